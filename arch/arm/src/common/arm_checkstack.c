@@ -112,6 +112,13 @@ size_t arm_stack_check(void *stackbase, size_t nbytes)
 
   nbytes  = end - start;
 
+#ifdef CONFIG_STACK_COLORATION_SPARSE
+  /* Only the guard area and the probe words may have been colored */
+
+  return nxsched_stack_check((FAR void *)start, (FAR void *)end,
+                             STACK_COLOR);
+#endif
+
   /* The ARM uses a push-down stack:  the stack grows toward lower addresses
    * in memory.  We need to start at the lowest address in the stack memory
    * allocation and search to higher addresses.  The first word we encounter
@@ -196,6 +203,14 @@ void arm_stack_color(void *stackbase, size_t nbytes)
   else
     {
       stkend = (uintptr_t)stackbase + nbytes;
+
+#ifdef CONFIG_STACK_COLORATION_SPARSE
+      /* Color only the guard area and the probe words of a new stack */
+
+      nxsched_stack_color(stkptr, (FAR void *)STACK_ALIGN_DOWN(stkend),
+                          STACK_COLOR);
+      return;
+#endif
     }
 
   stkend = STACK_ALIGN_DOWN(stkend);
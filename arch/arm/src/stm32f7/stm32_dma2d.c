@@ -36,9 +36,11 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/cache.h>
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/nx/nxglib.h>
 #include <nuttx/video/fb.h>
 
 #include <arch/board/board.h>
@@ -1068,6 +1070,110 @@ static int stm32_dma2d_blend(struct stm32_dma2d_overlay_s *doverlay,
   return ret;
 }
 
+#ifdef CONFIG_NX_HWACCEL
+/****************************************************************************
+ * Name: stm32_dma2d_nxoverlay
+ *
+ * Description:
+ *   Describe a memory region of NX as an overlay of the DMA2D.
+ *
+ * Input Parameters:
+ *   mem     - Start of the memory
+ *   stride  - Length of a line in bytes
+ *   bpp     - Bits per pixel
+ *   overlay - The overlay to set up
+ *   oinfo   - Overlay information referenced by the overlay
+ *
+ * Returned Value:
+ *   OK on success; -ENOSYS if the DMA2D cannot handle the format.
+ *
+ ****************************************************************************/
+
+static int stm32_dma2d_nxoverlay(void *mem, unsigned int stride,
+                                 uint8_t bpp,
+                                 struct stm32_dma2d_overlay_s *overlay,
+                                 struct fb_overlayinfo_s *oinfo)
+{
+  switch (bpp)
+    {
+      case 16:
+        overlay->fmt = DMA2D_PF_RGB565;
+        break;
+
+      case 24:
+        overlay->fmt = DMA2D_PF_RGB888;
+        break;
+
+      case 32:
+        overlay->fmt = DMA2D_PF_ARGB8888;
+        break;
+
+      default:
+        return -ENOSYS;
+    }
+
+  if (!g_initialized || stride % DMA2D_PF_BYPP(bpp) != 0)
+    {
+      return -ENOSYS;
+    }
+
+  memset(oinfo, 0, sizeof(*oinfo));
+  oinfo->fbmem         = mem;
+  oinfo->stride        = stride;
+  oinfo->bpp           = bpp;
+
+  overlay->transp_mode = 0;
+  overlay->xres        = stride / DMA2D_PF_BYPP(bpp);
+  overlay->yres        = 0;
+  overlay->oinfo       = oinfo;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32_dma2d_nxarea
+ *
+ * Description:
+ *   Convert a rectangle of NX to an area, if it is worth the DMA2D.
+ *
+ ****************************************************************************/
+
+static int stm32_dma2d_nxarea(const struct nxgl_rect_s *rect,
+                              struct fb_area_s *area)
+{
+  area->x = rect->pt1.x;
+  area->y = rect->pt1.y;
+  area->w = rect->pt2.x - rect->pt1.x + 1;
+  area->h = rect->pt2.y - rect->pt1.y + 1;
+
+  if ((uint32_t)area->w * area->h < CONFIG_STM32F7_DMA2D_NX_MINPIXELS)
+    {
+      return -ENOSYS;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32_dma2d_nxrange
+ *
+ * Description:
+ *   Get the memory range covered by an area of an overlay, for the cache
+ *   maintenance around a transfer.
+ *
+ ****************************************************************************/
+
+static void stm32_dma2d_nxrange(struct stm32_dma2d_overlay_s *overlay,
+                                const struct fb_area_s *area,
+                                uintptr_t *start, uintptr_t *end)
+{
+  struct fb_overlayinfo_s *oinfo = overlay->oinfo;
+
+  *start = stm32_dma2d_memaddress(overlay, area->x, area->y);
+  *end   = *start + (area->h - 1) * oinfo->stride +
+           area->w * DMA2D_PF_BYPP(oinfo->bpp);
+}
+#endif /* CONFIG_NX_HWACCEL */
+
 /****************************************************************************
  * Name: stm32_dma2dinitialize
  *
@@ -1164,3 +1270,166 @@ struct dma2d_layer_s *stm32_dma2ddev(void)
 {
   return &g_dma2ddev.dma2d;
 }
+
+#ifdef CONFIG_NX_HWACCEL
+/****************************************************************************
+ * Name: up_nxgl_fillrectangle
+ *
+ * Description:
+ *   Fill a rectangle of an NX framebuffer plane with the DMA2D.  The
+ *   output color register takes the color in the output format, so the
+ *   native NX pixel is used as is.
+ *
+ ****************************************************************************/
+
+int up_nxgl_fillrectangle(struct fb_planeinfo_s *pinfo,
+                          const struct nxgl_rect_s *rect,
+                          nxgl_mxpixel_t color)
+{
+  struct stm32_dma2d_overlay_s overlay;
+  struct fb_overlayinfo_s oinfo;
+  struct fb_area_s area;
+  uintptr_t start;
+  uintptr_t end;
+  int ret;
+
+  ret = stm32_dma2d_nxarea(rect, &area);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = stm32_dma2d_nxoverlay(pinfo->fbmem, pinfo->stride, pinfo->bpp,
+                              &overlay, &oinfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Write back the lines of the CPU first, drop the stale ones after */
+
+  stm32_dma2d_nxrange(&overlay, &area, &start, &end);
+  up_flush_dcache(start, end);
+  ret = stm32_dma2d_fillcolor(&overlay, &area, color);
+  up_invalidate_dcache(start, end);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: up_nxgl_moverectangle
+ *
+ * Description:
+ *   Move a rectangle of an NX framebuffer plane with the DMA2D.  The DMA2D
+ *   walks the lines top down, so overlapping moves are only done when the
+ *   destination is above the source.
+ *
+ ****************************************************************************/
+
+int up_nxgl_moverectangle(struct fb_planeinfo_s *pinfo,
+                          const struct nxgl_rect_s *rect,
+                          struct nxgl_point_s *offset)
+{
+  struct stm32_dma2d_overlay_s overlay;
+  struct fb_overlayinfo_s oinfo;
+  struct fb_area_s sarea;
+  struct fb_area_s darea;
+  uintptr_t sstart;
+  uintptr_t send;
+  uintptr_t dstart;
+  uintptr_t dend;
+  int ret;
+
+  ret = stm32_dma2d_nxarea(rect, &sarea);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (offset->y >= rect->pt1.y &&
+      offset->y <= rect->pt2.y &&
+      offset->x + sarea.w > rect->pt1.x &&
+      offset->x <= rect->pt2.x)
+    {
+      return -ENOSYS;
+    }
+
+  ret = stm32_dma2d_nxoverlay(pinfo->fbmem, pinfo->stride, pinfo->bpp,
+                              &overlay, &oinfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  darea   = sarea;
+  darea.x = offset->x;
+  darea.y = offset->y;
+
+  stm32_dma2d_nxrange(&overlay, &sarea, &sstart, &send);
+  stm32_dma2d_nxrange(&overlay, &darea, &dstart, &dend);
+  up_clean_dcache(sstart, send);
+  up_flush_dcache(dstart, dend);
+  ret = stm32_dma2d_blit(&overlay, darea.x, darea.y, &overlay, &sarea);
+  up_invalidate_dcache(dstart, dend);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: up_nxgl_copyrectangle
+ *
+ * Description:
+ *   Copy a bitmap of the NX pixel format into a rectangle of an NX
+ *   framebuffer plane with the DMA2D.
+ *
+ ****************************************************************************/
+
+int up_nxgl_copyrectangle(struct fb_planeinfo_s *pinfo,
+                          const struct nxgl_rect_s *dest,
+                          const void *src,
+                          const struct nxgl_point_s *origin,
+                          unsigned int srcstride)
+{
+  struct stm32_dma2d_overlay_s doverlay;
+  struct stm32_dma2d_overlay_s soverlay;
+  struct fb_overlayinfo_s doinfo;
+  struct fb_overlayinfo_s soinfo;
+  struct fb_area_s sarea;
+  struct fb_area_s darea;
+  uintptr_t sstart;
+  uintptr_t send;
+  uintptr_t dstart;
+  uintptr_t dend;
+  int ret;
+
+  ret = stm32_dma2d_nxarea(dest, &darea);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = stm32_dma2d_nxoverlay(pinfo->fbmem, pinfo->stride, pinfo->bpp,
+                              &doverlay, &doinfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = stm32_dma2d_nxoverlay((void *)src, srcstride, pinfo->bpp,
+                              &soverlay, &soinfo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  sarea   = darea;
+  sarea.x = dest->pt1.x - origin->x;
+  sarea.y = dest->pt1.y - origin->y;
+
+  stm32_dma2d_nxrange(&soverlay, &sarea, &sstart, &send);
+  stm32_dma2d_nxrange(&doverlay, &darea, &dstart, &dend);
+  up_clean_dcache(sstart, send);
+  up_flush_dcache(dstart, dend);
+  ret = stm32_dma2d_blit(&doverlay, darea.x, darea.y, &soverlay, &sarea);
+  up_invalidate_dcache(dstart, dend);
+  return ret;
+}
+#endif /* CONFIG_NX_HWACCEL */
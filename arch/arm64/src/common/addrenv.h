@@ -130,5 +130,24 @@ int arm64_map_pages(arch_addrenv_t *addrenv, uintptr_t *pages,
 int arm64_unmap_pages(arch_addrenv_t *addrenv, uintptr_t vaddr,
                       unsigned int npages);
 
+/****************************************************************************
+ * Name: arm64_asid_switch
+ *
+ * Description:
+ *   Instantiate an address environment on this CPU using its ASID, so that
+ *   the TLB entries of other address environments need not be flushed.
+ *
+ * Input Parameters:
+ *   addrenv - The address environment to instantiate
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+void arm64_asid_switch(arch_addrenv_t *addrenv);
+#endif
+
 #endif /* CONFIG_ARCH_ADDRENV */
 #endif /* __ARCH_ARM64_SRC_COMMON_ADDRENV_H */
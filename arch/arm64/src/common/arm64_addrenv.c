@@ -738,7 +738,13 @@ ssize_t up_addrenv_heapsize(const arch_addrenv_t *addrenv)
 int up_addrenv_select(const arch_addrenv_t *addrenv)
 {
   DEBUGASSERT(addrenv && addrenv->ttbr0);
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+  /* The ASID is assigned lazily, this is the only state that changes */
+
+  arm64_asid_switch((arch_addrenv_t *)addrenv);
+#else
   mmu_write_ttbr0(addrenv->ttbr0);
+#endif
   return OK;
 }
 
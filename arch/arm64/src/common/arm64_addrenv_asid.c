@@ -0,0 +1,280 @@
+/****************************************************************************
+ * arch/arm64/src/common/arm64_addrenv_asid.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/addrenv.h>
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+#include <arch/barriers.h>
+
+#include "addrenv.h"
+#include "arm64_mmu.h"
+
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The MMU is set up with TCR_ASID_8, i.e. 256 ASIDs.  ASID 0 is used by
+ * the kernel mappings and is never handed out.
+ *
+ * An addrenv's context id holds the ASID in its low bits and the
+ * generation in which that ASID was allocated above them.  When the ASIDs
+ * of a generation are used up, a new generation is started and every CPU
+ * flushes its TLB once before it runs with a new ASID.
+ */
+
+#define ASID_BITS          8
+#define ASID_COUNT         (1 << ASID_BITS)
+#define ASID_MASK          ((uintptr_t)ASID_COUNT - 1)
+#define ASID_GEN_MASK      (~ASID_MASK)
+#define ASID_FIRST_GEN     ((uintptr_t)ASID_COUNT)
+
+#define ASID_MAP_WORDS     (ASID_COUNT / 32)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static spinlock_t g_asid_lock = SP_UNLOCKED;
+
+/* Current generation */
+
+static uintptr_t g_asid_gen = ASID_FIRST_GEN;
+
+/* ASIDs handed out in the current generation */
+
+static uint32_t g_asid_map[ASID_MAP_WORDS] =
+{
+  1
+};
+
+/* Where to start searching for a free ASID */
+
+static unsigned int g_asid_next = 1;
+
+/* Context id running on each CPU, and the ones that were kept across the
+ * last rollover because they were running at that time.
+ */
+
+static uintptr_t g_asid_active[CONFIG_SMP_NCPUS];
+static uintptr_t g_asid_reserved[CONFIG_SMP_NCPUS];
+
+/* CPUs that must flush their TLB before using a new generation ASID */
+
+static bool g_asid_flush[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: asid_test_and_set
+ *
+ * Description:
+ *   Mark an ASID as used in the current generation, returning whether it
+ *   already was.
+ *
+ ****************************************************************************/
+
+static inline bool asid_test_and_set(unsigned int idx)
+{
+  uint32_t bit = UINT32_C(1) << (idx & 31);
+
+  if ((g_asid_map[idx >> 5] & bit) != 0)
+    {
+      return true;
+    }
+
+  g_asid_map[idx >> 5] |= bit;
+  return false;
+}
+
+/****************************************************************************
+ * Name: asid_rollover
+ *
+ * Description:
+ *   Start a new generation.  The ASIDs running on the CPUs right now keep
+ *   their number so that those address environments need not be
+ *   re-tagged; everything else is forgotten and will be flushed.
+ *
+ ****************************************************************************/
+
+static void asid_rollover(void)
+{
+  uintptr_t asid;
+  int cpu;
+
+  g_asid_gen += ASID_FIRST_GEN;
+  if (g_asid_gen == 0)
+    {
+      g_asid_gen = ASID_FIRST_GEN;
+    }
+
+  memset(g_asid_map, 0, sizeof(g_asid_map));
+  asid_test_and_set(0);
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      asid = g_asid_active[cpu];
+      if (asid != 0)
+        {
+          asid_test_and_set(asid & ASID_MASK);
+        }
+
+      g_asid_reserved[cpu] = asid;
+      g_asid_flush[cpu]    = true;
+    }
+
+  g_asid_next = 1;
+}
+
+/****************************************************************************
+ * Name: asid_new
+ *
+ * Description:
+ *   Give an address environment a context id of the current generation.
+ *
+ ****************************************************************************/
+
+static uintptr_t asid_new(uintptr_t asid)
+{
+  unsigned int idx;
+  int cpu;
+
+  if (asid != 0)
+    {
+      uintptr_t newasid = g_asid_gen | (asid & ASID_MASK);
+      bool reserved = false;
+
+      /* Keep the number if it was carried over by the last rollover */
+
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          if (g_asid_reserved[cpu] == asid)
+            {
+              g_asid_reserved[cpu] = newasid;
+              reserved = true;
+            }
+        }
+
+      /* Or if nobody took it in this generation yet */
+
+      if (reserved || !asid_test_and_set(asid & ASID_MASK))
+        {
+          return newasid;
+        }
+    }
+
+  /* Search for a free one, starting a new generation if there is none */
+
+  for (idx = g_asid_next; idx < ASID_COUNT; idx++)
+    {
+      if (!asid_test_and_set(idx))
+        {
+          goto found;
+        }
+    }
+
+  /* Only the ASIDs kept for the running CPUs are in use after this */
+
+  asid_rollover();
+
+  idx = 1;
+  while (asid_test_and_set(idx))
+    {
+      idx++;
+    }
+
+found:
+  g_asid_next = idx + 1;
+  return g_asid_gen | idx;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm64_asid_switch
+ *
+ * Description:
+ *   Instantiate an address environment on this CPU using its ASID, so that
+ *   the TLB entries of other address environments need not be flushed.
+ *   An ASID is (re)assigned first if the address environment has none in
+ *   the current generation.
+ *
+ * Input Parameters:
+ *   addrenv - The address environment to instantiate
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void arm64_asid_switch(arch_addrenv_t *addrenv)
+{
+  irqstate_t flags;
+  uintptr_t asid;
+  bool flush;
+  int cpu;
+
+  flags = spin_lock_irqsave(&g_asid_lock);
+
+  cpu  = this_cpu();
+  asid = addrenv->asid;
+  if ((asid & ASID_GEN_MASK) != g_asid_gen)
+    {
+      asid = asid_new(asid);
+      addrenv->asid = asid;
+    }
+
+  g_asid_active[cpu] = asid;
+  flush = g_asid_flush[cpu];
+  g_asid_flush[cpu] = false;
+
+  spin_unlock_irqrestore(&g_asid_lock, flags);
+
+  write_sysreg(mmu_ttbr_reg(addrenv->ttbr0 & TTBR_BADDR_MASK,
+                            asid & ASID_MASK), ttbr0_el1);
+  UP_ISB();
+
+  if (flush)
+    {
+      mmu_invalidate_tlbs();
+    }
+}
+
+#endif /* CONFIG_ARCH_ADDRENV_ASID */
@@ -49,6 +49,172 @@
 static struct arch_addrenv_s g_kernel_addrenv;
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_KMAP_LARGE_PAGES
+
+/****************************************************************************
+ * Name: arm64_kmap_iscontig
+ *
+ * Description:
+ *   Check if npages physical pages follow each other in memory.
+ *
+ ****************************************************************************/
+
+static bool arm64_kmap_iscontig(uintptr_t *pages, unsigned int npages)
+{
+  unsigned int i;
+
+  for (i = 1; i < npages; i++)
+    {
+      if (pages[i] != pages[0] + ((uintptr_t)i << MM_PGSHIFT))
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: arm64_kmap_large
+ *
+ * Description:
+ *   Map pages into the kernel mapping area like arm64_map_pages(), with a
+ *   level 2 block for every aligned and physically contiguous 2M and the
+ *   contiguous hint for every such 64K of the rest.
+ *
+ ****************************************************************************/
+
+static int arm64_kmap_large(struct arch_addrenv_s *addrenv,
+                            uintptr_t *pages, unsigned int npages,
+                            uintptr_t vaddr, uint64_t mask)
+{
+  const unsigned int nblock  = MMU_L2_PAGE_SIZE >> MM_PGSHIFT;
+  const unsigned int ncontig = MMU_L3_CONTIG_SIZE >> MM_PGSHIFT;
+  uintptr_t          l2;
+  uintptr_t          entry;
+  unsigned int       count;
+  int                ret;
+
+  l2 = arm64_pgvaddr(addrenv->spgtables[MMU_PGT_LEVEL_MAX - 1]);
+  if (!l2)
+    {
+      return -EFAULT;
+    }
+
+  while (npages > 0)
+    {
+      if (npages >= nblock &&
+          ((vaddr | pages[0]) & (MMU_L2_PAGE_SIZE - 1)) == 0 &&
+          arm64_kmap_iscontig(pages, nblock))
+        {
+          /* The block replaces the level 3 table left by earlier mappings,
+           * if any.  The whole 2M is ours, so the table maps nothing.
+           */
+
+          entry = mmu_ln_getentry(MMU_PGT_LEVEL_MAX - 1, l2, vaddr);
+          mmu_ln_setentry(MMU_PGT_LEVEL_MAX - 1, l2, pages[0], vaddr,
+                          (mask & ~PTE_DESC_TYPE_MASK) | PTE_BLOCK_DESC);
+
+          if ((entry & PTE_DESC_TYPE_MASK) == PTE_TABLE_DESC)
+            {
+              mmu_invalidate_walk_by_vaddr(vaddr);
+              mm_pgfree(mmu_pte_to_paddr(entry), 1);
+            }
+
+          count = nblock;
+        }
+      else
+        {
+          uint64_t flags = mask;
+
+          count = 1;
+          if (npages >= ncontig &&
+              ((vaddr | pages[0]) & (MMU_L3_CONTIG_SIZE - 1)) == 0 &&
+              arm64_kmap_iscontig(pages, ncontig))
+            {
+              flags |= PTE_BLOCK_DESC_CONTIG;
+              count  = ncontig;
+            }
+
+          ret = arm64_map_pages(addrenv, pages, count, vaddr, flags);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      pages  += count;
+      npages -= count;
+      vaddr  += (uintptr_t)count << MM_PGSHIFT;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: arm64_kunmap_large
+ *
+ * Description:
+ *   Unmap a region mapped by arm64_kmap_large(), level 2 blocks included.
+ *
+ ****************************************************************************/
+
+static int arm64_kunmap_large(struct arch_addrenv_s *addrenv,
+                              uintptr_t vaddr, unsigned int npages)
+{
+  uintptr_t    l2;
+  uintptr_t    entry;
+  unsigned int count;
+  int          ret;
+
+  l2 = arm64_pgvaddr(addrenv->spgtables[MMU_PGT_LEVEL_MAX - 1]);
+  if (!l2)
+    {
+      return -EFAULT;
+    }
+
+  while (npages > 0)
+    {
+      entry = mmu_ln_getentry(MMU_PGT_LEVEL_MAX - 1, l2, vaddr);
+      if ((entry & PTE_DESC_TYPE_MASK) == PTE_BLOCK_DESC)
+        {
+          DEBUGASSERT((vaddr & (MMU_L2_PAGE_SIZE - 1)) == 0);
+
+          mmu_ln_clear(MMU_PGT_LEVEL_MAX - 1, l2, vaddr);
+          count = MMU_L2_PAGE_SIZE >> MM_PGSHIFT;
+        }
+      else
+        {
+          /* The pages up to the end of this level 3 table */
+
+          count = (MMU_L2_PAGE_SIZE - (vaddr & (MMU_L2_PAGE_SIZE - 1))) >>
+                  MM_PGSHIFT;
+          if (count > npages)
+            {
+              count = npages;
+            }
+
+          ret = arm64_unmap_pages(addrenv, vaddr, count);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      DEBUGASSERT(count <= npages);
+      npages -= count;
+      vaddr  += (uintptr_t)count << MM_PGSHIFT;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_MM_KMAP_LARGE_PAGES */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -248,7 +414,7 @@ int up_addrenv_kmap_pages(void **pages, unsigned int npages, uintptr_t vaddr,
                           int prot)
 {
   struct arch_addrenv_s *addrenv = &g_kernel_addrenv;
-  int mask                       = 0;
+  uint64_t mask                  = 0;
 
   /* Sanity checks */
 
@@ -286,9 +452,15 @@ int up_addrenv_kmap_pages(void **pages, unsigned int npages, uintptr_t vaddr,
 
   mask |= MMU_MT_NORMAL_FLAGS;
 
+#ifdef CONFIG_MM_KMAP_LARGE_PAGES
+  /* Use blocks and contiguous runs where the pages allow */
+
+  return arm64_kmap_large(addrenv, (uintptr_t *)pages, npages, vaddr, mask);
+#else
   /* Let arm64_map_pages do the work */
 
   return arm64_map_pages(addrenv, (uintptr_t *)pages, npages, vaddr, mask);
+#endif
 }
 
 /****************************************************************************
@@ -318,9 +490,13 @@ int up_addrenv_kunmap_pages(uintptr_t vaddr, unsigned int npages)
   DEBUGASSERT(vaddr >= CONFIG_ARCH_KMAP_VBASE && vaddr < ARCH_KMAP_VEND);
   DEBUGASSERT(MM_ISALIGNED(vaddr));
 
+#ifdef CONFIG_MM_KMAP_LARGE_PAGES
+  return arm64_kunmap_large(addrenv, vaddr, npages);
+#else
   /* Let arm64_unmap_pages do the work */
 
   return arm64_unmap_pages(addrenv, vaddr, npages);
+#endif
 }
 
 #endif /* CONFIG_MM_KMAP */
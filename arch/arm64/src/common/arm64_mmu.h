@@ -117,6 +117,7 @@
 #define PTE_BLOCK_DESC_AF           (1ULL << 10) /* A-flag */
 #define PTE_BLOCK_DESC_NG           (1ULL << 11) /* Non-global */
 #define PTE_BLOCK_DESC_DIRTY        (1ULL << 51) /* D-flag */
+#define PTE_BLOCK_DESC_CONTIG       (1ULL << 52) /* Contiguous hint */
 #define PTE_BLOCK_DESC_PXN          (1ULL << 53) /* Kernel execute never */
 #define PTE_BLOCK_DESC_UXN          (1ULL << 54) /* User execute never */
 
@@ -278,6 +279,12 @@
 #define MMU_L2_PAGE_SIZE            (0x200000)     /* 2M */
 #define MMU_L3_PAGE_SIZE            (0x1000)       /* 4K */
 
+/* Size of a run of level 3 entries that can share one TLB entry when they
+ * carry PTE_BLOCK_DESC_CONTIG (16 entries with the 4K granule).
+ */
+
+#define MMU_L3_CONTIG_SIZE          (0x10000)      /* 64K */
+
 /* Flags for user page tables */
 
 #define MMU_UPGT_FLAGS              (PTE_TABLE_DESC)
@@ -399,7 +406,7 @@ static inline uintptr_t mmu_ttbr_reg(uintptr_t pgbase, uint16_t asid)
  * Name: mmu_invalidate_tlb_by_vaddr
  *
  * Description:
- *   Flush the TLB for vaddr entry
+ *   Flush the TLB for vaddr entry, whatever ASID it is tagged with
  *
  * Input Parameters:
  *   vaddr - The virtual address to flush
@@ -411,7 +418,33 @@ static inline void mmu_invalidate_tlb_by_vaddr(uintptr_t vaddr)
   __asm__ __volatile__
     (
       "dsb ishst\n"
-      "tlbi vale1is, %0\n"
+      "tlbi vaale1is, %0\n"
+      "dsb ish\n"
+      "isb"
+      :
+      : "r" (TLBI_ARG(vaddr, 0))
+      : "memory"
+    );
+}
+
+/****************************************************************************
+ * Name: mmu_invalidate_walk_by_vaddr
+ *
+ * Description:
+ *   Flush the TLB and the cached table walks for vaddr entry, whatever
+ *   ASID it is tagged with.  Needed when a table descriptor is replaced.
+ *
+ * Input Parameters:
+ *   vaddr - The virtual address to flush
+ *
+ ****************************************************************************/
+
+static inline void mmu_invalidate_walk_by_vaddr(uintptr_t vaddr)
+{
+  __asm__ __volatile__
+    (
+      "dsb ishst\n"
+      "tlbi vaae1is, %0\n"
       "dsb ish\n"
       "isb"
       :
@@ -130,5 +130,25 @@ int riscv_map_pages(arch_addrenv_t *addrenv, uintptr_t *pages,
 int riscv_unmap_pages(arch_addrenv_t *addrenv, uintptr_t vaddr,
                       unsigned int npages);
 
+/****************************************************************************
+ * Name: riscv_asid_switch
+ *
+ * Description:
+ *   Instantiate an address environment on this hart using its ASID, so
+ *   that the TLB entries of other address environments need not be
+ *   flushed.
+ *
+ * Input Parameters:
+ *   addrenv - The address environment to instantiate
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+void riscv_asid_switch(arch_addrenv_t *addrenv);
+#endif
+
 #endif /* CONFIG_ARCH_ADDRENV */
 #endif /* __ARCH_RISC_V_SRC_COMMON_ADDRENV_H */
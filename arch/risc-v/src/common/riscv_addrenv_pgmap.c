@@ -41,6 +41,17 @@
 
 #ifdef CONFIG_BUILD_KERNEL
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Only Sv39 has 2M megapages, Sv32 ones are 4M */
+
+#if defined(CONFIG_MM_KMAP_LARGE_PAGES) && \
+    defined(CONFIG_ARCH_MMU_TYPE_SV39)
+#  define RISCV_KMAP_MEGAPAGES
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -49,6 +60,179 @@
 static struct arch_addrenv_s g_kernel_addrenv;
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef RISCV_KMAP_MEGAPAGES
+
+/****************************************************************************
+ * Name: riscv_kmap_iscontig
+ *
+ * Description:
+ *   Check if npages physical pages follow each other in memory.
+ *
+ ****************************************************************************/
+
+static bool riscv_kmap_iscontig(uintptr_t *pages, unsigned int npages)
+{
+  unsigned int i;
+
+  for (i = 1; i < npages; i++)
+    {
+      if (pages[i] != pages[0] + ((uintptr_t)i << MM_PGSHIFT))
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: riscv_kmap_span
+ *
+ * Description:
+ *   Return the number of pages from vaddr up to the end of its level 2
+ *   entry, at most npages.
+ *
+ ****************************************************************************/
+
+static unsigned int riscv_kmap_span(uintptr_t vaddr, unsigned int npages)
+{
+  unsigned int count;
+
+  count = (RV_MMU_L2_PAGE_SIZE - (vaddr & (RV_MMU_L2_PAGE_SIZE - 1))) >>
+          MM_PGSHIFT;
+
+  return count < npages ? count : npages;
+}
+
+/****************************************************************************
+ * Name: riscv_kmap_large
+ *
+ * Description:
+ *   Map pages into the kernel mapping area like riscv_map_pages(), with a
+ *   megapage for every aligned and physically contiguous 2M.
+ *
+ ****************************************************************************/
+
+static int riscv_kmap_large(struct arch_addrenv_s *addrenv,
+                            uintptr_t *pages, unsigned int npages,
+                            uintptr_t vaddr, int mask)
+{
+  const unsigned int nmega = RV_MMU_L2_PAGE_SIZE >> MM_PGSHIFT;
+  uintptr_t          l2;
+  uintptr_t          entry;
+  unsigned int       count;
+  int                ret;
+
+  l2 = riscv_pgvaddr(addrenv->spgtables[ARCH_SPGTS - 1]);
+  if (!l2)
+    {
+      return -EFAULT;
+    }
+
+  while (npages > 0)
+    {
+      /* A megapage is a leaf, PROT_NONE would turn it into a table */
+
+      if ((mask & PTE_LEAF_MASK) != 0 && npages >= nmega &&
+          ((vaddr | pages[0]) & (RV_MMU_L2_PAGE_SIZE - 1)) == 0 &&
+          riscv_kmap_iscontig(pages, nmega))
+        {
+          /* The megapage replaces the level 3 table left by earlier
+           * mappings, if any.  The whole 2M is ours, so the table maps
+           * nothing.
+           */
+
+          entry = mmu_ln_getentry(ARCH_SPGTS, l2, vaddr);
+          mmu_ln_setentry(ARCH_SPGTS, l2, pages[0], vaddr, mask);
+
+          if ((entry & PTE_VALID) != 0 && (entry & PTE_LEAF_MASK) == 0)
+            {
+              /* sfence.vma with an address only flushes the leaf */
+
+              mmu_invalidate_tlbs();
+              mm_pgfree(mmu_pte_to_paddr(entry), 1);
+            }
+
+          count = nmega;
+        }
+      else
+        {
+          count = riscv_kmap_span(vaddr, npages);
+          ret   = riscv_map_pages(addrenv, pages, count, vaddr, mask);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      pages  += count;
+      npages -= count;
+      vaddr  += (uintptr_t)count << MM_PGSHIFT;
+    }
+
+  UP_DMB();
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: riscv_kunmap_large
+ *
+ * Description:
+ *   Unmap a region mapped by riscv_kmap_large(), megapages included.
+ *
+ ****************************************************************************/
+
+static int riscv_kunmap_large(struct arch_addrenv_s *addrenv,
+                              uintptr_t vaddr, unsigned int npages)
+{
+  uintptr_t    l2;
+  uintptr_t    entry;
+  unsigned int count;
+  int          ret;
+
+  l2 = riscv_pgvaddr(addrenv->spgtables[ARCH_SPGTS - 1]);
+  if (!l2)
+    {
+      return -EFAULT;
+    }
+
+  while (npages > 0)
+    {
+      entry = mmu_ln_getentry(ARCH_SPGTS, l2, vaddr);
+      if ((entry & PTE_VALID) != 0 && (entry & PTE_LEAF_MASK) != 0)
+        {
+          DEBUGASSERT((vaddr & (RV_MMU_L2_PAGE_SIZE - 1)) == 0);
+
+          mmu_ln_clear(ARCH_SPGTS, l2, vaddr);
+          count = RV_MMU_L2_PAGE_SIZE >> MM_PGSHIFT;
+        }
+      else
+        {
+          count = riscv_kmap_span(vaddr, npages);
+          ret   = riscv_unmap_pages(addrenv, vaddr, count);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      DEBUGASSERT(count <= npages);
+      npages -= count;
+      vaddr  += (uintptr_t)count << MM_PGSHIFT;
+    }
+
+  UP_DMB();
+
+  return OK;
+}
+
+#endif /* RISCV_KMAP_MEGAPAGES */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -273,9 +457,15 @@ int up_addrenv_kmap_pages(void **pages, unsigned int npages, uintptr_t vaddr,
 
   mask |= PTE_G;
 
+#ifdef RISCV_KMAP_MEGAPAGES
+  /* Use megapages where the pages allow */
+
+  return riscv_kmap_large(addrenv, (uintptr_t *)pages, npages, vaddr, mask);
+#else
   /* Let riscv_map_pages do the work */
 
   return riscv_map_pages(addrenv, (uintptr_t *)pages, npages, vaddr, mask);
+#endif
 }
 
 /****************************************************************************
@@ -305,9 +495,13 @@ int up_addrenv_kunmap_pages(uintptr_t vaddr, unsigned int npages)
   DEBUGASSERT(vaddr >= CONFIG_ARCH_KMAP_VBASE && vaddr < ARCH_KMAP_VEND);
   DEBUGASSERT(MM_ISALIGNED(vaddr));
 
+#ifdef RISCV_KMAP_MEGAPAGES
+  return riscv_kunmap_large(addrenv, vaddr, npages);
+#else
   /* Let riscv_unmap_pages do the work */
 
   return riscv_unmap_pages(addrenv, vaddr, npages);
+#endif
 }
 
 #endif /* CONFIG_MM_KMAP */
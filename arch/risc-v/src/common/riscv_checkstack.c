@@ -110,6 +110,16 @@ size_t riscv_stack_check(uintptr_t alloc, size_t size)
 
   size  = end - start;
 
+#ifdef CONFIG_STACK_COLORATION_SPARSE
+  /* Only the guard area and the probe words may have been colored.  Use
+   * the same bounds as riscv_stack_color().
+   */
+
+  return nxsched_stack_check((FAR void *)STACK_ALIGN_UP(start),
+                             (FAR void *)STACK_ALIGN_DOWN(end),
+                             STACK_COLOR);
+#endif
+
   /* RISC-V uses a push-down stack:  the stack grows toward lower addresses
    * in memory.  We need to start at the lowest address in the stack memory
    * allocation and search to higher addresses.  The first word we encounter
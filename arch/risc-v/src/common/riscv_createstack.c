@@ -122,14 +122,16 @@ int up_create_stack(struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 
       if (ttype == TCB_FLAG_TTYPE_KERNEL)
         {
-          tcb->stack_alloc_ptr = kmm_memalign(TLS_STACK_ALIGN, stack_size);
+          tcb->stack_alloc_ptr =
+            kmm_memalign_stack(TLS_STACK_ALIGN, stack_size);
         }
       else
 #endif
         {
           /* Use the user-space allocator if this is a task or pthread */
 
-          tcb->stack_alloc_ptr = kumm_memalign(TLS_STACK_ALIGN, stack_size);
+          tcb->stack_alloc_ptr =
+            kumm_memalign_stack(TLS_STACK_ALIGN, stack_size);
         }
 
 #else /* CONFIG_TLS_ALIGNED */
@@ -138,14 +140,14 @@ int up_create_stack(struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 
       if (ttype == TCB_FLAG_TTYPE_KERNEL)
         {
-          tcb->stack_alloc_ptr = kmm_malloc(stack_size);
+          tcb->stack_alloc_ptr = kmm_malloc_stack(stack_size);
         }
       else
 #endif
         {
           /* Use the user-space allocator if this is a task or pthread */
 
-          tcb->stack_alloc_ptr = kumm_malloc(stack_size);
+          tcb->stack_alloc_ptr = kumm_malloc_stack(stack_size);
         }
 #endif /* CONFIG_TLS_ALIGNED */
 
@@ -235,6 +237,14 @@ void riscv_stack_color(void *stackbase, size_t nbytes)
   else
     {
       stkend = (uintptr_t)stackbase + nbytes;
+
+#ifdef CONFIG_STACK_COLORATION_SPARSE
+      /* Color only the guard area and the probe words of a new stack */
+
+      nxsched_stack_color(stkptr, (FAR void *)STACK_ALIGN_DOWN(stkend),
+                          STACK_COLOR);
+      return;
+#endif
     }
 
   stkend = STACK_ALIGN_DOWN(stkend);
@@ -36,6 +36,10 @@
 #  include <nuttx/pgalloc.h>
 #endif
 
+#ifdef CONFIG_FS_FILEMAP
+#  include <nuttx/fs/fs.h>
+#endif
+
 #ifdef CONFIG_PAGING
 #  include "pgalloc.h"
 #  include "riscv_mmu.h"
@@ -198,6 +202,17 @@ int riscv_fillpage(int mcause, void *regs, void *args)
     {
       mmuflags = MMU_UDATA_FLAGS;
     }
+#ifdef CONFIG_FS_FILEMAP
+  else if (vaddr >= CONFIG_ARCH_SHM_VBASE && vaddr <= ARCH_SHM_VEND &&
+           filemap_fault(vaddr, cause == RISCV_IRQ_STOREPF) >= 0)
+    {
+      /* The page of a file mapping was mapped in, or the task was blocked
+       * until it is read.  Either way the access is retried.
+       */
+
+      return 0;
+    }
+#endif
   else
     {
       _alert("PANIC!!! virtual address not mappable: %" PRIxPTR "\n", vaddr);
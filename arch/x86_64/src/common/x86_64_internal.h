@@ -304,6 +304,12 @@ void x86_64_usbuninitialize(void);
 void x86_64_pci_init(void);
 #endif
 
+/* Defined in intel64_irq.c */
+
+#ifdef CONFIG_PCI
+int x86_64_msi_affinity(int irq, int cpu, uintptr_t *mar, uint32_t *mdr);
+#endif
+
 /* Defined in intel64_checkstack.c */
 
 #ifdef CONFIG_STACK_COLORATION
@@ -83,6 +83,8 @@ static void x86_64_pci_release_irq(struct pci_bus_s *bus,
 static int x86_64_pci_connect_irq(struct pci_bus_s *bus,
                                   int *irq, int num,
                                   uintptr_t *mar, uint32_t *mdr);
+static int x86_64_pci_affinity_irq(struct pci_bus_s *bus, int irq,
+                                   int cpu, uintptr_t *mar, uint32_t *mdr);
 
 /****************************************************************************
  * Private Data
@@ -90,15 +92,16 @@ static int x86_64_pci_connect_irq(struct pci_bus_s *bus,
 
 static const struct pci_ops_s g_x86_64_pci_ops =
 {
-  .write       = x86_64_pci_write,
-  .read        = x86_64_pci_read,
-  .map         = x86_64_pci_map,
-  .read_io     = x86_64_pci_read_io,
-  .write_io    = x86_64_pci_write_io,
-  .get_irq     = x86_64_pci_get_irq,
-  .alloc_irq   = x86_64_pci_alloc_irq,
-  .release_irq = x86_64_pci_release_irq,
-  .connect_irq = x86_64_pci_connect_irq,
+  .write        = x86_64_pci_write,
+  .read         = x86_64_pci_read,
+  .map          = x86_64_pci_map,
+  .read_io      = x86_64_pci_read_io,
+  .write_io     = x86_64_pci_write_io,
+  .get_irq      = x86_64_pci_get_irq,
+  .alloc_irq    = x86_64_pci_alloc_irq,
+  .release_irq  = x86_64_pci_release_irq,
+  .connect_irq  = x86_64_pci_connect_irq,
+  .affinity_irq = x86_64_pci_affinity_irq,
 };
 
 static struct pci_controller_s g_x86_64_pci =
@@ -407,6 +410,32 @@ static int x86_64_pci_connect_irq(struct pci_bus_s *bus, int *irq, int num,
   return up_connect_irq(irq, num, mar, mdr);
 }
 
+/****************************************************************************
+ * Name: x86_64_pci_affinity_irq
+ *
+ * Description:
+ *  Get the MSI/MSI-X message that routes a vector to a CPU.
+ *
+ * Input Parameters:
+ *   bus - Bus that PCI device resides
+ *   irq - the vector
+ *   cpu - the CPU to interrupt
+ *   mar - returned value for Message Address Register
+ *   mdr - returned value for Message Data Register
+ *
+ * Returned Value:
+ *   OK on success or a negated errno
+ *
+ ****************************************************************************/
+
+static int x86_64_pci_affinity_irq(struct pci_bus_s *bus, int irq,
+                                   int cpu, uintptr_t *mar, uint32_t *mdr)
+{
+  UNUSED(bus);
+
+  return x86_64_msi_affinity(irq, cpu, mar, mdr);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
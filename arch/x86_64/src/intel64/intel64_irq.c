@@ -796,3 +796,20 @@ int up_connect_irq(const int *irq, int num, uintptr_t *mar, uint32_t *mdr)
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: x86_64_msi_affinity
+ *
+ * Description:
+ *   Get the MSI/MSI-X message that delivers a vector to the given CPU
+ *
+ ****************************************************************************/
+
+int x86_64_msi_affinity(int irq, int cpu, uintptr_t *mar, uint32_t *mdr)
+{
+  *mar = X86_64_MAR_DEST |
+    ((uintptr_t)x86_64_cpu_to_loapic(cpu) << PCI_MSI_DATA_CPUID_SHIFT);
+  *mdr = X86_64_MDR_TYPE | irq;
+
+  return OK;
+}
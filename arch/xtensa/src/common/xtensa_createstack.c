@@ -126,7 +126,8 @@ int up_create_stack(struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 
       if (ttype == TCB_FLAG_TTYPE_KERNEL)
         {
-          tcb->stack_alloc_ptr = kmm_memalign(TLS_STACK_ALIGN, stack_size);
+          tcb->stack_alloc_ptr =
+            kmm_memalign_stack(TLS_STACK_ALIGN, stack_size);
         }
       else
 #endif
@@ -142,7 +143,7 @@ int up_create_stack(struct tcb_s *tcb, size_t stack_size, uint8_t ttype)
 
       if (ttype == TCB_FLAG_TTYPE_KERNEL)
         {
-          tcb->stack_alloc_ptr = kmm_malloc(stack_size);
+          tcb->stack_alloc_ptr = kmm_malloc_stack(stack_size);
         }
       else
 #endif
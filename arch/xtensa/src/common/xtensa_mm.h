@@ -42,8 +42,8 @@
 #  define UMM_FREE(p)        xtensa_imm_free(p)
 #  define UMM_HEAPMEMEBER(p) xtensa_imm_heapmember(p)
 #else
-#  define UMM_MALLOC(s)      kumm_malloc(s)
-#  define UMM_MEMALIGN(a,s)  kumm_memalign(a,s)
+#  define UMM_MALLOC(s)      kumm_malloc_stack(s)
+#  define UMM_MEMALIGN(a,s)  kumm_memalign_stack(a,s)
 #  define UMM_FREE(p)        kumm_free(p)
 #  define UMM_HEAPMEMEBER(p) umm_heapmember(p)
 #endif  /* CONFIG_XTENSA_IMEM_USE_SEPARATE_HEAP */
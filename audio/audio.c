@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -34,6 +35,7 @@
 #include <unistd.h>
 #include <string.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
@@ -41,6 +43,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mqueue.h>
 #include <nuttx/arch.h>
+#include <nuttx/cache.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/audio/audio.h>
 #include <nuttx/mutex.h>
@@ -65,6 +68,10 @@
 #  define CONFIG_AUDIO_BUFFER_DEQUEUE_PRIO  1
 #endif
 
+/* Alignment of a ring allocated by the upper half, for DMA */
+
+#define AUDIO_MMAP_ALIGN  32
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -78,6 +85,17 @@ struct audio_upperhalf_s
   mutex_t           lock;             /* Supports mutual exclusion */
   FAR struct audio_lowerhalf_s *dev;  /* lower-half state */
   struct file      *usermq;           /* User mode app's message queue */
+#ifdef CONFIG_AUDIO_MMAP
+  FAR struct audio_mmap_ctrl_s *ctrl; /* Shared pointers of the mmap ring */
+  FAR struct ap_buffer_s **periods;   /* Periods of the mmap ring */
+  FAR uint8_t      *ring;             /* Samples of the mmap ring */
+  uint32_t          ringsize;         /* Bytes in the mmap ring */
+  uint32_t          cleanptr;         /* Playback data written back so far */
+  uint32_t          availmin;         /* Bytes available to wake poll() */
+  bool              capture;          /* The device fills the ring */
+  volatile bool     running;          /* Periods are requeued when done */
+  FAR struct pollfd *fds[CONFIG_AUDIO_MMAP_NPOLLWAITERS];
+#endif
 };
 
 /****************************************************************************
@@ -95,6 +113,14 @@ static ssize_t  audio_write(FAR struct file *filep,
 static int      audio_ioctl(FAR struct file *filep,
                             int cmd,
                             unsigned long arg);
+#ifdef CONFIG_AUDIO_MMAP
+static void     audio_mmap_release(FAR struct audio_upperhalf_s *upper);
+static int      audio_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+static int      audio_poll(FAR struct file *filep,
+                           FAR struct pollfd *fds,
+                           bool setup);
+#endif
 #ifdef CONFIG_AUDIO_MULTI_SESSION
 static int      audio_start(FAR struct audio_upperhalf_s *upper,
                             FAR void *session);
@@ -123,6 +149,11 @@ static const struct file_operations g_audioops =
   audio_write, /* write */
   NULL,        /* seek */
   audio_ioctl, /* ioctl */
+#ifdef CONFIG_AUDIO_MMAP
+  audio_mmap,  /* mmap */
+  NULL,        /* truncate */
+  audio_poll,  /* poll */
+#endif
 };
 
 /****************************************************************************
@@ -225,8 +256,14 @@ static int audio_close(FAR struct file *filep)
       DEBUGASSERT(lower->ops->shutdown != NULL);
       audinfo("calling shutdown\n");
 
+#ifdef CONFIG_AUDIO_MMAP
+      upper->running = false;
+#endif
       lower->ops->shutdown(lower);
       upper->usermq = NULL;
+#ifdef CONFIG_AUDIO_MMAP
+      audio_mmap_release(upper);
+#endif
     }
 
   ret = OK;
@@ -292,6 +329,492 @@ static ssize_t audio_write(FAR struct file *filep,
   return 0;
 }
 
+#ifdef CONFIG_AUDIO_MMAP
+/****************************************************************************
+ * Name: audio_mmap_delta
+ *
+ * Description:
+ *   Return the number of bytes from one ring pointer to another.
+ *
+ ****************************************************************************/
+
+static inline uint32_t audio_mmap_delta(FAR struct audio_mmap_ctrl_s *ctrl,
+                                        uint32_t from, uint32_t to)
+{
+  return to >= from ? to - from : ctrl->boundary - from + to;
+}
+
+/****************************************************************************
+ * Name: audio_mmap_avail
+ *
+ * Description:
+ *   Return the number of bytes the application may write (playback) or
+ *   read (capture) without waiting for the device.
+ *
+ ****************************************************************************/
+
+static uint32_t audio_mmap_avail(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_mmap_ctrl_s *ctrl = upper->ctrl;
+  uint32_t filled;
+
+  if (upper->capture)
+    {
+      return audio_mmap_delta(ctrl, ctrl->appl_ptr, ctrl->hw_ptr);
+    }
+
+  /* An application behind the device may rewrite the whole ring */
+
+  filled = audio_mmap_delta(ctrl, ctrl->hw_ptr, ctrl->appl_ptr);
+  return filled > upper->ringsize ? upper->ringsize :
+                                    upper->ringsize - filled;
+}
+
+/****************************************************************************
+ * Name: audio_mmap_clean
+ *
+ * Description:
+ *   Write back the playback data the application put in the ring since the
+ *   last call, so that the device sees it.  Runs once per period; anything
+ *   written at least one period ahead of the device is covered in time.
+ *
+ ****************************************************************************/
+
+static void audio_mmap_clean(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_mmap_ctrl_s *ctrl = upper->ctrl;
+  uint32_t appl = ctrl->appl_ptr;
+  uint32_t nbytes;
+  uint32_t offset;
+  uint32_t chunk;
+
+  nbytes = audio_mmap_delta(ctrl, upper->cleanptr, appl);
+  nbytes = MIN(nbytes, upper->ringsize);
+  offset = upper->cleanptr % upper->ringsize;
+
+  while (nbytes > 0)
+    {
+      chunk = MIN(nbytes, upper->ringsize - offset);
+      up_clean_dcache((uintptr_t)upper->ring + offset,
+                      (uintptr_t)upper->ring + offset + chunk);
+      nbytes -= chunk;
+      offset  = 0;
+    }
+
+  upper->cleanptr = appl;
+}
+
+/****************************************************************************
+ * Name: audio_mmap_release
+ *
+ * Description:
+ *   Free the mmap ring, if any.  The stream must be stopped.
+ *
+ ****************************************************************************/
+
+static void audio_mmap_release(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  struct audio_buf_desc_s bufdesc;
+  uint32_t i;
+
+  if (upper->ctrl == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < upper->ctrl->nperiods; i++)
+    {
+      if (upper->periods[i] == NULL)
+        {
+          continue;
+        }
+
+      if (lower->ops->freebuffer != NULL)
+        {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+          bufdesc.session  = upper->periods[i]->session;
+#endif
+          bufdesc.numbytes = upper->periods[i]->nmaxbytes;
+          bufdesc.u.buffer = upper->periods[i];
+          lower->ops->freebuffer(lower, &bufdesc);
+        }
+      else
+        {
+          apb_free(upper->periods[i]);
+        }
+    }
+
+  /* The ring is only allocated here if the lower half allocates no
+   * buffers, otherwise it belongs to the lower half.
+   */
+
+  if (lower->ops->allocbuffer == NULL)
+    {
+      kumm_free(upper->ring);
+    }
+
+  kmm_free(upper->periods);
+  kumm_free(upper->ctrl);
+  upper->periods = NULL;
+  upper->ctrl    = NULL;
+  upper->ring    = NULL;
+}
+
+/****************************************************************************
+ * Name: audio_mmap_setup
+ *
+ * Description:
+ *   Handle the AUDIOIOC_MMAPSETUP ioctl command.  The ring is made of
+ *   periods allocated by the lower half if it can, so a DMA ring such as
+ *   the one of audio_dma is shared with the application as is.  Those
+ *   periods have to be contiguous.
+ *
+ ****************************************************************************/
+
+static int audio_mmap_setup(FAR struct audio_upperhalf_s *upper,
+                            FAR const struct audio_mmap_desc_s *desc)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  FAR struct audio_mmap_ctrl_s *ctrl;
+  struct audio_buf_desc_s bufdesc;
+  FAR struct ap_buffer_s *apb;
+  uint32_t i;
+  int ret;
+
+  if (upper->started)
+    {
+      return -EBUSY;
+    }
+
+  audio_mmap_release(upper);
+  if (desc->nperiods == 0)
+    {
+      return OK;
+    }
+
+  if (desc->period_bytes == 0 || desc->nperiods < 2 ||
+      desc->avail_min == 0 || desc->avail_min > desc->nperiods ||
+      (uint64_t)desc->period_bytes * desc->nperiods > UINT32_MAX)
+    {
+      return -EINVAL;
+    }
+
+  ctrl = kumm_zalloc(sizeof(*ctrl));
+  if (ctrl == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->periods = kmm_zalloc(desc->nperiods * sizeof(*upper->periods));
+  if (upper->periods == NULL)
+    {
+      kumm_free(ctrl);
+      return -ENOMEM;
+    }
+
+  upper->ctrl        = ctrl;
+  upper->ringsize    = desc->period_bytes * desc->nperiods;
+  upper->availmin    = desc->period_bytes * desc->avail_min;
+  upper->capture     = desc->capture;
+  ctrl->period_bytes = desc->period_bytes;
+  ctrl->nperiods     = desc->nperiods;
+  ctrl->boundary     = UINT32_MAX / upper->ringsize * upper->ringsize;
+
+  if (lower->ops->allocbuffer == NULL)
+    {
+      upper->ring = kumm_memalign(AUDIO_MMAP_ALIGN, upper->ringsize);
+      if (upper->ring == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+    }
+
+  for (i = 0; i < desc->nperiods; i++)
+    {
+      if (lower->ops->allocbuffer != NULL)
+        {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+          bufdesc.session   = desc->session;
+#endif
+          bufdesc.numbytes  = desc->period_bytes;
+          bufdesc.u.pbuffer = &upper->periods[i];
+
+          ret = lower->ops->allocbuffer(lower, &bufdesc);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          apb = upper->periods[i];
+          if (i == 0)
+            {
+              upper->ring = apb->samp;
+            }
+          else if (apb->samp != upper->ring + i * desc->period_bytes)
+            {
+              auderr("ERROR: Buffers of the lower half not contiguous\n");
+              ret = -ENOTSUP;
+              goto errout;
+            }
+        }
+      else
+        {
+          apb = kumm_zalloc(sizeof(*apb));
+          if (apb == NULL)
+            {
+              ret = -ENOMEM;
+              goto errout;
+            }
+
+          apb->i.channels = 1;
+          apb->crefs      = 1;
+          apb->nmaxbytes  = desc->period_bytes;
+          apb->samp       = upper->ring + i * desc->period_bytes;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+          apb->session    = desc->session;
+#endif
+          nxmutex_init(&apb->lock);
+          upper->periods[i] = apb;
+        }
+    }
+
+  /* Start with silence for playback */
+
+  memset(upper->ring, 0, upper->ringsize);
+  up_clean_dcache((uintptr_t)upper->ring,
+                  (uintptr_t)upper->ring + upper->ringsize);
+  return OK;
+
+errout:
+  audio_mmap_release(upper);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mmap_enqueue
+ *
+ * Description:
+ *   Hand a period of the mmap ring back to the lower half.
+ *
+ ****************************************************************************/
+
+static int audio_mmap_enqueue(FAR struct audio_upperhalf_s *upper,
+                              FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+
+  apb->nbytes  = upper->ctrl->period_bytes;
+  apb->curbyte = 0;
+  apb->flags   = 0;
+  return lower->ops->enqueuebuffer(lower, apb);
+}
+
+/****************************************************************************
+ * Name: audio_mmap_start
+ *
+ * Description:
+ *   Queue all the periods of the mmap ring before the stream is started.
+ *   The data the application put in the ring beforehand is played first.
+ *
+ ****************************************************************************/
+
+static int audio_mmap_start(FAR struct audio_upperhalf_s *upper)
+{
+  uint32_t i;
+  int ret;
+
+  upper->cleanptr = upper->ctrl->appl_ptr;
+  upper->running  = true;
+
+  for (i = 0; i < upper->ctrl->nperiods; i++)
+    {
+      ret = audio_mmap_enqueue(upper, upper->periods[i]);
+      if (ret < 0)
+        {
+          upper->running = false;
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mmap_dequeue
+ *
+ * Description:
+ *   The device is done with a period of the mmap ring: advance hw_ptr and
+ *   queue the period again, so the lower half never runs out of buffers.
+ *   poll() is only woken up once 'avail_min' periods are available.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+static void audio_mmap_dequeue(FAR struct audio_upperhalf_s *upper,
+                               FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mmap_ctrl_s *ctrl = upper->ctrl;
+  uint32_t hw;
+
+  /* The periods flushed when the stream is stopped are just dropped */
+
+  if (!upper->running)
+    {
+      return;
+    }
+
+  hw = ctrl->hw_ptr + ctrl->period_bytes;
+  if (hw >= ctrl->boundary)
+    {
+      hw -= ctrl->boundary;
+    }
+
+  if (!upper->capture)
+    {
+      uint32_t filled;
+
+      audio_mmap_clean(upper);
+
+      /* If the application has not written ahead of the device, silence
+       * this period rather than play it again when the ring comes round.
+       */
+
+      filled = audio_mmap_delta(ctrl, hw, ctrl->appl_ptr);
+      if (filled == 0 || filled > upper->ringsize)
+        {
+          ctrl->xruns++;
+          memset(apb->samp, 0, ctrl->period_bytes);
+          up_clean_dcache((uintptr_t)apb->samp,
+                          (uintptr_t)apb->samp + ctrl->period_bytes);
+        }
+    }
+  else if (audio_mmap_delta(ctrl, ctrl->appl_ptr, hw) > upper->ringsize)
+    {
+      /* A period was overwritten before the application read it */
+
+      ctrl->xruns++;
+    }
+
+  /* Publish the new pointer after the data it covers */
+
+  UP_DMB();
+  ctrl->hw_ptr = hw;
+
+  audio_mmap_enqueue(upper, apb);
+
+  if (audio_mmap_avail(upper) >= upper->availmin)
+    {
+      poll_notify(upper->fds, CONFIG_AUDIO_MMAP_NPOLLWAITERS,
+                  upper->capture ? POLLIN : POLLOUT);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mmap
+ *
+ * Description:
+ *   Map the samples of the ring at AUDIO_MMAP_OFFSET_DATA, or the shared
+ *   audio_mmap_ctrl_s at AUDIO_MMAP_OFFSET_CTRL.
+ *
+ ****************************************************************************/
+
+static int audio_mmap(FAR struct file *filep,
+                      FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  int ret;
+
+  ret = nxmutex_lock(&upper->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = -EINVAL;
+  if (upper->ctrl == NULL)
+    {
+      ret = -ENODEV;
+    }
+  else if (map->offset == AUDIO_MMAP_OFFSET_CTRL)
+    {
+      if (map->length <= sizeof(struct audio_mmap_ctrl_s))
+        {
+          map->vaddr = upper->ctrl;
+          ret = OK;
+        }
+    }
+  else if (map->offset >= AUDIO_MMAP_OFFSET_DATA &&
+           map->offset < upper->ringsize &&
+           map->length <= upper->ringsize - map->offset)
+    {
+      map->vaddr = upper->ring + map->offset;
+      ret = OK;
+    }
+
+  nxmutex_unlock(&upper->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_poll
+ *
+ * Description:
+ *   Wait for 'avail_min' periods of the mmap ring to be available.
+ *
+ ****************************************************************************/
+
+static int audio_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  FAR struct pollfd **slot;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  flags = enter_critical_section();
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_AUDIO_MMAP_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              upper->fds[i] = fds;
+              fds->priv     = &upper->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_AUDIO_MMAP_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else if (upper->ctrl != NULL &&
+               audio_mmap_avail(upper) >= upper->availmin)
+        {
+          poll_notify(&fds, 1, upper->capture ? POLLIN : POLLOUT);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif /* CONFIG_AUDIO_MMAP */
+
 /****************************************************************************
  * Name: audio_start
  *
@@ -316,6 +839,17 @@ static int audio_start(FAR struct audio_upperhalf_s *upper)
 
   if (!upper->started)
     {
+#ifdef CONFIG_AUDIO_MMAP
+      if (upper->ctrl != NULL)
+        {
+          ret = audio_mmap_start(upper);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+#endif
+
       /* Invoke the bottom half method to start the audio stream */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
@@ -334,6 +868,12 @@ static int audio_start(FAR struct audio_upperhalf_s *upper)
 
           upper->started = true;
         }
+#ifdef CONFIG_AUDIO_MMAP
+      else
+        {
+          upper->running = false;
+        }
+#endif
     }
 
   return ret;
@@ -457,6 +997,9 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
           if (upper->started)
             {
+#ifdef CONFIG_AUDIO_MMAP
+              upper->running = false;
+#endif
 #ifdef CONFIG_AUDIO_MULTI_SESSION
               session = (FAR void *) arg;
               ret = lower->ops->stop(lower, session);
@@ -464,6 +1007,13 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               ret = lower->ops->stop(lower);
 #endif
               upper->started = false;
+#ifdef CONFIG_AUDIO_MMAP
+              if (upper->ctrl != NULL)
+                {
+                  upper->ctrl->hw_ptr   = 0;
+                  upper->ctrl->appl_ptr = 0;
+                }
+#endif
             }
         }
         break;
@@ -576,11 +1126,38 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
           DEBUGASSERT(lower->ops->enqueuebuffer != NULL);
 
+#ifdef CONFIG_AUDIO_MMAP
+          /* The periods of a mmap ring are the only buffers queued */
+
+          if (upper->ctrl != NULL)
+            {
+              ret = -EBUSY;
+              break;
+            }
+#endif
+
           bufdesc = (FAR struct audio_buf_desc_s *) arg;
           ret = lower->ops->enqueuebuffer(lower, bufdesc->u.buffer);
         }
         break;
 
+#ifdef CONFIG_AUDIO_MMAP
+      /* AUDIOIOC_MMAPSETUP - Set up a ring of periods for mmap()
+       *
+       *   ioctl argument:  pointer to an audio_mmap_desc_s structure
+       */
+
+      case AUDIOIOC_MMAPSETUP:
+        {
+          audinfo("AUDIOIOC_MMAPSETUP\n");
+
+          DEBUGASSERT(lower->ops->enqueuebuffer != NULL);
+          ret = audio_mmap_setup(upper,
+                  (FAR const struct audio_mmap_desc_s *)((uintptr_t)arg));
+        }
+        break;
+#endif
+
       /* AUDIOIOC_REGISTERMQ - Register a client Message Queue
        *
        * TODO:  This needs to have multi session support.
@@ -911,6 +1488,14 @@ static void audio_callback(FAR void *handle, uint16_t reason,
     {
       case AUDIO_CALLBACK_DEQUEUE:
         {
+#ifdef CONFIG_AUDIO_MMAP
+          if (upper->ctrl != NULL)
+            {
+              audio_mmap_dequeue(upper, apb);
+              break;
+            }
+#endif
+
           /* Call the dequeue routine */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
@@ -0,0 +1,1203 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define AUDIO_MIXER_WORK        HPWORK
+#else
+#  define AUDIO_MIXER_WORK        LPWORK
+#endif
+
+#define AUDIO_MIXER_NCH           CONFIG_AUDIO_MIXER_CHANNELS
+#define AUDIO_MIXER_FRAMESIZE     (AUDIO_MIXER_NCH * sizeof(int16_t))
+
+/* Gains and the resampling phase are fixed point numbers.  Gains have
+ * few fractional bits so that the sum of 16 full scale streams still fits
+ * in 32 bits.
+ */
+
+#define AUDIO_MIXER_GAIN_SHIFT    12
+#define AUDIO_MIXER_UNITY         (1 << AUDIO_MIXER_GAIN_SHIFT)
+#define AUDIO_MIXER_PHASE_ONE     (1 << 16)
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+#  define audio_mixer_upper(s, r, a) \
+     (s)->export.upper((s)->export.priv, r, a, OK, s)
+#else
+#  define audio_mixer_upper(s, r, a) \
+     (s)->export.upper((s)->export.priv, r, a, OK)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct audio_mixer_s;
+
+/* This structure describes the state of one stream of the mixer */
+
+struct audio_mixer_stream_s
+{
+  /* This is our appearance to the outside world.  This *MUST* be the first
+   * element of the structure so that we can freely cast between types
+   * struct audio_lowerhalf and struct audio_mixer_stream_s.
+   */
+
+  struct audio_lowerhalf_s export;
+
+  FAR struct audio_mixer_s *mixer;      /* The mixer of the stream */
+  struct dq_queue_s pendq;              /* Buffers queued by the upper half */
+  uint32_t step;                        /* Input frames per output, Q16 */
+  uint32_t phase;                       /* Position after 'prev', Q16 */
+  int16_t  prev[AUDIO_MIXER_NCH];       /* Frames around the position */
+  int16_t  cur[AUDIO_MIXER_NCH];
+  uint16_t gain;                        /* Volume, Q12 */
+  uint8_t  channels;                    /* Channels of the input */
+  uint8_t  bpsamp;                      /* Bits per sample of the input */
+  bool     reserved;                    /* A session is open */
+  bool     started;                     /* The stream is mixed */
+  bool     paused;                      /* The stream is mixed as silence */
+  bool     primed;                      /* 'cur' holds an input frame */
+  bool     final;                       /* The last buffer was used up */
+};
+
+/* This structure describes the state of the mixer */
+
+struct audio_mixer_s
+{
+  FAR struct audio_lowerhalf_s *lower;  /* The output device */
+  mutex_t lock;                         /* Protects the streams */
+  spinlock_t spinlock;                  /* Protects 'freeq' */
+  struct dq_queue_s freeq;              /* Output buffers to be mixed */
+  struct work_s work;                   /* Mixes the output buffers */
+  FAR struct ap_buffer_s **outbufs;     /* Output buffers */
+  FAR int32_t *acc;                     /* Sum of an output buffer */
+  FAR int16_t *scratch;                 /* One stream of an output buffer */
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void *session;                    /* Session of the output device */
+#endif
+  apb_samp_t nbuffers;                  /* Number of output buffers */
+  apb_samp_t nframes;                   /* Frames in an output buffer */
+  bool running;                         /* The output device is started */
+  uint8_t nstarted;                     /* Number of started streams */
+  int nstreams;                         /* Number of streams */
+  struct audio_mixer_stream_s streams[1];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void audio_mixer_flush(FAR struct audio_mixer_stream_s *stream);
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR void *session,
+                                 FAR const struct audio_caps_s *caps);
+#else
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps);
+#endif
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session);
+#else
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session);
+#else
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                              FAR void *session);
+#else
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb);
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                               FAR void **session);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session);
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status,
+                                 FAR void *session);
+#else
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev);
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_audio_mixer_ops =
+{
+  audio_mixer_getcaps,       /* getcaps        */
+  audio_mixer_configure,     /* configure      */
+  audio_mixer_shutdown,      /* shutdown       */
+  audio_mixer_start,         /* start          */
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  audio_mixer_stop,          /* stop           */
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  audio_mixer_pause,         /* pause          */
+  audio_mixer_resume,        /* resume         */
+#endif
+  NULL,                      /* allocbuffer    */
+  NULL,                      /* freebuffer     */
+  audio_mixer_enqueuebuffer, /* enqueue_buffer */
+  NULL,                      /* cancel_buffer  */
+  audio_mixer_ioctl,         /* ioctl          */
+  NULL,                      /* read           */
+  NULL,                      /* write          */
+  audio_mixer_reserve,       /* reserve        */
+  audio_mixer_release        /* release        */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_accumulate
+ *
+ * Description:
+ *   Add the samples of a stream, scaled by its gain, to the sum.  This and
+ *   audio_mixer_saturate() are where the time goes; they are kept as plain
+ *   loops over arrays so that the compiler vectorizes them for the SIMD
+ *   unit of the target (NEON, Helium, RVV...).
+ *
+ ****************************************************************************/
+
+static void audio_mixer_accumulate(FAR int32_t *acc,
+                                   FAR const int16_t *in,
+                                   size_t nsamples, int32_t gain)
+{
+  size_t i;
+
+  for (i = 0; i < nsamples; i++)
+    {
+      acc[i] += in[i] * gain;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_saturate
+ *
+ * Description:
+ *   Scale the sum back to 16-bit samples, clipping what overflows.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_saturate(FAR int16_t *out, FAR const int32_t *acc,
+                                 size_t nsamples)
+{
+  int32_t sample;
+  size_t i;
+
+  for (i = 0; i < nsamples; i++)
+    {
+      sample = acc[i] >> AUDIO_MIXER_GAIN_SHIFT;
+      out[i] = sample > INT16_MAX ? INT16_MAX :
+               sample < INT16_MIN ? INT16_MIN : sample;
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_getframe
+ *
+ * Description:
+ *   Read the next input frame of a stream, converted to 16-bit samples and
+ *   to the channels of the output.  Buffers are given back to the upper
+ *   half as they are used up.
+ *
+ * Returned Value:
+ *   True if a frame was read; false if the stream has no data queued.
+ *
+ ****************************************************************************/
+
+static bool audio_mixer_getframe(FAR struct audio_mixer_stream_s *stream,
+                                 FAR int16_t *frame)
+{
+  FAR struct ap_buffer_s *apb;
+  int16_t in[AUDIO_MIXER_NCH];
+  FAR const uint8_t *p;
+  apb_samp_t size;
+  int32_t sum = 0;
+  int ch;
+
+  size = stream->channels * (stream->bpsamp / 8);
+
+  for (; ; )
+    {
+      apb = (FAR struct ap_buffer_s *)dq_peek(&stream->pendq);
+      if (apb == NULL)
+        {
+          return false;
+        }
+
+      if (apb->curbyte + size <= apb->nbytes)
+        {
+          break;
+        }
+
+      /* The buffer is used up, a partial frame at its end is dropped */
+
+      dq_remfirst(&stream->pendq);
+      apb->flags |= AUDIO_APB_DEQUEUED;
+      audio_mixer_upper(stream, AUDIO_CALLBACK_DEQUEUE, apb);
+
+      if ((apb->flags & AUDIO_APB_FINAL) != 0)
+        {
+          stream->final = true;
+        }
+    }
+
+  p = apb->samp + apb->curbyte;
+  apb->curbyte += size;
+
+  for (ch = 0; ch < stream->channels; ch++)
+    {
+      int16_t sample;
+
+      switch (stream->bpsamp)
+        {
+          case 8:
+            sample = (int16_t)((p[0] - 128) << 8);
+            p += 1;
+            break;
+
+          case 16:
+            sample = (int16_t)(p[0] | (p[1] << 8));
+            p += 2;
+            break;
+
+          default:
+            sample = (int16_t)(p[2] | (p[3] << 8));
+            p += 4;
+            break;
+        }
+
+      sum += sample;
+      if (ch < AUDIO_MIXER_NCH)
+        {
+          in[ch] = sample;
+        }
+    }
+
+  /* Down mixing to mono averages the channels, otherwise the missing ones
+   * repeat the first ones (mono to stereo).
+   */
+
+  if (AUDIO_MIXER_NCH == 1)
+    {
+      frame[0] = sum / stream->channels;
+      return true;
+    }
+
+  for (ch = 0; ch < AUDIO_MIXER_NCH; ch++)
+    {
+      frame[ch] = in[ch % MIN(stream->channels, AUDIO_MIXER_NCH)];
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_resample
+ *
+ * Description:
+ *   Produce up to 'nframes' output frames of a stream at the rate of the
+ *   output, interpolating linearly between the two input frames around
+ *   each output frame.
+ *
+ * Returned Value:
+ *   The number of frames produced; less than asked if the stream ran out
+ *   of data.
+ *
+ ****************************************************************************/
+
+static apb_samp_t
+audio_mixer_resample(FAR struct audio_mixer_stream_s *stream,
+                     FAR int16_t *out, apb_samp_t nframes)
+{
+  apb_samp_t n;
+  int32_t frac;
+  int ch;
+
+  if (!stream->primed)
+    {
+      if (!audio_mixer_getframe(stream, stream->cur))
+        {
+          return 0;
+        }
+
+      memcpy(stream->prev, stream->cur, sizeof(stream->prev));
+      stream->phase  = 0;
+      stream->primed = true;
+    }
+
+  for (n = 0; n < nframes; n++)
+    {
+      while (stream->phase >= AUDIO_MIXER_PHASE_ONE)
+        {
+          memcpy(stream->prev, stream->cur, sizeof(stream->prev));
+          if (!audio_mixer_getframe(stream, stream->cur))
+            {
+              return n;
+            }
+
+          stream->phase -= AUDIO_MIXER_PHASE_ONE;
+        }
+
+      /* Q15 so that the product can not overflow */
+
+      frac = stream->phase >> 1;
+      for (ch = 0; ch < AUDIO_MIXER_NCH; ch++)
+        {
+          *out++ = stream->prev[ch] +
+                   (((stream->cur[ch] - stream->prev[ch]) * frac) >> 15);
+        }
+
+      stream->phase += stream->step;
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_mix
+ *
+ * Description:
+ *   Fill an output buffer with the sum of the running streams.  Streams
+ *   which have no data queued add silence.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_mix(FAR struct audio_mixer_s *mixer,
+                            FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_stream_s *stream;
+  apb_samp_t nsamples = mixer->nframes * AUDIO_MIXER_NCH;
+  apb_samp_t n;
+  int i;
+
+  memset(mixer->acc, 0, nsamples * sizeof(*mixer->acc));
+
+  for (i = 0; i < mixer->nstreams; i++)
+    {
+      stream = &mixer->streams[i];
+      if (!stream->started || stream->paused)
+        {
+          continue;
+        }
+
+      n = audio_mixer_resample(stream, mixer->scratch, mixer->nframes);
+      if (stream->gain != 0)
+        {
+          audio_mixer_accumulate(mixer->acc, mixer->scratch,
+                                 n * AUDIO_MIXER_NCH, stream->gain);
+        }
+    }
+
+  audio_mixer_saturate((FAR int16_t *)apb->samp, mixer->acc, nsamples);
+  apb->nbytes  = mixer->nframes * AUDIO_MIXER_FRAMESIZE;
+  apb->curbyte = 0;
+  apb->flags   = 0;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_worker
+ *
+ * Description:
+ *   Mix the output buffers given back by the output device and queue them
+ *   again.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_worker(FAR void *arg)
+{
+  FAR struct audio_mixer_s *mixer = arg;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  int i;
+
+  nxmutex_lock(&mixer->lock);
+
+  while (mixer->running)
+    {
+      flags = spin_lock_irqsave(&mixer->spinlock);
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&mixer->freeq);
+      spin_unlock_irqrestore(&mixer->spinlock, flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      audio_mixer_mix(mixer, apb);
+      lower->ops->enqueuebuffer(lower, apb);
+    }
+
+  /* Streams done with their last buffer are completed here, the output
+   * device is stopped with the last one.
+   */
+
+  for (i = 0; i < mixer->nstreams; i++)
+    {
+      if (mixer->streams[i].final)
+        {
+          audio_mixer_flush(&mixer->streams[i]);
+        }
+    }
+
+  nxmutex_unlock(&mixer->lock);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_freebuffers
+ ****************************************************************************/
+
+static void audio_mixer_freebuffers(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  struct audio_buf_desc_s bufdesc;
+  apb_samp_t i;
+
+  for (i = 0; mixer->outbufs != NULL && i < mixer->nbuffers; i++)
+    {
+      if (mixer->outbufs[i] == NULL)
+        {
+          continue;
+        }
+
+      if (lower->ops->freebuffer != NULL)
+        {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+          bufdesc.session  = mixer->session;
+#endif
+          bufdesc.numbytes = mixer->outbufs[i]->nmaxbytes;
+          bufdesc.u.buffer = mixer->outbufs[i];
+          lower->ops->freebuffer(lower, &bufdesc);
+        }
+      else
+        {
+          apb_free(mixer->outbufs[i]);
+        }
+    }
+
+  kmm_free(mixer->outbufs);
+  kmm_free(mixer->acc);
+  kmm_free(mixer->scratch);
+  mixer->outbufs = NULL;
+  mixer->acc     = NULL;
+  mixer->scratch = NULL;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_allocbuffers
+ *
+ * Description:
+ *   Allocate the output buffers, with the number and size preferred by the
+ *   output device if it tells them.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_allocbuffers(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  struct audio_buf_desc_s bufdesc;
+  struct ap_buffer_info_s info;
+  apb_samp_t i;
+  int ret;
+
+  info.nbuffers    = CONFIG_AUDIO_NUM_BUFFERS;
+  info.buffer_size = CONFIG_AUDIO_BUFFER_NUMBYTES;
+  if (lower->ops->ioctl != NULL &&
+      lower->ops->ioctl(lower, AUDIOIOC_GETBUFFERINFO,
+                        (unsigned long)((uintptr_t)&info)) < 0)
+    {
+      info.nbuffers    = CONFIG_AUDIO_NUM_BUFFERS;
+      info.buffer_size = CONFIG_AUDIO_BUFFER_NUMBYTES;
+    }
+
+  mixer->nbuffers = info.nbuffers;
+  mixer->nframes  = info.buffer_size / AUDIO_MIXER_FRAMESIZE;
+  if (mixer->nbuffers == 0 || mixer->nframes == 0)
+    {
+      return -EINVAL;
+    }
+
+  mixer->outbufs = kmm_zalloc(mixer->nbuffers * sizeof(*mixer->outbufs));
+  mixer->acc     = kmm_malloc(mixer->nframes * AUDIO_MIXER_NCH *
+                              sizeof(*mixer->acc));
+  mixer->scratch = kmm_malloc(mixer->nframes * AUDIO_MIXER_FRAMESIZE);
+  if (mixer->outbufs == NULL || mixer->acc == NULL ||
+      mixer->scratch == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  for (i = 0; i < mixer->nbuffers; i++)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      bufdesc.session   = mixer->session;
+#endif
+      bufdesc.numbytes  = info.buffer_size;
+      bufdesc.u.pbuffer = &mixer->outbufs[i];
+
+      if (lower->ops->allocbuffer != NULL)
+        {
+          ret = lower->ops->allocbuffer(lower, &bufdesc);
+        }
+      else
+        {
+          ret = apb_alloc(&bufdesc);
+        }
+
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  return OK;
+
+errout:
+  audio_mixer_freebuffers(mixer);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stoplower
+ *
+ * Description:
+ *   Stop the output device once no stream is started any more.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_stoplower(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  irqstate_t flags;
+
+  /* The buffers flushed by the stop are not queued again */
+
+  mixer->running = false;
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  if (lower->ops->stop != NULL)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      lower->ops->stop(lower, mixer->session);
+#else
+      lower->ops->stop(lower);
+#endif
+    }
+#endif
+
+  work_cancel(AUDIO_MIXER_WORK, &mixer->work);
+
+  flags = spin_lock_irqsave(&mixer->spinlock);
+  dq_init(&mixer->freeq);
+  spin_unlock_irqrestore(&mixer->spinlock, flags);
+
+  audio_mixer_freebuffers(mixer);
+
+  if (lower->ops->release != NULL)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      lower->ops->release(lower, mixer->session);
+#else
+      lower->ops->release(lower);
+#endif
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_startlower
+ *
+ * Description:
+ *   Set up and start the output device when the first stream starts.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_startlower(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  struct audio_caps_s caps;
+  apb_samp_t i;
+  int ret = OK;
+
+  if (lower->ops->reserve != NULL)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      ret = lower->ops->reserve(lower, &mixer->session);
+#else
+      ret = lower->ops->reserve(lower);
+#endif
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  memset(&caps, 0, sizeof(caps));
+  caps.ac_len              = sizeof(caps);
+  caps.ac_type             = AUDIO_TYPE_OUTPUT;
+  caps.ac_channels         = AUDIO_MIXER_NCH;
+  caps.ac_controls.hw[0]   = CONFIG_AUDIO_MIXER_SAMPRATE;
+  caps.ac_controls.b[2]    = 16;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->configure(lower, mixer->session, &caps);
+#else
+  ret = lower->ops->configure(lower, &caps);
+#endif
+  if (ret >= 0)
+    {
+      ret = audio_mixer_allocbuffers(mixer);
+    }
+
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  /* Prime the output with all the buffers, mixed from what the streams
+   * have queued so far.
+   */
+
+  mixer->running = true;
+  for (i = 0; i < mixer->nbuffers; i++)
+    {
+      audio_mixer_mix(mixer, mixer->outbufs[i]);
+      ret = lower->ops->enqueuebuffer(lower, mixer->outbufs[i]);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->start(lower, mixer->session);
+#else
+  ret = lower->ops->start(lower);
+#endif
+  if (ret >= 0)
+    {
+      return ret;
+    }
+
+errout:
+  audio_mixer_stoplower(mixer);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_flush
+ *
+ * Description:
+ *   Stop mixing a stream and give its queued buffers back.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_flush(FAR struct audio_mixer_stream_s *stream)
+{
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  FAR struct ap_buffer_s *apb;
+
+  if (!stream->started)
+    {
+      return;
+    }
+
+  stream->started = false;
+  stream->paused  = false;
+  stream->final   = false;
+
+  while ((apb = (FAR struct ap_buffer_s *)dq_remfirst(&stream->pendq)))
+    {
+      apb->flags |= AUDIO_APB_DEQUEUED;
+      audio_mixer_upper(stream, AUDIO_CALLBACK_DEQUEUE, apb);
+    }
+
+  audio_mixer_upper(stream, AUDIO_CALLBACK_COMPLETE, NULL);
+
+  if (--mixer->nstarted == 0 && mixer->running)
+    {
+      audio_mixer_stoplower(mixer);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_getcaps
+ *
+ * Description:
+ *   Get the capabilities of the output device.  Any sample rate is
+ *   accepted and converted though.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_lowerhalf_s *lower = stream->mixer->lower;
+
+  return lower->ops->getcaps(lower, type, caps);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_configure
+ *
+ * Description:
+ *   Set the format of a stream, or its volume.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR void *session,
+                                 FAR const struct audio_caps_s *caps)
+#else
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  uint32_t samprate;
+  int ret = -ENOTTY;
+
+  nxmutex_lock(&mixer->lock);
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_OUTPUT:
+        samprate = caps->ac_controls.hw[0];
+        if (caps->ac_channels < 1 || caps->ac_channels > 15 ||
+            (caps->ac_controls.b[2] != 8 && caps->ac_controls.b[2] != 16 &&
+             caps->ac_controls.b[2] != 32) || samprate == 0)
+          {
+            ret = -ERANGE;
+            break;
+          }
+
+        stream->channels = caps->ac_channels;
+        stream->bpsamp   = caps->ac_controls.b[2];
+        stream->step     = (samprate << 16) / CONFIG_AUDIO_MIXER_SAMPRATE;
+        stream->primed   = false;
+        ret = OK;
+        break;
+
+#ifndef CONFIG_AUDIO_EXCLUDE_VOLUME
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_format.hw == AUDIO_FU_VOLUME)
+          {
+            /* The volume is in the range {0..1000} */
+
+            if (caps->ac_controls.hw[0] > 1000)
+              {
+                ret = -EDOM;
+                break;
+              }
+
+            stream->gain = caps->ac_controls.hw[0] * AUDIO_MIXER_UNITY /
+                           1000;
+            ret = OK;
+          }
+        break;
+#endif
+
+      default:
+        break;
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_shutdown
+ ****************************************************************************/
+
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+
+  nxmutex_lock(&mixer->lock);
+  audio_mixer_flush(stream);
+  nxmutex_unlock(&mixer->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_start
+ *
+ * Description:
+ *   Start mixing a stream, the output device is started with the first.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session)
+#else
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  int ret = OK;
+
+  if (stream->step == 0)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&mixer->lock);
+
+  if (!stream->started)
+    {
+      stream->started = true;
+      stream->primed  = false;
+      if (mixer->nstarted++ == 0)
+        {
+          ret = audio_mixer_startlower(mixer);
+          if (ret < 0)
+            {
+              stream->started = false;
+              mixer->nstarted = 0;
+            }
+        }
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stop
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session)
+#else
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+
+  nxmutex_lock(&mixer->lock);
+  audio_mixer_flush(stream);
+  nxmutex_unlock(&mixer->lock);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_pause
+ *
+ * Description:
+ *   Pause a stream, the others go on playing.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session)
+#else
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  nxmutex_lock(&stream->mixer->lock);
+  stream->paused = true;
+  nxmutex_unlock(&stream->mixer->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_resume
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                              FAR void *session)
+#else
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  nxmutex_lock(&stream->mixer->lock);
+  stream->paused = false;
+  nxmutex_unlock(&stream->mixer->lock);
+  return OK;
+}
+#endif /* CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME */
+
+/****************************************************************************
+ * Name: audio_mixer_enqueuebuffer
+ ****************************************************************************/
+
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  nxmutex_lock(&stream->mixer->lock);
+  apb->curbyte = 0;
+  apb->flags  |= AUDIO_APB_OUTPUT_ENQUEUED;
+  dq_addlast(&apb->dq_entry, &stream->pendq);
+  nxmutex_unlock(&stream->mixer->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_ioctl
+ ****************************************************************************/
+
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg)
+{
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_reserve
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                               FAR void **session)
+#else
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  int ret = OK;
+
+  nxmutex_lock(&stream->mixer->lock);
+  if (stream->reserved)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      stream->reserved = true;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      *session = stream;
+#endif
+    }
+
+  nxmutex_unlock(&stream->mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_release
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session)
+#else
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  nxmutex_lock(&stream->mixer->lock);
+  audio_mixer_flush(stream);
+  stream->reserved = false;
+  nxmutex_unlock(&stream->mixer->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_callback
+ *
+ * Description:
+ *   Lower-to-upper level callback of the output device.  The buffers it is
+ *   done with are mixed again on the work queue.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status, FAR void *session)
+#else
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status)
+#endif
+{
+  FAR struct audio_mixer_s *mixer = arg;
+  irqstate_t flags;
+
+  if (reason != AUDIO_CALLBACK_DEQUEUE || !mixer->running)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&mixer->spinlock);
+  dq_addlast(&apb->dq_entry, &mixer->freeq);
+  spin_unlock_irqrestore(&mixer->spinlock, flags);
+
+  work_queue(AUDIO_MIXER_WORK, &mixer->work, audio_mixer_worker, mixer, 0);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Share an output device between several streams.  One audio device
+ *   named "<name><n>" is registered for each stream.
+ *
+ * Input Parameters:
+ *   name     - The prefix of the names of the audio devices.
+ *   lower    - The lower half audio driver of the output device.
+ *   nstreams - The number of streams.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR const char *name,
+                           FAR struct audio_lowerhalf_s *lower,
+                           int nstreams)
+{
+  FAR struct audio_mixer_stream_s *stream;
+  FAR struct audio_mixer_s *mixer;
+  char devname[32];
+  int ret;
+  int i;
+
+  if (name == NULL || lower == NULL || nstreams <= 0)
+    {
+      return -EINVAL;
+    }
+
+  mixer = kmm_zalloc(sizeof(struct audio_mixer_s) +
+                     sizeof(struct audio_mixer_stream_s) * (nstreams - 1));
+  if (mixer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&mixer->lock);
+  spin_lock_init(&mixer->spinlock);
+  mixer->lower    = lower;
+  mixer->nstreams = nstreams;
+  lower->upper    = audio_mixer_callback;
+  lower->priv     = mixer;
+
+  for (i = 0; i < nstreams; i++)
+    {
+      stream             = &mixer->streams[i];
+      stream->export.ops = &g_audio_mixer_ops;
+      stream->mixer      = mixer;
+      stream->gain       = AUDIO_MIXER_UNITY;
+
+      snprintf(devname, sizeof(devname), "%s%d", name, i);
+      ret = audio_register(devname, &stream->export);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to register %s: %d\n", devname, ret);
+          return ret;
+        }
+    }
+
+  return OK;
+}
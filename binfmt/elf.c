@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <sys/param.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <stdint.h>
 #include <string.h>
@@ -35,7 +36,9 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/binfmt/binfmt.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
 
 #ifdef CONFIG_ELF
 
@@ -55,6 +58,32 @@
 #  define CONFIG_ELF_STACKSIZE 2048
 #endif
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_CACHE
+/* A loaded and bound program kept after its task exits.  Only one task
+ * at a time can run it, its data are restored from the copy taken right
+ * after binding before it is run again.
+ */
+
+struct elf_cache_s
+{
+  FAR char *filename;                  /* Path of the program, NULL if free */
+  off_t filelen;                       /* Size of the file when loaded */
+  struct timespec mtime;               /* Modification time when loaded */
+  FAR const struct symtab_s *exports;  /* Symbol table it is bound to */
+  int nexports;                        /* Number of symbols in exports */
+  struct module_s mod;                 /* The loaded image */
+  main_t entrypt;                      /* Entry point of the program */
+  FAR void *data;                      /* Copy of .data/.bss after binding */
+  size_t datasize;                     /* Size of .data/.bss */
+  uint32_t stamp;                      /* Time of the last use */
+  bool busy;                           /* A task runs the program */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -77,12 +106,297 @@ static struct binfmt_s g_elfbinfmt =
   elf_unloadbinary, /* unload */
 };
 
+#ifdef CONFIG_ELF_CACHE
+static struct elf_cache_s g_elf_cache[CONFIG_ELF_CACHE_NENTRIES];
+static uint32_t g_elf_cache_stamp;
+static mutex_t g_elf_cache_lock = NXMUTEX_INITIALIZER;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_ELF_CACHE
 /****************************************************************************
- * Name: elf_loadbinary
+ * Name: elf_cache_free
+ *
+ * Description:
+ *   Release a cached program that no task runs.
+ *
+ ****************************************************************************/
+
+static void elf_cache_free(FAR struct elf_cache_s *cache)
+{
+  /* The destructors already ran when its last task exited */
+
+  cache->mod.nfini = 0;
+  libelf_uninit(&cache->mod);
+
+  kmm_free(cache->data);
+  kmm_free(cache->filename);
+  memset(cache, 0, sizeof(*cache));
+}
+
+/****************************************************************************
+ * Name: elf_cache_flush
+ *
+ * Description:
+ *   Release all the cached programs that no task runs, when the memory
+ *   is needed to load another program.
+ *
+ * Returned Value:
+ *   The number of programs released.
+ *
+ ****************************************************************************/
+
+static int elf_cache_flush(void)
+{
+  int nfreed = 0;
+  int i;
+
+  nxmutex_lock(&g_elf_cache_lock);
+  for (i = 0; i < CONFIG_ELF_CACHE_NENTRIES; i++)
+    {
+      if (g_elf_cache[i].filename != NULL && !g_elf_cache[i].busy)
+        {
+          elf_cache_free(&g_elf_cache[i]);
+          nfreed++;
+        }
+    }
+
+  nxmutex_unlock(&g_elf_cache_lock);
+  return nfreed;
+}
+
+/****************************************************************************
+ * Name: elf_cache_match
+ ****************************************************************************/
+
+static bool elf_cache_match(FAR struct elf_cache_s *cache,
+                            FAR const char *filename,
+                            FAR const struct stat *buf)
+{
+  return cache->filename != NULL &&
+         strcmp(cache->filename, filename) == 0 &&
+         cache->filelen == buf->st_size &&
+         cache->mtime.tv_sec == buf->st_mtim.tv_sec &&
+         cache->mtime.tv_nsec == buf->st_mtim.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: elf_cache_get
+ *
+ * Description:
+ *   Reuse the cached image of a program if no task runs it, the cached
+ *   images of older versions of the file are released on the way.
+ *
+ * Returned Value:
+ *   0 (OK) if the image is reused, -ENOENT if the program must be loaded.
+ *
+ ****************************************************************************/
+
+static int elf_cache_get(FAR struct binary_s *binp,
+                         FAR const char *filename,
+                         FAR const struct symtab_s *exports, int nexports,
+                         FAR const struct stat *buf)
+{
+  FAR struct elf_cache_s *cache;
+  int ret = -ENOENT;
+  int i;
+
+  nxmutex_lock(&g_elf_cache_lock);
+  for (i = 0; i < CONFIG_ELF_CACHE_NENTRIES; i++)
+    {
+      cache = &g_elf_cache[i];
+      if (cache->filename == NULL || cache->busy ||
+          strcmp(cache->filename, filename) != 0)
+        {
+          continue;
+        }
+
+      if (!elf_cache_match(cache, filename, buf))
+        {
+          elf_cache_free(cache);
+          continue;
+        }
+
+      if (cache->exports != exports || cache->nexports != nexports)
+        {
+          continue;
+        }
+
+      /* Start again from the data of a freshly loaded image */
+
+      if (cache->datasize > 0)
+        {
+          memcpy(cache->mod.dataalloc, cache->data, cache->datasize);
+          up_coherent_dcache((uintptr_t)cache->mod.dataalloc,
+                             cache->datasize);
+        }
+
+      cache->busy  = true;
+      cache->stamp = ++g_elf_cache_stamp;
+
+      memcpy(&binp->mod, &cache->mod, sizeof(binp->mod));
+      binp->entrypt = cache->entrypt;
+      ret = OK;
+      break;
+    }
+
+  nxmutex_unlock(&g_elf_cache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: elf_cache_put
+ *
+ * Description:
+ *   Keep a newly loaded program for the next time it is executed, in a
+ *   free entry or in place of the least recently used one.  The program
+ *   is simply not cached if there is no room or no memory.
+ *
+ ****************************************************************************/
+
+static void elf_cache_put(FAR struct binary_s *binp,
+                          FAR const char *filename,
+                          FAR const struct symtab_s *exports, int nexports,
+                          FAR const struct stat *buf, size_t datasize)
+{
+  FAR struct elf_cache_s *cache = NULL;
+  FAR struct elf_cache_s *entry;
+  int i;
+
+  if (binp->mod.textalloc == NULL)
+    {
+      return;
+    }
+
+#if CONFIG_LIBC_ELF_MAXDEPEND > 0
+  /* Do not hold the shared libraries the program depends upon */
+
+  if (binp->mod.dependencies[0] != NULL)
+    {
+      return;
+    }
+#endif
+
+  nxmutex_lock(&g_elf_cache_lock);
+  for (i = 0; i < CONFIG_ELF_CACHE_NENTRIES; i++)
+    {
+      entry = &g_elf_cache[i];
+      if (entry->filename == NULL)
+        {
+          if (cache == NULL || cache->filename != NULL)
+            {
+              cache = entry;
+            }
+        }
+      else if (elf_cache_match(entry, filename, buf) &&
+               entry->exports == exports && entry->nexports == nexports)
+        {
+          /* Another task runs the cached image */
+
+          goto out;
+        }
+      else if (!entry->busy && (cache == NULL ||
+               (cache->filename != NULL && entry->stamp < cache->stamp)))
+        {
+          cache = entry;
+        }
+    }
+
+  if (cache == NULL)
+    {
+      goto out;
+    }
+
+  if (cache->filename != NULL)
+    {
+      elf_cache_free(cache);
+    }
+
+  cache->filename = strdup(filename);
+  cache->data     = datasize > 0 ? kmm_malloc(datasize) : NULL;
+  if (cache->filename == NULL || (datasize > 0 && cache->data == NULL))
+    {
+      kmm_free(cache->filename);
+      kmm_free(cache->data);
+      memset(cache, 0, sizeof(*cache));
+      goto out;
+    }
+
+  if (datasize > 0)
+    {
+      memcpy(cache->data, binp->mod.dataalloc, datasize);
+    }
+
+  cache->filelen  = buf->st_size;
+  cache->mtime    = buf->st_mtim;
+  cache->exports  = exports;
+  cache->nexports = nexports;
+  cache->entrypt  = binp->entrypt;
+  cache->datasize = datasize;
+  cache->stamp    = ++g_elf_cache_stamp;
+  cache->busy     = true;
+  memcpy(&cache->mod, &binp->mod, sizeof(cache->mod));
+
+out:
+  nxmutex_unlock(&g_elf_cache_lock);
+}
+
+/****************************************************************************
+ * Name: elf_cache_release
+ *
+ * Description:
+ *   Keep the cached image of a program when its task exits.
+ *
+ * Returned Value:
+ *   true if the image is cached; false if it must be unloaded.
+ *
+ ****************************************************************************/
+
+static bool elf_cache_release(FAR struct binary_s *binp)
+{
+  FAR struct elf_cache_s *cache = NULL;
+  FAR void (**array)(void);
+  int i;
+
+  nxmutex_lock(&g_elf_cache_lock);
+  for (i = 0; i < CONFIG_ELF_CACHE_NENTRIES; i++)
+    {
+      if (g_elf_cache[i].busy && binp->mod.textalloc != NULL &&
+          g_elf_cache[i].mod.textalloc == binp->mod.textalloc)
+        {
+          cache = &g_elf_cache[i];
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_elf_cache_lock);
+  if (cache == NULL)
+    {
+      return false;
+    }
+
+  /* Run the destructors as an unload would, the image stays busy until
+   * they are done.
+   */
+
+  array = (FAR void (**)(void))binp->mod.finiarr;
+  for (i = 0; i < binp->mod.nfini; i++)
+    {
+      array[i]();
+    }
+
+  nxmutex_lock(&g_elf_cache_lock);
+  cache->busy = false;
+  nxmutex_unlock(&g_elf_cache_lock);
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: elf_loadfile
  *
  * Description:
  *   Verify that the file is an ELF binary and, if so, load the ELF
@@ -90,10 +404,17 @@ static struct binfmt_s g_elfbinfmt =
  *
  ****************************************************************************/
 
-static int elf_loadbinary(FAR struct binary_s *binp,
-                          FAR const char *filename,
-                          FAR const struct symtab_s *exports,
-                          int nexports)
+#ifdef CONFIG_ELF_CACHE
+static int elf_loadfile(FAR struct binary_s *binp,
+                        FAR const char *filename,
+                        FAR const struct symtab_s *exports,
+                        int nexports, FAR const struct stat *buf)
+#else
+static int elf_loadfile(FAR struct binary_s *binp,
+                        FAR const char *filename,
+                        FAR const struct symtab_s *exports,
+                        int nexports)
+#endif
 {
   struct mod_loadinfo_s loadinfo;
   int ret;
@@ -227,6 +548,18 @@ static int elf_loadbinary(FAR struct binary_s *binp,
     }
 #endif
 
+#ifdef CONFIG_ELF_CACHE
+  /* Only relocatable programs without a GOT are in allocated memory that
+   * can be reused as is.
+   */
+
+  if (loadinfo.ehdr.e_type == ET_REL && loadinfo.gotindex < 0)
+    {
+      elf_cache_put(binp, filename, exports, nexports, buf,
+                    loadinfo.datasize);
+    }
+#endif
+
   libelf_uninitialize(&loadinfo);
   return OK;
 
@@ -237,6 +570,59 @@ errout_with_init:
   return ret;
 }
 
+/****************************************************************************
+ * Name: elf_loadbinary
+ *
+ * Description:
+ *   Load the ELF binary, or reuse its cached image.
+ *
+ ****************************************************************************/
+
+static int elf_loadbinary(FAR struct binary_s *binp,
+                          FAR const char *filename,
+                          FAR const struct symtab_s *exports,
+                          int nexports)
+{
+#ifdef CONFIG_ELF_CACHE
+  struct stat buf;
+  int ret;
+
+  ret = nx_stat(filename, &buf, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = elf_cache_get(binp, filename, exports, nexports, &buf);
+  if (ret == OK)
+    {
+      binfo("Reusing the cached image of %s\n", filename);
+
+      binp->stacksize = CONFIG_ELF_STACKSIZE;
+#  ifdef CONFIG_SCHED_USER_IDENTITY
+      binp->uid  = buf.st_uid;
+      binp->gid  = buf.st_gid;
+      binp->mode = buf.st_mode;
+#  endif
+
+      return OK;
+    }
+
+  ret = elf_loadfile(binp, filename, exports, nexports, &buf);
+
+  /* The memory of the idle cached images is given back if it is needed */
+
+  if (ret == -ENOMEM && elf_cache_flush() > 0)
+    {
+      ret = elf_loadfile(binp, filename, exports, nexports, &buf);
+    }
+
+  return ret;
+#else
+  return elf_loadfile(binp, filename, exports, nexports);
+#endif
+}
+
 /****************************************************************************
  * Name: elf_unloadbinary
  *
@@ -248,6 +634,14 @@ errout_with_init:
 static int elf_unloadbinary(FAR struct binary_s *binp)
 {
   binfo("Unloading %p\n", binp);
+
+#ifdef CONFIG_ELF_CACHE
+  if (elf_cache_release(binp))
+    {
+      return OK;
+    }
+#endif
+
   libelf_uninit(&binp->mod);
 
   return OK;
@@ -32,6 +32,7 @@
 #include <nuttx/mm/mm.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/userspace.h>
+#include <nuttx/vdso.h>
 
 #if defined(CONFIG_BUILD_PROTECTED) && !defined(__KERNEL__)
 
@@ -89,6 +90,12 @@ const struct userspace_s userspace locate_data(".userspace") =
 #ifdef CONFIG_LIBC_USRWORK
   .work_usrstart    = work_usrstart,
 #endif
+
+  /* Time data published by the kernel (declared in include/nuttx/vdso.h) */
+
+#ifdef CONFIG_CLOCK_VDSO
+  .us_vdso          = &g_vdso,
+#endif
 };
 
 /****************************************************************************
@@ -0,0 +1,402 @@
+/****************************************************************************
+ * crypto/aes_hw.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* AES rounds and GHASH with the instructions of the CPU: AES-NI and
+ * PCLMULQDQ on x86_64, the ARMv8 Cryptographic Extension on arm64.
+ *
+ * The round keys are the ones of rijndael_key_setup_enc() and
+ * rijndael_key_setup_dec() stored in byte order, the decryption uses the
+ * equivalent inverse cipher that these instructions expect.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <crypto/gmac.h>
+#include <crypto/rijndael.h>
+
+#if defined(__x86_64__)
+#  include <cpuid.h>
+#  include <immintrin.h>
+#elif defined(__aarch64__)
+#  include <arm_neon.h>
+#else
+#  error CONFIG_CRYPTO_AES_HW is not supported on this architecture
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Only the functions below are built for the extensions, the rest of the
+ * system never runs their instructions on a CPU without them.
+ */
+
+#if defined(__x86_64__)
+#  define AES_HW_TARGET __attribute__((target("aes,pclmul,ssse3")))
+#elif defined(__clang__)
+#  define AES_HW_TARGET __attribute__((target("aes")))
+#else
+#  define AES_HW_TARGET __attribute__((target("+crypto")))
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static int g_aes_hw = -1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aes_hw_probe
+ *
+ * Description:
+ *   Check that the CPU has the AES and the carry-less multiplication
+ *   instructions.
+ *
+ ****************************************************************************/
+
+static bool aes_hw_probe(void)
+{
+#if defined(__x86_64__)
+  unsigned int eax;
+  unsigned int ebx;
+  unsigned int ecx;
+  unsigned int edx;
+
+  if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0)
+    {
+      return false;
+    }
+
+  /* CPUID.1:ECX.AESNI[25], PCLMULQDQ[1] and SSSE3[9] */
+
+  return (ecx & (1 << 25)) != 0 && (ecx & (1 << 1)) != 0 &&
+         (ecx & (1 << 9)) != 0;
+#else
+  uint64_t isar0;
+
+  /* ID_AA64ISAR0_EL1.AES is 2 with both AES and PMULL */
+
+  __asm__ __volatile__("mrs %0, id_aa64isar0_el1" : "=r"(isar0));
+  return ((isar0 >> 4) & 0xf) >= 2;
+#endif
+}
+
+#if defined(__x86_64__)
+/****************************************************************************
+ * Name: ghash_gfmul_hw
+ *
+ * Description:
+ *   Multiply in GF(2^128) two blocks whose bytes are reversed, as in the
+ *   Intel white paper "Carry-Less Multiplication and Its Usage for
+ *   Computing the GCM Mode".
+ *
+ ****************************************************************************/
+
+AES_HW_TARGET
+static __m128i ghash_gfmul_hw(__m128i a, __m128i b)
+{
+  __m128i lo;
+  __m128i hi;
+  __m128i mid;
+  __m128i t1;
+  __m128i t2;
+  __m128i t3;
+
+  lo  = _mm_clmulepi64_si128(a, b, 0x00);
+  hi  = _mm_clmulepi64_si128(a, b, 0x11);
+  mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10),
+                      _mm_clmulepi64_si128(a, b, 0x01));
+  lo  = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+  hi  = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+  /* The operands are bit reflected, shift the product left by one */
+
+  t1 = _mm_srli_epi32(lo, 31);
+  t2 = _mm_srli_epi32(hi, 31);
+  lo = _mm_slli_epi32(lo, 1);
+  hi = _mm_slli_epi32(hi, 1);
+  t3 = _mm_srli_si128(t1, 12);
+  t2 = _mm_slli_si128(t2, 4);
+  t1 = _mm_slli_si128(t1, 4);
+  lo = _mm_or_si128(lo, t1);
+  hi = _mm_or_si128(hi, t2);
+  hi = _mm_or_si128(hi, t3);
+
+  /* Reduce modulo x^128 + x^7 + x^2 + x + 1 */
+
+  t1 = _mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30));
+  t1 = _mm_xor_si128(t1, _mm_slli_epi32(lo, 25));
+  t2 = _mm_srli_si128(t1, 4);
+  t1 = _mm_slli_si128(t1, 12);
+  lo = _mm_xor_si128(lo, t1);
+
+  t3 = _mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2));
+  t3 = _mm_xor_si128(t3, _mm_srli_epi32(lo, 7));
+  t3 = _mm_xor_si128(t3, t2);
+  lo = _mm_xor_si128(lo, t3);
+  return _mm_xor_si128(hi, lo);
+}
+#else
+/****************************************************************************
+ * Name: ghash_clmul
+ ****************************************************************************/
+
+AES_HW_TARGET
+static void ghash_clmul(uint64_t a, uint64_t b, FAR uint64_t *r)
+{
+  uint64x2_t p = vreinterpretq_u64_p128(vmull_p64(a, b));
+
+  r[0] = vgetq_lane_u64(p, 0);
+  r[1] = vgetq_lane_u64(p, 1);
+}
+
+/****************************************************************************
+ * Name: ghash_gfmul_hw
+ *
+ * Description:
+ *   Multiply in GF(2^128) two blocks whose bits are reversed in each byte,
+ *   so that bit i of the little endian 128 bit value is the coefficient of
+ *   x^i.
+ *
+ ****************************************************************************/
+
+AES_HW_TARGET
+static void ghash_gfmul_hw(FAR uint64_t *y, FAR const uint64_t *h)
+{
+  uint64_t lo[2];
+  uint64_t hi[2];
+  uint64_t mid[2];
+  uint64_t r[4];
+  uint64_t t[2];
+
+  ghash_clmul(y[0], h[0], lo);
+  ghash_clmul(y[1], h[1], hi);
+  ghash_clmul(y[0] ^ y[1], h[0] ^ h[1], mid);
+
+  r[0] = lo[0];
+  r[1] = lo[1] ^ mid[0] ^ lo[0] ^ hi[0];
+  r[2] = hi[0] ^ mid[1] ^ lo[1] ^ hi[1];
+  r[3] = hi[1];
+
+  /* Reduce modulo x^128 + x^7 + x^2 + x + 1, x^128 is 0x87 */
+
+  ghash_clmul(r[3], 0x87, t);
+  r[1] ^= t[0];
+  r[2] ^= t[1];
+
+  ghash_clmul(r[2], 0x87, t);
+  y[0] = r[0] ^ t[0];
+  y[1] = r[1] ^ t[1];
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aes_hw_available
+ ****************************************************************************/
+
+bool aes_hw_available(void)
+{
+  if (g_aes_hw < 0)
+    {
+      g_aes_hw = aes_hw_probe();
+    }
+
+  return g_aes_hw;
+}
+
+/****************************************************************************
+ * Name: aes_hw_initialize
+ ****************************************************************************/
+
+void aes_hw_initialize(void)
+{
+  if (aes_hw_available())
+    {
+      ghash_update = ghash_update_hw;
+    }
+}
+
+#if defined(__x86_64__)
+/****************************************************************************
+ * Name: aes_hw_encrypt
+ ****************************************************************************/
+
+AES_HW_TARGET
+void aes_hw_encrypt(FAR const uint8_t *rk, int nr,
+                    FAR const uint8_t *src, FAR uint8_t *dst)
+{
+  FAR const __m128i *k = (FAR const __m128i *)rk;
+  __m128i s;
+  int i;
+
+  s = _mm_xor_si128(_mm_loadu_si128((FAR const __m128i *)src),
+                    _mm_loadu_si128(k));
+  for (i = 1; i < nr; i++)
+    {
+      s = _mm_aesenc_si128(s, _mm_loadu_si128(k + i));
+    }
+
+  s = _mm_aesenclast_si128(s, _mm_loadu_si128(k + nr));
+  _mm_storeu_si128((FAR __m128i *)dst, s);
+}
+
+/****************************************************************************
+ * Name: aes_hw_decrypt
+ ****************************************************************************/
+
+AES_HW_TARGET
+void aes_hw_decrypt(FAR const uint8_t *rk, int nr,
+                    FAR const uint8_t *src, FAR uint8_t *dst)
+{
+  FAR const __m128i *k = (FAR const __m128i *)rk;
+  __m128i s;
+  int i;
+
+  s = _mm_xor_si128(_mm_loadu_si128((FAR const __m128i *)src),
+                    _mm_loadu_si128(k));
+  for (i = 1; i < nr; i++)
+    {
+      s = _mm_aesdec_si128(s, _mm_loadu_si128(k + i));
+    }
+
+  s = _mm_aesdeclast_si128(s, _mm_loadu_si128(k + nr));
+  _mm_storeu_si128((FAR __m128i *)dst, s);
+}
+
+/****************************************************************************
+ * Name: ghash_update_hw
+ ****************************************************************************/
+
+AES_HW_TARGET
+void ghash_update_hw(FAR GHASH_CTX *ctx, FAR uint8_t *x, size_t len)
+{
+  const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                     8, 9, 10, 11, 12, 13, 14, 15);
+  __m128i h;
+  __m128i y;
+
+  h = _mm_shuffle_epi8(_mm_loadu_si128((FAR const __m128i *)ctx->H),
+                       bswap);
+  y = _mm_shuffle_epi8(_mm_loadu_si128((FAR const __m128i *)ctx->Z),
+                       bswap);
+
+  for (; len >= GMAC_BLOCK_LEN; len -= GMAC_BLOCK_LEN, x += GMAC_BLOCK_LEN)
+    {
+      y = _mm_xor_si128(y, _mm_shuffle_epi8(
+                             _mm_loadu_si128((FAR const __m128i *)x),
+                             bswap));
+      y = ghash_gfmul_hw(y, h);
+    }
+
+  y = _mm_shuffle_epi8(y, bswap);
+  _mm_storeu_si128((FAR __m128i *)ctx->S, y);
+  _mm_storeu_si128((FAR __m128i *)ctx->Z, y);
+}
+#else
+/****************************************************************************
+ * Name: aes_hw_encrypt
+ ****************************************************************************/
+
+AES_HW_TARGET
+void aes_hw_encrypt(FAR const uint8_t *rk, int nr,
+                    FAR const uint8_t *src, FAR uint8_t *dst)
+{
+  uint8x16_t s = vld1q_u8(src);
+  int i;
+
+  for (i = 0; i < nr - 1; i++)
+    {
+      s = vaesmcq_u8(vaeseq_u8(s, vld1q_u8(rk + 16 * i)));
+    }
+
+  s = vaeseq_u8(s, vld1q_u8(rk + 16 * i));
+  s = veorq_u8(s, vld1q_u8(rk + 16 * nr));
+  vst1q_u8(dst, s);
+}
+
+/****************************************************************************
+ * Name: aes_hw_decrypt
+ ****************************************************************************/
+
+AES_HW_TARGET
+void aes_hw_decrypt(FAR const uint8_t *rk, int nr,
+                    FAR const uint8_t *src, FAR uint8_t *dst)
+{
+  uint8x16_t s = vld1q_u8(src);
+  int i;
+
+  for (i = 0; i < nr - 1; i++)
+    {
+      s = vaesimcq_u8(vaesdq_u8(s, vld1q_u8(rk + 16 * i)));
+    }
+
+  s = vaesdq_u8(s, vld1q_u8(rk + 16 * i));
+  s = veorq_u8(s, vld1q_u8(rk + 16 * nr));
+  vst1q_u8(dst, s);
+}
+
+/****************************************************************************
+ * Name: ghash_update_hw
+ ****************************************************************************/
+
+AES_HW_TARGET
+void ghash_update_hw(FAR GHASH_CTX *ctx, FAR uint8_t *x, size_t len)
+{
+  uint64_t h[2];
+  uint64_t y[2];
+  uint64x2_t v;
+
+  v    = vreinterpretq_u64_u8(vrbitq_u8(vld1q_u8(ctx->H)));
+  h[0] = vgetq_lane_u64(v, 0);
+  h[1] = vgetq_lane_u64(v, 1);
+  v    = vreinterpretq_u64_u8(vrbitq_u8(vld1q_u8(ctx->Z)));
+  y[0] = vgetq_lane_u64(v, 0);
+  y[1] = vgetq_lane_u64(v, 1);
+
+  for (; len >= GMAC_BLOCK_LEN; len -= GMAC_BLOCK_LEN, x += GMAC_BLOCK_LEN)
+    {
+      v     = vreinterpretq_u64_u8(vrbitq_u8(vld1q_u8(x)));
+      y[0] ^= vgetq_lane_u64(v, 0);
+      y[1] ^= vgetq_lane_u64(v, 1);
+      ghash_gfmul_hw(y, h);
+    }
+
+  v = vcombine_u64(vcreate_u64(y[0]), vcreate_u64(y[1]));
+  vst1q_u8(ctx->S, vrbitq_u8(vreinterpretq_u8_u64(v)));
+  vst1q_u8(ctx->Z, vrbitq_u8(vreinterpretq_u8_u64(v)));
+}
+#endif
@@ -42,18 +42,27 @@
  * it suitable for use in embedded applications.
  *
  *
- * The current state is correct functionality and adequate performance.
- * There may well be room for performance-optimizations and improvements.
+ * Modular exponentiation with an odd modulus runs in the Montgomery domain
+ * on 32-bit limbs, with fixed windows and a constant-time table lookup for
+ * the long exponents.  It and the Karatsuba products of bignum_mul() take
+ * their tables from the heap, and fall back to the slower code if it is
+ * exhausted.
  */
 
 /****************************************************************************
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <stdio.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/param.h>
 #include <crypto/bn.h>
+#include <nuttx/kmalloc.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -63,6 +72,26 @@
 
 #define require(p, msg) ASSERT(p && msg)
 
+/* DTYPE words in a 32-bit limb and limbs in a big number */
+
+#define BN_LIMB_WORDS         (4 / WORD_SIZE)
+#define BN_LIMBS              (BN_ARRAY_SIZE / BN_LIMB_WORDS)
+
+/* Operands of at least this many limbs are multiplied with Karatsuba */
+
+#define BN_KARATSUBA_LIMBS    16
+
+/* Window of the long exponents, 2^w powers of the base are precomputed */
+
+#define BN_WINDOW_MAX         5
+
+/* Allocation of bn_mont_pow(): the 2^w powers, the modulus, the
+ * accumulator, a selected power and a k + 2 limbs scratch.
+ */
+
+#define BN_MONT_SIZE(k, w)    ((((4 + (1 << (w))) * (k)) + 2) * \
+                               sizeof(uint32_t))
+
 /****************************************************************************
  * Private Functions Prototype
  ****************************************************************************/
@@ -194,6 +223,484 @@ void bignum_add_sub(struct bn *a, struct bn *b, struct bn *c, int flip)
     }
 }
 
+/* The multiplication and Montgomery helpers below work on 32-bit limbs,
+ * least significant first, whatever WORD_SIZE is.  The 32x32+32+32 bit
+ * multiply-accumulate of their inner loops never overflows 64 bits and is
+ * a single UMAAL on Armv6 and later.
+ */
+
+static void bn_to_limbs(FAR const struct bn *a, FAR uint32_t *l, int k)
+{
+  int i;
+  int j;
+
+  for (i = 0; i < k; i++)
+    {
+      l[i] = 0;
+      for (j = 0; j < BN_LIMB_WORDS; j++)
+        {
+          l[i] |= (uint32_t)a->array[i * BN_LIMB_WORDS + j] <<
+                  (8 * WORD_SIZE * j);
+        }
+    }
+}
+
+static void bn_from_limbs(FAR struct bn *a, FAR const uint32_t *l, int k)
+{
+  int i;
+  int j;
+
+  bignum_init(a);
+  for (i = 0; i < k; i++)
+    {
+      for (j = 0; j < BN_LIMB_WORDS; j++)
+        {
+          a->array[i * BN_LIMB_WORDS + j] =
+            (DTYPE)(l[i] >> (8 * WORD_SIZE * j));
+        }
+    }
+}
+
+static int bn_limbs_used(FAR const uint32_t *l, int k)
+{
+  while (k > 0 && l[k - 1] == 0)
+    {
+      k--;
+    }
+
+  return k;
+}
+
+/* r = a + b, return the carry */
+
+static uint32_t bn_limbs_add(FAR uint32_t *r, FAR const uint32_t *a,
+                             FAR const uint32_t *b, int k)
+{
+  uint64_t c = 0;
+  int i;
+
+  for (i = 0; i < k; i++)
+    {
+      c += (uint64_t)a[i] + b[i];
+      r[i] = (uint32_t)c;
+      c >>= 32;
+    }
+
+  return (uint32_t)c;
+}
+
+/* r = a - b, return the borrow */
+
+static uint32_t bn_limbs_sub(FAR uint32_t *r, FAR const uint32_t *a,
+                             FAR const uint32_t *b, int k)
+{
+  uint32_t borrow = 0;
+  uint64_t d;
+  int i;
+
+  for (i = 0; i < k; i++)
+    {
+      d = (uint64_t)a[i] - b[i] - borrow;
+      r[i] = (uint32_t)d;
+      borrow = (uint32_t)(d >> 32) & 1;
+    }
+
+  return borrow;
+}
+
+/* r = |a - b|, return 1 if a < b.  No branch depends on the values. */
+
+static uint32_t bn_limbs_absdiff(FAR uint32_t *r, FAR const uint32_t *a,
+                                 FAR const uint32_t *b, int k)
+{
+  uint32_t borrow = bn_limbs_sub(r, a, b, k);
+  uint32_t mask = 0 - borrow;
+  uint64_t c = borrow;
+  int i;
+
+  for (i = 0; i < k; i++)
+    {
+      c += r[i] ^ mask;
+      r[i] = (uint32_t)c;
+      c >>= 32;
+    }
+
+  return borrow;
+}
+
+/* Schoolbook r = a * b, truncated to the nr limbs of r */
+
+static void bn_limbs_mul(FAR uint32_t *r, FAR const uint32_t *a, int na,
+                         FAR const uint32_t *b, int nb, int nr)
+{
+  uint64_t c;
+  int i;
+  int j;
+
+  memset(r, 0, nr * sizeof(uint32_t));
+  for (i = 0; i < na && i < nr; i++)
+    {
+      c = 0;
+      for (j = 0; j < nb && i + j < nr; j++)
+        {
+          c += (uint64_t)a[i] * b[j] + r[i + j];
+          r[i + j] = (uint32_t)c;
+          c >>= 32;
+        }
+
+      if (i + nb < nr)
+        {
+          r[i + nb] = (uint32_t)c;
+        }
+    }
+}
+
+/* Karatsuba r = a * b, the 2n limbs of the full product.  t is a scratch
+ * of 4n limbs.  z1 = z0 + z2 - (a0 - a1)(b0 - b1) is formed without a
+ * branch on the sign of the middle product.
+ */
+
+static void bn_karatsuba(FAR uint32_t *r, FAR const uint32_t *a,
+                         FAR const uint32_t *b, int n, FAR uint32_t *t)
+{
+  uint32_t mask;
+  uint32_t top;
+  uint64_t c;
+  int h = n / 2;
+  int i;
+
+  if (n < BN_KARATSUBA_LIMBS || (n & 1) != 0)
+    {
+      bn_limbs_mul(r, a, n, b, n, 2 * n);
+      return;
+    }
+
+  bn_karatsuba(r, a, b, h, t);
+  bn_karatsuba(r + n, a + h, b + h, h, t);
+
+  /* mask is all ones when (a0 - a1)(b0 - b1) >= 0 and is subtracted */
+
+  mask = bn_limbs_absdiff(t, a, a + h, h) ^
+         bn_limbs_absdiff(t + h, b, b + h, h);
+  mask = mask - 1;
+  bn_karatsuba(t + n, t, t + h, h, t + 2 * n);
+
+  top = bn_limbs_add(t, r, r + n, n);
+  c = mask & 1;
+  for (i = 0; i < n; i++)
+    {
+      c += (uint64_t)t[i] + (t[n + i] ^ mask);
+      t[i] = (uint32_t)c;
+      c >>= 32;
+    }
+
+  top += (uint32_t)c + mask;
+
+  /* r += z1 << (32 * h) */
+
+  c = (uint64_t)bn_limbs_add(r + h, r + h, t, n) + top;
+  for (i = h + n; i < 2 * n; i++)
+    {
+      c += r[i];
+      r[i] = (uint32_t)c;
+      c >>= 32;
+    }
+}
+
+/* r = a * b / 2^(32k) mod n, for a, b < n odd and n0 = -1 / n mod 2^32.
+ * The product is accumulated in the k + 2 limbs of t (CIOS), r may alias
+ * a or b.  The final subtraction is done by mask, so the timing does not
+ * depend on the values.
+ */
+
+static void bn_mont_mul(FAR uint32_t *r, FAR const uint32_t *a,
+                        FAR const uint32_t *b, FAR const uint32_t *n,
+                        uint32_t n0, int k, FAR uint32_t *t)
+{
+  uint32_t mask;
+  uint32_t m;
+  uint64_t c;
+  int i;
+  int j;
+
+  memset(t, 0, (k + 2) * sizeof(uint32_t));
+  for (i = 0; i < k; i++)
+    {
+      c = 0;
+      for (j = 0; j < k; j++)
+        {
+          c += (uint64_t)a[j] * b[i] + t[j];
+          t[j] = (uint32_t)c;
+          c >>= 32;
+        }
+
+      c += t[k];
+      t[k] = (uint32_t)c;
+      t[k + 1] = (uint32_t)(c >> 32);
+
+      m = t[0] * n0;
+      c = ((uint64_t)m * n[0] + t[0]) >> 32;
+      for (j = 1; j < k; j++)
+        {
+          c += (uint64_t)m * n[j] + t[j];
+          t[j - 1] = (uint32_t)c;
+          c >>= 32;
+        }
+
+      c += t[k];
+      t[k - 1] = (uint32_t)c;
+      t[k] = t[k + 1] + (uint32_t)(c >> 32);
+    }
+
+  /* t < 2n, keep it only if t - n borrowed out of the top limb */
+
+  mask = bn_limbs_sub(r, t, n, k) & (t[k] ^ 1);
+  mask = 0 - mask;
+  for (i = 0; i < k; i++)
+    {
+      r[i] = (t[i] & mask) | (r[i] & ~mask);
+    }
+}
+
+/* x = 2x mod n, for x < n.  t is a scratch of k limbs. */
+
+static void bn_mont_double(FAR uint32_t *x, FAR const uint32_t *n, int k,
+                           FAR uint32_t *t)
+{
+  uint32_t carry = 0;
+  uint32_t mask;
+  uint32_t v;
+  int i;
+
+  for (i = 0; i < k; i++)
+    {
+      v = x[i];
+      x[i] = (v << 1) | carry;
+      carry = v >> 31;
+    }
+
+  mask = bn_limbs_sub(t, x, n, k) & (carry ^ 1);
+  mask = 0 - mask;
+  for (i = 0; i < k; i++)
+    {
+      x[i] = (x[i] & mask) | (t[i] & ~mask);
+    }
+}
+
+static int bn_bit(FAR const struct bn *a, int i)
+{
+  if (i >= BN_ARRAY_SIZE * WORD_SIZE * 8)
+    {
+      return 0;
+    }
+
+  return (a->array[i / (WORD_SIZE * 8)] >> (i % (WORD_SIZE * 8))) & 1;
+}
+
+/* res = a ^ b mod n for an odd n, in the Montgomery domain.
+ *
+ * Exponents of up to 32 bits, the public ones, take the plain binary
+ * method.  Longer exponents are scanned in fixed windows, each window
+ * squares w times then multiplies by a power read from the table with a
+ * mask over all of its entries: neither the operations nor the memory
+ * accesses depend on the bits of the exponent.
+ *
+ * Return -EINVAL if n is even and -ENOMEM if the table cannot be
+ * allocated, pow_mod_faster() then does it the slow way.
+ */
+
+static int bn_mont_pow(FAR struct bn *a, FAR struct bn *b,
+                       FAR struct bn *n, FAR struct bn *res)
+{
+  FAR uint32_t *table;
+  FAR uint32_t *mod;
+  FAR uint32_t *acc;
+  FAR uint32_t *sel;
+  FAR uint32_t *t;
+  struct bn tmp;
+  uint32_t mask;
+  uint32_t n0;
+  uint32_t d;
+  int ebits;
+  int bits;
+  int val;
+  int k;
+  int w;
+  int e;
+  int i;
+  int j;
+
+  for (k = BN_LIMBS; k > 0; k--)
+    {
+      for (j = 0; j < BN_LIMB_WORDS; j++)
+        {
+          if (n->array[(k - 1) * BN_LIMB_WORDS + j] != 0)
+            {
+              break;
+            }
+        }
+
+      if (j < BN_LIMB_WORDS)
+        {
+          break;
+        }
+    }
+
+  if (k == 0 || (n->array[0] & 1) == 0 || n->s < 0 || a->s < 0)
+    {
+      return -EINVAL;
+    }
+
+  for (ebits = BN_ARRAY_SIZE * WORD_SIZE * 8; ebits > 0; ebits--)
+    {
+      if (bn_bit(b, ebits - 1))
+        {
+          break;
+        }
+    }
+
+  w = ebits > 256 ? BN_WINDOW_MAX : ebits > 32 ? 4 : 1;
+
+  table = kmm_malloc(BN_MONT_SIZE(k, w));
+  if (table == NULL && w > 1)
+    {
+      w = 1;
+      table = kmm_malloc(BN_MONT_SIZE(k, w));
+    }
+
+  if (table == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mod   = table + (1 << w) * k;
+  acc   = mod + k;
+  sel   = acc + k;
+  t     = sel + k;
+
+  bn_to_limbs(n, mod, k);
+  if (k == 1 && mod[0] == 1)
+    {
+      bignum_init(res);
+      kmm_free(table);
+      return OK;
+    }
+
+  /* n0 = -1 / n mod 2^32, Newton's iteration doubles the correct bits of
+   * an inverse, the odd n is its own inverse mod 8.
+   */
+
+  n0 = mod[0];
+  for (i = 0; i < 4; i++)
+    {
+      n0 *= 2 - mod[0] * n0;
+    }
+
+  n0 = 0 - n0;
+
+  /* acc = R mod n, with R = 2^(32k): double the highest power of two
+   * below n up to R.
+   */
+
+  for (bits = 32 * k; ((mod[k - 1] >> ((bits - 1) % 32)) & 1) == 0; )
+    {
+      bits--;
+    }
+
+  memset(acc, 0, k * sizeof(uint32_t));
+  acc[(bits - 1) / 32] = UINT32_C(1) << ((bits - 1) % 32);
+  for (i = bits - 1; i < 32 * k; i++)
+    {
+      bn_mont_double(acc, mod, k, t);
+    }
+
+  /* sel = R^2 mod n: 32k = e * 2^j with e odd, double R mod n e times to
+   * 2^e R (the Montgomery form of 2^e), then square it j times.
+   */
+
+  for (e = 32 * k, j = 0; (e & 1) == 0; e >>= 1)
+    {
+      j++;
+    }
+
+  memcpy(sel, acc, k * sizeof(uint32_t));
+  for (i = 0; i < e; i++)
+    {
+      bn_mont_double(sel, mod, k, t);
+    }
+
+  for (i = 0; i < j; i++)
+    {
+      bn_mont_mul(sel, sel, sel, mod, n0, k, t);
+    }
+
+  /* table[i] = a^i R mod n, a must be below R for the Montgomery form */
+
+  for (i = k * BN_LIMB_WORDS; i < BN_ARRAY_SIZE; i++)
+    {
+      if (a->array[i] != 0)
+        {
+          bignum_mod(a, n, &tmp);
+          a = &tmp;
+          break;
+        }
+    }
+
+  memcpy(table, acc, k * sizeof(uint32_t));
+  bn_to_limbs(a, table + k, k);
+  bn_mont_mul(table + k, table + k, sel, mod, n0, k, t);
+  for (i = 2; i < (1 << w); i++)
+    {
+      bn_mont_mul(table + i * k, table + (i - 1) * k, table + k,
+                  mod, n0, k, t);
+    }
+
+  if (w == 1)
+    {
+      for (i = ebits - 1; i >= 0; i--)
+        {
+          bn_mont_mul(acc, acc, acc, mod, n0, k, t);
+          if (bn_bit(b, i))
+            {
+              bn_mont_mul(acc, acc, table + k, mod, n0, k, t);
+            }
+        }
+    }
+  else
+    {
+      for (i = (ebits + w - 1) / w * w - w; i >= 0; i -= w)
+        {
+          for (val = 0, j = w - 1; j >= 0; j--)
+            {
+              bn_mont_mul(acc, acc, acc, mod, n0, k, t);
+              val = (val << 1) | bn_bit(b, i + j);
+            }
+
+          for (e = 0; e < (1 << w); e++)
+            {
+              d = (uint32_t)(e ^ val);
+              mask = ((d | (0 - d)) >> 31) - 1;
+              for (j = 0; j < k; j++)
+                {
+                  sel[j] = (sel[j] & ~mask) | (table[e * k + j] & mask);
+                }
+            }
+
+          bn_mont_mul(acc, acc, sel, mod, n0, k, t);
+        }
+    }
+
+  /* Out of the Montgomery domain: acc * 1 / R mod n */
+
+  memset(sel, 0, k * sizeof(uint32_t));
+  sel[0] = 1;
+  bn_mont_mul(acc, acc, sel, mod, n0, k, t);
+  bn_from_limbs(res, acc, k);
+
+  kmm_free(table);
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -438,45 +945,51 @@ void bignum_sub_abs(FAR struct bn *a, FAR struct bn *b, FAR struct bn *c)
 
 void bignum_mul(FAR struct bn *a, FAR struct bn *b, FAR struct bn *c)
 {
-  struct bn row;
-  struct bn tmp;
-  int i;
-  int j;
+  uint32_t la[BN_LIMBS];
+  uint32_t lb[BN_LIMBS];
+  uint32_t lc[BN_LIMBS];
+  FAR uint32_t *r;
+  int na;
+  int nb;
+  int n;
+  int s;
 
   require(a, "a is null");
   require(b, "b is null");
   require(c, "c is null");
 
-  bignum_init(c);
-
-  for (i = 0; i < BN_ARRAY_SIZE; ++i)
-    {
-      bignum_init(&row);
+  bn_to_limbs(a, la, BN_LIMBS);
+  bn_to_limbs(b, lb, BN_LIMBS);
+  na = bn_limbs_used(la, BN_LIMBS);
+  nb = bn_limbs_used(lb, BN_LIMBS);
+  s  = a->s * b->s;
 
-      for (j = 0; j < BN_ARRAY_SIZE; ++j)
-        {
-          if (i + j < BN_ARRAY_SIZE)
-            {
-              bignum_init(&tmp);
-              DTYPE_TMP intermediate =
-                ((DTYPE_TMP)a->array[i] * (DTYPE_TMP)b->array[j]);
-              bignum_from_int(&tmp, intermediate);
-              lshift_word(&tmp, i + j);
-              bignum_add_abs(&tmp, &row, &row);
-            }
-        }
+  /* Karatsuba pays for operands of close sizes, they are padded to a
+   * multiple of 8 limbs so that it recurses a few times.
+   */
 
-      bignum_add_abs(c, &row, c);
+  n = (MAX(na, nb) + 7) & ~7;
+  r = NULL;
+  if (MIN(na, nb) >= BN_KARATSUBA_LIMBS && 2 * MIN(na, nb) > n)
+    {
+      r = kmm_malloc(6 * n * sizeof(uint32_t));
     }
 
-  if (bignum_is_zero(c) != 0)
+  if (r != NULL)
     {
-      c->s = 1;
+      bn_karatsuba(r, la, lb, n, r + 2 * n);
+      memcpy(lc, r, MIN(2 * n, BN_LIMBS) * sizeof(uint32_t));
+      memset(lc + MIN(2 * n, BN_LIMBS), 0,
+             (BN_LIMBS - MIN(2 * n, BN_LIMBS)) * sizeof(uint32_t));
+      kmm_free(r);
     }
   else
     {
-      c->s = a->s * b->s;
+      bn_limbs_mul(lc, la, na, lb, nb, BN_LIMBS);
     }
+
+  bn_from_limbs(c, lc, BN_LIMBS);
+  c->s = bignum_is_zero(c) != 0 ? 1 : s;
 }
 
 void bignum_div(FAR struct bn *a, FAR struct bn *b, FAR struct bn *c)
@@ -870,6 +1383,14 @@ void pow_mod_faster(FAR struct bn *a, FAR struct bn *b,
   struct bn tmpa;
   struct bn tmpb;
   struct bn tmp;
+
+  /* Montgomery for the odd moduli, RSA and DH ones are */
+
+  if (bn_mont_pow(a, b, n, res) == OK)
+    {
+      return;
+    }
+
   bignum_assign(&tmpa, a);
   bignum_assign(&tmpb, b);
 
@@ -11,6 +11,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <endian.h>
 #include <string.h>
 #include <sys/types.h>
 
@@ -146,6 +147,98 @@ static void chacha_ivsetup(FAR chacha_ctx *x,
   x->input[15] = U8TO32_LITTLE(iv + 4);
 }
 
+#ifdef CONFIG_CRYPTO_CHACHA_SIMD
+
+/* Four blocks side by side, lane i of each vector is a word of block i */
+
+typedef uint32_t chacha_vec_t __attribute__((vector_size(16)));
+
+#define VROTATE(v, c) (((v) << (c)) | ((v) >> (32 - (c))))
+
+#define VQUARTERROUND(a, b, c, d)                    \
+  do                                                 \
+    {                                                \
+      a += b; d ^= a; d = VROTATE(d, 16);            \
+      c += d; b ^= c; b = VROTATE(b, 12);            \
+      a += b; d ^= a; d = VROTATE(d, 8);             \
+      c += d; b ^= c; b = VROTATE(b, 7);             \
+    }                                                \
+  while (0)
+
+static void chacha_encrypt_blocks4(FAR chacha_ctx *x,
+                                   FAR const uint8_t *m,
+                                   FAR uint8_t *c)
+{
+  const chacha_vec_t lanes =
+  {
+    0, 1, 2, 3
+  };
+
+  chacha_vec_t v[16];
+  chacha_vec_t j[16];
+  uint32_t out[16][4];
+  uint32_t w;
+  int b;
+  int i;
+
+  for (i = 0; i < 16; i++)
+    {
+      for (b = 0; b < 4; b++)
+        {
+          j[i][b] = x->input[i];
+        }
+    }
+
+  /* The counter of each block, with the carry into the next word */
+
+  j[12] += lanes;
+  j[13] -= (chacha_vec_t)(j[12] < lanes);
+
+  memcpy(v, j, sizeof(v));
+  for (i = 20; i > 0; i -= 2)
+    {
+      VQUARTERROUND(v[0], v[4], v[8], v[12]);
+      VQUARTERROUND(v[1], v[5], v[9], v[13]);
+      VQUARTERROUND(v[2], v[6], v[10], v[14]);
+      VQUARTERROUND(v[3], v[7], v[11], v[15]);
+      VQUARTERROUND(v[0], v[5], v[10], v[15]);
+      VQUARTERROUND(v[1], v[6], v[11], v[12]);
+      VQUARTERROUND(v[2], v[7], v[8], v[13]);
+      VQUARTERROUND(v[3], v[4], v[9], v[14]);
+    }
+
+  for (i = 0; i < 16; i++)
+    {
+      v[i] += j[i];
+    }
+
+  memcpy(out, v, sizeof(out));
+  for (b = 0; b < 4; b++)
+    {
+      for (i = 0; i < 16; i++)
+        {
+          w = htole32(out[i][b]);
+#ifndef KEYSTREAM_ONLY
+          memcpy(&out[i][b], m + 4 * i, sizeof(w));
+          w ^= out[i][b];
+#endif
+          memcpy(c + 4 * i, &w, sizeof(w));
+        }
+
+      c += 64;
+#ifndef KEYSTREAM_ONLY
+      m += 64;
+#endif
+    }
+
+  x->input[12] += 4;
+  if (x->input[12] < 4)
+    {
+      x->input[13]++;
+    }
+}
+#endif
+
 static void chacha_encrypt_bytes(FAR chacha_ctx *x,
                                  FAR const uint8_t *m,
                                  FAR uint8_t *c,
@@ -192,6 +285,18 @@ static void chacha_encrypt_bytes(FAR chacha_ctx *x,
       return;
     }
 
+#ifdef CONFIG_CRYPTO_CHACHA_SIMD
+  for (; bytes >= 256; bytes -= 256, m += 256, c += 256)
+    {
+      chacha_encrypt_blocks4(x, m, c);
+    }
+
+  if (!bytes)
+    {
+      return;
+    }
+#endif
+
   j0 = x->input[0];
   j1 = x->input[1];
   j2 = x->input[2];
@@ -35,6 +35,8 @@
 #include <debug.h>
 #include <errno.h>
 #include <crypto/cryptodev.h>
+#include <crypto/rijndael.h>
+#include <crypto/sha2.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/mutex.h>
 #include <nuttx/kmalloc.h>
@@ -563,6 +565,7 @@ int crypto_invoke(FAR struct cryptop *crp)
     {
       crp->crp_etype = -EINVAL;
       nxmutex_unlock(&g_crypto_lock);
+      crypto_done(crp);
       return 0;
     }
 
@@ -601,8 +604,16 @@ int crypto_invoke(FAR struct cryptop *crp)
           crp->crp_etype = error;
         }
     }
+  else if (crypto_drivers[hid].cc_flags & CRYPTOCAP_F_ASYNC)
+    {
+      /* The driver completes the request */
+
+      nxmutex_unlock(&g_crypto_lock);
+      return 0;
+    }
 
   nxmutex_unlock(&g_crypto_lock);
+  crypto_done(crp);
   return 0;
 
 migrate:
@@ -621,9 +632,21 @@ migrate:
 
   crp->crp_etype = -EAGAIN;
   nxmutex_unlock(&g_crypto_lock);
+  crypto_done(crp);
   return 0;
 }
 
+/* Complete a crypto request, call its callback if it has one. */
+
+void crypto_done(FAR struct cryptop *crp)
+{
+  crp->crp_flags |= CRYPTO_F_DONE;
+  if (crp->crp_callback != NULL)
+    {
+      crp->crp_callback(crp);
+    }
+}
+
 /* Release a set of crypto descriptors. */
 
 void crypto_freereq(FAR struct cryptop *crp)
@@ -726,6 +749,14 @@ out:
 
 int up_cryptoinitialize(void)
 {
+#ifdef CONFIG_CRYPTO_AES_HW
+  aes_hw_initialize();
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA2_HW
+  sha2_hw_initialize();
+#endif
+
 #ifdef CONFIG_CRYPTO_ALGTEST
   int ret = crypto_test();
   if (ret)
@@ -47,6 +47,8 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/drivers/drivers.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 
 #include <crypto/xform.h>
 #include <crypto/cryptodev.h>
@@ -72,9 +74,24 @@ int cryptodevallowsoft = 0;
  * Private Types
  ****************************************************************************/
 
+/* An operation of CIOCASYNCCRYPT, on the pending list of its session
+ * until it is done, then on the completions of its fcrypt.
+ */
+
+struct casync
+{
+  TAILQ_ENTRY(casync) next;
+  FAR struct csession *cse;
+  FAR struct cryptop *crp;
+  uint32_t ses;
+  uint32_t reqid;
+};
+
 struct csession
 {
   TAILQ_ENTRY(csession) next;
+  TAILQ_HEAD(casynclist, casync) pending;
+  FAR struct fcrypt *fcr;
   uint64_t sid;
   uint32_t ses;
 
@@ -96,6 +113,11 @@ struct fcrypt
 {
   TAILQ_HEAD(csessionlist, csession) csessions;
   TAILQ_HEAD(cryptkoplist, cryptkop) crpk_ret;
+  struct casynclist crp_ret;  /* Completed CIOCASYNCCRYPT operations */
+  spinlock_t lock;            /* Protects the asynchronous lists */
+  sem_t drain;                /* Posted to the waiters of a session */
+  int waiters;                /* Number of threads waiting on drain */
+  int nasync;                 /* Operations not fetched yet */
   int sesn;
   FAR struct pollfd *fds;
 };
@@ -135,6 +157,14 @@ static FAR struct csession *csecreate(FAR struct fcrypt *, uint64_t,
                                       uint32_t, bool, bool);
 static int csefree(FAR struct csession *);
 
+static void fcrinit(FAR struct fcrypt *);
+static void csedrain(FAR struct fcrypt *, FAR struct csession *);
+static int cryptodev_prepare(FAR struct csession *,
+                             FAR struct crypt_op *, FAR struct cryptop **);
+static int cryptodev_asyncop(FAR struct fcrypt *, FAR struct crypt_mop *);
+static int cryptodev_asyncfetch(FAR struct fcrypt *,
+                                FAR struct crypt_mres *);
+static int cryptodev_cb(FAR struct cryptop *);
 static int cryptodev_op(FAR struct csession *,
                         FAR struct crypt_op *);
 static int cryptodev_key(FAR struct fcrypt *, FAR struct crypt_kop *);
@@ -356,6 +386,7 @@ bail:
           }
 
         csedelete(fcr, cse);
+        csedrain(fcr, cse);
         error = csefree(cse);
         break;
       case CIOCCRYPT:
@@ -368,6 +399,12 @@ bail:
 
         error = cryptodev_op(cse, cop);
         break;
+      case CIOCASYNCCRYPT:
+        error = cryptodev_asyncop(fcr, (FAR struct crypt_mop *)arg);
+        break;
+      case CIOCASYNCFETCH:
+        error = cryptodev_asyncfetch(fcr, (FAR struct crypt_mres *)arg);
+        break;
       case CIOCKEY:
         error = cryptodev_key(fcr, (FAR struct crypt_kop *)arg);
         break;
@@ -384,14 +421,16 @@ bail:
   return error;
 }
 
-static int cryptodev_op(FAR struct csession *cse,
-                        FAR struct crypt_op *cop)
+/* Build the request of an operation, the caller frees it */
+
+static int cryptodev_prepare(FAR struct csession *cse,
+                             FAR struct crypt_op *cop,
+                             FAR struct cryptop **crpp)
 {
   FAR struct cryptop *crp = NULL;
   FAR struct cryptodesc *crde = NULL;
   FAR struct cryptodesc *crda = NULL;
   int error = OK;
-  uint32_t hid;
 
   /* number of requests, not logical and */
 
@@ -496,6 +535,31 @@ static int cryptodev_op(FAR struct csession *cse,
       crp->crp_mac = cop->mac;
     }
 
+  *crpp = crp;
+  return OK;
+
+bail:
+  if (crp)
+    {
+      crypto_freereq(crp);
+    }
+
+  return error;
+}
+
+static int cryptodev_op(FAR struct csession *cse,
+                        FAR struct crypt_op *cop)
+{
+  FAR struct cryptop *crp;
+  int error;
+  uint32_t hid;
+
+  error = cryptodev_prepare(cse, cop, &crp);
+  if (error < 0)
+    {
+      return error;
+    }
+
   /* try the fast path first */
 
   crp->crp_flags = CRYPTO_F_IOV | CRYPTO_F_NOQUEUE;
@@ -530,30 +594,160 @@ dispatch:
   crypto_invoke(crp);
 processed:
 
-  if (crde && (cop->flags & COP_FLAG_UPDATE) == 0)
+  if (cse->error)
     {
-      crde->crd_flags &= ~CRD_F_IV_EXPLICIT;
+      error = cse->error;
+    }
+  else
+    {
+      error = crp->crp_etype;
     }
 
-  if (cse->error)
+  crypto_freereq(crp);
+  return error;
+}
+
+/* Start a batch of operations, return how many are started */
+
+static int cryptodev_asyncop(FAR struct fcrypt *fcr,
+                             FAR struct crypt_mop *mop)
+{
+  FAR struct csession *cse;
+  FAR struct cryptop *crp;
+  FAR struct casync *req;
+  irqstate_t flags;
+  unsigned i;
+  int error = -EINVAL;
+
+  for (i = 0; i < mop->count; i++)
     {
-      error = cse->error;
-      goto bail;
+      cse = csefind(fcr, mop->ops[i].ses);
+      if (cse == NULL)
+        {
+          error = -EINVAL;
+          break;
+        }
+
+      /* Hold back until the application fetches its completions */
+
+      flags = spin_lock_irqsave(&fcr->lock);
+      if (fcr->nasync >= CONFIG_CRYPTO_CRYPTODEV_ASYNC_MAX)
+        {
+          spin_unlock_irqrestore(&fcr->lock, flags);
+          error = -EAGAIN;
+          break;
+        }
+
+      fcr->nasync++;
+      spin_unlock_irqrestore(&fcr->lock, flags);
+
+      req = kmm_zalloc(sizeof(*req));
+      if (req == NULL)
+        {
+          error = -ENOMEM;
+        }
+      else
+        {
+          error = cryptodev_prepare(cse, &mop->ops[i], &crp);
+        }
+
+      if (error < 0)
+        {
+          kmm_free(req);
+          flags = spin_lock_irqsave(&fcr->lock);
+          fcr->nasync--;
+          spin_unlock_irqrestore(&fcr->lock, flags);
+          break;
+        }
+
+      req->cse   = cse;
+      req->crp   = crp;
+      req->ses   = cse->ses;
+      req->reqid = mop->ops[i].reqid;
+
+      crp->crp_opaque   = req;
+      crp->crp_callback = cryptodev_cb;
+      crp->crp_flags    = CRYPTO_F_IOV;
+
+      flags = spin_lock_irqsave(&fcr->lock);
+      TAILQ_INSERT_TAIL(&cse->pending, req, next);
+      spin_unlock_irqrestore(&fcr->lock, flags);
+
+      /* A software or synchronous driver completes it right away, an
+       * asynchronous one queues it and calls crypto_done() later.
+       */
+
+      crypto_invoke(crp);
     }
 
-  if (crp->crp_etype != 0)
+  return i > 0 ? i : error;
+}
+
+/* Called by crypto_done(), possibly from the interrupt of a driver */
+
+static int cryptodev_cb(FAR struct cryptop *crp)
+{
+  FAR struct casync *req = crp->crp_opaque;
+  FAR struct fcrypt *fcr = req->cse->fcr;
+  irqstate_t flags;
+  bool wake = false;
+
+  flags = spin_lock_irqsave(&fcr->lock);
+  TAILQ_REMOVE(&req->cse->pending, req, next);
+  TAILQ_INSERT_TAIL(&fcr->crp_ret, req, next);
+  if (fcr->waiters > 0)
     {
-      error = crp->crp_etype;
-      goto bail;
+      fcr->waiters--;
+      wake = true;
     }
 
-bail:
-  if (crp)
+  spin_unlock_irqrestore(&fcr->lock, flags);
+
+  if (wake)
     {
-      crypto_freereq(crp);
+      nxsem_post(&fcr->drain);
     }
 
-  return error;
+  if (fcr->fds != NULL)
+    {
+      poll_notify(&fcr->fds, 1, POLLIN);
+    }
+
+  return OK;
+}
+
+static int cryptodev_asyncfetch(FAR struct fcrypt *fcr,
+                                FAR struct crypt_mres *mres)
+{
+  FAR struct casync *req;
+  irqstate_t flags;
+  unsigned n;
+
+  for (n = 0; n < mres->count; n++)
+    {
+      flags = spin_lock_irqsave(&fcr->lock);
+      req = TAILQ_FIRST(&fcr->crp_ret);
+      if (req != NULL)
+        {
+          TAILQ_REMOVE(&fcr->crp_ret, req, next);
+          fcr->nasync--;
+        }
+
+      spin_unlock_irqrestore(&fcr->lock, flags);
+      if (req == NULL)
+        {
+          break;
+        }
+
+      mres->res[n].ses    = req->ses;
+      mres->res[n].reqid  = req->reqid;
+      mres->res[n].status = req->crp->crp_etype;
+      crypto_freereq(req->crp);
+      kmm_free(req);
+    }
+
+  mres->count = n;
+  return n > 0 ? OK : -EAGAIN;
 }
 
 static int cryptodev_key(FAR struct fcrypt *fcr, FAR struct crypt_kop *kop)
@@ -810,7 +1004,7 @@ static int cryptof_poll(FAR struct file *filep,
 
   if (setup)
     {
-      if (!TAILQ_EMPTY(&fcr->crpk_ret))
+      if (!TAILQ_EMPTY(&fcr->crpk_ret) || !TAILQ_EMPTY(&fcr->crp_ret))
         {
           poll_notify(&fds, 1, POLLIN);
           return OK;
@@ -838,14 +1032,23 @@ static int cryptof_close(FAR struct file *filep)
   FAR struct fcrypt *fcr = filep->f_priv;
   FAR struct csession *cse;
   FAR struct cryptkop *krp;
+  FAR struct casync *req;
   int i;
 
   while ((cse = TAILQ_FIRST(&fcr->csessions)))
     {
       TAILQ_REMOVE(&fcr->csessions, cse, next);
+      csedrain(fcr, cse);
       (void)csefree(cse);
     }
 
+  while ((req = TAILQ_FIRST(&fcr->crp_ret)))
+    {
+      TAILQ_REMOVE(&fcr->crp_ret, req, next);
+      crypto_freereq(req->crp);
+      kmm_free(req);
+    }
+
   while ((krp = TAILQ_FIRST(&fcr->crpk_ret)))
     {
       TAILQ_REMOVE(&fcr->crpk_ret, krp, krp_next);
@@ -862,6 +1065,7 @@ static int cryptof_close(FAR struct file *filep)
       kmm_free(krp);
     }
 
+  nxsem_destroy(&fcr->drain);
   kmm_free(fcr);
   filep->f_priv = NULL;
   return 0;
@@ -900,7 +1104,7 @@ static int cryptof_open(FAR struct file *filep)
       return -ENOMEM;
     }
 
-  TAILQ_INIT(&fcrd->csessions);
+  fcrinit(fcrd);
   TAILQ_FOREACH(cse, &fcr->csessions, next)
     {
       bzero(&crie, sizeof(crie));
@@ -1025,12 +1229,12 @@ static int cryptoioctl(FAR struct file *filep, int cmd, unsigned long arg)
             return -ENOMEM;
           }
 
-        TAILQ_INIT(&fcr->csessions);
-        TAILQ_INIT(&fcr->crpk_ret);
+        fcrinit(fcr);
 
         fd = file_allocate_from_inode(&g_cryptoinode, 0, 0, fcr, 0);
         if (fd < 0)
           {
+            nxsem_destroy(&fcr->drain);
             kmm_free(fcr);
             return fd;
           }
@@ -1046,6 +1250,36 @@ static int cryptoioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return error;
 }
 
+static void fcrinit(FAR struct fcrypt *fcr)
+{
+  TAILQ_INIT(&fcr->csessions);
+  TAILQ_INIT(&fcr->crpk_ret);
+  TAILQ_INIT(&fcr->crp_ret);
+  spin_lock_init(&fcr->lock);
+  nxsem_init(&fcr->drain, 0, 0);
+}
+
+/* Wait for the asynchronous operations of a session */
+
+static void csedrain(FAR struct fcrypt *fcr, FAR struct csession *cse)
+{
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&fcr->lock);
+      if (TAILQ_EMPTY(&cse->pending))
+        {
+          spin_unlock_irqrestore(&fcr->lock, flags);
+          return;
+        }
+
+      fcr->waiters++;
+      spin_unlock_irqrestore(&fcr->lock, flags);
+      nxsem_wait_uninterruptible(&fcr->drain);
+    }
+}
+
 static FAR struct csession *csefind(FAR struct fcrypt *fcr, u_int ses)
 {
   FAR struct csession *cse;
@@ -1104,6 +1338,8 @@ static FAR struct csession *csecreate(FAR struct fcrypt *fcr, uint64_t sid,
       cse->txform = txform;
       cse->thash = thash;
       cse->error = 0;
+      cse->fcr = fcr;
+      TAILQ_INIT(&cse->pending);
       cseadd(fcr, cse);
     }
 
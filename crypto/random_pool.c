@@ -34,12 +34,19 @@
 #include <assert.h>
 #include <errno.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
 #include <nuttx/random.h>
 #include <nuttx/board.h>
 #include <nuttx/clock.h>
 #include <nuttx/mutex.h>
 #include <nuttx/crypto/blake2s.h>
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+#  define KEYSTREAM_ONLY
+#  include "chacha_private.h"
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -72,9 +79,23 @@ struct rng_s
   volatile uint8_t rd_prev_time;
   volatile uint16_t rd_prev_irq;
   bool output_initialized;
+  volatile uint32_t generation; /* Incremented by each reseed */
   struct blake2xs_rng_s blake2xs;
 };
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+/* The ChaCha20 generator of a CPU.  Only that CPU uses it, with its
+ * interrupts disabled, so the requests of different CPUs never contend.
+ */
+
+struct rng_cpu_s
+{
+  uint8_t key[32];              /* Replaced by each request */
+  uint32_t generation;          /* g_rng.generation at the last reseed */
+  uint32_t uses;                /* Requests since the last reseed */
+};
+#endif
+
 enum
 {
   POOL_SIZE = ENTROPY_POOL_SIZE,
@@ -93,6 +114,11 @@ static struct rng_s g_rng =
   NXMUTEX_INITIALIZER,
 };
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+static struct rng_cpu_s g_rng_cpu[CONFIG_SMP_NCPUS];
+static const uint8_t g_rng_iv[8];
+#endif
+
 #ifdef CONFIG_BOARD_ENTROPY_POOL
 /* Entropy pool structure can be provided by board source. Use for this is,
  * for example, allocate entropy pool from special area of RAM which content
@@ -306,6 +332,7 @@ static void rng_reseed(void)
   g_rng.blake2xs.param.node_depth = 0;
 
   g_rng.output_initialized = true;
+  g_rng.generation++;
 }
 
 static void rng_buf_internal(FAR uint8_t *bytes, size_t nbytes)
@@ -359,6 +386,45 @@ static void rng_buf_internal(FAR uint8_t *bytes, size_t nbytes)
     }
 }
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+/****************************************************************************
+ * Name: rng_cpu_reseed
+ *
+ * Description:
+ *   Mix new BLAKE2Xs output into the key of the generator of this CPU.
+ *   The caller may be moved to another CPU while it waits for the pool,
+ *   the generator of that one is then reseeded, which is as good.
+ *
+ ****************************************************************************/
+
+static void rng_cpu_reseed(void)
+{
+  FAR struct rng_cpu_s *cpu;
+  uint8_t seed[32];
+  uint32_t generation;
+  irqstate_t flags;
+  int i;
+
+  nxmutex_lock(&g_rng.rd_lock);
+  rng_buf_internal(seed, sizeof(seed));
+  generation = g_rng.generation;
+  nxmutex_unlock(&g_rng.rd_lock);
+
+  flags = up_irq_save();
+  cpu = &g_rng_cpu[up_this_cpu()];
+  for (i = 0; i < sizeof(seed); i++)
+    {
+      cpu->key[i] ^= seed[i];
+    }
+
+  cpu->generation = generation;
+  cpu->uses = 0;
+  up_irq_restore(flags);
+
+  explicit_bzero(seed, sizeof(seed));
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -526,7 +592,62 @@ void up_randompool_initialize(void)
 
 void up_rngbuf(FAR void *bytes, size_t nbytes)
 {
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  FAR struct rng_cpu_s *cpu;
+  FAR uint8_t *out = bytes;
+  irqstate_t flags;
+  uint8_t block[64];
+  chacha_ctx ctx;
+  bool reseed;
+  size_t n;
+
+  flags  = up_irq_save();
+  cpu    = &g_rng_cpu[up_this_cpu()];
+  reseed = !g_rng.output_initialized ||
+           cpu->generation != g_rng.generation ||
+           cpu->uses >= CONFIG_CRYPTO_RANDOM_POOL_PERCPU_RESEED ||
+           g_rng.rd_newentr >= MAX_SEED_NEW_ENTROPY_WORDS;
+  up_irq_restore(flags);
+
+  if (reseed)
+    {
+      rng_cpu_reseed();
+    }
+
+  /* Fast key erasure: one block under the key of the CPU gives its next
+   * key and, in its second half, the output or the key of the output
+   * stream.  The key of the CPU is never seen again once overwritten.
+   */
+
+  flags = up_irq_save();
+  cpu   = &g_rng_cpu[up_this_cpu()];
+  chacha_keysetup(&ctx, cpu->key, 256);
+  chacha_ivsetup(&ctx, g_rng_iv, NULL);
+  chacha_encrypt_bytes(&ctx, block, block, sizeof(block));
+  memcpy(cpu->key, block, sizeof(cpu->key));
+  cpu->uses++;
+  up_irq_restore(flags);
+
+  if (nbytes <= sizeof(block) - sizeof(cpu->key))
+    {
+      memcpy(out, block + sizeof(cpu->key), nbytes);
+    }
+  else
+    {
+      chacha_keysetup(&ctx, block + sizeof(cpu->key), 256);
+      chacha_ivsetup(&ctx, g_rng_iv, NULL);
+      for (; nbytes > 0; nbytes -= n, out += n)
+        {
+          n = MIN(nbytes, UINT32_MAX & ~63);
+          chacha_encrypt_bytes(&ctx, out, out, n);
+        }
+    }
+
+  explicit_bzero(block, sizeof(block));
+  explicit_bzero(&ctx, sizeof(ctx));
+#else
   nxmutex_lock(&g_rng.rd_lock);
   rng_buf_internal(bytes, nbytes);
   nxmutex_unlock(&g_rng.rd_lock);
+#endif
 }
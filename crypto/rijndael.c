@@ -24,6 +24,7 @@
  ****************************************************************************/
 
 #include <sys/param.h>
+#include <endian.h>
 
 #include <crypto/rijndael.h>
 
@@ -1348,6 +1349,25 @@ static void rijndaeldecrypt(FAR const uint32_t *rk,
   PUTU32(pt + 12, s3);
 }
 
+#ifdef CONFIG_CRYPTO_AES_HW
+/* store the schedules in byte order if the CPU does the rounds */
+
+static void rijndael_set_key_hw(FAR rijndael_ctx *ctx)
+{
+  int i;
+
+  ctx->hw = aes_hw_available();
+  for (i = 0; ctx->hw && i < 4 * (ctx->nr + 1); i++)
+    {
+      ctx->ek[i] = htobe32(ctx->ek[i]);
+      if (!ctx->enc_only)
+        {
+          ctx->dk[i] = htobe32(ctx->dk[i]);
+        }
+    }
+}
+#endif
+
 /* setup key context for encryption only */
 
 int rijndael_set_key_enc_only(FAR rijndael_ctx *ctx,
@@ -1364,6 +1384,9 @@ int rijndael_set_key_enc_only(FAR rijndael_ctx *ctx,
 
   ctx->nr = rounds;
   ctx->enc_only = 1;
+#ifdef CONFIG_CRYPTO_AES_HW
+  rijndael_set_key_hw(ctx);
+#endif
 
   return 0;
 }
@@ -1387,6 +1410,9 @@ int rijndael_set_key(FAR rijndael_ctx *ctx, FAR const u_char *key, int bits)
 
   ctx->nr = rounds;
   ctx->enc_only = 0;
+#ifdef CONFIG_CRYPTO_AES_HW
+  rijndael_set_key_hw(ctx);
+#endif
 
   return 0;
 }
@@ -1395,6 +1421,14 @@ void rijndael_decrypt(FAR rijndael_ctx *ctx,
                       FAR const u_char *src,
                       FAR u_char *dst)
 {
+#ifdef CONFIG_CRYPTO_AES_HW
+  if (ctx->hw)
+    {
+      aes_hw_decrypt((FAR const uint8_t *)ctx->dk, ctx->nr, src, dst);
+      return;
+    }
+#endif
+
   rijndaeldecrypt(ctx->dk, ctx->nr, src, dst);
 }
 
@@ -1402,5 +1436,13 @@ void rijndael_encrypt(FAR rijndael_ctx *ctx,
                       FAR const u_char *src,
                       FAR u_char *dst)
 {
+#ifdef CONFIG_CRYPTO_AES_HW
+  if (ctx->hw)
+    {
+      aes_hw_encrypt((FAR const uint8_t *)ctx->ek, ctx->nr, src, dst);
+      return;
+    }
+#endif
+
   rijndaelencrypt(ctx->ek, ctx->nr, src, dst);
 }
@@ -35,11 +35,25 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <endian.h>
+#include <stdbool.h>
 #include <string.h>
 #include <sys/time.h>
 #include <crypto/sha2.h>
 
+#ifdef CONFIG_CRYPTO_SHA2_HW
+#  if defined(__x86_64__)
+#    include <cpuid.h>
+#    include <immintrin.h>
+#  elif defined(__aarch64__)
+#    include <arm_neon.h>
+#  else
+#    error CONFIG_CRYPTO_SHA2_HW is not supported on this architecture
+#  endif
+#endif
+
 /* UNROLLED TRANSFORM LOOP NOTE:
  * You can define SHA2_UNROLL_TRANSFORM to use the unrolled transform
  * loop version for the hash transform rounds (defined using macros
@@ -170,6 +184,23 @@ void sha512last(FAR SHA2_CTX *);
 void sha256transform(FAR uint32_t *, FAR const uint8_t *);
 void sha512transform(FAR uint64_t *, FAR const uint8_t *);
 
+/* The block functions, sha2_hw_initialize() replaces them with the ones
+ * using the SHA instructions of the CPU.
+ */
+
+#ifdef CONFIG_CRYPTO_SHA2_HW
+static CODE void (*g_sha256transform)(FAR uint32_t *, FAR const uint8_t *) =
+  sha256transform;
+static CODE void (*g_sha512transform)(FAR uint64_t *, FAR const uint8_t *) =
+  sha512transform;
+
+#  define SHA256TRANSFORM(s, d) g_sha256transform(s, d)
+#  define SHA512TRANSFORM(s, d) g_sha512transform(s, d)
+#else
+#  define SHA256TRANSFORM(s, d) sha256transform(s, d)
+#  define SHA512TRANSFORM(s, d) sha512transform(s, d)
+#endif
+
 /* SHA-XYZ INITIAL HASH VALUES AND CONSTANTS */
 
 /* Hash constant words K for SHA-256: */
@@ -296,6 +327,241 @@ const static uint64_t sha512_initial_hash_value[8] =
   0x5be0cd19137e2179ull
 };
 
+#ifdef CONFIG_CRYPTO_SHA2_HW
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Only these functions are built for the extensions, they never run on a
+ * CPU without them.
+ */
+
+#  if defined(__x86_64__)
+#    define SHA256_HW_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+#  elif defined(__clang__)
+#    define SHA256_HW_TARGET __attribute__((target("sha2")))
+#    define SHA512_HW_TARGET __attribute__((target("sha3")))
+#  else
+#    define SHA256_HW_TARGET __attribute__((target("+crypto")))
+#    define SHA512_HW_TARGET __attribute__((target("+sha3")))
+#  endif
+
+/****************************************************************************
+ * Name: sha2_hw_probe
+ *
+ * Description:
+ *   Return 0 if the CPU has no SHA instructions, 1 if it has the SHA-256
+ *   ones and 2 if it has the SHA-512 ones too.
+ *
+ ****************************************************************************/
+
+static int sha2_hw_probe(void)
+{
+#  if defined(__x86_64__)
+  unsigned int eax;
+  unsigned int ebx;
+  unsigned int ecx;
+  unsigned int edx;
+
+  /* CPUID.1:ECX.SSSE3[9] and SSE4.1[19], CPUID.(7,0):EBX.SHA[29] */
+
+  if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0 ||
+      (ecx & (1 << 9)) == 0 || (ecx & (1 << 19)) == 0 ||
+      __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0)
+    {
+      return 0;
+    }
+
+  return (ebx & (1 << 29)) != 0;
+#  else
+  uint64_t isar0;
+
+  /* ID_AA64ISAR0_EL1.SHA2 is 1 with SHA-256, 2 with SHA-512 too */
+
+  __asm__ __volatile__("mrs %0, id_aa64isar0_el1" : "=r"(isar0));
+  return (isar0 >> 12) & 0xf;
+#  endif
+}
+
+#  if defined(__x86_64__)
+/****************************************************************************
+ * Name: sha256transform_hw
+ ****************************************************************************/
+
+SHA256_HW_TARGET
+static void sha256transform_hw(FAR uint32_t *state, FAR const uint8_t *data)
+{
+  const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bull,
+                                       0x0405060700010203ull);
+  __m128i abef;
+  __m128i cdgh;
+  __m128i save0;
+  __m128i save1;
+  __m128i m[4];
+  __m128i k;
+  __m128i t;
+  int i;
+
+  /* The instructions keep the state as ABEF and CDGH */
+
+  t     = _mm_shuffle_epi32(_mm_loadu_si128((FAR __m128i *)&state[0]),
+                            0xb1);
+  cdgh  = _mm_shuffle_epi32(_mm_loadu_si128((FAR __m128i *)&state[4]),
+                            0x1b);
+  abef  = _mm_alignr_epi8(t, cdgh, 8);
+  cdgh  = _mm_blend_epi16(cdgh, t, 0xf0);
+  save0 = abef;
+  save1 = cdgh;
+
+  for (i = 0; i < 4; i++)
+    {
+      m[i] = _mm_shuffle_epi8(
+               _mm_loadu_si128((FAR const __m128i *)(data + 16 * i)),
+               bswap);
+    }
+
+  /* Four rounds per step, m[] holds the next 16 words of the schedule */
+
+  for (i = 0; i < 16; i++)
+    {
+      k    = _mm_add_epi32(m[i & 3],
+                           _mm_loadu_si128((FAR const __m128i *)
+                                           &K256[4 * i]));
+      cdgh = _mm_sha256rnds2_epu32(cdgh, abef, k);
+      abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(k, 0x0e));
+
+      if (i < 12)
+        {
+          t        = _mm_alignr_epi8(m[(i + 3) & 3], m[(i + 2) & 3], 4);
+          m[i & 3] = _mm_sha256msg1_epu32(m[i & 3], m[(i + 1) & 3]);
+          m[i & 3] = _mm_sha256msg2_epu32(_mm_add_epi32(m[i & 3], t),
+                                          m[(i + 3) & 3]);
+        }
+    }
+
+  abef = _mm_shuffle_epi32(_mm_add_epi32(abef, save0), 0x1b);
+  cdgh = _mm_shuffle_epi32(_mm_add_epi32(cdgh, save1), 0xb1);
+  _mm_storeu_si128((FAR __m128i *)&state[0],
+                   _mm_blend_epi16(abef, cdgh, 0xf0));
+  _mm_storeu_si128((FAR __m128i *)&state[4],
+                   _mm_alignr_epi8(cdgh, abef, 8));
+}
+#  else
+/****************************************************************************
+ * Name: sha256transform_hw
+ ****************************************************************************/
+
+SHA256_HW_TARGET
+static void sha256transform_hw(FAR uint32_t *state, FAR const uint8_t *data)
+{
+  uint32x4_t abcd;
+  uint32x4_t efgh;
+  uint32x4_t save0;
+  uint32x4_t save1;
+  uint32x4_t m[4];
+  uint32x4_t k;
+  uint32x4_t t;
+  int i;
+
+  abcd  = vld1q_u32(&state[0]);
+  efgh  = vld1q_u32(&state[4]);
+  save0 = abcd;
+  save1 = efgh;
+
+  for (i = 0; i < 4; i++)
+    {
+      m[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+    }
+
+  /* Four rounds per step, m[] holds the next 16 words of the schedule */
+
+  for (i = 0; i < 16; i++)
+    {
+      k = vaddq_u32(m[i & 3], vld1q_u32(&K256[4 * i]));
+      if (i < 12)
+        {
+          m[i & 3] = vsha256su1q_u32(vsha256su0q_u32(m[i & 3],
+                                                     m[(i + 1) & 3]),
+                                     m[(i + 2) & 3], m[(i + 3) & 3]);
+        }
+
+      t    = abcd;
+      abcd = vsha256hq_u32(abcd, efgh, k);
+      efgh = vsha256h2q_u32(efgh, t, k);
+    }
+
+  vst1q_u32(&state[0], vaddq_u32(abcd, save0));
+  vst1q_u32(&state[4], vaddq_u32(efgh, save1));
+}
+
+/****************************************************************************
+ * Name: sha512transform_hw
+ ****************************************************************************/
+
+SHA512_HW_TARGET
+static void sha512transform_hw(FAR uint64_t *state, FAR const uint8_t *data)
+{
+  /* Each step does two rounds and moves the state by one of five
+   * registers, s[r[3]] and s[r[4]] receive the new words.
+   */
+
+  static const uint8_t rotation[25] =
+  {
+    0, 1, 2, 3, 4, 3, 0, 4, 2, 1, 2, 3, 1, 4, 0,
+    4, 2, 0, 1, 3, 1, 4, 3, 0, 2
+  };
+
+  FAR const uint8_t *r;
+  uint64x2_t save[4];
+  uint64x2_t s[5];
+  uint64x2_t m[8];
+  uint64x2_t kw;
+  uint64x2_t fg;
+  uint64x2_t de;
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      s[i]    = vld1q_u64(&state[2 * i]);
+      save[i] = s[i];
+    }
+
+  for (i = 0; i < 8; i++)
+    {
+      m[i] = vreinterpretq_u64_u8(vrev64q_u8(vld1q_u8(data + 16 * i)));
+    }
+
+  for (i = 0; i < 40; i++)
+    {
+      r       = &rotation[5 * (i % 5)];
+      kw      = vaddq_u64(m[i & 7], vld1q_u64(&K512[2 * i]));
+      kw      = vextq_u64(kw, kw, 1);
+      fg      = vextq_u64(s[r[2]], s[r[3]], 1);
+      de      = vextq_u64(s[r[1]], s[r[2]], 1);
+      s[r[3]] = vaddq_u64(s[r[3]], kw);
+
+      if (i < 32)
+        {
+          kw       = vextq_u64(m[(i + 4) & 7], m[(i + 5) & 7], 1);
+          m[i & 7] = vsha512su1q_u64(vsha512su0q_u64(m[i & 7],
+                                                     m[(i + 1) & 7]),
+                                     m[(i + 7) & 7], kw);
+        }
+
+      s[r[3]] = vsha512hq_u64(s[r[3]], fg, de);
+      s[r[4]] = vaddq_u64(s[r[1]], s[r[3]]);
+      s[r[3]] = vsha512h2q_u64(s[r[3]], s[r[1]], s[r[0]]);
+    }
+
+  for (i = 0; i < 4; i++)
+    {
+      vst1q_u64(&state[2 * i], vaddq_u64(s[i], save[i]));
+    }
+}
+#  endif
+#endif /* CONFIG_CRYPTO_SHA2_HW */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -548,7 +814,7 @@ void sha256update(FAR SHA2_CTX *context,
           context->bitcount[0] += freespace << 3;
           len -= freespace;
           data += freespace;
-          sha256transform(context->state.st32, context->buffer);
+          SHA256TRANSFORM(context->state.st32, context->buffer);
         }
       else
         {
@@ -568,7 +834,7 @@ void sha256update(FAR SHA2_CTX *context,
     {
       /* Process as many complete blocks as we can */
 
-      sha256transform(context->state.st32, data);
+      SHA256TRANSFORM(context->state.st32, data);
       context->bitcount[0] += SHA256_BLOCK_LENGTH << 3;
       len -= SHA256_BLOCK_LENGTH;
       data += SHA256_BLOCK_LENGTH;
@@ -622,7 +888,7 @@ void sha256last(FAR SHA2_CTX *context)
 
           /* Do second-to-last transform: */
 
-          sha256transform(context->state.st32, context->buffer);
+          SHA256TRANSFORM(context->state.st32, context->buffer);
 
           /* And set-up for the last transform: */
 
@@ -648,7 +914,7 @@ void sha256last(FAR SHA2_CTX *context)
 
   /* Final transform: */
 
-  sha256transform(context->state.st32, context->buffer);
+  SHA256TRANSFORM(context->state.st32, context->buffer);
 }
 
 void sha256final(FAR uint8_t *digest, FAR SHA2_CTX *context)
@@ -961,7 +1227,7 @@ void sha512update(FAR SHA2_CTX *context, FAR const void *dataptr, size_t len)
           ADDINC128(context->bitcount, freespace << 3);
           len -= freespace;
           data += freespace;
-          sha512transform(context->state.st64, context->buffer);
+          SHA512TRANSFORM(context->state.st64, context->buffer);
         }
       else
         {
@@ -981,7 +1247,7 @@ void sha512update(FAR SHA2_CTX *context, FAR const void *dataptr, size_t len)
     {
       /* Process as many complete blocks as we can */
 
-      sha512transform(context->state.st64, data);
+      SHA512TRANSFORM(context->state.st64, data);
       ADDINC128(context->bitcount, SHA512_BLOCK_LENGTH << 3);
       len -= SHA512_BLOCK_LENGTH;
       data += SHA512_BLOCK_LENGTH;
@@ -1035,7 +1301,7 @@ void sha512last(FAR SHA2_CTX *context)
 
           /* Do second-to-last transform: */
 
-          sha512transform(context->state.st64, context->buffer);
+          SHA512TRANSFORM(context->state.st64, context->buffer);
 
           /* And set-up for the last transform: */
 
@@ -1062,7 +1328,7 @@ void sha512last(FAR SHA2_CTX *context)
 
   /* Final transform: */
 
-  sha512transform(context->state.st64, context->buffer);
+  SHA512TRANSFORM(context->state.st64, context->buffer);
 }
 
 void sha512final(FAR uint8_t *digest, FAR SHA2_CTX *context)
@@ -1129,3 +1395,30 @@ void sha384final(FAR uint8_t *digest, FAR SHA2_CTX *context)
 
   explicit_bzero(context, sizeof(*context));
 }
+
+#ifdef CONFIG_CRYPTO_SHA2_HW
+/****************************************************************************
+ * Name: sha2_hw_initialize
+ *
+ * Description:
+ *   Use the SHA instructions of the CPU if it has them.
+ *
+ ****************************************************************************/
+
+void sha2_hw_initialize(void)
+{
+  int level = sha2_hw_probe();
+
+  if (level >= 1)
+    {
+      g_sha256transform = sha256transform_hw;
+    }
+
+#  ifdef __aarch64__
+  if (level >= 2)
+    {
+      g_sha512transform = sha512transform_hw;
+    }
+#  endif
+}
+#endif
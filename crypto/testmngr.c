@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <string.h>
 #include <poll.h>
@@ -35,9 +36,11 @@
 
 #include <sys/param.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
+#include <crypto/bn.h>
 
 #ifdef CONFIG_CRYPTO_ALGTEST
 
@@ -108,6 +111,57 @@ static int test_aes(void)
 }
 #endif
 
+/* Check the big number products and exponentiations, and report how long
+ * each one took.
+ */
+
+static int test_bn(void)
+{
+  FAR struct bn *bn;
+  clock_t start;
+  int res = OK;
+  int i;
+
+  bn = kmm_malloc(5 * sizeof(struct bn));
+  if (bn == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < nitems(bn_tv_template); i++)
+    {
+      FAR struct bn_testvec *test = &bn_tv_template[i];
+
+      bignum_from_string(&bn[0], test->a, strlen(test->a));
+      bignum_from_string(&bn[1], test->b, strlen(test->b));
+      bignum_from_string(&bn[3], test->result, strlen(test->result));
+
+      start = clock_systime_ticks();
+      if (test->n != NULL)
+        {
+          bignum_from_string(&bn[2], test->n, strlen(test->n));
+          pow_mod_faster(&bn[0], &bn[1], &bn[2], &bn[4]);
+        }
+      else
+        {
+          bignum_mul(&bn[0], &bn[1], &bn[4]);
+        }
+
+      cryptinfo("bn test #%i: %" PRIu32 " ms\n", i,
+                (uint32_t)TICK2MSEC(clock_systime_ticks() - start));
+
+      if (bignum_cmp(&bn[4], &bn[3]) != EQUAL)
+        {
+          crypterr("ERROR: Failed bn test #%i\n", i);
+          res = -1;
+          break;
+        }
+    }
+
+  kmm_free(bn);
+  return res;
+}
+
 int crypto_test(void)
 {
 #if defined(CONFIG_CRYPTO_AES)
@@ -117,6 +171,11 @@ int crypto_test(void)
     }
 #endif
 
+  if (test_bn())
+    {
+      return -1;
+    }
+
   return OK;
 }
 
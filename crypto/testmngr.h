@@ -47,6 +47,16 @@ struct cipher_testvec
   unsigned short rlen;
 };
 
+/* Big numbers in hex, n is NULL when result = a * b */
+
+struct bn_testvec
+{
+  FAR char *a;
+  FAR char *b;
+  FAR char *n;
+  FAR char *result;
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -512,4 +522,75 @@ static struct cipher_testvec aes_ctr_dec_tv_template[] =
 };
 
 #endif /* CONFIG_CRYPTO_AES */
+
+/* Big number test vectors: a 1024-bit Karatsuba product, a 1024-bit
+ * exponent through the windows and e = 65537 through the binary method.
+ */
+
+static struct bn_testvec bn_tv_template[] =
+{
+  {
+    .a = "1355e4e910f62c7a263ade4f90136cc3242c610b00a83455d69befbd"
+         "90e13c6ee996ab0432863bc7411720d0d7bbc7774ed31d1aadac7842"
+         "69d0dfa3591bebee86e4c375520f6f477e52292d5312eeb9786d6f68"
+         "d7273a2f5b2495d1eb090346852495966643d5c8f8a7e4e12a61d563"
+         "e8c4546870efc3e0a4fab233b7895f8e",
+    .b = "c8b63db9c4506aeb6540e9c8cea787f97c475f39511e86f4f8cba2d2"
+         "461dd69c87d6f72272c76d576ed5ad1301e7871573f78b92241dcce7"
+         "bcf5de8d6717b399d5e9098ecd1868510a18d7bf574fc6d06c5ddceb"
+         "914fe099cdc10bffbcafb09a51d87b3e60af7e14804f0c92c3882df5"
+         "72059a23441f7b7775b0cc5693364c15",
+    .n = "d584a285e92195e81f7678795f345ff4c2b90e2d4a7acb3107918460"
+         "1cbc456dc694494e110443704ced30628e0cd071e46ab5adb68f9c7d"
+         "936d4747ab0e6d1ca10d04b240699a838a1d921ca352a3c35190feda"
+         "277a4c28fc377c61075dce9e7bb2dae32250963d5d2d816782f2681e"
+         "67d9849f3c94f8e0d974b822f0a612e1",
+    .result = "9448a1ccd0a0ead4c9581aa012a35c75122e7c4f9bc116517bd8ad85"
+              "d18cbe762df045ffb2c63f471cdaf410ab5fb5ef037e6cb2dcaf2180"
+              "dee719de0c8fdd3c879d81c43cb2ce30f702fb5a13ccb0fe9d69bac8"
+              "89785265d27a2b81c36b42ce5dfb2d1fcc3139e89a54cfd5365d9b62"
+              "b64596ba2552fdeefa2644dafb834408"
+  },
+  {
+    .a = "1355e4e910f62c7a263ade4f90136cc3242c610b00a83455d69befbd"
+         "90e13c6ee996ab0432863bc7411720d0d7bbc7774ed31d1aadac7842"
+         "69d0dfa3591bebee86e4c375520f6f477e52292d5312eeb9786d6f68"
+         "d7273a2f5b2495d1eb090346852495966643d5c8f8a7e4e12a61d563"
+         "e8c4546870efc3e0a4fab233b7895f8e",
+    .b = "010001",
+    .n = "d584a285e92195e81f7678795f345ff4c2b90e2d4a7acb3107918460"
+         "1cbc456dc694494e110443704ced30628e0cd071e46ab5adb68f9c7d"
+         "936d4747ab0e6d1ca10d04b240699a838a1d921ca352a3c35190feda"
+         "277a4c28fc377c61075dce9e7bb2dae32250963d5d2d816782f2681e"
+         "67d9849f3c94f8e0d974b822f0a612e1",
+    .result = "7b1f578ba97dc3706b0fa0b569dbf4d5bf98d987f435bd2ef25c014b"
+              "04e93b676edf427f337ab0adcc017abef222faf2b69563bd27b52593"
+              "f5510fb68237fdd0c14fad793478bd791dfc326184244b3f55f23d29"
+              "02441374742622189d8c03dad099148f4c4c583db1399f5282b30eda"
+              "efb51e9ac7b8f0dfeb1a08adf278c679"
+  },
+  {
+    .a = "8605bf84a6de7cffdfbf669c9b6b26c4deb992bdca5d4f3dda5bc2c5"
+         "2fee9fa8c9d231898beda2521296de33eb3fce8a4ab83f00a7b81777"
+         "0c220ba6420a992391251db5e9cfdffa1ced8f42c62a2f50fc2b5656"
+         "7e7664570567ae18ac6b1b732a808e756c2c600939bc4628d2296d0b"
+         "3944255d6999c7028d908b64ef9ea35b",
+    .b = "c4a1ea84e43d440877980f20a685b213013c0b072d63935e5d5b0fcc"
+         "3746450181e92b5b98ba91acc7261610e1d48840c22d2dd007da9149"
+         "d8085eca10f10ab8328ad98459cd2ac26390b66a49bf4805a412560c"
+         "c115c5123ae1e589e4652a7e133d020e8d1142fb85b743b111cefb01"
+         "8639b9851cc916b0c19f34f42768fca3",
+    .result = "66f12b05d5b27c1caa18028f8cd16d46786cac36378a65bf5e876aa8"
+              "c79ee776b76ac1bf2eeabfc67078aa035a7771320df0e7848f83f587"
+              "137dc9f9bccdd41fc702c18ba8ddbe3ad78e1c558342c41e724aa6bc"
+              "ea05917ac9bd0e4e8e55b4f9f8ada55b0d29032550578959e0fcb884"
+              "2237c22d96dce4972b0b84d03a018317cc583b7b783d9923f975e634"
+              "1a69385e4c4f7493db8bce49f7faa335f9cc1e3ea8c815f56bbc84f5"
+              "553fd8791c96d077a473dc2f8040f26603e93430d65c91f1d8e39192"
+              "f2e9c5d2a04e66df5ca955f1ace82c3a7cd26e2d29b999689ea33eaa"
+              "e277c76dcd2d7c4589823077d939d85dbd0dcbf56564ac0f1aa9cf35"
+              "f4c796f1"
+  }
+};
+
 #endif /* __CRYPTO_TESTMNGR_H */
@@ -35,6 +35,7 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/blkcache.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -42,22 +43,58 @@
 
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+#ifndef CONFIG_BCH_CACHE_NSECTORS
+#  define CONFIG_BCH_CACHE_NSECTORS 1
+#endif
+
+#ifndef CONFIG_BCH_CACHE_NWAYS
+#  define CONFIG_BCH_CACHE_NWAYS 1
+#endif
+
+#ifndef CONFIG_BCH_CACHE_READAHEAD
+#  define CONFIG_BCH_CACHE_READAHEAD 0
+#endif
+
+/* Line W of set S is bchlib_s::lines[W * BCH_CACHE_NSETS + S], so the lines
+ * of one way hold consecutive sectors in consecutive memory.
+ */
+
+#define BCH_CACHE_NSETS   (CONFIG_BCH_CACHE_NSECTORS / CONFIG_BCH_CACHE_NWAYS)
+
+#if BCH_CACHE_NSETS * CONFIG_BCH_CACHE_NWAYS != CONFIG_BCH_CACHE_NSECTORS
+#  error CONFIG_BCH_CACHE_NSECTORS must be a multiple of CONFIG_BCH_CACHE_NWAYS
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* One line of the sector cache */
+
+struct bchlib_line_s
+{
+  size_t sector;           /* The sector in the line, (size_t)-1 if none */
+  uint32_t stamp;          /* Time of the last access */
+  bool dirty;              /* true: Data has been written to the line */
+};
+
 struct bchlib_s
 {
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
   mutex_t lock;            /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
-  bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  uint32_t stamp;          /* Counts the accesses to the cache */
+  FAR uint8_t *cache;      /* CONFIG_BCH_CACHE_NSECTORS sector buffers */
+  FAR uint8_t *buffer;     /* The sector last read by bchlib_readsector() */
+
+  /* The cache lines and the one that holds buffer */
+
+  struct bchlib_line_s lines[CONFIG_BCH_CACHE_NSECTORS];
+  FAR struct bchlib_line_s *line;
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -85,6 +122,8 @@ EXTERN const struct file_operations g_bch_fops;
 
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch, bool discard);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_invalidate(FAR struct bchlib_s *bch, size_t start,
+                              size_t nsectors);
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -173,6 +173,7 @@ static int bch_close(FAR struct file *filep)
   /* Flush any dirty pages remaining in the cache */
 
   bchlib_flushsector(bch, false);
+  ret = blkcache_flush(bch->inode);
 
   /* Decrement the reference count (I don't use bchlib_decref() because I
    * want the entire close operation to be atomic wrt other driver
@@ -437,9 +438,10 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       case BIOC_DISCARD:
         {
-          /* Invalidate the sector so next read is from the device- */
+          /* Invalidate the cache so next read is from the device- */
 
-          bch->sector = (size_t)-1;
+          bchlib_invalidate(bch, 0, bch->nsectors);
+          blkcache_invalidate(bch->inode);
           goto ioctl_default;
         }
 
@@ -448,6 +450,11 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           /* Flush any dirty pages remaining in the cache */
 
           ret = bchlib_flushsector(bch, false);
+          if (ret >= 0)
+            {
+              ret = blkcache_flush(bch->inode);
+            }
+
           if (ret < 0)
             {
               break;
@@ -62,10 +62,11 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR uint8_t *data,
+                      size_t sector, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)data;
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -73,7 +74,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -92,74 +93,185 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Name: bchlib_linebuffer
+ *
+ * Description:
+ *   Return the sector buffer of the cache line with index 'index'.
+ *
  ****************************************************************************/
 
+static FAR uint8_t *bchlib_linebuffer(FAR struct bchlib_s *bch, int index)
+{
+  return bch->cache + (size_t)index * bch->sectsize;
+}
+
 /****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bchlib_writelines
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
- *
- * Assumptions:
- *   Caller must assume mutual exclusion
+ *   Write 'count' dirty lines, starting at line 'index', that hold
+ *   consecutive sectors in consecutive memory with one transfer.
  *
  ****************************************************************************/
 
-int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
+static int bchlib_writelines(FAR struct bchlib_s *bch, int index, int count)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  FAR struct bchlib_line_s *line = &bch->lines[index];
+  FAR uint8_t *buffer = bchlib_linebuffer(bch, index);
+  ssize_t ret;
+  int i;
 
-  /* Check if the sector has been modified and is out of synch with the
-   * media.
-   */
+#if defined(CONFIG_BCH_ENCRYPTION)
+  /* Encrypt data as necessary */
 
-  if (bch->dirty && bch->buffer != NULL)
+  for (i = 0; i < count; i++)
     {
-      inode = bch->inode;
+      bch_cypher(bch, buffer + i * bch->sectsize, line->sector + i,
+                 CYPHER_ENCRYPT);
+    }
+#endif
+
+  /* Write the sectors to the media */
+
+  ret = blkcache_write(bch->inode, buffer, line->sector, count,
+                       bch->sectsize);
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-      /* Encrypt data as necessary */
+  /* Computation overhead to save memory for extra sector buffer
+   * TODO: Add configuration switch for extra sector buffer
+   */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+  for (i = 0; i < count; i++)
+    {
+      bch_cypher(bch, buffer + i * bch->sectsize, line->sector + i,
+                 CYPHER_DECRYPT);
+    }
 #endif
 
-      /* Write the sector to the media */
+  if (ret < 0)
+    {
+      ferr("Write failed: %zd\n", ret);
+      return (int)ret;
+    }
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
-      if (ret < 0)
+  /* The sectors are now in sync with the media */
+
+  for (i = 0; i < count; i++)
+    {
+      line[i].dirty = false;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_readahead
+ *
+ * Description:
+ *   Return how many sectors, starting with 'sector' which goes to line
+ *   'index', can be read into the cache with one transfer.  A following
+ *   sector is read ahead into the next line of the same way if that line is
+ *   clean and the sector is not cached elsewhere in its set.
+ *
+ ****************************************************************************/
+
+static int bchlib_readahead(FAR struct bchlib_s *bch, int index,
+                            size_t sector)
+{
+  int count = 1;
+#if CONFIG_BCH_CACHE_READAHEAD > 0
+  int set = index % BCH_CACHE_NSETS;
+  int way;
+
+  while (count <= CONFIG_BCH_CACHE_READAHEAD &&
+         set + count < BCH_CACHE_NSETS &&
+         sector + count < bch->nsectors &&
+         !bch->lines[index + count].dirty)
+    {
+      for (way = 0; way < CONFIG_BCH_CACHE_NWAYS; way++)
         {
-          ferr("Write failed: %zd\n", ret);
-          return (int)ret;
+          if (bch->lines[way * BCH_CACHE_NSETS + set + count].sector ==
+              sector + count)
+            {
+              return count;
+            }
         }
 
-#if defined(CONFIG_BCH_ENCRYPTION)
-      /* Computation overhead to save memory for extra sector buffer
-       * TODO: Add configuration switch for extra sector buffer
-       */
-
-      bch_cypher(bch, CYPHER_DECRYPT);
+      count++;
+    }
 #endif
 
-      /* The sector is now in sync with the media */
+  return count;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-      bch->dirty = false;
+/****************************************************************************
+ * Name: bchlib_flushsector
+ *
+ * Description:
+ *   Write all dirty sectors in the cache back to the media.  Runs of dirty
+ *   lines that hold consecutive sectors are written with one transfer.  If
+ *   'discard' is true, the cache is emptied afterwards.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
+{
+  FAR struct bchlib_line_s *line;
+  int index;
+  int count;
+  int ret;
+
+  if (bch->cache != NULL)
+    {
+      for (index = 0; index < CONFIG_BCH_CACHE_NSECTORS; index += count)
+        {
+          line  = &bch->lines[index];
+          count = 1;
+
+          if (!line->dirty)
+            {
+              continue;
+            }
+
+          /* Gather the dirty lines that follow in the same way */
+
+          while ((index + count) % BCH_CACHE_NSETS != 0 &&
+                 line[count].dirty &&
+                 line[count].sector == line->sector + count)
+            {
+              count++;
+            }
+
+          ret = bchlib_writelines(bch, index, count);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
     }
 
   if (discard)
     {
-      bch->sector = (size_t)-1;
+      bchlib_invalidate(bch, 0, bch->nsectors);
     }
 
-  return (int)ret;
+  return OK;
 }
 
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Read the current sector contents into buffer
+ *   Make bch->buffer refer to the cached contents of 'sector', reading it
+ *   from the media if it is not cached.  bch->line is the cache line that
+ *   holds it: set bch->line->dirty after modifying bch->buffer.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -168,46 +280,128 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  FAR struct bchlib_line_s *line;
+  FAR struct bchlib_line_s *victim = NULL;
+  FAR uint8_t *buffer;
+  ssize_t ret;
+  int index;
+  int count;
+  int set;
+  int way;
+  int i;
 
-  if (bch->buffer == NULL)
+  if (bch->cache == NULL)
     {
+      size_t size = (size_t)CONFIG_BCH_CACHE_NSECTORS * bch->sectsize;
+
 #if CONFIG_BCH_BUFFER_ALIGNMENT != 0
-      bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, bch->sectsize);
+      bch->cache = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, size);
 #else
-      bch->buffer = kmm_malloc(bch->sectsize);
+      bch->cache = kmm_malloc(size);
 #endif
-      if (bch->buffer == NULL)
+      if (bch->cache == NULL)
         {
           ferr("Failed to allocate sector buffer\n");
           return -ENOMEM;
         }
     }
 
-  if (bch->sector != sector)
+  /* Look for the sector in its set, and for the line to replace if it is
+   * not there: an empty one, else the least recently used one.
+   */
+
+  set = sector % BCH_CACHE_NSETS;
+  for (way = 0; way < CONFIG_BCH_CACHE_NWAYS; way++)
     {
-      inode = bch->inode;
+      line = &bch->lines[way * BCH_CACHE_NSETS + set];
+      if (line->sector == sector)
+        {
+          goto out;
+        }
 
-      ret = bchlib_flushsector(bch, true);
-      if (ret < 0)
+      if (victim == NULL || (victim->sector != (size_t)-1 &&
+          (line->sector == (size_t)-1 ||
+           (int32_t)(line->stamp - victim->stamp) < 0)))
         {
-          ferr("Flush failed: %zd\n", ret);
-          return (int)ret;
+          victim = line;
         }
+    }
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+  /* Write the lines that are dirty back before one is replaced */
+
+  if (victim->dirty)
+    {
+      ret = bchlib_flushsector(bch, false);
       if (ret < 0)
         {
-          ferr("Read failed: %zd\n", ret);
+          ferr("Flush failed: %zd\n", ret);
           return (int)ret;
         }
+    }
+
+  line   = victim;
+  index  = line - bch->lines;
+  buffer = bchlib_linebuffer(bch, index);
+  count  = bchlib_readahead(bch, index, sector);
+
+  for (i = 0; i < count; i++)
+    {
+      line[i].sector = (size_t)-1;
+    }
+
+  ret = blkcache_read(bch->inode, buffer, sector, count, bch->sectsize);
+  if (ret < 0)
+    {
+      ferr("Read failed: %zd\n", ret);
+      return (int)ret;
+    }
+  else if (ret == 0)
+    {
+      return -EIO;
+    }
 
-      bch->sector = sector;
+  for (i = 0; i < ret; i++)
+    {
+      line[i].sector = sector + i;
+      line[i].stamp  = bch->stamp;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, buffer + i * bch->sectsize, sector + i,
+                 CYPHER_DECRYPT);
 #endif
     }
 
-  return (int)ret;
+out:
+  line->stamp = ++bch->stamp;
+  bch->line   = line;
+  bch->buffer = bchlib_linebuffer(bch, line - bch->lines);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_invalidate
+ *
+ * Description:
+ *   Drop the sectors 'start' through 'start' + 'nsectors' - 1 from the
+ *   cache without writing them back.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_invalidate(FAR struct bchlib_s *bch, size_t start,
+                       size_t nsectors)
+{
+  int index;
+
+  for (index = 0; index < CONFIG_BCH_CACHE_NSECTORS; index++)
+    {
+      FAR struct bchlib_line_s *line = &bch->lines[index];
+
+      if (line->sector - start < nsectors)
+        {
+          line->sector = (size_t)-1;
+          line->dirty  = false;
+        }
+    }
 }
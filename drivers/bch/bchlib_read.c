@@ -148,8 +148,17 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
-      ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
-                                       sector, nsectors);
+      /* The media must not miss data that is only in the cache */
+
+      ret = bchlib_flushsector(bch, false);
+      if (ret < 0)
+        {
+          ferr("ERROR: Flush failed: %d\n", ret);
+          return ret;
+        }
+
+      ret = blkcache_read(bch->inode, (FAR uint8_t *)buffer, sector,
+                          nsectors, bch->sectsize);
       if (ret < 0)
         {
           ferr("ERROR: Read failed: %d\n", ret);
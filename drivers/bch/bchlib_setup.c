@@ -111,8 +111,8 @@ int bchlib_setup(FAR const char *blkdev, int oflags, FAR void **handle)
   nxmutex_init(&bch->lock);
   bch->nsectors = geo.geo_nsectors;
   bch->sectsize = geo.geo_sectorsize;
-  bch->sector   = (size_t)-1;
   bch->readonly = readonly;
+  bchlib_invalidate(bch, 0, bch->nsectors);
   *handle = bch;
   return OK;
 
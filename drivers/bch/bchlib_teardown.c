@@ -65,6 +65,7 @@ int bchlib_teardown(FAR void *handle)
   /* Flush any pending data to the block driver */
 
   bchlib_flushsector(bch, false);
+  blkcache_invalidate(bch->inode);
 
   /* Close the block driver */
 
@@ -72,9 +73,9 @@ int bchlib_teardown(FAR void *handle)
 
   /* Free the BCH state structure */
 
-  if (bch->buffer)
+  if (bch->cache)
     {
-      kmm_free(bch->buffer);
+      kmm_free(bch->cache);
     }
 
   nxmutex_destroy(&bch->lock);
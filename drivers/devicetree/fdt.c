@@ -29,10 +29,74 @@
 #include <errno.h>
 #include <assert.h>
 #include <ctype.h>
+#include <string.h>
+#include <debug.h>
 #include <nuttx/compiler.h>
 #include <nuttx/fdt.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
 #include <libfdt.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Deepest node nesting the index supports, real trees stay well below */
+
+#define FDT_INDEX_MAXDEPTH 32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_DEVICE_TREE_INDEX
+/* A node of the unflattened tree, nodes are kept in the order of the blob
+ * so their offsets are sorted.
+ */
+
+struct fdt_inode_s
+{
+  FAR const char *name;         /* Node name, with its unit address */
+  int             namelen;      /* Length of name */
+  int             offset;       /* Offset of the node in the blob */
+  int             parent;       /* Index of the parent, -1 for the root */
+  int             child;        /* Index of the first child, or -1 */
+  int             sibling;      /* Index of the next sibling, or -1 */
+};
+
+/* One string of a compatible property.  The first node with a given
+ * string is in the hash table, the others are chained from it in the
+ * order of the blob.
+ */
+
+struct fdt_icompat_s
+{
+  FAR const char *str;          /* The compatible string */
+  uint32_t        hash;         /* fdt_index_hash() of str */
+  int             node;         /* Index of the node */
+  int             next;         /* Next entry with the same string, or -1 */
+  int             last;         /* Last entry of the chain, head only */
+};
+
+struct fdt_iphandle_s
+{
+  uint32_t        phandle;      /* 0 if the slot is free */
+  int             node;         /* Index of the node */
+};
+
+struct fdt_index_s
+{
+  FAR const void            *fdt;     /* The indexed blob, NULL if none */
+  FAR struct fdt_inode_s    *nodes;
+  FAR struct fdt_icompat_s  *compat;
+  FAR struct fdt_iphandle_s *phandle;
+  FAR int                   *ctab;    /* Compatible hash table */
+  uint32_t                   cmask;   /* Size of ctab - 1 */
+  uint32_t                   pmask;   /* Size of phandle - 1 */
+  int                        nnodes;
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -41,6 +105,326 @@
 
 static FAR const char *g_fdt_base;
 
+#ifdef CONFIG_DEVICE_TREE_INDEX
+/* Index of g_fdt_base, built on first use since fdt_register() runs
+ * before the heap is set up.
+ */
+
+static struct fdt_index_s g_fdt_index;
+static mutex_t g_fdt_index_lock = NXMUTEX_INITIALIZER;
+static bool g_fdt_index_failed;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_DEVICE_TREE_INDEX
+static uint32_t fdt_index_hash(FAR const char *str)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*str != '\0')
+    {
+      hash = (hash ^ (uint8_t)*str++) * 16777619u;
+    }
+
+  return hash;
+}
+
+static uint32_t fdt_index_tabsize(int count)
+{
+  uint32_t size = 1;
+
+  /* Keep the load factor at or below one half */
+
+  while (size < 2 * count)
+    {
+      size <<= 1;
+    }
+
+  return size;
+}
+
+/****************************************************************************
+ * Name: fdt_index_compat_add
+ *
+ * Description:
+ *   Add one compatible string of a node to the index.
+ *
+ ****************************************************************************/
+
+static void fdt_index_compat_add(FAR struct fdt_index_s *idx, int entry,
+                                 FAR const char *str, int node)
+{
+  FAR struct fdt_icompat_s *ic = &idx->compat[entry];
+  uint32_t hash = fdt_index_hash(str);
+  uint32_t slot;
+
+  ic->str  = str;
+  ic->hash = hash;
+  ic->node = node;
+  ic->next = -1;
+  ic->last = entry;
+
+  for (slot = hash & idx->cmask; idx->ctab[slot] >= 0;
+       slot = (slot + 1) & idx->cmask)
+    {
+      FAR struct fdt_icompat_s *head = &idx->compat[idx->ctab[slot]];
+
+      if (head->hash == hash && strcmp(head->str, str) == 0)
+        {
+          idx->compat[head->last].next = entry;
+          head->last = entry;
+          return;
+        }
+    }
+
+  idx->ctab[slot] = entry;
+}
+
+/****************************************************************************
+ * Name: fdt_index_build
+ *
+ * Description:
+ *   Walk the blob twice, once to size the index and once to fill it.
+ *
+ ****************************************************************************/
+
+static int fdt_index_build(FAR struct fdt_index_s *idx, FAR const void *fdt)
+{
+  int lastchild[FDT_INDEX_MAXDEPTH];
+  int parents[FDT_INDEX_MAXDEPTH];
+  FAR const char *prop;
+  FAR uint8_t *mem;
+  size_t nodesz;
+  size_t compatsz;
+  size_t phandlesz;
+  int nphandles = 0;
+  int ncompat = 0;
+  int nnodes = 0;
+  int offset;
+  int depth;
+  int entry;
+  int len;
+  int i;
+
+  for (offset = 0, depth = 0; offset >= 0 && depth >= 0;
+       offset = fdt_next_node(fdt, offset, &depth))
+    {
+      if (depth >= FDT_INDEX_MAXDEPTH)
+        {
+          return -E2BIG;
+        }
+
+      prop = fdt_getprop(fdt, offset, "compatible", &len);
+      for (i = 0; prop != NULL && i < len;
+           i += strnlen(prop + i, len - i) + 1)
+        {
+          ncompat++;
+        }
+
+      if (fdt_get_phandle(fdt, offset) != 0)
+        {
+          nphandles++;
+        }
+
+      nnodes++;
+    }
+
+  idx->cmask = fdt_index_tabsize(ncompat) - 1;
+  idx->pmask = fdt_index_tabsize(nphandles) - 1;
+
+  nodesz    = nnodes * sizeof(struct fdt_inode_s);
+  compatsz  = ncompat * sizeof(struct fdt_icompat_s);
+  phandlesz = (idx->pmask + 1) * sizeof(struct fdt_iphandle_s);
+
+  mem = kmm_malloc(nodesz + compatsz + phandlesz +
+                   (idx->cmask + 1) * sizeof(int));
+  if (mem == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  idx->nodes   = (FAR struct fdt_inode_s *)mem;
+  idx->compat  = (FAR struct fdt_icompat_s *)(mem + nodesz);
+  idx->phandle = (FAR struct fdt_iphandle_s *)(mem + nodesz + compatsz);
+  idx->ctab    = (FAR int *)(mem + nodesz + compatsz + phandlesz);
+  idx->nnodes  = nnodes;
+
+  memset(idx->phandle, 0, phandlesz);
+  memset(idx->ctab, 0xff, (idx->cmask + 1) * sizeof(int));
+
+  nnodes = 0;
+  entry  = 0;
+
+  for (offset = 0, depth = 0; offset >= 0 && depth >= 0;
+       offset = fdt_next_node(fdt, offset, &depth))
+    {
+      FAR struct fdt_inode_s *node = &idx->nodes[nnodes];
+      uint32_t phandle;
+
+      node->name    = fdt_get_name(fdt, offset, &node->namelen);
+      node->offset  = offset;
+      node->parent  = depth > 0 ? parents[depth - 1] : -1;
+      node->child   = -1;
+      node->sibling = -1;
+
+      if (depth > 0)
+        {
+          if (lastchild[depth - 1] < 0)
+            {
+              idx->nodes[node->parent].child = nnodes;
+            }
+          else
+            {
+              idx->nodes[lastchild[depth - 1]].sibling = nnodes;
+            }
+
+          lastchild[depth - 1] = nnodes;
+        }
+
+      parents[depth]   = nnodes;
+      lastchild[depth] = -1;
+
+      prop = fdt_getprop(fdt, offset, "compatible", &len);
+      for (i = 0; prop != NULL && i < len;
+           i += strnlen(prop + i, len - i) + 1)
+        {
+          fdt_index_compat_add(idx, entry++, prop + i, nnodes);
+        }
+
+      phandle = fdt_get_phandle(fdt, offset);
+      if (phandle != 0)
+        {
+          uint32_t slot = (phandle * 2654435761u) & idx->pmask;
+
+          while (idx->phandle[slot].phandle != 0)
+            {
+              slot = (slot + 1) & idx->pmask;
+            }
+
+          idx->phandle[slot].phandle = phandle;
+          idx->phandle[slot].node    = nnodes;
+        }
+
+      nnodes++;
+    }
+
+  finfo("Indexed %d nodes, %d compatible strings, %d phandles\n",
+        nnodes, entry, nphandles);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fdt_index_get
+ *
+ * Description:
+ *   Return the index of fdt, building it on the first call.  Only the
+ *   registered blob is indexed, NULL means the caller has to use libfdt.
+ *
+ ****************************************************************************/
+
+static FAR struct fdt_index_s *fdt_index_get(FAR const void *fdt)
+{
+  if (fdt == NULL || fdt != g_fdt_base)
+    {
+      return NULL;
+    }
+
+  if (g_fdt_index.fdt != fdt && !g_fdt_index_failed)
+    {
+      nxmutex_lock(&g_fdt_index_lock);
+
+      if (g_fdt_index.fdt != fdt && !g_fdt_index_failed)
+        {
+          int ret = fdt_index_build(&g_fdt_index, fdt);
+          if (ret < 0)
+            {
+              ferr("ERROR: Failed to index the device tree: %d\n", ret);
+              g_fdt_index_failed = true;
+            }
+          else
+            {
+              g_fdt_index.fdt = fdt;
+            }
+        }
+
+      nxmutex_unlock(&g_fdt_index_lock);
+    }
+
+  return g_fdt_index.fdt == fdt ? &g_fdt_index : NULL;
+}
+
+/****************************************************************************
+ * Name: fdt_index_node
+ *
+ * Description:
+ *   Return the index of the node at offset, or -1 if there is none.
+ *
+ ****************************************************************************/
+
+static int fdt_index_node(FAR struct fdt_index_s *idx, int offset)
+{
+  int lo = 0;
+  int hi = idx->nnodes - 1;
+
+  while (lo <= hi)
+    {
+      int mid = (lo + hi) / 2;
+
+      if (idx->nodes[mid].offset == offset)
+        {
+          return mid;
+        }
+      else if (idx->nodes[mid].offset < offset)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid - 1;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: fdt_index_child
+ *
+ * Description:
+ *   Find the child of a node by name, with the same rule as libfdt: a name
+ *   without a unit address matches the first node with any unit address.
+ *
+ ****************************************************************************/
+
+static int fdt_index_child(FAR struct fdt_index_s *idx, int node,
+                           FAR const char *name, int namelen)
+{
+  int child;
+
+  for (child = idx->nodes[node].child; child >= 0;
+       child = idx->nodes[child].sibling)
+    {
+      FAR struct fdt_inode_s *n = &idx->nodes[child];
+
+      if (n->namelen < namelen || memcmp(n->name, name, namelen) != 0)
+        {
+          continue;
+        }
+
+      if (n->namelen == namelen ||
+          (n->name[namelen] == '@' && memchr(name, '@', namelen) == NULL))
+        {
+          return child;
+        }
+    }
+
+  return -1;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -71,6 +455,18 @@ int fdt_register(FAR const char *fdt_base)
       return -EINVAL; /* Bad magic byte read */
     }
 
+#ifdef CONFIG_DEVICE_TREE_INDEX
+  /* Drop the index of the previous blob, the new one is indexed on use */
+
+  if (g_fdt_index.fdt != NULL && g_fdt_index.fdt != fdt_base)
+    {
+      kmm_free(g_fdt_index.nodes);
+      memset(&g_fdt_index, 0, sizeof(g_fdt_index));
+    }
+
+  g_fdt_index_failed = false;
+#endif
+
   g_fdt_base = fdt_base;
   return OK;
 }
@@ -89,6 +485,168 @@ FAR const char *fdt_get(void)
   return g_fdt_base;
 }
 
+/****************************************************************************
+ * Name: fdt_find_compatible
+ *
+ * Description:
+ *   Same as fdt_node_offset_by_compatible(), in constant time on the
+ *   registered FDT.
+ *
+ ****************************************************************************/
+
+int fdt_find_compatible(FAR const void *fdt, int startoffset,
+                        FAR const char *compatible)
+{
+#ifdef CONFIG_DEVICE_TREE_INDEX
+  FAR struct fdt_index_s *idx = fdt_index_get(fdt);
+
+  if (idx != NULL)
+    {
+      uint32_t hash = fdt_index_hash(compatible);
+      uint32_t slot;
+      int entry;
+
+      for (slot = hash & idx->cmask; idx->ctab[slot] >= 0;
+           slot = (slot + 1) & idx->cmask)
+        {
+          FAR struct fdt_icompat_s *head = &idx->compat[idx->ctab[slot]];
+
+          if (head->hash != hash || strcmp(head->str, compatible) != 0)
+            {
+              continue;
+            }
+
+          for (entry = idx->ctab[slot]; entry >= 0;
+               entry = idx->compat[entry].next)
+            {
+              int offset = idx->nodes[idx->compat[entry].node].offset;
+
+              if (offset > startoffset)
+                {
+                  return offset;
+                }
+            }
+
+          break;
+        }
+
+      return -FDT_ERR_NOTFOUND;
+    }
+#endif
+
+  return fdt_node_offset_by_compatible(fdt, startoffset, compatible);
+}
+
+/****************************************************************************
+ * Name: fdt_find_phandle
+ *
+ * Description:
+ *   Same as fdt_node_offset_by_phandle(), in constant time on the
+ *   registered FDT.
+ *
+ ****************************************************************************/
+
+int fdt_find_phandle(FAR const void *fdt, uint32_t phandle)
+{
+#ifdef CONFIG_DEVICE_TREE_INDEX
+  FAR struct fdt_index_s *idx = fdt_index_get(fdt);
+
+  if (idx != NULL && phandle != 0 && phandle != UINT32_MAX)
+    {
+      uint32_t slot;
+
+      for (slot = (phandle * 2654435761u) & idx->pmask;
+           idx->phandle[slot].phandle != 0;
+           slot = (slot + 1) & idx->pmask)
+        {
+          if (idx->phandle[slot].phandle == phandle)
+            {
+              return idx->nodes[idx->phandle[slot].node].offset;
+            }
+        }
+
+      return -FDT_ERR_NOTFOUND;
+    }
+#endif
+
+  return fdt_node_offset_by_phandle(fdt, phandle);
+}
+
+/****************************************************************************
+ * Name: fdt_find_parent
+ *
+ * Description:
+ *   Same as fdt_parent_offset(), which has to rescan the blob from the
+ *   root, in logarithmic time on the registered FDT.
+ *
+ ****************************************************************************/
+
+int fdt_find_parent(FAR const void *fdt, int offset)
+{
+#ifdef CONFIG_DEVICE_TREE_INDEX
+  FAR struct fdt_index_s *idx = fdt_index_get(fdt);
+
+  if (idx != NULL)
+    {
+      int node = fdt_index_node(idx, offset);
+
+      if (node < 0)
+        {
+          return -FDT_ERR_BADOFFSET;
+        }
+
+      node = idx->nodes[node].parent;
+      return node < 0 ? -FDT_ERR_NOTFOUND : idx->nodes[node].offset;
+    }
+#endif
+
+  return fdt_parent_offset(fdt, offset);
+}
+
+/****************************************************************************
+ * Name: fdt_find_path
+ *
+ * Description:
+ *   Same as fdt_path_offset().  Full paths are resolved from the index of
+ *   the registered FDT, aliases are left to libfdt.
+ *
+ ****************************************************************************/
+
+int fdt_find_path(FAR const void *fdt, FAR const char *path)
+{
+#ifdef CONFIG_DEVICE_TREE_INDEX
+  FAR struct fdt_index_s *idx = fdt_index_get(fdt);
+
+  if (idx != NULL && path[0] == '/')
+    {
+      int node = 0;
+
+      while (node >= 0)
+        {
+          FAR const char *end;
+
+          while (*path == '/')
+            {
+              path++;
+            }
+
+          if (*path == '\0')
+            {
+              return idx->nodes[node].offset;
+            }
+
+          end = strchrnul(path, '/');
+          node = fdt_index_child(idx, node, path, end - path);
+          path = end;
+        }
+
+      return -FDT_ERR_NOTFOUND;
+    }
+#endif
+
+  return fdt_path_offset(fdt, path);
+}
+
 /****************************************************************************
  * Name: fdt_get_irq
  *
@@ -123,7 +681,7 @@ int fdt_get_irq(FAR const void *fdt, int nodeoffset,
 int fdt_get_irq_by_path(FAR const void *fdt, int offset,
                         const char *path, int irqbase)
 {
-  return fdt_get_irq(fdt, fdt_path_offset(fdt, path), offset, irqbase);
+  return fdt_get_irq(fdt, fdt_find_path(fdt, path), offset, irqbase);
 }
 
 /****************************************************************************
@@ -160,7 +718,7 @@ int fdt_get_parent_address_cells(FAR const void *fdt, int offset)
 {
   int parentoff;
 
-  parentoff = fdt_parent_offset(fdt, offset);
+  parentoff = fdt_find_parent(fdt, offset);
   if (parentoff < 0)
     {
       return parentoff;
@@ -181,7 +739,7 @@ int fdt_get_parent_size_cells(FAR const void *fdt, int offset)
 {
   int parentoff;
 
-  parentoff = fdt_parent_offset(fdt, offset);
+  parentoff = fdt_find_parent(fdt, offset);
   if (parentoff < 0)
     {
       return parentoff;
@@ -373,7 +931,7 @@ size_t fdt_get_reg_size_by_index(FAR const void *fdt, int offset, int index)
 
 uintptr_t fdt_get_reg_base_by_path(FAR const void *fdt, FAR const char *path)
 {
-  return fdt_get_reg_base(fdt, fdt_path_offset(fdt, path), 0);
+  return fdt_get_reg_base(fdt, fdt_find_path(fdt, path), 0);
 }
 
 bool fdt_device_is_available(FAR const void *fdt, int node)
@@ -404,7 +962,7 @@ FAR const char *fdt_get_node_label(FAR const void *fdt, int node)
       0
     };
 
-  symbols_offset = fdt_path_offset(fdt, "/__symbols__");
+  symbols_offset = fdt_find_path(fdt, "/__symbols__");
   if (symbols_offset < 0)
     {
       return NULL;
@@ -477,7 +1035,7 @@ uintptr_t fdt_get_clock_frequency_from_clocks(FAR const void *fdt,
 
   clk_phandle = fdt32_ld(pv + index);
 
-  pv_offset = fdt_node_offset_by_phandle(fdt, clk_phandle);
+  pv_offset = fdt_find_phandle(fdt, clk_phandle);
   if (pv_offset < 0)
     {
       return clock_frequency;
@@ -536,8 +1094,7 @@ void fdt_node_from_compat(FAR const void *fdt,
     {
       while (true)
         {
-          offset
-              = fdt_node_offset_by_compatible(fdt, offset, *compatible_ids);
+          offset = fdt_find_compatible(fdt, offset, *compatible_ids);
           if (offset == -FDT_ERR_NOTFOUND)
             {
               break;
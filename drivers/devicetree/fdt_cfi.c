@@ -58,7 +58,7 @@ int fdt_cfi_register(FAR const void *fdt)
   int ret = 0;
   int offset = -1;
 
-  while ((offset = fdt_node_offset_by_compatible(fdt, offset, "cfi-flash"))
+  while ((offset = fdt_find_compatible(fdt, offset, "cfi-flash"))
          >= 0)
     {
       uintptr_t address_cell = fdt_get_parent_address_cells(fdt, offset);
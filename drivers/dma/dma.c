@@ -0,0 +1,265 @@
+/****************************************************************************
+ * drivers/dma/dma.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/cache.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/dma/dma.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The waiter of a dma_memcpy() */
+
+struct dma_memcpy_s
+{
+  sem_t sem;
+  ssize_t result;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct dma_dev_s *g_dma_devs[CONFIG_DMA_NDEVICES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_sg_done
+ *
+ * Description:
+ *   Completion of one entry of a scatter-gather list started by the
+ *   generic fallback; start the next one, or report the whole list.
+ *
+ ****************************************************************************/
+
+static void dma_sg_done(FAR struct dma_chan_s *chan, FAR void *arg,
+                        ssize_t len)
+{
+  FAR struct dma_desc_s *desc = arg;
+  FAR const struct dma_sg_s *sg;
+  int ret;
+
+  if (len < 0)
+    {
+      desc->callback(chan, desc->arg, len);
+      return;
+    }
+
+  desc->total += len;
+  if (++desc->index < desc->nsg)
+    {
+      sg  = &desc->sg[desc->index];
+      ret = DMA_START(chan, dma_sg_done, desc, sg->dst, sg->src, sg->len);
+      if (ret < 0)
+        {
+          desc->callback(chan, desc->arg, ret);
+        }
+
+      return;
+    }
+
+  desc->callback(chan, desc->arg, desc->total);
+}
+
+/****************************************************************************
+ * Name: dma_memcpy_done
+ ****************************************************************************/
+
+static void dma_memcpy_done(FAR struct dma_chan_s *chan, FAR void *arg,
+                            ssize_t len)
+{
+  FAR struct dma_memcpy_s *wait = arg;
+
+  wait->result = len;
+  nxsem_post(&wait->sem);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_register
+ ****************************************************************************/
+
+int dma_register(int minor, FAR struct dma_dev_s *dev)
+{
+  if (minor < 0 || minor >= CONFIG_DMA_NDEVICES || dev == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (g_dma_devs[minor] != NULL)
+    {
+      return -EEXIST;
+    }
+
+  g_dma_devs[minor] = dev;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dma_request_chan
+ ****************************************************************************/
+
+FAR struct dma_chan_s *dma_request_chan(int minor, unsigned int ident)
+{
+  if (minor < 0 || minor >= CONFIG_DMA_NDEVICES ||
+      g_dma_devs[minor] == NULL)
+    {
+      return NULL;
+    }
+
+  return DMA_GET_CHAN(g_dma_devs[minor], ident);
+}
+
+/****************************************************************************
+ * Name: dma_release_chan
+ ****************************************************************************/
+
+void dma_release_chan(int minor, FAR struct dma_chan_s *chan)
+{
+  DEBUGASSERT(minor >= 0 && minor < CONFIG_DMA_NDEVICES &&
+              g_dma_devs[minor] != NULL);
+
+  DMA_PUT_CHAN(g_dma_devs[minor], chan);
+}
+
+/****************************************************************************
+ * Name: dma_prep_sg
+ ****************************************************************************/
+
+void dma_prep_sg(FAR struct dma_desc_s *desc, FAR const struct dma_sg_s *sg,
+                 size_t nsg, dma_callback_t callback, FAR void *arg)
+{
+  DEBUGASSERT(desc != NULL && sg != NULL && nsg > 0 && callback != NULL);
+
+  desc->sg       = sg;
+  desc->nsg      = nsg;
+  desc->callback = callback;
+  desc->arg      = arg;
+  desc->index    = 0;
+  desc->total    = 0;
+}
+
+/****************************************************************************
+ * Name: dma_start_sg
+ ****************************************************************************/
+
+int dma_start_sg(FAR struct dma_chan_s *chan, FAR struct dma_desc_s *desc)
+{
+  DEBUGASSERT(chan != NULL && desc != NULL && desc->nsg > 0);
+
+  if (chan->ops->start_sg != NULL)
+    {
+      return chan->ops->start_sg(chan, desc->callback, desc->arg,
+                                 desc->sg, desc->nsg);
+    }
+
+  /* Without hardware lists, each entry is started from the completion of
+   * the previous one.
+   */
+
+  desc->index = 0;
+  desc->total = 0;
+  return DMA_START(chan, dma_sg_done, desc,
+                   desc->sg[0].dst, desc->sg[0].src, desc->sg[0].len);
+}
+
+/****************************************************************************
+ * Name: dma_memcpy
+ ****************************************************************************/
+
+int dma_memcpy(FAR struct dma_chan_s *chan, FAR void *dst,
+               FAR const void *src, size_t len)
+{
+  struct dma_config_s cfg;
+  struct dma_memcpy_s wait;
+  unsigned int width;
+  int ret;
+
+  if (chan == NULL || len < CONFIG_DMA_MEMCPY_THRESHOLD)
+    {
+      memcpy(dst, src, len);
+      return OK;
+    }
+
+  /* Move words when both ends and the length allow it */
+
+  width = (((uintptr_t)dst | (uintptr_t)src | len) & 3) == 0 ? 4 : 1;
+
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.direction = DMA_MEM_TO_MEM;
+  cfg.dst_width = width;
+  cfg.src_width = width;
+  cfg.dst_step  = width;
+  cfg.src_step  = width;
+
+  ret = DMA_CONFIG(chan, &cfg);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The destination is flushed too, so that no dirty line is written back
+   * over the new data.
+   */
+
+  up_clean_dcache((uintptr_t)src, (uintptr_t)src + len);
+  up_flush_dcache((uintptr_t)dst, (uintptr_t)dst + len);
+
+  nxsem_init(&wait.sem, 0, 0);
+  ret = DMA_START(chan, dma_memcpy_done, &wait,
+                  up_addrenv_va_to_pa(dst),
+                  up_addrenv_va_to_pa((FAR void *)src), len);
+  if (ret >= 0)
+    {
+      ret = nxsem_wait_uninterruptible(&wait.sem);
+      if (ret < 0)
+        {
+          DMA_STOP(chan);
+        }
+      else if (wait.result < 0)
+        {
+          ret = wait.result;
+        }
+    }
+
+  nxsem_destroy(&wait.sem);
+  up_invalidate_dcache((uintptr_t)dst, (uintptr_t)dst + len);
+  return ret < 0 ? ret : OK;
+}
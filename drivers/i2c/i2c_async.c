@@ -0,0 +1,234 @@
+/****************************************************************************
+ * drivers/i2c/i2c_async.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/i2c/i2c_master.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_ASYNC_HPWORK
+#  define I2C_ASYNC_WORK HPWORK
+#else
+#  define I2C_ASYNC_WORK LPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The queue of the requests of a bus without native asynchronous support */
+
+struct i2c_async_s
+{
+  FAR struct i2c_async_s *flink; /* Next bus with a queue */
+  FAR struct i2c_master_s *dev;  /* The bus */
+  sq_queue_t queue;              /* The pending requests */
+  struct work_s work;            /* Runs the pending requests */
+  bool running;                  /* The work is queued or running */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The queues are never freed, so they may be looked up without a lock
+ * once they are on the list.
+ */
+
+static FAR struct i2c_async_s *g_i2c_async;
+static spinlock_t g_i2c_async_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_async_find
+ ****************************************************************************/
+
+static FAR struct i2c_async_s *i2c_async_find(FAR struct i2c_master_s *dev)
+{
+  FAR struct i2c_async_s *async;
+
+  for (async = g_i2c_async; async != NULL; async = async->flink)
+    {
+      if (async->dev == dev)
+        {
+          break;
+        }
+    }
+
+  return async;
+}
+
+/****************************************************************************
+ * Name: i2c_async_worker
+ *
+ * Description:
+ *   Run the pending requests of a bus back to back through the blocking
+ *   transfer method of the lower half.
+ *
+ ****************************************************************************/
+
+static void i2c_async_worker(FAR void *arg)
+{
+  FAR struct i2c_async_s *async = arg;
+  FAR struct i2c_request_s *req;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&g_i2c_async_lock);
+      req = (FAR struct i2c_request_s *)sq_remfirst(&async->queue);
+      if (req == NULL)
+        {
+          async->running = false;
+          spin_unlock_irqrestore(&g_i2c_async_lock, flags);
+          break;
+        }
+
+      spin_unlock_irqrestore(&g_i2c_async_lock, flags);
+
+      /* Some lower halves return the number of messages transferred */
+
+      ret = I2C_TRANSFER(async->dev, req->msgs, req->count);
+      req->result = ret < 0 ? ret : OK;
+
+      /* The callback may queue the next request, even the same one */
+
+      if (req->complete != NULL)
+        {
+          req->complete(req);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_async_initialize
+ *
+ * Description:
+ *   Create the request queue of a bus.  Any number of calls for the same
+ *   bus are allowed.
+ *
+ ****************************************************************************/
+
+int i2c_async_initialize(FAR struct i2c_master_s *dev)
+{
+  FAR struct i2c_async_s *async;
+  FAR struct i2c_async_s *other;
+  irqstate_t flags;
+
+  DEBUGASSERT(dev != NULL && dev->ops != NULL);
+
+  if (dev->ops->transfer_async != NULL || i2c_async_find(dev) != NULL)
+    {
+      return OK;
+    }
+
+  async = kmm_zalloc(sizeof(*async));
+  if (async == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  async->dev = dev;
+  sq_init(&async->queue);
+
+  /* Another thread may have been faster */
+
+  flags = spin_lock_irqsave(&g_i2c_async_lock);
+  other = i2c_async_find(dev);
+  if (other == NULL)
+    {
+      async->flink = g_i2c_async;
+      g_i2c_async  = async;
+    }
+
+  spin_unlock_irqrestore(&g_i2c_async_lock, flags);
+
+  if (other != NULL)
+    {
+      kmm_free(async);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: i2c_async
+ *
+ * Description:
+ *   Queue a request on a bus and return at once.
+ *
+ ****************************************************************************/
+
+int i2c_async(FAR struct i2c_master_s *dev, FAR struct i2c_request_s *req)
+{
+  FAR struct i2c_async_s *async;
+  irqstate_t flags;
+
+  DEBUGASSERT(dev != NULL && dev->ops != NULL && req != NULL &&
+              req->msgs != NULL && req->count > 0);
+
+  req->result = -EINPROGRESS;
+
+  if (dev->ops->transfer_async != NULL)
+    {
+      return dev->ops->transfer_async(dev, req);
+    }
+
+  async = i2c_async_find(dev);
+  if (async == NULL)
+    {
+      return -ENODEV;
+    }
+
+  flags = spin_lock_irqsave(&g_i2c_async_lock);
+  sq_addlast(&req->node, &async->queue);
+  if (!async->running)
+    {
+      async->running = true;
+      work_queue(I2C_ASYNC_WORK, &async->work, i2c_async_worker, async, 0);
+    }
+
+  spin_unlock_irqrestore(&g_i2c_async_lock, flags);
+  return OK;
+}
@@ -48,6 +48,11 @@ struct mouse_openpriv_s
   FAR struct pollfd *fds;     /* Polling structure of waiting thread */
   sem_t              waitsem; /* Used to wait for the availability of data */
   mutex_t            lock;    /* Manages exclusive access to this structure */
+#ifdef CONFIG_INPUT_COALESCE
+  struct mouse_report_s last;   /* Latest report */
+  struct mouse_report_s motion; /* Latest motion, not queued yet */
+  bool               moving;    /* Whether 'motion' holds a report */
+#endif
 };
 
 /* This structure is for mouse upper half driver */
@@ -73,6 +78,12 @@ static int     mouse_ioctl(FAR struct file *filep, int cmd,
 static int     mouse_poll(FAR struct file *filep, FAR struct pollfd *fds,
                           bool setup);
 
+#ifdef CONFIG_INPUT_COALESCE
+static void    mouse_flush(FAR struct mouse_openpriv_s *openpriv);
+#else
+#  define mouse_flush(openpriv)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -94,6 +105,26 @@ static const struct file_operations g_mouse_fops =
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_INPUT_COALESCE
+/****************************************************************************
+ * Name: mouse_flush
+ *
+ * Description:
+ *   Queue the pending motion report, ahead of any newer report.
+ *
+ ****************************************************************************/
+
+static void mouse_flush(FAR struct mouse_openpriv_s *openpriv)
+{
+  if (openpriv->moving)
+    {
+      circbuf_overwrite(&openpriv->circbuf, &openpriv->motion,
+                        sizeof(struct mouse_report_s));
+      openpriv->moving = false;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: mouse_open
  ****************************************************************************/
@@ -200,6 +231,7 @@ static ssize_t mouse_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
+  mouse_flush(openpriv);
   while (circbuf_is_empty(&openpriv->circbuf))
     {
       if (filep->f_oflags & O_NONBLOCK)
@@ -221,6 +253,8 @@ static ssize_t mouse_read(FAR struct file *filep, FAR char *buffer,
             {
               return ret;
             }
+
+          mouse_flush(openpriv);
         }
     }
 
@@ -291,6 +325,7 @@ static int mouse_poll(FAR struct file *filep,
           goto errout;
         }
 
+      mouse_flush(openpriv);
       if (!circbuf_is_empty(&openpriv->circbuf))
         {
           eventset |= POLLIN;
@@ -330,8 +365,31 @@ void mouse_event(FAR void *priv, FAR const struct mouse_report_s *sample)
 
   list_for_every_entry(&upper->head, openpriv, struct mouse_openpriv_s, node)
     {
+#ifdef CONFIG_INPUT_COALESCE
+      /* Reports changing the buttons or the wheel are queued in order, the
+       * motion in between is merged until the reader catches up.
+       */
+
+      nxmutex_lock(&openpriv->lock);
+      if (sample->buttons == openpriv->last.buttons &&
+          sample->wheel == openpriv->last.wheel)
+        {
+          openpriv->motion = *sample;
+          openpriv->moving = true;
+        }
+      else
+        {
+          mouse_flush(openpriv);
+          circbuf_overwrite(&openpriv->circbuf, sample,
+                            sizeof(struct mouse_report_s));
+        }
+
+      openpriv->last = *sample;
+      nxmutex_unlock(&openpriv->lock);
+#else
       circbuf_overwrite(&openpriv->circbuf, sample,
                         sizeof(struct mouse_report_s));
+#endif
 
       nxsem_get_value(&openpriv->waitsem, &semcount);
       if (semcount < 1)
@@ -53,6 +53,10 @@ struct touch_openpriv_s
   FAR struct pollfd *fds;     /* Polling structure of waiting thread */
   sem_t              waitsem; /* Used to wait for the availability of data */
   mutex_t            lock;    /* Manages exclusive access to this structure */
+#ifdef CONFIG_INPUT_COALESCE
+  FAR struct touch_sample_s *motion; /* Latest motion, not queued yet */
+  bool               moving;         /* Whether 'motion' holds a sample */
+#endif
 };
 
 /* This structure is for touchscreen upper half driver */
@@ -85,6 +89,12 @@ static void    touch_event_notify(FAR struct touch_upperhalf_s *upper,
                                   FAR struct touch_openpriv_s  *openpriv,
                                   FAR struct touch_sample_s *sample);
 
+#ifdef CONFIG_INPUT_COALESCE
+static void    touch_flush(FAR struct touch_openpriv_s *openpriv);
+#else
+#  define touch_flush(openpriv)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -106,6 +116,78 @@ static const struct file_operations g_touch_fops =
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_INPUT_COALESCE
+/****************************************************************************
+ * Name: touch_flush
+ *
+ * Description:
+ *   Queue the pending motion sample, ahead of any newer event.
+ *
+ ****************************************************************************/
+
+static void touch_flush(FAR struct touch_openpriv_s *openpriv)
+{
+  if (openpriv->moving)
+    {
+      circbuf_overwrite(&openpriv->circbuf, openpriv->motion,
+                        SIZEOF_TOUCH_SAMPLE_S(openpriv->motion->npoints));
+      openpriv->moving = false;
+    }
+}
+
+/****************************************************************************
+ * Name: touch_coalesce
+ *
+ * Description:
+ *   Keep a sample that only moves the contacts of the pending motion, or
+ *   any moves when there is none, as the pending motion.  Return false if
+ *   the sample must be queued.
+ *
+ ****************************************************************************/
+
+static bool touch_coalesce(FAR struct touch_upperhalf_s *upper,
+                           FAR struct touch_openpriv_s *openpriv,
+                           FAR const struct touch_sample_s *sample)
+{
+  FAR struct touch_sample_s *motion = openpriv->motion;
+  int n;
+
+  if (sample->npoints < 1 || sample->npoints > upper->lower->maxpoint)
+    {
+      return false;
+    }
+
+  for (n = 0; n < sample->npoints; n++)
+    {
+      if ((sample->point[n].flags & (TOUCH_DOWN | TOUCH_UP)) != 0 ||
+          (sample->point[n].flags & TOUCH_MOVE) == 0)
+        {
+          return false;
+        }
+    }
+
+  if (openpriv->moving)
+    {
+      if (motion->npoints != sample->npoints)
+        {
+          return false;
+        }
+
+      for (n = 0; n < sample->npoints; n++)
+        {
+          if (motion->point[n].id != sample->point[n].id)
+            {
+              return false;
+            }
+        }
+    }
+
+  memcpy(motion, sample, SIZEOF_TOUCH_SAMPLE_S(sample->npoints));
+  openpriv->moving = true;
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: touch_open
  ****************************************************************************/
@@ -132,9 +214,22 @@ static int touch_open(FAR struct file *filep)
       return ret;
     }
 
+#ifdef CONFIG_INPUT_COALESCE
+  openpriv->motion = kmm_malloc(SIZEOF_TOUCH_SAMPLE_S(lower->maxpoint));
+  if (openpriv->motion == NULL)
+    {
+      circbuf_uninit(&openpriv->circbuf);
+      kmm_free(openpriv);
+      return -ENOMEM;
+    }
+#endif
+
   ret = nxmutex_lock(&upper->lock);
   if (ret < 0)
     {
+#ifdef CONFIG_INPUT_COALESCE
+      kmm_free(openpriv->motion);
+#endif
       circbuf_uninit(&openpriv->circbuf);
       kmm_free(openpriv);
       return ret;
@@ -183,6 +278,9 @@ static int touch_close(FAR struct file *filep)
 
   list_delete(&openpriv->node);
   circbuf_uninit(&openpriv->circbuf);
+#ifdef CONFIG_INPUT_COALESCE
+  kmm_free(openpriv->motion);
+#endif
   nxsem_destroy(&openpriv->waitsem);
   nxmutex_destroy(&openpriv->lock);
   kmm_free(openpriv);
@@ -236,6 +334,7 @@ static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
+  touch_flush(openpriv);
   while (circbuf_is_empty(&openpriv->circbuf))
     {
       if (filep->f_oflags & O_NONBLOCK)
@@ -257,6 +356,8 @@ static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
             {
               return ret;
             }
+
+          touch_flush(openpriv);
         }
     }
 
@@ -363,6 +464,7 @@ static int touch_poll(FAR struct file *filep, FAR struct pollfd *fds,
           goto errout;
         }
 
+      touch_flush(openpriv);
       if (!circbuf_is_empty(&openpriv->circbuf))
         {
           eventset |= POLLIN;
@@ -414,8 +516,22 @@ static void touch_event_notify(FAR struct touch_upperhalf_s *upper,
     }
 
   nxmutex_lock(&openpriv->lock);
+
+#ifdef CONFIG_INPUT_COALESCE
+  /* Motion is merged until the reader catches up, the contacts going down
+   * or up and the reports of other contacts are queued in order.
+   */
+
+  if (!touch_coalesce(upper, openpriv, sample))
+    {
+      touch_flush(openpriv);
+      circbuf_overwrite(&openpriv->circbuf, sample,
+                        SIZEOF_TOUCH_SAMPLE_S(sample->npoints));
+    }
+#else
   circbuf_overwrite(&openpriv->circbuf, sample,
                     SIZEOF_TOUCH_SAMPLE_S(sample->npoints));
+#endif
 
   nxsem_get_value(&openpriv->waitsem, &n);
   if (n < 1)
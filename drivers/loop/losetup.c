@@ -66,6 +66,11 @@ struct loop_struct_s
   uint8_t      opencnt;      /* Count of open references to the loop device */
   bool         writeenabled; /* true: can write to device */
   struct file  devfile;      /* File struct of char device/file */
+#ifdef CONFIG_DEV_LOOP_DIRECT_IO
+  FAR struct inode *blkdrv;  /* Backing block driver, NULL if a file */
+  blkcnt_t     blkoffset;    /* Offset in block driver sectors */
+  uint16_t     blkratio;     /* Block driver sectors per loop sector */
+#endif
 };
 
 /****************************************************************************
@@ -185,8 +190,9 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
 {
   FAR struct loop_struct_s *dev;
   ssize_t nbytesread;
+  size_t nbytes;
+  size_t ndone = 0;
   off_t offset;
-  off_t ret;
 
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
@@ -197,33 +203,52 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
       return -EIO;
     }
 
-  /* Calculate the offset to read the sectors and seek to the position */
-
-  offset = start_sector * dev->sectsize + dev->offset;
-  ret = file_seek(&dev->devfile, offset, SEEK_SET);
-  if (ret < 0)
+#ifdef CONFIG_DEV_LOOP_DIRECT_IO
+  if (dev->blkdrv != NULL)
     {
-      ferr("ERROR: Seek failed for offset=%d: %d\n", (int)offset, (int)ret);
-      return -EIO;
+      nbytesread = dev->blkdrv->u.i_bops->read(dev->blkdrv, buffer,
+                      dev->blkoffset + start_sector * dev->blkratio,
+                      nsectors * dev->blkratio);
+      return nbytesread < 0 ? nbytesread : nbytesread / dev->blkratio;
     }
+#endif
 
-  /* Then read the requested number of sectors from that position */
+  /* Read the whole request at its offset in one call, the position is
+   * not shared so that concurrent requests do not need the lock.
+   */
 
-  do
+  offset = start_sector * dev->sectsize + dev->offset;
+  nbytes = nsectors * dev->sectsize;
+
+  while (ndone < nbytes)
     {
-      nbytesread = file_read(&dev->devfile, buffer,
-                             nsectors * dev->sectsize);
-      if (nbytesread < 0 && nbytesread != -EINTR)
+      nbytesread = file_pread(&dev->devfile, buffer + ndone,
+                              nbytes - ndone, offset + ndone);
+      if (nbytesread == -EINTR)
+        {
+          continue;
+        }
+      else if (nbytesread < 0)
         {
           ferr("ERROR: Read failed: %zd\n", nbytesread);
-          return (int)nbytesread;
+          if (ndone == 0)
+            {
+              return nbytesread;
+            }
+
+          break;
         }
+      else if (nbytesread == 0)
+        {
+          break;
+        }
+
+      ndone += nbytesread;
     }
-  while (nbytesread < 0);
 
   /* Return the number of sectors read */
 
-  return nbytesread / dev->sectsize;
+  return ndone / dev->sectsize;
 }
 
 /****************************************************************************
@@ -239,38 +264,64 @@ static ssize_t loop_write(FAR struct inode *inode,
 {
   FAR struct loop_struct_s *dev;
   ssize_t nbyteswritten;
+  size_t nbytes;
+  size_t ndone = 0;
   off_t offset;
-  off_t ret;
 
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
-  /* Calculate the offset to write the sectors and seek to the position */
+  if (start_sector + nsectors > dev->nsectors)
+    {
+      ferr("ERROR: Write past end of file\n");
+      return -EIO;
+    }
 
-  offset = start_sector * dev->sectsize + dev->offset;
-  ret = file_seek(&dev->devfile, offset, SEEK_SET);
-  if (ret < 0)
+#ifdef CONFIG_DEV_LOOP_DIRECT_IO
+  if (dev->blkdrv != NULL)
     {
-      ferr("ERROR: Seek failed for offset=%d: %d\n", (int)offset, (int)ret);
+      nbyteswritten = dev->blkdrv->u.i_bops->write(dev->blkdrv, buffer,
+                         dev->blkoffset + start_sector * dev->blkratio,
+                         nsectors * dev->blkratio);
+      return nbyteswritten < 0 ? nbyteswritten :
+                                 nbyteswritten / dev->blkratio;
     }
+#endif
 
-  /* Then write the requested number of sectors to that position */
+  /* Write the whole request at its offset in one call */
 
-  do
+  offset = start_sector * dev->sectsize + dev->offset;
+  nbytes = nsectors * dev->sectsize;
+
+  while (ndone < nbytes)
     {
-      nbyteswritten = file_write(&dev->devfile, buffer,
-                                 nsectors * dev->sectsize);
-      if (nbyteswritten < 0 && nbyteswritten != -EINTR)
+      nbyteswritten = file_pwrite(&dev->devfile, buffer + ndone,
+                                  nbytes - ndone, offset + ndone);
+      if (nbyteswritten == -EINTR)
+        {
+          continue;
+        }
+      else if (nbyteswritten < 0)
         {
-          ferr("ERROR: file_write failed: %zd\n", nbyteswritten);
-          return nbyteswritten;
+          ferr("ERROR: file_pwrite failed: %zd\n", nbyteswritten);
+          if (ndone == 0)
+            {
+              return nbyteswritten;
+            }
+
+          break;
         }
+      else if (nbyteswritten == 0)
+        {
+          break;
+        }
+
+      ndone += nbyteswritten;
     }
-  while (nbyteswritten < 0);
 
   /* Return the number of sectors written */
 
-  return nbyteswritten / dev->sectsize;
+  return ndone / dev->sectsize;
 }
 
 /****************************************************************************
@@ -302,6 +353,63 @@ static int loop_geometry(FAR struct inode *inode,
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: loop_setup_direct
+ *
+ * Description:
+ *   Use the backing block driver directly instead of a file opened on it,
+ *   which would put a block-to-character cache between the two block
+ *   drivers.  Only possible if the loop sectors and the offset are whole
+ *   sectors of the block driver.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_LOOP_DIRECT_IO
+static int loop_setup_direct(FAR struct loop_struct_s *dev,
+                             FAR const char *filename, bool readonly)
+{
+  FAR struct inode *inode;
+  struct geometry geo;
+  int ret;
+
+  ret = -EACCES;
+  if (!readonly)
+    {
+      ret = open_blockdriver(filename, 0, &inode);
+    }
+
+  if (ret >= 0)
+    {
+      dev->writeenabled = true;
+    }
+  else
+    {
+      ret = open_blockdriver(filename, MS_RDONLY, &inode);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  ret = inode->u.i_bops->geometry(inode, &geo);
+  if (ret < 0 || !geo.geo_available || geo.geo_sectorsize == 0 ||
+      dev->sectsize % geo.geo_sectorsize != 0 ||
+      dev->offset % geo.geo_sectorsize != 0)
+    {
+      finfo("%s: not usable directly, going through a file\n", filename);
+      close_blockdriver(inode);
+      dev->writeenabled = false;
+      return ret < 0 ? ret : -EINVAL;
+    }
+
+  dev->blkdrv    = inode;
+  dev->blkoffset = dev->offset / geo.geo_sectorsize;
+  dev->blkratio  = dev->sectsize / geo.geo_sectorsize;
+  dev->writeenabled &= geo.geo_writeenabled;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -364,6 +472,16 @@ int losetup(FAR const char *devname, FAR const char *filename,
   dev->sectsize  = sectsize;
   dev->offset    = offset;
 
+#ifdef CONFIG_DEV_LOOP_DIRECT_IO
+  /* A block driver is used as is, without a file and its cache */
+
+  if (S_ISBLK(sb.st_mode) &&
+      loop_setup_direct(dev, filename, readonly) >= 0)
+    {
+      goto register_dev;
+    }
+#endif
+
   /* Open the file. */
 
   /* First try to open the device R/W access (unless we are asked
@@ -392,6 +510,10 @@ int losetup(FAR const char *devname, FAR const char *filename,
         }
     }
 
+#ifdef CONFIG_DEV_LOOP_DIRECT_IO
+register_dev:
+#endif
+
   /* Inode private data will be reference to the loop device structure */
 
   ret = register_blockdriver(devname, &g_bops, 0, dev);
@@ -404,7 +526,16 @@ int losetup(FAR const char *devname, FAR const char *filename,
   return OK;
 
 errout_with_file:
-  file_close(&dev->devfile);
+#ifdef CONFIG_DEV_LOOP_DIRECT_IO
+  if (dev->blkdrv != NULL)
+    {
+      close_blockdriver(dev->blkdrv);
+    }
+  else
+#endif
+    {
+      file_close(&dev->devfile);
+    }
 
 errout_with_dev:
   nxmutex_destroy(&dev->lock);
@@ -466,6 +597,13 @@ int loteardown(FAR const char *devname)
 
   /* Release the device structure */
 
+#ifdef CONFIG_DEV_LOOP_DIRECT_IO
+  if (dev->blkdrv != NULL)
+    {
+      close_blockdriver(dev->blkdrv);
+    }
+#endif
+
   if (dev->devfile.f_inode != NULL)
     {
       file_close(&dev->devfile);
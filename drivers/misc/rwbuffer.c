@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <inttypes.h>
 #include <stdint.h>
@@ -64,6 +65,9 @@
 
 static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
                          size_t nblocks, FAR uint8_t *rdbuffer);
+#ifdef CONFIG_DRVR_READAHEAD
+static inline void rwb_resetrhbuffer(FAR struct rwbuffer_s *rwb);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -169,11 +173,229 @@ static void rwb_wrflush(FAR struct rwbuffer_s *rwb)
           ferr("ERROR: Error flushing write buffer: %d\n", ret);
         }
 
+#ifdef CONFIG_DRVR_READAHEAD
+      /* The read-ahead may have been loaded with what the media held
+       * before.
+       */
+
+      if (rwb->rhmaxblocks > 0 && rwb_lock(&rwb->rhlock) >= 0)
+        {
+          if (rwb_overlap(rwb->rhblockstart, rwb->rhnblocks,
+                          rwb->wrblockstart, rwb->wrnblocks))
+            {
+              rwb_resetrhbuffer(rwb);
+            }
+
+          rwb_unlock(&rwb->rhlock);
+        }
+#endif
+
       rwb_resetwrbuffer(rwb);
     }
 }
 #endif
 
+/****************************************************************************
+ * Name: rwb_wrswap
+ *
+ * Description:
+ *   Exchange the write buffer with a parked one.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+static void rwb_wrswap(FAR struct rwbuffer_s *rwb,
+                       FAR struct rwb_slot_s *slot)
+{
+  FAR uint8_t *buffer = rwb->wrbuffer;
+  off_t blockstart = rwb->wrblockstart;
+  uint16_t nblocks = rwb->wrnblocks;
+
+  rwb->wrbuffer     = slot->buffer;
+  rwb->wrblockstart = slot->blockstart;
+  rwb->wrnblocks    = slot->nblocks;
+  slot->buffer      = buffer;
+  slot->blockstart  = blockstart;
+  slot->nblocks     = nblocks;
+}
+
+/****************************************************************************
+ * Name: rwb_wrunpark
+ *
+ * Description:
+ *   Move the empty slot 'i' from the parked ones to the free ones.
+ *
+ ****************************************************************************/
+
+static void rwb_wrunpark(FAR struct rwbuffer_s *rwb, int i)
+{
+  struct rwb_slot_s slot = rwb->wrslots[i];
+
+  rwb->wrnparked--;
+  memmove(&rwb->wrslots[i], &rwb->wrslots[i + 1],
+          (rwb->wrnparked - i) * sizeof(struct rwb_slot_s));
+  rwb->wrslots[rwb->wrnparked] = slot;
+}
+
+/****************************************************************************
+ * Name: rwb_wrflushslot
+ ****************************************************************************/
+
+static void rwb_wrflushslot(FAR struct rwbuffer_s *rwb, int i)
+{
+  rwb_wrswap(rwb, &rwb->wrslots[i]);
+  rwb_wrflush(rwb);
+  rwb_wrswap(rwb, &rwb->wrslots[i]);
+  rwb_wrunpark(rwb, i);
+}
+
+/****************************************************************************
+ * Name: rwb_wrflushall
+ ****************************************************************************/
+
+static void rwb_wrflushall(FAR struct rwbuffer_s *rwb)
+{
+  rwb_wrflush(rwb);
+  while (rwb->wrnparked > 0)
+    {
+      rwb_wrflushslot(rwb, rwb->wrnparked - 1);
+    }
+}
+
+/****************************************************************************
+ * Name: rwb_wrpark
+ *
+ * Description:
+ *   Make the write buffer free for a write at 'startblock'.  Partly filled
+ *   data is put aside in a slot, unless it is complete or the write
+ *   covers it, evicting the least recently used slot if all are taken.
+ *
+ ****************************************************************************/
+
+static void rwb_wrpark(FAR struct rwbuffer_s *rwb, off_t startblock,
+                       size_t nblocks)
+{
+  off_t alignstart = startblock - startblock % rwb->wralignblocks;
+  struct rwb_slot_s slot;
+
+  if (rwb->wrnblocks == 0)
+    {
+      return;
+    }
+
+  if (rwb->wrnslots == 0 || rwb->wrnblocks >= rwb->wrmaxblocks ||
+      rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, alignstart,
+                  startblock + nblocks - alignstart))
+    {
+      rwb_wrflush(rwb);
+      return;
+    }
+
+  if (rwb->wrnparked == rwb->wrnslots)
+    {
+      rwb_wrflushslot(rwb, rwb->wrnparked - 1);
+    }
+
+  slot = rwb->wrslots[rwb->wrnparked];
+  memmove(&rwb->wrslots[1], &rwb->wrslots[0],
+          rwb->wrnparked * sizeof(struct rwb_slot_s));
+  rwb->wrslots[0] = slot;
+  rwb->wrnparked++;
+  rwb_wrswap(rwb, &rwb->wrslots[0]);
+}
+
+/****************************************************************************
+ * Name: rwb_wrresume
+ *
+ * Description:
+ *   Before a write: bring back the parked buffer the write continues, and
+ *   flush the other parked ones it touches, so that they can never be
+ *   written over newer data later.
+ *
+ ****************************************************************************/
+
+static void rwb_wrresume(FAR struct rwbuffer_s *rwb, off_t startblock,
+                         size_t nblocks)
+{
+  FAR struct rwb_slot_s *slot;
+  off_t alignstart;
+  struct rwb_slot_s tmp;
+  int i;
+
+  if (rwb->wrnparked == 0 ||
+      (rwb->wrnblocks > 0 && startblock >= rwb->wrblockstart &&
+       startblock <= rwb->wrblockstart + rwb->wrnblocks))
+    {
+      goto flush;
+    }
+
+  for (i = 0; i < rwb->wrnparked; i++)
+    {
+      slot = &rwb->wrslots[i];
+      if (startblock >= slot->blockstart &&
+          startblock <= slot->blockstart + slot->nblocks &&
+          startblock < slot->blockstart + rwb->wrmaxblocks)
+        {
+          /* The former write buffer becomes the most recent slot */
+
+          rwb_wrswap(rwb, slot);
+          tmp = *slot;
+          memmove(&rwb->wrslots[1], &rwb->wrslots[0],
+                  i * sizeof(struct rwb_slot_s));
+          rwb->wrslots[0] = tmp;
+          if (tmp.nblocks == 0)
+            {
+              rwb_wrunpark(rwb, 0);
+            }
+
+          break;
+        }
+    }
+
+flush:
+  alignstart = startblock - startblock % rwb->wralignblocks;
+  for (i = rwb->wrnparked - 1; i >= 0; i--)
+    {
+      slot = &rwb->wrslots[i];
+      if (rwb_overlap(slot->blockstart, slot->nblocks, alignstart,
+                      startblock + nblocks - alignstart))
+        {
+          rwb_wrflushslot(rwb, i);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: rwb_wroverlay
+ *
+ * Description:
+ *   Copy the parked data over what was read from the media.
+ *
+ ****************************************************************************/
+
+static void rwb_wroverlay(FAR struct rwbuffer_s *rwb, off_t startblock,
+                          size_t nblocks, FAR uint8_t *rdbuffer)
+{
+  FAR struct rwb_slot_s *slot;
+  off_t start;
+  off_t end;
+  int i;
+
+  for (i = 0; i < rwb->wrnparked; i++)
+    {
+      slot  = &rwb->wrslots[i];
+      start = MAX(slot->blockstart, startblock);
+      end   = MIN(slot->blockstart + slot->nblocks, startblock + nblocks);
+      if (start < end)
+        {
+          memcpy(rdbuffer + (start - startblock) * rwb->blocksize,
+                 slot->buffer + (start - slot->blockstart) * rwb->blocksize,
+                 (end - start) * rwb->blocksize);
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: rwb_wrtimeout
  ****************************************************************************/
@@ -194,7 +416,7 @@ static void rwb_wrtimeout(FAR void *arg)
    */
 
   rwb_lock(&rwb->wrlock);
-  rwb_wrflush(rwb);
+  rwb_wrflushall(rwb);
   rwb_unlock(&rwb->wrlock);
 }
 #endif
@@ -244,6 +466,7 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
   /* Write writebuffer Logic */
 
   rwb_wrcanceltimeout(rwb);
+  rwb_wrresume(rwb, startblock, nblocks);
 
   /* Is data saved in the write buffer? */
 
@@ -267,7 +490,7 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
 
       /* 2. We update the entire write buffer. */
 
-      else if (rwb->wrblockstart > startblock && wrbend < newend)
+      else if (rwb->wrblockstart >= startblock && wrbend <= newend)
         {
           rwb->wrnblocks = 0;
         }
@@ -331,7 +554,18 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
 
   if (nblocks > rwb->wrmaxblocks)
     {
-      ssize_t ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
+      ssize_t ret;
+
+      /* The older data buffered here must not land after this write */
+
+      if (rwb->wrnblocks > 0 &&
+          rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, startblock,
+                      nblocks))
+        {
+          rwb_wrflush(rwb);
+        }
+
+      ret = rwb->wrflush(rwb->dev, wrbuffer, startblock, nblocks);
       if (ret < 0)
         {
           return ret;
@@ -345,9 +579,9 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
       size_t padblocks;
       size_t remain = nblocks;
 
-      /* Flush the write buffer */
+      /* Flush the write buffer, or put it aside */
 
-      rwb_wrflush(rwb);
+      rwb_wrpark(rwb, startblock, nblocks);
 
       /* Get the alignment padding of startblock, and read the contents
        * of the padding area, ensure that wrblockstart is aligned
@@ -377,7 +611,7 @@ static ssize_t rwb_writebuffer(FAR struct rwbuffer_s *rwb,
       wrbuffer += remain * rwb->blocksize;
     }
 
-  if (rwb->wrnblocks > 0)
+  if (rwb->wrnblocks > 0 || rwb->wrnparked > 0)
     {
       rwb_wrstarttimeout(rwb);
     }
@@ -504,27 +738,18 @@ static int rwb_rhreload(FAR struct rwbuffer_s *rwb, off_t startblock)
  ****************************************************************************/
 
 #if defined(CONFIG_DRVR_WRITEBUFFER) && defined(CONFIG_DRVR_INVALIDATE)
-int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
-                               off_t startblock, size_t blockcount)
+static int rwb_wrinvalidate(FAR struct rwbuffer_s *rwb,
+                            off_t startblock, size_t blockcount)
 {
   int ret = OK;
 
-  /* Is there a write buffer?  Is data saved in the write buffer? */
+  /* Is data saved in the write buffer? */
 
-  if (rwb->wrmaxblocks > 0 && rwb->wrnblocks > 0)
+  if (rwb->wrnblocks > 0)
     {
       off_t wrbend;
       off_t invend;
 
-      finfo("startblock=%" PRIdOFF " blockcount=%zu\n",
-            startblock, blockcount);
-
-      ret = rwb_lock(&rwb->wrlock);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
       /* Now there are five cases:
        *
        * 1. We invalidate nothing
@@ -631,6 +856,44 @@ int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
           rwb->wrnblocks    = nkeep;
           ret = OK;
         }
+    }
+
+  return ret;
+}
+
+int rwb_invalidate_writebuffer(FAR struct rwbuffer_s *rwb,
+                               off_t startblock, size_t blockcount)
+{
+  int ret = OK;
+  int i;
+
+  /* Is there a write buffer?  Is data saved in the write buffer? */
+
+  if (rwb->wrmaxblocks > 0 && (rwb->wrnblocks > 0 || rwb->wrnparked > 0))
+    {
+      finfo("startblock=%" PRIdOFF " blockcount=%zu\n",
+            startblock, blockcount);
+
+      ret = rwb_lock(&rwb->wrlock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = rwb_wrinvalidate(rwb, startblock, blockcount);
+
+      /* The parked buffers go through the same, one at a time */
+
+      for (i = rwb->wrnparked - 1; ret >= 0 && i >= 0; i--)
+        {
+          rwb_wrswap(rwb, &rwb->wrslots[i]);
+          ret = rwb_wrinvalidate(rwb, startblock, blockcount);
+          rwb_wrswap(rwb, &rwb->wrslots[i]);
+          if (rwb->wrslots[i].nblocks == 0)
+            {
+              rwb_wrunpark(rwb, i);
+            }
+        }
 
       rwb_unlock(&rwb->wrlock);
     }
@@ -769,6 +1032,9 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
 int rwb_initialize(FAR struct rwbuffer_s *rwb)
 {
   uint32_t allocsize;
+#ifdef CONFIG_DRVR_WRITEBUFFER
+  int i;
+#endif
 
   /* Sanity checking */
 
@@ -809,17 +1075,38 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
 
       rwb_resetwrbuffer(rwb);
 
-      /* Allocate the write buffer */
+      /* Allocate the write buffer, and the ones of the slots after it */
 
       allocsize     = rwb->wrmaxblocks * rwb->blocksize;
-      rwb->wrbuffer = kmm_malloc(allocsize);
-      if (!rwb->wrbuffer)
+      rwb->wrpool   = kmm_malloc(allocsize * (rwb->wrnslots + 1));
+      rwb->wrslots  = NULL;
+      rwb->wrnparked = 0;
+      if (rwb->wrpool != NULL && rwb->wrnslots > 0)
+        {
+          rwb->wrslots = kmm_malloc(rwb->wrnslots *
+                                    sizeof(struct rwb_slot_s));
+          if (rwb->wrslots == NULL)
+            {
+              kmm_free(rwb->wrpool);
+              rwb->wrpool = NULL;
+            }
+        }
+
+      if (!rwb->wrpool)
         {
           ferr("Write buffer kmm_malloc(%" PRIu32 ") failed\n", allocsize);
           nxmutex_destroy(&rwb->wrlock);
           return -ENOMEM;
         }
 
+      rwb->wrbuffer = rwb->wrpool;
+      for (i = 0; i < rwb->wrnslots; i++)
+        {
+          rwb->wrslots[i].buffer     = rwb->wrpool + (i + 1) * allocsize;
+          rwb->wrslots[i].blockstart = -1;
+          rwb->wrslots[i].nblocks    = 0;
+        }
+
       finfo("Write buffer size: %" PRIu32 " bytes\n", allocsize);
     }
 #endif /* CONFIG_DRVR_WRITEBUFFER */
@@ -852,9 +1139,10 @@ int rwb_initialize(FAR struct rwbuffer_s *rwb)
               nxmutex_destroy(&rwb->wrlock);
             }
 
-          if (rwb->wrbuffer != NULL)
+          if (rwb->wrpool != NULL)
             {
-              kmm_free(rwb->wrbuffer);
+              kmm_free(rwb->wrpool);
+              kmm_free(rwb->wrslots);
             }
 #endif
 
@@ -878,11 +1166,12 @@ void rwb_uninitialize(FAR struct rwbuffer_s *rwb)
   if (rwb->wrmaxblocks > 0)
     {
       rwb_wrcanceltimeout(rwb);
-      rwb_wrflush(rwb);
+      rwb_wrflushall(rwb);
       nxmutex_destroy(&rwb->wrlock);
-      if (rwb->wrbuffer)
+      if (rwb->wrpool)
         {
-          kmm_free(rwb->wrbuffer);
+          kmm_free(rwb->wrpool);
+          kmm_free(rwb->wrslots);
         }
     }
 #endif
@@ -999,6 +1288,11 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
 {
   int ret = OK;
   size_t readblocks = 0;
+#ifdef CONFIG_DRVR_WRITEBUFFER
+  FAR uint8_t *rdorig = rdbuffer;
+  off_t rdstart = startblock;
+  size_t rdcount = nblocks;
+#endif
 
   finfo("startblock=%ld nblocks=%ld rdbuffer=%p\n",
         (long)startblock, (long)nblocks, rdbuffer);
@@ -1066,6 +1360,16 @@ ssize_t rwb_read(FAR struct rwbuffer_s *rwb, off_t startblock,
       return ret;
     }
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
+  /* The parked write buffers are newer than the media */
+
+  if (rwb->wrnparked > 0 && rwb_lock(&rwb->wrlock) >= 0)
+    {
+      rwb_wroverlay(rwb, rdstart, rdcount, rdorig);
+      rwb_unlock(&rwb->wrlock);
+    }
+#endif
+
   return readblocks + ret;
 }
 
@@ -1199,6 +1503,11 @@ int rwb_mediaremoved(FAR struct rwbuffer_s *rwb)
         }
 
       rwb_resetwrbuffer(rwb);
+      while (rwb->wrnparked > 0)
+        {
+          rwb->wrslots[--rwb->wrnparked].nblocks = 0;
+        }
+
       rwb_unlock(&rwb->wrlock);
     }
 #endif
@@ -1272,7 +1581,7 @@ int rwb_flush(FAR struct rwbuffer_s *rwb)
 
   ret = rwb_lock(&rwb->wrlock);
   rwb_wrcanceltimeout(rwb);
-  rwb_wrflush(rwb);
+  rwb_wrflushall(rwb);
   rwb_unlock(&rwb->wrlock);
 
   return ret;
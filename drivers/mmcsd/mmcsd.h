@@ -29,6 +29,7 @@
 
 #include <nuttx/config.h>
 #include <nuttx/sdio.h>
+#include <nuttx/wqueue.h>
 #include <stdint.h>
 #include <debug.h>
 
@@ -93,6 +94,9 @@ struct mmcsd_state_s
 #ifdef CONFIG_SDIO_DMA
   uint8_t dma:1;                   /* true: hardware supports DMA */
 #endif
+#ifdef CONFIG_MMCSD_PACKED_WRITE
+  uint8_t pkwrite:1;               /* true: Next CMD25 is a packed write */
+#endif
 
   uint8_t mode:4;                  /* (See MMCSDMODE_* definitions) */
   uint8_t type:4;                  /* Card type (See MMCSD_CARDTYPE_* definitions) */
@@ -108,6 +112,18 @@ struct mmcsd_state_s
 
   uint8_t  blockshift;             /* Log2 of blocksize */
   uint16_t blocksize;              /* Read block length (== block size) */
+
+#ifdef CONFIG_MMCSD_PACKED_WRITE
+  /* Writes to the user area queued for a packed write command */
+
+  FAR uint8_t *pkbuffer;           /* Packed header, then the queued data */
+  struct work_s pkwork;            /* Writes the queue out after a delay */
+  int      pkerror;                /* Failure of a write done by pkwork */
+  uint16_t pkmaxblocks;            /* Data blocks the queue holds */
+  uint16_t pkblocks;               /* Data blocks queued */
+  uint8_t  pkmax;                  /* Writes in a packed command, 0: none */
+  uint8_t  pkcount;                /* Writes queued */
+#endif
 };
 
 /****************************************************************************
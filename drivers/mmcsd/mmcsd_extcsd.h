@@ -53,6 +53,10 @@
 #define MMCSD_EXTCSD_HC_WP_GRP_SIZE                221  /* RO */
 #define MMCSD_EXTCSD_HC_ERASE_GRP_SIZE             224  /* RO */
 #define MMCSD_EXTCSD_BOOT_SIZE_MULT                226  /* RO */
+#define MMCSD_EXTCSD_PACKED_COMMAND_SUPPORT        495  /* RO */
+#define MMCSD_EXTCSD_MAX_PACKED_WRITES             500  /* RO */
+
+#define MMCSD_PACKED_WR_SUPPORT                    0x1
 
 /****************************************************************************
  * Public Types
@@ -32,7 +32,9 @@
 
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/param.h>
 
+#include <endian.h>
 #include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -104,6 +106,22 @@
 #  define MMCSD_MULTIBLOCK_LIMIT CONFIG_MMCSD_MULTIBLOCK_LIMIT
 #endif
 
+/* Packed write command.  The first data block is a header with the
+ * number of writes and a (block count, address) pair for each, the data
+ * of the writes follows in order.
+ */
+
+#define MMCSD_CMD23_PACKED      (1 << 30) /* CMD23 argument: packed command */
+#define MMCSD_PACKED_VERSION    0x01
+#define MMCSD_PACKED_WR         0x02
+#define MMCSD_PACKED_MAXWRITES  63        /* Pairs in a 512 byte header */
+
+#ifdef CONFIG_MMCSD_PACKED_WRITE
+#  define MMCSD_PKFLAGS(priv)   ((priv)->pkwrite ? MMCSD_CMD23_PACKED : 0)
+#else
+#  define MMCSD_PKFLAGS(priv)   0
+#endif
+
 #define MMCSD_CAPACITY(b, s)    ((s) >= 10 ? (b) << ((s) - 10) : (b) >> (10 - (s)))
 
 #ifdef CONFIG_BOARD_COREDUMP_BLKDEV
@@ -196,6 +214,19 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
 
 /* Block driver methods *****************************************************/
 
+/* Packed writes ************************************************************/
+
+#ifdef CONFIG_MMCSD_PACKED_WRITE
+static bool    mmcsd_pkoverlap(FAR struct mmcsd_state_s *priv,
+                               off_t startblock, size_t nblocks);
+static int     mmcsd_pkflush(FAR struct mmcsd_state_s *priv);
+static void    mmcsd_pkworker(FAR void *arg);
+static ssize_t mmcsd_pkqueue(FAR struct mmcsd_part_s *part,
+                             FAR const uint8_t *buffer, off_t startblock,
+                             size_t nblocks);
+static void    mmcsd_pkinitialize(FAR struct mmcsd_state_s *priv);
+#endif
+
 static int     mmcsd_open(FAR struct inode *inode);
 static int     mmcsd_close(FAR struct inode *inode);
 static ssize_t mmcsd_read(FAR struct inode *inode, FAR unsigned char *buffer,
@@ -2157,7 +2188,8 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
   if (IS_MMC(priv->type))
     {
       ret = mmcsd_setblockcount(priv, priv->partnum == MMCSD_PART_RPMB ?
-                                ((1 << 31) | nblocks) : nblocks);
+                                ((1 << 31) | nblocks) :
+                                (MMCSD_PKFLAGS(priv) | nblocks));
       if (ret != OK)
         {
           return ret;
@@ -2292,6 +2324,252 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
 }
 #endif
 
+#ifdef CONFIG_MMCSD_PACKED_WRITE
+/****************************************************************************
+ * Name: mmcsd_pkoverlap
+ *
+ * Description:
+ *   Check if a range of the user area overlaps the queued writes.
+ *
+ ****************************************************************************/
+
+static bool mmcsd_pkoverlap(FAR struct mmcsd_state_s *priv,
+                            off_t startblock, size_t nblocks)
+{
+  FAR uint32_t *hdr = (FAR uint32_t *)priv->pkbuffer;
+  off_t start;
+  int i;
+
+  for (i = 1; i <= priv->pkcount; i++)
+    {
+      start = le32toh(hdr[2 * i + 1]);
+      if (startblock < start + le32toh(hdr[2 * i]) &&
+          start < startblock + nblocks)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: mmcsd_pkflush
+ *
+ * Description:
+ *   Write the queued writes to the card, as one packed command if there
+ *   are several.  Returns the failure of a delayed write, if any, too.
+ *
+ ****************************************************************************/
+
+static int mmcsd_pkflush(FAR struct mmcsd_state_s *priv)
+{
+  FAR struct mmcsd_part_s *part = &priv->part[0];
+  FAR uint32_t *hdr = (FAR uint32_t *)priv->pkbuffer;
+  FAR uint8_t *data;
+  ssize_t nwrite = OK;
+  uint32_t nblocks;
+  int ret;
+  int i;
+
+  ret = priv->pkerror;
+  priv->pkerror = OK;
+  if (priv->pkcount == 0)
+    {
+      return ret;
+    }
+
+  work_cancel(LPWORK, &priv->pkwork);
+
+  if (priv->pkcount > 1)
+    {
+      hdr[0] = htole32(((uint32_t)priv->pkcount << 16) |
+                       (MMCSD_PACKED_WR << 8) | MMCSD_PACKED_VERSION);
+      hdr[1] = 0;
+
+      /* CMD25 carries the address of the first write */
+
+      priv->pkwrite = true;
+      nwrite = mmcsd_writemultiple(part, priv->pkbuffer, le32toh(hdr[3]),
+                                   priv->pkblocks + 1);
+      priv->pkwrite = false;
+      if (nwrite < 0)
+        {
+          ferr("ERROR: Packed write failed: %zd\n", nwrite);
+        }
+    }
+
+  /* A single write, or the writes of a failed packed command, are sent
+   * one at a time.  Writing a block again does no harm.
+   */
+
+  if (priv->pkcount == 1 || nwrite < 0)
+    {
+      data = priv->pkbuffer + priv->blocksize;
+      for (i = 1; i <= priv->pkcount; i++)
+        {
+          nblocks = le32toh(hdr[2 * i]);
+          if (nblocks == 1)
+            {
+              nwrite = mmcsd_writesingle(part, data,
+                                         le32toh(hdr[2 * i + 1]));
+            }
+          else
+            {
+              nwrite = mmcsd_writemultiple(part, data,
+                                           le32toh(hdr[2 * i + 1]),
+                                           nblocks);
+            }
+
+          if (nwrite < 0)
+            {
+              break;
+            }
+
+          data += nblocks << priv->blockshift;
+        }
+    }
+
+  priv->pkcount  = 0;
+  priv->pkblocks = 0;
+  return ret < 0 ? ret : nwrite < 0 ? nwrite : OK;
+}
+
+/****************************************************************************
+ * Name: mmcsd_pkworker
+ *
+ * Description:
+ *   Write the queue out when no read or write did it for a while.
+ *
+ ****************************************************************************/
+
+static void mmcsd_pkworker(FAR void *arg)
+{
+  FAR struct mmcsd_state_s *priv = arg;
+  int ret;
+
+  if (mmcsd_lock(priv) < 0)
+    {
+      return;
+    }
+
+  ret = mmcsd_pkflush(priv);
+  if (ret < 0)
+    {
+      ferr("ERROR: Delayed write failed: %d\n", ret);
+      priv->pkerror = ret;
+    }
+
+  mmcsd_unlock(priv);
+}
+
+/****************************************************************************
+ * Name: mmcsd_pkqueue
+ *
+ * Description:
+ *   Queue a write to the user area, extending the last queued write if it
+ *   carries on from it.  The queue is written out first if the write does
+ *   not fit or overlaps it.
+ *
+ ****************************************************************************/
+
+static ssize_t mmcsd_pkqueue(FAR struct mmcsd_part_s *part,
+                             FAR const uint8_t *buffer, off_t startblock,
+                             size_t nblocks)
+{
+  FAR struct mmcsd_state_s *priv = part->priv;
+  FAR uint32_t *hdr = (FAR uint32_t *)priv->pkbuffer;
+  int last;
+  int ret;
+
+  if (mmcsd_wrprotected(priv))
+    {
+      ferr("ERROR: Card is locked or write protected\n");
+      return -EPERM;
+    }
+
+  if (priv->pkerror < 0 ||
+      priv->pkblocks + nblocks > priv->pkmaxblocks ||
+      mmcsd_pkoverlap(priv, startblock, nblocks))
+    {
+      ret = mmcsd_pkflush(priv);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  last = priv->pkcount;
+  if (last > 0 &&
+      le32toh(hdr[2 * last + 1]) + le32toh(hdr[2 * last]) == startblock)
+    {
+      hdr[2 * last] = htole32(le32toh(hdr[2 * last]) + nblocks);
+    }
+  else
+    {
+      if (last == priv->pkmax)
+        {
+          ret = mmcsd_pkflush(priv);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      last = ++priv->pkcount;
+      hdr[2 * last]     = htole32(nblocks);
+      hdr[2 * last + 1] = htole32(startblock);
+    }
+
+  memcpy(priv->pkbuffer + ((1 + priv->pkblocks) << priv->blockshift),
+         buffer, nblocks << priv->blockshift);
+  priv->pkblocks += nblocks;
+
+  /* The delay runs from the first write of the queue */
+
+  if (work_available(&priv->pkwork))
+    {
+      work_queue(LPWORK, &priv->pkwork, mmcsd_pkworker, priv,
+                 MSEC2TICK(CONFIG_MMCSD_PACKED_DELAY));
+    }
+
+  return nblocks;
+}
+
+/****************************************************************************
+ * Name: mmcsd_pkinitialize
+ *
+ * Description:
+ *   Allocate the queue if the card supports packed writes.  The header
+ *   takes one 512 byte block and addresses are block numbers, so only
+ *   block addressed cards with 512 byte blocks are served.
+ *
+ ****************************************************************************/
+
+static void mmcsd_pkinitialize(FAR struct mmcsd_state_s *priv)
+{
+  if (priv->pkmax < 2 || priv->blocksize != 512 ||
+      !IS_BLOCK(priv->type) || priv->pkbuffer != NULL)
+    {
+      return;
+    }
+
+  priv->pkmaxblocks = MIN(CONFIG_MMCSD_PACKED_BLOCKS,
+                          MMCSD_MULTIBLOCK_LIMIT - 1);
+  priv->pkbuffer    = kmm_memalign(16, (1 + priv->pkmaxblocks) <<
+                                       priv->blockshift);
+  if (priv->pkbuffer == NULL)
+    {
+      ferr("ERROR: No memory for the packed write queue\n");
+      priv->pkmax = 0;
+      return;
+    }
+
+  finfo("Packed writes: %u writes, %u blocks\n",
+        priv->pkmax, priv->pkmaxblocks);
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_open
  *
@@ -2352,9 +2630,13 @@ static int mmcsd_close(FAR struct inode *inode)
       return ret;
     }
 
+#ifdef CONFIG_MMCSD_PACKED_WRITE
+  ret = mmcsd_pkflush(priv);
+#endif
+
   priv->crefs--;
   mmcsd_unlock(priv);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -2391,6 +2673,21 @@ static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
           return ret;
         }
 
+#ifdef CONFIG_MMCSD_PACKED_WRITE
+      /* Queued writes to the range must reach the card first */
+
+      if (part == priv->part &&
+          mmcsd_pkoverlap(priv, startsector, nsectors))
+        {
+          ret = mmcsd_pkflush(priv);
+          if (ret < 0)
+            {
+              mmcsd_unlock(priv);
+              return ret;
+            }
+        }
+#endif
+
       ret = nsectors;
       endsector = startsector + nsectors;
       for (sector = startsector; sector < endsector; sector += nread)
@@ -2472,6 +2769,27 @@ static ssize_t mmcsd_write(FAR struct inode *inode,
           return ret;
         }
 
+#ifdef CONFIG_MMCSD_PACKED_WRITE
+      /* Small writes to the user area are queued, any other write comes
+       * after the queued ones.
+       */
+
+      if (part == priv->part && priv->pkbuffer != NULL &&
+          nsectors <= priv->pkmaxblocks)
+        {
+          ret = mmcsd_pkqueue(part, buffer, startsector, nsectors);
+          mmcsd_unlock(priv);
+          return ret;
+        }
+
+      ret = mmcsd_pkflush(priv);
+      if (ret < 0)
+        {
+          mmcsd_unlock(priv);
+          return ret;
+        }
+#endif
+
       ret = nsectors;
       endsector = startsector + nsectors;
       for (sector = startsector; sector < endsector; sector += nwrite)
@@ -2609,8 +2927,29 @@ static int mmcsd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       return ret;
     }
 
+#ifdef CONFIG_MMCSD_PACKED_WRITE
+  /* Commands other than probe and eject may access the card, the queued
+   * writes go first.
+   */
+
+  if (cmd != BIOC_PROBE && cmd != BIOC_EJECT)
+    {
+      ret = mmcsd_pkflush(priv);
+      if (ret < 0)
+        {
+          mmcsd_unlock(priv);
+          return ret;
+        }
+    }
+#endif
+
   switch (cmd)
     {
+#ifdef CONFIG_MMCSD_PACKED_WRITE
+    case BIOC_FLUSH: /* Write out the queued writes, done above */
+      break;
+#endif
+
     case BIOC_PROBE: /* Check for media in the slot */
       {
         finfo("BIOC_PROBE\n");
@@ -2939,6 +3278,14 @@ static void mmcsd_decode_extcsd(FAR struct mmcsd_state_s *priv,
   finfo("MMC ext CSD read succsesfully, number of block %" PRIuOFF "\n",
                                                 priv->part[0].nblocks);
 
+#ifdef CONFIG_MMCSD_PACKED_WRITE
+  if (extcsd[MMCSD_EXTCSD_PACKED_COMMAND_SUPPORT] & MMCSD_PACKED_WR_SUPPORT)
+    {
+      priv->pkmax = MIN(extcsd[MMCSD_EXTCSD_MAX_PACKED_WRITES],
+                        MMCSD_PACKED_MAXWRITES);
+    }
+#endif
+
   if (extcsd[MMCSD_EXTCSD_PARTITION_SUPPORT] & MMCSD_PART_SUPPORT_PART_EN)
     {
       /* Boot partition size = 128KB byte x BOOT_SIZE_MULT */
@@ -3141,6 +3488,10 @@ static int mmcsd_mmcinitialize(FAR struct mmcsd_state_s *priv)
 
   mmcsd_decode_csd(priv, priv->csd);
 
+#ifdef CONFIG_MMCSD_PACKED_WRITE
+  mmcsd_pkinitialize(priv);
+#endif
+
   /* It's up to the driver to act on the widebus request.  mmcsd_widebus()
    * enables the CLOCK_MMC_TRANSFER, so call it here always.
    */
@@ -4446,6 +4797,18 @@ static int mmcsd_removed(FAR struct mmcsd_state_s *priv)
   priv->rca          = 0;
   priv->selblocklen  = 0;
 
+#ifdef CONFIG_MMCSD_PACKED_WRITE
+  /* Whatever is queued cannot be written any more */
+
+  work_cancel(LPWORK, &priv->pkwork);
+  kmm_free(priv->pkbuffer);
+  priv->pkbuffer     = NULL;
+  priv->pkmax        = 0;
+  priv->pkcount      = 0;
+  priv->pkblocks     = 0;
+  priv->pkerror      = OK;
+#endif
+
   /* Go back to the default 1-bit data bus. */
 
   priv->buswidth     = MMCSD_SCR_BUSWIDTH_1BIT;
@@ -898,6 +898,19 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd,
 
   finfo("path=\"%s\"\n", path);
 
+#ifdef CONFIG_FTL_LOG
+  /* Random writes become appends to the nvblk log, but it has no bad
+   * block handling and O_DIRECT asks for the media as is.
+   */
+
+  if ((oflags & O_DIRECT) == 0 && MTD_ISBAD(mtd, 0) == -ENOSYS)
+    {
+      return nvblk_initialize(path, mtd, CONFIG_MTD_NVBLK_DEFAULT_LBS,
+                              CONFIG_MTD_NVBLK_DEFAULT_IOBS,
+                              CONFIG_MTD_NVBLK_DEFAULT_SPEB);
+    }
+#endif
+
   /* Allocate a FTL device structure */
 
   dev = kmm_zalloc(sizeof(struct ftl_struct_s));
@@ -939,6 +952,7 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd,
 #if defined(CONFIG_FTL_WRITEBUFFER)
       dev->rwb.wrmaxblocks   = dev->blkper;
       dev->rwb.wralignblocks = dev->blkper;
+      dev->rwb.wrnslots      = CONFIG_FTL_NWRSLOTS;
 #endif
 
 #ifdef CONFIG_FTL_READAHEAD
@@ -0,0 +1,415 @@
+/****************************************************************************
+ * drivers/mtd/mtd_async.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* MTD driver that contains another MTD driver and runs the requests
+ * submitted through MTDIOC_SUBMIT in the background.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mtd/mtd.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The struct mtd_dev_s must appear at the beginning of the definition so
+ * that you can freely cast between pointers to struct mtd_dev_s and struct
+ * mtd_async_s.
+ */
+
+struct mtd_async_s
+{
+  struct mtd_dev_s      mtd;      /* Our exported MTD interface */
+  FAR struct mtd_dev_s *dev;      /* The contained MTD device */
+  mutex_t               lock;     /* Protects the queue, held by sync calls */
+  sem_t                 idle;     /* Posted when the queue runs empty */
+  sq_queue_t            pending;  /* Submitted, not yet run requests */
+  struct work_s         work;     /* Runs the requests */
+  bool                  busy;     /* The worker has requests to run */
+  uint8_t               nwaiters; /* Sync calls waiting for the worker */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     mtd_async_erase(FAR struct mtd_dev_s *dev, off_t startblock,
+                               size_t nblocks);
+static ssize_t mtd_async_bread(FAR struct mtd_dev_s *dev, off_t startblock,
+                               size_t nblocks, FAR uint8_t *buf);
+static ssize_t mtd_async_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
+                                size_t nblocks, FAR const uint8_t *buf);
+static ssize_t mtd_async_read(FAR struct mtd_dev_s *dev, off_t offset,
+                              size_t nbytes, FAR uint8_t *buffer);
+#ifdef CONFIG_MTD_BYTE_WRITE
+static ssize_t mtd_async_write(FAR struct mtd_dev_s *dev, off_t offset,
+                               size_t nbytes, FAR const uint8_t *buffer);
+#endif
+static int     mtd_async_ioctl(FAR struct mtd_dev_s *dev, int cmd,
+                               unsigned long arg);
+static int     mtd_async_isbad(FAR struct mtd_dev_s *dev, off_t block);
+static int     mtd_async_markbad(FAR struct mtd_dev_s *dev, off_t block);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mtd_async_worker
+ ****************************************************************************/
+
+static void mtd_async_worker(FAR void *arg)
+{
+  FAR struct mtd_async_s *priv = arg;
+  FAR struct mtd_dev_s *dev = priv->dev;
+  FAR struct mtd_request_s *req;
+
+  for (; ; )
+    {
+      nxmutex_lock(&priv->lock);
+      req = (FAR struct mtd_request_s *)sq_remfirst(&priv->pending);
+      if (req == NULL)
+        {
+          priv->busy = false;
+          while (priv->nwaiters > 0)
+            {
+              priv->nwaiters--;
+              nxsem_post(&priv->idle);
+            }
+
+          nxmutex_unlock(&priv->lock);
+          return;
+        }
+
+      nxmutex_unlock(&priv->lock);
+
+      /* Run it unlocked, so that more can be submitted meanwhile */
+
+      switch (req->op)
+        {
+          case MTD_REQ_ERASE:
+            req->result = MTD_ERASE(dev, req->block, req->count);
+            break;
+
+          case MTD_REQ_BREAD:
+            req->result = MTD_BREAD(dev, req->block, req->count,
+                                    req->buffer);
+            break;
+
+          case MTD_REQ_BWRITE:
+            req->result = MTD_BWRITE(dev, req->block, req->count,
+                                     req->buffer);
+            break;
+
+          default:
+            req->result = -EINVAL;
+            break;
+        }
+
+      req->done(req);
+    }
+}
+
+/****************************************************************************
+ * Name: mtd_async_submit
+ ****************************************************************************/
+
+static int mtd_async_submit(FAR struct mtd_async_s *priv,
+                            FAR struct mtd_request_s *req)
+{
+  int ret;
+
+  if (req == NULL || req->done == NULL || req->op > MTD_REQ_BWRITE)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  sq_addlast(&req->node, &priv->pending);
+  if (!priv->busy)
+    {
+      priv->busy = true;
+      work_queue(LPWORK, &priv->work, mtd_async_worker, priv, 0);
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mtd_async_lock
+ *
+ * Description:
+ *   Take the lock for a synchronous call once all the submitted requests
+ *   are done, so that the call is ordered after them.
+ *
+ ****************************************************************************/
+
+static int mtd_async_lock(FAR struct mtd_async_s *priv)
+{
+  int ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  while (ret >= 0 && priv->busy)
+    {
+      priv->nwaiters++;
+      nxmutex_unlock(&priv->lock);
+      nxsem_wait_uninterruptible(&priv->idle);
+      ret = nxmutex_lock(&priv->lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtd_async_erase
+ ****************************************************************************/
+
+static int mtd_async_erase(FAR struct mtd_dev_s *dev, off_t startblock,
+                           size_t nblocks)
+{
+  FAR struct mtd_async_s *priv = (FAR struct mtd_async_s *)dev;
+  int ret;
+
+  ret = mtd_async_lock(priv);
+  if (ret >= 0)
+    {
+      ret = MTD_ERASE(priv->dev, startblock, nblocks);
+      nxmutex_unlock(&priv->lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtd_async_bread
+ ****************************************************************************/
+
+static ssize_t mtd_async_bread(FAR struct mtd_dev_s *dev, off_t startblock,
+                               size_t nblocks, FAR uint8_t *buf)
+{
+  FAR struct mtd_async_s *priv = (FAR struct mtd_async_s *)dev;
+  ssize_t ret;
+
+  ret = mtd_async_lock(priv);
+  if (ret >= 0)
+    {
+      ret = MTD_BREAD(priv->dev, startblock, nblocks, buf);
+      nxmutex_unlock(&priv->lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtd_async_bwrite
+ ****************************************************************************/
+
+static ssize_t mtd_async_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
+                                size_t nblocks, FAR const uint8_t *buf)
+{
+  FAR struct mtd_async_s *priv = (FAR struct mtd_async_s *)dev;
+  ssize_t ret;
+
+  ret = mtd_async_lock(priv);
+  if (ret >= 0)
+    {
+      ret = MTD_BWRITE(priv->dev, startblock, nblocks, buf);
+      nxmutex_unlock(&priv->lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtd_async_read
+ ****************************************************************************/
+
+static ssize_t mtd_async_read(FAR struct mtd_dev_s *dev, off_t offset,
+                              size_t nbytes, FAR uint8_t *buffer)
+{
+  FAR struct mtd_async_s *priv = (FAR struct mtd_async_s *)dev;
+  ssize_t ret;
+
+  ret = mtd_async_lock(priv);
+  if (ret >= 0)
+    {
+      ret = MTD_READ(priv->dev, offset, nbytes, buffer);
+      nxmutex_unlock(&priv->lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtd_async_write
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+static ssize_t mtd_async_write(FAR struct mtd_dev_s *dev, off_t offset,
+                               size_t nbytes, FAR const uint8_t *buffer)
+{
+  FAR struct mtd_async_s *priv = (FAR struct mtd_async_s *)dev;
+  ssize_t ret;
+
+  ret = mtd_async_lock(priv);
+  if (ret >= 0)
+    {
+      ret = MTD_WRITE(priv->dev, offset, nbytes, buffer);
+      nxmutex_unlock(&priv->lock);
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: mtd_async_ioctl
+ ****************************************************************************/
+
+static int mtd_async_ioctl(FAR struct mtd_dev_s *dev, int cmd,
+                           unsigned long arg)
+{
+  FAR struct mtd_async_s *priv = (FAR struct mtd_async_s *)dev;
+  int ret;
+
+  if (cmd == MTDIOC_SUBMIT)
+    {
+      return mtd_async_submit(priv,
+                              (FAR struct mtd_request_s *)(uintptr_t)arg);
+    }
+
+  /* Everything else, BIOC_FLUSH included, waits for the queue */
+
+  ret = mtd_async_lock(priv);
+  if (ret >= 0)
+    {
+      ret = MTD_IOCTL(priv->dev, cmd, arg);
+      nxmutex_unlock(&priv->lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtd_async_isbad
+ ****************************************************************************/
+
+static int mtd_async_isbad(FAR struct mtd_dev_s *dev, off_t block)
+{
+  FAR struct mtd_async_s *priv = (FAR struct mtd_async_s *)dev;
+  int ret;
+
+  ret = mtd_async_lock(priv);
+  if (ret >= 0)
+    {
+      ret = MTD_ISBAD(priv->dev, block);
+      nxmutex_unlock(&priv->lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mtd_async_markbad
+ ****************************************************************************/
+
+static int mtd_async_markbad(FAR struct mtd_dev_s *dev, off_t block)
+{
+  FAR struct mtd_async_s *priv = (FAR struct mtd_async_s *)dev;
+  int ret;
+
+  ret = mtd_async_lock(priv);
+  if (ret >= 0)
+    {
+      ret = MTD_MARKBAD(priv->dev, block);
+      nxmutex_unlock(&priv->lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mtd_async_initialize
+ *
+ * Description:
+ *   Create an MTD device that contains another one and also takes
+ *   requests through MTDIOC_SUBMIT.
+ *
+ ****************************************************************************/
+
+FAR struct mtd_dev_s *mtd_async_initialize(FAR struct mtd_dev_s *mtd)
+{
+  FAR struct mtd_async_s *priv;
+
+  DEBUGASSERT(mtd != NULL);
+
+  priv = kmm_zalloc(sizeof(struct mtd_async_s));
+  if (priv == NULL)
+    {
+      ferr("ERROR: Failed to allocate mtd_async\n");
+      return NULL;
+    }
+
+  priv->mtd.erase   = mtd_async_erase;
+  priv->mtd.bread   = mtd_async_bread;
+  priv->mtd.bwrite  = mtd_async_bwrite;
+  priv->mtd.read    = mtd->read ? mtd_async_read : NULL;
+#ifdef CONFIG_MTD_BYTE_WRITE
+  priv->mtd.write   = mtd->write ? mtd_async_write : NULL;
+#endif
+  priv->mtd.ioctl   = mtd_async_ioctl;
+  priv->mtd.isbad   = mtd->isbad ? mtd_async_isbad : NULL;
+  priv->mtd.markbad = mtd->markbad ? mtd_async_markbad : NULL;
+  priv->mtd.name    = mtd->name;
+  priv->dev         = mtd;
+
+  nxmutex_init(&priv->lock);
+  nxsem_init(&priv->idle, 0, 0);
+  sq_init(&priv->pending);
+  return &priv->mtd;
+}
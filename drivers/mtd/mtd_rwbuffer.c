@@ -69,6 +69,10 @@
 #  define CONFIG_MTD_NRDBLOCKS 4
 #endif
 
+#ifndef CONFIG_MTD_NWRSLOTS
+#  define CONFIG_MTD_NWRSLOTS 0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -366,6 +370,21 @@ static int mtd_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
  ****************************************************************************/
 
 FAR struct mtd_dev_s *mtd_rwb_initialize(FAR struct mtd_dev_s *mtd)
+{
+  return mtd_rwb_initialize_slots(mtd, CONFIG_MTD_NWRSLOTS);
+}
+
+/****************************************************************************
+ * Name: mtd_rwb_initialize_slots
+ *
+ * Description:
+ *   As mtd_rwb_initialize(), with 'nslots' more write buffers kept for
+ *   writes that alternate between regions, e.g. for one partition.
+ *
+ ****************************************************************************/
+
+FAR struct mtd_dev_s *mtd_rwb_initialize_slots(FAR struct mtd_dev_s *mtd,
+                                               uint8_t nslots)
 {
   FAR struct mtd_rwbuffer_s *priv;
   struct mtd_geometry_s geo;
@@ -429,6 +448,7 @@ FAR struct mtd_dev_s *mtd_rwb_initialize(FAR struct mtd_dev_s *mtd)
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
   priv->rwb.wrmaxblocks = CONFIG_MTD_NWRBLOCKS;
+  priv->rwb.wrnslots    = nslots;
 #endif
 #ifdef CONFIG_DRVR_READAHEAD
   priv->rwb.rhmaxblocks = CONFIG_MTD_NRDBLOCKS;
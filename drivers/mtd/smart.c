@@ -29,6 +29,7 @@
 #include <sys/types.h>
 #include <sys/ioctl.h>
 #include <sys/mount.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <inttypes.h>
 #include <stdint.h>
@@ -3756,7 +3757,9 @@ static int smart_findfreephyssector(FAR struct smart_struct_s *dev,
   uint32_t readaddr;
   struct smart_sect_header_s header;
   int ret;
+  uint16_t first;
   uint16_t i;
+  uint16_t j;
 
   /* Determine which erase block we should allocate the new
    * sector from. This is based on the number of free sectors
@@ -3924,12 +3927,23 @@ retry:
     }
 
   /* Now find a free physical sector within this selected erase block to
-   * allocate.
+   * allocate.  Sectors are taken in order and only given back by erasing
+   * the whole block, so the free ones are normally the last 'count' of
+   * the block: start there and only scan the rest if that one is taken.
    */
 
-  for (i = allocblock * dev->sectorsperblk;
-       i < allocblock * dev->sectorsperblk + dev->availsectperblk; i++)
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+  count = smart_get_count(dev, dev->freecount, allocblock);
+#else
+  count = dev->freecount[allocblock];
+#endif
+
+  first = dev->availsectperblk - MIN(count, dev->availsectperblk);
+  for (j = 0; j < dev->availsectperblk; j++)
     {
+      i = allocblock * dev->sectorsperblk +
+          (first + j) % dev->availsectperblk;
+
       /* Check if this physical sector is available. */
 
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
@@ -4146,6 +4160,81 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_idle_collect
+ *
+ * Description:  Called by the file system when it is idle.  Relocates the
+ *               block with the most released sectors if at least half of
+ *               it is released, so that the garbage collection does not
+ *               have to be done in the write path later.
+ *
+ *               Returns 1 if a block was collected, 0 if none is worth it.
+ *
+ ****************************************************************************/
+
+static int smart_idle_collect(FAR struct smart_struct_s *dev)
+{
+  uint16_t collectblock = 0xffff;
+  uint16_t releasemax = 0;
+  uint16_t release;
+  uint16_t live;
+  int ret;
+  int x;
+
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
+        {
+          continue;
+        }
+#endif
+
+      /* Blocks still being filled are better left alone */
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      if (smart_get_count(dev, dev->freecount, x) != 0)
+        {
+          continue;
+        }
+
+      release = smart_get_count(dev, dev->releasecount, x);
+#else
+      if (dev->freecount[x] != 0)
+        {
+          continue;
+        }
+
+      release = dev->releasecount[x];
+#endif
+
+      if (release > releasemax)
+        {
+          releasemax   = release;
+          collectblock = x;
+        }
+    }
+
+  if (collectblock == 0xffff || releasemax < dev->availsectperblk / 2)
+    {
+      return 0;
+    }
+
+  /* The live sectors must fit without dipping into the reserve */
+
+  live = dev->availsectperblk - releasemax;
+  if (dev->freesectors < live + dev->sectorsperblk)
+    {
+      return 0;
+    }
+
+  finfo("Idle collecting block %d, released=%d\n",
+        collectblock, releasemax);
+
+  ret = smart_relocate_block(dev, collectblock);
+  return ret < 0 ? ret : 1;
+}
+
 /****************************************************************************
  * Name: smart_write_wearstatus
  *
@@ -5556,6 +5645,13 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
       ret = smart_freesector(dev, arg);
       goto ok_out;
 
+    case BIOC_GARBAGECOLLECT:
+
+      /* Reclaim released sectors while the file system is idle */
+
+      ret = smart_idle_collect(dev);
+      goto ok_out;
+
     case BIOC_WRITESECT:
 
       /* Write to the sector */
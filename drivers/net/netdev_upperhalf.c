@@ -28,17 +28,27 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <limits.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
+#include <time.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/can.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/ip.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
 #include <nuttx/net/vlan.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
@@ -51,6 +61,14 @@
 
 #define NETDEV_THREAD_NAME_FMT "netdev-%s"
 
+/* Packets received in one poll round before yielding to other work */
+
+#if CONFIG_NETDEV_RX_BUDGET > 0
+#  define NETDEV_RX_BUDGET CONFIG_NETDEV_RX_BUDGET
+#else
+#  define NETDEV_RX_BUDGET UINT_MAX
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -63,6 +81,21 @@ struct netdev_vlan_entry_s
 };
 #endif
 
+#ifdef CONFIG_NETDEV_GRO
+/* The TCP segment held back for aggregation */
+
+struct netdev_gro_s
+{
+  uint32_t seqno;   /* Sequence number of the first payload byte */
+  uint16_t l4off;   /* Offset of the TCP header */
+  uint16_t hdrlen;  /* Offset of the TCP payload */
+  uint16_t paylen;  /* Length of the TCP payload */
+  uint16_t paysum;  /* Checksum of the TCP payload */
+  uint8_t  flags;   /* TCP flags */
+  bool     merged;  /* Segments have been appended */
+};
+#endif
+
 struct netdev_thread_s
 {
   pid_t tid;
@@ -86,6 +119,20 @@ struct netdev_upperhalf_s
   struct netdev_vlan_entry_s vlan[CONFIG_NET_VLAN_COUNT];
 #endif
 
+#ifdef CONFIG_NETDEV_GSO
+  uint16_t gsosize;          /* Segment size of the packet in transmit() */
+#endif
+
+#ifdef CONFIG_NETDEV_GRO
+  FAR netpkt_t *gro;         /* TCP segment held back for aggregation */
+  struct netdev_gro_s groinfo;
+#endif
+
+#if CONFIG_NETDEV_RX_BUDGET > 0
+  uint32_t rxavg;            /* Average packets per poll round, x16 */
+  uint32_t rxhint;           /* Last coalescing hint given to the driver */
+#endif
+
   bool txing;
 
   /* Deferring process to work queue or thread */
@@ -97,11 +144,23 @@ struct netdev_upperhalf_s
   };
 };
 
+#ifdef CONFIG_NETDEV_GSO
+/* Consumer of the segments cut from a super-frame */
+
+typedef CODE int (*netdev_gso_out_t)(FAR struct netdev_upperhalf_s *upper,
+                                     FAR netpkt_t *seg);
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
 static int netdev_upper_txavail(FAR struct net_driver_s *dev);
+#if CONFIG_NETDEV_RX_BUDGET > 0
+static void netdev_upper_post_thread(FAR struct netdev_upperhalf_s *upper,
+                                     int index);
+static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -256,433 +315,1436 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
 }
 
 /****************************************************************************
- * Name: netdev_upper_txpoll
+ * Name: netdev_upper_txqueue
  *
  * Description:
- *   The transmitter is available, check if the network has any outgoing
- *   packets ready to send.  This is a callback from devif_poll().
- *   devif_poll() may be called:
- *
- *   1. When the preceding TX packet send is complete
- *   2. When the preceding TX packet send times out and the interface is
- *      reset
- *   3. During normal TX polling
- *
- * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
- *
- * Returned Value:
- *   Negated errno value - Error number that occurs.
- *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
- *
- * Assumptions:
- *   Called with the network locked.
+ *   Pick the TX queue of a multi-queue lower half for pkt by hashing its
+ *   IP addresses and TCP/UDP ports, so that the packets of one flow stay
+ *   in order on one queue.
  *
  ****************************************************************************/
 
-static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static int netdev_upper_txqueue(FAR struct netdev_lowerhalf_s *lower,
+                                FAR netpkt_t *pkt)
 {
-  FAR struct netdev_upperhalf_s *upper = dev->d_private;
-  FAR struct netdev_lowerhalf_s *lower = upper->lower;
-  FAR netpkt_t                  *pkt;
-  int                            ret;
-
-  DEBUGASSERT(dev->d_len > 0);
-
-  NETDEV_TXPACKETS(dev);
+  FAR const uint8_t *ip = IOB_DATA(pkt);
+  FAR const uint8_t *addr;
+  uint32_t hash = 0;
+  uint32_t word;
+  uint16_t l4off;
+  uint8_t naddr;
+  uint8_t proto;
+  int i;
 
-#ifdef CONFIG_NET_PKT
-  /* When packet sockets are enabled, feed the tx frame into it */
+  if (lower->nqueues <= 1)
+    {
+      return 0;
+    }
 
-  pkt_input(dev);
+#ifdef CONFIG_NET_IPv6
+  if (pkt->io_len >= IPv6_HDRLEN && (ip[0] >> 4) == 6)
+    {
+      addr  = ip + 8;
+      naddr = 8;
+      proto = ip[6];
+      l4off = IPv6_HDRLEN;
+    }
+  else
 #endif
+#ifdef CONFIG_NET_IPv4
+  if (pkt->io_len >= IPv4_HDRLEN && (ip[0] >> 4) == 4)
+    {
+      addr  = ip + 12;
+      naddr = 2;
+      proto = ip[9];
+      l4off = (ip[0] & IPv4_HLMASK) << 2;
 
-  pkt = netpkt_get(dev, NETPKT_TX);
+      /* Only the first fragment has the ports */
 
-  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
-    {
-      nerr("ERROR: Packet too long to send!\n");
-      ret = -EMSGSIZE;
+      if ((ip[6] & 0x3f) != 0 || ip[7] != 0)
+        {
+          proto = 0;
+        }
     }
   else
+#endif
     {
-      ret = lower->ops->transmit(lower, pkt);
+      /* Not IP, e.g. ARP, use the first queue */
+
+      return 0;
     }
 
-  if (ret != OK)
+  for (i = 0; i < naddr; i++, addr += 4)
     {
-      /* Stop polling on any error
-       * REVISIT: maybe store the pkt in upper half and retry later?
-       */
+      memcpy(&word, addr, 4);
+      hash = (hash ^ word) * GOLDEN_RATIO_32;
+    }
 
-      NETDEV_TXERRORS(dev);
-      nerr("ERROR: Transmit failed: %d\n", ret);
-      netpkt_put(dev, pkt, NETPKT_TX);
-      return ret;
+  if ((proto == IP_PROTO_TCP || proto == IP_PROTO_UDP) &&
+      pkt->io_len >= l4off + 4)
+    {
+      memcpy(&word, ip + l4off, 4);
+      hash = (hash ^ word) * GOLDEN_RATIO_32;
     }
 
-  return NETDEV_TX_CONTINUE;
+  hash ^= hash >> 16;
+  return ((uint64_t)hash * lower->nqueues) >> 32;
 }
+#endif
 
 /****************************************************************************
- * Name: netdev_upper_tx
+ * Name: netdev_upper_transmit
  *
  * Description:
- *   Do the actual transmission of packets, including pre-queued packets and
- *   packets from the network stack.
- *
- * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
- *
- * Returned Value:
- *   Negated errno value - Error number that occurs.
- *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
+ *   Pass a packet to the lower half, on the TX queue of its flow if the
+ *   lower half has several.
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-static int netdev_upper_tx(FAR struct net_driver_s *dev)
+static int netdev_upper_transmit(FAR struct netdev_lowerhalf_s *lower,
+                                 FAR netpkt_t *pkt)
 {
-#if CONFIG_IOB_NCHAINS > 0
-  FAR struct netdev_upperhalf_s *upper = dev->d_private;
-
-  if (!IOB_QEMPTY(&upper->txq))
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->rxtype == NETDEV_RX_THREAD_MQ)
     {
-      /* Put the packet back to the device */
-
-      netdev_iob_replace_l2(dev, iob_remove_queue(&upper->txq));
-      return netdev_upper_txpoll(dev);
+      return lower->ops->transmit_queue(lower, pkt,
+                                        netdev_upper_txqueue(lower, pkt));
     }
 #endif
 
-  /* No more TX packets in queue, poll the net stack to get more packets */
+  return lower->ops->transmit(lower, pkt);
+}
 
-  return devif_poll(dev, netdev_upper_txpoll);
+/****************************************************************************
+ * Name: netdev_upper_get32/put32
+ *
+ * Description:
+ *   Access a 32-bit field in network byte order, like the TCP sequence
+ *   number, which may not be aligned.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_GSO) || defined(CONFIG_NETDEV_GRO)
+static inline uint32_t netdev_upper_get32(FAR const uint8_t *p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+         ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void netdev_upper_put32(FAR uint8_t *p, uint32_t value)
+{
+  p[0] = value >> 24;
+  p[1] = value >> 16;
+  p[2] = value >> 8;
+  p[3] = value;
 }
 
 /****************************************************************************
- * Name: netdev_upper_txavail_work
+ * Name: netdev_upper_tcp_hdrlen
  *
  * Description:
- *   Perform an out-of-cycle tx poll on the worker thread.
+ *   Locate the TCP header of the IPv4 or IPv6 packet in pkt.
  *
  * Input Parameters:
- *   upper - Reference to the upper half driver structure
+ *   pkt   - The packet, with the IP header at IOB_DATA()
+ *   l4off - Return the offset of the TCP header
  *
- * Assumptions:
- *   Called with the network locked.
+ * Returned Value:
+ *   The offset of the TCP payload, or zero if pkt is not a TCP packet
+ *   whose headers sit in its first buffer.
  *
  ****************************************************************************/
 
-static void netdev_upper_txavail_work(FAR struct netdev_upperhalf_s *upper)
+static uint16_t netdev_upper_tcp_hdrlen(FAR netpkt_t *pkt,
+                                        FAR uint16_t *l4off)
 {
-  FAR struct net_driver_s *dev = &upper->lower->netdev;
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t hdrlen;
 
-  /* Ignore the notification if the interface is not yet up */
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] >> 4) == 6)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
 
-  netdev_lock(dev);
-  if (IFF_IS_UP(dev->d_flags) && !upper->txing)
+      if (pkt->io_len < IPv6_HDRLEN || ipv6->proto != IP_PROTO_TCP)
+        {
+          return 0;
+        }
+
+      *l4off = IPv6_HDRLEN;
+    }
+  else
+#endif
     {
-      DEBUGASSERT(dev->d_buf == NULL); /* Make sure: IOB only. */
-      upper->txing = true;
-      while (netdev_upper_can_tx(upper) &&
-             netdev_upper_tx(dev) == NETDEV_TX_CONTINUE);
-      upper->txing = false;
+#ifdef CONFIG_NET_IPv4
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      if (pkt->io_len < IPv4_HDRLEN || (ip[0] >> 4) != 4 ||
+          ipv4->proto != IP_PROTO_TCP)
+        {
+          return 0;
+        }
+
+      *l4off = (ipv4->vhl & IPv4_HLMASK) << 2;
+#else
+      return 0;
+#endif
     }
 
-  netdev_unlock(dev);
+  if (pkt->io_len < *l4off + TCP_HDRLEN)
+    {
+      return 0;
+    }
+
+  tcp    = (FAR struct tcp_hdr_s *)(ip + *l4off);
+  hdrlen = *l4off + ((tcp->tcpoffset >> 4) << 2);
+
+  return pkt->io_len < hdrlen ? 0 : hdrlen;
 }
 
 /****************************************************************************
- * Name: netdev_upper_queue_tx
+ * Name: netdev_upper_setiplen
  *
  * Description:
- *   Queue a TX packet to the upper half for sending later.
- *
- * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
- *
- * Assumptions:
- *   Called with the network locked.
+ *   Update the length field of the IPv4 or IPv6 header at the beginning of
+ *   pkt after its payload was changed, hdrlen and paylen are the size of
+ *   the IP and TCP headers and of the TCP payload.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211) || defined(CONFIG_NET_MBIM)
-static void netdev_upper_queue_tx(FAR struct net_driver_s *dev)
+static void netdev_upper_setiplen(FAR netpkt_t *pkt, uint16_t hdrlen,
+                                  uint16_t paylen)
 {
-#if CONFIG_IOB_NCHAINS > 0
-  FAR struct netdev_upperhalf_s *upper = dev->d_private;
-  int ret;
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  uint16_t len = hdrlen + paylen;
 
-  if ((ret = iob_tryadd_queue(dev->d_iob, &upper->txq)) >= 0)
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] >> 4) == 6)
     {
-      netdev_iob_clear(dev);
-      netdev_upper_txavail(dev);
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      len         -= IPv6_HDRLEN;
+      ipv6->len[0] = len >> 8;
+      ipv6->len[1] = len & 0xff;
     }
   else
+#endif
     {
-      nwarn("WARNING: Failed to queue TX packet, dropping: %d\n", ret);
-    }
-#else
-  /* Fall back to send the packet directly if we don't have IOB queue. */
-
-  netdev_upper_txpoll(dev);
+#ifdef CONFIG_NET_IPv4
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      ipv4->len[0]   = len >> 8;
+      ipv4->len[1]   = len & 0xff;
+      ipv4->ipchksum = 0;
+#  ifdef CONFIG_NET_IPV4_CHECKSUMS
+      ipv4->ipchksum = ~ipv4_chksum(ipv4);
+#  endif
 #endif
+    }
 }
-#endif
 
 /****************************************************************************
- * Name: netdev_upper_vlan_dev
+ * Name: netdev_upper_tcp_sum
  *
  * Description:
- *   Get the VLAN device for the VID.
- *
- * Input Parameters:
- *   upper - Reference to the upper half driver structure
- *   vid   - VLAN ID
- *
- * Returned Value:
- *   Reference to the network device structure, or NULL if not found.
+ *   Sum the TCP pseudo-header and TCP header of pkt and add paysum, the sum
+ *   of its payload.  The payload starts at an even offset, so the two sums
+ *   can simply be added.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_VLAN
-static FAR struct netdev_lowerhalf_s *
-netdev_upper_vlan_dev(FAR struct netdev_upperhalf_s *upper, uint16_t vid)
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+static uint16_t netdev_upper_tcp_sum(FAR netpkt_t *pkt, uint16_t l4off,
+                                     uint16_t hdrlen, uint16_t paysum)
 {
-  int i;
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  uint16_t sum = pkt->io_pktlen - l4off + IP_PROTO_TCP;
 
-  for (i = 0; i < CONFIG_NET_VLAN_COUNT; i++)
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] >> 4) == 6)
     {
-      if (upper->vlan[i].vid == vid)
-        {
-          return upper->vlan[i].dev;
-        }
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      sum = chksum(sum, (FAR uint8_t *)ipv6->srcipaddr,
+                   2 * sizeof(net_ipv6addr_t));
+    }
+  else
+#endif
+    {
+#ifdef CONFIG_NET_IPv4
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      sum = chksum(sum, (FAR uint8_t *)ipv4->srcipaddr,
+                   2 * sizeof(in_addr_t));
+#endif
     }
 
-  return NULL;
+  sum = chksum(sum, ip + l4off, hdrlen - l4off);
+
+  /* Add the payload with end around carry */
+
+  sum += paysum;
+  return sum < paysum ? sum + 1 : sum;
 }
+#endif
 
 /****************************************************************************
- * Name: netdev_upper_vlan_foreach
+ * Name: netdev_upper_tcp_setchksum
  *
  * Description:
- *   Call the callback for each VLAN device.
- *
- * Input Parameters:
- *   upper - Reference to the upper half driver structure
- *   cb    - The callback function
+ *   Recalculate the TCP checksum of pkt, see netdev_upper_tcp_sum().
  *
  ****************************************************************************/
 
-static void
-netdev_upper_vlan_foreach(FAR struct netdev_upperhalf_s *upper,
-                          CODE void (*cb)(FAR struct netdev_lowerhalf_s *))
+static void netdev_upper_tcp_setchksum(FAR netpkt_t *pkt, uint16_t l4off,
+                                       uint16_t hdrlen, uint16_t paysum)
 {
-  int i;
+  FAR struct tcp_hdr_s *tcp;
 
-  net_lock();
-  for (i = 0; i < CONFIG_NET_VLAN_COUNT; i++)
-    {
-      if (upper->vlan[i].dev)
-        {
-          cb(upper->vlan[i].dev);
-        }
-    }
+  tcp = (FAR struct tcp_hdr_s *)(IOB_DATA(pkt) + l4off);
+  tcp->tcpchksum = 0;
 
-  net_unlock();
-}
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+  paysum = netdev_upper_tcp_sum(pkt, l4off, hdrlen, paysum);
+  tcp->tcpchksum = ~(paysum == 0 ? 0xffff : HTONS(paysum));
+#else
+  UNUSED(hdrlen);
+  UNUSED(paysum);
 #endif
+}
+#endif /* CONFIG_NETDEV_GSO || CONFIG_NETDEV_GRO */
 
 /****************************************************************************
- * Name: eth_input
+ * Name: netdev_upper_gso_segment
  *
  * Description:
- *   Handle L2 packet input.
+ *   Cut the TCP super-frame pkt into segments carrying at most gsosize
+ *   bytes of payload each and hand them to out() in order.  pkt is left to
+ *   the caller.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX network driver state structure
+ *   upper   - Reference to the upper half driver structure
+ *   pkt     - The super-frame
+ *   gsosize - The payload size of each segment
+ *   out     - Where to pass each segment, it owns the segment afterwards
+ *
+ * Returned Value:
+ *   OK if every segment has been passed to out(), otherwise a negated
+ *   errno, the segments passed before are not recalled.
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-static void eth_input(FAR struct net_driver_s *dev)
+#ifdef CONFIG_NETDEV_GSO
+static int netdev_upper_gso_segment(FAR struct netdev_upperhalf_s *upper,
+                                    FAR netpkt_t *pkt, uint16_t gsosize,
+                                    netdev_gso_out_t out)
 {
-  FAR struct eth_hdr_s *eth_hdr = (FAR struct eth_hdr_s *)NETLLBUF;
+  uint8_t llhdrlen = NET_LL_HDRLEN(&upper->lower->netdev);
+  FAR struct tcp_hdr_s *tcp;
+  FAR netpkt_t *seg;
+  FAR uint8_t *ip;
+  uint32_t seqno;
+  uint16_t paysum = 0;
+  uint16_t seglen;
+  uint16_t hdrlen;
+  uint16_t paylen;
+  uint16_t l4off;
+  uint16_t ipid;
+  uint16_t off;
+  uint8_t flags;
+  int ret;
 
-  /* Check if this is an 802.1Q VLAN tagged packet */
+  hdrlen = netdev_upper_tcp_hdrlen(pkt, &l4off);
+  if (hdrlen == 0 || pkt->io_pktlen <= hdrlen ||
+      hdrlen > CONFIG_IOB_BUFSIZE - CONFIG_NET_LL_GUARDSIZE)
+    {
+      return -EMSGSIZE;
+    }
 
-#ifdef CONFIG_NET_VLAN
-  if (eth_hdr->type == HTONS(ETHERTYPE_VLAN))
+  ip     = IOB_DATA(pkt);
+  tcp    = (FAR struct tcp_hdr_s *)(ip + l4off);
+  paylen = pkt->io_pktlen - hdrlen;
+  seqno  = netdev_upper_get32(tcp->seqno);
+  flags  = tcp->flags;
+  ipid   = ((uint16_t)ip[4] << 8) | ip[5];
+
+  for (off = 0; off < paylen; off += seglen)
     {
-      FAR struct netdev_upperhalf_s *upper = dev->d_private;
-      FAR struct netdev_lowerhalf_s *vlan;
-      FAR struct eth_8021qhdr_s *vlan_hdr = NETLLBUF;
-      uint16_t vid = NTOHS(vlan_hdr->tci) & VLAN_VID_MASK;
+      seglen = MIN(gsosize, paylen - off);
 
-      vlan = netdev_upper_vlan_dev(upper, vid);
-      if (vlan)
+      seg = iob_tryalloc(false);
+      if (seg == NULL)
         {
-          /* Need to remove the 4 octet VLAN Tag, by moving src and dest
-           * addresses 4 octets to the right, and then read the actual
-           * ethertype.
-           */
+          return -ENOMEM;
+        }
+
+      /* Copy the link layer, IP and TCP headers, then the payload */
+
+      iob_reserve(seg, CONFIG_NET_LL_GUARDSIZE);
+      memcpy(IOB_DATA(seg) - llhdrlen, ip - llhdrlen, llhdrlen + hdrlen);
+      seg->io_len    = hdrlen;
+      seg->io_pktlen = hdrlen;
+
+      ret = iob_clone_partial(pkt, seglen, hdrlen + off, seg, hdrlen,
+                              false, false);
+      if (ret < 0)
+        {
+          iob_free_chain(seg);
+          return ret;
+        }
+
+      /* Then fix up the headers for this segment.  The IPv4 ID has to
+       * differ between the segments, IPv6 has none.
+       */
+
+      if ((ip[0] >> 4) == 4)
+        {
+          FAR uint8_t *segip = IOB_DATA(seg);
+
+          segip[4] = (ipid + off / gsosize) >> 8;
+          segip[5] = (ipid + off / gsosize) & 0xff;
+        }
+
+      netdev_upper_setiplen(seg, hdrlen, seglen);
+
+      tcp = (FAR struct tcp_hdr_s *)(IOB_DATA(seg) + l4off);
+      netdev_upper_put32(tcp->seqno, seqno + off);
+      if (off + seglen < paylen)
+        {
+          tcp->flags = flags & ~(TCP_FIN | TCP_PSH);
+        }
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      paysum = chksum_iob(0, seg, hdrlen);
+#endif
+      netdev_upper_tcp_setchksum(seg, l4off, hdrlen, paysum);
+
+      ret = out(upper, seg);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gso_transmit
+ *
+ * Description:
+ *   Pass a segment of a super-frame to the lower half, accounting it in
+ *   the TX quota like netpkt_get() does.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_gso_transmit(FAR struct netdev_upperhalf_s *upper,
+                                     FAR netpkt_t *seg)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+  atomic_fetch_sub(&lower->quota_ptr[NETPKT_TX], 1);
+
+  ret = netdev_upper_transmit(lower, seg);
+  if (ret != OK)
+    {
+      netpkt_free(lower, seg, NETPKT_TX);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gso_xmit
+ *
+ * Description:
+ *   Transmit the TCP super-frame pkt, as is if the lower half does TSO,
+ *   otherwise segment by segment.
+ *
+ * Returned Value:
+ *   OK if pkt has been consumed, a negated errno if it is still owned by
+ *   the caller.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_gso_xmit(FAR struct netdev_upperhalf_s *upper,
+                                 FAR netpkt_t *pkt, uint16_t gsosize)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+  if ((lower->features & NETDEV_FEATURE_TSO) != 0)
+    {
+      upper->gsosize = gsosize;
+      ret = netdev_upper_transmit(lower, pkt);
+      upper->gsosize = 0;
+      return ret;
+    }
+
+  ret = netdev_upper_gso_segment(upper, pkt, gsosize,
+                                 netdev_upper_gso_transmit);
+  if (ret == OK)
+    {
+      netpkt_free(lower, pkt, NETPKT_TX);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gso_queue
+ *
+ * Description:
+ *   Queue a segment of a super-frame for netdev_upper_tx().
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_NCHAINS > 0
+static int netdev_upper_gso_queue(FAR struct netdev_upperhalf_s *upper,
+                                  FAR netpkt_t *seg)
+{
+  int ret = iob_tryadd_queue(seg, &upper->txq);
+
+  if (ret < 0)
+    {
+      iob_free_chain(seg);
+    }
+
+  return ret;
+}
+#endif
+#endif /* CONFIG_NETDEV_GSO */
+
+/****************************************************************************
+ * Name: netdev_upper_txtstamp
+ *
+ * Description:
+ *   Take the software transmit timestamp of a packet that asks for one,
+ *   just before it is handed to the lower half.  A lower half without
+ *   NETDEV_FEATURE_HWTSTAMP will never report the hardware one, so the
+ *   request is completed here.
+ *
+ * Input Parameters:
+ *   lower - The lower half device driver structure
+ *   pkt   - The packet about to be transmitted
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+static void netdev_upper_txtstamp(FAR struct netdev_lowerhalf_s *lower,
+                                  FAR netpkt_t *pkt)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+  net_txtstamp(pkt, &ts, false);
+
+  if ((lower->features & NETDEV_FEATURE_HWTSTAMP) == 0)
+    {
+      net_txtstamp(pkt, NULL, true);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_txpoll
+ *
+ * Description:
+ *   The transmitter is available, check if the network has any outgoing
+ *   packets ready to send.  This is a callback from devif_poll().
+ *   devif_poll() may be called:
+ *
+ *   1. When the preceding TX packet send is complete
+ *   2. When the preceding TX packet send times out and the interface is
+ *      reset
+ *   3. During normal TX polling
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   Negated errno value - Error number that occurs.
+ *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR netpkt_t                  *pkt;
+#ifdef CONFIG_NETDEV_GSO
+  uint16_t                       gsosize = dev->d_gsosize;
+#endif
+  int                            ret;
+
+  DEBUGASSERT(dev->d_len > 0);
+
+  NETDEV_TXPACKETS(dev);
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the tx frame into it */
+
+  pkt_input(dev);
+#endif
+
+  pkt = netpkt_get(dev, NETPKT_TX);
+
+#ifdef CONFIG_NET_TIMESTAMPING
+  if (pkt->io_tsid != 0)
+    {
+      netdev_upper_txtstamp(lower, pkt);
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_GSO
+  if (gsosize > 0 && netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+    {
+      ret = netdev_upper_gso_xmit(upper, pkt, gsosize);
+    }
+  else
+#endif
+  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+    {
+      nerr("ERROR: Packet too long to send!\n");
+      ret = -EMSGSIZE;
+    }
+  else
+    {
+      ret = netdev_upper_transmit(lower, pkt);
+    }
+
+  if (ret != OK)
+    {
+      /* Stop polling on any error
+       * REVISIT: maybe store the pkt in upper half and retry later?
+       */
+
+      NETDEV_TXERRORS(dev);
+      nerr("ERROR: Transmit failed: %d\n", ret);
+      netpkt_put(dev, pkt, NETPKT_TX);
+      return ret;
+    }
+
+  return NETDEV_TX_CONTINUE;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_tx
+ *
+ * Description:
+ *   Do the actual transmission of packets, including pre-queued packets and
+ *   packets from the network stack.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   Negated errno value - Error number that occurs.
+ *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_tx(FAR struct net_driver_s *dev)
+{
+#if CONFIG_IOB_NCHAINS > 0
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+
+  if (!IOB_QEMPTY(&upper->txq))
+    {
+      /* Put the packet back to the device */
+
+      netdev_iob_replace_l2(dev, iob_remove_queue(&upper->txq));
+      return netdev_upper_txpoll(dev);
+    }
+#endif
+
+  /* No more TX packets in queue, poll the net stack to get more packets */
+
+  return devif_poll(dev, netdev_upper_txpoll);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_txavail_work
+ *
+ * Description:
+ *   Perform an out-of-cycle tx poll on the worker thread.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_txavail_work(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+
+  /* Ignore the notification if the interface is not yet up */
+
+  netdev_lock(dev);
+  if (IFF_IS_UP(dev->d_flags) && !upper->txing)
+    {
+      DEBUGASSERT(dev->d_buf == NULL); /* Make sure: IOB only. */
+      upper->txing = true;
+      while (netdev_upper_can_tx(upper) &&
+             netdev_upper_tx(dev) == NETDEV_TX_CONTINUE);
+      upper->txing = false;
+    }
+
+  netdev_unlock(dev);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_queue_tx
+ *
+ * Description:
+ *   Queue a TX packet to the upper half for sending later.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211) || defined(CONFIG_NET_MBIM)
+static void netdev_upper_queue_tx(FAR struct net_driver_s *dev)
+{
+#if CONFIG_IOB_NCHAINS > 0
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
+
+#  ifdef CONFIG_NETDEV_GSO
+  /* The segment size is not kept in the queue, cut super-frames now */
+
+  if (dev->d_gsosize > 0 && dev->d_len > NETDEV_PKTSIZE(dev))
+    {
+      ret = netdev_upper_gso_segment(upper, dev->d_iob, dev->d_gsosize,
+                                     netdev_upper_gso_queue);
+      if (ret < 0)
+        {
+          nwarn("WARNING: Failed to queue TX segments: %d\n", ret);
+        }
+
+      netdev_iob_release(dev);
+      netdev_upper_txavail(dev);
+    }
+  else
+#  endif
+  if ((ret = iob_tryadd_queue(dev->d_iob, &upper->txq)) >= 0)
+    {
+      netdev_iob_clear(dev);
+      netdev_upper_txavail(dev);
+    }
+  else
+    {
+      nwarn("WARNING: Failed to queue TX packet, dropping: %d\n", ret);
+    }
+#else
+  /* Fall back to send the packet directly if we don't have IOB queue. */
+
+  netdev_upper_txpoll(dev);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_vlan_dev
+ *
+ * Description:
+ *   Get the VLAN device for the VID.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   vid   - VLAN ID
+ *
+ * Returned Value:
+ *   Reference to the network device structure, or NULL if not found.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_VLAN
+static FAR struct netdev_lowerhalf_s *
+netdev_upper_vlan_dev(FAR struct netdev_upperhalf_s *upper, uint16_t vid)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_VLAN_COUNT; i++)
+    {
+      if (upper->vlan[i].vid == vid)
+        {
+          return upper->vlan[i].dev;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_vlan_foreach
+ *
+ * Description:
+ *   Call the callback for each VLAN device.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   cb    - The callback function
+ *
+ ****************************************************************************/
+
+static void
+netdev_upper_vlan_foreach(FAR struct netdev_upperhalf_s *upper,
+                          CODE void (*cb)(FAR struct netdev_lowerhalf_s *))
+{
+  int i;
+
+  net_lock();
+  for (i = 0; i < CONFIG_NET_VLAN_COUNT; i++)
+    {
+      if (upper->vlan[i].dev)
+        {
+          cb(upper->vlan[i].dev);
+        }
+    }
+
+  net_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Name: eth_input
+ *
+ * Description:
+ *   Handle L2 packet input.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX network driver state structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+static void eth_input(FAR struct net_driver_s *dev)
+{
+  FAR struct eth_hdr_s *eth_hdr = (FAR struct eth_hdr_s *)NETLLBUF;
+
+  /* Check if this is an 802.1Q VLAN tagged packet */
+
+#ifdef CONFIG_NET_VLAN
+  if (eth_hdr->type == HTONS(ETHERTYPE_VLAN))
+    {
+      FAR struct netdev_upperhalf_s *upper = dev->d_private;
+      FAR struct netdev_lowerhalf_s *vlan;
+      FAR struct eth_8021qhdr_s *vlan_hdr = NETLLBUF;
+      uint16_t vid = NTOHS(vlan_hdr->tci) & VLAN_VID_MASK;
+
+      vlan = netdev_upper_vlan_dev(upper, vid);
+      if (vlan)
+        {
+          /* Need to remove the 4 octet VLAN Tag, by moving src and dest
+           * addresses 4 octets to the right, and then read the actual
+           * ethertype.
+           */
+
+          netdev_lock(&vlan->netdev);
+          memmove((FAR uint8_t *)eth_hdr + 4, eth_hdr,
+                  offsetof(struct eth_hdr_s, type));
+          netdev_iob_release(&vlan->netdev);
+          vlan->netdev.d_iob = iob_trimhead(dev->d_iob, 4);
+          vlan->netdev.d_len = dev->d_len - 4;
+          netdev_iob_clear(dev);
+
+          /* Then call eth_input again with the new dev */
+
+#ifdef CONFIG_NET_PKT
+          pkt_input(&vlan->netdev);
+#endif
+          eth_input(&vlan->netdev);
+          netdev_unlock(&vlan->netdev);
+        }
+      else
+        {
+          ninfo("INFO: Dropped, unknown vlan id: %d\n", vid);
+          NETDEV_RXDROPPED(dev);
+          dev->d_len = 0;
+        }
+    }
+  else
+#endif
+
+  /* We only accept IP packets of the configured type and ARP packets */
+
+#ifdef CONFIG_NET_IPv4
+  if (eth_hdr->type == HTONS(ETHTYPE_IP))
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(dev);
+
+      /* Receive an IPv4 packet from the network device */
+
+      ipv4_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (eth_hdr->type == HTONS(ETHTYPE_IP6))
+    {
+      ninfo("IPv6 frame\n");
+      NETDEV_RXIPV6(dev);
+
+      /* Give the IPv6 packet to the network layer */
+
+      ipv6_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_ARP
+  if (eth_hdr->type == HTONS(ETHTYPE_ARP))
+    {
+      ninfo("ARP frame\n");
+      NETDEV_RXARP(dev);
+
+      /* Handle ARP packet */
+
+      arp_input(dev);
+    }
+  else
+#endif
+    {
+      ninfo("INFO: Dropped, Unknown type: %04x\n", eth_hdr->type);
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+      netdev_iob_release(dev);
+    }
+
+  /* If the above function invocation resulted in data
+   * that should be sent out on the network,
+   * the field d_len will set to a value > 0.
+   */
+
+  if (dev->d_len > 0)
+    {
+      /* And queue the packet for sending later.
+       * Note: RX is tried before TX, so we don't need to call txavail here.
+       */
+
+      netdev_upper_queue_tx(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: ip_input
+ *
+ * Description:
+ *   Handle L3 packet input.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX network driver state structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_MBIM
+static void ip_input(FAR struct net_driver_s *dev)
+{
+  /* We only accept IP packets of the configured type */
+
+#ifdef CONFIG_NET_IPv4
+  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(dev);
+
+      /* Receive an IPv4 packet from the network device */
+
+      ipv4_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      ninfo("IPv6 frame\n");
+      NETDEV_RXIPV6(dev);
+
+      /* Give the IPv6 packet to the network layer */
+
+      ipv6_input(dev);
+    }
+  else
+#endif
+    {
+      ninfo("INFO: Dropped, Unknown type\n");
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+    }
+
+  /* If the above function invocation resulted in data
+   * that should be sent out on the network,
+   * the field d_len will set to a value > 0.
+   */
+
+  if (dev->d_len > 0)
+    {
+      /* And queue the packet for sending later.
+       * Note: RX is tried before TX, so we don't need to call txavail here.
+       */
+
+      netdev_upper_queue_tx(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Function: netdev_upper_input
+ *
+ * Description:
+ *   Pass a received packet into the network stack.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   pkt   - The received packet
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_input(FAR struct netdev_upperhalf_s *upper,
+                               FAR netpkt_t *pkt)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+
+  netpkt_put(dev, pkt, NETPKT_RX);
+  NETDEV_RXPACKETS(dev);
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#endif
+
+  switch (dev->d_lltype)
+    {
+#ifdef CONFIG_NET_LOOPBACK
+    case NET_LL_LOOPBACK:
+#endif
+#ifdef CONFIG_NET_ETHERNET
+    case NET_LL_ETHERNET:
+#endif
+#ifdef CONFIG_DRIVERS_IEEE80211
+    case NET_LL_IEEE80211:
+#endif
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+      eth_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_MBIM
+    case NET_LL_MBIM:
+      ip_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_CAN
+    case NET_LL_CAN:
+      ninfo("CAN frame");
+      can_input(dev);
+      break;
+#endif
+    default:
+      nerr("Unknown link type %d\n", dev->d_lltype);
+      break;
+    }
+}
+
+/****************************************************************************
+ * Function: netdev_upper_gro_parse
+ *
+ * Description:
+ *   Check whether a received Ethernet frame is a TCP data segment that may
+ *   be aggregated and describe it in info.  Only pure ACK or ACK|PSH
+ *   segments of unfragmented packets without IP options qualify, and their
+ *   checksum must be right, since after merging nobody could tell.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+static bool netdev_upper_gro_parse(FAR struct netdev_upperhalf_s *upper,
+                                   FAR netpkt_t *pkt,
+                                   FAR struct netdev_gro_s *info)
+{
+  FAR struct eth_hdr_s *eth;
+  FAR struct tcp_hdr_s *tcp;
+  FAR uint8_t *ip;
+  uint16_t iplen;
+
+  if (upper->lower->netdev.d_lltype != NET_LL_ETHERNET)
+    {
+      return false;
+    }
 
-          netdev_lock(&vlan->netdev);
-          memmove((FAR uint8_t *)eth_hdr + 4, eth_hdr,
-                  offsetof(struct eth_hdr_s, type));
-          netdev_iob_release(&vlan->netdev);
-          vlan->netdev.d_iob = iob_trimhead(dev->d_iob, 4);
-          vlan->netdev.d_len = dev->d_len - 4;
-          netdev_iob_clear(dev);
+  ip  = IOB_DATA(pkt);
+  eth = (FAR struct eth_hdr_s *)(ip - ETH_HDRLEN);
 
-          /* Then call eth_input again with the new dev */
+  info->hdrlen = netdev_upper_tcp_hdrlen(pkt, &info->l4off);
+  if (info->hdrlen == 0)
+    {
+      return false;
+    }
 
-#ifdef CONFIG_NET_PKT
-          pkt_input(&vlan->netdev);
-#endif
-          eth_input(&vlan->netdev);
-          netdev_unlock(&vlan->netdev);
-        }
-      else
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] >> 4) == 6)
+    {
+      if (eth->type != HTONS(ETHTYPE_IP6))
         {
-          ninfo("INFO: Dropped, unknown vlan id: %d\n", vid);
-          NETDEV_RXDROPPED(dev);
-          dev->d_len = 0;
+          return false;
         }
+
+      iplen = IPv6_HDRLEN + (((uint16_t)ip[4] << 8) | ip[5]);
     }
   else
 #endif
+    {
+#ifdef CONFIG_NET_IPv4
+      /* No options and neither MF nor a fragment offset */
 
-  /* We only accept IP packets of the configured type and ARP packets */
+      if (eth->type != HTONS(ETHTYPE_IP) || info->l4off != IPv4_HDRLEN ||
+          (ip[6] & ~(IP_FLAG_DONTFRAG >> 8)) != 0 || ip[7] != 0)
+        {
+          return false;
+        }
 
-#ifdef CONFIG_NET_IPv4
-  if (eth_hdr->type == HTONS(ETHTYPE_IP))
+      iplen = ((uint16_t)ip[2] << 8) | ip[3];
+#else
+      return false;
+#endif
+    }
+
+  /* Frames with Ethernet padding or without payload are left alone */
+
+  tcp = (FAR struct tcp_hdr_s *)(ip + info->l4off);
+  if (iplen != pkt->io_pktlen || iplen <= info->hdrlen ||
+      (tcp->flags & ~(TCP_ACK | TCP_PSH)) != 0 ||
+      (tcp->flags & TCP_ACK) == 0)
     {
-      ninfo("IPv4 frame\n");
-      NETDEV_RXIPV4(dev);
+      return false;
+    }
 
-      /* Receive an IPv4 packet from the network device */
+  info->seqno  = netdev_upper_get32(tcp->seqno);
+  info->paylen = iplen - info->hdrlen;
+  info->paysum = 0;
+  info->flags  = tcp->flags;
+  info->merged = false;
 
-      ipv4_input(dev);
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+  info->paysum = chksum_iob(0, pkt, info->hdrlen);
+  if (netdev_upper_tcp_sum(pkt, info->l4off, info->hdrlen,
+                           info->paysum) != 0xffff)
+    {
+      return false;
     }
-  else
 #endif
-#ifdef CONFIG_NET_IPv6
-  if (eth_hdr->type == HTONS(ETHTYPE_IP6))
+
+  return true;
+}
+
+/****************************************************************************
+ * Function: netdev_upper_gro_merge
+ *
+ * Description:
+ *   Append the payload of pkt to the held segment if pkt directly follows
+ *   it on the same connection with the same headers.
+ *
+ * Returned Value:
+ *   True if pkt has been consumed.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_gro_merge(FAR struct netdev_upperhalf_s *upper,
+                                   FAR netpkt_t *pkt,
+                                   FAR struct netdev_gro_s *info)
+{
+  FAR struct netdev_gro_s *held = &upper->groinfo;
+  FAR uint8_t *hip = IOB_DATA(upper->gro);
+  FAR uint8_t *ip = IOB_DATA(pkt);
+  FAR uint8_t *htcp = hip + held->l4off;
+  FAR uint8_t *tcp = ip + info->l4off;
+  uint32_t sum;
+
+  /* The payload sums only add up if the held payload has an even size */
+
+  if (info->seqno != held->seqno + held->paylen ||
+      info->hdrlen != held->hdrlen || info->l4off != held->l4off ||
+      (held->paylen & 1) != 0 ||
+      held->hdrlen + held->paylen + info->paylen >
+      CONFIG_NETDEV_GRO_MAXSIZE)
     {
-      ninfo("IPv6 frame\n");
-      NETDEV_RXIPV6(dev);
+      return false;
+    }
 
-      /* Give the IPv6 packet to the network layer */
+  /* Same Ethernet header, and IP header apart from length, ID and
+   * checksum.
+   */
 
-      ipv6_input(dev);
+  if (memcmp(hip - ETH_HDRLEN, ip - ETH_HDRLEN, ETH_HDRLEN) != 0)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] >> 4) == 6)
+    {
+      if (memcmp(hip, ip, 4) != 0 ||
+          memcmp(hip + 6, ip + 6, IPv6_HDRLEN - 6) != 0)
+        {
+          return false;
+        }
     }
   else
 #endif
-#ifdef CONFIG_NET_ARP
-  if (eth_hdr->type == HTONS(ETHTYPE_ARP))
     {
-      ninfo("ARP frame\n");
-      NETDEV_RXARP(dev);
+#ifdef CONFIG_NET_IPv4
+      if (hip[1] != ip[1] || memcmp(hip + 6, ip + 6, 4) != 0 ||
+          memcmp(hip + 12, ip + 12, IPv4_HDRLEN - 12) != 0)
+        {
+          return false;
+        }
+#endif
+    }
 
-      /* Handle ARP packet */
+  /* Same TCP header apart from sequence number, flags and checksum */
 
-      arp_input(dev);
-    }
-  else
-#endif
+  if (memcmp(htcp, tcp, 4) != 0 || memcmp(htcp + 8, tcp + 8, 5) != 0 ||
+      memcmp(htcp + 14, tcp + 14, 2) != 0 ||
+      memcmp(htcp + 18, tcp + 18,
+             held->hdrlen - held->l4off - 18) != 0)
     {
-      ninfo("INFO: Dropped, Unknown type: %04x\n", eth_hdr->type);
-      NETDEV_RXDROPPED(dev);
-      dev->d_len = 0;
-      netdev_iob_release(dev);
+      return false;
     }
 
-  /* If the above function invocation resulted in data
-   * that should be sent out on the network,
-   * the field d_len will set to a value > 0.
-   */
+  ((FAR struct tcp_hdr_s *)htcp)->flags |= info->flags & TCP_PSH;
 
-  if (dev->d_len > 0)
+  /* Move the payload over, its quota goes back like in netpkt_put() */
+
+  pkt = iob_trimhead(pkt, info->hdrlen);
+  iob_concat(upper->gro, pkt);
+  atomic_fetch_add(&upper->lower->quota_ptr[NETPKT_RX], 1);
+
+  sum           = (uint32_t)held->paysum + info->paysum;
+  held->paysum  = (sum & 0xffff) + (sum >> 16);
+  held->paylen += info->paylen;
+  held->flags  |= info->flags;
+  held->merged  = true;
+  return true;
+}
+
+/****************************************************************************
+ * Function: netdev_upper_gro_flush
+ *
+ * Description:
+ *   Pass the held segment into the network stack, with fixed up headers if
+ *   others have been merged into it.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_gro_flush(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_gro_s *held = &upper->groinfo;
+  FAR netpkt_t *pkt = upper->gro;
+
+  if (pkt == NULL)
     {
-      /* And queue the packet for sending later.
-       * Note: RX is tried before TX, so we don't need to call txavail here.
-       */
+      return;
+    }
 
-      netdev_upper_queue_tx(dev);
+  upper->gro = NULL;
+
+  if (held->merged)
+    {
+      netdev_upper_setiplen(pkt, held->hdrlen, held->paylen);
+      netdev_upper_tcp_setchksum(pkt, held->l4off, held->hdrlen,
+                                 held->paysum);
     }
+
+  netdev_upper_input(upper, pkt);
 }
-#endif
 
 /****************************************************************************
- * Name: ip_input
+ * Function: netdev_upper_gro_input
  *
  * Description:
- *   Handle L3 packet input.
- *
- * Input Parameters:
- *   dev - Reference to the NuttX network driver state structure
+ *   Aggregate a received packet with the held TCP segment, or flush that
+ *   and pass the new packet on or hold it instead.  The order of the
+ *   packets is kept.
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_MBIM
-static void ip_input(FAR struct net_driver_s *dev)
+static void netdev_upper_gro_input(FAR struct netdev_upperhalf_s *upper,
+                                   FAR netpkt_t *pkt)
 {
-  /* We only accept IP packets of the configured type */
+  struct netdev_gro_s info;
 
-#ifdef CONFIG_NET_IPv4
-  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+  if (!netdev_upper_gro_parse(upper, pkt, &info))
     {
-      ninfo("IPv4 frame\n");
-      NETDEV_RXIPV4(dev);
-
-      /* Receive an IPv4 packet from the network device */
+      netdev_upper_gro_flush(upper);
+      netdev_upper_input(upper, pkt);
+      return;
+    }
 
-      ipv4_input(dev);
+  if (upper->gro == NULL || !netdev_upper_gro_merge(upper, pkt, &info))
+    {
+      netdev_upper_gro_flush(upper);
+      upper->gro     = pkt;
+      upper->groinfo = info;
     }
-  else
-#endif
-#ifdef CONFIG_NET_IPv6
-  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
+
+  /* The sender wants this delivered now */
+
+  if ((info.flags & TCP_PSH) != 0)
     {
-      ninfo("IPv6 frame\n");
-      NETDEV_RXIPV6(dev);
+      netdev_upper_gro_flush(upper);
+    }
+}
+#endif /* CONFIG_NETDEV_GRO */
 
-      /* Give the IPv6 packet to the network layer */
+/****************************************************************************
+ * Function: netdev_upper_receive
+ *
+ * Description:
+ *   Get a received packet from the lower half, from the given RX queue if
+ *   the lower half has several.
+ *
+ ****************************************************************************/
 
-      ipv6_input(dev);
+static inline FAR netpkt_t *
+netdev_upper_receive(FAR struct netdev_lowerhalf_s *lower, int queue)
+{
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->rxtype == NETDEV_RX_THREAD_MQ)
+    {
+      return lower->ops->receive_queue(lower, queue);
     }
-  else
 #endif
+
+  UNUSED(queue);
+  return lower->ops->receive(lower);
+}
+
+/****************************************************************************
+ * Function: netdev_upper_rxint
+ *
+ * Description:
+ *   Enable or disable the RX interrupt of a queue, if the lower half lets
+ *   the upper half control it.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NETDEV_RX_BUDGET > 0
+static inline void netdev_upper_rxint(FAR struct netdev_lowerhalf_s *lower,
+                                      int queue, bool enable)
+{
+  if (lower->ops->rxint != NULL && lower->rxtype != NETDEV_RX_DIRECT)
     {
-      ninfo("INFO: Dropped, Unknown type\n");
-      NETDEV_RXDROPPED(dev);
-      dev->d_len = 0;
+      lower->ops->rxint(lower, queue, enable);
     }
+}
 
-  /* If the above function invocation resulted in data
-   * that should be sent out on the network,
-   * the field d_len will set to a value > 0.
+/****************************************************************************
+ * Function: netdev_upper_rxpoll_done
+ *
+ * Description:
+ *   Account a finished poll round of npkts packets: keep a running
+ *   average of the load, hint the interrupt coalescing to the lower half
+ *   when it changes, and schedule another round if the budget was used
+ *   up, which leaves the RX interrupt disabled in the meantime.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_rxpoll_done(FAR struct netdev_upperhalf_s *upper,
+                                     int queue, unsigned int npkts)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  uint32_t hint;
+
+  /* avg = 3/4 avg + 1/4 npkts, kept x16 for precision */
+
+  upper->rxavg = upper->rxavg - (upper->rxavg >> 2) + (npkts << 2);
+
+  /* Only tell the power of two, to not reprogram the hardware for every
+   * small change in the load.
    */
 
-  if (dev->d_len > 0)
+  hint = upper->rxavg >> 4;
+  if (hint > 0)
     {
-      /* And queue the packet for sending later.
-       * Note: RX is tried before TX, so we don't need to call txavail here.
-       */
+      hint = 1u << (flsl(hint) - 1);
+    }
 
-      netdev_upper_queue_tx(dev);
+  if (hint != upper->rxhint && lower->ops->coalesce != NULL)
+    {
+      upper->rxhint = hint;
+      lower->ops->coalesce(lower, hint);
+    }
+
+  if (npkts >= NETDEV_RX_BUDGET && lower->rxtype != NETDEV_RX_DIRECT)
+    {
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+      if (lower->rxtype == NETDEV_RX_THREAD_MQ)
+        {
+          netdev_upper_post_thread(upper, queue);
+        }
+      else
+#endif
+        {
+          netdev_upper_queue_work(&lower->netdev);
+        }
     }
 }
 #endif
@@ -696,23 +1758,64 @@ static void ip_input(FAR struct net_driver_s *dev)
  *
  * Input Parameters:
  *   upper - Reference to the upper half driver structure
+ *   queue - The RX queue to poll, for NETDEV_RX_THREAD_MQ
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper,
+                                     int queue)
 {
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR struct net_driver_s       *dev   = &lower->netdev;
   FAR netpkt_t                  *pkt;
+  unsigned int                   budget;
+  unsigned int                   npkts = 0;
+#if CONFIG_NETDEV_RX_BUDGET > 0
+  bool                           rxint = false;
+#endif
+
+  /* In direct mode nobody would schedule the rest, so drain it all */
 
-  /* Loop while receive() successfully retrieves valid Ethernet frames. */
+  budget = lower->rxtype == NETDEV_RX_DIRECT ? UINT_MAX : NETDEV_RX_BUDGET;
+
+  /* Loop while receive() successfully retrieves valid Ethernet frames, up
+   * to the budget of the round.
+   */
 
   netdev_lock(dev);
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  while (npkts < budget)
     {
+      pkt = netdev_upper_receive(lower, queue);
+      if (pkt == NULL)
+        {
+#if CONFIG_NETDEV_RX_BUDGET > 0
+          if (!rxint && lower->ops->rxint != NULL)
+            {
+              /* Drained, re-enable the interrupt, and look once more for
+               * a packet that arrived just before it.
+               */
+
+              netdev_upper_rxint(lower, queue, true);
+              rxint = true;
+              continue;
+            }
+#endif
+
+          break;
+        }
+
+#if CONFIG_NETDEV_RX_BUDGET > 0
+      if (rxint)
+        {
+          netdev_upper_rxint(lower, queue, false);
+          rxint = false;
+        }
+#endif
+
+      npkts++;
       if (!IFF_IS_UP(dev->d_flags))
         {
           /* Interface down, drop frame */
@@ -722,49 +1825,26 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
           nerr("ERROR: Dropped frame due to lower dev not up\n");
           continue;
         }
-
-      netpkt_put(dev, pkt, NETPKT_RX);
-      NETDEV_RXPACKETS(dev);
-
-#ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
-
-      pkt_input(dev);
-#endif
-
-      switch (dev->d_lltype)
-        {
-#ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
-#endif
-#ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
-#endif
-#ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
-#endif
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_MBIM
-        case NET_LL_MBIM:
-          ip_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
-#endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
-        }
+
+#ifdef CONFIG_NETDEV_GRO
+      netdev_upper_gro_input(upper, pkt);
+#else
+      netdev_upper_input(upper, pkt);
+#endif
     }
 
+#ifdef CONFIG_NETDEV_GRO
+  /* Nothing is held back across polls */
+
+  netdev_upper_gro_flush(upper);
+#endif
+
+#if CONFIG_NETDEV_RX_BUDGET > 0
+  netdev_upper_rxpoll_done(upper, queue, npkts);
+#else
+  UNUSED(npkts);
+#endif
+
   netdev_unlock(dev);
 }
 
@@ -785,10 +1865,56 @@ static void netdev_upper_work(FAR void *arg)
 
   /* RX may release quota and driver buffer, so do RX first. */
 
-  netdev_upper_rxpoll_work(upper);
+  netdev_upper_rxpoll_work(upper, 0);
   netdev_upper_txavail_work(upper);
 }
 
+/****************************************************************************
+ * Name: netdev_upper_nthreads
+ *
+ * Description:
+ *   Get the number of dedicated threads of the device: one per CPU for
+ *   NETDEV_RX_THREAD_RSS and one per queue for NETDEV_RX_THREAD_MQ.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_nthreads(FAR struct netdev_lowerhalf_s *lower)
+{
+  switch (lower->rxtype)
+    {
+      case NETDEV_RX_THREAD:
+        return 1;
+      case NETDEV_RX_THREAD_RSS:
+        return CONFIG_SMP_NCPUS;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+      case NETDEV_RX_THREAD_MQ:
+        return lower->nqueues;
+#endif
+      default:
+        return 0;
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_upper_post_thread
+ *
+ * Description:
+ *   Wake up a dedicated thread if it is not already going to run.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_post_thread(FAR struct netdev_upperhalf_s *upper,
+                                     int index)
+{
+  FAR struct netdev_thread_s *t = &upper->thread[index];
+  int semcount;
+
+  if (nxsem_get_value(&t->sem, &semcount) == OK && semcount <= 0)
+    {
+      nxsem_post(&t->sem);
+    }
+}
+
 /****************************************************************************
  * Name: netdev_upper_loop
  *
@@ -812,10 +1938,25 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
       CPU_SET(cpu, &cpuset);
       sched_setaffinity(t->tid, sizeof(cpu_set_t), &cpuset);
     }
+#if defined(CONFIG_NETDEV_MULTIQUEUE) && defined(CONFIG_SMP)
+  else if (upper->lower->rxtype == NETDEV_RX_THREAD_MQ)
+    {
+      cpu_set_t cpuset;
+
+      /* Spread the queues over the CPUs, queue N on CPU N first */
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpu % CONFIG_SMP_NCPUS, &cpuset);
+      sched_setaffinity(t->tid, sizeof(cpu_set_t), &cpuset);
+    }
+#endif
+
+  /* The thread index is also the RX queue for NETDEV_RX_THREAD_MQ */
 
   while (nxsem_wait(&t->sem) == OK && t->tid != INVALID_PROCESS_ID)
     {
-      netdev_upper_work(upper);
+      netdev_upper_rxpoll_work(upper, cpu);
+      netdev_upper_txavail_work(upper);
     }
 
   nwarn("WARNING: Netdev work thread quitting.");
@@ -853,18 +1994,15 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
             }
         }
         break;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+      case NETDEV_RX_THREAD_MQ:
+        netdev_upper_post_thread(upper, this_cpu() % upper->lower->nqueues);
+        break;
+#endif
       case NETDEV_RX_THREAD_RSS:
         cpu = this_cpu();
       case NETDEV_RX_THREAD:
-        {
-          FAR struct netdev_thread_s *t = &upper->thread[cpu];
-          int semcount;
-
-          if (nxsem_get_value(&t->sem, &semcount) == OK && semcount <= 0)
-            {
-              nxsem_post(&t->sem);
-            }
-        }
+        netdev_upper_post_thread(upper, cpu);
         break;
     }
 }
@@ -1173,27 +2311,20 @@ int netdev_upper_vlan_ioctl(FAR struct netdev_lowerhalf_s *lower,
 
 static void netdev_upper_exit_thread(FAR struct netdev_upperhalf_s *upper)
 {
-  int cpu = 1;
+  int cpu = netdev_upper_nthreads(upper->lower);
 
-  switch (upper->lower->rxtype)
+  while (--cpu >= 0)
     {
-      case NETDEV_RX_THREAD_RSS:
-        cpu = CONFIG_SMP_NCPUS;
-      case NETDEV_RX_THREAD:
-        while (--cpu >= 0)
-          {
-            FAR struct netdev_thread_s *t = &upper->thread[cpu];
+      FAR struct netdev_thread_s *t = &upper->thread[cpu];
 
-            if (t->tid >= 0)
-              {
-                /* Try to tear down the dedicated thread for work. */
+      if (t->tid >= 0)
+        {
+          /* Try to tear down the dedicated thread for work. */
 
-                t->tid = INVALID_PROCESS_ID;
-                nxsem_post(&t->sem);
-                nxsem_wait(&t->sem_exit);
-              }
-          }
-        break;
+          t->tid = INVALID_PROCESS_ID;
+          nxsem_post(&t->sem);
+          nxsem_wait(&t->sem_exit);
+        }
     }
 }
 
@@ -1208,44 +2339,36 @@ static void netdev_upper_exit_thread(FAR struct netdev_upperhalf_s *upper)
 static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
-  int cpu = 1;
+  int cpu = netdev_upper_nthreads(upper->lower);
 
-  switch (upper->lower->rxtype)
+  /* Try to bring up the dedicated threads for work. */
+
+  while (--cpu >= 0)
     {
-      case NETDEV_RX_THREAD_RSS:
-        cpu = CONFIG_SMP_NCPUS;
-      case NETDEV_RX_THREAD:
+      FAR struct netdev_thread_s *t = &upper->thread[cpu];
+      FAR char *argv[3];
+      char      arg1[32];
+      char      arg2[32];
+      char      name[32];
 
-        /* Try to bring up a dedicated thread for work. */
+      snprintf(arg1, sizeof(arg1), "%p", upper);
+      argv[0] = arg1;
 
-        while (--cpu >= 0)
-          {
-            FAR struct netdev_thread_s *t = &upper->thread[cpu];
-            FAR char *argv[3];
-            char      arg1[32];
-            char      arg2[32];
-            char      name[32];
-
-            snprintf(arg1, sizeof(arg1), "%p", upper);
-            argv[0] = arg1;
-
-            snprintf(arg2, sizeof(arg2), "%d", cpu);
-            argv[1] = arg2;
-            argv[2] = NULL;
-
-            snprintf(name, sizeof(name), NETDEV_THREAD_NAME_FMT,
-                     dev->d_ifname);
-
-            t->tid = kthread_create(name, upper->lower->priority,
-                                    CONFIG_DEFAULT_TASK_STACKSIZE,
-                                    netdev_upper_loop, argv);
-            if (t->tid < 0)
-              {
-                netdev_upper_exit_thread(upper);
-                return t->tid;
-              }
-          }
-        break;
+      snprintf(arg2, sizeof(arg2), "%d", cpu);
+      argv[1] = arg2;
+      argv[2] = NULL;
+
+      snprintf(name, sizeof(name), NETDEV_THREAD_NAME_FMT,
+               dev->d_ifname);
+
+      t->tid = kthread_create(name, upper->lower->priority,
+                              CONFIG_DEFAULT_TASK_STACKSIZE,
+                              netdev_upper_loop, argv);
+      if (t->tid < 0)
+        {
+          netdev_upper_exit_thread(upper);
+          return t->tid;
+        }
     }
 
   if (upper->lower->ops->ifup)
@@ -1267,6 +2390,9 @@ static int netdev_upper_ifdown(FAR struct net_driver_s *dev)
         break;
       case NETDEV_RX_THREAD:
       case NETDEV_RX_THREAD_RSS:
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+      case NETDEV_RX_THREAD_MQ:
+#endif
         netdev_upper_exit_thread(upper);
         break;
     }
@@ -1374,8 +2500,25 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
   int cpu = 0;
   int ret;
 
-  if (dev == NULL || dev->ops == NULL ||
-      dev->ops->transmit == NULL || dev->ops->receive == NULL)
+  if (dev == NULL || dev->ops == NULL)
+    {
+      nerr("ERROR: Invalid lower half device\n");
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (dev->rxtype == NETDEV_RX_THREAD_MQ)
+    {
+      if (dev->ops->transmit_queue == NULL ||
+          dev->ops->receive_queue == NULL || dev->nqueues == 0)
+        {
+          nerr("ERROR: Invalid multi-queue lower half device\n");
+          return -EINVAL;
+        }
+    }
+  else
+#endif
+  if (dev->ops->transmit == NULL || dev->ops->receive == NULL)
     {
       nerr("ERROR: Invalid lower half device\n");
       return -EINVAL;
@@ -1407,6 +2550,12 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
         extra_size = sizeof(struct netdev_thread_s) * CONFIG_SMP_NCPUS;
         cpu = CONFIG_SMP_NCPUS;
         break;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+      case NETDEV_RX_THREAD_MQ:
+        extra_size = sizeof(struct netdev_thread_s) * dev->nqueues;
+        cpu = dev->nqueues;
+        break;
+#endif
       default:
         nerr("ERROR: Unrecognized device rxtype: %d\n", dev->rxtype);
         return -EINVAL;
@@ -1428,6 +2577,13 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 #endif
 #ifdef CONFIG_NETDEV_IOCTL
   dev->netdev.d_ioctl   = netdev_upper_ioctl;
+#endif
+#ifdef CONFIG_NETDEV_GSO
+  dev->netdev.d_gsomax  = CONFIG_NETDEV_GSO_MAXSIZE;
+#endif
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  dev->netdev.d_csumcap = (dev->features & NETDEV_FEATURE_TXCSUM) != 0 ?
+                          NETDEV_CSUM_TCP | NETDEV_CSUM_UDP : 0;
 #endif
   dev->netdev.d_private = upper;
 
@@ -1468,7 +2624,7 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper;
-  int cpu = 1;
+  int cpu;
   int ret;
 
   if (dev == NULL || dev->netdev.d_private == NULL)
@@ -1489,23 +2645,17 @@ int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
       return ret;
     }
 
-  switch (dev->rxtype)
-    {
-      case NETDEV_RX_THREAD_RSS:
-        cpu = CONFIG_SMP_NCPUS;
-      case NETDEV_RX_THREAD:
+  /* Stop the dedicated threads for network operations in thread mode */
 
-        /* Stop the dedicated thread for network operations in thread mode */
+  netdev_upper_exit_thread(upper);
 
-        netdev_upper_exit_thread(upper);
-        while (--cpu >= 0)
-          {
-            FAR struct netdev_thread_s *t = &upper->thread[cpu];
+  cpu = netdev_upper_nthreads(dev);
+  while (--cpu >= 0)
+    {
+      FAR struct netdev_thread_s *t = &upper->thread[cpu];
 
-            nxsem_destroy(&t->sem);
-            nxsem_destroy(&t->sem_exit);
-          }
-        break;
+      nxsem_destroy(&t->sem);
+      nxsem_destroy(&t->sem_exit);
     }
 
 #if CONFIG_IOB_NCHAINS > 0
@@ -1585,14 +2735,63 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 
   if (dev->rxtype == NETDEV_RX_DIRECT)
     {
-      netdev_upper_rxpoll_work(dev->netdev.d_private);
+      netdev_upper_rxpoll_work(dev->netdev.d_private, 0);
+    }
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  else if (dev->rxtype == NETDEV_RX_THREAD_MQ)
+    {
+      int queue;
+
+      /* We don't know which queue, poll them all */
+
+      for (queue = 0; queue < dev->nqueues; queue++)
+        {
+#  if CONFIG_NETDEV_RX_BUDGET > 0
+          netdev_upper_rxint(dev, queue, false);
+#  endif
+          netdev_upper_post_thread(dev->netdev.d_private, queue);
+        }
     }
+#endif
   else
     {
+#if CONFIG_NETDEV_RX_BUDGET > 0
+      /* Keep the interrupt off until the poll has drained the queue */
+
+      netdev_upper_rxint(dev, 0, false);
+#endif
       netdev_upper_queue_work(&dev->netdev);
     }
 }
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about RX packets ready to read on one
+ *   queue of a NETDEV_RX_THREAD_MQ lower half, which wakes up the thread
+ *   of that queue only.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The RX queue with new packets
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue)
+{
+  DEBUGASSERT(dev->rxtype == NETDEV_RX_THREAD_MQ && queue >= 0 &&
+              queue < dev->nqueues);
+
+#if CONFIG_NETDEV_RX_BUDGET > 0
+  netdev_upper_rxint(dev, queue, false);
+#endif
+  netdev_upper_post_thread(dev->netdev.d_private, queue);
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_txdone
  *
@@ -1895,6 +3094,190 @@ unsigned int netpkt_getdatalen(FAR struct netdev_lowerhalf_s *dev,
   return pkt->io_pktlen + NET_LL_HDRLEN(&dev->netdev);
 }
 
+/****************************************************************************
+ * Name: netpkt_getgsosize
+ *
+ * Description:
+ *   Get the TCP segment size of a super-frame passed to transmit() of a
+ *   lower half with NETDEV_FEATURE_TSO, only valid inside transmit().
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *
+ * Returned Value:
+ *   The payload size of each segment, or zero if pkt is a normal packet.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GSO
+uint16_t netpkt_getgsosize(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+
+  UNUSED(pkt);
+  return upper->gsosize;
+}
+#endif
+
+/****************************************************************************
+ * Name: netpkt_setcsumvalid
+ *
+ * Description:
+ *   Mark a received packet whose TCP/UDP checksum has been verified by the
+ *   hardware, so that the stack does not verify it again.  Packets with a
+ *   bad checksum should just not be marked.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+void netpkt_setcsumvalid(FAR struct netdev_lowerhalf_s *dev,
+                         FAR netpkt_t *pkt)
+{
+  UNUSED(dev);
+  pkt->io_csum = IOB_CSUM_UNNECESSARY;
+}
+
+/****************************************************************************
+ * Name: netpkt_getcsumpartial
+ *
+ * Description:
+ *   Check whether the device has to finish the TCP/UDP checksum of a packet
+ *   passed to transmit() of a lower half with NETDEV_FEATURE_TXCSUM.  The
+ *   checksum field holds the pseudo-header sum, the device has to add the
+ *   one's complement sum from start to the end of the packet and store its
+ *   complement at start + offset.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *   start  - Returns the offset of the TCP/UDP header from the L2 data
+ *   offset - Returns the offset of the checksum field in that header
+ *
+ * Returned Value:
+ *   true if the checksum has to be computed by the device.
+ *
+ ****************************************************************************/
+
+bool netpkt_getcsumpartial(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt, FAR unsigned int *start,
+                           FAR unsigned int *offset)
+{
+  FAR const uint8_t *ip = IOB_DATA(pkt);
+  uint8_t proto;
+
+  if (pkt->io_csum != IOB_CSUM_PARTIAL)
+    {
+      return false;
+    }
+
+  /* The stack builds these without options or extension headers, except
+   * for the IPv4 options it may add.
+   */
+
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] >> 4) == 6)
+    {
+      proto  = ip[6];
+      *start = IPv6_HDRLEN;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] >> 4) == 4)
+    {
+      proto  = ip[9];
+      *start = (ip[0] & IPv4_HLMASK) << 2;
+    }
+  else
+#endif
+    {
+      return false;
+    }
+
+  *start += NET_LL_HDRLEN(&dev->netdev);
+  *offset = proto == IP_PROTO_TCP ? offsetof(struct tcp_hdr_s, tcpchksum) :
+                                    offsetof(struct udp_hdr_s, udpchksum);
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: netpkt_setrxtstamp
+ *
+ * Description:
+ *   Attach the hardware receive time of a packet, read from the PTP
+ *   hardware clock of the device, before returning it from receive().
+ *   Only meaningful on a lower half with NETDEV_FEATURE_HWTSTAMP.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The received net packet
+ *   ts     - The hardware receive time
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+void netpkt_setrxtstamp(FAR struct netdev_lowerhalf_s *dev,
+                        FAR netpkt_t *pkt, FAR const struct timespec *ts)
+{
+  UNUSED(dev);
+  pkt->io_tstamp = (uint64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+/****************************************************************************
+ * Name: netpkt_needtxtstamp
+ *
+ * Description:
+ *   Check whether a packet passed to transmit() wants its hardware transmit
+ *   time, the lower half then has to latch it and report it with
+ *   netpkt_settxtstamp() before freeing the packet.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *
+ * Returned Value:
+ *   true if the transmit time of the packet is wanted.
+ *
+ ****************************************************************************/
+
+bool netpkt_needtxtstamp(FAR struct netdev_lowerhalf_s *dev,
+                         FAR netpkt_t *pkt)
+{
+  UNUSED(dev);
+  return pkt->io_tsid != 0;
+}
+
+/****************************************************************************
+ * Name: netpkt_settxtstamp
+ *
+ * Description:
+ *   Report the hardware transmit time of a packet for which
+ *   netpkt_needtxtstamp() returned true, or NULL if the hardware could not
+ *   stamp it.  Must be called from thread context (e.g. the work that
+ *   reclaims the TX descriptors), not from the interrupt handler.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The transmitted net packet
+ *   ts     - The hardware transmit time, or NULL
+ *
+ ****************************************************************************/
+
+void netpkt_settxtstamp(FAR struct netdev_lowerhalf_s *dev,
+                        FAR netpkt_t *pkt, FAR const struct timespec *ts)
+{
+  UNUSED(dev);
+  net_txtstamp(pkt, ts, true);
+}
+#endif
+
 /****************************************************************************
  * Name: netpkt_reset_reserved
  *
@@ -1969,3 +3352,27 @@ int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
 
   return i;
 }
+
+/****************************************************************************
+ * Name: netpkt_to_sg
+ *
+ * Description:
+ *   Describe a (possibly linked) netpkt as a list of DMA segments.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *   sg     - The segment array to write
+ *   nsg    - The number of elements in the segment array
+ *
+ * Returned Value:
+ *   The number of segments written; -E2BIG if the packet has more pieces
+ *   than "nsg".
+ *
+ ****************************************************************************/
+
+int netpkt_to_sg(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                 FAR netpkt_sg_t *sg, int nsg)
+{
+  return iob_to_sg(pkt, NET_LL_HDRLEN(&dev->netdev), sg, nsg);
+}
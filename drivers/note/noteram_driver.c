@@ -62,6 +62,16 @@
 
 #define NCPUS CONFIG_SMP_NCPUS
 
+/* Number of circular buffers; with per-CPU rings each CPU writes to its
+ * own share of the buffer.
+ */
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+#  define NOTERAM_NRINGS NCPUS
+#else
+#  define NOTERAM_NRINGS 1
+#endif
+
 /* Renumber idle task PIDs
  *  In NuttX, PID number less than NCPUS are idle tasks.
  *  In Linux, there is only one idle task of PID 0.
@@ -82,15 +92,21 @@
  * Private Types
  ****************************************************************************/
 
+struct noteram_ring_s
+{
+  volatile unsigned int ni_head;
+  volatile unsigned int ni_tail;
+  volatile unsigned int ni_read;
+  spinlock_t lock;
+};
+
 struct noteram_driver_s
 {
   struct note_driver_s driver;
   FAR uint8_t *ni_buffer;
-  size_t ni_bufsize;
+  size_t ni_bufsize;                  /* Size of the buffer of each ring */
   unsigned int ni_overwrite;
-  volatile unsigned int ni_head;
-  volatile unsigned int ni_tail;
-  volatile unsigned int ni_read;
+  struct noteram_ring_s ni_ring[NOTERAM_NRINGS];
   spinlock_t lock;
   FAR struct pollfd *pfd;
 };
@@ -181,7 +197,7 @@ struct noteram_driver_s g_noteram_driver =
     &g_noteram_ops
   },
   g_ramnote_buffer,
-  CONFIG_DRIVERS_NOTERAM_BUFSIZE,
+  CONFIG_DRIVERS_NOTERAM_BUFSIZE / NOTERAM_NRINGS,
 #ifdef CONFIG_DRIVERS_NOTERAM_DEFAULT_NOOVERWRITE
   NOTERAM_MODE_OVERWRITE_DISABLE
 #else
@@ -193,6 +209,20 @@ struct noteram_driver_s g_noteram_driver =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: noteram_ringbuf
+ *
+ * Description:
+ *   Return the start of the circular buffer of a ring.
+ *
+ ****************************************************************************/
+
+static inline FAR uint8_t *noteram_ringbuf(FAR struct noteram_driver_s *drv,
+                                           FAR struct noteram_ring_s *ring)
+{
+  return drv->ni_buffer + (ring - drv->ni_ring) * drv->ni_bufsize;
+}
+
 /****************************************************************************
  * Name: noteram_buffer_clear
  *
@@ -209,8 +239,17 @@ struct noteram_driver_s g_noteram_driver =
 
 static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
 {
-  drv->ni_tail = drv->ni_head;
-  drv->ni_read = drv->ni_head;
+  int i;
+
+  for (i = 0; i < NOTERAM_NRINGS; i++)
+    {
+      FAR struct noteram_ring_s *ring = &drv->ni_ring[i];
+      irqstate_t flags = spin_lock_irqsave_notrace(&ring->lock);
+
+      ring->ni_tail = ring->ni_head;
+      ring->ni_read = ring->ni_head;
+      spin_unlock_irqrestore_notrace(&ring->lock, flags);
+    }
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
@@ -260,10 +299,11 @@ static inline unsigned int noteram_next(FAR struct noteram_driver_s *drv,
  *
  ****************************************************************************/
 
-static unsigned int noteram_length(FAR struct noteram_driver_s *drv)
+static unsigned int noteram_length(FAR struct noteram_driver_s *drv,
+                                   FAR struct noteram_ring_s *ring)
 {
-  unsigned int head = drv->ni_head;
-  unsigned int tail = drv->ni_tail;
+  unsigned int head = ring->ni_head;
+  unsigned int tail = ring->ni_tail;
 
   if (tail > head)
     {
@@ -287,10 +327,11 @@ static unsigned int noteram_length(FAR struct noteram_driver_s *drv)
  *
  ****************************************************************************/
 
-static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
+static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv,
+                                          FAR struct noteram_ring_s *ring)
 {
-  unsigned int head = drv->ni_head;
-  unsigned int read = drv->ni_read;
+  unsigned int head = ring->ni_head;
+  unsigned int read = ring->ni_read;
 
   if (read > head)
     {
@@ -317,33 +358,99 @@ static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
  *
  ****************************************************************************/
 
-static void noteram_remove(FAR struct noteram_driver_s *drv)
+static void noteram_remove(FAR struct noteram_driver_s *drv,
+                           FAR struct noteram_ring_s *ring)
 {
   unsigned int tail;
   unsigned int length;
 
   /* Get the tail index of the circular buffer */
 
-  tail = drv->ni_tail;
+  tail = ring->ni_tail;
   DEBUGASSERT(tail < drv->ni_bufsize);
 
   /* Get the length of the note at the tail index */
 
-  length = NOTE_ALIGN(drv->ni_buffer[tail]);
-  DEBUGASSERT(length <= noteram_length(drv));
+  length = NOTE_ALIGN(noteram_ringbuf(drv, ring)[tail]);
+  DEBUGASSERT(length <= noteram_length(drv, ring));
 
   /* Increment the tail index to remove the entire note from the circular
    * buffer.
    */
 
-  if (drv->ni_read == drv->ni_tail)
+  if (ring->ni_read == ring->ni_tail)
     {
       /* The read index also needs increment. */
 
-      drv->ni_read = noteram_next(drv, tail, length);
+      ring->ni_read = noteram_next(drv, tail, length);
+    }
+
+  ring->ni_tail = noteram_next(drv, tail, length);
+}
+
+/****************************************************************************
+ * Name: noteram_select
+ *
+ * Description:
+ *   Select the ring that holds the next note to be read.  With per-CPU
+ *   rings this is the ring whose oldest unread note has the earliest time
+ *   stamp, so that the notes of all CPUs are returned in time order.
+ *
+ * Input Parameters:
+ *   drv - The noteram driver
+ *
+ * Returned Value:
+ *   The ring to read from next.
+ *
+ ****************************************************************************/
+
+static FAR struct noteram_ring_s *
+noteram_select(FAR struct noteram_driver_s *drv)
+{
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  FAR struct noteram_ring_s *found = NULL;
+  clock_t first = 0;
+  int i;
+
+  for (i = 0; i < NOTERAM_NRINGS; i++)
+    {
+      FAR struct noteram_ring_s *ring = &drv->ni_ring[i];
+      FAR uint8_t *buffer = noteram_ringbuf(drv, ring);
+      struct note_common_s note;
+      FAR uint8_t *p = (FAR uint8_t *)&note;
+      unsigned int read;
+      irqstate_t flags;
+      size_t n;
+
+      /* Copy the header of the oldest unread note, it may wrap around */
+
+      flags = spin_lock_irqsave_notrace(&ring->lock);
+      if (noteram_unread_length(drv, ring) == 0)
+        {
+          spin_unlock_irqrestore_notrace(&ring->lock, flags);
+          continue;
+        }
+
+      read = ring->ni_read;
+      for (n = 0; n < sizeof(note); n++)
+        {
+          p[n] = buffer[read];
+          read = noteram_next(drv, read, 1);
+        }
+
+      spin_unlock_irqrestore_notrace(&ring->lock, flags);
+
+      if (found == NULL || (sclock_t)(note.nc_systime - first) < 0)
+        {
+          first = note.nc_systime;
+          found = ring;
+        }
     }
 
-  drv->ni_tail = noteram_next(drv, tail, length);
+  return found != NULL ? found : &drv->ni_ring[0];
+#else
+  return &drv->ni_ring[0];
+#endif
 }
 
 /****************************************************************************
@@ -353,6 +460,7 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
  *   Get the next note from the read index of the circular buffer.
  *
  * Input Parameters:
+ *   ring   - The ring to read from
  *   buffer - Location to return the next note
  *   buflen - The length of the user provided buffer.
  *
@@ -364,8 +472,10 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
  ****************************************************************************/
 
 static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
+                           FAR struct noteram_ring_s *ring,
                            FAR uint8_t *buffer, size_t buflen)
 {
+  FAR uint8_t *ringbuf = noteram_ringbuf(drv, ring);
   FAR struct note_common_s *note;
   unsigned int remaining;
   unsigned int read;
@@ -376,7 +486,7 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
 
   /* Verify that the circular buffer is not empty */
 
-  circlen = noteram_unread_length(drv);
+  circlen = noteram_unread_length(drv, ring);
   if (circlen <= 0)
     {
       return 0;
@@ -384,12 +494,12 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
 
   /* Get the read index of the circular buffer */
 
-  read = drv->ni_read;
+  read = ring->ni_read;
   DEBUGASSERT(read < drv->ni_bufsize);
 
   /* Get the length of the note at the read index */
 
-  note = (FAR struct note_common_s *)&drv->ni_buffer[read];
+  note = (FAR struct note_common_s *)&ringbuf[read];
   notelen = note->nc_length;
   DEBUGASSERT(notelen <= circlen);
 
@@ -399,7 +509,7 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
     {
       /* Skip the large note so that we do not get constipated. */
 
-      drv->ni_read = noteram_next(drv, read, NOTE_ALIGN(notelen));
+      ring->ni_read = noteram_next(drv, read, NOTE_ALIGN(notelen));
 
       /* and return an error */
 
@@ -413,7 +523,7 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
     {
       /* Copy the next byte at the read index */
 
-      *buffer++ = drv->ni_buffer[read];
+      *buffer++ = ringbuf[read];
 
       /* Adjust indices and counts */
 
@@ -421,11 +531,33 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
       remaining--;
     }
 
-  drv->ni_read = noteram_next(drv, drv->ni_read, NOTE_ALIGN(notelen));
+  ring->ni_read = noteram_next(drv, ring->ni_read, NOTE_ALIGN(notelen));
 
   return notelen;
 }
 
+/****************************************************************************
+ * Name: noteram_get_next
+ *
+ * Description:
+ *   Get the next note in time order from any ring.
+ *
+ ****************************************************************************/
+
+static ssize_t noteram_get_next(FAR struct noteram_driver_s *drv,
+                                FAR uint8_t *buffer, size_t buflen)
+{
+  FAR struct noteram_ring_s *ring = noteram_select(drv);
+  irqstate_t flags;
+  ssize_t ret;
+
+  flags = spin_lock_irqsave_notrace(&ring->lock);
+  ret = noteram_get(drv, ring, buffer, buflen);
+  spin_unlock_irqrestore_notrace(&ring->lock, flags);
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: noteram_open
  ****************************************************************************/
@@ -435,10 +567,15 @@ static int noteram_open(FAR struct file *filep)
   FAR struct noteram_dump_context_s *ctx;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)
                                      filep->f_inode->i_private;
+  int i;
 
   /* Reset the read index of the circular buffer */
 
-  drv->ni_read = drv->ni_tail;
+  for (i = 0; i < NOTERAM_NRINGS; i++)
+    {
+      drv->ni_ring[i].ni_read = drv->ni_ring[i].ni_tail;
+    }
+
   ctx = kmm_zalloc(sizeof(*ctx));
   if (ctx == NULL)
     {
@@ -469,13 +606,10 @@ static ssize_t noteram_read(FAR struct file *filep, FAR char *buffer,
   FAR struct noteram_driver_s *drv = filep->f_inode->i_private;
   FAR struct lib_memoutstream_s stream;
   ssize_t ret;
-  irqstate_t flags;
 
   if (ctx->mode == NOTERAM_MODE_READ_BINARY)
     {
-      flags = spin_lock_irqsave_notrace(&drv->lock);
-      ret = noteram_get(drv, (FAR uint8_t *)buffer, buflen);
-      spin_unlock_irqrestore_notrace(&drv->lock, flags);
+      ret = noteram_get_next(drv, (FAR uint8_t *)buffer, buflen);
     }
   else
     {
@@ -487,9 +621,7 @@ static ssize_t noteram_read(FAR struct file *filep, FAR char *buffer,
 
           /* Get the next note (removing it from the buffer) */
 
-          flags = spin_lock_irqsave_notrace(&drv->lock);
-          ret = noteram_get(drv, note, sizeof(note));
-          spin_unlock_irqrestore_notrace(&drv->lock, flags);
+          ret = noteram_get_next(drv, note, sizeof(note));
           if (ret <= 0)
             {
               return ret;
@@ -621,6 +753,7 @@ static int noteram_poll(FAR struct file *filep, FAR struct pollfd *fds,
   FAR struct inode *inode;
   FAR struct noteram_driver_s *drv;
   irqstate_t flags;
+  int i;
 
   DEBUGASSERT(filep != NULL && fds != NULL);
   inode = filep->f_inode;
@@ -659,11 +792,14 @@ static int noteram_poll(FAR struct file *filep, FAR struct pollfd *fds,
        * don't wait for RX.
        */
 
-      if (noteram_unread_length(drv) > 0)
+      for (i = 0; i < NOTERAM_NRINGS; i++)
         {
-          spin_unlock_irqrestore_notrace(&drv->lock, flags);
-          poll_notify(&drv->pfd, 1, POLLIN);
-          return ret;
+          if (noteram_unread_length(drv, &drv->ni_ring[i]) > 0)
+            {
+              spin_unlock_irqrestore_notrace(&drv->lock, flags);
+              poll_notify(&drv->pfd, 1, POLLIN);
+              return ret;
+            }
         }
     }
   else /* Tear it down */
@@ -680,7 +816,9 @@ errout:
  * Name: noteram_add
  *
  * Description:
- *   Add the variable length note to the transport layer
+ *   Add the variable length note to the transport layer.  With per-CPU
+ *   rings the note goes to the ring of the current CPU, whose lock is only
+ *   ever contended by a reader.
  *
  * Input Parameters:
  *   note    - The note buffer
@@ -699,21 +837,30 @@ static void noteram_add(FAR struct note_driver_s *driver,
 {
   FAR const char *buf = note;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)driver;
+  FAR struct noteram_ring_s *ring;
+  FAR uint8_t *ringbuf;
   unsigned int head;
   unsigned int remain;
   unsigned int space;
   irqstate_t flags;
 
-  flags = spin_lock_irqsave_notrace(&drv->lock);
+  flags = up_irq_save();
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  ring = &drv->ni_ring[this_cpu()];
+#else
+  ring = &drv->ni_ring[0];
+#endif
+  ringbuf = noteram_ringbuf(drv, ring);
+  spin_lock_notrace(&ring->lock);
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
-      spin_unlock_irqrestore_notrace(&drv->lock, flags);
+      spin_unlock_irqrestore_notrace(&ring->lock, flags);
       return;
     }
 
   DEBUGASSERT(note != NULL && notelen < drv->ni_bufsize);
-  remain = drv->ni_bufsize - noteram_length(drv);
+  remain = drv->ni_bufsize - noteram_length(drv, ring);
 
   if (remain <= NOTE_ALIGN(notelen))
     {
@@ -722,7 +869,7 @@ static void noteram_add(FAR struct note_driver_s *driver,
           /* Stop recording if not in overwrite mode */
 
           drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
-          spin_unlock_irqrestore_notrace(&drv->lock, flags);
+          spin_unlock_irqrestore_notrace(&ring->lock, flags);
           return;
         }
 
@@ -731,19 +878,19 @@ static void noteram_add(FAR struct note_driver_s *driver,
 
       do
         {
-          noteram_remove(drv);
-          remain = drv->ni_bufsize - noteram_length(drv);
+          noteram_remove(drv, ring);
+          remain = drv->ni_bufsize - noteram_length(drv, ring);
         }
       while (remain <= NOTE_ALIGN(notelen));
     }
 
-  head = drv->ni_head;
+  head = ring->ni_head;
   space = drv->ni_bufsize - head;
   space = space < notelen ? space : notelen;
-  memcpy(drv->ni_buffer + head, note, space);
-  memcpy(drv->ni_buffer, buf + space, notelen - space);
-  drv->ni_head = noteram_next(drv, head, NOTE_ALIGN(notelen));
-  spin_unlock_irqrestore_notrace(&drv->lock, flags);
+  memcpy(ringbuf + head, note, space);
+  memcpy(ringbuf, buf + space, notelen - space);
+  ring->ni_head = noteram_next(drv, head, NOTE_ALIGN(notelen));
+  spin_unlock_irqrestore_notrace(&ring->lock, flags);
   poll_notify(&drv->pfd, 1, POLLIN);
 }
 
@@ -1253,7 +1400,7 @@ static void noteram_dump(FAR struct noteram_driver_s *drv)
     {
       ssize_t ret;
 
-      ret = noteram_get(drv, note, sizeof(note));
+      ret = noteram_get(drv, noteram_select(drv), note, sizeof(note));
       if (ret <= 0)
         {
           break;
@@ -1343,6 +1490,7 @@ noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite)
   size_t len = 0;
 #endif
   int ret;
+  int i;
 
   drv = kmm_malloc(sizeof(*drv) + len + bufsize);
   if (drv == NULL)
@@ -1364,13 +1512,19 @@ noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite)
 #endif
 
   drv->driver.ops = &g_noteram_ops;
-  drv->ni_bufsize = bufsize;
+  drv->ni_bufsize = bufsize / NOTERAM_NRINGS;
   drv->ni_buffer = (FAR uint8_t *)(drv + 1) + len;
   drv->ni_overwrite = overwrite;
-  drv->ni_head = 0;
-  drv->ni_tail = 0;
-  drv->ni_read = 0;
   drv->pfd = NULL;
+  spin_lock_init(&drv->lock);
+
+  for (i = 0; i < NOTERAM_NRINGS; i++)
+    {
+      drv->ni_ring[i].ni_head = 0;
+      drv->ni_ring[i].ni_tail = 0;
+      drv->ni_ring[i].ni_read = 0;
+      spin_lock_init(&drv->ni_ring[i].lock);
+    }
 
   ret = note_driver_register(&drv->driver);
   if (ret < 0)
@@ -28,12 +28,34 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
 
 /****************************************************************************
  * Pre-processor definitions
  ****************************************************************************/
 
 #define NOTERPMSG_EPT_NAME           "rpmsg-note"
+#define NOTERPMSG_PAGE_EPT_NAME      "rpmsg-note-page"
+
+#define NOTERPMSG_PAGE_MAGIC         0x4750544e /* "NTPG" */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Header at the start of every page sent on NOTERPMSG_PAGE_EPT_NAME,
+ * followed by the notes back to back.
+ */
+
+begin_packed_struct struct noterpmsg_page_s
+{
+  uint32_t magic;                    /* NOTERPMSG_PAGE_MAGIC */
+  uint32_t seq;                      /* Page sequence number */
+  uint32_t dropped;                  /* Notes dropped before this page */
+  uint32_t length;                   /* Page length including the header */
+} end_packed_struct;
 
 /****************************************************************************
  * Public Data
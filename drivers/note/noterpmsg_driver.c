@@ -38,16 +38,44 @@
 
 #define NOTE_RPMSG_WORK_DELAY MSEC2TICK(CONFIG_DRIVERS_NOTERPMSG_WORK_DELAY)
 
+#ifdef CONFIG_DRIVERS_NOTERPMSG_PAGED
+#  define NOTE_RPMSG_EPT_NAME  NOTERPMSG_PAGE_EPT_NAME
+#  define NOTE_RPMSG_NPAGES    CONFIG_DRIVERS_NOTERPMSG_PAGES
+#else
+#  define NOTE_RPMSG_EPT_NAME  NOTERPMSG_EPT_NAME
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTERPMSG_PAGED
+/* An rpmsg TX payload buffer that notes are written into */
+
+struct noterpmsg_pbuf_s
+{
+  FAR uint8_t *buf;
+  uint32_t     size;
+  uint32_t     len;
+};
+#endif
+
 struct noterpmsg_driver_s
 {
   struct note_driver_s  driver;
+#ifdef CONFIG_DRIVERS_NOTERPMSG_PAGED
+  struct noterpmsg_pbuf_s page;                    /* Page being filled */
+  struct noterpmsg_pbuf_s full[NOTE_RPMSG_NPAGES]; /* Pages to send */
+  struct noterpmsg_pbuf_s free[NOTE_RPMSG_NPAGES]; /* Empty pages */
+  uint8_t               nfull;
+  uint8_t               nfree;
+  uint32_t              seq;
+  uint32_t              dropped;
+#else
   volatile size_t       head;
   volatile size_t       tail;
   uint8_t               buffer[CONFIG_DRIVERS_NOTERPMSG_BUFSIZE];
+#endif
   struct work_s         work;
   struct rpmsg_endpoint ept;
   spinlock_t            lock;
@@ -91,6 +119,132 @@ struct noterpmsg_driver_s g_noterpmsg_driver =
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTERPMSG_PAGED
+static void noterpmsg_work(FAR void *priv)
+{
+  FAR struct noterpmsg_driver_s *drv = priv;
+  struct noterpmsg_pbuf_s pages[NOTE_RPMSG_NPAGES];
+  FAR struct noterpmsg_page_s *hdr;
+  FAR uint8_t *buffer;
+  irqstate_t flags;
+  uint32_t space;
+  int npages;
+  int nheld;
+  int i;
+
+  /* Take the full pages, and the partially filled one so that no note
+   * waits for longer than the work delay.
+   */
+
+  flags = spin_lock_irqsave_notrace(&drv->lock);
+
+  npages = drv->nfull;
+  memcpy(pages, drv->full, npages * sizeof(pages[0]));
+  drv->nfull = 0;
+
+  if (drv->page.buf != NULL &&
+      drv->page.len > sizeof(struct noterpmsg_page_s))
+    {
+      pages[npages++] = drv->page;
+      drv->page.buf = NULL;
+    }
+
+  for (i = 0; i < npages; i++)
+    {
+      hdr          = (FAR struct noterpmsg_page_s *)pages[i].buf;
+      hdr->magic   = NOTERPMSG_PAGE_MAGIC;
+      hdr->seq     = drv->seq++;
+      hdr->dropped = drv->dropped;
+      hdr->length  = pages[i].len;
+      drv->dropped = 0;
+    }
+
+  nheld = drv->nfree + drv->nfull + (drv->page.buf != NULL);
+  spin_unlock_irqrestore_notrace(&drv->lock, flags);
+
+  /* The notes were written in place, so the pages go out without a copy */
+
+  for (i = 0; i < npages; i++)
+    {
+      if (rpmsg_send_nocopy(&drv->ept, pages[i].buf, pages[i].len) < 0)
+        {
+          rpmsg_release_tx_buffer(&drv->ept, pages[i].buf);
+        }
+    }
+
+  /* Refill the pool of empty pages */
+
+  while (nheld < NOTE_RPMSG_NPAGES)
+    {
+      buffer = rpmsg_get_tx_payload_buffer(&drv->ept, &space, false);
+      if (buffer == NULL)
+        {
+          work_queue(HPWORK, &drv->work, noterpmsg_work, drv,
+                     NOTE_RPMSG_WORK_DELAY);
+          break;
+        }
+
+      if (space <= sizeof(struct noterpmsg_page_s))
+        {
+          rpmsg_release_tx_buffer(&drv->ept, buffer);
+          break;
+        }
+
+      flags = spin_lock_irqsave_notrace(&drv->lock);
+      drv->free[drv->nfree].buf  = buffer;
+      drv->free[drv->nfree].size = space;
+      drv->nfree++;
+      spin_unlock_irqrestore_notrace(&drv->lock, flags);
+      nheld++;
+    }
+}
+
+static void noterpmsg_add(FAR struct note_driver_s *driver,
+                          FAR const void *note, size_t notelen)
+{
+  FAR struct noterpmsg_driver_s *drv =
+    (FAR struct noterpmsg_driver_s *)driver;
+  FAR struct noterpmsg_pbuf_s *page = &drv->page;
+  clock_t delay = NOTE_RPMSG_WORK_DELAY;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave_notrace(&drv->lock);
+
+  /* Hand a full page over to the work and send it as soon as possible */
+
+  if (page->buf != NULL && page->len + notelen > page->size)
+    {
+      drv->full[drv->nfull++] = *page;
+      page->buf = NULL;
+      delay = 0;
+    }
+
+  if (page->buf == NULL && drv->nfree > 0)
+    {
+      *page = drv->free[--drv->nfree];
+      page->len = sizeof(struct noterpmsg_page_s);
+    }
+
+  if (page->buf != NULL && page->len + notelen <= page->size)
+    {
+      memcpy(page->buf + page->len, note, notelen);
+      page->len += notelen;
+    }
+  else
+    {
+      /* No page is available, the next page sent reports the loss */
+
+      drv->dropped++;
+    }
+
+  if (delay == 0 || work_available(&drv->work))
+    {
+      work_queue(HPWORK, &drv->work, noterpmsg_work, drv, delay);
+    }
+
+  spin_unlock_irqrestore_notrace(&drv->lock, flags);
+}
+#else
 static inline size_t noterpmsg_next(FAR struct noterpmsg_driver_s *drv,
                                     size_t pos, size_t offset)
 {
@@ -238,6 +392,7 @@ static void noterpmsg_add(FAR struct note_driver_s *driver,
 
   spin_unlock_irqrestore_notrace(&drv->lock, flags);
 }
+#endif /* CONFIG_DRIVERS_NOTERPMSG_PAGED */
 
 static int noterpmsg_ept_cb(FAR struct rpmsg_endpoint *ept,
                             FAR void *data, size_t len, uint32_t src,
@@ -258,7 +413,7 @@ static void noterpmsg_device_created(FAR struct rpmsg_device *rdev,
       drv->ept.priv = drv;
       spin_lock_init(&drv->lock);
 
-      ret = rpmsg_create_ept(&drv->ept, rdev, NOTERPMSG_EPT_NAME,
+      ret = rpmsg_create_ept(&drv->ept, rdev, NOTE_RPMSG_EPT_NAME,
                              RPMSG_ADDR_ANY, RPMSG_ADDR_ANY,
                              noterpmsg_ept_cb, NULL);
       if (ret >= 0)
@@ -272,10 +427,42 @@ static void noterpmsg_device_destroy(FAR struct rpmsg_device *rdev,
                                      FAR void *priv)
 {
   FAR struct noterpmsg_driver_s *drv = priv;
+#ifdef CONFIG_DRIVERS_NOTERPMSG_PAGED
+  struct noterpmsg_pbuf_s pages[NOTE_RPMSG_NPAGES];
+  irqstate_t flags;
+  int npages;
+#endif
 
   if (strcmp(CONFIG_DRIVERS_NOTERPMSG_SERVER_NAME,
              rpmsg_get_cpuname(rdev)) == 0)
     {
+#ifdef CONFIG_DRIVERS_NOTERPMSG_PAGED
+      /* Give every page held back to the transport */
+
+      work_cancel_sync(HPWORK, &drv->work);
+
+      flags = spin_lock_irqsave_notrace(&drv->lock);
+
+      npages = drv->nfull;
+      memcpy(pages, drv->full, drv->nfull * sizeof(pages[0]));
+      memcpy(pages + npages, drv->free, drv->nfree * sizeof(pages[0]));
+      npages += drv->nfree;
+      if (drv->page.buf != NULL)
+        {
+          pages[npages++] = drv->page;
+        }
+
+      drv->page.buf = NULL;
+      drv->nfull    = 0;
+      drv->nfree    = 0;
+      spin_unlock_irqrestore_notrace(&drv->lock, flags);
+
+      while (npages-- > 0)
+        {
+          rpmsg_release_tx_buffer(&drv->ept, pages[npages].buf);
+        }
+#endif
+
       rpmsg_destroy_ept(&drv->ept);
     }
 }
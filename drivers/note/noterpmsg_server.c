@@ -24,6 +24,10 @@
  * Included Files
  ****************************************************************************/
 
+#include <errno.h>
+#include <inttypes.h>
+
+#include <debug.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/rpmsg/rpmsg.h>
 #include <nuttx/sched_note.h>
@@ -64,6 +68,34 @@ static int noterpmsg_ept_cb(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+static int noterpmsg_page_ept_cb(FAR struct rpmsg_endpoint *ept,
+                                 FAR void *data, size_t len,
+                                 uint32_t src, FAR void *priv)
+{
+  FAR struct noterpmsg_page_s *hdr = data;
+
+  if (len < sizeof(*hdr) || hdr->magic != NOTERPMSG_PAGE_MAGIC ||
+      hdr->length > len)
+    {
+      return -EINVAL;
+    }
+
+  if (hdr->dropped > 0)
+    {
+      _warn("WARNING: %" PRIu32 " notes dropped before page %" PRIu32 "\n",
+            hdr->dropped, hdr->seq);
+    }
+
+  /* The notes follow the header back to back */
+
+  if (hdr->length > sizeof(*hdr))
+    {
+      sched_note_add(hdr + 1, hdr->length - sizeof(*hdr));
+    }
+
+  return 0;
+}
+
 static void noterpmsg_ns_unbind(FAR struct rpmsg_endpoint *ept)
 {
   FAR struct noterpmsg_server_s *srv = ept->priv;
@@ -76,7 +108,8 @@ static bool noterpmsg_ns_match(FAR struct rpmsg_device *rdev,
                                FAR void *priv, FAR const char *name,
                                uint32_t dest)
 {
-  return !strcmp(name, NOTERPMSG_EPT_NAME);
+  return !strcmp(name, NOTERPMSG_EPT_NAME) ||
+         !strcmp(name, NOTERPMSG_PAGE_EPT_NAME);
 }
 
 static void noterpmsg_ns_bind(FAR struct rpmsg_device *rdev,
@@ -84,6 +117,7 @@ static void noterpmsg_ns_bind(FAR struct rpmsg_device *rdev,
                               uint32_t dest)
 {
   FAR struct noterpmsg_server_s *srv;
+  rpmsg_ept_cb cb;
   int ret;
 
   srv = kmm_zalloc(sizeof(struct noterpmsg_server_s));
@@ -94,9 +128,12 @@ static void noterpmsg_ns_bind(FAR struct rpmsg_device *rdev,
 
   srv->ept.priv = srv;
 
-  ret = rpmsg_create_ept(&srv->ept, rdev, NOTERPMSG_EPT_NAME,
+  cb = strcmp(name, NOTERPMSG_PAGE_EPT_NAME) ? noterpmsg_ept_cb :
+                                                noterpmsg_page_ept_cb;
+
+  ret = rpmsg_create_ept(&srv->ept, rdev, name,
                          RPMSG_ADDR_ANY, dest,
-                         noterpmsg_ept_cb, noterpmsg_ns_unbind);
+                         cb, noterpmsg_ns_unbind);
   if (ret < 0)
     {
       kmm_free(srv);
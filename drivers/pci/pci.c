@@ -1285,6 +1285,52 @@ static void pci_disable_msi(FAR struct pci_device_s *dev, uint8_t msi)
   pci_write_config_word(dev, msi + PCI_MSI_FLAGS, flags);
 }
 
+/****************************************************************************
+ * Name: pci_msix_table
+ *
+ * Description:
+ *  Get the MSI-X table.
+ *
+ * Input Parameters:
+ *   dev     - device
+ *   msix    - MSI-X base address
+ *   tblsize - returned number of entries
+ *
+ * Return value:
+ *   The mapped address of the table
+ *
+ ****************************************************************************/
+
+static uintptr_t pci_msix_table(FAR struct pci_device_s *dev, uint8_t msix,
+                                FAR uint16_t *tblsize)
+{
+  uintptr_t tbladdr = 0;
+  uint16_t  flags   = 0;
+  uint32_t  tbl     = 0;
+
+  pci_read_config_word(dev, msix + PCI_MSIX_FLAGS, &flags);
+
+  /* Table Size is N - 1 encoded */
+
+  *tblsize = (flags & PCI_MSIX_FLAGS_QSIZE) + 1;
+
+  /* Extract table address */
+
+  pci_read_config_dword(dev, msix + PCI_MSIX_TABLE, &tbl);
+  tbladdr = pci_resource_start(dev, tbl & PCI_MSIX_TABLE_BIR);
+  tbladdr += tbl & PCI_MSIX_TABLE_OFFSET;
+
+  /* Map MSI-X table */
+
+  if (dev->bus->ctrl->ops->map)
+    {
+      tbladdr = dev->bus->ctrl->ops->map(dev->bus, tbladdr, tbladdr +
+                                         *tblsize * PCI_MSIX_ENTRY_SIZE);
+    }
+
+  return tbladdr;
+}
+
 /****************************************************************************
  * Name: pci_disable_msix
  *
@@ -1306,20 +1352,13 @@ static void pci_disable_msix(FAR struct pci_device_s *dev, uint8_t msix,
 {
   uint16_t  flags     = 0;
   uintptr_t tbladdr   = 0;
-  uint32_t  tbloffset = 0;
-  uint32_t  tblbar    = 0;
-  uint32_t  tbl       = 0;
+  uint16_t  tblsize   = 0;
   int       i         = 0;
 
   pci_read_config_word(dev, msix + PCI_MSIX_FLAGS, &flags);
-  pci_read_config_dword(dev, msix + PCI_MSIX_TABLE, &tbl);
-
-  tblbar = tbl & PCI_MSIX_TABLE_BIR;
-  tbladdr = pci_resource_start(dev, tblbar);
-  tbloffset = tbl & PCI_MSIX_TABLE_OFFSET;
-  tbladdr += tbloffset;
+  tbladdr = pci_msix_table(dev, msix, &tblsize);
 
-  for (i = 0; i < num; i++)
+  for (i = 0; i < num && i < tblsize; i++)
     {
       pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_LOWER_ADDR, 0);
       pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_UPPER_ADDR, 0);
@@ -1359,10 +1398,6 @@ static int pci_enable_msix(FAR struct pci_device_s *dev, FAR int *irq,
   uint16_t  flags     = 0;
   uintptr_t mar       = 0;
   uintptr_t tbladdr   = 0;
-  uintptr_t tblend    = 0;
-  uint32_t  tbloffset = 0;
-  uint32_t  tblbar    = 0;
-  uint32_t  tbl       = 0;
   uint16_t  tblsize   = 0;
   int       i         = 0;
   int       ret       = OK;
@@ -1371,29 +1406,9 @@ static int pci_enable_msix(FAR struct pci_device_s *dev, FAR int *irq,
 
   pci_read_config_word(dev, msix + PCI_MSIX_FLAGS, &flags);
 
-  /* Table Size is N - 1 encoded */
-
-  tblsize = (flags & PCI_MSIX_FLAGS_QSIZE) + 1;
-
   /* Get MSI-X table */
 
-  pci_read_config_dword(dev, msix + PCI_MSIX_TABLE, &tbl);
-
-  /* Extract table address */
-
-  tblbar = tbl & PCI_MSIX_TABLE_BIR;
-  tbladdr = pci_resource_start(dev, tblbar);
-  tbloffset = tbl & PCI_MSIX_TABLE_OFFSET;
-  tbladdr += tbloffset;
-
-  /* Map MSI-X table */
-
-  tblend = tbladdr + tblsize * PCI_MSIX_ENTRY_SIZE;
-
-  if (dev->bus->ctrl->ops->map)
-    {
-      tbladdr = dev->bus->ctrl->ops->map(dev->bus, tbladdr, tblend);
-    }
+  tbladdr = pci_msix_table(dev, msix, &tblsize);
 
   /* Limit tblsize */
 
@@ -1441,6 +1456,42 @@ static int pci_enable_msix(FAR struct pci_device_s *dev, FAR int *irq,
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: pci_msix_entry
+ *
+ * Description:
+ *   Get an entry of the MSI-X table.
+ *
+ * Input Parameters:
+ *   dev   - device
+ *   index - index of the entry
+ *
+ * Return value:
+ *   The mapped address of the entry, 0 if there is no such entry
+ *
+ ****************************************************************************/
+
+static uintptr_t pci_msix_entry(FAR struct pci_device_s *dev, int index)
+{
+  uintptr_t tbladdr = 0;
+  uint16_t  tblsize = 0;
+  uint8_t   msix    = 0;
+
+  pci_get_msi_base(dev, NULL, &msix);
+  if (msix == 0)
+    {
+      return 0;
+    }
+
+  tbladdr = pci_msix_table(dev, msix, &tblsize);
+  if (tbladdr == 0 || index < 0 || index >= tblsize)
+    {
+      return 0;
+    }
+
+  return tbladdr + index * PCI_MSIX_ENTRY_SIZE;
+}
 #endif  /* CONFIG_PCI_MSIX */
 
 /****************************************************************************
@@ -2034,6 +2085,234 @@ int pci_connect_irq(FAR struct pci_device_s *dev, FAR int *irq, int num)
     }
 }
 
+/****************************************************************************
+ * Name: pci_mask_irq
+ *
+ * Description:
+ *   Mask or unmask one MSI-X vector in the device.
+ *
+ * Input Parameters:
+ *   dev   - PCI device
+ *   index - index of the vector in the MSI-X table
+ *   mask  - true to mask, false to unmask
+ *
+ * Return value:
+ *   Return OK on success, -ENOTSUP if MSI-X is not available.
+ *
+ ****************************************************************************/
+
+int pci_mask_irq(FAR struct pci_device_s *dev, int index, bool mask)
+{
+#ifdef CONFIG_PCI_MSIX
+  uintptr_t entry;
+  uint32_t  ctrl;
+
+  entry = pci_msix_entry(dev, index);
+  if (entry == 0)
+    {
+      return -ENOTSUP;
+    }
+
+  pci_read_mmio_dword(dev, entry + PCI_MSIX_ENTRY_VECTOR_CTRL, &ctrl);
+  if (mask)
+    {
+      ctrl |= PCI_MSIX_ENTRY_CTRL_MASKBIT;
+    }
+  else
+    {
+      ctrl &= ~PCI_MSIX_ENTRY_CTRL_MASKBIT;
+    }
+
+  pci_write_mmio_dword(dev, entry + PCI_MSIX_ENTRY_VECTOR_CTRL, ctrl);
+  return OK;
+#else
+  return -ENOTSUP;
+#endif
+}
+
+/****************************************************************************
+ * Name: pci_affinity_irq
+ *
+ * Description:
+ *   Route a connected MSI or MSI-X vector to a CPU.
+ *
+ * Input Parameters:
+ *   dev   - PCI device
+ *   index - index of the vector in the MSI-X table
+ *   irq   - the vector
+ *   cpu   - the CPU to interrupt
+ *
+ * Return value:
+ *   Return OK on success or negative errno on failure.
+ *
+ ****************************************************************************/
+
+int pci_affinity_irq(FAR struct pci_device_s *dev, int index, int irq,
+                     int cpu)
+{
+  FAR const struct pci_ops_s *ops = dev->bus->ctrl->ops;
+#ifdef CONFIG_PCI_MSIX
+  uintptr_t entry;
+  uintptr_t mar;
+  uint32_t  mdr;
+  uint32_t  ctrl;
+  int       ret;
+#endif
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  /* The interrupt controller routes the vector */
+
+  if (ops->affinity_irq == NULL)
+    {
+#ifdef CONFIG_SMP
+      cpu_set_t cpuset;
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpu, &cpuset);
+      up_affinity_irq(irq, cpuset);
+#endif
+      return OK;
+    }
+
+#ifdef CONFIG_PCI_MSIX
+  /* Or the destination is in the message, which is rewritten with the
+   * vector masked.  The MSI vectors share one message and can't be
+   * routed separately.
+   */
+
+  entry = pci_msix_entry(dev, index);
+  if (entry == 0)
+    {
+      return -ENOTSUP;
+    }
+
+  ret = ops->affinity_irq(dev->bus, irq, cpu, &mar, &mdr);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  pci_read_mmio_dword(dev, entry + PCI_MSIX_ENTRY_VECTOR_CTRL, &ctrl);
+  pci_write_mmio_dword(dev, entry + PCI_MSIX_ENTRY_VECTOR_CTRL,
+                       ctrl | PCI_MSIX_ENTRY_CTRL_MASKBIT);
+
+  pci_write_mmio_dword(dev, entry + PCI_MSIX_ENTRY_LOWER_ADDR, mar);
+  pci_write_mmio_dword(dev, entry + PCI_MSIX_ENTRY_UPPER_ADDR,
+                       ((uint64_t)mar >> 32));
+  pci_write_mmio_dword(dev, entry + PCI_MSIX_ENTRY_DATA, mdr);
+
+  pci_write_mmio_dword(dev, entry + PCI_MSIX_ENTRY_VECTOR_CTRL, ctrl);
+  return OK;
+#else
+  return -ENOTSUP;
+#endif
+}
+
+/****************************************************************************
+ * Name: pci_connect_queue_irqs
+ *
+ * Description:
+ *   Allocate and connect up to 'num' MSI or MSI-X vectors, one per queue,
+ *   attach 'isr' to each and enable them.
+ *
+ * Input Parameters:
+ *   dev     - PCI device
+ *   irq     - returned vectors
+ *   num     - number of queues
+ *   isr     - interrupt handler of all the queues
+ *   arg     - argument of the first queue
+ *   argsize - distance between the arguments of two queues
+ *
+ * Return value:
+ *   Return the number of vectors, which may be less than 'num', or
+ *   negative errno on failure.
+ *
+ ****************************************************************************/
+
+int pci_connect_queue_irqs(FAR struct pci_device_s *dev, FAR int *irq,
+                           int num, xcpt_t isr, FAR void *arg,
+                           size_t argsize)
+{
+  int ret;
+  int n;
+  int i;
+
+  n = pci_alloc_irq(dev, irq, num);
+  if (n <= 0)
+    {
+      return n < 0 ? n : -ENOSPC;
+    }
+
+  ret = pci_connect_irq(dev, irq, n);
+  if (ret < 0)
+    {
+      goto err_release;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      ret = irq_attach(irq[i], isr, (FAR uint8_t *)arg + i * argsize);
+      if (ret < 0)
+        {
+          goto err_detach;
+        }
+
+#ifdef CONFIG_SMP
+      /* Spread the queues over the CPUs, the default routing stays if
+       * the vector can't be moved.
+       */
+
+      pci_affinity_irq(dev, i, irq[i], i % CONFIG_SMP_NCPUS);
+#endif
+
+      up_enable_irq(irq[i]);
+    }
+
+  return n;
+
+err_detach:
+  while (i-- > 0)
+    {
+      up_disable_irq(irq[i]);
+      irq_detach(irq[i]);
+    }
+
+err_release:
+  pci_release_irq(dev, irq, n);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pci_release_queue_irqs
+ *
+ * Description:
+ *   Disable, detach and release the vectors of pci_connect_queue_irqs().
+ *
+ * Input Parameters:
+ *   dev - PCI device
+ *   irq - vectors
+ *   num - number of vectors returned by pci_connect_queue_irqs()
+ *
+ ****************************************************************************/
+
+void pci_release_queue_irqs(FAR struct pci_device_s *dev, FAR int *irq,
+                            int num)
+{
+  int i;
+
+  for (i = 0; i < num; i++)
+    {
+      up_disable_irq(irq[i]);
+      irq_detach(irq[i]);
+    }
+
+  pci_release_irq(dev, irq, num);
+}
+
 /****************************************************************************
  * Name: pci_register_driver
  *
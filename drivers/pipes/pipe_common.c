@@ -42,6 +42,7 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
@@ -64,6 +65,18 @@
 #  define pipe_dumpbuffer(m,a,n)
 #endif
 
+/* Count the readers or writers blocked on the data, for the lock-free
+ * paths which must not miss them.
+ */
+
+#ifdef CONFIG_DEV_PIPE_LOCKLESS
+#  define pipe_waitbegin(n) atomic_fetch_add(&(n), 1)
+#  define pipe_waitend(n)   atomic_fetch_sub(&(n), 1)
+#else
+#  define pipe_waitbegin(n)
+#  define pipe_waitend(n)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -85,6 +98,444 @@ static void pipecommon_wakeup(FAR sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_lock
+ *
+ * Description:
+ *   Take d_bflock.  With the lock-free paths, the outermost lock also
+ *   takes both of their tokens, so that everything done under d_bflock
+ *   excludes them.
+ *
+ ****************************************************************************/
+
+static int pipecommon_lock(FAR struct pipe_dev_s *dev)
+{
+  int ret;
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+
+#ifdef CONFIG_DEV_PIPE_LOCKLESS
+  if (ret >= 0 && dev->d_bflock.count == 1)
+    {
+      int32_t expected = 0;
+
+      /* A token is only held for one copy with preemption disabled, so
+       * this spins on another CPU at most.
+       */
+
+      while (!atomic_try_cmpxchg_acquire(&dev->d_rdtoken, &expected, 1))
+        {
+          expected = 0;
+        }
+
+      while (!atomic_try_cmpxchg_acquire(&dev->d_wrtoken, &expected, 1))
+        {
+          expected = 0;
+        }
+    }
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_unlock
+ ****************************************************************************/
+
+static void pipecommon_unlock(FAR struct pipe_dev_s *dev)
+{
+#ifdef CONFIG_DEV_PIPE_LOCKLESS
+  if (dev->d_bflock.count == 1)
+    {
+      atomic_set_release(&dev->d_wrtoken, 0);
+      atomic_set_release(&dev->d_rdtoken, 0);
+    }
+#endif
+
+  nxrmutex_unlock(&dev->d_bflock);
+}
+
+#ifdef CONFIG_DEV_PIPE_LOCKLESS
+/****************************************************************************
+ * Name: pipecommon_fastbegin
+ *
+ * Description:
+ *   Try to become the only reader or writer of the buffer without taking
+ *   d_bflock.  That fails if anyone holds d_bflock or if poll waiters, who
+ *   must be notified under d_bflock, are registered.
+ *
+ ****************************************************************************/
+
+static bool pipecommon_fastbegin(FAR struct pipe_dev_s *dev,
+                                 FAR atomic_t *token)
+{
+  int32_t expected = 0;
+  int i;
+
+  sched_lock();
+  if (!atomic_try_cmpxchg_acquire(token, &expected, 1))
+    {
+      sched_unlock();
+      return false;
+    }
+
+  if (dev->d_buffer.size > 0)
+    {
+      for (i = 0; i < CONFIG_DEV_PIPE_NPOLLWAITERS; i++)
+        {
+          if (dev->d_fds[i] != NULL)
+            {
+              break;
+            }
+        }
+
+      if (i == CONFIG_DEV_PIPE_NPOLLWAITERS)
+        {
+          return true;
+        }
+    }
+
+  atomic_set_release(token, 0);
+  sched_unlock();
+  return false;
+}
+
+/****************************************************************************
+ * Name: pipecommon_fastend
+ ****************************************************************************/
+
+static void pipecommon_fastend(FAR atomic_t *token)
+{
+  atomic_set_release(token, 0);
+  sched_unlock();
+}
+
+/****************************************************************************
+ * Name: pipecommon_fastread
+ *
+ * Description:
+ *   Read what the pipe holds without d_bflock.  The other side may be
+ *   writing at the same time: the head is only written by the writer and
+ *   the tail only by the reader, the barriers order the data with them.
+ *
+ * Returned Value:
+ *   The number of bytes read; 0 if the slow path must be taken.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_fastread(FAR struct pipe_dev_s *dev,
+                                   FAR char *buffer, size_t len)
+{
+  FAR struct circbuf_s *circ = &dev->d_buffer;
+  size_t ncopy;
+  size_t tail;
+  size_t off;
+  size_t n;
+
+  if (!pipecommon_fastbegin(dev, &dev->d_rdtoken))
+    {
+      return 0;
+    }
+
+  tail = circ->tail;
+  n    = MIN(len, circ->head - tail);
+  UP_DMB();
+
+  if (n > 0)
+    {
+      off   = tail % circ->size;
+      ncopy = MIN(n, circ->size - off);
+      memcpy(buffer, (FAR char *)circ->base + off, ncopy);
+      memcpy(buffer + ncopy, circ->base, n - ncopy);
+      UP_DMB();
+      circ->tail = tail + n;
+    }
+
+  pipecommon_fastend(&dev->d_rdtoken);
+
+  if (n > 0 && atomic_read(&dev->d_nwrwait) > 0)
+    {
+      pipecommon_wakeup(&dev->d_wrsem);
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Name: pipecommon_fastwrite
+ *
+ * Description:
+ *   Write what fits in the pipe without d_bflock, see
+ *   pipecommon_fastread().  A reader waiting for a handoff, or no reader
+ *   at all, needs the slow path.
+ *
+ * Returned Value:
+ *   The number of bytes written; 0 if the slow path must be taken.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_fastwrite(FAR struct pipe_dev_s *dev,
+                                    FAR const char *buffer, size_t len)
+{
+  FAR struct circbuf_s *circ = &dev->d_buffer;
+  size_t ncopy;
+  size_t head;
+  size_t off;
+  size_t n = 0;
+
+  if (!pipecommon_fastbegin(dev, &dev->d_wrtoken))
+    {
+      return 0;
+    }
+
+  if (dev->d_nreaders > 0
+#ifdef CONFIG_DEV_PIPE_HANDOFF
+      && dev->d_handoff == NULL
+#endif
+     )
+    {
+      head = circ->head;
+      n    = MIN(len, circ->size - (head - circ->tail));
+      UP_DMB();
+
+      if (n > 0)
+        {
+          off   = head % circ->size;
+          ncopy = MIN(n, circ->size - off);
+          memcpy((FAR char *)circ->base + off, buffer, ncopy);
+          memcpy(circ->base, buffer + ncopy, n - ncopy);
+          UP_DMB();
+          circ->head = head + n;
+        }
+    }
+
+  pipecommon_fastend(&dev->d_wrtoken);
+
+  if (n > 0 && atomic_read(&dev->d_nrdwait) > 0)
+    {
+      pipecommon_wakeup(&dev->d_rdsem);
+    }
+
+  return n;
+}
+#endif /* CONFIG_DEV_PIPE_LOCKLESS */
+
+/****************************************************************************
+ * Name: pipecommon_waitread
+ *
+ * Description:
+ *   Wait until the pipe holds data.  The caller holds d_bflock.
+ *
+ * Returned Value:
+ *   1 if data is available, with d_bflock still held; 0 at end of file or
+ *   a negated errno value, with d_bflock released.
+ *
+ ****************************************************************************/
+
+static int pipecommon_waitread(FAR struct file *filep,
+                               FAR struct pipe_dev_s *dev, bool nonblock)
+{
+  int ret;
+
+  while (circbuf_is_empty(&dev->d_buffer))
+    {
+      /* If there are no writers on the pipe, then return end of file */
+
+      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          pipecommon_unlock(dev);
+          return 0;
+        }
+
+      /* If O_NONBLOCK was set, then return EGAIN */
+
+      if (nonblock || (filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          pipecommon_unlock(dev);
+          return -EAGAIN;
+        }
+
+      /* Otherwise, wait for something to be written to the pipe */
+
+      pipe_waitbegin(dev->d_nrdwait);
+      pipecommon_unlock(dev);
+      ret = nxsem_wait(&dev->d_rdsem);
+      pipe_waitend(dev->d_nrdwait);
+
+      if (ret < 0 || (ret = pipecommon_lock(dev)) < 0)
+        {
+          /* May fail because a signal was received or if the task was
+           * canceled.
+           */
+
+          return ret;
+        }
+    }
+
+  return 1;
+}
+
+/****************************************************************************
+ * Name: pipecommon_waithandoff
+ *
+ * Description:
+ *   Wait on an empty pipe for a writer to copy its data straight into the
+ *   reader buffer, which saves the copy through the pipe buffer.  The
+ *   caller holds d_bflock.
+ *
+ * Returned Value:
+ *   The number of bytes received or a negated errno value, with d_bflock
+ *   released; 0 with d_bflock still held if the data went to the pipe
+ *   buffer instead or there are no writers left.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PIPE_HANDOFF
+static ssize_t pipecommon_waithandoff(FAR struct pipe_dev_s *dev,
+                                      FAR char *buffer, size_t len)
+{
+  struct pipe_handoff_s handoff;
+  int ret = OK;
+
+  handoff.h_buffer = buffer;
+  handoff.h_len    = len;
+  handoff.h_nread  = 0;
+  dev->d_handoff   = &handoff;
+
+  while (handoff.h_nread == 0 && circbuf_is_empty(&dev->d_buffer) &&
+         (dev->d_nwriters > 0 || PIPE_IS_POLICY_1(dev->d_flags)))
+    {
+      pipe_waitbegin(dev->d_nrdwait);
+      pipecommon_unlock(dev);
+      ret = nxsem_wait(&dev->d_rdsem);
+      pipe_waitend(dev->d_nrdwait);
+
+      /* The handoff lives on this stack, it must be withdrawn under the
+       * lock even if the wait was interrupted.
+       */
+
+      while (pipecommon_lock(dev) < 0)
+        {
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  if (dev->d_handoff == &handoff)
+    {
+      dev->d_handoff = NULL;
+    }
+
+  if (handoff.h_nread > 0)
+    {
+      pipecommon_unlock(dev);
+      return handoff.h_nread;
+    }
+  else if (ret < 0)
+    {
+      pipecommon_unlock(dev);
+      return ret;
+    }
+
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: pipecommon_readdone
+ *
+ * Description:
+ *   Notify the writers after data was removed from the pipe.  The caller
+ *   holds d_bflock.
+ *
+ ****************************************************************************/
+
+static void pipecommon_readdone(FAR struct pipe_dev_s *dev)
+{
+  /* Notify all poll/select waiters that they can write to the
+   * FIFO when buffer can accept more than d_polloutthrd bytes.
+   */
+
+  if (circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
+    }
+
+  /* Notify all waiting writers that bytes have been removed from the
+   * buffer.
+   */
+
+  pipecommon_wakeup(&dev->d_wrsem);
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitwrite
+ *
+ * Description:
+ *   Wait until the pipe has room for at least one byte.  The caller holds
+ *   d_bflock.
+ *
+ * Returned Value:
+ *   1 if there is room, with d_bflock still held; a negated errno value,
+ *   with d_bflock released.
+ *
+ ****************************************************************************/
+
+static int pipecommon_waitwrite(FAR struct file *filep,
+                                FAR struct pipe_dev_s *dev, bool nonblock)
+{
+  int ret;
+
+  while (circbuf_is_full(&dev->d_buffer) ||
+         (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags)))
+    {
+      if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          pipecommon_unlock(dev);
+          return -EPIPE;
+        }
+
+      if (nonblock || (filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          pipecommon_unlock(dev);
+          return -EAGAIN;
+        }
+
+      pipe_waitbegin(dev->d_nwrwait);
+      pipecommon_unlock(dev);
+      ret = nxsem_wait(&dev->d_wrsem);
+      pipe_waitend(dev->d_nwrwait);
+      if (ret < 0 || (ret = pipecommon_lock(dev)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  return 1;
+}
+
+/****************************************************************************
+ * Name: pipecommon_writedone
+ *
+ * Description:
+ *   Notify the readers after data was added to the pipe.  The caller holds
+ *   d_bflock.
+ *
+ ****************************************************************************/
+
+static void pipecommon_writedone(FAR struct pipe_dev_s *dev)
+{
+  if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+    }
+
+  pipecommon_wakeup(&dev->d_rdsem);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -144,7 +595,7 @@ int pipecommon_open(FAR struct file *filep)
    * the thread was canceled.
    */
 
-  ret = nxrmutex_lock(&dev->d_bflock);
+  ret = pipecommon_lock(dev);
   if (ret < 0)
     {
       ferr("ERROR: nxrmutex_lock failed: %d\n", ret);
@@ -158,7 +609,7 @@ int pipecommon_open(FAR struct file *filep)
       ret = circbuf_init(&dev->d_buffer, NULL, dev->d_bufsize);
       if (ret < 0)
         {
-          nxrmutex_unlock(&dev->d_bflock);
+          pipecommon_unlock(dev);
           return ret;
         }
     }
@@ -193,7 +644,7 @@ int pipecommon_open(FAR struct file *filep)
        * on the pipe.
        */
 
-      nxrmutex_unlock(&dev->d_bflock);
+      pipecommon_unlock(dev);
 
       /* NOTE: d_wrsem is normally used to check if the write buffer is full
        * and wait for it being read and being able to receive more data. But,
@@ -217,7 +668,7 @@ int pipecommon_open(FAR struct file *filep)
        * signal or if the task is canceled.
        */
 
-      ret = nxrmutex_lock(&dev->d_bflock);
+      ret = pipecommon_lock(dev);
       if (ret < 0)
         {
           ferr("ERROR: nxrmutex_lock failed: %d\n", ret);
@@ -257,7 +708,7 @@ int pipecommon_open(FAR struct file *filep)
        * on the pipe.
        */
 
-      nxrmutex_unlock(&dev->d_bflock);
+      pipecommon_unlock(dev);
 
       /* NOTE: d_rdsem is normally used when the read logic waits for more
        * data to be written.  But until the first writer has opened the
@@ -283,7 +734,7 @@ int pipecommon_open(FAR struct file *filep)
        * signal or if the task is canceled.
        */
 
-      ret = nxrmutex_lock(&dev->d_bflock);
+      ret = pipecommon_lock(dev);
       if (ret < 0)
         {
           ferr("ERROR: nxrmutex_lock failed: %d\n", ret);
@@ -295,7 +746,7 @@ int pipecommon_open(FAR struct file *filep)
         }
     }
 
-  nxrmutex_unlock(&dev->d_bflock);
+  pipecommon_unlock(dev);
   return ret;
 }
 
@@ -316,7 +767,7 @@ int pipecommon_close(FAR struct file *filep)
    * I've never seen anyone check that.
    */
 
-  ret = nxrmutex_lock(&dev->d_bflock);
+  ret = pipecommon_lock(dev);
   if (ret < 0)
     {
       /* The close will not be performed if the task was canceled */
@@ -404,7 +855,7 @@ int pipecommon_close(FAR struct file *filep)
 #endif
     }
 
-  nxrmutex_unlock(&dev->d_bflock);
+  pipecommon_unlock(dev);
   return OK;
 }
 
@@ -426,75 +877,65 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return 0;
     }
 
-  /* Make sure that we have exclusive access to the device structure */
-
-  ret = nxrmutex_lock(&dev->d_bflock);
-  if (ret < 0)
-    {
-      /* May fail because a signal was received or if the task was
-       * canceled.
-       */
-
-      return ret;
-    }
-
-  /* If the pipe is empty, then wait for something to be written to it */
-
-  while (circbuf_is_empty(&dev->d_buffer))
-    {
-      /* If there are no writers on the pipe, then return end of file */
-
-      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
-        {
-          nxrmutex_unlock(&dev->d_bflock);
-          return 0;
-        }
-
-      /* If O_NONBLOCK was set, then return EGAIN */
-
-      if (filep->f_oflags & O_NONBLOCK)
-        {
-          nxrmutex_unlock(&dev->d_bflock);
-          return -EAGAIN;
-        }
+#ifdef CONFIG_DEV_PIPE_LOCKLESS
+  /* Take what is there without the lock, the lock is only needed to wait
+   * on an empty pipe.
+   */
 
-      /* Otherwise, wait for something to be written to the pipe */
+  nread = pipecommon_fastread(dev, buffer, len);
+  if (nread > 0)
+    {
+      pipe_dumpbuffer("From PIPE:", buffer, nread);
+      return nread;
+    }
+#endif
 
-      nxrmutex_unlock(&dev->d_bflock);
-      ret = nxsem_wait(&dev->d_rdsem);
+  /* Make sure that we have exclusive access to the device structure */
 
-      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
-        {
-          /* May fail because a signal was received or if the task was
-           * canceled.
-           */
+  ret = pipecommon_lock(dev);
+  if (ret < 0)
+    {
+      /* May fail because a signal was received or if the task was
+       * canceled.
+       */
 
-          return ret;
-        }
+      return ret;
     }
 
-  /* Then return whatever is available in the pipe (which is at least one
-   * byte).
+#ifdef CONFIG_DEV_PIPE_HANDOFF
+  /* A blocking reader of an empty pipe lets the writer fill its buffer.
+   * Only one reader waits that way, the others use the pipe buffer.
    */
 
-  nread = circbuf_read(&dev->d_buffer, buffer, len);
+  if (circbuf_is_empty(&dev->d_buffer) && dev->d_handoff == NULL &&
+      (filep->f_oflags & O_NONBLOCK) == 0 &&
+      (dev->d_nwriters > 0 || PIPE_IS_POLICY_1(dev->d_flags)))
+    {
+      nread = pipecommon_waithandoff(dev, buffer, len);
+      if (nread != 0)
+        {
+          pipe_dumpbuffer("From PIPE:", buffer, nread);
+          return nread;
+        }
+    }
+#endif
 
-  /* Notify all poll/select waiters that they can write to the
-   * FIFO when buffer can accept more than d_polloutthrd bytes.
-   */
+  /* If the pipe is empty, then wait for something to be written to it */
 
-  if (circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
+  ret = pipecommon_waitread(filep, dev, false);
+  if (ret <= 0)
     {
-      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
+      return ret;
     }
 
-  /* Notify all waiting writers that bytes have been removed from the
-   * buffer.
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte).
    */
 
-  pipecommon_wakeup(&dev->d_wrsem);
+  nread = circbuf_read(&dev->d_buffer, buffer, len);
+  pipecommon_readdone(dev);
 
-  nxrmutex_unlock(&dev->d_bflock);
+  pipecommon_unlock(dev);
   pipe_dumpbuffer("From PIPE:", buffer, nread);
   return nread;
 }
@@ -537,16 +978,26 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
   DEBUGASSERT(up_interrupt_context() == false);
 
+#ifdef CONFIG_DEV_PIPE_LOCKLESS
+  /* Put what fits without the lock, the rest takes the slow path */
+
+  nwritten = pipecommon_fastwrite(dev, buffer, len);
+  if ((size_t)nwritten == len)
+    {
+      return len;
+    }
+#endif
+
   /* Make sure that we have exclusive access to the device structure */
 
-  ret = nxrmutex_lock(&dev->d_bflock);
+  ret = pipecommon_lock(dev);
   if (ret < 0)
     {
       /* May fail because a signal was received or if the task was
        * canceled.
        */
 
-      return ret;
+      return nwritten == 0 ? ret : nwritten;
     }
 
   /* Loop until all of the bytes have been written */
@@ -562,10 +1013,37 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
       if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
         {
-          nxrmutex_unlock(&dev->d_bflock);
+          pipecommon_unlock(dev);
           return nwritten == 0 ? -EPIPE : nwritten;
         }
 
+#ifdef CONFIG_DEV_PIPE_HANDOFF
+      /* Copy straight into the buffer of a waiting reader.  It only waits
+       * on an empty pipe, so this keeps the order of the data.
+       */
+
+      if (dev->d_handoff != NULL && circbuf_is_empty(&dev->d_buffer))
+        {
+          FAR struct pipe_handoff_s *handoff = dev->d_handoff;
+          size_t ncopy = MIN(handoff->h_len, len - nwritten);
+
+          memcpy(handoff->h_buffer, buffer + nwritten, ncopy);
+          handoff->h_nread = ncopy;
+          dev->d_handoff   = NULL;
+          nwritten        += ncopy;
+
+          pipecommon_wakeup(&dev->d_rdsem);
+
+          if ((size_t)nwritten == len)
+            {
+              pipecommon_unlock(dev);
+              return len;
+            }
+
+          continue;
+        }
+#endif
+
       /* Would the next write overflow the circular buffer? */
 
       if (!circbuf_is_full(&dev->d_buffer))
@@ -595,7 +1073,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
               /* Return the number of bytes written */
 
-              nxrmutex_unlock(&dev->d_bflock);
+              pipecommon_unlock(dev);
               return len;
             }
         }
@@ -633,7 +1111,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
                   nwritten = -EAGAIN;
                 }
 
-              nxrmutex_unlock(&dev->d_bflock);
+              pipecommon_unlock(dev);
               return nwritten;
             }
 
@@ -641,9 +1119,11 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
            * the pipe
            */
 
-          nxrmutex_unlock(&dev->d_bflock);
+          pipe_waitbegin(dev->d_nwrwait);
+          pipecommon_unlock(dev);
           ret = nxsem_wait(&dev->d_wrsem);
-          if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+          pipe_waitend(dev->d_nwrwait);
+          if (ret < 0 || (ret = pipecommon_lock(dev)) < 0)
             {
               /* Either call nxsem_wait may fail because a signal was
                * received or if the task was canceled.
@@ -655,6 +1135,368 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
     }
 }
 
+/****************************************************************************
+ * Name: pipe_splice_out
+ *
+ * Description:
+ *   Move data out of a pipe without copying it to a caller buffer: 'sink'
+ *   is handed the data in place, in at most two contiguous pieces, and the
+ *   bytes it reports as consumed are removed from the pipe.  'sink' runs
+ *   with the pipe locked and must not access the same pipe.
+ *
+ * Input Parameters:
+ *   filep    - The read end of the pipe
+ *   sink     - Consumes the data, returns the number of bytes taken or a
+ *              negated errno value
+ *   arg      - Passed to 'sink'
+ *   len      - The maximum number of bytes to move
+ *   nonblock - Do not wait for data even if the pipe is blocking
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at end of file, or a negated errno
+ *   value.
+ *
+ ****************************************************************************/
+
+ssize_t pipe_splice_out(FAR struct file *filep, pipe_splice_t sink,
+                        FAR void *arg, size_t len, bool nonblock)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  FAR void *buffer;
+  ssize_t total = 0;
+  ssize_t ret;
+  size_t size;
+
+  DEBUGASSERT(dev != NULL && sink != NULL);
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  ret = pipecommon_lock(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = pipecommon_waitread(filep, dev, nonblock);
+  if (ret <= 0)
+    {
+      return ret;
+    }
+
+  while ((size_t)total < len)
+    {
+      buffer = circbuf_get_readptr(&dev->d_buffer, &size);
+      if (size == 0)
+        {
+          break;
+        }
+
+      size = MIN(size, len - total);
+      ret  = sink(arg, buffer, size);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      pipe_dumpbuffer("From PIPE:", buffer, ret);
+      circbuf_readcommit(&dev->d_buffer, ret);
+      total += ret;
+      if ((size_t)ret < size)
+        {
+          break;
+        }
+    }
+
+  if (total > 0)
+    {
+      pipecommon_readdone(dev);
+    }
+
+  pipecommon_unlock(dev);
+  return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Name: pipe_splice_in
+ *
+ * Description:
+ *   Move data into a pipe without staging it in a caller buffer: 'source'
+ *   fills the free space of the pipe in place, in at most two contiguous
+ *   pieces.  'source' runs with the pipe locked and must not access the
+ *   same pipe.
+ *
+ * Input Parameters:
+ *   filep    - The write end of the pipe
+ *   source   - Produces the data, returns the number of bytes stored or a
+ *              negated errno value
+ *   arg      - Passed to 'source'
+ *   len      - The maximum number of bytes to move
+ *   nonblock - Do not wait for room even if the pipe is blocking
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero if 'source' had nothing, or a negated
+ *   errno value.
+ *
+ ****************************************************************************/
+
+ssize_t pipe_splice_in(FAR struct file *filep, pipe_splice_t source,
+                       FAR void *arg, size_t len, bool nonblock)
+{
+  FAR struct pipe_dev_s *dev = filep->f_inode->i_private;
+  FAR void *buffer;
+  ssize_t total = 0;
+  ssize_t ret;
+  size_t size;
+
+  DEBUGASSERT(dev != NULL && source != NULL);
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  ret = pipecommon_lock(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = pipecommon_waitwrite(filep, dev, nonblock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while ((size_t)total < len)
+    {
+      buffer = circbuf_get_writeptr(&dev->d_buffer, &size);
+      if (size == 0)
+        {
+          break;
+        }
+
+      size = MIN(size, len - total);
+      ret  = source(arg, buffer, size);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      pipe_dumpbuffer("To PIPE:", buffer, ret);
+      circbuf_writecommit(&dev->d_buffer, ret);
+      total += ret;
+      if ((size_t)ret < size)
+        {
+          break;
+        }
+    }
+
+  if (total > 0)
+    {
+      pipecommon_writedone(dev);
+    }
+
+  pipecommon_unlock(dev);
+  return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_copy
+ *
+ * Description:
+ *   Copy up to 'len' bytes of the data queued in one pipe into another
+ *   pipe, and remove them from the source if 'consume' is true.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_copy(FAR struct file *infile,
+                               FAR struct file *outfile, size_t len,
+                               bool nonblock, bool consume)
+{
+  FAR struct pipe_dev_s *indev = infile->f_inode->i_private;
+  FAR struct pipe_dev_s *outdev = outfile->f_inode->i_private;
+  FAR void *buffer;
+  ssize_t total = 0;
+  ssize_t ret;
+  size_t size;
+
+  DEBUGASSERT(indev != NULL && outdev != NULL);
+
+  if (indev == outdev)
+    {
+      return -EINVAL;
+    }
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  /* Wait for data without holding the other pipe, then take both locks in
+   * a fixed order so that two opposite transfers cannot deadlock.
+   */
+
+  for (; ; )
+    {
+      ret = pipecommon_lock(indev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = pipecommon_waitread(infile, indev, nonblock);
+      if (ret <= 0)
+        {
+          return ret;
+        }
+
+      pipecommon_unlock(indev);
+
+      ret = pipecommon_lock(outdev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = pipecommon_waitwrite(outfile, outdev, nonblock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (indev > outdev)
+        {
+          ret = pipecommon_lock(indev);
+          if (ret < 0)
+            {
+              pipecommon_unlock(outdev);
+              return ret;
+            }
+        }
+      else
+        {
+          pipecommon_unlock(outdev);
+          ret = pipecommon_lock(indev);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          ret = pipecommon_lock(outdev);
+          if (ret < 0)
+            {
+              pipecommon_unlock(indev);
+              return ret;
+            }
+        }
+
+      /* Someone may have drained the source or filled the destination
+       * while neither was locked.
+       */
+
+      if (!circbuf_is_empty(&indev->d_buffer) &&
+          !circbuf_is_full(&outdev->d_buffer))
+        {
+          break;
+        }
+
+      pipecommon_unlock(outdev);
+      pipecommon_unlock(indev);
+    }
+
+  len = MIN(len, circbuf_used(&indev->d_buffer));
+  while ((size_t)total < len)
+    {
+      buffer = circbuf_get_writeptr(&outdev->d_buffer, &size);
+      if (size == 0)
+        {
+          break;
+        }
+
+      size = MIN(size, len - total);
+      ret  = circbuf_peekat(&indev->d_buffer,
+                            indev->d_buffer.tail + total,
+                            buffer, size);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      circbuf_writecommit(&outdev->d_buffer, ret);
+      total += ret;
+    }
+
+  if (total > 0)
+    {
+      if (consume)
+        {
+          circbuf_readcommit(&indev->d_buffer, total);
+          pipecommon_readdone(indev);
+        }
+
+      pipecommon_writedone(outdev);
+    }
+
+  pipecommon_unlock(outdev);
+  pipecommon_unlock(indev);
+  return total;
+}
+
+/****************************************************************************
+ * Name: pipe_tee
+ *
+ * Description:
+ *   Duplicate up to 'len' bytes of the data queued in one pipe into
+ *   another pipe without consuming them.
+ *
+ * Input Parameters:
+ *   infile   - The read end of the source pipe
+ *   outfile  - The write end of the destination pipe
+ *   len      - The maximum number of bytes to duplicate
+ *   nonblock - Do not wait even if the pipes are blocking
+ *
+ * Returned Value:
+ *   The number of bytes duplicated, zero at end of file, or a negated errno
+ *   value.
+ *
+ ****************************************************************************/
+
+ssize_t pipe_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, bool nonblock)
+{
+  return pipecommon_copy(infile, outfile, len, nonblock, false);
+}
+
+/****************************************************************************
+ * Name: pipe_move
+ *
+ * Description:
+ *   Move up to 'len' bytes from one pipe to another.  Unlike a sink passed
+ *   to pipe_splice_out() that writes into the other pipe, this takes both
+ *   pipe locks in a fixed order.
+ *
+ * Input Parameters:
+ *   infile   - The read end of the source pipe
+ *   outfile  - The write end of the destination pipe
+ *   len      - The maximum number of bytes to move
+ *   nonblock - Do not wait even if the pipes are blocking
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at end of file, or a negated errno
+ *   value.
+ *
+ ****************************************************************************/
+
+ssize_t pipe_move(FAR struct file *infile, FAR struct file *outfile,
+                  size_t len, bool nonblock)
+{
+  return pipecommon_copy(infile, outfile, len, nonblock, true);
+}
+
 /****************************************************************************
  * Name: pipecommon_poll
  ****************************************************************************/
@@ -673,7 +1515,7 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
   /* Are we setting up the poll?  Or tearing it down? */
 
-  ret = nxrmutex_lock(&dev->d_bflock);
+  ret = pipecommon_lock(dev);
   if (ret < 0)
     {
       return ret;
@@ -770,7 +1612,7 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
     }
 
 errout:
-  nxrmutex_unlock(&dev->d_bflock);
+  pipecommon_unlock(dev);
   return ret;
 }
 
@@ -793,7 +1635,7 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     }
 #endif
 
-  ret = nxrmutex_lock(&dev->d_bflock);
+  ret = pipecommon_lock(dev);
   if (ret < 0)
     {
       return ret;
@@ -865,7 +1707,22 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               break;
             }
 
+#ifdef CONFIG_MM_PGSIZE
+          /* Grow in whole pages, as F_SETPIPE_SZ does elsewhere */
+
+          size = ALIGN_UP(size, CONFIG_MM_PGSIZE);
+#endif
+
           size = MIN(size, CONFIG_DEV_PIPE_MAXSIZE);
+
+          /* Shrinking below the data held would lose some of it */
+
+          if (size < circbuf_used(&dev->d_buffer))
+            {
+              ret = -EBUSY;
+              break;
+            }
+
           ret = circbuf_resize(&dev->d_buffer, size);
           if (ret != 0)
             {
@@ -908,7 +1765,7 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
     }
 
-  nxrmutex_unlock(&dev->d_bflock);
+  pipecommon_unlock(dev);
   return ret;
 }
 
@@ -925,7 +1782,7 @@ int pipecommon_unlink(FAR struct inode *inode)
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
-  ret = nxrmutex_lock(&dev->d_bflock);
+  ret = pipecommon_lock(dev);
   if (ret < 0)
     {
       return ret;
@@ -941,7 +1798,7 @@ int pipecommon_unlink(FAR struct inode *inode)
   /* Mark the pipe unlinked */
 
   PIPE_UNLINK(dev->d_flags);
-  nxrmutex_unlock(&dev->d_bflock);
+  pipecommon_unlock(dev);
 
   return OK;
 }
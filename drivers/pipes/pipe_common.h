@@ -28,6 +28,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/atomic.h>
 #include <nuttx/mutex.h>
 #include <nuttx/circbuf.h>
 #include <sys/types.h>
@@ -110,6 +111,19 @@ typedef uint16_t pipe_ndx_t;  /* 16-bit index */
 typedef uint8_t pipe_ndx_t;   /*  8-bit index */
 #endif
 
+#ifdef CONFIG_DEV_PIPE_HANDOFF
+/* A reader blocked on an empty pipe, whose buffer the next writer fills
+ * directly.
+ */
+
+struct pipe_handoff_s
+{
+  FAR char *h_buffer;             /* Buffer of the reader */
+  size_t    h_len;                /* Size of the buffer */
+  size_t    h_nread;              /* Bytes written there, 0 until filled */
+};
+#endif
+
 /* This structure represents the state of one pipe.  A reference to this
  * structure is retained in the i_private field of the inode whenthe
  * pipe/fifo device is registered.
@@ -137,6 +151,17 @@ struct pipe_dev_s
    */
 
   FAR struct pollfd *d_fds[CONFIG_DEV_PIPE_NPOLLWAITERS];
+
+#ifdef CONFIG_DEV_PIPE_HANDOFF
+  FAR struct pipe_handoff_s *d_handoff; /* Reader waiting for a handoff */
+#endif
+
+#ifdef CONFIG_DEV_PIPE_LOCKLESS
+  atomic_t         d_rdtoken;     /* Held by the one reader of d_buffer */
+  atomic_t         d_wrtoken;     /* Held by the one writer of d_buffer */
+  atomic_t         d_nrdwait;     /* Readers blocked on d_rdsem for data */
+  atomic_t         d_nwrwait;     /* Writers blocked on d_wrsem for room */
+#endif
 };
 
 /****************************************************************************
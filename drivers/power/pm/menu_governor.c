@@ -0,0 +1,380 @@
+/****************************************************************************
+ * drivers/power/pm/menu_governor.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <sys/param.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/power/pm.h>
+
+#include "pm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MENU_HISTORY           CONFIG_PM_GOVERNOR_MENU_HISTORY
+
+/* Idle durations are kept in microseconds, UINT32_MAX if unknown */
+
+#define MENU_UNKNOWN           UINT32_MAX
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pm_menu_governor_domain_s
+{
+  /* The durations of the last idle periods, in microseconds */
+
+  uint32_t history[MENU_HISTORY];
+  uint8_t  nhistory;
+  uint8_t  next;
+
+  /* The state entered and when, valid while idle is true */
+
+  bool     idle;
+  uint8_t  state;
+  uint64_t enter;
+
+  /* What each state was used for */
+
+  struct pm_menu_stats_s stats[PM_COUNT];
+};
+
+struct pm_menu_governor_s
+{
+  struct pm_menu_governor_domain_s domain[CONFIG_PM_NDOMAINS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* PM governor methods */
+
+static void menu_governor_statechanged(int domain, enum pm_state_e newstate);
+static enum pm_state_e menu_governor_checkstate(int domain);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct pm_governor_s g_menu_governor_ops =
+{
+  NULL,                            /* initialize */
+  NULL,                            /* deinitialize */
+  menu_governor_statechanged,      /* statechanged */
+  menu_governor_checkstate,        /* checkstate */
+  NULL,                            /* activity */
+  NULL                             /* priv */
+};
+
+/* Time to leave each state, and the shortest stay that saves power */
+
+static const uint32_t g_menu_governor_latency[PM_COUNT] =
+{
+  0,
+  CONFIG_PM_GOVERNOR_MENU_IDLE_LATENCY,
+  CONFIG_PM_GOVERNOR_MENU_STANDBY_LATENCY,
+  CONFIG_PM_GOVERNOR_MENU_SLEEP_LATENCY,
+};
+
+static const uint32_t g_menu_governor_residency[PM_COUNT] =
+{
+  0,
+  CONFIG_PM_GOVERNOR_MENU_IDLE_RESIDENCY,
+  CONFIG_PM_GOVERNOR_MENU_STANDBY_RESIDENCY,
+  CONFIG_PM_GOVERNOR_MENU_SLEEP_RESIDENCY,
+};
+
+static struct pm_menu_governor_s g_menu_governor;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: menu_governor_now
+ ****************************************************************************/
+
+static uint64_t menu_governor_now(void)
+{
+  struct timespec ts;
+
+  clock_systime_timespec(&ts);
+  return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: menu_governor_deadline
+ *
+ * Description:
+ *   The time until the next timer expiration, the idle period can't be
+ *   longer than that.
+ *
+ ****************************************************************************/
+
+static uint32_t menu_governor_deadline(void)
+{
+#ifdef CONFIG_SCHED_TICKLESS
+  uint64_t usec = TICK2USEC((uint64_t)nxsched_get_next_expired());
+
+  return MIN(usec, MENU_UNKNOWN - 1);
+#else
+  return USEC_PER_TICK;
+#endif
+}
+
+/****************************************************************************
+ * Name: menu_governor_typical
+ *
+ * Description:
+ *   Look for a repeating pattern in the idle history: if the durations
+ *   are close to their average, it predicts the next one.  The longest
+ *   durations are dropped as outliers, down to three quarters of the
+ *   history.  Return MENU_UNKNOWN if there is no pattern.
+ *
+ ****************************************************************************/
+
+static uint32_t
+menu_governor_typical(FAR struct pm_menu_governor_domain_s *gdom)
+{
+  uint32_t thresh = MENU_UNKNOWN - 1;
+  uint64_t variance;
+  uint64_t sum;
+  uint32_t max;
+  uint32_t avg;
+  int n;
+  int i;
+
+  for (; ; )
+    {
+      sum = 0;
+      max = 0;
+      n   = 0;
+
+      for (i = 0; i < gdom->nhistory; i++)
+        {
+          if (gdom->history[i] <= thresh)
+            {
+              sum += gdom->history[i];
+              max  = MAX(max, gdom->history[i]);
+              n++;
+            }
+        }
+
+      if (n == 0)
+        {
+          return MENU_UNKNOWN;
+        }
+
+      avg      = sum / n;
+      variance = 0;
+
+      for (i = 0; i < gdom->nhistory; i++)
+        {
+          if (gdom->history[i] <= thresh)
+            {
+              int64_t diff = (int64_t)gdom->history[i] - avg;
+
+              variance += (uint64_t)(diff * diff) / n;
+            }
+        }
+
+      /* Standard deviation under a sixth of the average, or under 20us */
+
+      if (variance <= (uint64_t)avg * avg / 36 || variance <= 400)
+        {
+          return avg;
+        }
+
+      if (n * 4 <= gdom->nhistory * 3)
+        {
+          return MENU_UNKNOWN;
+        }
+
+      thresh = max - 1;
+    }
+}
+
+/****************************************************************************
+ * Name: menu_governor_statechanged
+ *
+ * Description:
+ *   Called with the domain locked.  The time between a state change and
+ *   the PM_RESTORE from pm_idle() is the idle period learnt from.
+ *
+ ****************************************************************************/
+
+static void menu_governor_statechanged(int domain, enum pm_state_e newstate)
+{
+  FAR struct pm_menu_governor_domain_s *gdom;
+  FAR struct pm_menu_stats_s *stats;
+  uint64_t duration;
+
+  gdom = &g_menu_governor.domain[domain];
+
+  if (newstate != PM_RESTORE)
+    {
+      gdom->idle  = true;
+      gdom->state = newstate;
+      gdom->enter = menu_governor_now();
+      return;
+    }
+
+  if (!gdom->idle)
+    {
+      return;
+    }
+
+  gdom->idle = false;
+  duration   = menu_governor_now() - gdom->enter;
+  duration   = MIN(duration, MENU_UNKNOWN - 1);
+
+  gdom->history[gdom->next] = duration;
+  if (gdom->nhistory < MENU_HISTORY)
+    {
+      gdom->nhistory++;
+    }
+
+  if (++gdom->next >= MENU_HISTORY)
+    {
+      gdom->next = 0;
+    }
+
+  stats = &gdom->stats[gdom->state];
+  stats->count++;
+  stats->residency += duration;
+  if (duration < g_menu_governor_residency[gdom->state])
+    {
+      stats->early++;
+    }
+}
+
+/****************************************************************************
+ * Name: menu_governor_checkstate
+ ****************************************************************************/
+
+static enum pm_state_e menu_governor_checkstate(int domain)
+{
+  FAR struct pm_menu_governor_domain_s *gdom;
+  FAR struct pm_domain_s *pdom;
+  enum pm_state_e state;
+  irqstate_t flags;
+  uint32_t predicted;
+  uint32_t deadline;
+
+  gdom = &g_menu_governor.domain[domain];
+  pdom = &g_pmdomains[domain];
+  state = PM_NORMAL;
+
+  deadline = menu_governor_deadline();
+
+  /* We disable interrupts since pm_stay()/pm_relax() could be simultaneously
+   * invoked, which modifies the stay count which we are about to read
+   */
+
+  flags = spin_lock_irqsave(&pdom->lock);
+
+  /* Find the lowest power-level which is not locked. */
+
+  while (dq_empty(&pdom->wakelock[state]) && state < (PM_COUNT - 1))
+    {
+      state++;
+    }
+
+  predicted = MIN(deadline, menu_governor_typical(gdom));
+
+  spin_unlock_irqrestore(&pdom->lock, flags);
+
+  /* Then back off to the deepest state that pays off within the predicted
+   * idle period and can be left before the next timer expires.
+   */
+
+  for (; state > PM_NORMAL; state--)
+    {
+      if (g_menu_governor_residency[state] <= predicted &&
+          g_menu_governor_latency[state] <= deadline)
+        {
+          break;
+        }
+    }
+
+  return state;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_menu_governor_stats
+ ****************************************************************************/
+
+void pm_menu_governor_stats(int domain, enum pm_state_e state,
+                            FAR struct pm_menu_stats_s *stats)
+{
+  *stats = g_menu_governor.domain[domain].stats[state];
+}
+
+/****************************************************************************
+ * Name: pm_menu_governor_latency
+ ****************************************************************************/
+
+uint32_t pm_menu_governor_latency(enum pm_state_e state)
+{
+  return g_menu_governor_latency[state];
+}
+
+/****************************************************************************
+ * Name: pm_menu_governor_residency
+ ****************************************************************************/
+
+uint32_t pm_menu_governor_residency(enum pm_state_e state)
+{
+  return g_menu_governor_residency[state];
+}
+
+/****************************************************************************
+ * Name: pm_menu_governor_initialize
+ *
+ * Description:
+ *   Return the menu governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct. Otherwise NULL is returned on error.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_menu_governor_initialize(void)
+{
+  return &g_menu_governor_ops;
+}
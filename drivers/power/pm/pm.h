@@ -95,6 +95,17 @@ struct pm_domain_s
   spinlock_t lock;
 };
 
+#ifdef CONFIG_PM_GOVERNOR_MENU
+/* What the menu governor used a state for, the times are in microseconds */
+
+struct pm_menu_stats_s
+{
+  uint32_t count;      /* Times the state was entered */
+  uint32_t early;      /* Times left before the target residency */
+  uint64_t residency;  /* Total time spent in the state */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -164,6 +175,41 @@ void pm_domain_unlock(int domain, irqstate_t flags);
 
 void pm_wakelock_global_init(void);
 
+#ifdef CONFIG_PM_GOVERNOR_MENU
+
+/****************************************************************************
+ * Name: pm_menu_governor_stats
+ *
+ * Description:
+ *   Get the statistics of one state of a domain, the caller must hold the
+ *   domain lock.
+ *
+ ****************************************************************************/
+
+void pm_menu_governor_stats(int domain, enum pm_state_e state,
+                            FAR struct pm_menu_stats_s *stats);
+
+/****************************************************************************
+ * Name: pm_menu_governor_latency
+ *
+ * Description:
+ *   Return the exit latency of a state in microseconds.
+ *
+ ****************************************************************************/
+
+uint32_t pm_menu_governor_latency(enum pm_state_e state);
+
+/****************************************************************************
+ * Name: pm_menu_governor_residency
+ *
+ * Description:
+ *   Return the target residency of a state in microseconds.
+ *
+ ****************************************************************************/
+
+uint32_t pm_menu_governor_residency(enum pm_state_e state);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
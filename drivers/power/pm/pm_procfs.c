@@ -49,6 +49,9 @@
 #define STHDR "DOMAIN%-2d                  WAKE           SLEEP          TOTAL\n"
 #define PFHDR "CALLBACKS                 IDLE           STANDBY        SLEEP\n"
 #define WAHDR "DOMAIN%-2d                  STATE          COUNT          TIME\n"
+#define GOHDR "DOMAIN%-2d    COUNT      EARLY      RESIDENCY      LATENCY    TARGET\n"
+#define GOFMT "%-11s %-10" PRIu32 " %-10" PRIu32 " %-12" PRIu64 "us %-8" \
+              PRIu32 "us %" PRIu32 "us\n"
 
 #ifdef CONFIG_SYSTEM_TIME64
 #  define STFMT "%-18s %8" PRIu64 "s %3" PRIu64 "%% %8" PRIu64 "s %3" \
@@ -109,6 +112,10 @@ static ssize_t pm_read_wakelock(FAR struct file *filep, FAR char *buffer,
                                 size_t buflen);
 static ssize_t pm_read_preparefail(FAR struct file *filep, FAR char *buffer,
                                    size_t buflen);
+#ifdef CONFIG_PM_GOVERNOR_MENU
+static ssize_t pm_read_governor(FAR struct file *filep, FAR char *buffer,
+                                size_t buflen);
+#endif
 static ssize_t pm_read(FAR struct file *filep, FAR char *buffer,
                        size_t buflen);
 static int     pm_dup(FAR const struct file *oldp,
@@ -161,6 +168,9 @@ static const struct pm_file_ops_s g_pm_files[] =
   {"state",        pm_read_state},
   {"wakelock",     pm_read_wakelock},
   {"preparefail",  pm_read_preparefail},
+#ifdef CONFIG_PM_GOVERNOR_MENU
+  {"governor",     pm_read_governor},
+#endif
 };
 
 static FAR const char *g_pm_state[PM_COUNT] =
@@ -533,6 +543,76 @@ static ssize_t pm_read_preparefail(FAR struct file *filep, FAR char *buffer,
   return totalsize;
 }
 
+#ifdef CONFIG_PM_GOVERNOR_MENU
+/****************************************************************************
+ * Name: pm_read_governor
+ *
+ * Description:
+ *   The statistic values of the menu governor about every domain states.
+ *
+ ****************************************************************************/
+
+static ssize_t pm_read_governor(FAR struct file *filep, FAR char *buffer,
+                                size_t buflen)
+{
+  struct pm_menu_stats_s stats[PM_COUNT];
+  FAR struct pm_file_s *pmfile;
+  irqstate_t flags;
+  size_t totalsize = 0;
+  size_t linesize;
+  size_t copysize;
+  off_t offset;
+  uint32_t state;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  pmfile = (FAR struct pm_file_s *)filep->f_priv;
+  DEBUGASSERT(pmfile);
+
+  /* Save the file offset and the user buffer information */
+
+  offset = filep->f_pos;
+
+  linesize = snprintf(pmfile->line, PM_LINELEN, GOHDR, pmfile->domain);
+  copysize = procfs_memcpy(pmfile->line, linesize, buffer,
+                           buflen, &offset);
+
+  totalsize += copysize;
+
+  flags = pm_domain_lock(pmfile->domain);
+
+  for (state = 0; state < PM_COUNT; state++)
+    {
+      pm_menu_governor_stats(pmfile->domain, state, &stats[state]);
+    }
+
+  pm_domain_unlock(pmfile->domain, flags);
+
+  for (state = 0; state < PM_COUNT && totalsize < buflen; state++)
+    {
+      linesize = snprintf(pmfile->line, PM_LINELEN, GOFMT,
+                          g_pm_state[state],
+                          stats[state].count,
+                          stats[state].early,
+                          stats[state].residency,
+                          pm_menu_governor_latency(state),
+                          pm_menu_governor_residency(state));
+      buffer += copysize;
+      buflen -= copysize;
+
+      copysize = procfs_memcpy(pmfile->line, linesize, buffer,
+                               buflen, &offset);
+
+      totalsize += copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: pm_read
  ****************************************************************************/
@@ -81,9 +81,41 @@ struct regmap_s
 
   int reg_stride;
 
+#ifdef CONFIG_REGMAP_CACHE
+  /* The register cache, indexed by register address / reg_stride. */
+
+  FAR unsigned int *cache;
+  FAR uint8_t *cache_valid;    /* Bitmap of the registers in the cache */
+  FAR uint8_t *cache_dirty;    /* Bitmap of the registers to write back */
+  unsigned int cache_nregs;
+  bool cache_only;             /* Writes only go to the cache */
+  bool cache_reset;            /* The device holds its reset values */
+  bool cache_bulk_sync;        /* Sync runs of registers in one write */
+
+  CODE bool (*volatile_reg)(unsigned int reg);
+  FAR const struct regmap_default_s *reg_defaults;
+  unsigned int num_reg_defaults;
+#endif
+
   /* Prevent fragmentation */
 
   mutex_t mutex[0];
 };
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_REGMAP_CACHE
+int regcache_init(FAR struct regmap_s *map,
+                  FAR const struct regmap_config_s *config);
+void regcache_exit(FAR struct regmap_s *map);
+int regcache_read(FAR struct regmap_s *map, unsigned int reg,
+                  FAR unsigned int *val);
+int regcache_write(FAR struct regmap_s *map, unsigned int reg,
+                   unsigned int val, bool dirty);
+void regcache_drop(FAR struct regmap_s *map, unsigned int reg,
+                   unsigned int count);
+#endif
+
 #endif /* __DRIVERS_REGMAP_INTERNAL_H */
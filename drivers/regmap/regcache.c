@@ -0,0 +1,401 @@
+/****************************************************************************
+ * drivers/regmap/regcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/regmap/regmap.h>
+
+#include "internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define REGCACHE_TEST(map, b, i) (((map)->b[(i) >> 3] >> ((i) & 7)) & 1)
+#define REGCACHE_SET(map, b, i)  ((map)->b[(i) >> 3] |= 1 << ((i) & 7))
+#define REGCACHE_CLR(map, b, i)  ((map)->b[(i) >> 3] &= ~(1 << ((i) & 7)))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: regcache_index
+ *
+ * Description:
+ *   Return the index of a cached register, or -ENOENT if the register is
+ *   not cached.
+ *
+ ****************************************************************************/
+
+static int regcache_index(FAR struct regmap_s *map, unsigned int reg)
+{
+  unsigned int index = reg / map->reg_stride;
+
+  if (map->cache == NULL || index >= map->cache_nregs ||
+      (map->volatile_reg != NULL && map->volatile_reg(reg)))
+    {
+      return -ENOENT;
+    }
+
+  return index;
+}
+
+/****************************************************************************
+ * Name: regcache_is_default
+ ****************************************************************************/
+
+static bool regcache_is_default(FAR struct regmap_s *map, unsigned int reg,
+                                unsigned int val)
+{
+  unsigned int i;
+
+  for (i = 0; i < map->num_reg_defaults; i++)
+    {
+      if (map->reg_defaults[i].reg == reg)
+        {
+          return map->reg_defaults[i].def == val;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: regcache_needs_sync
+ ****************************************************************************/
+
+static bool regcache_needs_sync(FAR struct regmap_s *map, unsigned int i)
+{
+  return REGCACHE_TEST(map, cache_dirty, i) &&
+         !(map->cache_reset &&
+           regcache_is_default(map, i * map->reg_stride, map->cache[i]));
+}
+
+/****************************************************************************
+ * Name: regcache_put
+ *
+ * Description:
+ *   Store a value big endian, as the bus sends it.
+ *
+ ****************************************************************************/
+
+static void regcache_put(FAR uint8_t *buf, unsigned int val, int bytes)
+{
+  while (bytes-- > 0)
+    {
+      buf[bytes] = val & 0xff;
+      val >>= 8;
+    }
+}
+
+/****************************************************************************
+ * Name: regcache_sync_run
+ *
+ * Description:
+ *   Write 'count' registers from index 'first' in one bus transfer, or
+ *   one by one without a buffer.
+ *
+ ****************************************************************************/
+
+static int regcache_sync_run(FAR struct regmap_s *map, FAR uint8_t *buf,
+                             unsigned int first, unsigned int count)
+{
+  unsigned int i;
+  int ret = OK;
+
+  if (buf != NULL && count > 1)
+    {
+      regcache_put(buf, first * map->reg_stride, map->reg_bytes);
+      for (i = 0; i < count; i++)
+        {
+          regcache_put(buf + map->reg_bytes + i * map->val_bytes,
+                       map->cache[first + i], map->val_bytes);
+        }
+
+      return map->write(map->bus, buf,
+                        map->reg_bytes + count * map->val_bytes);
+    }
+
+  for (i = first; i < first + count && ret >= 0; i++)
+    {
+      ret = map->reg_write(map->bus, i * map->reg_stride, map->cache[i]);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: regcache_init
+ *
+ * Description:
+ *   Allocate the cache of a map and fill it with the defaults.
+ *
+ ****************************************************************************/
+
+int regcache_init(FAR struct regmap_s *map,
+                  FAR const struct regmap_config_s *config)
+{
+  unsigned int nbitmap;
+  unsigned int i;
+  int index;
+
+  if (config->cache_type == REGMAP_CACHE_NONE)
+    {
+      return OK;
+    }
+
+  if (config->cache_type != REGMAP_CACHE_FLAT)
+    {
+      return -EINVAL;
+    }
+
+  map->cache_nregs = config->max_register / map->reg_stride + 1;
+  nbitmap = (map->cache_nregs + 7) / 8;
+
+  /* One allocation for the values and both bitmaps */
+
+  map->cache = kmm_zalloc(map->cache_nregs * sizeof(*map->cache) +
+                          2 * nbitmap);
+  if (map->cache == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  map->cache_valid      = (FAR uint8_t *)(map->cache + map->cache_nregs);
+  map->cache_dirty      = map->cache_valid + nbitmap;
+  map->volatile_reg     = config->volatile_reg;
+  map->reg_defaults     = config->reg_defaults;
+  map->num_reg_defaults = config->num_reg_defaults;
+  map->cache_bulk_sync  = config->cache_bulk_sync &&
+                          map->write != NULL;
+
+  for (i = 0; i < map->num_reg_defaults; i++)
+    {
+      index = regcache_index(map, map->reg_defaults[i].reg);
+      if (index >= 0)
+        {
+          map->cache[index] = map->reg_defaults[i].def;
+          REGCACHE_SET(map, cache_valid, index);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: regcache_exit
+ ****************************************************************************/
+
+void regcache_exit(FAR struct regmap_s *map)
+{
+  kmm_free(map->cache);
+  map->cache = NULL;
+}
+
+/****************************************************************************
+ * Name: regcache_read
+ *
+ * Description:
+ *   Get a register from the cache, -ENOENT if it is not there.
+ *
+ ****************************************************************************/
+
+int regcache_read(FAR struct regmap_s *map, unsigned int reg,
+                  FAR unsigned int *val)
+{
+  int index = regcache_index(map, reg);
+
+  if (index < 0 || !REGCACHE_TEST(map, cache_valid, index))
+    {
+      return -ENOENT;
+    }
+
+  *val = map->cache[index];
+  return OK;
+}
+
+/****************************************************************************
+ * Name: regcache_write
+ *
+ * Description:
+ *   Store a register in the cache, -ENOENT if it is not cached.  'dirty'
+ *   is set if the value has not reached the device yet.
+ *
+ ****************************************************************************/
+
+int regcache_write(FAR struct regmap_s *map, unsigned int reg,
+                   unsigned int val, bool dirty)
+{
+  int index = regcache_index(map, reg);
+
+  if (index < 0)
+    {
+      return -ENOENT;
+    }
+
+  map->cache[index] = val;
+  REGCACHE_SET(map, cache_valid, index);
+  if (dirty)
+    {
+      REGCACHE_SET(map, cache_dirty, index);
+    }
+  else
+    {
+      REGCACHE_CLR(map, cache_dirty, index);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: regcache_drop
+ *
+ * Description:
+ *   Forget registers written or read in a format the cache can't parse.
+ *
+ ****************************************************************************/
+
+void regcache_drop(FAR struct regmap_s *map, unsigned int reg,
+                   unsigned int count)
+{
+  int index;
+
+  while (count-- > 0)
+    {
+      index = regcache_index(map, reg);
+      if (index >= 0)
+        {
+          REGCACHE_CLR(map, cache_valid, index);
+          REGCACHE_CLR(map, cache_dirty, index);
+        }
+
+      reg += map->reg_stride;
+    }
+}
+
+/****************************************************************************
+ * Name: regcache_cache_only
+ ****************************************************************************/
+
+void regcache_cache_only(FAR struct regmap_s *map, bool enable)
+{
+  map->lock(map);
+  map->cache_only = enable;
+  map->unlock(map);
+}
+
+/****************************************************************************
+ * Name: regcache_mark_dirty
+ ****************************************************************************/
+
+void regcache_mark_dirty(FAR struct regmap_s *map)
+{
+  unsigned int i;
+
+  map->lock(map);
+  if (map->cache != NULL)
+    {
+      for (i = 0; i < (map->cache_nregs + 7) / 8; i++)
+        {
+          map->cache_dirty[i] = map->cache_valid[i];
+        }
+
+      map->cache_reset = true;
+    }
+
+  map->unlock(map);
+}
+
+/****************************************************************************
+ * Name: regcache_sync
+ ****************************************************************************/
+
+int regcache_sync(FAR struct regmap_s *map)
+{
+  FAR uint8_t *buf = NULL;
+  unsigned int first;
+  unsigned int i;
+  int ret = OK;
+
+  map->lock(map);
+  if (map->cache == NULL || map->cache_only)
+    {
+      map->unlock(map);
+      return map->cache == NULL ? OK : -EBUSY;
+    }
+
+  /* Room for the longest run; one by one if there is none */
+
+  if (map->cache_bulk_sync)
+    {
+      buf = kmm_malloc(map->reg_bytes +
+                       CONFIG_REGMAP_CACHE_SYNC_MAX * map->val_bytes);
+    }
+
+  for (i = 0; i < map->cache_nregs && ret >= 0; )
+    {
+      if (!regcache_needs_sync(map, i))
+        {
+          REGCACHE_CLR(map, cache_dirty, i);
+          i++;
+          continue;
+        }
+
+      first = i++;
+      while (buf != NULL && i < map->cache_nregs &&
+             i - first < CONFIG_REGMAP_CACHE_SYNC_MAX &&
+             regcache_needs_sync(map, i))
+        {
+          i++;
+        }
+
+      ret = regcache_sync_run(map, buf, first, i - first);
+      while (ret >= 0 && first < i)
+        {
+          REGCACHE_CLR(map, cache_dirty, first);
+          first++;
+        }
+    }
+
+  if (ret >= 0)
+    {
+      map->cache_reset = false;
+    }
+
+  map->unlock(map);
+  kmm_free(buf);
+  return ret < 0 ? ret : OK;
+}
@@ -61,6 +61,72 @@ static void regmap_unlock_mutex(FAR void *context)
   nxmutex_unlock(&map->mutex[0]);
 }
 
+/****************************************************************************
+ * Name: regmap_read_nolock
+ *
+ * Description:
+ *   Read a register into an unsigned int, from the cache if possible.
+ *
+ ****************************************************************************/
+
+static int regmap_read_nolock(FAR struct regmap_s *map, unsigned int reg,
+                              FAR unsigned int *val)
+{
+  int ret;
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (regcache_read(map, reg, val) >= 0)
+    {
+      return OK;
+    }
+
+  if (map->cache_only)
+    {
+      return -EBUSY;
+    }
+#endif
+
+  *val = 0;
+  ret = map->reg_read(map->bus, reg, val);
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (ret >= 0)
+    {
+      regcache_write(map, reg, *val, false);
+    }
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: regmap_write_nolock
+ ****************************************************************************/
+
+static int regmap_write_nolock(FAR struct regmap_s *map, unsigned int reg,
+                               unsigned int val)
+{
+  int ret;
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (map->cache_only)
+    {
+      return regcache_write(map, reg, val, true) < 0 ? -EBUSY : OK;
+    }
+#endif
+
+  ret = map->reg_write(map->bus, reg, val);
+
+#ifdef CONFIG_REGMAP_CACHE
+  if (ret >= 0)
+    {
+      regcache_write(map, reg, val, false);
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -140,6 +206,19 @@ FAR struct regmap_s *regmap_init(FAR struct regmap_bus_s *bus,
   map->read  = bus->read;
   map->write = bus->write;
 
+#ifdef CONFIG_REGMAP_CACHE
+  if (regcache_init(map, config) < 0)
+    {
+      if (!config->disable_locking)
+        {
+          nxmutex_destroy(&map->mutex[0]);
+        }
+
+      kmm_free(map);
+      return NULL;
+    }
+#endif
+
   return map;
 }
 
@@ -173,7 +252,7 @@ int regmap_write(FAR struct regmap_s *map, unsigned int reg,
 
   map->lock(map);
 
-  ret = map->reg_write(map->bus, reg, val);
+  ret = regmap_write_nolock(map, reg, val);
 
   map->unlock(map);
 
@@ -216,6 +295,18 @@ int regmap_bulk_write(FAR struct regmap_s *map, unsigned int reg,
   map->lock(map);
   if (map->write != NULL)
     {
+#ifdef CONFIG_REGMAP_CACHE
+      /* The raw data can't go to the cache, nor be deferred */
+
+      if (map->cache_only)
+        {
+          ret = -EBUSY;
+          goto out;
+        }
+
+      regcache_drop(map, reg, val_count);
+#endif
+
       ret = map->write(map->bus, val, val_bytes * val_count);
       goto out;
     }
@@ -239,7 +330,7 @@ int regmap_bulk_write(FAR struct regmap_s *map, unsigned int reg,
             goto out;
         }
 
-      ret = map->reg_write(map->bus, reg + (i * map->reg_stride), ival);
+      ret = regmap_write_nolock(map, reg + (i * map->reg_stride), ival);
       if (ret < 0)
         {
           break;
@@ -275,12 +366,42 @@ out:
 int regmap_read(FAR struct regmap_s *map, unsigned int reg, FAR void *val)
 {
   int ret;
+#ifdef CONFIG_REGMAP_CACHE
+  unsigned int ival;
+#endif
 
   DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
 
   map->lock(map);
 
-  ret = map->reg_read(map->bus, reg, val);
+#ifdef CONFIG_REGMAP_CACHE
+  if (map->cache != NULL)
+    {
+      ret = regmap_read_nolock(map, reg, &ival);
+      if (ret >= 0)
+        {
+          switch (map->val_bytes)
+            {
+              case 4:
+                *(FAR uint32_t *)val = ival;
+                break;
+              case 2:
+                *(FAR uint16_t *)val = ival;
+                break;
+              case 1:
+                *(FAR uint8_t *)val = ival;
+                break;
+              default:
+                ret = -EINVAL;
+                break;
+            }
+        }
+    }
+  else
+#endif
+    {
+      ret = map->reg_read(map->bus, reg, val);
+    }
 
   map->unlock(map);
   return ret;
@@ -322,6 +443,14 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
 
   map->lock(map);
 
+#ifdef CONFIG_REGMAP_CACHE
+  if (map->cache_only && map->read != NULL)
+    {
+      map->unlock(map);
+      return -EBUSY;
+    }
+#endif
+
   if (map->read != NULL)
     {
       ret = map->read(map->bus, &reg, map->reg_bytes, val, val_count);
@@ -330,7 +459,7 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
     {
       for (i = 0; i < val_count; i++)
         {
-          ret = map->reg_read(map->bus, reg + (i * map->reg_stride), &ival);
+          ret = regmap_read_nolock(map, reg + (i * map->reg_stride), &ival);
           if (ret < 0)
             {
               break;
@@ -359,6 +488,47 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write of the bits of 'mask' in a register.  The register is
+ *   only written if its value changes; with a cache it is only read from
+ *   the bus the first time.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - the bits to update.
+ *   val  - the new value of the bits.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val)
+{
+  unsigned int orig;
+  unsigned int tmp;
+  int ret;
+
+  DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
+
+  map->lock(map);
+
+  ret = regmap_read_nolock(map, reg, &orig);
+  if (ret >= 0)
+    {
+      tmp = (orig & ~mask) | (val & mask);
+      ret = tmp != orig ? regmap_write_nolock(map, reg, tmp) : OK;
+    }
+
+  map->unlock(map);
+  return ret < 0 ? ret : OK;
+}
+
 /****************************************************************************
  * Name: regmap_exit
  *
@@ -379,6 +549,10 @@ void regmap_exit(FAR struct regmap_s *map)
       nxmutex_destroy(&map->mutex[0]);
     }
 
+#ifdef CONFIG_REGMAP_CACHE
+  regcache_exit(map);
+#endif
+
   if (map->bus->exit != NULL)
     {
       map->bus->exit(map->bus);
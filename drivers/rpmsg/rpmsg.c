@@ -192,6 +192,90 @@ int rpmsg_post(FAR struct rpmsg_endpoint *ept, FAR sem_t *sem)
   return rpmsg->ops->post(rpmsg, sem);
 }
 
+/* Between rpmsg_batch_begin() and rpmsg_batch_end() the transport only
+ * queues the sent messages, the remote is notified once when the last
+ * open batch of the device ends.  Transports without a kick op notify
+ * for each message as before.
+ */
+
+int rpmsg_batch_begin(FAR struct rpmsg_endpoint *ept)
+{
+  FAR struct rpmsg_s *rpmsg;
+
+  if (!ept)
+    {
+      return -EINVAL;
+    }
+
+  rpmsg = rpmsg_get_by_rdev(ept->rdev);
+  if (!rpmsg)
+    {
+      return -EINVAL;
+    }
+
+  atomic_fetch_add(&rpmsg->batch, 1);
+  return OK;
+}
+
+int rpmsg_batch_end(FAR struct rpmsg_endpoint *ept)
+{
+  FAR struct rpmsg_s *rpmsg;
+
+  if (!ept)
+    {
+      return -EINVAL;
+    }
+
+  rpmsg = rpmsg_get_by_rdev(ept->rdev);
+  if (!rpmsg)
+    {
+      return -EINVAL;
+    }
+
+  if (atomic_fetch_sub(&rpmsg->batch, 1) == 1)
+    {
+      rpmsg_batch_flush(rpmsg);
+    }
+
+  return OK;
+}
+
+/* Called by the transport instead of notifying the remote, returns true
+ * if the notification is left to the end of the open batch.
+ */
+
+bool rpmsg_batch_defer(FAR struct rpmsg_s *rpmsg)
+{
+  if (atomic_read(&rpmsg->batch) == 0)
+    {
+      return false;
+    }
+
+  /* Mark before checking again, so either the batch end or this caller
+   * sees the mark after the last batch ended.
+   */
+
+  atomic_set(&rpmsg->batched, 1);
+  if (atomic_read(&rpmsg->batch) > 0)
+    {
+      return true;
+    }
+
+  return !atomic_xchg(&rpmsg->batched, 0);
+}
+
+/* Send the deferred notification now, the transport calls it before it
+ * waits for the remote to free buffers.
+ */
+
+void rpmsg_batch_flush(FAR struct rpmsg_s *rpmsg)
+{
+  if (rpmsg->ops->kick && atomic_xchg(&rpmsg->batched, 0))
+    {
+      rpmsg->ops->kick(rpmsg);
+    }
+}
+
 FAR const char *rpmsg_get_local_cpuname(FAR struct rpmsg_device *rdev)
 {
   FAR struct rpmsg_s *rpmsg = rpmsg_get_by_rdev(rdev);
@@ -527,6 +611,8 @@ int rpmsg_register(FAR const char *path, FAR struct rpmsg_s *rpmsg,
 
   metal_list_init(&rpmsg->bind);
   nxrmutex_init(&rpmsg->lock);
+  atomic_set(&rpmsg->batch, 0);
+  atomic_set(&rpmsg->batched, 0);
   rpmsg->ops = ops;
 
   /* Add priv to list */
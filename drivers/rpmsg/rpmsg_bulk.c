@@ -0,0 +1,291 @@
+/****************************************************************************
+ * drivers/rpmsg/rpmsg_bulk.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <metal/cache.h>
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/rpmsg/rpmsg_bulk.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The first line of an allocation holds its header, the data follows */
+
+#define RPMSG_BULK_HDRSIZE     CONFIG_RPMSG_BULK_ALIGN
+
+#ifdef CONFIG_OPENAMP_CACHE
+#  define RPMSG_BULK_FLUSH(x,s)      metal_cache_flush(x, s)
+#  define RPMSG_BULK_INVALIDATE(x,s) metal_cache_invalidate(x, s)
+#else
+#  define RPMSG_BULK_FLUSH(x,s)
+#  define RPMSG_BULK_INVALIDATE(x,s)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Header of an allocation.  The owner clears 'freed' when it hands the
+ * space out, the peer sets it when done, so each side only writes one
+ * transition and no cross-core atomics are needed.
+ */
+
+struct rpmsg_bulk_hdr_s
+{
+  volatile uint32_t freed;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rpmsg_bulk_block
+ ****************************************************************************/
+
+static inline FAR struct rpmsg_bulk_hdr_s *
+rpmsg_bulk_block(FAR struct rpmsg_bulk_s *bulk, uint8_t half, uint32_t i)
+{
+  return (FAR struct rpmsg_bulk_hdr_s *)
+    (bulk->base + (half * bulk->nblks + i) * bulk->blksize);
+}
+
+/****************************************************************************
+ * Name: rpmsg_bulk_check
+ *
+ * Description:
+ *   Validate a handle; return its half and first block, or -EINVAL.
+ *
+ ****************************************************************************/
+
+static int rpmsg_bulk_check(FAR struct rpmsg_bulk_s *bulk,
+                            FAR const struct rpmsg_bulk_handle_s *handle,
+                            FAR uint8_t *half)
+{
+  uint32_t halfsize = bulk->nblks * bulk->blksize;
+  uint32_t offset = handle->offset;
+
+  *half = offset / halfsize;
+  if (*half > 1 || offset % bulk->blksize != RPMSG_BULK_HDRSIZE ||
+      handle->len > (*half + 1) * halfsize - offset)
+    {
+      return -EINVAL;
+    }
+
+  return (offset - *half * halfsize) / bulk->blksize;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rpmsg_bulk_initialize
+ ****************************************************************************/
+
+int rpmsg_bulk_initialize(FAR struct rpmsg_bulk_s *bulk, FAR void *base,
+                          size_t size, uint32_t blksize, bool master)
+{
+  if (bulk == NULL || base == NULL || blksize <= RPMSG_BULK_HDRSIZE ||
+      blksize % CONFIG_RPMSG_BULK_ALIGN != 0 ||
+      (uintptr_t)base % CONFIG_RPMSG_BULK_ALIGN != 0 ||
+      size > UINT32_MAX)
+    {
+      return -EINVAL;
+    }
+
+  memset(bulk, 0, sizeof(*bulk));
+  bulk->base    = base;
+  bulk->blksize = blksize;
+  bulk->nblks   = MIN(size / 2 / blksize, UINT16_MAX);
+  bulk->local   = master ? 0 : 1;
+  if (bulk->nblks == 0)
+    {
+      return -EINVAL;
+    }
+
+  bulk->used = kmm_zalloc(bulk->nblks * sizeof(*bulk->used));
+  if (bulk->used == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  spin_lock_init(&bulk->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rpmsg_bulk_uninitialize
+ ****************************************************************************/
+
+void rpmsg_bulk_uninitialize(FAR struct rpmsg_bulk_s *bulk)
+{
+  kmm_free(bulk->used);
+  bulk->used = NULL;
+}
+
+/****************************************************************************
+ * Name: rpmsg_bulk_alloc
+ ****************************************************************************/
+
+FAR void *rpmsg_bulk_alloc(FAR struct rpmsg_bulk_s *bulk, uint32_t len,
+                           FAR struct rpmsg_bulk_handle_s *handle)
+{
+  FAR struct rpmsg_bulk_hdr_s *hdr;
+  irqstate_t flags;
+  uint32_t need;
+  uint32_t run = 0;
+  uint32_t i = 0;
+
+  need = ((uint64_t)len + RPMSG_BULK_HDRSIZE + bulk->blksize - 1) /
+         bulk->blksize;
+  if (len == 0 || need > bulk->nblks)
+    {
+      return NULL;
+    }
+
+  /* First fit, the allocations freed by the peer meanwhile are reaped on
+   * the way.
+   */
+
+  flags = spin_lock_irqsave(&bulk->lock);
+  while (i < bulk->nblks)
+    {
+      if (bulk->used[i] != 0)
+        {
+          hdr = rpmsg_bulk_block(bulk, bulk->local, i);
+          RPMSG_BULK_INVALIDATE(hdr, sizeof(*hdr));
+          if (hdr->freed)
+            {
+              bulk->used[i] = 0;
+              continue;
+            }
+
+          i  += bulk->used[i];
+          run = 0;
+        }
+      else if (++run == need)
+        {
+          break;
+        }
+      else
+        {
+          i++;
+        }
+    }
+
+  if (run < need)
+    {
+      spin_unlock_irqrestore(&bulk->lock, flags);
+      return NULL;
+    }
+
+  /* Clear the mark of the last use before the lock is released, or it
+   * would be reaped again by the next allocation.
+   */
+
+  i   = i + 1 - need;
+  hdr = rpmsg_bulk_block(bulk, bulk->local, i);
+  hdr->freed = 0;
+  RPMSG_BULK_FLUSH(hdr, sizeof(*hdr));
+  bulk->used[i] = need;
+  spin_unlock_irqrestore(&bulk->lock, flags);
+
+  handle->offset = (FAR uint8_t *)hdr - bulk->base + RPMSG_BULK_HDRSIZE;
+  handle->len    = len;
+  return (FAR uint8_t *)hdr + RPMSG_BULK_HDRSIZE;
+}
+
+/****************************************************************************
+ * Name: rpmsg_bulk_commit
+ ****************************************************************************/
+
+void rpmsg_bulk_commit(FAR struct rpmsg_bulk_s *bulk,
+                       FAR const struct rpmsg_bulk_handle_s *handle)
+{
+  RPMSG_BULK_FLUSH(bulk->base + handle->offset, handle->len);
+  UP_DMB();
+}
+
+/****************************************************************************
+ * Name: rpmsg_bulk_map
+ ****************************************************************************/
+
+FAR void *rpmsg_bulk_map(FAR struct rpmsg_bulk_s *bulk,
+                         FAR const struct rpmsg_bulk_handle_s *handle)
+{
+  uint8_t half;
+
+  if (rpmsg_bulk_check(bulk, handle, &half) < 0 || half == bulk->local)
+    {
+      return NULL;
+    }
+
+  RPMSG_BULK_INVALIDATE(bulk->base + handle->offset, handle->len);
+  return bulk->base + handle->offset;
+}
+
+/****************************************************************************
+ * Name: rpmsg_bulk_free
+ ****************************************************************************/
+
+void rpmsg_bulk_free(FAR struct rpmsg_bulk_s *bulk,
+                     FAR const struct rpmsg_bulk_handle_s *handle)
+{
+  FAR struct rpmsg_bulk_hdr_s *hdr;
+  irqstate_t flags;
+  uint8_t half;
+  int blk;
+
+  blk = rpmsg_bulk_check(bulk, handle, &half);
+  if (blk < 0)
+    {
+      return;
+    }
+
+  if (half == bulk->local)
+    {
+      flags = spin_lock_irqsave(&bulk->lock);
+      bulk->used[blk] = 0;
+      spin_unlock_irqrestore(&bulk->lock, flags);
+      return;
+    }
+
+  /* Hand the space back, after all reads of the data are done */
+
+  UP_DMB();
+  hdr = rpmsg_bulk_block(bulk, half, blk);
+  hdr->freed = 1;
+  RPMSG_BULK_FLUSH(hdr, sizeof(*hdr));
+}
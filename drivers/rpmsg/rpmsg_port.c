@@ -52,6 +52,7 @@ rpmsg_port_get_local_cpuname(FAR struct rpmsg_s *rpmsg);
 static FAR const char *rpmsg_port_get_cpuname(FAR struct rpmsg_s *rpmsg);
 static void rpmsg_port_dump(FAR struct rpmsg_s *rpmsg);
 static int rpmsg_port_get_signals(FAR struct rpmsg_s *rpmsg);
+static void rpmsg_port_kick(FAR struct rpmsg_s *rpmsg);
 
 /****************************************************************************
  * Private Data
@@ -67,6 +68,7 @@ static const struct rpmsg_ops_s g_rpmsg_port_ops =
   rpmsg_port_get_local_cpuname,
   rpmsg_port_get_cpuname,
   rpmsg_port_get_signals,
+  rpmsg_port_kick,
 };
 
 /****************************************************************************
@@ -248,7 +250,15 @@ rpmsg_port_get_tx_payload_buffer(FAR struct rpmsg_device *rdev,
   FAR struct rpmsg_port_s *port =
     metal_container_of(rdev, struct rpmsg_port_s, rdev);
   FAR struct rpmsg_port_header_s *hdr =
-    rpmsg_port_queue_get_available_buffer(&port->txq, wait);
+    rpmsg_port_queue_get_available_buffer(&port->txq, false);
+
+  if (hdr == NULL && wait)
+    {
+      /* The buffers may only come back once a batch is sent */
+
+      rpmsg_batch_flush(&port->rpmsg);
+      hdr = rpmsg_port_queue_get_available_buffer(&port->txq, true);
+    }
 
   if (hdr == NULL)
     {
@@ -285,10 +295,13 @@ static int rpmsg_port_send_offchannel_nocopy(FAR struct rpmsg_device *rdev,
   hdr->len = sizeof(struct rpmsg_port_header_s) +
              sizeof(struct rpmsg_hdr) + len;
 
-  rpmsg_port_queue_add_buffer(&port->txq, hdr);
-  if (port->ops->notify_tx_ready)
+  /* Queue the buffer, the driver is woken up now or at the batch end */
+
+  rpmsg_port_add_node(&port->txq.ready,
+                      RPMSG_PORT_BUF_TO_NODE(&port->txq, hdr));
+  if (!rpmsg_batch_defer(&port->rpmsg))
     {
-      port->ops->notify_tx_ready(port);
+      rpmsg_port_kick(&port->rpmsg);
     }
 
   return len;
@@ -577,6 +590,25 @@ static int rpmsg_port_get_signals(FAR struct rpmsg_s *rpmsg)
   return atomic_read(&port->signals);
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_kick
+ *
+ * Description:
+ *   Wake up the driver for all buffers queued in the tx queue.
+ *
+ ****************************************************************************/
+
+static void rpmsg_port_kick(FAR struct rpmsg_s *rpmsg)
+{
+  FAR struct rpmsg_port_s *port = (FAR struct rpmsg_port_s *)rpmsg;
+
+  rpmsg_port_post(&port->txq.ready.sem);
+  if (port->ops->notify_tx_ready)
+    {
+      port->ops->notify_tx_ready(port);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -722,6 +754,95 @@ void rpmsg_port_queue_add_buffer(FAR struct rpmsg_port_queue_s *queue,
   rpmsg_port_post(&queue->ready.sem);
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_queue_pack
+ ****************************************************************************/
+
+uint16_t rpmsg_port_queue_pack(FAR struct rpmsg_port_queue_s *queue,
+                               FAR struct rpmsg_port_header_s *dst,
+                               uint16_t max)
+{
+  FAR struct rpmsg_port_header_s *hdr;
+  FAR struct list_node *node;
+  irqstate_t flags;
+  uint16_t len = sizeof(*dst);
+  uint16_t num;
+
+  for (num = 0; num < max; num++)
+    {
+      /* Only the caller removes buffers from the ready list, so the head
+       * is still the same one when it is removed below.
+       */
+
+      flags = spin_lock_irqsave(&queue->ready.lock);
+      node = list_peek_head(&queue->ready.head);
+      spin_unlock_irqrestore(&queue->ready.lock, flags);
+      if (node == NULL)
+        {
+          break;
+        }
+
+      hdr = RPMSG_PORT_NODE_TO_BUF(queue, node);
+      if (len + hdr->len > queue->len)
+        {
+          break;
+        }
+
+      rpmsg_port_remove_node(&queue->ready);
+      memcpy((FAR uint8_t *)dst + len, hdr, hdr->len);
+      len += hdr->len;
+      rpmsg_port_queue_return_buffer(queue, hdr);
+    }
+
+  dst->len = len;
+  return num;
+}
+
+/****************************************************************************
+ * Name: rpmsg_port_queue_unpack
+ ****************************************************************************/
+
+int rpmsg_port_queue_unpack(FAR struct rpmsg_port_queue_s *queue,
+                            FAR const struct rpmsg_port_header_s *src,
+                            uint16_t cmd)
+{
+  FAR const struct rpmsg_port_header_s *hdr;
+  FAR struct rpmsg_port_header_s *dst;
+  uint16_t off = sizeof(*src);
+  int num = 0;
+
+  if (src->len > queue->len)
+    {
+      return -EINVAL;
+    }
+
+  while (off + sizeof(*hdr) <= src->len)
+    {
+      hdr = (FAR const struct rpmsg_port_header_s *)
+            ((FAR const uint8_t *)src + off);
+      if (hdr->len < sizeof(*hdr) + sizeof(struct rpmsg_hdr) ||
+          hdr->len > src->len - off)
+        {
+          return -EINVAL;
+        }
+
+      dst = rpmsg_port_queue_get_available_buffer(queue, false);
+      if (dst == NULL)
+        {
+          return -ENOBUFS;
+        }
+
+      memcpy(dst, hdr, hdr->len);
+      dst->cmd = cmd;
+      rpmsg_port_queue_add_buffer(queue, dst);
+
+      off += hdr->len;
+      num++;
+    }
+
+  return num;
+}
+
 /****************************************************************************
  * Name: rpmsg_port_drop_packets
  ****************************************************************************/
@@ -272,6 +272,51 @@ uint16_t rpmsg_port_queue_nused(FAR struct rpmsg_port_queue_s *queue)
   return atomic_read(&queue->ready.num);
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_queue_pack
+ *
+ * Description:
+ *   Copy buffers of the ready list of the queue, in order, into a single
+ *   frame for one transfer.  Each copy keeps its own header; 'dst->len'
+ *   is set to the length of the whole frame.  Only the one consumer of
+ *   the ready list may call this.
+ *
+ * Input Parameters:
+ *   queue - The queue whose ready buffers are packed and then freed.
+ *   dst   - The frame to pack into, of the queue's buffer length.
+ *   max   - The maximum number of buffers to pack.
+ *
+ * Returned Value:
+ *   The number of buffers packed, zero if the first one does not fit.
+ *
+ ****************************************************************************/
+
+uint16_t rpmsg_port_queue_pack(FAR struct rpmsg_port_queue_s *queue,
+                               FAR struct rpmsg_port_header_s *dst,
+                               uint16_t max);
+
+/****************************************************************************
+ * Name: rpmsg_port_queue_unpack
+ *
+ * Description:
+ *   Copy the buffers of a frame made by rpmsg_port_queue_pack() into free
+ *   buffers of the queue and add them to its ready list.
+ *
+ * Input Parameters:
+ *   queue - The queue to add the buffers to.
+ *   src   - The packed frame.
+ *   cmd   - The command to set in the header of each buffer.
+ *
+ * Returned Value:
+ *   The number of buffers added, or a negated errno value if the frame is
+ *   malformed or the queue ran out of free buffers.
+ *
+ ****************************************************************************/
+
+int rpmsg_port_queue_unpack(FAR struct rpmsg_port_queue_s *queue,
+                            FAR const struct rpmsg_port_header_s *src,
+                            uint16_t cmd);
+
 /****************************************************************************
  * Name: rpmsg_port_drop_packets
  ****************************************************************************/
@@ -51,6 +51,12 @@
 
 #define BYTES2WORDS(s,b)            ((b) / ((s)->nbits >> 3))
 
+/* Sent after the cpu name of the connect frame by peers that can receive
+ * several frames packed into one transfer.
+ */
+
+#define RPMSG_PORT_SPI_CAP_PACKED   0x4b434150 /* "PACK" */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -63,6 +69,7 @@ enum rpmsg_port_spi_cmd_e
   RPMSG_PORT_SPI_CMD_SUSPEND,
   RPMSG_PORT_SPI_CMD_RESUME,
   RPMSG_PORT_SPI_CMD_SHUTDOWN,
+  RPMSG_PORT_SPI_CMD_PACKED,
 };
 
 enum rpmsg_port_spi_state_e
@@ -110,6 +117,11 @@ struct rpmsg_port_spi_s
   uint16_t                       rxavail;
   uint16_t                       rxthres;
 
+  /* Frame packing, see rpmsg_port_queue_pack() */
+
+  bool                           packed;    /* The peer can unpack */
+  uint16_t                       txpacked;  /* Frames of this transfer */
+
   atomic_t                       transferring;
 };
 
@@ -209,25 +221,50 @@ static void rpmsg_port_spi_exchange(FAR struct rpmsg_port_spi_s *rpspi)
       return;
     }
 
+  rpspi->txpacked = 0;
   if (rpspi->state == RPMSG_PORT_SPI_STATE_UNCONNECTED)
     {
+      uint32_t caps = RPMSG_PORT_SPI_CAP_PACKED;
+
       txhdr = rpspi->cmdhdr;
       txhdr->cmd = RPMSG_PORT_SPI_CMD_CONNECT;
+      txhdr->len = rpspi->port.txq.len;
       strlcpy((FAR char *)(txhdr + 1), rpspi->port.cpuname, RPMSG_NAME_SIZE);
+      memcpy((FAR char *)(txhdr + 1) + RPMSG_NAME_SIZE, &caps, sizeof(caps));
     }
   else if (rpspi->txavail > 0 &&
            rpmsg_port_queue_nused(&rpspi->port.txq) > 0)
     {
-      txhdr = rpmsg_port_queue_get_buffer(&rpspi->port.txq, false);
-      DEBUGASSERT(txhdr != NULL);
+      /* With several frames waiting and room for them at the peer, send
+       * as many as fit in one transfer instead of one per transfer.
+       */
 
-      txhdr->cmd = RPMSG_PORT_SPI_CMD_DATA;
-      rpspi->txhdr = txhdr;
+      txhdr = rpspi->cmdhdr;
+      if (rpspi->packed && rpspi->txavail > 1 &&
+          rpmsg_port_queue_nused(&rpspi->port.txq) > 1)
+        {
+          rpspi->txpacked = rpmsg_port_queue_pack(&rpspi->port.txq, txhdr,
+                                                  rpspi->txavail);
+        }
+
+      if (rpspi->txpacked > 0)
+        {
+          txhdr->cmd = RPMSG_PORT_SPI_CMD_PACKED;
+        }
+      else
+        {
+          txhdr = rpmsg_port_queue_get_buffer(&rpspi->port.txq, false);
+          DEBUGASSERT(txhdr != NULL);
+
+          txhdr->cmd = RPMSG_PORT_SPI_CMD_DATA;
+          rpspi->txhdr = txhdr;
+        }
     }
   else
     {
       txhdr = rpspi->cmdhdr;
       txhdr->cmd = RPMSG_PORT_SPI_CMD_AVAIL;
+      txhdr->len = rpspi->port.txq.len;
     }
 
   txhdr->avail = rpmsg_port_queue_navail(&rpspi->port.rxq);
@@ -238,7 +275,7 @@ static void rpmsg_port_spi_exchange(FAR struct rpmsg_port_spi_s *rpspi)
 
   SPI_SELECT(rpspi->spi, rpspi->devid, true);
   SPI_EXCHANGE(rpspi->spi, txhdr, rpspi->rxhdr,
-               BYTES2WORDS(rpspi, rpspi->cmdhdr->len));
+               BYTES2WORDS(rpspi, rpspi->port.txq.len));
 
   rpspi->rxavail = txhdr->avail;
 }
@@ -282,17 +319,30 @@ static void rpmsg_port_spi_complete_handler(FAR void *arg)
   flags = spin_lock_irqsave(&rpspi->lock);
   if (rpspi->state == RPMSG_PORT_SPI_STATE_UNCONNECTED)
     {
+      uint32_t caps;
+
       if (rpspi->rxhdr->cmd != RPMSG_PORT_SPI_CMD_CONNECT)
         {
           goto unlock;
         }
 
+      memcpy(&caps, (FAR char *)(rpspi->rxhdr + 1) + RPMSG_NAME_SIZE,
+             sizeof(caps));
+      rpspi->packed  = caps == RPMSG_PORT_SPI_CAP_PACKED;
       rpspi->txavail = rpspi->rxhdr->avail;
-      rpspi->state = RPMSG_PORT_SPI_STATE_CONNECTING;
+      rpspi->state   = RPMSG_PORT_SPI_STATE_CONNECTING;
     }
   else if (rpspi->state == RPMSG_PORT_SPI_STATE_CONNECTED)
     {
+      /* The peer counted one frame of this transfer in its reserve */
+
       rpspi->txavail = rpspi->rxhdr->avail;
+      if (rpspi->txpacked > 1)
+        {
+          rpspi->txavail = rpspi->txavail >= rpspi->txpacked - 1 ?
+                           rpspi->txavail - (rpspi->txpacked - 1) : 0;
+        }
+
       if (rpspi->rxhdr->cmd == RPMSG_PORT_SPI_CMD_CONNECT)
         {
           rpspi->state = RPMSG_PORT_SPI_STATE_RECONNECTING;
@@ -327,6 +377,16 @@ static void rpmsg_port_spi_complete_handler(FAR void *arg)
     {
       atomic_fetch_or(&rpspi->port.signals, RPMSG_SIGNAL_RUNNING);
     }
+  else if (rpspi->rxhdr->cmd == RPMSG_PORT_SPI_CMD_PACKED)
+    {
+      /* Keep the receive buffer, its frames are copied to the rxq */
+
+      if (rpmsg_port_queue_unpack(&rpspi->port.rxq, rpspi->rxhdr,
+                                  RPMSG_PORT_SPI_CMD_DATA) < 0)
+        {
+          rpmsgerr("dropped frames of a packed transfer\n");
+        }
+    }
   else if (rpspi->rxhdr->cmd != RPMSG_PORT_SPI_CMD_AVAIL)
     {
       if (rpspi->rxhdr->cmd == RPMSG_PORT_SPI_CMD_SHUTDOWN)
@@ -103,6 +103,8 @@ rpmsg_virtio_lite_get_features_(FAR struct virtio_device *dev);
 static void rpmsg_virtio_lite_set_features(FAR struct virtio_device *dev,
                                            uint64_t feature);
 static void rpmsg_virtio_lite_notify(FAR struct virtqueue *vq);
+static void rpmsg_virtio_lite_notify_vq(FAR struct virtqueue *vq);
+static void rpmsg_virtio_lite_kick(FAR struct rpmsg_s *rpmsg);
 
 /****************************************************************************
  * Private Data
@@ -116,6 +118,7 @@ static const struct rpmsg_ops_s g_rpmsg_virtio_lite_ops =
   .dump               = rpmsg_virtio_lite_dump,
   .get_local_cpuname  = rpmsg_virtio_lite_get_local_cpuname,
   .get_cpuname        = rpmsg_virtio_lite_get_cpuname,
+  .kick               = rpmsg_virtio_lite_kick,
 };
 
 static const struct virtio_dispatch g_rpmsg_virtio_lite_dispatch =
@@ -125,7 +128,7 @@ static const struct virtio_dispatch g_rpmsg_virtio_lite_dispatch =
   .set_status        = rpmsg_virtio_lite_set_status_,
   .get_features      = rpmsg_virtio_lite_get_features_,
   .set_features      = rpmsg_virtio_lite_set_features,
-  .notify            = rpmsg_virtio_lite_notify,
+  .notify            = rpmsg_virtio_lite_notify_vq,
 };
 
 /****************************************************************************
@@ -359,6 +362,27 @@ static void rpmsg_virtio_lite_notify(FAR struct virtqueue *vq)
   RPMSG_VIRTIO_LITE_NOTIFY(priv->dev, vdev->vrings_info->notifyid);
 }
 
+static void rpmsg_virtio_lite_notify_vq(FAR struct virtqueue *vq)
+{
+  FAR struct rpmsg_virtio_lite_priv_s *priv =
+    rpmsg_virtio_lite_get_priv(vq->vq_dev);
+
+  /* All virtqueues share one notification, defer it in a batch */
+
+  if (!rpmsg_batch_defer(&priv->rpmsg))
+    {
+      rpmsg_virtio_lite_notify(vq);
+    }
+}
+
+static void rpmsg_virtio_lite_kick(FAR struct rpmsg_s *rpmsg)
+{
+  FAR struct rpmsg_virtio_lite_priv_s *priv =
+    (FAR struct rpmsg_virtio_lite_priv_s *)rpmsg;
+
+  rpmsg_virtio_lite_notify(priv->rvdev.svq);
+}
+
 static bool
 rpmsg_virtio_lite_is_recursive(FAR struct rpmsg_virtio_lite_priv_s *priv)
 {
@@ -632,6 +656,10 @@ static int rpmsg_virtio_lite_notify_wait(FAR struct rpmsg_device *rdev,
   FAR struct rpmsg_virtio_lite_priv_s *priv =
     metal_container_of(rdev, struct rpmsg_virtio_lite_priv_s, rvdev.rdev);
 
+  /* The remote frees no buffer before it is told about the batch */
+
+  rpmsg_batch_flush(&priv->rpmsg);
+
   if (!rpmsg_virtio_lite_is_recursive(priv))
     {
       return RPMSG_EOPNOTSUPP;
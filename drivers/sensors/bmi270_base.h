@@ -206,6 +206,29 @@
 #define GYRO_RANGE_250          (0x03)
 #define GYRO_RANGE_125          (0x04)
 
+/* Register 0x48 - FIFO_CONFIG_0 */
+
+#define FIFO_STOP_ON_FULL       (1 << 0)
+#define FIFO_TIME_EN            (1 << 1)
+
+/* Register 0x49 - FIFO_CONFIG_1 */
+
+#define FIFO_HEADER_EN          (1 << 4)
+#define FIFO_AUX_EN             (1 << 5)
+#define FIFO_ACC_EN             (1 << 6)
+#define FIFO_GYR_EN             (1 << 7)
+
+/* Register 0x25 - FIFO_LENGTH_1 */
+
+#define FIFO_LENGTH_1_MASK      (0x3f)
+
+/* FIFO size, and size of a headerless frame of gyro and accel data, which
+ * holds the gyro data first.
+ */
+
+#define BMI270_FIFO_SIZE        (2048)
+#define BMI270_FIFO_FRAME       (12)
+
 /* Register 0x7d - PWR_CONF */
 
 #define PWRCONF_APS_ON          (1 << 0)
@@ -221,6 +244,7 @@
 
 /* Register 0x7e - CMD */
 
+#define CMD_FIFO_FLUSH          (0xB0)
 #define CMD_SOFTRESET           (0xB6)
 
 /****************************************************************************
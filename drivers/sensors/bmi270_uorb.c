@@ -51,6 +51,16 @@
 
 #define CONSTANTS_ONE_G 9.8f
 
+#ifdef CONFIG_SENSORS_BMI270_POLL
+/* The sample period set by bmi270_set_normal_imu() */
+
+#  define BMI270_ODR_INTERVAL 10000
+
+/* Frames read from the FIFO and pushed at once */
+
+#  define BMI270_FIFO_CHUNK   4
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -71,6 +81,7 @@ struct bmi270_sensor_s
   bool                       enabled;
 #ifdef CONFIG_SENSORS_BMI270_POLL
   uint32_t                   interval;
+  uint32_t                   latency;
 #endif
   struct bmi270_dev_s        base;
 };
@@ -81,6 +92,7 @@ struct bmi270_sensor_dev_s
   mutex_t                lock;
 #ifdef CONFIG_SENSORS_BMI270_POLL
   sem_t                  run;
+  bool                   fifo;
 #endif
 };
 
@@ -96,7 +108,11 @@ static int bmi270_activate(FAR struct sensor_lowerhalf_s *lower,
 static int bmi270_set_interval(FAR struct sensor_lowerhalf_s *lower,
                                FAR struct file *filep,
                                FAR uint32_t *period_us);
-#ifndef CONFIG_SENSORS_BMI270_POLL
+#ifdef CONFIG_SENSORS_BMI270_POLL
+static int bmi270_batch(FAR struct sensor_lowerhalf_s *lower,
+                        FAR struct file *filep,
+                        FAR uint32_t *latency_us);
+#else
 static int bmi270_fetch(FAR struct sensor_lowerhalf_s *lower,
                         FAR struct file *filep,
                         FAR char *buffer, size_t buflen);
@@ -122,10 +138,11 @@ static const struct sensor_ops_s g_sensor_ops =
   NULL,                 /* close */
   bmi270_activate,
   bmi270_set_interval,
-  NULL,                 /* batch */
 #ifdef CONFIG_SENSORS_BMI270_POLL
+  bmi270_batch,
   NULL,                 /* fetch */
 #else
+  NULL,                 /* batch */
   bmi270_fetch,
 #endif
   NULL,                 /* flush */
@@ -188,6 +205,10 @@ static int bmi270_activate(FAR struct sensor_lowerhalf_s *lower,
 #ifdef CONFIG_SENSORS_BMI270_POLL
       priv->last_update = sensor_get_timestamp();
 
+      /* The FIFO may hold stale frames from the last run */
+
+      dev->fifo = false;
+
       /* Wake up the thread */
 
       nxsem_post(&dev->run);
@@ -224,7 +245,37 @@ static int bmi270_set_interval(FAR struct sensor_lowerhalf_s *lower,
   return OK;
 }
 
-#ifndef CONFIG_SENSORS_BMI270_POLL
+#ifdef CONFIG_SENSORS_BMI270_POLL
+/****************************************************************************
+ * Name: bmi270_batch
+ *
+ * Description:
+ *   Set the report latency, the samples are then collected in the hardware
+ *   FIFO and pushed together.  The latency is limited by the number of
+ *   events the upper half buffers.
+ *
+ ****************************************************************************/
+
+static int bmi270_batch(FAR struct sensor_lowerhalf_s *lower,
+                        FAR struct file *filep,
+                        FAR uint32_t *latency_us)
+{
+  FAR struct bmi270_sensor_s *priv = (FAR struct bmi270_sensor_s *)lower;
+  uint32_t max_latency = lower->nbuffer * BMI270_ODR_INTERVAL;
+
+  if (*latency_us > max_latency)
+    {
+      *latency_us = max_latency;
+    }
+  else if (*latency_us < BMI270_ODR_INTERVAL)
+    {
+      *latency_us = 0;
+    }
+
+  priv->latency = *latency_us;
+  return OK;
+}
+#else
 /****************************************************************************
  * Name: bmi270_fetch
  ****************************************************************************/
@@ -492,6 +543,143 @@ static void bmi270_gyro_data(FAR struct bmi270_sensor_s *priv,
   lower->push_event(lower->priv, &gyro, sizeof(gyro));
 }
 
+/****************************************************************************
+ * Name: bmi270_fifo_latency
+ *
+ * Description:
+ *   Get the latency to read the FIFO with, zero if some enabled sensor does
+ *   not batch.
+ *
+ ****************************************************************************/
+
+static uint32_t bmi270_fifo_latency(FAR struct bmi270_sensor_dev_s *dev)
+{
+  FAR struct bmi270_sensor_s *priv;
+  uint32_t                    latency = UINT32_MAX;
+  int                         i;
+
+  for (i = 0; i < BMI270_MAX_IDX; i++)
+    {
+      priv = &dev->priv[i];
+      if (priv->enabled)
+        {
+          latency = MIN(latency, priv->latency);
+        }
+    }
+
+  return latency != UINT32_MAX ? latency : 0;
+}
+
+/****************************************************************************
+ * Name: bmi270_fifo_enable
+ ****************************************************************************/
+
+static void bmi270_fifo_enable(FAR struct bmi270_sensor_dev_s *dev,
+                               bool enable)
+{
+  FAR struct bmi270_dev_s *base = &dev->priv[BMI270_ACCEL_IDX].base;
+
+  if (enable)
+    {
+      /* Stream mode, headerless frames of gyro and accel data */
+
+      bmi270_putreg8(base, BMI270_FIFO_CONFIG_0, 0);
+      bmi270_putreg8(base, BMI270_FIFO_CONFIG_1, FIFO_GYR_EN | FIFO_ACC_EN);
+      bmi270_putreg8(base, BMI270_CMD, CMD_FIFO_FLUSH);
+    }
+  else
+    {
+      bmi270_putreg8(base, BMI270_FIFO_CONFIG_1, FIFO_HEADER_EN);
+    }
+
+  dev->fifo = enable;
+}
+
+/****************************************************************************
+ * Name: bmi270_fifo_read
+ *
+ * Description:
+ *   Push all the frames in the FIFO, a few at a time.  The last frame is
+ *   the one sampled just now, the timestamps of the others are counted back
+ *   from it.
+ *
+ ****************************************************************************/
+
+static void bmi270_fifo_read(FAR struct bmi270_sensor_dev_s *dev)
+{
+  FAR struct bmi270_sensor_s *accel = &dev->priv[BMI270_ACCEL_IDX];
+  FAR struct bmi270_sensor_s *gyro  = &dev->priv[BMI270_GYRO_IDX];
+  struct sensor_accel         accels[BMI270_FIFO_CHUNK];
+  struct sensor_gyro          gyros[BMI270_FIFO_CHUNK];
+  int16_t                     data[BMI270_FIFO_CHUNK][6];
+  uint8_t                     len[2];
+  uint64_t                    now;
+  uint64_t                    timestamp;
+  int                         nframes;
+  int                         naccel;
+  int                         ngyro;
+  int                         n;
+  int                         i;
+
+  bmi270_getregs(&accel->base, BMI270_FIFO_LENGTH_0, len, 2);
+  now     = sensor_get_timestamp();
+  nframes = (len[0] | (len[1] & FIFO_LENGTH_1_MASK) << 8) /
+            BMI270_FIFO_FRAME;
+
+  while (nframes > 0)
+    {
+      n = MIN(nframes, BMI270_FIFO_CHUNK);
+      bmi270_getregs(&accel->base, BMI270_FIFO_DATA, (FAR uint8_t *)data,
+                     n * BMI270_FIFO_FRAME);
+
+      /* Keep the interval of each subscriber, as when polling */
+
+      naccel = 0;
+      ngyro  = 0;
+      for (i = 0; i < n; i++)
+        {
+          timestamp = now - (uint64_t)(nframes - 1 - i) *
+                      BMI270_ODR_INTERVAL;
+
+          if (gyro->enabled &&
+              timestamp - gyro->last_update >= gyro->interval)
+            {
+              gyro->last_update            = timestamp;
+              gyros[ngyro].timestamp       = timestamp;
+              gyros[ngyro].x               = data[i][0] * gyro->scale;
+              gyros[ngyro].y               = data[i][1] * gyro->scale;
+              gyros[ngyro].z               = data[i][2] * gyro->scale;
+              gyros[ngyro++].temperature   = 0;
+            }
+
+          if (accel->enabled &&
+              timestamp - accel->last_update >= accel->interval)
+            {
+              accel->last_update           = timestamp;
+              accels[naccel].timestamp     = timestamp;
+              accels[naccel].x             = data[i][3] * accel->scale;
+              accels[naccel].y             = data[i][4] * accel->scale;
+              accels[naccel].z             = data[i][5] * accel->scale;
+              accels[naccel++].temperature = 0;
+            }
+        }
+
+      if (naccel > 0)
+        {
+          accel->lower.push_event(accel->lower.priv, accels,
+                                  naccel * sizeof(accels[0]));
+        }
+
+      if (ngyro > 0)
+        {
+          gyro->lower.push_event(gyro->lower.priv, gyros,
+                                 ngyro * sizeof(gyros[0]));
+        }
+
+      nframes -= n;
+    }
+}
+
 /****************************************************************************
  * Name: bmi270_thread
  *
@@ -512,6 +700,7 @@ static int bmi270_thread(int argc, FAR char **argv)
   FAR struct bmi270_sensor_s *accel = &dev->priv[BMI270_ACCEL_IDX];
   FAR struct bmi270_sensor_s *gyro  = &dev->priv[BMI270_GYRO_IDX];
   unsigned long               min_interval;
+  uint32_t                    latency;
   int16_t                     data[6];
   int                         ret;
 
@@ -528,6 +717,31 @@ static int bmi270_thread(int argc, FAR char **argv)
             }
         }
 
+      /* Batching, let the FIFO collect the samples meanwhile */
+
+      latency = bmi270_fifo_latency(dev);
+      if (latency > 0)
+        {
+          if (!dev->fifo)
+            {
+              bmi270_fifo_enable(dev, true);
+            }
+          else
+            {
+              bmi270_fifo_read(dev);
+            }
+
+          nxsched_usleep(latency);
+          continue;
+        }
+      else if (dev->fifo)
+        {
+          /* Push what was batched before going on with single samples */
+
+          bmi270_fifo_read(dev);
+          bmi270_fifo_enable(dev, false);
+        }
+
       /* Get data */
 
       bmi270_getregs(&gyro->base, BMI270_DATA_8, (FAR uint8_t *)data, 12);
@@ -616,7 +830,11 @@ int bmi270_register_uorb(int devno, FAR struct spi_dev_s *spi)
 #endif
   tmp->lower.ops     = &g_sensor_ops;
   tmp->lower.type    = SENSOR_TYPE_ACCELEROMETER;
+#ifdef CONFIG_SENSORS_BMI270_POLL
+  tmp->lower.nbuffer = CONFIG_SENSORS_BMI270_NBUFFER;
+#else
   tmp->lower.nbuffer = 1;
+#endif
 #ifdef CONFIG_SENSORS_BMI270_POLL
   tmp->enabled       = false;
   tmp->interval      = CONFIG_SENSORS_BMI270_POLL_INTERVAL;
@@ -641,7 +859,11 @@ int bmi270_register_uorb(int devno, FAR struct spi_dev_s *spi)
 #endif
   tmp->lower.ops     = &g_sensor_ops;
   tmp->lower.type    = SENSOR_TYPE_GYROSCOPE;
+#ifdef CONFIG_SENSORS_BMI270_POLL
+  tmp->lower.nbuffer = CONFIG_SENSORS_BMI270_NBUFFER;
+#else
   tmp->lower.nbuffer = 1;
+#endif
 #ifdef CONFIG_SENSORS_BMI270_POLL
   tmp->enabled       = false;
   tmp->interval      = CONFIG_SENSORS_BMI270_POLL_INTERVAL;
@@ -36,10 +36,12 @@
 
 #include <poll.h>
 #include <fcntl.h>
+#include <nuttx/arch.h>
 #include <nuttx/list.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/circbuf.h>
 #include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/sensors/sensor.h>
 #include <nuttx/lib/lib.h>
 
@@ -102,6 +104,9 @@ struct sensor_user_s
   bool             flushing;   /* The is used to indicate user is flushing */
   sem_t            buffersem;  /* Wakeup user waiting for data in circular buffer */
   size_t           bufferpos;  /* The index of user generation in buffer */
+#ifdef CONFIG_SENSORS_RING
+  int              ring;       /* The cursor slot in the shared ring */
+#endif
 
   /* The subscriber info
    * Support multi advertisers to subscribe their own data when they
@@ -119,6 +124,10 @@ struct sensor_upperhalf_s
   struct sensor_state_s          state;  /* The state of sensor device */
   struct circbuf_s   timing;             /* The circular buffer of generation */
   struct circbuf_s   buffer;             /* The circular buffer of data */
+#ifdef CONFIG_SENSORS_RING
+  FAR struct sensor_ring_s *ring;        /* The ring holding both buffers */
+  uint32_t           ringslots;          /* The bitmap of used cursors */
+#endif
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
 };
@@ -137,6 +146,10 @@ static ssize_t sensor_write(FAR struct file *filep, FAR const char *buffer,
                             size_t buflen);
 static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
+#ifdef CONFIG_SENSORS_RING
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
@@ -228,7 +241,11 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
+#ifdef CONFIG_SENSORS_RING
+  sensor_mmap,    /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -390,6 +407,71 @@ update:
   return ret;
 }
 
+static int sensor_buffer_init(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+#ifdef CONFIG_SENSORS_RING
+  FAR struct sensor_ring_s *ring;
+  size_t timing;
+  size_t data;
+
+  /* Both buffers are placed in the ring, so the subscribers that map it
+   * see the samples where they are published.
+   */
+
+  timing = ALIGN_UP(sizeof(*ring) + CONFIG_SENSORS_RING_NSLOTS *
+                    sizeof(ring->cursor[0]), sizeof(uint64_t));
+  data   = ALIGN_UP(timing + lower->nbuffer * TIMING_BUF_ESIZE,
+                    sizeof(uint64_t));
+  ring   = kmm_zalloc(data + lower->nbuffer * upper->state.esize);
+  if (ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ring->esize   = upper->state.esize;
+  ring->nbuffer = lower->nbuffer;
+  ring->nslots  = CONFIG_SENSORS_RING_NSLOTS;
+  ring->timing  = timing;
+  ring->data    = data;
+
+  circbuf_init(&upper->timing, (FAR char *)ring + timing,
+               lower->nbuffer * TIMING_BUF_ESIZE);
+  circbuf_init(&upper->buffer, (FAR char *)ring + data,
+               lower->nbuffer * upper->state.esize);
+  upper->ring = ring;
+  ret = OK;
+#else
+  ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
+                     upper->state.esize);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
+                     TIMING_BUF_ESIZE);
+  if (ret < 0)
+    {
+      circbuf_uninit(&upper->buffer);
+    }
+#endif
+
+  return ret;
+}
+
+static void sensor_buffer_uninit(FAR struct sensor_upperhalf_s *upper)
+{
+  circbuf_uninit(&upper->buffer);
+  circbuf_uninit(&upper->timing);
+#ifdef CONFIG_SENSORS_RING
+  kmm_free(upper->ring);
+  upper->ring = NULL;
+#endif
+}
+
 static void sensor_generate_timing(FAR struct sensor_upperhalf_s *upper,
                                    unsigned long nums)
 {
@@ -408,6 +490,15 @@ static bool sensor_is_updated(FAR struct sensor_upperhalf_s *upper,
 {
   long delta = (long long)upper->state.generation - user->state.generation;
 
+#ifdef CONFIG_SENSORS_RING
+  /* The user of the ring consumes in place and owns its cursor */
+
+  if (user->ring >= 0)
+    {
+      return upper->ring->cursor[user->ring] != upper->ring->head;
+    }
+#endif
+
   if (delta <= 0)
     {
       return false;
@@ -569,6 +660,61 @@ static ssize_t sensor_do_samples(FAR struct sensor_upperhalf_s *upper,
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_RING
+static int sensor_ring_attach(FAR struct sensor_upperhalf_s *upper,
+                              FAR struct sensor_user_s *user)
+{
+  FAR struct sensor_ring_s *ring;
+  int slot;
+  int ret;
+
+  if (user->ring >= 0)
+    {
+      return user->ring;
+    }
+  else if (upper->lower->ops->fetch != NULL)
+    {
+      return -ENOTSUP;
+    }
+  else if (!circbuf_is_init(&upper->buffer))
+    {
+      ret = sensor_buffer_init(upper);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  for (slot = 0; slot < CONFIG_SENSORS_RING_NSLOTS; slot++)
+    {
+      if ((upper->ringslots & (1u << slot)) == 0)
+        {
+          break;
+        }
+    }
+
+  if (slot == CONFIG_SENSORS_RING_NSLOTS)
+    {
+      return -EBUSY;
+    }
+
+  /* Start where read() would have, the latest sample of a persistent
+   * topic is still of interest.
+   */
+
+  ring = upper->ring;
+  ring->cursor[slot] = ring->head;
+  if (ring->head && upper->lower->persist)
+    {
+      ring->cursor[slot]--;
+    }
+
+  upper->ringslots |= 1u << slot;
+  user->ring = slot;
+  return slot;
+}
+#endif
+
 static void sensor_pollnotify_one(FAR struct sensor_user_s *user,
                                   pollevent_t eventset,
                                   sensor_role_t role)
@@ -663,6 +809,9 @@ static int sensor_open(FAR struct file *filep)
 
   user->state.interval = UINT32_MAX;
   user->state.esize = upper->state.esize;
+#ifdef CONFIG_SENSORS_RING
+  user->ring = -1;
+#endif
   nxsem_init(&user->buffersem, 0, 0);
   list_add_tail(&upper->userlist, &user->node);
 
@@ -723,6 +872,13 @@ static int sensor_close(FAR struct file *filep)
     }
 
   list_delete(&user->node);
+#ifdef CONFIG_SENSORS_RING
+  if (user->ring >= 0)
+    {
+      upper->ringslots &= ~(1u << user->ring);
+    }
+#endif
+
   sensor_update_latency(filep, upper, user, UINT32_MAX);
   sensor_update_interval(filep, upper, user, UINT32_MAX);
   nxsem_destroy(&user->buffersem);
@@ -1003,6 +1159,16 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_SENSORS_RING
+      case SNIOC_RING_ATTACH:
+        {
+          nxrmutex_lock(&upper->lock);
+          ret = sensor_ring_attach(upper, user);
+          nxrmutex_unlock(&upper->lock);
+        }
+        break;
+#endif
+
       default:
 
         /* Lowerhalf driver process other cmd. */
@@ -1022,6 +1188,48 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_RING
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_ring_s *ring;
+  size_t size;
+  int ret = -EINVAL;
+
+  nxrmutex_lock(&upper->lock);
+  if (upper->lower->ops->fetch != NULL)
+    {
+      ret = -ENOTSUP;
+      goto out;
+    }
+  else if (!circbuf_is_init(&upper->buffer))
+    {
+      ret = sensor_buffer_init(upper);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  /* The ring lives as long as the driver, so no munmap is needed */
+
+  ring = upper->ring;
+  size = ring->data + ring->nbuffer * ring->esize;
+  if (map->offset >= 0 && map->offset < size && map->length &&
+      map->offset + map->length <= size)
+    {
+      map->vaddr = (FAR char *)ring + map->offset;
+      ret = OK;
+    }
+
+out:
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif
+
 static int sensor_poll(FAR struct file *filep,
                        FAR struct pollfd *fds, bool setup)
 {
@@ -1090,7 +1298,6 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes)
 {
   FAR struct sensor_upperhalf_s *upper = priv;
-  FAR struct sensor_lowerhalf_s *lower = upper->lower;
   FAR struct sensor_user_s *user;
   unsigned long envcount;
   int semcount;
@@ -1125,26 +1332,33 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
     {
       /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
-                         upper->state.esize);
-      if (ret < 0)
-        {
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
-
-      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
-                         TIMING_BUF_ESIZE);
+      ret = sensor_buffer_init(upper);
       if (ret < 0)
         {
-          circbuf_uninit(&upper->buffer);
           nxrmutex_unlock(&upper->lock);
           return ret;
         }
     }
 
+#ifdef CONFIG_SENSORS_RING
+  /* Tell the subscribers reading in place which samples are overwritten,
+   * before they are.
+   */
+
+  upper->ring->writing = upper->ring->head + envcount;
+  UP_DMB();
+#endif
+
   circbuf_overwrite(&upper->buffer, data, bytes);
   sensor_generate_timing(upper, envcount);
+
+#ifdef CONFIG_SENSORS_RING
+  UP_DMB();
+  upper->ring->pos  = upper->buffer.head % upper->buffer.size /
+                      upper->state.esize;
+  UP_DMB();
+  upper->ring->head = upper->ring->writing;
+#endif
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
       if (sensor_is_updated(upper, user))
@@ -1445,8 +1659,7 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
   nxrmutex_destroy(&upper->lock);
   if (circbuf_is_init(&upper->buffer))
     {
-      circbuf_uninit(&upper->buffer);
-      circbuf_uninit(&upper->timing);
+      sensor_buffer_uninit(upper);
     }
 
   kmm_free(upper);
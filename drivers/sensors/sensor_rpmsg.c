@@ -28,6 +28,7 @@
 
 #include <fcntl.h>
 #include <debug.h>
+#include <sys/param.h>
 
 #include <nuttx/nuttx.h>
 #include <nuttx/list.h>
@@ -835,6 +836,7 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
   FAR struct sensor_rpmsg_ept_s *sre;
   FAR struct sensor_rpmsg_data_s *msg;
   struct sensor_ustate_s state;
+  uint32_t timeout;
   uint64_t now;
   bool updated;
   int ret;
@@ -852,6 +854,12 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
       state.interval = 0;
     }
 
+  /* Coalesce the samples for up to half of what the remote subscriber
+   * waits anyway, its interval or, when it batches, its latency.
+   */
+
+  timeout = MAX(state.interval, state.latency) / 2;
+
   sre = container_of(stub->ept, struct sensor_rpmsg_ept_s, ept);
   nxrmutex_lock(&sre->lock);
 
@@ -926,7 +934,11 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
    */
 
   now = sensor_get_timestamp();
-  if (sre->expire <= now && sre->buffer)
+  if (!sre->buffer)
+    {
+      /* Nothing was new for this subscriber, no need to wake up */
+    }
+  else if (sre->expire <= now)
     {
       ret = rpmsg_send_nocopy(&sre->ept, sre->buffer, sre->written);
       if (ret < 0)
@@ -940,10 +952,9 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
     }
   else
     {
-      if (sre->expire == UINT64_MAX ||
-          sre->expire - now > state.interval / 2)
+      if (sre->expire == UINT64_MAX || sre->expire - now > timeout)
         {
-          sre->expire = now + state.interval / 2;
+          sre->expire = now + timeout;
         }
 
       work_queue(HPWORK, &sre->work, sensor_rpmsg_data_worker, sre,
@@ -970,9 +981,15 @@ static ssize_t sensor_rpmsg_push_event(FAR void *priv, FAR const void *data,
     }
 
   /* Send new data to own proxy(remote subscribers), don't care whether
-   * is successful, and must return length of written.
+   * is successful, and must return length of written.  A topic nobody
+   * subscribes remotely costs nothing more.
    */
 
+  if (list_is_empty(&dev->stublist))
+    {
+      return ret;
+    }
+
   sensor_rpmsg_lock(dev);
   list_for_every_entry_safe(&dev->stublist, stub, stmp,
                             struct sensor_rpmsg_stub_s, node)
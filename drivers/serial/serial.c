@@ -101,6 +101,13 @@ static inline ssize_t uart_irqwrite(FAR uart_dev_t *dev,
                                     size_t buflen);
 static inline ssize_t uart_irqwritev(FAR uart_dev_t *dev,
                                      FAR struct uio *uio);
+#ifdef CONFIG_SERIAL_TERMIOS
+static int     uart_rxwait(FAR uart_dev_t *dev, bool started);
+#endif
+#ifdef CONFIG_SERIAL_TXDMA_DIRECT
+static ssize_t uart_dmadirect(FAR uart_dev_t *dev, FAR const char *buffer,
+                              size_t buflen);
+#endif
 static int     uart_tcdrain(FAR uart_dev_t *dev,
                             bool cancelable, clock_t timeout);
 
@@ -484,6 +491,115 @@ static inline ssize_t uart_irqwritev(FAR uart_dev_t *dev,
   return total;
 }
 
+/****************************************************************************
+ * Name: uart_rxwait
+ *
+ * Description:
+ *   Wait for received data in non-canonical mode when c_cc[VTIME] is set.
+ *   The RX side only wakes us once dev->minrecv bytes are buffered.
+ *
+ *   With VMIN == 0, VTIME is a plain timeout for the whole read.  With
+ *   VMIN > 0 it is an inter-character timer: it is restarted while bytes
+ *   keep arriving and only runs once the first byte is in.  A burst is
+ *   therefore handed over in one wake-up, when VMIN bytes have arrived or
+ *   when the line has been quiet for VTIME.
+ *
+ *   Called with the recv.lock held and within a critical section.
+ *   'started' tells whether this read has already returned some bytes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_TERMIOS
+static int uart_rxwait(FAR uart_dev_t *dev, bool started)
+{
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  sbuf_size_t head = rxbuf->head;
+  int ret;
+
+  for (; ; )
+    {
+      nxmutex_unlock(&dev->recv.lock);
+      ret = nxsem_tickwait(&dev->recvsem, DSEC2TICK(dev->timeout));
+      nxmutex_lock(&dev->recv.lock);
+
+      if (ret != -ETIMEDOUT || dev->minread == 0)
+        {
+          return ret;
+        }
+
+      if (rxbuf->head == head)
+        {
+          /* The line was quiet for VTIME.  Hand over what has arrived. */
+
+          if (rxbuf->head != rxbuf->tail)
+            {
+              return OK;
+            }
+          else if (started)
+            {
+              return ret;
+            }
+        }
+
+      head = rxbuf->head;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: uart_dmadirect
+ *
+ * Description:
+ *   Send the caller's buffer by TX DMA without staging it in the TX
+ *   circular buffer.  The caller must hold xmit.lock and the TX buffer
+ *   must be empty.  Returns the number of bytes sent.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_TXDMA_DIRECT
+static ssize_t uart_dmadirect(FAR uart_dev_t *dev, FAR const char *buffer,
+                              size_t buflen)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmatx;
+  irqstate_t flags;
+  size_t nbytes;
+
+  flags = enter_critical_section();
+
+  xfer->buffer   = (FAR char *)buffer;
+  xfer->length   = buflen;
+  xfer->nbuffer  = NULL;
+  xfer->nlength  = 0;
+  dev->dmadirect = true;
+
+  uart_dmasend(dev);
+
+  /* The DMA reads the caller's memory, so do not return before
+   * uart_xmitchars_done() reports the end of the transfer.
+   */
+
+  while (dev->dmadirect)
+    {
+#ifdef CONFIG_SERIAL_REMOVABLE
+      if (dev->disconnected)
+        {
+          dev->dmadirect = false;
+          break;
+        }
+#endif
+
+      nxsem_wait_uninterruptible(&dev->xmitsem);
+    }
+
+  nbytes       = MIN(xfer->nbytes, buflen);
+  xfer->nbytes = 0;
+  xfer->length = 0;
+
+  leave_critical_section(flags);
+  return nbytes;
+}
+#endif
+
 /****************************************************************************
  * Name: uart_tcdrain
  *
@@ -1250,19 +1366,16 @@ static ssize_t uart_readv(FAR struct file *filep, FAR struct uio *uio)
                                          dev->minread - recvd);
                       if (dev->timeout)
                         {
-                          nxmutex_unlock(&dev->recv.lock);
-                          ret = nxsem_tickwait(&dev->recvsem,
-                                              DSEC2TICK(dev->timeout));
+                          ret = uart_rxwait(dev, recvd > 0);
                         }
                       else
 #endif
                         {
                           nxmutex_unlock(&dev->recv.lock);
                           ret = nxsem_wait(&dev->recvsem);
+                          nxmutex_lock(&dev->recv.lock);
                         }
 
-                      nxmutex_lock(&dev->recv.lock);
-
 #ifdef CONFIG_SERIAL_TERMIOS
                       dev->minrecv = dev->minread;
 #endif
@@ -1476,6 +1589,40 @@ static ssize_t uart_writev(FAR struct file *filep, FAR struct uio *uio)
    */
 
   uart_disabletxint(dev);
+
+#ifdef CONFIG_SERIAL_TXDMA_DIRECT
+  /* Large writes that need no output post-processing are sent straight
+   * from the caller's buffer once everything queued before them is out.
+   */
+
+  if (oktoblock && dev->ops->dmasend != NULL &&
+      ((dev->tc_oflag & OPOST) == 0 ||
+       (dev->tc_oflag & (OCRNL | ONLCR | ONLRET)) == 0))
+    {
+      while (buflen > 0 && dev->xmit.head == dev->xmit.tail)
+        {
+          FAR const struct iovec *iov = uio->uio_iov;
+          size_t len = iov->iov_len - uio->uio_offset_in_iov;
+          ssize_t nsent;
+
+          if (len < CONFIG_SERIAL_TXDMA_DIRECT_THRESHOLD)
+            {
+              break;
+            }
+
+          nsent = uart_dmadirect(dev, (FAR const char *)iov->iov_base +
+                                 uio->uio_offset_in_iov, len);
+          if (nsent <= 0)
+            {
+              break;
+            }
+
+          uio_advance(uio, nsent);
+          buflen -= nsent;
+        }
+    }
+#endif
+
   for (; buflen; uio_advance(uio, 1), buflen--)
     {
       uio_copyto(uio, 0, &ch, 1);
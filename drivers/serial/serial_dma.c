@@ -99,6 +99,15 @@ void uart_xmitchars_dma(FAR uart_dev_t *dev)
 {
   FAR struct uart_dmaxfer_s *xfer = &dev->dmatx;
 
+#ifdef CONFIG_SERIAL_TXDMA_DIRECT
+  if (dev->dmadirect)
+    {
+      /* The DMA is busy with a write from the caller's buffer. */
+
+      return;
+    }
+#endif
+
   if (dev->xmit.head == dev->xmit.tail)
     {
       /* No data to transfer. */
@@ -143,6 +152,20 @@ void uart_xmitchars_done(FAR uart_dev_t *dev)
   size_t nbytes = xfer->nbytes;
   struct uart_buffer_s *txbuf = &dev->xmit;
 
+#ifdef CONFIG_SERIAL_TXDMA_DIRECT
+  if (dev->dmadirect)
+    {
+      /* A write from the caller's buffer is complete.  Leave nbytes for
+       * the writer and wake it up.
+       */
+
+      xfer->length   = xfer->nlength = 0;
+      dev->dmadirect = false;
+      uart_datasent(dev);
+      return;
+    }
+#endif
+
   /* Skip the update if the tail position change which mean
    * someone reset (e.g. TCOFLUSH) the xmit buffer during DMA.
    */
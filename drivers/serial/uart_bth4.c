@@ -271,6 +271,7 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
   enum bt_buf_type_e type;
   size_t reserved;
   uint8_t *data;
+  size_t offset = 0;
   size_t pktlen;
   size_t hdrlen;
   int ret;
@@ -302,11 +303,18 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
          buffer, buflen);
   dev->sendlen += buflen;
 
-  hdr = (FAR union bt_hdr_u *)data;
+  /* A single write may carry several complete packets (e.g. a burst of
+   * ACL fragments).  Each one is handed to the driver where it lies in
+   * the send buffer: the head room a driver may use in front of a later
+   * packet only overlaps packets that were already sent.  Any partial
+   * packet left over is moved to the front once, after the loop.
+   */
 
   for (; ; )
     {
-      switch (*(data - H4_HEADER_SIZE))
+      hdr = (FAR union bt_hdr_u *)(data + offset);
+
+      switch (data[offset - H4_HEADER_SIZE])
         {
           case H4_CMD:
             hdrlen = sizeof(struct bt_hci_cmd_hdr_s);
@@ -334,34 +342,40 @@ static ssize_t uart_bth4_write(FAR struct file *filep,
 
       if (dev->sendlen < hdrlen)
         {
-          goto out;
+          break;
         }
 
       pktlen += hdrlen;
       if (dev->sendlen < pktlen)
         {
-          goto out;
+          break;
         }
 
       /* Got the full packet, send out */
 
       ret = dev->drv->send(dev->drv, type,
-                           data, pktlen - H4_HEADER_SIZE);
+                           data + offset, pktlen - H4_HEADER_SIZE);
       if (ret < 0)
         {
           goto err;
         }
 
+      offset       += pktlen;
       dev->sendlen -= pktlen;
       if (dev->sendlen == 0)
         {
           goto out;
         }
+    }
 
+  if (offset > 0)
+    {
       memmove(data - H4_HEADER_SIZE,
-              dev->sendbuf + pktlen, dev->sendlen);
+              data - H4_HEADER_SIZE + offset, dev->sendlen);
     }
 
+  goto out;
+
 err:
   dev->sendlen = 0;
 out:
@@ -31,43 +31,72 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/spi/spi.h>
 #include <nuttx/spi/spi_transfer.h>
 
 /****************************************************************************
- * Public Functions
+ * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_SPI_ASYNC_HPWORK
+#  define SPI_ASYNC_WORK HPWORK
+#else
+#  define SPI_ASYNC_WORK LPWORK
+#endif
+
 /****************************************************************************
- * Name: spi_transfer
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+/* The queue of the asynchronous messages of one bus */
+
+struct spi_async_s
+{
+  FAR struct spi_async_s *flink; /* Next bus with a queue */
+  FAR struct spi_dev_s *spi;     /* The bus */
+  sq_queue_t queue;              /* The pending messages */
+  struct work_s work;            /* Runs the pending messages */
+  bool running;                  /* The work is queued or running */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+/* The queues are never freed, so they may be looked up without a lock
+ * once they are on the list.
+ */
+
+static FAR struct spi_async_s *g_spi_async;
+static spinlock_t g_spi_async_lock = SP_UNLOCKED;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_transfer_locked
  *
  * Description:
- *   This is a helper function that can be used to encapsulate and manage
- *   a sequence of SPI transfers.  The SPI bus will be locked and the
- *   SPI device selected for the duration of the transfers.
- *
- * Input Parameters:
- *   spi - An instance of the SPI device to use for the transfer
- *   seq - Describes the sequence of transfers.
- *
- * Returned Value:
- *   Zero (OK) on success; a negated errno value on failure.
+ *   Perform a sequence of SPI transfers on a bus that is already locked.
  *
  ****************************************************************************/
 
-int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
+static int spi_transfer_locked(FAR struct spi_dev_s *spi,
+                               FAR struct spi_sequence_s *seq)
 {
   FAR struct spi_trans_s *trans;
   int ret = OK;
   int i;
 
-  DEBUGASSERT(spi != NULL && seq != NULL && seq->trans != NULL);
-
-  /* Get exclusive access to the SPI bus */
-
-  SPI_LOCK(spi, true);
-
   /* Establish the fixed SPI attributes for all transfers in the sequence */
 
   SPI_SETFREQUENCY(spi, seq->frequency);
@@ -77,7 +106,6 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
   if (ret < 0)
     {
       spierr("ERROR: SPI_SETDELAY failed: %d\n", ret);
-      SPI_LOCK(spi, false);
       return ret;
     }
 #endif
@@ -139,7 +167,232 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
     }
 
   SPI_SELECT(spi, seq->dev, false);
+  return ret;
+}
+
+#ifdef CONFIG_SPI_ASYNC
+/****************************************************************************
+ * Name: spi_async_find
+ ****************************************************************************/
+
+static FAR struct spi_async_s *spi_async_find(FAR struct spi_dev_s *spi)
+{
+  FAR struct spi_async_s *async;
+
+  for (async = g_spi_async; async != NULL; async = async->flink)
+    {
+      if (async->spi == spi)
+        {
+          break;
+        }
+    }
+
+  return async;
+}
+
+/****************************************************************************
+ * Name: spi_async_worker
+ *
+ * Description:
+ *   Run the pending messages of a bus back to back.  The bus stays locked
+ *   until the queue is empty, so the other users of the bus get in only
+ *   between two batches.
+ *
+ ****************************************************************************/
+
+static void spi_async_worker(FAR void *arg)
+{
+  FAR struct spi_async_s *async = arg;
+  FAR struct spi_message_s *msg;
+  irqstate_t flags;
+
+  SPI_LOCK(async->spi, true);
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&g_spi_async_lock);
+      msg = (FAR struct spi_message_s *)sq_remfirst(&async->queue);
+      if (msg == NULL)
+        {
+          async->running = false;
+          spin_unlock_irqrestore(&g_spi_async_lock, flags);
+          break;
+        }
+
+      spin_unlock_irqrestore(&g_spi_async_lock, flags);
+
+      /* The callback may queue the next message, even the same one */
+
+      msg->result = spi_transfer_locked(async->spi, msg->seq);
+      if (msg->complete != NULL)
+        {
+          msg->complete(msg);
+        }
+    }
+
+  SPI_LOCK(async->spi, false);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_transfer
+ *
+ * Description:
+ *   This is a helper function that can be used to encapsulate and manage
+ *   a sequence of SPI transfers.  The SPI bus will be locked and the
+ *   SPI device selected for the duration of the transfers.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfer
+ *   seq - Describes the sequence of transfers.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
+{
+  int ret;
+
+  DEBUGASSERT(spi != NULL && seq != NULL && seq->trans != NULL);
+
+  /* Get exclusive access to the SPI bus */
+
+  SPI_LOCK(spi, true);
+  ret = spi_transfer_locked(spi, seq);
   SPI_LOCK(spi, false);
   return ret;
 }
 
+#ifdef CONFIG_SPI_ASYNC
+/****************************************************************************
+ * Name: spi_async_initialize
+ *
+ * Description:
+ *   Create the message queue of a bus.  Any number of calls for the same
+ *   bus are allowed.
+ *
+ ****************************************************************************/
+
+int spi_async_initialize(FAR struct spi_dev_s *spi)
+{
+  FAR struct spi_async_s *async;
+  FAR struct spi_async_s *other;
+  irqstate_t flags;
+
+  DEBUGASSERT(spi != NULL);
+
+  if (spi_async_find(spi) != NULL)
+    {
+      return OK;
+    }
+
+  async = kmm_zalloc(sizeof(*async));
+  if (async == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  async->spi = spi;
+  sq_init(&async->queue);
+
+  /* Another thread may have been faster */
+
+  flags = spin_lock_irqsave(&g_spi_async_lock);
+  other = spi_async_find(spi);
+  if (other == NULL)
+    {
+      async->flink = g_spi_async;
+      g_spi_async  = async;
+    }
+
+  spin_unlock_irqrestore(&g_spi_async_lock, flags);
+
+  if (other != NULL)
+    {
+      kmm_free(async);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spi_async
+ *
+ * Description:
+ *   Queue a message on a bus and return at once.
+ *
+ ****************************************************************************/
+
+int spi_async(FAR struct spi_dev_s *spi, FAR struct spi_message_s *msg)
+{
+  FAR struct spi_async_s *async;
+  irqstate_t flags;
+
+  DEBUGASSERT(spi != NULL && msg != NULL && msg->seq != NULL &&
+              msg->seq->trans != NULL);
+
+  async = spi_async_find(spi);
+  if (async == NULL)
+    {
+      return -ENODEV;
+    }
+
+  msg->result = -EINPROGRESS;
+
+  flags = spin_lock_irqsave(&g_spi_async_lock);
+  sq_addlast(&msg->node, &async->queue);
+  if (!async->running)
+    {
+      async->running = true;
+      work_queue(SPI_ASYNC_WORK, &async->work, spi_async_worker, async, 0);
+    }
+
+  spin_unlock_irqrestore(&g_spi_async_lock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spi_async_cancel
+ *
+ * Description:
+ *   Remove a message from the queue of a bus if it has not started yet.
+ *
+ ****************************************************************************/
+
+int spi_async_cancel(FAR struct spi_dev_s *spi,
+                     FAR struct spi_message_s *msg)
+{
+  FAR struct spi_async_s *async;
+  FAR sq_entry_t *node;
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  async = spi_async_find(spi);
+  if (async == NULL)
+    {
+      return -ENODEV;
+    }
+
+  flags = spin_lock_irqsave(&g_spi_async_lock);
+  for (node = sq_peek(&async->queue); node != NULL; node = sq_next(node))
+    {
+      if (node == &msg->node)
+        {
+          sq_rem(node, &async->queue);
+          msg->result = -ECANCELED;
+          ret = OK;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_spi_async_lock, flags);
+  return ret;
+}
+#endif /* CONFIG_SPI_ASYNC */
+
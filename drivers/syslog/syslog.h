@@ -29,7 +29,30 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <time.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The context of one message, captured when it is logged */
+
+struct syslog_header_s
+{
+  int             priority;  /* Message priority */
+#ifdef CONFIG_SMP
+  int             cpu;       /* CPU that logged the message */
+#endif
+#if defined(CONFIG_SYSLOG_PROCESSID) || defined(CONFIG_SYSLOG_PROCESS_NAME)
+  pid_t           pid;       /* Thread that logged the message */
+#endif
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec ts;        /* Time the message was logged */
+#endif
+};
 
 /****************************************************************************
  * Public Data
@@ -229,6 +252,94 @@ void syslog_add_intbuffer(FAR const char *buffer, size_t buflen);
 void syslog_flush_intbuffer(bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_header_init
+ *
+ * Description:
+ *   Capture the priority, CPU, thread and time of a message that is being
+ *   logged now.
+ *
+ * Input Parameters:
+ *   hdr      - The header to initialize
+ *   priority - The priority of the message
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_SYSLOG_RFC5424
+void syslog_header_init(FAR struct syslog_header_s *hdr, int priority);
+
+/****************************************************************************
+ * Name: syslog_vformat
+ *
+ * Description:
+ *   Format one message, with the prefix described by 'hdr', and write it
+ *   to the SYSLOG channels.
+ *
+ * Input Parameters:
+ *   hdr  - The context captured when the message was logged
+ *   fmt  - The message format string
+ *   ap   - The message arguments, or NULL to take them from 'args'
+ *   args - The arguments as packed by lib_bspack(), used if 'ap' is NULL
+ *
+ * Returned Value:
+ *   The number of characters written.
+ *
+ ****************************************************************************/
+
+int syslog_vformat(FAR const struct syslog_header_s *hdr,
+                   FAR const IPTR char *fmt, FAR va_list *ap,
+                   FAR const void *args);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred_add
+ *
+ * Description:
+ *   Queue a message in the ring of the current CPU.  Only the message
+ *   context and the packed arguments are copied; formatting and output
+ *   are done later by the flusher work.
+ *
+ * Input Parameters:
+ *   priority - The priority of the message
+ *   fmt      - The message format string.  It must stay valid until the
+ *              message is flushed.
+ *   ap       - The message arguments
+ *
+ * Returned Value:
+ *   Zero (OK) is returned when the message was queued or dropped because
+ *   the ring was full.  A negated errno value is returned if the message
+ *   cannot be deferred and must be output directly.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_deferred_add(int priority, FAR const IPTR char *fmt,
+                        FAR va_list *ap);
+
+/****************************************************************************
+ * Name: syslog_flush_deferred
+ *
+ * Description:
+ *   Format and output all messages queued in the rings of all CPUs.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from the flusher work, or from crash handling logic with
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+void syslog_flush_deferred(void);
+#endif
+
 /****************************************************************************
  * Name: syslog_write_foreach
  *
@@ -0,0 +1,314 @@
+/****************************************************************************
+ * drivers/syslog/syslog_deferred.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <syslog.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/compiler.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/streams.h>
+#include <nuttx/syslog/syslog.h>
+#include <nuttx/wqueue.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SYSLOG_RECORD_ALIGN 8
+#define SYSLOG_RECORD_SIZE \
+  ALIGN_UP(sizeof(struct syslog_record_s), SYSLOG_RECORD_ALIGN)
+#define SYSLOG_RECORD_MAX \
+  ALIGN_UP(SYSLOG_RECORD_SIZE + CONFIG_SYSLOG_DEFERRED_MSGSIZE, \
+           SYSLOG_RECORD_ALIGN)
+#define SYSLOG_RING_SIZE \
+  ALIGN_DOWN(CONFIG_SYSLOG_DEFERRED_BUFSIZE, SYSLOG_RECORD_ALIGN)
+
+#if CONFIG_SYSLOG_DEFERRED_BUFSIZE < 2 * CONFIG_SYSLOG_DEFERRED_MSGSIZE
+#  error CONFIG_SYSLOG_DEFERRED_BUFSIZE too small for the message size
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One queued message.  The packed arguments follow the record.  A record
+ * with a NULL format string only pads the ring up to its end.
+ */
+
+struct syslog_record_s
+{
+  size_t                 len;  /* Size of the record with its arguments */
+  FAR const IPTR char   *fmt;  /* Format string or NULL */
+  struct syslog_header_s hdr;  /* Context of the message */
+};
+
+/* The ring of one CPU.  Only that CPU produces, with its interrupts
+ * disabled; only the flusher consumes.  If fewer than a record header
+ * of bytes are left at the end, the ring wraps without a pad record.
+ */
+
+struct syslog_ring_s
+{
+  atomic_t head;     /* Offset of the next record to write */
+  atomic_t tail;     /* Offset of the next record to flush */
+  atomic_t dropped;  /* Number of messages that did not fit */
+  aligned_data(SYSLOG_RECORD_ALIGN) uint8_t buffer[SYSLOG_RING_SIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_ring_s g_syslog_ring[CONFIG_SMP_NCPUS];
+static struct work_s g_syslog_work;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_deferred_reserve
+ *
+ * Description:
+ *   Find room for the largest record at the head of the ring.  Returns the
+ *   offset of the room or -ENOSPC.  '*wrap' is set if the room is at the
+ *   start of the ring.
+ *
+ ****************************************************************************/
+
+static int syslog_deferred_reserve(FAR struct syslog_ring_s *ring,
+                                   FAR bool *wrap)
+{
+  int head = atomic_read(&ring->head);
+  int tail = atomic_read_acquire(&ring->tail);
+
+  *wrap = false;
+
+  if (head >= tail)
+    {
+      /* Never fill the ring up to the tail, head == tail means empty */
+
+      if (SYSLOG_RING_SIZE - head > SYSLOG_RECORD_MAX ||
+          (SYSLOG_RING_SIZE - head == SYSLOG_RECORD_MAX && tail != 0))
+        {
+          return head;
+        }
+
+      if (tail > SYSLOG_RECORD_MAX)
+        {
+          *wrap = true;
+          return 0;
+        }
+    }
+  else if (tail - head > SYSLOG_RECORD_MAX)
+    {
+      return head;
+    }
+
+  return -ENOSPC;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_dropped
+ ****************************************************************************/
+
+static void syslog_deferred_dropped(FAR const IPTR char *fmt, ...)
+{
+  struct syslog_header_s hdr;
+  va_list ap;
+
+  syslog_header_init(&hdr, LOG_WARNING);
+
+  va_start(ap, fmt);
+  syslog_vformat(&hdr, fmt, &ap, NULL);
+  va_end(ap);
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_worker
+ ****************************************************************************/
+
+static void syslog_deferred_worker(FAR void *arg)
+{
+  syslog_flush_deferred();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_deferred_add
+ *
+ * Description:
+ *   Queue a message in the ring of the current CPU.  Only the message
+ *   context and the packed arguments are copied; formatting and output
+ *   are done later by the flusher work.
+ *
+ ****************************************************************************/
+
+int syslog_deferred_add(int priority, FAR const IPTR char *fmt,
+                        FAR va_list *ap)
+{
+  FAR struct syslog_ring_s *ring;
+  FAR struct syslog_record_s *rec;
+  irqstate_t flags;
+  ssize_t nbytes;
+  va_list copy;
+  bool wrap;
+  int head;
+  int pos;
+
+  /* The work queue is not running yet, or not anymore */
+
+  if (!OSINIT_OS_READY() || OSINIT_IS_PANIC())
+    {
+      return -EAGAIN;
+    }
+
+  flags = up_irq_save();
+  ring  = &g_syslog_ring[this_cpu()];
+
+  pos = syslog_deferred_reserve(ring, &wrap);
+  if (pos < 0)
+    {
+      atomic_fetch_add(&ring->dropped, 1);
+      up_irq_restore(flags);
+      return OK;
+    }
+
+  /* Pack a copy, 'ap' is still needed if the message cannot be deferred */
+
+  rec = (FAR struct syslog_record_s *)&ring->buffer[pos];
+  va_copy(copy, *ap);
+  nbytes = lib_bspack((FAR uint8_t *)rec + SYSLOG_RECORD_SIZE,
+                      CONFIG_SYSLOG_DEFERRED_MSGSIZE, fmt, copy);
+  va_end(copy);
+
+  if (nbytes < 0)
+    {
+      up_irq_restore(flags);
+      return nbytes;
+    }
+
+  rec->len = ALIGN_UP(SYSLOG_RECORD_SIZE + nbytes, SYSLOG_RECORD_ALIGN);
+  rec->fmt = fmt;
+  syslog_header_init(&rec->hdr, priority);
+
+  if (wrap)
+    {
+      head = atomic_read(&ring->head);
+      if (SYSLOG_RING_SIZE - head >= SYSLOG_RECORD_SIZE)
+        {
+          rec = (FAR struct syslog_record_s *)&ring->buffer[head];
+          rec->fmt = NULL;
+        }
+    }
+
+  /* Publish the record; the release orders the stores above */
+
+  head = pos + ((FAR struct syslog_record_s *)&ring->buffer[pos])->len;
+  atomic_set_release(&ring->head, head == SYSLOG_RING_SIZE ? 0 : head);
+
+  if (work_available(&g_syslog_work))
+    {
+      work_queue(LPWORK, &g_syslog_work, syslog_deferred_worker, NULL, 0);
+    }
+
+  up_irq_restore(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_flush_deferred
+ *
+ * Description:
+ *   Format and output all messages queued in the rings of all CPUs.
+ *
+ ****************************************************************************/
+
+void syslog_flush_deferred(void)
+{
+  FAR struct syslog_ring_s *ring;
+  FAR struct syslog_record_s *rec;
+  int dropped;
+  int head;
+  int tail;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      ring = &g_syslog_ring[i];
+      head = atomic_read_acquire(&ring->head);
+      tail = atomic_read(&ring->tail);
+
+      while (tail != head)
+        {
+          rec = (FAR struct syslog_record_s *)&ring->buffer[tail];
+          if (SYSLOG_RING_SIZE - tail < SYSLOG_RECORD_SIZE ||
+              rec->fmt == NULL)
+            {
+              tail = 0;
+              continue;
+            }
+
+          syslog_vformat(&rec->hdr, rec->fmt, NULL,
+                         (FAR uint8_t *)rec + SYSLOG_RECORD_SIZE);
+
+          tail += rec->len;
+          if (tail == SYSLOG_RING_SIZE)
+            {
+              tail = 0;
+            }
+
+          /* Hand the space back to the producer */
+
+          atomic_set_release(&ring->tail, tail);
+          head = atomic_read_acquire(&ring->head);
+        }
+
+      dropped = atomic_xchg(&ring->dropped, 0);
+      if (dropped > 0)
+        {
+          syslog_deferred_dropped("syslog: %d messages dropped\n",
+                                  dropped);
+        }
+    }
+}
+
+#endif /* CONFIG_SYSLOG_DEFERRED */
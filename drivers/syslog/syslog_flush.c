@@ -68,6 +68,12 @@ int syslog_flush(void)
 {
   int i;
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Output the messages still queued for the flusher */
+
+  syslog_flush_deferred();
+#endif
+
 #ifdef CONFIG_SYSLOG_INTBUFFER
   /* Flush any characters that may have been added to the interrupt
    * buffer.
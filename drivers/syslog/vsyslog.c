@@ -33,6 +33,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/init.h>
 #include <nuttx/clock.h>
+#include <nuttx/sched.h>
 #include <nuttx/streams.h>
 #include <nuttx/syslog/syslog.h>
 
@@ -69,46 +70,26 @@ static FAR const char * const g_priority_str[] =
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nx_vsyslog
+ * Name: syslog_header_init
  *
  * Description:
- *   nx_vsyslog() handles the system logging system calls. It is functionally
- *   equivalent to vsyslog() except that (1) the per-process priority
- *   filtering has already been performed and the va_list parameter is
- *   passed by reference.  That is because the va_list is a structure in
- *   some compilers and passing of structures in the NuttX sycalls does
- *   not work.
+ *   Capture the context of a message that is being logged now.
  *
  ****************************************************************************/
 
-int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+void syslog_header_init(FAR struct syslog_header_s *hdr, int priority)
 {
-  struct lib_syslograwstream_s stream;
-  int ret = 0;
-#ifdef CONFIG_SYSLOG_PROCESS_NAME
-  FAR struct tcb_s *tcb = nxsched_self();
+  hdr->priority = priority;
+#ifdef CONFIG_SMP
+  hdr->cpu      = this_cpu();
 #endif
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  struct timespec ts;
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  struct tm tm;
-  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
-#  endif
+#if defined(CONFIG_SYSLOG_PROCESSID) || defined(CONFIG_SYSLOG_PROCESS_NAME)
+  hdr->pid      = nxsched_gettid();
 #endif
 
-  /* Wrap the low-level output in a stream object and let lib_vsprintf
-   * do the work.
-   */
-
-  lib_syslograwstream_open(&stream);
-
 #ifdef CONFIG_SYSLOG_TIMESTAMP
-  ts.tv_sec = 0;
-  ts.tv_nsec = 0;
-
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  memset(&tm, 0, sizeof(tm));
-#  endif
+  hdr->ts.tv_sec  = 0;
+  hdr->ts.tv_nsec = 0;
 
   /* Get the current time.  Since debug output may be generated very early
    * in the start-up sequence, hardware timer support may not yet be
@@ -120,31 +101,68 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_REALTIME)
       /* Use CLOCK_REALTIME if so configured */
 
-      clock_gettime(CLOCK_REALTIME, &ts);
+      clock_gettime(CLOCK_REALTIME, &hdr->ts);
 #  else
       /* Prefer monotonic when enabled, as it can be synchronized to
        * RTC with clock_resynchronize.
        */
 
-      clock_gettime(CLOCK_MONOTONIC, &ts);
+      clock_gettime(CLOCK_MONOTONIC, &hdr->ts);
 #  endif
+    }
+#endif
+}
 
-      /* Prepend the message with the current time, if available */
+/****************************************************************************
+ * Name: syslog_vformat
+ *
+ * Description:
+ *   Format a message and write it to the SYSLOG channels.  The arguments
+ *   are taken from 'ap' or, if 'ap' is NULL, from 'args' as packed by
+ *   lib_bspack().
+ *
+ ****************************************************************************/
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-#    if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
-      localtime_r(&ts.tv_sec, &tm);
-#    else
-      gmtime_r(&ts.tv_sec, &tm);
-#    endif
+int syslog_vformat(FAR const struct syslog_header_s *hdr,
+                   FAR const IPTR char *fmt, FAR va_list *ap,
+                   FAR const void *args)
+{
+  struct lib_syslograwstream_s stream;
+  int ret = 0;
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+  FAR struct tcb_s *tcb = nxsched_get_tcb(hdr->pid);
+#endif
+#if defined(CONFIG_SYSLOG_TIMESTAMP) && defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+  struct tm tm;
+  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
+#endif
+#if defined(CONFIG_SYSLOG_COLOR_OUTPUT) || defined(CONFIG_SYSLOG_PRIORITY)
+  int priority = hdr->priority;
+#endif
+
+  /* Wrap the low-level output in a stream object and let lib_vsprintf
+   * do the work.
+   */
+
+  lib_syslograwstream_open(&stream);
+
+#if defined(CONFIG_SYSLOG_TIMESTAMP) && defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+  memset(&tm, 0, sizeof(tm));
+
+  /* Prepend the message with the current time, if available */
+
+  if (hdr->ts.tv_sec != 0 || hdr->ts.tv_nsec != 0)
+    {
+#  if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
+      localtime_r(&hdr->ts.tv_sec, &tm);
+#  else
+      gmtime_r(&hdr->ts.tv_sec, &tm);
 #  endif
     }
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   date_buf[0] = '\0';
   strftime(date_buf, CONFIG_SYSLOG_TIMESTAMP_BUFFER,
            CONFIG_SYSLOG_TIMESTAMP_FORMAT, &tm);
-#  endif
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT) || defined(CONFIG_SYSLOG_TIMESTAMP) || \
@@ -206,24 +224,24 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_TIMESTAMP
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
 #    if defined(CONFIG_SYSLOG_TIMESTAMP_FORMAT_MICROSECOND)
-                             , date_buf, ts.tv_nsec / NSEC_PER_USEC
+                             , date_buf, hdr->ts.tv_nsec / NSEC_PER_USEC
 #    else
                              , date_buf
 #    endif
 #  else
-                             , (uintmax_t)ts.tv_sec
-                             , ts.tv_nsec / NSEC_PER_USEC
+                             , (uintmax_t)hdr->ts.tv_sec
+                             , hdr->ts.tv_nsec / NSEC_PER_USEC
 #  endif
 #endif
 
 #if defined(CONFIG_SMP)
-                             , this_cpu()
+                             , hdr->cpu
 #endif
 
 #if defined(CONFIG_SYSLOG_PROCESSID)
   /* Prepend the Thread ID */
 
-                             , nxsched_gettid()
+                             , hdr->pid
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
@@ -247,7 +265,7 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_PROCESS_NAME
   /* Prepend the thread name */
 
-                             , get_task_name(tcb)
+                             , tcb != NULL ? get_task_name(tcb) : ""
 #endif
                     );
 
@@ -255,7 +273,14 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 
   /* Generate the output */
 
-  ret += lib_vsprintf_internal(&stream.common, fmt, *ap);
+  if (ap != NULL)
+    {
+      ret += lib_vsprintf_internal(&stream.common, fmt, *ap);
+    }
+  else
+    {
+      ret += lib_bsprintf(&stream.common, fmt, args);
+    }
 
   if (stream.last_ch != '\n')
     {
@@ -274,3 +299,34 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
   lib_syslograwstream_close(&stream);
   return ret;
 }
+
+/****************************************************************************
+ * Name: nx_vsyslog
+ *
+ * Description:
+ *   nx_vsyslog() handles the system logging system calls. It is functionally
+ *   equivalent to vsyslog() except that (1) the per-process priority
+ *   filtering has already been performed and the va_list parameter is
+ *   passed by reference.  That is because the va_list is a structure in
+ *   some compilers and passing of structures in the NuttX sycalls does
+ *   not work.
+ *
+ ****************************************************************************/
+
+int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  struct syslog_header_s hdr;
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Queue the message for the flusher, unless it cannot be deferred */
+
+  int ret = syslog_deferred_add(priority, fmt, ap);
+  if (ret >= 0)
+    {
+      return ret;
+    }
+#endif
+
+  syslog_header_init(&hdr, priority);
+  return syslog_vformat(&hdr, fmt, ap, NULL);
+}
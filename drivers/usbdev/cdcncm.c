@@ -35,7 +35,9 @@
 #include <debug.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <inttypes.h>
 #include <stdbool.h>
+#include <sys/param.h>
 #include <sys/poll.h>
 
 #include <nuttx/net/netdev_lowerhalf.h>
@@ -75,8 +77,9 @@
 /* TX timeout = 1 minute */
 
 #define CDCNCM_TXTIMEOUT             (60*CLK_TCK)
-#define CDCNCM_DGRAM_COMBINE_PERIOD   1
+#define CDCNCM_DGRAM_COMBINE_PERIOD   CONFIG_CDCNCM_TXDELAY
 
+#define NTB_MIN_IN_SIZE               2048
 #define NTB_DEFAULT_IN_SIZE           16384
 #define NTB_OUT_SIZE                  16384
 #define TX_MAX_NUM_DPE                32
@@ -310,8 +313,15 @@ struct cdcncm_driver_s
   FAR struct usbdev_req_s    *rdreq;       /* Single read request */
   bool                        rxpending;   /* Packet available in rdreq */
 
-  FAR struct usbdev_req_s    *wrreq;       /* Single write request */
-  sem_t                       wrreq_idle;  /* Is the wrreq available? */
+  FAR struct usbdev_req_s    *wrreq;       /* NTB being filled, or NULL */
+  uint8_t                     nwrfree;     /* Write requests not in use */
+  uint32_t                    ntbinsize;   /* NTB input size of the host */
+
+  /* All write requests, and those not in use */
+
+  FAR struct usbdev_req_s    *wrreqs[CONFIG_CDCNCM_NWRREQS];
+  FAR struct usbdev_req_s    *wrfree[CONFIG_CDCNCM_NWRREQS];
+
   bool                        txdone;      /* Did a write request complete? */
   enum ncm_notify_state_e     notify;      /* State of notify */
   FAR const struct ndp_parser_opts_s
@@ -372,6 +382,7 @@ static int     cdcmbim_poll(FAR struct file *filep, FAR struct pollfd *fds,
 /* Interrupt handling */
 
 static void cdcncm_receive(FAR struct cdcncm_driver_s *priv);
+static void cdcncm_transmit(FAR struct cdcncm_driver_s *self);
 static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv);
 
 static void cdcncm_interrupt_work(FAR void *arg);
@@ -894,50 +905,54 @@ static void cdcncm_transmit_format(FAR struct cdcncm_driver_s *self,
 }
 
 /****************************************************************************
- * Name: cdcncm_transmit_work
+ * Name: cdcncm_transmit
  *
  * Description:
- *   Send NTB to the USB device for ethernet frame transmission
+ *   Send the NTB being filled to the USB device for ethernet frame
+ *   transmission
  *
  * Input Parameters:
- *   arg - Reference to the driver state structure
+ *   self - Reference to the driver state structure
  *
  * Returned Value:
  *   None
  *
+ * Assumptions:
+ *   The network device is locked.
+ *
  ****************************************************************************/
 
-static void cdcncm_transmit_work(FAR void *arg)
+static void cdcncm_transmit(FAR struct cdcncm_driver_s *self)
 {
-  FAR struct cdcncm_driver_s *self = arg;
   FAR const struct ndp_parser_opts_s *opts = self->parseropts;
+  FAR struct usbdev_req_s *req = self->wrreq;
   FAR uint8_t *tmp;
   const int dgramidxlen = 2 * opts->dgramitemlen;
   const int ndpalign = g_ntbparameters.ndpinalignment;
+  irqstate_t flags;
   int ncblen;
   int ndpindex;
   int totallen;
 
-  /* Wait until the USB device request for Ethernet frame transmissions
-   * becomes available.
-   */
-
-  while (nxsem_wait(&self->wrreq_idle) != OK)
+  if (req == NULL || self->dgramcount == 0)
     {
+      return;
     }
 
+  work_cancel(ETHWORK, &self->delaywork);
+
   ncblen   = opts->nthsize;
   ndpindex = NCM_ALIGN(ncblen, ndpalign);
 
   /* Fill NCB */
 
-  tmp      = self->wrreq->buf + 8; /* Offset to block length */
-  totallen = self->dgramaddr - self->wrreq->buf;
+  tmp      = req->buf + 8; /* Offset to block length */
+  totallen = self->dgramaddr - req->buf;
   cdcncm_put(&tmp, opts->blocklen, totallen);
 
   /* Fill NDP */
 
-  tmp = self->wrreq->buf + ndpindex + 4; /* Offset to ndp length */
+  tmp = req->buf + ndpindex + 4; /* Offset to ndp length */
   cdcncm_put(&tmp, 2, opts->ndpsize + (self->dgramcount + 1) * dgramidxlen);
 
   tmp += opts->reserved1 + opts->nextndpindex + opts->reserved2 +
@@ -948,8 +963,37 @@ static void cdcncm_transmit_work(FAR void *arg)
   cdcncm_put(&tmp, opts->dgramitemlen, 0);
 
   self->wrreq->len = totallen;
+  self->wrreq      = NULL;
+
+  if (EP_SUBMIT(self->epbulkin, req) < 0)
+    {
+      flags = enter_critical_section();
+      self->wrfree[self->nwrfree++] = req;
+      leave_critical_section(flags);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_transmit_work
+ *
+ * Description:
+ *   Send a partly filled NTB when no completion did it in time
+ *
+ * Input Parameters:
+ *   arg - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
 
-  EP_SUBMIT(self->epbulkin, self->wrreq);
+static void cdcncm_transmit_work(FAR void *arg)
+{
+  FAR struct cdcncm_driver_s *self = arg;
+
+  netdev_lock(&self->dev.netdev);
+  cdcncm_transmit(self);
+  netdev_unlock(&self->dev.netdev);
 }
 
 /****************************************************************************
@@ -1181,6 +1225,12 @@ static void cdcncm_interrupt_work(FAR void *arg)
       self->txdone = false;
       leave_critical_section(flags);
 
+      /* The datagrams gathered while the NTB was on the bus go next */
+
+      netdev_lock(&self->dev.netdev);
+      cdcncm_transmit(self);
+      netdev_unlock(&self->dev.netdev);
+
       cdcncm_txdone(self);
     }
   else
@@ -1289,18 +1339,46 @@ static int cdcncm_ifdown(FAR struct netdev_lowerhalf_s *dev)
 static int cdcncm_send(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt)
 {
   FAR struct cdcncm_driver_s *self;
+  irqstate_t flags;
 
   self = container_of(dev, struct cdcncm_driver_s, dev);
+
+  /* Start a new NTB in a free write request.  With none left the packet
+   * stays with the upper half until a write request completes.
+   */
+
+  if (self->wrreq == NULL)
+    {
+      flags = enter_critical_section();
+      if (self->nwrfree > 0)
+        {
+          self->wrreq = self->wrfree[--self->nwrfree];
+        }
+
+      leave_critical_section(flags);
+
+      if (self->wrreq == NULL)
+        {
+          return -EBUSY;
+        }
+
+      self->dgramcount = 0;
+    }
+
   cdcncm_transmit_format(self, pkt);
   netpkt_free(dev, pkt, NETPKT_TX);
 
-  if ((self->wrreq->buf + NTB_OUT_SIZE - self->dgramaddr <
-       self->dev.netdev.d_pktsize) || self->dgramcount >= TX_MAX_NUM_DPE)
+  /* Send the NTB if it is full, or if the bus is idle anyway.  Otherwise
+   * it takes more datagrams until an NTB in flight completes.
+   */
+
+  if ((self->wrreq->buf + self->ntbinsize - self->dgramaddr <
+       self->dev.netdev.d_pktsize) || self->dgramcount >= TX_MAX_NUM_DPE ||
+      self->nwrfree == CONFIG_CDCNCM_NWRREQS - 1)
     {
-      work_cancel(ETHWORK, &self->delaywork);
-      cdcncm_transmit_work(self);
+      cdcncm_transmit(self);
     }
-  else
+  else if (work_available(&self->delaywork))
     {
       work_queue(ETHWORK, &self->delaywork, cdcncm_transmit_work, self,
                  MSEC2TICK(CDCNCM_DGRAM_COMBINE_PERIOD));
@@ -1514,21 +1592,16 @@ static void cdcncm_wrcomplete(FAR struct usbdev_ep_s *ep,
                               FAR struct usbdev_req_s *req)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
-  int rc;
+  irqstate_t flags;
 
   uinfo("buf: %p, flags 0x%hhx, len %zu, xfrd %zu, result %hd\n",
         req->buf, req->flags, req->len, req->xfrd, req->result);
 
-  /* The single USB device write request is available for upcoming
-   * transmissions again.
-   */
-
-  rc = nxsem_post(&self->wrreq_idle);
+  /* The write request is available for upcoming transmissions again */
 
-  if (rc != OK)
-    {
-      nerr("nxsem_post failed! rc: %d\n", rc);
-    }
+  flags = enter_critical_section();
+  self->wrfree[self->nwrfree++] = req;
+  leave_critical_section(flags);
 
   /* Inform the network layer that an Ethernet frame was transmitted. */
 
@@ -1571,6 +1644,7 @@ static void cdcncm_resetconfig(FAR struct cdcncm_driver_s *self)
   self->parseropts = &g_ndp16_opts;
   self->ndpsign    = self->isncm ? self->parseropts->ndpsign :
                                    CDC_MBIM_NDP16_NOCRC_SIGN;
+  self->ntbinsize  = NTB_DEFAULT_IN_SIZE;
 }
 
 /****************************************************************************
@@ -2480,6 +2554,7 @@ static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
   int ret = OK;
+  int i;
 
   uinfo("\n");
 
@@ -2547,27 +2622,27 @@ static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
 
   self->rdreq->callback = cdcncm_rdcomplete;
 
-  /* Pre-allocate a single write request. Buffer size is NTB_OUT_SIZE */
+  /* Pre-allocate the write requests. Buffer size is NTB_OUT_SIZE */
 
-  self->wrreq = usbdev_allocreq(self->epbulkin, NTB_OUT_SIZE);
-  if (self->wrreq == NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
-    }
-
-  self->wrreq->callback = cdcncm_wrcomplete;
+      self->wrreqs[i] = usbdev_allocreq(self->epbulkin, NTB_OUT_SIZE);
+      if (self->wrreqs[i] == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
 
-  /* The single write request just allocated is available now. */
+      self->wrreqs[i]->callback = cdcncm_wrcomplete;
+      self->wrfree[i] = self->wrreqs[i];
+    }
 
-  ret = nxsem_init(&self->wrreq_idle, 0, 1);
+  /* The write requests just allocated are available now. */
 
-  if (ret != OK)
-    {
-      uerr("nxsem_init failed. ret: %d\n", ret);
-      goto error;
-    }
+  self->nwrfree   = CONFIG_CDCNCM_NWRREQS;
+  self->wrreq     = NULL;
+  self->ntbinsize = NTB_DEFAULT_IN_SIZE;
 
   self->txdone    = false;
 
@@ -2594,6 +2669,7 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
                           FAR struct usbdev_s *dev)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  int i;
 
 #ifdef CONFIG_DEBUG_FEATURES
   if (!driver || !dev)
@@ -2651,12 +2727,18 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
    * of them)
    */
 
-  if (self->wrreq != NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
     {
-      usbdev_freereq(self->epbulkin, self->wrreq);
-      self->wrreq = NULL;
+      if (self->wrreqs[i] != NULL)
+        {
+          usbdev_freereq(self->epbulkin, self->wrreqs[i]);
+          self->wrreqs[i] = NULL;
+        }
     }
 
+  self->wrreq   = NULL;
+  self->nwrfree = 0;
+
   /* Free the bulk IN endpoint */
 
   if (self->epbulkin)
@@ -2763,15 +2845,33 @@ static int cdcncm_setup(FAR struct usbdevclass_driver_s *driver,
 
           case NCM_GET_NTB_INPUT_SIZE:
             uinfo("NCM_GET_NTB_INPUT_SIZE len %d\n", len);
-            ret = 0;
+            if (len >= 4)
+              {
+                FAR uint8_t *tmp = self->ctrlreq->buf;
+
+                cdcncm_put(&tmp, 4, self->ntbinsize);
+                ret = 4;
+              }
             break;
 
           case NCM_SET_NTB_INPUT_SIZE:
-            if (len == 4 && value == 0)
+
+            /* The host limits the size of the NTBs it receives, also when
+             * it takes fewer than the maximum offered.
+             */
+
+            if ((len == 4 || len == 8) && value == 0)
               {
-                uinfo("NCM_SET_NTB_INPUT_SIZE len %d NTB input size %d\n",
-                      len, *(FAR int *)dataout);
-                ret = 0;
+                FAR uint8_t *tmp = (FAR uint8_t *)dataout;
+                uint32_t size = cdcncm_get(&tmp, 4);
+
+                uinfo("NCM_SET_NTB_INPUT_SIZE len %d NTB input size %"
+                      PRIu32 "\n", len, size);
+                if (size >= NTB_MIN_IN_SIZE)
+                  {
+                    self->ntbinsize = MIN(size, NTB_DEFAULT_IN_SIZE);
+                    ret = 0;
+                  }
               }
             break;
 
@@ -88,6 +88,22 @@
 #  define CONFIG_USBMSC_NRDREQS 4
 #endif
 
+/* Number of sectors in the I/O buffer */
+
+#ifndef CONFIG_USBMSC_IOSECTORS
+#  define CONFIG_USBMSC_IOSECTORS 0
+#endif
+
+#if defined(CONFIG_USBMSC_WRMULTIPLE) || defined(CONFIG_USBMSC_RDMULTIPLE)
+#  if CONFIG_USBMSC_IOSECTORS > 0
+#    define USBMSC_IOSECTORS CONFIG_USBMSC_IOSECTORS
+#  else
+#    define USBMSC_IOSECTORS CONFIG_USBMSC_NWRREQS
+#  endif
+#else
+#  define USBMSC_IOSECTORS 1
+#endif
+
 /* Logical endpoint numbers / max packet sizes */
 
 #ifndef CONFIG_USBMSC_COMPOSITE
@@ -411,6 +427,7 @@ struct usbmsc_dev_s
   uint8_t           cdblen;           /* Length of cdb[] from CBW */
   uint8_t           cbwlun;           /* LUN from the CBW */
   uint16_t          nsectbytes;       /* Bytes buffered in iobuffer[] */
+  uint16_t          niobytes;         /* Bytes last read into iobuffer[] */
   uint16_t          nreqbytes;        /* Bytes buffered in head write requests */
   uint16_t          iosize;           /* Size of iobuffer[] */
   uint32_t          cbwlen;           /* Length of data from CBW */
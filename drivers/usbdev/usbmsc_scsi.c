@@ -95,6 +95,18 @@
 #  define USBMSC_STALL_RACEWAR 1
 #endif
 
+/* Bytes put in each bulk IN request of a SCSI read.  Only the last request
+ * of a transfer may end in a short packet.
+ */
+
+#ifdef CONFIG_USBMSC_RDMULTIPLE
+#  define USBMSC_INREQLEN(p) \
+     (CONFIG_USBMSC_BULKINREQLEN - \
+      CONFIG_USBMSC_BULKINREQLEN % (p)->epbulkin->maxpacket)
+#else
+#  define USBMSC_INREQLEN(p) ((p)->epbulkin->maxpacket)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -2234,7 +2246,8 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
  * State variables:
  *   xfrlen     - holds the number of sectors read to be read.
  *   sector     - holds the sector number of the next sector to be read
- *   nsectbytes - holds the number of bytes buffered for the current sector
+ *   nsectbytes - holds the number of bytes left in the I/O buffer
+ *   niobytes   - holds the number of bytes last read into the I/O buffer
  *   nreqbytes  - holds the number of bytes currently buffered in the request
  *                at the head of the wrreqlist.
  *
@@ -2265,10 +2278,18 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
 
       if (priv->nsectbytes <= 0)
         {
+#ifdef CONFIG_USBMSC_RDMULTIPLE
+          /* Yes.. read as many of the next sectors as the buffer holds */
+
+          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector,
+                                   MIN(priv->u.xfrlen,
+                                       priv->iosize / lun->sectorsize));
+#else
           /* Yes.. read the next sector */
 
           nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, 1);
-          if (nread < 0)
+#endif
+          if (nread <= 0)
             {
               usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL),
                        -nread);
@@ -2277,9 +2298,10 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
               break;
             }
 
-          priv->nsectbytes = lun->sectorsize;
-          priv->u.xfrlen--;
-          priv->sector++;
+          priv->niobytes   = nread * lun->sectorsize;
+          priv->nsectbytes = priv->niobytes;
+          priv->u.xfrlen  -= nread;
+          priv->sector    += nread;
         }
 
       /* Check if there is a request in the wrreqlist that we will be able to
@@ -2307,10 +2329,10 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
        * OR (2) all of the data available in the sector buffer.
        */
 
-      src    = &priv->iobuffer[lun->sectorsize - priv->nsectbytes];
+      src    = &priv->iobuffer[priv->niobytes - priv->nsectbytes];
       dest   = &req->buf[priv->nreqbytes];
 
-      nbytes = MIN(priv->epbulkin->maxpacket - priv->nreqbytes,
+      nbytes = MIN(USBMSC_INREQLEN(priv) - priv->nreqbytes,
                    priv->nsectbytes);
 
       /* Copy the data from the sector buffer to the USB request and update
@@ -2326,7 +2348,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
        * then submit the request
        */
 
-      if (priv->nreqbytes >= priv->epbulkin->maxpacket ||
+      if (priv->nreqbytes >= USBMSC_INREQLEN(priv) ||
           (priv->u.xfrlen <= 0 && priv->nsectbytes <= 0))
         {
           /* Remove the request that we just filled from wrreqlist (we've
@@ -2483,12 +2505,12 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
           priv->nreqbytes  -= nbytes;
 
 #ifdef CONFIG_USBMSC_WRMULTIPLE
-          uint32_t nrbufs = MIN(priv->u.xfrlen, CONFIG_USBMSC_NWRREQS);
+          uint32_t nrbufs = MIN(priv->u.xfrlen, USBMSC_IOSECTORS);
 
           /* Is the I/O buffer full? */
 
           if ((priv->nsectbytes >= lun->sectorsize * priv->u.xfrlen) ||
-              (priv->nsectbytes >= lun->sectorsize * CONFIG_USBMSC_NWRREQS))
+              (priv->nsectbytes >= lun->sectorsize * USBMSC_IOSECTORS))
             {
               /* Yes.. Write next sectors */
 
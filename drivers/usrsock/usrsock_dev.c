@@ -42,7 +42,9 @@
 
 #include <nuttx/random.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/queue.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/usrsock.h>
 
@@ -58,16 +60,25 @@
  * Private Types
  ****************************************************************************/
 
+struct usrsockdev_req_s
+{
+  sq_entry_t              node;   /* Entry in the pending request queue */
+  FAR const struct iovec *iov;    /* Request buffers */
+  int                     iovcnt; /* Number of request buffers */
+  size_t                  pos;    /* Reader position on request buffer */
+  int                     result; /* OK once the daemon has the request */
+  sem_t                   done;   /* Posted when the request is handed off */
+#if CONFIG_NET_USRSOCK_SEND_CREDITS > 0
+  FAR void               *buf;    /* Request owned by the device or NULL */
+  struct iovec            bufiov; /* I/O vector describing buf */
+#endif
+};
+
 struct usrsockdev_s
 {
-  mutex_t devlock; /* Lock for device node */
-  uint8_t ocount;  /* The number of times the device has been opened */
-  struct
-  {
-    FAR const struct iovec *iov;    /* Pending request buffers */
-    int                     iovcnt; /* Number of request buffers */
-    size_t                  pos;    /* Reader position on request buffer */
-  } req;
+  mutex_t    devlock; /* Lock for device node */
+  uint8_t    ocount;  /* The number of times the device has been opened */
+  sq_queue_t req;     /* Pending requests, the daemon reads the head */
   FAR struct pollfd *pollfds[CONFIG_NET_USRSOCKDEV_NPOLLWAITERS];
 };
 
@@ -130,6 +141,92 @@ static bool usrsockdev_is_opened(FAR struct usrsockdev_s *dev)
   return ret;
 }
 
+/****************************************************************************
+ * Name: usrsockdev_xid
+ ****************************************************************************/
+
+static uint32_t usrsockdev_xid(FAR struct usrsockdev_req_s *req)
+{
+  FAR const struct usrsock_request_common_s *head = req->iov[0].iov_base;
+
+  return head->xid;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_consumed
+ *
+ * Description:
+ *   Return true if the daemon has read all of the request.
+ *
+ ****************************************************************************/
+
+static bool usrsockdev_consumed(FAR struct usrsockdev_req_s *req)
+{
+  return usrsock_iovec_get(NULL, 0, req->iov, req->iovcnt, req->pos,
+                           NULL) < 0;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_complete
+ *
+ * Description:
+ *   Remove the request at the head of the queue and release its sender.
+ *
+ ****************************************************************************/
+
+static void usrsockdev_complete(FAR struct usrsockdev_s *dev, int result)
+{
+  FAR struct usrsockdev_req_s *req;
+
+  req = (FAR struct usrsockdev_req_s *)sq_remfirst(&dev->req);
+  DEBUGASSERT(req != NULL);
+
+#if CONFIG_NET_USRSOCK_SEND_CREDITS > 0
+  if (req->buf != NULL)
+    {
+      /* Nobody waits for a request owned by the device */
+
+      kmm_free(req->buf);
+      kmm_free(req);
+      return;
+    }
+#endif
+
+  req->result = result;
+  nxsem_post(&req->done);
+}
+
+/****************************************************************************
+ * Name: usrsockdev_enqueue
+ ****************************************************************************/
+
+static int usrsockdev_enqueue(FAR struct usrsockdev_s *dev,
+                              FAR struct usrsockdev_req_s *req)
+{
+  int ret = OK;
+
+  /* Set outstanding request for daemon to handle. */
+
+  usrsock_mutex_timedlock(&dev->devlock, UINT_MAX);
+
+  if (usrsockdev_is_opened(dev))
+    {
+      sq_addlast(&req->node, &dev->req);
+
+      /* Notify daemon of new request. */
+
+      poll_notify(dev->pollfds, nitems(dev->pollfds), POLLIN);
+    }
+  else
+    {
+      ninfo("daemon abruptly closed /dev/usrsock.\n");
+      ret = -ENETDOWN;
+    }
+
+  nxmutex_unlock(&dev->devlock);
+  return ret;
+}
+
 /****************************************************************************
  * Name: usrsockdev_read
  ****************************************************************************/
@@ -139,6 +236,7 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
 {
   FAR struct inode *inode = filep->f_inode;
   FAR struct usrsockdev_s *dev;
+  ssize_t total = 0;
   int ret;
 
   if (len == 0)
@@ -161,35 +259,38 @@ static ssize_t usrsockdev_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
-  /* Is request available? */
+  /* Copy requests to user-space.  Once the head request has been read
+   * completely its sender is released, and the rest of the buffer is
+   * filled from the next one, so that several queued requests can be
+   * fetched with a single read.
+   */
 
-  if (dev->req.iov)
+  while (len > 0 && !sq_empty(&dev->req))
     {
+      FAR struct usrsockdev_req_s *req =
+        (FAR struct usrsockdev_req_s *)sq_peek(&dev->req);
       ssize_t rlen;
 
-      /* Copy request to user-space. */
-
-      rlen = usrsock_iovec_get(buffer, len, dev->req.iov, dev->req.iovcnt,
-                               dev->req.pos, NULL);
-      if (rlen < 0)
+      rlen = usrsock_iovec_get(buffer, len, req->iov, req->iovcnt,
+                               req->pos, NULL);
+      if (rlen > 0)
         {
-          /* Tried reading beyond buffer. */
-
-          len = 0;
+          req->pos += rlen;
+          buffer   += rlen;
+          len      -= rlen;
+          total    += rlen;
         }
-      else
+
+      if (!usrsockdev_consumed(req))
         {
-          dev->req.pos += rlen;
-          len = rlen;
+          break;
         }
-    }
-  else
-    {
-      len = 0;
+
+      usrsockdev_complete(dev, OK);
     }
 
   nxmutex_unlock(&dev->devlock);
-  return len;
+  return total;
 }
 
 /****************************************************************************
@@ -221,13 +322,15 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset,
 
   /* Is request available? */
 
-  if (dev->req.iov)
+  if (!sq_empty(&dev->req))
     {
+      FAR struct usrsockdev_req_s *req =
+        (FAR struct usrsockdev_req_s *)sq_peek(&dev->req);
       ssize_t rlen;
 
       if (whence == SEEK_CUR)
         {
-          pos = dev->req.pos + offset;
+          pos = req->pos + offset;
         }
       else
         {
@@ -236,8 +339,7 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset,
 
       /* Copy request to user-space. */
 
-      rlen = usrsock_iovec_get(NULL, 0, dev->req.iov, dev->req.iovcnt,
-                               pos, NULL);
+      rlen = usrsock_iovec_get(NULL, 0, req->iov, req->iovcnt, pos, NULL);
       if (rlen < 0)
         {
           /* Tried seek beyond buffer. */
@@ -246,7 +348,7 @@ static off_t usrsockdev_seek(FAR struct file *filep, off_t offset,
         }
       else
         {
-          dev->req.pos = pos;
+          req->pos = pos;
         }
     }
   else
@@ -291,11 +393,21 @@ static ssize_t usrsockdev_write(FAR struct file *filep,
     }
 
   ret = usrsock_response(buffer, len, &req_done);
-  if (req_done && dev->req.iov)
+  if (req_done && !sq_empty(&dev->req))
     {
-      dev->req.iov = NULL;
-      dev->req.pos = 0;
-      dev->req.iovcnt = 0;
+      FAR const struct usrsock_message_req_ack_s *hdr =
+        (FAR const struct usrsock_message_req_ack_s *)buffer;
+      FAR struct usrsockdev_req_s *req =
+        (FAR struct usrsockdev_req_s *)sq_peek(&dev->req);
+
+      /* The daemon answered the request it was reading without reading
+       * all of it.
+       */
+
+      if (req->pos > 0 && usrsockdev_xid(req) == hdr->xid)
+        {
+          usrsockdev_complete(dev, OK);
+        }
     }
 
   nxmutex_unlock(&dev->devlock);
@@ -373,9 +485,13 @@ static int usrsockdev_close(FAR struct file *filep)
   dev->ocount--;
   DEBUGASSERT(dev->ocount == 0);
   ret = OK;
-  dev->req.iov = NULL;
-  dev->req.iovcnt = 0;
-  dev->req.pos = 0;
+
+  /* Fail the requests that the daemon will never read */
+
+  while (!sq_empty(&dev->req))
+    {
+      usrsockdev_complete(dev, -ENETDOWN);
+    }
 
   nxmutex_unlock(&dev->devlock);
   usrsock_abort();
@@ -445,9 +561,7 @@ static int usrsockdev_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       /* Notify the POLLIN event if pending request. */
 
-      if (dev->req.iov != NULL &&
-          !(usrsock_iovec_get(NULL, 0, dev->req.iov,
-                              dev->req.iovcnt, dev->req.pos, NULL) < 0))
+      if (!sq_empty(&dev->req))
         {
           poll_notify(&fds, 1, POLLIN);
         }
@@ -486,32 +600,63 @@ errout:
 int usrsock_request(FAR struct iovec *iov, unsigned int iovcnt)
 {
   FAR struct usrsockdev_s *dev = &g_usrsockdev;
-  int ret = 0;
-
-  /* Set outstanding request for daemon to handle. */
+  struct usrsockdev_req_s req;
+  int ret;
 
-  usrsock_mutex_timedlock(&dev->devlock, UINT_MAX);
+  memset(&req, 0, sizeof(req));
+  req.iov    = iov;
+  req.iovcnt = iovcnt;
+  nxsem_init(&req.done, 0, 0);
 
-  if (usrsockdev_is_opened(dev))
+  ret = usrsockdev_enqueue(dev, &req);
+  if (ret >= 0)
     {
-      DEBUGASSERT(dev->req.iov == NULL);
-      dev->req.iov = iov;
-      dev->req.pos = 0;
-      dev->req.iovcnt = iovcnt;
+      /* The request buffers belong to the caller, wait until the daemon
+       * has read them (or answered the request without reading it all).
+       */
 
-      /* Notify daemon of new request. */
+      usrsock_sem_timedwait(&req.done, false, UINT_MAX);
+      ret = req.result;
+    }
 
-      poll_notify(dev->pollfds, nitems(dev->pollfds), POLLIN);
+  nxsem_destroy(&req.done);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: usrsock_request_buffer
+ ****************************************************************************/
+
+#if CONFIG_NET_USRSOCK_SEND_CREDITS > 0
+int usrsock_request_buffer(FAR void *buf, size_t len)
+{
+  FAR struct usrsockdev_s *dev = &g_usrsockdev;
+  FAR struct usrsockdev_req_s *req;
+  int ret;
+
+  req = kmm_zalloc(sizeof(*req));
+  if (req == NULL)
+    {
+      kmm_free(buf);
+      return -ENOMEM;
     }
-  else
+
+  req->buf             = buf;
+  req->bufiov.iov_base = buf;
+  req->bufiov.iov_len  = len;
+  req->iov             = &req->bufiov;
+  req->iovcnt          = 1;
+
+  ret = usrsockdev_enqueue(dev, req);
+  if (ret < 0)
     {
-      ninfo("daemon abruptly closed /dev/usrsock.\n");
-      ret = -ENETDOWN;
+      kmm_free(buf);
+      kmm_free(req);
     }
 
-  nxmutex_unlock(&dev->devlock);
   return ret;
 }
+#endif
 
 /****************************************************************************
  * Name: usrsock_register
@@ -24,6 +24,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/net/dns.h>
 #include <nuttx/net/net.h>
 #include <nuttx/rpmsg/rpmsg.h>
@@ -246,6 +247,27 @@ int usrsock_request(FAR struct iovec *iov, unsigned int iovcnt)
   return ret;
 }
 
+/****************************************************************************
+ * Name: usrsock_request_buffer
+ ****************************************************************************/
+
+#if CONFIG_NET_USRSOCK_SEND_CREDITS > 0
+int usrsock_request_buffer(FAR void *buf, size_t len)
+{
+  struct iovec iov;
+  int ret;
+
+  iov.iov_base = buf;
+  iov.iov_len  = len;
+
+  /* usrsock_request() copies the request into the RPMSG buffers */
+
+  ret = usrsock_request(&iov, 1);
+  kmm_free(buf);
+  return ret;
+}
+#endif
+
 void usrsock_register(void)
 {
   rpmsg_register_callback(&g_usrsock_rpmsg,
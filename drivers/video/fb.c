@@ -28,6 +28,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -46,6 +47,8 @@
 #include <nuttx/wdog.h>
 #include <nuttx/circbuf.h>
 #include <nuttx/sched_note.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
 
 #ifdef CONFIG_VIDEO_FB_SPLASHSCREEN
 #  include <nuttx/signal.h>
@@ -75,6 +78,10 @@
 #
 #endif /* CONFIG_VIDEO_FB_SPLASHSCREEN */
 
+#ifdef CONFIG_FB_DAMAGE
+#  define FB_DAMAGE_DELAY MSEC2TICK(CONFIG_FB_DAMAGE_INTERVAL)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -117,6 +124,16 @@ struct fb_chardev_s
   FAR struct fb_priv_s    *head;
   FAR struct fb_paninfo_s *paninfo;       /* Pan info array                  */
   size_t                   paninfo_count; /* Pan info count                  */
+#ifdef CONFIG_FB_DAMAGE
+  spinlock_t               damagelock;    /* Protects the damage list        */
+  struct work_s            damagework;    /* Flushes the damage list         */
+  struct fb_area_s         damage[CONFIG_FB_DAMAGE_NRECTS];
+  uint8_t                  ndamage;       /* Number of damaged areas         */
+  uint8_t                  bpp;           /* Geometry of the primary plane   */
+  fb_coord_t               xres;
+  fb_coord_t               yres;
+  fb_coord_t               stride;
+#endif
 };
 
 struct fb_panelinfo_s
@@ -163,12 +180,24 @@ static int     fb_sem_wait(FAR struct fb_chardev_s *fb,
 static void    fb_sem_post(FAR struct fb_chardev_s *fb, int overlay);
 #endif
 
-#ifdef CONFIG_BUILD_KERNEL
+#if defined(CONFIG_BUILD_KERNEL) || defined(CONFIG_FB_DAMAGE)
 static int     fb_munmap(FAR struct task_group_s *group,
                          FAR struct mm_map_entry_s *entry,
                          FAR void *start, size_t length);
 #endif
 
+#ifdef CONFIG_FB_DAMAGE
+static void    fb_damage_init(FAR struct fb_chardev_s *fb,
+                              FAR const struct fb_videoinfo_s *vinfo);
+static void    fb_damage_add(FAR struct fb_chardev_s *fb,
+                             FAR const struct fb_area_s *area);
+static void    fb_damage_range(FAR struct fb_chardev_s *fb,
+                               size_t start, size_t end);
+static int     fb_msync(FAR struct mm_map_entry_s *entry, FAR void *start,
+                        size_t length, int flags);
+static void    fb_damage_worker(FAR void *arg);
+#endif
+
 #ifdef CONFIG_VIDEO_FB_SPLASHSCREEN
 static int fb_splashscreen(FAR struct fb_videoinfo_s *vinfo,
                            FAR struct fb_planeinfo_s *pinfo);
@@ -648,6 +677,14 @@ static ssize_t fb_write(FAR struct file *filep, FAR const char *buffer,
 
   memcpy(panelinfo.fbmem + start, buffer, size);
   filep->f_pos += size;
+
+#ifdef CONFIG_FB_DAMAGE
+  if (priv->overlay == FB_NO_OVERLAY)
+    {
+      fb_damage_range(fb, start, end);
+    }
+#endif
+
   return size;
 }
 
@@ -867,7 +904,14 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               break;
             }
 
+#ifdef CONFIG_FB_DAMAGE
+          /* Merged with the other damage and flushed later */
+
+          fb_damage_add(fb, area);
+          ret = OK;
+#else
           ret = fb->vtable->updatearea(fb->vtable, area);
+#endif
         }
         break;
 #endif
@@ -1330,7 +1374,7 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
-#ifdef CONFIG_BUILD_KERNEL
+#if defined(CONFIG_BUILD_KERNEL) || defined(CONFIG_FB_DAMAGE)
 static int fb_munmap(FAR struct task_group_s *group,
                      FAR struct mm_map_entry_s *entry,
                      FAR void *start, size_t length)
@@ -1338,7 +1382,9 @@ static int fb_munmap(FAR struct task_group_s *group,
   if (group && entry)
     {
       ginfo("%p, len=%zu\n", entry->vaddr, entry->length);
+#ifdef CONFIG_BUILD_KERNEL
       vm_unmap_region(entry->vaddr, entry->length);
+#endif
       mm_map_remove(get_current_mm(), entry);
     }
 
@@ -1376,6 +1422,16 @@ static int fb_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
   if (map->offset >= 0 && map->offset < panelinfo.fblen &&
       map->length && map->offset + map->length <= panelinfo.fblen)
     {
+#ifdef CONFIG_FB_DAMAGE
+      /* msync() on the mapping marks the synced range as damaged */
+
+      if (priv->overlay == FB_NO_OVERLAY)
+        {
+          map->priv.p = fb;
+          map->msync  = fb_msync;
+        }
+#endif
+
 #ifdef CONFIG_BUILD_KERNEL
       map->vaddr = vm_map_region((uintptr_t)panelinfo.fbmem + map->offset,
                                  panelinfo.fblen);
@@ -1384,7 +1440,17 @@ static int fb_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
       mm_map_add(get_current_mm(), map);
 #else
       map->vaddr = (FAR char *)panelinfo.fbmem + map->offset;
+#  ifdef CONFIG_FB_DAMAGE
+      if (map->msync != NULL)
+        {
+          /* The mapping must be known for msync() to find it */
+
+          map->munmap = fb_munmap;
+          mm_map_add(get_current_mm(), map);
+        }
+#  endif
 #endif
+
       return OK;
     }
 
@@ -1544,6 +1610,220 @@ static int fb_get_planeinfo(FAR struct fb_chardev_s *fb,
   return OK;
 }
 
+#ifdef CONFIG_FB_DAMAGE
+/****************************************************************************
+ * Name: fb_damage_init
+ ****************************************************************************/
+
+static void fb_damage_init(FAR struct fb_chardev_s *fb,
+                           FAR const struct fb_videoinfo_s *vinfo)
+{
+  struct fb_planeinfo_s pinfo;
+
+  spin_lock_init(&fb->damagelock);
+  if (fb_get_planeinfo(fb, &pinfo, 0) >= 0 && pinfo.bpp > 0)
+    {
+      fb->bpp    = pinfo.bpp;
+      fb->stride = pinfo.stride;
+      fb->xres   = vinfo->xres;
+      fb->yres   = vinfo->yres;
+    }
+}
+
+/****************************************************************************
+ * Name: fb_damage_union
+ ****************************************************************************/
+
+static void fb_damage_union(FAR struct fb_area_s *dst,
+                            FAR const struct fb_area_s *src)
+{
+  fb_coord_t x1 = MAX(dst->x + dst->w, src->x + src->w);
+  fb_coord_t y1 = MAX(dst->y + dst->h, src->y + src->h);
+
+  dst->x = MIN(dst->x, src->x);
+  dst->y = MIN(dst->y, src->y);
+  dst->w = x1 - dst->x;
+  dst->h = y1 - dst->y;
+}
+
+/****************************************************************************
+ * Name: fb_damage_add
+ *
+ * Description:
+ *   Add an area to the damage list.  Overlapping or touching areas are
+ *   merged; when the list is full, the new area is merged with the one
+ *   growing the least.
+ *
+ ****************************************************************************/
+
+static void fb_damage_add(FAR struct fb_chardev_s *fb,
+                          FAR const struct fb_area_s *area)
+{
+  FAR struct fb_area_s *d;
+  struct fb_area_s merged;
+  struct fb_area_s tmp;
+  irqstate_t flags;
+  uint32_t growth;
+  uint32_t best;
+  bool kick;
+  int i;
+  int j;
+
+  if (fb->vtable->updatearea == NULL ||
+      area->x >= fb->xres || area->y >= fb->yres ||
+      area->w == 0 || area->h == 0)
+    {
+      return;
+    }
+
+  merged   = *area;
+  merged.w = MIN(merged.w, fb->xres - merged.x);
+  merged.h = MIN(merged.h, fb->yres - merged.y);
+
+  flags = spin_lock_irqsave(&fb->damagelock);
+  kick  = fb->ndamage == 0;
+
+  for (i = 0; i < fb->ndamage; )
+    {
+      d = &fb->damage[i];
+      if (d->x <= merged.x + merged.w && merged.x <= d->x + d->w &&
+          d->y <= merged.y + merged.h && merged.y <= d->y + d->h)
+        {
+          /* Take it out and start over, the union may touch others */
+
+          fb_damage_union(&merged, d);
+          *d = fb->damage[--fb->ndamage];
+          i  = 0;
+        }
+      else
+        {
+          i++;
+        }
+    }
+
+  if (fb->ndamage == CONFIG_FB_DAMAGE_NRECTS)
+    {
+      best = UINT32_MAX;
+      j    = 0;
+
+      for (i = 0; i < fb->ndamage; i++)
+        {
+          d   = &fb->damage[i];
+          tmp = *d;
+          fb_damage_union(&tmp, &merged);
+          growth = (uint32_t)tmp.w * tmp.h - (uint32_t)d->w * d->h;
+          if (growth < best)
+            {
+              best = growth;
+              j    = i;
+            }
+        }
+
+      fb_damage_union(&merged, &fb->damage[j]);
+      fb->damage[j] = fb->damage[--fb->ndamage];
+    }
+
+  fb->damage[fb->ndamage++] = merged;
+  spin_unlock_irqrestore(&fb->damagelock, flags);
+
+  /* With no interval the flush waits for the next vsync instead */
+
+  if (kick && CONFIG_FB_DAMAGE_INTERVAL > 0 &&
+      work_available(&fb->damagework))
+    {
+      work_queue(LPWORK, &fb->damagework, fb_damage_worker, fb,
+                 FB_DAMAGE_DELAY);
+    }
+}
+
+/****************************************************************************
+ * Name: fb_damage_range
+ *
+ * Description:
+ *   Mark the rows of a byte range of the primary plane as damaged, only
+ *   the columns are kept for a range within a single row.
+ *
+ ****************************************************************************/
+
+static void fb_damage_range(FAR struct fb_chardev_s *fb,
+                            size_t start, size_t end)
+{
+  struct fb_area_s area;
+  size_t first;
+  size_t last;
+
+  if (fb->stride == 0 || end <= start)
+    {
+      return;
+    }
+
+  first = start / fb->stride;
+  last  = (end - 1) / fb->stride;
+  if (first >= fb->yres)
+    {
+      return;
+    }
+
+  area.y = first;
+  area.h = MIN(last, fb->yres - 1) - first + 1;
+  if (first == last)
+    {
+      area.x = (start % fb->stride) * 8 / fb->bpp;
+      area.w = ((end - 1) % fb->stride) * 8 / fb->bpp - area.x + 1;
+    }
+  else
+    {
+      area.x = 0;
+      area.w = fb->xres;
+    }
+
+  fb_damage_add(fb, &area);
+}
+
+/****************************************************************************
+ * Name: fb_msync
+ ****************************************************************************/
+
+static int fb_msync(FAR struct mm_map_entry_s *entry, FAR void *start,
+                    size_t length, int flags)
+{
+  size_t offset = entry->offset +
+                  ((uintptr_t)start - (uintptr_t)entry->vaddr);
+
+  fb_damage_range(entry->priv.p, offset, offset + length);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fb_damage_worker
+ *
+ * Description:
+ *   Flush the damaged areas through updatearea(), the transfer of each
+ *   area is up to the lower half, usually by DMA.
+ *
+ ****************************************************************************/
+
+static void fb_damage_worker(FAR void *arg)
+{
+  FAR struct fb_chardev_s *fb = arg;
+  struct fb_area_s damage[CONFIG_FB_DAMAGE_NRECTS];
+  irqstate_t flags;
+  int ndamage;
+  int i;
+
+  flags   = spin_lock_irqsave(&fb->damagelock);
+  ndamage = fb->ndamage;
+  memcpy(damage, fb->damage, ndamage * sizeof(struct fb_area_s));
+  fb->ndamage = 0;
+  spin_unlock_irqrestore(&fb->damagelock, flags);
+
+  for (i = 0; i < ndamage; i++)
+    {
+      fb->vtable->updatearea(fb->vtable, &damage[i]);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: fb_do_pollnotify
  ****************************************************************************/
@@ -1707,6 +1987,15 @@ void fb_notify_vsync(FAR struct fb_vtable_s *vtable)
         }
 
       leave_critical_section(flags);
+
+#if defined(CONFIG_FB_DAMAGE) && CONFIG_FB_DAMAGE_INTERVAL == 0
+      /* Flush the damage of the last frame in the blanking period */
+
+      if (fb->ndamage > 0 && work_available(&fb->damagework))
+        {
+          work_queue(LPWORK, &fb->damagework, fb_damage_worker, fb, 0);
+        }
+#endif
     }
 }
 
@@ -1978,6 +2267,10 @@ int fb_register_device(int display, int plane,
       snprintf(devname, sizeof(devname), "/dev/fb%d.%d", display, plane);
     }
 
+#ifdef CONFIG_FB_DAMAGE
+  fb_damage_init(fb, &vinfo);
+#endif
+
   ret = register_driver(devname, &g_fb_fops, 0666, fb);
 
   if (ret < 0)
@@ -32,6 +32,7 @@
 #include <poll.h>
 
 #include <nuttx/mutex.h>
+#include <nuttx/video/dmabuf.h>
 #include <nuttx/video/v4l2_cap.h>
 #include <nuttx/video/video.h>
 
@@ -181,6 +182,9 @@ struct capture_mng_s
   enum v4l2_scene_mode   capture_scene_mode;
   uint8_t                capture_scence_num;
   FAR capture_scene_params_t *capture_scene_param[V4L2_SCENE_MODE_MAX];
+#ifdef CONFIG_VIDEO_DMABUF
+  uint8_t                nexported;  /* Buffers exported by VIDIOC_EXPBUF */
+#endif
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   bool                   unlinked;
 #endif
@@ -217,6 +221,7 @@ static int validate_frame_setting(FAR capture_mng_t *cmng,
                                   FAR struct v4l2_rect *clip,
                                   FAR struct v4l2_fract *interval);
 static size_t get_bufsize(FAR video_format_t *vf);
+static bool capture_put(FAR capture_mng_t *cmng);
 
 /* ioctl function for each cmds of ioctl */
 
@@ -292,6 +297,10 @@ static int capture_enum_frmsize(FAR struct file *filep,
 
 static int capture_open(FAR struct file *filep);
 static int capture_close(FAR struct file *filep);
+#ifdef CONFIG_VIDEO_DMABUF
+static int capture_expbuf(FAR struct file *filep,
+                          FAR struct v4l2_exportbuffer *expbuf);
+#endif
 static int capture_mmap(FAR struct file *filep,
                         FAR struct mm_map_entry_s *map);
 static int capture_poll(FAR struct file *filep,
@@ -339,7 +348,15 @@ static const struct v4l2_ops_s g_capture_vops =
   capture_s_ext_ctrls_scene,          /* s_ext_ctrls_scene */
   capture_enum_fmt,                   /* enum_fmt */
   capture_enum_frminterval,           /* enum_frminterval */
-  capture_enum_frmsize                /* enum_frmsize */
+  capture_enum_frmsize,               /* enum_frmsize */
+  NULL,                               /* cropcap */
+  NULL,                               /* dqevent */
+  NULL,                               /* subscribe_event */
+  NULL,                               /* decoder_cmd */
+  NULL,                               /* encoder_cmd */
+#ifdef CONFIG_VIDEO_DMABUF
+  capture_expbuf                      /* expbuf */
+#endif
 };
 
 static const struct file_operations g_capture_fops =
@@ -1249,6 +1266,35 @@ static void cleanup_resources(FAR capture_mng_t *cmng)
   cleanup_scenes_parameter(cmng);
 }
 
+/* Drop a reference taken by open or by an exported buffer, return true if
+ * the unlinked driver is freed with it.
+ */
+
+static bool capture_put(FAR capture_mng_t *cmng)
+{
+  nxmutex_lock(&cmng->lock_open_num);
+
+  if (--cmng->open_num == 0)
+    {
+      cleanup_resources(cmng);
+      IMGSENSOR_UNINIT(cmng->imgsensor);
+      IMGDATA_UNINIT(cmng->imgdata);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+      if (cmng->unlinked)
+        {
+          nxmutex_unlock(&cmng->lock_open_num);
+          nxmutex_destroy(&cmng->lock_open_num);
+          kmm_free(cmng);
+          return true;
+        }
+
+#endif
+    }
+
+  nxmutex_unlock(&cmng->lock_open_num);
+  return false;
+}
+
 static bool is_sem_waited(FAR sem_t *sem)
 {
   int semcount;
@@ -2162,6 +2208,14 @@ static int capture_reqbufs(FAR struct file *filep,
 
       ret = -EPERM;
     }
+#ifdef CONFIG_VIDEO_DMABUF
+  else if (cmng->nexported > 0 && reqbufs->memory == V4L2_MEMORY_MMAP)
+    {
+      /* The exported buffers are still used by someone */
+
+      ret = -EBUSY;
+    }
+#endif
   else
     {
       if (reqbufs->count > V4L2_REQBUFS_COUNT_MAX)
@@ -2247,6 +2301,9 @@ static int capture_qbuf(FAR struct file *filep,
   FAR vbuf_container_t *container;
   enum capture_state_e next_capture_state;
   irqstate_t flags;
+#ifdef CONFIG_VIDEO_DMABUF
+  int ret;
+#endif
 
   if (cmng == NULL || buf == NULL)
     {
@@ -2279,6 +2336,17 @@ static int capture_qbuf(FAR struct file *filep,
       container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
                                  container->buf.length * buf->index);
     }
+#ifdef CONFIG_VIDEO_DMABUF
+  else
+    {
+      ret = video_framebuff_import(container);
+      if (ret < 0)
+        {
+          video_framebuff_free_container(&type_inf->bufinf, container);
+          return ret;
+        }
+    }
+#endif
 
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
@@ -2393,7 +2461,11 @@ static int capture_dqbuf(FAR struct file *filep,
       type_inf->wait_capture.done_container = NULL;
     }
 
+#ifdef CONFIG_VIDEO_DMABUF
+  video_framebuff_get_buf(container, buf);
+#else
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
+#endif
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   return OK;
@@ -3537,6 +3609,69 @@ static int capture_enum_frminterval(FAR struct file *filep,
   return 0;
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static void capture_expbuf_release(FAR void *arg)
+{
+  FAR capture_mng_t *cmng = arg;
+
+  nxmutex_lock(&cmng->lock_open_num);
+  cmng->nexported--;
+  nxmutex_unlock(&cmng->lock_open_num);
+
+  capture_put(cmng);
+}
+
+/* The exported buffer keeps the driver open, so the buffer heap lives
+ * until the last descriptor of it is closed.
+ */
+
+static int capture_expbuf(FAR struct file *filep,
+                          FAR struct v4l2_exportbuffer *expbuf)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR capture_mng_t *cmng = inode->i_private;
+  FAR capture_type_inf_t *type_inf;
+  size_t bufsize;
+  int ret;
+
+  if (cmng == NULL || expbuf == NULL || expbuf->plane != 0)
+    {
+      return -EINVAL;
+    }
+
+  type_inf = get_capture_type_inf(cmng, expbuf->type);
+  if (type_inf == NULL || type_inf->bufheap == NULL ||
+      expbuf->index >= type_inf->bufinf.container_size)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&cmng->lock_open_num);
+  if (cmng->open_num == UINT8_MAX || cmng->nexported == UINT8_MAX)
+    {
+      nxmutex_unlock(&cmng->lock_open_num);
+      return -EMFILE;
+    }
+
+  cmng->open_num++;
+  cmng->nexported++;
+  nxmutex_unlock(&cmng->lock_open_num);
+
+  bufsize = get_bufsize(&type_inf->fmt[CAPTURE_FMT_MAIN]);
+  ret = video_dmabuf_export(type_inf->bufheap + bufsize * expbuf->index,
+                            bufsize, expbuf->flags,
+                            capture_expbuf_release, cmng);
+  if (ret < 0)
+    {
+      capture_expbuf_release(cmng);
+      return ret;
+    }
+
+  expbuf->fd = ret;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * File Opterations Functions
  ****************************************************************************/
@@ -3593,27 +3728,11 @@ static int capture_close(FAR struct file *filep)
       return -EINVAL;
     }
 
-  nxmutex_lock(&cmng->lock_open_num);
-
-  if (--cmng->open_num == 0)
+  if (capture_put(cmng))
     {
-      cleanup_resources(cmng);
-      IMGSENSOR_UNINIT(cmng->imgsensor);
-      IMGDATA_UNINIT(cmng->imgdata);
-#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
-      if (cmng->unlinked)
-        {
-          nxmutex_unlock(&cmng->lock_open_num);
-          nxmutex_destroy(&cmng->lock_open_num);
-          kmm_free(cmng);
-          inode->i_private = NULL;
-          return OK;
-        }
-
-#endif
+      inode->i_private = NULL;
     }
 
-  nxmutex_unlock(&cmng->lock_open_num);
   return OK;
 }
 
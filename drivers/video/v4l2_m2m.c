@@ -371,6 +371,9 @@ static int codec_qbuf(FAR struct file *filep,
   FAR codec_type_inf_t *type_inf;
   FAR vbuf_container_t *container;
   size_t buf_size;
+#ifdef CONFIG_VIDEO_DMABUF
+  int ret;
+#endif
 
   if (buf == NULL)
     {
@@ -413,6 +416,19 @@ static int codec_qbuf(FAR struct file *filep,
       container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
                                  container->buf.length * buf->index);
     }
+#ifdef CONFIG_VIDEO_DMABUF
+  else
+    {
+      /* A buffer exported by another device, e.g. a captured frame */
+
+      ret = video_framebuff_import(container);
+      if (ret < 0)
+        {
+          video_framebuff_free_container(&type_inf->bufinf, container);
+          return ret;
+        }
+    }
+#endif
 
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
@@ -460,7 +476,11 @@ static int codec_dqbuf(FAR struct file *filep,
       return -EAGAIN;
     }
 
+#ifdef CONFIG_VIDEO_DMABUF
+  video_framebuff_get_buf(container, buf);
+#else
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
+#endif
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   vinfo("%s dequeue done\n", V4L2_TYPE_IS_OUTPUT(buf->type) ?
@@ -0,0 +1,189 @@
+/****************************************************************************
+ * drivers/video/video_dmabuf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/video/dmabuf.h>
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int dmabuf_open(FAR struct file *filep);
+static int dmabuf_close(FAR struct file *filep);
+static int dmabuf_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_dmabuf_fops =
+{
+  dmabuf_open,  /* open */
+  dmabuf_close, /* close */
+  NULL,         /* read */
+  NULL,         /* write */
+  NULL,         /* seek */
+  NULL,         /* ioctl */
+  dmabuf_mmap,  /* mmap */
+};
+
+static struct inode g_dmabuf_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_dmabuf_fops        /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* dup() of a descriptor opens the inode again */
+
+static int dmabuf_open(FAR struct file *filep)
+{
+  FAR struct dmabuf_s *buf = filep->f_priv;
+
+  atomic_fetch_add(&buf->refs, 1);
+  return OK;
+}
+
+static int dmabuf_close(FAR struct file *filep)
+{
+  video_dmabuf_put(filep->f_priv);
+  return OK;
+}
+
+static int dmabuf_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct dmabuf_s *buf = filep->f_priv;
+
+  if (map->offset < 0 || map->offset >= buf->len ||
+      map->length == 0 || map->length > buf->len - map->offset)
+    {
+      return -EINVAL;
+    }
+
+  map->vaddr = (FAR uint8_t *)buf->addr + map->offset;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: video_dmabuf_export
+ ****************************************************************************/
+
+int video_dmabuf_export(FAR void *addr, size_t len, int oflags,
+                        dmabuf_release_t release, FAR void *arg)
+{
+  FAR struct dmabuf_s *buf;
+  int fd;
+
+  if (addr == NULL || len == 0)
+    {
+      return -EINVAL;
+    }
+
+  buf = kmm_zalloc(sizeof(*buf));
+  if (buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  buf->addr    = addr;
+  buf->len     = len;
+  buf->release = release;
+  buf->arg     = arg;
+  atomic_set(&buf->refs, 1);
+
+  fd = file_allocate_from_inode(&g_dmabuf_inode,
+                                (oflags & (O_ACCMODE | O_CLOEXEC)) |
+                                O_RDOK, 0, buf, 0);
+  if (fd < 0)
+    {
+      kmm_free(buf);
+    }
+
+  return fd;
+}
+
+/****************************************************************************
+ * Name: video_dmabuf_get
+ ****************************************************************************/
+
+FAR struct dmabuf_s *video_dmabuf_get(int fd)
+{
+  FAR struct dmabuf_s *buf = NULL;
+  FAR struct file *filep;
+
+  if (file_get(fd, &filep) < 0)
+    {
+      return NULL;
+    }
+
+  if (filep->f_inode == &g_dmabuf_inode)
+    {
+      buf = filep->f_priv;
+      atomic_fetch_add(&buf->refs, 1);
+    }
+
+  file_put(filep);
+  return buf;
+}
+
+/****************************************************************************
+ * Name: video_dmabuf_put
+ ****************************************************************************/
+
+void video_dmabuf_put(FAR struct dmabuf_s *buf)
+{
+  if (atomic_fetch_sub(&buf->refs, 1) == 1)
+    {
+      if (buf->release != NULL)
+        {
+          buf->release(buf->arg);
+        }
+
+      kmm_free(buf);
+    }
+}
@@ -54,6 +54,17 @@ static void init_buf_chain(video_framebuff_t *fbuf)
     }
 }
 
+#ifdef CONFIG_VIDEO_DMABUF
+static void release_import(vbuf_container_t *cnt)
+{
+  if (cnt->dmabuf != NULL)
+    {
+      video_dmabuf_put(cnt->dmabuf);
+      cnt->dmabuf = NULL;
+    }
+}
+#endif
+
 static inline bool is_last_one(video_framebuff_t *fbuf)
 {
   return fbuf->vbuf_top == fbuf->vbuf_tail;
@@ -103,6 +114,9 @@ void video_framebuff_uninit(video_framebuff_t *fbuf)
 int video_framebuff_realloc_container(video_framebuff_t *fbuf, int sz)
 {
   vbuf_container_t *vbuf;
+#ifdef CONFIG_VIDEO_DMABUF
+  int i;
+#endif
 
   nxmutex_lock(&fbuf->lock_empty);
   if (fbuf->container_size == sz)
@@ -111,6 +125,15 @@ int video_framebuff_realloc_container(video_framebuff_t *fbuf, int sz)
       return OK;
     }
 
+#ifdef CONFIG_VIDEO_DMABUF
+  /* The buffers still queued are dropped with their containers */
+
+  for (i = 0; i < fbuf->container_size; i++)
+    {
+      release_import(&fbuf->vbuf_alloced[i]);
+    }
+#endif
+
   if (sz > 0)
     {
       vbuf = kmm_realloc(fbuf->vbuf_alloced, sizeof(vbuf_container_t) * sz);
@@ -163,6 +186,10 @@ vbuf_container_t *video_framebuff_get_container(video_framebuff_t *fbuf)
 void video_framebuff_free_container(video_framebuff_t *fbuf,
                                     vbuf_container_t  *cnt)
 {
+#ifdef CONFIG_VIDEO_DMABUF
+  release_import(cnt);
+#endif
+
   nxmutex_lock(&fbuf->lock_empty);
   cnt->next = fbuf->vbuf_empty;
   fbuf->vbuf_empty = cnt;
@@ -289,3 +316,52 @@ vbuf_container_t *video_framebuff_pop_curr_container(video_framebuff_t *fbuf)
   spin_unlock_irqrestore(&fbuf->lock_queue, flags);
   return ret;
 }
+
+#ifdef CONFIG_VIDEO_DMABUF
+/* Resolve the descriptor of a V4L2_MEMORY_DMABUF buffer just queued, the
+ * drivers below only see the address in m.userptr.
+ */
+
+int video_framebuff_import(vbuf_container_t *cnt)
+{
+  FAR struct dmabuf_s *dmabuf;
+
+  if (cnt->buf.memory != V4L2_MEMORY_DMABUF)
+    {
+      return OK;
+    }
+
+  dmabuf = video_dmabuf_get(cnt->buf.m.fd);
+  if (dmabuf == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (cnt->buf.length > dmabuf->len)
+    {
+      video_dmabuf_put(dmabuf);
+      return -EINVAL;
+    }
+
+  if (cnt->buf.length == 0)
+    {
+      cnt->buf.length = dmabuf->len;
+    }
+
+  cnt->dmabuf = dmabuf;
+  cnt->fd     = cnt->buf.m.fd;
+  cnt->buf.m.userptr = (unsigned long)dmabuf->addr;
+  return OK;
+}
+
+/* Give a dequeued buffer back to the application as it was queued */
+
+void video_framebuff_get_buf(vbuf_container_t *cnt, struct v4l2_buffer *buf)
+{
+  memcpy(buf, &cnt->buf, sizeof(struct v4l2_buffer));
+  if (cnt->dmabuf != NULL)
+    {
+      buf->m.fd = cnt->fd;
+    }
+}
+#endif
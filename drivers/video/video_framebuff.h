@@ -31,6 +31,7 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/spinlock.h>
+#include <nuttx/video/dmabuf.h>
 
 /****************************************************************************
  * Public Types
@@ -40,6 +41,10 @@ struct vbuf_container_s
 {
   struct v4l2_buffer       buf;   /* Buffer information */
   struct vbuf_container_s *next;  /* Pointer to next buffer */
+#ifdef CONFIG_VIDEO_DMABUF
+  FAR struct dmabuf_s     *dmabuf; /* Imported V4L2_MEMORY_DMABUF buffer */
+  int                      fd;     /* Descriptor given by the application */
+#endif
 };
 
 typedef struct vbuf_container_s vbuf_container_t;
@@ -89,5 +94,11 @@ void              video_framebuff_capture_done
                        (video_framebuff_t *fbuf);
 void              video_framebuff_change_mode
                        (video_framebuff_t *fbuf, enum v4l2_buf_mode mode);
+#ifdef CONFIG_VIDEO_DMABUF
+int               video_framebuff_import
+                       (vbuf_container_t *cnt);
+void              video_framebuff_get_buf
+                       (vbuf_container_t *cnt, struct v4l2_buffer *buf);
+#endif
 
 #endif  /* __DRIVERS_VIDEO_VIDEO_FRAMEBUFF_H */
@@ -24,8 +24,10 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
 #include <debug.h>
 #include <errno.h>
+#include <stdint.h>
 #include <stdio.h>
 
 #include <nuttx/fs/fs.h>
@@ -49,12 +51,17 @@
 #define VIRTIO_BLK_F_RO             5  /* Disk is read-only */
 #define VIRTIO_BLK_F_BLK_SIZE       6  /* Block size of disk is available */
 #define VIRTIO_BLK_F_FLUSH          9  /* Cache flush command support */
+#define VIRTIO_BLK_F_MQ             12 /* Support more than one vq */
+#define VIRTIO_BLK_F_DISCARD        13 /* Discard command support */
+#define VIRTIO_BLK_F_WRITE_ZEROES   14 /* Write zeroes command support */
 
 /* Block request type */
 
 #define VIRTIO_BLK_T_IN             0  /* READ */
 #define VIRTIO_BLK_T_OUT            1  /* WRITE */
 #define VIRTIO_BLK_T_FLUSH          4  /* FLUSH */
+#define VIRTIO_BLK_T_DISCARD        11 /* DISCARD */
+#define VIRTIO_BLK_T_WRITE_ZEROES   13 /* WRITE_ZEROES */
 
 /* Block request return status */
 
@@ -67,6 +74,10 @@
 #define VIRTIO_BLK_SECTOR_BITS      9
 #define VIRTIO_BLK_SECTOR_SIZE      (1UL << VIRTIO_BLK_SECTOR_BITS)
 
+/* Descriptors used by the largest request: header, data and status */
+
+#define VIRTIO_BLK_REQ_DESCS        3
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -87,6 +98,15 @@ begin_packed_struct struct virtio_blk_resp_s
   uint8_t status;
 } end_packed_struct;
 
+/* Block discard and write zeroes segment */
+
+begin_packed_struct struct virtio_blk_segment_s
+{
+  uint64_t sector;
+  uint32_t num_sectors;
+  uint32_t flags;
+} end_packed_struct;
+
 begin_packed_struct struct virtio_blk_config_s
 {
   uint64_t capacity;
@@ -115,12 +135,22 @@ begin_packed_struct struct virtio_blk_config_s
   uint32_t secure_erase_sector_alignment;
 } end_packed_struct;
 
+struct virtio_blk_queue_s
+{
+  FAR struct virtqueue         *vq;             /* Request virtqueue */
+  spinlock_t                    lock;           /* Lock */
+  sem_t                         slots;          /* Free request slots */
+};
+
 struct virtio_blk_priv_s
 {
   FAR struct virtio_device     *vdev;           /* Virtio device */
-  spinlock_t                    lock;           /* Lock */
+  struct virtio_blk_queue_s     queue[CONFIG_SMP_NCPUS];
+  int                           nqueues;        /* Number of queues */
   uint64_t                      nsectors;       /* Sectore numbers */
   uint32_t                      block_size;     /* Block size */
+  uint32_t                      max_discard;    /* Discard sectors limit */
+  uint32_t                      max_zeroes;     /* Zeroes sectors limit */
   char                          name[NAME_MAX]; /* Device name */
 };
 
@@ -130,6 +160,9 @@ struct virtio_blk_priv_s
 
 /* BLK block_operations functions and they helper function */
 
+static int     virtio_blk_submit(FAR struct virtio_blk_priv_s *priv,
+                                 FAR struct virtqueue_buf *vb,
+                                 int readable, int writable);
 static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
                                FAR void *buffer, blkcnt_t startsector,
                                unsigned int nsectors, bool write);
@@ -146,6 +179,8 @@ static int     virtio_blk_geometry(FAR struct inode *inode,
 static int     virtio_blk_ioctl(FAR struct inode *inode, int cmd,
                                 unsigned long arg);
 static int     virtio_blk_flush(FAR struct virtio_blk_priv_s *priv);
+static int     virtio_blk_erase(FAR struct virtio_blk_priv_s *priv,
+                                uint32_t type, FAR const uint64_t *range);
 
 /* Other functions */
 
@@ -192,17 +227,17 @@ static int g_virtio_blk_idx = 0;
  *
  ****************************************************************************/
 
-static void virtio_blk_wait_complete(FAR struct virtqueue *vq,
+static void virtio_blk_wait_complete(FAR struct virtio_blk_queue_s *queue,
                                      FAR sem_t *respsem)
 {
-  FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
   FAR sem_t *sem;
 
   if (up_interrupt_context() || OSINIT_IS_PANIC())
     {
       for (; ; )
         {
-          sem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
+          sem = virtqueue_get_buffer_lock(queue->vq, NULL, NULL,
+                                          &queue->lock);
           if (sem == respsem)
             {
               break;
@@ -219,6 +254,83 @@ static void virtio_blk_wait_complete(FAR struct virtqueue *vq,
     }
 }
 
+/****************************************************************************
+ * Name: virtio_blk_submit
+ *
+ * Description:
+ *   Queue one request and wait for its completion.  The last writable
+ *   buffer must be the status.  Requests from different threads are
+ *   outstanding at the same time, spread over the queues by CPU; a thread
+ *   waits for a free slot when its queue is full.
+ *
+ ****************************************************************************/
+
+static int virtio_blk_submit(FAR struct virtio_blk_priv_s *priv,
+                             FAR struct virtqueue_buf *vb,
+                             int readable, int writable)
+{
+  FAR struct virtio_blk_queue_s *queue;
+  FAR struct virtio_blk_resp_s *resp;
+  bool polling = up_interrupt_context() || OSINIT_IS_PANIC();
+  irqstate_t flags;
+  sem_t respsem;
+  int ret;
+
+  queue = &priv->queue[this_cpu() % priv->nqueues];
+  resp  = vb[readable + writable - 1].buf;
+  resp->status = VIRTIO_BLK_S_IOERR;
+
+  if (!polling)
+    {
+      nxsem_wait_uninterruptible(&queue->slots);
+    }
+
+  nxsem_init(&respsem, 0, 0);
+
+  if (up_interrupt_context())
+    {
+      virtqueue_disable_cb_lock(queue->vq, &queue->lock);
+    }
+
+  flags = spin_lock_irqsave(&queue->lock);
+  ret = virtqueue_add_buffer(queue->vq, vb, readable, writable, &respsem);
+  if (ret < 0)
+    {
+      spin_unlock_irqrestore(&queue->lock, flags);
+      vrterr("virtqueue_add_buffer failed, ret=%d\n", ret);
+      goto err;
+    }
+
+  virtqueue_kick(queue->vq);
+  spin_unlock_irqrestore(&queue->lock, flags);
+
+  /* Wait for the request completion */
+
+  virtio_blk_wait_complete(queue, &respsem);
+
+  if (resp->status == VIRTIO_BLK_S_UNSUPP)
+    {
+      ret = -ENOTSUP;
+    }
+  else if (resp->status != VIRTIO_BLK_S_OK)
+    {
+      ret = -EIO;
+    }
+
+err:
+  if (up_interrupt_context())
+    {
+      virtqueue_enable_cb_lock(queue->vq, &queue->lock);
+    }
+
+  if (!polling)
+    {
+      nxsem_post(&queue->slots);
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: virtio_blk_rdwr
  *
@@ -231,24 +343,17 @@ static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
                                FAR void *buffer, blkcnt_t startsector,
                                unsigned int nsectors, bool write)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
   FAR struct virtqueue_buf vb[3];
   struct virtio_blk_resp_s resp;
   struct virtio_blk_req_s req;
-  irqstate_t flags;
-  sem_t respsem;
-  ssize_t ret;
   int readnum;
-
-  nxsem_init(&respsem, 0, 0);
+  int ret;
 
   /* Build the block request */
 
   req.type     = write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
   req.reserved = 0;
   req.sector   = startsector * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
-  resp.status  = VIRTIO_BLK_S_IOERR;
 
   /* Fill the virtqueue buffer:
    * Buffer 0: the block out header;
@@ -264,40 +369,14 @@ static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
   vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
   readnum = write ? 2 : 1;
 
-  if (up_interrupt_context())
-    {
-      virtqueue_disable_cb_lock(vq, &priv->lock);
-    }
-
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, readnum, 3 - readnum, &respsem);
+  ret = virtio_blk_submit(priv, vb, readnum, 3 - readnum);
   if (ret < 0)
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      vrterr("virtqueue_add_buffer failed, ret=%zd\n", ret);
-      goto err;
-    }
-
-  virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
-
-  /* Wait for the request completion */
-
-  virtio_blk_wait_complete(vq, &respsem);
-
-  if (resp.status != VIRTIO_BLK_S_OK)
-    {
-      vrterr("%s Error\n", write ? "Write" : "Read");
-      ret = -EIO;
-    }
-
-err:
-  if (up_interrupt_context())
-    {
-      virtqueue_enable_cb_lock(vq, &priv->lock);
+      vrterr("%s Error, ret=%d\n", write ? "Write" : "Read", ret);
+      return ret;
     }
 
-  return ret >= 0 ? nsectors : ret;
+  return nsectors;
 }
 
 /****************************************************************************
@@ -407,47 +486,92 @@ static int virtio_blk_geometry(FAR struct inode *inode,
 
 static int virtio_blk_flush(FAR struct virtio_blk_priv_s *priv)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
   FAR struct virtqueue_buf vb[2];
   struct virtio_blk_resp_s resp;
   struct virtio_blk_req_s req;
-  irqstate_t flags;
-  sem_t respsem;
   int ret;
 
-  nxsem_init(&respsem, 0, 0);
-
   /* Build the block request */
 
   req.type     = VIRTIO_BLK_T_FLUSH;
   req.reserved = 0;
   req.sector   = 0;
-  resp.status  = VIRTIO_BLK_S_IOERR;
 
   vb[0].buf = &req;
   vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
   vb[1].buf = &resp;
   vb[1].len = VIRTIO_BLK_RESP_HEADER_SIZE;
 
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, 1, 1, &respsem);
+  ret = virtio_blk_submit(priv, vb, 1, 1);
   if (ret < 0)
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      return ret;
+      vrterr("Flush Error, ret=%d\n", ret);
     }
 
-  virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
+  return ret;
+}
 
-  /* Wait for the request completion */
+/****************************************************************************
+ * Name: virtio_blk_erase
+ *
+ * Description:
+ *   Discard or write zeroes to a byte range, given as offset and length
+ *   like Linux BLKDISCARD/BLKZEROOUT, split at the limit of the device.
+ *
+ ****************************************************************************/
+
+static int virtio_blk_erase(FAR struct virtio_blk_priv_s *priv,
+                            uint32_t type, FAR const uint64_t *range)
+{
+  FAR struct virtqueue_buf vb[3];
+  struct virtio_blk_segment_s seg;
+  struct virtio_blk_resp_s resp;
+  struct virtio_blk_req_s req;
+  uint64_t capacity;
+  uint64_t sector;
+  uint64_t nsectors;
+  uint32_t limit;
+  int ret = OK;
+
+  capacity = priv->nsectors * priv->block_size;
+  if (range == NULL || range[0] % priv->block_size != 0 ||
+      range[1] % priv->block_size != 0 || range[0] > capacity ||
+      range[1] > capacity - range[0])
+    {
+      return -EINVAL;
+    }
 
-  nxsem_wait_uninterruptible(&respsem);
-  if (resp.status != VIRTIO_BLK_S_OK)
+  limit = type == VIRTIO_BLK_T_DISCARD ? priv->max_discard :
+                                         priv->max_zeroes;
+  if (limit == 0)
     {
-      vrterr("Flush Error\n");
-      ret = -EIO;
+      limit = UINT32_MAX;
+    }
+
+  sector   = range[0] >> VIRTIO_BLK_SECTOR_BITS;
+  nsectors = range[1] >> VIRTIO_BLK_SECTOR_BITS;
+
+  req.type     = type;
+  req.reserved = 0;
+  req.sector   = 0;
+
+  vb[0].buf = &req;
+  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
+  vb[1].buf = &seg;
+  vb[1].len = sizeof(seg);
+  vb[2].buf = &resp;
+  vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+
+  while (nsectors > 0 && ret >= 0)
+    {
+      seg.sector      = sector;
+      seg.num_sectors = MIN(nsectors, limit);
+      seg.flags       = 0;
+
+      ret = virtio_blk_submit(priv, vb, 2, 1);
+
+      sector   += seg.num_sectors;
+      nsectors -= seg.num_sectors;
     }
 
   return ret;
@@ -474,6 +598,22 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
             ret = virtio_blk_flush(priv);
           }
         break;
+
+      case BIOC_BLKDISCARD:
+        if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_DISCARD))
+          {
+            ret = virtio_blk_erase(priv, VIRTIO_BLK_T_DISCARD,
+                                   (FAR const uint64_t *)(uintptr_t)arg);
+          }
+        break;
+
+      case BIOC_BLKZEROOUT:
+        if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_WRITE_ZEROES))
+          {
+            ret = virtio_blk_erase(priv, VIRTIO_BLK_T_WRITE_ZEROES,
+                                   (FAR const uint64_t *)(uintptr_t)arg);
+          }
+        break;
     }
 
   return ret;
@@ -486,14 +626,25 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
 static void virtio_blk_done(FAR struct virtqueue *vq)
 {
   FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
+  FAR struct virtio_blk_queue_s *queue = &priv->queue[vq->vq_queue_index];
   FAR sem_t *respsem;
 
   for (; ; )
     {
-      respsem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
+      respsem = virtqueue_get_buffer_lock(vq, NULL, NULL, &queue->lock);
       if (respsem == NULL)
         {
-          break;
+          /* Rearm the callback, with VIRTIO_RING_F_EVENT_IDX this moves
+           * the used event index past the buffers just consumed.  Check
+           * again if more buffers were used in the meantime.
+           */
+
+          if (virtqueue_enable_cb_lock(vq, &queue->lock) == 0)
+            {
+              break;
+            }
+
+          continue;
         }
 
       nxsem_post(respsem);
@@ -507,33 +658,68 @@ static void virtio_blk_done(FAR struct virtqueue *vq)
 static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqname[1];
-  vq_callback callback[1];
+  FAR const char *vqname[CONFIG_SMP_NCPUS];
+  vq_callback callback[CONFIG_SMP_NCPUS];
+  FAR struct virtio_blk_queue_s *queue;
+  uint16_t nqueues = 1;
   int ret;
+  int i;
 
   priv->vdev = vdev;
   vdev->priv = priv;
-  spin_lock_init(&priv->lock);
 
   /* Initialize the virtio device */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
   virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_RO) |
                                   (1UL << VIRTIO_BLK_F_BLK_SIZE) |
-                                  (1UL << VIRTIO_BLK_F_FLUSH), NULL);
+                                  (1UL << VIRTIO_BLK_F_FLUSH) |
+                                  (1UL << VIRTIO_BLK_F_MQ) |
+                                  (1UL << VIRTIO_BLK_F_DISCARD) |
+                                  (1UL << VIRTIO_BLK_F_WRITE_ZEROES) |
+                                  VIRTIO_RING_FEATURES, NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqname[0]   = "virtio_blk_vq";
-  callback[0] = virtio_blk_done;
-  ret = virtio_create_virtqueues(vdev, 0, 1, vqname, callback, NULL);
+  /* Use one queue per CPU at most, more cannot be busy at once */
+
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_MQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                num_queues, &nqueues);
+      nqueues = MAX(MIN(nqueues, CONFIG_SMP_NCPUS), 1);
+    }
+
+  for (i = 0; i < nqueues; i++)
+    {
+      vqname[i]   = "virtio_blk_vq";
+      callback[i] = virtio_blk_done;
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, nqueues, vqname, callback, NULL);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
       return ret;
     }
 
+  /* Bound the outstanding requests by the descriptors in each queue */
+
+  priv->nqueues = nqueues;
+  for (i = 0; i < nqueues; i++)
+    {
+      queue = &priv->queue[i];
+      queue->vq = vdev->vrings_info[i].vq;
+      spin_lock_init(&queue->lock);
+      nxsem_init(&queue->slots, 0,
+                 MAX(queue->vq->vq_nentries / VIRTIO_BLK_REQ_DESCS, 1));
+    }
+
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
-  virtqueue_enable_cb(vdev->vrings_info[0].vq);
+  for (i = 0; i < nqueues; i++)
+    {
+      virtqueue_enable_cb(priv->queue[i].vq);
+    }
+
   return ret;
 }
 
@@ -544,9 +730,15 @@ static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
 static void virtio_blk_uninit(FAR struct virtio_blk_priv_s *priv)
 {
   FAR struct virtio_device *vdev = priv->vdev;
+  int i;
 
   virtio_reset_device(vdev);
   virtio_delete_virtqueues(vdev);
+
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      nxsem_destroy(&priv->queue[i].slots);
+    }
 }
 
 /****************************************************************************
@@ -593,6 +785,19 @@ static int virtio_blk_probe(FAR struct virtio_device *vdev)
       priv->block_size = VIRTIO_BLK_SECTOR_SIZE;
     }
 
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_DISCARD))
+    {
+      virtio_read_config_member(priv->vdev, struct virtio_blk_config_s,
+                                max_discard_sectors, &priv->max_discard);
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_WRITE_ZEROES))
+    {
+      virtio_read_config_member(priv->vdev, struct virtio_blk_config_s,
+                                max_write_zeroes_sectors,
+                                &priv->max_zeroes);
+    }
+
   /* Register block driver */
 
   snprintf(priv->name, NAME_MAX, "/dev/virtblk%d", g_virtio_blk_idx);
@@ -31,6 +31,7 @@
 
 #include <nuttx/compiler.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/virtio/virtio.h>
@@ -45,19 +46,53 @@
 /* Virtio net feature bits */
 
 #define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_MRG_RXBUF 15
+#define VIRTIO_NET_F_CTRL_VQ  17
+#define VIRTIO_NET_F_MQ       22
+
+/* Virtio net control commands */
+
+#define VIRTIO_NET_CTRL_MQ    4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+#define VIRTIO_NET_OK         0
+#define VIRTIO_NET_ERR        1
 
 /* Virtio net header size and packet buffer size */
 
 #define VIRTIO_NET_HDRSIZE    (sizeof(struct virtio_net_hdr_s))
-#define VIRTIO_NET_LLHDRSIZE  (sizeof(struct virtio_net_llhdr_s))
+#define VIRTIO_NET_MRG_HDRSIZE \
+    (VIRTIO_NET_HDRSIZE + sizeof(uint16_t))
+#define VIRTIO_NET_LLHDRSIZE  \
+    (sizeof(FAR netpkt_t *) + VIRTIO_NET_HDRSIZE)
+#define VIRTIO_NET_MRG_LLHDRSIZE \
+    (sizeof(FAR netpkt_t *) + VIRTIO_NET_MRG_HDRSIZE)
 #define VIRTIO_NET_BUFSIZE    (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
 
-/* Virtio net virtqueue index and number */
+/* With VIRTIO_NET_F_MRG_RXBUF each RX buffer is a single IOB */
+
+#define VIRTIO_NET_MRG_BUFSIZE \
+    (CONFIG_IOB_BUFSIZE - CONFIG_NET_LL_GUARDSIZE + ETH_HDRLEN)
+#define VIRTIO_NET_CAN_MERGE \
+    (CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_MRG_LLHDRSIZE + ETH_HDRLEN && \
+     VIRTIO_NET_MRG_BUFSIZE < VIRTIO_NET_BUFSIZE)
+
+/* Virtio net virtqueue index and number, each queue pair is a RX and a TX
+ * virtqueue, the control virtqueue follows all pairs of the device.
+ */
 
 #define VIRTIO_NET_RX         0
 #define VIRTIO_NET_TX         1
 #define VIRTIO_NET_NUM        2
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+#  define VIRTIO_NET_MAX_PAIRS CONFIG_SMP_NCPUS
+#else
+#  define VIRTIO_NET_MAX_PAIRS 1
+#endif
+
+#define VIRTIO_NET_PAIR(vq)   ((vq)->vq_queue_index / VIRTIO_NET_NUM)
+#define VIRTIO_NET_TYPE(vq)   ((vq)->vq_queue_index % VIRTIO_NET_NUM)
+
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
 #define VIRTIO_NET_MAX_NIOB \
@@ -99,6 +134,20 @@ begin_packed_struct struct virtio_net_config_s
   uint32_t supported_hash_types;
 } end_packed_struct;
 
+/* Virtio net control command header */
+
+begin_packed_struct struct virtio_net_ctrl_s
+{
+  uint8_t  class;
+  uint8_t  cmd;
+} end_packed_struct;
+
+struct virtio_net_queue_s
+{
+  FAR struct virtqueue     *vq;        /* RX or TX virtqueue */
+  spinlock_t                lock;      /* Lock of the virtqueue */
+};
+
 struct virtio_net_priv_s
 {
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -112,12 +161,16 @@ struct virtio_net_priv_s
   struct netdev_lowerhalf_s lower;     /* The netdev lowerhalf */
 #endif
 
-  spinlock_t                lock[VIRTIO_NET_NUM];
+  struct virtio_net_queue_s queue[VIRTIO_NET_MAX_PAIRS][VIRTIO_NET_NUM];
 
   /* Virtio device information */
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
-  int                       bufnum;    /* TX and RX Buffer number */
+  int                       bufnum;    /* TX Buffer number per queue */
+  int                       rxbufnum;  /* RX Buffer number per queue */
+  uint8_t                   npairs;    /* Queue pairs in use */
+  uint8_t                   hdrsize;   /* Virtio net header size */
+  bool                      mergeable; /* VIRTIO_NET_F_MRG_RXBUF */
 };
 
 /* Virtio Link Layer Header, follow shows the iob buffer layout:
@@ -133,12 +186,16 @@ struct virtio_net_priv_s
  *                          = sizeof(uintptr) + 10 + 14
  *                          = 32 (64-Bit)
  *                          = 28 (32-Bit)
+ *
+ * The virtio header ends right before the ETH header, with
+ * VIRTIO_NET_F_MRG_RXBUF it is two bytes longer (num_buffers).
  */
 
 begin_packed_struct struct virtio_net_llhdr_s
 {
   FAR netpkt_t           *pkt;         /* Netpaket pointer */
   struct virtio_net_hdr_s vhdr;        /* Virtio net header */
+  uint16_t                num_buffers; /* VIRTIO_NET_F_MRG_RXBUF only */
 } end_packed_struct;
 
 static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDRLEN,
@@ -165,6 +222,10 @@ static int virtio_net_ioctl(FAR struct netdev_lowerhalf_s *dev,
                             int cmd, unsigned long arg);
 #endif
 static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev);
+static int virtio_net_send_queue(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt, int pair);
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       int pair);
 
 static int  virtio_net_probe(FAR struct virtio_device *vdev);
 static void virtio_net_remove(FAR struct virtio_device *vdev);
@@ -194,7 +255,15 @@ static const struct netdev_ops_s g_virtio_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   virtio_net_ioctl,
 #endif
-  virtio_net_txfree
+  virtio_net_txfree,
+#if CONFIG_NETDEV_RX_BUDGET > 0
+  NULL,                  /* rxint */
+  NULL,                  /* coalesce */
+#endif
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  virtio_net_send_queue,
+  virtio_net_recv_queue
+#endif
 };
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -210,42 +279,52 @@ static uint8_t g_netdev_num = 0;
  ****************************************************************************/
 
 static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
-                                FAR struct virtqueue *vq, FAR netpkt_t *pkt,
-                                unsigned int vq_id)
+                                FAR struct virtio_net_queue_s *queue,
+                                FAR netpkt_t *pkt, unsigned int vq_id)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
   FAR struct virtio_net_llhdr_s *hdr;
   struct virtqueue_buf vb[VIRTIO_NET_MAX_NIOB + 1];
-  struct iovec iov[VIRTIO_NET_MAX_NIOB];
+  netpkt_sg_t sg[VIRTIO_NET_MAX_NIOB];
   int iov_cnt;
   int i;
 
-  /* Convert netpkt to virtqueue_buf */
+  /* Describe the netpkt in place, the virtqueue transfers it without a
+   * copy.  The virtqueue is cache coherent, no sync is needed.
+   */
 
-  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_MAX_NIOB);
+  iov_cnt = netpkt_to_sg(dev, pkt, sg, VIRTIO_NET_MAX_NIOB);
+  if (iov_cnt < 0)
+    {
+      vrterr("net packet has too many buffers\n");
+      return iov_cnt;
+    }
 
   /* Alloc cookie and net header from transport layer */
 
   hdr = (FAR struct virtio_net_llhdr_s *)
-          ((FAR uint8_t *)iov[0].iov_base - VIRTIO_NET_LLHDRSIZE);
+          (sg[0].base - priv->hdrsize - sizeof(FAR netpkt_t *));
   DEBUGASSERT((FAR uint8_t *)hdr >= netpkt_getbase(pkt));
-  memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
+  memset(&hdr->vhdr, 0, priv->hdrsize);
   hdr->pkt = pkt;
 
-  /* Prepare buffers depends on the feature VIRTIO_F_ANY_LAYOUT */
+  /* Prepare buffers depends on the feature VIRTIO_F_ANY_LAYOUT, mergeable
+   * RX buffers always carry the header in the buffer itself.
+   */
 
-  if (virtio_has_feature(priv->vdev, VIRTIO_F_ANY_LAYOUT))
+  if (priv->mergeable ||
+      virtio_has_feature(priv->vdev, VIRTIO_F_ANY_LAYOUT))
     {
       /* Append the virtio net header to the first buffer */
 
       vb[0].buf = &hdr->vhdr;
-      vb[0].len = iov[0].iov_len + VIRTIO_NET_HDRSIZE;
+      vb[0].len = sg[0].len + priv->hdrsize;
 
 #if VIRTIO_NET_MAX_NIOB > 1
       for (i = 1; i < iov_cnt; i++)
         {
-          vb[i].buf = iov[i].iov_base;
-          vb[i].len = iov[i].iov_len;
+          vb[i].buf = sg[i].base;
+          vb[i].len = sg[i].len;
         }
 #endif
     }
@@ -254,12 +333,12 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
       /* Buffer 0 is only for virtio net header */
 
       vb[0].buf = &hdr->vhdr;
-      vb[0].len = VIRTIO_NET_HDRSIZE;
+      vb[0].len = priv->hdrsize;
 
       for (i = 0; i < iov_cnt; i++)
         {
-          vb[i + 1].buf = iov[i].iov_base;
-          vb[i + 1].len = iov[i].iov_len;
+          vb[i + 1].buf = sg[i].base;
+          vb[i + 1].len = sg[i].len;
         }
 
       iov_cnt++;
@@ -268,13 +347,13 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
   vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
   if (vq_id == VIRTIO_NET_RX)
     {
-      return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, hdr,
-                                       &priv->lock[vq_id]);
+      return virtqueue_add_buffer_lock(queue->vq, vb, 0, iov_cnt, hdr,
+                                       &queue->lock);
     }
   else
     {
-      return virtqueue_add_buffer_lock(vq, vb, iov_cnt, 0, hdr,
-                                       &priv->lock[vq_id]);
+      return virtqueue_add_buffer_lock(queue->vq, vb, iov_cnt, 0, hdr,
+                                       &queue->lock);
     }
 }
 
@@ -282,15 +361,25 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
  * Name: virtio_net_rxfill
  ****************************************************************************/
 
-static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev, int pair)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  FAR struct virtio_net_queue_s *queue = &priv->queue[pair][VIRTIO_NET_RX];
+  unsigned int bufsize;
   FAR netpkt_t *pkt;
   int i;
 
-  for (i = 0; i < priv->bufnum; i++)
+  bufsize = priv->mergeable ? VIRTIO_NET_MRG_BUFSIZE : VIRTIO_NET_BUFSIZE;
+
+  for (i = 0; i < priv->rxbufnum; i++)
     {
+      /* The RX quota is shared by the pairs, stop before the ring is full */
+
+      if (queue->vq->vq_free_cnt < VIRTIO_NET_MAX_NIOB + 1)
+        {
+          break;
+        }
+
       /* IOB Offload, Alloc buffer from RX netpkt */
 
       pkt = netpkt_alloc(dev, NETPKT_RX);
@@ -302,8 +391,7 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Preserve data length */
 
-      if (netpkt_setdatalen(dev, pkt, VIRTIO_NET_BUFSIZE) <
-          VIRTIO_NET_BUFSIZE)
+      if (netpkt_setdatalen(dev, pkt, bufsize) < bufsize)
         {
           vrtwarn("No enough buffer to prepare RX buffer, i=%d\n", i);
           netpkt_free(dev, pkt, NETPKT_RX);
@@ -312,12 +400,12 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Add buffer to RX virtqueue */
 
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
+      virtio_net_addbuffer(dev, queue, pkt, VIRTIO_NET_RX);
     }
 
   if (i > 0)
     {
-      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+      virtqueue_kick_lock(queue->vq, &queue->lock);
     }
 }
 
@@ -328,23 +416,79 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  FAR struct virtio_net_queue_s *queue;
   FAR struct virtio_net_llhdr_s *hdr;
+  int pair;
 
-  while (1)
+  for (pair = 0; pair < priv->npairs; pair++)
     {
-      /* Get buffer from tx virtqueue */
+      queue = &priv->queue[pair][VIRTIO_NET_TX];
+
+      while (1)
+        {
+          /* Get buffer from tx virtqueue */
+
+          hdr = virtqueue_get_buffer_lock(queue->vq, NULL, NULL,
+                                          &queue->lock);
+          if (hdr == NULL)
+            {
+              break;
+            }
+
+          netpkt_free(dev, hdr->pkt, NETPKT_TX);
+          vrtinfo("Free, hdr: %p, pkt: %p\n", hdr, hdr->pkt);
+        }
+    }
+}
 
-      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL,
-                                      &priv->lock[VIRTIO_NET_TX]);
+/****************************************************************************
+ * Name: virtio_net_merge
+ *
+ * Description:
+ *   Append the other buffers of a packet received with
+ *   VIRTIO_NET_F_MRG_RXBUF to its first buffer.  The device writes them
+ *   from their start, where the virtio header would be.
+ *
+ ****************************************************************************/
+
+static int virtio_net_merge(FAR struct netdev_lowerhalf_s *dev,
+                            FAR struct virtio_net_queue_s *queue,
+                            FAR netpkt_t *pkt, uint16_t num)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  FAR struct virtio_net_llhdr_s *hdr;
+  FAR netpkt_t *next;
+  uint32_t len;
+  int ret = OK;
+
+  while (--num > 0)
+    {
+      hdr = virtqueue_get_buffer_lock(queue->vq, &len, NULL, &queue->lock);
       if (hdr == NULL)
         {
-          break;
+          vrterr("Missing %u buffers of a merged packet\n", num);
+          return -EIO;
+        }
+
+      next = hdr->pkt;
+      if (ret < 0 || len > VIRTIO_NET_MRG_BUFSIZE + priv->hdrsize)
+        {
+          netpkt_free(dev, next, NETPKT_RX);
+          ret = -EIO;
+          continue;
         }
 
-      netpkt_free(dev, hdr->pkt, NETPKT_TX);
-      vrtinfo("Free, hdr: %p, pkt: %p\n", hdr, hdr->pkt);
+      next->io_offset -= NET_LL_HDRLEN(&dev->netdev) + priv->hdrsize;
+      next->io_len     = len;
+      next->io_pktlen  = len;
+      iob_concat(pkt, next);
+
+      /* The appended buffer goes to the stack with the packet */
+
+      atomic_fetch_add(&dev->quota_ptr[NETPKT_RX], 1);
     }
+
+  return ret;
 }
 
 /****************************************************************************
@@ -354,6 +498,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int pair;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -370,9 +515,12 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RX].vq,
-                           &priv->lock[VIRTIO_NET_RX]);
-  virtio_net_rxfill(dev);
+  for (pair = 0; pair < priv->npairs; pair++)
+    {
+      virtqueue_enable_cb_lock(priv->queue[pair][VIRTIO_NET_RX].vq,
+                               &priv->queue[pair][VIRTIO_NET_RX].lock);
+      virtio_net_rxfill(dev, pair);
+    }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   if (priv->lower.wifi == NULL)
@@ -391,14 +539,18 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int pair;
   int i;
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (pair = 0; pair < priv->npairs; pair++)
     {
-      virtqueue_disable_cb_lock(priv->vdev->vrings_info[i].vq,
-                                &priv->lock[i]);
+      for (i = 0; i < VIRTIO_NET_NUM; i++)
+        {
+          virtqueue_disable_cb_lock(priv->queue[pair][i].vq,
+                                    &priv->queue[pair][i].lock);
+        }
     }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -415,14 +567,15 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 }
 
 /****************************************************************************
- * Name: virtio_net_send
+ * Name: virtio_net_send_queue
  ****************************************************************************/
 
-static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
-                           FAR netpkt_t *pkt)
+static int virtio_net_send_queue(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt, int pair)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  FAR struct virtio_net_queue_s *queue = &priv->queue[pair][VIRTIO_NET_TX];
+  int ret;
 
   /* Check the send length */
 
@@ -434,8 +587,13 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   /* Add buffer to vq and notify the other side */
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
-  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  ret = virtio_net_addbuffer(dev, queue, pkt, VIRTIO_NET_TX);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  virtqueue_kick_lock(queue->vq, &queue->lock);
 
   /* Try return Netpkt TX buffer to upper-half. */
 
@@ -445,55 +603,88 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+      virtqueue_enable_cb_lock(queue->vq, &queue->lock);
     }
 
   return OK;
 }
 
 /****************************************************************************
- * Name: virtio_net_recv
+ * Name: virtio_net_send
  ****************************************************************************/
 
-static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt)
+{
+  return virtio_net_send_queue(dev, pkt, 0);
+}
+
+/****************************************************************************
+ * Name: virtio_net_recv_queue
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       int pair)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  FAR struct virtio_net_queue_s *queue = &priv->queue[pair][VIRTIO_NET_RX];
   FAR struct virtio_net_llhdr_s *hdr;
   irqstate_t flags;
+  FAR netpkt_t *pkt;
   uint32_t len;
 
   /* Fill the free Netpkt RX buffer to the RX virtqueue */
 
-  virtio_net_rxfill(dev);
-
-  /* Get received buffer form RX virtqueue */
+  virtio_net_rxfill(dev, pair);
 
-  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RX]);
-  hdr = virtqueue_get_buffer(vq, &len, NULL);
-  if (hdr == NULL)
+  for (; ; )
     {
-      /* If we have no buffer left, enable RX callback. */
+      /* Get received buffer form RX virtqueue */
 
-      virtqueue_enable_cb(vq);
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      flags = spin_lock_irqsave(&queue->lock);
+      hdr = virtqueue_get_buffer(queue->vq, &len, NULL);
+      if (hdr == NULL)
+        {
+          /* If we have no buffer left, enable RX callback. */
 
-      vrtinfo("get NULL buffer\n");
-      return NULL;
-    }
-  else
-    {
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+          virtqueue_enable_cb(queue->vq);
+          spin_unlock_irqrestore(&queue->lock, flags);
+
+          vrtinfo("get NULL buffer\n");
+          return NULL;
+        }
+      else
+        {
+          spin_unlock_irqrestore(&queue->lock, flags);
+        }
+
+      /* Set the received pkt length */
+
+      pkt = hdr->pkt;
+      netpkt_setdatalen(dev, pkt, len - priv->hdrsize);
+      vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, pkt, len);
+
+      if (!priv->mergeable || hdr->num_buffers <= 1 ||
+          virtio_net_merge(dev, queue, pkt, hdr->num_buffers) >= 0)
+        {
+          return pkt;
+        }
+
+      /* Drop the broken packet and go on with the next one */
+
+      netpkt_free(dev, pkt, NETPKT_RX);
     }
+}
 
-  /* Set the received pkt length */
+/****************************************************************************
+ * Name: virtio_net_recv
+ ****************************************************************************/
 
-  netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
-  vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, hdr->pkt, len);
-  return hdr->pkt;
+static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+{
+  return virtio_net_recv_queue(dev, 0);
 }
 
-#ifdef CONFIG_NET_MCASTGROUP
 /****************************************************************************
  * Name: virtio_net_addmac
  ****************************************************************************/
@@ -534,8 +725,19 @@ static int virtio_net_ioctl(FAR struct netdev_lowerhalf_s *dev,
 static void virtio_net_rxready(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
+  int pair = VIRTIO_NET_PAIR(vq);
+
+  virtqueue_disable_cb_lock(vq, &priv->queue[pair][VIRTIO_NET_RX].lock);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->npairs > 1)
+    {
+      netdev_lower_rxready_queue((FAR struct netdev_lowerhalf_s *)priv,
+                                 pair);
+      return;
+    }
+#endif
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_RX]);
   netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
 }
 
@@ -546,11 +748,51 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
 static void virtio_net_txdone(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
+  int pair = VIRTIO_NET_PAIR(vq);
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtqueue_disable_cb_lock(vq, &priv->queue[pair][VIRTIO_NET_TX].lock);
   netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
 }
 
+/****************************************************************************
+ * Name: virtio_net_set_pairs
+ *
+ * Description:
+ *   Tell the device how many queue pairs are used, it only uses the first
+ *   one until told otherwise.  Called once at init, so the command is
+ *   simply polled for.
+ *
+ ****************************************************************************/
+
+static int virtio_net_set_pairs(FAR struct virtqueue *vq, uint16_t npairs)
+{
+  struct virtio_net_ctrl_s ctrl;
+  struct virtqueue_buf vb[3];
+  uint8_t ack = VIRTIO_NET_ERR;
+  int ret;
+
+  ctrl.class = VIRTIO_NET_CTRL_MQ;
+  ctrl.cmd   = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+
+  vb[0].buf = &ctrl;
+  vb[0].len = sizeof(ctrl);
+  vb[1].buf = &npairs;
+  vb[1].len = sizeof(npairs);
+  vb[2].buf = &ack;
+  vb[2].len = sizeof(ack);
+
+  ret = virtqueue_add_buffer(vq, vb, 2, 1, &ack);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  virtqueue_kick(vq);
+  while (virtqueue_get_buffer(vq, NULL, NULL) == NULL);
+
+  return ack == VIRTIO_NET_OK ? OK : -EIO;
+}
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -558,50 +800,146 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char **vqnames;
+  FAR vq_callback *callbacks;
+  uint64_t features;
+  uint16_t maxpairs = 1;
+  int descs;
+  int nvqs = VIRTIO_NET_NUM;
+  int pair;
   int ret;
+  int i;
 
-  spin_lock_init(&priv->lock[VIRTIO_NET_RX]);
-  spin_lock_init(&priv->lock[VIRTIO_NET_TX]);
   priv->vdev = vdev;
   vdev->priv = priv;
 
-  /* Initialize the virtio device */
+  /* Initialize the virtio device, mergeable RX buffers are only of use if
+   * a frame does not fit in one IOB and the headroom holds the longer
+   * header.
+   */
+
+  features = (1UL << VIRTIO_NET_F_MAC) | (1UL << VIRTIO_F_ANY_LAYOUT) |
+             VIRTIO_RING_FEATURES;
+  if (VIRTIO_NET_CAN_MERGE)
+    {
+      features |= 1UL << VIRTIO_NET_F_MRG_RXBUF;
+    }
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  features |= (1UL << VIRTIO_NET_F_CTRL_VQ) | (1UL << VIRTIO_NET_F_MQ);
+#endif
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
-                                  (1UL << VIRTIO_F_ANY_LAYOUT), NULL);
+  virtio_negotiate_features(vdev, features, NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks, NULL);
+  priv->mergeable = virtio_has_feature(vdev, VIRTIO_NET_F_MRG_RXBUF);
+  priv->hdrsize   = priv->mergeable ? VIRTIO_NET_MRG_HDRSIZE :
+                                      VIRTIO_NET_HDRSIZE;
+
+  /* With VIRTIO_NET_F_MQ the control virtqueue comes after all the queue
+   * pairs of the device, so all of them are created even if fewer are
+   * used.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_MQ) &&
+      virtio_has_feature(vdev, VIRTIO_NET_F_CTRL_VQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_net_config_s,
+                                max_virtqueue_pairs, &maxpairs);
+      maxpairs = MAX(maxpairs, 1);
+      nvqs     = maxpairs * VIRTIO_NET_NUM + 1;
+    }
+
+  vqnames   = kmm_malloc(nvqs * sizeof(*vqnames));
+  callbacks = kmm_malloc(nvqs * sizeof(*callbacks));
+  if (vqnames == NULL || callbacks == NULL)
+    {
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  /* Only the used pairs get callbacks, the others never get buffers */
+
+  priv->npairs = MIN(maxpairs, VIRTIO_NET_MAX_PAIRS);
+  for (i = 0; i < nvqs; i++)
+    {
+      pair         = i / VIRTIO_NET_NUM;
+      vqnames[i]   = i % VIRTIO_NET_NUM == VIRTIO_NET_RX ?
+                     "virtio_net_rx" : "virtio_net_tx";
+      callbacks[i] = NULL;
+
+      if (i == nvqs - 1 && nvqs > VIRTIO_NET_NUM)
+        {
+          vqnames[i] = "virtio_net_ctrl";
+        }
+      else if (pair < priv->npairs)
+        {
+          callbacks[i] = i % VIRTIO_NET_NUM == VIRTIO_NET_RX ?
+                         virtio_net_rxready : virtio_net_txdone;
+        }
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqnames, callbacks, NULL);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
-      return ret;
+      goto out;
+    }
+
+  for (pair = 0; pair < priv->npairs; pair++)
+    {
+      for (i = 0; i < VIRTIO_NET_NUM; i++)
+        {
+          priv->queue[pair][i].vq =
+            vdev->vrings_info[pair * VIRTIO_NET_NUM + i].vq;
+          spin_lock_init(&priv->queue[pair][i].lock);
+        }
     }
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+  if (nvqs > VIRTIO_NET_NUM && priv->npairs > 1 &&
+      virtio_net_set_pairs(vdev->vrings_info[nvqs - 1].vq,
+                           priv->npairs) < 0)
+    {
+      vrtwarn("Set %u queue pairs failed, use one\n", priv->npairs);
+      priv->npairs = 1;
+    }
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
   priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
   /* Calculate the virtio network buffer number:
-   * 1/4 for the TX netpkts, 1/4 for the RX netpkts.
+   * 1/4 for the TX netpkts, 1/4 for the RX netpkts, shared by the pairs.
    */
 
-  priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4;
+  priv->bufnum = MAX(CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4 /
+                     priv->npairs, 1);
 #endif
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs /
-                     (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
+
+  /* A mergeable RX buffer is a single IOB in a single descriptor, so the
+   * same IOBs make more RX buffers.
+   */
+
+  descs = vdev->vrings_info[VIRTIO_NET_RX].info.num_descs;
+  if (priv->mergeable)
+    {
+      priv->rxbufnum = MIN(descs, priv->bufnum * VIRTIO_NET_MAX_NIOB);
+    }
+  else
+    {
+      priv->rxbufnum = MIN(descs / (VIRTIO_NET_MAX_NIOB + 1),
+                           priv->bufnum);
+    }
+
   priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
                      (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
-  return OK;
+
+out:
+  kmm_free(vqnames);
+  kmm_free(callbacks);
+  return ret;
 }
 
 static void virtio_net_set_macaddr(FAR struct virtio_net_priv_s *priv)
@@ -668,10 +1006,18 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   /* Initialize the netdev lower half */
 
   netdev = (FAR struct netdev_lowerhalf_s *)priv;
-  netdev->quota[NETPKT_RX] = priv->bufnum;
-  netdev->quota[NETPKT_TX] = priv->bufnum;
+  netdev->quota[NETPKT_RX] = priv->rxbufnum * priv->npairs;
+  netdev->quota[NETPKT_TX] = priv->bufnum * priv->npairs;
   netdev->ops = &g_virtio_net_ops;
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->npairs > 1)
+    {
+      netdev->rxtype  = NETDEV_RX_THREAD_MQ;
+      netdev->nqueues = priv->npairs;
+    }
+#endif
+
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
    * no more WiFi interfaces will be created.
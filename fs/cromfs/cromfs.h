@@ -102,16 +102,24 @@ struct cromfs_volume_s
  *                Return 0
  *   st_ctime   - Time of last status change
  *                Return 0
+ *
+ * Regular files with CROMFS_NODE_XIP set in cn_flags are not compressed:
+ * u.cn_blocks is then the offset to the cn_size bytes of raw file data,
+ * stored contiguously and aligned in the image so that the file can be
+ * mapped and executed in place.
  */
 
+#define CROMFS_NODE_XIP (1 << 0) /* File data is stored uncompressed */
+
 begin_packed_struct struct cromfs_node_s
 {
-  uint16_t cn_mode; /* File type, attributes, and access mode bits */
-  uint16_t cn_pad;  /* Not used */
-  uint32_t cn_name; /* Offset from the beginning of the volume header to the
-                     * node name string.  NUL-terminated. */
-  uint32_t cn_size; /* Size of the uncompressed data (in bytes) */
-  uint32_t cn_peer; /* Offset to next node in this directory (for readdir()) */
+  uint16_t cn_mode;  /* File type, attributes, and access mode bits */
+  uint16_t cn_flags; /* See CROMFS_NODE_* */
+  uint32_t cn_name;  /* Offset from the beginning of the volume header to
+                      * the node name string.  NUL-terminated. */
+  uint32_t cn_size;  /* Size of the uncompressed data (in bytes) */
+  uint32_t cn_peer;  /* Offset to next node in this directory (for
+                      * readdir()) */
   union
   {
     uint32_t cn_child;  /* Offset to first node in sub-directory (directories only) */
@@ -41,6 +41,8 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 
@@ -55,6 +57,21 @@
 
 #define CROMFS_MAX_LINKS 64
 
+#ifndef CONFIG_FS_CROMFS_CACHE_NBLOCKS
+#  define CONFIG_FS_CROMFS_CACHE_NBLOCKS 0
+#endif
+
+#ifndef CONFIG_FS_CROMFS_READAHEAD
+#  define CONFIG_FS_CROMFS_READAHEAD 0
+#endif
+
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+#  define CROMFS_HAVE_CACHE 1
+#  if CONFIG_FS_CROMFS_READAHEAD > 0 && defined(CONFIG_SCHED_WORKQUEUE)
+#    define CROMFS_HAVE_READAHEAD 1
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -74,8 +91,23 @@ struct cromfs_file_s
   uint32_t ff_offset;                       /* Cached block offset (zero means none) */
   uint16_t ff_ulen;                         /* Length of decompressed data in cache */
   FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
+#ifdef CROMFS_HAVE_READAHEAD
+  off_t ff_rapos;                           /* Where a sequential read starts */
+#endif
 };
 
+#ifdef CROMFS_HAVE_CACHE
+/* An entry in the cache of decompressed blocks shared by all open files */
+
+struct cromfs_cache_s
+{
+  dq_entry_t cc_node;    /* Entry in the LRU list, must be first */
+  uint32_t cc_offset;    /* Offset of the compressed data (zero means none) */
+  uint16_t cc_ulen;      /* Length of the decompressed data */
+  FAR uint8_t *cc_data;  /* Decompressed data */
+};
+#endif
+
 /* This is the form of the callback from cromfs_foreach_node(): */
 
 typedef CODE int (*cromfs_foreach_t)(FAR const struct cromfs_volume_s *fs,
@@ -133,6 +165,22 @@ static int      cromfs_compare_node(FAR const struct cromfs_volume_s *fs,
                                     FAR const struct cromfs_node_s *node,
                                     uint32_t offset,
                                     FAR void *arg);
+static uint32_t cromfs_block_info(FAR const struct lzf_header_s *hdr,
+                                  FAR uint16_t *ulen, FAR uint16_t *clen);
+#ifdef CROMFS_HAVE_CACHE
+static int      cromfs_cache_initialize(
+                  FAR const struct cromfs_volume_s *fs);
+static void     cromfs_cache_uninitialize(void);
+static FAR struct cromfs_cache_s *
+                cromfs_cache_block(FAR const struct cromfs_volume_s *fs,
+                                   FAR const uint8_t *src, uint16_t clen);
+#endif
+#ifdef CROMFS_HAVE_READAHEAD
+static void     cromfs_readahead_worker(FAR void *arg);
+static void     cromfs_readahead(FAR const struct cromfs_volume_s *fs,
+                                 FAR const struct lzf_header_s *hdr,
+                                 uint32_t remaining);
+#endif
 static int      cromfs_find_node(FAR const struct cromfs_volume_s *fs,
                                  FAR const char *relpath,
                                  FAR struct cromfs_nodeinfo_s *info,
@@ -147,6 +195,8 @@ static ssize_t  cromfs_read(FAR struct file *filep,
                             FAR char *buffer, size_t buflen);
 static int      cromfs_ioctl(FAR struct file *filep,
                              int cmd, unsigned long arg);
+static int      cromfs_mmap(FAR struct file *filep,
+                            FAR struct mm_map_entry_s *map);
 
 static int      cromfs_dup(FAR const struct file *oldp,
                            FAR struct file *newp);
@@ -191,7 +241,7 @@ const struct mountpt_operations g_cromfs_operations =
   NULL,              /* write */
   NULL,              /* seek */
   cromfs_ioctl,      /* ioctl */
-  NULL,              /* mmap */
+  cromfs_mmap,       /* mmap */
   NULL,              /* truncate */
   NULL,              /* poll */
   NULL,              /* readv */
@@ -230,6 +280,28 @@ const struct mountpt_operations g_cromfs_operations =
 
 extern const struct cromfs_volume_s g_cromfs_image;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CROMFS_HAVE_CACHE
+/* The image is shared by every mount, and so is the cache of decompressed
+ * blocks.  g_cromfs_cachelock protects the cache and the readahead state.
+ */
+
+static mutex_t g_cromfs_cachelock = NXMUTEX_INITIALIZER;
+static struct cromfs_cache_s g_cromfs_cache[CONFIG_FS_CROMFS_CACHE_NBLOCKS];
+static dq_queue_t g_cromfs_lru;
+static FAR uint8_t *g_cromfs_cachebuf;
+static unsigned int g_cromfs_nmounts;
+#endif
+
+#ifdef CROMFS_HAVE_READAHEAD
+static struct work_s g_cromfs_rawork;
+static uint32_t g_cromfs_ranext;      /* Offset of the next block header */
+static uint32_t g_cromfs_raremaining; /* File data from that block onward */
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -353,7 +425,7 @@ static int cromfs_follow_link(FAR const struct cromfs_volume_s *fs,
            */
 
           newnode->cn_mode    = S_IFDIR | (node->cn_mode & ~S_IFMT);
-          newnode->cn_pad     = 0;
+          newnode->cn_flags   = 0;
           newnode->cn_name    = node->cn_name;
           newnode->cn_size    = 0;
           newnode->cn_peer    = node->cn_peer;
@@ -370,13 +442,13 @@ static int cromfs_follow_link(FAR const struct cromfs_volume_s *fs,
       /* Copy the origin node file name into the writable node copy */
 
       newnode->cn_name   = node->cn_name;
-      newnode->cn_pad    = 0;
 
       /* Copy all attributes of the target node, but retain the hard link
        * file name and, possibly, the peer node reference.
        */
 
       newnode->cn_mode   = linknode->cn_mode;
+      newnode->cn_flags  = linknode->cn_flags;
       newnode->cn_size   = linknode->cn_size;
       newnode->u.cn_link = linknode->u.cn_link;
 
@@ -649,6 +721,249 @@ static int cromfs_compare_node(FAR const struct cromfs_volume_s *fs,
   return 0;  /* Keep looking in this directory */
 }
 
+/****************************************************************************
+ * Name: cromfs_block_info
+ *
+ * Description:
+ *   Decode the header of a LZF block.  Returns the size of the block,
+ *   header included, and the uncompressed and compressed data lengths.
+ *   For an uncompressed block both lengths are the same.
+ *
+ ****************************************************************************/
+
+static uint32_t cromfs_block_info(FAR const struct lzf_header_s *hdr,
+                                  FAR uint16_t *ulen, FAR uint16_t *clen)
+{
+  if (hdr->lzf_type == LZF_TYPE0_HDR)
+    {
+      FAR const struct lzf_type0_header_s *hdr0 =
+        (FAR const struct lzf_type0_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr0->lzf_len[0] << 8 |
+              (uint16_t)hdr0->lzf_len[1];
+      *clen = *ulen;
+      return (uint32_t)*ulen + LZF_TYPE0_HDR_SIZE;
+    }
+  else
+    {
+      FAR const struct lzf_type1_header_s *hdr1 =
+        (FAR const struct lzf_type1_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr1->lzf_ulen[0] << 8 |
+              (uint16_t)hdr1->lzf_ulen[1];
+      *clen = (uint16_t)hdr1->lzf_clen[0] << 8 |
+              (uint16_t)hdr1->lzf_clen[1];
+      return (uint32_t)*clen + LZF_TYPE1_HDR_SIZE;
+    }
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_initialize
+ *
+ * Description:
+ *   Allocate the decompressed block cache when the first mount is bound.
+ *
+ ****************************************************************************/
+
+#ifdef CROMFS_HAVE_CACHE
+static int cromfs_cache_initialize(FAR const struct cromfs_volume_s *fs)
+{
+  int ret = OK;
+  int i;
+
+  nxmutex_lock(&g_cromfs_cachelock);
+
+  if (g_cromfs_cachebuf == NULL)
+    {
+      g_cromfs_cachebuf =
+        fs_heap_malloc(CONFIG_FS_CROMFS_CACHE_NBLOCKS * fs->cv_bsize);
+      if (g_cromfs_cachebuf == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+
+      dq_init(&g_cromfs_lru);
+      for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+        {
+          g_cromfs_cache[i].cc_offset = 0;
+          g_cromfs_cache[i].cc_data   = g_cromfs_cachebuf +
+                                        i * fs->cv_bsize;
+          dq_addlast(&g_cromfs_cache[i].cc_node, &g_cromfs_lru);
+        }
+    }
+
+  g_cromfs_nmounts++;
+
+errout_with_lock:
+  nxmutex_unlock(&g_cromfs_cachelock);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: cromfs_cache_uninitialize
+ *
+ * Description:
+ *   Release the decompressed block cache when the last mount is unbound.
+ *
+ ****************************************************************************/
+
+#ifdef CROMFS_HAVE_CACHE
+static void cromfs_cache_uninitialize(void)
+{
+  bool last;
+
+  nxmutex_lock(&g_cromfs_cachelock);
+  last = --g_cromfs_nmounts == 0;
+  nxmutex_unlock(&g_cromfs_cachelock);
+
+  if (last)
+    {
+#ifdef CROMFS_HAVE_READAHEAD
+      /* The worker takes the lock, so it cannot be cancelled under it */
+
+      work_cancel_sync(LPWORK, &g_cromfs_rawork);
+#endif
+
+      nxmutex_lock(&g_cromfs_cachelock);
+      if (g_cromfs_nmounts == 0)
+        {
+          fs_heap_free(g_cromfs_cachebuf);
+          g_cromfs_cachebuf = NULL;
+        }
+
+      nxmutex_unlock(&g_cromfs_cachelock);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: cromfs_cache_block
+ *
+ * Description:
+ *   Return the cache entry holding the decompressed contents of the LZF
+ *   data at "src", decompressing it into the least recently used entry if
+ *   it is not cached yet.  The entry becomes the most recently used one.
+ *
+ * Assumptions:
+ *   The caller holds g_cromfs_cachelock.  The returned entry is only valid
+ *   until the lock is released.
+ *
+ ****************************************************************************/
+
+#ifdef CROMFS_HAVE_CACHE
+static FAR struct cromfs_cache_s *
+cromfs_cache_block(FAR const struct cromfs_volume_s *fs,
+                   FAR const uint8_t *src, uint16_t clen)
+{
+  FAR struct cromfs_cache_s *entry;
+  FAR dq_entry_t *node;
+  uint32_t voloffs;
+
+  voloffs = cromfs_addr2offset(fs, src);
+
+  dq_for_every(&g_cromfs_lru, node)
+    {
+      entry = (FAR struct cromfs_cache_s *)node;
+      if (entry->cc_offset == voloffs)
+        {
+          goto out;
+        }
+    }
+
+  /* Not cached, recycle the least recently used entry */
+
+  entry = (FAR struct cromfs_cache_s *)dq_tail(&g_cromfs_lru);
+  entry->cc_ulen   = lzf_decompress(src, clen, entry->cc_data,
+                                    fs->cv_bsize);
+  entry->cc_offset = voloffs;
+  finfo("voloffs=%" PRIu32 " clen=%" PRIu16 " ulen=%" PRIu16 "\n",
+        voloffs, clen, entry->cc_ulen);
+
+out:
+  dq_rem(&entry->cc_node, &g_cromfs_lru);
+  dq_addfirst(&entry->cc_node, &g_cromfs_lru);
+  return entry;
+}
+#endif
+
+/****************************************************************************
+ * Name: cromfs_readahead_worker
+ *
+ * Description:
+ *   Decompress the blocks that follow a sequential read into the cache so
+ *   that the next read of the file only has to copy them.
+ *
+ ****************************************************************************/
+
+#ifdef CROMFS_HAVE_READAHEAD
+static void cromfs_readahead_worker(FAR void *arg)
+{
+  FAR const struct cromfs_volume_s *fs = arg;
+  FAR const struct lzf_header_s *hdr;
+  uint32_t remaining;
+  uint32_t blksize;
+  uint16_t ulen;
+  uint16_t clen;
+  int i;
+
+  nxmutex_lock(&g_cromfs_cachelock);
+  hdr       = cromfs_offset2addr(fs, g_cromfs_ranext);
+  remaining = g_cromfs_raremaining;
+
+  for (i = 0; i < CONFIG_FS_CROMFS_READAHEAD && remaining > 0; i++)
+    {
+      blksize = cromfs_block_info(hdr, &ulen, &clen);
+      if (hdr->lzf_type == LZF_TYPE1_HDR)
+        {
+          cromfs_cache_block(fs, (FAR const uint8_t *)hdr +
+                             LZF_TYPE1_HDR_SIZE, clen);
+        }
+
+      remaining -= ulen < remaining ? ulen : remaining;
+      hdr        = (FAR const struct lzf_header_s *)
+                   ((FAR const uint8_t *)hdr + blksize);
+
+      /* Let readers in between two blocks */
+
+      nxmutex_unlock(&g_cromfs_cachelock);
+      nxmutex_lock(&g_cromfs_cachelock);
+    }
+
+  nxmutex_unlock(&g_cromfs_cachelock);
+}
+#endif
+
+/****************************************************************************
+ * Name: cromfs_readahead
+ *
+ * Description:
+ *   Schedule decompression of the blocks starting at "hdr".  "remaining" is
+ *   the amount of file data stored from that block onward.  Nothing is
+ *   done if readahead of an earlier read is still pending.
+ *
+ ****************************************************************************/
+
+#ifdef CROMFS_HAVE_READAHEAD
+static void cromfs_readahead(FAR const struct cromfs_volume_s *fs,
+                             FAR const struct lzf_header_s *hdr,
+                             uint32_t remaining)
+{
+  nxmutex_lock(&g_cromfs_cachelock);
+
+  if (work_available(&g_cromfs_rawork))
+    {
+      g_cromfs_ranext      = cromfs_addr2offset(fs, hdr);
+      g_cromfs_raremaining = remaining;
+      work_queue(LPWORK, &g_cromfs_rawork, cromfs_readahead_worker,
+                 (FAR void *)fs, 0);
+    }
+
+  nxmutex_unlock(&g_cromfs_cachelock);
+}
+#endif
+
 /****************************************************************************
  * Name: cromfs_find_node
  *
@@ -796,20 +1111,28 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
-  /* Create a file buffer to support partial sector accesses */
-
-  ff->ff_buffer = fs_heap_malloc(fs->cv_bsize);
-  if (!ff->ff_buffer)
-    {
-      fs_heap_free(ff);
-      return -ENOMEM;
-    }
-
   /* Save the node in the open file instance */
 
   ff->ff_node = (FAR const struct cromfs_node_s *)
     cromfs_offset2addr(fs, offset);
 
+  /* Create a file buffer to support partial sector accesses.  Files that
+   * are stored uncompressed are read straight from the image, and compressed
+   * files share the block cache when there is one.
+   */
+
+#ifndef CROMFS_HAVE_CACHE
+  if ((ff->ff_node->cn_flags & CROMFS_NODE_XIP) == 0)
+    {
+      ff->ff_buffer = fs_heap_malloc(fs->cv_bsize);
+      if (!ff->ff_buffer)
+        {
+          fs_heap_free(ff);
+          return -ENOMEM;
+        }
+    }
+#endif
+
   /* Save the index as the open-specific state in filep->f_priv */
 
   filep->f_priv = (FAR void *)ff;
@@ -830,7 +1153,7 @@ static int cromfs_close(FAR struct file *filep)
   /* Get the open file instance from the file structure */
 
   ff = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Free all resources consumed by the opened file */
 
@@ -852,6 +1175,11 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   FAR struct cromfs_file_s *ff;
   FAR struct lzf_header_s *currhdr;
   FAR struct lzf_header_s *nexthdr;
+#ifdef CROMFS_HAVE_CACHE
+  FAR struct cromfs_cache_s *entry;
+#else
+  uint32_t voloffs;
+#endif
   FAR uint8_t *dest;
   FAR const uint8_t *src;
   off_t fpos;
@@ -876,7 +1204,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   /* Get the open file instance from the file structure */
 
   ff = (FAR struct cromfs_file_s *)filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Check for a read past the end of the file */
 
@@ -897,6 +1225,21 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
       buflen = ff->ff_node->cn_size - filep->f_pos;
     }
 
+  /* Uncompressed files are simply copied out of the image */
+
+  if ((ff->ff_node->cn_flags & CROMFS_NODE_XIP) != 0)
+    {
+      if (buflen > 0)
+        {
+          src = (FAR const uint8_t *)
+                cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+          memcpy(buffer, src + filep->f_pos, buflen);
+          filep->f_pos += buflen;
+        }
+
+      return buflen;
+    }
+
   /* Find the compressed block containing the current offset, f_pos */
 
   dest      = (FAR uint8_t *)buffer;
@@ -927,28 +1270,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
 
           currhdr  = nexthdr;
           blkoffs += ulen;
-
-          if (currhdr->lzf_type == LZF_TYPE0_HDR)
-            {
-              FAR struct lzf_type0_header_s *hdr0 =
-                (FAR struct lzf_type0_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr0->lzf_len[0] << 8 |
-                        (uint16_t)hdr0->lzf_len[1];
-              blksize = (uint32_t)ulen + LZF_TYPE0_HDR_SIZE;
-            }
-          else
-            {
-              FAR struct lzf_type1_header_s * hdr1 =
-                (FAR struct lzf_type1_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr1->lzf_ulen[0] << 8 |
-                        (uint16_t)hdr1->lzf_ulen[1];
-              clen    = (uint16_t)hdr1->lzf_clen[0] << 8 |
-                        (uint16_t)hdr1->lzf_clen[1];
-              blksize = (uint32_t)clen + LZF_TYPE1_HDR_SIZE;
-            }
-
+          blksize  = cromfs_block_info(currhdr, &ulen, &clen);
           nexthdr  = (FAR struct lzf_header_s *)
                      ((FAR uint8_t *)currhdr + blksize);
         }
@@ -983,86 +1305,71 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
         }
       else
         {
-          /* If the source of the data is at the beginning of the compressed
-           * data buffer and if the uncompressed data would not overrun the
-           * buffer, then we can decompress directly into the user buffer.
-           */
+          copyoffs = (blkoffs >= filep->f_pos) ?
+                        0 : filep->f_pos - blkoffs;
+          DEBUGASSERT(ulen > copyoffs);
+          copysize = ulen - copyoffs;
 
-          if (filep->f_pos <= blkoffs && ulen <= remaining)
+          if (copysize > remaining)
             {
-              uint32_t voloffs;
+              /* Clip to the size really needed */
 
-              copyoffs = 0;
-              copysize = ulen;
+              copysize = remaining;
+            }
 
-              /* Get the address and offset in the CROMFS image to obtain
-               * the data.  Check if we already have this offset in the
-               * cache.
-               */
+          DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
 
-              src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
+          src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
 
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
+#ifdef CROMFS_HAVE_CACHE
+          /* Copy out of the shared cache of decompressed blocks */
 
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
+          nxmutex_lock(&g_cromfs_cachelock);
 
-              finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32
-                    " ulen=%" PRIu16 " ff_offset=%" PRIu32 " copysize=%u\n",
-                    voloffs, blkoffs, ulen, ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
-            }
-          else
-            {
-              uint32_t voloffs;
-
-              /* No, we will need to decompress into the our intermediate
-               * decompression buffer.
-               */
+          entry = cromfs_cache_block(fs, src, clen);
+          DEBUGASSERT(entry->cc_ulen >= (copyoffs + copysize));
+          memcpy(dest, &entry->cc_data[copyoffs], copysize);
 
-              copyoffs = (blkoffs >= filep->f_pos) ?
-                            0 : filep->f_pos - blkoffs;
-              DEBUGASSERT(ulen > copyoffs);
-              copysize = ulen - copyoffs;
+          nxmutex_unlock(&g_cromfs_cachelock);
+#else
+          /* Get the address and offset in the CROMFS image to obtain the
+           * data.  Check if we already have this offset in the cache.
+           */
 
-              if (copysize > remaining)
-                {
-                  /* Clip to the size really needed */
+          voloffs = cromfs_addr2offset(fs, src);
+          if (voloffs == ff->ff_offset)
+            {
+              DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
+              memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+            }
 
-                  copysize = remaining;
-                }
+          /* If the whole block is wanted, then we can decompress directly
+           * into the user buffer.
+           */
 
-              DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
+          else if (copyoffs == 0 && copysize == ulen)
+            {
+              lzf_decompress(src, clen, dest, fs->cv_bsize);
+            }
 
-              src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
+          /* No, we will need to decompress into the our intermediate
+           * decompression buffer.
+           */
 
-                  decomplen = lzf_decompress(src, clen, ff->ff_buffer,
+          else
+            {
+              ff->ff_ulen   = lzf_decompress(src, clen, ff->ff_buffer,
                                              fs->cv_bsize);
+              ff->ff_offset = voloffs;
 
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
-
-              finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32 " ulen=%" PRIu16
-                    " clen=%" PRIu16 " ff_offset=%" PRIu32
-                    "  copyoffs=%u copysize=%u\n",
-                    voloffs, blkoffs, ulen, clen, ff->ff_offset,
-                    copyoffs, copysize);
               DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
-
-              /* Then copy to user buffer */
-
               memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
             }
+#endif
+
+          finfo("blkoffs=%" PRIu32 " ulen=%" PRIu16 " clen=%" PRIu16
+                " copyoffs=%u copysize=%u\n",
+                blkoffs, ulen, clen, copyoffs, copysize);
         }
 
       /* Adjust pointers counts and offset */
@@ -1072,6 +1379,21 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
       fpos      += copysize;
     }
 
+#ifdef CROMFS_HAVE_READAHEAD
+  /* If this read continued the previous one, then the file is likely read
+   * sequentially: start decompressing the blocks that follow.
+   */
+
+  if (buflen > 0 && filep->f_pos == ff->ff_rapos &&
+      blkoffs + ulen < ff->ff_node->cn_size)
+    {
+      cromfs_readahead(fs, nexthdr,
+                       ff->ff_node->cn_size - (blkoffs + ulen));
+    }
+
+  ff->ff_rapos = fpos;
+#endif
+
   /* Update the file pointer */
 
   filep->f_pos = fpos;
@@ -1084,9 +1406,68 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
 
 static int cromfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
+  FAR const struct cromfs_volume_s *fs;
+  FAR struct cromfs_file_s *ff;
+
   finfo("cmd: %d arg: %08lx\n", cmd, arg);
 
-  /* No IOCTL commands yet supported */
+  if (cmd == FIOC_XIPBASE)
+    {
+      FAR uintptr_t *ptr = (FAR uintptr_t *)arg;
+
+      DEBUGASSERT(filep->f_priv != NULL && ptr != NULL);
+
+      fs = filep->f_inode->i_private;
+      ff = filep->f_priv;
+
+      /* Only files stored uncompressed can be accessed in place */
+
+      if ((ff->ff_node->cn_flags & CROMFS_NODE_XIP) == 0)
+        {
+          return -ENXIO;
+        }
+
+      *ptr = (uintptr_t)cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+      return OK;
+    }
+
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: cromfs_mmap
+ ****************************************************************************/
+
+static int cromfs_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR const struct cromfs_volume_s *fs;
+  FAR struct cromfs_file_s *ff;
+  uint32_t size;
+
+  /* Sanity checks */
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  /* Recover our private data from the struct file instance */
+
+  fs   = filep->f_inode->i_private;
+  ff   = filep->f_priv;
+  size = ff->ff_node->cn_size;
+
+  /* Return the address in the image corresponding to the requested offset
+   * of an uncompressed file.  Compressed files fall back to rammap().
+   */
+
+  if ((ff->ff_node->cn_flags & CROMFS_NODE_XIP) != 0 &&
+      map->offset >= 0 && map->offset < size &&
+      map->length != 0 && map->offset + map->length <= size)
+    {
+      map->vaddr = (FAR uint8_t *)
+                   cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks) +
+                   map->offset;
+      return OK;
+    }
 
   return -ENOTTY;
 }
@@ -1117,7 +1498,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   /* Get the open file instance from the file structure */
 
   oldff = oldp->f_priv;
-  DEBUGASSERT(oldff->ff_node != NULL && oldff->ff_buffer != NULL);
+  DEBUGASSERT(oldff->ff_node != NULL);
 
   /* Allocate and initialize an new open file instance referring to the
    * same node.
@@ -1131,11 +1512,14 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
 
   /* Create a file buffer to support partial sector accesses */
 
-  newff->ff_buffer = fs_heap_malloc(fs->cv_bsize);
-  if (newff->ff_buffer == NULL)
+  if (oldff->ff_buffer != NULL)
     {
-      fs_heap_free(newff);
-      return -ENOMEM;
+      newff->ff_buffer = fs_heap_malloc(fs->cv_bsize);
+      if (newff->ff_buffer == NULL)
+        {
+          fs_heap_free(newff);
+          return -ENOMEM;
+        }
     }
 
   /* Save the node in the open file instance */
@@ -1174,7 +1558,7 @@ static int cromfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
    */
 
   ff              = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   inode           = filep->f_inode;
   fs              = inode->i_private;
@@ -1431,11 +1815,23 @@ static int cromfs_rewinddir(FAR struct inode *mountpt,
 static int cromfs_bind(FAR struct inode *blkdriver, FAR const void *data,
                        FAR void **handle)
 {
+#ifdef CROMFS_HAVE_CACHE
+  int ret;
+
+#endif
   finfo("blkdriver: %p data: %p handle: %p\n", blkdriver, data, handle);
 
   DEBUGASSERT(blkdriver == NULL && handle != NULL);
   DEBUGASSERT(g_cromfs_image.cv_magic == CROMFS_MAGIC);
 
+#ifdef CROMFS_HAVE_CACHE
+  ret = cromfs_cache_initialize(&g_cromfs_image);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   /* Return the new file system handle */
 
   *handle = (FAR void *)&g_cromfs_image;
@@ -1455,6 +1851,11 @@ static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 {
   finfo("handle: %p blkdriver: %p flags: %02x\n",
         handle, blkdriver, flags);
+
+#ifdef CROMFS_HAVE_CACHE
+  cromfs_cache_uninitialize();
+#endif
+
   return OK;
 }
 
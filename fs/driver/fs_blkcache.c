@@ -0,0 +1,688 @@
+/****************************************************************************
+ * fs/driver/fs_blkcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* One pool of sector buffers is shared by every block driver.  Sectors are
+ * found through a hash on (inode, sector) and recycled in least recently
+ * used order.  The lock is held across device transfers, which keeps the
+ * bookkeeping simple at the price of serializing cached I/O.
+ *
+ * In write-back mode dirty sectors are written in runs of contiguous
+ * sectors, so that media with large erase pages see few, large transfers.
+ * A run is written when one of its sectors is evicted, when the volume is
+ * synced, when the dirty data exceeds CONFIG_FS_BLKCACHE_DIRTY_BYTES or
+ * when the oldest dirty sector reaches CONFIG_FS_BLKCACHE_DIRTY_AGE.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/blkcache.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BLKCACHE_NENTRIES \
+  (CONFIG_FS_BLKCACHE_SIZE / CONFIG_FS_BLKCACHE_SECTORSIZE)
+
+#if BLKCACHE_NENTRIES < 1
+#  error CONFIG_FS_BLKCACHE_SIZE is smaller than one sector
+#endif
+
+#ifdef CONFIG_FS_BLKCACHE_WRITEBACK
+/* A run never needs more sectors than the cache holds */
+
+#  if CONFIG_FS_BLKCACHE_WRITEBACK_BATCH < BLKCACHE_NENTRIES
+#    define BLKCACHE_BATCH CONFIG_FS_BLKCACHE_WRITEBACK_BATCH
+#  else
+#    define BLKCACHE_BATCH BLKCACHE_NENTRIES
+#  endif
+
+#  if defined(CONFIG_FS_BLKCACHE_DIRTY_AGE) && CONFIG_FS_BLKCACHE_DIRTY_AGE > 0
+#    define BLKCACHE_FLUSHER 1
+#    define BLKCACHE_DIRTY_TICKS MSEC2TICK(CONFIG_FS_BLKCACHE_DIRTY_AGE)
+#  endif
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct blkcache_entry_s
+{
+  dq_entry_t                   lru;    /* Most recently used first */
+  FAR struct blkcache_entry_s *hnext;  /* Next entry in the hash bucket */
+  FAR struct inode            *inode;  /* Block driver, NULL if unused */
+  blkcnt_t                     sector; /* Sector held by the entry */
+  bool                         dirty;  /* Not yet written to the device */
+#ifdef BLKCACHE_FLUSHER
+  clock_t                      dirtied; /* Time the entry became dirty */
+#endif
+  FAR uint8_t                 *data;   /* Sector contents */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint8_t g_blkcache_data[BLKCACHE_NENTRIES]
+                              [CONFIG_FS_BLKCACHE_SECTORSIZE]
+                              aligned_data(sizeof(uintptr_t));
+static struct blkcache_entry_s g_blkcache[BLKCACHE_NENTRIES];
+static FAR struct blkcache_entry_s *g_blkcache_hash[BLKCACHE_NENTRIES];
+static dq_queue_t g_blkcache_lru;
+static mutex_t g_blkcache_lock = NXMUTEX_INITIALIZER;
+static bool g_blkcache_ready;
+
+#ifdef CONFIG_FS_BLKCACHE_WRITEBACK
+/* Staging buffer used to write a run of dirty sectors in one transfer */
+
+static uint8_t g_blkcache_batch[BLKCACHE_BATCH]
+                               [CONFIG_FS_BLKCACHE_SECTORSIZE]
+                               aligned_data(sizeof(uintptr_t));
+
+/* Number of dirty entries */
+
+static unsigned int g_blkcache_ndirty;
+#endif
+
+#ifdef BLKCACHE_FLUSHER
+/* Writes back sectors that have been dirty for too long */
+
+static struct work_s g_blkcache_work;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkcache_bucket
+ ****************************************************************************/
+
+static FAR struct blkcache_entry_s **
+blkcache_bucket(FAR struct inode *inode, blkcnt_t sector)
+{
+  uintptr_t hash = (uintptr_t)inode ^ ((uintptr_t)sector * 2654435761u);
+
+  return &g_blkcache_hash[(hash ^ (hash >> 13)) % BLKCACHE_NENTRIES];
+}
+
+/****************************************************************************
+ * Name: blkcache_initialize
+ ****************************************************************************/
+
+static void blkcache_initialize(void)
+{
+  int i;
+
+  for (i = 0; i < BLKCACHE_NENTRIES; i++)
+    {
+      g_blkcache[i].data = g_blkcache_data[i];
+      dq_addlast(&g_blkcache[i].lru, &g_blkcache_lru);
+    }
+
+  g_blkcache_ready = true;
+}
+
+/****************************************************************************
+ * Name: blkcache_find
+ *
+ * Description:
+ *   Return the entry holding 'sector' of 'inode', or NULL.  A hit becomes
+ *   the most recently used entry if 'touch' is true.
+ *
+ ****************************************************************************/
+
+static FAR struct blkcache_entry_s *
+blkcache_find(FAR struct inode *inode, blkcnt_t sector, bool touch)
+{
+  FAR struct blkcache_entry_s *entry = *blkcache_bucket(inode, sector);
+
+  for (; entry != NULL; entry = entry->hnext)
+    {
+      if (entry->inode == inode && entry->sector == sector)
+        {
+          if (touch)
+            {
+              dq_rem(&entry->lru, &g_blkcache_lru);
+              dq_addfirst(&entry->lru, &g_blkcache_lru);
+            }
+
+          break;
+        }
+    }
+
+  return entry;
+}
+
+/****************************************************************************
+ * Name: blkcache_clean
+ *
+ * Description:
+ *   Mark an entry as matching the device.
+ *
+ ****************************************************************************/
+
+static void blkcache_clean(FAR struct blkcache_entry_s *entry)
+{
+#ifdef CONFIG_FS_BLKCACHE_WRITEBACK
+  if (entry->dirty)
+    {
+      g_blkcache_ndirty--;
+    }
+#endif
+
+  entry->dirty = false;
+}
+
+#ifdef CONFIG_FS_BLKCACHE_WRITEBACK
+
+/****************************************************************************
+ * Name: blkcache_writerun
+ *
+ * Description:
+ *   Write a dirty entry back to the device together with the contiguous
+ *   dirty sectors around it, up to BLKCACHE_BATCH sectors in one transfer.
+ *
+ ****************************************************************************/
+
+static int blkcache_writerun(FAR struct blkcache_entry_s *entry)
+{
+  FAR struct inode *inode = entry->inode;
+  FAR struct blkcache_entry_s *next;
+  FAR const uint8_t *buffer;
+  blkcnt_t first = entry->sector;
+  unsigned int nsectors;
+  unsigned int i;
+  ssize_t ret;
+
+  if (!entry->dirty)
+    {
+      return OK;
+    }
+
+  /* Find the start of the run, then gather it into the staging buffer */
+
+  while (first > 0 && entry->sector - first < BLKCACHE_BATCH - 1)
+    {
+      next = blkcache_find(inode, first - 1, false);
+      if (next == NULL || !next->dirty)
+        {
+          break;
+        }
+
+      first--;
+    }
+
+  for (nsectors = 0; nsectors < BLKCACHE_BATCH; nsectors++)
+    {
+      next = blkcache_find(inode, first + nsectors, false);
+      if (next == NULL || !next->dirty)
+        {
+          break;
+        }
+
+      memcpy(g_blkcache_batch[nsectors], next->data,
+             CONFIG_FS_BLKCACHE_SECTORSIZE);
+    }
+
+  /* A single sector is written straight from the entry */
+
+  buffer = nsectors > 1 ? g_blkcache_batch[0] : entry->data;
+
+  ret = inode->u.i_bops->write(inode, buffer, first, nsectors);
+  if (ret < 0)
+    {
+      ferr("ERROR: Write back of sectors %" PRIuOFF "-%" PRIuOFF
+           " failed: %zd\n", (off_t)first,
+           (off_t)(first + nsectors - 1), ret);
+      return (int)ret;
+    }
+
+  for (i = 0; i < (unsigned int)ret && i < nsectors; i++)
+    {
+      blkcache_clean(blkcache_find(inode, first + i, false));
+    }
+
+  return entry->dirty ? -EIO : OK;
+}
+
+/****************************************************************************
+ * Name: blkcache_writeall
+ *
+ * Description:
+ *   Write back every dirty entry of 'inode', or of all devices if 'inode'
+ *   is NULL.
+ *
+ ****************************************************************************/
+
+static int blkcache_writeall(FAR struct inode *inode)
+{
+  int ret = OK;
+  int i;
+
+  for (i = 0; i < BLKCACHE_NENTRIES && g_blkcache_ndirty > 0; i++)
+    {
+      if (g_blkcache[i].dirty &&
+          (inode == NULL || g_blkcache[i].inode == inode))
+        {
+          int status = blkcache_writerun(&g_blkcache[i]);
+          if (status < 0 && ret == OK)
+            {
+              ret = status;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkcache_flusher
+ *
+ * Description:
+ *   Work queue job that writes back the entries that have been dirty for
+ *   CONFIG_FS_BLKCACHE_DIRTY_AGE milliseconds, then reschedules itself for
+ *   the next entry to come of age.
+ *
+ ****************************************************************************/
+
+#ifdef BLKCACHE_FLUSHER
+static void blkcache_flusher(FAR void *arg)
+{
+  clock_t delay = BLKCACHE_DIRTY_TICKS;
+  clock_t now;
+  clock_t age;
+  int i;
+
+  nxmutex_lock(&g_blkcache_lock);
+
+  now = clock_systime_ticks();
+  for (i = 0; i < BLKCACHE_NENTRIES; i++)
+    {
+      if (g_blkcache[i].dirty &&
+          now - g_blkcache[i].dirtied >= BLKCACHE_DIRTY_TICKS)
+        {
+          blkcache_writerun(&g_blkcache[i]);
+        }
+    }
+
+  /* Entries that failed to write are retried after a full period */
+
+  for (i = 0; i < BLKCACHE_NENTRIES; i++)
+    {
+      if (g_blkcache[i].dirty)
+        {
+          age = now - g_blkcache[i].dirtied;
+          if (age < BLKCACHE_DIRTY_TICKS &&
+              BLKCACHE_DIRTY_TICKS - age < delay)
+            {
+              delay = BLKCACHE_DIRTY_TICKS - age;
+            }
+        }
+    }
+
+  if (g_blkcache_ndirty > 0)
+    {
+      work_queue(LPWORK, &g_blkcache_work, blkcache_flusher, NULL, delay);
+    }
+
+  nxmutex_unlock(&g_blkcache_lock);
+}
+#endif
+
+/****************************************************************************
+ * Name: blkcache_dirty
+ *
+ * Description:
+ *   Mark an entry as newer than the device.
+ *
+ ****************************************************************************/
+
+static void blkcache_dirty(FAR struct blkcache_entry_s *entry)
+{
+  if (entry->dirty)
+    {
+      return;
+    }
+
+  entry->dirty = true;
+  g_blkcache_ndirty++;
+
+#ifdef BLKCACHE_FLUSHER
+  entry->dirtied = clock_systime_ticks();
+  if (work_available(&g_blkcache_work))
+    {
+      work_queue(LPWORK, &g_blkcache_work, blkcache_flusher, NULL,
+                 BLKCACHE_DIRTY_TICKS);
+    }
+#endif
+}
+
+#else
+
+/* Write-through entries are never dirty */
+
+static int blkcache_writerun(FAR struct blkcache_entry_s *entry)
+{
+  return OK;
+}
+#endif /* CONFIG_FS_BLKCACHE_WRITEBACK */
+
+/****************************************************************************
+ * Name: blkcache_drop
+ *
+ * Description:
+ *   Remove an entry from the hash and make it the first to be reused.
+ *
+ ****************************************************************************/
+
+static void blkcache_drop(FAR struct blkcache_entry_s *entry)
+{
+  FAR struct blkcache_entry_s **pprev;
+
+  pprev = blkcache_bucket(entry->inode, entry->sector);
+  while (*pprev != entry)
+    {
+      pprev = &(*pprev)->hnext;
+    }
+
+  *pprev       = entry->hnext;
+  entry->inode = NULL;
+  blkcache_clean(entry);
+
+  dq_rem(&entry->lru, &g_blkcache_lru);
+  dq_addlast(&entry->lru, &g_blkcache_lru);
+}
+
+/****************************************************************************
+ * Name: blkcache_alloc
+ *
+ * Description:
+ *   Recycle the least recently used entry for 'sector' of 'inode'.  The
+ *   caller fills in the data.  NULL is returned if a dirty victim could
+ *   not be written back.
+ *
+ ****************************************************************************/
+
+static FAR struct blkcache_entry_s *
+blkcache_alloc(FAR struct inode *inode, blkcnt_t sector)
+{
+  FAR struct blkcache_entry_s *entry;
+  FAR struct blkcache_entry_s **bucket;
+
+  entry = (FAR struct blkcache_entry_s *)dq_tail(&g_blkcache_lru);
+  if (entry->inode != NULL)
+    {
+      if (blkcache_writerun(entry) < 0)
+        {
+          return NULL;
+        }
+
+      blkcache_drop(entry);
+    }
+
+  bucket        = blkcache_bucket(inode, sector);
+  entry->inode  = inode;
+  entry->sector = sector;
+  entry->hnext  = *bucket;
+  *bucket       = entry;
+
+  dq_rem(&entry->lru, &g_blkcache_lru);
+  dq_addfirst(&entry->lru, &g_blkcache_lru);
+  return entry;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkcache_read
+ *
+ * Description:
+ *   Read sectors from a block driver through the shared block cache.
+ *   Cached sectors are copied out; each run of missing sectors is read
+ *   from the device in one transfer and then entered into the cache.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                      blkcnt_t start, unsigned int nsectors,
+                      size_t sectsize)
+{
+  FAR struct blkcache_entry_s *entry;
+  unsigned int i = 0;
+  unsigned int j;
+  ssize_t ret;
+
+  if (sectsize != CONFIG_FS_BLKCACHE_SECTORSIZE)
+    {
+      return inode->u.i_bops->read(inode, buffer, start, nsectors);
+    }
+
+  nxmutex_lock(&g_blkcache_lock);
+  if (!g_blkcache_ready)
+    {
+      blkcache_initialize();
+    }
+
+  while (i < nsectors)
+    {
+      entry = blkcache_find(inode, start + i, true);
+      if (entry != NULL)
+        {
+          memcpy(buffer + i * sectsize, entry->data, sectsize);
+          i++;
+          continue;
+        }
+
+      for (j = i + 1; j < nsectors; j++)
+        {
+          if (blkcache_find(inode, start + j, false) != NULL)
+            {
+              break;
+            }
+        }
+
+      ret = inode->u.i_bops->read(inode, buffer + i * sectsize,
+                                  start + i, j - i);
+      if (ret <= 0)
+        {
+          nxmutex_unlock(&g_blkcache_lock);
+          return i > 0 ? i : ret;
+        }
+
+      for (j = i + ret; i < j; i++)
+        {
+          entry = blkcache_alloc(inode, start + i);
+          if (entry != NULL)
+            {
+              memcpy(entry->data, buffer + i * sectsize, sectsize);
+            }
+        }
+    }
+
+  nxmutex_unlock(&g_blkcache_lock);
+  return i;
+}
+
+/****************************************************************************
+ * Name: blkcache_write
+ *
+ * Description:
+ *   Write sectors to a block driver through the shared block cache.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_write(FAR struct inode *inode,
+                       FAR const unsigned char *buffer, blkcnt_t start,
+                       unsigned int nsectors, size_t sectsize)
+{
+  FAR struct blkcache_entry_s *entry;
+  unsigned int i;
+  ssize_t ret;
+
+  if (sectsize != CONFIG_FS_BLKCACHE_SECTORSIZE)
+    {
+      return inode->u.i_bops->write(inode, buffer, start, nsectors);
+    }
+
+  nxmutex_lock(&g_blkcache_lock);
+  if (!g_blkcache_ready)
+    {
+      blkcache_initialize();
+    }
+
+#ifdef CONFIG_FS_BLKCACHE_WRITEBACK
+  /* Writes of up to one run are only made to the cache and reach the
+   * device later, coalesced with their neighbours.  Larger writes are
+   * already efficient and go straight to the device.
+   */
+
+  if (nsectors <= BLKCACHE_BATCH)
+    {
+      for (i = 0; i < nsectors; i++)
+        {
+          entry = blkcache_find(inode, start + i, true);
+          if (entry == NULL)
+            {
+              entry = blkcache_alloc(inode, start + i);
+              if (entry == NULL)
+                {
+                  break;
+                }
+            }
+
+          memcpy(entry->data, buffer + i * sectsize, sectsize);
+          blkcache_dirty(entry);
+        }
+
+      /* Throttle writers once too much data is held back */
+
+      if ((size_t)g_blkcache_ndirty * sectsize >
+          CONFIG_FS_BLKCACHE_DIRTY_BYTES)
+        {
+          blkcache_writeall(NULL);
+        }
+
+      if (i == nsectors)
+        {
+          nxmutex_unlock(&g_blkcache_lock);
+          return nsectors;
+        }
+
+      /* A dirty victim could not be written back, write the rest
+       * through.
+       */
+
+      ret = inode->u.i_bops->write(inode, buffer + i * sectsize,
+                                   start + i, nsectors - i);
+      nxmutex_unlock(&g_blkcache_lock);
+      return ret < 0 ? (i > 0 ? i : ret) : i + ret;
+    }
+#endif
+
+  ret = inode->u.i_bops->write(inode, buffer, start, nsectors);
+
+  /* Keep the cached copies in step with the device */
+
+  for (i = 0; ret > 0 && i < (unsigned int)ret; i++)
+    {
+      entry = blkcache_find(inode, start + i, nsectors == 1);
+      if (entry == NULL && nsectors == 1)
+        {
+          entry = blkcache_alloc(inode, start);
+        }
+
+      if (entry != NULL)
+        {
+          memcpy(entry->data, buffer + i * sectsize, sectsize);
+          blkcache_clean(entry);
+        }
+    }
+
+  nxmutex_unlock(&g_blkcache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkcache_flush
+ *
+ * Description:
+ *   Write all dirty cached sectors of a block driver to the device.
+ *
+ ****************************************************************************/
+
+int blkcache_flush(FAR struct inode *inode)
+{
+  int ret = OK;
+
+#ifdef CONFIG_FS_BLKCACHE_WRITEBACK
+  nxmutex_lock(&g_blkcache_lock);
+  ret = blkcache_writeall(inode);
+  nxmutex_unlock(&g_blkcache_lock);
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkcache_invalidate
+ *
+ * Description:
+ *   Flush, then drop, all cached sectors of a block driver.
+ *
+ ****************************************************************************/
+
+void blkcache_invalidate(FAR struct inode *inode)
+{
+  int i;
+
+  nxmutex_lock(&g_blkcache_lock);
+  for (i = 0; i < BLKCACHE_NENTRIES; i++)
+    {
+      if (g_blkcache[i].inode == inode)
+        {
+          blkcache_writerun(&g_blkcache[i]);
+          blkcache_drop(&g_blkcache[i]);
+        }
+    }
+
+  nxmutex_unlock(&g_blkcache_lock);
+}
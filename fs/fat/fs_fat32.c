@@ -30,6 +30,7 @@
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <sys/mount.h>
+#include <sys/param.h>
 
 #include <stdlib.h>
 #include <unistd.h>
@@ -40,6 +41,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/blkcache.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
 
@@ -75,6 +77,8 @@ static off_t   fat_seek(FAR struct file *filep, off_t offset, int whence);
 static int     fat_ioctl(FAR struct file *filep, int cmd,
                  unsigned long arg);
 
+static int     fat_syncfile(FAR struct fat_mountpt_s *fs,
+                 FAR struct fat_file_s *ff);
 static int     fat_sync(FAR struct file *filep);
 static int     fat_dup(FAR const struct file *oldp, FAR struct file *newp);
 static int     fat_fstat(FAR const struct file *filep,
@@ -113,6 +117,7 @@ static int     fat_stat_root(FAR struct fat_mountpt_s *fs,
                  FAR struct stat *buf);
 static int     fat_stat(struct inode *mountpt, const char *relpath,
                  FAR struct stat *buf);
+static int     fat_syncfs(FAR struct inode *mountpt);
 
 /****************************************************************************
  * Public Data
@@ -156,7 +161,8 @@ const struct mountpt_operations g_fat_operations =
   fat_rmdir,         /* rmdir */
   fat_rename,        /* rename */
   fat_stat,          /* stat */
-  NULL               /* chstat */
+  NULL,              /* chstat */
+  fat_syncfs         /* syncfs */
 };
 
 /****************************************************************************
@@ -622,6 +628,25 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
 
   /* Traverse the existing chain */
 
+#if CONFIG_FAT_EXTENTS > 0
+  i = MIN(num_clu, new_num_clu);
+  if (i > num_traversed)
+    {
+      /* Let the extents of the file skip over the known part */
+
+      off_t next = fat_ffcluster(fs, ff, i - 1);
+      if (next < 0)
+        {
+          return next;
+        }
+
+      cluster = next;
+    }
+  else
+    {
+      i = num_traversed;
+    }
+#else
   for (i = num_traversed; i < num_clu && i < new_num_clu; i++)
     {
       cluster = fat_getcluster(fs, cluster);
@@ -633,6 +658,7 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
           return -EIO;
         }
     }
+#endif
 
   if (read)
     {
@@ -1375,54 +1401,19 @@ static int fat_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 }
 
 /****************************************************************************
- * Name: fat_sync
+ * Name: fat_syncfile
  *
- * Description: Synchronize the file state on disk to match internal, in-
- *   memory state.
+ * Description: Write the buffered data and the directory entry of one open
+ *   file to the volume.  The caller holds fs_lock.
  *
  ****************************************************************************/
 
-static int fat_sync(FAR struct file *filep)
+static int fat_syncfile(FAR struct fat_mountpt_s *fs,
+                        FAR struct fat_file_s *ff)
 {
-  FAR struct inode *inode;
-  FAR struct fat_mountpt_s *fs;
-  FAR struct fat_file_s *ff;
   uint32_t wrttime;
   uint8_t *direntry;
-  int ret;
-
-  /* Sanity checks */
-
-  DEBUGASSERT(filep->f_priv != NULL);
-
-  /* Check for the forced mount condition */
-
-  ff = filep->f_priv;
-  if ((ff->ff_bflags & UMOUNT_FORCED) != 0)
-    {
-      return -EPIPE;
-    }
-
-  /* Recover our private data from the struct file instance */
-
-  inode = filep->f_inode;
-  fs    = inode->i_private;
-
-  DEBUGASSERT(fs != NULL);
-
-  /* Make sure that the mount is still healthy */
-
-  ret = nxmutex_lock(&fs->fs_lock);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  ret = fat_checkmount(fs);
-  if (ret != OK)
-    {
-      goto errout_with_lock;
-    }
+  int ret = OK;
 
   /* Check if the has been modified in any way */
 
@@ -1435,7 +1426,7 @@ static int fat_sync(FAR struct file *filep)
       ret = fat_ffcacheflush(fs, ff);
       if (ret < 0)
         {
-          goto errout_with_lock;
+          return ret;
         }
 
       /* Update the directory entry.  First read the directory
@@ -1445,7 +1436,7 @@ static int fat_sync(FAR struct file *filep)
       ret = fat_fscacheread(fs, ff->ff_dirsector);
       if (ret < 0)
         {
-          goto errout_with_lock;
+          return ret;
         }
 
       /* Recover a pointer to the specific directory entry
@@ -1492,6 +1483,120 @@ static int fat_sync(FAR struct file *filep)
       ret          = fat_updatefsinfo(fs);
     }
 
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_sync
+ *
+ * Description: Synchronize the file state on disk to match internal, in-
+ *   memory state.
+ *
+ ****************************************************************************/
+
+static int fat_sync(FAR struct file *filep)
+{
+  FAR struct inode *inode;
+  FAR struct fat_mountpt_s *fs;
+  FAR struct fat_file_s *ff;
+  int ret;
+
+  /* Sanity checks */
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  /* Check for the forced mount condition */
+
+  ff = filep->f_priv;
+  if ((ff->ff_bflags & UMOUNT_FORCED) != 0)
+    {
+      return -EPIPE;
+    }
+
+  /* Recover our private data from the struct file instance */
+
+  inode = filep->f_inode;
+  fs    = inode->i_private;
+
+  DEBUGASSERT(fs != NULL);
+
+  /* Make sure that the mount is still healthy */
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = fat_checkmount(fs);
+  if (ret != OK)
+    {
+      goto errout_with_lock;
+    }
+
+  ret = fat_syncfile(fs, ff);
+
+  /* Push the sectors held back by the block cache out to the media */
+
+  if (ret >= 0)
+    {
+      ret = blkcache_flush(fs->fs_blkdriver);
+    }
+
+errout_with_lock:
+  nxmutex_unlock(&fs->fs_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_syncfs
+ *
+ * Description: Synchronize every open file of the volume and write back
+ *   everything that the block cache still holds for it.
+ *
+ ****************************************************************************/
+
+static int fat_syncfs(FAR struct inode *mountpt)
+{
+  FAR struct fat_mountpt_s *fs;
+  FAR struct fat_file_s *ff;
+  int ret;
+
+  /* Sanity checks */
+
+  DEBUGASSERT(mountpt && mountpt->i_private);
+
+  /* Get the mountpoint private data from the inode structure */
+
+  fs = mountpt->i_private;
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = fat_checkmount(fs);
+  if (ret != OK)
+    {
+      goto errout_with_lock;
+    }
+
+  for (ff = fs->fs_head; ff != NULL && ret >= 0; ff = ff->ff_next)
+    {
+      ret = fat_syncfile(fs, ff);
+    }
+
+  if (ret >= 0)
+    {
+      ret = fat_fscacheflush(fs);
+    }
+
+  if (ret >= 0)
+    {
+      ret = blkcache_flush(fs->fs_blkdriver);
+    }
+
 errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -1931,6 +2036,12 @@ static int fat_truncate(FAR struct file *filep, off_t length)
           ret = fat_dirshrink(fs, direntry, length);
         }
 
+#if CONFIG_FAT_EXTENTS > 0
+      /* The extents may now describe clusters that were released */
+
+      ff->ff_nextents = 0;
+#endif
+
       if (ret >= 0)
         {
           /* The truncation has completed without error.  Update the file
@@ -2333,6 +2444,7 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       FAR struct inode *inode = fs->fs_blkdriver;
       if (inode)
         {
+          blkcache_invalidate(inode);
           if (inode->u.i_bops && inode->u.i_bops->close)
             {
               inode->u.i_bops->close(inode);
@@ -2358,6 +2470,10 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  fs_heap_free(fs->fs_freemap);
+#endif
+
   nxmutex_destroy(&fs->fs_lock);
   fs_heap_free(fs);
   return OK;
@@ -853,6 +853,19 @@
 #  define fat_io_free(m,s) fs_heap_free(m)
 #endif
 
+/****************************************************************************
+ * Free cluster bitmap and cluster chain extents
+ ****************************************************************************/
+
+/* Size in bytes of the free cluster bitmap, one bit per cluster */
+
+#define FAT_FREEMAP_SIZE(fs) \
+  ((((fs)->fs_nclusters + 31) >> 5) * sizeof(uint32_t))
+
+#ifndef CONFIG_FAT_EXTENTS
+#  define CONFIG_FAT_EXTENTS 0
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -891,8 +904,24 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#ifdef CONFIG_FAT_FREEMAP
+  FAR uint32_t *fs_freemap;        /* One bit per cluster, set if the cluster is
+                                    * free (NULL if not built) */
+  bool     fs_freemaptried;        /* true: Building fs_freemap was attempted */
+#endif
 };
 
+#if CONFIG_FAT_EXTENTS > 0
+/* A run of contiguous clusters in the cluster chain of an open file */
+
+struct fat_extent_s
+{
+  uint32_t fe_index;               /* Index of the first cluster in the file */
+  uint32_t fe_cluster;             /* First cluster of the run on the media */
+  uint32_t fe_count;               /* Number of clusters in the run */
+};
+#endif
+
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
  * opened file.
@@ -913,6 +942,13 @@ struct fat_file_s
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   off_t    ff_pos;                 /* Current position in the file */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#if CONFIG_FAT_EXTENTS > 0
+  uint8_t  ff_nextents;            /* Number of valid entries in ff_extents */
+
+  /* Runs of the cluster chain, in file order */
+
+  struct fat_extent_s ff_extents[CONFIG_FAT_EXTENTS];
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1048,6 +1084,10 @@ EXTERN off_t  fat_getcluster(FAR struct fat_mountpt_s *fs,
                              uint32_t clusterno);
 EXTERN int    fat_putcluster(FAR struct fat_mountpt_s *fs,
                              uint32_t clusterno, off_t startsector);
+#if CONFIG_FAT_EXTENTS > 0
+EXTERN off_t  fat_ffcluster(FAR struct fat_mountpt_s *fs,
+                            FAR struct fat_file_s *ff, uint32_t index);
+#endif
 EXTERN int    fat_removechain(FAR struct fat_mountpt_s *fs,
                               uint32_t cluster);
 EXTERN int32_t fat_extendchain(FAR struct fat_mountpt_s *fs,
@@ -32,12 +32,14 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <time.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/blkcache.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
 
@@ -270,6 +272,108 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_setfree
+ *
+ * Description:
+ *   Record in the free cluster bitmap whether 'cluster' is free.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static void fat_setfree(FAR struct fat_mountpt_s *fs, uint32_t cluster,
+                        bool isfree)
+{
+  uint32_t bit = cluster - 2;
+
+  if (isfree)
+    {
+      fs->fs_freemap[bit >> 5] |= (uint32_t)1 << (bit & 31);
+    }
+  else
+    {
+      fs->fs_freemap[bit >> 5] &= ~((uint32_t)1 << (bit & 31));
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_scanfree
+ *
+ * Description:
+ *   Return the first bit set in the free cluster bitmap in the range
+ *   [from, to), or -1 if there is none.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static int32_t fat_scanfree(FAR struct fat_mountpt_s *fs, uint32_t from,
+                            uint32_t to)
+{
+  uint32_t word;
+  uint32_t bit;
+
+  while (from < to)
+    {
+      /* Ignore the bits below 'from' in its word */
+
+      word = fs->fs_freemap[from >> 5] & (UINT32_MAX << (from & 31));
+      if (word != 0)
+        {
+          bit = (from & ~31) + ffs(word) - 1;
+          return bit < to ? (int32_t)bit : -1;
+        }
+
+      from = (from | 31) + 1;
+    }
+
+  return -1;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_findfree
+ *
+ * Description:
+ *   Find a free cluster in the free cluster bitmap.  The search starts
+ *   after 'startcluster' and wraps around to the beginning of the FAT, in
+ *   the same order as the search through the FAT in fat_extendchain().
+ *
+ * Returned Value:
+ *   The number of the free cluster, or zero if there is no free cluster.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static uint32_t fat_findfree(FAR struct fat_mountpt_s *fs,
+                             uint32_t startcluster)
+{
+  uint32_t start = startcluster - 1;
+  int32_t bit;
+
+  /* Bit N of the bitmap is cluster N + 2, so 'start' is the bit of the
+   * cluster that follows 'startcluster'.
+   */
+
+  if (start >= fs->fs_nclusters)
+    {
+      start = 0;
+    }
+
+  bit = fat_scanfree(fs, start, fs->fs_nclusters);
+  if (bit < 0)
+    {
+      bit = fat_scanfree(fs, 0, start);
+      if (bit < 0)
+        {
+          return 0;
+        }
+    }
+
+  return bit + 2;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -728,8 +832,9 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->read)
         {
-          ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
-                                                       sector, nsectors);
+          ssize_t nsectorsread = blkcache_read(inode, buffer, sector,
+                                               nsectors,
+                                               fs->fs_hwsectorsize);
           if (nsectorsread == nsectors)
             {
               ret = OK;
@@ -762,7 +867,8 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
       if (inode && inode->u.i_bops && inode->u.i_bops->write)
         {
           ssize_t nsectorswritten =
-              inode->u.i_bops->write(inode, buffer, sector, nsectors);
+              blkcache_write(inode, buffer, sector, nsectors,
+                             fs->fs_hwsectorsize);
 
           if (nsectorswritten == nsectors)
             {
@@ -1100,6 +1206,15 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
             return -EINVAL;
         }
 
+#ifdef CONFIG_FAT_FREEMAP
+      /* Keep the free cluster bitmap in step with the FAT */
+
+      if (fs->fs_freemap != NULL && clusterno >= 2)
+        {
+          fat_setfree(fs, clusterno, nextcluster == 0);
+        }
+#endif
+
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
@@ -1109,6 +1224,103 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: fat_ffcluster
+ *
+ * Description:
+ *   Return the cluster that holds the cluster with index 'index' (counting
+ *   from zero) of an open file.  The clusters covered by the extents of the
+ *   file are found without reading the FAT; the chain is followed from the
+ *   end of the last extent otherwise, recording the runs of contiguous
+ *   clusters that are met while there are free extents.
+ *
+ * Returned Value:
+ *   The cluster number, or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_EXTENTS > 0
+off_t fat_ffcluster(FAR struct fat_mountpt_s *fs,
+                    FAR struct fat_file_s *ff, uint32_t index)
+{
+  FAR struct fat_extent_s *extent;
+  uint32_t clusterindex;
+  off_t    cluster;
+  off_t    next;
+  bool     record = true;
+  int      i;
+
+  for (i = 0; i < ff->ff_nextents; i++)
+    {
+      extent = &ff->ff_extents[i];
+      if (index < extent->fe_index + extent->fe_count)
+        {
+          return extent->fe_cluster + (index - extent->fe_index);
+        }
+    }
+
+  /* The first extent starts with the first cluster of the file */
+
+  if (ff->ff_nextents == 0)
+    {
+      if (ff->ff_startcluster < 2 ||
+          ff->ff_startcluster >= fs->fs_nclusters + 2)
+        {
+          return -EIO;
+        }
+
+      extent             = &ff->ff_extents[0];
+      extent->fe_index   = 0;
+      extent->fe_cluster = ff->ff_startcluster;
+      extent->fe_count   = 1;
+      ff->ff_nextents    = 1;
+    }
+
+  /* Follow the chain from the last cluster that the extents know of */
+
+  extent       = &ff->ff_extents[ff->ff_nextents - 1];
+  clusterindex = extent->fe_index + extent->fe_count - 1;
+  cluster      = extent->fe_cluster + extent->fe_count - 1;
+
+  while (clusterindex < index)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          return next;
+        }
+
+      /* The chain is broken */
+
+      if (next < 2 || next >= fs->fs_nclusters + 2)
+        {
+          return -EIO;
+        }
+
+      clusterindex++;
+      if (record && next == cluster + 1)
+        {
+          extent->fe_count++;
+        }
+      else if (record && ff->ff_nextents < CONFIG_FAT_EXTENTS)
+        {
+          extent             = &ff->ff_extents[ff->ff_nextents++];
+          extent->fe_index   = clusterindex;
+          extent->fe_cluster = next;
+          extent->fe_count   = 1;
+        }
+      else
+        {
+          record = false;
+        }
+
+      cluster = next;
+    }
+
+  return cluster;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_removechain
  *
@@ -1226,61 +1438,87 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
-   */
+#ifdef CONFIG_FAT_FREEMAP
+  /* Build the free cluster bitmap with the first allocation */
 
-  newcluster = startcluster;
-  for (; ; )
+  if (fs->fs_freemap == NULL && !fs->fs_freemaptried)
     {
-      /* Examine the next cluster in the FAT */
+      ret = fat_computefreeclusters(fs);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
 
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters + 2)
+  if (fs->fs_freemap != NULL)
+    {
+      /* The bitmap tells where the next free cluster is */
+
+      newcluster = fat_findfree(fs, startcluster);
+      if (newcluster == 0)
         {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
+          return 0;
+        }
+    }
+  else
+#endif
+    {
+      /* Loop until (1) we discover that there are not free clusters
+       * (return 0), an errors occurs (return -errno), or (3) we find
+       * the next cluster (return the new cluster number).
+       */
+
+      newcluster = startcluster;
+      for (; ; )
+        {
+          /* Examine the next cluster in the FAT */
 
-          newcluster = 2;
-          if (newcluster > startcluster)
+          newcluster++;
+          if (newcluster >= fs->fs_nclusters + 2)
             {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
+              /* If we hit the end of the available clusters, then
+               * wrap back to the beginning because we might have
+               * started at a non-optimal place.  But don't continue
+               * past the start cluster.
                */
 
-              return 0;
+              newcluster = 2;
+              if (newcluster > startcluster)
+                {
+                  /* We are back past the starting cluster, then there
+                   * is no free cluster.
+                   */
+
+                  return 0;
+                }
             }
-        }
 
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
-       */
+          /* We have a candidate cluster.  Check if the cluster number is
+           * mapped to a group of sectors.
+           */
 
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
-        {
-          /* Found have found a free cluster break out */
+          startsector = fat_getcluster(fs, newcluster);
+          if (startsector == 0)
+            {
+              /* Found have found a free cluster break out */
 
-          break;
-        }
-      else if (startsector < 0)
-        {
-          /* Some error occurred, return the error number */
+              break;
+            }
+          else if (startsector < 0)
+            {
+              /* Some error occurred, return the error number */
 
-          return startsector;
-        }
+              return startsector;
+            }
 
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
+          /* We wrap all the back to the starting cluster?  If so, then
+           * there are no free clusters.
+           */
 
-      if (newcluster == startcluster)
-        {
-          return 0;
+          if (newcluster == startcluster)
+            {
+              return 0;
+            }
         }
     }
 
@@ -2038,37 +2276,67 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
   /* We have to count the number of free clusters */
 
   uint32_t nfreeclusters = 0;
-  if (fs->fs_type == FSTYPE_FAT12)
+  uint32_t clusterno;
+  int      ret = OK;
+
+#ifdef CONFIG_FAT_FREEMAP
+  /* Build the free cluster bitmap while we are at it */
+
+  if (fs->fs_freemap == NULL && !fs->fs_freemaptried)
     {
-      off_t sector;
+      fs->fs_freemaptried = true;
+      fs->fs_freemap      = fs_heap_zalloc(FAT_FREEMAP_SIZE(fs));
+    }
+  else if (fs->fs_freemap != NULL)
+    {
+      memset(fs->fs_freemap, 0, FAT_FREEMAP_SIZE(fs));
+    }
+#endif
 
+  if (fs->fs_type == FSTYPE_FAT12)
+    {
       /* Examine every cluster in the fat */
 
-      for (sector = 2; sector < fs->fs_nclusters + 2; sector++)
+      for (clusterno = 2; clusterno < fs->fs_nclusters + 2; clusterno++)
         {
+          off_t next = fat_getcluster(fs, clusterno);
+
+          if (next < 0)
+            {
+              ret = next;
+              goto errout;
+            }
+
           /* If the cluster is unassigned, then increment the count of free
            * clusters
            */
 
-          if ((uint16_t)fat_getcluster(fs, sector) == 0)
+          if ((uint16_t)next == 0)
             {
               nfreeclusters++;
+#ifdef CONFIG_FAT_FREEMAP
+              if (fs->fs_freemap != NULL)
+                {
+                  fat_setfree(fs, clusterno, true);
+                }
+#endif
             }
         }
     }
   else
     {
-      unsigned int cluster;
       off_t        fatsector;
       unsigned int offset;
-      int          ret;
+      uint32_t     next;
 
       fatsector    = fs->fs_fatbase;
       offset       = fs->fs_hwsectorsize;
 
-      /* Examine each cluster in the fat */
+      /* Examine each cluster in the fat.  The first two entries of the FAT
+       * are reserved, data clusters are 2 through fs_nclusters + 1.
+       */
 
-      for (cluster = fs->fs_nclusters; cluster > 0; cluster--)
+      for (clusterno = 0; clusterno < fs->fs_nclusters + 2; clusterno++)
         {
           /* If we are starting a new sector, then read the new sector in
            * fs_buffer
@@ -2079,7 +2347,7 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
               ret = fat_fscacheread(fs, fatsector);
               if (ret < 0)
                 {
-                  return ret;
+                  goto errout;
                 }
 
               /* Reset the offset to the next FAT entry.
@@ -2096,21 +2364,24 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
 
           if (fs->fs_type == FSTYPE_FAT16)
             {
-              if (FAT_GETFAT16(fs->fs_buffer, offset) == 0)
-                {
-                  nfreeclusters++;
-                }
-
+              next    = FAT_GETFAT16(fs->fs_buffer, offset);
               offset += 2;
             }
           else
             {
-              if (FAT_GETFAT32(fs->fs_buffer, offset) == 0)
+              next    = FAT_GETFAT32(fs->fs_buffer, offset) & 0x0fffffff;
+              offset += 4;
+            }
+
+          if (next == 0 && clusterno >= 2)
+            {
+              nfreeclusters++;
+#ifdef CONFIG_FAT_FREEMAP
+              if (fs->fs_freemap != NULL)
                 {
-                  nfreeclusters++;
+                  fat_setfree(fs, clusterno, true);
                 }
-
-              offset += 4;
+#endif
             }
         }
     }
@@ -2122,6 +2393,15 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
     }
 
   return OK;
+
+errout:
+#ifdef CONFIG_FAT_FREEMAP
+  /* A partial bitmap is of no use, fall back to searching the FAT */
+
+  fs_heap_free(fs->fs_freemap);
+  fs->fs_freemap = NULL;
+#endif
+  return ret;
 }
 
 /****************************************************************************
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -38,6 +39,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/lib/lib.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -65,6 +67,19 @@ struct hostfs_dir_s
   FAR void *dir;
 };
 
+#if CONFIG_FS_HOSTFS_STAT_CACHE > 0
+/* A result of host_stat() that is still trusted */
+
+struct hostfs_statent_s
+{
+  uint32_t gen;                     /* Matches g_stat_gen while valid */
+  clock_t expire;                   /* Ticks when the result gets stale */
+  int ret;                          /* Negative results are kept too */
+  struct stat st;
+  char path[HOSTFS_MAX_PATH];
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -130,6 +145,17 @@ static int     hostfs_chstat(FAR struct inode *mountpt,
 
 static mutex_t g_lock = NXMUTEX_INITIALIZER;
 
+#if CONFIG_FS_HOSTFS_STAT_CACHE > 0
+/* Every change made through hostfs bumps the generation, which drops all
+ * cached results at once.  Changes made by the host itself are seen once a
+ * result expires.
+ */
+
+static struct hostfs_statent_s g_stat_cache[CONFIG_FS_HOSTFS_STAT_CACHE];
+static uint32_t g_stat_gen = 1;
+static int g_stat_next;
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -240,6 +266,266 @@ static void hostfs_mkpath(FAR struct hostfs_mountpt_s  *fs,
     }
 }
 
+/****************************************************************************
+ * Name: hostfs_stat_invalidate
+ *
+ * Description: Forget all cached stat results.  Called with g_lock held
+ *   after anything that may change them.
+ *
+ ****************************************************************************/
+
+static inline void hostfs_stat_invalidate(void)
+{
+#if CONFIG_FS_HOSTFS_STAT_CACHE > 0
+  g_stat_gen++;
+#endif
+}
+
+/****************************************************************************
+ * Name: hostfs_cached_stat
+ *
+ * Description: host_stat() through the cache of recent results.
+ *
+ ****************************************************************************/
+
+static int hostfs_cached_stat(FAR const char *path, FAR struct stat *buf)
+{
+#if CONFIG_FS_HOSTFS_STAT_CACHE > 0
+  FAR struct hostfs_statent_s *ent;
+  clock_t now = clock_systime_ticks();
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_STAT_CACHE; i++)
+    {
+      ent = &g_stat_cache[i];
+      if (ent->gen == g_stat_gen &&
+          (sclock_t)(ent->expire - now) > 0 &&
+          strcmp(ent->path, path) == 0)
+        {
+          if (ent->ret >= 0)
+            {
+              memcpy(buf, &ent->st, sizeof(struct stat));
+            }
+
+          return ent->ret;
+        }
+    }
+
+  ent = &g_stat_cache[g_stat_next];
+  g_stat_next = (g_stat_next + 1) % CONFIG_FS_HOSTFS_STAT_CACHE;
+
+  ent->ret = host_stat(path, buf);
+  if (ent->ret >= 0)
+    {
+      memcpy(&ent->st, buf, sizeof(struct stat));
+    }
+
+  strlcpy(ent->path, path, sizeof(ent->path));
+  ent->expire = now + MSEC2TICK(CONFIG_FS_HOSTFS_STAT_CACHE_MSEC);
+  ent->gen    = g_stat_gen;
+  return ent->ret;
+#else
+  return host_stat(path, buf);
+#endif
+}
+
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+/****************************************************************************
+ * Name: hostfs_buffered
+ *
+ * Description: Return true if the file goes through the buffer, allocating
+ *   the buffer on the first use.  Only regular files are buffered, so that
+ *   pipes and devices of the host behave as before.
+ *
+ ****************************************************************************/
+
+static bool hostfs_buffered(FAR struct hostfs_ofile_s *hf)
+{
+  struct stat st;
+
+  if (hf->buf != NULL || hf->nobuf)
+    {
+      return hf->buf != NULL;
+    }
+
+  if ((hf->oflags & O_DIRECT) != 0 || host_fstat(hf->fd, &st) < 0 ||
+      !S_ISREG(st.st_mode))
+    {
+      hf->nobuf = true;
+      return false;
+    }
+
+  hf->buf = fs_heap_malloc(CONFIG_FS_HOSTFS_BUFFER_SIZE);
+  return hf->buf != NULL;
+}
+
+/****************************************************************************
+ * Name: hostfs_bufflush
+ *
+ * Description: Write the data written behind to the host.
+ *
+ ****************************************************************************/
+
+static int hostfs_bufflush(FAR struct hostfs_ofile_s *hf)
+{
+  size_t done = 0;
+  ssize_t ret;
+
+  if (!hf->dirty)
+    {
+      return OK;
+    }
+
+  while (done < hf->buflen)
+    {
+      ret = host_write(hf->fd, hf->buf + done, hf->buflen - done);
+      if (ret <= 0)
+        {
+          /* The data that could not be written is lost */
+
+          hf->dirty  = false;
+          hf->buflen = 0;
+          return ret < 0 ? ret : -EIO;
+        }
+
+      done += ret;
+    }
+
+  hostfs_stat_invalidate();
+  hf->dirty  = false;
+  hf->buflen = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hostfs_bufsync
+ *
+ * Description: Empty the buffer, so that the position of the host file
+ *   matches the position seen by the caller again.
+ *
+ ****************************************************************************/
+
+static int hostfs_bufsync(FAR struct hostfs_ofile_s *hf)
+{
+  off_t ret = OK;
+
+  if (hf->dirty)
+    {
+      return hostfs_bufflush(hf);
+    }
+
+  if (hf->bufoff < hf->buflen)
+    {
+      /* Give back what was read ahead */
+
+      ret = host_lseek(hf->fd, hf->bufpos + hf->buflen,
+                       hf->bufpos + hf->bufoff, SEEK_SET);
+    }
+
+  hf->buflen = 0;
+  hf->bufoff = 0;
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: hostfs_bufread
+ ****************************************************************************/
+
+static ssize_t hostfs_bufread(FAR struct hostfs_ofile_s *hf, off_t pos,
+                              FAR char *buffer, size_t buflen)
+{
+  size_t done = 0;
+  ssize_t ret;
+  size_t n;
+
+  ret = hostfs_bufflush(hf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (done < buflen)
+    {
+      if (hf->bufoff < hf->buflen)
+        {
+          n = MIN(hf->buflen - hf->bufoff, buflen - done);
+          memcpy(buffer + done, hf->buf + hf->bufoff, n);
+          hf->bufoff += n;
+          done       += n;
+          continue;
+        }
+
+      /* Large transfers go straight to the caller's buffer */
+
+      if (buflen - done >= CONFIG_FS_HOSTFS_BUFFER_SIZE)
+        {
+          ret = host_read(hf->fd, buffer + done, buflen - done);
+        }
+      else
+        {
+          hf->bufpos = pos + done;
+          hf->buflen = 0;
+          hf->bufoff = 0;
+          ret = host_read(hf->fd, hf->buf, CONFIG_FS_HOSTFS_BUFFER_SIZE);
+          if (ret > 0)
+            {
+              hf->buflen = ret;
+              continue;
+            }
+        }
+
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      done += ret;
+    }
+
+  return done > 0 ? done : ret;
+}
+
+/****************************************************************************
+ * Name: hostfs_bufwrite
+ ****************************************************************************/
+
+static ssize_t hostfs_bufwrite(FAR struct hostfs_ofile_s *hf, off_t pos,
+                               FAR const char *buffer, size_t buflen)
+{
+  ssize_t ret;
+
+  if (!hf->dirty || hf->buflen + buflen > CONFIG_FS_HOSTFS_BUFFER_SIZE)
+    {
+      ret = hostfs_bufsync(hf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (buflen >= CONFIG_FS_HOSTFS_BUFFER_SIZE)
+    {
+      ret = host_write(hf->fd, buffer, buflen);
+      if (ret > 0)
+        {
+          hostfs_stat_invalidate();
+        }
+
+      return ret;
+    }
+
+  if (!hf->dirty)
+    {
+      hf->bufpos = pos;
+      hf->dirty  = true;
+    }
+
+  memcpy(hf->buf + hf->buflen, buffer, buflen);
+  hf->buflen += buflen;
+  return buflen;
+}
+#endif
+
 /****************************************************************************
  * Name: hostfs_open
  ****************************************************************************/
@@ -300,6 +586,11 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_buffer;
     }
 
+  if ((oflags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      hostfs_stat_invalidate();
+    }
+
   /* In write/append mode, we need to set the file pointer to the end of the
    * file.
    */
@@ -330,6 +621,13 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
   hf->fnext = fs->fs_head;
   hf->crefs = 1;
   hf->oflags = oflags;
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  hf->buf    = NULL;
+  hf->buflen = 0;
+  hf->bufoff = 0;
+  hf->dirty  = false;
+  hf->nobuf  = false;
+#endif
   memcpy(hf->relpath, relpath, len + 1);
   fs->fs_head = hf;
 
@@ -424,6 +722,13 @@ static int hostfs_close(FAR struct file *filep)
         }
     }
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  /* Write what is still buffered */
+
+  ret = hostfs_bufflush(hf);
+  fs_heap_free(hf->buf);
+#endif
+
   /* Close the host file */
 
   host_close(hf->fd);
@@ -435,7 +740,7 @@ static int hostfs_close(FAR struct file *filep)
 
 okout:
   nxmutex_unlock(&g_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -472,7 +777,17 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Call the host to perform the read */
 
-  ret = host_read(hf->fd, buffer, buflen);
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  if (hostfs_buffered(hf))
+    {
+      ret = hostfs_bufread(hf, filep->f_pos, buffer, buflen);
+    }
+  else
+#endif
+    {
+      ret = host_read(hf->fd, buffer, buflen);
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -524,7 +839,18 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
 
   /* Call the host to perform the write */
 
-  ret = host_write(hf->fd, buffer, buflen);
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  if (hostfs_buffered(hf))
+    {
+      ret = hostfs_bufwrite(hf, filep->f_pos, buffer, buflen);
+    }
+  else
+#endif
+    {
+      ret = host_write(hf->fd, buffer, buflen);
+      hostfs_stat_invalidate();
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -566,6 +892,31 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
       return ret;
     }
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  /* Stay inside of what was read ahead, as ftell() and short skips do */
+
+  if (!hf->dirty && hf->buflen > 0 &&
+      (whence == SEEK_SET || whence == SEEK_CUR))
+    {
+      off_t pos = whence == SEEK_SET ? offset : filep->f_pos + offset;
+
+      if (pos >= hf->bufpos && pos <= hf->bufpos + (off_t)hf->buflen)
+        {
+          hf->bufoff   = pos - hf->bufpos;
+          filep->f_pos = pos;
+          nxmutex_unlock(&g_lock);
+          return pos;
+        }
+    }
+
+  ret = hostfs_bufsync(hf);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
   /* Call our internal routine to perform the seek */
 
   ret = host_lseek(hf->fd, filep->f_pos, offset, whence);
@@ -609,6 +960,15 @@ static int hostfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  ret = hostfs_bufsync(hf);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
   /* Call our internal routine to perform the ioctl */
 
   ret = host_ioctl(hf->fd, cmd, arg);
@@ -671,10 +1031,14 @@ static int hostfs_sync(FAR struct file *filep)
       return ret;
     }
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  ret = hostfs_bufflush(hf);
+#endif
+
   host_sync(hf->fd);
 
   nxmutex_unlock(&g_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -745,6 +1109,17 @@ static int hostfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
       return ret;
     }
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  /* The size has to include what is written behind */
+
+  ret = hostfs_bufflush(hf);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
   /* Call the host to perform the read */
 
   ret = host_fstat(hf->fd, buf);
@@ -791,9 +1166,21 @@ static int hostfs_fchstat(FAR const struct file *filep,
       return ret;
     }
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  /* The times must not be changed again by a later flush */
+
+  ret = hostfs_bufflush(hf);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
   /* Call the host to perform the change */
 
   ret = host_fchstat(hf->fd, buf, flags);
+  hostfs_stat_invalidate();
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -832,9 +1219,19 @@ static int hostfs_ftruncate(FAR struct file *filep, off_t length)
       return ret;
     }
 
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  ret = hostfs_bufsync(hf);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
   /* Call the host to perform the truncate */
 
   ret = host_ftruncate(hf->fd, length);
+  hostfs_stat_invalidate();
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1228,6 +1625,7 @@ static int hostfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host fs to perform the unlink */
 
   ret = host_unlink(path);
+  hostfs_stat_invalidate();
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1268,6 +1666,7 @@ static int hostfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_mkdir(path, mode);
+  hostfs_stat_invalidate();
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1309,6 +1708,7 @@ int hostfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host FS to do the mkdir */
 
   ret = host_rmdir(path);
+  hostfs_stat_invalidate();
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1353,6 +1753,7 @@ int hostfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_rename(oldpath, newpath);
+  hostfs_stat_invalidate();
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1392,7 +1793,7 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the stat operation */
 
-  ret = host_stat(path, buf);
+  ret = hostfs_cached_stat(path, buf);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1433,6 +1834,7 @@ static int hostfs_chstat(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the chstat operation */
 
   ret = host_chstat(path, buf, flags);
+  hostfs_stat_invalidate();
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -53,6 +53,14 @@ struct hostfs_ofile_s
   int16_t                   crefs;   /* Reference count */
   mode_t                    oflags;  /* Open mode */
   int                       fd;
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  FAR char                 *buf;     /* Read ahead or written behind data */
+  off_t                     bufpos;  /* File position of buf[0] */
+  size_t                    buflen;  /* Number of valid bytes in buf */
+  size_t                    bufoff;  /* Next byte to be read from buf */
+  bool                      dirty;   /* buf is yet to be written */
+  bool                      nobuf;   /* Not a regular file, never buffer */
+#endif
   char                      relpath[1];
 };
 
@@ -41,6 +41,8 @@
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/rcu.h>
 #include <nuttx/sched.h>
 #include <nuttx/spawn.h>
 #include <nuttx/spinlock.h>
@@ -54,10 +56,38 @@
 #include "inode/inode.h"
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_FDLIST_RCU
+/* fdlist_get_by_index() reads the descriptor table without the list lock,
+ * so a file may still be looked at by a reader after its last reference
+ * is dropped.  Its memory is freed only once a grace period has elapsed.
+ */
+
+struct file_rcu_s
+{
+  struct file     file;       /* Must be first */
+  struct rcu_head rcu;        /* Defers the release of the memory */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: file_free_rcu
+ ****************************************************************************/
+
+#ifdef CONFIG_FDLIST_RCU
+static void file_free_rcu(FAR struct rcu_head *head)
+{
+  fs_heap_free(container_of(head, struct file_rcu_s, rcu));
+}
+#endif
+
 /****************************************************************************
  * Name: fdlist_get_by_index
  ****************************************************************************/
@@ -68,6 +98,42 @@ static void fdlist_get_by_index(FAR struct fdlist *list,
                                 FAR struct fd **fdp)
 {
   FAR struct fd *fdp1;
+#ifdef CONFIG_FDLIST_RCU
+  int32_t refs;
+
+  rcu_read_lock();
+
+  /* Pairs with the barrier in fdlist_extend(): a row count that covers
+   * the index implies a table that holds it.
+   */
+
+  SMP_RMB();
+  fdp1 = &rcu_dereference(list->fl_fds)[l1][l2];
+
+  for (; ; )
+    {
+      *filep = rcu_dereference(fdp1->f_file);
+      if (*filep == NULL)
+        {
+          break;
+        }
+
+      /* Take a reference unless the last one is already gone, in which
+       * case the descriptor has been closed or replaced meanwhile.
+       */
+
+      refs = atomic_read_acquire(&(*filep)->f_refs);
+      while (refs > 0 &&
+             !atomic_try_cmpxchg(&(*filep)->f_refs, &refs, refs + 1));
+
+      if (refs > 0)
+        {
+          break;
+        }
+    }
+
+  rcu_read_unlock();
+#else
   irqstate_t flags;
 
   flags = spin_lock_irqsave_notrace(&list->fl_lock);
@@ -79,6 +145,8 @@ static void fdlist_get_by_index(FAR struct fdlist *list,
     }
 
   spin_unlock_irqrestore_notrace(&list->fl_lock, flags);
+#endif
+
   if (fdp != NULL)
     {
       *fdp = fdp1;
@@ -162,13 +230,23 @@ static int fdlist_extend(FAR struct fdlist *list, size_t row)
     }
 
   tmp = list->fl_fds;
+#ifdef CONFIG_FDLIST_RCU
+  rcu_assign_pointer(list->fl_fds, fds);
+  SMP_WMB();
+#else
   list->fl_fds = fds;
+#endif
   list->fl_rows = row;
 
   spin_unlock_irqrestore_notrace(&list->fl_lock, flags);
 
   if (tmp != NULL && tmp != &list->fl_prefd)
     {
+#ifdef CONFIG_FDLIST_RCU
+      /* Wait for lock-free readers that may still use the old table */
+
+      synchronize_rcu();
+#endif
       fs_heap_free(tmp);
     }
 
@@ -219,8 +297,12 @@ static void fdlist_install(FAR struct fdlist *list, int fd,
 
   fdp1 = &list->fl_fds[l1][l2];
   filep1 = fdp1->f_file;
-  fdp1->f_file = filep;
   file_ref(filep);
+#ifdef CONFIG_FDLIST_RCU
+  rcu_assign_pointer(fdp1->f_file, filep);
+#else
+  fdp1->f_file = filep;
+#endif
   fdp1->f_cloexec = !!(oflags & O_CLOEXEC);
   FS_ADD_BACKTRACE(fdp1);
   if (copy)
@@ -606,7 +688,11 @@ int fdlist_dupfile(FAR struct fdlist *list, int oflags, int minfd,
           if (fdp->f_file == NULL)
             {
               atomic_fetch_add(&filep->f_refs, 1);
+#ifdef CONFIG_FDLIST_RCU
+              rcu_assign_pointer(fdp->f_file, filep);
+#else
               fdp->f_file        = filep;
+#endif
               fdp->f_cloexec     = !!(oflags & O_CLOEXEC);
  #ifdef CONFIG_FDSAN
               fdp->f_tag_fdsan   = 0;
@@ -664,6 +750,9 @@ int file_allocate_from_inode(FAR struct inode *inode, int oflags, off_t pos,
   filep->f_priv   = priv;
 #if CONFIG_FS_LOCK_BUCKET_SIZE > 0
   filep->f_locked = false;
+#endif
+#ifdef CONFIG_FS_READAHEAD
+  filep->f_ra     = NULL;
 #endif
   fd = file_dup(filep, minfd, oflags);
   if (fd < 0)
@@ -778,7 +867,11 @@ int fdlist_copy(FAR struct fdlist *plist, FAR struct fdlist *clist,
 
 FAR struct file *file_allocate(void)
 {
+#ifdef CONFIG_FDLIST_RCU
+  return fs_heap_zalloc(sizeof(struct file_rcu_s));
+#else
   return fs_heap_zalloc(sizeof(struct file));
+#endif
 }
 
 /****************************************************************************
@@ -791,7 +884,11 @@ FAR struct file *file_allocate(void)
 
 void file_deallocate(FAR struct file *filep)
 {
+#ifdef CONFIG_FDLIST_RCU
+  call_rcu(&((FAR struct file_rcu_s *)filep)->rcu, file_free_rcu);
+#else
   fs_heap_free(filep);
+#endif
 }
 
 /****************************************************************************
@@ -870,7 +967,7 @@ int file_put(FAR struct file *filep)
           ferr("ERROR: fs putfilep file_close() failed: %d\n", ret);
         }
 
-      fs_heap_free(filep);
+      file_deallocate(filep);
     }
 
   return ret;
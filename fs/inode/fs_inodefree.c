@@ -64,6 +64,7 @@ void inode_free(FAR struct inode *inode)
 
       inode_free(inode->i_peer);
       inode_free(inode->i_child);
+      inode_hash_remove(inode);
 
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
       /* If the inode is a symbolic link, the free the path to the linked
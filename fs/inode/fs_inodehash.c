@@ -0,0 +1,181 @@
+/****************************************************************************
+ * fs/inode/fs_inodehash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_PSEUDOFS_HASH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_PSEUDOFS_HASH_SIZE & (CONFIG_PSEUDOFS_HASH_SIZE - 1)) != 0
+#  error CONFIG_PSEUDOFS_HASH_SIZE must be a power of two
+#endif
+
+#define INODE_HASH_MASK (CONFIG_PSEUDOFS_HASH_SIZE - 1)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Every linked inode except the root, keyed by its parent and its name */
+
+static FAR struct inode *g_inode_hash[CONFIG_PSEUDOFS_HASH_SIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_hash_index
+ *
+ * Description:
+ *   Return the bucket of the child 'name' of 'parent'.  'name' ends at the
+ *   first '/' or at the NUL terminator.
+ *
+ ****************************************************************************/
+
+static unsigned int inode_hash_index(FAR struct inode *parent,
+                                     FAR const char *name)
+{
+  uint32_t hash = 2166136261u ^ (uint32_t)(uintptr_t)parent;
+
+  while (*name != '\0' && *name != '/')
+    {
+      hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+
+  return (hash ^ (hash >> 16)) & INODE_HASH_MASK;
+}
+
+/****************************************************************************
+ * Name: inode_hash_match
+ *
+ * Description:
+ *   Return true if the path segment 'name' is the name of 'inode'.
+ *
+ ****************************************************************************/
+
+static bool inode_hash_match(FAR struct inode *inode, FAR const char *name)
+{
+  FAR const char *nname = inode->i_name;
+
+  while (*nname != '\0' && *nname == *name)
+    {
+      nname++;
+      name++;
+    }
+
+  return *nname == '\0' && (*name == '\0' || *name == '/');
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_hash_add
+ *
+ * Description:
+ *   Enter a newly linked inode into the lookup hash.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock for writing
+ *
+ ****************************************************************************/
+
+void inode_hash_add(FAR struct inode *inode)
+{
+  unsigned int index = inode_hash_index(inode->i_parent, inode->i_name);
+
+  inode->i_hash       = g_inode_hash[index];
+  g_inode_hash[index] = inode;
+}
+
+/****************************************************************************
+ * Name: inode_hash_remove
+ *
+ * Description:
+ *   Remove an inode from the lookup hash.  Nothing happens if the inode is
+ *   not in it.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock for writing
+ *
+ ****************************************************************************/
+
+void inode_hash_remove(FAR struct inode *inode)
+{
+  FAR struct inode **pprev;
+
+  pprev = &g_inode_hash[inode_hash_index(inode->i_parent, inode->i_name)];
+  for (; *pprev != NULL; pprev = &(*pprev)->i_hash)
+    {
+      if (*pprev == inode)
+        {
+          *pprev = inode->i_hash;
+          inode->i_hash = NULL;
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: inode_hash_find
+ *
+ * Description:
+ *   Return the child of 'parent' named by the path segment 'name', or NULL
+ *   if there is no such child.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock
+ *
+ ****************************************************************************/
+
+FAR struct inode *inode_hash_find(FAR struct inode *parent,
+                                  FAR const char *name)
+{
+  FAR struct inode *inode = g_inode_hash[inode_hash_index(parent, name)];
+
+  for (; inode != NULL; inode = inode->i_hash)
+    {
+      if (inode->i_parent == parent && inode_hash_match(inode, name))
+        {
+          break;
+        }
+    }
+
+  return inode;
+}
+
+#endif /* CONFIG_PSEUDOFS_HASH */
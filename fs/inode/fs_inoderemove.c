@@ -79,6 +79,22 @@ static FAR struct inode *inode_unlink(FAR const char *path)
       inode = desc.node;
       DEBUGASSERT(inode != NULL);
 
+#ifdef CONFIG_PSEUDOFS_HASH
+      /* A lookup through the hash does not report the node to the left */
+
+      if (desc.parent != NULL)
+        {
+          FAR struct inode *peer;
+
+          desc.peer = NULL;
+          for (peer = desc.parent->i_child; peer != inode;
+               peer = peer->i_peer)
+            {
+              desc.peer = peer;
+            }
+        }
+#endif
+
       /* If peer is non-null, then remove the node from the right of
        * of that peer node.
        */
@@ -105,6 +121,7 @@ static FAR struct inode *inode_unlink(FAR const char *path)
           desc.parent->i_child = inode->i_peer;
         }
 
+      inode_hash_remove(inode);
       inode->i_peer   = NULL;
       inode->i_parent = NULL;
       atomic_fetch_sub(&inode->i_crefs, 1);
@@ -221,6 +221,9 @@ static int _inode_search(FAR struct inode_search_s *desc)
   FAR struct inode *left    = NULL;
   FAR struct inode *above   = NULL;
   FAR const char   *relpath = NULL;
+#ifdef CONFIG_PSEUDOFS_HASH
+  FAR struct inode *child;
+#endif
   int ret = -ENOENT;
 
   /* Get the search path, skipping over the leading '/'.  The leading '/' is
@@ -387,6 +390,19 @@ static int _inode_search(FAR struct inode_search_s *desc)
               above = inode;
               left  = NULL;
               inode = inode->i_child;
+
+#ifdef CONFIG_PSEUDOFS_HASH
+              /* Go straight to the matching child if there is one.  If
+               * not, the walk below the parent still has to find where a
+               * node of that name would be inserted.
+               */
+
+              child = inode_hash_find(above, name);
+              if (child != NULL)
+                {
+                  inode = child;
+                }
+#endif
             }
         }
     }
@@ -404,7 +420,9 @@ static int _inode_search(FAR struct inode_search_s *desc)
    *
    * With node != NULL
    *
-   *   (4) When the node matching the full path is found
+   *   (4) When the node matching the full path is found.  If the node
+   *       was reached through the lookup hash, 'left' may not be the node
+   *       to its left.
    */
 
   desc->path    = name;
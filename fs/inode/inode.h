@@ -126,7 +126,8 @@ struct inode_search_s
 {
   FAR const char *path;      /* Path of inode to find */
   FAR struct inode *node;    /* Pointer to the inode found */
-  FAR struct inode *peer;    /* Node to the "left" for the found inode */
+  FAR struct inode *peer;    /* Node to the "left" for the found inode
+                              * (not valid if found through the hash) */
   FAR struct inode *parent;  /* Node "above" the found inode */
   FAR const char *relpath;   /* Relative path into the mountpoint */
   FAR char *buffer;          /* Path expansion buffer */
@@ -346,6 +347,28 @@ const char *inode_nextname(FAR const char *name);
 
 void inode_root_reserve(void);
 
+/****************************************************************************
+ * Name: inode_hash_add, inode_hash_remove and inode_hash_find
+ *
+ * Description:
+ *   Maintain and query the hash that maps a parent inode and a path
+ *   segment to the child inode of that name.  inode_hash_find() returns
+ *   NULL if the child does not exist.
+ *
+ *   NOTE: Caller must hold the inode semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PSEUDOFS_HASH
+void inode_hash_add(FAR struct inode *inode);
+void inode_hash_remove(FAR struct inode *inode);
+FAR struct inode *inode_hash_find(FAR struct inode *parent,
+                                  FAR const char *name);
+#else
+#  define inode_hash_add(inode)
+#  define inode_hash_remove(inode)
+#endif
+
 /****************************************************************************
  * Name: inode_reserve
  *
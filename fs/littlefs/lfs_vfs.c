@@ -35,6 +35,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/mutex.h>
+#include <nuttx/queue.h>
 
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -52,6 +53,14 @@
 #  error littlefs requires CONFIG_C99_BOOL to be selected
 #endif
 
+#ifndef CONFIG_FS_LITTLEFS_SHARED_CACHE
+#  define CONFIG_FS_LITTLEFS_SHARED_CACHE 0
+#endif
+
+#if CONFIG_FS_LITTLEFS_SHARED_CACHE > 0
+#  define LITTLEFS_NOPAGE UINT32_MAX
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -68,6 +77,18 @@ struct littlefs_file_s
   int                   refs;
 };
 
+#if CONFIG_FS_LITTLEFS_SHARED_CACHE > 0
+/* A device block held in the shared cache */
+
+struct littlefs_page_s
+{
+  dq_entry_t            node;    /* Entry in one of the LRU lists */
+  uint32_t              block;   /* Device block, LITTLEFS_NOPAGE if none */
+  lfs_block_t           lblock;  /* The littlefs block that contains it */
+  bool                  pinned;  /* true: Part of a pinned metadata pair */
+};
+#endif
+
 /* This structure represents the overall mountpoint state. An instance of
  * this structure is retained as inode private data on each mountpoint that
  * is mounted with a littlefs filesystem.
@@ -81,6 +102,20 @@ struct littlefs_mountpt_s
   struct lfs_config     cfg;
   struct lfs            lfs;
   bool                  readonly;
+  lfs_ssize_t           used;      /* Blocks in use, negative if unknown */
+#if CONFIG_FS_LITTLEFS_SHARED_CACHE > 0
+  FAR uint8_t          *cache;     /* The page buffers */
+  dq_queue_t            lru;       /* Unpinned pages, most recent first */
+  dq_queue_t            pinlru;    /* Pinned pages, most recent first */
+  unsigned int          nextpair;  /* Next entry of pairs to replace */
+  lfs_block_t           pairs[CONFIG_FS_LITTLEFS_PINNED_PAIRS][2];
+  struct littlefs_page_s pages[CONFIG_FS_LITTLEFS_SHARED_CACHE];
+#endif
+#ifdef CONFIG_MTD_ASYNC
+  struct mtd_request_s  erase;     /* The posted erase */
+  volatile bool         erasing;   /* 'erase' is owned by the MTD */
+  int                   eraseret;  /* Error of a posted erase, if any */
+#endif
 };
 
 /* NuttX specific file attributes.
@@ -162,6 +197,10 @@ static int     littlefs_chstat(FAR struct inode *mountpt,
                                FAR const char *relpath,
                                FAR const struct stat *buf, int flags);
 #endif
+#if CONFIG_FS_LITTLEFS_SHARED_CACHE > 0
+static void    littlefs_cache_pin(FAR struct littlefs_mountpt_s *fs,
+                                  FAR const lfs_block_t *pair);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -394,6 +433,12 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout;
     }
 
+#if CONFIG_FS_LITTLEFS_SHARED_CACHE > 0
+  /* Keep the metadata pair of the file in the cache */
+
+  littlefs_cache_pin(fs, priv->file.m.pair);
+#endif
+
 #ifdef CONFIG_FS_LITTLEFS_ATTR_UPDATE
   if (oflags & LFS_O_CREAT)
     {
@@ -1023,6 +1068,10 @@ static int littlefs_opendir(FAR struct inode *mountpt,
       goto errout;
     }
 
+#if CONFIG_FS_LITTLEFS_SHARED_CACHE > 0
+  littlefs_cache_pin(fs, ldir->dir.m.pair);
+#endif
+
   nxmutex_unlock(&fs->lock);
   *dir = &ldir->base;
   return OK;
@@ -1153,6 +1202,271 @@ static int littlefs_rewinddir(FAR struct inode *mountpt,
   return ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_bread
+ *
+ * Description:
+ *   Read 'nblocks' device blocks starting with 'block' from the driver.
+ *
+ ****************************************************************************/
+
+static int littlefs_bread(FAR struct littlefs_mountpt_s *fs, uint32_t block,
+                          size_t nblocks, FAR void *buffer)
+{
+  FAR struct inode *drv = fs->drv;
+  int ret;
+
+  if (INODE_IS_MTD(drv))
+    {
+      ret = MTD_BREAD(drv->u.i_mtd, block, nblocks, buffer);
+    }
+  else
+    {
+      ret = drv->u.i_bops->read(drv, buffer, block, nblocks);
+    }
+
+  return ret >= 0 ? OK : ret;
+}
+
+/****************************************************************************
+ * Name: littlefs_cache_find
+ *
+ * Description:
+ *   Return the page of the shared cache that holds device block 'block',
+ *   or NULL if it is not cached.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_LITTLEFS_SHARED_CACHE > 0
+static FAR struct littlefs_page_s *
+littlefs_cache_find(FAR struct littlefs_mountpt_s *fs, uint32_t block)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_LITTLEFS_SHARED_CACHE; i++)
+    {
+      if (fs->pages[i].block == block)
+        {
+          return &fs->pages[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: littlefs_cache_buffer
+ ****************************************************************************/
+
+static FAR uint8_t *littlefs_cache_buffer(FAR struct littlefs_mountpt_s *fs,
+                                          FAR struct littlefs_page_s *page)
+{
+  return fs->cache + (page - fs->pages) * fs->geo.blocksize;
+}
+
+/****************************************************************************
+ * Name: littlefs_cache_ispinned
+ *
+ * Description:
+ *   Check if littlefs block 'lblock' belongs to a pinned metadata pair.
+ *
+ ****************************************************************************/
+
+static bool littlefs_cache_ispinned(FAR struct littlefs_mountpt_s *fs,
+                                    lfs_block_t lblock)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_LITTLEFS_PINNED_PAIRS; i++)
+    {
+      if (fs->pairs[i][0] == lblock || fs->pairs[i][1] == lblock)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: littlefs_cache_touch
+ *
+ * Description:
+ *   Make 'page' the most recently used page of its list.
+ *
+ ****************************************************************************/
+
+static void littlefs_cache_touch(FAR struct littlefs_mountpt_s *fs,
+                                 FAR struct littlefs_page_s *page)
+{
+  dq_rem(&page->node, page->pinned ? &fs->pinlru : &fs->lru);
+  dq_addfirst(&page->node, page->pinned ? &fs->pinlru : &fs->lru);
+}
+
+/****************************************************************************
+ * Name: littlefs_cache_setpin
+ *
+ * Description:
+ *   Move a page between the unpinned and the pinned list.
+ *
+ ****************************************************************************/
+
+static void littlefs_cache_setpin(FAR struct littlefs_mountpt_s *fs,
+                                  FAR struct littlefs_page_s *page,
+                                  bool pinned)
+{
+  if (page->pinned != pinned)
+    {
+      dq_rem(&page->node, page->pinned ? &fs->pinlru : &fs->lru);
+      page->pinned = pinned;
+      dq_addfirst(&page->node, pinned ? &fs->pinlru : &fs->lru);
+    }
+}
+
+/****************************************************************************
+ * Name: littlefs_cache_insert
+ *
+ * Description:
+ *   Copy device block 'block' of littlefs block 'lblock' into the cache,
+ *   recycling the least recently used unpinned page, or the least recently
+ *   used pinned page if all pages are pinned.
+ *
+ ****************************************************************************/
+
+static void littlefs_cache_insert(FAR struct littlefs_mountpt_s *fs,
+                                  uint32_t block, lfs_block_t lblock,
+                                  FAR const void *data)
+{
+  FAR struct littlefs_page_s *page;
+
+  page = (FAR struct littlefs_page_s *)dq_tail(&fs->lru);
+  if (page == NULL)
+    {
+      page = (FAR struct littlefs_page_s *)dq_tail(&fs->pinlru);
+    }
+
+  page->block  = block;
+  page->lblock = lblock;
+  memcpy(littlefs_cache_buffer(fs, page), data, fs->geo.blocksize);
+
+  littlefs_cache_setpin(fs, page, littlefs_cache_ispinned(fs, lblock));
+  littlefs_cache_touch(fs, page);
+}
+
+/****************************************************************************
+ * Name: littlefs_cache_drop
+ *
+ * Description:
+ *   Drop the device blocks 'block' through 'block' + 'nblocks' - 1 from
+ *   the cache.
+ *
+ ****************************************************************************/
+
+static void littlefs_cache_drop(FAR struct littlefs_mountpt_s *fs,
+                                uint32_t block, size_t nblocks)
+{
+  FAR struct littlefs_page_s *page;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_LITTLEFS_SHARED_CACHE; i++)
+    {
+      page = &fs->pages[i];
+      if (page->block != LITTLEFS_NOPAGE && page->block - block < nblocks)
+        {
+          /* Recycle it first */
+
+          page->block = LITTLEFS_NOPAGE;
+          littlefs_cache_setpin(fs, page, false);
+          dq_rem(&page->node, &fs->lru);
+          dq_addlast(&page->node, &fs->lru);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: littlefs_cache_pin
+ *
+ * Description:
+ *   Pin the pages of a metadata pair that was just used to open a file or
+ *   a directory.  The pair that it replaces is unpinned.  The root pair in
+ *   the first entry is never replaced.
+ *
+ ****************************************************************************/
+
+static void littlefs_cache_pin(FAR struct littlefs_mountpt_s *fs,
+                               FAR const lfs_block_t *pair)
+{
+  FAR struct littlefs_page_s *page;
+  FAR lfs_block_t *entry;
+  int i;
+
+  if (littlefs_cache_ispinned(fs, pair[0]))
+    {
+      return;
+    }
+
+  if (CONFIG_FS_LITTLEFS_PINNED_PAIRS < 2)
+    {
+      return;
+    }
+
+  if (fs->nextpair == 0 ||
+      fs->nextpair >= CONFIG_FS_LITTLEFS_PINNED_PAIRS)
+    {
+      fs->nextpair = 1;
+    }
+
+  entry    = fs->pairs[fs->nextpair++];
+  entry[0] = pair[0];
+  entry[1] = pair[1];
+
+  for (i = 0; i < CONFIG_FS_LITTLEFS_SHARED_CACHE; i++)
+    {
+      page = &fs->pages[i];
+      if (page->block != LITTLEFS_NOPAGE)
+        {
+          littlefs_cache_setpin(fs, page,
+                                littlefs_cache_ispinned(fs, page->lblock));
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: littlefs_cache_initialize
+ ****************************************************************************/
+
+static int littlefs_cache_initialize(FAR struct littlefs_mountpt_s *fs)
+{
+  int i;
+
+  fs->cache = fs_heap_malloc(CONFIG_FS_LITTLEFS_SHARED_CACHE *
+                             fs->geo.blocksize);
+  if (fs->cache == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  dq_init(&fs->lru);
+  dq_init(&fs->pinlru);
+
+  for (i = 0; i < CONFIG_FS_LITTLEFS_SHARED_CACHE; i++)
+    {
+      fs->pages[i].block = LITTLEFS_NOPAGE;
+      dq_addlast(&fs->pages[i].node, &fs->lru);
+    }
+
+  /* The superblock and the root directory live in blocks 0 and 1 */
+
+  for (i = 0; i < CONFIG_FS_LITTLEFS_PINNED_PAIRS; i++)
+    {
+      fs->pairs[i][0] = i == 0 ? 0 : (lfs_block_t)-1;
+      fs->pairs[i][1] = i == 0 ? 1 : (lfs_block_t)-1;
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: littlefs_read_block
  ****************************************************************************/
@@ -1163,22 +1477,60 @@ static int littlefs_read_block(FAR const struct lfs_config *c,
 {
   FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct mtd_geometry_s *geo = &fs->geo;
-  FAR struct inode *drv = fs->drv;
+#if CONFIG_FS_LITTLEFS_SHARED_CACHE > 0
+  FAR struct littlefs_page_s *page;
+  FAR uint8_t *dest = buffer;
+  lfs_block_t lblock = block;
+  size_t nmiss;
+  size_t i;
+  size_t j;
   int ret;
+#endif
 
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
-  if (INODE_IS_MTD(drv))
+#if CONFIG_FS_LITTLEFS_SHARED_CACHE > 0
+  for (i = 0; i < size; i += nmiss)
     {
-      ret = MTD_BREAD(drv->u.i_mtd, block, size, buffer);
-    }
-  else
-    {
-      ret = drv->u.i_bops->read(drv, buffer, block, size);
+      page = littlefs_cache_find(fs, block + i);
+      if (page != NULL)
+        {
+          memcpy(dest + i * geo->blocksize,
+                 littlefs_cache_buffer(fs, page), geo->blocksize);
+          littlefs_cache_touch(fs, page);
+          nmiss = 1;
+          continue;
+        }
+
+      /* Read the run of missing blocks at once, then cache them */
+
+      for (nmiss = 1; i + nmiss < size; nmiss++)
+        {
+          if (littlefs_cache_find(fs, block + i + nmiss) != NULL)
+            {
+              break;
+            }
+        }
+
+      ret = littlefs_bread(fs, block + i, nmiss,
+                           dest + i * geo->blocksize);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      for (j = 0; j < nmiss; j++)
+        {
+          littlefs_cache_insert(fs, block + i + j, lblock,
+                                dest + (i + j) * geo->blocksize);
+        }
     }
 
-  return ret >= 0 ? OK : ret;
+  return OK;
+#else
+  return littlefs_bread(fs, block, size, buffer);
+#endif
 }
 
 /****************************************************************************
@@ -1202,6 +1554,10 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
+  /* The blocks in use have to be counted again */
+
+  fs->used = -1;
+
   if (INODE_IS_MTD(drv))
     {
       ret = MTD_BWRITE(drv->u.i_mtd, block, size, buffer);
@@ -1211,9 +1567,76 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
       ret = drv->u.i_bops->write(drv, buffer, block, size);
     }
 
+#if CONFIG_FS_LITTLEFS_SHARED_CACHE > 0
+  /* Keep the cached copies in step with the media */
+
+  if (ret >= 0)
+    {
+      FAR struct littlefs_page_s *page;
+      lfs_size_t i;
+
+      for (i = 0; i < size; i++)
+        {
+          page = littlefs_cache_find(fs, block + i);
+          if (page != NULL)
+            {
+              memcpy(littlefs_cache_buffer(fs, page),
+                     (FAR const uint8_t *)buffer + i * geo->blocksize,
+                     geo->blocksize);
+            }
+        }
+    }
+  else
+    {
+      littlefs_cache_drop(fs, block, size);
+    }
+#endif
+
+  ret = littlefs_erase_status(fs, ret);
   return ret >= 0 ? OK : ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_erase_done
+ *
+ * Description:
+ *   Completion of a posted erase, from the MTD worker.  The next program
+ *   or sync waits for it anyway, so its error is reported there.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_ASYNC
+static void littlefs_erase_done(FAR struct mtd_request_s *req)
+{
+  FAR struct littlefs_mountpt_s *fs = req->arg;
+
+  if (req->result < 0)
+    {
+      fs->eraseret = req->result;
+    }
+
+  fs->erasing = false;
+}
+
+/****************************************************************************
+ * Name: littlefs_erase_status
+ ****************************************************************************/
+
+static int littlefs_erase_status(FAR struct littlefs_mountpt_s *fs,
+                                 int ret)
+{
+  if (ret >= 0 && fs->eraseret < 0)
+    {
+      ret = fs->eraseret;
+    }
+
+  fs->eraseret = 0;
+  return ret;
+}
+#else
+#  define littlefs_erase_status(fs, ret) (ret)
+#endif
+
 /****************************************************************************
  * Name: littlefs_erase_block
  ****************************************************************************/
@@ -1230,12 +1653,42 @@ static int littlefs_erase_block(FAR const struct lfs_config *c,
       return -EROFS;
     }
 
+  fs->used = -1;
+
+#if CONFIG_FS_LITTLEFS_SHARED_CACHE > 0
+  littlefs_cache_drop(fs, block * c->block_size / fs->geo.blocksize,
+                      c->block_size / fs->geo.blocksize);
+#endif
+
   if (INODE_IS_MTD(drv))
     {
       FAR struct mtd_geometry_s *geo = &fs->geo;
       size_t size = c->block_size / geo->erasesize;
 
       block = block * c->block_size / geo->erasesize;
+
+#ifdef CONFIG_MTD_ASYNC
+      /* Post the erase, littlefs computes what to program meanwhile */
+
+      if (!fs->erasing)
+        {
+          fs->erase.op    = MTD_REQ_ERASE;
+          fs->erase.block = block;
+          fs->erase.count = size;
+          fs->erase.done  = littlefs_erase_done;
+          fs->erase.arg   = fs;
+          fs->erasing     = true;
+
+          if (MTD_IOCTL(drv->u.i_mtd, MTDIOC_SUBMIT,
+                        (unsigned long)(uintptr_t)&fs->erase) >= 0)
+            {
+              return OK;
+            }
+
+          fs->erasing = false;
+        }
+#endif
+
       ret = MTD_ERASE(drv->u.i_mtd, block, size);
     }
 
@@ -1273,7 +1726,7 @@ static int littlefs_sync_block(FAR const struct lfs_config *c)
         }
     }
 
-  return ret == -ENOTTY ? OK : ret;
+  return littlefs_erase_status(fs, ret == -ENOTTY ? OK : ret);
 }
 
 /****************************************************************************
@@ -1318,7 +1771,8 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
    * have to addref() here (but does have to release in unbind().
    */
 
-  fs->drv = driver;        /* Save the driver reference */
+  fs->drv  = driver;       /* Save the driver reference */
+  fs->used = -1;           /* The blocks in use are not counted yet */
   nxmutex_init(&fs->lock); /* Initialize the access control mutex */
 
   if (INODE_IS_MTD(driver))
@@ -1365,6 +1819,14 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
       goto errout_with_fs;
     }
 
+#if CONFIG_FS_LITTLEFS_SHARED_CACHE > 0
+  ret = littlefs_cache_initialize(fs);
+  if (ret < 0)
+    {
+      goto errout_with_fs;
+    }
+#endif
+
   /* Initialize lfs_config structure */
 
   fs->cfg.context        = fs;
@@ -1444,6 +1906,9 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   return OK;
 
 errout_with_fs:
+#if CONFIG_FS_LITTLEFS_SHARED_CACHE > 0
+  fs_heap_free(fs->cache);
+#endif
   nxmutex_destroy(&fs->lock);
   fs_heap_free(fs);
 errout_with_block:
@@ -1479,6 +1944,16 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
     }
 
   ret = littlefs_convert_result(lfs_unmount(&fs->lfs));
+
+#ifdef CONFIG_MTD_ASYNC
+  /* Wait for a posted erase, it refers to 'fs' */
+
+  if (ret >= 0 && fs->erasing)
+    {
+      MTD_IOCTL(drv->u.i_mtd, BIOC_FLUSH, 0);
+    }
+#endif
+
   nxmutex_unlock(&fs->lock);
 
   if (ret >= 0)
@@ -1503,6 +1978,9 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
 
       /* Release the mountpoint private data */
 
+#if CONFIG_FS_LITTLEFS_SHARED_CACHE > 0
+      fs_heap_free(fs->cache);
+#endif
       nxmutex_destroy(&fs->lock);
       fs_heap_free(fs);
     }
@@ -1541,7 +2019,16 @@ static int littlefs_statfs(FAR struct inode *mountpt, FAR struct statfs *buf)
       return ret;
     }
 
-  ret = littlefs_convert_result(lfs_fs_size(&fs->lfs));
+  /* Traverse the file system only if something was written since the
+   * last time.
+   */
+
+  if (fs->used < 0)
+    {
+      fs->used = lfs_fs_size(&fs->lfs);
+    }
+
+  ret = littlefs_convert_result(fs->used);
   if (ret > 0)
     {
       /* Clamp to prevent underflow - lfs_fs_size can return more than
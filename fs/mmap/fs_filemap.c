@@ -0,0 +1,870 @@
+/****************************************************************************
+ * fs/mmap/fs_filemap.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* A file mapping only reserves virtual address space when it is created.
+ * The first access to a page raises a page fault.  The fault handler
+ * cannot perform I/O, so it queues the page on the mapping, puts the
+ * faulting task to sleep and lets the low priority work queue read the
+ * page from the file into a freshly allocated physical page.  When the
+ * task is woken it retries the access, finds the page resident and maps
+ * it into its address environment.
+ *
+ * Every task that faults on a page while it is being read sleeps with
+ * waitobj pointing at the page and is woken when the read completes.  A
+ * fault also queues up to CONFIG_FS_FILEMAP_READAHEAD following pages,
+ * and the worker reads a run of consecutive queued pages into contiguous
+ * physical pages with a single read, so that sequential access faults
+ * once per run rather than once per page.
+ *
+ * Shared writable mappings map clean pages read-only.  The first store to
+ * such a page faults again, marks the page dirty and makes it writable,
+ * so that msync() and munmap() only have to write back dirty pages.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/mman.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/addrenv.h>
+#include <nuttx/arch.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/pgalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+#include "fs_filemap.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_FS_FILEMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Page flags */
+
+#define FILEMAP_PAGE_FILLING  (1 << 0) /* Queued for the fill worker */
+#define FILEMAP_PAGE_MAPPED   (1 << 1) /* Present in the address environment */
+#define FILEMAP_PAGE_DIRTY    (1 << 2) /* Written since the last write-back */
+#define FILEMAP_PAGE_ERROR    (1 << 3) /* The page could not be read */
+#define FILEMAP_PAGE_WANTED   (1 << 4) /* A task faulted on the page */
+
+/* Longest run of pages read with one request */
+
+#define FILEMAP_MAXRUN        (CONFIG_FS_FILEMAP_READAHEAD + 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct filemap_page_s
+{
+  sq_entry_t node;                   /* Entry in the list of pages to fill */
+  uintptr_t  paddr;                  /* Physical page, 0 if not resident */
+  uint8_t    flags;                  /* See FILEMAP_PAGE_* */
+};
+
+struct filemap_s
+{
+  dq_entry_t               node;     /* Entry in g_filemap_list */
+  FAR struct task_group_s *group;    /* The group that owns the mapping */
+  FAR struct file         *filep;    /* The backing file */
+  uintptr_t                vaddr;    /* Start of the mapping */
+  off_t                    offset;   /* File offset of the first page */
+  size_t                   length;   /* Length of the mapping in bytes */
+  unsigned int             npages;   /* Number of pages still mapped */
+  int                      prot;     /* PROT_* of the mapping */
+  int                      flags;    /* MAP_* of the mapping */
+  int                      crefs;    /* The mapping plus a queued worker */
+  sq_queue_t               fills;    /* Pages waiting to be read */
+  struct work_s            work;     /* Runs filemap_worker() */
+  struct filemap_page_s    pages[1]; /* Actually npages entries */
+};
+
+#define SIZEOF_FILEMAP_S(n) \
+  (sizeof(struct filemap_s) + ((n) - 1) * sizeof(struct filemap_page_s))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The fault handler looks mappings up in interrupt context, so they are
+ * kept in a list of their own rather than being found through the mm_map
+ * list and its mutex.  The spinlock also protects the page states.
+ */
+
+static dq_queue_t g_filemap_list;
+static spinlock_t g_filemap_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: filemap_release
+ *
+ * Description:
+ *   Drop a reference to the mapping and free it with the last one.
+ *
+ ****************************************************************************/
+
+static void filemap_release(FAR struct filemap_s *map)
+{
+  irqstate_t flags;
+  int crefs;
+
+  flags = spin_lock_irqsave(&g_filemap_lock);
+  crefs = --map->crefs;
+  spin_unlock_irqrestore(&g_filemap_lock, flags);
+
+  if (crefs == 0)
+    {
+      file_put(map->filep);
+      kmm_free(map);
+    }
+}
+
+/****************************************************************************
+ * Name: filemap_sleep
+ *
+ * Description:
+ *   Block the faulting task from the page fault handler until the page it
+ *   faulted on has been read.  It then returns to the faulting instruction
+ *   and retries it.
+ *
+ * Assumptions:
+ *   Called within a critical section, which is also held by
+ *   filemap_wakeup(), so the wakeup cannot be missed.
+ *
+ ****************************************************************************/
+
+static void filemap_sleep(FAR struct filemap_page_s *page)
+{
+  FAR struct tcb_s *rtcb = this_task();
+
+  DEBUGASSERT(!is_idle_task(rtcb));
+
+  nxsched_remove_self(rtcb);
+
+  rtcb->waitobj    = page;
+  rtcb->task_state = TSTATE_SLEEPING;
+  dq_addlast((FAR dq_entry_t *)rtcb, list_waitingforsignal());
+
+  up_switch_context(this_task(), rtcb);
+}
+
+/****************************************************************************
+ * Name: filemap_wakeup
+ *
+ * Description:
+ *   Wake all tasks sleeping on one of the pages in [first, last].
+ *
+ ****************************************************************************/
+
+static void filemap_wakeup(FAR struct filemap_page_s *first,
+                           FAR struct filemap_page_s *last)
+{
+  FAR struct tcb_s *tcb;
+  FAR struct tcb_s *next;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  for (tcb = (FAR struct tcb_s *)dq_peek(list_waitingforsignal());
+       tcb != NULL; tcb = next)
+    {
+      next = tcb->flink;
+      if (tcb->task_state == TSTATE_SLEEPING &&
+          (FAR struct filemap_page_s *)tcb->waitobj >= first &&
+          (FAR struct filemap_page_s *)tcb->waitobj <= last)
+        {
+          tcb->waitobj = NULL;
+          nxsched_wakeup(tcb);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: filemap_pagesize
+ *
+ * Description:
+ *   Return the number of bytes of the mapping that lie in page "index".
+ *
+ ****************************************************************************/
+
+static size_t filemap_pagesize(FAR struct filemap_s *map,
+                               unsigned int index)
+{
+  size_t offset = (size_t)index << MM_PGSHIFT;
+
+  return map->length - offset < MM_PGSIZE ? map->length - offset :
+                                            MM_PGSIZE;
+}
+
+/****************************************************************************
+ * Name: filemap_read
+ *
+ * Description:
+ *   Read "count" pages of the mapping starting with page "index" into the
+ *   physically contiguous pages at "paddr".
+ *
+ ****************************************************************************/
+
+static ssize_t filemap_read(FAR struct filemap_s *map, unsigned int index,
+                            unsigned int count, uintptr_t paddr)
+{
+  FAR uint8_t *kaddr = (FAR uint8_t *)up_addrenv_page_vaddr(paddr);
+  size_t offset = (size_t)index << MM_PGSHIFT;
+  size_t size = (size_t)count << MM_PGSHIFT;
+  ssize_t nread;
+
+  if (size > map->length - offset)
+    {
+      size = map->length - offset;
+    }
+
+  do
+    {
+      nread = file_pread(map->filep, kaddr, size, map->offset + offset);
+    }
+  while (nread == -EINTR);
+
+  if (nread >= 0)
+    {
+      /* Whatever lies beyond the end of the file reads as zero */
+
+      memset(kaddr + nread, 0, ((size_t)count << MM_PGSHIFT) - nread);
+    }
+  else
+    {
+      ferr("ERROR: Fill of pages %u-%u failed: %zd\n",
+           index, index + count - 1, nread);
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: filemap_complete
+ *
+ * Description:
+ *   Install the result of reading "count" pages starting with "pages[0]"
+ *   into "paddr" (0 if the read failed) and wake the waiting tasks.
+ *
+ ****************************************************************************/
+
+static void filemap_complete(FAR struct filemap_s *map,
+                             FAR struct filemap_page_s **pages,
+                             unsigned int count, uintptr_t paddr)
+{
+  FAR struct filemap_page_s *page;
+  irqstate_t flags;
+  unsigned int npages;
+  unsigned int index;
+  unsigned int i;
+
+  flags  = spin_lock_irqsave(&g_filemap_lock);
+  npages = map->npages;
+
+  for (i = 0; i < count; i++)
+    {
+      page  = pages[i];
+      index = page - map->pages;
+
+      /* Pages that were unmapped while they were read are freed below */
+
+      if (index < npages)
+        {
+          page->flags &= ~FILEMAP_PAGE_FILLING;
+          if (paddr != 0)
+            {
+              page->paddr = paddr + ((uintptr_t)i << MM_PGSHIFT);
+            }
+          else if ((page->flags & FILEMAP_PAGE_WANTED) != 0)
+            {
+              /* Only report errors for pages that were asked for, a page
+               * that was read ahead is simply tried again when needed.
+               */
+
+              page->flags |= FILEMAP_PAGE_ERROR;
+            }
+        }
+    }
+
+  spin_unlock_irqrestore(&g_filemap_lock, flags);
+
+  if (paddr != 0)
+    {
+      for (i = 0; i < count; i++)
+        {
+          if ((unsigned int)(pages[i] - map->pages) >= npages)
+            {
+              mm_pgfree(paddr + ((uintptr_t)i << MM_PGSHIFT), 1);
+            }
+        }
+    }
+
+  filemap_wakeup(pages[0], pages[count - 1]);
+}
+
+/****************************************************************************
+ * Name: filemap_worker
+ *
+ * Description:
+ *   Read the queued pages from the file and wake the tasks waiting for
+ *   them.  Runs of consecutive pages are read with a single request into
+ *   contiguous physical pages when such pages are available.
+ *
+ ****************************************************************************/
+
+static void filemap_worker(FAR void *arg)
+{
+  FAR struct filemap_page_s *pages[FILEMAP_MAXRUN];
+  FAR struct filemap_s *map = arg;
+  FAR struct filemap_page_s *next;
+  irqstate_t flags;
+  unsigned int index;
+  unsigned int count;
+  unsigned int i;
+  uintptr_t paddr;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&g_filemap_lock);
+
+      pages[0] = (FAR struct filemap_page_s *)sq_remfirst(&map->fills);
+      if (pages[0] == NULL)
+        {
+          spin_unlock_irqrestore(&g_filemap_lock, flags);
+          break;
+        }
+
+      index = pages[0] - map->pages;
+      count = 1;
+
+      while (count < FILEMAP_MAXRUN &&
+             (next = (FAR struct filemap_page_s *)
+                     sq_peek(&map->fills)) != NULL &&
+             (unsigned int)(next - map->pages) == index + count)
+        {
+          pages[count++] = next;
+          sq_remfirst(&map->fills);
+        }
+
+      spin_unlock_irqrestore(&g_filemap_lock, flags);
+
+      paddr = mm_pgalloc(count);
+      if (paddr != 0)
+        {
+          if (filemap_read(map, index, count, paddr) < 0)
+            {
+              mm_pgfree(paddr, count);
+              paddr = 0;
+            }
+
+          filemap_complete(map, pages, count, paddr);
+          continue;
+        }
+
+      /* No contiguous run of physical pages, read one page at a time */
+
+      for (i = 0; i < count; i++)
+        {
+          paddr = mm_pgalloc(1);
+          if (paddr != 0 && filemap_read(map, index + i, 1, paddr) < 0)
+            {
+              mm_pgfree(paddr, 1);
+              paddr = 0;
+            }
+
+          filemap_complete(map, &pages[i], 1, paddr);
+        }
+    }
+
+  filemap_release(map);
+}
+
+/****************************************************************************
+ * Name: filemap_writeback
+ *
+ * Description:
+ *   Write the dirty pages in [first, last) back to the file.  If "remap"
+ *   is true, the pages are made read-only again first so that a later
+ *   store marks them dirty once more.
+ *
+ ****************************************************************************/
+
+static int filemap_writeback(FAR struct filemap_s *map, unsigned int first,
+                             unsigned int last, bool remap)
+{
+  FAR struct filemap_page_s *page;
+  FAR struct tcb_s *tcb = this_task();
+  struct stat buf;
+  irqstate_t flags;
+  unsigned int index;
+  uintptr_t paddr;
+  ssize_t nwrite;
+  off_t offset;
+  off_t fsize;
+  size_t size;
+  int ret = OK;
+
+  if ((map->flags & MAP_SHARED) == 0 || (map->prot & PROT_WRITE) == 0)
+    {
+      return OK;
+    }
+
+  /* Never grow the file: stores beyond its end are dropped, as they are
+   * for a regular mapped file.
+   */
+
+  fsize = file_fstat(map->filep, &buf) >= 0 ? buf.st_size : 0;
+
+  for (index = first; index < last; index++)
+    {
+      page = &map->pages[index];
+
+      flags = spin_lock_irqsave(&g_filemap_lock);
+      if ((page->flags & FILEMAP_PAGE_DIRTY) == 0)
+        {
+          spin_unlock_irqrestore(&g_filemap_lock, flags);
+          continue;
+        }
+
+      page->flags &= ~FILEMAP_PAGE_DIRTY;
+      paddr = page->paddr;
+
+      if (remap && (page->flags & FILEMAP_PAGE_MAPPED) != 0)
+        {
+          up_addrenv_mprot(&tcb->addrenv_own->addrenv,
+                           map->vaddr + ((uintptr_t)index << MM_PGSHIFT),
+                           MM_PGSIZE, map->prot & ~PROT_WRITE);
+        }
+
+      spin_unlock_irqrestore(&g_filemap_lock, flags);
+
+      offset = map->offset + ((off_t)index << MM_PGSHIFT);
+      if (offset >= fsize)
+        {
+          continue;
+        }
+
+      size = filemap_pagesize(map, index);
+      if (size > fsize - offset)
+        {
+          size = fsize - offset;
+        }
+
+      do
+        {
+          nwrite = file_pwrite(map->filep,
+                               (FAR void *)up_addrenv_page_vaddr(paddr),
+                               size, offset);
+        }
+      while (nwrite == -EINTR);
+
+      if (nwrite < 0)
+        {
+          ferr("ERROR: Write-back of page %u failed: %zd\n", index, nwrite);
+
+          /* Keep the page dirty so that a later msync() retries it */
+
+          flags = spin_lock_irqsave(&g_filemap_lock);
+          page->flags |= FILEMAP_PAGE_DIRTY;
+          spin_unlock_irqrestore(&g_filemap_lock, flags);
+          ret = nwrite;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: msync_filemap
+ ****************************************************************************/
+
+static int msync_filemap(FAR struct mm_map_entry_s *entry, FAR void *start,
+                         size_t length, int flags)
+{
+  FAR struct filemap_s *map = entry->priv.p;
+  uintptr_t first;
+  uintptr_t last;
+
+  UNUSED(flags);
+
+  first = MM_PGALIGNDOWN(start) - map->vaddr;
+  last  = MM_PGALIGNUP((uintptr_t)start + length) - map->vaddr;
+
+  return filemap_writeback(map, first >> MM_PGSHIFT,
+                           MIN(last >> MM_PGSHIFT, map->npages), true);
+}
+
+/****************************************************************************
+ * Name: unmap_filemap
+ ****************************************************************************/
+
+static int unmap_filemap(FAR struct task_group_s *group,
+                         FAR struct mm_map_entry_s *entry,
+                         FAR void *start, size_t length)
+{
+  FAR struct filemap_s *map = entry->priv.p;
+  FAR struct filemap_page_s *page;
+  irqstate_t flags;
+  unsigned int first;
+  unsigned int last;
+  unsigned int index;
+  uintptr_t paddr;
+  uintptr_t offset;
+  int ret = OK;
+
+  /* As with rammap(), only the tail of a mapping can be unmapped */
+
+  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+  if (offset + length < entry->length)
+    {
+      ferr("ERROR: Cannot umap without unmapping to the end\n");
+      return -ENOSYS;
+    }
+
+  first = MM_NPAGES(offset);
+  last  = map->npages;
+
+  /* Dirty pages are lost once they are freed, so write them back first */
+
+  filemap_writeback(map, first, last, false);
+
+  flags = spin_lock_irqsave(&g_filemap_lock);
+
+  /* No fault can reach the pages beyond npages any more.  Pages that are
+   * still being filled are released by the worker.
+   */
+
+  map->npages = first;
+  if (first == 0)
+    {
+      dq_rem(&map->node, &g_filemap_list);
+    }
+
+  spin_unlock_irqrestore(&g_filemap_lock, flags);
+
+  for (index = first; index < last; index++)
+    {
+      page  = &map->pages[index];
+      paddr = page->paddr;
+
+      if (group != NULL && (page->flags & FILEMAP_PAGE_MAPPED) != 0)
+        {
+          up_shmdt(map->vaddr + ((uintptr_t)index << MM_PGSHIFT), 1);
+        }
+
+      if (paddr != 0)
+        {
+          mm_pgfree(paddr, 1);
+        }
+
+      page->paddr = 0;
+      page->flags = 0;
+    }
+
+  if (group != NULL)
+    {
+      vm_release_region(get_group_mm(group),
+                        (FAR void *)(map->vaddr +
+                                     ((uintptr_t)first << MM_PGSHIFT)),
+                        (size_t)(last - first) << MM_PGSHIFT);
+    }
+
+  if (first == 0)
+    {
+      ret = mm_map_remove(get_group_mm(group), entry);
+      filemap_release(map);
+    }
+  else
+    {
+      entry->length = offset;
+      map->length   = offset;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: filemap
+ *
+ * Description:
+ *   Map a file into the address environment of the calling process with
+ *   pages that are read in on first access.
+ *
+ * Input Parameters:
+ *   filep - The backing file
+ *   entry - The mapping request; offset, length, prot and flags must be
+ *           initialized.
+ *
+ * Returned Value:
+ *   Zero (OK) on success with entry->vaddr set.  -ENOTTY if the request
+ *   cannot be demand paged and should fall back to rammap().  Otherwise a
+ *   negated errno value.
+ *
+ ****************************************************************************/
+
+int filemap(FAR struct file *filep, FAR struct mm_map_entry_s *entry)
+{
+  FAR struct task_group_s *group = this_task()->group;
+  FAR struct filemap_s *map;
+  irqstate_t flags;
+  unsigned int npages;
+  FAR void *vaddr;
+  int ret;
+
+  /* Only page aligned offsets can be demand paged */
+
+  if (!MM_ISALIGNED(entry->offset) || group == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  npages = MM_NPAGES(entry->length);
+
+  map = kmm_zalloc(SIZEOF_FILEMAP_S(npages));
+  if (map == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  vaddr = vm_alloc_region(get_group_mm(group), NULL,
+                          (size_t)npages << MM_PGSHIFT);
+  if (vaddr == NULL)
+    {
+      ferr("ERROR: vm_alloc_region() failed\n");
+      kmm_free(map);
+      return -ENOMEM;
+    }
+
+  map->group  = group;
+  map->filep  = filep;
+  map->vaddr  = (uintptr_t)vaddr;
+  map->offset = entry->offset;
+  map->length = entry->length;
+  map->npages = npages;
+  map->prot   = entry->prot;
+  map->flags  = entry->flags;
+  map->crefs  = 1;
+  sq_init(&map->fills);
+
+  file_ref(filep);
+
+  entry->vaddr  = vaddr;
+  entry->priv.p = map;
+  entry->munmap = unmap_filemap;
+  entry->msync  = msync_filemap;
+
+  ret = mm_map_add(get_group_mm(group), entry);
+  if (ret < 0)
+    {
+      vm_release_region(get_group_mm(group), vaddr,
+                        (size_t)npages << MM_PGSHIFT);
+      file_put(filep);
+      kmm_free(map);
+      return ret;
+    }
+
+  flags = spin_lock_irqsave(&g_filemap_lock);
+  dq_addlast(&map->node, &g_filemap_list);
+  spin_unlock_irqrestore(&g_filemap_lock, flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: filemap_fault
+ *
+ * Description:
+ *   Resolve a page fault in a demand-paged file mapping.  See
+ *   include/nuttx/fs/fs.h.
+ *
+ ****************************************************************************/
+
+int filemap_fault(uintptr_t vaddr, bool write)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  FAR struct filemap_page_s *page;
+  FAR struct filemap_s *map;
+  FAR dq_entry_t *node;
+  irqstate_t cflags;
+  irqstate_t flags;
+  unsigned int index;
+  unsigned int last;
+  bool kick = false;
+  int prot;
+  int ret = OK;
+
+  vaddr = MM_PGALIGNDOWN(vaddr);
+
+  /* The critical section is held until the task sleeps, so that the
+   * worker cannot complete the page and miss the sleeper in between.
+   */
+
+  cflags = enter_critical_section();
+  flags  = spin_lock_irqsave(&g_filemap_lock);
+
+  for (node = dq_peek(&g_filemap_list); node != NULL; node = dq_next(node))
+    {
+      map = container_of(node, struct filemap_s, node);
+      if (map->group == rtcb->group && vaddr >= map->vaddr &&
+          vaddr - map->vaddr < ((uintptr_t)map->npages << MM_PGSHIFT))
+        {
+          break;
+        }
+    }
+
+  if (node == NULL)
+    {
+      spin_unlock_irqrestore(&g_filemap_lock, flags);
+      leave_critical_section(cflags);
+      return -EFAULT;
+    }
+
+  if ((write && (map->prot & PROT_WRITE) == 0) ||
+      (map->prot & (PROT_READ | PROT_WRITE | PROT_EXEC)) == 0)
+    {
+      spin_unlock_irqrestore(&g_filemap_lock, flags);
+      leave_critical_section(cflags);
+      return -EACCES;
+    }
+
+  index = (vaddr - map->vaddr) >> MM_PGSHIFT;
+  page  = &map->pages[index];
+
+  if ((page->flags & FILEMAP_PAGE_ERROR) != 0)
+    {
+      ret = -EIO;
+    }
+  else if ((page->flags & FILEMAP_PAGE_FILLING) != 0)
+    {
+      /* The page is being read already (maybe ahead), wait for it */
+
+      page->flags |= FILEMAP_PAGE_WANTED;
+      spin_unlock_irqrestore(&g_filemap_lock, flags);
+      filemap_sleep(page);
+      leave_critical_section(cflags);
+      return OK;
+    }
+  else if (page->paddr == 0)
+    {
+      page->flags |= FILEMAP_PAGE_FILLING | FILEMAP_PAGE_WANTED;
+      sq_addlast(&page->node, &map->fills);
+
+      /* Read ahead the following pages that are not resident yet */
+
+      last = MIN(index + FILEMAP_MAXRUN, map->npages);
+      for (index++; index < last; index++)
+        {
+          if (map->pages[index].paddr != 0 ||
+              (map->pages[index].flags &
+               (FILEMAP_PAGE_FILLING | FILEMAP_PAGE_ERROR)) != 0)
+            {
+              break;
+            }
+
+          map->pages[index].flags |= FILEMAP_PAGE_FILLING;
+          sq_addlast(&map->pages[index].node, &map->fills);
+        }
+
+      if (work_available(&map->work))
+        {
+          map->crefs++;
+          kick = true;
+        }
+
+      spin_unlock_irqrestore(&g_filemap_lock, flags);
+
+      if (kick)
+        {
+          work_queue(LPWORK, &map->work, filemap_worker, map, 0);
+        }
+
+      filemap_sleep(page);
+      leave_critical_section(cflags);
+      return OK;
+    }
+  else
+    {
+      /* Clean pages of a shared writable mapping stay read-only so that
+       * the first store to them is seen.
+       */
+
+      prot = map->prot;
+      if ((map->flags & MAP_SHARED) != 0 && (prot & PROT_WRITE) != 0)
+        {
+          if (write)
+            {
+              page->flags |= FILEMAP_PAGE_DIRTY;
+            }
+          else if ((page->flags & FILEMAP_PAGE_DIRTY) == 0)
+            {
+              prot &= ~PROT_WRITE;
+            }
+        }
+
+      if ((page->flags & FILEMAP_PAGE_MAPPED) == 0)
+        {
+          ret = up_shmat(&page->paddr, 1, vaddr);
+          if (ret >= 0)
+            {
+              page->flags |= FILEMAP_PAGE_MAPPED;
+            }
+        }
+
+      if (ret >= 0)
+        {
+          ret = up_addrenv_mprot(&rtcb->addrenv_own->addrenv, vaddr,
+                                 MM_PGSIZE, prot);
+        }
+    }
+
+  spin_unlock_irqrestore(&g_filemap_lock, flags);
+  leave_critical_section(cflags);
+  return ret;
+}
+
+#endif /* CONFIG_FS_FILEMAP */
@@ -0,0 +1,70 @@
+/****************************************************************************
+ * fs/mmap/fs_filemap.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __FS_MMAP_FS_FILEMAP_H
+#define __FS_MMAP_FS_FILEMAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <nuttx/mm/map.h>
+
+#ifdef CONFIG_FS_FILEMAP
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: filemap
+ *
+ * Description:
+ *   Map a file into the address environment of the calling process.  Only
+ *   virtual address space is reserved here; the pages are read from the
+ *   file when they are first accessed.
+ *
+ * Input Parameters:
+ *   filep   file descriptor of the backing file -- required.
+ *   entry   mmap entry information.
+ *           field offset, length, prot and flags must be initialized.
+ *
+ * Returned Value:
+ *   On success filemap returns 0 and entry->vaddr points to the mapping.
+ *   Otherwise a negated errno is returned:
+ *
+ *     ENOTTY
+ *       The mapping cannot be demand paged; use rammap() instead.
+ *     ENOMEM
+ *       Insufficient memory or address space is available.
+ *
+ ****************************************************************************/
+
+int filemap(FAR struct file *filep, FAR struct mm_map_entry_s *entry);
+#else
+#  define filemap(file, entry) (-ENOTTY)
+#endif /* CONFIG_FS_FILEMAP */
+
+#endif /* __FS_MMAP_FS_FILEMAP_H */
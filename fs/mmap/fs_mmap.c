@@ -38,6 +38,7 @@
 #include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
+#include "fs_filemap.h"
 #include "fs_rammap.h"
 
 /****************************************************************************
@@ -161,6 +162,13 @@ static int file_mmap_(FAR struct file *filep, FAR void *start,
       ret = filep->f_inode->u.i_ops->mmap(filep, &entry);
     }
 
+  if (ret == -ENOTTY && type == MAP_USER)
+    {
+      /* Read the pages of a user mapping in on demand */
+
+      ret = filemap(filep, &entry);
+    }
+
   if (ret == -ENOTTY)
     {
       /* Caller request the private mapping. Or not directly mappable,
@@ -1808,6 +1808,25 @@ static int mnemofs_bind(FAR struct inode *driver, FAR const void *data,
       MFS_EXTRA_LOG("BIND", "RW Buffer allocated.");
     }
 
+#if CONFIG_MNEMOFS_BATCH_PAGES > 0
+  /* Both runs of the write queue and the read buffer in one go. */
+
+  sb->batch = fs_heap_zalloc(sizeof(struct mfs_batch_s) +
+                             3 * CONFIG_MNEMOFS_BATCH_PAGES * MFS_PGSZ(sb));
+  if (predict_false(sb->batch == NULL))
+    {
+      MFS_LOG("BIND", "Page batch in-memory allocation error.");
+      ret = -ENOMEM;
+      goto errout_with_rwbuf;
+    }
+
+  MFS_BATCH(sb)->data.buf = (FAR uint8_t *)(MFS_BATCH(sb) + 1);
+  MFS_BATCH(sb)->meta.buf = MFS_BATCH(sb)->data.buf +
+                            CONFIG_MNEMOFS_BATCH_PAGES * MFS_PGSZ(sb);
+  MFS_BATCH(sb)->rdbuf    = MFS_BATCH(sb)->meta.buf +
+                            CONFIG_MNEMOFS_BATCH_PAGES * MFS_PGSZ(sb);
+#endif
+
   /* TODO: Format the superblock in Block 0. */
 
   srand(time(NULL));
@@ -1940,6 +1959,9 @@ static int mnemofs_bind(FAR struct inode *driver, FAR const void *data,
   return ret;
 
 errout_with_rwbuf:
+#if CONFIG_MNEMOFS_BATCH_PAGES > 0
+  fs_heap_free(sb->batch);
+#endif
   fs_heap_free(sb->rw_buf);
   MFS_LOG("BIND", "RW Buffer freed.");
 
@@ -1992,12 +2014,21 @@ static int mnemofs_unbind(FAR void *handle, FAR struct inode **driver,
   *driver = sb->drv;
   MFS_LOG("UNBIND", "Driver %p.", driver);
 
+  if (predict_false(mfs_flush_pages(sb) < 0))
+    {
+      MFS_LOG("UNBIND", "Could not program the queued pages.");
+    }
+
   mfs_jrnl_free(sb);
   mfs_ba_free(sb);
 
   nxmutex_destroy(&MFS_LOCK(sb));
   MFS_EXTRA_LOG("UNBIND", "Mutex destroyed.");
 
+#if CONFIG_MNEMOFS_BATCH_PAGES > 0
+  fs_heap_free(sb->batch);
+#endif
+
   fs_heap_free(sb->rw_buf);
   MFS_LOG("UNBIND", "RW Buffer freed.");
 
@@ -2670,6 +2701,10 @@ int mnemofs_flush(FAR struct mfs_sb_s *sb)
       finfo("Finished Iteration.");
     }
 
+  /* Program what the flushes above left queued. */
+
+  ret = mfs_flush_pages(sb);
+
 errout:
   return ret;
 }
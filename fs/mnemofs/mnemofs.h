@@ -86,6 +86,7 @@
 #define MFS_PGINBLK(sb)            ((sb)->pg_in_blk)
 #define MFS_MTD(sb)                ((sb)->drv->u.i_mtd)
 #define MFS_RWBUF(sb)              ((sb)->rw_buf)
+#define MFS_BATCH(sb)              ((sb)->batch)
 #define MFS_BA(sb)                 ((sb)->ba_state)
 #define MFS_NBLKS(sb)              ((sb)->n_blks)
 #define MFS_OFILES(sb)             ((sb)->of)
@@ -187,9 +188,38 @@ struct mfs_jrnl_state_s
   uint16_t n_blks;        /* TODO: Does not include the master node. */
 };
 
+#if CONFIG_MNEMOFS_BATCH_PAGES > 0
+/* Consecutive pages that are waiting to be programmed. */
+
+struct mfs_pgrun_s
+{
+  FAR uint8_t *buf;          /* CONFIG_MNEMOFS_BATCH_PAGES pages. */
+  mfs_t       pg;            /* First page of the run. */
+  mfs_t       n;             /* Number of pages in the run. */
+};
+
+/* Pages of CTZ lists only ever point to pages that were written before
+ * them, while journal and master node pages may point to anything written
+ * before them. So pages of CTZ lists can be programmed earlier than they
+ * were written, which lets the pages of several files that follow each
+ * other on the flash be queued as one run although their journal logs were
+ * written in between.
+ */
+
+struct mfs_batch_s
+{
+  struct mfs_pgrun_s data;   /* Pages of CTZ lists. */
+  struct mfs_pgrun_s meta;   /* Journal and master node pages. */
+  FAR uint8_t        *rdbuf; /* For multi-page reads. */
+};
+#endif
+
 struct mfs_sb_s
 {
   FAR uint8_t             *rw_buf;
+#if CONFIG_MNEMOFS_BATCH_PAGES > 0
+  FAR struct mfs_batch_s  *batch;
+#endif
   FAR struct inode        *drv;
   mutex_t                 fs_lock;
   mfs_t                   sb_blk;        /* Block number of the superblock */
@@ -989,6 +1019,74 @@ ssize_t mfs_read_page(FAR const struct mfs_sb_s * const sb,
                       FAR char *data, const mfs_t datalen, const off_t page,
                       const mfs_t pgoff);
 
+/****************************************************************************
+ * Name: mfs_write_data_page
+ *
+ * Description:
+ *   Write a page of a CTZ list. Unlike mfs_write_page(), the page may be
+ *   programmed before journal or master node pages that were written
+ *   earlier, so it must not point to any of them.
+ *
+ * Input Parameters:
+ *   sb      - Superblock instance of the device.
+ *   data    - Buffer
+ *   datalen - Length of buffer.
+ *   pg      - Page number.
+ *
+ * Assumptions/Limitations:
+ *   This assumes a locked environment when called.
+ *
+ ****************************************************************************/
+
+ssize_t mfs_write_data_page(FAR const struct mfs_sb_s * const sb,
+                            FAR const char *data, const mfs_t datalen,
+                            const off_t page);
+
+/****************************************************************************
+ * Name: mfs_read_pages
+ *
+ * Description:
+ *   Read whole consecutive pages with one request to the device.
+ *
+ * Input Parameters:
+ *   sb   - Superblock instance of the device.
+ *   data - Buffer of `n` pages.
+ *   pg   - First page number.
+ *   n    - Number of pages.
+ *
+ * Returned Value:
+ *   Number of pages read, or a negated errno.
+ *
+ * Assumptions/Limitations:
+ *   This assumes a locked environment when called.
+ *
+ ****************************************************************************/
+
+ssize_t mfs_read_pages(FAR const struct mfs_sb_s * const sb,
+                       FAR char *data, const off_t page, const mfs_t n);
+
+/****************************************************************************
+ * Name: mfs_flush_pages
+ *
+ * Description:
+ *   Program all pages that are queued in RAM. Writes may be queued when
+ *   CONFIG_MNEMOFS_BATCH_PAGES is not zero, and an error in programming
+ *   them is only reported by a later write or by this function.
+ *
+ * Input Parameters:
+ *   sb - Superblock instance of the device.
+ *
+ * Returned Value:
+ *   0   - OK
+ *   < 0 - Error
+ *
+ * Assumptions/Limitations:
+ *   This assumes a locked environment when called.
+ *
+ ****************************************************************************/
+
+int mfs_flush_pages(FAR const struct mfs_sb_s * const sb);
+
 /****************************************************************************
  * Name: mfs_erase_blk
  *
@@ -128,6 +128,10 @@ static mfs_t  ctz_blkdatasz(FAR const struct mfs_sb_s * const sb,
 static void   ctz_copyidxptrs(FAR const struct mfs_sb_s * const sb,
                               struct mfs_ctz_s ctz, const mfs_t idx,
                               FAR char *buf);
+static int    ctz_rdblk(FAR const struct mfs_sb_s * const sb, FAR mfs_t *pg,
+                        const mfs_t nblks, const mfs_t pgoff,
+                        const mfs_t len, FAR char *buf,
+                        FAR mfs_t *win_pg, FAR mfs_t *win_n);
 
 /****************************************************************************
  * Private Data
@@ -318,6 +322,111 @@ static void ctz_copyidxptrs(FAR const struct mfs_sb_s * const sb,
     }
 }
 
+/****************************************************************************
+ * Name: ctz_rdblk
+ *
+ * Description:
+ *   Reads data from a CTZ block, and moves to the CTZ block before it. When
+ *   page batching is enabled, the pages below the CTZ block in the same
+ *   erase block are read along with it, since a CTZ list is read from its
+ *   end and its blocks are mostly allocated in ascending pages. These pages
+ *   are then used by the following calls as long as the pointers of the
+ *   list lead to them.
+ *
+ * Input Parameters:
+ *   sb     - Superblock instance of the device.
+ *   pg     - Page of the CTZ block, updated to the page of the one before.
+ *   nblks  - Number of CTZ blocks left to read, including this one.
+ *   pgoff  - Offset of the data in the CTZ block.
+ *   len    - Length of the data.
+ *   buf    - Buffer for the data.
+ *   win_pg - First page that was read ahead.
+ *   win_n  - Number of pages that were read ahead.
+ *
+ * Returned Value:
+ *   0   - OK
+ *   < 0 - Error
+ *
+ ****************************************************************************/
+
+static int ctz_rdblk(FAR const struct mfs_sb_s * const sb, FAR mfs_t *pg,
+                     const mfs_t nblks, const mfs_t pgoff, const mfs_t len,
+                     FAR char *buf, FAR mfs_t *win_pg, FAR mfs_t *win_n)
+{
+#if CONFIG_MNEMOFS_BATCH_PAGES > 0
+  ssize_t         ret;
+  mfs_t           n;
+  FAR const char *blk;
+
+  if (*win_n == 0 || *pg < *win_pg || *pg >= *win_pg + *win_n)
+    {
+      n = MIN(MIN(nblks, CONFIG_MNEMOFS_BATCH_PAGES),
+              MFS_PG2BLKPGOFF(sb, *pg) + 1);
+
+      ret = mfs_read_pages(sb, (FAR char *)MFS_BATCH(sb)->rdbuf,
+                           *pg - n + 1, n);
+      if (ret < 0 && n > 1)
+        {
+          /* The pages below could be erased, or contain anything. */
+
+          n   = 1;
+          ret = mfs_read_pages(sb, (FAR char *)MFS_BATCH(sb)->rdbuf,
+                               *pg, n);
+        }
+
+      if (predict_false(ret != n))
+        {
+          *win_n = 0;
+          return ret < 0 ? ret : -EIO;
+        }
+
+      *win_pg = *pg - n + 1;
+      *win_n  = n;
+    }
+
+  blk = (FAR const char *)MFS_BATCH(sb)->rdbuf +
+        (*pg - *win_pg) * MFS_PGSZ(sb);
+  memcpy(buf, blk + pgoff, len);
+
+  if (nblks > 1)
+    {
+      /* The first pointer is at the end of the CTZ block. */
+
+      mfs_deser_mfs(blk + MFS_PGSZ(sb) - MFS_CTZ_PTRSZ, pg);
+    }
+#else
+  ssize_t ret;
+  char    ptr[MFS_CTZ_PTRSZ];
+
+  ret = mfs_read_page(sb, buf, len, *pg, pgoff);
+  if (predict_false(ret <= 0))
+    {
+      return ret < 0 ? ret : -EINVAL;
+    }
+
+  if (nblks > 1)
+    {
+      /* The first pointer is at the end of the CTZ block. */
+
+      ret = mfs_read_page(sb, ptr, MFS_CTZ_PTRSZ, *pg,
+                          MFS_PGSZ(sb) - MFS_CTZ_PTRSZ);
+      if (predict_false(ret <= 0))
+        {
+          return ret < 0 ? ret : -EINVAL;
+        }
+
+      mfs_deser_mfs(ptr, pg);
+    }
+#endif
+
+  if (nblks > 1 && predict_false(*pg == 0))
+    {
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -334,6 +443,9 @@ int mfs_ctz_rdfromoff(FAR const struct mfs_sb_s * const sb,
   mfs_t end_idx;
   mfs_t end_pgoff;
   mfs_t pg_rd_sz;
+  mfs_t pgoff;
+  mfs_t win_pg    = 0;
+  mfs_t win_n     = 0;
 
   finfo("Reading (%u, %u) CTZ from %u offset for %u bytes.", ctz.idx_e,
         ctz.pg_e, data_off, len);
@@ -365,44 +477,46 @@ int mfs_ctz_rdfromoff(FAR const struct mfs_sb_s * const sb,
 
   if (cur_idx != end_idx)
     {
-      for (i = cur_idx; i >= end_idx; i--)
+      /* Each CTZ block leads to the one before it, so the blocks are read
+       * from the end of the range, without traveling from the end of the
+       * list for each of them.
+       */
+
+      buf += len;
+
+      for (i = cur_idx; ; i--)
         {
           finfo("Current index %u, Current Page %u.", i, cur_pg);
 
           if (predict_false(i == cur_idx))
             {
               pg_rd_sz  = cur_pgoff;
-              ret       = mfs_read_page(sb, buf - pg_rd_sz, pg_rd_sz, cur_pg,
-                                        0);
-              cur_pgoff = 0;
+              pgoff     = 0;
             }
           else if (predict_false(i == end_idx))
             {
               pg_rd_sz = ctz_blkdatasz(sb, i) - end_pgoff;
-              ret      = mfs_read_page(sb, buf - pg_rd_sz, pg_rd_sz, cur_pg,
-                                       end_pgoff);
+              pgoff    = end_pgoff;
             }
           else
             {
               pg_rd_sz = ctz_blkdatasz(sb, i);
-              ret      = mfs_read_page(sb, buf - pg_rd_sz, pg_rd_sz, cur_pg,
-                                      0);
+              pgoff    = 0;
             }
 
-          if (predict_false(ret == 0))
+          ret = ctz_rdblk(sb, &cur_pg, i - end_idx + 1, pgoff, pg_rd_sz,
+                          buf - pg_rd_sz, &win_pg, &win_n);
+          if (predict_false(ret < 0))
             {
-              ret = -EINVAL;
               goto errout;
             }
 
           buf -= pg_rd_sz;
-        }
 
-      cur_pg = mfs_ctz_travel(sb, cur_idx, cur_pg, cur_idx - 1);
-      if (predict_false(cur_pg == 0))
-        {
-          ret = -EINVAL;
-          goto errout;
+          if (i == end_idx)
+            {
+              break;
+            }
         }
     }
   else
@@ -554,7 +668,7 @@ int mfs_ctz_wrtnode(FAR struct mfs_sb_s * const sb,
 
           ctz_copyidxptrs(sb, ctz, cur_idx, buf);
 
-          ret = mfs_write_page(sb, buf, MFS_PGSZ(sb), new_pg, 0);
+          ret = mfs_write_data_page(sb, buf, MFS_PGSZ(sb), new_pg);
           if (predict_false(ret == 0))
             {
               ret = -EINVAL;
@@ -82,6 +82,101 @@
  * Private Functions
  ****************************************************************************/
 
+#if CONFIG_MNEMOFS_BATCH_PAGES > 0
+static int rw_flush_run(FAR const struct mfs_sb_s * const sb,
+                        FAR struct mfs_pgrun_s *run)
+{
+  ssize_t ret;
+  mfs_t   n = run->n;
+
+  if (n == 0)
+    {
+      return OK;
+    }
+
+  run->n = 0;
+  ret    = MTD_BWRITE(MFS_MTD(sb), run->pg, n, run->buf);
+  if (predict_false(ret < 0))
+    {
+      return ret;
+    }
+
+  return ret == n ? OK : -EIO;
+}
+
+/* Queue a page at the end of a run, programming the run first if the page
+ * does not follow it.
+ */
+
+static ssize_t rw_queue(FAR const struct mfs_sb_s * const sb,
+                        FAR struct mfs_pgrun_s *run, FAR const char *data,
+                        const mfs_t datalen, const off_t page)
+{
+  int       ret;
+  FAR char *dst;
+
+  if (run->n > 0 && (page != run->pg + run->n ||
+                     MFS_PG2BLK(sb, page) != MFS_PG2BLK(sb, run->pg)))
+    {
+      /* Journal and master node pages may point to pages of CTZ lists
+       * anywhere in the queue.
+       */
+
+      ret = run == &MFS_BATCH(sb)->meta ? mfs_flush_pages(sb) :
+                                          rw_flush_run(sb, run);
+      if (predict_false(ret < 0))
+        {
+          return ret;
+        }
+    }
+
+  if (run->n == 0)
+    {
+      run->pg = page;
+    }
+
+  /* Pad the page with zeroes, as the unbatched writes do. */
+
+  dst = (FAR char *)run->buf + run->n * MFS_PGSZ(sb);
+  memcpy(dst, data, MIN(datalen, MFS_PGSZ(sb)));
+  if (datalen < MFS_PGSZ(sb))
+    {
+      memset(dst + datalen, 0, MFS_PGSZ(sb) - datalen);
+    }
+
+  if (++run->n == CONFIG_MNEMOFS_BATCH_PAGES)
+    {
+      ret = run == &MFS_BATCH(sb)->meta ? mfs_flush_pages(sb) :
+                                          rw_flush_run(sb, run);
+      if (predict_false(ret < 0))
+        {
+          return ret;
+        }
+    }
+
+  return 1;
+}
+
+static FAR const uint8_t *rw_queued(FAR const struct mfs_sb_s * const sb,
+                                    const off_t page)
+{
+  FAR struct mfs_pgrun_s *run = &MFS_BATCH(sb)->data;
+
+  if (run->n > 0 && page >= run->pg && page < run->pg + run->n)
+    {
+      return run->buf + (page - run->pg) * MFS_PGSZ(sb);
+    }
+
+  run = &MFS_BATCH(sb)->meta;
+  if (run->n > 0 && page >= run->pg && page < run->pg + run->n)
+    {
+      return run->buf + (page - run->pg) * MFS_PGSZ(sb);
+    }
+
+  return NULL;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -121,6 +216,19 @@ ssize_t mfs_write_page(FAR const struct mfs_sb_s * const sb,
       return -EINVAL;
     }
 
+#if CONFIG_MNEMOFS_BATCH_PAGES > 0
+  if (pgoff == 0)
+    {
+      return rw_queue(sb, &MFS_BATCH(sb)->meta, data, datalen, page);
+    }
+
+  ret = mfs_flush_pages(sb);
+  if (predict_false(ret < 0))
+    {
+      return ret;
+    }
+#endif
+
   memcpy(MFS_RWBUF(sb) + pgoff, data, MIN(datalen, MFS_PGSZ(sb) - pgoff));
 
   ret = MTD_BWRITE(MFS_MTD(sb), page, 1, MFS_RWBUF(sb));
@@ -140,12 +248,24 @@ ssize_t mfs_read_page(FAR const struct mfs_sb_s * const sb,
                       const mfs_t pgoff)
 {
   int ret = OK;
+#if CONFIG_MNEMOFS_BATCH_PAGES > 0
+  FAR const uint8_t *queued;
+#endif
 
   if (predict_false(page > MFS_NPGS(sb) || pgoff >= MFS_PGSZ(sb)))
     {
       return -EINVAL;
     }
 
+#if CONFIG_MNEMOFS_BATCH_PAGES > 0
+  queued = rw_queued(sb, page);
+  if (queued != NULL)
+    {
+      memcpy(data, queued + pgoff, MIN(datalen, MFS_PGSZ(sb) - pgoff));
+      return 1;
+    }
+#endif
+
   ret = MTD_BREAD(MFS_MTD(sb), page, 1, MFS_RWBUF(sb));
   if (predict_false(ret < 0))
     {
@@ -160,23 +280,106 @@ errout_with_reset:
   return ret;
 }
 
+ssize_t mfs_write_data_page(FAR const struct mfs_sb_s * const sb,
+                            FAR const char *data, const mfs_t datalen,
+                            const off_t page)
+{
+#if CONFIG_MNEMOFS_BATCH_PAGES > 0
+  if (predict_false(page > MFS_NPGS(sb)))
+    {
+      return -EINVAL;
+    }
+
+  return rw_queue(sb, &MFS_BATCH(sb)->data, data, datalen, page);
+#else
+  return mfs_write_page(sb, data, datalen, page, 0);
+#endif
+}
+
+ssize_t mfs_read_pages(FAR const struct mfs_sb_s * const sb,
+                       FAR char *data, const off_t page, const mfs_t n)
+{
+#if CONFIG_MNEMOFS_BATCH_PAGES > 0
+  int   ret;
+  mfs_t i;
+#endif
+
+  if (predict_false(page + n > MFS_NPGS(sb)))
+    {
+      return -EINVAL;
+    }
+
+#if CONFIG_MNEMOFS_BATCH_PAGES > 0
+  for (i = 0; i < n; i++)
+    {
+      if (rw_queued(sb, page + i) != NULL)
+        {
+          ret = mfs_flush_pages(sb);
+          if (predict_false(ret < 0))
+            {
+              return ret;
+            }
+
+          break;
+        }
+    }
+#endif
+
+  return MTD_BREAD(MFS_MTD(sb), page, n, (FAR uint8_t *)data);
+}
+
+int mfs_flush_pages(FAR const struct mfs_sb_s * const sb)
+{
+#if CONFIG_MNEMOFS_BATCH_PAGES > 0
+  int ret;
+
+  /* CTZ list pages first, as the journal may point to them. */
+
+  ret = rw_flush_run(sb, &MFS_BATCH(sb)->data);
+  if (predict_false(ret < 0))
+    {
+      return ret;
+    }
+
+  return rw_flush_run(sb, &MFS_BATCH(sb)->meta);
+#else
+  return OK;
+#endif
+}
+
 int mfs_erase_blk(FAR const struct mfs_sb_s * const sb, const off_t blk)
 {
+  int ret;
+
   if (predict_false(blk > MFS_NBLKS(sb)))
     {
       return -EINVAL;
     }
 
+  ret = mfs_flush_pages(sb);
+  if (predict_false(ret < 0))
+    {
+      return ret;
+    }
+
   return MTD_ERASE(MFS_MTD(sb), blk, 1);
 }
 
 int mfs_erase_nblks(FAR const struct mfs_sb_s * const sb, const off_t blk,
                     const size_t n)
 {
+  int ret;
+
   if (predict_false(blk + n > MFS_NBLKS(sb)))
     {
       return -EINVAL;
     }
 
+  ret = mfs_flush_pages(sb);
+  if (predict_false(ret < 0))
+    {
+      return ret;
+    }
+
   return MTD_ERASE(MFS_MTD(sb), blk, n);
 }
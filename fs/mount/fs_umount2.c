@@ -127,6 +127,8 @@ int nx_umount2(FAR const char *target, unsigned int flags)
       goto errout_with_lock;
     }
 
+  pathcache_invalidate(mountpt_inode);
+
   /* Successfully unbound.  Convert the mountpoint inode to regular
    * pseudo-file inode.
    */
@@ -113,6 +113,8 @@ extern "C"
 EXTERN int nfs_request(FAR struct nfsmount *nmp, int procnum,
                 FAR void *request, size_t reqlen,
                 FAR void *response, size_t resplen);
+EXTERN int nfs_request_multi(FAR struct nfsmount *nmp, int procnum,
+              FAR struct rpcclnt_call *calls, int ncalls);
 EXTERN int  nfs_lookup(FAR struct nfsmount *nmp, FAR const char *filename,
               FAR struct file_handle *fhandle,
               FAR struct nfs_fattr *obj_attributes,
@@ -50,6 +50,8 @@
  ****************************************************************************/
 
 #include <sys/socket.h>
+#include <stdbool.h>
+#include <time.h>
 #include <nuttx/mutex.h>
 
 #include "rpc.h"
@@ -58,10 +60,57 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_NFS_IO_WINDOW
+#  define CONFIG_NFS_IO_WINDOW 1
+#endif
+
+#ifndef CONFIG_NFS_LOOKUP_CACHE
+#  define CONFIG_NFS_LOOKUP_CACHE 0
+#endif
+
+#ifndef CONFIG_NFS_LOOKUP_CACHE_TIMEOUT
+#  define CONFIG_NFS_LOOKUP_CACHE_TIMEOUT 3000
+#endif
+
+/* Longest name that is kept in the lookup cache */
+
+#define NFS_LOOKUP_NAMELEN 32
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* A cached LOOKUP result: the file handle and attributes of the name
+ * lc_name in the directory lc_dir.
+ */
+
+#if CONFIG_NFS_LOOKUP_CACHE > 0
+struct nfs_lookup_cache_s
+{
+  clock_t                   lc_time;          /* Time of the LOOKUP call */
+  bool                      lc_valid;         /* Entry is in use */
+  bool                      lc_hasdirattr;    /* lc_dirattr is valid */
+  uint8_t                   lc_namelen;       /* Length of lc_name */
+  struct file_handle        lc_dir;           /* Handle of the directory */
+  struct file_handle        lc_fh;            /* Handle of the object */
+  struct nfs_fattr          lc_attr;          /* Attributes of the object */
+  struct nfs_fattr          lc_dirattr;       /* Attributes of the directory */
+  char                      lc_name[NFS_LOOKUP_NAMELEN];
+};
+#endif
+
+/* READ call or WRITE reply message of a call in flight beyond the first
+ * one, which uses nm_msgbuffer.
+ */
+
+#if CONFIG_NFS_IO_WINDOW > 1
+union nfs_iomsg_u
+{
+  struct rpc_call_read      read;
+  struct rpc_reply_write    write;
+};
+#endif
+
 /* Mount structure. One mount structure is allocated for each NFS mount. This
  * structure holds NFS specific information for mount.
  */
@@ -102,13 +151,22 @@ struct nfsmount
     struct rpc_reply_write  write;
   } nm_msgbuffer;
 
+#if CONFIG_NFS_IO_WINDOW > 1
+  union nfs_iomsg_u         nm_iomsg[CONFIG_NFS_IO_WINDOW - 1];
+#endif
+
+#if CONFIG_NFS_LOOKUP_CACHE > 0
+  struct nfs_lookup_cache_s nm_lookup[CONFIG_NFS_LOOKUP_CACHE];
+#endif
+
   /* I/O buffer (must be a aligned to 32-bit boundaries).  This buffer used
    * for all reply messages EXCEPT for the WRITE RPC. In that case it is used
    * for the WRITE call message that contains the data to be written.  This
    * buffer must be dynamically sized based on the characteristics of the
    * server and upon the configuration of the NuttX network.  It must be
    * sized to hold the largest possible WRITE call message or READ response
-   * message.
+   * message.  With CONFIG_NFS_IO_WINDOW > 1, there is one such buffer for
+   * each call in flight, every one of them nm_buflen bytes long.
    */
 
   uint32_t                  nm_iobuffer[1];   /* Actual size is given by nm_buflen */
@@ -51,6 +51,16 @@
 
 #include "nfs_proto.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Values of n_flags */
+
+#define NFSNODE_UNSTABLE   (1 << 0)  /* Has UNSTABLE writes not committed */
+#define NFSNODE_HAVEVERF   (1 << 1)  /* n_verf holds the write verifier */
+#define NFSNODE_LOSTDATA   (1 << 2)  /* The server lost written data */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -71,6 +81,13 @@ struct nfsnode
   struct timespec     n_ctime;      /* File creation time */
   nfsfh_t             n_fhandle;    /* NFS File Handle */
   uint64_t            n_size;       /* Current size of file */
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+  uint8_t             n_flags;      /* See NFSNODE_* definitions */
+
+  /* Write verifier of the server at the time of the last UNSTABLE write */
+
+  uint8_t             n_verf[NFSX_V3WRITEVERF];
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
@@ -38,6 +38,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+
 #include "rpc.h"
 #include "nfs.h"
 #include "nfs_proto.h"
@@ -101,6 +103,188 @@ static inline int nfs_pathsegment(FAR const char **path, FAR char *buffer,
     }
 }
 
+/****************************************************************************
+ * Name: nfs_checkreply
+ *
+ * Description:
+ *   Verify the NFS level of a reply message.
+ *
+ ****************************************************************************/
+
+static int nfs_checkreply(FAR void *response)
+{
+  struct nfs_reply_header replyh;
+  int error;
+
+  memcpy(&replyh, response, sizeof(struct nfs_reply_header));
+
+  if (replyh.nfs_status != 0)
+    {
+      /* NFS_ERRORS are the same as NuttX errno values */
+
+      return -fxdr_unsigned(uint32_t, replyh.nfs_status);
+    }
+
+  if (replyh.rh.rpc_verfi.authtype != 0)
+    {
+      error = -EOPNOTSUPP;
+      ferr("ERROR: NFS authtype %d from server\n",
+           fxdr_unsigned(int, replyh.rh.rpc_verfi.authtype));
+      return error;
+    }
+
+  finfo("NFS_SUCCESS\n");
+  return OK;
+}
+
+#if CONFIG_NFS_LOOKUP_CACHE > 0
+/****************************************************************************
+ * Name: nfs_lookup_cache_find
+ *
+ * Description:
+ *   Find the unexpired cache entry for the name in the directory.
+ *
+ ****************************************************************************/
+
+static FAR struct nfs_lookup_cache_s *
+nfs_lookup_cache_find(FAR struct nfsmount *nmp,
+                      FAR const struct file_handle *dir,
+                      FAR const char *name, int namelen)
+{
+  FAR struct nfs_lookup_cache_s *entry;
+  clock_t now = clock_systime_ticks();
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_LOOKUP_CACHE; i++)
+    {
+      entry = &nmp->nm_lookup[i];
+      if (!entry->lc_valid)
+        {
+          continue;
+        }
+
+      if (now - entry->lc_time >=
+          MSEC2TICK(CONFIG_NFS_LOOKUP_CACHE_TIMEOUT))
+        {
+          entry->lc_valid = false;
+          continue;
+        }
+
+      if (entry->lc_namelen == namelen &&
+          entry->lc_dir.length == dir->length &&
+          memcmp(entry->lc_name, name, namelen) == 0 &&
+          memcmp(&entry->lc_dir.handle, &dir->handle, dir->length) == 0)
+        {
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: nfs_lookup_cache_add
+ *
+ * Description:
+ *   Remember the result of a LOOKUP call, replacing a free entry or else
+ *   the oldest one.
+ *
+ ****************************************************************************/
+
+static void nfs_lookup_cache_add(FAR struct nfsmount *nmp,
+                                 FAR const struct file_handle *dir,
+                                 FAR const char *name, int namelen,
+                                 FAR const struct file_handle *fhandle,
+                                 FAR const struct nfs_fattr *obj_attributes,
+                                 FAR const struct nfs_fattr *dir_attributes)
+{
+  FAR struct nfs_lookup_cache_s *entry = &nmp->nm_lookup[0];
+  clock_t now = clock_systime_ticks();
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_LOOKUP_CACHE && entry->lc_valid; i++)
+    {
+      if (!nmp->nm_lookup[i].lc_valid ||
+          now - nmp->nm_lookup[i].lc_time > now - entry->lc_time)
+        {
+          entry = &nmp->nm_lookup[i];
+        }
+    }
+
+  entry->lc_time       = now;
+  entry->lc_valid      = true;
+  entry->lc_hasdirattr = dir_attributes != NULL;
+  entry->lc_namelen    = namelen;
+  memcpy(entry->lc_name, name, namelen);
+  memcpy(&entry->lc_dir, dir, sizeof(struct file_handle));
+  memcpy(&entry->lc_fh, fhandle, sizeof(struct file_handle));
+  memcpy(&entry->lc_attr, obj_attributes, sizeof(struct nfs_fattr));
+
+  if (dir_attributes != NULL)
+    {
+      memcpy(&entry->lc_dirattr, dir_attributes, sizeof(struct nfs_fattr));
+    }
+}
+
+/****************************************************************************
+ * Name: nfs_lookup_cache_invalidate
+ *
+ * Description:
+ *   Drop the cache entries that the request is about to make stale.  A
+ *   change of the name space drops everything, because it also changes
+ *   the attributes of the directories involved.  A WRITE or SETATTR only
+ *   drops the entries of the file that it operates on.
+ *
+ ****************************************************************************/
+
+static void nfs_lookup_cache_invalidate(FAR struct nfsmount *nmp,
+                                        int procnum, FAR void *request)
+{
+  FAR uint32_t *ptr;
+  uint32_t length;
+  int i;
+
+  switch (procnum)
+    {
+      case NFSPROC_CREATE:
+      case NFSPROC_MKDIR:
+      case NFSPROC_SYMLINK:
+      case NFSPROC_MKNOD:
+      case NFSPROC_REMOVE:
+      case NFSPROC_RMDIR:
+      case NFSPROC_RENAME:
+      case NFSPROC_LINK:
+        for (i = 0; i < CONFIG_NFS_LOOKUP_CACHE; i++)
+          {
+            nmp->nm_lookup[i].lc_valid = false;
+          }
+        break;
+
+      case NFSPROC_WRITE:
+      case NFSPROC_SETATTR:
+
+        /* Both argument lists begin with the file handle */
+
+        ptr    = (FAR uint32_t *)((FAR uint8_t *)request +
+                                  sizeof(struct rpc_call_header));
+        length = fxdr_unsigned(uint32_t, *ptr++);
+
+        for (i = 0; i < CONFIG_NFS_LOOKUP_CACHE; i++)
+          {
+            if (nmp->nm_lookup[i].lc_fh.length == length &&
+                memcmp(&nmp->nm_lookup[i].lc_fh.handle, ptr, length) == 0)
+              {
+                nmp->nm_lookup[i].lc_valid = false;
+              }
+          }
+        break;
+
+      default:
+        break;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -120,16 +304,53 @@ static inline int nfs_pathsegment(FAR const char **path, FAR char *buffer,
 int nfs_request(FAR struct nfsmount *nmp, int procnum,
                 FAR void *request, size_t reqlen,
                 FAR void *response, size_t resplen)
+{
+  struct rpcclnt_call call;
+  int error;
+
+  call.rq_request  = request;
+  call.rq_reqlen   = reqlen;
+  call.rq_response = response;
+  call.rq_resplen  = resplen;
+
+  error = nfs_request_multi(nmp, procnum, &call, 1);
+  return error != OK ? error : call.rq_result;
+}
+
+/****************************************************************************
+ * Name: nfs_request_multi
+ *
+ * Description:
+ *   Perform a batch of NFS requests for the same procedure with all of
+ *   them in flight at the same time.  On successful receipt, it verifies
+ *   the NFS level of each returned value.
+ *
+ * Returned Value:
+ *   Zero if every call got a reply, in which case rq_result of each call
+ *   holds its status; a negative errno value of the transport failure
+ *   otherwise.
+ *
+ ****************************************************************************/
+
+int nfs_request_multi(FAR struct nfsmount *nmp, int procnum,
+                      FAR struct rpcclnt_call *calls, int ncalls)
 {
   FAR struct rpcclnt *clnt = nmp->nm_rpcclnt;
-  struct nfs_reply_header replyh;
   int error;
+  int i;
 
-  error = rpcclnt_request(clnt, procnum, NFS_PROG, NFS_VER3,
-                          request, reqlen, response, resplen);
+#if CONFIG_NFS_LOOKUP_CACHE > 0
+  for (i = 0; i < ncalls; i++)
+    {
+      nfs_lookup_cache_invalidate(nmp, procnum, calls[i].rq_request);
+    }
+#endif
+
+  error = rpcclnt_request_multi(clnt, procnum, NFS_PROG, NFS_VER3,
+                                calls, ncalls);
   if (error != 0)
     {
-      ferr("ERROR: rpcclnt_request failed: %d\n", error);
+      ferr("ERROR: rpcclnt_request_multi failed: %d\n", error);
 
       if (error != -ENOTCONN)
         {
@@ -147,10 +368,10 @@ int nfs_request(FAR struct nfsmount *nmp, int procnum,
           return error;
         }
 
-      /* Send the request again */
+      /* Send the requests again */
 
-      error = rpcclnt_request(clnt, procnum, NFS_PROG, NFS_VER3,
-                              request, reqlen, response, resplen);
+      error = rpcclnt_request_multi(clnt, procnum, NFS_PROG, NFS_VER3,
+                                    calls, ncalls);
 
       if (error != 0)
         {
@@ -158,24 +379,14 @@ int nfs_request(FAR struct nfsmount *nmp, int procnum,
         }
     }
 
-  memcpy(&replyh, response, sizeof(struct nfs_reply_header));
-
-  if (replyh.nfs_status != 0)
-    {
-      /* NFS_ERRORS are the same as NuttX errno values */
-
-      return -fxdr_unsigned(uint32_t, replyh.nfs_status);
-    }
-
-  if (replyh.rh.rpc_verfi.authtype != 0)
+  for (i = 0; i < ncalls; i++)
     {
-      error = -EOPNOTSUPP;
-      ferr("ERROR: NFS authtype %d from server\n",
-           fxdr_unsigned(int, replyh.rh.rpc_verfi.authtype));
-      return error;
+      if (calls[i].rq_result == OK)
+        {
+          calls[i].rq_result = nfs_checkreply(calls[i].rq_response);
+        }
     }
 
-  finfo("NFS_SUCCESS\n");
   return OK;
 }
 
@@ -198,6 +409,11 @@ int nfs_lookup(FAR struct nfsmount *nmp, FAR const char *filename,
                FAR struct nfs_fattr *obj_attributes,
                FAR struct nfs_fattr *dir_attributes)
 {
+#if CONFIG_NFS_LOOKUP_CACHE > 0
+  FAR struct nfs_lookup_cache_s *entry;
+  struct file_handle dir;
+  FAR void *objattr;
+#endif
   FAR uint32_t *ptr;
   uint32_t value;
   int reqlen;
@@ -215,6 +431,31 @@ int nfs_lookup(FAR struct nfsmount *nmp, FAR const char *filename,
       return -E2BIG;
     }
 
+#if CONFIG_NFS_LOOKUP_CACHE > 0
+  /* Use a recent answer to the same question if there is one */
+
+  entry = nfs_lookup_cache_find(nmp, fhandle, filename, namelen);
+  if (entry != NULL && (dir_attributes == NULL || entry->lc_hasdirattr))
+    {
+      memcpy(fhandle, &entry->lc_fh, sizeof(struct file_handle));
+      if (obj_attributes)
+        {
+          memcpy(obj_attributes, &entry->lc_attr, sizeof(struct nfs_fattr));
+        }
+
+      if (dir_attributes)
+        {
+          memcpy(dir_attributes, &entry->lc_dirattr,
+                 sizeof(struct nfs_fattr));
+        }
+
+      return OK;
+    }
+
+  memcpy(&dir, fhandle, sizeof(struct file_handle));
+  objattr = NULL;
+#endif
+
   /* Initialize the request */
 
   ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.lookup.lookup;
@@ -286,6 +527,9 @@ int nfs_lookup(FAR struct nfsmount *nmp, FAR const char *filename,
           memcpy(obj_attributes, ptr, sizeof(struct nfs_fattr));
         }
 
+#if CONFIG_NFS_LOOKUP_CACHE > 0
+      objattr = ptr;
+#endif
       ptr += uint32_increment(sizeof(struct nfs_fattr));
     }
 
@@ -299,6 +543,16 @@ int nfs_lookup(FAR struct nfsmount *nmp, FAR const char *filename,
       memcpy(dir_attributes, ptr, sizeof(struct nfs_fattr));
     }
 
+#if CONFIG_NFS_LOOKUP_CACHE > 0
+  /* Only complete answers are worth remembering */
+
+  if (objattr != NULL && namelen <= NFS_LOOKUP_NAMELEN)
+    {
+      nfs_lookup_cache_add(nmp, &dir, filename, namelen, fhandle, objattr,
+                           value ? (FAR void *)ptr : NULL);
+    }
+#endif
+
   return OK;
 }
 
@@ -143,6 +143,9 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
                         size_t buflen);
 static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
                    size_t buflen);
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+static int     nfs_commit(FAR struct nfsmount *nmp, FAR struct nfsnode *np);
+#endif
 static off_t   nfs_seek(FAR struct file *filep, off_t offset, int whence);
 static int     nfs_sync(FAR struct file *filep);
 static int     nfs_dup(FAR const struct file *oldp, FAR struct file *newp);
@@ -781,6 +784,9 @@ static int nfs_close(FAR struct file *filep)
   FAR struct nfsnode  *np;
   FAR struct nfsnode  *prev;
   FAR struct nfsnode  *curr;
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+  int commit;
+#endif
   int ret;
 
   /* Sanity checks */
@@ -821,6 +827,12 @@ static int nfs_close(FAR struct file *filep)
 
   else
     {
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+      /* Commit the UNSTABLE writes before the node goes away */
+
+      commit = nfs_commit(nmp, np);
+
+#endif
       /* Assume file structure won't be found. This should never happen. */
 
       ret = -EINVAL;
@@ -855,6 +867,13 @@ static int nfs_close(FAR struct file *filep)
               break;
             }
         }
+
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+      if (ret == OK)
+        {
+          ret = commit;
+        }
+#endif
     }
 
   filep->f_priv = NULL;
@@ -862,9 +881,48 @@ static int nfs_close(FAR struct file *filep)
   return ret;
 }
 
+/****************************************************************************
+ * Name: nfs_iobuffer
+ *
+ * Description:
+ *   Return the I/O buffer of the call in window slot "slot".
+ *
+ ****************************************************************************/
+
+static inline FAR void *nfs_iobuffer(FAR struct nfsmount *nmp, int slot)
+{
+  return (FAR uint8_t *)nmp->nm_iobuffer + slot * nmp->nm_buflen;
+}
+
+/****************************************************************************
+ * Name: nfs_iomsg
+ *
+ * Description:
+ *   Return the buffer of the READ call or WRITE reply message of the call
+ *   in window slot "slot".
+ *
+ ****************************************************************************/
+
+static inline FAR void *nfs_iomsg(FAR struct nfsmount *nmp, int slot)
+{
+#if CONFIG_NFS_IO_WINDOW > 1
+  if (slot > 0)
+    {
+      return &nmp->nm_iomsg[slot - 1];
+    }
+#endif
+
+  return &nmp->nm_msgbuffer;
+}
+
 /****************************************************************************
  * Name: nfs_read
  *
+ * Description:
+ *   Read in rsize chunks with up to CONFIG_NFS_IO_WINDOW READ calls in
+ *   flight.  The replies are consumed in file order; a short reply ends
+ *   the batch and the next batch starts where the data ended.
+ *
  * Returned Value:
  *   The (non-negative) number of bytes read on success; a negated errno
  *   value on failure.
@@ -874,13 +932,21 @@ static int nfs_close(FAR struct file *filep)
 static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
                         size_t buflen)
 {
+  struct rpcclnt_call        calls[CONFIG_NFS_IO_WINDOW];
+  size_t                     asked[CONFIG_NFS_IO_WINDOW];
+  FAR struct rpc_call_read  *msg;
   FAR struct nfsmount       *nmp;
   FAR struct nfsnode        *np;
   ssize_t                    readsize;
   ssize_t                    tmp;
   ssize_t                    bytesread;
   size_t                     reqlen;
+  size_t                     remaining;
+  off_t                      offset;
   FAR uint32_t              *ptr;
+  uint32_t                   eof;
+  int                        ncalls;
+  int                        i;
   int                        ret = 0;
 
   finfo("Read %zu bytes from offset %jd\n",
@@ -918,114 +984,156 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
 
   for (bytesread = 0; bytesread < buflen; )
     {
-      /* Make sure that the attempted read size does not exceed the RPC
-       * maximum
-       */
+      offset    = filep->f_pos;
+      remaining = buflen - bytesread;
 
-      readsize = buflen - bytesread;
-      if (readsize > nmp->nm_rsize)
+      for (ncalls = 0; ncalls < CONFIG_NFS_IO_WINDOW && remaining > 0;
+           ncalls++)
         {
-          readsize = nmp->nm_rsize;
-        }
+          /* Make sure that the attempted read size does not exceed the RPC
+           * maximum
+           */
 
-      /* Make sure that the attempted read size does not exceed the IO buffer
-       * size
-       */
+          readsize = remaining;
+          if (readsize > nmp->nm_rsize)
+            {
+              readsize = nmp->nm_rsize;
+            }
 
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
-        {
-          readsize -= (tmp - nmp->nm_buflen);
-        }
+          /* Make sure that the attempted read size does not exceed the IO
+           * buffer size
+           */
 
-      /* Initialize the request */
+          tmp = SIZEOF_rpc_reply_read(readsize);
+          if (tmp > nmp->nm_buflen)
+            {
+              readsize -= (tmp - nmp->nm_buflen);
+            }
 
-      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
+          /* Initialize the request */
 
-      /* Copy the variable length, file handle */
+          msg     = nfs_iomsg(nmp, ncalls);
+          ptr     = (FAR uint32_t *)&msg->read;
+          reqlen  = 0;
 
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
+          /* Copy the variable length, file handle */
 
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
+          *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+          reqlen += sizeof(uint32_t);
 
-      /* Copy the file offset */
+          memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+          reqlen += uint32_alignup(np->n_fhsize);
+          ptr    += uint32_increment(np->n_fhsize);
 
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
+          /* Copy the file offset */
 
-      /* Set the readsize */
+          txdr_hyper((uint64_t)offset, ptr);
+          ptr += 2;
+          reqlen += 2*sizeof(uint32_t);
 
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
+          /* Set the readsize */
 
-      /* Perform the read */
+          *ptr = txdr_unsigned(readsize);
+          reqlen += sizeof(uint32_t);
 
-      finfo("Reading %zu bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      ret = nfs_request(nmp, NFSPROC_READ,
-                        &nmp->nm_msgbuffer.read, reqlen,
-                        nmp->nm_iobuffer, nmp->nm_buflen);
+          calls[ncalls].rq_request  = msg;
+          calls[ncalls].rq_reqlen   = reqlen;
+          calls[ncalls].rq_response = nfs_iobuffer(nmp, ncalls);
+          calls[ncalls].rq_resplen  = nmp->nm_buflen;
+          asked[ncalls]             = readsize;
+
+          offset    += readsize;
+          remaining -= readsize;
+          nfs_statistics(NFSPROC_READ);
+        }
+
+      /* Perform the reads */
+
+      finfo("Reading %zu bytes in %d calls\n",
+            buflen - bytesread - remaining, ncalls);
+      ret = nfs_request_multi(nmp, NFSPROC_READ, calls, ncalls);
       if (ret)
         {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
+          ferr("ERROR: nfs_request_multi failed: %d\n", ret);
           goto errout_with_lock;
         }
 
-      /* The read was successful.  Get a pointer to the beginning of the NFS
-       * response data.
-       */
+      for (i = 0; i < ncalls; i++)
+        {
+          ret = calls[i].rq_result;
+          if (ret)
+            {
+              ferr("ERROR: READ failed: %d\n", ret);
+              goto errout_with_lock;
+            }
 
-      ptr = (FAR uint32_t *)
-        &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+          /* The read was successful.  Get a pointer to the beginning of the
+           * NFS response data.
+           */
 
-      /* Check if attributes are included in the responses */
+          ptr = (FAR uint32_t *)
+            &((FAR struct rpc_reply_read *)calls[i].rq_response)->read;
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. Update the cached file status in the file structure. */
+          /* Check if attributes are included in the responses */
 
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
+          tmp = *ptr++;
+          if (tmp != 0)
+            {
+              /* Yes.. Update the cached file status in the file structure. */
 
-      /* This is followed by the count of data read.  Isn't this
-       * the same as the length that is included in the read data?
-       *
-       * Just skip over if for now.
-       */
+              nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+              ptr += uint32_increment(sizeof(struct nfs_fattr));
+            }
 
-      ptr++;
+          /* This is followed by the count of data read.  Isn't this
+           * the same as the length that is included in the read data?
+           *
+           * Just skip over if for now.
+           */
 
-      /* Next comes an EOF indication.  Save that in tmp for now. */
+          ptr++;
 
-      tmp = *ptr++;
+          /* Next comes an EOF indication.  Save that for now. */
 
-      /* Then the length of the read data followed by the read data itself */
+          eof = *ptr++;
 
-      readsize = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
+          /* Then the length of the read data followed by the read data
+           * itself
+           */
 
-      /* Copy the read data into the user buffer */
+          readsize = fxdr_unsigned(uint32_t, *ptr);
+          ptr++;
 
-      memcpy(buffer, ptr, readsize);
+          if (readsize > asked[i])
+            {
+              ret = -EIO;
+              goto errout_with_lock;
+            }
 
-      /* Update the read state data */
+          /* Copy the read data into the user buffer */
 
-      filep->f_pos += readsize;
-      bytesread    += readsize;
-      buffer       += readsize;
+          memcpy(buffer, ptr, readsize);
 
-      /* Check if we hit the end of file */
+          /* Update the read state data */
 
-      if (tmp != 0)
-        {
-          break;
+          filep->f_pos += readsize;
+          bytesread    += readsize;
+          buffer       += readsize;
+
+          /* Check if we hit the end of file.  The data of the later calls
+           * of this batch does not follow on a short read, so they have to
+           * be sent again.
+           */
+
+          if (eof != 0 || readsize == 0)
+            {
+              goto errout_with_lock;
+            }
+
+          if (readsize < asked[i])
+            {
+              break;
+            }
         }
     }
 
@@ -1037,6 +1145,11 @@ errout_with_lock:
 /****************************************************************************
  * Name: nfs_write
  *
+ * Description:
+ *   Write in wsize chunks with up to CONFIG_NFS_IO_WINDOW WRITE calls in
+ *   flight.  A short reply ends the batch and the next batch starts where
+ *   the server stopped, rewriting the data of the later calls.
+ *
  * Returned Value:
  *   The (non-negative) number of bytes written on success; a negated errno
  *   value on failure.
@@ -1046,16 +1159,26 @@ errout_with_lock:
 static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
                          size_t buflen)
 {
+  struct rpcclnt_call  calls[CONFIG_NFS_IO_WINDOW];
+  size_t               asked[CONFIG_NFS_IO_WINDOW];
   FAR struct nfsmount *nmp;
   FAR struct nfsnode  *np;
+  FAR const char      *data;
   ssize_t              writesize;
   ssize_t              bufsize;
   ssize_t              byteswritten = 0;
   size_t               reqlen;
+  size_t               remaining;
+  off_t                offset;
   FAR uint32_t        *ptr;
   uint32_t             tmp;
-  int                  commit = 0;
-  int                  committed = NFSV3WRITE_FILESYNC;
+  int                  ncalls;
+  int                  i;
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+  int                  stable = NFSV3WRITE_UNSTABLE;
+#else
+  int                  stable = NFSV3WRITE_FILESYNC;
+#endif
   int                  ret;
 
   finfo("Write %zu bytes to offset %jd\n",
@@ -1090,132 +1213,174 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
 
   for (byteswritten = 0; byteswritten < buflen; )
     {
-      /* Make sure that the attempted write size does not exceed the RPC
-       * maximum.
-       */
+      offset    = filep->f_pos;
+      data      = buffer;
+      remaining = buflen - byteswritten;
 
-      writesize = buflen - byteswritten;
-      if (writesize > nmp->nm_wsize)
+      for (ncalls = 0; ncalls < CONFIG_NFS_IO_WINDOW && remaining > 0;
+           ncalls++)
         {
-          writesize = nmp->nm_wsize;
-        }
+          /* Make sure that the attempted write size does not exceed the RPC
+           * maximum.
+           */
 
-      /* Make sure that the attempted read size does not exceed the IO
-       * buffer size.
-       */
+          writesize = remaining;
+          if (writesize > nmp->nm_wsize)
+            {
+              writesize = nmp->nm_wsize;
+            }
 
-      bufsize = SIZEOF_rpc_call_write(writesize);
-      if (bufsize > nmp->nm_buflen)
-        {
-          writesize -= (bufsize - nmp->nm_buflen);
-        }
+          /* Make sure that the attempted read size does not exceed the IO
+           * buffer size.
+           */
 
-      /* Initialize the request.  Here we need an offset pointer to the write
-       * arguments, skipping over the RPC header.  Write is unique among the
-       * RPC calls in that the entry RPC calls message lies in the I/O buffer
-       */
+          bufsize = SIZEOF_rpc_call_write(writesize);
+          if (bufsize > nmp->nm_buflen)
+            {
+              writesize -= (bufsize - nmp->nm_buflen);
+            }
 
-      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
-                  nmp->nm_iobuffer)->write;
-      reqlen  = 0;
+          /* Initialize the request.  Here we need an offset pointer to the
+           * write arguments, skipping over the RPC header.  Write is unique
+           * among the RPC calls in that the entry RPC calls message lies in
+           * the I/O buffer
+           */
 
-      /* Copy the variable length, file handle */
+          ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
+                      nfs_iobuffer(nmp, ncalls))->write;
+          reqlen  = 0;
 
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
+          /* Copy the variable length, file handle */
 
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
+          *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+          reqlen += sizeof(uint32_t);
 
-      /* Copy the file offset */
+          memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+          reqlen += uint32_alignup(np->n_fhsize);
+          ptr    += uint32_increment(np->n_fhsize);
 
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr    += 2;
-      reqlen += 2*sizeof(uint32_t);
+          /* Copy the file offset */
 
-      /* Copy the count and stable values */
+          txdr_hyper((uint64_t)offset, ptr);
+          ptr    += 2;
+          reqlen += 2*sizeof(uint32_t);
 
-      *ptr++  = txdr_unsigned(writesize);
-      *ptr++  = txdr_unsigned(committed);
-      reqlen += 2*sizeof(uint32_t);
+          /* Copy the count and stable values */
 
-      /* Copy a chunk of the user data into the I/O buffer */
+          *ptr++  = txdr_unsigned(writesize);
+          *ptr++  = txdr_unsigned(stable);
+          reqlen += 2*sizeof(uint32_t);
 
-      *ptr++  = txdr_unsigned(writesize);
-      reqlen += sizeof(uint32_t);
-      memcpy(ptr, buffer, writesize);
-      reqlen += uint32_alignup(writesize);
+          /* Copy a chunk of the user data into the I/O buffer */
+
+          *ptr++  = txdr_unsigned(writesize);
+          reqlen += sizeof(uint32_t);
+          memcpy(ptr, data, writesize);
+          reqlen += uint32_alignup(writesize);
+
+          calls[ncalls].rq_request  = nfs_iobuffer(nmp, ncalls);
+          calls[ncalls].rq_reqlen   = reqlen;
+          calls[ncalls].rq_response = nfs_iomsg(nmp, ncalls);
+          calls[ncalls].rq_resplen  = sizeof(struct rpc_reply_write);
+          asked[ncalls]             = writesize;
+
+          offset    += writesize;
+          data      += writesize;
+          remaining -= writesize;
+          nfs_statistics(NFSPROC_WRITE);
+        }
 
-      /* Perform the write */
+      /* Perform the writes */
 
-      nfs_statistics(NFSPROC_WRITE);
-      ret = nfs_request(nmp, NFSPROC_WRITE,
-                        nmp->nm_iobuffer, reqlen,
-                        &nmp->nm_msgbuffer.write,
-                        sizeof(struct rpc_reply_write));
+      ret = nfs_request_multi(nmp, NFSPROC_WRITE, calls, ncalls);
       if (ret)
         {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
+          ferr("ERROR: nfs_request_multi failed: %d\n", ret);
           goto errout_with_lock;
         }
 
-      /* Get a pointer to the WRITE reply data */
+      for (i = 0; i < ncalls; i++)
+        {
+          ret = calls[i].rq_result;
+          if (ret)
+            {
+              ferr("ERROR: WRITE failed: %d\n", ret);
+              goto errout_with_lock;
+            }
 
-      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+          /* Get a pointer to the WRITE reply data */
 
-      /* Parse file_wcc.  First, check if WCC attributes follow. */
+          ptr = (FAR uint32_t *)
+            &((FAR struct rpc_reply_write *)calls[i].rq_response)->write;
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. WCC attributes follow.  But we just skip over them. */
+          /* Parse file_wcc.  First, check if WCC attributes follow. */
 
-          ptr += uint32_increment(sizeof(struct wcc_attr));
-        }
+          tmp = *ptr++;
+          if (tmp != 0)
+            {
+              /* Yes.. WCC attributes follow.  But we just skip over them. */
 
-      /* Check if normal file attributes follow */
+              ptr += uint32_increment(sizeof(struct wcc_attr));
+            }
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. Update the cached file status in the file structure. */
+          /* Check if normal file attributes follow */
 
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
+          tmp = *ptr++;
+          if (tmp != 0)
+            {
+              /* Yes.. Update the cached file status in the file structure. */
 
-      /* Get the count of bytes actually written */
+              nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+              ptr += uint32_increment(sizeof(struct nfs_fattr));
+            }
 
-      tmp = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
+          /* Get the count of bytes actually written */
 
-      if (tmp < 1 || tmp > writesize)
-        {
-          ret = -EIO;
-          goto errout_with_lock;
-        }
+          tmp = fxdr_unsigned(uint32_t, *ptr);
+          ptr++;
 
-      writesize = tmp;
+          if (tmp < 1 || tmp > asked[i])
+            {
+              ret = -EIO;
+              goto errout_with_lock;
+            }
 
-      /* Determine the lowest commitment level obtained by any of the RPCs. */
+          writesize = tmp;
 
-      commit = *ptr++;
-      if (committed == NFSV3WRITE_FILESYNC)
-        {
-          committed = commit;
-        }
-      else if (committed == NFSV3WRITE_DATASYNC &&
-               commit == NFSV3WRITE_UNSTABLE)
-        {
-          committed = commit;
-        }
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+          /* Data that the server did not commit to stable storage has to be
+           * committed later.  If the write verifier changed in between, the
+           * server has restarted and may have lost data written before.
+           */
 
-      /* Update the read state data */
+          tmp = fxdr_unsigned(uint32_t, *ptr);
+          ptr++;
 
-      filep->f_pos += writesize;
-      byteswritten += writesize;
-      buffer       += writesize;
+          if (tmp != NFSV3WRITE_FILESYNC)
+            {
+              if ((np->n_flags & (NFSNODE_UNSTABLE | NFSNODE_HAVEVERF)) ==
+                  (NFSNODE_UNSTABLE | NFSNODE_HAVEVERF) &&
+                  memcmp(np->n_verf, ptr, NFSX_V3WRITEVERF) != 0)
+                {
+                  np->n_flags |= NFSNODE_LOSTDATA;
+                }
+
+              memcpy(np->n_verf, ptr, NFSX_V3WRITEVERF);
+              np->n_flags |= NFSNODE_UNSTABLE | NFSNODE_HAVEVERF;
+            }
+#endif
+
+          /* Update the read state data */
+
+          filep->f_pos += writesize;
+          byteswritten += writesize;
+          buffer       += writesize;
+
+          if (writesize < asked[i])
+            {
+              break;
+            }
+        }
     }
 
 errout_with_lock:
@@ -1223,6 +1388,100 @@ errout_with_lock:
   return byteswritten > 0 ? byteswritten : ret;
 }
 
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+/****************************************************************************
+ * Name: nfs_commit
+ *
+ * Description:
+ *   Ask the server to flush the UNSTABLE writes of the file to stable
+ *   storage.
+ *
+ * Returned Value:
+ *   Zero on success; -EIO if the server lost some of the written data;
+ *   another negated errno value if the COMMIT failed.
+ *
+ * Assumptions:
+ *   The caller holds the mount lock.
+ *
+ ****************************************************************************/
+
+static int nfs_commit(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  FAR uint32_t *ptr;
+  uint32_t tmp;
+  size_t reqlen;
+  int ret;
+
+  if ((np->n_flags & NFSNODE_UNSTABLE) == 0)
+    {
+      return OK;
+    }
+
+  /* The COMMIT arguments have the same layout as the READ arguments:  The
+   * file handle followed by the offset and count of the range.  A count of
+   * zero commits everything from the offset on.
+   */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
+  reqlen  = 0;
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
+
+  txdr_hyper((uint64_t)0, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  *ptr    = 0;
+  reqlen += sizeof(uint32_t);
+
+  nfs_statistics(NFSPROC_COMMIT);
+  ret = nfs_request(nmp, NFSPROC_COMMIT,
+                    &nmp->nm_msgbuffer.read, reqlen,
+                    nmp->nm_iobuffer, nmp->nm_buflen);
+  if (ret)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
+
+  /* The reply is file_wcc followed by the write verifier */
+
+  ptr = (FAR uint32_t *)&((FAR struct rpc_reply_write *)
+                          nmp->nm_iobuffer)->write;
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  if (memcmp(np->n_verf, ptr, NFSX_V3WRITEVERF) != 0)
+    {
+      np->n_flags |= NFSNODE_LOSTDATA;
+    }
+
+  /* Report lost data once.  The data itself is not kept here, so it cannot
+   * be written again.
+   */
+
+  ret = (np->n_flags & NFSNODE_LOSTDATA) != 0 ? -EIO : OK;
+  np->n_flags &= ~(NFSNODE_UNSTABLE | NFSNODE_LOSTDATA);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: nfs_seek
  *
@@ -1298,7 +1557,34 @@ static off_t nfs_seek(FAR struct file *filep, off_t offset, int whence)
 
 static int nfs_sync(FAR struct file *filep)
 {
+#ifdef CONFIG_NFS_UNSTABLE_WRITES
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode  *np;
+  int ret;
+
+  /* Sanity checks */
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  /* Recover our private data from the struct file instance */
+
+  nmp = filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
+
+  DEBUGASSERT(nmp != NULL);
+
+  ret = nxmutex_lock(&nmp->nm_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = nfs_commit(nmp, np);
+  nxmutex_unlock(&nmp->nm_lock);
+  return ret;
+#else
   return 0;
+#endif
 }
 
 /****************************************************************************
@@ -2088,9 +2374,15 @@ static int nfs_bind(FAR struct inode *blkdriver, FAR const void *data,
       buflen = MIN_UDP_MSS;
     }
 
+  /* Each call in flight has its own I/O buffer.  Keep them aligned to
+   * 32-bit boundaries.
+   */
+
+  buflen &= ~3;
+
   /* Create an instance of the mountpt state structure */
 
-  nmp = fs_heap_zalloc(SIZEOF_nfsmount(buflen));
+  nmp = fs_heap_zalloc(SIZEOF_nfsmount(buflen * CONFIG_NFS_IO_WINDOW));
   if (!nmp)
     {
       ferr("ERROR: Failed to allocate mountpoint structure\n");
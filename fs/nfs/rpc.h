@@ -462,6 +462,20 @@ struct rpcclnt
   uint32_t  rc_xid;           /* Transaction id */
 };
 
+/* One call of a batch that is sent with rpcclnt_request_multi().  The
+ * request starts with space for the RPC call header.
+ */
+
+struct rpcclnt_call
+{
+  FAR void *rq_request;       /* Call message */
+  size_t    rq_reqlen;        /* Length of the message after the header */
+  FAR void *rq_response;      /* Buffer for the reply message */
+  size_t    rq_resplen;       /* Size of the reply buffer */
+  uint32_t  rq_xid;           /* Transaction id of the call */
+  int       rq_result;        /* RPC level result of the call */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -472,5 +486,8 @@ void rpcclnt_disconnect(FAR struct rpcclnt *rpc);
 int  rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
                      int version, FAR void *request, size_t reqlen,
                      FAR void *response, size_t resplen);
+int  rpcclnt_request_multi(FAR struct rpcclnt *rpc, int procnum, int prog,
+                           int version, FAR struct rpcclnt_call *calls,
+                           int ncalls);
 
 #endif /* __FS_NFS_RPC_H */
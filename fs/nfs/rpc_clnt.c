@@ -79,6 +79,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <netinet/in.h>
@@ -149,8 +150,6 @@ static int rpcclnt_send(FAR struct rpcclnt *rpc,
                         FAR void *call, int reqlen);
 static int rpcclnt_receive(FAR struct rpcclnt *rpc,
                            FAR void *reply, size_t resplen);
-static int rpcclnt_reply(FAR struct rpcclnt *rpc, uint32_t xid,
-                         FAR void *reply, size_t resplen);
 static void rpcclnt_fmtheader(FAR struct rpc_call_header *ch,
                               uint32_t xid, int procid, int prog, int vers);
 
@@ -420,53 +419,6 @@ static int rpcclnt_receive(FAR struct rpcclnt *rpc,
   return OK;
 }
 
-/****************************************************************************
- * Name: rpcclnt_reply
- *
- * Description:
- *   Received the RPC reply on the socket.
- *
- ****************************************************************************/
-
-static int rpcclnt_reply(FAR struct rpcclnt *rpc, uint32_t xid,
-                         FAR void *reply, size_t resplen)
-{
-  int error;
-
-retry:
-
-  /* Get the next RPC reply from the socket */
-
-  error = rpcclnt_receive(rpc, reply, resplen);
-  if (error != 0)
-    {
-      ferr("ERROR: rpcclnt_receive returned: %d\n", error);
-    }
-
-  /* Get the xid and check that it is an RPC replysvr */
-
-  else
-    {
-      FAR struct rpc_reply_header *replyheader =
-        (FAR struct rpc_reply_header *)reply;
-
-      if (replyheader->rp_direction != rpc_reply)
-        {
-          ferr("ERROR: Different RPC REPLY returned\n");
-          rpc_statistics(rpcinvalid);
-          error = -EPROTO;
-        }
-      else if (replyheader->rp_xid != txdr_unsigned(xid))
-        {
-          ferr("ERROR: Different RPC XID returned\n");
-          rpc_statistics(rpcinvalid);
-          goto retry;
-        }
-    }
-
-  return error;
-}
-
 /****************************************************************************
  * Name: rpcclnt_fmtheader
  *
@@ -504,6 +456,43 @@ static void rpcclnt_fmtheader(FAR struct rpc_call_header *ch,
   ch->rpc_verf.authlen   = 0;
 }
 
+/****************************************************************************
+ * Name: rpcclnt_checkreply
+ *
+ * Description:
+ *   Verify the RPC level of a received reply message.
+ *
+ ****************************************************************************/
+
+static int rpcclnt_checkreply(FAR void *response)
+{
+  FAR struct rpc_reply_header *replymsg;
+  uint32_t tmp;
+
+  /* Break down the RPC header and check if it is OK */
+
+  replymsg = (FAR struct rpc_reply_header *)response;
+
+  tmp = fxdr_unsigned(uint32_t, replymsg->type);
+  if (tmp != RPC_MSGACCEPTED)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  tmp = fxdr_unsigned(uint32_t, replymsg->status);
+  if (tmp == RPC_SUCCESS)
+    {
+      finfo("RPC_SUCCESS\n");
+    }
+  else
+    {
+      ferr("ERROR: Unsupported RPC type: %" PRId32 "\n", tmp);
+      return -EOPNOTSUPP;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -752,9 +741,9 @@ bad:
  *
  * Description:
  *   Perform the RPC request.  Logic formats the RPC CALL message and calls
- *   rpcclnt_send to send the RPC CALL message.  It then calls
- *   rpcclnt_reply() to get the response.  It may attempt to re-send the
- *   CALL message on certain errors.
+ *   rpcclnt_send to send the RPC CALL message.  It then waits for the
+ *   response.  It may attempt to re-send the CALL message on certain
+ *   errors.
  *
  *   On successful receipt, it verifies the RPC level of the returned values.
  *   (There may still be be NFS layer errors that will be detected by calling
@@ -766,59 +755,149 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
                     int version, FAR void *request, size_t reqlen,
                     FAR void *response, size_t resplen)
 {
-  FAR struct rpc_reply_header *replymsg;
-  uint32_t tmp;
-  uint32_t xid;
-  int retries = 0;
-  int error = 0;
+  struct rpcclnt_call call;
+  int error;
 
-  /* Get a new (non-zero) xid */
+  call.rq_request  = request;
+  call.rq_reqlen   = reqlen;
+  call.rq_response = response;
+  call.rq_resplen  = resplen;
 
-  xid = ++rpc->rc_xid;
+  error = rpcclnt_request_multi(rpc, procnum, prog, version, &call, 1);
+  return error != OK ? error : call.rq_result;
+}
 
-  /* Initialize the RPC header fields */
+/****************************************************************************
+ * Name: rpcclnt_request_multi
+ *
+ * Description:
+ *   Send a batch of CALL messages for the same procedure without waiting
+ *   for the replies in between, then collect the replies in whatever order
+ *   the server sends them.  Each call gets its own xid; a reply is matched
+ *   to its call by that xid and replies to unknown xids are discarded.  On
+ *   a response timeout, every call that is still unanswered is sent again.
+ *
+ *   A reply is first received into the buffer of the oldest unanswered call
+ *   and copied if it belongs to another one, so all reply buffers of a
+ *   batch should have the same size.
+ *
+ * Returned Value:
+ *   Zero if a reply was received for every call, in which case rq_result
+ *   of each call holds the RPC level status of its reply.  Otherwise, a
+ *   negated errno value of the transport failure.
+ *
+ ****************************************************************************/
 
-  rpcclnt_fmtheader((FAR struct rpc_call_header *)request,
-                    xid, prog, version, procnum);
+int rpcclnt_request_multi(FAR struct rpcclnt *rpc, int procnum, int prog,
+                          int version, FAR struct rpcclnt_call *calls,
+                          int ncalls)
+{
+  FAR struct rpc_reply_header *replyheader;
+  FAR struct rpcclnt_call *first;
+  FAR struct rpcclnt_call *call;
+  int pending = ncalls;
+  int retries = 0;
+  int error = OK;
+  int i;
 
-  /* Get the full size of the message (the size of variable data plus the
-   * size of the messages header).
-   */
+  /* Give every call a new (non-zero) xid and initialize its header */
 
-  reqlen += sizeof(struct rpc_call_header);
+  for (i = 0; i < ncalls; i++)
+    {
+      calls[i].rq_xid    = ++rpc->rc_xid;
+      calls[i].rq_result = -EINPROGRESS;
+      rpcclnt_fmtheader((FAR struct rpc_call_header *)calls[i].rq_request,
+                        calls[i].rq_xid, prog, version, procnum);
+    }
 
-  /* Send the RPC call messages and receive the RPC response.  A limited
+  /* Send the RPC call messages and receive the RPC responses.  A limited
    * number of re-tries will be attempted, but only for the case of response
    * timeouts.
    */
 
   for (; ; )
     {
-      /* Do the client side RPC. */
-
-      rpc_statistics(rpcrequests);
+      /* Send every CALL message that has not been answered yet */
 
-      /* Send the RPC CALL message */
-
-      error = rpcclnt_send(rpc, request, reqlen);
-      if (error != OK)
+      for (i = 0; i < ncalls && error == OK; i++)
         {
-          finfo("ERROR rpcclnt_send failed: %d\n", error);
+          if (calls[i].rq_result == -EINPROGRESS)
+            {
+              rpc_statistics(rpcrequests);
+
+              /* The full size of the message is the size of variable data
+               * plus the size of the messages header.
+               */
+
+              error = rpcclnt_send(rpc, calls[i].rq_request,
+                                   calls[i].rq_reqlen +
+                                   sizeof(struct rpc_call_header));
+              if (error != OK)
+                {
+                  finfo("ERROR rpcclnt_send failed: %d\n", error);
+                }
+            }
         }
 
-      /* Wait for the reply from our send */
+      /* Wait for the replies to our sends */
 
-      else
+      while (error == OK && pending > 0)
         {
-          error = rpcclnt_reply(rpc, xid, response, resplen);
+          first = calls;
+          while (first->rq_result != -EINPROGRESS)
+            {
+              first++;
+            }
+
+          error = rpcclnt_receive(rpc, first->rq_response,
+                                  first->rq_resplen);
           if (error != OK)
             {
-              finfo("ERROR rpcclnt_reply failed: %d\n", error);
+              finfo("ERROR rpcclnt_receive failed: %d\n", error);
+              break;
             }
+
+          /* Get the xid and check that it is an RPC replysvr */
+
+          replyheader = (FAR struct rpc_reply_header *)first->rq_response;
+          if (replyheader->rp_direction != rpc_reply)
+            {
+              ferr("ERROR: Different RPC REPLY returned\n");
+              rpc_statistics(rpcinvalid);
+              error = -EPROTO;
+              break;
+            }
+
+          for (call = first; call < calls + ncalls; call++)
+            {
+              if (call->rq_result == -EINPROGRESS &&
+                  replyheader->rp_xid == txdr_unsigned(call->rq_xid))
+                {
+                  break;
+                }
+            }
+
+          if (call == calls + ncalls)
+            {
+              /* Probably the late reply to a call that was re-sent */
+
+              ferr("ERROR: Different RPC XID returned\n");
+              rpc_statistics(rpcinvalid);
+              continue;
+            }
+
+          if (call != first)
+            {
+              memcpy(call->rq_response, first->rq_response,
+                     MIN(call->rq_resplen, first->rq_resplen));
+            }
+
+          call->rq_result = rpcclnt_checkreply(call->rq_response);
+          pending--;
         }
 
       /* If we failed because of a timeout, then try sending the CALL
-       * message again.
+       * messages again.
        */
 
       if (error != -EAGAIN && error != -ETIMEDOUT)
@@ -833,34 +912,13 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
         }
 
       rpc_statistics(rpcretries);
+      error = OK;
     }
 
   if (error != OK)
     {
       ferr("ERROR: RPC failed: %d\n", error);
-      return error;
     }
 
-  /* Break down the RPC header and check if it is OK */
-
-  replymsg = (FAR struct rpc_reply_header *)response;
-
-  tmp = fxdr_unsigned(uint32_t, replymsg->type);
-  if (tmp != RPC_MSGACCEPTED)
-    {
-      return -EOPNOTSUPP;
-    }
-
-  tmp = fxdr_unsigned(uint32_t, replymsg->status);
-  if (tmp == RPC_SUCCESS)
-    {
-      finfo("RPC_SUCCESS\n");
-    }
-  else
-    {
-      ferr("ERROR: Unsupported RPC type: %" PRId32 "\n", tmp);
-      return -EOPNOTSUPP;
-    }
-
-  return OK;
+  return error;
 }
@@ -64,8 +64,10 @@ extern const struct procfs_operations g_fdt_operations;
 extern const struct procfs_operations g_iobinfo_operations;
 extern const struct procfs_operations g_irq_operations;
 extern const struct procfs_operations g_meminfo_operations;
+extern const struct procfs_operations g_membench_operations;
 extern const struct procfs_operations g_memdump_operations;
 extern const struct procfs_operations g_mempool_operations;
+extern const struct procfs_operations g_memsample_operations;
 extern const struct procfs_operations g_module_operations;
 extern const struct procfs_operations g_pm_operations;
 extern const struct procfs_operations g_proc_operations;
@@ -74,6 +76,9 @@ extern const struct procfs_operations g_thermal_operations;
 extern const struct procfs_operations g_uptime_operations;
 extern const struct procfs_operations g_version_operations;
 extern const struct procfs_operations g_pressure_operations;
+extern const struct procfs_operations g_sampler_operations;
+extern const struct procfs_operations g_schedbench_operations;
+extern const struct procfs_operations g_snapshot_operations;
 
 /* This is not good.  These are implemented in other sub-systems.  Having to
  * deal with them here is not a good coupling. What is really needed is a
@@ -149,6 +154,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "irqs",         &g_irq_operations,      PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_MM_BENCH) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
+  { "membench",     &g_membench_operations, PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMINFO
 #  ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMDUMP
   { "memdump",      &g_memdump_operations,  PROCFS_FILE_TYPE   },
@@ -160,6 +169,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "mempool",      &g_mempool_operations,  PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_MM_HEAP_SAMPLE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
+  { "memsample",    &g_memsample_operations, PROCFS_FILE_TYPE  },
+#endif
+
 #if defined(CONFIG_MODULE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
   { "modules",      &g_module_operations,   PROCFS_FILE_TYPE   },
 #endif
@@ -187,11 +200,23 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "pressure/**",  &g_pressure_operations, PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_SCHED_SAMPLER
+  { "sampler",      &g_sampler_operations,  PROCFS_FILE_TYPE   },
+#endif
+
+#ifdef CONFIG_SCHED_BENCH
+  { "schedbench",   &g_schedbench_operations, PROCFS_FILE_TYPE },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_PROCESS
   { "self",         &g_proc_operations,     PROCFS_DIR_TYPE    },
   { "self/**",      &g_proc_operations,     PROCFS_UNKOWN_TYPE },
 #endif
 
+#ifdef CONFIG_FS_PROCFS_INCLUDE_SNAPSHOT
+  { "snapshot",     &g_snapshot_operations, PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_ARCH_HAVE_TCBINFO) && !defined(CONFIG_FS_PROCFS_EXCLUDE_TCBINFO)
   { "tcbinfo",      &g_tcbinfo_operations,  PROCFS_FILE_TYPE   },
 #endif
@@ -555,9 +580,21 @@ static int procfs_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
 static int procfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
+  FAR struct procfs_file_s *handler;
+
   finfo("cmd: %d arg: %08lx\n", cmd, arg);
 
-  /* No IOCTL commands supported */
+  /* Recover our private data from the struct file instance */
+
+  handler = (FAR struct procfs_file_s *)filep->f_priv;
+  DEBUGASSERT(handler);
+
+  /* Call the handler's ioctl routine */
+
+  if (handler->procfsentry->ops->ioctl)
+    {
+      return handler->procfsentry->ops->ioctl(filep, cmd, arg);
+    }
 
   return -ENOTTY;
 }
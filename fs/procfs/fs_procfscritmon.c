@@ -39,11 +39,13 @@
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
+#include <inttypes.h>
 
 #include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
+#include <nuttx/irq.h>
 #include <nuttx/sched.h>
 
 #include "fs_heap.h"
@@ -88,6 +90,10 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
 static int     critmon_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     critmon_stat(FAR const char *relpath, FAR struct stat *buf);
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static int     critmon_ioctl(FAR struct file *filep, int cmd,
+                 unsigned long arg);
+#endif
 
 /****************************************************************************
  * Public Data
@@ -113,7 +119,13 @@ const struct procfs_operations g_critmon_operations =
   NULL,              /* readdir */
   NULL,              /* rewinddir */
 
-  critmon_stat        /* stat */
+  critmon_stat,       /* stat */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  critmon_ioctl       /* ioctl */
+#else
+  NULL                /* ioctl */
+#endif
 };
 
 /****************************************************************************
@@ -287,6 +299,69 @@ static ssize_t critmon_read_cpu(FAR struct critmon_file_s *attr,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: critmon_read_hist
+ *
+ * Description:
+ *   Output the non-empty buckets of one histogram as "upper bound:count"
+ *   pairs, the upper bound of bucket N being 2^N performance counter
+ *   cycles.  The last bucket also counts all of the longer intervals.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static ssize_t critmon_read_hist(FAR struct critmon_file_s *attr,
+                                 FAR char *buffer, size_t buflen,
+                                 FAR off_t *offset, int cpu,
+                                 FAR const char *name,
+                                 FAR const uint32_t *hist)
+{
+  struct timespec upper;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  int i;
+
+  linesize = procfs_snprintf(attr->line, CRITMON_LINELEN, "%d,%s",
+                             cpu, name);
+  copysize = procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+
+  totalsize = copysize;
+  buffer   += copysize;
+  buflen   -= copysize;
+
+  for (i = 0; i < CRITMON_HIST_NBUCKETS && buflen > 0; i++)
+    {
+      if (hist[i] == 0)
+        {
+          continue;
+        }
+
+      perf_convert((clock_t)1 << i, &upper);
+
+      linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                                 ",%lu.%09lu:%" PRIu32,
+                                 (unsigned long)upper.tv_sec,
+                                 (unsigned long)upper.tv_nsec, hist[i]);
+      copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                               offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+    }
+
+  if (buflen > 0)
+    {
+      linesize = procfs_snprintf(attr->line, CRITMON_LINELEN, "\n");
+      totalsize += procfs_memcpy(attr->line, linesize, buffer, buflen,
+                                 offset);
+    }
+
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: critmon_read
  ****************************************************************************/
@@ -323,6 +398,24 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  /* Then the histograms of each CPU */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS && ret < buflen; cpu++)
+    {
+      ret += critmon_read_hist(attr, buffer + ret, buflen - ret, &offset,
+                               cpu, "wakeup", g_wakeup_hist[cpu]);
+#  if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
+      ret += critmon_read_hist(attr, buffer + ret, buflen - ret, &offset,
+                               cpu, "preemption", g_preemp_hist[cpu]);
+#  endif
+#  if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0
+      ret += critmon_read_hist(attr, buffer + ret, buflen - ret, &offset,
+                               cpu, "csection", g_crit_hist[cpu]);
+#  endif
+    }
+#endif
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -386,6 +479,41 @@ static int critmon_stat(const char *relpath, struct stat *buf)
   return OK;
 }
 
+/****************************************************************************
+ * Name: critmon_ioctl
+ *
+ * Description:
+ *   PROCFSIOC_RESET clears the histograms and the maximum values.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static int critmon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  irqstate_t flags;
+
+  if (cmd != PROCFSIOC_RESET)
+    {
+      return -ENOTTY;
+    }
+
+  flags = enter_critical_section();
+
+  memset(g_wakeup_hist, 0, sizeof(g_wakeup_hist));
+#  if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
+  memset(g_preemp_hist, 0, sizeof(g_preemp_hist));
+  memset(g_preemp_max, 0, sizeof(g_preemp_max));
+#  endif
+#  if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0
+  memset(g_crit_hist, 0, sizeof(g_crit_hist));
+  memset(g_crit_max, 0, sizeof(g_crit_max));
+#  endif
+
+  leave_critical_section(flags);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -187,6 +187,9 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
   size_t copysize;
   size_t totalsize;
   off_t offset;
+#if CONFIG_IOB_CACHE > 0
+  int cpu;
+#endif
 
   finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
 
@@ -223,6 +226,33 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
                              &offset);
   totalsize += copysize;
 
+#if CONFIG_IOB_CACHE > 0
+  /* Then the per-CPU caches, which are included in nfree above */
+
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                               "%10s%10s%10s\n",
+                               "cpu", "ncached", "nhits");
+  copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                                   "%10d%10d%10lu\n", cpu,
+                                   stats.ncached[cpu], stats.nhits[cpu]);
+      copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
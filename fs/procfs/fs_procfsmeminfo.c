@@ -29,6 +29,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -106,6 +107,16 @@ static ssize_t memdump_read(FAR struct file *filep, FAR char *buffer,
 static ssize_t memdump_write(FAR struct file *filep, FAR const char *buffer,
                              size_t buflen);
 #endif
+#ifdef CONFIG_MM_HEAP_SAMPLE
+static ssize_t memsample_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen);
+#endif
+#ifdef CONFIG_MM_BENCH
+static ssize_t membench_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen);
+static ssize_t membench_write(FAR struct file *filep,
+                              FAR const char *buffer, size_t buflen);
+#endif
 static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
 static int     meminfo_dup(FAR const struct file *oldp,
@@ -153,6 +164,40 @@ const struct procfs_operations g_memdump_operations =
 };
 #endif
 
+#ifdef CONFIG_MM_HEAP_SAMPLE
+const struct procfs_operations g_memsample_operations =
+{
+  meminfo_open,   /* open */
+  meminfo_close,  /* close */
+  memsample_read, /* read */
+  NULL,           /* write */
+  NULL,           /* poll */
+  meminfo_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  meminfo_stat    /* stat */
+};
+#endif
+
+#ifdef CONFIG_MM_BENCH
+const struct procfs_operations g_membench_operations =
+{
+  meminfo_open,   /* open */
+  meminfo_close,  /* close */
+  membench_read,  /* read */
+  membench_write, /* write */
+  NULL,           /* poll */
+  meminfo_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  meminfo_stat    /* stat */
+};
+#endif
+
 static FAR struct procfs_meminfo_entry_s *g_procfs_meminfo = NULL;
 
 /****************************************************************************
@@ -342,6 +387,39 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
           copysize   = procfs_memcpy(procfile->line, linesize, buffer,
                                      buflen, &offset);
           totalsize += copysize;
+
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+          /* Followed by the usage of each region of the heap */
+
+          unsigned int flags;
+          int region;
+
+          for (region = 0;
+               buflen > copysize &&
+               mm_mallinfo_region(entry->heap, region, &info, &flags) >= 0;
+               region++)
+            {
+              buffer    += copysize;
+              buflen    -= copysize;
+
+              linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                           "%11lu%11lu%11lu%11s%11lu"
+                                           "%7lu%7lu %s.%d%s\n",
+                                           (unsigned long)info.arena,
+                                           (unsigned long)info.uordblks,
+                                           (unsigned long)info.fordblks,
+                                           "",
+                                           (unsigned long)info.mxordblk,
+                                           (unsigned long)info.aordblks,
+                                           (unsigned long)info.ordblks,
+                                           entry->name, region,
+                                           (flags & MM_REGION_FAST) ?
+                                           " fast" : "");
+              copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                         buflen, &offset);
+              totalsize += copysize;
+            }
+#endif
         }
     }
 
@@ -409,6 +487,196 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: memsample_read
+ *
+ * Description:
+ *   Show the sampled allocations by call site in the legacy pprof heap
+ *   profile format, which "pprof --symbols" can resolve against the ELF
+ *   image.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_SAMPLE
+static ssize_t memsample_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct meminfo_file_s *procfile;
+  struct mm_sample_site_s site;
+  size_t inuse_count = 0;
+  size_t inuse_bytes = 0;
+  size_t alloc_count = 0;
+  size_t alloc_bytes = 0;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int i;
+  int j;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct meminfo_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* The first line holds the totals */
+
+  for (i = 0; mm_sample_site(i, &site) >= 0; i++)
+    {
+      inuse_count += site.inuse_count;
+      inuse_bytes += site.inuse_bytes;
+      alloc_count += site.alloc_count;
+      alloc_bytes += site.alloc_bytes;
+    }
+
+  linesize  = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                              "heap profile: %zu: %zu [%zu: %zu] "
+                              "@ heap_v2/%d\n",
+                              inuse_count, inuse_bytes,
+                              alloc_count, alloc_bytes,
+                              CONFIG_MM_HEAP_SAMPLE_INTERVAL);
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  /* Followed by one line per call site */
+
+  for (i = 0; buflen > 0 && mm_sample_site(i, &site) >= 0; i++)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%zu: %zu [%zu: %zu] @",
+                                   site.inuse_count, site.inuse_bytes,
+                                   site.alloc_count, site.alloc_bytes);
+
+      for (j = 0; j < CONFIG_MM_HEAP_SAMPLE_DEPTH &&
+                  site.backtrace[j] != NULL; j++)
+        {
+          linesize += procfs_snprintf(procfile->line + linesize,
+                                      MEMINFO_LINELEN - linesize,
+                                      " %p", site.backtrace[j]);
+        }
+
+      linesize  += procfs_snprintf(procfile->line + linesize,
+                                   MEMINFO_LINELEN - linesize, "\n");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: membench_read
+ *
+ * Description:
+ *   Show the results of the last allocator benchmark runs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_BENCH
+static ssize_t membench_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct meminfo_file_s *procfile;
+  struct mm_bench_result_s result;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct meminfo_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* The first line is the headers */
+
+  linesize  = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                              "%-28s%4s%10s%8s%11s%9s%9s%9s%7s\n",
+                              "name", "thr", "ops", "fail", "ops/s",
+                              "p50(ns)", "p99(ns)", "max(ns)", "frag%");
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  /* Followed by one line per run */
+
+  for (i = 0; buflen > 0 && mm_bench_result(i, &result) >= 0; i++)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "%-28s%4u%10zu%8zu%11" PRIu32
+                                   "%9" PRIu32 "%9" PRIu32 "%9" PRIu32
+                                   "%5u.%u\n",
+                                   result.name, result.nthreads,
+                                   result.nops, result.nfail,
+                                   result.opsps, result.p50, result.p99,
+                                   result.max, result.frag / 10,
+                                   result.frag % 10);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: membench_write
+ *
+ * Description:
+ *   Run one allocator benchmark, see mm_bench_run() for the syntax, e.g.
+ *   "echo churn mempool mixed 100000 2 > /proc/membench".
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_BENCH
+static ssize_t membench_write(FAR struct file *filep,
+                              FAR const char *buffer, size_t buflen)
+{
+  char cmd[MEMINFO_LINELEN];
+  int ret;
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+
+  if (buflen >= sizeof(cmd))
+    {
+      return -E2BIG;
+    }
+
+  memcpy(cmd, buffer, buflen);
+  cmd[buflen] = '\0';
+
+  ret = mm_bench_run(cmd);
+  return ret < 0 ? ret : buflen;
+}
+#endif
+
 /****************************************************************************
  * Name: memdump_read
  ****************************************************************************/
@@ -437,6 +705,9 @@ static ssize_t memdump_read(FAR struct file *filep, FAR char *buffer,
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD > 0
                  "/mempool"
 #endif
+#ifdef CONFIG_MM_HEAP_MEMPOOL_PROFILE
+                 "/profile"
+#endif
 #if CONFIG_MM_HEAP_BIGGEST_COUNT > 0
                   "/biggest"
 #endif
@@ -453,6 +724,9 @@ static ssize_t memdump_read(FAR struct file *filep, FAR char *buffer,
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD > 0
                  "mempool: dump all mempool alloc node\n"
 #endif
+#ifdef CONFIG_MM_HEAP_MEMPOOL_PROFILE
+                 "profile: suggest mempool block sizes\n"
+#endif
 #if CONFIG_MM_HEAP_BIGGEST_COUNT > 0
                   "biggest: dump allocated top n node\n"
 #endif
@@ -606,6 +880,12 @@ static ssize_t memdump_write(FAR struct file *filep, FAR const char *buffer,
         break;
 #endif
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_PROFILE
+      case 'p':
+        dump.pid = PID_MM_PROFILE;
+        break;
+#endif
+
       case 'o':
         dump.pid = PID_MM_ORPHAN;
 #  if CONFIG_MM_BACKTRACE >= 0
@@ -753,4 +1033,31 @@ void procfs_unregister_meminfo(FAR struct procfs_meminfo_entry_s *entry)
         }
     }
 }
+
+/****************************************************************************
+ * Name: procfs_meminfo_foreach
+ *
+ * Description:
+ *   Call 'handler' with the name and the statistics of every heap that is
+ *   registered with procfs_register_meminfo().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PROCFS_INCLUDE_SNAPSHOT
+void procfs_meminfo_foreach(procfs_meminfo_handler_t handler,
+                            FAR void *arg)
+{
+  FAR const struct procfs_meminfo_entry_s *entry;
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      struct mallinfo info;
+
+      mm_free_delaylist(entry->heap);
+      info = mm_mallinfo(entry->heap);
+      handler(entry->name, &info, arg);
+    }
+}
+#endif
+
 #endif /* !CONFIG_FS_PROCFS_EXCLUDE_MEMINFO */
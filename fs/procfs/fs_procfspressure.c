@@ -49,6 +49,7 @@ struct pressure_file_s
   struct procfs_file_s base;        /* Base open file structure */
   dq_entry_t entry;                 /* Supports a linked list */
   FAR struct pollfd *fds;           /* Polling structure of waiting thread */
+  bool remaining;                   /* Watch the free memory, not largest */
   size_t threshold;                 /* Memory notification threshold */
   clock_t lasttick;                 /* Last time notified */
   clock_t interval;                 /* Notification interval in us */
@@ -109,6 +110,20 @@ const struct procfs_operations g_pressure_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: pressure_below
+ *
+ * Description:
+ *   Return true if the watched value of "priv" is at or below its
+ *   threshold.  The caller holds g_pressure_lock.
+ *
+ ****************************************************************************/
+
+static bool pressure_below(FAR struct pressure_file_s *priv)
+{
+  return (priv->remaining ? g_remaining : g_largest) <= priv->threshold;
+}
+
 /****************************************************************************
  * Name: pressure_open
  ****************************************************************************/
@@ -201,12 +216,28 @@ static ssize_t pressure_write(FAR struct file *filep, FAR const char *buffer,
   size_t threshold;
   clock_t interval;
   uint32_t flags;
+  bool remaining;
 
   if (buffer == NULL)
     {
       return -EINVAL;
     }
 
+  /* An optional "remaining" or "largest" keyword selects the watched
+   * value, the largest free chunk is watched by default.
+   */
+
+  remaining = false;
+  if (strncmp(buffer, "remaining", 9) == 0)
+    {
+      remaining = true;
+      buffer += 9;
+    }
+  else if (strncmp(buffer, "largest", 7) == 0)
+    {
+      buffer += 7;
+    }
+
   threshold = strtoul(buffer, &endptr, 0);
   if (threshold == 0)
     {
@@ -231,6 +262,7 @@ static ssize_t pressure_write(FAR struct file *filep, FAR const char *buffer,
   /* We should trigger the first event immediately */
 
   priv->lasttick  = CLOCK_MAX;
+  priv->remaining = remaining;
   priv->threshold = threshold;
   priv->interval  = interval;
   spin_unlock_irqrestore(&g_pressure_lock, flags);
@@ -261,7 +293,7 @@ static int pressure_poll(FAR struct file *filep, FAR struct pollfd *fds,
            * the first time and we should always send a notification.
            */
 
-          if (g_remaining <= priv->threshold && (priv->lasttick ==
+          if (pressure_below(priv) && (priv->lasttick ==
               CLOCK_MAX || current - priv->lasttick >= priv->interval))
             {
               priv->lasttick = current;
@@ -434,11 +466,11 @@ void mm_notify_pressure(size_t remaining, size_t largest)
       FAR struct pressure_file_s *pressure =
           container_of(entry, struct pressure_file_s, entry);
 
-      /* If the largest available block is less than the threshold,
-       * send a notification
+      /* If the watched value is less than the threshold, send a
+       * notification
        */
 
-      if (largest > pressure->threshold)
+      if (!pressure_below(pressure))
         {
           continue;
         }
@@ -42,7 +42,7 @@
 #include <malloc.h>
 #include <execinfo.h>
 
-#ifdef CONFIG_SCHED_CRITMONITOR
+#if defined(CONFIG_SCHED_CRITMONITOR) || defined(CONFIG_SCHED_ACCOUNTING)
 #  include <time.h>
 #endif
 
@@ -63,7 +63,8 @@
 
 #include "fs_heap.h"
 
-#if !defined(CONFIG_SCHED_CPULOAD_NONE) || defined(CONFIG_SCHED_CRITMONITOR)
+#if !defined(CONFIG_SCHED_CPULOAD_NONE) || \
+    defined(CONFIG_SCHED_CRITMONITOR) || defined(CONFIG_SCHED_ACCOUNTING)
 #  include <nuttx/clock.h>
 #endif
 
@@ -99,6 +100,9 @@ enum proc_node_e
 #ifdef CONFIG_SCHED_CRITMONITOR
   PROC_CRITMON,                       /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_ACCOUNTING
+  PROC_SCHEDSTAT,                     /* Run time accounting */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   PROC_HEAP,                          /* Task heap info */
 #endif
@@ -190,6 +194,11 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#ifdef CONFIG_SCHED_ACCOUNTING
+static ssize_t proc_schedstat(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
 static ssize_t proc_heap(FAR struct proc_file_s *procfile,
                          FAR struct tcb_s *tcb, FAR char *buffer,
@@ -302,6 +311,13 @@ static const struct proc_node_s g_critmon =
 };
 #endif
 
+#ifdef CONFIG_SCHED_ACCOUNTING
+static const struct proc_node_s g_schedstat =
+{
+  "schedstat",    "schedstat", (uint8_t)PROC_SCHEDSTAT,  DTYPE_FILE        /* Run time accounting */
+};
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static const struct proc_node_s g_heap =
 {
@@ -356,6 +372,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section Monitor */
 #endif
+#ifdef CONFIG_SCHED_ACCOUNTING
+  &g_schedstat,    /* Run time accounting */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -385,6 +404,9 @@ static const struct proc_node_s * const g_level0info[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_ACCOUNTING
+  &g_schedstat,    /* Run time accounting */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -880,6 +902,47 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_schedstat
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_ACCOUNTING
+static ssize_t proc_schedstat(FAR struct proc_file_s *procfile,
+                              FAR struct tcb_s *tcb, FAR char *buffer,
+                              size_t buflen, off_t offset)
+{
+  struct timespec runtime;
+  struct timespec waittime;
+  clock_t elapsed;
+  size_t linesize;
+
+  /* Include the slice a running thread has not been charged for yet */
+
+  elapsed = tcb->acct_runtime;
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      elapsed += perf_gettime() - tcb->acct_start;
+    }
+
+  perf_convert(elapsed, &runtime);
+  perf_convert(tcb->acct_waittime, &waittime);
+
+  /* Output the total run time, the total wait time, the number of
+   * voluntary switches and the number of involuntary switches
+   */
+
+  linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                             "%lu.%09lu %lu.%09lu %" PRIu32 " %" PRIu32 "\n",
+                             (unsigned long)runtime.tv_sec,
+                             (unsigned long)runtime.tv_nsec,
+                             (unsigned long)waittime.tv_sec,
+                             (unsigned long)waittime.tv_nsec,
+                             tcb->acct_nvcsw, tcb->acct_nivcsw);
+
+  return procfs_memcpy(procfile->line, linesize, buffer, buflen, &offset);
+}
+#endif
+
 /****************************************************************************
  * Name: proc_heap
  ****************************************************************************/
@@ -1628,6 +1691,11 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_critmon(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 #endif
+#ifdef CONFIG_SCHED_ACCOUNTING
+    case PROC_SCHEDSTAT: /* Run time accounting */
+      ret = proc_schedstat(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
     case PROC_HEAP: /* Task heap info */
       ret = proc_heap(procfile, tcb, buffer, buflen, filep->f_pos);
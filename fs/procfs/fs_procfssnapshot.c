@@ -0,0 +1,544 @@
+/****************************************************************************
+ * fs/procfs/fs_procfssnapshot.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+#include <malloc.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/mempool.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifdef CONFIG_FS_PROCFS_INCLUDE_SNAPSHOT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Room for threads, heaps and pools created while the snapshot is taken */
+
+#define SNAPSHOT_SLACK 4
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct snapshot_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  FAR uint8_t *data;            /* The last snapshot taken */
+  size_t size;                  /* Size of the snapshot */
+};
+
+/* Used while a snapshot is filled in */
+
+struct snapshot_fill_s
+{
+  FAR struct procfs_snapshot_s *hdr;
+  FAR struct procfs_snapshot_task_s *task;
+  FAR struct procfs_snapshot_heap_s *heap;
+  FAR struct procfs_snapshot_pool_s *pool;
+  uint32_t maxtasks;
+  uint32_t maxheaps;
+  uint32_t maxpools;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     snapshot_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     snapshot_close(FAR struct file *filep);
+static ssize_t snapshot_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     snapshot_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     snapshot_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_snapshot_operations =
+{
+  snapshot_open,     /* open */
+  snapshot_close,    /* close */
+  snapshot_read,     /* read */
+  NULL,              /* write */
+  NULL,              /* poll */
+
+  snapshot_dup,      /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  snapshot_stat      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: snapshot_count_*
+ *
+ * Description:
+ *   Count the records that a snapshot will need room for.
+ *
+ ****************************************************************************/
+
+static void snapshot_count_task(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  (*(FAR uint32_t *)arg)++;
+}
+
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMINFO
+static void snapshot_count_heap(FAR const char *name,
+                                FAR struct mallinfo *info, FAR void *arg)
+{
+  (*(FAR uint32_t *)arg)++;
+}
+#endif
+
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL
+static void snapshot_count_pool(FAR const char *name,
+                                FAR const struct mempoolinfo_s *info,
+                                FAR void *arg)
+{
+  (*(FAR uint32_t *)arg)++;
+}
+#endif
+
+/****************************************************************************
+ * Name: snapshot_task
+ *
+ * Description:
+ *   Add the record of one thread.  Called by nxsched_foreach().
+ *
+ ****************************************************************************/
+
+static void snapshot_task(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct snapshot_fill_s *fill = arg;
+  FAR struct procfs_snapshot_task_s *task;
+#ifndef CONFIG_SCHED_CPULOAD_NONE
+  struct cpuload_s cpuload;
+#endif
+
+  if (fill->hdr->ntasks >= fill->maxtasks)
+    {
+      return;
+    }
+
+  task = &fill->task[fill->hdr->ntasks++];
+
+  task->pid           = tcb->pid;
+  task->group         = tcb->group ? tcb->group->tg_pid : -1;
+  task->state         = tcb->task_state;
+  task->priority      = tcb->sched_priority;
+  task->base_priority = tcb->base_priority;
+#ifdef CONFIG_SMP
+  task->cpu           = tcb->cpu;
+#endif
+  task->flags         = tcb->flags;
+  task->stacksize     = tcb->adj_stack_size;
+#ifdef CONFIG_STACK_COLORATION
+  task->stackused     = up_check_tcbstack(tcb, tcb->adj_stack_size);
+#endif
+
+#ifndef CONFIG_SCHED_CPULOAD_NONE
+  if (clock_cpuload(tcb->pid, &cpuload) >= 0)
+    {
+      task->load_active = cpuload.active;
+      task->load_total  = cpuload.total;
+    }
+#endif
+
+  strlcpy(task->name, get_task_name(tcb), sizeof(task->name));
+}
+
+/****************************************************************************
+ * Name: snapshot_heap
+ *
+ * Description:
+ *   Add the record of one heap.  Called by procfs_meminfo_foreach().
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMINFO
+static void snapshot_heap(FAR const char *name, FAR struct mallinfo *info,
+                          FAR void *arg)
+{
+  FAR struct snapshot_fill_s *fill = arg;
+  FAR struct procfs_snapshot_heap_s *heap;
+
+  if (fill->hdr->nheaps >= fill->maxheaps)
+    {
+      return;
+    }
+
+  heap = &fill->heap[fill->hdr->nheaps++];
+
+  heap->arena    = info->arena;
+  heap->uordblks = info->uordblks;
+  heap->fordblks = info->fordblks;
+  heap->usmblks  = info->usmblks;
+  heap->mxordblk = info->mxordblk;
+  heap->aordblks = info->aordblks;
+  heap->ordblks  = info->ordblks;
+  strlcpy(heap->name, name, sizeof(heap->name));
+}
+#endif
+
+/****************************************************************************
+ * Name: snapshot_pool
+ *
+ * Description:
+ *   Add the record of one memory pool.  Called by mempool_procfs_foreach().
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL
+static void snapshot_pool(FAR const char *name,
+                          FAR const struct mempoolinfo_s *info,
+                          FAR void *arg)
+{
+  FAR struct snapshot_fill_s *fill = arg;
+  FAR struct procfs_snapshot_pool_s *pool;
+
+  if (fill->hdr->npools >= fill->maxpools)
+    {
+      return;
+    }
+
+  pool = &fill->pool[fill->hdr->npools++];
+
+  pool->arena    = info->arena;
+  pool->sizeblks = info->sizeblks;
+  pool->aordblks = info->aordblks;
+  pool->ordblks  = info->ordblks;
+  pool->iordblks = info->iordblks;
+  pool->nwaiter  = info->nwaiter;
+  strlcpy(pool->name, name, sizeof(pool->name));
+}
+#endif
+
+/****************************************************************************
+ * Name: snapshot_take
+ *
+ * Description:
+ *   Replace the snapshot of an open file by a new one.
+ *
+ ****************************************************************************/
+
+static int snapshot_take(FAR struct snapshot_file_s *attr)
+{
+  struct snapshot_fill_s fill;
+  FAR struct procfs_snapshot_s *hdr;
+  uint32_t ntasks = SNAPSHOT_SLACK;
+  uint32_t nheaps = SNAPSHOT_SLACK;
+  uint32_t npools = SNAPSHOT_SLACK;
+  FAR uint8_t *data;
+#ifdef CONFIG_MM_IOB
+  struct iob_stats_s stats;
+#endif
+
+  /* Size the snapshot first, so that the records can be filled in
+   * without allocating memory.
+   */
+
+  nxsched_foreach(snapshot_count_task, &ntasks);
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMINFO
+  procfs_meminfo_foreach(snapshot_count_heap, &nheaps);
+#endif
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL
+  mempool_procfs_foreach(snapshot_count_pool, &npools);
+#endif
+
+  data = fs_heap_zalloc(sizeof(struct procfs_snapshot_s) +
+                        ntasks * sizeof(struct procfs_snapshot_task_s) +
+                        nheaps * sizeof(struct procfs_snapshot_heap_s) +
+                        npools * sizeof(struct procfs_snapshot_pool_s));
+  if (data == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  hdr            = (FAR struct procfs_snapshot_s *)data;
+  hdr->magic     = PROCFS_SNAPSHOT_MAGIC;
+  hdr->version   = PROCFS_SNAPSHOT_VERSION;
+  hdr->hdrsize   = sizeof(struct procfs_snapshot_s);
+  hdr->tasksize  = sizeof(struct procfs_snapshot_task_s);
+  hdr->heapsize  = sizeof(struct procfs_snapshot_heap_s);
+  hdr->poolsize  = sizeof(struct procfs_snapshot_pool_s);
+  hdr->ncpus     = CONFIG_SMP_NCPUS;
+  hdr->tickhz    = CLOCKS_PER_SEC;
+  hdr->uptime    = clock_systime_ticks();
+
+#ifdef CONFIG_MM_IOB
+  iob_getstats(&stats);
+  hdr->iob_ntotal    = stats.ntotal;
+  hdr->iob_nfree     = stats.nfree;
+  hdr->iob_nwait     = stats.nwait;
+  hdr->iob_nthrottle = stats.nthrottle;
+#else
+  hdr->iob_ntotal    = -1;
+#endif
+
+  fill.hdr      = hdr;
+  fill.task     = (FAR struct procfs_snapshot_task_s *)(hdr + 1);
+  fill.maxtasks = ntasks;
+
+  nxsched_foreach(snapshot_task, &fill);
+
+  fill.heap     = (FAR struct procfs_snapshot_heap_s *)
+                  (fill.task + hdr->ntasks);
+  fill.maxheaps = nheaps;
+
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMINFO
+  procfs_meminfo_foreach(snapshot_heap, &fill);
+#endif
+
+  fill.pool     = (FAR struct procfs_snapshot_pool_s *)
+                  (fill.heap + hdr->nheaps);
+  fill.maxpools = npools;
+
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL
+  mempool_procfs_foreach(snapshot_pool, &fill);
+#endif
+
+  fs_heap_free(attr->data);
+  attr->data = data;
+  attr->size = (FAR uint8_t *)(fill.pool + hdr->npools) - data;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: snapshot_open
+ ****************************************************************************/
+
+static int snapshot_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct snapshot_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct snapshot_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: snapshot_close
+ ****************************************************************************/
+
+static int snapshot_close(FAR struct file *filep)
+{
+  FAR struct snapshot_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct snapshot_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the snapshot and the file attributes structure */
+
+  fs_heap_free(attr->data);
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: snapshot_read
+ ****************************************************************************/
+
+static ssize_t snapshot_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct snapshot_file_s *attr;
+  off_t offset;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct snapshot_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* A read from the start takes a new snapshot.  Reads further in return
+   * the rest of the previous one, so that it stays consistent however it
+   * is read.
+   */
+
+  if (filep->f_pos == 0)
+    {
+      ret = snapshot_take(attr);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  offset = filep->f_pos;
+  ret = procfs_memcpy((FAR const char *)attr->data, attr->size, buffer,
+                      buflen, &offset);
+
+  /* Update the file offset */
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: snapshot_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int snapshot_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct snapshot_file_s *oldattr;
+  FAR struct snapshot_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct snapshot_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_zalloc(sizeof(struct snapshot_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy of the snapshot is private to the new file */
+
+  if (oldattr->data != NULL)
+    {
+      newattr->data = fs_heap_malloc(oldattr->size);
+      if (newattr->data == NULL)
+        {
+          fs_heap_free(newattr);
+          return -ENOMEM;
+        }
+
+      memcpy(newattr->data, oldattr->data, oldattr->size);
+      newattr->size = oldattr->size;
+    }
+
+  newattr->base = oldattr->base;
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: snapshot_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int snapshot_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "snapshot" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_FS_PROCFS_INCLUDE_SNAPSHOT */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
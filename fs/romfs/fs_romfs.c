@@ -40,6 +40,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/blkcache.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 
@@ -1217,6 +1218,7 @@ static int romfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
           FAR struct inode *inode = rm->rm_blkdriver;
           if (inode)
             {
+              blkcache_invalidate(inode);
               if (INODE_IS_BLOCK(inode) && inode->u.i_bops->close != NULL)
                 {
                   inode->u.i_bops->close(inode);
@@ -37,6 +37,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/blkcache.h>
 #include <nuttx/fs/ioctl.h>
 
 #include "fs_romfs.h"
@@ -540,7 +541,7 @@ int romfs_hwread(FAR struct romfs_mountpt_s *rm, FAR uint8_t *buffer,
 
       FAR struct inode *inode = rm->rm_blkdriver;
       ssize_t nsectorsread =
-        inode->u.i_bops->read(inode, buffer, sector, nsectors);
+        blkcache_read(inode, buffer, sector, nsectors, rm->rm_hwsectorsize);
 
       if (nsectorsread < 0)
         {
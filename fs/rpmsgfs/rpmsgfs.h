@@ -60,6 +60,9 @@
 #define RPMSGFS_STAT            20
 #define RPMSGFS_FCHSTAT         21
 #define RPMSGFS_CHSTAT          22
+#define RPMSGFS_READDIRS        23
+#define RPMSGFS_READ_SHM        24
+#define RPMSGFS_WRITE_SHM       25
 
 /****************************************************************************
  * Public Types
@@ -170,6 +173,30 @@ begin_packed_struct struct rpmsgfs_readdir_s
   char                    name[0];
 } end_packed_struct;
 
+/* Reply with several directory entries.  buf holds "result" bytes of
+ * records, each of which is the entry type in one byte followed by the
+ * NUL terminated name.  count is zero if the end of the directory was
+ * reached.
+ */
+
+begin_packed_struct struct rpmsgfs_readdirs_s
+{
+  struct rpmsgfs_header_s header;
+  int32_t                 fd;
+  uint32_t                count;
+  char                    buf[0];
+} end_packed_struct;
+
+/* Read or write with the data in a buffer that both CPUs can access */
+
+begin_packed_struct struct rpmsgfs_shm_s
+{
+  struct rpmsgfs_header_s header;
+  int32_t                 fd;
+  uint32_t                count;
+  uint64_t                addr;
+} end_packed_struct;
+
 #define rpmsgfs_rewinddir_s rpmsgfs_close_s
 #define rpmsgfs_closedir_s rpmsgfs_close_s
 
@@ -32,6 +32,7 @@
 #include <termios.h>
 #include <fcntl.h>
 
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/rpmsg/rpmsg.h>
@@ -58,6 +59,20 @@ struct rpmsgfs_cookie_s
   FAR void *data;
 };
 
+#ifdef CONFIG_FS_RPMSGFS_READDIR_BATCH
+/* An open directory with the entries of the last batch */
+
+struct rpmsgfs_client_dir_s
+{
+  int32_t  fd;      /* Directory index on the server */
+  bool     end;     /* The server has no more entries */
+  uint32_t size;    /* Size of buf */
+  uint32_t len;     /* Number of valid bytes in buf */
+  uint32_t pos;     /* Offset of the next entry in buf */
+  char     buf[1];  /* Records of the last batch, actual size is size */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -80,6 +95,11 @@ static int rpmsgfs_statfs_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgfs_stat_handler(FAR struct rpmsg_endpoint *ept,
                                  FAR void *data, size_t len,
                                  uint32_t src, FAR void *priv);
+#ifdef CONFIG_FS_RPMSGFS_READDIR_BATCH
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv);
+#endif
 static void rpmsgfs_device_created(struct rpmsg_device *rdev,
                                    FAR void *priv_);
 static void rpmsgfs_device_destroy(struct rpmsg_device *rdev,
@@ -120,6 +140,13 @@ static const rpmsg_ept_cb g_rpmsgfs_handler[] =
   [RPMSGFS_STAT]      = rpmsgfs_stat_handler,
   [RPMSGFS_FCHSTAT]   = rpmsgfs_default_handler,
   [RPMSGFS_CHSTAT]    = rpmsgfs_default_handler,
+#ifdef CONFIG_FS_RPMSGFS_READDIR_BATCH
+  [RPMSGFS_READDIRS]  = rpmsgfs_readdirs_handler,
+#endif
+#ifdef CONFIG_FS_RPMSGFS_ZEROCOPY
+  [RPMSGFS_READ_SHM]  = rpmsgfs_default_handler,
+  [RPMSGFS_WRITE_SHM] = rpmsgfs_default_handler,
+#endif
 };
 
 /****************************************************************************
@@ -212,6 +239,39 @@ static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+#ifdef CONFIG_FS_RPMSGFS_READDIR_BATCH
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_header_s *header = data;
+  FAR struct rpmsgfs_cookie_s *cookie =
+      (struct rpmsgfs_cookie_s *)(uintptr_t)header->cookie;
+  FAR struct rpmsgfs_readdirs_s *rsp = data;
+  FAR struct rpmsgfs_client_dir_s *dir = cookie->data;
+
+  cookie->result = header->result;
+  if (cookie->result >= 0)
+    {
+      if (cookie->result > MIN(dir->size, len - sizeof(*rsp)))
+        {
+          cookie->result = -EIO;
+        }
+      else
+        {
+          memcpy(dir->buf, rsp->buf, cookie->result);
+          dir->len = cookie->result;
+          dir->pos = 0;
+          dir->end = rsp->count == 0;
+        }
+    }
+
+  rpmsg_post(ept, &cookie->sem);
+
+  return 0;
+}
+#endif
+
 static int rpmsgfs_statfs_handler(FAR struct rpmsg_endpoint *ept,
                                   FAR void *data, size_t len,
                                   uint32_t src, FAR void *priv)
@@ -394,6 +454,38 @@ fail:
   return ret;
 }
 
+#ifdef CONFIG_FS_RPMSGFS_ZEROCOPY
+static ssize_t rpmsgfs_client_shm(FAR struct rpmsgfs_s *priv,
+                                  uint32_t command, int fd,
+                                  FAR void *buf, size_t count)
+{
+  struct rpmsgfs_shm_s msg =
+  {
+    .fd    = fd,
+    .count = count,
+    .addr  = (uintptr_t)buf,
+  };
+
+  int ret;
+
+  /* The server accesses the buffer in memory.  Write back what the cache
+   * holds of it, and discard it after a read so that the data of the
+   * server is seen.
+   */
+
+  up_flush_dcache((uintptr_t)buf, (uintptr_t)buf + count);
+
+  ret = rpmsgfs_send_recv(priv, command, true,
+          (struct rpmsgfs_header_s *)&msg, sizeof(msg), NULL);
+  if (ret > 0 && command == RPMSGFS_READ_SHM)
+    {
+      up_invalidate_dcache((uintptr_t)buf, (uintptr_t)buf + ret);
+    }
+
+  return ret;
+}
+#endif
+
 static ssize_t rpmsgfs_ioctl_arglen(int cmd)
 {
   switch (cmd)
@@ -479,6 +571,13 @@ ssize_t rpmsgfs_client_read(FAR void *handle, int fd,
       return 0;
     }
 
+#ifdef CONFIG_FS_RPMSGFS_ZEROCOPY
+  if (count > rpmsg_get_rx_buffer_size(&priv->ept) - sizeof(msg))
+    {
+      return rpmsgfs_client_shm(priv, RPMSGFS_READ_SHM, fd, buf, count);
+    }
+#endif
+
   memset(&cookie, 0, sizeof(cookie));
 
   nxsem_init(&cookie.sem, 0, 0);
@@ -522,6 +621,15 @@ ssize_t rpmsgfs_client_write(FAR void *handle, int fd,
       return 0;
     }
 
+#ifdef CONFIG_FS_RPMSGFS_ZEROCOPY
+  if (count > rpmsg_get_tx_buffer_size(&priv->ept) -
+      sizeof(struct rpmsgfs_write_s))
+    {
+      return rpmsgfs_client_shm(priv, RPMSGFS_WRITE_SHM, fd,
+                                (FAR void *)buf, count);
+    }
+#endif
+
   memset(&cookie, 0, sizeof(cookie));
   nxsem_init(&cookie.sem, 0, 0);
 
@@ -691,6 +799,9 @@ FAR void *rpmsgfs_client_opendir(FAR void *handle, FAR const char *name)
 {
   FAR struct rpmsgfs_s *priv = handle;
   FAR struct rpmsgfs_opendir_s *msg;
+#ifdef CONFIG_FS_RPMSGFS_READDIR_BATCH
+  FAR struct rpmsgfs_client_dir_s *dir;
+#endif
   uint32_t space;
   size_t len;
   int ret;
@@ -710,12 +821,81 @@ FAR void *rpmsgfs_client_opendir(FAR void *handle, FAR const char *name)
   ret = rpmsgfs_send_recv(priv, RPMSGFS_OPENDIR, false,
           (struct rpmsgfs_header_s *)msg, len, NULL);
 
+#ifdef CONFIG_FS_RPMSGFS_READDIR_BATCH
+  if (ret < 0)
+    {
+      return NULL;
+    }
+
+  /* A batch fills at most one received message */
+
+  space = rpmsg_get_rx_buffer_size(&priv->ept) -
+          sizeof(struct rpmsgfs_readdirs_s);
+  dir = fs_heap_zalloc(sizeof(*dir) + space);
+  if (dir == NULL)
+    {
+      struct rpmsgfs_closedir_s close =
+      {
+        .fd = ret,
+      };
+
+      rpmsgfs_send_recv(priv, RPMSGFS_CLOSEDIR, true,
+          (struct rpmsgfs_header_s *)&close, sizeof(close), NULL);
+      return NULL;
+    }
+
+  dir->fd   = ret;
+  dir->size = space;
+  return dir;
+#else
   return ret < 0 ? NULL : (FAR void *)((uintptr_t)ret);
+#endif
 }
 
 int rpmsgfs_client_readdir(FAR void *handle, FAR void *dirp,
                            FAR struct dirent *entry)
 {
+#ifdef CONFIG_FS_RPMSGFS_READDIR_BATCH
+  FAR struct rpmsgfs_client_dir_s *dir = dirp;
+  FAR const char *name;
+  size_t namelen;
+  int ret;
+
+  if (dir->pos >= dir->len)
+    {
+      struct rpmsgfs_readdirs_s msg =
+      {
+        .fd    = dir->fd,
+        .count = dir->size,
+      };
+
+      if (dir->end)
+        {
+          return -ENOENT;
+        }
+
+      ret = rpmsgfs_send_recv(handle, RPMSGFS_READDIRS, true,
+              (struct rpmsgfs_header_s *)&msg, sizeof(msg), dir);
+      if (ret < 0)
+        {
+          return ret;
+        }
+      else if (ret == 0)
+        {
+          return -ENOENT;
+        }
+    }
+
+  /* Take the next record of the batch */
+
+  name    = &dir->buf[dir->pos + 1];
+  namelen = strnlen(name, dir->len - dir->pos - 1);
+
+  entry->d_type = dir->buf[dir->pos];
+  strlcpy(entry->d_name, name, MIN(namelen + 1, sizeof(entry->d_name)));
+  dir->pos += namelen + 2;
+  return 0;
+#else
   struct rpmsgfs_readdir_s msg =
   {
     .fd = (uintptr_t)dirp,
@@ -723,14 +903,27 @@ int rpmsgfs_client_readdir(FAR void *handle, FAR void *dirp,
 
   return rpmsgfs_send_recv(handle, RPMSGFS_READDIR, true,
           (struct rpmsgfs_header_s *)&msg, sizeof(msg), entry);
+#endif
 }
 
 void rpmsgfs_client_rewinddir(FAR void *handle, FAR void *dirp)
 {
+#ifdef CONFIG_FS_RPMSGFS_READDIR_BATCH
+  FAR struct rpmsgfs_client_dir_s *dir = dirp;
+  struct rpmsgfs_rewinddir_s msg =
+  {
+    .fd = dir->fd,
+  };
+
+  dir->len = 0;
+  dir->pos = 0;
+  dir->end = false;
+#else
   struct rpmsgfs_rewinddir_s msg =
   {
     .fd = (uintptr_t)dirp,
   };
+#endif
 
   rpmsgfs_send_recv(handle, RPMSGFS_REWINDDIR, true,
           (struct rpmsgfs_header_s *)&msg, sizeof(msg), NULL);
@@ -788,10 +981,20 @@ int rpmsgfs_client_unbind(FAR void *handle)
 
 int rpmsgfs_client_closedir(FAR void *handle, FAR void *dirp)
 {
+#ifdef CONFIG_FS_RPMSGFS_READDIR_BATCH
+  FAR struct rpmsgfs_client_dir_s *dir = dirp;
+  struct rpmsgfs_closedir_s msg =
+  {
+    .fd = dir->fd,
+  };
+
+  fs_heap_free(dir);
+#else
   struct rpmsgfs_closedir_s msg =
   {
     .fd = (uintptr_t)dirp,
   };
+#endif
 
   return rpmsgfs_send_recv(handle, RPMSGFS_CLOSEDIR, true,
           (struct rpmsgfs_header_s *)&msg, sizeof(msg), NULL);
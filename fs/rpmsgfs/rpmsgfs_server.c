@@ -34,6 +34,7 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -126,6 +127,12 @@ static int rpmsgfs_fchstat_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgfs_chstat_handler(FAR struct rpmsg_endpoint *ept,
                                   FAR void *data, size_t len,
                                   uint32_t src, FAR void *priv);
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv);
+static int rpmsgfs_shm_handler(FAR struct rpmsg_endpoint *ept,
+                               FAR void *data, size_t len,
+                               uint32_t src, FAR void *priv);
 
 static bool rpmsgfs_ns_match(FAR struct rpmsg_device *rdev,
                              FAR void *priv_, FAR const char *name,
@@ -165,6 +172,9 @@ static const rpmsg_ept_cb g_rpmsgfs_handler[] =
   [RPMSGFS_STAT]      = rpmsgfs_stat_handler,
   [RPMSGFS_FCHSTAT]   = rpmsgfs_fchstat_handler,
   [RPMSGFS_CHSTAT]    = rpmsgfs_chstat_handler,
+  [RPMSGFS_READDIRS]  = rpmsgfs_readdirs_handler,
+  [RPMSGFS_READ_SHM]  = rpmsgfs_shm_handler,
+  [RPMSGFS_WRITE_SHM] = rpmsgfs_shm_handler,
 };
 
 /****************************************************************************
@@ -631,6 +641,127 @@ static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
   return rpmsg_send(ept, msg, len);
 }
 
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_readdirs_s *msg = data;
+  FAR struct rpmsgfs_readdirs_s *rsp;
+  FAR struct dirent *entry;
+  int ret = -ENOENT;
+  FAR void *dir;
+  uint32_t space;
+  size_t used = 0;
+  size_t size;
+
+  rsp = rpmsg_get_tx_payload_buffer(ept, &space, true);
+  if (rsp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  *rsp = *msg;
+
+  /* Do not fill more than the client can receive, and stop as soon as
+   * the longest possible entry might not fit any more, so that no entry
+   * that was read has to be put back.
+   */
+
+  space = MIN(space, rpmsg_get_rx_buffer_size(ept)) - sizeof(*rsp);
+  space = MIN(space, msg->count);
+
+  dir = rpmsgfs_get_dir(priv, msg->fd);
+  if (dir)
+    {
+      while (used == 0 || space - used >= sizeof(entry->d_name) + 1)
+        {
+          entry = readdir(dir);
+          if (entry == NULL)
+            {
+              rsp->count = 0;
+              break;
+            }
+
+          size = MIN(space - used - 1, strlen(entry->d_name) + 1);
+          rsp->buf[used] = entry->d_type;
+          strlcpy(&rsp->buf[used + 1], entry->d_name, size);
+          used += size + 1;
+        }
+
+      ret = used;
+    }
+
+  rsp->header.result = ret;
+  ret = rpmsg_send_nocopy(ept, rsp, sizeof(*rsp) + used);
+  if (ret < 0)
+    {
+      rpmsg_release_tx_buffer(ept, rsp);
+    }
+
+  return ret;
+}
+
+static int rpmsgfs_shm_handler(FAR struct rpmsg_endpoint *ept,
+                               FAR void *data, size_t len,
+                               uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_shm_s *msg = data;
+  int ret = -ENOSYS;
+#ifdef CONFIG_FS_RPMSGFS_ZEROCOPY
+  FAR char *buf = (FAR char *)(uintptr_t)msg->addr;
+  FAR struct file *filep;
+  size_t done = 0;
+
+  filep = rpmsgfs_get_file(priv, msg->fd);
+  if (filep == NULL)
+    {
+      ret = -ENOENT;
+    }
+  else if (msg->header.command == RPMSGFS_READ_SHM)
+    {
+      while (done < msg->count)
+        {
+          ret = file_read(filep, buf + done, msg->count - done);
+          if (ret <= 0)
+            {
+              break;
+            }
+
+          done += ret;
+        }
+
+      /* Write the data back to memory for the client */
+
+      up_flush_dcache((uintptr_t)buf, (uintptr_t)buf + done);
+    }
+  else
+    {
+      /* Do not use stale cache lines of the client buffer */
+
+      up_invalidate_dcache((uintptr_t)buf, (uintptr_t)buf + msg->count);
+
+      while (done < msg->count)
+        {
+          ret = file_write(filep, buf + done, msg->count - done);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          done += ret;
+        }
+    }
+
+  if (done > 0)
+    {
+      ret = done;
+    }
+#endif
+
+  msg->header.result = ret;
+  return rpmsg_send(ept, msg, sizeof(*msg));
+}
+
 static int rpmsgfs_rewinddir_handler(FAR struct rpmsg_endpoint *ept,
                                      FAR void *data, size_t len,
                                      uint32_t src, FAR void *priv)
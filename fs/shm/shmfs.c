@@ -25,6 +25,8 @@
  ****************************************************************************/
 
 #include <assert.h>
+#include <fcntl.h>
+#include <poll.h>
 
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mm/map.h>
@@ -46,6 +48,11 @@ static ssize_t shmfs_read(FAR struct file *filep, FAR char *buffer,
 static ssize_t shmfs_write(FAR struct file *filep, FAR const char *buffer,
                            size_t buflen);
 static int shmfs_truncate(FAR struct file *filep, off_t length);
+#ifdef CONFIG_FS_SHMFS_RING
+static int shmfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+static int shmfs_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup);
+#endif
 
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 static int shmfs_unlink(FAR struct inode *inode);
@@ -69,10 +76,18 @@ const struct file_operations g_shmfs_operations =
   shmfs_read,       /* read */
   shmfs_write,      /* write */
   NULL,             /* seek */
+#ifdef CONFIG_FS_SHMFS_RING
+  shmfs_ioctl,      /* ioctl */
+#else
   NULL,             /* ioctl */
+#endif
   shmfs_mmap,       /* mmap */
   shmfs_truncate,   /* truncate */
+#ifdef CONFIG_FS_SHMFS_RING
+  shmfs_poll,       /* poll */
+#else
   NULL,             /* poll */
+#endif
   NULL,             /* readv */
   NULL,             /* writev */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
@@ -249,6 +264,119 @@ static int shmfs_truncate(FAR struct file *filep, off_t length)
   return ret;
 }
 
+/****************************************************************************
+ * Name: shmfs_ioctl
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_SHMFS_RING
+static int shmfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct shmfs_object_s *object = filep->f_inode->i_private;
+  int semcount;
+  int ret;
+
+  if (cmd != FIOC_RINGNOTIFY && cmd != FIOC_RINGWAIT)
+    {
+      return -ENOTTY;
+    }
+
+  if (object == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (cmd == FIOC_RINGWAIT)
+    {
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          return nxsem_trywait(&object->ringsem);
+        }
+
+      return nxsem_wait(&object->ringsem);
+    }
+
+  /* Keep the semaphore binary, the consumer checks the ring again after
+   * every wakeup anyway.
+   */
+
+  ret = nxmutex_lock(&object->ringlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nxsem_get_value(&object->ringsem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&object->ringsem);
+    }
+
+  poll_notify(object->fds, CONFIG_FS_SHMFS_NPOLLWAITERS, POLLIN);
+  nxmutex_unlock(&object->ringlock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: shmfs_poll
+ ****************************************************************************/
+
+static int shmfs_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct shmfs_object_s *object = filep->f_inode->i_private;
+  int semcount;
+  int ret;
+  int i;
+
+  if (object == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&object->ringlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_FS_SHMFS_NPOLLWAITERS; i++)
+        {
+          if (object->fds[i] == NULL)
+            {
+              object->fds[i] = fds;
+              fds->priv      = &object->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_FS_SHMFS_NPOLLWAITERS)
+        {
+          ret = -EBUSY;
+        }
+      else
+        {
+          /* Report a wakeup that is already pending */
+
+          nxsem_get_value(&object->ringsem, &semcount);
+          if (semcount > 0)
+            {
+              poll_notify(&object->fds[i], 1, POLLIN);
+            }
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      *(FAR struct pollfd **)fds->priv = NULL;
+      fds->priv = NULL;
+    }
+
+  nxmutex_unlock(&object->ringlock);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: shmfs_unlink
  ****************************************************************************/
@@ -28,6 +28,8 @@
  ****************************************************************************/
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
 
 /****************************************************************************
  * Public Data
@@ -45,6 +47,16 @@ struct shmfs_object_s
 
   size_t length;
 
+#ifdef CONFIG_FS_SHMFS_RING
+  /* Wakeup of a ring consumer: FIOC_RINGNOTIFY posts the semaphore and
+   * wakes the pollers, FIOC_RINGWAIT takes it.
+   */
+
+  mutex_t ringlock;
+  sem_t ringsem;
+  FAR struct pollfd *fds[CONFIG_FS_SHMFS_NPOLLWAITERS];
+#endif
+
   /* Vector of allocations from physical memory.
    *
    * - In flat and protected builds this is a pointer to the
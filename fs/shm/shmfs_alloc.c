@@ -142,6 +142,10 @@ FAR struct shmfs_object_s *shmfs_alloc_object(size_t length)
   if (allocated)
     {
       object->length = length;
+#ifdef CONFIG_FS_SHMFS_RING
+      nxmutex_init(&object->ringlock);
+      nxsem_init(&object->ringsem, 0, 0);
+#endif
     }
   else
     {
@@ -158,6 +162,14 @@ void shmfs_free_object(FAR struct shmfs_object_s *object)
 {
   if (object)
     {
+#ifdef CONFIG_FS_SHMFS_RING
+      if (object->length > 0)
+        {
+          nxmutex_destroy(&object->ringlock);
+          nxsem_destroy(&object->ringsem);
+        }
+#endif
+
 #if defined(CONFIG_BUILD_PROTECTED)
       kumm_free(object->paddr);
 #elif defined(CONFIG_BUILD_KERNEL)
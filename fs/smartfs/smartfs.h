@@ -35,6 +35,7 @@
 
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/fs/smart.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -329,6 +330,9 @@ struct smartfs_mountpt_s
   FAR char                     *fs_rwbuffer;   /* Read/Write working buffer */
   FAR char                     *fs_workbuffer; /* Working buffer */
   uint8_t                       fs_rootsector; /* Root directory sector num */
+#ifdef CONFIG_SMARTFS_IDLE_GC
+  struct work_s                 fs_gcwork;     /* Idle garbage collection */
+#endif
 };
 
 /****************************************************************************
@@ -176,6 +176,55 @@ const struct mountpt_operations g_smartfs_operations =
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_SMARTFS_IDLE_GC
+/****************************************************************************
+ * Name: smartfs_idle_worker
+ *
+ * Description: Reclaim one erase block while the file system is idle, and
+ *   come back right away as long as there are more worth it.  Any write
+ *   in between postpones the next one.
+ *
+ ****************************************************************************/
+
+static void smartfs_idle_worker(FAR void *arg)
+{
+  FAR struct smartfs_mountpt_s *fs = arg;
+  int ret;
+
+  if (nxmutex_lock(&g_lock) < 0)
+    {
+      return;
+    }
+
+  if (fs->fs_mounted)
+    {
+      ret = FS_IOCTL(fs, BIOC_GARBAGECOLLECT, 0);
+      if (ret > 0 && work_available(&fs->fs_gcwork))
+        {
+          work_queue(LPWORK, &fs->fs_gcwork, smartfs_idle_worker, fs, 1);
+        }
+    }
+
+  nxmutex_unlock(&g_lock);
+}
+
+/****************************************************************************
+ * Name: smartfs_idle_schedule
+ *
+ * Description: (Re)start the idle timer after a modification, with the
+ *   lock held.
+ *
+ ****************************************************************************/
+
+static void smartfs_idle_schedule(FAR struct smartfs_mountpt_s *fs)
+{
+  work_queue(LPWORK, &fs->fs_gcwork, smartfs_idle_worker, fs,
+             MSEC2TICK(CONFIG_SMARTFS_IDLE_GC_DELAY));
+}
+#else
+#  define smartfs_idle_schedule(fs)
+#endif
+
 /****************************************************************************
  * Name: smartfs_open
  ****************************************************************************/
@@ -977,6 +1026,7 @@ static ssize_t smartfs_write(FAR struct file *filep, FAR const char *buffer,
 #endif /* CONFIG_SMARTFS_USE_SECTOR_BUFFER */
     }
 
+  smartfs_idle_schedule(fs);
   ret = byteswritten;
 
 errout_with_lock:
@@ -1254,6 +1304,8 @@ static int smartfs_truncate(FAR struct file *filep, off_t length)
       ret = smartfs_extendfile(fs, sf, length);
     }
 
+  smartfs_idle_schedule(fs);
+
 errout_with_lock:
 
   /* Relinquish exclusive access */
@@ -1642,9 +1694,17 @@ static int smartfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       /* Unmount ... close the block driver */
 
       ret = smartfs_unmount(fs);
+      fs->fs_mounted = false;
     }
 
   nxmutex_unlock(&g_lock);
+
+#ifdef CONFIG_SMARTFS_IDLE_GC
+  /* Not with the lock held, the worker may be waiting for it */
+
+  work_cancel_sync(LPWORK, &fs->fs_gcwork);
+#endif
+
   fs_heap_free(fs);
   return ret;
 }
@@ -1752,6 +1812,7 @@ static int smartfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
        */
 
       smartfs_deleteentry(fs, &entry);
+      smartfs_idle_schedule(fs);
     }
   else
     {
@@ -54,6 +54,8 @@ static int sock_file_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg);
 static int sock_file_poll(FAR struct file *filep, struct pollfd *fds,
                           bool setup);
+static int sock_file_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map);
 static int sock_file_truncate(FAR struct file *filep, off_t length);
 
 /****************************************************************************
@@ -68,7 +70,7 @@ static const struct file_operations g_sock_fileops =
   sock_file_write,    /* write */
   NULL,               /* seek */
   sock_file_ioctl,    /* ioctl */
-  NULL,               /* mmap */
+  sock_file_mmap,     /* mmap */
   sock_file_truncate, /* truncate */
   sock_file_poll      /* poll */
 };
@@ -144,6 +146,12 @@ static int sock_file_poll(FAR struct file *filep, FAR struct pollfd *fds,
   return psock_poll(filep->f_priv, fds, setup);
 }
 
+static int sock_file_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map)
+{
+  return psock_mmap(filep->f_priv, map);
+}
+
 static int sock_file_truncate(FAR struct file *filep, off_t length)
 {
   return -EINVAL;
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <stdint.h>
@@ -54,10 +55,16 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
+#if CONFIG_FS_TMPFS_CHUNKSIZE == 0 && \
+    CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
 #  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+#  define TMPFS_NCHUNKS(size) \
+     (((size) + CONFIG_FS_TMPFS_CHUNKSIZE - 1) / CONFIG_FS_TMPFS_CHUNKSIZE)
+#endif
+
 #define tmpfs_lock(fs) \
            nxrmutex_lock(&fs->tfs_lock)
 #define tmpfs_lock_object(to) \
@@ -96,6 +103,13 @@ static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static void tmpfs_free_data(FAR struct tmpfs_file_s *tfo);
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+static void tmpfs_read_chunks(FAR struct tmpfs_file_s *tfo, off_t pos,
+              FAR char *buffer, size_t buflen);
+static size_t tmpfs_write_chunks(FAR struct tmpfs_file_s *tfo, off_t pos,
+              FAR const char *buffer, size_t buflen);
+#endif
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_release_file(FAR struct tmpfs_file_s *tfo);
@@ -272,6 +286,99 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
  * Name: tmpfs_realloc_file
  ****************************************************************************/
 
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
+                              size_t newsize)
+{
+  FAR uint8_t **chunks;
+  size_t nchunks;
+  size_t nalloc;
+  size_t offset;
+  size_t i;
+
+  /* Free everything if the size is shrinking to zero */
+
+  if (newsize == 0)
+    {
+      tmpfs_free_data(tfo);
+      tfo->tfo_size = 0;
+      return OK;
+    }
+
+  nchunks = TMPFS_NCHUNKS(newsize);
+  if (nchunks > SIZE_MAX / (2 * sizeof(*chunks)))
+    {
+      return -ENOMEM;
+    }
+
+  if (newsize < tfo->tfo_size)
+    {
+      /* Free the chunks past the new end of the file and clear the tail of
+       * the last one, so that the file reads as zeros if it grows again.
+       */
+
+      for (i = nchunks; i < tfo->tfo_nchunks; i++)
+        {
+          if (tfo->tfo_chunks[i] != NULL)
+            {
+              fs_heap_free(tfo->tfo_chunks[i]);
+              tfo->tfo_chunks[i] = NULL;
+              tfo->tfo_alloc -= CONFIG_FS_TMPFS_CHUNKSIZE;
+            }
+        }
+
+      offset = newsize % CONFIG_FS_TMPFS_CHUNKSIZE;
+      if (offset > 0 && tfo->tfo_chunks[nchunks - 1] != NULL)
+        {
+          memset(tfo->tfo_chunks[nchunks - 1] + offset, 0,
+                 CONFIG_FS_TMPFS_CHUNKSIZE - offset);
+        }
+    }
+
+  /* Only the table of chunk pointers is reallocated.  It grows by doubling
+   * and shrinks once three quarters of it are unused.  The chunks that are
+   * added are holes until they are written.
+   */
+
+  nalloc = tfo->tfo_nchunks;
+  if (nchunks > nalloc)
+    {
+      nalloc = MAX(nchunks, 2 * nalloc);
+    }
+  else if (nchunks < nalloc / 4)
+    {
+      nalloc = nchunks;
+    }
+
+  if (nalloc != tfo->tfo_nchunks)
+    {
+      chunks = fs_heap_realloc(tfo->tfo_chunks, nalloc * sizeof(*chunks));
+      if (chunks == NULL)
+        {
+          if (nalloc > tfo->tfo_nchunks)
+            {
+              return -ENOMEM;
+            }
+        }
+      else
+        {
+          if (nalloc > tfo->tfo_nchunks)
+            {
+              memset(&chunks[tfo->tfo_nchunks], 0,
+                     (nalloc - tfo->tfo_nchunks) * sizeof(*chunks));
+            }
+
+          tfo->tfo_alloc   = tfo->tfo_alloc + nalloc * sizeof(*chunks) -
+                             tfo->tfo_nchunks * sizeof(*chunks);
+          tfo->tfo_nchunks = nalloc;
+          tfo->tfo_chunks  = chunks;
+        }
+    }
+
+  tfo->tfo_size = newsize;
+  return OK;
+}
+#else
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
                               size_t newsize)
 {
@@ -291,9 +398,7 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
         {
           /* Free the file object */
 
-          fs_heap_free(tfo->tfo_data);
-          tfo->tfo_data = NULL;
-          tfo->tfo_alloc = 0;
+          tmpfs_free_data(tfo);
           tfo->tfo_size = 0;
           return OK;
         }
@@ -345,6 +450,118 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
   tfo->tfo_data  = newdata;
   return OK;
 }
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_free_data
+ *
+ * Description:
+ *   Free the memory that holds the data of a file.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_data(FAR struct tmpfs_file_s *tfo)
+{
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+  size_t i;
+
+  for (i = 0; i < tfo->tfo_nchunks; i++)
+    {
+      fs_heap_free(tfo->tfo_chunks[i]);
+    }
+
+  fs_heap_free(tfo->tfo_chunks);
+  tfo->tfo_chunks  = NULL;
+  tfo->tfo_nchunks = 0;
+#else
+  fs_heap_free(tfo->tfo_data);
+  tfo->tfo_data = NULL;
+#endif
+  tfo->tfo_alloc = 0;
+}
+
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+/****************************************************************************
+ * Name: tmpfs_read_chunks
+ *
+ * Description:
+ *   Copy 'buflen' bytes of file data starting at 'pos' to 'buffer'.  Holes
+ *   read as zeros.  The range must lie within the file.
+ *
+ ****************************************************************************/
+
+static void tmpfs_read_chunks(FAR struct tmpfs_file_s *tfo, off_t pos,
+                              FAR char *buffer, size_t buflen)
+{
+  FAR uint8_t *chunk;
+  size_t offset;
+  size_t nbytes;
+
+  while (buflen > 0)
+    {
+      chunk  = tfo->tfo_chunks[pos / CONFIG_FS_TMPFS_CHUNKSIZE];
+      offset = pos % CONFIG_FS_TMPFS_CHUNKSIZE;
+      nbytes = MIN(CONFIG_FS_TMPFS_CHUNKSIZE - offset, buflen);
+
+      if (chunk != NULL)
+        {
+          memcpy(buffer, chunk + offset, nbytes);
+        }
+      else
+        {
+          memset(buffer, 0, nbytes);
+        }
+
+      buffer += nbytes;
+      buflen -= nbytes;
+      pos    += nbytes;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_write_chunks
+ *
+ * Description:
+ *   Copy 'buflen' bytes from 'buffer' to the file data starting at 'pos',
+ *   allocating the chunks that are holes.  The range must lie within the
+ *   file.  Returns the number of bytes written, which is less than
+ *   'buflen' only if a chunk could not be allocated.
+ *
+ ****************************************************************************/
+
+static size_t tmpfs_write_chunks(FAR struct tmpfs_file_s *tfo, off_t pos,
+                                 FAR const char *buffer, size_t buflen)
+{
+  FAR uint8_t **chunk;
+  size_t nwritten = 0;
+  size_t offset;
+  size_t nbytes;
+
+  while (nwritten < buflen)
+    {
+      chunk  = &tfo->tfo_chunks[pos / CONFIG_FS_TMPFS_CHUNKSIZE];
+      offset = pos % CONFIG_FS_TMPFS_CHUNKSIZE;
+      nbytes = MIN(CONFIG_FS_TMPFS_CHUNKSIZE - offset, buflen - nwritten);
+
+      if (*chunk == NULL)
+        {
+          *chunk = fs_heap_zalloc(CONFIG_FS_TMPFS_CHUNKSIZE);
+          if (*chunk == NULL)
+            {
+              break;
+            }
+
+          tfo->tfo_alloc += CONFIG_FS_TMPFS_CHUNKSIZE;
+        }
+
+      memcpy(*chunk + offset, buffer + nwritten, nbytes);
+      nwritten += nbytes;
+      pos      += nbytes;
+    }
+
+  return nwritten;
+}
+#endif
 
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
@@ -383,7 +600,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
       fs_heap_free(tfo);
     }
 
@@ -582,7 +799,6 @@ tmpfs_alloc_file(FAR struct tmpfs_directory_s *parent)
   tfo->tfo_parent = parent;
   tfo->tfo_flags  = 0;
   tfo->tfo_size   = 0;
-  tfo->tfo_data   = NULL;
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -1189,7 +1405,11 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 
       tmptfo             = (FAR struct tmpfs_file_s *)to;
       tmpbuf->tsf_alloc += sizeof(struct tmpfs_file_s);
-      tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+      if (to->to_alloc > tmptfo->tfo_size)
+        {
+          tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+        }
+
       tmpbuf->tsf_files++;
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
@@ -1265,7 +1485,7 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
@@ -1586,6 +1806,10 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+  tmpfs_read_chunks(tfo, startpos, buffer, nread);
+  filep->f_pos += nread;
+#else
   if (tfo->tfo_data != NULL)
     {
       memcpy(buffer, &tfo->tfo_data[startpos], nread);
@@ -1595,6 +1819,7 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
     {
       DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
     }
+#endif
 
   /* Release the lock on the file */
 
@@ -1613,6 +1838,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   ssize_t nwritten;
   off_t startpos;
   off_t endpos;
+  size_t oldsize;
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1644,6 +1870,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   nwritten = buflen;
   endpos   = startpos + buflen;
+  oldsize  = tfo->tfo_size;
 
   if (endpos > tfo->tfo_size)
     {
@@ -1658,6 +1885,32 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+  nwritten = tmpfs_write_chunks(tfo, startpos, buffer, buflen);
+  if (nwritten < buflen)
+    {
+      /* Out of memory.  Keep the part that was written. */
+
+      endpos = startpos + nwritten;
+      if (tfo->tfo_size > oldsize)
+        {
+          tmpfs_realloc_file(tfo, MAX(oldsize, (size_t)endpos));
+        }
+
+      if (nwritten == 0)
+        {
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+    }
+#else
+  /* A write past the end of the file leaves a hole that reads as zeros */
+
+  if (startpos > oldsize)
+    {
+      memset(&tfo->tfo_data[oldsize], 0, startpos - oldsize);
+    }
+
   if (tfo->tfo_data != NULL)
     {
       memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
@@ -1666,6 +1919,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
     {
       DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
     }
+#endif
 
   filep->f_pos = endpos;
 
@@ -1788,7 +2042,39 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
   if (map->offset >= 0 && map->offset < tfo->tfo_size &&
       map->length && map->offset + map->length <= tfo->tfo_size)
     {
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+      FAR uint8_t **chunk;
+      size_t index = map->offset / CONFIG_FS_TMPFS_CHUNKSIZE;
+
+      /* Only a range within one chunk can be mapped directly.  Leave the
+       * others to the generic logic, which copies the data.
+       */
+
+      if (index != (map->offset + map->length - 1) /
+                   CONFIG_FS_TMPFS_CHUNKSIZE)
+        {
+          return -ENOTTY;
+        }
+
+      tmpfs_lock_file(tfo);
+      chunk = &tfo->tfo_chunks[index];
+      if (*chunk == NULL)
+        {
+          *chunk = fs_heap_zalloc(CONFIG_FS_TMPFS_CHUNKSIZE);
+          if (*chunk == NULL)
+            {
+              tmpfs_unlock_file(tfo);
+              return -ENOMEM;
+            }
+
+          tfo->tfo_alloc += CONFIG_FS_TMPFS_CHUNKSIZE;
+        }
+
+      map->vaddr = *chunk + map->offset % CONFIG_FS_TMPFS_CHUNKSIZE;
+      tmpfs_unlock_file(tfo);
+#else
       map->vaddr = tfo->tfo_data + map->offset;
+#endif
       map->priv.p = tfo;
       map->munmap = tmpfs_unmap;
       ret = mm_map_add(get_current_mm(), map);
@@ -1842,7 +2128,18 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     {
       FAR uintptr_t *ptr = (FAR uintptr_t *)arg;
 
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+      /* The data is only contiguous if it fits in one chunk */
+
+      if (TMPFS_NCHUNKS(tfo->tfo_size) > 1)
+        {
+          return -ENOTTY;
+        }
+
+      *ptr = tfo->tfo_nchunks > 0 ? (uintptr_t)tfo->tfo_chunks[0] : 0;
+#else
       *ptr = (uintptr_t)tfo->tfo_data;
+#endif
       return OK;
     }
 
@@ -1976,14 +2273,16 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
           goto errout_with_lock;
         }
 
+#if CONFIG_FS_TMPFS_CHUNKSIZE == 0
       /* If the size has increased, then we need to zero the newly added
-       * memory.
+       * memory.  Chunks are always cleared beyond the end of the file.
        */
 
       if (length > oldsize)
         {
           memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
         }
+#endif
 
       ret = OK;
     }
@@ -2430,7 +2729,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
       fs_heap_free(tfo);
     }
 
@@ -42,6 +42,10 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+#ifndef CONFIG_FS_TMPFS_CHUNKSIZE
+#  define CONFIG_FS_TMPFS_CHUNKSIZE 0
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -128,7 +132,12 @@ struct tmpfs_file_s
 
   uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
   size_t        tfo_size;  /* Valid file size */
+#if CONFIG_FS_TMPFS_CHUNKSIZE > 0
+  size_t        tfo_nchunks; /* Number of entries in tfo_chunks */
+  FAR uint8_t **tfo_chunks;  /* File data, NULL entries are holes */
+#else
   FAR uint8_t  *tfo_data;  /* File data starts here */
+#endif
 };
 
 /* This structure represents one instance of a TMPFS file system */
@@ -54,6 +54,10 @@
 #define V9FS_BIT16SZ           2          /* uint16 -> V9FS_BIT16SZ */
 #define V9FS_BIT32SZ           4          /* uint32 -> V9FS_BIT32SZ */
 #define V9FS_BIT64SZ           8          /* uint64 -> V9FS_BIT64SZ */
+#ifndef CONFIG_V9FS_MAX_INFLIGHT
+#  define CONFIG_V9FS_MAX_INFLIGHT 1
+#endif
+
 #define V9FS_DEFAULT_VERSION   "9P2000.L" /* Current implementations are
                                            * based on the "9P2000L"
                                            * protocol.
@@ -294,6 +298,17 @@ begin_packed_struct struct v9fs_rwrite_s
 #define v9fs_read_s v9fs_write_s
 #define v9fs_rread_s v9fs_rwrite_s
 
+/* One Tread or Twrite request of a transfer and its reply */
+
+struct v9fs_io_s
+{
+  struct v9fs_write_s   request;
+  struct v9fs_rwrite_s  response;
+  struct iovec          wiov[2];
+  struct iovec          riov[2];
+  struct v9fs_payload_s payload;
+};
+
 #define v9fs_readdir_s v9fs_write_s
 #define v9fs_rreaddir_s v9fs_rwrite_s
 
@@ -537,6 +552,56 @@ static void v9fs_fid_destroy(FAR struct v9fs_client_s *client,
   fs_heap_free(fidp);
 }
 
+/****************************************************************************
+ * v9fs_client_submit
+ *
+ * Description:
+ *   Hand a request to the transport without waiting for the reply.  The
+ *   transport completes the payload with v9fs_transport_done(), which
+ *   matches the reply to the request that it belongs to.
+ *
+ ****************************************************************************/
+
+static int v9fs_client_submit(FAR struct v9fs_transport_s *transport,
+                              FAR struct v9fs_payload_s *payload,
+                              FAR struct iovec *wiov, size_t wcount,
+                              FAR struct iovec *riov, size_t rcount,
+                              uint16_t tag)
+{
+  int ret;
+
+  nxsem_init(&payload->resp, 0, 0);
+  payload->wiov = wiov;
+  payload->riov = riov;
+  payload->wcount = wcount;
+  payload->rcount = rcount;
+  payload->tag = tag;
+  payload->ret = -EIO;
+
+  ret = v9fs_transport_request(transport, payload);
+  if (ret < 0)
+    {
+      nxsem_destroy(&payload->resp);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * v9fs_client_wait
+ *
+ * Description:
+ *   Wait for the reply to a request that was submitted.
+ *
+ ****************************************************************************/
+
+static int v9fs_client_wait(FAR struct v9fs_payload_s *payload)
+{
+  nxsem_wait_uninterruptible(&payload->resp);
+  nxsem_destroy(&payload->resp);
+  return payload->ret;
+}
+
 /****************************************************************************
  * v9fs_client_rpc
  ****************************************************************************/
@@ -549,25 +614,148 @@ static int v9fs_client_rpc(FAR struct v9fs_transport_s *transport,
   struct v9fs_payload_s payload;
   int ret;
 
-  nxsem_init(&payload.resp, 0, 0);
-  payload.wiov = wiov;
-  payload.riov = riov;
-  payload.wcount = wcount;
-  payload.rcount = rcount;
-  payload.tag = tag;
-  payload.ret = -EIO;
-
-  ret = v9fs_transport_request(transport, &payload);
+  ret = v9fs_client_submit(transport, &payload, wiov, wcount, riov, rcount,
+                           tag);
   if (ret < 0)
     {
-      nxsem_destroy(&payload.resp);
       return ret;
     }
 
-  nxsem_wait(&payload.resp);
-  nxsem_destroy(&payload.resp);
+  return v9fs_client_wait(&payload);
+}
+
+/****************************************************************************
+ * v9fs_client_transfer
+ *
+ * Description:
+ *   Read or write 'buflen' bytes at 'offset', split into requests of at
+ *   most one I/O unit.  Up to CONFIG_V9FS_MAX_INFLIGHT requests are in
+ *   flight at a time, each with its own tag, and their replies are
+ *   consumed in the order the requests were sent.  A short reply ends the
+ *   pipeline: the requests behind it are drained and the transfer
+ *   restarts from the end of the data that was actually moved.
+ *
+ ****************************************************************************/
+
+static ssize_t v9fs_client_transfer(FAR struct v9fs_client_s *client,
+                                    uint32_t fid, FAR uint8_t *buffer,
+                                    off_t offset, size_t buflen,
+                                    uint8_t type)
+{
+  struct v9fs_io_s io[CONFIG_V9FS_MAX_INFLIGHT];
+  FAR struct v9fs_fid_s *fidp;
+  FAR struct v9fs_io_s *iop;
+  unsigned int nsubmit = 0;
+  unsigned int ndone = 0;
+  size_t nposted = 0;
+  size_t ndata = 0;
+  bool resync = false;
+  bool stop = false;
+  int result;
+  int ret = 0;
+
+  fidp = idr_find(client->fids, fid);
+  if (fidp == NULL)
+    {
+      return -ENOENT;
+    }
+
+  for (; ; )
+    {
+      /* Keep the pipeline full */
+
+      while (!stop && !resync && nposted < buflen &&
+             nsubmit - ndone < CONFIG_V9FS_MAX_INFLIGHT)
+        {
+          iop = &io[nsubmit % CONFIG_V9FS_MAX_INFLIGHT];
+          iop->request.count = MIN(buflen - nposted, fidp->iounit);
+          iop->request.header.size = V9FS_HDRSZ + V9FS_BIT32SZ +
+                                     V9FS_BIT64SZ + V9FS_BIT32SZ;
+          iop->request.header.type = type;
+          iop->request.header.tag = v9fs_get_tagid(client);
+          iop->request.fid = fid;
+          iop->request.offset = offset + nposted;
+
+          iop->wiov[0].iov_base = &iop->request;
+          iop->wiov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
+                                 V9FS_BIT32SZ;
+          iop->riov[0].iov_base = &iop->response;
+          iop->riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
+
+          if (type == V9FS_TWRITE)
+            {
+              iop->request.header.size += iop->request.count;
+              iop->wiov[1].iov_base = buffer + nposted;
+              iop->wiov[1].iov_len = iop->request.count;
+              ret = v9fs_client_submit(client->transport, &iop->payload,
+                                       iop->wiov, 2, iop->riov, 1,
+                                       iop->request.header.tag);
+            }
+          else
+            {
+              iop->riov[1].iov_base = buffer + nposted;
+              iop->riov[1].iov_len = iop->request.count;
+              ret = v9fs_client_submit(client->transport, &iop->payload,
+                                       iop->wiov, 1, iop->riov, 2,
+                                       iop->request.header.tag);
+            }
+
+          if (ret < 0)
+            {
+              /* The transport may be full.  Retry after a reply came in,
+               * but give up if nothing is in flight.
+               */
+
+              stop = nsubmit == ndone;
+              break;
+            }
+
+          nposted += iop->request.count;
+          nsubmit++;
+        }
+
+      if (ndone == nsubmit)
+        {
+          /* Restart after a short reply, unless it moved nothing */
 
-  return payload.ret;
+          if (resync && !stop)
+            {
+              resync  = false;
+              nposted = ndata;
+              continue;
+            }
+
+          break;
+        }
+
+      /* Consume the oldest reply */
+
+      iop = &io[ndone++ % CONFIG_V9FS_MAX_INFLIGHT];
+      result = v9fs_client_wait(&iop->payload);
+      if (stop || resync)
+        {
+          continue;
+        }
+
+      if (result < 0)
+        {
+          ret  = result;
+          stop = true;
+          continue;
+        }
+
+      ndata += iop->response.count;
+      if (iop->response.count == 0)
+        {
+          stop = true;
+        }
+      else if (iop->response.count < iop->request.count)
+        {
+          resync = true;
+        }
+    }
+
+  return ndata ? ndata : ret;
 }
 
 /****************************************************************************
@@ -902,61 +1090,12 @@ int v9fs_client_chstat(FAR struct v9fs_client_s *client, uint32_t fid,
 ssize_t v9fs_client_read(FAR struct v9fs_client_s *client, uint32_t fid,
                          FAR void *buffer, off_t offset, size_t buflen)
 {
-  FAR struct v9fs_fid_s *fidp;
-  struct v9fs_read_s request;
-  struct v9fs_rread_s response;
-  struct iovec wiov[1];
-  struct iovec riov[2];
-  size_t nread = 0;
-  int ret = 0;
-
   /* size[4] Tread tag[2] fid[4] offset[8] count[4]
    * size[4] Rread tag[2] count[4] data[count]
    */
 
-  fidp = idr_find(client->fids, fid);
-  if (fidp == NULL)
-    {
-      return -ENOENT;
-    }
-
-  while (buflen > 0)
-    {
-      request.header.size = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                            V9FS_BIT32SZ;
-      request.header.type = V9FS_TREAD;
-      request.header.tag = v9fs_get_tagid(client);
-      request.fid = fid;
-      request.offset = offset;
-      request.count = buflen > fidp->iounit ? fidp->iounit : buflen;
-
-      wiov[0].iov_base = &request;
-      wiov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                        V9FS_BIT32SZ;
-      riov[0].iov_base = &response;
-      riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
-      riov[1].iov_base = (FAR void *)buffer;
-      riov[1].iov_len = request.count;
-
-      ret = v9fs_client_rpc(client->transport, wiov, 1, riov, 2,
-                            request.header.tag);
-      if (ret < 0)
-        {
-          break;
-        }
-
-      if (response.count == 0)
-        {
-          break;
-        }
-
-      nread += response.count;
-      offset += response.count;
-      buffer += response.count;
-      buflen -= response.count;
-    }
-
-  return nread ? nread : ret;
+  return v9fs_client_transfer(client, fid, buffer, offset, buflen,
+                              V9FS_TREAD);
 }
 
 /****************************************************************************
@@ -1078,56 +1217,12 @@ ssize_t v9fs_client_write(FAR struct v9fs_client_s *client, uint32_t fid,
                           FAR const void *buffer, off_t offset,
                           size_t buflen)
 {
-  FAR struct v9fs_fid_s *fidp;
-  struct v9fs_write_s request;
-  struct v9fs_rwrite_s response;
-  struct iovec wiov[2];
-  struct iovec riov[1];
-  size_t nwrite = 0;
-  int ret = 0;
-
   /* size[4] Twrite tag[2] fid[4] offset[8] count[4] data[count]
    * size[4] Rwrite tag[2] count[4]
    */
 
-  fidp = idr_find(client->fids, fid);
-  if (fidp == NULL)
-    {
-      return -ENOENT;
-    }
-
-  while (buflen > 0)
-    {
-      request.count = buflen > fidp->iounit ? fidp->iounit : buflen;
-      request.header.size = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                            V9FS_BIT32SZ + request.count;
-      request.header.type = V9FS_TWRITE;
-      request.header.tag = v9fs_get_tagid(client);
-      request.fid = fid;
-      request.offset = offset;
-
-      wiov[0].iov_base = &request;
-      wiov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                        V9FS_BIT32SZ;
-      wiov[1].iov_base = (FAR void *)buffer;
-      wiov[1].iov_len = request.count;
-      riov[0].iov_base = &response;
-      riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
-
-      ret = v9fs_client_rpc(client->transport, wiov, 2, riov, 1,
-                            request.header.tag);
-      if (ret < 0)
-        {
-          break;
-        }
-
-      nwrite += response.count;
-      offset += response.count;
-      buffer += response.count;
-      buflen -= response.count;
-    }
-
-  return nwrite ? nwrite : ret;
+  return v9fs_client_transfer(client, fid, (FAR uint8_t *)buffer, offset,
+                              buflen, V9FS_TWRITE);
 }
 
 /****************************************************************************
@@ -34,6 +34,7 @@
 #include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
+#include "vfs.h"
 
 /****************************************************************************
  * Private Functions
@@ -86,6 +87,7 @@ static int chstat_recursive(FAR const char *path,
           /* Perform the chstat() operation */
 
           ret = inode->u.i_mops->chstat(inode, desc.relpath, buf, flags);
+          pathcache_invalidate(inode);
         }
       else
         {
@@ -114,6 +114,8 @@ int file_close(FAR struct file *filep)
   if (inode)
     {
       file_closelk(filep);
+      readahead_close(filep);
+      pollcache_close(filep);
 
       /* Close the file, driver, or mountpoint. */
 
@@ -124,6 +126,13 @@ int file_close(FAR struct file *filep)
           ret = inode->u.i_ops->close(filep);
         }
 
+      /* Closing a written file may update its status on the volume */
+
+      if (INODE_IS_MOUNTPT(inode) && (filep->f_oflags & O_WROK) != 0)
+        {
+          pathcache_invalidate(inode);
+        }
+
       /* And release the inode */
 
       if (ret >= 0)
@@ -42,6 +42,7 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/tls.h>
 
 #include "inode/inode.h"
@@ -54,8 +55,11 @@
 struct epoll_node_s
 {
   struct list_node         node;
+  struct list_node         rnode;    /* Entry in the ready list */
+  struct list_node         xnode;    /* Entry in g_epoll_exclusive */
   epoll_data_t             data;
   bool                     notified;
+  bool                     woken;    /* EPOLLEXCLUSIVE: woke up a waiter */
   struct pollfd            pfd;
   FAR struct file         *filep;
   FAR struct epoll_head_s *eph;
@@ -67,8 +71,14 @@ struct epoll_head_s
 {
   int                   size;
   int                   crefs;
+  int                   nwaiters; /* Number of threads in epoll_wait() */
   mutex_t               lock;
   sem_t                 sem;
+  spinlock_t            rlock;    /* Protects the ready list */
+  struct list_node      ready;    /* The ready list, store the setuped epoll
+                                   * nodes notified since the last
+                                   * epoll_wait(), in notification order.
+                                   */
   struct list_node      setup;    /* The setup list, store all the setuped
                                    * epoll node.
                                    */
@@ -123,6 +133,12 @@ static const struct file_operations g_epoll_ops =
   epoll_do_poll     /* poll */
 };
 
+/* The nodes added with EPOLLEXCLUSIVE, across all epoll instances */
+
+static spinlock_t g_epoll_xlock = SP_UNLOCKED;
+static struct list_node g_epoll_exclusive =
+  LIST_INITIAL_VALUE(g_epoll_exclusive);
+
 static struct inode g_epoll_inode =
 {
   NULL,                   /* i_parent */
@@ -164,6 +180,108 @@ static FAR epoll_head_t *epoll_head_from_fd(int fd, FAR struct file **filep)
   return (*filep)->f_priv;
 }
 
+/****************************************************************************
+ * Name: epoll_unready
+ *
+ * Description:
+ *   Remove an epoll node from the ready list, if it is queued there.
+ *
+ ****************************************************************************/
+
+static void epoll_unready(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (list_in_list(&epn->rnode))
+    {
+      list_delete(&epn->rnode);
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
+}
+
+/****************************************************************************
+ * Name: epoll_exclusive_remove
+ *
+ * Description:
+ *   Forget an epoll node added with EPOLLEXCLUSIVE.
+ *
+ ****************************************************************************/
+
+static void epoll_exclusive_remove(FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  if ((epn->pfd.events & EPOLLEXCLUSIVE) != 0)
+    {
+      flags = spin_lock_irqsave(&g_epoll_xlock);
+      list_delete(&epn->xnode);
+      epn->woken = false;
+      spin_unlock_irqrestore(&g_epoll_xlock, flags);
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_claim
+ *
+ * Description:
+ *   Decide whether a notification of an EPOLLEXCLUSIVE node should wake up
+ *   a waiter of its epoll instance.  Only one of the instances that watch
+ *   the same file exclusively and have a thread waiting is woken up, until
+ *   that instance has collected the event; the others only queue the node
+ *   on their ready list.
+ *
+ ****************************************************************************/
+
+static bool epoll_claim(FAR epoll_node_t *epn)
+{
+  FAR epoll_node_t *other;
+  irqstate_t flags;
+  bool claim = true;
+
+  /* Nobody sleeps in this instance, so there is no herd to avoid */
+
+  if (epn->eph->nwaiters == 0)
+    {
+      return true;
+    }
+
+  flags = spin_lock_irqsave(&g_epoll_xlock);
+  list_for_every_entry(&g_epoll_exclusive, other, epoll_node_t, xnode)
+    {
+      if (other != epn && other->woken && other->filep == epn->filep)
+        {
+          claim = false;
+          break;
+        }
+    }
+
+  if (claim)
+    {
+      epn->woken = true;
+    }
+
+  spin_unlock_irqrestore(&g_epoll_xlock, flags);
+  return claim;
+}
+
+/****************************************************************************
+ * Name: epoll_unclaim
+ ****************************************************************************/
+
+static void epoll_unclaim(FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  if (epn->woken)
+    {
+      flags = spin_lock_irqsave(&g_epoll_xlock);
+      epn->woken = false;
+      spin_unlock_irqrestore(&g_epoll_xlock, flags);
+    }
+}
+
 static int epoll_do_open(FAR struct file *filep)
 {
   FAR epoll_head_t *eph = filep->f_priv;
@@ -201,11 +319,13 @@ static int epoll_do_close(FAR struct file *filep)
       list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
         {
           file_poll(epn->filep, &epn->pfd, false);
+          epoll_exclusive_remove(epn);
           file_put(epn->filep);
         }
 
       list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
         {
+          epoll_exclusive_remove(epn);
           file_put(epn->filep);
         }
 
@@ -250,12 +370,14 @@ static int epoll_do_create(int size, int flags)
   eph->size = size;
   nxmutex_init(&eph->lock);
   nxsem_init(&eph->sem, 0, 0);
+  spin_lock_init(&eph->rlock);
 
   /* List initialize */
 
   epn = (FAR epoll_node_t *)(eph + 1);
 
   list_initialize(&eph->setup);
+  list_initialize(&eph->ready);
   list_initialize(&eph->teardown);
   list_initialize(&eph->oneshot);
   list_initialize(&eph->extend);
@@ -335,8 +457,13 @@ static int epoll_setup(FAR epoll_head_t *eph)
  * Name: epoll_teardown
  *
  * Description:
- *   Teardown all the notified fd and check the notified fd's event with user
- *   expected event.
+ *   Collect the events of the nodes on the ready list.  Only the nodes
+ *   notified since the last call are visited, so the cost does not depend
+ *   on the number of watched fds.  Level triggered nodes are torn down and
+ *   set up again by the next epoll_setup() to check for pending events;
+ *   edge triggered nodes stay set up and are only reported again when the
+ *   file notifies a new event.  The nodes that do not fit in evs remain on
+ *   the ready list for the next call.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -352,31 +479,46 @@ static int epoll_setup(FAR epoll_head_t *eph)
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents)
 {
-  FAR epoll_node_t *tepn;
+  FAR struct list_node *node;
   FAR epoll_node_t *epn;
+  pollevent_t revents;
+  irqstate_t flags;
+  bool pending;
   int i = 0;
 
   nxmutex_lock(&eph->lock);
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  while (i < maxevents)
     {
-      /* Only check the notified fd */
+      flags = spin_lock_irqsave(&eph->rlock);
+      node = list_remove_head(&eph->ready);
+      if (node == NULL)
+        {
+          spin_unlock_irqrestore(&eph->rlock, flags);
+          break;
+        }
 
-      if (!epn->notified)
+      epn = container_of(node, epoll_node_t, rnode);
+      if ((epn->pfd.events & (EPOLLET | EPOLLONESHOT)) == EPOLLET)
         {
-          continue;
+          /* Keep the node set up, the next notification queues it again */
+
+          revents          = epn->pfd.revents;
+          epn->pfd.revents = 0;
+          epn->notified    = false;
+          spin_unlock_irqrestore(&eph->rlock, flags);
         }
+      else
+        {
+          spin_unlock_irqrestore(&eph->rlock, flags);
 
-      /* Teradown all the notified fd */
+          /* Teardown the notified fd */
 
-      file_poll(epn->filep, &epn->pfd, false);
-      list_delete(&epn->node);
+          file_poll(epn->filep, &epn->pfd, false);
+          list_delete(&epn->node);
 
-      if (epn->pfd.revents != 0 && i < maxevents)
-        {
-          evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
+          revents = epn->pfd.revents;
+          if (revents != 0 && (epn->pfd.events & EPOLLONESHOT) != 0)
             {
               list_add_tail(&eph->oneshot, &epn->node);
             }
@@ -385,9 +527,30 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
               list_add_tail(&eph->teardown, &epn->node);
             }
         }
-      else
+
+      epoll_unclaim(epn);
+
+      if (revents != 0)
+        {
+          evs[i].data     = epn->data;
+          evs[i++].events = revents;
+        }
+    }
+
+  /* Let the next epoll_wait() return at once for the nodes left over */
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  pending = !list_is_empty(&eph->ready);
+  spin_unlock_irqrestore(&eph->rlock, flags);
+
+  if (pending)
+    {
+      int semcount = 0;
+
+      nxsem_get_value(&eph->sem, &semcount);
+      if (semcount < 1)
         {
-          list_add_tail(&eph->teardown, &epn->node);
+          nxsem_post(&eph->sem);
         }
     }
 
@@ -395,6 +558,44 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
   return i;
 }
 
+/****************************************************************************
+ * Name: epoll_wait_ready
+ *
+ * Description:
+ *   Wait until a node is notified or the timeout expires.
+ *
+ ****************************************************************************/
+
+static int epoll_wait_ready(FAR epoll_head_t *eph, int timeout)
+{
+  irqstate_t flags;
+  int ret;
+
+  if (timeout == 0)
+    {
+      return -ETIMEDOUT;
+    }
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  eph->nwaiters++;
+  spin_unlock_irqrestore(&eph->rlock, flags);
+
+  if (timeout > 0)
+    {
+      ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
+    }
+  else
+    {
+      ret = nxsem_wait(&eph->sem);
+    }
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  eph->nwaiters--;
+  spin_unlock_irqrestore(&eph->rlock, flags);
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: epoll_cleanup
  *
@@ -426,10 +627,21 @@ static void epoll_cleanup(FAR void *arg)
 static void epoll_default_cb(FAR struct pollfd *fds)
 {
   FAR epoll_node_t *epn = fds->arg;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
   int semcount = 0;
 
-  epn->notified = true;
-  if (fds->revents != 0)
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (!epn->notified)
+    {
+      epn->notified = true;
+      list_add_tail(&eph->ready, &epn->rnode);
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
+
+  if (fds->revents != 0 &&
+      ((fds->events & EPOLLEXCLUSIVE) == 0 || epoll_claim(epn)))
     {
       nxsem_get_value(&epn->eph->sem, &semcount);
       if (semcount < 1)
@@ -529,6 +741,13 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
       case EPOLL_CTL_ADD:
         finfo("%p CTL ADD: fd=%d ev=%08" PRIx32 "\n", eph, fd, ev->events);
 
+        if ((ev->events & (EPOLLEXCLUSIVE | EPOLLONESHOT)) ==
+            (EPOLLEXCLUSIVE | EPOLLONESHOT))
+          {
+            ret = -EINVAL;
+            goto err;
+          }
+
         /* Check repetition */
 
         list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
@@ -607,6 +826,13 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
             goto err;
           }
 
+        if ((ev->events & EPOLLEXCLUSIVE) != 0)
+          {
+            irqstate_t flags = spin_lock_irqsave(&g_epoll_xlock);
+            list_add_tail(&g_epoll_exclusive, &epn->xnode);
+            spin_unlock_irqrestore(&g_epoll_xlock, flags);
+          }
+
         list_add_tail(&eph->setup, &epn->node);
         break;
 
@@ -617,6 +843,8 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
             if (epn->pfd.fd == fd)
               {
                 file_poll(epn->filep, &epn->pfd, false);
+                epoll_unready(eph, epn);
+                epoll_exclusive_remove(epn);
                 file_put(epn->filep);
                 list_delete(&epn->node);
                 list_add_tail(&eph->free, &epn->node);
@@ -628,6 +856,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
           {
             if (epn->pfd.fd == fd)
               {
+                epoll_exclusive_remove(epn);
                 file_put(epn->filep);
                 list_delete(&epn->node);
                 list_add_tail(&eph->free, &epn->node);
@@ -650,13 +879,29 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 
       case EPOLL_CTL_MOD:
         finfo("%p CTL MOD: fd=%d ev=%08" PRIx32 "\n", eph, fd, ev->events);
+
+        /* EPOLLEXCLUSIVE can only be given to EPOLL_CTL_ADD */
+
+        if ((ev->events & EPOLLEXCLUSIVE) != 0)
+          {
+            ret = -EINVAL;
+            goto err;
+          }
+
         list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
           {
             if (epn->pfd.fd == fd)
               {
+                if ((epn->pfd.events & EPOLLEXCLUSIVE) != 0)
+                  {
+                    ret = -EINVAL;
+                    goto err;
+                  }
+
                 if (epn->pfd.events != (ev->events | POLLALWAYS))
                   {
                     file_poll(epn->filep, &epn->pfd, false);
+                    epoll_unready(eph, epn);
 
                     epn->notified    = false;
                     epn->data        = ev->data;
@@ -678,6 +923,12 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
           {
             if (epn->pfd.fd == fd)
               {
+                if ((epn->pfd.events & EPOLLEXCLUSIVE) != 0)
+                  {
+                    ret = -EINVAL;
+                    goto err;
+                  }
+
                 if (epn->pfd.events != (ev->events | POLLALWAYS))
                   {
                     epn->notified    = false;
@@ -774,18 +1025,7 @@ retry:
 
   tls_cleanup_push(tls_get_info(), epoll_cleanup, filep);
 
-  if (timeout == 0)
-    {
-      ret = -ETIMEDOUT;
-    }
-  else if (timeout > 0)
-    {
-      ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
-    }
-  else
-    {
-      ret = nxsem_wait(&eph->sem);
-    }
+  ret = epoll_wait_ready(eph, timeout);
 
   /* Pop the cancellation point */
 
@@ -857,18 +1097,7 @@ retry:
 
   /* Wait the poll ready */
 
-  if (timeout == 0)
-    {
-      ret = -ETIMEDOUT;
-    }
-  else if (timeout > 0)
-    {
-      ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
-    }
-  else
-    {
-      ret = nxsem_wait(&eph->sem);
-    }
+  ret = epoll_wait_ready(eph, timeout);
 
   /* Pop the cancellation point */
 
@@ -176,6 +176,7 @@ int file_fchstat(FAR struct file *filep, FAR struct stat *buf, int flags)
           /* Perform the fchstat() operation */
 
           ret = inode->u.i_mops->fchstat(filep, buf, flags);
+          pathcache_invalidate(inode);
         }
       else
         {
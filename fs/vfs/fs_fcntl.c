@@ -211,6 +211,12 @@ static int file_vfcntl(FAR struct file *filep, int cmd, va_list ap)
 
         {
           ret = file_ioctl(filep, PIPEIOC_SETSIZE, va_arg(ap, int));
+          if (ret >= 0)
+            {
+              /* Return the capacity, which may have been rounded */
+
+              ret = file_ioctl(filep, PIPEIOC_GETSIZE);
+            }
         }
 
         break;
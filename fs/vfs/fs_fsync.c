@@ -37,6 +37,7 @@
 #include <nuttx/fs/ioctl.h>
 
 #include "inode/inode.h"
+#include "vfs.h"
 
 /****************************************************************************
  * Public Functions
@@ -72,7 +73,9 @@ int file_fsync(FAR struct file *filep)
             {
               /* Yes, then tell the mountpoint to sync this file */
 
-              return inode->u.i_mops->sync(filep);
+              ret = inode->u.i_mops->sync(filep);
+              pathcache_invalidate(inode);
+              return ret;
             }
         }
       else
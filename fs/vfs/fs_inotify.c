@@ -51,6 +51,16 @@
 
  #define ROUND_UP(x, y) (((x) + (y) - 1) / (y) * (y))
 
+/* Size of a preallocated event, which has room for any file name */
+
+#define INOTIFY_POOL_ENTRY \
+  (sizeof(struct inotify_event_s) + \
+   ROUND_UP(NAME_MAX + 1, sizeof(struct inotify_event)))
+
+/* Events that may be folded into an earlier unread one of the same file */
+
+#define INOTIFY_COALESCE (IN_ACCESS | IN_MODIFY | IN_ATTRIB)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -64,6 +74,9 @@ struct inotify_device_s
   int                count;       /* Reference count */
   uint32_t           event_size;  /* Size of the queue (bytes) */
   uint32_t           event_count; /* Number of pending events */
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  struct list_node   pool;        /* Free preallocated events */
+#endif
   FAR struct pollfd *fds[CONFIG_FS_NOTIFY_FD_POLLWAITERS];
 };
 
@@ -202,8 +215,8 @@ static int notify_check_mask(uint32_t mask)
  ****************************************************************************/
 
 static FAR struct inotify_event_s *
-inotify_alloc_event(int wd, uint32_t mask, uint32_t cookie,
-                    FAR const char *name)
+inotify_alloc_event(FAR struct inotify_device_s *dev, int wd,
+                    uint32_t mask, uint32_t cookie, FAR const char *name)
 {
   FAR struct inotify_event_s *event;
   size_t len = 0;
@@ -213,7 +226,21 @@ inotify_alloc_event(int wd, uint32_t mask, uint32_t cookie,
       len = ROUND_UP(strlen(name) + 1, sizeof(struct inotify_event));
     }
 
-  event = fs_heap_malloc(sizeof(struct inotify_event_s) + len);
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  /* Take the event from the pool of the device if it has one left */
+
+  if (!list_is_empty(&dev->pool) &&
+      sizeof(struct inotify_event_s) + len <= INOTIFY_POOL_ENTRY)
+    {
+      event = list_remove_head_type(&dev->pool, struct inotify_event_s,
+                                    node);
+    }
+  else
+#endif
+    {
+      event = fs_heap_malloc(sizeof(struct inotify_event_s) + len);
+    }
+
   if (event == NULL)
     {
       return NULL;
@@ -248,18 +275,33 @@ static void inotify_queue_event(FAR struct inotify_device_s *dev, int wd,
   FAR struct inotify_event_s *last;
   int semcnt;
 
-  if (!list_is_empty(&dev->events))
+  list_for_every_entry_reverse(&dev->events, last,
+                               struct inotify_event_s, node)
     {
-      /* Drop this event if it is a dupe of the previous */
+      /* Look for the last unread event of the same file */
 
-      last = list_last_entry(&dev->events,
-                             struct inotify_event_s, node);
-      if (last->event.mask == mask && last->event.wd == wd &&
-          last->event.cookie == cookie &&
+      if (last->event.wd == wd &&
           ((name == NULL && last->event.len == 0) ||
            (name && last->event.len && !strcmp(name, last->event.name))))
         {
-          return;
+          /* Drop this event if it is a dupe of that one */
+
+          if (last->event.mask == mask && last->event.cookie == cookie)
+            {
+              return;
+            }
+
+          break;
+        }
+
+      /* Only accesses, modifications and attribute changes are folded
+       * into an event that other events were queued after, as the order
+       * of the other events matters.
+       */
+
+      if ((mask & ~INOTIFY_COALESCE) != 0)
+        {
+          break;
         }
     }
 
@@ -271,11 +313,11 @@ static void inotify_queue_event(FAR struct inotify_device_s *dev, int wd,
 
   if (dev->event_count == CONFIG_FS_NOTIFY_MAX_EVENTS)
     {
-      event = inotify_alloc_event(-1, IN_Q_OVERFLOW, cookie, NULL);
+      event = inotify_alloc_event(dev, -1, IN_Q_OVERFLOW, cookie, NULL);
     }
   else
     {
-      event = inotify_alloc_event(wd, mask, cookie, name);
+      event = inotify_alloc_event(dev, wd, mask, cookie, name);
     }
 
   if (event == NULL)
@@ -353,6 +395,20 @@ static void inotify_remove_event(FAR struct inotify_device_s *dev,
   list_delete(&event->node);
   dev->event_size -= sizeof(struct inotify_event) + event->event.len;
   dev->event_count--;
+
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  /* Events of the pool live right after the device */
+
+  if ((FAR uint8_t *)event >= (FAR uint8_t *)(dev + 1) &&
+      (FAR uint8_t *)event < (FAR uint8_t *)(dev + 1) +
+                             CONFIG_FS_NOTIFY_EVENT_POOL *
+                             INOTIFY_POOL_ENTRY)
+    {
+      list_add_head(&dev->pool, &event->node);
+      return;
+    }
+#endif
+
   fs_heap_free(event);
 }
 
@@ -367,8 +423,13 @@ static void inotify_remove_event(FAR struct inotify_device_s *dev,
 static FAR struct inotify_device_s *inotify_alloc_device(void)
 {
   FAR struct inotify_device_s *dev;
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  FAR uint8_t *entry;
+  int i;
+#endif
 
-  dev = fs_heap_zalloc(sizeof(struct inotify_device_s));
+  dev = fs_heap_zalloc(sizeof(struct inotify_device_s) +
+                       CONFIG_FS_NOTIFY_EVENT_POOL * INOTIFY_POOL_ENTRY);
   if (dev == NULL)
     {
       return dev;
@@ -379,6 +440,22 @@ static FAR struct inotify_device_s *inotify_alloc_device(void)
   nxsem_init(&dev->sem, 0, 0);
   list_initialize(&dev->events);
   list_initialize(&dev->watches);
+
+#if CONFIG_FS_NOTIFY_EVENT_POOL > 0
+  /* Keep a few events with the device, so that bursts of events are
+   * queued without going through the heap.
+   */
+
+  list_initialize(&dev->pool);
+  entry = (FAR uint8_t *)(dev + 1);
+  for (i = 0; i < CONFIG_FS_NOTIFY_EVENT_POOL; i++)
+    {
+      list_add_tail(&dev->pool,
+                    &((FAR struct inotify_event_s *)entry)->node);
+      entry += INOTIFY_POOL_ENTRY;
+    }
+#endif
+
   return dev;
 }
 
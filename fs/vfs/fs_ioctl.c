@@ -119,6 +119,17 @@ static int file_vioctl(FAR struct file *filep, int req, va_list ap)
           }
         break;
 
+#ifdef CONFIG_FS_READAHEAD
+      case FIOC_FADVISE:
+        if (ret == -ENOTTY)
+          {
+            ret = readahead_advise(filep,
+                                   (FAR const struct fadvise_s *)
+                                   (uintptr_t)arg);
+          }
+        break;
+
+#endif
 #ifndef CONFIG_DISABLE_MOUNTPOINT
       case BIOC_BLKSSZGET:
         if (ret == -ENOTTY && inode->u.i_ops != NULL &&
@@ -106,6 +106,7 @@ int mkdir(const char *pathname, mode_t mode)
       if (inode->u.i_mops->mkdir)
         {
           ret = inode->u.i_mops->mkdir(inode, desc.relpath, mode);
+          pathcache_invalidate(inode);
           if (ret < 0)
             {
               errcode = -ret;
@@ -245,7 +245,31 @@ static int file_vopen(FAR struct file *filep, FAR const char *path,
     {
       if (inode->u.i_mops->open != NULL)
         {
-          ret = inode->u.i_mops->open(filep, desc.relpath, oflags, mode);
+          uint32_t gen;
+
+          /* Paths known not to exist need not be looked up again, unless
+           * they are about to be created.
+           */
+
+          ret = -EAGAIN;
+          if ((oflags & O_CREAT) == 0)
+            {
+              ret = pathcache_lookup(inode, desc.relpath, NULL, &gen);
+            }
+
+          if (ret != -ENOENT)
+            {
+              ret = inode->u.i_mops->open(filep, desc.relpath, oflags,
+                                          mode);
+              if ((oflags & (O_CREAT | O_TRUNC)) != 0)
+                {
+                  pathcache_invalidate(inode);
+                }
+              else if (ret == -ENOENT)
+                {
+                  pathcache_add(inode, desc.relpath, NULL, gen);
+                }
+            }
         }
     }
 #endif
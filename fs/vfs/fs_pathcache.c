@@ -0,0 +1,221 @@
+/****************************************************************************
+ * fs/vfs/fs_pathcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* A small, direct-mapped cache of path lookups on mounted volumes.  An
+ * entry records, for a relative path below a mountpoint, either the
+ * result of a successful stat() or the fact that the path does not exist.
+ * Every modification made through the VFS drops all of the entries of the
+ * affected mountpoint, so the cache never has to reason about which paths
+ * an operation touched.
+ *
+ * A lookup that raced with a modification must not be entered afterwards.
+ * Each invalidation therefore bumps a generation count, and a miss returns
+ * the count at the time of the miss; pathcache_add() discards the result
+ * if the count has moved on since then.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
+
+#include "vfs.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pathcache_entry_s
+{
+  FAR struct inode *mountpt;   /* Mountpoint, NULL if the entry is unused */
+  int               result;    /* OK or -ENOENT */
+  struct stat       st;        /* Status of the path if result is OK */
+  char              relpath[CONFIG_FS_PATHCACHE_PATHLEN];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct pathcache_entry_s g_pathcache[CONFIG_FS_PATHCACHE_ENTRIES];
+static mutex_t g_pathcache_lock = NXMUTEX_INITIALIZER;
+static uint32_t g_pathcache_gen;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pathcache_entry
+ *
+ * Description:
+ *   Return the cache entry that 'relpath' below 'mountpt' maps to, or NULL
+ *   if the path is too long to be cached.
+ *
+ ****************************************************************************/
+
+static FAR struct pathcache_entry_s *
+pathcache_entry(FAR struct inode *mountpt, FAR const char *relpath)
+{
+  uint32_t hash = 2166136261u ^ (uint32_t)(uintptr_t)mountpt;
+  size_t len = 0;
+
+  while (relpath[len] != '\0')
+    {
+      hash = (hash ^ (uint8_t)relpath[len++]) * 16777619u;
+    }
+
+  if (len >= CONFIG_FS_PATHCACHE_PATHLEN)
+    {
+      return NULL;
+    }
+
+  return &g_pathcache[(hash ^ (hash >> 16)) %
+                      CONFIG_FS_PATHCACHE_ENTRIES];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pathcache_lookup
+ *
+ * Description:
+ *   Look 'relpath' below 'mountpt' up in the path cache.
+ *
+ * Input Parameters:
+ *   mountpt - The mountpoint inode
+ *   relpath - The path relative to the mountpoint
+ *   buf     - The location to return the status of the path, may be NULL
+ *   gen     - The location to return the generation to pass to
+ *             pathcache_add() on a miss
+ *
+ * Returned Value:
+ *   OK if the path is known to exist (with its status in 'buf'), -ENOENT
+ *   if it is known not to exist and -EAGAIN if the cache does not know.
+ *
+ ****************************************************************************/
+
+int pathcache_lookup(FAR struct inode *mountpt, FAR const char *relpath,
+                     FAR struct stat *buf, FAR uint32_t *gen)
+{
+  FAR struct pathcache_entry_s *entry;
+  int ret = -EAGAIN;
+
+  entry = pathcache_entry(mountpt, relpath);
+
+  nxmutex_lock(&g_pathcache_lock);
+  *gen = g_pathcache_gen;
+  if (entry != NULL && entry->mountpt == mountpt &&
+      strcmp(entry->relpath, relpath) == 0)
+    {
+      ret = entry->result;
+      if (ret == OK && buf != NULL)
+        {
+          *buf = entry->st;
+        }
+    }
+
+  nxmutex_unlock(&g_pathcache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pathcache_add
+ *
+ * Description:
+ *   Remember the outcome of a lookup of 'relpath' below 'mountpt'.  'buf'
+ *   is the status of the path, or NULL if the path does not exist.  'gen'
+ *   is the generation returned by the pathcache_lookup() that missed.
+ *
+ ****************************************************************************/
+
+void pathcache_add(FAR struct inode *mountpt, FAR const char *relpath,
+                   FAR const struct stat *buf, uint32_t gen)
+{
+  FAR struct pathcache_entry_s *entry;
+
+  entry = pathcache_entry(mountpt, relpath);
+  if (entry == NULL)
+    {
+      return;
+    }
+
+  nxmutex_lock(&g_pathcache_lock);
+  if (gen != g_pathcache_gen)
+    {
+      nxmutex_unlock(&g_pathcache_lock);
+      return;
+    }
+
+  entry->mountpt = mountpt;
+  strcpy(entry->relpath, relpath);
+  if (buf != NULL)
+    {
+      entry->result = OK;
+      entry->st     = *buf;
+    }
+  else
+    {
+      entry->result = -ENOENT;
+    }
+
+  nxmutex_unlock(&g_pathcache_lock);
+}
+
+/****************************************************************************
+ * Name: pathcache_invalidate
+ *
+ * Description:
+ *   Forget everything cached about the paths below 'mountpt'.  This must be
+ *   called after any operation that may have created, removed, renamed or
+ *   changed the status of a file on the mounted volume, whether or not the
+ *   operation succeeded.
+ *
+ ****************************************************************************/
+
+void pathcache_invalidate(FAR struct inode *mountpt)
+{
+  int i;
+
+  nxmutex_lock(&g_pathcache_lock);
+  g_pathcache_gen++;
+  for (i = 0; i < CONFIG_FS_PATHCACHE_ENTRIES; i++)
+    {
+      if (g_pathcache[i].mountpt == mountpt)
+        {
+          g_pathcache[i].mountpt = NULL;
+        }
+    }
+
+  nxmutex_unlock(&g_pathcache_lock);
+}
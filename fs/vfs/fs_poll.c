@@ -42,6 +42,7 @@
 #include <arch/irq.h>
 
 #include "inode/inode.h"
+#include "vfs.h"
 #include "fs_heap.h"
 
 /****************************************************************************
@@ -427,6 +428,24 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
 
   enter_cancellation_point();
 
+#ifdef CONFIG_FS_POLL_CACHE
+  /* Keep the registrations of small sets in the poll cache of the thread.
+   * The cache never passes the fds to the drivers, so no kernel copy is
+   * needed either.
+   */
+
+  if (nfds > 0 && nfds <= CONFIG_FS_POLL_CACHE_MAXFDS)
+    {
+      count = pollcache_wait(fds, nfds, timeout);
+      if (count < 0)
+        {
+          ret = count;
+        }
+
+      goto out_with_cancelpt;
+    }
+#endif
+
 #ifdef CONFIG_BUILD_KERNEL
   /* Allocate kernel memory for the fds */
 
@@ -538,7 +557,9 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
   /* Free the temporary buffer */
 
   fs_heap_free(kfds);
+#endif
 
+#if defined(CONFIG_BUILD_KERNEL) || defined(CONFIG_FS_POLL_CACHE)
 out_with_cancelpt:
 #endif
 
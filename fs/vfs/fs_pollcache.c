@@ -0,0 +1,572 @@
+/****************************************************************************
+ * fs/vfs/fs_pollcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Most programs call poll() in a loop with the same descriptors every time,
+ * yet poll() sets up and tears down the wait of every descriptor on each
+ * call.  The poll cache of a thread keeps the registrations of its last
+ * call instead.  Descriptors that did not change and reported no event
+ * keep waiting across calls, so that a call only has to look up every
+ * descriptor and to re-arm those that reported an event, which must be
+ * asked again whether they are still ready.
+ *
+ * A registration holds no reference to its file between two calls, so a
+ * close() is never delayed by it.  file_close() removes the registrations
+ * of a file before the file goes away instead.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/tls.h>
+
+#include "inode/inode.h"
+#include "sched/sched.h"
+#include "vfs.h"
+#include "fs_heap.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One registration: the pollfd given to the driver and the file it was
+ * given to.  filep is NULL when the entry is not registered.
+ */
+
+struct pollcache_ent_s
+{
+  struct pollfd               pfd;    /* Registered with the driver */
+  FAR struct file            *filep;  /* The file it is registered on */
+  FAR struct pollcache_ent_s *flink;  /* Next registration on filep */
+};
+
+/* The poll cache of a thread and the registrations of its last call */
+
+struct pollcache_s
+{
+  sem_t                       sem;    /* Posted by every registration */
+  nfds_t                      nents;  /* Number of entries in use */
+  nfds_t                      nalloc; /* Number of entries allocated */
+  nfds_t                      nheld;  /* Entries holding a reference */
+  FAR struct pollcache_ent_s *ents;   /* Entry i caches fds[i] */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Protects the registration lists of the files and the filep fields of
+ * the entries whose file the owning thread holds no reference to.
+ */
+
+static mutex_t g_pollcache_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pollcache_link / pollcache_unlink
+ *
+ * Description:
+ *   Add an entry to or remove it from the registrations of its file.  The
+ *   caller holds g_pollcache_lock.
+ *
+ ****************************************************************************/
+
+static void pollcache_link(FAR struct pollcache_ent_s *ent,
+                           FAR struct file *filep)
+{
+  ent->filep     = filep;
+  ent->flink     = filep->f_polls;
+  filep->f_polls = ent;
+}
+
+static void pollcache_unlink(FAR struct pollcache_ent_s *ent)
+{
+  FAR struct pollcache_ent_s **link = &ent->filep->f_polls;
+
+  while (*link != ent)
+    {
+      DEBUGASSERT(*link != NULL);
+      link = &(*link)->flink;
+    }
+
+  *link      = ent->flink;
+  ent->filep = NULL;
+}
+
+/****************************************************************************
+ * Name: pollcache_drop
+ *
+ * Description:
+ *   Tear the registration of an entry down, if it is still registered.
+ *   The file may be closing concurrently on another thread, so this is
+ *   done with the lock held.
+ *
+ ****************************************************************************/
+
+static void pollcache_drop(FAR struct pollcache_ent_s *ent)
+{
+  nxmutex_lock(&g_pollcache_lock);
+
+  if (ent->filep != NULL)
+    {
+      file_poll(ent->filep, &ent->pfd, false);
+      pollcache_unlink(ent);
+    }
+
+  nxmutex_unlock(&g_pollcache_lock);
+}
+
+/****************************************************************************
+ * Name: pollcache_arm
+ *
+ * Description:
+ *   Register an entry with a file the caller holds a reference to.  The
+ *   driver reports the events that are already pending right away.
+ *
+ ****************************************************************************/
+
+static int pollcache_arm(FAR struct pollcache_s *pc,
+                         FAR struct pollcache_ent_s *ent,
+                         FAR struct file *filep, FAR struct pollfd *fds)
+{
+  int ret;
+
+  ent->pfd.fd      = fds->fd;
+  ent->pfd.events  = fds->events;
+  ent->pfd.revents = 0;
+  ent->pfd.arg     = &pc->sem;
+  ent->pfd.cb      = poll_default_cb;
+  ent->pfd.priv    = NULL;
+
+  ret = file_poll(filep, &ent->pfd, true);
+  if (ret >= 0)
+    {
+      nxmutex_lock(&g_pollcache_lock);
+      pollcache_link(ent, filep);
+      nxmutex_unlock(&g_pollcache_lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pollcache_rearm
+ *
+ * Description:
+ *   Ask the driver again whether a registered entry that reported an event
+ *   is still ready.  The caller holds a reference to the file, so the
+ *   registration cannot be removed concurrently.
+ *
+ ****************************************************************************/
+
+static int pollcache_rearm(FAR struct pollcache_s *pc,
+                           FAR struct pollcache_ent_s *ent,
+                           FAR struct pollfd *fds)
+{
+  FAR struct file *filep = ent->filep;
+
+  file_poll(filep, &ent->pfd, false);
+
+  nxmutex_lock(&g_pollcache_lock);
+  pollcache_unlink(ent);
+  nxmutex_unlock(&g_pollcache_lock);
+
+  return pollcache_arm(pc, ent, filep, fds);
+}
+
+/****************************************************************************
+ * Name: pollcache_put
+ *
+ * Description:
+ *   Release the references taken on the files of the current call.  The
+ *   registrations stay in place, unless a reference is the last one and
+ *   the file is closed, which removes them.
+ *
+ ****************************************************************************/
+
+static void pollcache_put(FAR struct pollcache_s *pc)
+{
+  nfds_t nheld = pc->nheld;
+  nfds_t i;
+
+  pc->nheld = 0;
+  for (i = 0; i < nheld; i++)
+    {
+      FAR struct file *filep = pc->ents[i].filep;
+
+      if (filep != NULL)
+        {
+          file_put(filep);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pollcache_cleanup
+ *
+ * Description:
+ *   Release the references of the current call if the thread is canceled
+ *   while it waits.
+ *
+ ****************************************************************************/
+
+static void pollcache_cleanup(FAR void *arg)
+{
+  pollcache_put((FAR struct pollcache_s *)arg);
+}
+
+/****************************************************************************
+ * Name: pollcache_count
+ *
+ * Description:
+ *   Return the number of entries of the current call that have events.
+ *
+ ****************************************************************************/
+
+static int pollcache_count(FAR struct pollcache_s *pc, nfds_t nfds)
+{
+  int count = 0;
+  nfds_t i;
+
+  for (i = 0; i < nfds; i++)
+    {
+      if (pc->ents[i].pfd.revents != 0)
+        {
+          count++;
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: pollcache_get
+ *
+ * Description:
+ *   Return the poll cache of the calling thread with room for nfds
+ *   entries, allocating it on first use.  Entries beyond nfds are torn
+ *   down, since they would only cause spurious wake-ups.
+ *
+ ****************************************************************************/
+
+static FAR struct pollcache_s *pollcache_get(nfds_t nfds)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  FAR struct pollcache_s *pc = rtcb->pollcache;
+  nfds_t i;
+
+  if (pc == NULL)
+    {
+      pc = fs_heap_zalloc(sizeof(struct pollcache_s));
+      if (pc == NULL)
+        {
+          return NULL;
+        }
+
+      nxsem_init(&pc->sem, 0, 0);
+      rtcb->pollcache = pc;
+    }
+
+  if (nfds > pc->nalloc)
+    {
+      FAR struct pollcache_ent_s *ents;
+
+      /* The registration lists point into the array, so the entries are
+       * torn down before it is replaced.
+       */
+
+      for (i = 0; i < pc->nents; i++)
+        {
+          pollcache_drop(&pc->ents[i]);
+        }
+
+      ents = fs_heap_zalloc(nfds * sizeof(struct pollcache_ent_s));
+      if (ents == NULL)
+        {
+          return NULL;
+        }
+
+      fs_heap_free(pc->ents);
+      pc->ents   = ents;
+      pc->nalloc = nfds;
+      pc->nents  = 0;
+    }
+
+  for (i = nfds; i < pc->nents; i++)
+    {
+      pollcache_drop(&pc->ents[i]);
+    }
+
+  pc->nents = nfds;
+  return pc;
+}
+
+/****************************************************************************
+ * Name: pollcache_setup
+ *
+ * Description:
+ *   Bring the registrations in line with fds and return the number of
+ *   entries that have events.  A reference is taken on the file of every
+ *   registered entry.
+ *
+ ****************************************************************************/
+
+static int pollcache_setup(FAR struct pollcache_s *pc,
+                           FAR struct pollfd *fds, nfds_t nfds)
+{
+  int count = 0;
+  nfds_t i;
+
+  for (i = 0; i < nfds; i++)
+    {
+      FAR struct pollcache_ent_s *ent = &pc->ents[i];
+      FAR struct file *filep;
+      int ret;
+
+      pc->nheld = i + 1;
+
+      /* "If the value of fd is less than 0, events shall be ignored, and
+       * revents shall be set to 0 in that entry on return from poll()."
+       */
+
+      if (fds[i].fd < 0)
+        {
+          pollcache_drop(ent);
+          ent->pfd.fd      = fds[i].fd;
+          ent->pfd.revents = 0;
+          continue;
+        }
+
+      ret = file_get(fds[i].fd, &filep);
+      if (ret < 0)
+        {
+          pollcache_drop(ent);
+          ent->pfd.revents = POLLERR;
+          count++;
+          continue;
+        }
+
+      if (ent->filep == filep && ent->pfd.fd == fds[i].fd &&
+          ent->pfd.events == fds[i].events)
+        {
+          /* Still registered as asked.  It keeps waiting unless it has
+           * reported an event, which may no longer be true.
+           */
+
+          ret = ent->pfd.revents != 0 ?
+                pollcache_rearm(pc, ent, &fds[i]) : OK;
+        }
+      else
+        {
+          pollcache_drop(ent);
+          ret = pollcache_arm(pc, ent, filep, &fds[i]);
+        }
+
+      if (ret < 0)
+        {
+          file_put(filep);
+          ent->pfd.revents = POLLERR;
+        }
+
+      if (ent->pfd.revents != 0)
+        {
+          count++;
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pollcache_wait
+ *
+ * Description:
+ *   poll() on the registrations kept in the poll cache of the calling
+ *   thread.
+ *
+ * Returned Value:
+ *   The number of descriptors with events, zero on a timeout or a negated
+ *   errno value on failure.
+ *
+ ****************************************************************************/
+
+int pollcache_wait(FAR struct pollfd *fds, nfds_t nfds, int timeout)
+{
+  FAR struct pollcache_s *pc;
+  clock_t deadline = 0;
+  int count;
+  int ret = OK;
+  nfds_t i;
+
+  pc = pollcache_get(nfds);
+  if (pc == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  if (timeout > 0)
+    {
+      deadline = clock_systime_ticks() + MSEC2TICK((clock_t)timeout);
+    }
+
+  /* Posts left over from earlier calls are for events that are either
+   * seen below or no longer of interest.
+   */
+
+  while (nxsem_trywait(&pc->sem) >= 0);
+
+  count = pollcache_setup(pc, fds, nfds);
+  if (count == 0 && timeout != 0)
+    {
+      tls_cleanup_push(tls_get_info(), pollcache_cleanup, pc);
+
+      /* The semaphore is also posted by events that were reported and then
+       * cleared again, so wait until an entry really has an event.
+       */
+
+      do
+        {
+          if (timeout < 0)
+            {
+              ret = nxsem_wait(&pc->sem);
+            }
+          else
+            {
+              sclock_t delay = deadline - clock_systime_ticks();
+
+              ret = delay > 0 ? nxsem_tickwait(&pc->sem, delay) :
+                                -ETIMEDOUT;
+            }
+
+          if (ret < 0)
+            {
+              /* Return zero (OK) in the event of a timeout.  EINTR is the
+               * only other error expected in normal operation.
+               */
+
+              if (ret == -ETIMEDOUT)
+                {
+                  ret = OK;
+                }
+
+              break;
+            }
+
+          count = pollcache_count(pc, nfds);
+        }
+      while (count == 0);
+
+      tls_cleanup_pop(tls_get_info(), 0);
+    }
+
+  if (ret >= 0)
+    {
+      count = pollcache_count(pc, nfds);
+      for (i = 0; i < nfds; i++)
+        {
+          fds[i].revents = pc->ents[i].pfd.revents;
+        }
+    }
+
+  pollcache_put(pc);
+  return ret < 0 ? ret : count;
+}
+
+/****************************************************************************
+ * Name: pollcache_close
+ *
+ * Description:
+ *   Remove the registrations of a file that is being closed.
+ *
+ ****************************************************************************/
+
+void pollcache_close(FAR struct file *filep)
+{
+  FAR struct pollcache_ent_s *ent;
+
+  if (filep->f_polls == NULL)
+    {
+      return;
+    }
+
+  nxmutex_lock(&g_pollcache_lock);
+
+  while ((ent = filep->f_polls) != NULL)
+    {
+      file_poll(filep, &ent->pfd, false);
+      pollcache_unlink(ent);
+    }
+
+  nxmutex_unlock(&g_pollcache_lock);
+}
+
+/****************************************************************************
+ * Name: pollcache_release
+ *
+ * Description:
+ *   Tear down the poll cache of a thread that exits.
+ *
+ ****************************************************************************/
+
+void pollcache_release(FAR struct tcb_s *tcb)
+{
+  FAR struct pollcache_s *pc = tcb->pollcache;
+  nfds_t i;
+
+  if (pc == NULL)
+    {
+      return;
+    }
+
+  /* A thread deleted while it waits still holds its references */
+
+  pollcache_put(pc);
+
+  for (i = 0; i < pc->nents; i++)
+    {
+      pollcache_drop(&pc->ents[i]);
+    }
+
+  tcb->pollcache = NULL;
+  nxsem_destroy(&pc->sem);
+  fs_heap_free(pc->ents);
+  fs_heap_free(pc);
+}
@@ -206,6 +206,15 @@ ssize_t file_readv(FAR struct file *filep,
 
   else if (inode != NULL && inode->u.i_ops)
     {
+#ifdef CONFIG_FS_READAHEAD
+      /* Sequential reads of regular files may be served ahead of time */
+
+      if (iovcnt == 1 && readahead_eligible(filep))
+        {
+          ret = readahead_read(filep, iov[0].iov_base, iov[0].iov_len);
+        }
+      else
+#endif
       if (inode->u.i_ops->readv)
         {
           struct uio uio;
@@ -0,0 +1,517 @@
+/****************************************************************************
+ * fs/vfs/fs_readahead.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+
+#include "inode/inode.h"
+#include "vfs.h"
+#include "fs_heap.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The readahead state of an open file.  The reader consumes one buffer
+ * while the worker fills the other one with the data that follows it,
+ * through a private open of the same file so that the file position of
+ * the reader is never disturbed.
+ */
+
+struct readahead_s
+{
+  struct file   file;         /* Private open of the file used by the worker */
+  struct work_s work;         /* Fills buf[fill] asynchronously */
+  mutex_t       lock;         /* Protects the fields below */
+  sem_t         done;         /* Posted when a fill completes */
+  FAR uint8_t  *buf[2];       /* Allocated when readahead starts */
+  off_t         start[2];     /* File offset of the data in each buffer */
+  size_t        len[2];       /* Number of valid bytes in each buffer */
+  uint32_t      gen[2];       /* Write generation each buffer was read in */
+  off_t         next;         /* File offset following the last read */
+  uint8_t       fill;         /* The buffer being filled while busy */
+  uint8_t       nseq;         /* Number of consecutive sequential reads */
+  uint8_t       advice;       /* The last POSIX_FADV_* advice */
+  bool          busy;         /* The worker owns buf[fill] */
+  bool          waiting;      /* The reader waits for the worker */
+  bool          seekneeded;   /* The file system position lags f_pos */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Serializes the creation of per-file state */
+
+static mutex_t g_readahead_lock = NXMUTEX_INITIALIZER;
+
+/* Incremented on every write to a mounted volume.  Data read ahead in an
+ * older generation may be stale and is never returned.
+ */
+
+static atomic_t g_readahead_gen;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: readahead_get
+ *
+ * Description:
+ *   Return the readahead state of 'filep', creating it on first use.
+ *
+ ****************************************************************************/
+
+static FAR struct readahead_s *readahead_get(FAR struct file *filep)
+{
+  FAR struct readahead_s *ra = filep->f_ra;
+
+  if (ra == NULL)
+    {
+      nxmutex_lock(&g_readahead_lock);
+
+      ra = filep->f_ra;
+      if (ra == NULL)
+        {
+          ra = fs_heap_zalloc(sizeof(struct readahead_s));
+          if (ra != NULL)
+            {
+              nxmutex_init(&ra->lock);
+              nxsem_init(&ra->done, 0, 0);
+              ra->next   = filep->f_pos;
+              ra->advice = POSIX_FADV_NORMAL;
+              filep->f_ra = ra;
+            }
+        }
+
+      nxmutex_unlock(&g_readahead_lock);
+    }
+
+  return ra;
+}
+
+/****************************************************************************
+ * Name: readahead_hit
+ *
+ * Description:
+ *   Return true if buffer 'i' holds valid data at file offset 'pos'.
+ *
+ ****************************************************************************/
+
+static bool readahead_hit(FAR struct readahead_s *ra, int i, off_t pos)
+{
+  return !(ra->busy && ra->fill == i) && ra->len[i] > 0 &&
+         ra->gen[i] == (uint32_t)atomic_read(&g_readahead_gen) &&
+         pos >= ra->start[i] && pos - ra->start[i] < ra->len[i];
+}
+
+/****************************************************************************
+ * Name: readahead_worker
+ *
+ * Description:
+ *   Fill buf[fill] from the private open of the file.
+ *
+ ****************************************************************************/
+
+static void readahead_worker(FAR void *arg)
+{
+  FAR struct readahead_s *ra = arg;
+  FAR struct inode *inode = ra->file.f_inode;
+  FAR uint8_t *buf;
+  ssize_t nread;
+  size_t len = 0;
+  off_t start;
+
+  nxmutex_lock(&ra->lock);
+  buf   = ra->buf[ra->fill];
+  start = ra->start[ra->fill];
+  nxmutex_unlock(&ra->lock);
+
+  if (inode->u.i_ops->seek(&ra->file, start, SEEK_SET) == start)
+    {
+      while (len < CONFIG_FS_READAHEAD_SIZE)
+        {
+          nread = inode->u.i_ops->read(&ra->file, (FAR char *)buf + len,
+                                       CONFIG_FS_READAHEAD_SIZE - len);
+          if (nread <= 0)
+            {
+              break;
+            }
+
+          len += nread;
+        }
+    }
+
+  nxmutex_lock(&ra->lock);
+
+  ra->len[ra->fill] = len;
+  ra->busy = false;
+
+  if (ra->waiting)
+    {
+      ra->waiting = false;
+      nxsem_post(&ra->done);
+    }
+
+  nxmutex_unlock(&ra->lock);
+}
+
+/****************************************************************************
+ * Name: readahead_fill
+ *
+ * Description:
+ *   Start filling buffer 'i' with the data at file offset 'start'.  The
+ *   buffers and the private open of the file are set up on first use.
+ *
+ * Assumptions:
+ *   The caller holds ra->lock and no fill is in progress.
+ *
+ ****************************************************************************/
+
+static void readahead_fill(FAR struct readahead_s *ra,
+                           FAR struct file *filep, int i, off_t start)
+{
+  DEBUGASSERT(!ra->busy);
+
+  if (ra->buf[0] == NULL)
+    {
+      ra->buf[0] = fs_heap_malloc(2 * CONFIG_FS_READAHEAD_SIZE);
+      if (ra->buf[0] == NULL || file_dup2(filep, &ra->file) < 0)
+        {
+          /* Stop trying on this file */
+
+          fs_heap_free(ra->buf[0]);
+          ra->buf[0] = NULL;
+          ra->advice = POSIX_FADV_RANDOM;
+          return;
+        }
+
+      ra->buf[1] = ra->buf[0] + CONFIG_FS_READAHEAD_SIZE;
+    }
+
+  ra->fill     = i;
+  ra->start[i] = start;
+  ra->len[i]   = 0;
+  ra->gen[i]   = atomic_read(&g_readahead_gen);
+  ra->busy     = true;
+
+  work_queue(LPWORK, &ra->work, readahead_worker, ra, 0);
+}
+
+/****************************************************************************
+ * Name: readahead_schedule
+ *
+ * Description:
+ *   Once the access pattern looks sequential, make sure that the window
+ *   following the current file position is being read ahead.
+ *
+ * Assumptions:
+ *   The caller holds ra->lock.
+ *
+ ****************************************************************************/
+
+static void readahead_schedule(FAR struct readahead_s *ra,
+                               FAR struct file *filep)
+{
+  off_t pos = filep->f_pos;
+  int i;
+
+  if (ra->busy || ra->advice == POSIX_FADV_RANDOM ||
+      (ra->advice != POSIX_FADV_SEQUENTIAL &&
+       ra->nseq < CONFIG_FS_READAHEAD_TRIGGER))
+    {
+      return;
+    }
+
+  for (i = 0; i < 2; i++)
+    {
+      if (readahead_hit(ra, i, pos))
+        {
+          /* A short buffer ended at the end of the file.  Otherwise read
+           * the data that follows it into the other buffer.
+           */
+
+          pos = ra->start[i] + ra->len[i];
+          if (ra->len[i] < CONFIG_FS_READAHEAD_SIZE ||
+              readahead_hit(ra, i ^ 1, pos))
+            {
+              return;
+            }
+
+          readahead_fill(ra, filep, i ^ 1, pos);
+          return;
+        }
+    }
+
+  readahead_fill(ra, filep, 0, pos);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: readahead_eligible
+ ****************************************************************************/
+
+bool readahead_eligible(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+
+  return INODE_IS_MOUNTPT(inode) && (filep->f_oflags & O_WROK) == 0 &&
+         inode->u.i_mops->read != NULL && inode->u.i_mops->seek != NULL &&
+         inode->u.i_mops->dup != NULL;
+}
+
+/****************************************************************************
+ * Name: readahead_read
+ ****************************************************************************/
+
+ssize_t readahead_read(FAR struct file *filep, FAR void *buffer,
+                       size_t nbytes)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct readahead_s *ra;
+  size_t nread = 0;
+  ssize_t ret;
+  size_t n;
+  off_t pos;
+  int i;
+
+  if (nbytes > SSIZE_MAX)
+    {
+      return -EINVAL;
+    }
+
+  ra = readahead_get(filep);
+  if (ra == NULL)
+    {
+      return inode->u.i_ops->read(filep, buffer, nbytes);
+    }
+
+  nxmutex_lock(&ra->lock);
+
+  if (filep->f_pos != ra->next)
+    {
+      ra->nseq = 0;
+    }
+  else if (ra->nseq < UINT8_MAX)
+    {
+      ra->nseq++;
+    }
+
+  /* Copy whatever has been read ahead, waiting for a fill in progress if
+   * it covers the file position.
+   */
+
+  while (nread < nbytes)
+    {
+      pos = filep->f_pos;
+
+      for (i = 0; i < 2 && !readahead_hit(ra, i, pos); i++);
+
+      if (i < 2)
+        {
+          n = MIN(nbytes - nread, ra->start[i] + ra->len[i] - pos);
+          memcpy((FAR uint8_t *)buffer + nread,
+                 ra->buf[i] + (pos - ra->start[i]), n);
+
+          nread           += n;
+          filep->f_pos    += n;
+          ra->seekneeded   = true;
+
+          readahead_schedule(ra, filep);
+        }
+      else if (ra->busy && pos >= ra->start[ra->fill] &&
+               pos - ra->start[ra->fill] < CONFIG_FS_READAHEAD_SIZE)
+        {
+          ra->waiting = true;
+          nxmutex_unlock(&ra->lock);
+          nxsem_wait_uninterruptible(&ra->done);
+          nxmutex_lock(&ra->lock);
+        }
+      else
+        {
+          break;
+        }
+    }
+
+  /* Read the rest directly, after moving the file system position to the
+   * data served from the buffers.
+   */
+
+  ret = OK;
+  if (nread < nbytes)
+    {
+      if (ra->seekneeded)
+        {
+          ret = inode->u.i_ops->seek(filep, filep->f_pos, SEEK_SET);
+          if (ret >= 0)
+            {
+              ra->seekneeded = false;
+            }
+        }
+
+      if (ret >= 0)
+        {
+          ret = inode->u.i_ops->read(filep, (FAR char *)buffer + nread,
+                                     nbytes - nread);
+          if (ret > 0)
+            {
+              nread += ret;
+            }
+        }
+    }
+
+  ra->next = filep->f_pos;
+  readahead_schedule(ra, filep);
+  nxmutex_unlock(&ra->lock);
+
+  return nread > 0 || ret >= 0 ? (ssize_t)nread : ret;
+}
+
+/****************************************************************************
+ * Name: readahead_advise
+ ****************************************************************************/
+
+int readahead_advise(FAR struct file *filep,
+                     FAR const struct fadvise_s *fadv)
+{
+  FAR struct readahead_s *ra;
+  int i;
+
+  if (fadv == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (!readahead_eligible(filep))
+    {
+      return -ENOTTY;
+    }
+
+  ra = readahead_get(filep);
+  if (ra == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_lock(&ra->lock);
+
+  switch (fadv->advice)
+    {
+      case POSIX_FADV_NORMAL:
+      case POSIX_FADV_RANDOM:
+      case POSIX_FADV_SEQUENTIAL:
+        ra->advice = fadv->advice;
+        ra->nseq   = 0;
+        break;
+
+      case POSIX_FADV_WILLNEED:
+
+        /* Start reading the range into the buffer that the reader does
+         * not use, unless it is already there.
+         */
+
+        if (!ra->busy && !readahead_hit(ra, 0, fadv->offset) &&
+            !readahead_hit(ra, 1, fadv->offset))
+          {
+            readahead_fill(ra, filep,
+                           readahead_hit(ra, 0, filep->f_pos), fadv->offset);
+          }
+        break;
+
+      case POSIX_FADV_DONTNEED:
+        for (i = 0; i < 2; i++)
+          {
+            if (!(ra->busy && ra->fill == i))
+              {
+                ra->len[i] = 0;
+              }
+          }
+        break;
+
+      case POSIX_FADV_NOREUSE:
+        break;
+
+      default:
+        nxmutex_unlock(&ra->lock);
+        return -EINVAL;
+    }
+
+  nxmutex_unlock(&ra->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: readahead_invalidate
+ ****************************************************************************/
+
+void readahead_invalidate(void)
+{
+  atomic_fetch_add(&g_readahead_gen, 1);
+}
+
+/****************************************************************************
+ * Name: readahead_close
+ ****************************************************************************/
+
+void readahead_close(FAR struct file *filep)
+{
+  FAR struct readahead_s *ra = filep->f_ra;
+
+  if (ra == NULL)
+    {
+      return;
+    }
+
+  filep->f_ra = NULL;
+
+  work_cancel_sync(LPWORK, &ra->work);
+
+  if (ra->buf[0] != NULL)
+    {
+      file_close(&ra->file);
+      fs_heap_free(ra->buf[0]);
+    }
+
+  nxsem_destroy(&ra->done);
+  nxmutex_destroy(&ra->lock);
+  fs_heap_free(ra);
+}
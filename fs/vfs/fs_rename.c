@@ -70,6 +70,7 @@ static int pseudorename(FAR const char *oldpath, FAR struct inode *oldinode,
 {
   struct inode_search_s newdesc;
   FAR struct inode *newinode;
+  FAR struct inode *child;
   FAR char *subdir = NULL;
 #ifdef CONFIG_FS_NOTIFY
   bool isdir = INODE_IS_PSEUDODIR(oldinode);
@@ -219,7 +220,14 @@ static int pseudorename(FAR const char *oldpath, FAR struct inode *oldinode,
       goto errout_with_lock;
     }
 
-  /* Remove all of the children from the unlinked inode */
+  /* Move all of the children over from the unlinked inode */
+
+  for (child = newinode->i_child; child != NULL; child = child->i_peer)
+    {
+      inode_hash_remove(child);
+      child->i_parent = newinode;
+      inode_hash_add(child);
+    }
 
   oldinode->i_child  = NULL;
   oldinode->i_parent = NULL;
@@ -427,6 +435,7 @@ static int mountptrename(FAR const char *oldpath, FAR struct inode *oldinode,
    */
 
   ret = oldinode->u.i_mops->rename(oldinode, oldrelpath, newrelpath);
+  pathcache_invalidate(oldinode);
 
 #ifdef CONFIG_FS_NOTIFY
   if (ret >= 0)
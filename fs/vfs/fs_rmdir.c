@@ -98,6 +98,7 @@ int rmdir(FAR const char *pathname)
       if (inode->u.i_mops->rmdir)
         {
           ret = inode->u.i_mops->rmdir(inode, desc.relpath);
+          pathcache_invalidate(inode);
           if (ret < 0)
             {
               errcode = -ret;
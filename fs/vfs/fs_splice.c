@@ -0,0 +1,388 @@
+/****************************************************************************
+ * fs/vfs/fs_splice.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/semaphore.h>
+
+#ifdef CONFIG_PIPES
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The file on the other side of the pipe */
+
+struct splice_file_s
+{
+  FAR struct file *filep;
+  FAR off_t       *offset;  /* Explicit file offset, or NULL */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice_sink
+ *
+ * Description:
+ *   Write data drained from a pipe to the destination file.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_sink(FAR void *arg, FAR void *buffer, size_t len)
+{
+  FAR struct splice_file_s *file = arg;
+  ssize_t ret;
+
+  if (file->offset != NULL)
+    {
+      ret = file_pwrite(file->filep, buffer, len, *file->offset);
+      if (ret > 0)
+        {
+          *file->offset += ret;
+        }
+
+      return ret;
+    }
+
+  return file_write(file->filep, buffer, len);
+}
+
+/****************************************************************************
+ * Name: splice_source
+ *
+ * Description:
+ *   Read data from the source file straight into a pipe.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_source(FAR void *arg, FAR void *buffer, size_t len)
+{
+  FAR struct splice_file_s *file = arg;
+  ssize_t ret;
+
+  if (file->offset != NULL)
+    {
+      ret = file_pread(file->filep, buffer, len, *file->offset);
+      if (ret > 0)
+        {
+          *file->offset += ret;
+        }
+
+      return ret;
+    }
+
+  return file_read(file->filep, buffer, len);
+}
+
+/****************************************************************************
+ * Name: splice_wait
+ *
+ * Description:
+ *   Wait until the file on the other side of the pipe is ready.  The pipe
+ *   is locked while data is transferred, so a transfer must not wait for a
+ *   slow device or a socket: that would also stall the other users of the
+ *   pipe, even when it holds data for them.  Regular files and block
+ *   devices are always ready, and non-blocking files report EAGAIN
+ *   themselves.
+ *
+ ****************************************************************************/
+
+static int splice_wait(FAR struct file *filep, pollevent_t events)
+{
+  FAR struct inode *inode = filep->f_inode;
+  struct pollfd fds;
+  sem_t sem;
+  int ret;
+
+  if ((filep->f_oflags & O_NONBLOCK) != 0 || inode == NULL ||
+      !(INODE_IS_DRIVER(inode) || INODE_IS_SOCKET(inode) ||
+        INODE_IS_MQUEUE(inode)))
+    {
+      return OK;
+    }
+
+  nxsem_init(&sem, 0, 0);
+
+  fds.fd      = -1;
+  fds.events  = events;
+  fds.revents = 0;
+  fds.arg     = &sem;
+  fds.cb      = poll_default_cb;
+  fds.priv    = NULL;
+
+  ret = file_poll(filep, &fds, true);
+  if (ret >= 0)
+    {
+      if (fds.revents == 0)
+        {
+          ret = nxsem_wait(&sem);
+        }
+
+      file_poll(filep, &fds, false);
+    }
+  else if (ret == -ENOSYS)
+    {
+      ret = OK;
+    }
+
+  nxsem_destroy(&sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Move data between two files, at least one of which is a pipe, without
+ *   a round trip through a user buffer.  Data leaving a pipe is written
+ *   to the destination straight from the pipe buffer, and data entering
+ *   a pipe is read from the source straight into the pipe buffer.
+ *
+ * Input Parameters:
+ *   infile  - The file to read from
+ *   inoff   - The offset in infile to start at, or NULL for the current
+ *             position; updated on return.  Must be NULL for a pipe.
+ *   outfile - The file to write to
+ *   outoff  - The offset in outfile, like inoff
+ *   len     - The maximum number of bytes to move
+ *   flags   - SPLICE_F_* flags
+ *
+ * Returned Value:
+ *   The number of bytes moved; zero at end of file; a negated errno value
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoff,
+                    FAR struct file *outfile, FAR off_t *outoff,
+                    size_t len, unsigned int flags)
+{
+  struct splice_file_s file;
+  bool nonblock = (flags & SPLICE_F_NONBLOCK) != 0;
+  bool inpipe = INODE_IS_PIPE(infile->f_inode);
+  bool outpipe = INODE_IS_PIPE(outfile->f_inode);
+  int ret;
+
+  if ((inpipe && inoff != NULL) || (outpipe && outoff != NULL))
+    {
+      return -ESPIPE;
+    }
+
+  if ((infile->f_oflags & O_RDOK) == 0 || (outfile->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  if (inpipe && outpipe)
+    {
+      return infile->f_inode == outfile->f_inode ? -EINVAL :
+             pipe_move(infile, outfile, len, nonblock);
+    }
+  else if (inpipe)
+    {
+      ret = splice_wait(outfile, POLLOUT);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      file.filep  = outfile;
+      file.offset = outoff;
+      return pipe_splice_out(infile, splice_sink, &file, len, nonblock);
+    }
+  else if (outpipe)
+    {
+      ret = splice_wait(infile, POLLIN);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      file.filep  = infile;
+      file.offset = inoff;
+      return pipe_splice_in(outfile, splice_source, &file, len, nonblock);
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   splice() moves data between two file descriptors, at least one of
+ *   which must refer to a pipe, without copying it through user space.
+ *   The other descriptor may be a file, a device or a socket.
+ *
+ *   NOTE: This interface is not specified by POSIX; it follows the Linux
+ *   splice interface.  SPLICE_F_NONBLOCK makes the pipe operations
+ *   non-blocking; the other descriptor follows its own O_NONBLOCK flag.
+ *
+ * Input Parameters:
+ *   fd_in   - The descriptor to read from
+ *   off_in  - The offset to read from, or NULL for the current position.
+ *             Must be NULL for a pipe.
+ *   fd_out  - The descriptor to write to
+ *   off_out - The offset to write to, like off_in
+ *   len     - The maximum number of bytes to move
+ *   flags   - SPLICE_F_* flags
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at end of input.  On error, -1 is
+ *   returned, and errno is set appropriately:
+ *
+ *   EBADF  - A descriptor is not valid or has the wrong access mode.
+ *   EINVAL - Neither descriptor is a pipe, or both refer to the same pipe.
+ *   ESPIPE - An offset was given for a pipe.
+ *   EAGAIN - SPLICE_F_NONBLOCK was given and the pipe operation would
+ *            block.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  /* splice() is a cancellation point */
+
+  enter_cancellation_point();
+
+  ret = file_get(fd_in, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_get(fd_out, &outfile);
+  if (ret < 0)
+    {
+      file_put(infile);
+      goto errout;
+    }
+
+  ret = file_splice(infile, off_in, outfile, off_out, len, flags);
+  file_put(outfile);
+  file_put(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  leave_cancellation_point();
+  return ret;
+
+errout:
+  leave_cancellation_point();
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   tee() duplicates up to 'len' bytes of the data queued in the pipe
+ *   'fd_in' into the pipe 'fd_out' without consuming them, so that the
+ *   same data can then be spliced to another destination.
+ *
+ * Returned Value:
+ *   The number of bytes duplicated, zero if there was no writer left on
+ *   an empty input pipe.  On error, -1 is returned, and errno is set as
+ *   for splice(); EINVAL is also returned if a descriptor is not a pipe.
+ *
+ ****************************************************************************/
+
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  enter_cancellation_point();
+
+  ret = file_get(fd_in, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_get(fd_out, &outfile);
+  if (ret < 0)
+    {
+      file_put(infile);
+      goto errout;
+    }
+
+  if (!INODE_IS_PIPE(infile->f_inode) || !INODE_IS_PIPE(outfile->f_inode))
+    {
+      ret = -EINVAL;
+    }
+  else if ((infile->f_oflags & O_RDOK) == 0 ||
+           (outfile->f_oflags & O_WROK) == 0)
+    {
+      ret = -EBADF;
+    }
+  else
+    {
+      ret = pipe_tee(infile, outfile, len,
+                     (flags & SPLICE_F_NONBLOCK) != 0);
+    }
+
+  file_put(outfile);
+  file_put(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  leave_cancellation_point();
+  return ret;
+
+errout:
+  leave_cancellation_point();
+  set_errno(-ret);
+  return ERROR;
+}
+
+#endif /* CONFIG_PIPES */
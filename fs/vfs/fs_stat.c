@@ -36,6 +36,7 @@
 #include "inode/inode.h"
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/fs/ioctl.h>
+#include "vfs.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -118,9 +119,20 @@ static int stat_recursive(FAR const char *path,
 
       if (inode->u.i_mops && inode->u.i_mops->stat)
         {
-          /* Perform the stat() operation */
+          uint32_t gen;
 
-          ret = inode->u.i_mops->stat(inode, desc.relpath, buf);
+          /* Perform the stat() operation unless the outcome is cached */
+
+          ret = pathcache_lookup(inode, desc.relpath, buf, &gen);
+          if (ret == -EAGAIN)
+            {
+              ret = inode->u.i_mops->stat(inode, desc.relpath, buf);
+              if (ret == OK || ret == -ENOENT)
+                {
+                  pathcache_add(inode, desc.relpath,
+                                ret == OK ? buf : NULL, gen);
+                }
+            }
         }
       else
         {
@@ -95,6 +95,7 @@ int nx_unlink(FAR const char *pathname)
       if (inode->u.i_mops->unlink)
         {
           ret = inode->u.i_mops->unlink(inode, desc.relpath);
+          pathcache_invalidate(inode);
           if (ret < 0)
             {
               goto errout_with_inode;
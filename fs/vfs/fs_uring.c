@@ -0,0 +1,1126 @@
+/****************************************************************************
+ * fs/vfs/fs_uring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* A ring is a pair of queues in memory shared with the application.  The
+ * application fills submission entries and calls uring_enter(), which
+ * copies them into requests and hands them to a low priority worker.  The
+ * worker carries the requests out in batches and posts one completion per
+ * request.  Requests on descriptors that may block first arm a poll
+ * callback, so the worker never waits on one descriptor while the others
+ * are ready; the callback puts the request back on the ready list.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/uring.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/net/net.h>
+#include <nuttx/queue.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+#include "inode/inode.h"
+#include "fs_heap.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Request states */
+
+#define URING_REQ_FREE     0  /* On the free list */
+#define URING_REQ_READY    1  /* On the ready list, waiting for the worker */
+#define URING_REQ_POLLING  2  /* Waiting for the poll callback */
+#define URING_REQ_RUNNING  3  /* Owned by the worker */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct uring_s;
+
+/* One submitted operation */
+
+struct uring_req_s
+{
+  sq_entry_t          node;     /* Entry in the free or the ready list */
+  FAR struct uring_s *ring;     /* The ring the request belongs to */
+  FAR struct file    *filep;    /* Reference on the target descriptor */
+  FAR struct fdlist  *list;     /* Descriptor table of the submitter */
+  struct pollfd       pfd;      /* Used to wait for the target */
+  struct uring_sqe    sqe;      /* Copy of the submission entry */
+  uint8_t             state;    /* URING_REQ_* */
+  bool                armed;    /* pfd is set up on the target */
+  bool                polled;   /* The target reported readiness */
+};
+
+/* The state of one ring */
+
+struct uring_s
+{
+  mutex_t                 lock;     /* Serializes submission and completion */
+  spinlock_t              splock;   /* Protects the ready list and states */
+  struct work_s           work;     /* Runs uring_worker() */
+  sem_t                   waitsem;  /* uring_enter() waits for completions */
+  uint16_t                nwaiters; /* Number of threads waiting on waitsem */
+  uint8_t                 crefs;    /* Number of open file structures */
+  bool                    closing;  /* The ring is being torn down */
+  FAR struct uring_sq    *sq;       /* Shared submission queue */
+  FAR struct uring_cq    *cq;       /* Shared completion queue */
+  FAR void               *shared;   /* Memory of the shared queues */
+  FAR struct uring_req_s *reqs;     /* Pool of requests */
+  uint32_t                nreqs;    /* Number of requests in the pool */
+  sq_queue_t              freelist; /* Requests not in use */
+  sq_queue_t              ready;    /* Requests for the worker */
+
+  /* The poll structures of threads waiting for completions */
+
+  FAR struct pollfd *fds[CONFIG_FS_URING_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int uring_open(FAR struct file *filep);
+static int uring_close(FAR struct file *filep);
+static int uring_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup);
+static void uring_worker(FAR void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_uring_fops =
+{
+  uring_open,   /* open */
+  uring_close,  /* close */
+  NULL,         /* read */
+  NULL,         /* write */
+  NULL,         /* seek */
+  NULL,         /* ioctl */
+  NULL,         /* mmap */
+  NULL,         /* truncate */
+  uring_poll    /* poll */
+};
+
+static struct inode g_uring_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_uring_fops         /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uring_pollcb
+ *
+ * Description:
+ *   Called by the target of a request when it becomes ready.  This may run
+ *   in interrupt context, so it only moves the request back to the ready
+ *   list and schedules the worker.
+ *
+ ****************************************************************************/
+
+static void uring_pollcb(FAR struct pollfd *fds)
+{
+  FAR struct uring_req_s *req = fds->arg;
+  FAR struct uring_s *ring = req->ring;
+  irqstate_t flags;
+  bool queue = false;
+
+  flags = spin_lock_irqsave(&ring->splock);
+  if (req->state == URING_REQ_POLLING)
+    {
+      req->state  = URING_REQ_READY;
+      req->polled = true;
+      sq_addlast(&req->node, &ring->ready);
+      queue = !ring->closing;
+    }
+
+  spin_unlock_irqrestore(&ring->splock, flags);
+
+  if (queue)
+    {
+      work_queue(LPWORK, &ring->work, uring_worker, ring, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: uring_arm
+ *
+ * Description:
+ *   Wait for 'events' on the target of a request.  The poll callback may
+ *   fire before this function returns; the request is then already back
+ *   on the ready list.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request now waits for the callback; a negated errno
+ *   value if the target cannot be polled.
+ *
+ ****************************************************************************/
+
+static int uring_arm(FAR struct uring_req_s *req, pollevent_t events)
+{
+  FAR struct uring_s *ring = req->ring;
+  irqstate_t flags;
+  int ret;
+
+  memset(&req->pfd, 0, sizeof(req->pfd));
+  req->pfd.fd     = req->sqe.fd;
+  req->pfd.events = events;
+  req->pfd.arg    = req;
+  req->pfd.cb     = uring_pollcb;
+  req->polled     = false;
+
+  flags = spin_lock_irqsave(&ring->splock);
+  req->state = URING_REQ_POLLING;
+  spin_unlock_irqrestore(&ring->splock, flags);
+
+  ret = file_poll(req->filep, &req->pfd, true);
+
+  flags = spin_lock_irqsave(&ring->splock);
+  if (ret < 0)
+    {
+      /* Take back a request that a premature callback queued */
+
+      if (req->state == URING_REQ_READY)
+        {
+          sq_rem(&req->node, &ring->ready);
+        }
+
+      req->state = URING_REQ_RUNNING;
+    }
+  else
+    {
+      req->armed = true;
+    }
+
+  spin_unlock_irqrestore(&ring->splock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: uring_disarm
+ *
+ * Description:
+ *   Tear down the poll set up by uring_arm().
+ *
+ ****************************************************************************/
+
+static void uring_disarm(FAR struct uring_req_s *req)
+{
+  if (req->armed)
+    {
+      file_poll(req->filep, &req->pfd, false);
+      req->armed = false;
+    }
+}
+
+/****************************************************************************
+ * Name: uring_events
+ *
+ * Description:
+ *   Return the events the target of a request has to report before the
+ *   operation is attempted, or zero if it can be attempted right away.
+ *   Regular files and block devices never block for long, so only
+ *   drivers, pipes, message queues and sockets are waited for.
+ *
+ ****************************************************************************/
+
+static pollevent_t uring_events(FAR struct uring_req_s *req)
+{
+  FAR struct inode *inode = req->filep->f_inode;
+
+  if (req->sqe.opcode == URING_OP_POLL_ADD)
+    {
+      return req->sqe.opflags;
+    }
+
+  if (inode == NULL ||
+      !(INODE_IS_DRIVER(inode) || INODE_IS_MQUEUE(inode) ||
+        INODE_IS_SOCKET(inode) || INODE_IS_PIPE(inode)))
+    {
+      return 0;
+    }
+
+  switch (req->sqe.opcode)
+    {
+      case URING_OP_READ:
+      case URING_OP_READV:
+      case URING_OP_RECV:
+      case URING_OP_ACCEPT:
+        return POLLIN;
+
+      case URING_OP_WRITE:
+      case URING_OP_SEND:
+        return POLLOUT;
+
+      default:
+        return 0;
+    }
+}
+
+/****************************************************************************
+ * Name: uring_preadv
+ *
+ * Description:
+ *   Read into an iovec array at an explicit offset.
+ *
+ ****************************************************************************/
+
+static ssize_t uring_preadv(FAR struct file *filep,
+                            FAR const struct iovec *iov, int iovcnt,
+                            off_t offset)
+{
+  ssize_t total = 0;
+  ssize_t nread;
+  int i;
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      nread = file_pread(filep, iov[i].iov_base, iov[i].iov_len,
+                         offset + total);
+      if (nread < 0)
+        {
+          return total > 0 ? total : nread;
+        }
+
+      total += nread;
+      if ((size_t)nread < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: uring_accept
+ *
+ * Description:
+ *   Accept a connection and install it in the descriptor table of the
+ *   submitter.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET
+static int uring_accept(FAR struct uring_req_s *req,
+                        FAR struct socket *psock)
+{
+  FAR struct socket *newsock;
+  FAR struct file *newfilep;
+  int sflags = req->sqe.opflags;
+  int oflags = O_RDWR;
+  int ret;
+
+  if (sflags & ~(SOCK_NONBLOCK | SOCK_CLOEXEC))
+    {
+      return -EINVAL;
+    }
+
+  newsock = fs_heap_zalloc(sizeof(*newsock));
+  if (newsock == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = psock_accept(psock, req->sqe.addr, req->sqe.addr2, newsock,
+                     sflags);
+  if (ret < 0)
+    {
+      goto errout_with_alloc;
+    }
+
+  if (sflags & SOCK_CLOEXEC)
+    {
+      oflags |= O_CLOEXEC;
+    }
+
+  if (sflags & SOCK_NONBLOCK)
+    {
+      oflags |= O_NONBLOCK;
+    }
+
+  newfilep = file_allocate();
+  if (newfilep == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_psock;
+    }
+
+  inode_addref(req->filep->f_inode);
+  newfilep->f_inode  = req->filep->f_inode;
+  newfilep->f_oflags = oflags & ~O_CLOEXEC;
+  newfilep->f_priv   = newsock;
+
+  ret = fdlist_dupfile(req->list, oflags, 0, newfilep);
+  if (ret < 0)
+    {
+      inode_release(newfilep->f_inode);
+      file_deallocate(newfilep);
+      goto errout_with_psock;
+    }
+
+  return ret;
+
+errout_with_psock:
+  psock_close(newsock);
+
+errout_with_alloc:
+  fs_heap_free(newsock);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: uring_execute
+ *
+ * Description:
+ *   Carry out the operation of a request.
+ *
+ * Returned Value:
+ *   The result to post in the completion.  -EAGAIN from a socket means that
+ *   the request has to wait for the socket again.
+ *
+ ****************************************************************************/
+
+static int uring_execute(FAR struct uring_req_s *req)
+{
+  FAR struct uring_sqe *sqe = &req->sqe;
+  FAR struct file *filep = req->filep;
+#ifdef CONFIG_NET
+  FAR struct socket *psock = file_socket(filep);
+#endif
+
+  switch (sqe->opcode)
+    {
+      case URING_OP_NOP:
+        return OK;
+
+      case URING_OP_READ:
+        if (sqe->off >= 0)
+          {
+            return file_pread(filep, sqe->addr, sqe->len, sqe->off);
+          }
+
+        return file_read(filep, sqe->addr, sqe->len);
+
+      case URING_OP_WRITE:
+        if (sqe->off >= 0)
+          {
+            return file_pwrite(filep, sqe->addr, sqe->len, sqe->off);
+          }
+
+        return file_write(filep, sqe->addr, sqe->len);
+
+      case URING_OP_READV:
+        if (sqe->off >= 0)
+          {
+            return uring_preadv(filep, sqe->addr, sqe->len, sqe->off);
+          }
+
+        return file_readv(filep, sqe->addr, sqe->len);
+
+#ifdef CONFIG_NET
+      case URING_OP_SEND:
+        if (psock == NULL)
+          {
+            return -ENOTSOCK;
+          }
+
+        return psock_send(psock, sqe->addr, sqe->len,
+                          sqe->opflags | MSG_DONTWAIT);
+
+      case URING_OP_RECV:
+        if (psock == NULL)
+          {
+            return -ENOTSOCK;
+          }
+
+        return psock_recv(psock, sqe->addr, sqe->len,
+                          sqe->opflags | MSG_DONTWAIT);
+
+      case URING_OP_ACCEPT:
+        if (psock == NULL)
+          {
+            return -ENOTSOCK;
+          }
+
+        return uring_accept(req, psock);
+#endif
+
+      case URING_OP_POLL_ADD:
+        return req->pfd.revents;
+
+      case URING_OP_FSYNC:
+        return file_fsync(filep);
+
+      default:
+        return -EINVAL;
+    }
+}
+
+/****************************************************************************
+ * Name: uring_post
+ *
+ * Description:
+ *   Post a completion.  The caller holds the ring lock.
+ *
+ ****************************************************************************/
+
+static void uring_post(FAR struct uring_s *ring, uint64_t user_data,
+                       int res)
+{
+  FAR struct uring_cq *cq = ring->cq;
+  FAR struct uring_cqe *cqe;
+  uint32_t tail = cq->tail;
+
+  if (tail - cq->head > cq->mask)
+    {
+      cq->overflow++;
+      return;
+    }
+
+  cqe            = &cq->cqes[tail & cq->mask];
+  cqe->user_data = user_data;
+  cqe->res       = res;
+  cqe->flags     = 0;
+
+  /* Make the entry visible before the new tail */
+
+  SMP_WMB();
+  cq->tail = tail + 1;
+}
+
+/****************************************************************************
+ * Name: uring_wakeup
+ *
+ * Description:
+ *   Wake up the threads waiting for completions.  The caller holds the
+ *   ring lock.
+ *
+ ****************************************************************************/
+
+static void uring_wakeup(FAR struct uring_s *ring)
+{
+  while (ring->nwaiters > 0)
+    {
+      ring->nwaiters--;
+      nxsem_post(&ring->waitsem);
+    }
+
+  poll_notify(ring->fds, CONFIG_FS_URING_NPOLLWAITERS, POLLIN);
+}
+
+/****************************************************************************
+ * Name: uring_complete
+ *
+ * Description:
+ *   Post the completion of a request and return it to the free list.
+ *
+ ****************************************************************************/
+
+static void uring_complete(FAR struct uring_req_s *req, int res)
+{
+  FAR struct uring_s *ring = req->ring;
+
+  nxmutex_lock(&ring->lock);
+  uring_post(ring, req->sqe.user_data, res);
+
+  file_put(req->filep);
+  req->filep = NULL;
+  req->state = URING_REQ_FREE;
+  sq_addlast(&req->node, &ring->freelist);
+  nxmutex_unlock(&ring->lock);
+}
+
+/****************************************************************************
+ * Name: uring_worker
+ *
+ * Description:
+ *   Carry out every request on the ready list.
+ *
+ ****************************************************************************/
+
+static void uring_worker(FAR void *arg)
+{
+  FAR struct uring_s *ring = arg;
+  FAR struct uring_req_s *req;
+  pollevent_t events;
+  irqstate_t flags;
+  bool done = false;
+  int ret;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&ring->splock);
+      req = ring->closing ? NULL :
+            (FAR struct uring_req_s *)sq_remfirst(&ring->ready);
+      if (req != NULL)
+        {
+          req->state = URING_REQ_RUNNING;
+        }
+
+      spin_unlock_irqrestore(&ring->splock, flags);
+
+      if (req == NULL)
+        {
+          break;
+        }
+
+      uring_disarm(req);
+
+      events = uring_events(req);
+      if (events != 0 && !req->polled)
+        {
+          ret = uring_arm(req, events);
+          if (ret >= 0)
+            {
+              continue;
+            }
+          else if (ret != -ENOSYS ||
+                   req->sqe.opcode == URING_OP_POLL_ADD)
+            {
+              uring_complete(req, ret);
+              done = true;
+              continue;
+            }
+        }
+
+      ret = uring_execute(req);
+      if (ret == -EAGAIN && events != 0 &&
+          req->sqe.opcode != URING_OP_POLL_ADD &&
+          uring_arm(req, events) >= 0)
+        {
+          continue;
+        }
+
+      uring_complete(req, ret);
+      done = true;
+    }
+
+  if (done)
+    {
+      nxmutex_lock(&ring->lock);
+      uring_wakeup(ring);
+      nxmutex_unlock(&ring->lock);
+    }
+}
+
+/****************************************************************************
+ * Name: uring_destroy
+ *
+ * Description:
+ *   Stop the worker, drop the outstanding requests and free the ring.
+ *
+ ****************************************************************************/
+
+static void uring_destroy(FAR struct uring_s *ring)
+{
+  irqstate_t flags;
+  uint32_t i;
+
+  /* No poll callback schedules the worker once closing is set */
+
+  flags = spin_lock_irqsave(&ring->splock);
+  ring->closing = true;
+  spin_unlock_irqrestore(&ring->splock, flags);
+
+  work_cancel_sync(LPWORK, &ring->work);
+
+  for (i = 0; i < ring->nreqs; i++)
+    {
+      FAR struct uring_req_s *req = &ring->reqs[i];
+
+      if (req->state != URING_REQ_FREE)
+        {
+          uring_disarm(req);
+          file_put(req->filep);
+        }
+    }
+
+  nxsem_destroy(&ring->waitsem);
+  nxmutex_destroy(&ring->lock);
+  kumm_free(ring->shared);
+  fs_heap_free(ring->reqs);
+  fs_heap_free(ring);
+}
+
+/****************************************************************************
+ * Name: uring_open
+ ****************************************************************************/
+
+static int uring_open(FAR struct file *filep)
+{
+  FAR struct uring_s *ring = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (ring->crefs >= 255)
+    {
+      ret = -EMFILE;
+    }
+  else
+    {
+      ring->crefs++;
+    }
+
+  nxmutex_unlock(&ring->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: uring_close
+ ****************************************************************************/
+
+static int uring_close(FAR struct file *filep)
+{
+  FAR struct uring_s *ring = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (ring->crefs > 1)
+    {
+      ring->crefs--;
+      nxmutex_unlock(&ring->lock);
+      return OK;
+    }
+
+  nxmutex_unlock(&ring->lock);
+
+  finfo("destroy\n");
+  uring_destroy(ring);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: uring_poll
+ *
+ * Description:
+ *   A ring is readable while its completion queue is not empty.
+ *
+ ****************************************************************************/
+
+static int uring_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct uring_s *ring = filep->f_priv;
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (!setup)
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      *slot     = NULL;
+      fds->priv = NULL;
+      goto out;
+    }
+
+  for (i = 0; i < CONFIG_FS_URING_NPOLLWAITERS; i++)
+    {
+      if (ring->fds[i] == NULL)
+        {
+          ring->fds[i] = fds;
+          fds->priv    = &ring->fds[i];
+          break;
+        }
+    }
+
+  if (i >= CONFIG_FS_URING_NPOLLWAITERS)
+    {
+      fds->priv = NULL;
+      ret       = -EBUSY;
+      goto out;
+    }
+
+  if (ring->cq->tail != ring->cq->head)
+    {
+      poll_notify(&fds, 1, POLLIN);
+    }
+
+out:
+  nxmutex_unlock(&ring->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uring_setup
+ *
+ * Description:
+ *   Create a submission/completion ring pair.  See include/sys/uring.h.
+ *
+ ****************************************************************************/
+
+int uring_setup(unsigned int entries, FAR struct uring_params *params)
+{
+  FAR struct uring_s *ring;
+  FAR uint8_t *shared;
+  uint32_t sqentries;
+  uint32_t cqentries;
+  uint32_t i;
+  int ret;
+
+  if (entries == 0 || params == NULL ||
+      (params->flags & ~URING_SETUP_CLOEXEC) != 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  if (entries > CONFIG_FS_URING_MAXENTRIES)
+    {
+      entries = CONFIG_FS_URING_MAXENTRIES;
+    }
+
+  sqentries = 1;
+  while (sqentries < entries)
+    {
+      sqentries <<= 1;
+    }
+
+  cqentries = 2 * sqentries;
+
+  ring = fs_heap_zalloc(sizeof(struct uring_s));
+  if (ring == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  /* A request lives until its completion is posted, so allow as many
+   * outstanding requests as the completion queue holds.
+   */
+
+  ring->nreqs = cqentries;
+  ring->reqs  = fs_heap_zalloc(cqentries * sizeof(struct uring_req_s));
+  if (ring->reqs == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_ring;
+    }
+
+  /* The queues are accessed by the application, so they come from the user
+   * heap.  The entry arrays go first to keep them aligned.
+   */
+
+  shared = kumm_zalloc(sqentries * sizeof(struct uring_sqe) +
+                       cqentries * sizeof(struct uring_cqe) +
+                       sizeof(struct uring_sq) + sizeof(struct uring_cq));
+  if (shared == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_reqs;
+    }
+
+  ring->shared   = shared;
+  ring->sq       = (FAR struct uring_sq *)
+                   (shared + sqentries * sizeof(struct uring_sqe) +
+                    cqentries * sizeof(struct uring_cqe));
+  ring->cq       = (FAR struct uring_cq *)(ring->sq + 1);
+
+  ring->sq->mask = sqentries - 1;
+  ring->sq->sqes = (FAR struct uring_sqe *)shared;
+  ring->cq->mask = cqentries - 1;
+  ring->cq->cqes = (FAR struct uring_cqe *)
+                   (shared + sqentries * sizeof(struct uring_sqe));
+
+  for (i = 0; i < cqentries; i++)
+    {
+      ring->reqs[i].ring = ring;
+      sq_addlast(&ring->reqs[i].node, &ring->freelist);
+    }
+
+  nxmutex_init(&ring->lock);
+  nxsem_init(&ring->waitsem, 0, 0);
+  spin_lock_init(&ring->splock);
+  ring->crefs = 1;
+
+  ret = file_allocate_from_inode(&g_uring_inode, O_RDWR | params->flags,
+                                 0, ring, 0);
+  if (ret < 0)
+    {
+      nxsem_destroy(&ring->waitsem);
+      nxmutex_destroy(&ring->lock);
+      kumm_free(shared);
+      goto errout_with_reqs;
+    }
+
+  params->sq_entries = sqentries;
+  params->cq_entries = cqentries;
+  params->sq         = ring->sq;
+  params->cq         = ring->cq;
+  return ret;
+
+errout_with_reqs:
+  fs_heap_free(ring->reqs);
+
+errout_with_ring:
+  fs_heap_free(ring);
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: uring_enter
+ *
+ * Description:
+ *   Submit entries of the submission queue and optionally wait for
+ *   completions.  See include/sys/uring.h.
+ *
+ ****************************************************************************/
+
+int uring_enter(int fd, unsigned int to_submit, unsigned int min_complete,
+                unsigned int flags)
+{
+  FAR struct uring_req_s *req;
+  FAR struct fdlist *list;
+  FAR struct uring_s *ring;
+  FAR struct uring_sq *sq;
+  FAR struct uring_cq *cq;
+  FAR struct file *filep;
+  irqstate_t irqflags;
+  unsigned int submitted = 0;
+  bool posted = false;
+  bool queued = false;
+  uint32_t head;
+  uint32_t tail;
+  int ret;
+
+  if ((flags & ~URING_ENTER_GETEVENTS) != 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = file_get(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (filep->f_inode != &g_uring_inode)
+    {
+      ret = -EBADF;
+      goto errout_with_filep;
+    }
+
+  ring = filep->f_priv;
+  sq   = ring->sq;
+  cq   = ring->cq;
+  list = nxsched_get_fdlist();
+
+  ret = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      goto errout_with_filep;
+    }
+
+  /* Read the entries only after the tail that covers them */
+
+  head = sq->head;
+  tail = sq->tail;
+  SMP_RMB();
+
+  if (tail - head > sq->mask + 1)
+    {
+      ret = -EINVAL;
+      goto errout_with_lock;
+    }
+
+  if (to_submit > tail - head)
+    {
+      to_submit = tail - head;
+    }
+
+  while (submitted < to_submit &&
+         (req = (FAR struct uring_req_s *)sq_peek(&ring->freelist)) != NULL)
+    {
+      req->sqe = sq->sqes[head & sq->mask];
+      head++;
+      submitted++;
+
+      if (req->sqe.opcode > URING_OP_LAST)
+        {
+          uring_post(ring, req->sqe.user_data, -EINVAL);
+          posted = true;
+          continue;
+        }
+
+      if (req->sqe.opcode == URING_OP_NOP)
+        {
+          uring_post(ring, req->sqe.user_data, OK);
+          posted = true;
+          continue;
+        }
+
+      /* Rings cannot be the target of a request; a request on its own
+       * ring would keep the ring open forever.
+       */
+
+      ret = file_get(req->sqe.fd, &req->filep);
+      if (ret >= 0 && req->filep->f_inode == &g_uring_inode)
+        {
+          file_put(req->filep);
+          ret = -EBADF;
+        }
+
+      if (ret < 0)
+        {
+          req->filep = NULL;
+          uring_post(ring, req->sqe.user_data, ret);
+          posted = true;
+          continue;
+        }
+
+      sq_remfirst(&ring->freelist);
+      req->list   = list;
+      req->armed  = false;
+      req->polled = false;
+      req->pfd.revents = 0;
+
+      irqflags = spin_lock_irqsave(&ring->splock);
+      req->state = URING_REQ_READY;
+      sq_addlast(&req->node, &ring->ready);
+      spin_unlock_irqrestore(&ring->splock, irqflags);
+      queued = true;
+    }
+
+  if (submitted == 0 && to_submit > 0)
+    {
+      /* Every request is outstanding */
+
+      ret = -EBUSY;
+      goto errout_with_lock;
+    }
+
+  /* Finish reading the entries before they are handed back */
+
+  SMP_MB();
+  sq->head = head;
+
+  if (posted)
+    {
+      uring_wakeup(ring);
+    }
+
+  if (queued && work_available(&ring->work))
+    {
+      work_queue(LPWORK, &ring->work, uring_worker, ring, 0);
+    }
+
+  if (flags & URING_ENTER_GETEVENTS)
+    {
+      if (min_complete > cq->mask + 1)
+        {
+          min_complete = cq->mask + 1;
+        }
+
+      while (cq->tail - cq->head < min_complete)
+        {
+          ring->nwaiters++;
+          nxmutex_unlock(&ring->lock);
+
+          ret = nxsem_wait(&ring->waitsem);
+          if (ret < 0)
+            {
+              /* A late post only causes a spurious wakeup later */
+
+              file_put(filep);
+              if (submitted > 0)
+                {
+                  return submitted;
+                }
+
+              goto errout;
+            }
+
+          nxmutex_lock(&ring->lock);
+        }
+    }
+
+  nxmutex_unlock(&ring->lock);
+  file_put(filep);
+  return submitted;
+
+errout_with_lock:
+  nxmutex_unlock(&ring->lock);
+
+errout_with_filep:
+  file_put(filep);
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
@@ -204,6 +204,12 @@ ssize_t file_writev(FAR struct file *filep,
         }
     }
 
+  if (ret > 0 && INODE_IS_MOUNTPT(inode))
+    {
+      pathcache_invalidate(inode);
+      readahead_invalidate();
+    }
+
 #ifdef CONFIG_FS_NOTIFY
   if (ret > 0)
     {
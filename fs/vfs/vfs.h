@@ -28,7 +28,11 @@
  ****************************************************************************/
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <sys/stat.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -107,6 +111,160 @@ int file_setlk(FAR struct file *filep, FAR struct flock *flock,
 
 #endif /* CONFIG_FS_LOCK_BUCKET_SIZE */
 
+#if CONFIG_FS_PATHCACHE_ENTRIES > 0
+
+/****************************************************************************
+ * Name: pathcache_lookup
+ *
+ * Description:
+ *   Look up the outcome of an earlier lookup of 'relpath' below the
+ *   mountpoint 'mountpt'.
+ *
+ * Input Parameters:
+ *   mountpt - The mountpoint inode
+ *   relpath - The path relative to the mountpoint
+ *   buf     - The location to return the status of the path, may be NULL
+ *   gen     - The location to return the generation to pass to
+ *             pathcache_add() on a miss
+ *
+ * Returned Value:
+ *   OK if the path is known to exist, -ENOENT if it is known not to exist
+ *   and -EAGAIN if the outcome is not cached.
+ *
+ ****************************************************************************/
+
+int pathcache_lookup(FAR struct inode *mountpt, FAR const char *relpath,
+                     FAR struct stat *buf, FAR uint32_t *gen);
+
+/****************************************************************************
+ * Name: pathcache_add
+ *
+ * Description:
+ *   Cache the status of 'relpath' below 'mountpt', or the fact that it
+ *   does not exist if 'buf' is NULL.
+ *
+ ****************************************************************************/
+
+void pathcache_add(FAR struct inode *mountpt, FAR const char *relpath,
+                   FAR const struct stat *buf, uint32_t gen);
+
+/****************************************************************************
+ * Name: pathcache_invalidate
+ *
+ * Description:
+ *   Drop all cached lookups below 'mountpt'.  Called after every operation
+ *   that may have changed the contents of the mounted volume.
+ *
+ ****************************************************************************/
+
+void pathcache_invalidate(FAR struct inode *mountpt);
+
+#else
+#  define pathcache_lookup(mountpt, relpath, buf, gen) ((void)(gen), -EAGAIN)
+#  define pathcache_add(mountpt, relpath, buf, gen)
+#  define pathcache_invalidate(mountpt)
+#endif /* CONFIG_FS_PATHCACHE_ENTRIES > 0 */
+
+#ifdef CONFIG_FS_READAHEAD
+
+/****************************************************************************
+ * Name: readahead_eligible
+ *
+ * Description:
+ *   Return true if reads of 'filep' may go through readahead: a file on a
+ *   mounted volume, opened read-only, whose file system can seek and
+ *   duplicate open files.
+ *
+ ****************************************************************************/
+
+bool readahead_eligible(FAR struct file *filep);
+
+/****************************************************************************
+ * Name: readahead_read
+ *
+ * Description:
+ *   Read from an eligible file, serving the data from the readahead
+ *   buffers when possible and scheduling the next window once the reads
+ *   look sequential.
+ *
+ * Returned Value:
+ *   The number of bytes read, 0 at the end of the file or a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t readahead_read(FAR struct file *filep, FAR void *buffer,
+                       size_t nbytes);
+
+/****************************************************************************
+ * Name: readahead_advise
+ *
+ * Description:
+ *   Apply posix_fadvise() advice to the readahead of 'filep'.
+ *
+ * Returned Value:
+ *   OK on success, -ENOTTY if the file is not eligible for readahead or
+ *   another negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int readahead_advise(FAR struct file *filep,
+                     FAR const struct fadvise_s *fadv);
+
+/****************************************************************************
+ * Name: readahead_invalidate
+ *
+ * Description:
+ *   Discard all data read ahead so far.  Called after every write to a
+ *   mounted volume.
+ *
+ ****************************************************************************/
+
+void readahead_invalidate(void);
+
+/****************************************************************************
+ * Name: readahead_close
+ *
+ * Description:
+ *   Stop the readahead of 'filep' and release its resources.
+ *
+ ****************************************************************************/
+
+void readahead_close(FAR struct file *filep);
+
+#else
+#  define readahead_invalidate()
+#  define readahead_close(filep)
+#endif /* CONFIG_FS_READAHEAD */
+
+#ifdef CONFIG_FS_POLL_CACHE
+
+/****************************************************************************
+ * Name: pollcache_wait
+ *
+ * Description:
+ *   poll() on the registrations that the calling thread keeps between
+ *   calls.  Returns the number of descriptors with events, zero on a
+ *   timeout or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pollcache_wait(FAR struct pollfd *fds, nfds_t nfds, int timeout);
+
+/****************************************************************************
+ * Name: pollcache_close
+ *
+ * Description:
+ *   Remove the poll() registrations kept on 'filep' before it is closed.
+ *
+ ****************************************************************************/
+
+void pollcache_close(FAR struct file *filep);
+
+#else
+#  define pollcache_close(filep)
+#endif /* CONFIG_FS_POLL_CACHE */
+
 #ifdef CONFIG_FS_NOTIFY
 void notify_open(FAR const char *path, int oflags);
 void notify_close(FAR const char *path, int oflags);
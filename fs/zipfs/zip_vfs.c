@@ -25,9 +25,12 @@
  ****************************************************************************/
 
 #include <assert.h>
+#include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <string.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <nuttx/mutex.h>
@@ -35,6 +38,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 
+#include <zlib.h>
 #include <unzip.h>
 
 #include "fs_heap.h"
@@ -51,8 +55,26 @@ struct zipfs_dir_s
   bool last;
 };
 
+#ifdef CONFIG_ZIPFS_INDEX
+/* One entry of the central directory index */
+
+struct zipfs_entry_s
+{
+  unz64_file_pos pos;      /* Position of the entry in the directory */
+  uint64_t size;           /* Uncompressed size */
+  uint32_t hash;           /* Hash of the case folded name */
+  uint32_t next;           /* Next entry in the hash chain */
+  FAR char *name;          /* Name of the entry */
+};
+#endif
+
 struct zipfs_mountpt_s
 {
+#ifdef CONFIG_ZIPFS_INDEX
+  FAR struct zipfs_entry_s *entries; /* In central directory order */
+  FAR uint32_t *buckets;             /* First entry of each hash chain */
+  uint32_t nbuckets;                 /* Power of two, or zero if empty */
+#endif
   char abspath[1];
 };
 
@@ -61,6 +83,23 @@ struct zipfs_file_s
   unzFile uf;
   mutex_t lock;
   FAR char *seekbuf;
+#ifdef CONFIG_ZIPFS_RANDOM_ACCESS
+  bool direct;             /* The entry is read here, not by minizip */
+  bool deflated;           /* The entry is deflated, else it is stored */
+  struct file zip;         /* The image, for the direct reads */
+  off_t data;              /* Offset of the entry data in the image */
+  off_t csize;             /* Compressed size of the entry */
+  off_t usize;             /* Uncompressed size of the entry */
+  off_t crcpos;            /* crc covers the data up to this offset */
+  uint32_t crc;            /* CRC of the data read so far */
+  uint32_t crcwant;        /* CRC from the central directory */
+  z_stream strm;           /* Inflate state, at strm.total_out */
+#  if CONFIG_ZIPFS_SEEK_POINTS > 0
+  int nseek;               /* Number of saved states in use */
+  z_stream seek[CONFIG_ZIPFS_SEEK_POINTS];
+#  endif
+  unsigned char inbuf[CONFIG_ZIPFS_SEEK_BUFSIZE];
+#endif
   char relpath[1];
 };
 
@@ -243,6 +282,464 @@ static int zipfs_convert_result(int ziperr)
     }
 }
 
+#ifdef CONFIG_ZIPFS_INDEX
+static uint32_t zipfs_hash(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  /* FNV-1a of the case folded name, so that the hash does not depend on
+   * whether minizip compares names with or without case.
+   */
+
+  while (*name != '\0')
+    {
+      hash = (hash ^ (uint8_t)tolower(*name++)) * 16777619u;
+    }
+
+  return hash;
+}
+
+static FAR struct zipfs_entry_s *
+zipfs_find(FAR struct zipfs_mountpt_s *fs, FAR const char *relpath)
+{
+  uint32_t hash;
+  uint32_t i;
+
+  if (fs->nbuckets == 0)
+    {
+      return NULL;
+    }
+
+  hash = zipfs_hash(relpath);
+  for (i = fs->buckets[hash & (fs->nbuckets - 1)]; i != UINT32_MAX;
+       i = fs->entries[i].next)
+    {
+      if (fs->entries[i].hash == hash &&
+          unzStringFileNameCompare(fs->entries[i].name, relpath, 0) == 0)
+        {
+          return &fs->entries[i];
+        }
+    }
+
+  return NULL;
+}
+
+static int zipfs_build_index(FAR struct zipfs_mountpt_s *fs, unzFile uf)
+{
+  unz_global_info64 ginfo;
+  unz_file_info64 info;
+  FAR struct zipfs_entry_s *entry;
+  FAR char *names;
+  size_t namelen = 0;
+  uint32_t nentries;
+  uint32_t nbuckets;
+  uint32_t i;
+  int ret;
+
+  ret = zipfs_convert_result(unzGetGlobalInfo64(uf, &ginfo));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (ginfo.number_entry == 0)
+    {
+      return OK;
+    }
+  else if (ginfo.number_entry >= UINT32_MAX / 2)
+    {
+      return -EFBIG;
+    }
+
+  /* Get the space needed for the names first */
+
+  nentries = ginfo.number_entry;
+  ret = unzGoToFirstFile(uf);
+  for (i = 0; i < nentries && ret == UNZ_OK; i++)
+    {
+      ret = unzGetCurrentFileInfo64(uf, &info, NULL, 0, NULL, 0, NULL, 0);
+      if (ret == UNZ_OK)
+        {
+          namelen += info.size_filename + 1;
+          ret = unzGoToNextFile(uf);
+        }
+    }
+
+  if (i < nentries)
+    {
+      return ret != UNZ_OK ? zipfs_convert_result(ret) : -EIO;
+    }
+
+  nbuckets = 1;
+  while (nbuckets < nentries)
+    {
+      nbuckets <<= 1;
+    }
+
+  fs->entries = fs_heap_malloc(sizeof(struct zipfs_entry_s) * nentries +
+                               sizeof(uint32_t) * nbuckets + namelen);
+  if (fs->entries == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  fs->buckets = (FAR uint32_t *)&fs->entries[nentries];
+  names       = (FAR char *)&fs->buckets[nbuckets];
+
+  /* Then record every entry */
+
+  ret = unzGoToFirstFile(uf);
+  for (i = 0; i < nentries && ret == UNZ_OK; i++)
+    {
+      entry = &fs->entries[i];
+      ret = unzGetCurrentFileInfo64(uf, &info, names, namelen,
+                                    NULL, 0, NULL, 0);
+      if (ret != UNZ_OK)
+        {
+          break;
+        }
+
+      if (info.size_filename >= namelen)
+        {
+          ret = UNZ_BADZIPFILE;
+          break;
+        }
+
+      ret = unzGetFilePos64(uf, &entry->pos);
+      if (ret != UNZ_OK)
+        {
+          break;
+        }
+
+      entry->name = names;
+      entry->size = info.uncompressed_size;
+      entry->hash = zipfs_hash(names);
+      names      += info.size_filename + 1;
+      namelen    -= info.size_filename + 1;
+      ret = unzGoToNextFile(uf);
+    }
+
+  if (i < nentries)
+    {
+      fs_heap_free(fs->entries);
+      fs->entries = NULL;
+      return ret != UNZ_OK ? zipfs_convert_result(ret) : -EIO;
+    }
+
+  /* Build the chains backwards, so that every chain is in directory order
+   * and the first match is the one unzLocateFile() would find.
+   */
+
+  memset(fs->buckets, 0xff, sizeof(uint32_t) * nbuckets);
+  for (i = nentries; i-- > 0; )
+    {
+      entry       = &fs->entries[i];
+      entry->next = fs->buckets[entry->hash & (nbuckets - 1)];
+      fs->buckets[entry->hash & (nbuckets - 1)] = i;
+    }
+
+  fs->nbuckets = nbuckets;
+  return OK;
+}
+#endif
+
+static int zipfs_locate(FAR struct zipfs_mountpt_s *fs, unzFile uf,
+                        FAR const char *relpath)
+{
+#ifdef CONFIG_ZIPFS_INDEX
+  FAR struct zipfs_entry_s *entry;
+
+  entry = zipfs_find(fs, relpath);
+  if (entry == NULL)
+    {
+      return -ENOENT;
+    }
+
+  return zipfs_convert_result(unzGoToFilePos64(uf, &entry->pos));
+#else
+  return zipfs_convert_result(unzLocateFile(uf, relpath, 0));
+#endif
+}
+
+#ifdef CONFIG_ZIPFS_RANDOM_ACCESS
+static void zipfs_direct_init(FAR struct zipfs_mountpt_s *fs,
+                              FAR struct zipfs_file_s *fp)
+{
+  unz_file_info64 info;
+
+  fp->direct = false;
+
+  if (unzGetCurrentFileInfo64(fp->uf, &info, NULL, 0,
+                              NULL, 0, NULL, 0) != UNZ_OK)
+    {
+      return;
+    }
+
+  /* Leave encrypted entries, other methods and sizes that the counters of
+   * zlib cannot hold to minizip.
+   */
+
+  if ((info.flag & 1) != 0 ||
+      (info.compression_method != 0 &&
+       info.compression_method != Z_DEFLATED) ||
+      info.compressed_size > ULONG_MAX ||
+      info.uncompressed_size > ULONG_MAX)
+    {
+      return;
+    }
+
+  fp->data = unzGetCurrentFileZStreamPos64(fp->uf);
+  if (fp->data == 0 || file_open(&fp->zip, fs->abspath, O_RDONLY) < 0)
+    {
+      return;
+    }
+
+  memset(&fp->strm, 0, sizeof(fp->strm));
+  fp->deflated = info.compression_method == Z_DEFLATED;
+  if (fp->deflated && inflateInit2(&fp->strm, -MAX_WBITS) != Z_OK)
+    {
+      file_close(&fp->zip);
+      return;
+    }
+
+  fp->csize   = info.compressed_size;
+  fp->usize   = info.uncompressed_size;
+  fp->crcwant = info.crc;
+  fp->crcpos  = 0;
+  fp->crc     = crc32(0, Z_NULL, 0);
+#  if CONFIG_ZIPFS_SEEK_POINTS > 0
+  fp->nseek   = 0;
+#  endif
+
+  /* The buffers of minizip for this entry are not needed any more */
+
+  unzCloseCurrentFile(fp->uf);
+  fp->direct = true;
+}
+
+static void zipfs_direct_uninit(FAR struct zipfs_file_s *fp)
+{
+  if (fp->direct)
+    {
+#  if CONFIG_ZIPFS_SEEK_POINTS > 0
+      while (fp->nseek > 0)
+        {
+          inflateEnd(&fp->seek[--fp->nseek]);
+        }
+#  endif
+
+      if (fp->deflated)
+        {
+          inflateEnd(&fp->strm);
+        }
+
+      file_close(&fp->zip);
+      fp->direct = false;
+    }
+}
+
+/* Extend the CRC with data that was read at "pos" and check it once the
+ * whole entry has been covered in order.
+ */
+
+static int zipfs_direct_crc(FAR struct zipfs_file_s *fp,
+                            FAR const char *buf, off_t pos, size_t len)
+{
+  size_t skip;
+
+  if (pos > fp->crcpos || pos + len <= fp->crcpos)
+    {
+      return OK;
+    }
+
+  skip        = fp->crcpos - pos;
+  fp->crc     = crc32(fp->crc, (FAR const Bytef *)buf + skip, len - skip);
+  fp->crcpos += len - skip;
+
+  if (fp->crcpos == fp->usize && fp->crc != fp->crcwant)
+    {
+      return -ESTALE;
+    }
+
+  return OK;
+}
+
+static ssize_t zipfs_direct_inflate(FAR struct zipfs_file_s *fp,
+                                    FAR char *buf, size_t len)
+{
+  off_t pos = fp->strm.total_out;
+  ssize_t nread;
+  int ret = OK;
+
+  fp->strm.next_out  = (FAR Bytef *)buf;
+  fp->strm.avail_out = len;
+
+  while (fp->strm.avail_out > 0)
+    {
+      /* All input read so far has been consumed, so the next compressed
+       * byte is at total_in.
+       */
+
+      if (fp->strm.avail_in == 0)
+        {
+          nread = MIN(sizeof(fp->inbuf), fp->csize - fp->strm.total_in);
+          if (nread > 0)
+            {
+              nread = file_pread(&fp->zip, fp->inbuf, nread,
+                                 fp->data + fp->strm.total_in);
+            }
+
+          if (nread <= 0)
+            {
+              ret = nread < 0 ? nread : -EIO;
+              break;
+            }
+
+          fp->strm.next_in  = fp->inbuf;
+          fp->strm.avail_in = nread;
+        }
+
+      ret = inflate(&fp->strm, Z_NO_FLUSH);
+
+#  if CONFIG_ZIPFS_SEEK_POINTS > 0
+      /* Save the state whenever the next interval boundary was passed */
+
+      if (fp->nseek < CONFIG_ZIPFS_SEEK_POINTS &&
+          fp->strm.total_out >=
+          (uLong)(fp->nseek + 1) * CONFIG_ZIPFS_SEEK_INTERVAL &&
+          inflateCopy(&fp->seek[fp->nseek], &fp->strm) == Z_OK)
+        {
+          fp->nseek++;
+        }
+#  endif
+
+      if (ret == Z_STREAM_END)
+        {
+          ret = OK;
+          break;
+        }
+      else if (ret != Z_OK)
+        {
+          ret = ret == Z_MEM_ERROR ? -ENOMEM : -EIO;
+          break;
+        }
+    }
+
+  len -= fp->strm.avail_out;
+  if (len > 0)
+    {
+      ret = zipfs_direct_crc(fp, buf, pos, len);
+    }
+
+  return ret < 0 ? ret : len;
+}
+
+/* Bring the inflate state to the uncompressed offset "pos", restarting from
+ * the nearest saved state if that is closer than going on from here.
+ */
+
+static int zipfs_direct_position(FAR struct zipfs_file_s *fp, off_t pos)
+{
+  FAR z_stream *best = NULL;
+  ssize_t ret;
+
+#  if CONFIG_ZIPFS_SEEK_POINTS > 0
+  int i;
+
+  for (i = fp->nseek - 1; i >= 0; i--)
+    {
+      if (fp->seek[i].total_out <= pos)
+        {
+          best = &fp->seek[i];
+          break;
+        }
+    }
+#  endif
+
+  if (pos < fp->strm.total_out ||
+      (best != NULL && best->total_out > fp->strm.total_out))
+    {
+      if (best == NULL)
+        {
+          ret = inflateReset(&fp->strm);
+        }
+      else
+        {
+          inflateEnd(&fp->strm);
+          ret = inflateCopy(&fp->strm, best);
+          if (ret != Z_OK)
+            {
+              ret = inflateInit2(&fp->strm, -MAX_WBITS);
+            }
+        }
+
+      fp->strm.avail_in = 0;
+      if (ret != Z_OK)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  if (fp->strm.total_out < pos && fp->seekbuf == NULL)
+    {
+      fp->seekbuf = fs_heap_malloc(CONFIG_ZIPFS_SEEK_BUFSIZE);
+      if (fp->seekbuf == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  while (fp->strm.total_out < pos)
+    {
+      ret = zipfs_direct_inflate(fp, fp->seekbuf,
+                                 MIN(CONFIG_ZIPFS_SEEK_BUFSIZE,
+                                     pos - fp->strm.total_out));
+      if (ret <= 0)
+        {
+          return ret < 0 ? ret : -EIO;
+        }
+    }
+
+  return OK;
+}
+
+static ssize_t zipfs_direct_read(FAR struct zipfs_file_s *fp,
+                                 FAR char *buffer, size_t buflen,
+                                 off_t pos)
+{
+  ssize_t ret;
+
+  if (pos >= fp->usize)
+    {
+      return 0;
+    }
+
+  buflen = MIN(buflen, fp->usize - pos);
+  if (fp->deflated)
+    {
+      ret = zipfs_direct_position(fp, pos);
+      if (ret >= 0)
+        {
+          ret = zipfs_direct_inflate(fp, buffer, buflen);
+        }
+    }
+  else
+    {
+      ret = file_pread(&fp->zip, buffer, buflen, fp->data + pos);
+      if (ret > 0)
+        {
+          int err = zipfs_direct_crc(fp, buffer, pos, ret);
+          if (err < 0)
+            {
+              ret = err;
+            }
+        }
+    }
+
+  return ret;
+}
+#endif
+
 static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
                       int oflags, mode_t mode)
 {
@@ -271,7 +768,7 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
       goto err_with_mutex;
     }
 
-  ret = zipfs_convert_result(unzLocateFile(fp->uf, relpath, 0));
+  ret = zipfs_locate(fs, fp->uf, relpath);
   if (ret < 0)
     {
       goto err_with_zip;
@@ -285,6 +782,9 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
 
   if (ret == OK)
     {
+#ifdef CONFIG_ZIPFS_RANDOM_ACCESS
+      zipfs_direct_init(fs, fp);
+#endif
       fp->seekbuf = NULL;
       strcpy(fp->relpath, relpath);
       filep->f_priv = fp;
@@ -307,6 +807,9 @@ static int zipfs_close(FAR struct file *filep)
   FAR struct zipfs_file_s *fp = filep->f_priv;
   int ret;
 
+#ifdef CONFIG_ZIPFS_RANDOM_ACCESS
+  zipfs_direct_uninit(fp);
+#endif
   ret = zipfs_convert_result(unzClose(fp->uf));
   nxmutex_destroy(&fp->lock);
   fs_heap_free(fp->seekbuf);
@@ -321,7 +824,18 @@ static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t ret;
 
   nxmutex_lock(&fp->lock);
-  ret = zipfs_convert_result(unzReadCurrentFile(fp->uf, buffer, buflen));
+#ifdef CONFIG_ZIPFS_RANDOM_ACCESS
+  if (fp->direct)
+    {
+      ret = zipfs_direct_read(fp, buffer, buflen, filep->f_pos);
+    }
+  else
+#endif
+    {
+      ret = zipfs_convert_result(unzReadCurrentFile(fp->uf, buffer,
+                                                    buflen));
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -369,7 +883,6 @@ static off_t zipfs_skip(FAR struct zipfs_file_s *fp, off_t amount)
 static off_t zipfs_seek(FAR struct file *filep, off_t offset,
                         int whence)
 {
-  FAR struct zipfs_mountpt_s *fs = filep->f_inode->i_private;
   FAR struct zipfs_file_s *fp = filep->f_priv;
   unz_file_info64 file_info;
   off_t ret = 0;
@@ -398,31 +911,31 @@ static off_t zipfs_seek(FAR struct file *filep, off_t offset,
         goto err_with_lock;
     }
 
+  if (offset < 0)
+    {
+      ret = -EINVAL;
+      goto err_with_lock;
+    }
+
+#ifdef CONFIG_ZIPFS_RANDOM_ACCESS
+  /* The data is positioned by the next read */
+
+  if (fp->direct)
+    {
+      filep->f_pos = MIN(offset, fp->usize);
+      goto err_with_lock;
+    }
+#endif
+
   if (filep->f_pos == offset)
     {
       goto err_with_lock;
     }
   else if (filep->f_pos > offset)
     {
-      ret = zipfs_convert_result(unzClose(fp->uf));
-      if (ret < 0)
-        {
-          goto err_with_lock;
-        }
-
-      fp->uf = unzOpen2_64(fs->abspath, &zipfs_real_ops);
-      if (fp->uf == NULL)
-        {
-          ret = -EINVAL;
-          goto err_with_lock;
-        }
-
-      ret = zipfs_convert_result(unzLocateFile(fp->uf, fp->relpath, 0));
-      if (ret < 0)
-        {
-          goto err_with_lock;
-        }
+      /* The entry stays selected, so only inflate has to start over */
 
+      unzCloseCurrentFile(fp->uf);
       ret = zipfs_convert_result(unzOpenCurrentFile(fp->uf));
       if (ret < 0)
         {
@@ -584,6 +1097,9 @@ static int zipfs_bind(FAR struct inode *driver, FAR const void *data,
 {
   FAR struct zipfs_mountpt_s *fs;
   unzFile uf;
+#ifdef CONFIG_ZIPFS_INDEX
+  int ret;
+#endif
 
   if (data == NULL)
     {
@@ -603,6 +1119,16 @@ static int zipfs_bind(FAR struct inode *driver, FAR const void *data,
       return -EINVAL;
     }
 
+#ifdef CONFIG_ZIPFS_INDEX
+  ret = zipfs_build_index(fs, uf);
+  if (ret < 0)
+    {
+      unzClose(uf);
+      fs_heap_free(fs);
+      return ret;
+    }
+#endif
+
   unzClose(uf);
   strcpy(fs->abspath, data);
   *handle = fs;
@@ -613,6 +1139,11 @@ static int zipfs_bind(FAR struct inode *driver, FAR const void *data,
 static int zipfs_unbind(FAR void *handle, FAR struct inode **driver,
                         unsigned int flags)
 {
+#ifdef CONFIG_ZIPFS_INDEX
+  FAR struct zipfs_mountpt_s *fs = handle;
+
+  fs_heap_free(fs->entries);
+#endif
   fs_heap_free(handle);
   return OK;
 }
@@ -628,8 +1159,12 @@ static int zipfs_stat(FAR struct inode *mountpt,
                       FAR const char *relpath, FAR struct stat *buf)
 {
   FAR struct zipfs_mountpt_s *fs;
+#ifdef CONFIG_ZIPFS_INDEX
+  FAR struct zipfs_entry_s *entry;
+#else
   unzFile uf;
   int ret;
+#endif
 
   /* Sanity checks */
 
@@ -642,13 +1177,28 @@ static int zipfs_stat(FAR struct inode *mountpt,
     }
 
   fs = mountpt->i_private;
+
+#ifdef CONFIG_ZIPFS_INDEX
+  /* The index knows everything that is reported */
+
+  entry = zipfs_find(fs, relpath);
+  if (entry == NULL)
+    {
+      return -ENOENT;
+    }
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_size = entry->size;
+  buf->st_mode = S_IFREG | 0444;
+  return OK;
+#else
   uf = unzOpen2_64(fs->abspath, &zipfs_real_ops);
   if (uf == NULL)
     {
       return -EINVAL;
     }
 
-  ret = zipfs_convert_result(unzLocateFile(uf, relpath, 0));
+  ret = zipfs_locate(fs, uf, relpath);
   if (ret < 0)
     {
       unzClose(uf);
@@ -659,4 +1209,5 @@ static int zipfs_stat(FAR struct inode *mountpt,
 
   unzClose(uf);
   return ret;
+#endif
 }
@@ -69,6 +69,13 @@ void NXGL_FUNCNAME(nxgl_copyrectangle, NXGLIB_SUFFIX)
   int lnlen;
 #endif
 
+#if defined(CONFIG_NX_HWACCEL) && NXGLIB_BITSPERPIXEL >= 8
+  if (up_nxgl_copyrectangle(pinfo, dest, src, origin, srcstride) >= 0)
+    {
+      return;
+    }
+#endif
+
   /* Get the width of the framebuffer in bytes */
 
   deststride = pinfo->stride;
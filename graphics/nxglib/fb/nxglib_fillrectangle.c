@@ -73,6 +73,13 @@ void NXGL_FUNCNAME(nxgl_fillrectangle, NXGLIB_SUFFIX)
   int lnlen;
 #endif
 
+#if defined(CONFIG_NX_HWACCEL) && NXGLIB_BITSPERPIXEL >= 8
+  if (up_nxgl_fillrectangle(pinfo, rect, color) >= 0)
+    {
+      return;
+    }
+#endif
+
   /* Get the width of the framebuffer in bytes */
 
   stride = pinfo->stride;
@@ -119,6 +119,13 @@ void NXGL_FUNCNAME(nxgl_moverectangle, NXGLIB_SUFFIX)
   uint8_t tailmask;
 #endif
 
+#if defined(CONFIG_NX_HWACCEL) && NXGLIB_BITSPERPIXEL >= 8
+  if (up_nxgl_moverectangle(pinfo, rect, offset) >= 0)
+    {
+      return;
+    }
+#endif
+
   /* Get the width of the framebuffer in bytes */
 
   stride = pinfo->stride;
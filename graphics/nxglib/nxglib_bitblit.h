@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <string.h>
 
 #include <nuttx/nx/nxglib.h>
 
@@ -141,18 +142,13 @@
        } \
    }
 
+/* Rows are copied with memmove(), the C library version is the one
+ * optimized for the architecture, and a row may overlap itself when moved
+ * horizontally.
+ */
+
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+   memmove((dest), (src), NXGL_SCALEX(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -171,28 +167,13 @@
    }
 
 #endif /* CONFIG_NX_ANTIALIASING */
-#else /* NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32 */
+#else /* NXGLIB_BITSPERPIXEL == 8, 16 or 32 */
 
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
-     nxgl_coord_t     _npix = (width); \
-     while (_npix--) \
-       { \
-         *_ptr++ = (value); \
-       } \
-   }
+   nxgl_memset((FAR NXGL_PIXEL_T *)(dest), (NXGL_PIXEL_T)(value), (width))
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR NXGL_PIXEL_T *_dptr = (FAR NXGL_PIXEL_T*)(dest); \
-     FAR NXGL_PIXEL_T *_sptr = (FAR NXGL_PIXEL_T*)(src); \
-     nxgl_coord_t      _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+   memmove((dest), (src), NXGL_SCALEX(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -228,6 +209,58 @@ extern "C"
  * Public Functions Definitions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxgl_memset
+ *
+ * Description:
+ *   Fill a run of whole byte pixels.  16-bit pixels are stored in pairs as
+ *   words, the loops are simple enough for the compiler to vectorize.
+ *
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL == 8
+static inline void nxgl_memset(FAR uint8_t *dest, uint8_t value,
+                               size_t npixels)
+{
+  memset(dest, value, npixels);
+}
+
+#elif NXGLIB_BITSPERPIXEL == 16
+static inline void nxgl_memset(FAR uint16_t *dest, uint16_t value,
+                               size_t npixels)
+{
+  FAR uint32_t *wptr;
+  uint32_t wide;
+
+  if (((uintptr_t)dest & 2) != 0 && npixels > 0)
+    {
+      *dest++ = value;
+      npixels--;
+    }
+
+  wide = (uint32_t)value << 16 | value;
+  for (wptr = (FAR uint32_t *)dest; npixels >= 2; npixels -= 2)
+    {
+      *wptr++ = wide;
+    }
+
+  if (npixels > 0)
+    {
+      *(FAR uint16_t *)wptr = value;
+    }
+}
+
+#elif NXGLIB_BITSPERPIXEL == 32
+static inline void nxgl_memset(FAR uint32_t *dest, uint32_t value,
+                               size_t npixels)
+{
+  while (npixels-- > 0)
+    {
+      *dest++ = value;
+    }
+}
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
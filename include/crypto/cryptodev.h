@@ -319,6 +319,11 @@ struct cryptocap
 #define CRYPTOCAP_F_SOFTWARE    0x02
 #define CRYPTOCAP_F_ENCRYPT_MAC 0x04 /* Can do encrypt-then-MAC (IPsec) */
 #define CRYPTOCAP_F_MAC_ENCRYPT 0x08 /* Can do MAC-then-encrypt (TLS) */
+#define CRYPTOCAP_F_ASYNC       0x10 /* cc_process may return before a request
+                                      * with a crp_callback is done, the driver
+                                      * calls crypto_done() for every request
+                                      * it accepted
+                                      */
 
   CODE int (*cc_newsession)(FAR uint32_t *, FAR struct cryptoini *);
   CODE int (*cc_process)(FAR struct cryptop *);
@@ -369,6 +374,35 @@ struct crypt_op
   caddr_t mac;        /* must be big enough for chosen MAC */
   caddr_t iv;
   caddr_t aad;
+  uint32_t reqid;     /* distinguish tasks in asynchronous calling */
+};
+
+/* ioctl parameter of CIOCASYNCCRYPT: operations started without waiting
+ * for them.  Their buffers must stay valid until the completion is fetched
+ * with CIOCASYNCFETCH.
+ */
+
+struct crypt_mop
+{
+  unsigned count;            /* Number of operations */
+  FAR struct crypt_op *ops;  /* The operations */
+};
+
+/* Completion of an operation started by CIOCASYNCCRYPT */
+
+struct crypt_res
+{
+  uint32_t ses;              /* Session of the operation */
+  uint32_t reqid;            /* reqid of the operation */
+  int status;                /* 0 or a negated errno value */
+};
+
+/* ioctl parameter of CIOCASYNCFETCH */
+
+struct crypt_mres
+{
+  unsigned count;            /* Room in res, returns: number filled */
+  FAR struct crypt_res *res;
 };
 
 /* hamc buffer, software & hardware need it */
@@ -392,6 +426,8 @@ extern const uint8_t hmac_opad_buffer[HMAC_MAX_BLOCK_LEN];
 #define CIOCKEY                 104
 #define CIOCKEYRET              105
 #define CIOCASYMFEAT            106
+#define CIOCASYNCCRYPT          107
+#define CIOCASYNCFETCH          108
 
 int crypto_newsession(FAR uint64_t *, FAR struct cryptoini *, int);
 int crypto_freesession(uint64_t);
@@ -406,6 +442,7 @@ int crypto_get_driverid(uint8_t);
 int crypto_invoke(FAR struct cryptop *);
 int crypto_kinvoke(FAR struct cryptkop *);
 int crypto_getfeat(FAR int *);
+void crypto_done(FAR struct cryptop *);
 
 FAR struct cryptop *crypto_getreq(int);
 void crypto_freereq(FAR struct cryptop *);
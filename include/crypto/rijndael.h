@@ -29,7 +29,10 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <sys/types.h>
+#include <stdbool.h>
 
 #define AES_MAXKEYBITS  (256)
 #define AES_MAXKEYBYTES (AES_MAXKEYBITS / 8)
@@ -46,6 +49,9 @@ typedef struct
   int nr;                               /* key-length-dependent number of rounds */
   uint32_t ek[4 * (AES_MAXROUNDS + 1)]; /* encrypt key schedule */
   uint32_t dk[4 * (AES_MAXROUNDS + 1)]; /* decrypt key schedule */
+#ifdef CONFIG_CRYPTO_AES_HW
+  bool hw;                              /* schedules in byte order for the CPU */
+#endif
 } rijndael_ctx;
 
 int rijndael_set_key(FAR rijndael_ctx *, FAR const u_char *, int);
@@ -64,4 +70,13 @@ void rijndael_encrypt1(const unsigned int [],
                        const unsigned char [],
                        unsigned char []);
 
+#ifdef CONFIG_CRYPTO_AES_HW
+bool aes_hw_available(void);
+void aes_hw_initialize(void);
+void aes_hw_encrypt(FAR const uint8_t *, int, FAR const uint8_t *,
+                    FAR uint8_t *);
+void aes_hw_decrypt(FAR const uint8_t *, int, FAR const uint8_t *,
+                    FAR uint8_t *);
+#endif
+
 #endif /* __INCLUDE_CRYPTO_RIJNDAEL_H */
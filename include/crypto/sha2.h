@@ -40,6 +40,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <sys/types.h>
 
 /* SHA-256/384/512 Various Length Definitions */
@@ -86,4 +88,8 @@ void sha512init(FAR SHA2_CTX *);
 void sha512update(FAR SHA2_CTX *, FAR const void *, size_t);
 void sha512final(FAR uint8_t *, FAR SHA2_CTX *);
 
+#ifdef CONFIG_CRYPTO_SHA2_HW
+void sha2_hw_initialize(void);
+#endif
+
 #endif /* __INCLUDE_CRYPTO_SHA2_H */
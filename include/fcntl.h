@@ -160,6 +160,22 @@
 #define F_SEAL_WRITE        0x0008 /* Prevent writes */
 #define F_SEAL_FUTURE_WRITE 0x0010 /* Prevent future writes while mapped */
 
+/* Advice for posix_fadvise() */
+
+#define POSIX_FADV_NORMAL     0 /* No particular access pattern */
+#define POSIX_FADV_RANDOM     1 /* Random access, do not read ahead */
+#define POSIX_FADV_SEQUENTIAL 2 /* Sequential access, read ahead eagerly */
+#define POSIX_FADV_WILLNEED   3 /* The range will be accessed soon */
+#define POSIX_FADV_DONTNEED   4 /* The range will not be accessed soon */
+#define POSIX_FADV_NOREUSE    5 /* The range will be accessed only once */
+
+/* Flags for splice() and tee() (Linux) */
+
+#define SPLICE_F_MOVE         1 /* Hint only, data is always moved */
+#define SPLICE_F_NONBLOCK     2 /* Do not block on the pipes */
+#define SPLICE_F_MORE         4 /* More data will follow, ignored */
+#define SPLICE_F_GIFT         8 /* Ignored */
+
 /* int creat(const char *path, mode_t mode);
  *
  * is equivalent to open with O_WRONLY|O_CREAT|O_TRUNC.
@@ -220,6 +236,11 @@ int openat(int dirfd, FAR const char *path, int oflag, ...);
 int fcntl(int fd, int cmd, ...);
 
 int posix_fallocate(int fd, off_t offset, off_t len);
+int posix_fadvise(int fd, off_t offset, off_t len, int advice);
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags);
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags);
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -35,6 +35,7 @@
 
 /* Special PID to query the info about alloc, free and mempool */
 
+#define PID_MM_PROFILE ((pid_t)-7)
 #define PID_MM_ORPHAN  ((pid_t)-6)
 #define PID_MM_BIGGEST ((pid_t)-5)
 #define PID_MM_FREE    ((pid_t)-4)
@@ -42,6 +43,12 @@
 #define PID_MM_LEAK    ((pid_t)-2)
 #define PID_MM_MEMPOOL ((pid_t)-1)
 
+/* Flags of malloc_region() and memalign_region(): prefer fast memory,
+ * such as internal SRAM or TCM.
+ */
+
+#define MALLOC_REGION_FAST 0x01
+
 /* For Linux and MacOS compatibility */
 
 #define malloc_usable_size malloc_size
@@ -104,6 +111,12 @@ struct mallinfo mallinfo(void);
 size_t malloc_size(FAR void *ptr);
 struct mallinfo_task mallinfo_task(FAR const struct malltask *task);
 
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+FAR void *malloc_region(size_t size, unsigned int flags);
+FAR void *memalign_region(size_t alignment, size_t size,
+                          unsigned int flags);
+#endif
+
 #if defined(__cplusplus)
 }
 #endif
@@ -142,6 +142,16 @@
 #define mdio_phy_id_c45(prtad, devad) \
     ((uint16_t)(MDIO_PHY_ID_C45 | ((prtad) << 5) | (devad)))
 
+/* Values of hwtstamp_config::tx_type and rx_filter (same as Linux) */
+
+#define HWTSTAMP_TX_OFF             0  /* No outgoing packet is stamped */
+#define HWTSTAMP_TX_ON              1  /* Stamp packets that request it */
+
+#define HWTSTAMP_FILTER_NONE        0  /* Stamp no incoming packet */
+#define HWTSTAMP_FILTER_ALL         1  /* Stamp every incoming packet */
+#define HWTSTAMP_FILTER_SOME        2  /* Stamp some, driver's choice */
+#define HWTSTAMP_FILTER_PTP_V2_EVENT 12 /* Stamp PTPv2 event messages */
+
 /* RFC 2863 operational status */
 
 enum
@@ -213,6 +223,18 @@ struct can_ioctl_filter_s
   uint8_t  fprio; /* See CAN_MSGPRIO_* definitions */
 };
 
+/* Structure pointed to by ifr_data for the SIOCxHWTSTAMP ioctl commands.
+ * The driver may widen rx_filter (e.g. to HWTSTAMP_FILTER_ALL) and reports
+ * the value it actually applied back to the caller.
+ */
+
+struct hwtstamp_config
+{
+  int flags;      /* Reserved, must be zero */
+  int tx_type;    /* HWTSTAMP_TX_* */
+  int rx_filter;  /* HWTSTAMP_FILTER_* */
+};
+
 /* Define an struct type that describes the CAN/LIN state */
 
 enum can_ioctl_state_e
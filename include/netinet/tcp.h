@@ -59,4 +59,8 @@
 #define TCP_MAXSEG    (__SO_PROTOCOL + 4) /* The maximum segment size */
 #define TCP_CORK      (__SO_PROTOCOL + 5) /* Coalescing of small segments */
 
+/* Congestion control algorithm, argument: name string */
+
+#define TCP_CONGESTION (__SO_PROTOCOL + 6)
+
 #endif /* __INCLUDE_NETINET_TCP_H */
@@ -49,8 +49,45 @@
 #define PACKET_ADD_MEMBERSHIP  1 /* Add a multicast address to the interface */
 #define PACKET_DROP_MEMBERSHIP 2 /* Drop a multicast address from the interface */
 
+#define PACKET_RX_RING         5 /* Set up a mapped receive ring */
+#define PACKET_STATISTICS      6 /* Get the counters of the receive ring */
+#define PACKET_VERSION        10 /* Set the format of the rings */
+#define PACKET_TX_RING        13 /* Set up a mapped transmit ring */
+
 #define PACKET_MR_MULTICAST    0 /* Multicast address */
 
+/* Status of the blocks of a receive ring (block_status):  owned by the
+ * kernel or by the application, frames were dropped before the block, the
+ * block was retired by the timeout.
+ */
+
+#define TP_STATUS_KERNEL       0
+#define TP_STATUS_USER         (1 << 0)
+#define TP_STATUS_LOSING       (1 << 2)
+#define TP_STATUS_BLK_TMO      (1 << 5)
+
+/* Status of the frames of a transmit ring (tp_status):  free for the
+ * application, filled to be sent, being sent, rejected (e.g. too long).
+ */
+
+#define TP_STATUS_AVAILABLE    0
+#define TP_STATUS_SEND_REQUEST (1 << 0)
+#define TP_STATUS_SENDING      (1 << 1)
+#define TP_STATUS_WRONG_FORMAT (1 << 2)
+
+/* Frames and blocks are aligned within the rings */
+
+#define TPACKET_ALIGNMENT  16
+#define TPACKET_ALIGN(x)   (((x) + TPACKET_ALIGNMENT - 1) & \
+                            ~(TPACKET_ALIGNMENT - 1))
+
+/* Offset of the frame data from the start of its struct tpacket3_hdr in a
+ * receive ring, the struct sockaddr_ll of the sender lies in between.
+ */
+
+#define TPACKET3_HDRLEN    (TPACKET_ALIGN(sizeof(struct tpacket3_hdr)) + \
+                            sizeof(struct sockaddr_ll))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -74,4 +111,101 @@ struct packet_mreq
   unsigned char  mr_address[8];
 };
 
+/* Ring format selected with PACKET_VERSION, only TPACKET_V3 is supported */
+
+enum tpacket_versions
+{
+  TPACKET_V1,
+  TPACKET_V2,
+  TPACKET_V3
+};
+
+/* Geometry of a ring, passed to PACKET_RX_RING and PACKET_TX_RING.  A ring
+ * is made of tp_block_nr blocks of tp_block_size bytes.  Receive blocks
+ * are filled with variable sized frames, transmit blocks are split into
+ * frames of tp_frame_size bytes.
+ */
+
+struct tpacket_req3
+{
+  unsigned int tp_block_size;      /* Size of a block */
+  unsigned int tp_block_nr;        /* Number of blocks */
+  unsigned int tp_frame_size;      /* Size of a frame */
+  unsigned int tp_frame_nr;        /* Total number of frames */
+  unsigned int tp_retire_blk_tov;  /* Timeout in msecs to retire a block */
+  unsigned int tp_sizeof_priv;     /* Private area at the start of a block */
+  unsigned int tp_feature_req_word;
+};
+
+/* Counters returned by PACKET_STATISTICS, cleared when read */
+
+struct tpacket_stats_v3
+{
+  unsigned int tp_packets;         /* Frames stored or dropped */
+  unsigned int tp_drops;           /* Frames dropped, no free block */
+  unsigned int tp_freeze_q_cnt;    /* Times the ring got full */
+};
+
+/* Header of each frame in a ring */
+
+struct tpacket_hdr_variant1
+{
+  uint32_t tp_rxhash;
+  uint32_t tp_vlan_tci;
+  uint16_t tp_vlan_tpid;
+  uint16_t tp_padding;
+};
+
+struct tpacket3_hdr
+{
+  uint32_t tp_next_offset;         /* Offset of the next frame in block */
+  uint32_t tp_sec;                 /* Reception time */
+  uint32_t tp_nsec;
+  uint32_t tp_snaplen;             /* Bytes stored in the ring */
+  uint32_t tp_len;                 /* Length of the frame */
+  uint32_t tp_status;
+  uint16_t tp_mac;                 /* Offset of the link layer header */
+  uint16_t tp_net;                 /* Offset of the network header */
+  union
+  {
+    struct tpacket_hdr_variant1 hv1;
+  };
+  uint8_t  tp_padding[8];
+};
+
+/* Header of each block of a receive ring */
+
+struct tpacket_bd_ts
+{
+  unsigned int ts_sec;
+  union
+  {
+    unsigned int ts_usec;
+    unsigned int ts_nsec;
+  };
+};
+
+struct tpacket_hdr_v1
+{
+  uint32_t block_status;
+  uint32_t num_pkts;               /* Number of frames in the block */
+  uint32_t offset_to_first_pkt;
+  uint32_t blk_len;                /* Bytes used in the block */
+  uint64_t seq_num;                /* Sequence number of the block */
+  struct tpacket_bd_ts ts_first_pkt;
+  struct tpacket_bd_ts ts_last_pkt;
+};
+
+union tpacket_bd_header_u
+{
+  struct tpacket_hdr_v1 bh1;
+};
+
+struct tpacket_block_desc
+{
+  uint32_t version;
+  uint32_t offset_to_priv;
+  union tpacket_bd_header_u hdr;
+};
+
 #endif /* __INCLUDE_NETPACKET_PACKET_H */
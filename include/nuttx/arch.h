@@ -2545,6 +2545,31 @@ size_t up_check_intstack(int cpu, size_t check_size);
 uintptr_t up_get_intstackbase(int cpu);
 #endif
 
+/****************************************************************************
+ * Name: nxsched_stack_color and nxsched_stack_check
+ *
+ * Description:
+ *   Sparse stack coloration, provided by the OS for the architecture's
+ *   stack coloring and checking logic.  nxsched_stack_color() colors only
+ *   a guard area at the bottom of the stack and probe words at
+ *   exponentially growing distances from the top; nxsched_stack_check()
+ *   estimates the high water mark from them.
+ *
+ * Input Parameters:
+ *   start - The word aligned lowest address of the stack
+ *   end   - The word aligned top of the stack
+ *   color - The architecture's stack coloration value
+ *
+ * Returned Value:
+ *   nxsched_stack_check() returns the estimated amount of stack space used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_STACK_COLORATION_SPARSE
+void nxsched_stack_color(FAR void *start, FAR void *end, uint32_t color);
+size_t nxsched_stack_check(FAR void *start, FAR void *end, uint32_t color);
+#endif
+
 /****************************************************************************
  * Name: up_rtc_initialize
  *
@@ -43,6 +43,9 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mutex.h>
 #include <nuttx/spi/spi.h>
@@ -94,6 +97,12 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * AUDIOIOC_MMAPSETUP - Set up a ring of periods for mmap()
+ *
+ *   ioctl argument:  Pointer to the audio_mmap_desc_s structure.  A zero
+ *                    period count releases the ring.  Only allowed while
+ *                    the stream is stopped.
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -117,6 +126,14 @@
 #define AUDIOIOC_GETLATENCY         _AUDIOIOC(19)
 #define AUDIOIOC_FLUSH              _AUDIOIOC(20)
 #define AUDIOIOC_GETPOSITION        _AUDIOIOC(21)
+#define AUDIOIOC_MMAPSETUP          _AUDIOIOC(22)
+
+/* mmap() offsets of an audio device with a ring set up by
+ * AUDIOIOC_MMAPSETUP: the samples of the ring and its audio_mmap_ctrl_s.
+ */
+
+#define AUDIO_MMAP_OFFSET_DATA      0x00000000
+#define AUDIO_MMAP_OFFSET_CTRL      0x40000000
 
 /* Audio Device Types *******************************************************/
 
@@ -526,6 +543,36 @@ struct audio_buf_desc_s
   } u;
 };
 
+/* Structure for setting up a ring of periods via AUDIOIOC_MMAPSETUP */
+
+struct audio_mmap_desc_s
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void            *session;           /* Associated channel */
+#endif
+  apb_samp_t          period_bytes;       /* Number of bytes in a period */
+  uint16_t            nperiods;           /* Number of periods in the ring */
+  uint16_t            avail_min;          /* Periods available to poll() */
+  bool                capture;            /* The device fills the ring */
+};
+
+/* Shared state of a mmap()ed ring.  hw_ptr is advanced by the driver each
+ * time the device is done with a period, appl_ptr by the application as
+ * it writes (playback) or reads (capture) the ring.  Both count bytes and
+ * wrap at 'boundary', a multiple of the ring size, so 'ptr % ring size' is
+ * the offset in the ring.  Stopping the stream resets both to zero.
+ */
+
+struct audio_mmap_ctrl_s
+{
+  volatile uint32_t   hw_ptr;             /* Bytes done by the device */
+  volatile uint32_t   appl_ptr;           /* Bytes done by the application */
+  volatile uint32_t   xruns;              /* Periods the application missed */
+  uint32_t            period_bytes;       /* Number of bytes in a period */
+  uint32_t            nperiods;           /* Number of periods in the ring */
+  uint32_t            boundary;           /* Wrap point of the pointers */
+};
+
 /* Typedef for lower-level to upper-level callback for buffer dequeuing */
 
 #ifdef CONFIG_AUDIO_MULTI_SESSION
@@ -0,0 +1,76 @@
+/****************************************************************************
+ * include/nuttx/audio/audio_mixer.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H
+#define __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_AUDIO_MIXER
+#include <nuttx/audio/audio.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Share an output device between several streams.  One audio device
+ *   named "<name><n>" is registered for each stream; the samples of all
+ *   the running streams are converted to the format of the device, scaled
+ *   by the volume of their stream and added up.
+ *
+ * Input Parameters:
+ *   name     - The prefix of the names of the audio devices.
+ *   lower    - The lower half audio driver of the output device.
+ *   nstreams - The number of streams.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR const char *name,
+                           FAR struct audio_lowerhalf_s *lower,
+                           int nstreams);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_AUDIO_MIXER */
+#endif /* __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H */
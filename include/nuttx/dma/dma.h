@@ -282,6 +282,33 @@ struct dma_link_config_s
 };
 #endif
 
+/* One entry of a scatter-gather list */
+
+struct dma_sg_s
+{
+  uintptr_t dst;                /* The destination address */
+  uintptr_t src;                /* The source address */
+  size_t len;                   /* The length to transfer */
+};
+
+/* A scatter-gather transfer prepared by dma_prep_sg().  The list and the
+ * descriptor belong to the channel until the callback is called, with the
+ * total length or the first error.
+ */
+
+struct dma_desc_s
+{
+  FAR const struct dma_sg_s *sg; /* The list of entries */
+  size_t nsg;                    /* The number of entries */
+  dma_callback_t callback;       /* Called when the list is done */
+  FAR void *arg;                 /* Passed to the callback */
+
+  /* Used by the generic fallback */
+
+  size_t index;                  /* The entry in progress */
+  ssize_t total;                 /* The length transferred so far */
+};
+
 /* The DMA vtable */
 
 struct dma_ops_s
@@ -305,6 +332,14 @@ struct dma_ops_s
   CODE int (*pause)(FAR struct dma_chan_s *chan);
   CODE int (*resume)(FAR struct dma_chan_s *chan);
   CODE size_t (*residual)(FAR struct dma_chan_s *chan);
+
+  /* Optional: run a whole scatter-gather list from hardware descriptors.
+   * Without it, dma_start_sg() starts the entries one after the other.
+   */
+
+  CODE int (*start_sg)(FAR struct dma_chan_s *chan,
+                       dma_callback_t callback, FAR void *arg,
+                       FAR const struct dma_sg_s *sg, size_t nsg);
 };
 
 /* This structure only defines the initial fields of the structure
@@ -325,4 +360,117 @@ struct dma_dev_s
                         FAR struct dma_chan_s *chan);
 };
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_DMA
+
+/****************************************************************************
+ * Name: dma_register
+ *
+ * Description:
+ *   Make a DMA controller available to generic drivers, which then get its
+ *   channels by 'minor' with dma_request_chan().
+ *
+ * Input Parameters:
+ *   minor - The number of the controller, below CONFIG_DMA_NDEVICES
+ *   dev   - The controller
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_register(int minor, FAR struct dma_dev_s *dev);
+
+/****************************************************************************
+ * Name: dma_request_chan
+ *
+ * Description:
+ *   Get a channel of a registered controller, see DMA_GET_CHAN().
+ *
+ * Returned Value:
+ *   The channel; NULL if no controller is registered as 'minor'.
+ *
+ ****************************************************************************/
+
+FAR struct dma_chan_s *dma_request_chan(int minor, unsigned int ident);
+
+/****************************************************************************
+ * Name: dma_release_chan
+ *
+ * Description:
+ *   Release a channel got from dma_request_chan().
+ *
+ ****************************************************************************/
+
+void dma_release_chan(int minor, FAR struct dma_chan_s *chan);
+
+/****************************************************************************
+ * Name: dma_prep_sg
+ *
+ * Description:
+ *   Prepare a descriptor for a scatter-gather transfer of 'nsg' entries.
+ *   The channel must have been configured for the direction of the list.
+ *
+ ****************************************************************************/
+
+void dma_prep_sg(FAR struct dma_desc_s *desc, FAR const struct dma_sg_s *sg,
+                 size_t nsg, dma_callback_t callback, FAR void *arg);
+
+/****************************************************************************
+ * Name: dma_start_sg
+ *
+ * Description:
+ *   Start a prepared scatter-gather transfer.  The callback of the
+ *   descriptor gets the total length when all entries are done, or the
+ *   error of the first one that fails.  As with DMA_START(), no cache
+ *   operations are performed.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_start_sg(FAR struct dma_chan_s *chan, FAR struct dma_desc_s *desc);
+
+/****************************************************************************
+ * Name: dma_memcpy
+ *
+ * Description:
+ *   Copy memory with a channel and wait for the copy to finish.  The
+ *   caches are maintained, so the destination should be aligned to cache
+ *   lines.  Copies shorter than CONFIG_DMA_MEMCPY_THRESHOLD, or without a
+ *   channel, are done by the CPU.
+ *
+ * Input Parameters:
+ *   chan - A channel able to do DMA_MEM_TO_MEM transfers, or NULL
+ *   dst  - The destination
+ *   src  - The source
+ *   len  - The number of bytes to copy
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_memcpy(FAR struct dma_chan_s *chan, FAR void *dst,
+               FAR const void *src, size_t len);
+
+#endif /* CONFIG_DMA */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* __INCLUDE_NUTTX_DMA_DMA_H */
@@ -55,6 +55,17 @@ typedef CODE ssize_t (*rwbreload_t)(FAR void *dev, FAR uint8_t *buffer,
 typedef CODE ssize_t (*rwbflush_t)(FAR void *dev, FAR const uint8_t *buffer,
                                    off_t startblock, size_t nblocks);
 
+#ifdef CONFIG_DRVR_WRITEBUFFER
+/* A write buffer put aside while the writes go to another region */
+
+struct rwb_slot_s
+{
+  FAR uint8_t  *buffer;          /* Buffered data */
+  off_t         blockstart;      /* First block in the buffer */
+  uint16_t      nblocks;         /* Number of blocks in the buffer */
+};
+#endif
+
 /* This structure holds the state of the buffers.  In typical usage,
  * an instance of this structure is declared within each block driver
  * status structure like:
@@ -103,6 +114,10 @@ struct rwbuffer_s
   uint16_t      wralignblocks;   /* The buffer to be flash is always multiplied by this
                                   * number. It must be 0 or divisible by wrmaxblocks.
                                   */
+  uint8_t       wrnslots;        /* The number of partly written buffers kept
+                                  * aside, least recently used flushed first.
+                                  * 0 flushes when the writes move elsewhere.
+                                  */
 #endif
 #ifdef CONFIG_DRVR_READAHEAD
   uint16_t      rhmaxblocks;     /* The number of blocks to buffer in memory */
@@ -134,6 +149,12 @@ struct rwbuffer_s
   FAR uint8_t  *wrbuffer;        /* Allocated write buffer */
   uint16_t      wrnblocks;       /* Number of blocks in write buffer */
   off_t         wrblockstart;    /* First block in write buffer */
+  FAR uint8_t  *wrpool;          /* Allocation of all the write buffers */
+  uint8_t       wrnparked;       /* Number of slots holding data */
+
+  /* The slots, the parked ones first, most recently used first */
+
+  FAR struct rwb_slot_s *wrslots;
 #endif
 
   /* This is the state of the read-ahead buffering */
@@ -97,6 +97,81 @@ int fdt_register(FAR const char *fdt_base);
 
 FAR const char *fdt_get(void);
 
+/****************************************************************************
+ * Name: fdt_find_compatible
+ *
+ * Description:
+ *   Find the first node after startoffset with a compatible string.  Same
+ *   as fdt_node_offset_by_compatible(), but looked up in the index when
+ *   fdt is the registered FDT and CONFIG_DEVICE_TREE_INDEX is enabled.
+ *
+ * Input Parameters:
+ *   fdt - The pointer to the raw FDT.
+ *   startoffset - Only nodes after this offset are matched, -1 for all.
+ *   compatible - The compatible string to match.
+ *
+ * Return:
+ *   The node offset, or a negative libfdt error code.
+ *
+ ****************************************************************************/
+
+int fdt_find_compatible(FAR const void *fdt, int startoffset,
+                        FAR const char *compatible);
+
+/****************************************************************************
+ * Name: fdt_find_phandle
+ *
+ * Description:
+ *   Find the node with a phandle.  Same as fdt_node_offset_by_phandle(),
+ *   indexed like fdt_find_compatible().
+ *
+ * Input Parameters:
+ *   fdt - The pointer to the raw FDT.
+ *   phandle - The phandle to look up.
+ *
+ * Return:
+ *   The node offset, or a negative libfdt error code.
+ *
+ ****************************************************************************/
+
+int fdt_find_phandle(FAR const void *fdt, uint32_t phandle);
+
+/****************************************************************************
+ * Name: fdt_find_parent
+ *
+ * Description:
+ *   Find the parent of a node.  Same as fdt_parent_offset(), indexed like
+ *   fdt_find_compatible().
+ *
+ * Input Parameters:
+ *   fdt - The pointer to the raw FDT.
+ *   offset - The offset of the node.
+ *
+ * Return:
+ *   The parent node offset, or a negative libfdt error code.
+ *
+ ****************************************************************************/
+
+int fdt_find_parent(FAR const void *fdt, int offset);
+
+/****************************************************************************
+ * Name: fdt_find_path
+ *
+ * Description:
+ *   Find a node by its path.  Same as fdt_path_offset(), indexed like
+ *   fdt_find_compatible() for full paths.
+ *
+ * Input Parameters:
+ *   fdt - The pointer to the raw FDT.
+ *   path - The full path of the node, or an alias.
+ *
+ * Return:
+ *   The node offset, or a negative libfdt error code.
+ *
+ ****************************************************************************/
+
+int fdt_find_path(FAR const void *fdt, FAR const char *path);
+
 /****************************************************************************
  * Name: fdt_get_irq
  *
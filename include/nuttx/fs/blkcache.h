@@ -0,0 +1,133 @@
+/****************************************************************************
+ * include/nuttx/fs/blkcache.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_BLKCACHE_H
+#define __INCLUDE_NUTTX_FS_BLKCACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#include <nuttx/fs/fs.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_BLKCACHE
+#  define blkcache_read(inode, buffer, start, nsectors, sectsize) \
+     ((inode)->u.i_bops->read(inode, buffer, start, nsectors))
+#  define blkcache_write(inode, buffer, start, nsectors, sectsize) \
+     ((inode)->u.i_bops->write(inode, buffer, start, nsectors))
+#  define blkcache_flush(inode) (OK)
+#  define blkcache_invalidate(inode)
+#else
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: blkcache_read
+ *
+ * Description:
+ *   Read sectors from a block driver through the shared block cache.
+ *   Devices whose sector size is not CONFIG_FS_BLKCACHE_SECTORSIZE are
+ *   read directly.
+ *
+ * Input Parameters:
+ *   inode    - The block driver inode
+ *   buffer   - The location to return the data
+ *   start    - The first sector to read
+ *   nsectors - The number of sectors to read
+ *   sectsize - The sector size of the device
+ *
+ * Returned Value:
+ *   The number of sectors read or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                      blkcnt_t start, unsigned int nsectors,
+                      size_t sectsize);
+
+/****************************************************************************
+ * Name: blkcache_write
+ *
+ * Description:
+ *   Write sectors to a block driver through the shared block cache.  With
+ *   CONFIG_FS_BLKCACHE_WRITEBACK, writes of up to
+ *   CONFIG_FS_BLKCACHE_WRITEBACK_BATCH sectors are only made to the cache
+ *   and reach the device later, merged with adjacent dirty sectors.
+ *
+ * Returned Value:
+ *   The number of sectors written or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t blkcache_write(FAR struct inode *inode,
+                       FAR const unsigned char *buffer, blkcnt_t start,
+                       unsigned int nsectors, size_t sectsize);
+
+/****************************************************************************
+ * Name: blkcache_flush
+ *
+ * Description:
+ *   Write all dirty cached sectors of a block driver to the device.
+ *
+ * Returned Value:
+ *   Zero on success or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int blkcache_flush(FAR struct inode *inode);
+
+/****************************************************************************
+ * Name: blkcache_invalidate
+ *
+ * Description:
+ *   Flush, then drop, all cached sectors of a block driver.  This must be
+ *   called before the last user of the block driver lets go of it.
+ *
+ ****************************************************************************/
+
+void blkcache_invalidate(FAR struct inode *inode);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_FS_BLKCACHE */
+#endif /* __INCLUDE_NUTTX_FS_BLKCACHE_H */
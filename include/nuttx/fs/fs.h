@@ -189,6 +189,7 @@ struct statfs;
 struct pollfd;
 struct mtd_dev_s;
 struct uio;
+struct tcb_s;
 
 /* The internal representation of type DIR is just a container for an inode
  * reference, and the path of directory.
@@ -417,6 +418,9 @@ struct inode
   struct timespec   i_ctime;    /* Time of last status change */
 #endif
   FAR void         *i_private;  /* Per inode driver private data */
+#ifdef CONFIG_PSEUDOFS_HASH
+  FAR struct inode *i_hash;     /* Next inode in the lookup hash bucket */
+#endif
   char              i_name[1];  /* Name of inode (variable) */
 };
 
@@ -464,6 +468,12 @@ struct file
 #if CONFIG_FS_LOCK_BUCKET_SIZE > 0
   bool              f_locked;   /* Filelock state: false - unlocked, true - locked */
 #endif
+#ifdef CONFIG_FS_READAHEAD
+  FAR struct readahead_s *f_ra; /* Readahead state, see fs_readahead.c */
+#endif
+#ifdef CONFIG_FS_POLL_CACHE
+  FAR struct pollcache_ent_s *f_polls; /* Cached poll() registrations */
+#endif
 };
 
 struct fd
@@ -1636,6 +1646,21 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count);
 
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the splice function except that is accepts struct file
+ *   instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PIPES
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoff,
+                    FAR struct file *outfile, FAR off_t *outoff,
+                    size_t len, unsigned int flags);
+#endif
+
 /****************************************************************************
  * Name: file_seek
  *
@@ -1785,6 +1810,22 @@ int file_fcntl(FAR struct file *filep, int cmd, ...);
 
 int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: pollcache_release
+ *
+ * Description:
+ *   Tear down the poll() registrations that a thread keeps between calls.
+ *   Called when the thread exits.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the exiting thread
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLL_CACHE
+void pollcache_release(FAR struct tcb_s *tcb);
+#endif
+
 /****************************************************************************
  * Name: file_fstat
  *
@@ -1910,6 +1951,34 @@ int nx_unlink(FAR const char *pathname);
 int file_pipe(FAR struct file *filep[2], size_t bufsize, int flags);
 #endif
 
+/****************************************************************************
+ * Name: pipe_splice_out, pipe_splice_in, pipe_tee and pipe_move
+ *
+ * Description:
+ *   In-kernel transfers out of, into and between pipes that hand the pipe
+ *   buffer to a callback in place instead of copying it through a caller
+ *   buffer.  These implement splice() and tee().
+ *
+ * Returned Value:
+ *   The number of bytes transferred; a negated errno value is returned on
+ *   a failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PIPES
+typedef CODE ssize_t (*pipe_splice_t)(FAR void *arg, FAR void *buffer,
+                                      size_t len);
+
+ssize_t pipe_splice_out(FAR struct file *filep, pipe_splice_t sink,
+                        FAR void *arg, size_t len, bool nonblock);
+ssize_t pipe_splice_in(FAR struct file *filep, pipe_splice_t source,
+                       FAR void *arg, size_t len, bool nonblock);
+ssize_t pipe_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, bool nonblock);
+ssize_t pipe_move(FAR struct file *infile, FAR struct file *outfile,
+                  size_t len, bool nonblock);
+#endif
+
 /****************************************************************************
  * Name: nx_mkfifo
  *
@@ -1973,6 +2042,34 @@ int map_anonymous(FAR struct mm_map_entry_s *entry, bool kernel);
 #  define map_anonymous(entry, kernel) (-ENOSYS)
 #endif /* CONFIG_FS_ANONMAP */
 
+/****************************************************************************
+ * Name: filemap_fault
+ *
+ * Description:
+ *   Called by the architecture page fault handler for a fault in the
+ *   shared memory region of a user address environment.  If the address
+ *   belongs to a demand-paged file mapping, the page is mapped in or, if
+ *   it still has to be read from the file, the faulting task is blocked
+ *   until it is.  In either case the faulting access is simply retried
+ *   when the exception returns.  This function must be called from the
+ *   exception handler with the faulting task's address environment in
+ *   place.
+ *
+ * Input Parameters:
+ *   vaddr - The faulting virtual address
+ *   write - True if the fault was caused by a store
+ *
+ * Returned Value:
+ *   Zero (OK) if the access may be retried.  -EFAULT if the address is not
+ *   part of a file mapping, -EACCES if the access violates the protection
+ *   of the mapping and -EIO if the page could not be read.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_FILEMAP
+int filemap_fault(uintptr_t vaddr, bool write);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
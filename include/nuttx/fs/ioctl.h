@@ -113,6 +113,7 @@
 #define _1WIREBASE      (0x4500) /* 1WIRE ioctl commands */
 #define _EEPIOCBASE     (0x4600) /* EEPROM driver ioctl commands */
 #define _PTPBASE        (0x4700) /* PTP ioctl commands */
+#define _PROCFSBASE     (0x4800) /* Procfs ioctl commands */
 #define _WLIOCBASE      (0x8b00) /* Wireless modules ioctl network commands */
 
 /* boardctl() commands share the same number space */
@@ -248,6 +249,18 @@
 #define FIOGCLEX            _FIOC(0x0018) /* IN:  FAR int *
                                            * OUT: None
                                            */
+#define FIOC_RINGNOTIFY     _FIOC(0x0019) /* IN:  None
+                                           * OUT: None, wakes up the consumer
+                                           *      of a shared memory ring
+                                           */
+#define FIOC_RINGWAIT       _FIOC(0x001a) /* IN:  None
+                                           * OUT: None, waits for the next
+                                           *      FIOC_RINGNOTIFY
+                                           */
+#define FIOC_FADVISE        _FIOC(0x001b) /* IN:  Pointer to struct
+                                           *      fadvise_s
+                                           * OUT: None
+                                           */
 
 /* NuttX character driver ioctl definitions *********************************/
 
@@ -366,6 +379,27 @@
                                            * IN:  None
                                            * OUT: None (ioctl return value provides
                                            *      success/failure indication). */
+#define BIOC_BLKDISCARD _BIOC(0x0012)     /* Tell the device that a range of the
+                                           * media holds no data anymore.
+                                           * IN:  Pointer to uint64_t[2] with the
+                                           *      byte offset and length, both
+                                           *      aligned to the sector size.
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
+#define BIOC_BLKZEROOUT _BIOC(0x0013)     /* Write zeroes to a range of the media
+                                           * without transferring them.
+                                           * IN:  Pointer to uint64_t[2] with the
+                                           *      byte offset and length, both
+                                           *      aligned to the sector size.
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
+#define BIOC_GARBAGECOLLECT _BIOC(0x0014) /* Reclaim one erase block of released
+                                           * sectors, if worth it, while the
+                                           * device is idle.
+                                           * IN:  None
+                                           * OUT: 1 if a block was reclaimed, 0 if
+                                           *      none is worth it, or a negated
+                                           *      errno value. */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -807,6 +841,13 @@
 #define _PTPIOCVALID(c)       (_IOC_TYPE(c)==_PTPBASE)
 #define _PTPIOC(nr)           _IOC(_PTPBASE,nr)
 
+/* Procfs ioctl definitions *************************************************/
+
+/* see nuttx/include/fs/procfs.h */
+
+#define _PROCFSIOCVALID(c)    (_IOC_TYPE(c)==_PROCFSBASE)
+#define _PROCFSIOC(nr)        _IOC(_PROCFSBASE,nr)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -845,6 +886,15 @@ struct pipe_peek_s
   size_t size;
 };
 
+/* Argument of FIOC_FADVISE, see posix_fadvise() */
+
+struct fadvise_s
+{
+  off_t offset;             /* Start of the range the advice applies to */
+  off_t len;                /* Length of the range, 0 up to end of file */
+  int   advice;             /* One of POSIX_FADV_* */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
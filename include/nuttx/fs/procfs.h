@@ -29,11 +29,20 @@
 
 #include <nuttx/config.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Procfs ioctl commands ****************************************************/
+
+/* PROCFSIOC_RESET: Clear the statistics reported by the file.
+ *   Argument: None
+ */
+
+#define PROCFSIOC_RESET      _PROCFSIOC(0x0001)
+
 /* Data entry declaration prototypes ****************************************/
 
 /* Procfs operations are a subset of the mountpt_operations */
@@ -83,6 +92,10 @@ struct procfs_operations
   /* Operations on paths */
 
   CODE int     (*stat)(FAR const char *relpath, FAR struct stat *buf);
+
+  /* Placed last so that existing initializers need not change */
+
+  CODE int     (*ioctl)(FAR struct file *filep, int cmd, unsigned long arg);
 };
 
 /* Procfs handler prototypes ************************************************/
@@ -146,6 +159,79 @@ struct procfs_meminfo_entry_s
 #endif
 };
 
+#ifdef CONFIG_FS_PROCFS_INCLUDE_SNAPSHOT
+/* Layout of /proc/snapshot.  A read from offset zero takes a new snapshot,
+ * which consists of a struct procfs_snapshot_s followed by ntasks task
+ * records, nheaps heap records and npools memory pool records.  Fields
+ * are only ever appended to the records, so readers step through them by
+ * the sizes given in the header and ignore the fields they do not know.
+ */
+
+#define PROCFS_SNAPSHOT_MAGIC    0x5353584e /* "NXSS" */
+#define PROCFS_SNAPSHOT_VERSION  1
+#define PROCFS_SNAPSHOT_NAMELEN  32
+
+struct procfs_snapshot_s
+{
+  uint32_t magic;         /* PROCFS_SNAPSHOT_MAGIC */
+  uint16_t version;       /* PROCFS_SNAPSHOT_VERSION */
+  uint16_t hdrsize;       /* Size of this header */
+  uint16_t tasksize;      /* Size of a task record */
+  uint16_t heapsize;      /* Size of a heap record */
+  uint16_t poolsize;      /* Size of a memory pool record */
+  uint16_t ncpus;         /* Number of CPUs */
+  uint32_t ntasks;        /* Number of task records */
+  uint32_t nheaps;        /* Number of heap records */
+  uint32_t npools;        /* Number of memory pool records */
+  uint32_t tickhz;        /* Clock ticks per second */
+  uint64_t uptime;        /* System time in clock ticks */
+  int32_t  iob_ntotal;    /* IOBs in total, -1 without IOBs */
+  int32_t  iob_nfree;     /* Free IOBs */
+  int32_t  iob_nwait;     /* Threads waiting for an IOB */
+  int32_t  iob_nthrottle; /* Free IOBs beyond the throttle */
+};
+
+struct procfs_snapshot_task_s
+{
+  int32_t  pid;           /* Thread ID */
+  int32_t  group;         /* ID of the main thread of the group */
+  uint8_t  state;         /* enum tstate_e */
+  uint8_t  priority;      /* Current priority */
+  uint8_t  base_priority; /* Priority without boosting */
+  uint8_t  cpu;           /* CPU the thread runs or last ran on */
+  uint32_t flags;         /* TCB_FLAG_* */
+  uint32_t stacksize;     /* Size of the stack */
+  uint32_t stackused;     /* Deepest stack use, 0 if unknown */
+  uint64_t load_active;   /* Ticks the thread ran in the load interval */
+  uint64_t load_total;    /* Length of the load interval in ticks */
+  char     name[PROCFS_SNAPSHOT_NAMELEN];
+};
+
+struct procfs_snapshot_heap_s
+{
+  uint64_t arena;         /* Size of the heap */
+  uint64_t uordblks;      /* Bytes in use */
+  uint64_t fordblks;      /* Bytes free */
+  uint64_t usmblks;       /* Largest use ever */
+  uint64_t mxordblk;      /* Largest free chunk */
+  uint32_t aordblks;      /* Chunks in use */
+  uint32_t ordblks;       /* Free chunks */
+  char     name[PROCFS_SNAPSHOT_NAMELEN];
+};
+
+struct procfs_snapshot_pool_s
+{
+  uint64_t arena;         /* Size of the pool */
+  uint32_t sizeblks;      /* Size of a block */
+  uint32_t aordblks;      /* Blocks in use */
+  uint32_t ordblks;       /* Free blocks */
+  uint32_t iordblks;      /* Free blocks reserved for interrupts */
+  uint32_t nwaiter;       /* Threads waiting for a block */
+  uint32_t reserved;
+  char     name[PROCFS_SNAPSHOT_NAMELEN];
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -293,6 +379,29 @@ void procfs_register_meminfo(FAR struct procfs_meminfo_entry_s *entry);
 
 void procfs_unregister_meminfo(FAR struct procfs_meminfo_entry_s *entry);
 
+/****************************************************************************
+ * Name: procfs_meminfo_foreach
+ *
+ * Description:
+ *   Call 'handler' with the name and the statistics of every heap that is
+ *   registered with procfs_register_meminfo().
+ *
+ * Input Parameters:
+ *   handler - The function to call for each heap
+ *   arg     - Passed to 'handler' untouched
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PROCFS_INCLUDE_SNAPSHOT
+struct mallinfo;
+typedef CODE void (*procfs_meminfo_handler_t)(FAR const char *name,
+                                              FAR struct mallinfo *info,
+                                              FAR void *arg);
+
+void procfs_meminfo_foreach(procfs_meminfo_handler_t handler,
+                            FAR void *arg);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,104 @@
+/****************************************************************************
+ * include/nuttx/futex.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FUTEX_H
+#define __INCLUDE_NUTTX_FUTEX_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef CONFIG_FUTEX
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: nxfutex_wait
+ *
+ * Description:
+ *   Atomically check that the word at 'addr' still holds 'val' and, if so,
+ *   block until another thread calls nxfutex_wake() on the same address,
+ *   until the absolute time 'abstime' (measured against 'clockid') expires
+ *   or until a signal is received.  The check and the enqueue are done
+ *   under the same lock as the wake-up, so a wake-up issued after the
+ *   word has been changed can never be lost.
+ *
+ *   Futexes are private to the task group: within one address environment
+ *   the key is the virtual address of the word.
+ *
+ * Input Parameters:
+ *   addr    - The address of the futex word.
+ *   val     - The value the caller expects the futex word to hold.
+ *   clockid - The clock that 'abstime' is measured against.
+ *   abstime - The absolute timeout, or NULL to wait forever.
+ *
+ * Returned Value:
+ *   Zero (OK) when woken by nxfutex_wake(); otherwise a negated errno
+ *   value:  -EAGAIN if the word did not hold 'val', -ETIMEDOUT if the
+ *   timeout expired, -EINTR if interrupted by a signal or -EINVAL if an
+ *   argument is invalid.
+ *
+ ****************************************************************************/
+
+int nxfutex_wait(FAR volatile uint32_t *addr, uint32_t val,
+                 clockid_t clockid, FAR const struct timespec *abstime);
+
+/****************************************************************************
+ * Name: nxfutex_wake
+ *
+ * Description:
+ *   Wake up to 'count' threads blocked in nxfutex_wait() on 'addr'.  The
+ *   waiters are woken in the order in which they started waiting.
+ *
+ * Input Parameters:
+ *   addr  - The address of the futex word.
+ *   count - The maximum number of waiters to wake up.
+ *
+ * Returned Value:
+ *   The number of waiters woken up, or -EINVAL if an argument is invalid.
+ *
+ ****************************************************************************/
+
+int nxfutex_wake(FAR volatile uint32_t *addr, int count);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_FUTEX */
+#endif /* __INCLUDE_NUTTX_FUTEX_H */
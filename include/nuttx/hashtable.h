@@ -64,6 +64,9 @@
 #define hashtable_delete(table, item, key) \
   dq_rem(item, &table[HASH(key, hashtable_bits(table))])
 
+#define hashtable_bucket(table, key) \
+  (&table[HASH(key, hashtable_bits(table))])
+
 /* Iterate over whole hashtable. */
 
 #define hashtable_for_every(table, item, i)         \
@@ -32,7 +32,9 @@
 #include <nuttx/compiler.h>
 #include <nuttx/spinlock.h>
 
+#include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include <sys/tree.h>
 
 /****************************************************************************
@@ -87,6 +89,10 @@ struct hrtimer_s
   hrtimer_node_t node;   /* RB-tree node for sorted insertion */
   hrtimer_entry_t func;  /* Expiration callback function */
   uint64_t expired;      /* Absolute expiration time (ns) */
+#ifdef CONFIG_HRTIMER_PERCPU
+  uint8_t cpu;           /* CPU whose timer tree holds this timer */
+  bool pinned;           /* Always expire on "cpu" */
+#endif
 };
 
 /****************************************************************************
@@ -119,7 +125,7 @@ extern "C"
  ****************************************************************************/
 
 static inline_function
-void hrtimer_init(FAR hrtimer_t *hrtimer, hrtimer_cb func)
+void hrtimer_init(FAR hrtimer_t *hrtimer, hrtimer_entry_t func)
 {
   memset(hrtimer, 0, sizeof(hrtimer_t));
   hrtimer->func = func;
@@ -195,6 +201,47 @@ int hrtimer_start(FAR hrtimer_t *hrtimer,
                   uint64_t expired,
                   enum hrtimer_mode_e mode);
 
+#ifdef CONFIG_HRTIMER_PERCPU
+/****************************************************************************
+ * Name: hrtimer_migrate
+ *
+ * Description:
+ *   Move an armed timer to the timer tree of another CPU, so that it
+ *   expires there.  The expiration time is preserved.  An unarmed timer
+ *   is only retargeted: it will be queued on "cpu" when a periodic
+ *   callback re-arms it.  A later hrtimer_start() queues an unpinned timer
+ *   on the calling CPU again.
+ *
+ * Input Parameters:
+ *   hrtimer - Timer instance to migrate
+ *   cpu     - Destination CPU
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure:
+ *   -EINVAL - "cpu" is not a valid CPU index
+ *   -EPERM  - The timer is pinned to a different CPU
+ ****************************************************************************/
+
+int hrtimer_migrate(FAR hrtimer_t *hrtimer, int cpu);
+
+/****************************************************************************
+ * Name: hrtimer_pin
+ *
+ * Description:
+ *   Pin a timer to a CPU: it is migrated there now and every later
+ *   hrtimer_start() queues it on that CPU regardless of the caller.
+ *
+ * Input Parameters:
+ *   hrtimer - Timer instance to pin
+ *   cpu     - CPU to pin to, or a negative value to unpin the timer
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ ****************************************************************************/
+
+int hrtimer_pin(FAR hrtimer_t *hrtimer, int cpu);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -33,6 +33,7 @@
 #include <stdint.h>
 
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/queue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -213,6 +214,7 @@
 
 struct i2c_master_s;
 struct i2c_msg_s;
+struct i2c_request_s;
 struct i2c_ops_s
 {
   CODE int (*transfer)(FAR struct i2c_master_s *dev,
@@ -222,6 +224,15 @@ struct i2c_ops_s
 #endif
   CODE int (*setup)(FAR struct i2c_master_s *dev);
   CODE int (*shutdown)(FAR struct i2c_master_s *dev);
+
+#ifdef CONFIG_I2C_ASYNC
+  /* Optional: queue a request, set its result and call its callback when
+   * done.  Without it, i2c_async() runs the requests on a work queue.
+   */
+
+  CODE int (*transfer_async)(FAR struct i2c_master_s *dev,
+                             FAR struct i2c_request_s *req);
+#endif
 };
 
 /* This structure contains the full state of I2C as needed for a specific
@@ -270,6 +281,24 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+#ifdef CONFIG_I2C_ASYNC
+/* A sequence of messages queued by i2c_async().  The request and its
+ * messages belong to the bus until the completion callback is called.
+ * The callback may run in an interrupt handler with a native lower half,
+ * or on the work queue otherwise; it may queue more requests.
+ */
+
+struct i2c_request_s
+{
+  sq_entry_t node;              /* Used by the queue of the bus */
+  FAR struct i2c_msg_s *msgs;   /* The messages to transfer */
+  int count;                    /* The number of messages */
+  CODE void (*complete)(FAR struct i2c_request_s *req);
+  FAR void *arg;                /* For use by the callback */
+  int result;                   /* Zero or a negated errno value */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -383,6 +412,46 @@ int i2c_read(FAR struct i2c_master_s *dev,
              FAR const struct i2c_config_s *config,
              FAR uint8_t *buffer, int buflen);
 
+#ifdef CONFIG_I2C_ASYNC
+/****************************************************************************
+ * Name: i2c_async_initialize
+ *
+ * Description:
+ *   Create the request queue of an I2C bus whose lower half has no
+ *   transfer_async method.  This must be called from a thread before the
+ *   first i2c_async() on the bus; more calls for the same bus do nothing.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *
+ * Returned Value:
+ *   0: success, <0: A negated errno
+ *
+ ****************************************************************************/
+
+int i2c_async_initialize(FAR struct i2c_master_s *dev);
+
+/****************************************************************************
+ * Name: i2c_async
+ *
+ * Description:
+ *   Queue a sequence of I2C messages and return without waiting.  The
+ *   requests of a bus are transferred in order and back to back.  When a
+ *   request is done, its result is set and its callback is called.  This
+ *   may be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - The request to queue
+ *
+ * Returned Value:
+ *   0: queued, <0: A negated errno (-ENODEV if the bus has no queue)
+ *
+ ****************************************************************************/
+
+int i2c_async(FAR struct i2c_master_s *dev, FAR struct i2c_request_s *req);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
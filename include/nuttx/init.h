@@ -48,6 +48,14 @@
 #define OSINIT_IS_PANIC()        (g_nx_initstate >= OSINIT_PANIC)
 #define OSINIT_OS_INITIALIZING() (g_nx_initstate  < OSINIT_OSREADY)
 
+/* Record a named time stamp in the boot time profile */
+
+#ifdef CONFIG_SCHED_BOOT_PROFILE
+#  define BOOT_PROFILE_MARK(name) nx_bootprofile_mark(name)
+#else
+#  define BOOT_PROFILE_MARK(name)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -105,6 +113,15 @@ EXTERN volatile uint8_t g_nx_initstate;  /* See enum nx_initstate_e */
 
 void nx_start(void);
 
+/* Functions contained in nx_bootprofile.c **********************************/
+
+/* Record a boot time mark and print the collected boot time profile */
+
+#ifdef CONFIG_SCHED_BOOT_PROFILE
+void nx_bootprofile_mark(FAR const char *name);
+void nx_bootprofile_report(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
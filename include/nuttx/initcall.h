@@ -0,0 +1,128 @@
+/****************************************************************************
+ * include/nuttx/initcall.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_INITCALL_H
+#define __INCLUDE_NUTTX_INITCALL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+#include <nuttx/wqueue.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_SCHED_INITCALL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Static initializer for struct initcall_s.  deps is either NULL or a
+ * NULL-terminated array of the initcalls that must complete successfully
+ * before this one may run.  For example:
+ *
+ *   static struct initcall_s g_flash_init =
+ *     INITCALL_INITIALIZER("flash", board_flash_init, NULL, NULL);
+ *   static FAR struct initcall_s * const g_fs_deps[] =
+ *   {
+ *     &g_flash_init, NULL
+ *   };
+ *   static struct initcall_s g_fs_init =
+ *     INITCALL_INITIALIZER("fs", board_fs_init, NULL, g_fs_deps);
+ */
+
+#define INITCALL_INITIALIZER(name, func, arg, deps) \
+  { NULL, (name), (func), (arg), (deps) }
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Initialization function.  Returns zero (OK) on success or a negated
+ * errno value on failure.  Initcalls that depend on a failed one are not
+ * run.
+ */
+
+typedef CODE int (*initcall_t)(FAR void *arg);
+
+/* One deferred initialization call.  The structure must stay valid until
+ * the initcalls have run; normally it is statically allocated.  Only the
+ * first five fields are set by the caller.
+ */
+
+struct initcall_s
+{
+  FAR struct initcall_s *flink;           /* Registered list link */
+  FAR const char *name;                   /* Name used in diagnostics */
+  initcall_t func;                        /* Initialization function */
+  FAR void *arg;                          /* Argument passed to func */
+  FAR struct initcall_s * const *deps;    /* NULL-terminated dependencies */
+
+  /* Owned by the initcall logic */
+
+  struct work_s work;                     /* Work queue entry */
+  uint8_t state;                          /* See nx_initcall.c */
+  int result;                             /* Value returned by func */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: initcall_register
+ *
+ * Description:
+ *   Register an initialization call to be run, concurrently with other
+ *   independent initcalls, just after board_late_initialize().  Calls may
+ *   be registered from board_early_initialize(), board_late_initialize()
+ *   or from driver initialization logic that runs before them.
+ *
+ * Input Parameters:
+ *   call - The initcall to register.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBUSY if the call is already registered or the
+ *   initcalls have already been run.
+ *
+ ****************************************************************************/
+
+int initcall_register(FAR struct initcall_s *call);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SCHED_INITCALL */
+#endif /* __INCLUDE_NUTTX_INITCALL_H */
@@ -248,6 +248,54 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
 int irq_attach_wqueue(int irq, xcpt_t isr, xcpt_t isrwork,
                       FAR void *arg, int priority);
 
+/****************************************************************************
+ * Name: irq_set_coalesce
+ *
+ * Description:
+ *   Batch the bottom half attached with irq_attach_thread() or
+ *   irq_attach_wqueue() to IRQ number 'irq'.  The bottom half then runs
+ *   once 'maxevents' events are pending, or 'maxdelay' microseconds after
+ *   the first event of a batch, whichever comes first, and it must handle
+ *   all of the events pending in the hardware.
+ *
+ * Input Parameters:
+ *   irq       - Irq num
+ *   maxevents - Events per batch, zero or one disables coalescing
+ *   maxdelay  - Maximum delay of the first event of a batch (us), must be
+ *               non-zero when coalescing is enabled
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_COALESCE
+int irq_set_coalesce(int irq, unsigned int maxevents,
+                     unsigned int maxdelay);
+#endif
+
+/****************************************************************************
+ * Name: irq_set_affinity/irq_get_affinity
+ *
+ * Description:
+ *   Set or get the set of CPUs that IRQ number 'irq' may be routed to.  If
+ *   the set holds more than one CPU, the IRQ balancing thread (if enabled)
+ *   picks one of them by load.
+ *
+ * Input Parameters:
+ *   irq    - Irq num
+ *   cpuset - The set of CPUs
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_AFFINITY
+int irq_set_affinity(int irq, FAR const cpu_set_t *cpuset);
+int irq_get_affinity(int irq, FAR cpu_set_t *cpuset);
+#endif
+
 #ifdef CONFIG_IRQCHAIN
 int irqchain_detach(int irq, xcpt_t isr, FAR void *arg);
 #else
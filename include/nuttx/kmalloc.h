@@ -84,6 +84,18 @@ extern "C"
 #define kumm_free(p)             free(p)
 #define kumm_mallinfo()          mallinfo()
 
+/* Allocations that prefer the heap regions tagged with "f".  User memory
+ * can only be tagged in the flat build.
+ */
+
+#if defined(CONFIG_MM_HEAP_REGION_FLAGS) && defined(CONFIG_BUILD_FLAT)
+#  define kumm_malloc_region(s,f)     malloc_region(s,f)
+#  define kumm_memalign_region(a,s,f) memalign_region(a,s,f)
+#else
+#  define kumm_malloc_region(s,f)     kumm_malloc(s)
+#  define kumm_memalign_region(a,s,f) kumm_memalign(a,s)
+#endif
+
 /* This family of allocators is used to manage kernel protected memory */
 
 #ifndef CONFIG_MM_KERNEL_HEAP
@@ -106,11 +118,37 @@ extern "C"
 #  define kmm_heapmember(p)      umm_heapmember(p)
 #  define kmm_memdump(p)         umm_memdump(p)
 
+#  define kmm_malloc_region(s,f)     kumm_malloc_region(s,f)
+#  define kmm_memalign_region(a,s,f) kumm_memalign_region(a,s,f)
+
 #else
 /* Otherwise, the kernel-space allocators are declared in
  * include/nuttx/mm/mm.h and we can call them directly.
  */
 
+#  ifndef CONFIG_MM_HEAP_REGION_FLAGS
+#    define kmm_malloc_region(s,f)     kmm_malloc(s)
+#    define kmm_memalign_region(a,s,f) kmm_memalign(a,s)
+#  endif
+#endif
+
+#define kmm_malloc_fast(s)       kmm_malloc_region(s, MM_REGION_FAST)
+#define kmm_memalign_fast(a,s)   kmm_memalign_region(a, s, MM_REGION_FAST)
+#define kumm_malloc_fast(s)      kumm_malloc_region(s, MM_REGION_FAST)
+#define kumm_memalign_fast(a,s)  kumm_memalign_region(a, s, MM_REGION_FAST)
+
+/* The allocators of the thread stacks */
+
+#ifdef CONFIG_MM_HEAP_REGION_FAST_STACK
+#  define kmm_malloc_stack(s)      kmm_malloc_fast(s)
+#  define kmm_memalign_stack(a,s)  kmm_memalign_fast(a,s)
+#  define kumm_malloc_stack(s)     kumm_malloc_fast(s)
+#  define kumm_memalign_stack(a,s) kumm_memalign_fast(a,s)
+#else
+#  define kmm_malloc_stack(s)      kmm_malloc(s)
+#  define kmm_memalign_stack(a,s)  kmm_memalign(a,s)
+#  define kumm_malloc_stack(s)     kumm_malloc(s)
+#  define kumm_memalign_stack(a,s) kumm_memalign(a,s)
 #endif
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -240,6 +240,9 @@ struct mod_loadinfo_s
                               * romfs/tmps, we can try get xipbase,
                               * skip the copy.
                               */
+#ifdef CONFIG_LIBC_ELF_MAPPED_READ
+  uintptr_t     filebase;    /* Mapping of the whole file, or 0 */
+#endif
 
   /* Address environment.
    *
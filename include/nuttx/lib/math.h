@@ -30,6 +30,10 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#ifdef CONFIG_LIBM_FAST_FLOAT
+#  include <stddef.h>
+#endif
+
 /* If CONFIG_ARCH_MATH_H is defined, then the top-level Makefile will copy
  * this header file to include/math.h where it will become the system math.h
  * header file.  In this case, the architecture specific code must provide
@@ -607,6 +611,20 @@ double      scalbn(double x, int n);
 long double scalbnl(long double x, int n);
 #endif
 
+/* Array Functions **********************************************************/
+
+#ifdef CONFIG_LIBM_FAST_FLOAT
+/* y[i] = f(x[i]) for the n elements, in place if y is x */
+
+void        sinf_vec  (FAR const float *x, FAR float *y, size_t n);
+void        cosf_vec  (FAR const float *x, FAR float *y, size_t n);
+void        expf_vec  (FAR const float *x, FAR float *y, size_t n);
+void        logf_vec  (FAR const float *x, FAR float *y, size_t n);
+void        sqrtf_vec (FAR const float *x, FAR float *y, size_t n);
+void        atan2f_vec(FAR const float *y, FAR const float *x,
+                       FAR float *z, size_t n);
+#endif
+
 #define FP_INFINITE     0
 #define FP_NAN          1
 #define FP_NORMAL       2
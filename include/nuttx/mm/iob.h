@@ -58,6 +58,12 @@
 #  define CONFIG_IOB_THROTTLE 0
 #endif
 
+/* The number of free I/O buffers cached by each CPU, zero to disable */
+
+#if !defined(CONFIG_IOB_CACHE)
+#  define CONFIG_IOB_CACHE 0
+#endif
+
 /* Some I/O buffers should be allocated */
 
 #if !defined(CONFIG_IOB_NBUFFERS)
@@ -95,6 +101,15 @@
 #  define IOB_BUFSIZE(p) CONFIG_IOB_BUFSIZE
 #endif
 
+/* Checksum state of a packet, io_csum of its head I/O buffer */
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+#  define IOB_CSUM_NONE        0 /* Computed and verified in software */
+#  define IOB_CSUM_UNNECESSARY 1 /* RX: verified by the hardware */
+#  define IOB_CSUM_PARTIAL     2 /* TX: pseudo-header in place, the device
+                                  * sums the rest */
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -123,6 +138,13 @@ struct iob_s
 #  ifdef CONFIG_IOB_ALLOC
   uint16_t io_bufsize;  /* Total length of the data buffer */
 #  endif
+#endif
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  uint8_t  io_csum;     /* IOB_CSUM_*, only valid in the head of a chain */
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+  uint64_t io_tstamp;   /* RX hardware timestamp in ns, 0 if none */
+  uint32_t io_tsid;     /* TX timestamp request id, 0 if none */
 #endif
   unsigned int io_pktlen; /* Total length of the packet */
 
@@ -161,12 +183,27 @@ struct iob_queue_s
 };
 #endif /* CONFIG_IOB_NCHAINS > 0 */
 
+/* One segment of an I/O buffer chain, as handed to a DMA engine by
+ * iob_to_sg().
+ */
+
+struct iob_sg_s
+{
+  FAR uint8_t *base;            /* Virtual address of the segment */
+  uintptr_t    addr;            /* Physical (bus) address of the segment */
+  unsigned int len;             /* Length of the segment in bytes */
+};
+
 struct iob_stats_s
 {
   int ntotal;
   int nfree;
   int nwait;
   int nthrottle;
+#if CONFIG_IOB_CACHE > 0
+  int ncached[CONFIG_SMP_NCPUS];         /* Free buffers cached per CPU */
+  unsigned long nhits[CONFIG_SMP_NCPUS]; /* Allocations served by them */
+#endif
 };
 
 /****************************************************************************
@@ -220,6 +257,18 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_n
+ *
+ * Description:
+ *   Try to allocate "n" I/O buffers at once, without waiting, and return
+ *   them linked as one chain.  Either all of the buffers are allocated or
+ *   none is.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_n(bool throttled, unsigned int n);
+
 #ifdef CONFIG_IOB_ALLOC
 /****************************************************************************
  * Name: iob_alloc_dynamic
@@ -379,6 +428,17 @@ void iob_notifier_teardown(int key);
 
 void iob_free_chain(FAR struct iob_s *iob);
 
+/****************************************************************************
+ * Name: iob_free_chain_batch
+ *
+ * Description:
+ *   Free an entire buffer chain like iob_free_chain(), but return all of
+ *   its buffers to the free list at once.
+ *
+ ****************************************************************************/
+
+void iob_free_chain_batch(FAR struct iob_s *iob);
+
 /****************************************************************************
  * Name: iob_add_queue
  *
@@ -687,6 +747,44 @@ int iob_update_pktlen(FAR struct iob_s *iob, unsigned int pktlen,
 
 int iob_count(FAR struct iob_s *iob);
 
+/****************************************************************************
+ * Name: iob_to_sg
+ *
+ * Description:
+ *   Describe the data of an I/O buffer chain as a list of segments, so that
+ *   a DMA capable driver can transfer the chain in place instead of copying
+ *   it into a contiguous buffer first.  Empty buffers are skipped.
+ *
+ * Input Parameters:
+ *   iob      - The head of the I/O buffer chain
+ *   headroom - Bytes in front of the data of the first buffer to include
+ *              in the first segment (e.g. a link layer header)
+ *   sg       - The segment array to fill
+ *   nsg      - The number of entries in the segment array
+ *
+ * Returned Value:
+ *   The number of segments filled in on success; -E2BIG if the chain does
+ *   not fit into "nsg" segments.
+ *
+ ****************************************************************************/
+
+int iob_to_sg(FAR struct iob_s *iob, unsigned int headroom,
+              FAR struct iob_sg_s *sg, int nsg);
+
+/****************************************************************************
+ * Name: iob_sg_sync
+ *
+ * Description:
+ *   Perform the data cache maintenance for a segment list returned by
+ *   iob_to_sg().  Before the device reads the segments (todevice true) the
+ *   data cache is cleaned; after the device has written them (todevice
+ *   false) the data cache is invalidated.  This is a no-op without a data
+ *   cache.
+ *
+ ****************************************************************************/
+
+void iob_sg_sync(FAR const struct iob_sg_s *sg, int nsg, bool todevice);
+
 /****************************************************************************
  * Name: iob_dump
  *
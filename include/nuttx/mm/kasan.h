@@ -49,6 +49,7 @@
 #  define kasan_debugpoint(t,a,s) 0
 #  define kasan_init_early()
 #  define kasan_bypass(state) ((void)state, state)
+#  define kasan_region_enable(addr, enable) 0
 #else
 
 #  define kasan_init_early() kasan_stop()
@@ -237,6 +238,27 @@ int kasan_debugpoint(int type, FAR void *addr, size_t size);
 
 bool kasan_bypass(bool state);
 
+/****************************************************************************
+ * Name: kasan_region_enable
+ *
+ * Description:
+ *   Enable or disable the access check for the region registered with
+ *   kasan_register() that contains the given address.  Poisoning is still
+ *   tracked while the check is disabled, so the region can be re-enabled
+ *   at any time without reporting stale errors.  Use this to take trusted
+ *   or timing critical memory out of the check at run time.
+ *
+ * Input Parameters:
+ *   addr   - Any address inside the region
+ *   enable - true to check accesses to the region, false to skip them
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if no region contains the address.
+ *
+ ****************************************************************************/
+
+int kasan_region_enable(FAR const void *addr, bool enable);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -49,6 +49,10 @@
 #  define MEMPOOL_REALBLOCKSIZE(pool) ((pool)->blocksize)
 #endif
 
+#if defined(CONFIG_MM_MEMPOOL_MAGAZINE) && CONFIG_MM_MEMPOOL_MAGAZINE > 0
+#  define MEMPOOL_HAVE_MAGAZINE
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -87,6 +91,16 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+/* This structure describes the free blocks a CPU keeps from a pool */
+
+#ifdef MEMPOOL_HAVE_MAGAZINE
+struct mempool_magazine_s
+{
+  sq_queue_t queue; /* The free blocks kept by the CPU */
+  size_t     count; /* The number of blocks in queue */
+};
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -110,6 +124,9 @@ struct mempool_s
   size_t     nalloc;  /* The number of used block in mempool */
   spinlock_t lock;    /* The protect lock to mempool */
   sem_t      waitsem; /* The semaphore of waiter get free block */
+#ifdef MEMPOOL_HAVE_MAGAZINE
+  struct mempool_magazine_s magazine[CONFIG_SMP_NCPUS];
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   struct mempool_procfs_entry_s procfs; /* The entry of procfs */
 #endif
@@ -305,6 +322,28 @@ void mempool_procfs_register(FAR struct mempool_procfs_entry_s *entry,
 void mempool_procfs_unregister(FAR struct mempool_procfs_entry_s *entry);
 #endif
 
+/****************************************************************************
+ * Name: mempool_procfs_foreach
+ *
+ * Description:
+ *   Call 'handler' with the name and the statistics of every mempool that
+ *   is registered with procfs.
+ *
+ * Input Parameters:
+ *   handler - The function to call for each mempool
+ *   arg     - Passed to 'handler' untouched
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
+typedef CODE void (*mempool_procfs_handler_t)(FAR const char *name,
+                                  FAR const struct mempoolinfo_s *info,
+                                  FAR void *arg);
+
+void mempool_procfs_foreach(mempool_procfs_handler_t handler,
+                            FAR void *arg);
+#endif
+
 /****************************************************************************
  * Name: mempool_multiple_init
  *
@@ -474,6 +513,23 @@ FAR void *mempool_multiple_memalign(FAR struct mempool_multiple_s *mpool,
 void mempool_multiple_memdump(FAR struct mempool_multiple_s *mpool,
                               FAR const struct mm_memdump_s *dump);
 
+/****************************************************************************
+ * Name: mempool_multiple_profile
+ *
+ * Description:
+ *   Print the histogram of the sizes requested from the multiple memory
+ *   pool, the hit rate and waste of its block sizes, and the block sizes
+ *   that would waste the least memory for the same requests.
+ *
+ * Input Parameters:
+ *   mpool - The handle of multiple memory pool to be used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_PROFILE
+void mempool_multiple_profile(FAR struct mempool_multiple_s *mpool);
+#endif
+
 /****************************************************************************
  * Name: mempool_multiple_deinit
  *
@@ -0,0 +1,94 @@
+//***************************************************************************
+// include/nuttx/mm/mempool_resource.hxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+#ifndef __INCLUDE_NUTTX_MM_MEMPOOL_RESOURCE_HXX
+#define __INCLUDE_NUTTX_MM_MEMPOOL_RESOURCE_HXX
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <memory_resource>
+
+#include <nuttx/mm/mempool.h>
+
+#ifdef CONFIG_LIBXX_MEMPOOL
+
+//***************************************************************************
+// Public Types
+//***************************************************************************
+
+namespace nuttx
+{
+  // A memory resource serving the small blocks from a multiple mempool.
+  // The pools only take their own spinlock, or nothing with the per-CPU
+  // magazines, and never the lock of the heap.  Blocks larger than
+  // CONFIG_LIBXX_MEMPOOL_THRESHOLD or more aligned than the default of
+  // new come from the upstream resource.
+  //
+  // One instance is shared by the global new and delete with
+  // CONFIG_LIBXX_MEMPOOL_NEW.  A thread, or a subsystem, can also own an
+  // instance as its private arena, for its std::pmr containers:
+  //
+  //   nuttx::mempool_resource arena("worker");
+  //   std::pmr::map<int, int> map(&arena);
+
+  class mempool_resource : public std::pmr::memory_resource
+  {
+  public:
+    explicit mempool_resource(FAR const char *name = "libxx",
+                              FAR std::pmr::memory_resource *upstream =
+                                std::pmr::new_delete_resource());
+    ~mempool_resource();
+
+    mempool_resource(const mempool_resource &) = delete;
+    mempool_resource &operator=(const mempool_resource &) = delete;
+
+    // The upstream resource of the blocks out of the pools
+
+    FAR std::pmr::memory_resource *upstream_resource() const
+    {
+      return m_upstream;
+    }
+
+  protected:
+    FAR void *do_allocate(std::size_t bytes,
+                          std::size_t alignment) override;
+    void do_deallocate(FAR void *p, std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other)
+      const noexcept override
+    {
+      return this == &other;
+    }
+
+  private:
+    FAR struct mempool_multiple_s *m_pool;
+    FAR std::pmr::memory_resource *m_upstream;
+  };
+}
+
+#endif // CONFIG_LIBXX_MEMPOOL
+#endif // __INCLUDE_NUTTX_MM_MEMPOOL_RESOURCE_HXX
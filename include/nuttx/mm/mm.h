@@ -28,6 +28,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/queue.h>
 #include <nuttx/userspace.h>
 
 #include <sys/types.h>
@@ -166,6 +167,10 @@
 #  define MM_ALIGN       CONFIG_MM_DEFAULT_ALIGNMENT
 #endif
 
+/* Tags of the heap regions, see mm_region_setflags() */
+
+#define MM_REGION_FAST   MALLOC_REGION_FAST
+
 #define MM_INIT_MAGIC    0xcc
 #define MM_ALLOC_MAGIC   0xaa
 #define MM_FREE_MAGIC    0x55
@@ -182,6 +187,51 @@
 
 struct mm_heap_s; /* Forward reference */
 
+#ifdef CONFIG_MM_HEAP_SAMPLE
+/* The allocations sampled at one call site, see mm_sample_site() */
+
+struct mm_sample_site_s
+{
+  FAR void *backtrace[CONFIG_MM_HEAP_SAMPLE_DEPTH]; /* NULL terminated */
+  size_t    inuse_count;                            /* Live samples */
+  size_t    inuse_bytes;                            /* Their bytes */
+  size_t    alloc_count;                            /* Samples since boot */
+  size_t    alloc_bytes;                            /* Their bytes */
+};
+#endif
+
+#ifdef CONFIG_MM_BENCH
+/* The result of one benchmark run, see mm_bench_run() */
+
+struct mm_bench_result_s
+{
+  char     name[32];       /* Pattern, allocator and sizes */
+  size_t   nops;           /* Operations done */
+  size_t   nfail;          /* Failed allocations */
+  uint32_t opsps;          /* Operations per second in the allocator */
+  uint32_t p50;            /* Median latency in nanoseconds */
+  uint32_t p99;            /* 99th percentile latency in nanoseconds */
+  uint32_t max;            /* Worst latency in nanoseconds */
+  uint16_t frag;           /* Peak fragmentation in 1/1000 */
+  uint8_t  nthreads;       /* Number of threads */
+};
+#endif
+
+#ifdef CONFIG_MM_SHRINKER
+/* A subsystem that can give memory back to the heaps, see
+ * mm_register_shrinker().  "shrink" frees up to about "size" bytes and
+ * returns the number of bytes it freed.  It is called from the context
+ * of the failing allocation with no heap lock held; it may free memory
+ * but must not allocate any.
+ */
+
+struct mm_shrinker_s
+{
+  sq_entry_t node;         /* Entry in the list of shrinkers */
+  CODE size_t (*shrink)(FAR struct mm_shrinker_s *shrinker, size_t size);
+};
+#endif
+
 struct mempool_init_s
 {
   FAR const size_t *poolsize;
@@ -288,9 +338,22 @@ void umm_addregion(FAR void *heapstart, size_t heapsize);
 void kmm_addregion(FAR void *heapstart, size_t heapsize);
 #endif
 
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+int  mm_region_setflags(FAR struct mm_heap_s *heap, FAR void *mem,
+                        unsigned int flags);
+int  umm_region_setflags(FAR void *mem, unsigned int flags);
+#  ifdef CONFIG_MM_KERNEL_HEAP
+int  kmm_region_setflags(FAR void *mem, unsigned int flags);
+#  endif
+#endif
+
 /* Functions contained in mm_malloc.c ***************************************/
 
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size) malloc_like1(2);
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+FAR void *mm_malloc_region(FAR struct mm_heap_s *heap, size_t size,
+                           unsigned int flags) malloc_like1(2);
+#endif
 
 void mm_free_delaylist(FAR struct mm_heap_s *heap);
 
@@ -298,6 +361,10 @@ void mm_free_delaylist(FAR struct mm_heap_s *heap);
 
 #ifdef CONFIG_MM_KERNEL_HEAP
 FAR void *kmm_malloc(size_t size) malloc_like1(1);
+#  ifdef CONFIG_MM_HEAP_REGION_FLAGS
+FAR void *kmm_malloc_region(size_t size, unsigned int flags)
+  malloc_like1(1);
+#  endif
 #endif
 
 /* Functions contained in mm_malloc_size.c **********************************/
@@ -362,11 +429,20 @@ void kmm_memdump(FAR const struct mm_memdump_s *dump);
 
 FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
                       size_t size) malloc_like1(3);
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+FAR void *mm_memalign_region(FAR struct mm_heap_s *heap, size_t alignment,
+                             size_t size, unsigned int flags)
+  malloc_like1(3);
+#endif
 
 /* Functions contained in kmm_memalign.c ************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
 FAR void *kmm_memalign(size_t alignment, size_t size) malloc_like1(2);
+#  ifdef CONFIG_MM_HEAP_REGION_FLAGS
+FAR void *kmm_memalign_region(size_t alignment, size_t size,
+                              unsigned int flags) malloc_like1(2);
+#  endif
 #endif
 
 /* Functions contained in mm_heapmember.c ***********************************/
@@ -417,6 +493,10 @@ void kmm_extend(FAR void *mem, size_t size, int region);
 struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap);
 struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
                                       FAR const struct malltask *task);
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+int mm_mallinfo_region(FAR struct mm_heap_s *heap, int region,
+                       FAR struct mallinfo *info, FAR unsigned int *flags);
+#endif
 
 size_t mm_heapfree(FAR struct mm_heap_s *heap);
 size_t mm_heapfree_largest(FAR struct mm_heap_s *heap);
@@ -435,6 +515,42 @@ struct mallinfo_task kmm_mallinfo_task(FAR const struct malltask *task);
 void mm_memdump(FAR struct mm_heap_s *heap,
                 FAR const struct mm_memdump_s *dump);
 
+/* Functions contained in mm_foreach.c **************************************/
+
+/* Visit the unused payload of every free chunk in the heap, without taking
+ * the heap lock.  This is intended for crash handling, when nothing else
+ * can run; the heap metadata inside the chunks is not part of the ranges
+ * reported.
+ */
+
+void mm_foreach_free(FAR struct mm_heap_s *heap,
+                     CODE void (*handler)(FAR void *start, size_t size,
+                                          FAR void *arg),
+                     FAR void *arg);
+
+/* Functions contained in mm_sample.c ***************************************/
+
+#ifdef CONFIG_MM_HEAP_SAMPLE
+int mm_sample_site(int index, FAR struct mm_sample_site_s *site);
+#endif
+
+/* Functions contained in mm_bench.c ****************************************/
+
+#ifdef CONFIG_MM_BENCH
+int mm_bench_run(FAR const char *cmd);
+int mm_bench_result(int index, FAR struct mm_bench_result_s *result);
+#endif
+
+/* Functions contained in mm_shrink.c ***************************************/
+
+#ifdef CONFIG_MM_SHRINKER
+int mm_register_shrinker(FAR struct mm_shrinker_s *shrinker);
+int mm_unregister_shrinker(FAR struct mm_shrinker_s *shrinker);
+size_t mm_shrink(size_t size);
+#else
+#  define mm_shrink(size) 0
+#endif
+
 /* Functions contained in umm_memdump.c *************************************/
 
 void umm_memdump(FAR const struct mm_memdump_s *dump);
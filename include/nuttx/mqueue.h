@@ -32,6 +32,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/signal.h>
 #include <nuttx/list.h>
+#include <nuttx/spinlock_type.h>
 
 #include <sys/types.h>
 #include <stdint.h>
@@ -106,6 +107,9 @@ struct mqueue_cmn_s
   dq_queue_t waitfornotfull;  /* Task list waiting for not full */
   int16_t nwaitnotfull;       /* Number tasks waiting for not full */
   int16_t nwaitnotempty;      /* Number tasks waiting for not empty */
+#ifdef CONFIG_MQ_HANDOFF
+  dq_queue_t rcvwait;         /* Buffers of the receivers waiting */
+#endif
 };
 
 /* This structure defines a message queue */
@@ -122,6 +126,10 @@ struct mqueue_inode_s
 #else
   uint16_t maxmsgsize;        /* Max size of message in message queue */
 #endif
+#ifdef CONFIG_MQ_SLAB
+  spinlock_t slablock;        /* Protects slabfree */
+  struct list_node slabfree;  /* Free messages of the per-queue slab */
+#endif
 #ifndef CONFIG_DISABLE_MQUEUE_NOTIFICATION
   pid_t ntpid;                /* Notification: Receiving Task's PID */
   struct sigevent ntevent;    /* Notification description */
@@ -34,6 +34,7 @@
 #include <stdbool.h>
 
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/queue.h>
 
 #ifdef CONFIG_EEPROM
 #include <nuttx/eeprom/eeprom.h>
@@ -88,6 +89,11 @@
 #define MTDIOC_ISBAD        _MTDIOC(0x000e) /* IN: Erase block number
                                              * OUT: 0=A good block
                                              *      1=A bad block */
+#define MTDIOC_SUBMIT       _MTDIOC(0x000f) /* IN: Pointer to mtd_request_s
+                                             * OUT: None, the request completes
+                                             *      later through its callback.
+                                             *      -ENOTTY if the device does not
+                                             *      queue requests */
 
 /* Macros to hide implementation */
 
@@ -169,6 +175,28 @@ struct mtd_bad_block_s
   int bad_flag;
 };
 
+/* An asynchronous request, see MTDIOC_SUBMIT.  The request belongs to the
+ * device from the submit until 'done' is called, from the context of the
+ * device worker.  'done' may submit again but must not call the device
+ * synchronously.
+ */
+
+#define MTD_REQ_ERASE   0   /* Erase 'count' blocks at 'block' */
+#define MTD_REQ_BREAD   1   /* Read 'count' blocks at 'block' to 'buffer' */
+#define MTD_REQ_BWRITE  2   /* Write 'count' blocks at 'block' from 'buffer' */
+
+struct mtd_request_s
+{
+  sq_entry_t      node;     /* Used by the device while queued */
+  uint8_t         op;       /* One of MTD_REQ_* */
+  off_t           block;    /* First block */
+  size_t          count;    /* Number of blocks */
+  FAR void       *buffer;   /* Data of a read or a write */
+  ssize_t         result;   /* Result of the matching MTD method */
+  CODE void     (*done)(FAR struct mtd_request_s *req);
+  FAR void       *arg;      /* Owner's argument for 'done' */
+};
+
 /* This structure defines the interface to a simple memory technology device.
  * It will likely need to be extended in the future to support more complex
  * devices.
@@ -290,6 +318,22 @@ FAR struct mtd_dev_s *mtd_partition(FAR struct mtd_dev_s *mtd,
 int mtd_setpartitionname(FAR struct mtd_dev_s *mtd, FAR const char *name);
 #endif
 
+/****************************************************************************
+ * Name: mtd_async_initialize
+ *
+ * Description:
+ *   Create an MTD device that contains another one and also takes
+ *   requests through MTDIOC_SUBMIT.  The requests are run in order on the
+ *   low priority work queue; a synchronous call first waits for the queued
+ *   ones, so an erase can be posted and the next write to the block simply
+ *   follows it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_ASYNC
+FAR struct mtd_dev_s *mtd_async_initialize(FAR struct mtd_dev_s *mtd);
+#endif
+
 /****************************************************************************
  * Name: mtd_rwb_initialize
  *
@@ -308,6 +352,21 @@ int mtd_setpartitionname(FAR struct mtd_dev_s *mtd, FAR const char *name);
 FAR struct mtd_dev_s *mtd_rwb_initialize(FAR struct mtd_dev_s *mtd);
 #endif
 
+/****************************************************************************
+ * Name: mtd_rwb_initialize_slots
+ *
+ * Description:
+ *   As mtd_rwb_initialize(), but with 'nslots' partly written buffers
+ *   kept aside for writes that alternate between regions, instead of
+ *   CONFIG_MTD_NWRSLOTS.  The least recently used one is flushed first.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_MTD_WRBUFFER) || defined(CONFIG_MTD_READAHEAD)
+FAR struct mtd_dev_s *mtd_rwb_initialize_slots(FAR struct mtd_dev_s *mtd,
+                                               uint8_t nslots);
+#endif
+
 /****************************************************************************
  * Name: ftl_initialize_by_path
  *
@@ -159,6 +159,22 @@
 #define SIOCGIFVLAN        _SIOC(0x0043)  /* Get VLAN interface */
 #define SIOCSIFVLAN        _SIOC(0x0044)  /* Set VLAN interface */
 
+/* RPMSG socket zero-copy calls *********************************************/
+
+#define SIOCRPMSGGETTXBUF  _SIOC(0x0045)  /* Reserve a tx buffer,
+                                           * arg: FAR struct iovec * */
+#define SIOCRPMSGRELTXBUF  _SIOC(0x0046)  /* Drop the reserved tx buffer */
+#define SIOCRPMSGRELRXBUF  _SIOC(0x0047)  /* Give back a received buffer,
+                                           * arg: its data pointer */
+
+/* Hardware timestamping ****************************************************/
+
+#define SIOCSHWTSTAMP      _SIOC(0x0048)  /* Set hardware timestamping config,
+                                           * arg: ifr_data points to
+                                           * struct hwtstamp_config */
+#define SIOCGHWTSTAMP      _SIOC(0x0049)  /* Get hardware timestamping config,
+                                           * arg: as SIOCSHWTSTAMP */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -137,10 +137,11 @@ typedef uint8_t sockcaps_t;
  * a given address family.
  */
 
-struct file;    /* Forward reference */
-struct stat;    /* Forward reference */
-struct socket;  /* Forward reference */
-struct pollfd;  /* Forward reference */
+struct file;           /* Forward reference */
+struct stat;           /* Forward reference */
+struct socket;         /* Forward reference */
+struct pollfd;         /* Forward reference */
+struct mm_map_entry_s; /* Forward reference */
 
 struct sock_intf_s
 {
@@ -181,6 +182,11 @@ struct sock_intf_s
                     FAR struct file *infile, FAR off_t *offset,
                     size_t count);
 #endif
+  CODE int        (*si_mmap)(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
+  CODE int        (*si_recvmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags, FAR const struct timespec *timeout);
 };
 
 /* Each socket refers to a connection structure of type FAR void *.  Each
@@ -914,6 +920,43 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends a vector of messages to a socket.  It is
+ *   functionally equivalent to sendmmsg() except that it is not a
+ *   cancellation point, it does not modify the errno variable and it
+ *   accepts the internal socket structure rather than a descriptor.
+ *
+ * Returned Value:
+ *   The number of messages sent or, if the first one failed, a negated
+ *   errno value.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives a vector of messages from a socket.  It is
+ *   functionally equivalent to recvmmsg() except that it is not a
+ *   cancellation point, it does not modify the errno variable and it
+ *   accepts the internal socket structure rather than a descriptor.
+ *
+ * Returned Value:
+ *   The number of messages received or, if the first one failed, a
+ *   negated errno value.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -1316,6 +1359,24 @@ int psock_shutdown(FAR struct socket *psock, int how);
 struct pollfd; /* Forward reference -- see poll.h */
 int psock_poll(FAR struct socket *psock, struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: psock_mmap
+ *
+ * Description:
+ *   The standard mmap() operation redirects operations on socket
+ *   descriptors to this function.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   map   - The mapping to set up.
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure.
+ *
+ ****************************************************************************/
+
+int psock_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map);
+
 /****************************************************************************
  * Name: psock_dup2
  *
@@ -60,6 +60,10 @@
 #include <nuttx/net/ip.h>
 #include <nuttx/nuttx.h>
 
+#ifdef CONFIG_NET_STATISTICS_PERCPU
+#  include <nuttx/sched.h>
+#endif
+
 #ifdef CONFIG_NET_IGMP
 #  include <nuttx/net/igmp.h>
 #endif
@@ -103,33 +107,49 @@
 /* Helper macros for network device statistics */
 
 #ifdef CONFIG_NETDEV_STATISTICS
+/* NETDEV_STATISTICS() is the calling CPU's copy of the device counters,
+ * netdev_statistics_get() returns their total.
+ */
+
+#  ifdef CONFIG_NET_STATISTICS_PERCPU
+#    define _NETDEV_STATISTICS_CPU(dev,cpu) ((dev)->d_statistics[cpu])
+#    define NETDEV_STATISTICS(dev) _NETDEV_STATISTICS_CPU(dev,this_cpu())
+#  else
+#    define _NETDEV_STATISTICS_CPU(dev,cpu) ((dev)->d_statistics)
+#    define NETDEV_STATISTICS(dev) ((dev)->d_statistics)
+#    define netdev_statistics_get(dev,buf) \
+       ((void)(buf), &(dev)->d_statistics)
+#  endif
+
 #  define NETDEV_RESET_STATISTICS(dev) \
-     memset(&(dev)->d_statistics, 0, sizeof(struct netdev_statistics_s))
+     memset(&(dev)->d_statistics, 0, sizeof((dev)->d_statistics))
 
-#  define _NETDEV_STATISTIC(dev,name) ((dev)->d_statistics.name++)
+#  define _NETDEV_STATISTIC(dev,name) (NETDEV_STATISTICS(dev).name++)
 #  define _NETDEV_ERROR(dev,name) \
      do \
        { \
-         (dev)->d_statistics.name++; \
-         (dev)->d_statistics.errors++; \
+         NETDEV_STATISTICS(dev).name++; \
+         NETDEV_STATISTICS(dev).errors++; \
        } \
      while (0)
 
 #define _NETDEV_BYTES(dev,name) \
     do { \
-        (dev)->d_statistics.name += (dev)->d_len; \
+        NETDEV_STATISTICS(dev).name += (dev)->d_len; \
     } while (0)
 
 #  if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
 #    define NETDEV_STATISTICS_WORK LPWORK
+#    define NETDEV_STATISTICS_LOGWORK(dev) \
+       (&_NETDEV_STATISTICS_CPU(dev,0).logwork)
 #    define _NETDEV_STATISTIC_LOG(dev,name) \
        do \
          { \
            _NETDEV_STATISTIC(dev,name); \
-           if (work_available(&(dev)->d_statistics.logwork)) \
+           if (work_available(NETDEV_STATISTICS_LOGWORK(dev))) \
              { \
                work_queue(NETDEV_STATISTICS_WORK, \
-                          &(dev)->d_statistics.logwork, \
+                          NETDEV_STATISTICS_LOGWORK(dev), \
                           netdev_statistics_log, (dev), \
                           SEC2TICK(CONFIG_NETDEV_STATISTICS_LOG_PERIOD)); \
              } \
@@ -193,6 +213,11 @@
 #  define NETDEV_ERRORS(dev)
 #endif
 
+/* Checksums a device computes on transmit, net_driver_s::d_csumcap */
+
+#define NETDEV_CSUM_TCP (1 << 0) /* TCP over IPv4 and IPv6 */
+#define NETDEV_CSUM_UDP (1 << 1) /* UDP over IPv4 and IPv6 */
+
 /* There are some helper pointers for accessing the contents of the IP
  * headers
  */
@@ -352,6 +377,16 @@ struct net_driver_s
 #endif
 
   uint16_t d_pktsize;           /* Maximum packet size */
+#ifdef CONFIG_NETDEV_GSO
+  uint16_t d_gsomax;            /* Maximum TCP super-frame size, 0: none */
+#endif
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  /* NETDEV_CSUM_* the device finishes for d_iob marked IOB_CSUM_PARTIAL.
+   * Received packets marked IOB_CSUM_UNNECESSARY are not verified again.
+   */
+
+  uint8_t d_csumcap;
+#endif
 
   /* Link layer address */
 
@@ -496,6 +531,15 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NETDEV_GSO
+  /* When d_buf holds a TCP super-frame bigger than d_pktsize, d_gsosize is
+   * the payload size of the segments it has to be cut into by the driver.
+   * It is cleared together with d_iob.
+   */
+
+  uint16_t d_gsosize;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -508,10 +552,15 @@ struct net_driver_s
 #ifdef CONFIG_NETDEV_STATISTICS
   /* If CONFIG_NETDEV_STATISTICS is enabled and if the driver supports
    * statistics, then this structure holds the counts of network driver
-   * events.
+   * events.  With CONFIG_NET_STATISTICS_PERCPU each CPU counts in its
+   * own copy.
    */
 
+#  ifdef CONFIG_NET_STATISTICS_PERCPU
+  struct netdev_statistics_s d_statistics[CONFIG_SMP_NCPUS];
+#  else
   struct netdev_statistics_s d_statistics;
+#  endif
 #endif
 
 #if defined(CONFIG_NET_TIMESTAMP)
@@ -1226,6 +1275,32 @@ void netdev_iob_release(FAR struct net_driver_s *dev);
 FAR struct iob_s *netdev_iob_clone(FAR struct net_driver_s *dev,
                                    bool throttled);
 
+/****************************************************************************
+ * Name: net_txtstamp
+ *
+ * Description:
+ *   Report the transmit time of a packet whose io_tsid is set, the time it
+ *   was handed to the driver (hw is false) or the time the hardware put it
+ *   on the wire (hw is true).  The timestamp is queued to the error queue
+ *   of the sending socket once no further timestamp is expected, a NULL
+ *   ts with hw true completes the request with what has been reported so
+ *   far.  io_tsid is cleared when the request is complete.
+ *
+ * Input Parameters:
+ *   iob - The head of the transmitted packet
+ *   ts  - The CLOCK_REALTIME (software) or PHC (hardware) time, or NULL
+ *   hw  - Whether ts comes from the hardware
+ *
+ * Assumptions:
+ *   Not called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+void net_txtstamp(FAR struct iob_s *iob, FAR const struct timespec *ts,
+                  bool hw);
+#endif
+
 /****************************************************************************
  * Name: netdev_ipv6_add/del
  *
@@ -1371,4 +1446,25 @@ int netdev_ipv6_foreach(FAR struct net_driver_s *dev,
 void netdev_statistics_log(FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: netdev_statistics_get
+ *
+ * Description:
+ *   Add up the per-CPU copies of the device counters.
+ *
+ * Input Parameters:
+ *   dev - The network device
+ *   buf - Where to store the total
+ *
+ * Returned Value:
+ *   buf, holding the total counts.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NET_STATISTICS_PERCPU)
+FAR struct netdev_statistics_s *
+netdev_statistics_get(FAR struct net_driver_s *dev,
+                      FAR struct netdev_statistics_s *buf);
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_NETDEV_H */
@@ -68,6 +68,12 @@
 #define NETPKT_BUFLEN   CONFIG_IOB_BUFSIZE
 #define NETPKT_BUFNUM   CONFIG_IOB_NBUFFERS
 
+/* Offloads a lower half can claim in netdev_lowerhalf_s::features */
+
+#define NETDEV_FEATURE_TSO     (1 << 0) /* Segments TCP super-frames */
+#define NETDEV_FEATURE_TXCSUM  (1 << 1) /* Computes TCP/UDP checksums */
+#define NETDEV_FEATURE_HWTSTAMP (1 << 2) /* Reports hardware RX/TX times */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -79,6 +85,7 @@
 
 typedef struct iob_s netpkt_t;
 typedef struct iob_queue_s netpkt_queue_t;
+typedef struct iob_sg_s netpkt_sg_t;
 
 enum netpkt_type_e
 {
@@ -89,10 +96,13 @@ enum netpkt_type_e
 
 enum netdev_rx_e
 {
-  NETDEV_RX_WORK,      /* Use work queue thread */
-  NETDEV_RX_DIRECT,    /* Directly based on the current thread */
-  NETDEV_RX_THREAD,    /* Upper half dedicated thread */
-  NETDEV_RX_THREAD_RSS /* RSS mode, upper half thread */
+  NETDEV_RX_WORK,       /* Use work queue thread */
+  NETDEV_RX_DIRECT,     /* Directly based on the current thread */
+  NETDEV_RX_THREAD,     /* Upper half dedicated thread */
+  NETDEV_RX_THREAD_RSS, /* RSS mode, upper half thread */
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  NETDEV_RX_THREAD_MQ   /* Multi-queue mode, a thread per hardware queue */
+#endif
 };
 
 /* This structure is the generic form of state structure used by lower half
@@ -127,6 +137,23 @@ struct netdev_lowerhalf_s
   uint8_t rxtype;
   uint8_t priority;
 
+#if defined(CONFIG_NETDEV_GSO) || defined(CONFIG_NETDEV_CSUM_OFFLOAD) || \
+    defined(CONFIG_NET_TIMESTAMPING)
+  /* NETDEV_FEATURE_* set by the driver before registering, whatever is not
+   * claimed here is done in software by the upper half or the stack.
+   */
+
+  uint8_t features;
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Number of RX/TX queue pairs for NETDEV_RX_THREAD_MQ, the upper half
+   * runs one thread per queue and spreads them over the CPUs.
+   */
+
+  uint8_t nqueues;
+#endif
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
@@ -180,6 +207,40 @@ struct netdev_ops_s
   /* reclaim - try to reclaim packets sent by netdev. */
 
   CODE void (*reclaim)(FAR struct netdev_lowerhalf_s *dev);
+
+#if CONFIG_NETDEV_RX_BUDGET > 0
+  /* rxint - Enable or disable the RX interrupt of a queue (0 without
+   *   multi-queue), optional.  If provided, the upper half disables it in
+   *   netdev_lower_rxready and enables it again only once the poll rounds
+   *   have drained the queue, may be called from the interrupt handler.
+   */
+
+  CODE void (*rxint)(FAR struct netdev_lowerhalf_s *dev, int queue,
+                     bool enable);
+
+  /* coalesce - Hint the average number of packets received per poll
+   *   round (0 or a power of two), optional.  Drivers with interrupt
+   *   moderation may delay interrupts more under high load and deliver
+   *   them at once under light load.
+   */
+
+  CODE void (*coalesce)(FAR struct netdev_lowerhalf_s *dev,
+                        unsigned int npkts);
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* transmit_queue/receive_queue - The same as transmit/receive, but on
+   *   the given queue, used instead of them for NETDEV_RX_THREAD_MQ.
+   *   The upper half picks the TX queue by flow hash, so the packets of
+   *   one flow are always sent in order on one queue; RX queues are
+   *   expected to be steered by the hardware RSS hash in the same way.
+   */
+
+  CODE int (*transmit_queue)(FAR struct netdev_lowerhalf_s *dev,
+                             FAR netpkt_t *pkt, int queue);
+  CODE FAR netpkt_t *(*receive_queue)(FAR struct netdev_lowerhalf_s *dev,
+                                      int queue);
+#endif
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -303,6 +364,24 @@ void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about RX packets ready to read on one
+ *   queue of a NETDEV_RX_THREAD_MQ device.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The RX queue with new packets
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue);
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_txdone
  *
@@ -505,6 +584,136 @@ int netpkt_setdatalen(FAR struct netdev_lowerhalf_s *dev,
 unsigned int netpkt_getdatalen(FAR struct netdev_lowerhalf_s *dev,
                                FAR netpkt_t *pkt);
 
+/****************************************************************************
+ * Name: netpkt_getgsosize
+ *
+ * Description:
+ *   Get the TCP segment size of a super-frame passed to transmit() of a
+ *   lower half with NETDEV_FEATURE_TSO, only valid inside transmit().
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *
+ * Returned Value:
+ *   The payload size of each segment, or zero if pkt is a normal packet.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GSO
+uint16_t netpkt_getgsosize(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt);
+#endif
+
+/****************************************************************************
+ * Name: netpkt_setcsumvalid
+ *
+ * Description:
+ *   Mark a received packet whose TCP/UDP checksum has been verified by the
+ *   hardware, so that the stack does not verify it again.  Packets with a
+ *   bad checksum should just not be marked.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+void netpkt_setcsumvalid(FAR struct netdev_lowerhalf_s *dev,
+                         FAR netpkt_t *pkt);
+#endif
+
+/****************************************************************************
+ * Name: netpkt_getcsumpartial
+ *
+ * Description:
+ *   Check whether the device has to finish the TCP/UDP checksum of a packet
+ *   passed to transmit() of a lower half with NETDEV_FEATURE_TXCSUM.  The
+ *   checksum field holds the pseudo-header sum, the device has to add the
+ *   one's complement sum from start to the end of the packet and store its
+ *   complement at start + offset.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *   start  - Returns the offset of the TCP/UDP header from the L2 data
+ *   offset - Returns the offset of the checksum field in that header
+ *
+ * Returned Value:
+ *   true if the checksum has to be computed by the device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+bool netpkt_getcsumpartial(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt, FAR unsigned int *start,
+                           FAR unsigned int *offset);
+#endif
+
+/****************************************************************************
+ * Name: netpkt_setrxtstamp
+ *
+ * Description:
+ *   Attach the hardware receive time of a packet, read from the PTP
+ *   hardware clock of the device, before returning it from receive().
+ *   Only meaningful on a lower half with NETDEV_FEATURE_HWTSTAMP.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The received net packet
+ *   ts     - The hardware receive time
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+void netpkt_setrxtstamp(FAR struct netdev_lowerhalf_s *dev,
+                        FAR netpkt_t *pkt, FAR const struct timespec *ts);
+#endif
+
+/****************************************************************************
+ * Name: netpkt_needtxtstamp
+ *
+ * Description:
+ *   Check whether a packet passed to transmit() wants its hardware transmit
+ *   time, the lower half then has to latch it and report it with
+ *   netpkt_settxtstamp() before freeing the packet.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *
+ * Returned Value:
+ *   true if the transmit time of the packet is wanted.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+bool netpkt_needtxtstamp(FAR struct netdev_lowerhalf_s *dev,
+                         FAR netpkt_t *pkt);
+#endif
+
+/****************************************************************************
+ * Name: netpkt_settxtstamp
+ *
+ * Description:
+ *   Report the hardware transmit time of a packet for which
+ *   netpkt_needtxtstamp() returned true, or NULL if the hardware could not
+ *   stamp it.  Must be called from thread context (e.g. the work that
+ *   reclaims the TX descriptors), not from the interrupt handler.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The transmitted net packet
+ *   ts     - The hardware transmit time, or NULL
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+void netpkt_settxtstamp(FAR struct netdev_lowerhalf_s *dev,
+                        FAR netpkt_t *pkt, FAR const struct timespec *ts);
+#endif
+
 /****************************************************************************
  * Name: netpkt_reset_reserved
  *
@@ -555,6 +764,47 @@ bool netpkt_is_fragmented(FAR netpkt_t *pkt);
 int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
                   FAR struct iovec *iov, int iovcnt);
 
+/****************************************************************************
+ * Name: netpkt_to_sg
+ *
+ * Description:
+ *   Describe a (possibly linked) netpkt as a list of DMA segments, with the
+ *   virtual address, the physical address and the length of each piece of
+ *   data, so that the packet can be handed to the hardware without copying
+ *   it into a contiguous buffer.  Call netpkt_sg_sync() before starting the
+ *   transfer if the buffers are not cache coherent.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *   sg     - The segment array to write
+ *   nsg    - The number of elements in the segment array
+ *
+ * Returned Value:
+ *   The number of segments written; -E2BIG if the packet has more pieces
+ *   than "nsg".
+ *
+ ****************************************************************************/
+
+int netpkt_to_sg(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                 FAR netpkt_sg_t *sg, int nsg);
+
+/****************************************************************************
+ * Name: netpkt_sg_sync
+ *
+ * Description:
+ *   Clean (todevice true, before TX) or invalidate (todevice false, after
+ *   RX) the data cache for the segments returned by netpkt_to_sg().
+ *
+ * Input Parameters:
+ *   sg       - The segment array
+ *   nsg      - The number of segments
+ *   todevice - The direction of the transfer
+ *
+ ****************************************************************************/
+
+#define netpkt_sg_sync(sg, nsg, todevice) iob_sg_sync(sg, nsg, todevice)
+
 /****************************************************************************
  * Name: netpkt_tryadd_queue
  *
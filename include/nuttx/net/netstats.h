@@ -43,9 +43,13 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <nuttx/net/netconfig.h>
+#ifdef CONFIG_NET_STATISTICS_PERCPU
+#  include <nuttx/sched.h>
+#endif
 
 #include <nuttx/net/ip.h>
 #ifdef CONFIG_NET_TCP
@@ -76,6 +80,19 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Counters are updated through g_netstats, which is the calling CPU's copy
+ * with CONFIG_NET_STATISTICS_PERCPU.  NET_STATS() reads the total of a
+ * counter, e.g. NET_STATS(tcp.recv).
+ */
+
+#ifdef CONFIG_NET_STATISTICS_PERCPU
+#  define g_netstats     g_netstats_cpu[this_cpu()]
+#  define NET_STATS(field) \
+     net_stats_sum(offsetof(struct net_stats_s, field))
+#else
+#  define NET_STATS(field) (g_netstats.field)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -129,11 +146,34 @@ struct net_stats_s
 
 /* This is the structure in which the statistics are gathered. */
 
+#ifdef CONFIG_NET_STATISTICS_PERCPU
+extern struct net_stats_s g_netstats_cpu[CONFIG_SMP_NCPUS];
+#else
 extern struct net_stats_s g_netstats;
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: net_stats_sum
+ *
+ * Description:
+ *   Add up one counter over the copies of all CPUs.  Use NET_STATS()
+ *   instead of calling this directly.
+ *
+ * Input Parameters:
+ *   offset - The offset of the counter in struct net_stats_s
+ *
+ * Returned Value:
+ *   The total count.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_STATISTICS_PERCPU
+net_stats_t net_stats_sum(size_t offset);
+#endif
+
 #endif /* CONFIG_NET_STATISTICS */
 #endif /* __INCLUDE_NUTTX_NET_NETSTATS_H */
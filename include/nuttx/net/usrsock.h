@@ -414,10 +414,29 @@ ssize_t usrsock_response(FAR const char *buffer, size_t len,
 
 /****************************************************************************
  * Name: usrsock_request() - finish usrsock's request
+ *
+ * Description:
+ *   Hand a request over to the daemon.  The request buffers may be reused
+ *   as soon as this returns.
+ *
  ****************************************************************************/
 
 int usrsock_request(FAR struct iovec *iov, unsigned int iovcnt);
 
+/****************************************************************************
+ * Name: usrsock_request_buffer() - queue a request without waiting
+ *
+ * Description:
+ *   Hand a request allocated with kmm_malloc() over to the daemon.  The
+ *   transport owns the buffer and frees it once the request is sent, or
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_USRSOCK_SEND_CREDITS > 0
+int usrsock_request_buffer(FAR void *buf, size_t len);
+#endif
+
 /****************************************************************************
  * Name: usrsock_register
  *
@@ -507,6 +507,40 @@ void nxgl_circletraps(FAR const struct nxgl_point_s *center,
 uint32_t nxglib_rgb24_blend(uint32_t color1, uint32_t color2, ub16_t frac1);
 uint16_t nxglib_rgb565_blend(uint16_t color1, uint16_t color2, ub16_t frac1);
 
+#ifdef CONFIG_NX_HWACCEL
+/****************************************************************************
+ * Name: up_nxgl_fillrectangle, up_nxgl_moverectangle and
+ *       up_nxgl_copyrectangle
+ *
+ * Description:
+ *   Optional hooks to a 2D blitter of the architecture, provided when it
+ *   selects CONFIG_ARCH_HAVE_NX_HWACCEL.  The framebuffer rasterizers of
+ *   8 bits per pixel and more try them first, with the same arguments,
+ *   and fall back to the software loops when they fail.  The operation
+ *   must be complete when the hook returns.
+ *
+ * Returned Value:
+ *   OK if the operation was done by the hardware; a negated errno value,
+ *   e.g. for an unsupported pixel format or an area too small to be worth
+ *   the setup, if the software should do it instead.
+ *
+ ****************************************************************************/
+
+struct fb_planeinfo_s;
+
+int up_nxgl_fillrectangle(FAR struct fb_planeinfo_s *pinfo,
+                          FAR const struct nxgl_rect_s *rect,
+                          nxgl_mxpixel_t color);
+int up_nxgl_moverectangle(FAR struct fb_planeinfo_s *pinfo,
+                          FAR const struct nxgl_rect_s *rect,
+                          FAR struct nxgl_point_s *offset);
+int up_nxgl_copyrectangle(FAR struct fb_planeinfo_s *pinfo,
+                          FAR const struct nxgl_rect_s *dest,
+                          FAR const void *src,
+                          FAR const struct nxgl_point_s *origin,
+                          unsigned int srcstride);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -27,8 +27,11 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
 #include <stdint.h>
+#include <sys/types.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/list.h>
 #include <nuttx/pci/pci_ids.h>
 #include <nuttx/pci/pci_regs.h>
@@ -344,6 +347,14 @@ struct pci_ops_s
 
   CODE int (*connect_irq)(FAR struct pci_bus_s *bus, FAR int *irq,
                           int num, FAR uintptr_t *mar, FAR uint32_t *mdr);
+
+  /* Get the MSI/MSI-X message that routes a vector to a CPU, if the
+   * destination is part of the message.  Otherwise up_affinity_irq()
+   * is used.
+   */
+
+  CODE int (*affinity_irq)(FAR struct pci_bus_s *bus, int irq, int cpu,
+                           FAR uintptr_t *mar, FAR uint32_t *mdr);
 };
 
 /* Each pci channel is a top-level PCI bus seem by CPU.  A machine with
@@ -834,6 +845,87 @@ void pci_release_irq(FAR struct pci_device_s *dev, FAR int *irq, int num);
 
 int pci_connect_irq(FAR struct pci_device_s *dev, FAR int *irq, int num);
 
+/****************************************************************************
+ * Name: pci_mask_irq
+ *
+ * Description:
+ *   Mask or unmask one MSI-X vector in the device.
+ *
+ * Input Parameters:
+ *   dev   - PCI device
+ *   index - index of the vector in the MSI-X table
+ *   mask  - true to mask, false to unmask
+ *
+ * Return value:
+ *   Return OK on success, -ENOTSUP if MSI-X is not available.
+ *
+ ****************************************************************************/
+
+int pci_mask_irq(FAR struct pci_device_s *dev, int index, bool mask);
+
+/****************************************************************************
+ * Name: pci_affinity_irq
+ *
+ * Description:
+ *   Route a connected MSI or MSI-X vector to a CPU.
+ *
+ * Input Parameters:
+ *   dev   - PCI device
+ *   index - index of the vector in the MSI-X table
+ *   irq   - the vector
+ *   cpu   - the CPU to interrupt
+ *
+ * Return value:
+ *   Return OK on success or negative errno on failure.
+ *
+ ****************************************************************************/
+
+int pci_affinity_irq(FAR struct pci_device_s *dev, int index, int irq,
+                     int cpu);
+
+/****************************************************************************
+ * Name: pci_connect_queue_irqs
+ *
+ * Description:
+ *   Allocate and connect up to 'num' MSI or MSI-X vectors, one per queue,
+ *   attach 'isr' to each and enable them.  Queue i gets the argument
+ *   'arg' + i * 'argsize' and, with SMP, is routed to CPU i modulo the
+ *   number of CPUs.
+ *
+ * Input Parameters:
+ *   dev     - PCI device
+ *   irq     - returned vectors
+ *   num     - number of queues
+ *   isr     - interrupt handler of all the queues
+ *   arg     - argument of the first queue
+ *   argsize - distance between the arguments of two queues
+ *
+ * Return value:
+ *   Return the number of vectors, which may be less than 'num', or
+ *   negative errno on failure.
+ *
+ ****************************************************************************/
+
+int pci_connect_queue_irqs(FAR struct pci_device_s *dev, FAR int *irq,
+                           int num, xcpt_t isr, FAR void *arg,
+                           size_t argsize);
+
+/****************************************************************************
+ * Name: pci_release_queue_irqs
+ *
+ * Description:
+ *   Disable, detach and release the vectors of pci_connect_queue_irqs().
+ *
+ * Input Parameters:
+ *   dev - PCI device
+ *   irq - vectors
+ *   num - number of vectors returned by pci_connect_queue_irqs()
+ *
+ ****************************************************************************/
+
+void pci_release_queue_irqs(FAR struct pci_device_s *dev, FAR int *irq,
+                            int num);
+
 /****************************************************************************
  * Name: pci_register_driver
  *
@@ -79,6 +79,12 @@
 #define MM_NPAGES(s)      (((uintptr_t)(s) + MM_PGMASK) >> MM_PGSHIFT)
 #define MM_ISALIGNED(a)   (((uintptr_t)(a) & MM_PGMASK) == 0)
 
+/* Largest block mapping the MMUs can use for a physically contiguous
+ * region: arm64 level 2 blocks and RISC-V Sv39 megapages.
+ */
+
+#define MM_PGLARGESIZE    0x200000
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -185,6 +191,27 @@ uintptr_t mm_pgalloc(unsigned int npages);
 
 uintptr_t mm_pgalloc_align(unsigned int npages, unsigned int align);
 
+/****************************************************************************
+ * Name: mm_pgalloc_contig
+ *
+ * Description:
+ *   Allocate physically contiguous page memory, aligned so that it can be
+ *   mapped with the largest block or contiguous entries its size allows,
+ *   up to MM_PGLARGESIZE.  The alignment is relaxed when the pool is too
+ *   fragmented for it.
+ *
+ * Input Parameters:
+ *   npages - The number of pages to allocate, each of size CONFIG_MM_PGSIZE.
+ *
+ * Returned Value:
+ *   On success, a non-zero, physical address of the allocated page memory
+ *   is returned.  Zero is returned on failure.  NOTE:  This is an unmapped
+ *   physical address and cannot be used until it is appropriately mapped.
+ *
+ ****************************************************************************/
+
+uintptr_t mm_pgalloc_contig(unsigned int npages);
+
 /****************************************************************************
  * Name: mm_pgfree
  *
@@ -0,0 +1,150 @@
+/****************************************************************************
+ * include/nuttx/rcu.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RCU_H
+#define __INCLUDE_NUTTX_RCU_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/arch.h>
+#include <nuttx/queue.h>
+
+#ifdef CONFIG_RCU
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Fetch an RCU protected pointer inside a read-side critical section.  The
+ * barrier orders the load of the pointer before the loads of the data it
+ * points to.
+ */
+
+#define rcu_dereference(p) \
+  ({ \
+    typeof(p) _p = *(FAR volatile typeof(p) *)&(p); \
+    SMP_RMB(); \
+    _p; \
+  })
+
+/* Publish a new value of an RCU protected pointer.  The barrier makes the
+ * initialization of the pointed-to data visible before the pointer itself.
+ */
+
+#define rcu_assign_pointer(p, v) \
+  do \
+    { \
+      SMP_WMB(); \
+      *(FAR volatile typeof(p) *)&(p) = (v); \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct rcu_head;
+typedef CODE void (*rcu_callback_t)(FAR struct rcu_head *head);
+
+/* Embed this structure in an object that is to be reclaimed by call_rcu() */
+
+struct rcu_head
+{
+  sq_entry_t     node;      /* Entry in the list of pending callbacks */
+  rcu_callback_t func;      /* Called once the grace period has elapsed */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: rcu_read_lock
+ *
+ * Description:
+ *   Enter an RCU read-side critical section.  Read-side sections may nest
+ *   and may be preempted, but they must not wait for anything that an
+ *   updater holds while it calls synchronize_rcu().  This function must
+ *   not be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void rcu_read_lock(void);
+
+/****************************************************************************
+ * Name: rcu_read_unlock
+ *
+ * Description:
+ *   Leave an RCU read-side critical section.
+ *
+ ****************************************************************************/
+
+void rcu_read_unlock(void);
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ *
+ * Description:
+ *   Wait until every RCU read-side critical section that was in progress
+ *   when this function was called has completed.  Objects unlinked before
+ *   the call may be freed once it returns.
+ *
+ ****************************************************************************/
+
+void synchronize_rcu(void);
+
+/****************************************************************************
+ * Name: call_rcu
+ *
+ * Description:
+ *   Arrange for "func" to be called with "head" once a grace period has
+ *   elapsed.  The callback runs on the low priority work queue, so this
+ *   function never blocks.
+ *
+ * Input Parameters:
+ *   head - The rcu_head embedded in the object to be reclaimed
+ *   func - The function that reclaims the object
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+void call_rcu(FAR struct rcu_head *head, rcu_callback_t func);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_RCU */
+#endif /* __INCLUDE_NUTTX_RCU_H */
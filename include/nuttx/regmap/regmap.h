@@ -74,6 +74,22 @@ struct regmap_bus_s
   exit_t  exit;
 };
 
+/* Kinds of register cache, see CONFIG_REGMAP_CACHE */
+
+enum regmap_cache_e
+{
+  REGMAP_CACHE_NONE = 0,       /* Every access goes to the bus */
+  REGMAP_CACHE_FLAT            /* An array indexed by register */
+};
+
+/* Value of a register after reset */
+
+struct regmap_default_s
+{
+  unsigned int reg;
+  unsigned int def;
+};
+
 /* Configuration for the register map of a device.
  * reg_bits and val_bits must be set.
  */
@@ -100,6 +116,35 @@ struct regmap_config_s
    */
 
   bool disable_locking;
+
+  /* The register cache, only with CONFIG_REGMAP_CACHE.  A cached register
+   * is read from the bus once; the cache also serves the read half of
+   * regmap_update_bits().  max_register is the highest register address.
+   */
+
+  enum regmap_cache_e cache_type;
+  unsigned int max_register;
+
+  /* Optional: true for registers that change by themselves (status,
+   * interrupt flags, data) and so must never be served from the cache.
+   */
+
+  CODE bool (*volatile_reg)(unsigned int reg);
+
+  /* Optional: the reset values of the registers, which then need no read
+   * from the bus and are not written back by regcache_sync() after
+   * regcache_mark_dirty().
+   */
+
+  FAR const struct regmap_default_s *reg_defaults;
+  unsigned int num_reg_defaults;
+
+  /* The device increments the register address in a multi-byte write, so
+   * regcache_sync() can write runs of consecutive registers in one bus
+   * transfer.  Needs a bus with a block write method.
+   */
+
+  bool cache_bulk_sync;
 };
 
 struct regmap_s;
@@ -312,6 +357,70 @@ int regmap_read(FAR struct regmap_s *map, unsigned int reg,
 int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
                      FAR void *val, unsigned int val_count);
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write of the bits of 'mask' in a register.  The register is
+ *   only written if its value changes; with a cache it is only read from
+ *   the bus the first time.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - the bits to update.
+ *   val  - the new value of the bits.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val);
+
+#ifdef CONFIG_REGMAP_CACHE
+/****************************************************************************
+ * Name: regcache_cache_only
+ *
+ * Description:
+ *   Enter or leave cache-only mode.  In cache-only mode writes of cached
+ *   registers only update the cache and mark them dirty, reads are served
+ *   from the cache, the other accesses fail with -EBUSY.  Use it while the
+ *   device is powered down, or to batch many writes for regcache_sync().
+ *
+ ****************************************************************************/
+
+void regcache_cache_only(FAR struct regmap_s *map, bool enable);
+
+/****************************************************************************
+ * Name: regcache_mark_dirty
+ *
+ * Description:
+ *   Tell the cache that the device has been reset, for example after a
+ *   resume.  All cached registers that differ from their defaults will be
+ *   written by the next regcache_sync().
+ *
+ ****************************************************************************/
+
+void regcache_mark_dirty(FAR struct regmap_s *map);
+
+/****************************************************************************
+ * Name: regcache_sync
+ *
+ * Description:
+ *   Write the dirty registers of the cache to the device, coalescing runs
+ *   of consecutive registers if cache_bulk_sync is set.  The cache-only
+ *   mode must have been left first.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regcache_sync(FAR struct regmap_s *map);
+#endif /* CONFIG_REGMAP_CACHE */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -31,6 +31,7 @@
 
 #ifdef CONFIG_RPMSG
 
+#include <nuttx/atomic.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/rpmsg/rpmsg_ping.h>
 #include <openamp/rpmsg.h>
@@ -57,6 +58,8 @@ struct rpmsg_s
   rmutex_t                     lock;
   struct metal_list            node;
   FAR const struct rpmsg_ops_s *ops;
+  atomic_t                     batch;   /* Nesting of open batches */
+  atomic_t                     batched; /* A kick waits for batch end */
 #ifdef CONFIG_RPMSG_PING
   struct rpmsg_endpoint        ping;
 #endif
@@ -71,6 +74,7 @@ struct rpmsg_s
  * wait: wait sem.
  * post: post sem.
  * get_cpuname: get cpu name.
+ * kick: notify the remote of the messages sent during a batch.
  */
 
 struct rpmsg_ops_s
@@ -83,6 +87,7 @@ struct rpmsg_ops_s
   CODE FAR const char *(*get_local_cpuname)(FAR struct rpmsg_s *rpmsg);
   CODE FAR const char *(*get_cpuname)(FAR struct rpmsg_s *rpmsg);
   CODE int (*get_signals)(FAR struct rpmsg_s *rpmsg);
+  CODE void (*kick)(FAR struct rpmsg_s *rpmsg);
 };
 
 CODE typedef void (*rpmsg_dev_cb_t)(FAR struct rpmsg_device *rdev,
@@ -109,6 +114,11 @@ extern "C"
 int rpmsg_wait(FAR struct rpmsg_endpoint *ept, FAR sem_t *sem);
 int rpmsg_post(FAR struct rpmsg_endpoint *ept, FAR sem_t *sem);
 
+int rpmsg_batch_begin(FAR struct rpmsg_endpoint *ept);
+int rpmsg_batch_end(FAR struct rpmsg_endpoint *ept);
+bool rpmsg_batch_defer(FAR struct rpmsg_s *rpmsg);
+void rpmsg_batch_flush(FAR struct rpmsg_s *rpmsg);
+
 FAR const char *rpmsg_get_local_cpuname(FAR struct rpmsg_device *rdev);
 FAR const char *rpmsg_get_cpuname(FAR struct rpmsg_device *rdev);
 int rpmsg_get_signals(FAR struct rpmsg_device *rdev);
@@ -0,0 +1,166 @@
+/****************************************************************************
+ * include/nuttx/rpmsg/rpmsg_bulk.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RPMSG_RPMSG_BULK_H
+#define __INCLUDE_NUTTX_RPMSG_RPMSG_BULK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_RPMSG_BULK
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/compiler.h>
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Reference to data in the pool, carried inside a rpmsg message instead
+ * of the data itself.
+ */
+
+begin_packed_struct struct rpmsg_bulk_handle_s
+{
+  uint32_t offset;              /* Offset of the data in the region */
+  uint32_t len;                 /* Length of the data */
+} end_packed_struct;
+
+/* A region of memory shared by two cores.  Each core allocates from its
+ * own half; blocks sent by the peer are only read and freed.
+ */
+
+struct rpmsg_bulk_s
+{
+  FAR uint8_t    *base;         /* Start of the shared region */
+  FAR uint16_t   *used;         /* Blocks of each local allocation */
+  spinlock_t      lock;         /* Protects the local allocations */
+  uint32_t        blksize;      /* Size of a block */
+  uint32_t        nblks;        /* Number of blocks in each half */
+  uint8_t         local;        /* Half allocated by this side */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: rpmsg_bulk_initialize
+ *
+ * Description:
+ *   Set up a pool in a shared memory region.  Both sides must use the same
+ *   region and block size, the master allocates from the first half.
+ *
+ * Input Parameters:
+ *   bulk    - The pool to set up
+ *   base    - Start of the shared region
+ *   size    - Size of the shared region
+ *   blksize - Allocation unit, a multiple of CONFIG_RPMSG_BULK_ALIGN
+ *   master  - Whether this side owns the first half
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int rpmsg_bulk_initialize(FAR struct rpmsg_bulk_s *bulk, FAR void *base,
+                          size_t size, uint32_t blksize, bool master);
+
+/****************************************************************************
+ * Name: rpmsg_bulk_uninitialize
+ ****************************************************************************/
+
+void rpmsg_bulk_uninitialize(FAR struct rpmsg_bulk_s *bulk);
+
+/****************************************************************************
+ * Name: rpmsg_bulk_alloc
+ *
+ * Description:
+ *   Allocate contiguous space for 'len' bytes from the local half and
+ *   fill in the handle to send to the peer.
+ *
+ * Returned Value:
+ *   The space on success; NULL if the local half is full.
+ *
+ ****************************************************************************/
+
+FAR void *rpmsg_bulk_alloc(FAR struct rpmsg_bulk_s *bulk, uint32_t len,
+                           FAR struct rpmsg_bulk_handle_s *handle);
+
+/****************************************************************************
+ * Name: rpmsg_bulk_commit
+ *
+ * Description:
+ *   Make the written data visible to the peer, before the handle is sent.
+ *
+ ****************************************************************************/
+
+void rpmsg_bulk_commit(FAR struct rpmsg_bulk_s *bulk,
+                       FAR const struct rpmsg_bulk_handle_s *handle);
+
+/****************************************************************************
+ * Name: rpmsg_bulk_map
+ *
+ * Description:
+ *   Get the data of a handle received from the peer.
+ *
+ * Returned Value:
+ *   The data on success; NULL if the handle is not valid.
+ *
+ ****************************************************************************/
+
+FAR void *rpmsg_bulk_map(FAR struct rpmsg_bulk_s *bulk,
+                         FAR const struct rpmsg_bulk_handle_s *handle);
+
+/****************************************************************************
+ * Name: rpmsg_bulk_free
+ *
+ * Description:
+ *   Free the space of a handle, either one received from the peer when
+ *   the data is consumed, or a local one that was never sent.
+ *
+ ****************************************************************************/
+
+void rpmsg_bulk_free(FAR struct rpmsg_bulk_s *bulk,
+                     FAR const struct rpmsg_bulk_handle_s *handle);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_RPMSG_BULK */
+#endif /* __INCLUDE_NUTTX_RPMSG_RPMSG_BULK_H */
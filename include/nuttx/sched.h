@@ -75,6 +75,10 @@
 #  define CONFIG_SCHED_SPORADIC_MAXREPL 3
 #endif
 
+/* Number of buckets in each critical section monitor histogram */
+
+#define CRITMON_HIST_NBUCKETS      32
+
 /* Task Management Definitions **********************************************/
 
 /* Special task IDS.  Any negative PID is invalid. */
@@ -98,6 +102,7 @@
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT)  /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT)  /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT)  /* Sporadic scheding policy */
+#  define TCB_FLAG_SCHED_DEADLINE  (3 << TCB_FLAG_POLICY_SHIFT)  /* Deadline scheding policy */
 #define TCB_FLAG_CPU_LOCKED        (1 << 5)                      /* Bit 5: Locked to this CPU */
 #define TCB_FLAG_SIGNAL_ACTION     (1 << 6)                      /* Bit 6: In a signal handler */
 #define TCB_FLAG_SYSCALL           (1 << 7)                      /* Bit 7: In a system call */
@@ -347,6 +352,26 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s ********************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* This structure is an allocated "plug-in" to the main TCB structure,
+ * allocated when the deadline scheduling policy is assigned to a thread.
+ * The remaining budget is kept in tcb->timeslice.
+ */
+
+struct deadline_s
+{
+  clock_t   runtime;                /* Execution budget per period           */
+  clock_t   deadline;               /* Relative deadline                     */
+  clock_t   period;                 /* Release period                        */
+  clock_t   abs_deadline;           /* Current absolute deadline             */
+  uint32_t  bandwidth;              /* runtime / period in parts per million */
+};
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s ****************************************************/
 
 /* This structure is used to maintain information about child tasks.
@@ -526,6 +551,12 @@ struct task_group_s
   FAR char **tg_envp;               /* Allocated environment strings        */
   ssize_t    tg_envpc;              /* Maximum entries of environment array */
   ssize_t    tg_envc;               /* Number of environment strings        */
+  FAR char  *tg_envblk;             /* Inherited strings, one allocation    */
+  size_t     tg_envblksize;         /* Size of the inherited strings        */
+#ifdef CONFIG_ENVIRON_HASH
+  FAR int   *tg_envhash;            /* Hash index, holds envp index + 1     */
+  size_t     tg_envhashsize;        /* Number of slots (power of two)       */
+#endif
 #endif
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
@@ -621,14 +652,25 @@ struct tcb_s
   int16_t  irqcount;                     /* 0=Not in critical section       */
 #endif
   int16_t  errcode;                      /* Used to pass error information  */
+#ifdef CONFIG_RCU
+  uint8_t  rcu_nesting;                  /* RCU read-side nesting depth     */
+  uint8_t  rcu_idx;                      /* RCU reader phase when entered   */
+#endif
+#ifdef CONFIG_FS_POLL_CACHE
+  FAR struct pollcache_s *pollcache;     /* poll() registrations kept       */
+#endif
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
   int32_t  timeslice;                    /* RR timeslice OR Sporadic budget */
                                          /* interval remaining              */
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters  */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  FAR struct deadline_s *deadline;       /* Deadline scheduling parameters  */
+#endif
 
   struct wdog_s waitdog;                 /* All timed waits use this timer  */
 
@@ -679,6 +721,16 @@ struct tcb_s
   clock_t ticks;                         /* Number of ticks on this thread  */
 #endif
 
+  /* Run time accounting support *******************************************/
+
+#ifdef CONFIG_SCHED_ACCOUNTING
+  clock_t acct_start;                    /* Time of the last state change   */
+  clock_t acct_runtime;                  /* Total time thread run           */
+  clock_t acct_waittime;                 /* Total time ready but not run    */
+  uint32_t acct_nvcsw;                   /* Number of voluntary switches    */
+  uint32_t acct_nivcsw;                  /* Number of involuntary switches  */
+#endif
+
   /* Pre-emption monitor support ********************************************/
 
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
@@ -687,6 +739,10 @@ struct tcb_s
   clock_t run_time;                      /* Total time thread run           */
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  clock_t wakeup_start;                  /* Time when thread made ready     */
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
   clock_t preemp_start;                  /* Time when preemption disabled   */
   clock_t preemp_max;                    /* Max time preemption disabled    */
@@ -826,6 +882,20 @@ EXTERN clock_t g_preemp_max[CONFIG_SMP_NCPUS];
 EXTERN clock_t g_crit_max[CONFIG_SMP_NCPUS];
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
 
+/* Per-CPU latency histograms, bucket N counts the intervals of fewer than
+ * 2^N performance counter cycles.
+ */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+EXTERN uint32_t g_wakeup_hist[CONFIG_SMP_NCPUS][CRITMON_HIST_NBUCKETS];
+#  if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
+EXTERN uint32_t g_preemp_hist[CONFIG_SMP_NCPUS][CRITMON_HIST_NBUCKETS];
+#  endif
+#  if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0
+EXTERN uint32_t g_crit_hist[CONFIG_SMP_NCPUS][CRITMON_HIST_NBUCKETS];
+#  endif
+#endif /* CONFIG_SCHED_CRITMONITOR_HISTOGRAM */
+
 /* g_running_tasks[] holds a references to the running task for each CPU.
  * It is valid only when up_interrupt_context() returns true.
  */
@@ -548,6 +548,29 @@ int nxsem_unlink(FAR const char *name);
 
 int nxsem_reset(FAR sem_t *sem, int16_t count);
 
+/****************************************************************************
+ * Name: nxsem_requeue
+ *
+ * Description:
+ *   Move up to 'count' threads waiting on the counting semaphore 'sem' to
+ *   the wait list of 'mutex' while it is held, so that they acquire the
+ *   mutex without being woken up first.  This is how condition variables
+ *   hand their waiters over to the mutex (wait morphing).
+ *
+ * Input Parameters:
+ *   sem   - The counting semaphore with the waiters
+ *   mutex - The mutex they are to acquire afterwards
+ *   count - The maximum number of waiters to move
+ *
+ * Returned Value:
+ *   This is an internal OS interface, not available to applications.  The
+ *   number of waiters moved is returned; the caller posts 'sem' for the
+ *   other ones.
+ *
+ ****************************************************************************/
+
+int nxsem_requeue(FAR sem_t *sem, FAR sem_t *mutex, int count);
+
 /****************************************************************************
  * Name: nxsem_get_protocol
  *
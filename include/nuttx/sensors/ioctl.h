@@ -511,6 +511,15 @@
 #define SNIOC_COLD_START              _SNIOC(0X00A7)
 #define SNIOC_FULL_COLD_START         _SNIOC(0X00A8)
 
+/* Command:      SNIOC_RING_ATTACH
+ * Description:  Get a cursor in the ring of the topic mapped by mmap(), the
+ *               user is then readable while its cursor is behind the head.
+ * Argument:     None.
+ * Note:         Return the cursor slot in struct sensor_ring_s, or errno.
+ */
+
+#define SNIOC_RING_ATTACH             _SNIOC(0x00A9)
+
 /****************************************************************************
  * Public types
  ****************************************************************************/
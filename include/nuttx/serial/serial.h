@@ -364,6 +364,9 @@ struct uart_dev_s
 #ifdef CONFIG_SERIAL_TXDMA
   struct uart_dmaxfer_s dmatx;       /* Describes transmit DMA transfer */
 #endif
+#ifdef CONFIG_SERIAL_TXDMA_DIRECT
+  volatile bool dmadirect;           /* dmatx points at a writer's buffer */
+#endif
 #ifdef CONFIG_SERIAL_RXDMA
   struct uart_dmaxfer_s dmarx;       /* Describes receive DMA transfer */
 #endif
@@ -0,0 +1,219 @@
+/****************************************************************************
+ * include/nuttx/shmring.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_SHMRING_H
+#define __INCLUDE_NUTTX_SHMRING_H
+
+/* A shared memory ring passes variable sized messages from one producer to
+ * one consumer through a shared memory object (see shm_open() and mmap()),
+ * in any mix of tasks and processes.  No lock is taken and no system call
+ * is made per message: the producer only calls into the kernel to wake up
+ * a consumer that sleeps on an empty ring, on the empty to non-empty
+ * transition.  The wakeup is done with the FIOC_RINGNOTIFY and
+ * FIOC_RINGWAIT ioctls on the shm file descriptor.
+ *
+ * The producer calls shmring_reserve(), fills in the message in place and
+ * publishes it with shmring_commit().  The consumer gets the next message
+ * in place with shmring_peek() and frees it with shmring_release().  A
+ * consumer that runs out of messages sleeps in shmring_wait(), or, to wait
+ * with poll(), calls shmring_arm() and polls the descriptor for POLLIN,
+ * takes the wakeup with ioctl(fd, FIOC_RINGWAIT, 0) and then calls
+ * shmring_disarm().
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/atomic.h>
+#include <nuttx/compiler.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef CONFIG_FS_SHMFS_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SHMRING_MAGIC     0x52474e52  /* Set once the ring is initialized */
+#define SHMRING_CACHELINE 64          /* Keeps the two sides apart */
+#define SHMRING_HDRLEN    8           /* Bytes in front of each message */
+
+/* The smallest shared memory object that holds a ring */
+
+#define SHMRING_MINSIZE   (offsetof(struct shmring_s, data) + 16)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The ring control structure at the start of the shared memory object.
+ * Indexes run freely and are reduced modulo "size" when used.
+ */
+
+struct shmring_s
+{
+  uint32_t magic;                             /* SHMRING_MAGIC */
+  uint32_t size;                              /* Data bytes, power of two */
+
+  /* Written by the producer */
+
+  atomic_t head aligned_data(SHMRING_CACHELINE);
+  uint32_t reserved;                          /* Head after the reserved
+                                               * message */
+
+  /* Written by the consumer */
+
+  atomic_t tail aligned_data(SHMRING_CACHELINE);
+  atomic_t waiting;                           /* Set while it may sleep */
+
+  uint8_t  data[1] aligned_data(SHMRING_CACHELINE);
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: shmring_init
+ *
+ * Description:
+ *   Initialize an empty ring in mapped shared memory.  The data area is the
+ *   largest power of two that fits.  Only one side initializes the ring,
+ *   before the other side starts using it.
+ *
+ * Input Parameters:
+ *   ring   - The start of the mapped shared memory object
+ *   length - The length of the mapping, at least SHMRING_MINSIZE
+ *
+ * Returned Value:
+ *   Zero on success; -EINVAL if the object is too small.
+ *
+ ****************************************************************************/
+
+int shmring_init(FAR struct shmring_s *ring, size_t length);
+
+/****************************************************************************
+ * Name: shmring_reserve
+ *
+ * Description:
+ *   Reserve room for a message of "len" bytes.  The message is not visible
+ *   to the consumer until shmring_commit() is called.  Producer only.
+ *
+ * Returned Value:
+ *   The 8-byte aligned message buffer, or NULL if the ring is too full.
+ *
+ ****************************************************************************/
+
+FAR void *shmring_reserve(FAR struct shmring_s *ring, size_t len);
+
+/****************************************************************************
+ * Name: shmring_commit
+ *
+ * Description:
+ *   Publish the message reserved with shmring_reserve(), waking up the
+ *   consumer through "fd" if the ring was empty and the consumer is armed.
+ *   Producer only.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value if the wakeup failed.
+ *
+ ****************************************************************************/
+
+int shmring_commit(FAR struct shmring_s *ring, int fd);
+
+/****************************************************************************
+ * Name: shmring_peek
+ *
+ * Description:
+ *   Return the oldest message and its length without removing it.
+ *   Consumer only.
+ *
+ * Returned Value:
+ *   The message, or NULL if the ring is empty.
+ *
+ ****************************************************************************/
+
+FAR void *shmring_peek(FAR struct shmring_s *ring, FAR size_t *len);
+
+/****************************************************************************
+ * Name: shmring_release
+ *
+ * Description:
+ *   Remove the message returned by the last shmring_peek().  Consumer only.
+ *
+ ****************************************************************************/
+
+void shmring_release(FAR struct shmring_s *ring);
+
+/****************************************************************************
+ * Name: shmring_arm, shmring_disarm
+ *
+ * Description:
+ *   shmring_arm() asks the producer for a wakeup on the next message.  It
+ *   returns false, and stays disarmed, if a message is already there, so
+ *   the consumer must not sleep.  shmring_disarm() cancels the request
+ *   after the consumer wakes up.  Consumer only.
+ *
+ ****************************************************************************/
+
+bool shmring_arm(FAR struct shmring_s *ring);
+void shmring_disarm(FAR struct shmring_s *ring);
+
+/****************************************************************************
+ * Name: shmring_wait
+ *
+ * Description:
+ *   Sleep until the ring is not empty.  Consumer only.
+ *
+ * Input Parameters:
+ *   ring - The ring
+ *   fd   - The shm file descriptor of the shared memory object
+ *
+ * Returned Value:
+ *   Zero once a message is available; a negated errno value on failure,
+ *   e.g. -EINTR or, for a non-blocking descriptor, -EAGAIN.
+ *
+ ****************************************************************************/
+
+int shmring_wait(FAR struct shmring_s *ring, int fd);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FS_SHMFS_RING */
+#endif /* __INCLUDE_NUTTX_SHMRING_H */
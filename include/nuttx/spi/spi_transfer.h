@@ -34,6 +34,7 @@
 #include <stdbool.h>
 
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/queue.h>
 #include <nuttx/spi/spi.h>
 
 #ifdef CONFIG_SPI_EXCHANGE
@@ -114,6 +115,23 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_ASYNC
+/* This describes a sequence queued by spi_async().  The message and its
+ * sequence belong to the bus until the completion callback is called.
+ * The callback runs on the work queue with the bus locked; it may queue
+ * more messages but must not call spi_transfer() on the same bus.
+ */
+
+struct spi_message_s
+{
+  sq_entry_t node;                /* Used by the queue of the bus */
+  FAR struct spi_sequence_s *seq; /* The transfers to perform */
+  CODE void (*complete)(FAR struct spi_message_s *msg);
+  FAR void *arg;                  /* For use by the callback */
+  int result;                     /* The result of the transfers */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -163,6 +181,63 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 int spi_register(FAR struct spi_dev_s *spi, int bus);
 #endif
 
+#ifdef CONFIG_SPI_ASYNC
+/****************************************************************************
+ * Name: spi_async_initialize
+ *
+ * Description:
+ *   Create the message queue of an SPI bus.  This must be called from a
+ *   thread before the first spi_async() on the bus; more calls for the
+ *   same bus do nothing.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_async_initialize(FAR struct spi_dev_s *spi);
+
+/****************************************************************************
+ * Name: spi_async
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return without waiting.  The
+ *   messages of a bus are performed in order and back to back, each with
+ *   the chip select, mode and frequency of its own sequence.  When a
+ *   message is done, its result is set and its callback is called.  This
+ *   may be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device set up by spi_async_initialize()
+ *   msg - The message to queue
+ *
+ * Returned Value:
+ *   Zero (OK) if the message is queued; -ENODEV if the bus has no queue.
+ *
+ ****************************************************************************/
+
+int spi_async(FAR struct spi_dev_s *spi, FAR struct spi_message_s *msg);
+
+/****************************************************************************
+ * Name: spi_async_cancel
+ *
+ * Description:
+ *   Remove a message that has not been started from the queue of the bus.
+ *   Its callback is not called.
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was removed; -ENOENT if it has already been
+ *   started or is not queued.
+ *
+ ****************************************************************************/
+
+int spi_async_cancel(FAR struct spi_dev_s *spi,
+                     FAR struct spi_message_s *msg);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 #define EXTERN extern "C"
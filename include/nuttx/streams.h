@@ -820,6 +820,21 @@ int lib_sprintf(FAR struct lib_outstream_s *stream,
 int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
                  FAR const void *buf);
 
+/****************************************************************************
+ * Name: lib_bspack
+ *
+ * Description:
+ *  Pack the arguments described by 'fmt' into 'buf' in the layout that
+ *  lib_bsprintf() reads, so that the message can be formatted later.
+ *  Strings are copied into the buffer.  Returns the number of bytes used,
+ *  -E2BIG if they do not fit in 'size' bytes, or -ENOTSUP if 'fmt' uses a
+ *  conversion that cannot be replayed (%n or a "%.*s" precision).
+ *
+ ****************************************************************************/
+
+ssize_t lib_bspack(FAR void *buf, size_t size, FAR const IPTR char *fmt,
+                   va_list ap);
+
 /****************************************************************************
  * Name: lib_sprintf_internal
  *
@@ -29,6 +29,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -49,12 +51,18 @@
  *    adding or removing entries from the symbol table (realloc might be
  *    used for that purpose if needed).  The intention is to support only
  *    fixed size arrays completely defined at compilation or link time.
+ *
+ * With CONFIG_SYMTAB_ORDEREDBYHASH, each entry also holds the
+ * symtab_hash() of its name and the table is ordered by it.
  */
 
 struct symtab_s
 {
   FAR const char *sym_name;  /* A pointer to the symbol name string */
   FAR const void *sym_value; /* The value associated with the string */
+#ifdef CONFIG_SYMTAB_ORDEREDBYHASH
+  uint32_t        sym_hash;  /* symtab_hash() of sym_name */
+#endif
 };
 
 /****************************************************************************
@@ -76,8 +84,8 @@ extern "C"
  * Description:
  *   Find the symbol in the symbol table with the matching name.
  *   The implementation will be linear with respect to nsyms if
- *   CONFIG_SYMTAB_ORDEREDBYNAME is not selected, and logarithmic
- *   if it is.
+ *   CONFIG_SYMTAB_ORDEREDBYNAME or CONFIG_SYMTAB_ORDEREDBYHASH is not
+ *   selected, and logarithmic if one is.
  *
  * Returned Value:
  *   A reference to the symbol table entry if an entry with the matching
@@ -89,6 +97,37 @@ FAR const struct symtab_s *
 symtab_findbyname(FAR const struct symtab_s *symtab,
                   FAR const char *name, int nsyms);
 
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   Return the hash of a symbol name, the GNU ELF hash (h * 33 + c).
+ *   tools/mksymtab and tools/mkallsyms.py compute the same one.
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hash(FAR const char *name);
+
+/****************************************************************************
+ * Name: symtab_findbyhash
+ *
+ * Description:
+ *   Same as symtab_findbyname() with the hash of the name already known,
+ *   so that it is computed once when looking in several tables.  The name
+ *   is not decorated.  The implementation is a binary search over the
+ *   hashes if CONFIG_SYMTAB_ORDEREDBYHASH is selected, the hash is unused
+ *   otherwise.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findbyhash(FAR const struct symtab_s *symtab,
+                  FAR const char *name, uint32_t hash, int nsyms);
+
 /****************************************************************************
  * Name: symtab_findbyvalue
  *
@@ -121,6 +160,21 @@ symtab_findbyvalue(FAR const struct symtab_s *symtab,
 
 void symtab_sortbyname(FAR struct symtab_s *symtab, int nsyms);
 
+/****************************************************************************
+ * Name: symtab_sortbyhash
+ *
+ * Description:
+ *   Set the hash of each symbol and sort the symbol table by it.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYMTAB_ORDEREDBYHASH
+void symtab_sortbyhash(FAR struct symtab_s *symtab, int nsyms);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
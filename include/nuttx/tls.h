@@ -224,6 +224,9 @@ struct tls_info_s
   uint16_t tl_size;                    /* Actual size with alignments */
   int tl_errno;                        /* Per-thread error number */
   pid_t tl_tid;                        /* Thread ID */
+#ifdef CONFIG_TLS_GETPID
+  pid_t tl_pid;                        /* Process ID */
+#endif
 };
 
 /****************************************************************************
@@ -1205,6 +1205,32 @@ struct sensor_ustate_s
   uint64_t generation;         /* The recent generation of circular buffer */
 };
 
+/* This structure describes the ring of a topic shared with subscribers by
+ * mmap(), it is followed by the generation and the data of each sample at
+ * the given offsets.  A subscriber gets its cursor by SNIOC_RING_ATTACH,
+ * consumes the samples from cursor[slot] to head in place, stores the next
+ * sequence it wants back to cursor[slot], and polls for POLLIN once it has
+ * caught up with head.
+ *
+ * The sample of sequence 'seq' is at index
+ * (pos + nbuffer - (head - seq)) % nbuffer, read head, pos and head again
+ * to get a consistent pair.  The sample is intact as long as
+ * writing - seq <= nbuffer, check it again after use.
+ */
+
+struct sensor_ring_s
+{
+  uint32_t          esize;     /* The element size of the data */
+  uint32_t          nbuffer;   /* The number of samples in the ring */
+  uint32_t          nslots;    /* The number of subscriber cursors */
+  uint32_t          timing;    /* Offset of the uint32_t generations */
+  uint32_t          data;      /* Offset of the data */
+  volatile uint32_t head;      /* Sequence of the next sample published */
+  volatile uint32_t writing;   /* Head once the write in progress is done */
+  volatile uint32_t pos;       /* Index of the next sample published */
+  volatile uint32_t cursor[];  /* Next sequence wanted by each subscriber */
+};
+
 /* This structure describes the register info for the user sensor */
 
 #ifdef CONFIG_USENSOR
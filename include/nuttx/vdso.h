@@ -0,0 +1,78 @@
+/****************************************************************************
+ * include/nuttx/vdso.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_VDSO_H
+#define __INCLUDE_NUTTX_VDSO_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef CONFIG_CLOCK_VDSO
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Time data that the kernel publishes to user space.  The kernel makes
+ * vd_seq odd while it updates the other fields and even again afterwards;
+ * a reader retries until it sees the same even value before and after
+ * reading them.  vd_seq stays zero until the kernel first writes the data.
+ */
+
+struct vdso_data_s
+{
+  uint32_t        vd_seq;      /* Update sequence count */
+  clock_t         vd_ticks;    /* System timer ticks since power-up */
+  struct timespec vd_basetime; /* CLOCK_REALTIME at zero ticks */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/* The user-space instance, referenced by struct userspace_s::us_vdso */
+
+#ifndef __KERNEL__
+EXTERN struct vdso_data_s g_vdso;
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_CLOCK_VDSO */
+#endif /* __INCLUDE_NUTTX_VDSO_H */
@@ -0,0 +1,125 @@
+/****************************************************************************
+ * include/nuttx/video/dmabuf.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_VIDEO_DMABUF_H
+#define __INCLUDE_NUTTX_VIDEO_DMABUF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#include <nuttx/atomic.h>
+
+#ifdef CONFIG_VIDEO_DMABUF
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Called when the last reference of an exported buffer is gone */
+
+typedef CODE void (*dmabuf_release_t)(FAR void *arg);
+
+/* A buffer of a driver shared with other drivers and the application as a
+ * file descriptor, each open descriptor and each importer holds a
+ * reference.
+ */
+
+struct dmabuf_s
+{
+  FAR void        *addr;        /* Start of the buffer */
+  size_t           len;         /* Length of the buffer */
+  atomic_t         refs;        /* Number of references */
+  dmabuf_release_t release;     /* Called with the last reference */
+  FAR void        *arg;         /* Argument of release */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: video_dmabuf_export
+ *
+ * Description:
+ *   Export a buffer as a new file descriptor.  The descriptor can be
+ *   mmap'ed, dup'ed and passed to other drivers, the exporter must keep
+ *   the buffer until 'release' is called.
+ *
+ * Input Parameters:
+ *   addr    - Start of the buffer
+ *   len     - Length of the buffer
+ *   oflags  - Flags of the descriptor, O_RDWR, O_CLOEXEC...
+ *   release - Called when the last reference is dropped, may be NULL
+ *   arg     - Argument of release
+ *
+ * Returned Value:
+ *   The new file descriptor on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int video_dmabuf_export(FAR void *addr, size_t len, int oflags,
+                        dmabuf_release_t release, FAR void *arg);
+
+/****************************************************************************
+ * Name: video_dmabuf_get
+ *
+ * Description:
+ *   Take a reference of the buffer behind a descriptor, so an importer
+ *   can keep using it after the descriptor is closed.
+ *
+ * Returned Value:
+ *   The buffer on success; NULL if 'fd' is not an exported buffer.
+ *
+ ****************************************************************************/
+
+FAR struct dmabuf_s *video_dmabuf_get(int fd);
+
+/****************************************************************************
+ * Name: video_dmabuf_put
+ *
+ * Description:
+ *   Drop a reference taken by video_dmabuf_get().
+ *
+ ****************************************************************************/
+
+void video_dmabuf_put(FAR struct dmabuf_s *buf);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_VIDEO_DMABUF */
+#endif /* __INCLUDE_NUTTX_VIDEO_DMABUF_H */
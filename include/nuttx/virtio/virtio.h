@@ -37,6 +37,20 @@
 
 #include <openamp/open_amp.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The ring features offered by drivers that rearm their callbacks after
+ * each batch of used buffers, as VIRTIO_RING_F_EVENT_IDX requires.
+ */
+
+#ifdef CONFIG_DRIVERS_VIRTIO_EVENT_IDX
+#  define VIRTIO_RING_FEATURES VIRTIO_RING_F_EVENT_IDX
+#else
+#  define VIRTIO_RING_FEATURES 0
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -255,6 +255,16 @@ struct work_s
   FAR void        *arg;    /* Callback argument */
 };
 
+/* Describes one work queued by work_queue_batch() */
+
+struct work_batch_s
+{
+  FAR struct work_s *work;   /* The work structure to queue */
+  worker_t           worker; /* Work callback */
+  FAR void          *arg;    /* Callback argument */
+  clock_t            delay;  /* Delay in clock ticks, zero for immediate */
+};
+
 /* This is an enumeration of the various events that may be
  * notified via work_notifier_signal().
  */
@@ -442,6 +452,34 @@ int work_queue_next_wq(FAR struct kwork_wqueue_s *wqueue,
                        FAR struct work_s *work, worker_t worker,
                        FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_queue_batch/work_queue_batch_wq
+ *
+ * Description:
+ *   Queue several works at once.  Each entry of the batch behaves as a
+ *   work_queue() call, but the wqueue lock is taken only once and the
+ *   worker threads are woken up with a single reschedule.  This is
+ *   intended for drivers that queue bursts of work, e.g. on each packet
+ *   or sensor event.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue - The work queue handle
+ *   batch  - The array of works to queue
+ *   nitems - The number of entries in batch
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure.  Nothing is queued if
+ *   any entry is invalid.
+ *
+ ****************************************************************************/
+
+int work_queue_batch(int qid, FAR const struct work_batch_s *batch,
+                     size_t nitems);
+int work_queue_batch_wq(FAR struct kwork_wqueue_s *wqueue,
+                        FAR const struct work_batch_s *batch,
+                        size_t nitems);
+
 /****************************************************************************
  * Name: work_queue_pri
  *
@@ -272,6 +272,9 @@ struct pthread_cond_s
   sem_t sem;
   clockid_t clockid;
   int wait_count;
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+  FAR struct pthread_mutex_s *mutex; /* The mutex of the last waiter */
+#endif
 };
 
 #ifndef __PTHREAD_COND_T_DEFINED
@@ -389,10 +392,16 @@ typedef struct pthread_barrierattr_s pthread_barrierattr_t;
 
 struct pthread_barrier_s
 {
+#ifdef CONFIG_FUTEX
+  uint32_t     seq;          /* Futex word, bumped each time the barrier trips */
+#else
   sem_t        sem;
+#endif
   unsigned int count;
   unsigned int wait_count;
+#ifndef CONFIG_FUTEX
   mutex_t      mutex;
+#endif
 };
 
 #ifndef __PTHREAD_BARRIER_T_DEFINED
@@ -50,6 +50,7 @@
 #define SCHED_SPORADIC            3  /* Sporadic scheduling policy */
 #define SCHED_BATCH               4  /* Batch scheduling policy */
 #define SCHED_IDLE                5  /* Idle scheduling policy */
+#define SCHED_DEADLINE            6  /* Earliest deadline first policy */
 
 /* Maximum number of SCHED_SPORADIC replenishments */
 
@@ -201,6 +202,12 @@ struct sched_param
   int sched_ss_max_repl;                /* Maximum pending replenishments for
                                          * sporadic server. */
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  struct timespec sched_dl_runtime;     /* Execution budget per period */
+  struct timespec sched_dl_deadline;    /* Deadline relative to the release */
+  struct timespec sched_dl_period;      /* Release period */
+#endif
 };
 
 /****************************************************************************
@@ -37,6 +37,8 @@
 
 #define BLKSSZGET  BIOC_BLKSSZGET
 #define BLKGETSIZE BIOC_BLKGETSIZE
+#define BLKDISCARD BIOC_BLKDISCARD
+#define BLKZEROOUT BIOC_BLKZEROOUT
 
 /* Mount flags */
 
@@ -30,6 +30,7 @@
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <stdint.h>
+#include <time.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -136,10 +137,17 @@
 #define MSG_ERRQUEUE     0x002000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL     0x004000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE         0x008000 /* Sender will send more.  */
+#define MSG_WAITFORONE   0x010000 /* recvmmsg(): block until 1+ packets
+                                   * avail.
+                                   */
 #define MSG_CMSG_CLOEXEC 0x100000 /* Set close_on_exit for file
                                    * descriptor received through SCM_RIGHTS.
                                    */
 
+/* Send from the user buffer without copying it (see SO_ZEROCOPY) */
+
+#define MSG_ZEROCOPY     0x4000000
+
 /* Protocol levels supported by get/setsockopt(): */
 
 #define SOL_SOCKET       1 /* Only socket-level options supported */
@@ -220,9 +228,24 @@
 #define SO_PEERCRED     18 /* Return the credentials of the peer process
                             * connected to this socket.
                             */
+#define SO_REUSEPORT    19 /* Allow sockets to bind to the same address and
+                            * port and spread the incoming traffic over them
+                            * (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
 #define SO_TIMESTAMPNS  20 /* Generates a timestamp in ns for each incoming packet
                             * arg: integer value
                             */
+#define SO_ZEROCOPY     21 /* Allow MSG_ZEROCOPY sends, whose completions are
+                            * read back with MSG_ERRQUEUE (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
+#define SO_TIMESTAMPING 22 /* Select which receive and transmit timestamps
+                            * are generated and reported (get/set).
+                            * arg: integer of SOF_TIMESTAMPING_* flags
+                            */
 
 /* The options are unsupported but included for compatibility
  * and portability
@@ -253,6 +276,41 @@
 
 #define __SO_PROTOCOL  16
 
+/* Values of sock_extended_err::ee_origin and ee_code */
+
+#define SO_EE_ORIGIN_NONE          0
+#define SO_EE_ORIGIN_LOCAL         1
+#define SO_EE_ORIGIN_ICMP          2
+#define SO_EE_ORIGIN_ICMP6         3
+#define SO_EE_ORIGIN_TIMESTAMPING  4
+#define SO_EE_ORIGIN_ZEROCOPY      5
+
+#define SO_EE_CODE_ZEROCOPY_COPIED 1 /* Data was copied, not sent in place */
+
+/* Flags for SO_TIMESTAMPING (same values as Linux).  The generation flags
+ * select which timestamps are taken, the reporting flags select which of
+ * them are returned in the SCM_TIMESTAMPING control message.
+ */
+
+#define SOF_TIMESTAMPING_TX_HARDWARE  (1 << 0)
+#define SOF_TIMESTAMPING_TX_SOFTWARE  (1 << 1)
+#define SOF_TIMESTAMPING_RX_HARDWARE  (1 << 2)
+#define SOF_TIMESTAMPING_RX_SOFTWARE  (1 << 3)
+#define SOF_TIMESTAMPING_SOFTWARE     (1 << 4)
+#define SOF_TIMESTAMPING_SYS_HARDWARE (1 << 5)
+#define SOF_TIMESTAMPING_RAW_HARDWARE (1 << 6)
+#define SOF_TIMESTAMPING_OPT_ID       (1 << 7)
+#define SOF_TIMESTAMPING_OPT_TSONLY   (1 << 11)
+
+#define SOF_TIMESTAMPING_TX_MASK \
+  (SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_TX_SOFTWARE)
+#define SOF_TIMESTAMPING_RX_MASK \
+  (SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RX_SOFTWARE)
+
+/* Value of sock_extended_err::ee_info for SO_EE_ORIGIN_TIMESTAMPING */
+
+#define SCM_TSTAMP_SND             0 /* Packet left the device */
+
 /* Values for the 'how' argument of shutdown() */
 
 #define SHUT_RD         1 /* Bit 0: Disables further receive operations */
@@ -301,6 +359,7 @@
 #define SCM_CREDENTIALS 0x02    /* rw: struct ucred */
 #define SCM_SECURITY    0x03    /* rw: security label */
 #define SCM_TIMESTAMP   SO_TIMESTAMP
+#define SCM_TIMESTAMPING SO_TIMESTAMPING
 
 /* Desired design of maximum size and alignment (see RFC2553) */
 
@@ -377,6 +436,14 @@ struct msghdr
   unsigned int msg_flags;
 };
 
+/* Used with sendmmsg() and recvmmsg() */
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;        /* Message header */
+  unsigned int msg_len;         /* Number of bytes transferred */
+};
+
 struct cmsghdr
 {
   unsigned long cmsg_len;       /* Data byte count, including hdr */
@@ -391,6 +458,32 @@ struct ucred
   gid_t gid;
 };
 
+/* Returned in the IP_RECVERR/IPV6_RECVERR control message by recvmsg()
+ * with MSG_ERRQUEUE.  For SO_EE_ORIGIN_ZEROCOPY, ee_info..ee_data is the
+ * range of MSG_ZEROCOPY sends whose buffers may be reused.
+ */
+
+struct sock_extended_err
+{
+  uint32_t ee_errno;            /* Error number */
+  uint8_t  ee_origin;           /* Where the error originated */
+  uint8_t  ee_type;             /* Type */
+  uint8_t  ee_code;             /* Code */
+  uint8_t  ee_pad;              /* Padding */
+  uint32_t ee_info;             /* Additional information */
+  uint32_t ee_data;             /* Other data */
+};
+
+/* Payload of the SCM_TIMESTAMPING control message.  ts[0] holds the
+ * software timestamp, ts[2] the raw hardware timestamp; ts[1] is unused
+ * and kept for Linux compatibility.  Unset entries are zero.
+ */
+
+struct scm_timestamping
+{
+  struct timespec ts[3];
+};
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
@@ -464,6 +557,12 @@ int getpeername(int sockfd, FAR struct sockaddr *addr,
 ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags);
 
+struct timespec;
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 #if CONFIG_FORTIFY_SOURCE > 0
 fortify_function(send) ssize_t send(int sockfd, FAR const void *buf,
                                     size_t len, int flags)
@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #ifndef __ASSEMBLY__
+#  include <sys/types.h>
 #  include <stdint.h>
 #endif
 
@@ -66,6 +67,23 @@ enum
 #  undef SYSCALL_LOOKUP
 };
 
+#ifdef CONFIG_LIB_SYSCALL_BATCH
+
+/* One entry of a batched system call request.  The caller fills in 'nbr'
+ * and 'parm'; syscall_batch() fills in 'ret' and 'errcode', the errno
+ * value set by the call (zero if it did not set one).
+ */
+
+struct syscall_batch_s
+{
+  unsigned int nbr;                    /* System call number (SYS_xxx) */
+  uintptr_t parm[6];                   /* System call parameters */
+  uintptr_t ret;                       /* Returned value */
+  int errcode;                         /* errno value after the call */
+};
+
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -88,6 +106,12 @@ extern "C"
 
 EXTERN const uintptr_t g_stublookup[SYS_nsyscalls];
 
+/* Given the system call number, the corresponding entry in this table
+ * provides the number of parameters taken by the stub function.
+ */
+
+EXTERN const uint8_t g_stubnparms[SYS_nsyscalls];
+
 #endif
 
 /* Given the system call number, the corresponding entry in this table
@@ -100,6 +124,42 @@ EXTERN const char *g_funcnames[SYS_nsyscalls];
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: syscall_dispatch
+ *
+ * Description:
+ *   Call the stub function for system call 'nbr' with only as many of the
+ *   parameters in 'parm' as the stub takes.  Kernel phase only.
+ *
+ ****************************************************************************/
+
+uintptr_t syscall_dispatch(unsigned int nbr, FAR const uintptr_t *parm);
+
+#ifdef CONFIG_LIB_SYSCALL_BATCH
+
+/****************************************************************************
+ * Name: syscall_batch
+ *
+ * Description:
+ *   Execute 'ncalls' system calls described by the array 'calls' with a
+ *   single trap into the kernel.  The calls are made in order and all of
+ *   them are made, regardless of the result of the previous one.
+ *
+ * Input Parameters:
+ *   calls  - The array of system call requests
+ *   ncalls - The number of entries in 'calls'
+ *
+ * Returned Value:
+ *   The number of calls executed on success; -1 with errno set to EINVAL
+ *   if 'calls' is NULL or any entry holds an invalid system call number
+ *   (no call is executed in that case).
+ *
+ ****************************************************************************/
+
+int syscall_batch(FAR struct syscall_batch_s *calls, size_t ncalls);
+
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -28,9 +28,12 @@
 
 SYSCALL_LOOKUP1(_exit,                     1)
 SYSCALL_LOOKUP(_assert,                    4)
-SYSCALL_LOOKUP(getpid,                     0)
 SYSCALL_LOOKUP(prctl,                      2)
 
+#ifndef CONFIG_TLS_GETPID
+  SYSCALL_LOOKUP(getpid,                   0)
+#endif
+
 #ifdef CONFIG_SCHED_HAVE_PARENT
   SYSCALL_LOOKUP(getppid,                  0)
 #endif
@@ -93,6 +96,13 @@ SYSCALL_LOOKUP(nxsem_wait_slow,            1)
   SYSCALL_LOOKUP(nxsem_getprioceiling,     2)
 #endif
 
+/* Futexes */
+
+#ifdef CONFIG_FUTEX
+  SYSCALL_LOOKUP(nxfutex_wait,             4)
+  SYSCALL_LOOKUP(nxfutex_wake,             2)
+#endif
+
 /* Named semaphores */
 
 #ifdef CONFIG_FS_NAMED_SEMAPHORES
@@ -168,7 +178,11 @@ SYSCALL_LOOKUP(clock_nanosleep,            4)
  */
 
 SYSCALL_LOOKUP(clock,                      0)
-SYSCALL_LOOKUP(clock_gettime,              2)
+#ifdef CONFIG_CLOCK_VDSO
+  SYSCALL_LOOKUP(nxclock_gettime,          2)
+#else
+  SYSCALL_LOOKUP(clock_gettime,            2)
+#endif
 SYSCALL_LOOKUP(clock_settime,              2)
 #ifdef CONFIG_CLOCK_ADJTIME
   SYSCALL_LOOKUP(clock_adjtime,            2)
@@ -226,6 +240,10 @@ SYSCALL_LOOKUP(pwrite,                     4)
 #ifdef CONFIG_SIGNAL_FD
   SYSCALL_LOOKUP(signalfd,                 3)
 #endif
+#ifdef CONFIG_FS_URING
+  SYSCALL_LOOKUP(uring_setup,              2)
+  SYSCALL_LOOKUP(uring_enter,              4)
+#endif
 
 /* Board support */
 
@@ -277,6 +295,11 @@ SYSCALL_LOOKUP(munmap,                     2)
   SYSCALL_LOOKUP(nx_mkfifo,                3)
 #endif
 
+#ifdef CONFIG_PIPES
+  SYSCALL_LOOKUP(splice,                   6)
+  SYSCALL_LOOKUP(tee,                      4)
+#endif
+
 #ifndef CONFIG_DISABLE_MOUNTPOINT
   SYSCALL_LOOKUP(mount,                    5)
   SYSCALL_LOOKUP(mkdir,                    2)
@@ -377,9 +400,11 @@ SYSCALL_LOOKUP(munmap,                     2)
   SYSCALL_LOOKUP(recv,                     4)
   SYSCALL_LOOKUP(recvfrom,                 6)
   SYSCALL_LOOKUP(recvmsg,                  3)
+  SYSCALL_LOOKUP(recvmmsg,                 5)
   SYSCALL_LOOKUP(send,                     4)
   SYSCALL_LOOKUP(sendto,                   6)
   SYSCALL_LOOKUP(sendmsg,                  3)
+  SYSCALL_LOOKUP(sendmmsg,                 4)
   SYSCALL_LOOKUP(setsockopt,               5)
   SYSCALL_LOOKUP(shutdown,                 2)
   SYSCALL_LOOKUP(socket,                   3)
@@ -406,3 +431,9 @@ SYSCALL_LOOKUP(settimeofday,               2)
 /* ANSI C signal handling */
 
 SYSCALL_LOOKUP(signal,                     2)
+
+/* Batched system calls */
+
+#ifdef CONFIG_LIB_SYSCALL_BATCH
+  SYSCALL_LOOKUP(syscall_batch,            2)
+#endif
@@ -0,0 +1,185 @@
+/****************************************************************************
+ * include/sys/uring.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_URING_H
+#define __INCLUDE_SYS_URING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <fcntl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* uring_setup() flags */
+
+#define URING_SETUP_CLOEXEC     O_CLOEXEC
+
+/* uring_enter() flags */
+
+#define URING_ENTER_GETEVENTS   (1 << 0) /* Wait for min_complete completions */
+
+/* Operations of struct uring_sqe */
+
+#define URING_OP_NOP            0  /* Complete with res 0 */
+#define URING_OP_READ           1  /* read() or pread() into addr, len bytes */
+#define URING_OP_WRITE          2  /* write() or pwrite() from addr, len bytes */
+#define URING_OP_READV          3  /* readv() into the len iovecs at addr */
+#define URING_OP_SEND           4  /* send(), opflags holds the MSG_* flags */
+#define URING_OP_RECV           5  /* recv(), opflags holds the MSG_* flags */
+#define URING_OP_ACCEPT         6  /* accept4(), addr and addr2 give the peer
+                                    * address and its length, opflags holds
+                                    * the SOCK_* flags; res is the new fd */
+#define URING_OP_POLL_ADD       7  /* Wait for the poll events in opflags;
+                                    * res is the returned event set */
+#define URING_OP_FSYNC          8  /* fsync() */
+#define URING_OP_LAST           URING_OP_FSYNC
+
+/****************************************************************************
+ * Public Type Declarations
+ ****************************************************************************/
+
+/* A submission queue entry.  Entries are filled in by the application and
+ * copied by the kernel when they are submitted, so they may be reused as
+ * soon as uring_enter() returns.  The buffers they point to must stay
+ * valid until the operation completes.
+ */
+
+struct uring_sqe
+{
+  uint8_t        opcode;    /* URING_OP_* */
+  uint8_t        reserved[3];
+  int32_t        fd;        /* File descriptor the operation applies to */
+  uint32_t       opflags;   /* Operation specific flags, see URING_OP_* */
+  uint32_t       len;       /* Buffer length or number of iovecs */
+  off_t          off;       /* File offset, -1 for the current position */
+  FAR void      *addr;      /* Buffer, iovec array or peer address */
+  FAR void      *addr2;     /* URING_OP_ACCEPT: FAR socklen_t * */
+  uint64_t       user_data; /* Returned unchanged in the completion */
+};
+
+/* A completion queue entry */
+
+struct uring_cqe
+{
+  uint64_t       user_data; /* user_data of the submission */
+  int32_t        res;       /* Result, or a negated errno value */
+  uint32_t       flags;     /* Reserved, zero */
+};
+
+/* The submission queue.  The application fills sqes[tail & mask] and then
+ * advances tail; the kernel advances head as it consumes entries.  Both
+ * indices run freely and wrap around at 2^32.
+ */
+
+struct uring_sq
+{
+  volatile uint32_t     head;     /* Next entry consumed by the kernel */
+  volatile uint32_t     tail;     /* Next entry filled by the application */
+  uint32_t              mask;     /* Number of entries minus one */
+  uint32_t              reserved;
+  FAR struct uring_sqe *sqes;     /* The entries */
+};
+
+/* The completion queue.  The kernel fills cqes[tail & mask] and then
+ * advances tail; the application advances head as it consumes entries.
+ * Completions that find the queue full are counted in overflow and lost.
+ */
+
+struct uring_cq
+{
+  volatile uint32_t     head;     /* Next entry consumed by the application */
+  volatile uint32_t     tail;     /* Next entry filled by the kernel */
+  uint32_t              mask;     /* Number of entries minus one */
+  volatile uint32_t     overflow; /* Number of lost completions */
+  FAR struct uring_cqe *cqes;     /* The entries */
+};
+
+/* Parameters of uring_setup() */
+
+struct uring_params
+{
+  uint32_t             sq_entries;  /* OUT: Size of the submission queue */
+  uint32_t             cq_entries;  /* OUT: Size of the completion queue */
+  uint32_t             flags;       /* IN:  URING_SETUP_* */
+  FAR struct uring_sq *sq;          /* OUT: The submission queue */
+  FAR struct uring_cq *cq;          /* OUT: The completion queue */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: uring_setup
+ *
+ * Description:
+ *   Create a submission/completion ring pair with room for at least
+ *   'entries' submissions and twice as many completions.  The queues live
+ *   in memory shared with the application and are described in 'params'.
+ *   They are released when the returned file descriptor is closed.
+ *
+ * Returned Value:
+ *   A file descriptor that can be passed to uring_enter() and polled for
+ *   POLLIN while completions are pending; -1 with errno set on failure.
+ *
+ ****************************************************************************/
+
+int uring_setup(unsigned int entries, FAR struct uring_params *params);
+
+/****************************************************************************
+ * Name: uring_enter
+ *
+ * Description:
+ *   Submit up to 'to_submit' entries of the submission queue.  The
+ *   operations are carried out in batches by a kernel worker.  With
+ *   URING_ENTER_GETEVENTS, then wait until at least 'min_complete'
+ *   completions are pending.
+ *
+ * Returned Value:
+ *   The number of entries consumed from the submission queue; -1 with
+ *   errno set on failure.
+ *
+ ****************************************************************************/
+
+int uring_enter(int fd, unsigned int to_submit, unsigned int min_complete,
+                unsigned int flags);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_SYS_URING_H */
@@ -808,6 +808,25 @@ typedef struct v4l2_buffer v4l2_buffer_t;
 
 #define V4L2_BUF_FLAG_LAST                      0x00100000
 
+/* struct v4l2_exportbuffer
+ * Parameter of ioctl(VIDIOC_EXPBUF).  The buffer of 'index', allocated by
+ * VIDIOC_REQBUFS with V4L2_MEMORY_MMAP, is returned as a file descriptor
+ * in 'fd', which can be mmap'ed or queued to another device with
+ * V4L2_MEMORY_DMABUF.
+ */
+
+struct v4l2_exportbuffer
+{
+  uint32_t type;         /* enum #v4l2_buf_type */
+  uint32_t index;        /* Buffer id */
+  uint32_t plane;        /* Plane index, only 0 is supported */
+  uint32_t flags;        /* Flags of the new fd, O_CLOEXEC, O_RDWR... */
+  int32_t  fd;           /* Driver sets the exported file descriptor */
+  uint32_t reserved[11];
+};
+
+typedef struct v4l2_exportbuffer v4l2_exportbuffer_t;
+
 struct v4l2_fmtdesc
 {
   uint16_t index;                           /* Format number      */
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/ioctl.h>
 #include <sys/stat.h>
 
 #include <stdint.h>
@@ -35,6 +36,7 @@
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/lib/elf.h>
 
 #include "elf/elf.h"
@@ -76,6 +78,17 @@ static inline int libelf_fileinfo(FAR struct mod_loadinfo_s *loadinfo)
   loadinfo->fileuid  = buf.st_uid;
   loadinfo->filegid  = buf.st_gid;
   loadinfo->filemode = buf.st_mode;
+
+#ifdef CONFIG_LIBC_ELF_MAPPED_READ
+  /* Read from the mapping of the file if the file system has one */
+
+  if (ioctl(loadinfo->filfd, FIOC_XIPBASE,
+            (unsigned long)&loadinfo->filebase) < 0)
+    {
+      loadinfo->filebase = 0;
+    }
+#endif
+
   return OK;
 }
 
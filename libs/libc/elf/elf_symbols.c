@@ -55,6 +55,7 @@
 struct mod_exportinfo_s
 {
   FAR const char *name;              /* Symbol name to find */
+  uint32_t hash;                     /* symtab_hash() of the name */
   FAR struct module_s *modp;         /* The module that needs the symbol */
   FAR const struct symtab_s *symbol; /* Symbol info returned (if found) */
 };
@@ -203,8 +204,8 @@ static int libelf_symcallback(FAR struct module_s *modp, FAR void *arg)
 
   /* Check if this module exports a symbol of that name */
 
-  exportinfo->symbol = symtab_findbyname(modp->modinfo.exports,
-                                         exportinfo->name,
+  exportinfo->symbol = symtab_findbyhash(modp->modinfo.exports,
+                                         exportinfo->name, exportinfo->hash,
                                          modp->modinfo.nexports);
 
   if (exportinfo->symbol != NULL)
@@ -392,6 +393,23 @@ int libelf_symvalue(FAR struct module_s *modp,
         exportinfo.modp   = modp;
         exportinfo.symbol = NULL;
 
+        /* Hash the name once for all of the symbol tables searched, as
+         * symtab_findbyname() would.
+         */
+
+#ifdef CONFIG_SYMTAB_DECORATED
+        if (exportinfo.name[0] == '_')
+          {
+            exportinfo.name++;
+          }
+#endif
+
+#ifdef CONFIG_SYMTAB_ORDEREDBYHASH
+        exportinfo.hash   = symtab_hash(exportinfo.name);
+#else
+        exportinfo.hash   = 0;
+#endif
+
         ret = libelf_registry_foreach(libelf_symcallback,
                                       (FAR void *)&exportinfo);
         if (ret < 0)
@@ -408,8 +426,8 @@ int libelf_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
-            symbol = symtab_findbyname(exports, exportinfo.name,
-                                       nexports);
+            symbol = symtab_findbyhash(exports, exportinfo.name,
+                                       exportinfo.hash, nexports);
           }
 
         /* Was the symbol found from any exporter? */
@@ -542,8 +560,10 @@ int libelf_insertsymtab(FAR struct module_s *modp,
                 }
             }
 
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+#if defined(CONFIG_SYMTAB_ORDEREDBYNAME)
           symtab_sortbyname(symbol, symcount);
+#elif defined(CONFIG_SYMTAB_ORDEREDBYHASH)
+          symtab_sortbyhash(symbol, symcount);
 #endif
         }
       else
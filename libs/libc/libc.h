@@ -55,6 +55,13 @@
 #  define CONFIG_LIBC_HOMEDIR "/"
 #endif
 
+/* Range of g_pow10_significand[], enough for the shortest printing and the
+ * parsing of any double.
+ */
+
+#define LIB_POW10_MIN (-342)
+#define LIB_POW10_MAX 324
+
 #if ((!defined(CONFIG_LIBC_PREVENT_MEMCHR_USER) && !defined(__KERNEL__))  || \
      (!defined(CONFIG_LIBC_PREVENT_MEMCHR_KERNEL) && defined(__KERNEL__)))
 #  define LIBC_BUILD_MEMCHR
@@ -180,6 +187,13 @@ extern "C"
 #define EXTERN extern
 #endif
 
+/* Defined in lib_pow10tab.c */
+
+#ifdef CONFIG_LIBC_FAST_FLOAT
+EXTERN const uint64_t
+g_pow10_significand[LIB_POW10_MAX - LIB_POW10_MIN + 1][2];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -29,6 +29,7 @@
 #include <unistd.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/random.h>
 
 /****************************************************************************
  * Public Functions
@@ -67,6 +68,19 @@ ssize_t getrandom(FAR void *bytes, size_t nbytes, unsigned int flags)
   int fd;
   ssize_t ret;
 
+  /* /dev/urandom only reads the entropy pool, which the kernel can call
+   * without opening the device.
+   */
+
+#if defined(CONFIG_DEV_URANDOM_RANDOM_POOL) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+  if ((flags & GRND_RANDOM) == 0)
+    {
+      up_rngbuf(bytes, nbytes);
+      return nbytes;
+    }
+#endif
+
   if ((flags & GRND_NONBLOCK) != 0)
     {
       oflags |= O_NONBLOCK;
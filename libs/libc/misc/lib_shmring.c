@@ -0,0 +1,237 @@
+/****************************************************************************
+ * libs/libc/misc/lib_shmring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The head, the tail and the "waiting" flag must be ordered with full
+ * barriers for the wakeup to be reliable: the producer stores the head and
+ * then loads the tail and the flag, while the consumer stores the tail or
+ * the flag and then loads the head.  With a barrier on both sides at least
+ * one of them sees the other's store, so either the producer sends the
+ * wakeup or the consumer finds the message and does not sleep.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/shmring.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Set in the length of the filler that skips the end of the data area */
+
+#define SHMRING_PAD       0x80000000u
+
+#define SHMRING_MAXSIZE   0x40000000u
+
+#define shmring_mb()      __sync_synchronize()
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline FAR uint32_t *shmring_hdr(FAR struct shmring_s *ring,
+                                        uint32_t index)
+{
+  return (FAR uint32_t *)&ring->data[index & (ring->size - 1)];
+}
+
+static inline uint32_t shmring_msgsize(uint32_t len)
+{
+  return ALIGN_UP(SHMRING_HDRLEN + len, SHMRING_HDRLEN);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int shmring_init(FAR struct shmring_s *ring, size_t length)
+{
+  size_t size;
+
+  if (ring == NULL || length < SHMRING_MINSIZE)
+    {
+      return -EINVAL;
+    }
+
+  length -= offsetof(struct shmring_s, data);
+  size    = SHMRING_HDRLEN;
+  while (size * 2 <= length && size < SHMRING_MAXSIZE)
+    {
+      size *= 2;
+    }
+
+  ring->size     = size;
+  ring->reserved = 0;
+  atomic_set(&ring->head, 0);
+  atomic_set(&ring->tail, 0);
+  atomic_set(&ring->waiting, 0);
+
+  shmring_mb();
+  ring->magic = SHMRING_MAGIC;
+  return OK;
+}
+
+FAR void *shmring_reserve(FAR struct shmring_s *ring, size_t len)
+{
+  uint32_t head = atomic_read(&ring->head);
+  uint32_t tail = atomic_read_acquire(&ring->tail);
+  uint32_t contig = ring->size - (head & (ring->size - 1));
+  uint32_t need;
+  uint32_t pos = head;
+
+  DEBUGASSERT(ring->magic == SHMRING_MAGIC);
+
+  if (len > ring->size - SHMRING_HDRLEN)
+    {
+      return NULL;
+    }
+
+  need = shmring_msgsize(len);
+  if (need > contig)
+    {
+      /* The message does not fit before the end of the data area, fill
+       * the rest of it and start over at the beginning.
+       */
+
+      pos = head + contig;
+    }
+
+  if (pos + need - tail > ring->size)
+    {
+      return NULL;
+    }
+
+  if (pos != head)
+    {
+      *shmring_hdr(ring, head) = SHMRING_PAD;
+    }
+
+  *shmring_hdr(ring, pos) = len;
+  ring->reserved = pos + need;
+  return (FAR uint8_t *)shmring_hdr(ring, pos) + SHMRING_HDRLEN;
+}
+
+int shmring_commit(FAR struct shmring_s *ring, int fd)
+{
+  uint32_t head = atomic_read(&ring->head);
+
+  atomic_set_release(&ring->head, ring->reserved);
+  shmring_mb();
+
+  /* Only the empty to non-empty transition can find the consumer asleep */
+
+  if ((uint32_t)atomic_read(&ring->tail) == head &&
+      atomic_read(&ring->waiting) != 0)
+    {
+      if (ioctl(fd, FIOC_RINGNOTIFY, 0) < 0)
+        {
+          return -get_errno();
+        }
+    }
+
+  return OK;
+}
+
+FAR void *shmring_peek(FAR struct shmring_s *ring, FAR size_t *len)
+{
+  uint32_t tail = atomic_read(&ring->tail);
+  uint32_t head = atomic_read_acquire(&ring->head);
+  FAR uint32_t *hdr;
+
+  DEBUGASSERT(ring->magic == SHMRING_MAGIC && len != NULL);
+
+  if (tail == head)
+    {
+      return NULL;
+    }
+
+  hdr = shmring_hdr(ring, tail);
+  if (*hdr == SHMRING_PAD)
+    {
+      /* Skip the filler, the message is at the beginning */
+
+      tail += ring->size - (tail & (ring->size - 1));
+      atomic_set_release(&ring->tail, tail);
+      hdr = shmring_hdr(ring, tail);
+    }
+
+  *len = *hdr;
+  return (FAR uint8_t *)hdr + SHMRING_HDRLEN;
+}
+
+void shmring_release(FAR struct shmring_s *ring)
+{
+  uint32_t tail = atomic_read(&ring->tail);
+
+  DEBUGASSERT(tail != (uint32_t)atomic_read(&ring->head));
+
+  tail += shmring_msgsize(*shmring_hdr(ring, tail));
+  atomic_set_release(&ring->tail, tail);
+}
+
+bool shmring_arm(FAR struct shmring_s *ring)
+{
+  atomic_set(&ring->waiting, 1);
+  shmring_mb();
+
+  if ((uint32_t)atomic_read(&ring->tail) !=
+      (uint32_t)atomic_read(&ring->head))
+    {
+      atomic_set(&ring->waiting, 0);
+      return false;
+    }
+
+  return true;
+}
+
+void shmring_disarm(FAR struct shmring_s *ring)
+{
+  atomic_set(&ring->waiting, 0);
+}
+
+int shmring_wait(FAR struct shmring_s *ring, int fd)
+{
+  int ret = OK;
+
+  /* Stale wakeups may only return early, so check the ring again */
+
+  while (shmring_arm(ring))
+    {
+      ret = ioctl(fd, FIOC_RINGWAIT, 0);
+      shmring_disarm(ring);
+      if (ret < 0)
+        {
+          return -get_errno();
+        }
+    }
+
+  return ret;
+}
@@ -59,6 +59,10 @@
 #  define CONFIG_NETDB_DNSCLIENT_LIFESEC 3600
 #endif
 
+#ifndef CONFIG_NETDB_DNSCLIENT_NEGLIFESEC
+#  define CONFIG_NETDB_DNSCLIENT_NEGLIFESEC 0
+#endif
+
 #ifndef CONFIG_NETDB_RESOLVCONF_PATH
 #  define CONFIG_NETDB_RESOLVCONF_PATH "/etc/resolv.conf"
 #endif
@@ -154,6 +158,16 @@ void dns_breaklock(FAR unsigned int *count);
 
 void dns_restorelock(unsigned int count);
 
+/****************************************************************************
+ * Name: dns_get_timeout
+ *
+ * Description:
+ *   Return the timeout in seconds of a query after 'retry_count' retries.
+ *
+ ****************************************************************************/
+
+int dns_get_timeout(int retry_count);
+
 /****************************************************************************
  * Name: dns_bind
  *
@@ -223,7 +237,7 @@ bool dns_is_queryfamily(sa_family_t family);
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses, zero if the name has none.
  *   ttl      - The TTL of the IP addresses.
  *
  * Returned Value:
@@ -270,7 +284,8 @@ void dns_clear_answer(void);
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
  *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   was not found in the cache, or -EADDRNOTAVAIL meaning that the cache
+ *   knows that the hostname has no address.
  *
  ****************************************************************************/
 
@@ -47,6 +47,34 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: dns_get_timeout
+ *
+ * Description:
+ *   Return the timeout of a query in seconds, it grows with the retries:
+ *   base timeout * 2^retry_count, capped to the configured maximum.
+ *
+ ****************************************************************************/
+
+int dns_get_timeout(int retry_count)
+{
+  int timeout_sec = CONFIG_NETDB_DNSCLIENT_RECV_TIMEOUT;
+
+  if (retry_count > 0)
+    {
+      /* Apply exponential backoff with configurable maximum */
+
+      timeout_sec = timeout_sec << retry_count;
+      if (CONFIG_NETDB_DNSCLIENT_MAX_TIMEOUT > 0 &&
+          timeout_sec > CONFIG_NETDB_DNSCLIENT_MAX_TIMEOUT)
+        {
+          timeout_sec = CONFIG_NETDB_DNSCLIENT_MAX_TIMEOUT;
+        }
+    }
+
+  return timeout_sec;
+}
+
 /****************************************************************************
  * Name: dns_bind
  *
@@ -76,18 +104,7 @@ int dns_bind(sa_family_t family, bool stream, int retry_count)
    * For retry_count 0: base timeout, 1: base*2, 2: base*4, etc.
    */
 
-  timeout_sec = CONFIG_NETDB_DNSCLIENT_RECV_TIMEOUT;
-  if (retry_count > 0)
-    {
-      /* Apply exponential backoff with configurable maximum */
-
-      timeout_sec = timeout_sec << retry_count;
-      if (CONFIG_NETDB_DNSCLIENT_MAX_TIMEOUT > 0 &&
-          timeout_sec > CONFIG_NETDB_DNSCLIENT_MAX_TIMEOUT)
-        {
-          timeout_sec = CONFIG_NETDB_DNSCLIENT_MAX_TIMEOUT;
-        }
-    }
+  timeout_sec = dns_get_timeout(retry_count);
 
   /* Create a new socket */
 
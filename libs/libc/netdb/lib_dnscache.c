@@ -38,11 +38,22 @@
 
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The entries are chained in one bucket per entry, the links hold the
+ * index of the next entry plus one so that zero ends a chain.
+ */
+
+#define DNS_CACHE_NBUCKETS CONFIG_NETDB_DNSCLIENT_ENTRIES
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* This described one entry in the cache of resolved hostnames.
+/* This described one entry in the cache of resolved hostnames.  An entry
+ * without address records that the name has none.
  *
  * REVISIT: this consumes extra space, especially when multiple
  * addresses per name are stored.
@@ -50,30 +61,112 @@
 
 struct dns_cache_s
 {
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
   time_t            ctime;      /* Creation time */
-#endif
-  char              name[CONFIG_NETDB_DNSCLIENT_NAMESIZE];
+  uint32_t          ttl;        /* Time to live, unit: s */
+  uint32_t          hash;       /* Hash of the name */
+  uint8_t           next;       /* Next entry in the bucket plus one */
   uint8_t           naddr;      /* How many addresses per name */
+  bool              inuse;      /* The entry is in a bucket */
+  char              name[CONFIG_NETDB_DNSCLIENT_NAMESIZE];
   union dns_addr_u  addr[CONFIG_NETDB_MAX_IPADDR];
-  uint32_t          ttl;
 };
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static uint8_t g_dns_head;        /* Head of the circular, DNS resolver cache */
-static uint8_t g_dns_tail;        /* Tail of the circular, DNS resolver cache */
-
-/* This is the DNS resolver cache */
+/* This is the DNS resolver cache, each bucket holds the first entry of its
+ * chain plus one.
+ */
 
+static uint8_t g_dns_bucket[DNS_CACHE_NBUCKETS];
 static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: dns_cache_hash
+ *
+ * Description:
+ *   FNV-1a hash of the part of a hostname that fits in an entry.
+ *
+ ****************************************************************************/
+
+static uint32_t dns_cache_hash(FAR const char *hostname)
+{
+  uint32_t hash = 2166136261u;
+  int i;
+
+  for (i = 0; i < CONFIG_NETDB_DNSCLIENT_NAMESIZE - 1 &&
+              hostname[i] != '\0'; i++)
+    {
+      hash = (hash ^ (uint8_t)hostname[i]) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: dns_cache_expired
+ ****************************************************************************/
+
+static bool dns_cache_expired(FAR const struct dns_cache_s *entry,
+                              time_t now)
+{
+  uint32_t elapsed = (uint32_t)now - (uint32_t)entry->ctime;
+
+#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
+  if (elapsed > CONFIG_NETDB_DNSCLIENT_LIFESEC)
+    {
+      return true;
+    }
+#endif
+
+  return elapsed > entry->ttl;
+}
+
+/****************************************************************************
+ * Name: dns_cache_unlink
+ *
+ * Description:
+ *   Remove an entry from its bucket.
+ *
+ ****************************************************************************/
+
+static void dns_cache_unlink(FAR struct dns_cache_s *entry)
+{
+  FAR uint8_t *link = &g_dns_bucket[entry->hash % DNS_CACHE_NBUCKETS];
+
+  while (*link != 0)
+    {
+      FAR struct dns_cache_s *curr = &g_dns_cache[*link - 1];
+
+      if (curr == entry)
+        {
+          *link = entry->next;
+          break;
+        }
+
+      link = &curr->next;
+    }
+
+  entry->inuse = false;
+}
+
+/****************************************************************************
+ * Name: dns_cache_now
+ ****************************************************************************/
+
+static time_t dns_cache_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (time_t)now.tv_sec;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -87,7 +180,7 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses, zero if the name has none.
  *   ttl      - The TTL of the IP addresses.
  *
  * Returned Value:
@@ -99,63 +192,74 @@ void dns_save_answer(FAR const char *hostname,
                      FAR const union dns_addr_u *addr, int naddr,
                      uint32_t ttl)
 {
-  FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-#endif
-  int next;
+  FAR struct dns_cache_s *entry = NULL;
+  FAR struct dns_cache_s *curr;
+  FAR uint8_t *bucket;
+  uint32_t hash;
+  time_t now;
   int ndx;
 
   naddr = MIN(naddr, CONFIG_NETDB_MAX_IPADDR);
-  DEBUGASSERT(naddr >= 1 && naddr <= UCHAR_MAX);
+  DEBUGASSERT(naddr >= 0 && naddr <= UCHAR_MAX);
+
+  hash = dns_cache_hash(hostname);
+  now  = dns_cache_now();
 
   /* Get exclusive access to the DNS cache */
 
   dns_lock();
 
-  /* Get the index to the new head of the list */
-
-  ndx  = g_dns_head;
-  next = ndx + 1;
-  if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
-    {
-      next = 0;
-    }
-
-  /* If the next head pointer would match the tail index, then increment
-   * the tail index, discarding the oldest mapping in the cache.
+  /* Replace the old answer for the same name, else take a free entry,
+   * else an expired one, else the oldest one.
    */
 
-  if (next == g_dns_tail)
+  for (ndx = 0; ndx < CONFIG_NETDB_DNSCLIENT_ENTRIES; ndx++)
     {
-      int tmp = g_dns_tail + 1;
-      if (tmp >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+      curr = &g_dns_cache[ndx];
+      if (!curr->inuse)
         {
-          tmp = 0;
+          if (entry == NULL || entry->inuse)
+            {
+              entry = curr;
+            }
+        }
+      else if (curr->hash == hash &&
+               strncmp(hostname, curr->name,
+                       CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
+        {
+          entry = curr;
+          break;
         }
+      else if (entry == NULL ||
+               (entry->inuse && !dns_cache_expired(entry, now) &&
+                (dns_cache_expired(curr, now) ||
+                 (int32_t)(curr->ctime - entry->ctime) < 0)))
+        {
+          entry = curr;
+        }
+    }
 
-      g_dns_tail = tmp;
+  if (entry->inuse)
+    {
+      dns_cache_unlink(entry);
     }
 
   /* Save the answer in the cache */
 
-  entry = &g_dns_cache[ndx];
-
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time */
-
-  clock_gettime(CLOCK_MONOTONIC, &now);
-  entry->ctime = (time_t)now.tv_sec;
-#endif
-
+  entry->ctime = now;
+  entry->hash  = hash;
   strlcpy(entry->name, hostname, CONFIG_NETDB_DNSCLIENT_NAMESIZE);
   memcpy(&entry->addr, addr, naddr * sizeof(*addr));
   entry->naddr = naddr;
-  entry->ttl = ttl;
+  entry->ttl   = ttl;
+
+  /* Put it first in its bucket */
 
-  /* Save the updated head index */
+  bucket       = &g_dns_bucket[hash % DNS_CACHE_NBUCKETS];
+  entry->next  = *bucket;
+  entry->inuse = true;
+  *bucket      = entry - g_dns_cache + 1;
 
-  g_dns_head = next;
   dns_unlock();
 }
 
@@ -172,14 +276,19 @@ void dns_save_answer(FAR const char *hostname,
 
 void dns_clear_answer(void)
 {
+  int ndx;
+
   /* Get exclusive access to the DNS cache */
 
   dns_lock();
 
-  /* Reset the circular of DNS cache */
+  /* Empty all of the buckets */
 
-  g_dns_head = 0;
-  g_dns_tail = 0;
+  memset(g_dns_bucket, 0, sizeof(g_dns_bucket));
+  for (ndx = 0; ndx < CONFIG_NETDB_DNSCLIENT_ENTRIES; ndx++)
+    {
+      g_dns_cache[ndx].inuse = false;
+    }
 
   dns_unlock();
 }
@@ -202,7 +311,8 @@ void dns_clear_answer(void)
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
  *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   was not found in the cache, or -EADDRNOTAVAIL meaning that the cache
+ *   knows that the hostname has no address.
  *
  ****************************************************************************/
 
@@ -210,85 +320,58 @@ int dns_find_answer(FAR const char *hostname, FAR union dns_addr_u *addr,
                     FAR int *naddr)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-  uint32_t elapsed;
-  int ret;
-#endif
-  int next;
+  uint32_t hash;
+  time_t now;
   int ndx;
+  int ret = -ENOENT;
+
+  hash = dns_cache_hash(hostname);
+  now  = dns_cache_now();
 
   /* Get exclusive access to the DNS cache */
 
   dns_lock();
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time */
-
-  ret = clock_gettime(CLOCK_MONOTONIC, &now);
-#endif
-
-  for (ndx = g_dns_tail; ndx != g_dns_head; ndx = next)
+  for (ndx = g_dns_bucket[hash % DNS_CACHE_NBUCKETS]; ndx != 0;
+       ndx = entry->next)
     {
-      entry = &g_dns_cache[ndx];
+      entry = &g_dns_cache[ndx - 1];
 
-      /* Advance the index for the next time through the loop, handling
-       * wrapping to the beginning of the circular buffer.
+      /* Because the names are truncated to CONFIG_NETDB_DNSCLIENT_NAMESIZE,
+       * this has the possibility of aliasing two names and returning the
+       * wrong entry from the cache.
        */
 
-      next = ndx + 1;
-      if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+      if (entry->hash != hash ||
+          strncmp(hostname, entry->name,
+                  CONFIG_NETDB_DNSCLIENT_NAMESIZE) != 0)
         {
-          next = 0;
+          continue;
         }
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-      /* Check if this entry has expired
-       * REVISIT: Does not this calculation assume that the sizeof(time_t)
-       * is equal to the sizeof(uint32_t)?
-       */
-
-      elapsed = (uint32_t)now.tv_sec - (uint32_t)entry->ctime;
-      if (ret >= 0 &&
-          (elapsed > CONFIG_NETDB_DNSCLIENT_LIFESEC || elapsed > entry->ttl))
+      if (dns_cache_expired(entry, now))
         {
-          /* This entry has expired.  Increment the tail index to exclude
-           * this entry on future traversals.
-           */
+          /* This entry has expired, drop it */
 
-          g_dns_tail = next;
+          dns_cache_unlink(entry);
+        }
+      else if (entry->naddr == 0)
+        {
+          ret = -EADDRNOTAVAIL;
         }
       else
-#endif
         {
-          /* The entry has not expired, check for a name match. Because
-           * the names are truncated to CONFIG_NETDB_DNSCLIENT_NAMESIZE,
-           * this has the possibility of aliasing two names and returning
-           * the wrong entry from the cache.
+          /* We have a match.  Make sure that the address will fit in the
+           * caller-provided buffer and return the address information.
            */
 
-          if (strncmp(hostname, entry->name,
-                      CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
-            {
-              /* We have a match.  Return the resolved host address */
-
-              /* Make sure that the address will fit in the caller-provided
-               * buffer.
-               */
-
-              *naddr = MIN(*naddr, entry->naddr);
-
-              /* Return the address information */
-
-              memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
-
-              dns_unlock();
-              return OK;
-            }
+          *naddr = MIN(*naddr, entry->naddr);
+          memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
+          ret = OK;
         }
-    }
 
-  ret = -ENOENT;
+      break;
+    }
 
   dns_unlock();
   return ret;
@@ -40,12 +40,14 @@
 
 #include <nuttx/config.h>
 
+#include <inttypes.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
 #include <errno.h>
 #include <debug.h>
 #include <assert.h>
+#include <poll.h>
 
 #include <arpa/inet.h>
 
@@ -55,6 +57,7 @@
 #include <nuttx/net/dns.h>
 
 #include "netdb/lib_dns.h"
+#include "netdb/lib_netdb.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -75,6 +78,20 @@
 #define RECV_BUFFER_SIZE  CONFIG_NETDB_DNSCLIENT_MAXRESPONSE
 #define QUERY_BUFFER_SIZE MAX(SEND_BUFFER_SIZE, RECV_BUFFER_SIZE)
 
+/* Parallel queries: the IPv6 and IPv4 queries to each of the first name
+ * servers, each in its own slot.
+ */
+
+#ifdef CONFIG_NETDB_DNSCLIENT_PARALLEL
+#  define DNS_FAMILY_IPv6     0
+#  define DNS_FAMILY_IPv4     1
+#  define DNS_NFAMILIES       2
+#  define DNS_PARALLEL_SLOTS  (CONFIG_NETDB_DNSCLIENT_PARALLEL_SERVERS * \
+                               DNS_NFAMILIES)
+#  define DNS_FAMILY_MAXADDR  MAX(CONFIG_NETDB_MAX_IPv4ADDR, \
+                                  CONFIG_NETDB_MAX_IPv6ADDR)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -86,6 +103,8 @@ struct dns_query_s
   FAR union dns_addr_u *addr;     /* Location to return host address */
   FAR int *naddr;                 /* Number of returned addresses */
   uint32_t ttl;                   /* Time to Live, unit:s */
+  uint32_t negttl;                /* Time to Live of a negative answer */
+  bool negative;                  /* A server answered there is no address */
 };
 
 /* Query info to check response against. */
@@ -99,11 +118,30 @@ struct dns_query_info_s
                                                     * encoded format + NUL */
 };
 
+#ifdef CONFIG_NETDB_DNSCLIENT_PARALLEL
+/* The state of one family in a parallel query */
+
+enum dns_family_e
+{
+  DNS_FAMILY_SKIP = 0,            /* Not queried */
+  DNS_FAMILY_PENDING,             /* No answer yet */
+  DNS_FAMILY_FOUND,               /* Addresses found */
+  DNS_FAMILY_NONE                 /* The name has no such address */
+};
+#endif
+
 struct dns_query_data_s
 {
   struct dns_query_s query;
   struct dns_query_info_s qinfo;
   uint8_t buffer[QUERY_BUFFER_SIZE]; /* Buffer to hold request & response */
+#ifdef CONFIG_NETDB_DNSCLIENT_PARALLEL
+  uint8_t nservers;               /* Number of servers in 'servers' */
+  bool fallback;                  /* The traversal is still needed */
+  union dns_addr_u servers[CONFIG_NETDB_DNSCLIENT_PARALLEL_SERVERS];
+  struct dns_query_info_s pinfo[DNS_PARALLEL_SLOTS];
+  union dns_addr_u paddr[DNS_NFAMILIES][DNS_FAMILY_MAXADDR];
+#endif
 };
 
 /****************************************************************************
@@ -514,7 +552,10 @@ static int dns_send_query(int sd, FAR const char *name,
  *   Called when new UDP data arrives
  *
  * Returned Value:
- *   Returns number of valid IP address responses.  Negated errno value is
+ *   Returns number of valid IP address responses, 'ttl' is set to their
+ *   lowest TTL.  -EADDRNOTAVAIL is returned if the server answered that the
+ *   name has no such address, 'ttl' is then set to how long this answer
+ *   can be cached, zero if it should not be.  Negated errno value is
  *   returned in all other cases.
  *
  ****************************************************************************/
@@ -532,7 +573,11 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
   FAR struct dns_question_s *que;
   uint16_t nquestions;
   uint16_t nanswers;
+  uint16_t nauthrr;
   uint16_t temp;
+  uint32_t minttl = UINT32_MAX;
+  uint32_t rrttl;
+  uint8_t rcode;
   int naddr_read;
   int ret;
 
@@ -602,7 +647,10 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
       return -EAGAIN;
     }
 
-  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
+  /* A name that does not exist is an answer, checked as such below */
+
+  rcode = hdr->flags2 & DNS_FLAG2_ERR_MASK;
+  if (rcode != DNS_FLAG2_ERR_NONE && rcode != DNS_FLAG2_ERR_NAME)
     {
       nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
       return -EPROTO;
@@ -623,6 +671,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
 
   nquestions = NTOHS(hdr->numquestions);
   nanswers   = NTOHS(hdr->numanswers);
+  nauthrr    = NTOHS(hdr->numauthrr);
 
   /* We only ever send queries with one question. */
 
@@ -694,16 +743,12 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
           break;
         }
 
-      ans = (FAR struct dns_answer_s *)nameptr;
+      ans   = (FAR struct dns_answer_s *)nameptr;
+      rrttl = ((uint32_t)NTOHS(ans->ttl[0]) << 16) | NTOHS(ans->ttl[1]);
 
-      ninfo("Answer: type=%04x, class=%04x, ttl=%06x, length=%04x\n",
-            NTOHS(ans->type), NTOHS(ans->class),
-            (NTOHS(ans->ttl[0]) << 16) | NTOHS(ans->ttl[1]),
-            NTOHS(ans->len));
-      if (ttl)
-        {
-          *ttl = (NTOHS(ans->ttl[0]) << 16) | NTOHS(ans->ttl[1]);
-        }
+      ninfo("Answer: type=%04x, class=%04x, ttl=%06" PRIx32
+            ", length=%04x\n", NTOHS(ans->type), NTOHS(ans->class),
+            rrttl, NTOHS(ans->len));
 
       /* Check for IPv4/6 address type and Internet class. Others are
        * discarded.
@@ -729,6 +774,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
           inaddr->sin_family      = AF_INET;
           inaddr->sin_port        = 0;
           inaddr->sin_addr.s_addr = ans->u.ipv4.s_addr;
+          minttl                  = MIN(minttl, rrttl);
 
           if (++naddr_read >= naddr)
             {
@@ -762,6 +808,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
           inaddr->sin6_family     = AF_INET6;
           inaddr->sin6_port       = 0;
           memcpy(inaddr->sin6_addr.s6_addr, ans->u.ipv6.s6_addr, 16);
+          minttl                  = MIN(minttl, rrttl);
 
           if (++naddr_read >= naddr)
             {
@@ -776,12 +823,51 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
         }
     }
 
-  if (naddr_read == 0 && ret == OK)
+  if (naddr_read > 0)
     {
-      ret = -EADDRNOTAVAIL;
+      if (ttl)
+        {
+          *ttl = minttl;
+        }
+
+      return naddr_read;
     }
+  else if (ret != OK)
+    {
+      return ret;
+    }
+
+  /* RFC 2308: a negative answer can be cached as long as the TTL of the
+   * SOA record in the authority section, never without it.
+   */
+
+  rrttl = 0;
+  for (; nauthrr > 0; nauthrr--)
+    {
+      nameptr = dns_parse_name(nameptr, endofbuffer);
+      if (nameptr + 10 > endofbuffer)
+        {
+          break;
+        }
 
-  return naddr_read > 0 ? naddr_read : ret;
+      ans = (FAR struct dns_answer_s *)nameptr;
+      if (ans->type == HTONS(DNS_RECTYPE_SOA) &&
+          ans->class == HTONS(DNS_CLASS_IN))
+        {
+          rrttl = ((uint32_t)NTOHS(ans->ttl[0]) << 16) |
+                  NTOHS(ans->ttl[1]);
+          break;
+        }
+
+      nameptr = nameptr + 10 + NTOHS(ans->len);
+    }
+
+  if (ttl)
+    {
+      *ttl = rrttl;
+    }
+
+  return -EADDRNOTAVAIL;
 }
 
 /****************************************************************************
@@ -847,7 +933,10 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
 {
   FAR struct dns_query_data_s *qdata = arg;
   FAR struct dns_query_s      *query = &qdata->query;
-  int next = 0;
+  uint32_t ttl;
+  int next;
+  int nfamilies;
+  int nnone;
   int retries;
   int ret;
   int sd;
@@ -865,9 +954,15 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
             retries + 1, CONFIG_NETDB_DNSCLIENT_RETRIES);
 
 try_stream:
+      next      = 0;
+      nfamilies = 0;
+      nnone     = 0;
+
 #ifdef CONFIG_NET_IPv6
       if (dns_is_queryfamily(AF_INET6))
         {
+          nfamilies++;
+
           /* Send the IPv6 query */
 
           sd = dns_bind(addr->sa_family, stream, retries);
@@ -895,11 +990,18 @@ try_stream:
               ret = dns_recv_response(sd, &query->addr[next],
                                       CONFIG_NETDB_MAX_IPv6ADDR,
                                       &qdata->qinfo,
-                                      &query->ttl, qdata->buffer,
+                                      &ttl, qdata->buffer,
                                       stream, &should_try_stream);
               if (ret >= 0)
                 {
                   next += ret;
+                  query->ttl = MIN(query->ttl, ttl);
+                }
+              else if (ret == -EADDRNOTAVAIL)
+                {
+                  nnone++;
+                  query->negttl = MIN(query->negttl, ttl);
+                  query->result = ret;
                 }
               else
                 {
@@ -923,6 +1025,8 @@ try_stream:
 #ifdef CONFIG_NET_IPv4
       if (dns_is_queryfamily(AF_INET))
         {
+          nfamilies++;
+
           /* Send the IPv4 query */
 
           sd = dns_bind(addr->sa_family, stream, retries);
@@ -955,11 +1059,18 @@ try_stream:
               ret = dns_recv_response(sd, &query->addr[next],
                                       CONFIG_NETDB_MAX_IPv4ADDR,
                                       &qdata->qinfo,
-                                      &query->ttl, qdata->buffer,
+                                      &ttl, qdata->buffer,
                                       stream, &should_try_stream);
               if (ret >= 0)
                 {
                   next += ret;
+                  query->ttl = MIN(query->ttl, ttl);
+                }
+              else if (ret == -EADDRNOTAVAIL)
+                {
+                  nnone++;
+                  query->negttl = MIN(query->negttl, ttl);
+                  query->result = ret;
                 }
               else
                 {
@@ -982,11 +1093,6 @@ try_stream:
 
       if (next > 0)
         {
-#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-          /* Save the answer in the DNS cache */
-
-          dns_save_answer(query->hostname, query->addr, next, query->ttl);
-#endif
           /* Return 1 to indicate to (1) stop the traversal, and (2)
            * indicate that the address was found.
            */
@@ -994,6 +1100,15 @@ try_stream:
           *query->naddr = next;
           return 1;
         }
+      else if (nfamilies > 0 && nnone == nfamilies)
+        {
+          /* The server answered that the name has no address, the other
+           * servers are not asked.
+           */
+
+          query->negative = true;
+          return 1;
+        }
       else if (query->result != -EAGAIN)
         {
           break;
@@ -1003,6 +1118,352 @@ try_stream:
   return 0;
 }
 
+/****************************************************************************
+ * Name: dns_gather_callback
+ *
+ * Description:
+ *   Collect the first name servers for a parallel query.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDB_DNSCLIENT_PARALLEL
+static int dns_gather_callback(FAR void *arg, FAR struct sockaddr *addr,
+                               socklen_t addrlen)
+{
+  FAR struct dns_query_data_s *qdata = arg;
+
+  if (qdata->nservers >= CONFIG_NETDB_DNSCLIENT_PARALLEL_SERVERS)
+    {
+      /* The servers left are only asked one after the other */
+
+      qdata->fallback = true;
+      return 1;
+    }
+
+  memcpy(&qdata->servers[qdata->nservers++], addr,
+         MIN(addrlen, sizeof(union dns_addr_u)));
+  return 0;
+}
+
+/****************************************************************************
+ * Name: dns_parallel_family
+ *
+ * Description:
+ *   Return whether a family of a parallel query is to be queried and its
+ *   record type and maximum number of addresses.
+ *
+ ****************************************************************************/
+
+static bool dns_parallel_family(int family, FAR uint16_t *rectype,
+                                FAR int *maxaddr)
+{
+#ifdef CONFIG_NET_IPv6
+  if (family == DNS_FAMILY_IPv6 && dns_is_queryfamily(AF_INET6))
+    {
+      *rectype = DNS_RECTYPE_AAAA;
+      *maxaddr = CONFIG_NETDB_MAX_IPv6ADDR;
+      return true;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  if (family == DNS_FAMILY_IPv4 && dns_is_queryfamily(AF_INET))
+    {
+      *rectype = DNS_RECTYPE_A;
+      *maxaddr = CONFIG_NETDB_MAX_IPv4ADDR;
+      return true;
+    }
+#endif
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: dns_parallel_elapsed
+ *
+ * Description:
+ *   Return the milliseconds elapsed since 'start'.
+ *
+ ****************************************************************************/
+
+static int dns_parallel_elapsed(FAR const struct timespec *start)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) * MSEC_PER_SEC +
+         (now.tv_nsec - start->tv_nsec) / NSEC_PER_MSEC;
+}
+
+/****************************************************************************
+ * Name: dns_query_parallel
+ *
+ * Description:
+ *   Send the queries of all families to the first name servers at once and
+ *   keep the first answer of each family.  Once some addresses are known,
+ *   the families still pending are only waited for a short delay, as in
+ *   RFC 8305.
+ *
+ * Returned Value:
+ *   Returns one (1) if the query is answered, with some addresses or with
+ *   no address at all.  Zero is returned in all other cases, with the
+ *   fallback field of the query set if the sequential traversal of the
+ *   name servers could still give an answer.
+ *
+ ****************************************************************************/
+
+static int dns_query_parallel(FAR struct dns_query_data_s *qdata)
+{
+  FAR struct dns_query_s *query = &qdata->query;
+  struct pollfd fds[DNS_PARALLEL_SLOTS];
+  uint8_t state[DNS_NFAMILIES];
+  uint8_t family[DNS_PARALLEL_SLOTS];
+  uint8_t server[DNS_PARALLEL_SLOTS];
+  int count[DNS_NFAMILIES];
+  struct timespec start;
+  uint16_t rectype;
+  uint32_t ttl;
+  bool timedout;
+  bool delayed;
+  bool none;
+  int npending;
+  int maxaddr;
+  int timeout;
+  int retries;
+  int nslots;
+  int next;
+  int ret;
+  int sd;
+  int f;
+  int i;
+  int j;
+
+  qdata->nservers = 0;
+  qdata->fallback = false;
+  dns_foreach_nameserver(dns_gather_callback, qdata);
+
+  for (f = 0; f < DNS_NFAMILIES; f++)
+    {
+      count[f] = 0;
+      state[f] = dns_parallel_family(f, &rectype, &maxaddr) ?
+                 DNS_FAMILY_PENDING : DNS_FAMILY_SKIP;
+    }
+
+  for (retries = 0; retries < CONFIG_NETDB_DNSCLIENT_RETRIES; retries++)
+    {
+      /* Ask each server for each family still unknown */
+
+      nslots = 0;
+      for (i = 0; i < qdata->nservers; i++)
+        {
+          for (f = 0; f < DNS_NFAMILIES; f++)
+            {
+              if (state[f] != DNS_FAMILY_PENDING)
+                {
+                  continue;
+                }
+
+              sd = dns_bind(qdata->servers[i].addr.sa_family, false,
+                            retries);
+              if (sd < 0)
+                {
+                  query->result = sd;
+                  continue;
+                }
+
+              dns_parallel_family(f, &rectype, &maxaddr);
+              ret = dns_send_query(sd, query->hostname, &qdata->servers[i],
+                                   rectype, &qdata->pinfo[nslots],
+                                   qdata->buffer, false);
+              if (ret < 0)
+                {
+                  dns_query_error("ERROR: dns_send_query failed",
+                                  ret, &qdata->servers[i]);
+                  query->result = ret;
+                  close(sd);
+                  continue;
+                }
+
+              fds[nslots].fd      = sd;
+              fds[nslots].events  = POLLIN;
+              fds[nslots].revents = 0;
+              server[nslots]      = i;
+              family[nslots++]    = f;
+            }
+        }
+
+      /* Take the answers as they come */
+
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      timeout  = dns_get_timeout(retries) * MSEC_PER_SEC;
+      timedout = false;
+      delayed  = false;
+      npending = nslots;
+
+      while (npending > 0)
+        {
+          ret = timeout - dns_parallel_elapsed(&start);
+          if (ret > 0)
+            {
+              ret = poll(fds, nslots, ret);
+              if (ret < 0)
+                {
+                  ret = -get_errno();
+                  if (ret == -EINTR)
+                    {
+                      continue;
+                    }
+
+                  query->result = ret;
+                  break;
+                }
+            }
+
+          if (ret <= 0)
+            {
+              timedout = true;
+              break;
+            }
+
+          for (i = 0; i < nslots; i++)
+            {
+              bool should_try_stream = false;
+
+              if (fds[i].fd < 0 || fds[i].revents == 0)
+                {
+                  continue;
+                }
+
+              f = family[i];
+              dns_parallel_family(f, &rectype, &maxaddr);
+              ret = dns_recv_response(fds[i].fd, qdata->paddr[f], maxaddr,
+                                      &qdata->pinfo[i], &ttl,
+                                      qdata->buffer, false,
+                                      &should_try_stream);
+              close(fds[i].fd);
+              fds[i].fd = -1;
+              npending--;
+
+              if (state[f] != DNS_FAMILY_PENDING)
+                {
+                  continue;
+                }
+              else if (ret >= 0)
+                {
+                  state[f]   = DNS_FAMILY_FOUND;
+                  count[f]   = ret;
+                  query->ttl = MIN(query->ttl, ttl);
+                }
+              else if (ret == -EADDRNOTAVAIL)
+                {
+                  state[f]      = DNS_FAMILY_NONE;
+                  query->negttl = MIN(query->negttl, ttl);
+                  query->result = ret;
+                  continue;
+                }
+              else
+                {
+                  /* A truncated answer needs the stream socket of the
+                   * sequential traversal.
+                   */
+
+                  qdata->fallback |= should_try_stream;
+                  dns_query_error("ERROR: dns_recv_response failed",
+                                  ret, &qdata->servers[server[i]]);
+                  query->result = ret;
+                  continue;
+                }
+
+              /* The other servers are not waited for this family */
+
+              for (j = 0; j < nslots; j++)
+                {
+                  if (fds[j].fd >= 0 && family[j] == f)
+                    {
+                      close(fds[j].fd);
+                      fds[j].fd = -1;
+                      npending--;
+                    }
+                }
+            }
+
+          /* Do not wait long for the other family once some addresses
+           * are known.
+           */
+
+          if (!delayed && npending > 0 &&
+              (state[DNS_FAMILY_IPv6] == DNS_FAMILY_FOUND ||
+               state[DNS_FAMILY_IPv4] == DNS_FAMILY_FOUND))
+            {
+              timeout = MIN(timeout, dns_parallel_elapsed(&start) +
+                            CONFIG_NETDB_DNSCLIENT_RESOLUTION_DELAY);
+              delayed = true;
+            }
+        }
+
+      for (i = 0; i < nslots; i++)
+        {
+          if (fds[i].fd >= 0)
+            {
+              close(fds[i].fd);
+            }
+        }
+
+      /* Retry only when nothing is known and some server timed out */
+
+      if (!timedout || delayed)
+        {
+          break;
+        }
+
+      query->result = -EAGAIN;
+    }
+
+  /* Return the IPv6 addresses first, as the sequential traversal */
+
+  next = 0;
+  for (f = 0; f < DNS_NFAMILIES; f++)
+    {
+      if (state[f] != DNS_FAMILY_FOUND)
+        {
+          continue;
+        }
+
+      if (next >= *query->naddr)
+        {
+          next = *query->naddr / 2;
+        }
+
+      ret = MIN(count[f], *query->naddr - next);
+      memcpy(&query->addr[next], qdata->paddr[f],
+             ret * sizeof(union dns_addr_u));
+      next += ret;
+    }
+
+  if (next > 0)
+    {
+      *query->naddr = next;
+      return 1;
+    }
+
+  /* Or every family queried is known to have no address */
+
+  none = false;
+  for (f = 0; f < DNS_NFAMILIES; f++)
+    {
+      if (state[f] == DNS_FAMILY_PENDING)
+        {
+          return 0;
+        }
+
+      none |= state[f] == DNS_FAMILY_NONE;
+    }
+
+  query->negative = none;
+  return none;
+}
+#endif /* CONFIG_NETDB_DNSCLIENT_PARALLEL */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1044,26 +1505,60 @@ int dns_query(FAR const char *hostname, FAR union dns_addr_u *addr,
   qdata->query.hostname = hostname;
   qdata->query.addr     = addr;
   qdata->query.naddr    = naddr;
+  qdata->query.ttl      = UINT32_MAX;
+  qdata->query.negttl   = UINT32_MAX;
+  qdata->query.negative = false;
 
   /* Perform the query. dns_foreach_nameserver() will return:
    *
-   *  1 - The query was successful.
+   *  1 - The query was answered, with addresses unless negative is set.
    *  0 - Look up failed
    * <0 - Some other failure (?, shouldn't happen)
    */
 
+#ifdef CONFIG_NETDB_DNSCLIENT_PARALLEL
+  /* Ask the first servers for all families at once, the traversal is left
+   * for what this cannot answer.
+   */
+
+  ret = dns_query_parallel(qdata);
+  if (ret == 0 && qdata->fallback)
+    {
+      ret = dns_foreach_nameserver(dns_query_callback, qdata);
+    }
+#else
   ret = dns_foreach_nameserver(dns_query_callback, qdata);
+#endif
+
   if (ret > 0)
     {
       /* The lookup was successful */
 
-      ret = OK;
+      ret = qdata->query.negative ? -EADDRNOTAVAIL : OK;
     }
   else if (ret == 0)
     {
       ret = qdata->query.result;
     }
 
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+  /* Save the answer in the DNS cache, a negative one only as long as the
+   * server allows.
+   */
+
+  if (ret == OK)
+    {
+      dns_save_answer(hostname, addr, *naddr, qdata->query.ttl);
+    }
+  else if (qdata->query.negative && qdata->query.negttl > 0 &&
+           CONFIG_NETDB_DNSCLIENT_NEGLIFESEC > 0)
+    {
+      dns_save_answer(hostname, addr, 0,
+                      MIN(qdata->query.negttl,
+                          CONFIG_NETDB_DNSCLIENT_NEGLIFESEC));
+    }
+#endif
+
   /* Free the query data */
 
   lib_free(qdata);
@@ -63,7 +63,9 @@
 
 int pthread_barrier_destroy(FAR pthread_barrier_t *barrier)
 {
+#ifndef CONFIG_FUTEX
   int semcount;
+#endif
   int ret = OK;
 
   if (!barrier)
@@ -72,6 +74,14 @@ int pthread_barrier_destroy(FAR pthread_barrier_t *barrier)
     }
   else
     {
+#ifdef CONFIG_FUTEX
+      if (barrier->wait_count != 0)
+        {
+          return EBUSY;
+        }
+
+      barrier->count = 0;
+#else
       ret = nxsem_get_value(&barrier->sem, &semcount);
       if (ret < 0)
         {
@@ -85,6 +95,7 @@ int pthread_barrier_destroy(FAR pthread_barrier_t *barrier)
 
       ret = -nxsem_destroy(&barrier->sem);
       barrier->count = 0;
+#endif
     }
 
   return ret;
@@ -85,10 +85,16 @@ int pthread_barrier_init(FAR pthread_barrier_t *barrier,
     }
   else
     {
+#ifdef CONFIG_FUTEX
+      barrier->seq = 0;
+#else
       sem_init(&barrier->sem, 0, 0);
+#endif
       barrier->count = count;
       barrier->wait_count = 0;
+#ifndef CONFIG_FUTEX
       nxmutex_init(&barrier->mutex);
+#endif
     }
 
   return ret;
@@ -26,9 +26,12 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/atomic.h>
+#include <nuttx/futex.h>
 #include <nuttx/irq.h>
 #include <nuttx/semaphore.h>
 #include <pthread.h>
+#include <limits.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -82,11 +85,53 @@
 
 int pthread_barrier_wait(FAR pthread_barrier_t *barrier)
 {
+#ifdef CONFIG_FUTEX
+  uint32_t seq;
+  int ret;
+#endif
+
   if (barrier == NULL)
     {
       return EINVAL;
     }
 
+#ifdef CONFIG_FUTEX
+  /* Sample the generation before arriving: it cannot change until this
+   * thread has arrived, because the barrier only trips on the last one.
+   */
+
+  seq = atomic_read_acquire((FAR atomic_t *)&barrier->seq);
+
+  if (atomic_fetch_add((FAR atomic_t *)&barrier->wait_count, 1) + 1 >=
+      barrier->count)
+    {
+      /* Reset the arrival count for the next generation before releasing
+       * the waiters, then start the new generation and wake everybody.
+       */
+
+      atomic_set((FAR atomic_t *)&barrier->wait_count, 0);
+      atomic_fetch_add((FAR atomic_t *)&barrier->seq, 1);
+      nxfutex_wake(&barrier->seq, INT_MAX);
+
+      return PTHREAD_BARRIER_SERIAL_THREAD;
+    }
+
+  /* Sleep until the generation changes.  Signals and spurious wake-ups
+   * just send us back to sleep.
+   */
+
+  while ((uint32_t)atomic_read_acquire((FAR atomic_t *)&barrier->seq) ==
+         seq)
+    {
+      ret = nxfutex_wait(&barrier->seq, seq, CLOCK_REALTIME, NULL);
+      if (ret < 0 && ret != -EAGAIN && ret != -EINTR)
+        {
+          return -ret;
+        }
+    }
+
+  return OK;
+#else
   /* If the number of waiters would be equal to the count, then we are done */
 
   nxmutex_lock(&barrier->mutex);
@@ -124,4 +169,5 @@ int pthread_barrier_wait(FAR pthread_barrier_t *barrier)
     }
 
   return OK;
+#endif
 }
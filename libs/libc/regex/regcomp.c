@@ -3923,6 +3923,10 @@ int regcomp(regex_t *restrict preg, const char *restrict regex, int cflags)
   tnfa->num_states      = parse_ctx.position;
   tnfa->cflags          = cflags;
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+  tre_dfa_create(tnfa);
+#endif
+
   tre_mem_destroy(mem);
   tre_stack_destroy(stack);
   xfree(counts);
@@ -3968,6 +3972,10 @@ void regfree(regex_t *preg)
       return;
     }
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+  tre_dfa_destroy(tnfa);
+#endif
+
   for (i = 0; i < tnfa->num_transitions; i++)
     {
       if (tnfa->transitions[i].state)
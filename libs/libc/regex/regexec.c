@@ -1225,6 +1225,19 @@ int regexec(const regex_t *restrict preg, const char *restrict string,
       nmatch = 0;
     }
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+  /* The lazy DFA tells whether there is a match in linear time.  Without
+   * submatches to report it is the whole answer, otherwise the tagged
+   * matcher only runs on the strings that match.
+   */
+
+  status = tre_dfa_match(tnfa, string, eflags);
+  if (status == REG_NOMATCH || (status == REG_OK && nmatch == 0))
+    {
+      return status;
+    }
+#endif
+
   if (tnfa->num_tags > 0 && nmatch > 0)
     {
       tags = xmalloc(sizeof(*tags) * tnfa->num_tags);
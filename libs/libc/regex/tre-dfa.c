@@ -0,0 +1,658 @@
+/****************************************************************************
+ * libs/libc/regex/tre-dfa.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nuttx/mutex.h>
+
+#include "tre.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The assertions known from the next character, one row of transitions
+ * per class of the next character when the TNFA has any of them.
+ */
+
+#define DFA_LOOKAHEAD_ASSERTIONS (ASSERT_AT_EOL | ASSERT_AT_BOW | \
+                                  ASSERT_AT_EOW | ASSERT_AT_WB | \
+                                  ASSERT_AT_WB_NEG)
+
+#define DFA_LA_OTHER             0
+#define DFA_LA_WORD              1
+#define DFA_LA_NEWLINE           2
+#define DFA_LA_CLASSES           3
+
+/* The context of a position for the assertions */
+
+#define DFA_CTX_BOL              0x01 /* At the beginning of a line */
+#define DFA_CTX_EOL              0x02 /* At the end of a line */
+#define DFA_CTX_PREV_WORD        0x04 /* After a word character */
+#define DFA_CTX_NEXT_WORD        0x08 /* Before a word character */
+#define DFA_CTX_EDGE             0x10 /* At an end of the string */
+
+#define DFA_IS_WORD_CHAR(c)      ((c) == L'_' || tre_isalnum(c))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A DFA state is the set of the TNFA states reached at a position */
+
+struct tre_dfa_state
+{
+  int16_t *set;                /* The ids, increasing */
+  int16_t *next;               /* Next state per class, -1 not known yet */
+  uint32_t hash;
+  uint16_t nset;
+  uint16_t final;
+};
+
+struct tre_dfa
+{
+  mutex_t lock;
+  tre_tnfa_transition_t **states; /* The TNFA state of each id */
+  uint32_t *mark;                 /* The ids of the next set */
+  int16_t *scratch;               /* The next set */
+  struct tre_dfa_state *cache;    /* The DFA states, up to maxcache */
+  char *arena;                    /* The sets and rows of the DFA states */
+  size_t arena_size;
+  size_t arena_used;
+  int ncache;
+  int maxcache;
+  int nrow;                       /* Classes * lookahead classes */
+  int nla;                        /* Lookahead classes, 1 or 3 */
+  int final_id;
+  int newline;
+  int icase;
+  uint8_t classes[256];           /* The class of the characters < 256 */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int tre_dfa_neg_classes(tre_ctype_t *classes, tre_cint_t wc,
+                               int icase)
+{
+  for (; *classes != (tre_ctype_t)0; classes++)
+    {
+      if ((!icase && tre_isctype(wc, *classes)) ||
+          (icase && (tre_isctype(tre_toupper(wc), *classes) ||
+                     tre_isctype(tre_tolower(wc), *classes))))
+        {
+          return 1;
+        }
+    }
+
+  return 0;
+}
+
+/* Whether the transition rejects the character, as CHECK_CHAR_CLASSES */
+
+static int tre_dfa_class_fail(const tre_tnfa_transition_t *trans,
+                              tre_cint_t c, int icase)
+{
+  if ((trans->assertions & ASSERT_CHAR_CLASS) != 0)
+    {
+      if (!icase)
+        {
+          if (!tre_isctype(c, trans->u.class))
+            {
+              return 1;
+            }
+        }
+      else if (!tre_isctype(tre_tolower(c), trans->u.class) &&
+               !tre_isctype(tre_toupper(c), trans->u.class))
+        {
+          return 1;
+        }
+    }
+
+  return (trans->assertions & ASSERT_CHAR_CLASS_NEG) != 0 &&
+         tre_dfa_neg_classes(trans->neg_classes, c, icase);
+}
+
+/* Whether the assertions fail in the context, as CHECK_ASSERTIONS */
+
+static int tre_dfa_assert_fail(int assertions, int ctx)
+{
+  int prev = (ctx & DFA_CTX_PREV_WORD) != 0;
+  int next = (ctx & DFA_CTX_NEXT_WORD) != 0;
+
+  return ((assertions & ASSERT_AT_BOL) && !(ctx & DFA_CTX_BOL)) ||
+         ((assertions & ASSERT_AT_EOL) && !(ctx & DFA_CTX_EOL)) ||
+         ((assertions & ASSERT_AT_BOW) && (prev || !next)) ||
+         ((assertions & ASSERT_AT_EOW) && (!prev || next)) ||
+         ((assertions & ASSERT_AT_WB) && !(ctx & DFA_CTX_EDGE) &&
+          prev == next) ||
+         ((assertions & ASSERT_AT_WB_NEG) && ((ctx & DFA_CTX_EDGE) ||
+                                              prev != next));
+}
+
+/* The context after prev, before next, not at the start of the string */
+
+static int tre_dfa_context(const struct tre_dfa *dfa, tre_cint_t prev,
+                           tre_cint_t next, int eflags)
+{
+  int ctx = 0;
+
+  if (prev == L'\n' && dfa->newline)
+    {
+      ctx |= DFA_CTX_BOL;
+    }
+
+  if ((next == L'\0' && !(eflags & REG_NOTEOL)) ||
+      (next == L'\n' && dfa->newline))
+    {
+      ctx |= DFA_CTX_EOL;
+    }
+
+  if (DFA_IS_WORD_CHAR(prev))
+    {
+      ctx |= DFA_CTX_PREV_WORD;
+    }
+
+  if (DFA_IS_WORD_CHAR(next))
+    {
+      ctx |= DFA_CTX_NEXT_WORD;
+    }
+
+  if (next == L'\0')
+    {
+      ctx |= DFA_CTX_EDGE;
+    }
+
+  return ctx;
+}
+
+/* Split the classes of the characters by a predicate */
+
+static void tre_dfa_split(struct tre_dfa *dfa, const uint8_t *member,
+                          int *nclasses)
+{
+  int16_t remap[2][256];
+  int n = 0;
+  int c;
+
+  memset(remap, 0xff, sizeof(remap));
+  for (c = 0; c < 256; c++)
+    {
+      int16_t *id = &remap[member[c]][dfa->classes[c]];
+
+      if (*id < 0)
+        {
+          *id = n++;
+        }
+
+      dfa->classes[c] = *id;
+    }
+
+  *nclasses = n;
+}
+
+/* The characters below 256 of a class behave the same in every
+ * transition and every assertion, they share the rows of the DFA states.
+ */
+
+static void tre_dfa_classify(struct tre_dfa *dfa, const tre_tnfa_t *tnfa,
+                             int *nclasses)
+{
+  tre_tnfa_transition_t *trans;
+  uint8_t member[256];
+  unsigned int i;
+  int c;
+
+  *nclasses = 1;
+  memset(dfa->classes, 0, sizeof(dfa->classes));
+
+  for (c = 0; c < 256; c++)
+    {
+      member[c] = DFA_IS_WORD_CHAR(c);
+    }
+
+  tre_dfa_split(dfa, member, nclasses);
+
+  for (c = 0; c < 256; c++)
+    {
+      member[c] = c == L'\n';
+    }
+
+  tre_dfa_split(dfa, member, nclasses);
+
+  for (i = 0; i < tnfa->num_transitions; i++)
+    {
+      trans = &tnfa->transitions[i];
+      if (trans->state == NULL || trans->code_min > 255)
+        {
+          continue;
+        }
+
+      if (trans->code_min == 0 && trans->code_max >= 255 &&
+          !(trans->assertions & (ASSERT_CHAR_CLASS |
+                                 ASSERT_CHAR_CLASS_NEG)))
+        {
+          continue;
+        }
+
+      for (c = 0; c < 256; c++)
+        {
+          member[c] = trans->code_min <= c && trans->code_max >= c &&
+                      !(trans->assertions &&
+                        tre_dfa_class_fail(trans, c, dfa->icase));
+        }
+
+      tre_dfa_split(dfa, member, nclasses);
+    }
+}
+
+/* The set of the TNFA states reached from set by c, the initial states
+ * added, in dfa->scratch.
+ */
+
+static int tre_dfa_step(struct tre_dfa *dfa, const tre_tnfa_t *tnfa,
+                        const int16_t *set, int nset, tre_cint_t c,
+                        int ctx)
+{
+  tre_tnfa_transition_t *trans;
+  int nwords = (tnfa->num_states + 31) / 32;
+  int n = 0;
+  int i;
+
+  memset(dfa->mark, 0, nwords * sizeof(uint32_t));
+
+  for (i = 0; i < nset; i++)
+    {
+      for (trans = dfa->states[set[i]]; trans->state; trans++)
+        {
+          if (trans->code_min <= c && trans->code_max >= c &&
+              !(trans->assertions &&
+                (tre_dfa_assert_fail(trans->assertions, ctx) ||
+                 tre_dfa_class_fail(trans, c, dfa->icase))))
+            {
+              dfa->mark[trans->state_id / 32] |=
+                UINT32_C(1) << (trans->state_id % 32);
+            }
+        }
+    }
+
+  for (trans = tnfa->initial; trans->state; trans++)
+    {
+      if (!trans->assertions ||
+          !tre_dfa_assert_fail(trans->assertions, ctx))
+        {
+          dfa->mark[trans->state_id / 32] |=
+            UINT32_C(1) << (trans->state_id % 32);
+        }
+    }
+
+  for (i = 0; i < nwords; i++)
+    {
+      uint32_t word = dfa->mark[i];
+
+      while (word != 0)
+        {
+          dfa->scratch[n++] = i * 32 + __builtin_ctz(word);
+          word &= word - 1;
+        }
+    }
+
+  return n;
+}
+
+/* The DFA state of the set in dfa->scratch, added if new.  The cache is
+ * flushed when full, *flushed tells.
+ */
+
+static int tre_dfa_state(struct tre_dfa *dfa, int nset, int *flushed)
+{
+  struct tre_dfa_state *state;
+  uint32_t hash = 2166136261u;
+  size_t rowsize = dfa->nrow * sizeof(int16_t);
+  size_t setsize = nset * sizeof(int16_t);
+  int i;
+
+  for (i = 0; i < nset; i++)
+    {
+      hash = (hash ^ (uint16_t)dfa->scratch[i]) * 16777619u;
+    }
+
+  for (i = 0; i < dfa->ncache; i++)
+    {
+      state = &dfa->cache[i];
+      if (state->hash == hash && state->nset == nset &&
+          memcmp(state->set, dfa->scratch, setsize) == 0)
+        {
+          return i;
+        }
+    }
+
+  if (dfa->ncache == dfa->maxcache ||
+      dfa->arena_size - dfa->arena_used < rowsize + setsize)
+    {
+      dfa->ncache     = 0;
+      dfa->arena_used = 0;
+      *flushed        = 1;
+      if (dfa->arena_size < rowsize + setsize)
+        {
+          return -1;
+        }
+    }
+
+  state             = &dfa->cache[dfa->ncache];
+  state->next       = (int16_t *)(dfa->arena + dfa->arena_used);
+  state->set        = state->next + dfa->nrow;
+  state->hash       = hash;
+  state->nset       = nset;
+  state->final      = 0;
+  dfa->arena_used  += rowsize + setsize;
+
+  memset(state->next, 0xff, rowsize);
+  memcpy(state->set, dfa->scratch, setsize);
+
+  for (i = 0; i < nset; i++)
+    {
+      if (dfa->scratch[i] == dfa->final_id)
+        {
+          state->final = 1;
+        }
+    }
+
+  return dfa->ncache++;
+}
+
+/* The next character as GET_NEXT_WCHAR, and its length */
+
+static int tre_dfa_next(const char *str, tre_char_t *wc)
+{
+  int len;
+
+  if ((unsigned char)*str < 0x80)
+    {
+      *wc = (unsigned char)*str;
+      return 1;
+    }
+
+  len = mbtowc(wc, str, MB_LEN_MAX);
+  return len == 0 ? 1 : len;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void tre_dfa_create(tre_tnfa_t *tnfa)
+{
+  tre_tnfa_transition_t *trans;
+  struct tre_dfa *dfa;
+  unsigned int i;
+  int assertions = 0;
+  int nclasses;
+  int nwords;
+
+  if (tnfa->have_backrefs || tnfa->num_states <= 0 ||
+      tnfa->num_states > INT16_MAX)
+    {
+      return;
+    }
+
+  dfa = xcalloc(1, sizeof(*dfa));
+  if (dfa == NULL)
+    {
+      return;
+    }
+
+  nwords       = (tnfa->num_states + 31) / 32;
+  dfa->states  = xcalloc(tnfa->num_states, sizeof(*dfa->states));
+  dfa->mark    = xmalloc(nwords * sizeof(uint32_t));
+  dfa->scratch = xmalloc(tnfa->num_states * sizeof(int16_t));
+  if (dfa->states == NULL || dfa->mark == NULL || dfa->scratch == NULL)
+    {
+      goto errout;
+    }
+
+  /* The ids of the TNFA states, the final one is the destination of some
+   * transition if reachable.
+   */
+
+  dfa->final_id = -1;
+  for (i = 0; i < tnfa->num_transitions; i++)
+    {
+      trans = &tnfa->transitions[i];
+      if (trans->state != NULL)
+        {
+          dfa->states[trans->state_id] = trans->state;
+          assertions |= trans->assertions;
+          if (trans->state == tnfa->final)
+            {
+              dfa->final_id = trans->state_id;
+            }
+        }
+    }
+
+  for (trans = tnfa->initial; trans->state; trans++)
+    {
+      dfa->states[trans->state_id] = trans->state;
+      assertions |= trans->assertions;
+      if (trans->state == tnfa->final)
+        {
+          dfa->final_id = trans->state_id;
+        }
+    }
+
+  if (dfa->final_id < 0)
+    {
+      goto errout;
+    }
+
+  for (i = 0; i < (unsigned int)tnfa->num_states; i++)
+    {
+      if (dfa->states[i] == NULL)
+        {
+          goto errout;
+        }
+    }
+
+  dfa->newline = (tnfa->cflags & REG_NEWLINE) != 0;
+  dfa->icase   = (tnfa->cflags & REG_ICASE) != 0;
+  dfa->nla     = assertions & DFA_LOOKAHEAD_ASSERTIONS ?
+                 DFA_LA_CLASSES : 1;
+
+  tre_dfa_classify(dfa, tnfa, &nclasses);
+  dfa->nrow = nclasses * dfa->nla;
+
+  /* The budget holds the DFA states, their row and a few ids each */
+
+  dfa->maxcache = CONFIG_LIBC_REGEX_DFA_CACHE_SIZE /
+                  (sizeof(struct tre_dfa_state) +
+                   (dfa->nrow + 4) * sizeof(int16_t));
+  if (dfa->maxcache < 4)
+    {
+      goto errout;
+    }
+
+  dfa->cache      = xmalloc(CONFIG_LIBC_REGEX_DFA_CACHE_SIZE);
+  if (dfa->cache == NULL)
+    {
+      goto errout;
+    }
+
+  dfa->arena      = (char *)(dfa->cache + dfa->maxcache);
+  dfa->arena_size = CONFIG_LIBC_REGEX_DFA_CACHE_SIZE -
+                    dfa->maxcache * sizeof(struct tre_dfa_state);
+
+  nxmutex_init(&dfa->lock);
+  tnfa->dfa = dfa;
+  return;
+
+errout:
+  xfree(dfa->states);
+  xfree(dfa->mark);
+  xfree(dfa->scratch);
+  xfree(dfa);
+}
+
+void tre_dfa_destroy(tre_tnfa_t *tnfa)
+{
+  struct tre_dfa *dfa = tnfa->dfa;
+
+  if (dfa != NULL)
+    {
+      nxmutex_destroy(&dfa->lock);
+      xfree(dfa->cache);
+      xfree(dfa->states);
+      xfree(dfa->mark);
+      xfree(dfa->scratch);
+      xfree(dfa);
+      tnfa->dfa = NULL;
+    }
+}
+
+/* Run the TNFA without tags as a DFA, each set of TNFA states reached at
+ * a position is a DFA state built the first time it is needed.  The
+ * transitions by the characters below 256 are cached in the rows of the
+ * states, the others are computed every time.  The match is the first
+ * position the final state is reached at, as the parallel matcher does
+ * without tags.
+ */
+
+reg_errcode_t tre_dfa_match(const tre_tnfa_t *tnfa, const char *string,
+                            int eflags)
+{
+  struct tre_dfa *dfa = tnfa->dfa;
+  struct tre_dfa_state *state;
+  reg_errcode_t ret = REG_NOMATCH;
+  tre_char_t next_c;
+  tre_char_t c;
+  int flushed;
+  int cur;
+  int len;
+  int ctx;
+  int la;
+  int n;
+
+  if (dfa == NULL || nxmutex_trylock(&dfa->lock) < 0)
+    {
+      return TRE_DFA_UNKNOWN;
+    }
+
+  len = tre_dfa_next(string, &next_c);
+  if (len < 0)
+    {
+      goto out;
+    }
+
+  string += len;
+
+  /* The start, no character before */
+
+  ctx = tre_dfa_context(dfa, L'\0', next_c, eflags) | DFA_CTX_EDGE;
+  ctx = (ctx & ~DFA_CTX_BOL) | (eflags & REG_NOTBOL ? 0 : DFA_CTX_BOL);
+
+  flushed = 0;
+  n   = tre_dfa_step(dfa, tnfa, NULL, 0, L'\0', ctx);
+  cur = tre_dfa_state(dfa, n, &flushed);
+  if (cur < 0)
+    {
+      ret = TRE_DFA_UNKNOWN;
+      goto out;
+    }
+
+  while (!dfa->cache[cur].final)
+    {
+      if (next_c == L'\0')
+        {
+          goto out;
+        }
+
+      c   = next_c;
+      len = tre_dfa_next(string, &next_c);
+      if (len < 0)
+        {
+          goto out;
+        }
+
+      string += len;
+
+      /* The row of the next character, none for the end of the string if
+       * the assertions need to know.
+       */
+
+      la = -1;
+      if ((tre_cint_t)c < 256)
+        {
+          if (dfa->nla == 1)
+            {
+              la = 0;
+            }
+          else if (next_c != L'\0')
+            {
+              la = next_c == L'\n' ? DFA_LA_NEWLINE :
+                   DFA_IS_WORD_CHAR(next_c) ? DFA_LA_WORD : DFA_LA_OTHER;
+            }
+        }
+
+      state = &dfa->cache[cur];
+      if (la >= 0)
+        {
+          la = dfa->classes[c] * dfa->nla + la;
+          if (state->next[la] >= 0)
+            {
+              cur = state->next[la];
+              continue;
+            }
+        }
+
+      ctx     = tre_dfa_context(dfa, c, next_c, eflags);
+      n       = tre_dfa_step(dfa, tnfa, state->set, state->nset, c, ctx);
+      flushed = 0;
+      n       = tre_dfa_state(dfa, n, &flushed);
+      if (n < 0)
+        {
+          ret = TRE_DFA_UNKNOWN;
+          goto out;
+        }
+
+      if (la >= 0 && !flushed)
+        {
+          state->next[la] = n;
+        }
+
+      cur = n;
+    }
+
+  ret = REG_OK;
+
+out:
+  nxmutex_unlock(&dfa->lock);
+  return ret;
+}
@@ -36,6 +36,8 @@
 #ifndef _REGEX_TRE_H
 #define _REGEX_TRE_H
 
+#include <nuttx/config.h>
+
 #include <regex.h>
 #include <wchar.h>
 #include <wctype.h>
@@ -211,8 +213,38 @@ struct tnfa
   int cflags;
   int have_backrefs;
   int have_approx;
+#ifdef CONFIG_LIBC_REGEX_DFA
+  struct tre_dfa *dfa;
+#endif
 };
 
+/* from tre-dfa.c: */
+
+#ifdef CONFIG_LIBC_REGEX_DFA
+
+/* tre_dfa_match() cannot tell, the TNFA matchers must run */
+
+#define TRE_DFA_UNKNOWN     (-1)
+
+#define tre_dfa_create      __tre_dfa_create
+#define tre_dfa_destroy     __tre_dfa_destroy
+#define tre_dfa_match       __tre_dfa_match
+
+/* Build the lazy DFA of a TNFA without back references.  Failing is not an
+ * error, the TNFA matchers do all the work then.
+ */
+
+void tre_dfa_create(tre_tnfa_t *tnfa);
+void tre_dfa_destroy(tre_tnfa_t *tnfa);
+
+/* REG_OK or REG_NOMATCH if the string has a match or not, TRE_DFA_UNKNOWN
+ * if the DFA is in use by another thread.
+ */
+
+reg_errcode_t tre_dfa_match(const tre_tnfa_t *tnfa, const char *string,
+                            int eflags);
+#endif
+
 /* from tre-mem.h: */
 
 #define TRE_MEM_BLOCK_SIZE  1024
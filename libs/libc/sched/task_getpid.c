@@ -0,0 +1,63 @@
+/****************************************************************************
+ * libs/libc/sched/task_getpid.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <nuttx/tls.h>
+
+/* The kernel keeps its own getpid(), user space reads the cached value */
+
+#if defined(CONFIG_TLS_GETPID) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: getpid
+ *
+ * Description:
+ *   Get the process ID of the currently executing thread.  The ID was
+ *   recorded in the TLS of the thread when it was created.
+ *
+ * Input parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The process ID of the calling process.
+ *
+ ****************************************************************************/
+
+pid_t getpid(void)
+{
+  FAR struct tls_info_s *tls = tls_get_info();
+  return tls->tl_pid;
+}
+
+#endif /* CONFIG_TLS_GETPID && !__KERNEL__ */
@@ -43,7 +43,9 @@
 
 #include <sys/types.h>
 #include <sys/param.h>
+#include <stdbool.h>
 #include <stdlib.h>
+#include <strings.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -79,14 +81,22 @@
 
 #define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
 
+#define CMP(a, b) compar(a, b, arg)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE int (*qsort_compar_t)(FAR const void *, FAR const void *,
+                                   FAR void *);
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
 static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *));
+                             qsort_compar_t compar, FAR void *arg);
 
 /****************************************************************************
  * Private Functions
@@ -105,59 +115,117 @@ static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
 }
 
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *))
+                             qsort_compar_t compar, FAR void *arg)
 {
-  return compar(a, b) < 0 ?
-         (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a)) :
-         (compar(b, c) > 0 ? b : (compar(a, c) < 0 ? a : c));
+  return CMP(a, b) < 0 ?
+         (CMP(b, c) < 0 ? b : (CMP(a, c) < 0 ? c : a)) :
+         (CMP(b, c) > 0 ? b : (CMP(a, c) < 0 ? a : c));
 }
 
 /****************************************************************************
- * Public Function
- ****************************************************************************/
-
-/****************************************************************************
- * Name: qsort
+ * Name: qsort_insert
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
+ *   Insertion sort, giving up after 'limit' moves if 'limit' is not zero.
  *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
- *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
+ * Returned Value:
+ *   true if the array is sorted.
  *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
+ ****************************************************************************/
+
+static bool qsort_insert(FAR char *base, size_t nel, size_t width,
+                         qsort_compar_t compar, FAR void *arg,
+                         int swaptype, size_t limit)
+{
+  FAR char *pm;
+  FAR char *pl;
+  size_t moves = 0;
+
+  for (pm = base + width; pm < base + nel * width; pm += width)
+    {
+      for (pl = pm; pl > base && CMP(pl - width, pl) > 0; pl -= width)
+        {
+          swap(pl, pl - width);
+        }
+
+      moves += (pm - pl) / width;
+      if (limit != 0 && moves > limit)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: qsort_heap
  *
- *   (Based on description from OpenGroup.org).
+ * Description:
+ *   Heapsort, the O(n log n) fallback of a partitioning that goes too deep.
  *
- * Returned Value:
- *   The qsort() function will not return a value.
+ ****************************************************************************/
+
+static void qsort_heap(FAR char *base, size_t nel, size_t width,
+                       qsort_compar_t compar, FAR void *arg, int swaptype)
+{
+  FAR char *pr;
+  FAR char *pc;
+  size_t root;
+  size_t child;
+  size_t i;
+  size_t n;
+
+  for (i = nel / 2, n = nel; ; )
+    {
+      if (i > 0)
+        {
+          root = --i;
+        }
+      else if (--n > 0)
+        {
+          swap(base, base + n * width);
+          root = 0;
+        }
+      else
+        {
+          break;
+        }
+
+      /* Sift the root down */
+
+      while ((child = 2 * root + 1) < n)
+        {
+          pr = base + root * width;
+          pc = base + child * width;
+          if (child + 1 < n && CMP(pc, pc + width) < 0)
+            {
+              child++;
+              pc += width;
+            }
+
+          if (CMP(pr, pc) >= 0)
+            {
+              break;
+            }
+
+          swap(pr, pc);
+          root = child;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: qsort_loop
  *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ * Description:
+ *   Bentley & McIlroy's quicksort, turning into heapsort when 'depth'
+ *   levels of partitioning are used up, as in introsort.
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static void qsort_loop(FAR char *base, size_t nel, size_t width,
+                       qsort_compar_t compar, FAR void *arg, int depth)
 {
   FAR char *pa;
   FAR char *pb;
@@ -166,55 +234,52 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
+  size_t d;
+  size_t n;
   int swaptype;
   int swap_cnt;
-  int d;
   int r;
 
-loop:
   SWAPINIT(base, width);
+
+loop:
   swap_cnt = 0;
 
   if (nel < 7)
     {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
-        {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
-        }
+      qsort_insert(base, nel, width, compar, arg, swaptype, 0);
+      return;
+    }
 
+  if (depth-- == 0)
+    {
+      qsort_heap(base, nel, width, compar, arg, swaptype);
       return;
     }
 
-  pm = (FAR char *)base + (nel / 2) * width;
+  pm = base + (nel / 2) * width;
   if (nel > 7)
     {
       pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
+      pn = base + (nel - 1) * width;
       if (nel > 40)
         {
           d  = (nel / 8) * width;
-          pl = med3(pl, pl + d, pl + 2 * d, compar);
-          pm = med3(pm - d, pm, pm + d, compar);
-          pn = med3(pn - 2 * d, pn - d, pn, compar);
+          pl = med3(pl, pl + d, pl + 2 * d, compar, arg);
+          pm = med3(pm - d, pm, pm + d, compar, arg);
+          pn = med3(pn - 2 * d, pn - d, pn, compar, arg);
         }
 
-      pm = med3(pl, pm, pn, compar);
+      pm = med3(pl, pm, pn, compar, arg);
     }
 
   swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+  pa = pb = base + width;
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
+  pc = pd = base + (nel - 1) * width;
   for (; ; )
     {
-      while (pb <= pc && (r = compar(pb, base)) <= 0)
+      while (pb <= pc && (r = CMP(pb, base)) <= 0)
         {
           if (r == 0)
             {
@@ -226,7 +291,7 @@ loop:
           pb += width;
         }
 
-      while (pb <= pc && (r = compar(pc, base)) >= 0)
+      while (pb <= pc && (r = CMP(pc, base)) >= 0)
         {
           if (r == 0)
             {
@@ -249,43 +314,134 @@ loop:
       pc      -= width;
     }
 
+  /* Only the pivot moved, the partition is likely sorted already: put
+   * the pivot back and try an insertion sort.  It may only move 'nel'
+   * elements, linear like the partitioning, so a crafted input can not
+   * make this quadratic.  If it gives up, start over.
+   */
+
   if (swap_cnt == 0)
     {
-      /* Switch to insertion sort */
-
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      swap(base, pm);
+      if (qsort_insert(base, nel, width, compar, arg, swaptype, nel))
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          return;
         }
 
-      return;
+      goto loop;
     }
 
-  pn = (FAR char *)base + nel * width;
-  r  = MIN(pa - (FAR char *)base, pb - pa);
+  pn = base + nel * width;
+  r  = MIN(pa - base, pb - pa);
   vecswap(base, pb - r, r);
 
   r  = MIN(pd - pc, pn - pd - width);
   vecswap(pb, pn - r, r);
 
-  if ((r = pb - pa) > width)
+  /* Recurse into the smaller side and iterate on the larger one */
+
+  d = pb - pa;
+  n = pd - pc;
+  if (d > n)
     {
-      qsort(base, r / width, width, compar);
-    }
+      if (n > width)
+        {
+          qsort_loop(pn - n, n / width, width, compar, arg, depth);
+        }
 
-  if ((r = pd - pc) > width)
+      n = d;
+    }
+  else
     {
-      /* Iterate rather than recurse to save stack space */
+      if (d > width)
+        {
+          qsort_loop(base, d / width, width, compar, arg, depth);
+        }
 
-      base = pn - r;
-      nel = r / width;
+      base = pn - n;
+    }
+
+  if (n > width)
+    {
+      nel = n / width;
       goto loop;
     }
 }
+
+static int qsort_compar(FAR const void *a, FAR const void *b, FAR void *arg)
+{
+  return (*(CODE int (**)(FAR const void *, FAR const void *))arg)(a, b);
+}
+
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort_r
+ *
+ * Description:
+ *   Same as qsort(), except that 'arg' is passed as the third argument of
+ *   each call of 'compar', so compar needs no global state.
+ *
+ ****************************************************************************/
+
+void qsort_r(FAR void *base, size_t nel, size_t width,
+             CODE int (*compar)(FAR const void *, FAR const void *,
+                                FAR void *),
+             FAR void *arg)
+{
+  if (nel > 1 && width > 0)
+    {
+      /* Up to 2 * log2(nel) levels of partitioning like in introsort */
+
+      qsort_loop(base, nel, width, compar, arg, 2 * (flsl(nel) - 1));
+    }
+}
+
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes from the original BSD version:
+ *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *   A depth limit with a heapsort fallback bounds the worst case to
+ *   O(n log n).
+ *
+ ****************************************************************************/
+
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  qsort_r(base, nel, width, qsort_compar, &compar);
+}
@@ -40,6 +40,12 @@
 #include <stdbool.h>
 #include <errno.h>
 #include <math.h>
+#include <string.h>
+#include <strings.h>
+
+#include <nuttx/lib/math32.h>
+
+#include "libc.h"
 
 /****************************************************************************
  * Pre-processor definitions
@@ -84,10 +90,33 @@
 #  define llong_min LONG_MIN
 #endif
 
+/* Largest significand the Clinger fast path multiplies exactly */
+
+#define FAST_MANT_MAX (UINT64_C(1) << DBL_MANT_DIG)
+#define FAST_EXP_MAX  22
+
+/* floor(log2(10^e)) */
+
+#define FAST_FLOOR_LOG2_POW10(e) (((e) * 1741647) >> 19)
+
 #define shgetc(f) (*(f)++)
 #define shunget(f) ((f)--)
 #define ifexist(a,b) do { if ((a) != NULL) {*(a) = (b);} } while (0)
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if defined(CONFIG_HAVE_LONG_DOUBLE) && defined(CONFIG_LIBC_FAST_FLOAT)
+/* Powers of ten that are exact doubles */
+
+static const double g_pow10_exact[FAST_EXP_MAX + 1] =
+{
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -416,6 +445,170 @@ static long_double decfloat(FAR char *ptr, FAR char **endptr)
   return y;
 }
 
+#ifdef CONFIG_LIBC_FAST_FLOAT
+/****************************************************************************
+ * Name: fastfloat
+ *
+ * Description:
+ *   Convert a decimal string to a correctly rounded double, with the
+ *   Clinger fast path or the Eisel-Lemire algorithm.
+ *
+ * Input Parameters:
+ *   ptr    - A decimal string
+ *   endptr - If have ,the part that holds all but the numbers
+ *   result - The double
+ *
+ * Returned Value:
+ *   true on success; false if the caller must use decfloat: more than 19
+ *   significant digits, a result too close to a halfway case, or out of
+ *   the normal range.
+ *
+ ****************************************************************************/
+
+static bool fastfloat(FAR char *ptr, FAR char **endptr,
+                      FAR double *result)
+{
+  FAR const uint64_t *g;
+  FAR char *f = ptr;
+  uint64_t mant = 0;
+  uint64_t bits;
+  uint64_t p1;
+  uint64_t p2;
+  int ndigit = 0;
+  int exp10 = 0;
+  int shift;
+  int exp2;
+  int lz;
+
+  /* Up to 19 significant digits fit in the 64-bit significand */
+
+  for (; isdigit(*f); f++)
+    {
+      if (mant != 0 || *f != '0')
+        {
+          if (++ndigit > 19)
+            {
+              return false;
+            }
+
+          mant = 10 * mant + *f - '0';
+        }
+    }
+
+  if (*f == '.')
+    {
+      for (f++; isdigit(*f); f++)
+        {
+          if (mant != 0 || *f != '0')
+            {
+              if (++ndigit > 19)
+                {
+                  return false;
+                }
+
+              mant = 10 * mant + *f - '0';
+            }
+
+          exp10--;
+        }
+    }
+
+  if ((*f | 32) == 'e' && (isdigit(f[1]) ||
+                           ((f[1] == '+' || f[1] == '-') && isdigit(f[2]))))
+    {
+      bool neg = f[1] == '-';
+      int e = 0;
+
+      f += isdigit(f[1]) ? 1 : 2;
+      for (; isdigit(*f); f++)
+        {
+          if (e < 100000)
+            {
+              e = 10 * e + *f - '0';
+            }
+        }
+
+      exp10 += neg ? -e : e;
+    }
+
+  if (mant == 0)
+    {
+      *result = 0.;
+      ifexist(endptr, f);
+      return true;
+    }
+
+  /* Both the significand and the power of ten are exact doubles, so a
+   * single rounding gives the correct result.
+   */
+
+  if (mant <= FAST_MANT_MAX && exp10 >= -FAST_EXP_MAX &&
+      exp10 <= FAST_EXP_MAX)
+    {
+      if (exp10 < 0)
+        {
+          exp10   = -exp10;
+          *result = (double)mant / g_pow10_exact[exp10];
+        }
+      else
+        {
+          *result = (double)mant * g_pow10_exact[exp10];
+        }
+
+      ifexist(endptr, f);
+      return true;
+    }
+
+  if (exp10 < LIB_POW10_MIN || exp10 > DBL_MAX_10_EXP)
+    {
+      return false;
+    }
+
+  /* mant * 10^exp10 from the top 128 bits of the product with the 128-bit
+   * significand of 10^exp10.  The significand is rounded up by less than
+   * one, so the product is too large by less than 2^64: the bits above
+   * the rounding bit are right unless all the bits below it are zero.
+   */
+
+  lz    = 64 - flsll(mant);
+  mant <<= lz;
+  g     = g_pow10_significand[exp10 - LIB_POW10_MIN];
+  p1    = mant * g[0];
+  p2    = invdiv_umulh64(mant, g[0]);
+  bits  = invdiv_umulh64(mant, g[1]);
+  p1   += bits;
+  p2   += p1 < bits;
+
+  shift = 9 + (p2 >> 63);
+  if (((p2 & ((UINT64_C(1) << shift) - 1)) | p1) == 0)
+    {
+      return false;
+    }
+
+  /* 54 bits with the rounding bit, then 53 rounded half up */
+
+  bits  = ((p2 >> shift) + 1) >> 1;
+  exp2  = FAST_FLOOR_LOG2_POW10(exp10) + 2 + shift - lz;
+  if ((bits >> DBL_MANT_DIG) != 0)
+    {
+      bits >>= 1;
+      exp2++;
+    }
+
+  exp2 += DBL_MANT_DIG - 1 + DBL_MAX_EXP - 1;
+  if (exp2 <= 0 || exp2 >= 2 * DBL_MAX_EXP - 1)
+    {
+      return false;
+    }
+
+  bits = (bits & ((UINT64_C(1) << (DBL_MANT_DIG - 1)) - 1)) |
+         ((uint64_t)exp2 << (DBL_MANT_DIG - 1));
+  memcpy(result, &bits, sizeof(bits));
+  ifexist(endptr, f);
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: hexfloat
  *
@@ -725,7 +918,19 @@ static long_double strtox(FAR const char *str, FAR char **endptr, int flag)
 #endif
   if (isdigit(*s) || (*s == '.' && isdigit(*(s + 1))))
     {
-      y = decfloat(s, endptr);
+#ifdef CONFIG_LIBC_FAST_FLOAT
+      double d;
+
+      if ((flag == 2 || (flag == 3 && LDBL_MANT_DIG == DBL_MANT_DIG)) &&
+          fastfloat(s, endptr, &d))
+        {
+          y = d;
+        }
+      else
+#endif
+        {
+          y = decfloat(s, endptr);
+        }
     }
   else
     {
@@ -49,7 +49,15 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define DTOA_MAX_DIG        DBL_DIG
+/* The table driven engine gives all the digits needed to read a double
+ * back, the default one those it computes exactly.
+ */
+
+#ifdef CONFIG_LIBC_FAST_FLOAT
+#  define DTOA_MAX_DIG      17
+#else
+#  define DTOA_MAX_DIG      DBL_DIG
+#endif
 
 #define DTOA_MINUS          1
 #define DTOA_ZERO           2
@@ -0,0 +1,325 @@
+/****************************************************************************
+ * libs/libc/stream/lib_dtoa_fast.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/lib/math32.h>
+
+#include "libc.h"
+#include "lib_dtoa_engine.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if DBL_MANT_DIG != 53
+#  error CONFIG_LIBC_FAST_FLOAT needs IEEE 754 binary64 doubles
+#endif
+
+#define DTOA_FRAC_BITS            52
+#define DTOA_EXP_BIAS             (1023 + DTOA_FRAC_BITS)
+
+/* floor(log10(2^e)), floor(log10(3/4 * 2^e)) and floor(log2(10^e)) */
+
+#define DTOA_FLOOR_LOG10_POW2(e)  (((e) * 1262611) >> 22)
+#define DTOA_FLOOR_LOG10_P34(e)   (((e) * 1262611 - 524031) >> 22)
+#define DTOA_FLOOR_LOG2_POW10(e)  (((e) * 1741647) >> 19)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct dtoa_shortest_s
+{
+  uint64_t digits;          /* Shortest decimal digits */
+  int exp10;                /* Exponent of their last digit */
+  uint64_t vb;              /* 4 * x / 10^k, rounded to odd */
+  int k;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dtoa_round_to_odd
+ *
+ * Description:
+ *   Return the high 64 bits of the 192-bit product g * cp, with the lowest
+ *   bit set if anything below them is not zero.
+ *
+ ****************************************************************************/
+
+static uint64_t dtoa_round_to_odd(FAR const uint64_t *g, uint64_t cp)
+{
+  uint64_t xh = invdiv_umulh64(g[1], cp);
+  uint64_t y0 = g[0] * cp + xh;
+  uint64_t y1 = invdiv_umulh64(g[0], cp) + (y0 < xh);
+
+  return y1 | (y0 > 1);
+}
+
+/****************************************************************************
+ * Name: dtoa_shortest
+ *
+ * Description:
+ *   Find the shortest decimal digits * 10^exp10 that rounds back to the
+ *   finite, non-zero double 'bits', the closest one if there are several.
+ *   This is the Schubfach algorithm of Raffaello Giulietti.
+ *
+ ****************************************************************************/
+
+static void dtoa_shortest(uint64_t bits, FAR struct dtoa_shortest_s *res)
+{
+  uint64_t frac = bits & ((UINT64_C(1) << DTOA_FRAC_BITS) - 1);
+  int biased = (bits >> DTOA_FRAC_BITS) & 0x7ff;
+  FAR const uint64_t *g;
+  uint64_t lower;
+  uint64_t upper;
+  uint64_t cbl;
+  uint64_t vbl;
+  uint64_t vb;
+  uint64_t vbr;
+  uint64_t c;
+  uint64_t s;
+  bool closer;
+  bool even;
+  bool uin;
+  bool win;
+  int idx;
+  int q;
+  int k;
+  int h;
+
+  if (biased != 0)
+    {
+      c = (UINT64_C(1) << DTOA_FRAC_BITS) | frac;
+      q = biased - DTOA_EXP_BIAS;
+    }
+  else
+    {
+      c = frac;
+      q = 1 - DTOA_EXP_BIAS;
+    }
+
+  /* The rounding interval is [cbl, cbr] * 2^(q - 2), narrower below the
+   * powers of two.  It is closed when the double is even.
+   */
+
+  even   = (c & 1) == 0;
+  closer = frac == 0 && biased > 1;
+  cbl    = 4 * c - 2 + closer;
+  k      = closer ? DTOA_FLOOR_LOG10_P34(q) : DTOA_FLOOR_LOG10_POW2(q);
+  h      = q + DTOA_FLOOR_LOG2_POW10(-k) + 1;
+  idx    = -k - LIB_POW10_MIN;
+  g      = g_pow10_significand[idx];
+
+  vbl    = dtoa_round_to_odd(g, cbl << h);
+  vb     = dtoa_round_to_odd(g, (4 * c) << h);
+  vbr    = dtoa_round_to_odd(g, (4 * c + 2) << h);
+  lower  = vbl + !even;
+  upper  = vbr - !even;
+  s      = vb / 4;
+
+  res->vb = vb;
+  res->k  = k;
+
+  /* One digit less is the shortest if exactly one of its neighbours is
+   * inside the interval.
+   */
+
+  if (s >= 10)
+    {
+      uint64_t sp = s / 10;
+
+      uin = lower <= 40 * sp;
+      win = 40 * sp + 40 <= upper;
+      if (uin != win)
+        {
+          res->digits = sp + win;
+          res->exp10  = k + 1;
+          return;
+        }
+    }
+
+  uin = lower <= 4 * s;
+  win = 4 * s + 4 <= upper;
+  res->exp10 = k;
+  if (uin != win)
+    {
+      res->digits = s + win;
+      return;
+    }
+
+  /* Both are inside, take the closest one, the even one on a tie */
+
+  res->digits = s + (vb > 4 * s + 2 || (vb == 4 * s + 2 && (s & 1) != 0));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: __dtoa_engine
+ *
+ * Description:
+ *   Same interface as the default engine: 'max_digits' digits from the
+ *   first significant one, no more than 'max_decimals' after the decimal
+ *   point if not zero.  The shortest digits are rounded to this length or
+ *   padded with zeros.
+ *
+ ****************************************************************************/
+
+int __dtoa_engine(double x, FAR struct dtoa_s *dtoa, int max_digits,
+                  int max_decimals)
+{
+  int32_t exp = 0;
+  uint8_t flags = 0;
+  int i;
+
+  if (x < 0)
+    {
+      flags |= DTOA_MINUS;
+      x = -x;
+    }
+
+  if (x == 0)
+    {
+      flags |= DTOA_ZERO;
+      for (i = 0; i < max_digits; i++)
+        {
+          dtoa->digits[i] = '0';
+        }
+    }
+  else if (isnan(x))
+    {
+      flags |= DTOA_NAN;
+    }
+  else if (isinf(x))
+    {
+      flags |= DTOA_INF;
+    }
+  else
+    {
+      struct dtoa_shortest_s res;
+      uint64_t digits;
+      uint64_t scale;
+      uint64_t bits;
+      int n;
+
+      memcpy(&bits, &x, sizeof(bits));
+      dtoa_shortest(bits, &res);
+
+      digits = res.digits;
+      for (n = 1, scale = 10; scale <= digits; n++)
+        {
+          scale *= 10;
+        }
+
+      exp = res.exp10 + n - 1;
+
+      /* If limiting decimals, then limit the max digits to no more than the
+       * number of digits left of the decimal plus the number of digits right
+       * of the decimal.
+       */
+
+      if (max_decimals != 0)
+        {
+          max_digits = MIN(max_digits, max_decimals + MAX(exp + 1, 0));
+        }
+
+      if (n > max_digits)
+        {
+          uint64_t half;
+          uint64_t rem;
+          bool up;
+
+          for (scale = 1, i = max_digits; i < n; i++)
+            {
+              scale *= 10;
+            }
+
+          rem    = digits % scale;
+          digits = digits / scale;
+          half   = scale / 2;
+
+          /* Exactly half of the last kept digit left: tell on which side
+           * of it the double is from its scaled value, round to even if
+           * it is exact.
+           */
+
+          up = rem > half;
+          if (rem == half)
+            {
+              half = 4 * (digits * scale + half);
+              if (res.exp10 > res.k)
+                {
+                  half *= 10;
+                }
+
+              up = res.vb > half || (res.vb == half && (digits & 1) != 0);
+            }
+
+          /* Rounding 9...9 up gives a new leading digit */
+
+          for (scale = 1, i = 0; i < max_digits; i++)
+            {
+              scale *= 10;
+            }
+
+          digits += up;
+          if (digits == scale)
+            {
+              digits /= 10;
+              exp++;
+            }
+
+          n = max_digits;
+        }
+
+      for (i = n; i < max_digits; i++)
+        {
+          dtoa->digits[i] = '0';
+        }
+
+      for (i = n - 1; i >= 0; i--)
+        {
+          dtoa->digits[i] = digits % 10 + '0';
+          digits /= 10;
+        }
+    }
+
+  dtoa->digits[max_digits] = '\0';
+  dtoa->flags = flags;
+  dtoa->exp = exp;
+  return max_digits;
+}
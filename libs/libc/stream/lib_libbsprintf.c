@@ -29,11 +29,225 @@
 #include <string.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One packed argument, as lib_bsprintf() reads it back */
+
+begin_packed_struct union bsarg_u
+{
+  char c;
+  char s[1];
+  short int si;
+  int i;
+  long l;
+#ifdef CONFIG_HAVE_LONG_LONG
+  long long ll;
+#endif
+  intmax_t im;
+  size_t sz;
+  ptrdiff_t pd;
+  uintptr_t p;
+#ifdef CONFIG_HAVE_DOUBLE
+  float f;
+  double d;
+#  ifdef CONFIG_HAVE_LONG_DOUBLE
+  long double ld;
+#  endif
+#endif
+} end_packed_struct;
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: lib_bspack
+ ****************************************************************************/
+
+ssize_t lib_bspack(FAR void *buf, size_t size, FAR const IPTR char *fmt,
+                   va_list ap)
+{
+  FAR union bsarg_u *var;
+  FAR const char *prec = NULL;
+  FAR char *data = buf;
+  bool infmt = false;
+  size_t offset = 0;
+  size_t len;
+  char c;
+
+#define BSPACK(field, value) \
+  do \
+    { \
+      if (offset + sizeof(var->field) > size) \
+        { \
+          return -E2BIG; \
+        } \
+      \
+      var->field = (value); \
+      offset += sizeof(var->field); \
+    } \
+  while (0)
+
+  while ((c = *fmt++) != '\0')
+    {
+      if (c != '%' && !infmt)
+        {
+          continue;
+        }
+
+      if (!infmt)
+        {
+          infmt = true;
+          prec  = NULL;
+          continue;
+        }
+
+      var = (FAR void *)(data + offset);
+
+      if (c == 'c' || c == 'd' || c == 'i' || c == 'u' ||
+          c == 'o' || c == 'x' || c == 'X')
+        {
+          if (*(fmt - 2) == 'j')
+            {
+              BSPACK(im, va_arg(ap, intmax_t));
+            }
+#ifdef CONFIG_HAVE_LONG_LONG
+          else if (*(fmt - 2) == 'l' && *(fmt - 3) == 'l')
+            {
+              BSPACK(ll, va_arg(ap, long long));
+            }
+#endif
+          else if (*(fmt - 2) == 'l')
+            {
+              BSPACK(l, va_arg(ap, long));
+            }
+          else if (*(fmt - 2) == 'z')
+            {
+              BSPACK(sz, va_arg(ap, size_t));
+            }
+          else if (*(fmt - 2) == 't')
+            {
+              BSPACK(pd, va_arg(ap, ptrdiff_t));
+            }
+          else if (*(fmt - 2) == 'h' && *(fmt - 3) == 'h')
+            {
+              BSPACK(c, (char)va_arg(ap, int));
+            }
+          else if (*(fmt - 2) == 'h')
+            {
+              BSPACK(si, (short int)va_arg(ap, int));
+            }
+          else
+            {
+              BSPACK(i, va_arg(ap, int));
+            }
+
+          infmt = false;
+        }
+      else if (c == 'e' || c == 'f' || c == 'g' || c == 'a' ||
+               c == 'A' || c == 'E' || c == 'F' || c == 'G')
+        {
+#ifdef CONFIG_HAVE_DOUBLE
+          if (*(fmt - 2) == 'h')
+            {
+              BSPACK(f, (float)va_arg(ap, double));
+            }
+#  ifdef CONFIG_HAVE_LONG_DOUBLE
+          else if (*(fmt - 2) == 'L')
+            {
+              BSPACK(ld, va_arg(ap, long double));
+            }
+#  endif
+          else
+            {
+              BSPACK(d, va_arg(ap, double));
+            }
+
+          infmt = false;
+#else
+          return -ENOTSUP;
+#endif
+        }
+      else if (c == '*')
+        {
+          if (prec != NULL)
+            {
+              /* A run-time string precision cannot be replayed */
+
+              return -ENOTSUP;
+            }
+
+          BSPACK(i, va_arg(ap, int));
+        }
+      else if (c == 's')
+        {
+          FAR const char *str = va_arg(ap, FAR const char *);
+
+          if (str == NULL)
+            {
+              str = "(null)";
+            }
+
+          /* The string is copied, to exactly the precision if one is
+           * given, as lib_bsprintf() steps over that many bytes.
+           */
+
+          if (prec != NULL)
+            {
+              len = strtol(prec, NULL, 10);
+              if (offset + len > size)
+                {
+                  return -E2BIG;
+                }
+
+              strncpy(var->s, str, len);
+            }
+          else
+            {
+              len = strlen(str) + 1;
+              if (offset + len > size)
+                {
+                  return -E2BIG;
+                }
+
+              memcpy(var->s, str, len);
+            }
+
+          offset += len;
+          infmt   = false;
+        }
+      else if (c == 'p')
+        {
+          BSPACK(p, (uintptr_t)va_arg(ap, FAR void *));
+          infmt = false;
+        }
+      else if (c == '.')
+        {
+          prec = fmt;
+        }
+      else if (c == '%')
+        {
+          infmt = false;
+        }
+      else if (c == 'n')
+        {
+          return -ENOTSUP;
+        }
+    }
+
+#undef BSPACK
+
+  return offset;
+}
+
+/****************************************************************************
+ * Name: lib_bsprintf
+ ****************************************************************************/
+
 int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
                  FAR const void *buf)
 {
@@ -193,6 +407,12 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
         {
           prec = fmt;
         }
+      else if (c == '%' && len == 2)
+        {
+          lib_stream_putc(s, '%');
+          ret++;
+          infmt = false;
+        }
     }
 
   return ret;
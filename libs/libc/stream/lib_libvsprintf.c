@@ -40,6 +40,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/atomic.h>
 #include <nuttx/streams.h>
 #ifdef CONFIG_ALLSYMS
 #include <nuttx/allsyms.h>
@@ -136,12 +137,35 @@ struct arg_s
   FAR union arg_u *value;
 };
 
+#if defined(CONFIG_LIBC_NUMBERED_ARGS) && CONFIG_LIBC_NUMBERED_ARGS_CACHE > 0
+/* Argument types of a format with numbered arguments, from the parsing
+ * pass of an earlier call.  A slot busy in another context is treated as
+ * a miss, so the cache never blocks and can be used from interrupts.
+ */
+
+struct argcache_s
+{
+  atomic_t busy;
+  FAR const IPTR char *fmt;
+  int numargs;
+  unsigned char type[NL_ARGMAX];
+};
+#endif
+
 /****************************************************************************
  * Private Constant Data
  ****************************************************************************/
 
 static const char g_nullstring[] = "(null)";
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if defined(CONFIG_LIBC_NUMBERED_ARGS) && CONFIG_LIBC_NUMBERED_ARGS_CACHE > 0
+static struct argcache_s g_argcache[CONFIG_LIBC_NUMBERED_ARGS_CACHE];
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -192,6 +216,24 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
 
   for (; ; )
     {
+#ifndef CONFIG_ARCH_ROMGETC
+      /* Copy the text up to the next conversion in one go */
+
+      for (pnt = fmt; *fmt != '\0' && *fmt != '%'; fmt++)
+        {
+        }
+
+      size = fmt - pnt;
+#  ifdef CONFIG_LIBC_NUMBERED_ARGS
+      if (size > 0 && stream != NULL)
+#  else
+      if (size > 0)
+#  endif
+        {
+          stream_puts(pnt, size, stream);
+        }
+#endif
+
       for (; ; )
         {
           c = fmt_char(fmt);
@@ -1333,6 +1375,72 @@ ret:
   return total_len;
 }
 
+#ifdef CONFIG_LIBC_NUMBERED_ARGS
+/****************************************************************************
+ * Name: vsprintf_parse
+ *
+ * Description:
+ *   Collect the types of the numbered arguments of a format.  A format
+ *   without a '$' has none, which saves the parsing pass in the common
+ *   case.
+ *
+ * Returned Value:
+ *   The number of numbered arguments.
+ *
+ ****************************************************************************/
+
+static int vsprintf_parse(FAR struct arg_s *arglist,
+                          FAR const IPTR char *fmt, va_list ap)
+{
+  FAR const IPTR char *ptr = fmt;
+#if CONFIG_LIBC_NUMBERED_ARGS_CACHE > 0
+  FAR struct argcache_s *cache;
+  int expected = 0;
+#endif
+  int numargs;
+  char c;
+
+  while ((c = fmt_char(ptr)) != '$')
+    {
+      if (c == '\0')
+        {
+          return 0;
+        }
+    }
+
+#if CONFIG_LIBC_NUMBERED_ARGS_CACHE > 0
+  cache = &g_argcache[(uintptr_t)fmt % CONFIG_LIBC_NUMBERED_ARGS_CACHE];
+  if (atomic_cmpxchg_acquire(&cache->busy, &expected, 1))
+    {
+      if (cache->fmt == fmt)
+        {
+          numargs = cache->numargs;
+          memcpy(arglist->type, cache->type, numargs);
+          atomic_set_release(&cache->busy, 0);
+          return numargs;
+        }
+
+      atomic_set_release(&cache->busy, 0);
+    }
+#endif
+
+  numargs = vsprintf_internal(NULL, arglist, NL_ARGMAX, fmt, ap);
+
+#if CONFIG_LIBC_NUMBERED_ARGS_CACHE > 0
+  expected = 0;
+  if (atomic_cmpxchg_acquire(&cache->busy, &expected, 1))
+    {
+      cache->fmt     = fmt;
+      cache->numargs = numargs;
+      memcpy(cache->type, arglist->type, numargs);
+      atomic_set_release(&cache->busy, 0);
+    }
+#endif
+
+  return numargs;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1344,7 +1452,7 @@ int lib_vsprintf(FAR struct lib_outstream_s *stream,
   /* We do 2 passes of parsing and fill the arglist between the passes. */
 
   struct arg_s arglist;
-  int numargs = vsprintf_internal(NULL, &arglist, NL_ARGMAX, fmt, ap);
+  int numargs = vsprintf_parse(&arglist, fmt, ap);
   union arg_u argvalue[MAX(numargs, 1)];
   int i;
 
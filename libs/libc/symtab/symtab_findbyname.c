@@ -26,10 +26,8 @@
 
 #include <nuttx/config.h>
 
-#include <string.h>
 #include <debug.h>
 #include <assert.h>
-#include <errno.h>
 
 #include <nuttx/symtab.h>
 
@@ -41,9 +39,8 @@
  * Name: symtab_findbyname
  *
  * Description:
- *   Find the symbol in the symbol table with the matching name.
- *   This version assumes that table is not ordered with respect to symbol
- *   name and, hence, access time will be linear with respect to nsyms.
+ *   Find the symbol in the symbol table with the matching name, see
+ *   symtab_findbyhash() for the access time.
  *
  * Returned Value:
  *   A reference to the symbol table entry if an entry with the matching
@@ -55,18 +52,7 @@ FAR const struct symtab_s *
 symtab_findbyname(FAR const struct symtab_s *symtab,
                   FAR const char *name, int nsyms)
 {
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
-  int low  = 0;
-  int high = nsyms - 1;
-  int mid;
-  int cmp;
-#endif
-
-  if (symtab == NULL)
-    {
-      DEBUGASSERT(nsyms == 0);
-      return NULL;
-    }
+  DEBUGASSERT(name != NULL);
 
 #ifdef CONFIG_SYMTAB_DECORATED
   if (name[0] == '_')
@@ -75,59 +61,9 @@ symtab_findbyname(FAR const struct symtab_s *symtab,
     }
 #endif
 
-  DEBUGASSERT(name != NULL);
-
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
-  while (low < high)
-    {
-      /* Compare the name to the one in the middle.  (or just below
-       * the middle in the case where one is even and one is odd).
-       */
-
-      mid = (low + high) >> 1;
-      cmp = strcmp(name, symtab[mid].sym_name);
-      if (cmp < 0)
-        {
-          /* name < symtab[mid].sym_name
-           *
-           * NOTE: Because of truncation in the calculation of 'mid'.
-           * 'mid' could be equal to 'low'
-           */
-
-          high = mid > low ? mid - 1 : low;
-        }
-      else if (cmp > 0)
-        {
-          /* name > symtab[mid].sym_name */
-
-          low = mid + 1;
-        }
-      else
-        {
-          /* symtab[mid].sym_name == name */
-
-          return &symtab[mid];
-        }
-    }
-
-  /* low == high... One final check.  We might not have actually tested
-   * the final symtab[] name.
-   *
-   *   Example: Only the last pass through loop, suppose low = 1, high = 2,
-   *   mid = 1, and symtab[high].sym_name == name.  Then we would get here
-   *   with low = 2, high = 2, but symtab[2].sym_name was never tested.
-   */
-
-  return strcmp(name, symtab[low].sym_name) == 0 ? &symtab[low] : NULL;
+#ifdef CONFIG_SYMTAB_ORDEREDBYHASH
+  return symtab_findbyhash(symtab, name, symtab_hash(name), nsyms);
 #else
-  for (; nsyms > 0; symtab++, nsyms--)
-    {
-      if (strcmp(name, symtab->sym_name) == 0)
-        {
-          return symtab;
-        }
-    }
-
-  return NULL;
+  return symtab_findbyhash(symtab, name, 0, nsyms);
 #endif
 }
@@ -0,0 +1,54 @@
+/****************************************************************************
+ * libs/libc/symtab/symtab_hash.c
+ * libs/libc/symtab/symtab_sortbyname.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/symtab.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   Return the hash of a symbol name, the GNU ELF hash (h * 33 + c).
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hash(FAR const char *name)
+{
+  uint32_t hash = 5381;
+
+  while (*name != '\0')
+    {
+      hash = hash * 33 + (uint8_t)*name++;
+    }
+
+  return hash;
+}
@@ -0,0 +1,118 @@
+/****************************************************************************
+ * libs/libc/time/lib_clockgettime.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+#include <nuttx/vdso.h>
+
+/* The kernel has its own clock_gettime(); only user space reads the time
+ * data that the kernel publishes.
+ */
+
+#if defined(CONFIG_CLOCK_VDSO) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Written by the kernel through struct userspace_s::us_vdso */
+
+struct vdso_data_s g_vdso;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Return the time of the specified clock.  CLOCK_MONOTONIC,
+ *   CLOCK_BOOTTIME and CLOCK_REALTIME are computed from the data that the
+ *   kernel publishes in g_vdso without a system call; other clocks fall
+ *   back to nxclock_gettime().
+ *
+ * Input Parameters:
+ *   clock_id - The clock to read
+ *   tp       - The location to return the time
+ *
+ * Returned Value:
+ *   Zero (OK) on success;  -1 is returned on failure with the errno variable
+ *   set appropriately.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  struct timespec basetime;
+  uint32_t seq;
+  clock_t ticks;
+  int ret;
+
+  if (tp != NULL &&
+      (clock_id == CLOCK_MONOTONIC || clock_id == CLOCK_BOOTTIME ||
+       clock_id == CLOCK_REALTIME))
+    {
+      do
+        {
+          seq      = atomic_read_acquire((FAR atomic_t *)&g_vdso.vd_seq);
+          ticks    = g_vdso.vd_ticks;
+          basetime = g_vdso.vd_basetime;
+          SMP_RMB();
+        }
+      while ((seq & 1) != 0 || seq != g_vdso.vd_seq);
+
+      /* Nothing was published yet, ask the kernel */
+
+      if (seq != 0)
+        {
+          clock_ticks2time(tp, ticks);
+          if (clock_id == CLOCK_REALTIME)
+            {
+              clock_timespec_add(&basetime, tp, tp);
+            }
+
+          return OK;
+        }
+    }
+
+  ret = nxclock_gettime(clock_id, tp);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_CLOCK_VDSO && !__KERNEL__ */
@@ -53,6 +53,8 @@
 
 #include <sys/param.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
 #include <nuttx/irq.h>
 #include <nuttx/clock.h>
 #include <nuttx/init.h>
@@ -275,6 +277,31 @@ struct state_s
   int defaulttype;
 };
 
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+
+/* The local time type in force from start to before end, and the date of
+ * the local day number day.  It is written by the slow path of localsub()
+ * and read without a lock: seq is odd during an update, a reader retries
+ * on the slow path if it was odd or has changed.
+ */
+
+struct tzcache_s
+{
+  atomic_t seq;
+  time_t start;
+  time_t end;
+  time_t day;
+  int_fast32_t utoff;
+  int isdst;
+  FAR const char *abbr;
+  int year;
+  int mon;
+  int mday;
+  int wday;
+  int yday;
+};
+#endif
+
 struct rule_s
 {
   int r_type;                 /* type of rule; see below */
@@ -310,6 +337,10 @@ static rmutex_t g_gmt_lock = NXRMUTEX_INITIALIZER;
 
 static struct tm g_tm;
 
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+static struct tzcache_s g_lcl_cache;
+#endif
+
 static const int g_mon_lengths[2][MONSPERYEAR] =
 {
   {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31},
@@ -1902,6 +1933,141 @@ static void gmtload(FAR struct state_s *sp)
     }
 }
 
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+
+/* Start an update of the cache, false if another one is in progress */
+
+static bool tzcache_write_begin(FAR int32_t *seq)
+{
+  *seq = atomic_read(&g_lcl_cache.seq);
+  return (*seq & 1) == 0 &&
+         atomic_cmpxchg_acquire(&g_lcl_cache.seq, seq, *seq + 1);
+}
+
+static void tzcache_write_end(int32_t seq)
+{
+  atomic_set_release(&g_lcl_cache.seq, seq + 2);
+}
+
+/* Forget the cached type, when the time zone changes */
+
+static void tzcache_invalidate(void)
+{
+  int32_t seq;
+
+  if (tzcache_write_begin(&seq))
+    {
+      g_lcl_cache.start = 0;
+      g_lcl_cache.end   = 0;
+      tzcache_write_end(seq);
+    }
+}
+
+/* The local day number of t, and the seconds since its start */
+
+static time_t tzcache_day(time_t t, int_fast32_t utoff,
+                          FAR int_fast32_t *secs)
+{
+  time_t day;
+
+  t  += utoff;
+  day = t / SECSPERDAY;
+  *secs = t % SECSPERDAY;
+  if (*secs < 0)
+    {
+      *secs += SECSPERDAY;
+      day--;
+    }
+
+  return day;
+}
+
+/* Remember that the type of ttisp is in force from start to before end,
+ * and the date tmp of t.  The interval stays away from the extreme times,
+ * so that adding the offset cannot overflow.
+ */
+
+static void tzcache_update(time_t t, time_t start, time_t end,
+                           FAR const struct ttinfo_s *ttisp,
+                           FAR const struct tm *tmp)
+{
+  const time_t margin = 8 * SECSPERDAY;
+  int_fast32_t secs;
+  int32_t seq;
+
+  start = MAX(start, TIME_T_MIN + margin);
+  end   = MIN(end, TIME_T_MAX - margin);
+  if (t < start || t >= end || !tzcache_write_begin(&seq))
+    {
+      return;
+    }
+
+  g_lcl_cache.start = start;
+  g_lcl_cache.end   = end;
+  g_lcl_cache.day   = tzcache_day(t, ttisp->tt_utoff, &secs);
+  g_lcl_cache.utoff = ttisp->tt_utoff;
+  g_lcl_cache.isdst = tmp->tm_isdst;
+  g_lcl_cache.abbr  = tmp->tm_zone;
+  g_lcl_cache.year  = tmp->tm_year;
+  g_lcl_cache.mon   = tmp->tm_mon;
+  g_lcl_cache.mday  = tmp->tm_mday;
+  g_lcl_cache.wday  = tmp->tm_wday;
+  g_lcl_cache.yday  = tmp->tm_yday;
+  tzcache_write_end(seq);
+}
+
+/* Convert t with the cached type and date, NULL if t is out of the
+ * interval or of the day, or if the cache was being updated.
+ */
+
+static FAR struct tm *tzcache_localsub(time_t t, FAR struct tm *tmp)
+{
+  struct tzcache_s cache;
+  int_fast32_t secs;
+  int32_t seq;
+
+  seq = atomic_read_acquire(&g_lcl_cache.seq);
+  if ((seq & 1) != 0)
+    {
+      return NULL;
+    }
+
+  cache.start = g_lcl_cache.start;
+  cache.end   = g_lcl_cache.end;
+  cache.day   = g_lcl_cache.day;
+  cache.utoff = g_lcl_cache.utoff;
+  cache.isdst = g_lcl_cache.isdst;
+  cache.abbr  = g_lcl_cache.abbr;
+  cache.year  = g_lcl_cache.year;
+  cache.mon   = g_lcl_cache.mon;
+  cache.mday  = g_lcl_cache.mday;
+  cache.wday  = g_lcl_cache.wday;
+  cache.yday  = g_lcl_cache.yday;
+
+  SMP_RMB();
+  if (atomic_read(&g_lcl_cache.seq) != seq ||
+      t < cache.start || t >= cache.end ||
+      tzcache_day(t, cache.utoff, &secs) != cache.day)
+    {
+      return NULL;
+    }
+
+  tmp->tm_year   = cache.year;
+  tmp->tm_mon    = cache.mon;
+  tmp->tm_mday   = cache.mday;
+  tmp->tm_wday   = cache.wday;
+  tmp->tm_yday   = cache.yday;
+  tmp->tm_hour   = secs / SECSPERHOUR;
+  tmp->tm_min    = secs / SECSPERMIN % MINSPERHOUR;
+  tmp->tm_sec    = secs % SECSPERMIN;
+  tmp->tm_isdst  = cache.isdst;
+  tmp->tm_gmtoff = cache.utoff;
+  tmp->tm_zone   = cache.abbr;
+  tzname[cache.isdst] = (FAR char *)cache.abbr;
+  return tmp;
+}
+#endif
+
 /* The easy way to behave "as if no library function calls" localtime
  * is to not call it, so we drop its guts into "localsub", which can be
  * freely called. (And no, the PANS doesn't require the above behavior,
@@ -1918,6 +2084,10 @@ static FAR struct tm *localsub(FAR const time_t *timep,
   int i;
   FAR struct tm *result;
   const time_t t = *timep;
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+  time_t start = TIME_T_MIN;
+  time_t end = TIME_T_MAX;
+#endif
 
   sp = g_lcl_ptr;
   if (sp == NULL)
@@ -1925,6 +2095,14 @@ static FAR struct tm *localsub(FAR const time_t *timep,
       return gmtsub(timep, offset, tmp);
     }
 
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+  result = tzcache_localsub(t, tmp);
+  if (result != NULL)
+    {
+      return result;
+    }
+#endif
+
   if (nxrmutex_is_hold(&g_lcl_lock))
     {
       return NULL;
@@ -2002,6 +2180,12 @@ static FAR struct tm *localsub(FAR const time_t *timep,
   if (sp->timecnt == 0 || t < sp->ats[0])
     {
       i = sp->defaulttype;
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+      if (sp->timecnt > 0)
+        {
+          end = sp->ats[0];
+        }
+#endif
     }
   else
     {
@@ -2023,6 +2207,17 @@ static FAR struct tm *localsub(FAR const time_t *timep,
         }
 
       i = sp->types[lo - 1];
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+      start = sp->ats[lo - 1];
+      if (lo < sp->timecnt)
+        {
+          end = sp->ats[lo];
+        }
+      else if (sp->goahead)
+        {
+          end = sp->ats[lo - 1] + 1;
+        }
+#endif
     }
 
   ttisp = &sp->ttis[i];
@@ -2039,6 +2234,12 @@ static FAR struct tm *localsub(FAR const time_t *timep,
       result->tm_isdst = ttisp->tt_isdst;
       tzname[result->tm_isdst] = &sp->chars[ttisp->tt_desigidx];
       result->tm_zone = tzname[result->tm_isdst];
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+      if (sp->leapcnt == 0)
+        {
+          tzcache_update(t, start, end, ttisp, result);
+        }
+#endif
     }
 
   tz_unlock(&g_lcl_lock);
@@ -2801,11 +3002,19 @@ void tzset(void)
         }
     }
 
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+  tzcache_invalidate();
+#endif
+
   if (zoneinit(name) != 0)
     {
       zoneinit("");
     }
 
+#ifdef CONFIG_LIBC_LOCALTIME_CACHE
+  tzcache_invalidate();
+#endif
+
   strlcpy(g_lcl_tzname, name, sizeof(g_lcl_tzname));
 
 tzname:
@@ -0,0 +1,84 @@
+/****************************************************************************
+ * libs/libc/unistd/lib_posix_fadvise.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+
+#include <nuttx/fs/ioctl.h>
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: posix_fadvise
+ *
+ * Description:
+ *   The posix_fadvise() function shall advise the implementation on the
+ *   expected behavior of the application with respect to the data in the
+ *   file associated with the open file descriptor, fd, starting at offset
+ *   and continuing for len bytes.  A len of zero means all data following
+ *   offset.  The advice has no effect on the semantics of the file
+ *   operations; it only lets the file system tune its read-ahead.
+ *
+ * Returned Value:
+ *   Upon successful completion, posix_fadvise() shall return zero;
+ *   otherwise, an error number shall be returned to indicate the error.
+ *
+ ****************************************************************************/
+
+int posix_fadvise(int fd, off_t offset, off_t len, int advice)
+{
+  struct fadvise_s fadv;
+
+  if (offset < 0 || len < 0 || advice < POSIX_FADV_NORMAL ||
+      advice > POSIX_FADV_NOREUSE)
+    {
+      return EINVAL;
+    }
+
+  fadv.offset = offset;
+  fadv.len    = len;
+  fadv.advice = advice;
+
+  if (ioctl(fd, FIOC_FADVISE, &fadv) < 0)
+    {
+      int errcode = get_errno();
+
+      /* The advice is only a hint; files that cannot use it ignore it */
+
+      return errcode == ENOTTY ? 0 : errcode;
+    }
+
+  return 0;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT */
@@ -78,14 +78,15 @@ void avg_filter_data_init(FAR struct avg_filter_data_s *data,
 
 float avg_filter(FAR struct avg_filter_data_s *data, float x)
 {
-  float alpha;
   float avg;
 
   LIBDSP_DEBUGASSERT(data != NULL);
 
-  alpha = (data->k - 1.0f) / data->k;
+  /* With alpha = (k - 1) / k:
+   *   alpha * prev_avg + (1 - alpha) * x = prev_avg + (x - prev_avg) / k
+   */
 
-  avg = (alpha * data->prev_avg) + ((1.0f - alpha) * x);
+  avg = data->prev_avg + (x - data->prev_avg) / data->k;
   data->k += 1.0f;
 
   data->prev_avg = avg;
@@ -449,8 +449,8 @@ void phase_angle_update(FAR struct phase_angle_f32_s *angle, float val)
   angle->sin = fast_sin2(val);
   angle->cos = fast_cos2(val);
 #elif CONFIG_LIBDSP_PRECISION == 2
-  angle->sin = sin(val);
-  angle->cos = cos(val);
+  angle->sin = sinf(val);
+  angle->cos = cosf(val);
 #else
   angle->sin = fast_sin(val);
   angle->cos = fast_cos(val);
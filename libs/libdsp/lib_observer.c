@@ -34,7 +34,7 @@
 /* nan check for floats */
 
 #define IS_NAN(x)   ((x) != (x))
-#define NAN_ZERO(x) (x = IS_NAN(x) ? 0.0 : x)
+#define NAN_ZERO(x) (x = IS_NAN(x) ? 0.0f : x)
 
 /* Squared */
 
@@ -0,0 +1,119 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fastatan2f.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+
+#include "lib_fastmathf.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: atan2f
+ *
+ * Description:
+ *   The ratio a of the smaller to the larger magnitude is in [0, 1],
+ *   reduced above tan(pi/8): atan(a) = pi/4 + atan((a - 1) / (a + 1)).
+ *   The result m * pi/4 +- atan(t), |t| <= tan(pi/8), has the multiple of
+ *   pi/4 added last.  The error is below 2.5 ULP.
+ *
+ ****************************************************************************/
+
+float atan2f(float y, float x)
+{
+  uint32_t ix = fastf_asuint(x);
+  uint32_t iy = fastf_asuint(y);
+  uint32_t sign = iy & 0x80000000;
+  float ax = fastf_asfloat(ix & 0x7fffffff);
+  float ay = fastf_asfloat(iy & 0x7fffffff);
+  float lo;
+  float hi;
+  float a;
+  float p;
+  float m;
+
+  if (isnanf(x) || isnanf(y))
+    {
+      return x + y;
+    }
+
+  /* atan2(+-0, +0) = +-0, atan2(+-0, -0) = +-pi */
+
+  if (ax == 0.0F && ay == 0.0F)
+    {
+      return (ix >> 31) != 0 ? fastf_asfloat(fastf_asuint(M_PI_F) | sign) :
+                               y;
+    }
+
+  lo = ay > ax ? ax : ay;
+  hi = ay > ax ? ay : ax;
+
+  /* (a - 1) / (a + 1) = (lo - hi) / (lo + hi) rounds once, the sum must
+   * not overflow.
+   */
+
+  if (isinff(lo))
+    {
+      p = 0.0F;
+      m = 1.0F;
+    }
+  else if (lo > hi * FASTF_TAN_PIO8)
+    {
+      if (hi > FASTF_ATAN2_MAX)
+        {
+          lo *= 0.5F;
+          hi *= 0.5F;
+        }
+
+      p = fastf_atanpoly((lo - hi) / (lo + hi));
+      m = 1.0F;
+    }
+  else
+    {
+      p = fastf_atanpoly(lo / hi);
+      m = 0.0F;
+    }
+
+  /* pi/2 - v and pi - v */
+
+  if (ay > ax)
+    {
+      p = -p;
+      m = 2.0F - m;
+    }
+
+  if ((ix >> 31) != 0)
+    {
+      p = -p;
+      m = 4.0F - m;
+    }
+
+  a = m * FASTF_PIO4_HI + (p + m * FASTF_PIO4_LO);
+  return fastf_asfloat(fastf_asuint(a) | sign);
+}
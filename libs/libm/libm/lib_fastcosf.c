@@ -0,0 +1,72 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fastcosf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+
+#include "lib_fastmathf.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cosf
+ *
+ * Description:
+ *   Same reduction and polynomials as sinf.  The error is below 3 ULP.
+ *
+ ****************************************************************************/
+
+float cosf(float x)
+{
+  uint32_t ix = fastf_asuint(x) & 0x7fffffff;
+  int32_t n;
+  float r;
+  float s;
+  float c;
+
+  /* cos(x) rounds to 1 below 2^-12 */
+
+  if (ix < 0x39800000)
+    {
+      return 1.0F;
+    }
+
+  if (ix >= 0x7f800000)
+    {
+      return x - x;
+    }
+
+  /* Both polynomials and no branch on the quadrant */
+
+  r = fastf_rempio2(x, &n);
+  s = fastf_sinpoly(r);
+  c = fastf_cospoly(r);
+  r = (n & 1) != 0 ? s : c;
+  return fastf_asfloat(fastf_asuint(r) ^ ((uint32_t)((n + 1) & 2) << 30));
+}
@@ -0,0 +1,111 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fastexpf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+
+#include "lib_fastmathf.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* 2^(j / 32) */
+
+static const float g_expf_table[1 << FASTF_EXP_TABLE_BITS] =
+{
+  1.000000000F, 1.021897197F, 1.044273734F, 1.067140460F,
+  1.090507746F, 1.114386797F, 1.138788581F, 1.163724899F,
+  1.189207077F, 1.215247393F, 1.241857767F, 1.269050956F,
+  1.296839595F, 1.325236678F, 1.354255557F, 1.383909941F,
+  1.414213538F, 1.445180774F, 1.476826191F, 1.509164453F,
+  1.542210817F, 1.575980902F, 1.610490322F, 1.645755529F,
+  1.681792855F, 1.718619347F, 1.756252170F, 1.794709086F,
+  1.834008098F, 1.874167681F, 1.915206552F, 1.957144141F
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: expf
+ *
+ * Description:
+ *   x = (32 * e + j) * ln2/32 + r, exp(x) = 2^e * 2^(j/32) * exp(r) with
+ *   |r| <= ln2/64 and a polynomial of degree 3.  The error is below
+ *   1.5 ULP.
+ *
+ ****************************************************************************/
+
+float expf(float x)
+{
+  int32_t k;
+  int32_t j;
+  int32_t e;
+  float kf;
+  float r;
+  float t;
+  float y;
+
+  /* Also NaN */
+
+  if (!(x <= FASTF_EXP_MAX))
+    {
+      return x + INFINITY_F;
+    }
+
+  if (x < FASTF_EXP_MIN)
+    {
+      return 0.0F;
+    }
+
+  kf = (x * FASTF_32_LN2 + FASTF_ROUND_MAGIC) - FASTF_ROUND_MAGIC;
+  k  = (int32_t)kf;
+  r  = (x - kf * FASTF_LN2_32_HI) - kf * FASTF_LN2_32_LO;
+
+  j  = k & ((1 << FASTF_EXP_TABLE_BITS) - 1);
+  e  = (k - j) / (1 << FASTF_EXP_TABLE_BITS);
+  t  = g_expf_table[j];
+  y  = t + t * (r + r * r * (0.5F + r * (1.0F / 6.0F)));
+
+  /* 2^e in two steps out of the normal exponents, the result overflows
+   * or is denormal there.
+   */
+
+  if (e > 127)
+    {
+      return y * 2.0F * fastf_asfloat((uint32_t)(e - 1 + 127) << 23);
+    }
+  else if (e < -126)
+    {
+      return y * fastf_asfloat((uint32_t)(e + 64 + 127) << 23) *
+             5.421010862e-20F;
+    }
+
+  return y * fastf_asfloat((uint32_t)(e + 127) << 23);
+}
@@ -0,0 +1,83 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fastlogf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+
+#include "lib_fastmathf.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: logf
+ *
+ * Description:
+ *   x = 2^k * (1 + f) with sqrt(2)/2 <= 1 + f < sqrt(2), and log(1 + f)
+ *   from s = f / (2 + f) and a polynomial of degree 8 in s.  The error is
+ *   below 1 ULP.
+ *
+ ****************************************************************************/
+
+float logf(float x)
+{
+  uint32_t ix = fastf_asuint(x);
+  int32_t k = 0;
+
+  if (ix < 0x00800000 || (ix >> 31) != 0)
+    {
+      if ((ix << 1) == 0)
+        {
+          return -INFINITY_F;
+        }
+
+      if ((ix >> 31) != 0)
+        {
+          return NAN_F;
+        }
+
+      /* Denormal, scale it by 2^25 */
+
+      ix = fastf_asuint(x * 33554432.0F);
+      k -= 25;
+    }
+  else if (ix >= 0x7f800000)
+    {
+      return x;
+    }
+  else if (ix == 0x3f800000)
+    {
+      return 0.0F;
+    }
+
+  ix += 0x3f800000 - FASTF_SQRT1_2_BITS;
+  k  += (int32_t)(ix >> 23) - 0x7f;
+  ix  = (ix & 0x007fffff) + FASTF_SQRT1_2_BITS;
+
+  return fastf_logpoly(fastf_asfloat(ix) - 1.0F, (float)k);
+}
@@ -0,0 +1,229 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fastmathf.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBS_LIBM_LIBM_LIB_FASTMATHF_H
+#define __LIBS_LIBM_LIBM_LIB_FASTMATHF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include "libm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Adding and subtracting 1.5 * 2^23 rounds a float below 2^22 to the
+ * nearest integer.
+ */
+
+#define FASTF_ROUND_MAGIC   12582912.0F
+
+/* sinf and cosf: x = n * pi/2 + r, |r| <= pi/4.  The first two parts of
+ * pi/2 have 16 bits, n * FASTF_PIO2_1 and n * FASTF_PIO2_2 are exact below
+ * FASTF_PIO2_LARGE.  lib_rempio2f() reduces the larger arguments.
+ */
+
+#define FASTF_PIO2_LARGE    256.0F
+#define FASTF_2_PI          6.366197466850281e-01F
+#define FASTF_PIO2_1        1.570770263671875F
+#define FASTF_PIO2_2        2.6063062250614166e-05F
+#define FASTF_PIO2_3        6.07710062827671e-11F
+
+/* Minimax polynomials of sin and cos on [-pi/4, pi/4] */
+
+#define FASTF_SIN_S1       -1.6666654611e-01F
+#define FASTF_SIN_S2        8.3321608736e-03F
+#define FASTF_SIN_S3       -1.9515295891e-04F
+
+#define FASTF_COS_C1        4.166664568298827e-02F
+#define FASTF_COS_C2       -1.388731625493765e-03F
+#define FASTF_COS_C3        2.443315711809948e-05F
+
+/* expf: x = (32 * e + j) * ln2/32 + r, the 11 bits of FASTF_LN2_32_HI keep
+ * the product exact on the whole domain.
+ */
+
+#define FASTF_EXP_TABLE_BITS 5
+#define FASTF_EXP_MAX       88.8F
+#define FASTF_EXP_MIN      -104.0F
+#define FASTF_32_LN2        4.616624069213867e+01F
+#define FASTF_LN2_32_HI     2.16522216796875e-02F
+#define FASTF_LN2_32_LO     8.627713214e-06F
+
+/* expf without the table, x = e * ln2 + r */
+
+#define FASTF_1_LN2         1.442695022e+00F
+#define FASTF_LN2_HI        6.93359375e-01F
+#define FASTF_LN2_LO       -2.12194440e-04F
+
+#define FASTF_EXP_P0        1.9875691500e-04F
+#define FASTF_EXP_P1        1.3981999507e-03F
+#define FASTF_EXP_P2        8.3334519073e-03F
+#define FASTF_EXP_P3        4.1665795894e-02F
+#define FASTF_EXP_P4        1.6666665459e-01F
+#define FASTF_EXP_P5        5.0000001201e-01F
+
+/* logf: x = 2^k * (1 + f), sqrt(2)/2 <= 1 + f < sqrt(2) */
+
+#define FASTF_SQRT1_2_BITS  0x3f3504f3
+#define FASTF_LN2_HI_LOG    6.9313812256e-01F
+#define FASTF_LN2_LO_LOG    9.0580006145e-06F
+
+#define FASTF_LOG_LG1       6.6666662693e-01F
+#define FASTF_LOG_LG2       4.0000972152e-01F
+#define FASTF_LOG_LG3       2.8498786688e-01F
+#define FASTF_LOG_LG4       2.4279078841e-01F
+
+/* atan2f: tan(pi/8), pi/4 in a part of 21 bits and the rest, and the
+ * polynomial of atan on [-tan(pi/8), tan(pi/8)]
+ */
+
+#define FASTF_TAN_PIO8      4.1421356237e-01F
+#define FASTF_PIO4_HI       7.85398006439209e-01F
+#define FASTF_PIO4_LO       1.5695823663008923e-07F
+
+/* The sum of two magnitudes below it does not overflow */
+
+#define FASTF_ATAN2_MAX     1.0e38F
+
+#define FASTF_ATAN_A1      -3.33329491539e-01F
+#define FASTF_ATAN_A2       1.99777106478e-01F
+#define FASTF_ATAN_A3      -1.38776856032e-01F
+#define FASTF_ATAN_A4       8.05374449538e-02F
+
+/* sqrtf: the initial guess of 1 / sqrt(x) */
+
+#define FASTF_RSQRT_MAGIC   0x5f375a86
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+static inline uint32_t fastf_asuint(float x)
+{
+  union
+  {
+    float f;
+    uint32_t i;
+  } u;
+
+  u.f = x;
+  return u.i;
+}
+
+static inline float fastf_asfloat(uint32_t i)
+{
+  union
+  {
+    float f;
+    uint32_t i;
+  } u;
+
+  u.i = i;
+  return u.f;
+}
+
+/* sin(r) and cos(r), |r| <= pi/4 */
+
+static inline float fastf_sinpoly(float r)
+{
+  float z = r * r;
+
+  return r + r * z * (FASTF_SIN_S1 + z * (FASTF_SIN_S2 +
+                                          z * FASTF_SIN_S3));
+}
+
+static inline float fastf_cospoly(float r)
+{
+  float z = r * r;
+
+  return 1.0F - 0.5F * z + z * z * (FASTF_COS_C1 +
+                                    z * (FASTF_COS_C2 +
+                                         z * FASTF_COS_C3));
+}
+
+/* x = n * pi/2 + r, finite x */
+
+static inline float fastf_rempio2(float x, FAR int32_t *n)
+{
+  float k;
+
+  if (x > -FASTF_PIO2_LARGE && x < FASTF_PIO2_LARGE)
+    {
+      k  = (x * FASTF_2_PI + FASTF_ROUND_MAGIC) - FASTF_ROUND_MAGIC;
+      *n = (int32_t)k;
+      return ((x - k * FASTF_PIO2_1) - k * FASTF_PIO2_2) -
+             k * FASTF_PIO2_3;
+    }
+
+  return lib_rempio2f(x, n);
+}
+
+/* log(1 + f), sqrt(2)/2 <= 1 + f < sqrt(2), k * ln2 added */
+
+static inline float fastf_logpoly(float f, float k)
+{
+  float hfsq = 0.5F * f * f;
+  float s = f / (2.0F + f);
+  float z = s * s;
+  float w = z * z;
+  float r = z * (FASTF_LOG_LG1 + w * FASTF_LOG_LG3) +
+            w * (FASTF_LOG_LG2 + w * FASTF_LOG_LG4);
+
+  return s * (hfsq + r) + k * FASTF_LN2_LO_LOG - hfsq + f +
+         k * FASTF_LN2_HI_LOG;
+}
+
+/* atan(a), |a| <= tan(pi/8) */
+
+static inline float fastf_atanpoly(float a)
+{
+  float z = a * a;
+
+  return a + a * z * (FASTF_ATAN_A1 + z * (FASTF_ATAN_A2 +
+                                          z * (FASTF_ATAN_A3 +
+                                               z * FASTF_ATAN_A4)));
+}
+
+/* sqrt(x) of a positive normal x, no division */
+
+static inline float fastf_sqrtpoly(float x)
+{
+  float y = fastf_asfloat(FASTF_RSQRT_MAGIC - (fastf_asuint(x) >> 1));
+  float h = 0.5F * x;
+  float s;
+
+  y = y * (1.5F - h * y * y);
+  y = y * (1.5F - h * y * y);
+  y = y * (1.5F - h * y * y);
+
+  s = x * y;
+  return s + 0.5F * y * (x - s * s);
+}
+
+#endif /* __LIBS_LIBM_LIBM_LIB_FASTMATHF_H */
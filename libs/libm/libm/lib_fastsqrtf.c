@@ -0,0 +1,70 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fastsqrtf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <math.h>
+
+#include "lib_fastmathf.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sqrtf
+ *
+ * Description:
+ *   Newton iterations on 1 / sqrt(x) and one on sqrt(x), without any
+ *   division.  The error is below 1 ULP.
+ *
+ ****************************************************************************/
+
+float sqrtf(float x)
+{
+  uint32_t ix = fastf_asuint(x);
+
+  if (ix >= 0x7f800000 || ix < 0x00800000)
+    {
+      if ((ix << 1) == 0 || ix == 0x7f800000 || isnanf(x))
+        {
+          return x;
+        }
+
+      if ((ix >> 31) != 0)
+        {
+          set_errno(EDOM);
+          return NAN_F;
+        }
+
+      /* Denormal, scale it by 2^24 */
+
+      return fastf_sqrtpoly(x * 16777216.0F) * 2.44140625e-04F;
+    }
+
+  return fastf_sqrtpoly(x);
+}
@@ -0,0 +1,108 @@
+/****************************************************************************
+ * libs/libm/libm/lib_librempio2f.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include "libm.h"
+#include "lib_fastmathf.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* pi/2 * 2^-62, the weight of the fraction of the reduction */
+
+#define REMPIO2F_SCALE  3.4061216748705226e-19F
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The bits of 2/pi, entry i holds 32 bits from bit 8 * i - 23 after the
+ * point.  The first entries have the leading zero bits that the smallest
+ * exponents need.
+ */
+
+static const uint32_t g_rempio2f_bits[] =
+{
+  0x000000a2, 0x0000a2f9, 0x00a2f983, 0xa2f9836e, 0xf9836e4e, 0x836e4e44,
+  0x6e4e4415, 0x4e441529, 0x441529fc, 0x1529fc27, 0x29fc2757, 0xfc2757d1,
+  0x2757d1f5, 0x57d1f534, 0xd1f534dd, 0xf534ddc0, 0x34ddc0db, 0xddc0db62,
+  0xc0db6295, 0xdb629599, 0x6295993c, 0x95993c43, 0x993c4390, 0x3c439041
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_rempio2f
+ *
+ * Description:
+ *   Return r with x = n * pi/2 + r and |r| <= pi/4, for a finite x of at
+ *   least 2 in magnitude.  The mantissa is multiplied by the 96 bits of
+ *   2/pi at its exponent: the result modulo 4 needs no more, integer
+ *   arithmetic only, whatever the magnitude.
+ *
+ ****************************************************************************/
+
+float lib_rempio2f(float x, FAR int32_t *n)
+{
+  FAR const uint32_t *bits;
+  uint32_t ix = fastf_asuint(x);
+  uint32_t m;
+  uint64_t res;
+  int32_t q;
+  int e;
+  float r;
+
+  /* x = m * 2^e, the product m * 2/pi * 2^62 modulo 2^64 is the quadrant
+   * in the top two bits and the fraction below.
+   */
+
+  e    = (int)((ix >> 23) & 0xff) - 150 + 22;
+  bits = &g_rempio2f_bits[e >> 3];
+  m    = ((ix & 0x007fffff) | 0x00800000) << (e & 7);
+
+  res  = (uint64_t)(m * bits[0]) << 32;
+  res += (uint64_t)m * bits[4];
+  res += ((uint64_t)m * bits[8]) >> 32;
+
+  q    = (int32_t)((res + (UINT64_C(1) << 61)) >> 62);
+  res -= (uint64_t)q << 62;
+  r    = (float)(int64_t)res * REMPIO2F_SCALE;
+
+  if ((ix >> 31) != 0)
+    {
+      *n = -q;
+      return -r;
+    }
+
+  *n = q;
+  return r;
+}
@@ -0,0 +1,414 @@
+/****************************************************************************
+ * libs/libm/libm/lib_mathvecf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "lib_fastmathf.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The kernels are written with the vector extension of GCC, four lanes of
+ * 128 bits that the compiler keeps in the NEON, MVE or RVV registers.
+ * Without any of them they would be split into scalar code, the arrays are
+ * then computed by the scalar functions.
+ */
+
+#if defined(__ARM_NEON) || defined(__riscv_vector) || \
+    (defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 2) != 0)
+#  define MATHVEC_SIMD 1
+#endif
+
+#define MATHVEC_LANES 4
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef MATHVEC_SIMD
+typedef float    vecf_t __attribute__((vector_size(16)));
+typedef int32_t  veci_t __attribute__((vector_size(16)));
+typedef uint32_t vecu_t __attribute__((vector_size(16)));
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef MATHVEC_SIMD
+/* A group with an argument out of the range of the kernels */
+
+static void mathvec_scalar(CODE float (*f)(float), FAR const float *x,
+                           FAR float *y)
+{
+  int i;
+
+  for (i = 0; i < MATHVEC_LANES; i++)
+    {
+      y[i] = f(x[i]);
+    }
+}
+
+static inline vecf_t mathvec_load(FAR const float *x)
+{
+  vecf_t v;
+
+  memcpy(&v, x, sizeof(v));
+  return v;
+}
+
+static inline void mathvec_store(FAR float *y, vecf_t v)
+{
+  memcpy(y, &v, sizeof(v));
+}
+
+/* The lanes of a where m is set, those of b elsewhere */
+
+static inline vecf_t mathvec_select(veci_t m, vecf_t a, vecf_t b)
+{
+  return (vecf_t)(((veci_t)a & m) | ((veci_t)b & ~m));
+}
+
+static inline bool mathvec_any(veci_t m)
+{
+  return (m[0] | m[1] | m[2] | m[3]) != 0;
+}
+
+/* sin(x) if cos is 0, cos(x) otherwise, |x| < FASTF_PIO2_LARGE */
+
+static inline vecf_t mathvec_sincos(vecf_t x, int32_t cos)
+{
+  vecf_t k = (x * FASTF_2_PI + FASTF_ROUND_MAGIC) - FASTF_ROUND_MAGIC;
+  veci_t n = __builtin_convertvector(k, veci_t) + cos;
+  vecf_t r = ((x - k * FASTF_PIO2_1) - k * FASTF_PIO2_2) - k * FASTF_PIO2_3;
+  vecf_t z = r * r;
+  vecf_t s;
+  vecf_t c;
+
+  s = r + r * z * (FASTF_SIN_S1 + z * (FASTF_SIN_S2 + z * FASTF_SIN_S3));
+  c = 1.0F - 0.5F * z + z * z * (FASTF_COS_C1 +
+                                 z * (FASTF_COS_C2 + z * FASTF_COS_C3));
+
+  /* cos(x) = sin(x + pi/2) */
+
+  s = mathvec_select((n & 1) != 0, c, s);
+  return (vecf_t)((vecu_t)s ^ ((vecu_t)(n & 2) << 30));
+}
+
+/* exp(x), 2^e * exp(r) with |r| <= ln2/2 and no table to gather */
+
+static inline vecf_t mathvec_exp(vecf_t x)
+{
+  vecf_t k = (x * FASTF_1_LN2 + FASTF_ROUND_MAGIC) - FASTF_ROUND_MAGIC;
+  vecf_t r = (x - k * FASTF_LN2_HI) - k * FASTF_LN2_LO;
+  vecf_t z = r * r;
+  vecf_t y;
+
+  y = (((((FASTF_EXP_P0 * r + FASTF_EXP_P1) * r + FASTF_EXP_P2) * r +
+         FASTF_EXP_P3) * r + FASTF_EXP_P4) * r + FASTF_EXP_P5) * z + r +
+      1.0F;
+
+  return (vecf_t)((veci_t)y + (__builtin_convertvector(k, veci_t) << 23));
+}
+
+/* log(x) of positive normal x */
+
+static inline vecf_t mathvec_log(vecf_t x)
+{
+  vecu_t ix = (vecu_t)x + (0x3f800000 - FASTF_SQRT1_2_BITS);
+  vecf_t k = __builtin_convertvector((veci_t)(ix >> 23) - 0x7f, vecf_t);
+  vecf_t f = (vecf_t)((ix & 0x007fffff) + FASTF_SQRT1_2_BITS) - 1.0F;
+  vecf_t hfsq = 0.5F * f * f;
+  vecf_t s = f / (2.0F + f);
+  vecf_t z = s * s;
+  vecf_t w = z * z;
+  vecf_t r = z * (FASTF_LOG_LG1 + w * FASTF_LOG_LG3) +
+             w * (FASTF_LOG_LG2 + w * FASTF_LOG_LG4);
+
+  return s * (hfsq + r) + k * FASTF_LN2_LO_LOG - hfsq + f +
+         k * FASTF_LN2_HI_LOG;
+}
+
+/* sqrt(x) of positive normal x */
+
+static inline vecf_t mathvec_sqrt(vecf_t x)
+{
+  vecf_t y = (vecf_t)(FASTF_RSQRT_MAGIC - ((vecu_t)x >> 1));
+  vecf_t h = 0.5F * x;
+  vecf_t s;
+
+  y = y * (1.5F - h * y * y);
+  y = y * (1.5F - h * y * y);
+  y = y * (1.5F - h * y * y);
+
+  s = x * y;
+  return s + 0.5F * y * (x - s * s);
+}
+
+/* atan2(y, x) of finite x and y, not both zero */
+
+static inline vecf_t mathvec_atan2(vecf_t y, vecf_t x)
+{
+  vecu_t ix = (vecu_t)x;
+  vecu_t iy = (vecu_t)y;
+  vecf_t ax = (vecf_t)(ix & 0x7fffffff);
+  vecf_t ay = (vecf_t)(iy & 0x7fffffff);
+  veci_t swap = ay > ax;
+  vecf_t lo = mathvec_select(swap, ax, ay);
+  vecf_t hi = mathvec_select(swap, ay, ax);
+  veci_t red = lo > hi * FASTF_TAN_PIO8;
+  vecf_t t;
+  vecf_t z;
+  vecf_t p;
+  vecf_t m;
+
+  t = mathvec_select(red, lo - hi, lo) / mathvec_select(red, lo + hi, hi);
+  z = t * t;
+  p = t + t * z * (FASTF_ATAN_A1 + z * (FASTF_ATAN_A2 +
+                                        z * (FASTF_ATAN_A3 +
+                                             z * FASTF_ATAN_A4)));
+  m = (vecf_t)(red & 0x3f800000); /* 1.0F */
+
+  /* pi/2 - v and pi - v */
+
+  p = mathvec_select(swap, -p, p);
+  m = mathvec_select(swap, 2.0F - m, m);
+  p = mathvec_select((veci_t)ix < 0, -p, p);
+  m = mathvec_select((veci_t)ix < 0, 4.0F - m, m);
+
+  p = m * FASTF_PIO4_HI + (p + m * FASTF_PIO4_LO);
+  return (vecf_t)((vecu_t)p | (iy & 0x80000000));
+}
+#endif /* MATHVEC_SIMD */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sinf_vec, cosf_vec, expf_vec, logf_vec, sqrtf_vec
+ *
+ * Description:
+ *   y[i] = f(x[i]) for the n elements, in place if y is x.  A group of
+ *   lanes with an argument out of the range of the vector kernel, large,
+ *   denormal, infinite or NaN, is computed by the scalar function, as are
+ *   the last n % 4 elements.  The ULP error is that of the scalar
+ *   functions, below 1.5 for expf_vec.
+ *
+ ****************************************************************************/
+
+void sinf_vec(FAR const float *x, FAR float *y, size_t n)
+{
+#ifdef MATHVEC_SIMD
+  for (; n >= MATHVEC_LANES; n -= MATHVEC_LANES)
+    {
+      vecf_t v = mathvec_load(x);
+
+      if (mathvec_any(((vecu_t)v & 0x7fffffff) >=
+                      fastf_asuint(FASTF_PIO2_LARGE)))
+        {
+          mathvec_scalar(sinf, x, y);
+        }
+      else
+        {
+          mathvec_store(y, mathvec_sincos(v, 0));
+        }
+
+      x += MATHVEC_LANES;
+      y += MATHVEC_LANES;
+    }
+#endif
+
+  for (; n > 0; n--)
+    {
+      *y++ = sinf(*x++);
+    }
+}
+
+void cosf_vec(FAR const float *x, FAR float *y, size_t n)
+{
+#ifdef MATHVEC_SIMD
+  for (; n >= MATHVEC_LANES; n -= MATHVEC_LANES)
+    {
+      vecf_t v = mathvec_load(x);
+
+      if (mathvec_any(((vecu_t)v & 0x7fffffff) >=
+                      fastf_asuint(FASTF_PIO2_LARGE)))
+        {
+          mathvec_scalar(cosf, x, y);
+        }
+      else
+        {
+          mathvec_store(y, mathvec_sincos(v, 1));
+        }
+
+      x += MATHVEC_LANES;
+      y += MATHVEC_LANES;
+    }
+#endif
+
+  for (; n > 0; n--)
+    {
+      *y++ = cosf(*x++);
+    }
+}
+
+void expf_vec(FAR const float *x, FAR float *y, size_t n)
+{
+#ifdef MATHVEC_SIMD
+  for (; n >= MATHVEC_LANES; n -= MATHVEC_LANES)
+    {
+      vecf_t v = mathvec_load(x);
+
+      /* 2^e stays a normal number, also NaN */
+
+      if (mathvec_any(~((v > -87.0F) & (v < 88.0F))))
+        {
+          mathvec_scalar(expf, x, y);
+        }
+      else
+        {
+          mathvec_store(y, mathvec_exp(v));
+        }
+
+      x += MATHVEC_LANES;
+      y += MATHVEC_LANES;
+    }
+#endif
+
+  for (; n > 0; n--)
+    {
+      *y++ = expf(*x++);
+    }
+}
+
+void logf_vec(FAR const float *x, FAR float *y, size_t n)
+{
+#ifdef MATHVEC_SIMD
+  for (; n >= MATHVEC_LANES; n -= MATHVEC_LANES)
+    {
+      vecf_t v = mathvec_load(x);
+
+      if (mathvec_any((vecu_t)v - 0x00800000 >= 0x7f000000))
+        {
+          mathvec_scalar(logf, x, y);
+        }
+      else
+        {
+          mathvec_store(y, mathvec_log(v));
+        }
+
+      x += MATHVEC_LANES;
+      y += MATHVEC_LANES;
+    }
+#endif
+
+  for (; n > 0; n--)
+    {
+      *y++ = logf(*x++);
+    }
+}
+
+void sqrtf_vec(FAR const float *x, FAR float *y, size_t n)
+{
+#ifdef MATHVEC_SIMD
+  for (; n >= MATHVEC_LANES; n -= MATHVEC_LANES)
+    {
+      vecf_t v = mathvec_load(x);
+
+      if (mathvec_any((vecu_t)v - 0x00800000 >= 0x7f000000))
+        {
+          mathvec_scalar(sqrtf, x, y);
+        }
+      else
+        {
+          mathvec_store(y, mathvec_sqrt(v));
+        }
+
+      x += MATHVEC_LANES;
+      y += MATHVEC_LANES;
+    }
+#endif
+
+  for (; n > 0; n--)
+    {
+      *y++ = sqrtf(*x++);
+    }
+}
+
+/****************************************************************************
+ * Name: atan2f_vec
+ *
+ * Description:
+ *   z[i] = atan2f(y[i], x[i]) for the n elements, in place if z is x or y.
+ *   The groups with zeros, infinities, NaN or a magnitude above
+ *   FASTF_ATAN2_MAX are computed by atan2f.
+ *
+ ****************************************************************************/
+
+void atan2f_vec(FAR const float *y, FAR const float *x, FAR float *z,
+                size_t n)
+{
+#ifdef MATHVEC_SIMD
+  int i;
+
+  for (; n >= MATHVEC_LANES; n -= MATHVEC_LANES)
+    {
+      vecf_t vx = mathvec_load(x);
+      vecf_t vy = mathvec_load(y);
+      vecu_t ax = (vecu_t)vx & 0x7fffffff;
+      vecu_t ay = (vecu_t)vy & 0x7fffffff;
+
+      if (mathvec_any((ax - 1 >= fastf_asuint(FASTF_ATAN2_MAX)) |
+                      (ay - 1 >= fastf_asuint(FASTF_ATAN2_MAX))))
+        {
+          for (i = 0; i < MATHVEC_LANES; i++)
+            {
+              z[i] = atan2f(y[i], x[i]);
+            }
+        }
+      else
+        {
+          mathvec_store(z, mathvec_atan2(vy, vx));
+        }
+
+      x += MATHVEC_LANES;
+      y += MATHVEC_LANES;
+      z += MATHVEC_LANES;
+    }
+#endif
+
+  for (; n > 0; n--)
+    {
+      *z++ = atan2f(*y++, *x++);
+    }
+}
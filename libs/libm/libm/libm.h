@@ -64,6 +64,12 @@ double lib_expi(size_t n);
 
 float lib_sqrtapprox(float x);
 
+/* Defined in lib_librempio2f.c */
+
+#ifdef CONFIG_LIBM_FAST_FLOAT
+float lib_rempio2f(float x, FAR int32_t *n);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
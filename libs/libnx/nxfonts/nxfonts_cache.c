@@ -37,6 +37,20 @@
 #include <nuttx/nx/nxfonts.h>
 
 #include "nxcontext.h"
+#include "nxfonts.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of character codes, the size of the glyph index */
+
+#define NXFONTS_NCODES (1 << CONFIG_NXFONTS_CHARBITS)
+
+/* Memory accounted to a cached glyph */
+
+#define NXFONTS_GLYPHSIZE(g) \
+  SIZEOF_NXFONTS_GLYPH_S((size_t)(g)->stride * (g)->height)
 
 /****************************************************************************
  * Private Types
@@ -64,11 +78,15 @@ struct nxfonts_fcache_s
   nxgl_mxpixel_t fgcolor;              /* Foreground color */
   nxgl_mxpixel_t bgcolor;              /* Background color */
   nxf_renderer_t renderer;             /* Font renderer */
+  size_t msize;                        /* Memory used by the glyphs */
 
-  /* Glyph cache data storage */
+  /* Glyph cache data storage.  The list is kept in LRU order, most
+   * recently used first, the index finds a glyph by its code.
+   */
 
   FAR struct nxfonts_glyph_s *head;    /* Head of the list of glyphs */
   FAR struct nxfonts_glyph_s *tail;    /* Tail of the list of glyphs */
+  FAR struct nxfonts_glyph_s *index[NXFONTS_NCODES];
 };
 
 /****************************************************************************
@@ -121,57 +139,35 @@ static inline void nxf_removecache(FAR struct nxfonts_fcache_s *fcache,
  * Name: nxf_removeglyph
  *
  * Description:
- *   Removes the entry 'glyph' from the font cache.
+ *   Removes the entry 'glyph' from the list of glyphs of the font cache.
  *
  ****************************************************************************/
 
 static inline void nxf_removeglyph(FAR struct nxfonts_fcache_s *priv,
-                                   FAR struct nxfonts_glyph_s *glyph,
-                                   FAR struct nxfonts_glyph_s *prev)
+                                   FAR struct nxfonts_glyph_s *glyph)
 {
   ginfo("fcache=%p glyph=%p\n", priv, glyph);
 
-  /* Remove the glyph for the list.  First check for removal from the head
-   * (which, I think, never actually happens).
-   */
-
-  if (prev == NULL)
+  if (glyph->blink == NULL)
     {
-      /* Replace the head with the node following glyph */
-
       priv->head = glyph->flink;
-
-      /* If there is no node following glyph, then the list is empty */
-
-      if (priv->head == NULL)
-        {
-          priv->tail = NULL;
-        }
     }
-
-  /* Check for removal from the tail (we know that the list cannot become
-   * empty in either of the next two cases).
-   */
-
-  else if (glyph->flink == NULL)
+  else
     {
-      priv->tail = prev;
-      prev->flink = NULL;
+      glyph->blink->flink = glyph->flink;
     }
 
-  /* No.. Remove from mid-list */
-
+  if (glyph->flink == NULL)
+    {
+      priv->tail = glyph->blink;
+    }
   else
     {
-      prev->flink = glyph->flink;
+      glyph->flink->blink = glyph->blink;
     }
 
   glyph->flink = NULL;
-
-  /* Decrement the count of glyphs in the font cache */
-
-  DEBUGASSERT(priv->nglyphs > 0);
-  priv->nglyphs--;
+  glyph->blink = NULL;
 }
 
 /****************************************************************************
@@ -190,18 +186,39 @@ static inline void nxf_addglyph(FAR struct nxfonts_fcache_s *priv,
   /* Add the glyph to the head of the list */
 
   glyph->flink = priv->head;
+  glyph->blink = NULL;
 
   if (priv->head == NULL)
     {
       priv->tail = glyph;
     }
+  else
+    {
+      priv->head->blink = glyph;
+    }
 
   priv->head = glyph;
+}
+
+/****************************************************************************
+ * Name: nxf_freeglyph
+ *
+ * Description:
+ *   Remove the least recently used glyph from the font cache and free it.
+ *
+ ****************************************************************************/
+
+static void nxf_freeglyph(FAR struct nxfonts_fcache_s *priv)
+{
+  FAR struct nxfonts_glyph_s *glyph = priv->tail;
 
-  /* Increment the count of glyphs in the font cache. */
+  DEBUGASSERT(glyph != NULL && priv->nglyphs > 0);
 
-  DEBUGASSERT(priv->nglyphs < priv->maxglyphs);
-  priv->nglyphs++;
+  nxf_removeglyph(priv, glyph);
+  priv->index[glyph->code] = NULL;
+  priv->msize -= NXFONTS_GLYPHSIZE(glyph);
+  priv->nglyphs--;
+  lib_free(glyph);
 }
 
 /****************************************************************************
@@ -211,15 +228,10 @@ static inline void nxf_addglyph(FAR struct nxfonts_fcache_s *priv,
  *   Find the glyph for the specific character 'ch' in the list of pre-
  *   rendered fonts in the font cache.
  *
- *   This is logically a part of nxf_cache_getglyph().  nxf_cache_getglyph()
- *   will attempt to find the cached glyph before rendering a new one.  So
- *   this function has two unexpected side-effects:  (1) If the font cache
- *   is full and the font is not found, then the least-recently-used glyph
- *   is deleted to make space for the new glyph that will be allocated.
- *
- *   (2) If the glyph is found, then it is moved to the head of the list of
- *   glyphs since it is now the most recently used (leaving the least
- *   recently used glyph at the tail of the list).
+ *   This is logically a part of nxf_cache_getglyph().  If the glyph is
+ *   found, then it is moved to the head of the list of glyphs since it is
+ *   now the most recently used (leaving the least recently used glyph at
+ *   the tail of the list).
  *
  * Assumptions:
  *   The caller has exclusive access to the font cache.
@@ -230,54 +242,27 @@ static FAR struct nxfonts_glyph_s *
 nxf_findglyph(FAR struct nxfonts_fcache_s *priv, uint8_t ch)
 {
   FAR struct nxfonts_glyph_s *glyph;
-  FAR struct nxfonts_glyph_s *prev;
 
   ginfo("fcache=%p ch=%c (%02x)\n",
         priv, (ch >= 32 && ch < 128) ? ch : '.', ch);
 
-  /* Try to find the glyph in the list of pre-rendered glyphs */
-
-  for (prev = NULL, glyph = priv->head;
-       glyph != NULL;
-       prev = glyph, glyph = glyph->flink)
+  if (ch >= NXFONTS_NCODES)
     {
-      /* Check if we found the glyph for this character */
-
-      if (glyph->code == ch)
-        {
-          /* This is now the most recently used glyph.  Move it to the head
-           * of the list (if it is not already at the head of the list).
-           */
-
-          if (prev != NULL)
-            {
-              nxf_removeglyph(priv, glyph, prev);
-              nxf_addglyph(priv, glyph);
-            }
-
-          /* And return the glyph that we found */
-
-          return glyph;
-        }
-
-      /* Is this the last glyph in the list?  Has the cache reached its
-       * limit for the number of cached fonts?
-       */
+      return NULL;
+    }
 
-      if (glyph->flink == NULL && priv->nglyphs >= priv->maxglyphs)
-        {
-          /* Yes.. then remove it from the list and free the glyph memory.
-           * We do this because we have all of the information in hand now
-           * and we will surely need to have this space later.
-           */
+  /* This is now the most recently used glyph.  Move it to the head of the
+   * list (if it is not already at the head of the list).
+   */
 
-          nxf_removeglyph(priv, glyph, prev);
-          lib_free(glyph);
-          return NULL;
-        }
+  glyph = priv->index[ch];
+  if (glyph != NULL && glyph != priv->head)
+    {
+      nxf_removeglyph(priv, glyph);
+      nxf_addglyph(priv, glyph);
     }
 
-  return NULL;
+  return glyph;
 }
 
 /****************************************************************************
@@ -465,6 +450,7 @@ nxf_renderglyph(FAR struct nxfonts_fcache_s *priv,
 {
   FAR struct nxfonts_glyph_s *glyph = NULL;
   size_t bmsize;
+  size_t gsize;
   unsigned int height;
   unsigned int width;
   unsigned int stride;
@@ -482,11 +468,22 @@ nxf_renderglyph(FAR struct nxfonts_fcache_s *priv,
 
   stride = (width * priv->bpp + 7) >> 3;
 
-  /* Allocate the glyph (always succeeds) */
+  /* Make room for the glyph, the least recently used glyphs go first */
 
   bmsize = stride * height;
-  glyph  = (FAR struct nxfonts_glyph_s *)
-    lib_malloc(SIZEOF_NXFONTS_GLYPH_S(bmsize));
+  gsize  = SIZEOF_NXFONTS_GLYPH_S(bmsize);
+
+  while (priv->nglyphs > 0 &&
+         (priv->nglyphs >= priv->maxglyphs ||
+          (CONFIG_NXFONTS_CACHE_SIZE > 0 &&
+           priv->msize + gsize > CONFIG_NXFONTS_CACHE_SIZE)))
+    {
+      nxf_freeglyph(priv);
+    }
+
+  /* Allocate the glyph (always succeeds) */
+
+  glyph = (FAR struct nxfonts_glyph_s *)lib_malloc(gsize);
 
   if (glyph != NULL)
     {
@@ -520,6 +517,9 @@ nxf_renderglyph(FAR struct nxfonts_fcache_s *priv,
       /* Add the new glyph to the font cache */
 
       nxf_addglyph(priv, glyph);
+      priv->index[ch] = glyph;
+      priv->msize += gsize;
+      priv->nglyphs++;
     }
 
   return glyph;
@@ -782,7 +782,7 @@ void nxf_cache_disconnect(FCACHE fhandle)
 
       for (prev = NULL, fcache = g_fcaches;
            fcache != priv && fcache != NULL;
-           fcache = fcache->flink)
+           prev = fcache, fcache = fcache->flink)
         {
         }
 
@@ -878,7 +878,7 @@ nxf_cache_getglyph(FCACHE fhandle, uint8_t ch)
     {
       /* No, it is not cached... Does the code map to a font? */
 
-      fbm = nxf_getbitmap(priv->font, ch);
+      fbm = ch < NXFONTS_NCODES ? nxf_getbitmap(priv->font, ch) : NULL;
       if (fbm)
         {
           /* Yes.. render the glyph for the font */
@@ -153,11 +153,12 @@ int NXF_FUNCNAME(nxf_convert, NXFONTS_SUFFIX)
   int col;
   int bmndx;
 
+  int nbits;
+
 #if NXFONTS_BITSPERPIXEL < 8
   NXF_PIXEL_T mpixel;
   NXF_PIXEL_T mask;
   NXF_PIXEL_T pixel;
-  int nbits;
 #endif
 
   /* Get the starting position */
@@ -248,6 +249,16 @@ int NXF_FUNCNAME(nxf_convert, NXFONTS_SUFFIX)
         {
           bmbyte = *sptr++;
 
+          /* Skip the background of a whole byte at once, most of a glyph */
+
+          if (bmbyte == 0)
+            {
+              nbits = ngl_min(8, width - col);
+              dptr += nbits;
+              col  += nbits;
+              continue;
+            }
+
           /* Process each bit in the byte */
 
           for (bmbit = 7; bmbit >= 0 && col < width; bmbit--, col++)
@@ -0,0 +1,348 @@
+//***************************************************************************
+// libs/libxx/mempool/libxx_mempool.cxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <new>
+
+#include <nuttx/lib/lib.h>
+#include <nuttx/mm/mempool.h>
+#include <nuttx/mm/mempool_resource.hxx>
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+// The blocks are multiples of the alignment new guarantees
+
+#ifdef __STDCPP_DEFAULT_NEW_ALIGNMENT__
+#  define LIBXX_MEMPOOL_ALIGN  __STDCPP_DEFAULT_NEW_ALIGNMENT__
+#else
+#  define LIBXX_MEMPOOL_ALIGN  alignof(std::max_align_t)
+#endif
+
+#define LIBXX_MEMPOOL_NPOOLS   (CONFIG_LIBXX_MEMPOOL_THRESHOLD / \
+                                LIBXX_MEMPOOL_ALIGN)
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+// The pools expand from the heap
+
+static FAR void *libxx_mempool_memalign(FAR void *arg, std::size_t alignment,
+                                        std::size_t size)
+{
+  return lib_memalign(alignment, size);
+}
+
+static std::size_t libxx_mempool_size(FAR void *arg, FAR void *addr)
+{
+  return lib_malloc_size(addr);
+}
+
+static void libxx_mempool_release(FAR void *arg, FAR void *addr)
+{
+  lib_free(addr);
+}
+
+static FAR struct mempool_multiple_s *
+libxx_mempool_create(FAR const char *name)
+{
+  std::size_t poolsize[LIBXX_MEMPOOL_NPOOLS];
+
+  for (std::size_t i = 0; i < LIBXX_MEMPOOL_NPOOLS; i++)
+    {
+      poolsize[i] = (i + 1) * LIBXX_MEMPOOL_ALIGN;
+    }
+
+  return mempool_multiple_init(name, poolsize, LIBXX_MEMPOOL_NPOOLS,
+                               libxx_mempool_memalign, libxx_mempool_size,
+                               libxx_mempool_release, NULL, 0,
+                               CONFIG_LIBXX_MEMPOOL_EXPAND_SIZE,
+                               CONFIG_LIBXX_MEMPOOL_EXPAND_SIZE);
+}
+
+#ifdef CONFIG_LIBXX_MEMPOOL_NEW
+
+// The pools of new and delete, created by the first allocation
+
+static FAR struct mempool_multiple_s *libxx_mempool_pool(void)
+{
+  static FAR struct mempool_multiple_s *pool =
+    libxx_mempool_create("libxx");
+
+  return pool;
+}
+
+static FAR void *libxx_mempool_alloc(std::size_t size,
+                                     std::size_t alignment)
+{
+  FAR void *p;
+
+  if (alignment > LIBXX_MEMPOOL_ALIGN)
+    {
+      return lib_memalign(alignment, size);
+    }
+
+  if (size <= CONFIG_LIBXX_MEMPOOL_THRESHOLD)
+    {
+      p = mempool_multiple_alloc(libxx_mempool_pool(),
+                                 size > 0 ? size : 1);
+      if (p != NULL)
+        {
+          return p;
+        }
+    }
+
+  return lib_malloc(size > 0 ? size : 1);
+}
+
+// Loop on the new handler like the default operator new
+
+static FAR void *libxx_mempool_new(std::size_t size, std::size_t alignment)
+{
+  for (; ; )
+    {
+      FAR void *p = libxx_mempool_alloc(size, alignment);
+
+      if (p != NULL)
+        {
+          return p;
+        }
+
+      std::new_handler handler = std::get_new_handler();
+      if (handler == nullptr)
+        {
+#ifdef CONFIG_CXX_EXCEPTION
+          throw std::bad_alloc();
+#else
+          return nullptr;
+#endif
+        }
+
+      handler();
+    }
+}
+
+static FAR void *libxx_mempool_new_nothrow(std::size_t size,
+                                           std::size_t alignment) noexcept
+{
+#ifdef CONFIG_CXX_EXCEPTION
+  try
+    {
+      return libxx_mempool_new(size, alignment);
+    }
+  catch (...)
+    {
+      return nullptr;
+    }
+#else
+  return libxx_mempool_new(size, alignment);
+#endif
+}
+
+// The blocks out of the pools, the large and the aligned ones, are
+// released to the heap
+
+static void libxx_mempool_delete(FAR void *p) noexcept
+{
+  if (p != NULL && mempool_multiple_free(libxx_mempool_pool(), p) < 0)
+    {
+      lib_free(p);
+    }
+}
+
+#endif // CONFIG_LIBXX_MEMPOOL_NEW
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx
+{
+  mempool_resource::mempool_resource(FAR const char *name,
+                                     FAR std::pmr::memory_resource *upstream)
+    : m_pool(libxx_mempool_create(name)), m_upstream(upstream)
+  {
+  }
+
+  // All the blocks must have been released
+
+  mempool_resource::~mempool_resource()
+  {
+    mempool_multiple_deinit(m_pool);
+  }
+
+  FAR void *mempool_resource::do_allocate(std::size_t bytes,
+                                          std::size_t alignment)
+  {
+    if (m_pool != NULL && bytes <= CONFIG_LIBXX_MEMPOOL_THRESHOLD &&
+        alignment <= LIBXX_MEMPOOL_ALIGN)
+      {
+        FAR void *p = mempool_multiple_alloc(m_pool, bytes > 0 ? bytes : 1);
+
+        if (p != NULL)
+          {
+            return p;
+          }
+      }
+
+    return m_upstream->allocate(bytes, alignment);
+  }
+
+  void mempool_resource::do_deallocate(FAR void *p, std::size_t bytes,
+                                       std::size_t alignment)
+  {
+    if (m_pool != NULL && bytes <= CONFIG_LIBXX_MEMPOOL_THRESHOLD &&
+        alignment <= LIBXX_MEMPOOL_ALIGN &&
+        mempool_multiple_free(m_pool, p) >= 0)
+      {
+        return;
+      }
+
+    m_upstream->deallocate(p, bytes, alignment);
+  }
+}
+
+#ifdef CONFIG_LIBXX_MEMPOOL_NEW
+
+//***************************************************************************
+// Operators
+//***************************************************************************
+
+// These replace the ones of stdlib_new_delete.cpp of libcxxabi
+
+FAR void *operator new(std::size_t size)
+{
+  return libxx_mempool_new(size, LIBXX_MEMPOOL_ALIGN);
+}
+
+FAR void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+  return libxx_mempool_new_nothrow(size, LIBXX_MEMPOOL_ALIGN);
+}
+
+FAR void *operator new[](std::size_t size)
+{
+  return libxx_mempool_new(size, LIBXX_MEMPOOL_ALIGN);
+}
+
+FAR void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+  return libxx_mempool_new_nothrow(size, LIBXX_MEMPOOL_ALIGN);
+}
+
+void operator delete(FAR void *p) noexcept
+{
+  libxx_mempool_delete(p);
+}
+
+void operator delete(FAR void *p, const std::nothrow_t &) noexcept
+{
+  libxx_mempool_delete(p);
+}
+
+void operator delete(FAR void *p, std::size_t) noexcept
+{
+  libxx_mempool_delete(p);
+}
+
+void operator delete[](FAR void *p) noexcept
+{
+  libxx_mempool_delete(p);
+}
+
+void operator delete[](FAR void *p, const std::nothrow_t &) noexcept
+{
+  libxx_mempool_delete(p);
+}
+
+void operator delete[](FAR void *p, std::size_t) noexcept
+{
+  libxx_mempool_delete(p);
+}
+
+#ifdef __cpp_aligned_new
+FAR void *operator new(std::size_t size, std::align_val_t alignment)
+{
+  return libxx_mempool_new(size, static_cast<std::size_t>(alignment));
+}
+
+FAR void *operator new(std::size_t size, std::align_val_t alignment,
+                       const std::nothrow_t &) noexcept
+{
+  return libxx_mempool_new_nothrow(size,
+                                   static_cast<std::size_t>(alignment));
+}
+
+FAR void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+  return libxx_mempool_new(size, static_cast<std::size_t>(alignment));
+}
+
+FAR void *operator new[](std::size_t size, std::align_val_t alignment,
+                         const std::nothrow_t &) noexcept
+{
+  return libxx_mempool_new_nothrow(size,
+                                   static_cast<std::size_t>(alignment));
+}
+
+void operator delete(FAR void *p, std::align_val_t) noexcept
+{
+  libxx_mempool_delete(p);
+}
+
+void operator delete(FAR void *p, std::align_val_t,
+                     const std::nothrow_t &) noexcept
+{
+  libxx_mempool_delete(p);
+}
+
+void operator delete(FAR void *p, std::size_t, std::align_val_t) noexcept
+{
+  libxx_mempool_delete(p);
+}
+
+void operator delete[](FAR void *p, std::align_val_t) noexcept
+{
+  libxx_mempool_delete(p);
+}
+
+void operator delete[](FAR void *p, std::align_val_t,
+                       const std::nothrow_t &) noexcept
+{
+  libxx_mempool_delete(p);
+}
+
+void operator delete[](FAR void *p, std::size_t, std::align_val_t) noexcept
+{
+  libxx_mempool_delete(p);
+}
+#endif // __cpp_aligned_new
+
+#endif // CONFIG_LIBXX_MEMPOOL_NEW
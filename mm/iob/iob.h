@@ -51,6 +51,30 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+/* Is there anybody waiting for a free I/O buffer? */
+
+#if CONFIG_IOB_THROTTLE > 0
+#  define IOB_HAVE_WAITERS() (g_iob_count < 0 || g_throttle_wait > 0)
+#else
+#  define IOB_HAVE_WAITERS() (g_iob_count < 0)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The free I/O buffers cached by one CPU */
+
+#if CONFIG_IOB_CACHE > 0
+struct iob_cache_s
+{
+  spinlock_t lock;             /* Only contended by iob_cache_drain() */
+  FAR struct iob_s *head;      /* The cached buffers */
+  int16_t count;               /* The number of cached buffers */
+  unsigned long nhits;         /* Allocations served by the cache */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -98,6 +122,12 @@ extern int16_t g_qentry_wait;
 
 extern volatile spinlock_t g_iob_lock;
 
+#if CONFIG_IOB_CACHE > 0
+/* The free I/O buffers cached by each CPU */
+
+extern struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -137,6 +167,75 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_release
+ *
+ * Description:
+ *   Return one pre-allocated I/O buffer to the free list, or hand it to a
+ *   thread waiting for one.  This function is intended only for internal
+ *   use by the IOB module.
+ *
+ ****************************************************************************/
+
+void iob_release(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_release_list
+ *
+ * Description:
+ *   Return a list of pre-allocated I/O buffers, linked through io_flink,
+ *   to the free list under a single lock.  Buffers are handed to waiting
+ *   threads one at a time.  This function is intended only for internal
+ *   use by the IOB module.
+ *
+ ****************************************************************************/
+
+void iob_release_list(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take a free I/O buffer from the cache of this CPU, refilling the cache
+ *   from the free list if it is empty.  NULL is returned if there is none.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_CACHE > 0
+FAR struct iob_s *iob_cache_alloc(void);
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Keep a free I/O buffer in the cache of this CPU.  false is returned if
+ *   the buffer must go to the free list because a thread waits for one.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the buffers cached by all CPUs to the free list.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain(void);
+
+/****************************************************************************
+ * Name: iob_cache_count
+ *
+ * Description:
+ *   Return the number of buffers cached by all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_cache_count(void);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
@@ -96,6 +96,13 @@ static FAR struct iob_s *iob_alloc_committed(void)
       iob->io_len    = 0;    /* Length of the data in the entry */
       iob->io_offset = 0;    /* Offset to the beginning of data */
       iob->io_pktlen = 0;    /* Total length of the packet */
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      iob->io_csum   = IOB_CSUM_NONE;
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+      iob->io_tstamp = 0;
+      iob->io_tsid   = 0;
+#endif
     }
 
   spin_unlock_irqrestore(&g_iob_lock, flags);
@@ -135,6 +142,13 @@ static FAR struct iob_s *iob_tryalloc_internal(bool throttled)
           iob->io_len    = 0;    /* Length of the data in the entry */
           iob->io_offset = 0;    /* Offset to the beginning of data */
           iob->io_pktlen = 0;    /* Total length of the packet */
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+          iob->io_csum   = IOB_CSUM_NONE;
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+          iob->io_tstamp = 0;
+          iob->io_tsid   = 0;
+#endif
           return iob;
         }
     }
@@ -167,6 +181,14 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
   sem = &g_iob_sem;
 #endif
 
+#if CONFIG_IOB_CACHE > 0
+  iob = iob_cache_alloc();
+  if (iob != NULL)
+    {
+      return iob;
+    }
+#endif
+
   /* The following must be atomic; interrupt must be disabled so that there
    * is no conflict with interrupt level I/O buffer allocations.  This is
    * not as bad as it sounds because interrupts will be re-enabled while
@@ -193,6 +215,15 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
 
       spin_unlock_irqrestore(&g_iob_lock, flags);
 
+#if CONFIG_IOB_CACHE > 0
+      /* Now that we are counted as a waiter, the buffers cached by the
+       * CPUs are handed to us (or to the other waiters) as they return to
+       * the free list.
+       */
+
+      iob_cache_drain();
+#endif
+
       if (timeout == UINT_MAX)
         {
           ret = nxsem_wait_uninterruptible(sem);
@@ -301,6 +332,18 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   FAR struct iob_s *iob;
   irqstate_t flags;
 
+#if CONFIG_IOB_CACHE > 0
+  iob = iob_cache_alloc();
+  if (iob != NULL)
+    {
+      return iob;
+    }
+
+  /* The free list may be short because the other CPUs cache the buffers */
+
+  iob_cache_drain();
+#endif
+
   /* We don't know what context we are called from so we use extreme measures
    * to protect the free list:  We disable interrupts very briefly.
    */
@@ -311,6 +354,73 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_alloc_n
+ *
+ * Description:
+ *   Try to allocate "n" I/O buffers at once, without waiting, and return
+ *   them linked as one chain.  Either all of the buffers are allocated or
+ *   none is.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_n(bool throttled, unsigned int n)
+{
+  FAR struct iob_s *chain = NULL;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int16_t count;
+
+  if (n == 0)
+    {
+      return NULL;
+    }
+
+#if CONFIG_IOB_CACHE > 0
+  if (n > (unsigned int)g_iob_count)
+    {
+      iob_cache_drain();
+    }
+#endif
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+#if CONFIG_IOB_THROTTLE > 0
+  count = throttled ? g_iob_count - CONFIG_IOB_THROTTLE : g_iob_count;
+#else
+  count = g_iob_count;
+#endif
+
+  if (count >= 0 && n <= (unsigned int)count)
+    {
+      while (n-- > 0)
+        {
+          iob = g_iob_freelist;
+          DEBUGASSERT(iob != NULL);
+          g_iob_freelist = iob->io_flink;
+          g_iob_count--;
+
+          /* Put the I/O buffer in a known state */
+
+          iob->io_flink  = chain;
+          iob->io_len    = 0;
+          iob->io_offset = 0;
+          iob->io_pktlen = 0;
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+          iob->io_csum   = IOB_CSUM_NONE;
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+          iob->io_tstamp = 0;
+          iob->io_tsid   = 0;
+#endif
+          chain          = iob;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+  return chain;
+}
+
 #ifdef CONFIG_IOB_ALLOC
 
 /****************************************************************************
@@ -345,6 +455,13 @@ FAR struct iob_s *iob_alloc_dynamic(uint16_t size)
       iob->io_offset  = 0;                /* Offset to the beginning of data */
       iob->io_bufsize = size;             /* Total length of the iob buffer */
       iob->io_pktlen  = 0;                /* Total length of the packet */
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      iob->io_csum    = IOB_CSUM_NONE;
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+      iob->io_tstamp  = 0;
+      iob->io_tsid    = 0;
+#endif
       iob->io_free    = iob_free_dynamic; /* Customer free callback */
       iob->io_data    = (FAR uint8_t *)ALIGN_UP((uintptr_t)(iob + 1),
                                                 IOB_ALIGNMENT);
@@ -391,6 +508,13 @@ FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
       iob->io_offset  = 0;       /* Offset to the beginning of data */
       iob->io_bufsize = size;    /* Total length of the iob buffer */
       iob->io_pktlen  = 0;       /* Total length of the packet */
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      iob->io_csum    = IOB_CSUM_NONE;
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+      iob->io_tstamp  = 0;
+      iob->io_tsid    = 0;
+#endif
       iob->io_free    = free_cb; /* Customer free callback */
       iob->io_data    = data;
     }
@@ -430,6 +554,13 @@ FAR struct iob_s *iob_init_with_data(FAR void *data, uint16_t size,
   iob->io_len     = 0;       /* Length of the data in the entry */
   iob->io_offset  = 0;       /* Offset to the beginning of data */
   iob->io_pktlen  = 0;       /* Total length of the packet */
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  iob->io_csum    = IOB_CSUM_NONE;
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+  iob->io_tstamp  = 0;
+  iob->io_tsid    = 0;
+#endif
   iob->io_free    = free_cb; /* Customer free callback */
   iob->io_data    = (FAR uint8_t *)ALIGN_UP((uintptr_t)(iob + 1),
                                             IOB_ALIGNMENT);
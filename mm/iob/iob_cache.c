@@ -0,0 +1,269 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#if CONFIG_IOB_CACHE > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of buffers moved between a cache and the free list at once */
+
+#define IOB_CACHE_BATCH ((CONFIG_IOB_CACHE + 1) / 2)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The free I/O buffers cached by each CPU */
+
+struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_refill
+ *
+ * Description:
+ *   Move up to IOB_CACHE_BATCH buffers from the free list to a cache.  The
+ *   throttle reserve is left in the free list, so buffers taken from a
+ *   cache never need to be throttled.
+ *
+ ****************************************************************************/
+
+static void iob_cache_refill(FAR struct iob_cache_s *cache)
+{
+  FAR struct iob_s *iob;
+  int nblks = IOB_CACHE_BATCH;
+
+  spin_lock(&g_iob_lock);
+  while (nblks-- > 0 && g_iob_count > CONFIG_IOB_THROTTLE &&
+         (iob = g_iob_freelist) != NULL)
+    {
+      g_iob_freelist = iob->io_flink;
+      g_iob_count--;
+
+      iob->io_flink = cache->head;
+      cache->head   = iob;
+      cache->count++;
+    }
+
+  spin_unlock(&g_iob_lock);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take a free I/O buffer from the cache of this CPU, refilling the cache
+ *   from the free list if it is empty.  NULL is returned if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  /* Interrupts stay disabled so that this CPU is not left while its cache
+   * is in use.
+   */
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[this_cpu()];
+  spin_lock(&cache->lock);
+
+  if (cache->head == NULL)
+    {
+      iob_cache_refill(cache);
+    }
+
+  iob = cache->head;
+  if (iob != NULL)
+    {
+      cache->head = iob->io_flink;
+      cache->count--;
+      cache->nhits++;
+    }
+
+  spin_unlock(&cache->lock);
+  up_irq_restore(flags);
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      iob->io_csum   = IOB_CSUM_NONE;
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+      iob->io_tstamp = 0;
+      iob->io_tsid   = 0;
+#endif
+    }
+
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Keep a free I/O buffer in the cache of this CPU.  If the cache is full,
+ *   IOB_CACHE_BATCH buffers are returned to the free list first.  false is
+ *   returned if the buffer must go to the free list because a thread waits
+ *   for one.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *victims = NULL;
+  FAR struct iob_s *tail;
+  irqstate_t flags;
+  int nblks;
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[this_cpu()];
+  spin_lock(&cache->lock);
+
+  /* The waiters are checked with the cache lock held, so a thread that
+   * starts to wait after this check finds the buffer in iob_cache_drain().
+   */
+
+  if (IOB_HAVE_WAITERS())
+    {
+      spin_unlock(&cache->lock);
+      up_irq_restore(flags);
+      return false;
+    }
+
+  if (cache->count >= CONFIG_IOB_CACHE)
+    {
+      victims = cache->head;
+      for (tail = victims, nblks = 1; nblks < IOB_CACHE_BATCH; nblks++)
+        {
+          tail = tail->io_flink;
+        }
+
+      cache->head    = tail->io_flink;
+      cache->count  -= IOB_CACHE_BATCH;
+      tail->io_flink = NULL;
+    }
+
+  iob->io_flink = cache->head;
+  cache->head   = iob;
+  cache->count++;
+
+  spin_unlock(&cache->lock);
+  up_irq_restore(flags);
+
+  if (victims != NULL)
+    {
+      iob_release_list(victims);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the buffers cached by all CPUs to the free list.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain(void)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &g_iob_cache[cpu];
+
+      flags = spin_lock_irqsave(&cache->lock);
+      iob = cache->head;
+      cache->head  = NULL;
+      cache->count = 0;
+      spin_unlock_irqrestore(&cache->lock, flags);
+
+      if (iob != NULL)
+        {
+          iob_release_list(iob);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: iob_cache_count
+ *
+ * Description:
+ *   Return the number of buffers cached by all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_cache_count(void)
+{
+  int count = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      count += g_iob_cache[cpu].count;
+    }
+
+  return count;
+}
+
+#endif /* CONFIG_IOB_CACHE > 0 */
@@ -80,7 +80,6 @@
 FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
-  irqstate_t flags;
 #ifdef CONFIG_IOB_NOTIFIER
   int16_t navail;
 #endif
@@ -137,6 +136,49 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
     }
 #endif
 
+#if CONFIG_IOB_CACHE > 0
+  /* Keep the I/O buffer in the cache of this CPU if nobody waits for one */
+
+  if (!iob_cache_free(iob))
+#endif
+    {
+      iob_release(iob);
+    }
+
+#ifdef CONFIG_IOB_NOTIFIER
+  /* Check if the IOB was claimed by a thread that is blocked waiting
+   * for an IOB.
+   */
+
+  navail = iob_navail(false);
+  if (navail > 0 && (navail & IOB_MASK) == 0)
+    {
+      /* Signal any threads that have requested a signal notification
+       * when an IOB becomes available.
+       */
+
+      iob_notifier_signal();
+    }
+#endif
+
+  /* And return the I/O buffer after the one that was freed */
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: iob_release
+ *
+ * Description:
+ *   Return one pre-allocated I/O buffer to the free list, or hand it to a
+ *   thread waiting for one.
+ *
+ ****************************************************************************/
+
+void iob_release(FAR struct iob_s *iob)
+{
+  irqstate_t flags;
+
   /* Free the I/O buffer by adding it to the head of the free or the
    * committed list. We don't know what context we are called from so
    * we use extreme measures to protect the free list:  We disable
@@ -179,24 +221,39 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
     }
 
   DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
+}
 
-#ifdef CONFIG_IOB_NOTIFIER
-  /* Check if the IOB was claimed by a thread that is blocked waiting
-   * for an IOB.
-   */
+/****************************************************************************
+ * Name: iob_release_list
+ *
+ * Description:
+ *   Return a list of pre-allocated I/O buffers to the free list under a
+ *   single lock.  Once a thread waits for an I/O buffer, the rest of the
+ *   list goes through iob_release() so that the waiters get them.
+ *
+ ****************************************************************************/
 
-  navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
-    {
-      /* Signal any threads that have requested a signal notification
-       * when an IOB becomes available.
-       */
+void iob_release_list(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next;
+  irqstate_t flags;
 
-      iob_notifier_signal();
+  flags = spin_lock_irqsave(&g_iob_lock);
+  while (iob != NULL && !IOB_HAVE_WAITERS())
+    {
+      next            = iob->io_flink;
+      iob->io_flink   = g_iob_freelist;
+      g_iob_freelist  = iob;
+      g_iob_count++;
+      iob             = next;
     }
-#endif
 
-  /* And return the I/O buffer after the one that was freed */
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
 
-  return next;
+  for (; iob != NULL; iob = next)
+    {
+      next = iob->io_flink;
+      iob_release(iob);
+    }
 }
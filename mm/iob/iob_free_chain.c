@@ -55,3 +55,50 @@ void iob_free_chain(FAR struct iob_s *iob)
       next = iob_free(iob);
     }
 }
+
+/****************************************************************************
+ * Name: iob_free_chain_batch
+ *
+ * Description:
+ *   Free an entire buffer chain like iob_free_chain(), but return all of
+ *   its pre-allocated buffers to the free list under a single lock.
+ *
+ ****************************************************************************/
+
+void iob_free_chain_batch(FAR struct iob_s *iob)
+{
+#ifdef CONFIG_IOB_ALLOC
+  FAR struct iob_s *chain = NULL;
+  FAR struct iob_s *next;
+
+  /* Buffers allocated from the heap are freed on their own */
+
+  for (; iob != NULL; iob = next)
+    {
+      next = iob->io_flink;
+      if (iob->io_free != NULL)
+        {
+          iob->io_flink = NULL;
+          iob_free(iob);
+        }
+      else
+        {
+          iob->io_flink = chain;
+          chain         = iob;
+        }
+    }
+
+  iob = chain;
+#endif
+
+  if (iob != NULL)
+    {
+      iob_release_list(iob);
+#ifdef CONFIG_IOB_NOTIFIER
+      if (iob_navail(false) > 0)
+        {
+          iob_notifier_signal();
+        }
+#endif
+    }
+}
@@ -54,6 +54,10 @@
 
 void iob_getstats(FAR struct iob_stats_s *stats)
 {
+#if CONFIG_IOB_CACHE > 0
+  int cpu;
+#endif
+
   stats->ntotal = CONFIG_IOB_NBUFFERS;
 
   stats->nfree = g_iob_count;
@@ -74,6 +78,19 @@ void iob_getstats(FAR struct iob_stats_s *stats)
     {
       stats->nthrottle = 0;
     }
+
+#if CONFIG_IOB_CACHE > 0
+  /* The buffers cached by the CPUs are free, but not part of the counts
+   * above.
+   */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      stats->ncached[cpu] = g_iob_cache[cpu].count;
+      stats->nhits[cpu]   = g_iob_cache[cpu].nhits;
+      stats->nfree       += stats->ncached[cpu];
+    }
+#endif
 }
 
 #endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
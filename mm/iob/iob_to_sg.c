@@ -0,0 +1,119 @@
+/****************************************************************************
+ * mm/iob/iob_to_sg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/cache.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Without an address environment, virtual and physical addresses are the
+ * same.
+ */
+
+#ifdef CONFIG_ARCH_ADDRENV
+#  define IOB_VA_TO_PA(va) up_addrenv_va_to_pa(va)
+#else
+#  define IOB_VA_TO_PA(va) ((uintptr_t)(va))
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_to_sg
+ *
+ * Description:
+ *   Describe the data of an I/O buffer chain as a list of segments, so that
+ *   a DMA capable driver can transfer the chain in place instead of copying
+ *   it into a contiguous buffer first.  Empty buffers are skipped.
+ *
+ ****************************************************************************/
+
+int iob_to_sg(FAR struct iob_s *iob, unsigned int headroom,
+              FAR struct iob_sg_s *sg, int nsg)
+{
+  int i = 0;
+
+  DEBUGASSERT(iob != NULL && headroom <= iob->io_offset);
+
+  for (; iob != NULL; iob = iob->io_flink, headroom = 0)
+    {
+      if (iob->io_len == 0 && headroom == 0)
+        {
+          continue;
+        }
+
+      if (i >= nsg)
+        {
+          return -E2BIG;
+        }
+
+      sg[i].base = IOB_DATA(iob) - headroom;
+      sg[i].addr = IOB_VA_TO_PA(sg[i].base);
+      sg[i].len  = iob->io_len + headroom;
+      i++;
+    }
+
+  return i;
+}
+
+/****************************************************************************
+ * Name: iob_sg_sync
+ *
+ * Description:
+ *   Perform the data cache maintenance for a segment list returned by
+ *   iob_to_sg().
+ *
+ ****************************************************************************/
+
+void iob_sg_sync(FAR const struct iob_sg_s *sg, int nsg, bool todevice)
+{
+  int i;
+
+  for (i = 0; i < nsg; i++)
+    {
+      uintptr_t start = (uintptr_t)sg[i].base;
+
+      if (todevice)
+        {
+          up_clean_dcache(start, start + sg[i].len);
+        }
+      else
+        {
+          up_invalidate_dcache(start, start + sg[i].len);
+        }
+    }
+}
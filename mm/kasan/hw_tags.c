@@ -24,6 +24,8 @@
 
 #include <nuttx/arch.h>
 
+#include <errno.h>
+
 /****************************************************************************
  * Private Function
  ****************************************************************************/
@@ -92,3 +94,8 @@ void kasan_register(FAR void *addr, FAR size_t *size)
 void kasan_unregister(FAR void *addr)
 {
 }
+
+int kasan_region_enable(FAR const void *addr, bool enable)
+{
+  return -ENOSYS;
+}
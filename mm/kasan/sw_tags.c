@@ -27,6 +27,7 @@
 #include <nuttx/spinlock.h>
 
 #include <assert.h>
+#include <errno.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -53,6 +54,7 @@ struct kasan_region_s
 {
   uintptr_t begin;
   uintptr_t end;
+  bool      enabled;
   uint8_t   shadow[1];
 };
 
@@ -64,22 +66,36 @@ static FAR struct kasan_region_s *g_region[CONFIG_MM_KASAN_REGIONS];
 static int g_region_count;
 static spinlock_t g_lock;
 
+/* The span covered by all regions, to reject other addresses quickly */
+
+static uintptr_t g_region_begin = UINTPTR_MAX;
+static uintptr_t g_region_end;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 static inline_function FAR uint8_t *
-kasan_mem_to_shadow(FAR const void *ptr, size_t size)
+kasan_mem_to_shadow(FAR const void *ptr, size_t size, bool check)
 {
   uintptr_t addr;
   int i;
 
   addr = (uintptr_t)kasan_clear_tag(ptr);
+  if (addr < g_region_begin || addr >= g_region_end)
+    {
+      return NULL;
+    }
 
   for (i = 0; i < g_region_count; i++)
     {
       if (addr >= g_region[i]->begin && addr < g_region[i]->end)
         {
+          if (check && !g_region[i]->enabled)
+            {
+              return NULL;
+            }
+
           DEBUGASSERT(addr + size <= g_region[i]->end);
           addr -= g_region[i]->begin;
           return &g_region[i]->shadow[addr / KASAN_SHADOW_SCALE];
@@ -104,7 +120,7 @@ kasan_is_poisoned(FAR const void *addr, size_t size)
     }
 #endif
 
-  p = kasan_mem_to_shadow(addr, size);
+  p = kasan_mem_to_shadow(addr, size, true);
   if (p == NULL)
     {
       return kasan_global_is_poisoned(addr, size);
@@ -128,7 +144,7 @@ static void kasan_set_poison(FAR const void *addr,
   irqstate_t flags;
   FAR uint8_t *p;
 
-  p = kasan_mem_to_shadow(addr, size);
+  p = kasan_mem_to_shadow(addr, size, false);
   if (p == NULL)
     {
       return;
@@ -145,6 +161,29 @@ static void kasan_set_poison(FAR const void *addr,
   spin_unlock_irqrestore(&g_lock, flags);
 }
 
+static void kasan_update_span(void)
+{
+  uintptr_t begin = UINTPTR_MAX;
+  uintptr_t end = 0;
+  int i;
+
+  for (i = 0; i < g_region_count; i++)
+    {
+      if (g_region[i]->begin < begin)
+        {
+          begin = g_region[i]->begin;
+        }
+
+      if (g_region[i]->end > end)
+        {
+          end = g_region[i]->end;
+        }
+    }
+
+  g_region_begin = begin;
+  g_region_end   = end;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -192,13 +231,15 @@ void kasan_register(FAR void *addr, FAR size_t *size)
   region = (FAR struct kasan_region_s *)
     ((FAR char *)addr + *size - KASAN_REGION_SIZE(*size));
 
-  region->begin = (uintptr_t)addr;
-  region->end   = region->begin + *size;
+  region->begin   = (uintptr_t)addr;
+  region->end     = region->begin + *size;
+  region->enabled = true;
 
   flags = spin_lock_irqsave(&g_lock);
 
   DEBUGASSERT(g_region_count < CONFIG_MM_KASAN_REGIONS);
   g_region[g_region_count++] = region;
+  kasan_update_span();
 
   spin_unlock_irqrestore(&g_lock, flags);
 
@@ -221,6 +262,7 @@ void kasan_unregister(FAR void *addr)
           g_region_count--;
           memmove(&g_region[i], &g_region[i + 1],
                   (g_region_count - i) * sizeof(g_region[0]));
+          kasan_update_span();
           spin_unlock_irqrestore(&g_lock, flags);
           kasan_unpoison(addr, size);
           return;
@@ -229,3 +271,25 @@ void kasan_unregister(FAR void *addr)
 
   spin_unlock_irqrestore(&g_lock, flags);
 }
+
+int kasan_region_enable(FAR const void *addr, bool enable)
+{
+  uintptr_t ptr = (uintptr_t)kasan_clear_tag(addr);
+  irqstate_t flags;
+  int ret = -ENOENT;
+  int i;
+
+  flags = spin_lock_irqsave(&g_lock);
+  for (i = 0; i < g_region_count; i++)
+    {
+      if (ptr >= g_region[i]->begin && ptr < g_region[i]->end)
+        {
+          g_region[i]->enabled = enable;
+          ret = 0;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_lock, flags);
+  return ret;
+}
@@ -100,6 +100,50 @@ static int get_user_pages(FAR struct tcb_s *tcb, FAR void **pages,
   return OK;
 }
 
+/****************************************************************************
+ * Name: map_pages_align
+ *
+ * Description:
+ *   Return the virtual alignment that lets the architecture map the pages
+ *   with larger entries: the alignment of the first page, up to the size
+ *   of the region and MM_PGLARGESIZE, if the pages are physically
+ *   contiguous.
+ *
+ * Input Parameters:
+ *   pages  - Pointer to buffer that contains the physical page addresses.
+ *   npages - Amount of pages.
+ *
+ * Returned Value:
+ *   The alignment in bytes, MM_PGSIZE if no larger mapping is possible.
+ *
+ ****************************************************************************/
+
+static size_t map_pages_align(FAR void **pages, size_t npages)
+{
+  size_t align = MM_PGSIZE;
+#ifdef CONFIG_MM_KMAP_LARGE_PAGES
+  uintptr_t paddr = (uintptr_t)pages[0];
+  size_t    size  = npages << MM_PGSHIFT;
+  size_t    i;
+
+  for (i = 1; i < npages; i++)
+    {
+      if ((uintptr_t)pages[i] != paddr + (i << MM_PGSHIFT))
+        {
+          return MM_PGSIZE;
+        }
+    }
+
+  while (align < MM_PGLARGESIZE && (align << 1) <= size &&
+         (paddr & ((align << 1) - 1)) == 0)
+    {
+      align <<= 1;
+    }
+#endif
+
+  return align;
+}
+
 /****************************************************************************
  * Name: map_pages
  *
@@ -119,7 +163,8 @@ static int get_user_pages(FAR struct tcb_s *tcb, FAR void **pages,
 static FAR void *map_pages(FAR void **pages, size_t npages, int prot)
 {
   struct mm_map_entry_s entry;
-  FAR void             *vaddr;
+  FAR void             *vaddr = NULL;
+  size_t                align;
   size_t                size;
   int                   ret;
 
@@ -127,9 +172,21 @@ static FAR void *map_pages(FAR void **pages, size_t npages, int prot)
 
   size = npages << MM_PGSHIFT;
 
-  /* Find a virtual memory area that fits */
+  /* Find a virtual memory area that fits, aligned like the physical pages
+   * if they can use larger mappings.
+   */
+
+  align = map_pages_align(pages, npages);
+  if (align > MM_PGSIZE)
+    {
+      vaddr = gran_alloc_align(g_kmm_map_vpages, size, align);
+    }
+
+  if (!vaddr)
+    {
+      vaddr = gran_alloc(g_kmm_map_vpages, size);
+    }
 
-  vaddr = gran_alloc(g_kmm_map_vpages, size);
   if (!vaddr)
     {
       return NULL;
@@ -54,4 +54,26 @@ void kmm_addregion(FAR void *heap_start, size_t heap_size)
   mm_addregion(g_kmmheap, heap_start, heap_size);
 }
 
+/****************************************************************************
+ * Name: kmm_region_setflags
+ *
+ * Description:
+ *   Tag the kernel heap region that contains "mem" with MM_REGION_* flags.
+ *
+ * Input Parameters:
+ *   mem   - Any address within the region
+ *   flags - The new tags of the region
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if "mem" is not in a region of the heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+int kmm_region_setflags(FAR void *mem, unsigned int flags)
+{
+  return mm_region_setflags(g_kmmheap, mem, flags);
+}
+#endif
+
 #endif /* CONFIG_MM_KERNEL_HEAP */
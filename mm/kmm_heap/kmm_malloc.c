@@ -53,4 +53,27 @@ FAR void *kmm_malloc(size_t size)
   return mm_malloc(g_kmmheap, size);
 }
 
+/****************************************************************************
+ * Name: kmm_malloc_region
+ *
+ * Description:
+ *   Allocate memory from the kernel heap, preferring the regions tagged
+ *   with all of the MM_REGION_* "flags".
+ *
+ * Input Parameters:
+ *   size  - Size (in bytes) of the memory region to be allocated.
+ *   flags - The preferred region tags
+ *
+ * Returned Value:
+ *   The address of the allocated memory (NULL on failure to allocate)
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+FAR void *kmm_malloc_region(size_t size, unsigned int flags)
+{
+  return mm_malloc_region(g_kmmheap, size, flags);
+}
+#endif
+
 #endif /* CONFIG_MM_KERNEL_HEAP */
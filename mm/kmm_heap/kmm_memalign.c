@@ -56,4 +56,21 @@ FAR void *kmm_memalign(size_t alignment, size_t size)
   return mm_memalign(g_kmmheap, alignment, size);
 }
 
+/****************************************************************************
+ * Name: kmm_memalign_region
+ *
+ * Description:
+ *   Allocate aligned memory in the kernel heap, preferring the regions
+ *   tagged with all of the MM_REGION_* "flags".
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+FAR void *kmm_memalign_region(size_t alignment, size_t size,
+                              unsigned int flags)
+{
+  return mm_memalign_region(g_kmmheap, alignment, size, flags);
+}
+#endif
+
 #endif /* CONFIG_MM_KERNEL_HEAP */
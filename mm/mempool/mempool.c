@@ -100,6 +100,127 @@ static inline void mempool_add_queue(FAR struct mempool_s *pool,
     }
 }
 
+/* The blocks held in the magazines are counted in nalloc, which is only
+ * updated under the lock when they move in or out of the free queue.
+ */
+
+#ifdef MEMPOOL_HAVE_MAGAZINE
+static FAR sq_entry_t *mempool_magazine_alloc(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_magazine_s *magazine;
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+
+  if (pool->wait && pool->expandsize == 0)
+    {
+      return NULL;
+    }
+
+  flags = up_irq_save();
+  magazine = &pool->magazine[this_cpu()];
+  if (magazine->count == 0)
+    {
+      size_t nblks = (CONFIG_MM_MEMPOOL_MAGAZINE + 1) / 2;
+
+      /* Refill half of the magazine from the free queue */
+
+      spin_lock(&pool->lock);
+      while (nblks-- > 0 &&
+             (blk = mempool_remove_queue(pool, &pool->queue)) != NULL)
+        {
+          sq_addlast(blk, &magazine->queue);
+          magazine->count++;
+          pool->nalloc++;
+        }
+
+      spin_unlock(&pool->lock);
+    }
+
+  blk = mempool_remove_queue(pool, &magazine->queue);
+  if (blk != NULL)
+    {
+      magazine->count--;
+    }
+
+  up_irq_restore(flags);
+  return blk;
+}
+
+static bool mempool_magazine_release(FAR struct mempool_s *pool,
+                                     FAR void *blk)
+{
+  FAR struct mempool_magazine_s *magazine;
+  irqstate_t flags;
+
+  if ((pool->wait && pool->expandsize == 0) ||
+      (pool->ibase != NULL && (FAR char *)blk >= pool->ibase &&
+       (FAR char *)blk < pool->ibase + pool->interruptsize))
+    {
+      return false;
+    }
+
+  flags = up_irq_save();
+  magazine = &pool->magazine[this_cpu()];
+  if (magazine->count >= CONFIG_MM_MEMPOOL_MAGAZINE)
+    {
+      size_t nblks = (CONFIG_MM_MEMPOOL_MAGAZINE + 1) / 2;
+
+      /* Return half of the magazine to the free queue */
+
+      spin_lock(&pool->lock);
+      while (nblks-- > 0)
+        {
+          sq_addlast(mempool_remove_queue(pool, &magazine->queue),
+                     &pool->queue);
+          magazine->count--;
+          pool->nalloc--;
+        }
+
+      spin_unlock(&pool->lock);
+    }
+
+  kasan_poison(blk, pool->blocksize);
+  sq_addfirst(blk, &magazine->queue);
+  magazine->count++;
+  up_irq_restore(flags);
+
+  return true;
+}
+
+static size_t mempool_magazine_count(FAR struct mempool_s *pool)
+{
+  size_t count = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      count += pool->magazine[cpu].count;
+    }
+
+  return count;
+}
+
+static void mempool_magazine_flush(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_magazine_s *magazine;
+  irqstate_t flags;
+  int cpu;
+
+  flags = spin_lock_irqsave(&pool->lock);
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      magazine = &pool->magazine[cpu];
+      pool->nalloc -= magazine->count;
+      magazine->count = 0;
+      sq_cat(&magazine->queue, &pool->queue);
+    }
+
+  spin_unlock_irqrestore(&pool->lock, flags);
+}
+#else
+#  define mempool_magazine_count(pool) 0
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
                                          FAR struct mempool_backtrace_s *buf)
@@ -264,11 +385,22 @@ mempool_memdump_free_callback(FAR struct mempool_s *pool,
 int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+#ifdef MEMPOOL_HAVE_MAGAZINE
+  int i;
+#endif
 
   sq_init(&pool->queue);
   sq_init(&pool->iqueue);
   sq_init(&pool->equeue);
   pool->nalloc = 0;
+#ifdef MEMPOOL_HAVE_MAGAZINE
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      sq_init(&pool->magazine[i].queue);
+      pool->magazine[i].count = 0;
+    }
+#endif
+
   if (pool->interruptsize >= blocksize)
     {
       size_t ninterrupt = pool->interruptsize / blocksize;
@@ -354,6 +486,14 @@ FAR void *mempool_allocate(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   irqstate_t flags;
 
+#ifdef MEMPOOL_HAVE_MAGAZINE
+  blk = mempool_magazine_alloc(pool);
+  if (blk != NULL)
+    {
+      goto out;
+    }
+#endif
+
 retry:
   flags = spin_lock_irqsave(&pool->lock);
   blk = mempool_remove_queue(pool, &pool->queue);
@@ -408,6 +548,9 @@ retry:
   pool->nalloc++;
   spin_unlock_irqrestore(&pool->lock, flags);
 
+#ifdef MEMPOOL_HAVE_MAGAZINE
+out:
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   mempool_add_backtrace(pool, (FAR struct mempool_backtrace_s *)
                               ((FAR char *)blk + pool->blocksize));
@@ -434,7 +577,7 @@ retry:
 
 void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 {
-  irqstate_t flags = spin_lock_irqsave(&pool->lock);
+  irqstate_t flags;
 #if CONFIG_MM_BACKTRACE >= 0
   FAR struct mempool_backtrace_s *buf =
     (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
@@ -446,12 +589,20 @@ void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 
 #endif
 
-  pool->nalloc--;
-
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
   memset(blk, MM_FREE_MAGIC, pool->blocksize);
 #endif
 
+#ifdef MEMPOOL_HAVE_MAGAZINE
+  if (mempool_magazine_release(pool, blk))
+    {
+      return;
+    }
+#endif
+
+  flags = spin_lock_irqsave(&pool->lock);
+  pool->nalloc--;
+
   if (pool->ibase)
     {
       if ((FAR char *)blk >= pool->ibase &&
@@ -505,9 +656,9 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
   DEBUGASSERT(pool != NULL && info != NULL);
 
   flags = spin_lock_irqsave(&pool->lock);
-  info->ordblks = sq_count(&pool->queue);
+  info->ordblks = sq_count(&pool->queue) + mempool_magazine_count(pool);
   info->iordblks = sq_count(&pool->iqueue);
-  info->aordblks = pool->nalloc;
+  info->aordblks = pool->nalloc - mempool_magazine_count(pool);
   info->arena = sq_count(&pool->equeue) * MEMPOOL_HEADER_SIZE +
     (info->aordblks + info->ordblks + info->iordblks) * blocksize;
   spin_unlock_irqrestore(&pool->lock, flags);
@@ -545,7 +696,8 @@ mempool_info_task(FAR struct mempool_s *pool,
     {
       irqstate_t flags = spin_lock_irqsave(&pool->lock);
       size_t count = sq_count(&pool->queue) +
-                     sq_count(&pool->iqueue);
+                     sq_count(&pool->iqueue) +
+                     mempool_magazine_count(pool);
 
       spin_unlock_irqrestore(&pool->lock, flags);
       info.aordblks += count;
@@ -553,8 +705,10 @@ mempool_info_task(FAR struct mempool_s *pool,
     }
   else if (task->pid == PID_MM_ALLOC)
     {
-      info.aordblks += pool->nalloc;
-      info.uordblks += pool->nalloc * blocksize;
+      size_t count = pool->nalloc - mempool_magazine_count(pool);
+
+      info.aordblks += count;
+      info.uordblks += count * blocksize;
     }
 #if CONFIG_MM_BACKTRACE >= 0
   else
@@ -624,6 +778,10 @@ int mempool_deinit(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   size_t count = 0;
 
+#ifdef MEMPOOL_HAVE_MAGAZINE
+  mempool_magazine_flush(pool);
+#endif
+
   if (pool->nalloc != 0)
     {
       return -EBUSY;
@@ -25,10 +25,12 @@
  ****************************************************************************/
 
 #include <assert.h>
+#include <inttypes.h>
 #include <strings.h>
 #include <syslog.h>
 #include <sys/param.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/mutex.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/kmalloc.h>
@@ -93,6 +95,15 @@ struct mempool_multiple_s
   size_t                        dict_col_num_log2;
   size_t                        dict_row_num;
   FAR struct mpool_dict_s     **dict;
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_PROFILE
+  /* The number of requests for each size in MM_ALIGN steps.  The last
+   * entry counts the requests larger than the largest block.
+   */
+
+  FAR atomic_t                 *profile;
+  size_t                        nprofile;
+#endif
 };
 
 /****************************************************************************
@@ -145,6 +156,25 @@ mempool_multiple_find(FAR struct mempool_multiple_s *mpool, size_t size)
   return &mpool->pools[left];
 }
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_PROFILE
+static inline void
+mempool_multiple_record(FAR struct mempool_multiple_s *mpool, size_t size)
+{
+  size_t ndx;
+
+  if (size > mpool->pools[mpool->npools - 1].blocksize)
+    {
+      ndx = mpool->nprofile - 1;
+    }
+  else
+    {
+      ndx = MAX((size + MM_ALIGN - 1) / MM_ALIGN, 1);
+    }
+
+  atomic_fetch_add(&mpool->profile[ndx], 1);
+}
+#endif
+
 static FAR void *
 mempool_multiple_alloc_chunk(FAR struct mempool_multiple_s *mpool,
                              size_t align, size_t size)
@@ -500,6 +530,21 @@ mempool_multiple_init(FAR const char *name,
 
   memset(mpool->dict, 0,
          mpool->dict_row_num * sizeof(FAR struct mpool_dict_s *));
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_PROFILE
+  mpool->nprofile = (maxpoolszie + MM_ALIGN - 1) / MM_ALIGN + 2;
+  mpool->profile = mempool_multiple_alloc_chunk(
+                   mpool, sizeof(uintptr_t),
+                   mpool->nprofile * sizeof(atomic_t));
+  if (mpool->profile == NULL)
+    {
+      goto err_with_pools;
+    }
+
+  memset((FAR void *)mpool->profile, 0,
+         mpool->nprofile * sizeof(atomic_t));
+#endif
+
   nxrmutex_init(&mpool->lock);
 
   return mpool;
@@ -538,6 +583,13 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
   FAR struct mempool_s *end;
   FAR struct mempool_s *pool;
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_PROFILE
+  if (mpool != NULL)
+    {
+      mempool_multiple_record(mpool, size);
+    }
+#endif
+
   pool = mempool_multiple_find(mpool, size);
   if (pool == NULL)
     {
@@ -592,6 +644,13 @@ FAR void *mempool_multiple_realloc(FAR struct mempool_multiple_s *mpool,
       return NULL;
     }
 
+  /* Nothing to copy if the new size maps to the same pool */
+
+  if (mempool_multiple_find(mpool, size) == dict->pool)
+    {
+      return oldblk;
+    }
+
   blk = mempool_multiple_alloc(mpool, size);
   if (blk != NULL && oldblk != NULL)
     {
@@ -850,6 +909,164 @@ void mempool_multiple_memdump(FAR struct mempool_multiple_s *mpool,
     }
 }
 
+/****************************************************************************
+ * Name: mempool_multiple_profile
+ *
+ * Description:
+ *   Print the histogram of the sizes requested from the multiple memory
+ *   pool, the hit rate and waste of its block sizes, and the block sizes
+ *   that would waste the least memory for the same requests.
+ *
+ *   The block sizes are chosen by dynamic programming over the histogram:
+ *   waste[m][j] is the least memory wasted by the requests of up to j
+ *   MM_ALIGN units when they are served by m + 1 pools, the largest of
+ *   them being j units.  The number of pools and the largest block size
+ *   are kept, so that the hit rate does not change.
+ *
+ * Input Parameters:
+ *   mpool - The handle of multiple memory pool to be used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_PROFILE
+void mempool_multiple_profile(FAR struct mempool_multiple_s *mpool)
+{
+  FAR uint64_t *count;
+  FAR uint64_t *bytes;
+  FAR uint64_t *waste;
+  FAR uint64_t *next;
+  FAR uint64_t *swap;
+  FAR uint16_t *from;
+  FAR void *buf;
+  uint64_t current = 0;
+  uint64_t suggest;
+  uint64_t total;
+  size_t maxsize;
+  size_t npools;
+  size_t nsizes;
+  size_t size;
+  size_t i;
+  size_t j;
+  size_t m;
+
+  if (mpool == NULL)
+    {
+      return;
+    }
+
+  maxsize = mpool->pools[mpool->npools - 1].blocksize;
+  nsizes = mpool->nprofile - 2;
+  npools = MIN(mpool->npools, nsizes);
+  DEBUGASSERT(nsizes <= UINT16_MAX);
+
+  buf = mpool->alloc(mpool->arg, sizeof(uint64_t),
+                     4 * (nsizes + 1) * sizeof(uint64_t) +
+                     npools * (nsizes + 1) * sizeof(uint16_t));
+  if (buf == NULL)
+    {
+      syslog(LOG_INFO, "Mempool profile: no memory\n");
+      return;
+    }
+
+  count = buf;
+  bytes = count + nsizes + 1;
+  waste = bytes + nsizes + 1;
+  next  = waste + nsizes + 1;
+  from  = (FAR uint16_t *)(next + nsizes + 1);
+
+  /* Print the histogram and make its prefix sums, in MM_ALIGN units */
+
+  syslog(LOG_INFO, "Mempool profile\n");
+  syslog(LOG_INFO, "%12s%12s\n", "Size", "Requests");
+
+  count[0] = 0;
+  bytes[0] = 0;
+  for (j = 1, i = 0; j <= nsizes; j++)
+    {
+      uint64_t nreqs = atomic_read(&mpool->profile[j]);
+
+      if (nreqs > 0)
+        {
+          syslog(LOG_INFO, "%12zu%12" PRIu64 "\n", j * MM_ALIGN, nreqs);
+        }
+
+      count[j] = count[j - 1] + nreqs;
+      bytes[j] = bytes[j - 1] + nreqs * j;
+
+      /* Waste of the current block sizes */
+
+      size = MIN(j * MM_ALIGN, maxsize);
+      while (mpool->pools[i].blocksize < size)
+        {
+          i++;
+        }
+
+      current += nreqs * (mpool->pools[i].blocksize - size);
+    }
+
+  total = count[nsizes] + atomic_read(&mpool->profile[nsizes + 1]);
+  syslog(LOG_INFO, "%11s%zu%12" PRIu64 "\n", ">", maxsize,
+         total - count[nsizes]);
+
+  /* One pool serves everything up to j */
+
+  for (j = 1; j <= nsizes; j++)
+    {
+      waste[j] = j * count[j] - bytes[j];
+      from[j] = 0;
+    }
+
+  /* Each further pool splits the sizes up to j at the best i */
+
+  for (m = 1; m < npools; m++)
+    {
+      for (j = m + 1; j <= nsizes; j++)
+        {
+          next[j] = UINT64_MAX;
+          for (i = m; i < j; i++)
+            {
+              uint64_t cost = waste[i] + j * (count[j] - count[i]) -
+                              (bytes[j] - bytes[i]);
+
+              if (cost < next[j])
+                {
+                  next[j] = cost;
+                  from[m * (nsizes + 1) + j] = i;
+                }
+            }
+        }
+
+      swap  = waste;
+      waste = next;
+      next  = swap;
+    }
+
+  suggest = waste[nsizes] * MM_ALIGN;
+
+  syslog(LOG_INFO, "Hit %" PRIu64 " of %" PRIu64 " requests\n",
+         count[nsizes], total);
+  syslog(LOG_INFO, "Waste %" PRIu64 " bytes, suggested %" PRIu64
+         " bytes\n", current, suggest);
+
+  /* Walk the choices back from the largest block size, count[] is free to
+   * hold the result now.
+   */
+
+  for (j = nsizes, m = npools; m-- > 0; j = from[m * (nsizes + 1) + j])
+    {
+      count[m] = m == npools - 1 ? maxsize : j * MM_ALIGN;
+    }
+
+  syslog(LOG_INFO, "Suggested block sizes:\n");
+  for (m = 0; m < npools; m++)
+    {
+      syslog(LOG_INFO, "%12" PRIu64 "\n", count[m]);
+    }
+
+  mpool->free(mpool->arg, buf);
+}
+#endif
+
 /****************************************************************************
  * Name: mempool_multiple_deinit
  *
@@ -875,6 +1092,10 @@ void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool)
       DEBUGVERIFY(mempool_deinit(mpool->pools + i));
     }
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_PROFILE
+  mempool_multiple_free_chunk(mpool, (FAR void *)mpool->profile);
+#endif
+
   for (i = 0; i < mpool->dict_row_num; i++)
     {
       if (mpool->dict[i] != NULL)
@@ -264,3 +264,32 @@ void mempool_procfs_unregister(FAR struct mempool_procfs_entry_s *entry)
         }
     }
 }
+
+/****************************************************************************
+ * Name: mempool_procfs_foreach
+ *
+ * Description:
+ *   Call 'handler' with the name and the statistics of every mempool that
+ *   is registered with procfs.
+ *
+ * Input Parameters:
+ *   handler - The function to call for each mempool
+ *   arg     - Passed to 'handler' untouched
+ *
+ ****************************************************************************/
+
+void mempool_procfs_foreach(mempool_procfs_handler_t handler,
+                            FAR void *arg)
+{
+  FAR const struct mempool_procfs_entry_s *entry;
+
+  for (entry = g_mempool_procfs; entry != NULL; entry = entry->next)
+    {
+      FAR struct mempool_s *pool = container_of(entry, struct mempool_s,
+                                                procfs);
+      struct mempoolinfo_s minfo;
+
+      mempool_info(pool, &minfo);
+      handler(entry->name, &minfo, arg);
+    }
+}
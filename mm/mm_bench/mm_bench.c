@@ -0,0 +1,1054 @@
+/****************************************************************************
+ * mm/mm_bench/mm_bench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MM_BENCH_NOPS       10000  /* Default number of operations */
+#define MM_BENCH_TRACELEN   64     /* Longest line of a trace */
+
+#ifdef CONFIG_MM_TLSF_MANAGER
+#  define MM_BENCH_MANAGER  "tlsf"
+#else
+#  define MM_BENCH_MANAGER  "mm_heap"
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum mm_bench_pattern_e
+{
+  MM_BENCH_CHURN = 0,   /* Random alloc/realloc/free over a set of slots */
+  MM_BENCH_FIFO,        /* Producers allocate, consumers free */
+  MM_BENCH_TRACE        /* Replay of a recorded trace */
+};
+
+enum mm_bench_sizes_e
+{
+  MM_BENCH_SMALL = 0,   /* Uniform, 8 to 256 bytes */
+  MM_BENCH_MIXED,       /* Log-uniform, 16 to 4095 bytes */
+  MM_BENCH_LARGE        /* Uniform, 1024 to 4096 bytes */
+};
+
+struct mm_bench_slot_s
+{
+  FAR void *mem;
+  size_t    size;
+};
+
+struct mm_bench_thread_s
+{
+  FAR struct mm_bench_thread_s *peer;  /* Producer of a consumer */
+  FAR struct mm_bench_slot_s   *slots; /* Own slots, or the FIFO ring */
+  size_t                        nslots;
+  size_t                        nops;  /* Operations to do */
+  size_t                        ndone; /* Operations done */
+  size_t                        nfail; /* Failed allocations */
+  atomic_t                      head;  /* FIFO: next slot to fill */
+  atomic_t                      tail;  /* FIFO: next slot to free */
+  atomic_t                      finished;
+  uint32_t                      seed;
+  uint64_t                      busy;  /* Ticks spent in the allocator */
+  uint32_t                      max;   /* Longest operation in ticks */
+  size_t                        nseen; /* Operations offered to samples[] */
+  int                           index;
+  int                           error;
+  uint32_t                      samples[CONFIG_MM_BENCH_NSAMPLES];
+};
+
+struct mm_bench_s
+{
+  FAR struct mm_heap_s         *heap;
+  FAR void                     *arena;
+  FAR const char               *path;   /* The trace to replay */
+  size_t                        usable; /* Free bytes of the empty heap */
+  atomic_t                      live;   /* Bytes held by the benchmark */
+  uint16_t                      frag;   /* Peak fragmentation in 1/1000 */
+  uint8_t                       pattern;
+  uint8_t                       sizes;
+  int                           nthreads;
+  bool                          abort;
+  sem_t                         start;
+  sem_t                         done;
+  FAR struct mm_bench_thread_s *thread[CONFIG_MM_BENCH_NTHREADS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char * const g_mm_bench_patterns[] =
+{
+  "churn", "fifo", "trace"
+};
+
+static FAR const char * const g_mm_bench_sizes[] =
+{
+  "small", "mixed", "large"
+};
+
+/* Serializes the runs and protects the results */
+
+static mutex_t g_mm_bench_lock = NXMUTEX_INITIALIZER;
+
+/* The run in progress */
+
+static FAR struct mm_bench_s *g_mm_bench;
+
+/* The results of the last runs, g_mm_bench_count counts all of them */
+
+static struct mm_bench_result_s g_mm_bench_results[CONFIG_MM_BENCH_NRESULTS];
+static unsigned int g_mm_bench_count;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t mm_bench_rand(FAR struct mm_bench_thread_s *thread)
+{
+  uint32_t x = thread->seed;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return thread->seed = x;
+}
+
+static size_t mm_bench_size(FAR struct mm_bench_thread_s *thread)
+{
+  uint32_t r = mm_bench_rand(thread);
+
+  switch (g_mm_bench->sizes)
+    {
+      case MM_BENCH_SMALL:
+        return 8 + r % 249;
+
+      case MM_BENCH_MIXED:
+        return (16 << (r % 8)) + (r >> 8) % (16 << (r % 8));
+
+      default:
+        return 1024 + r % 3073;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_bench_record
+ *
+ * Description:
+ *   Account one operation that took "ticks".  The latencies are sampled
+ *   uniformly (reservoir sampling) so any number of operations fits.
+ *
+ ****************************************************************************/
+
+static void mm_bench_record(FAR struct mm_bench_thread_s *thread,
+                            clock_t ticks)
+{
+  uint32_t sample = ticks > UINT32_MAX ? UINT32_MAX : (uint32_t)ticks;
+  size_t i = thread->nseen++;
+
+  thread->busy += ticks;
+  if (sample > thread->max)
+    {
+      thread->max = sample;
+    }
+
+  if (i >= CONFIG_MM_BENCH_NSAMPLES)
+    {
+      i = mm_bench_rand(thread) % thread->nseen;
+    }
+
+  if (i < CONFIG_MM_BENCH_NSAMPLES)
+    {
+      thread->samples[i] = sample;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_bench_update
+ *
+ * Description:
+ *   Count an operation and sample the fragmentation from time to time: the
+ *   share of the memory not held by the benchmark that is not part of the
+ *   largest free chunk.  It includes the allocator overheads and the free
+ *   blocks held by the memory pools.
+ *
+ ****************************************************************************/
+
+static void mm_bench_update(FAR struct mm_bench_thread_s *thread)
+{
+  FAR struct mm_bench_s *bench = g_mm_bench;
+  struct mallinfo info;
+  size_t unused;
+
+  if (++thread->ndone % CONFIG_MM_BENCH_FRAG_INTERVAL != 0 ||
+      thread->index != 0)
+    {
+      return;
+    }
+
+  info   = mm_mallinfo(bench->heap);
+  unused = bench->usable - atomic_read(&bench->live);
+  if (unused > (size_t)info.mxordblk)
+    {
+      uint16_t frag = (unused - info.mxordblk) * 1000 / unused;
+
+      if (frag > bench->frag)
+        {
+          bench->frag = frag;
+        }
+    }
+}
+
+static void mm_bench_alloc(FAR struct mm_bench_thread_s *thread,
+                           FAR struct mm_bench_slot_s *slot, size_t size)
+{
+  clock_t start = perf_gettime();
+
+  slot->mem = mm_malloc(g_mm_bench->heap, size);
+  mm_bench_record(thread, perf_gettime() - start);
+
+  if (slot->mem == NULL)
+    {
+      thread->nfail++;
+    }
+  else
+    {
+      slot->size = size;
+      atomic_fetch_add(&g_mm_bench->live, size);
+    }
+
+  mm_bench_update(thread);
+}
+
+static void mm_bench_realloc(FAR struct mm_bench_thread_s *thread,
+                             FAR struct mm_bench_slot_s *slot, size_t size)
+{
+  clock_t start = perf_gettime();
+  FAR void *mem;
+
+  mem = mm_realloc(g_mm_bench->heap, slot->mem, size);
+  mm_bench_record(thread, perf_gettime() - start);
+
+  if (mem == NULL)
+    {
+      thread->nfail++;
+    }
+  else
+    {
+      atomic_fetch_add(&g_mm_bench->live, size - slot->size);
+      slot->mem  = mem;
+      slot->size = size;
+    }
+
+  mm_bench_update(thread);
+}
+
+static void mm_bench_free(FAR struct mm_bench_thread_s *thread,
+                          FAR struct mm_bench_slot_s *slot)
+{
+  clock_t start = perf_gettime();
+
+  mm_free(g_mm_bench->heap, slot->mem);
+  mm_bench_record(thread, perf_gettime() - start);
+
+  atomic_fetch_sub(&g_mm_bench->live, slot->size);
+  slot->mem = NULL;
+
+  mm_bench_update(thread);
+}
+
+/****************************************************************************
+ * Name: mm_bench_churn
+ *
+ * Description:
+ *   Pick a random slot: fill it if it is empty, otherwise free it or, one
+ *   time in eight, resize it.
+ *
+ ****************************************************************************/
+
+static void mm_bench_churn(FAR struct mm_bench_thread_s *thread)
+{
+  FAR struct mm_bench_slot_s *slot;
+  size_t i;
+
+  while (thread->ndone < thread->nops)
+    {
+      slot = &thread->slots[mm_bench_rand(thread) % thread->nslots];
+      if (slot->mem == NULL)
+        {
+          mm_bench_alloc(thread, slot, mm_bench_size(thread));
+        }
+      else if (mm_bench_rand(thread) % 8 == 0)
+        {
+          mm_bench_realloc(thread, slot, mm_bench_size(thread));
+        }
+      else
+        {
+          mm_bench_free(thread, slot);
+        }
+    }
+
+  for (i = 0; i < thread->nslots; i++)
+    {
+      if (thread->slots[i].mem != NULL)
+        {
+          mm_free(g_mm_bench->heap, thread->slots[i].mem);
+          atomic_fetch_sub(&g_mm_bench->live, thread->slots[i].size);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mm_bench_produce
+ *
+ * Description:
+ *   Allocate blocks and queue them to the consumer, which frees them,
+ *   usually on another CPU.
+ *
+ ****************************************************************************/
+
+static void mm_bench_produce(FAR struct mm_bench_thread_s *thread)
+{
+  FAR struct mm_bench_slot_s *slot;
+  int head;
+
+  while (thread->ndone < thread->nops)
+    {
+      head = atomic_read(&thread->head);
+      if (head - atomic_read_acquire(&thread->tail) ==
+          (int)thread->nslots)
+        {
+          sched_yield();
+          continue;
+        }
+
+      slot = &thread->slots[head % thread->nslots];
+      mm_bench_alloc(thread, slot, mm_bench_size(thread));
+      if (slot->mem != NULL)
+        {
+          atomic_set_release(&thread->head, head + 1);
+        }
+    }
+
+  atomic_set_release(&thread->finished, 1);
+}
+
+static void mm_bench_consume(FAR struct mm_bench_thread_s *thread)
+{
+  FAR struct mm_bench_thread_s *peer = thread->peer;
+  int tail;
+
+  for (; ; )
+    {
+      tail = atomic_read(&peer->tail);
+      if (tail == atomic_read_acquire(&peer->head))
+        {
+          if (atomic_read_acquire(&peer->finished) &&
+              tail == atomic_read_acquire(&peer->head))
+            {
+              break;
+            }
+
+          sched_yield();
+          continue;
+        }
+
+      mm_bench_free(thread, &peer->slots[tail % peer->nslots]);
+      atomic_set_release(&peer->tail, tail + 1);
+    }
+}
+
+/****************************************************************************
+ * Name: mm_bench_replay
+ *
+ * Description:
+ *   Replay one line of a trace.  Each line is "a <slot> <size>" (allocate),
+ *   "r <slot> <size>" (reallocate) or "f <slot>" (free); lines starting
+ *   with '#' are comments.  A trace recorded from the heap notes can be
+ *   reduced to this form offline by numbering the live addresses.
+ *
+ ****************************************************************************/
+
+static int mm_bench_replay(FAR struct mm_bench_thread_s *thread,
+                           FAR const char *line)
+{
+  FAR struct mm_bench_slot_s *slot;
+  unsigned long index;
+  unsigned long size = 0;
+  FAR char *next;
+
+  if (line[0] == '#' || line[0] == '\0')
+    {
+      return OK;
+    }
+
+  index = strtoul(line + 1, &next, 0);
+  if (line[0] != 'f')
+    {
+      size = strtoul(next, NULL, 0);
+    }
+
+  if (index >= thread->nslots || strchr("arf", line[0]) == NULL)
+    {
+      return -EINVAL;
+    }
+
+  slot = &thread->slots[index];
+  if (line[0] == 'f')
+    {
+      if (slot->mem != NULL)
+        {
+          mm_bench_free(thread, slot);
+        }
+    }
+  else if (line[0] == 'r' && slot->mem != NULL)
+    {
+      mm_bench_realloc(thread, slot, size);
+    }
+  else
+    {
+      if (slot->mem != NULL)
+        {
+          mm_bench_free(thread, slot);
+        }
+
+      mm_bench_alloc(thread, slot, size);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mm_bench_trace
+ *
+ * Description:
+ *   Replay the trace file line by line.
+ *
+ ****************************************************************************/
+
+static int mm_bench_trace(FAR struct mm_bench_thread_s *thread)
+{
+  char line[MM_BENCH_TRACELEN];
+  struct file file;
+  FAR char *eol;
+  size_t len = 0;
+  size_t used;
+  ssize_t nread;
+  int ret;
+
+  ret = file_open(&file, g_mm_bench->path, O_RDONLY);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  line[0] = '\0';
+  for (; ; )
+    {
+      eol = strchr(line, '\n');
+      if (eol == NULL)
+        {
+          if (len == sizeof(line) - 1)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          nread = file_read(&file, line + len, sizeof(line) - 1 - len);
+          if (nread < 0)
+            {
+              ret = nread;
+              break;
+            }
+          else if (nread > 0)
+            {
+              len += nread;
+              line[len] = '\0';
+              continue;
+            }
+          else if (len == 0)
+            {
+              break;
+            }
+
+          /* The last line has no newline */
+
+          eol = line + len;
+        }
+
+      used = eol - line + (eol < line + len);
+      *eol = '\0';
+
+      ret = mm_bench_replay(thread, line);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      /* Keep the rest of the buffer for the next line */
+
+      len -= used;
+      memmove(line, line + used, len + 1);
+    }
+
+  file_close(&file);
+
+  for (used = 0; used < thread->nslots; used++)
+    {
+      if (thread->slots[used].mem != NULL)
+        {
+          mm_free(g_mm_bench->heap, thread->slots[used].mem);
+          atomic_fetch_sub(&g_mm_bench->live, thread->slots[used].size);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_bench_entry
+ *
+ * Description:
+ *   The benchmark threads.  argv[1] is the index of the thread.
+ *
+ ****************************************************************************/
+
+static int mm_bench_entry(int argc, FAR char *argv[])
+{
+  FAR struct mm_bench_s *bench = g_mm_bench;
+  FAR struct mm_bench_thread_s *thread = bench->thread[atoi(argv[1])];
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+
+  CPU_ZERO(&cpuset);
+  CPU_SET(thread->index % CONFIG_SMP_NCPUS, &cpuset);
+  nxsched_set_affinity(0, sizeof(cpuset), &cpuset);
+#endif
+
+  nxsem_wait_uninterruptible(&bench->start);
+  if (!bench->abort)
+    {
+      switch (bench->pattern)
+        {
+          case MM_BENCH_CHURN:
+            mm_bench_churn(thread);
+            break;
+
+          case MM_BENCH_FIFO:
+            if (thread->peer == NULL)
+              {
+                mm_bench_produce(thread);
+              }
+            else
+              {
+                mm_bench_consume(thread);
+              }
+            break;
+
+          case MM_BENCH_TRACE:
+            thread->error = mm_bench_trace(thread);
+            break;
+        }
+    }
+
+  nxsem_post(&bench->done);
+  return 0;
+}
+
+static int mm_bench_compare(FAR const void *a, FAR const void *b)
+{
+  uint32_t x = *(FAR const uint32_t *)a;
+  uint32_t y = *(FAR const uint32_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+static uint64_t mm_bench_nsec(uint64_t ticks)
+{
+  unsigned long freq = perf_getfreq();
+
+  return ticks / freq * NSEC_PER_SEC +
+         ticks % freq * NSEC_PER_SEC / freq;
+}
+
+static uint32_t mm_bench_nsec32(uint64_t ticks)
+{
+  return MIN(mm_bench_nsec(ticks), UINT32_MAX);
+}
+
+/****************************************************************************
+ * Name: mm_bench_report
+ *
+ * Description:
+ *   Merge the statistics of the threads into a new result.
+ *
+ ****************************************************************************/
+
+static void mm_bench_report(FAR struct mm_bench_s *bench,
+                            FAR const char *allocator)
+{
+  FAR struct mm_bench_result_s *result;
+  FAR uint32_t *samples;
+  uint64_t busy = 0;
+  uint32_t max = 0;
+  size_t nsamples = 0;
+  size_t n;
+  int i;
+
+  result = &g_mm_bench_results[g_mm_bench_count++ %
+                               CONFIG_MM_BENCH_NRESULTS];
+  memset(result, 0, sizeof(*result));
+
+  snprintf(result->name, sizeof(result->name), "%s %s %s",
+           g_mm_bench_patterns[bench->pattern], allocator,
+           bench->pattern == MM_BENCH_TRACE ? "-" :
+           g_mm_bench_sizes[bench->sizes]);
+
+  samples = kmm_malloc(bench->nthreads * CONFIG_MM_BENCH_NSAMPLES *
+                       sizeof(uint32_t));
+
+  for (i = 0; i < bench->nthreads; i++)
+    {
+      FAR struct mm_bench_thread_s *thread = bench->thread[i];
+
+      n = MIN(thread->nseen, CONFIG_MM_BENCH_NSAMPLES);
+      if (samples != NULL)
+        {
+          memcpy(samples + nsamples, thread->samples, n * sizeof(uint32_t));
+          nsamples += n;
+        }
+
+      result->nops  += thread->nseen;
+      result->nfail += thread->nfail;
+      busy          += thread->busy;
+      max            = MAX(max, thread->max);
+    }
+
+  if (nsamples > 0)
+    {
+      qsort(samples, nsamples, sizeof(uint32_t), mm_bench_compare);
+      result->p50 = mm_bench_nsec32(samples[nsamples / 2]);
+      result->p99 = mm_bench_nsec32(samples[nsamples * 99 / 100]);
+    }
+
+  kmm_free(samples);
+
+  /* The threads run in parallel, so the time of one thread is the average
+   * time spent in the allocator.
+   */
+
+  busy = mm_bench_nsec(busy / bench->nthreads);
+  if (busy > 0)
+    {
+      result->opsps = MIN((uint64_t)result->nops * NSEC_PER_SEC / busy,
+                          UINT32_MAX);
+    }
+
+  result->nthreads = bench->nthreads;
+  result->max      = mm_bench_nsec32(max);
+  result->frag     = bench->frag;
+}
+
+/****************************************************************************
+ * Name: mm_bench_parse
+ *
+ * Description:
+ *   Parse "<pattern> <allocator> <sizes|path> [nops [nthreads]]".
+ *
+ ****************************************************************************/
+
+static int mm_bench_parse(FAR struct mm_bench_s *bench, FAR char *cmd,
+                          FAR bool *mempool, FAR size_t *nops)
+{
+  FAR char *argv[5] =
+    {
+      NULL
+    };
+
+  FAR char *save;
+  int argc;
+  int i;
+
+  for (argc = 0; argc < 5; argc++)
+    {
+      argv[argc] = strtok_r(argc == 0 ? cmd : NULL, " \t\n", &save);
+      if (argv[argc] == NULL)
+        {
+          break;
+        }
+    }
+
+  if (argc < 3)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < (int)nitems(g_mm_bench_patterns); i++)
+    {
+      if (strcmp(argv[0], g_mm_bench_patterns[i]) == 0)
+        {
+          break;
+        }
+    }
+
+  bench->pattern = i;
+
+  if (strcmp(argv[1], "heap") == 0)
+    {
+      *mempool = false;
+    }
+  else if (strcmp(argv[1], "mempool") == 0)
+    {
+      *mempool = true;
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  if (bench->pattern == MM_BENCH_TRACE)
+    {
+      bench->path = argv[2];
+    }
+  else
+    {
+      for (i = 0; i < (int)nitems(g_mm_bench_sizes); i++)
+        {
+          if (strcmp(argv[2], g_mm_bench_sizes[i]) == 0)
+            {
+              break;
+            }
+        }
+
+      bench->sizes = i;
+    }
+
+  *nops           = argc > 3 ? strtoul(argv[3], NULL, 0) : MM_BENCH_NOPS;
+  bench->nthreads = argc > 4 ? atoi(argv[4]) : 1;
+
+  /* FIFO runs pairs of producers and consumers, a trace one thread */
+
+  if (bench->pattern == MM_BENCH_FIFO)
+    {
+      bench->nthreads = MAX(bench->nthreads & ~1, 2);
+    }
+  else if (bench->pattern == MM_BENCH_TRACE)
+    {
+      bench->nthreads = 1;
+    }
+
+  if (bench->pattern >= nitems(g_mm_bench_patterns) ||
+      bench->sizes >= nitems(g_mm_bench_sizes) || *nops == 0 ||
+      bench->nthreads < 1 || bench->nthreads > CONFIG_MM_BENCH_NTHREADS ||
+      bench->nthreads > CONFIG_MM_BENCH_NSLOTS)
+    {
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mm_bench_setup
+ *
+ * Description:
+ *   Create the private heap and the state of the threads.
+ *
+ ****************************************************************************/
+
+static int mm_bench_setup(FAR struct mm_bench_s *bench, bool mempool,
+                          size_t nops)
+{
+  FAR struct mm_bench_thread_s *thread;
+  size_t nslots;
+  int i;
+
+  bench->arena = kmm_malloc(CONFIG_MM_BENCH_HEAPSIZE);
+  if (bench->arena == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  if (mempool)
+    {
+#if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD > 0
+      bench->heap = mm_initialize_pool("bench", bench->arena,
+                                       CONFIG_MM_BENCH_HEAPSIZE, NULL);
+#else
+      return -ENOSYS;
+#endif
+    }
+  else
+    {
+      bench->heap = mm_initialize("bench", bench->arena,
+                                  CONFIG_MM_BENCH_HEAPSIZE);
+    }
+
+  if (bench->heap == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  bench->usable = mm_heapfree(bench->heap);
+
+  /* The slots are split among the threads, a consumer uses the ring of
+   * the producer before it.
+   */
+
+  nslots = CONFIG_MM_BENCH_NSLOTS / bench->nthreads;
+  if (bench->pattern == MM_BENCH_FIFO)
+    {
+      nslots *= 2;
+    }
+
+  for (i = 0; i < bench->nthreads; i++)
+    {
+      thread = kmm_zalloc(sizeof(*thread) +
+                          nslots * sizeof(struct mm_bench_slot_s));
+      if (thread == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      bench->thread[i] = thread;
+      thread->slots    = (FAR struct mm_bench_slot_s *)(thread + 1);
+      thread->nslots   = nslots;
+      thread->nops     = nops / bench->nthreads;
+      thread->seed     = 2463534242u + i;
+      thread->index    = i;
+
+      if (bench->pattern == MM_BENCH_FIFO && (i & 1) != 0)
+        {
+          thread->peer = bench->thread[i - 1];
+        }
+    }
+
+  return OK;
+}
+
+static void mm_bench_teardown(FAR struct mm_bench_s *bench)
+{
+  int i;
+
+  for (i = 0; i < bench->nthreads; i++)
+    {
+      kmm_free(bench->thread[i]);
+    }
+
+  if (bench->heap != NULL)
+    {
+      mm_uninitialize(bench->heap);
+    }
+
+  kmm_free(bench->arena);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_bench_run
+ *
+ * Description:
+ *   Run one benchmark and keep its result.  "cmd" is
+ *   "<pattern> <allocator> <sizes|path> [nops [nthreads]]" where:
+ *
+ *     pattern   - "churn": random alloc/realloc/free over a set of slots,
+ *                 "fifo": producers allocate and consumers free, or
+ *                 "trace": replay a trace file
+ *     allocator - "heap": the selected heap manager alone, or
+ *                 "mempool": the heap with its memory pools
+ *     sizes     - "small", "mixed" or "large", or the path of the trace
+ *     nops      - The number of operations, spread over the threads
+ *     nthreads  - The number of threads, each on its own CPU if possible
+ *
+ *   "clear" discards the results.
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mm_bench_run(FAR const char *cmd)
+{
+  struct mm_bench_s bench;
+  FAR char *argv[2];
+  char index[8];
+  FAR char *copy;
+  bool mempool;
+  size_t nops;
+  int ret;
+  int n;
+  int i;
+
+  copy = kmm_malloc(strlen(cmd) + 1);
+  if (copy == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  strcpy(copy, cmd);
+
+  ret = nxmutex_lock(&g_mm_bench_lock);
+  if (ret < 0)
+    {
+      kmm_free(copy);
+      return ret;
+    }
+
+  if (strncmp(copy, "clear", 5) == 0)
+    {
+      g_mm_bench_count = 0;
+      goto out;
+    }
+
+  memset(&bench, 0, sizeof(bench));
+  ret = mm_bench_parse(&bench, copy, &mempool, &nops);
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  nxsem_init(&bench.start, 0, 0);
+  nxsem_init(&bench.done, 0, 0);
+  g_mm_bench = &bench;
+
+  ret = mm_bench_setup(&bench, mempool, nops);
+  for (n = 0; ret >= 0 && n < bench.nthreads; )
+    {
+      snprintf(index, sizeof(index), "%d", n);
+      argv[0] = index;
+      argv[1] = NULL;
+
+      ret = kthread_create("mm_bench", CONFIG_MM_BENCH_PRIORITY,
+                           CONFIG_MM_BENCH_STACKSIZE, mm_bench_entry,
+                           argv);
+      if (ret >= 0)
+        {
+          n++;
+        }
+    }
+
+  /* Start the threads all at once, or let them exit if not all of them
+   * could be created
+   */
+
+  bench.abort = ret < 0;
+  for (i = 0; i < n; i++)
+    {
+      nxsem_post(&bench.start);
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      nxsem_wait_uninterruptible(&bench.done);
+    }
+
+  if (ret >= 0)
+    {
+      ret = bench.thread[0]->error;
+      if (ret >= 0)
+        {
+          mm_bench_report(&bench, mempool ? MM_BENCH_MANAGER "+pool" :
+                                            MM_BENCH_MANAGER);
+          ret = OK;
+        }
+    }
+
+  mm_bench_teardown(&bench);
+  nxsem_destroy(&bench.start);
+  nxsem_destroy(&bench.done);
+  g_mm_bench = NULL;
+
+out:
+  nxmutex_unlock(&g_mm_bench_lock);
+  kmm_free(copy);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_bench_result
+ *
+ * Description:
+ *   Return the result of a previous run, the oldest one kept first.
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no such result.
+ *
+ ****************************************************************************/
+
+int mm_bench_result(int index, FAR struct mm_bench_result_s *result)
+{
+  unsigned int count;
+  int ret;
+
+  ret = nxmutex_lock(&g_mm_bench_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  count = MIN(g_mm_bench_count, CONFIG_MM_BENCH_NRESULTS);
+  if (index < 0 || index >= count)
+    {
+      ret = -ENOENT;
+    }
+  else
+    {
+      *result = g_mm_bench_results[(g_mm_bench_count - count + index) %
+                                   CONFIG_MM_BENCH_NRESULTS];
+    }
+
+  nxmutex_unlock(&g_mm_bench_lock);
+  return ret;
+}
+
+#endif /* CONFIG_BUILD_FLAT || __KERNEL__ */
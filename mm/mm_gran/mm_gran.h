@@ -44,8 +44,15 @@
 
 #define SIZEOF_GAT(n) \
   ((n + 31) >> 5)
+#ifdef CONFIG_GRAN_SUMMARY
+#  define SIZEOF_GAT_SUMMARY(n) \
+  (2 * SIZEOF_GAT(SIZEOF_GAT(n)))
+#else
+#  define SIZEOF_GAT_SUMMARY(n) 0
+#endif
 #define SIZEOF_GRAN_S(n) \
-  (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
+  (sizeof(struct gran_s) + sizeof(uint32_t) * \
+   (SIZEOF_GAT(n) + SIZEOF_GAT_SUMMARY(n) - 1))
 
 /* Debug */
 
@@ -77,6 +84,10 @@ struct gran_s
   mutex_t    lock;       /* For exclusive access to the GAT */
 #endif
   uintptr_t  heapstart; /* The aligned start of the granule heap */
+#ifdef CONFIG_GRAN_SUMMARY
+  FAR uint32_t *gfull;  /* One bit per GAT cell without free granules */
+  FAR uint32_t *gfree;  /* One bit per GAT cell without used granules */
+#endif
   uint32_t   gat[1];    /* Start of the granule allocation table */
 };
 
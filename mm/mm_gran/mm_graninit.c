@@ -33,6 +33,7 @@
 #include <nuttx/kmalloc.h>
 
 #include "mm_gran/mm_gran.h"
+#include "mm_gran/mm_grantable.h"
 
 #ifdef CONFIG_GRAN
 
@@ -138,6 +139,20 @@ GRAN_HANDLE gran_initialize(FAR void *heapstart, size_t heapsize,
       priv->ngranules = ngranules;
       priv->heapstart = alignedstart;
 
+#ifdef CONFIG_GRAN_SUMMARY
+      /* The summary bitmaps follow the GAT.  Clearing the whole table
+       * marks every cell as free in them.
+       */
+
+      priv->gfull     = &priv->gat[SIZEOF_GAT(ngranules)];
+      priv->gfree     = priv->gfull + SIZEOF_GAT(SIZEOF_GAT(ngranules));
+
+      if (ngranules > 0)
+        {
+          gran_clear(priv, 0, ngranules);
+        }
+#endif
+
       /* Initialize mutual exclusion support */
 
 #ifndef CONFIG_GRAN_INTR
@@ -90,6 +90,75 @@ uint32_t lsb_mask(uint32_t n)
   return (-n & n) & GATCFULL;
 }
 
+/* return the offset of the least significant set bit of n */
+
+static inline uint32_t lsb_offset(uint32_t n)
+{
+  DEBUGASSERT(n);
+#ifdef CONFIG_HAVE_BUILTIN_CTZ
+  return __builtin_ctz(n);
+#else
+  return DEBRUJIN_LUT[(uint32_t)(lsb_mask(n) * DEBRUJIN_NUM) >> 27];
+#endif
+}
+
+#ifdef CONFIG_GRAN_SUMMARY
+/* update the summary bits of a GAT cell */
+
+static void cell_summarize(gran_t *gran, uint32_t cell)
+{
+  uint32_t sidx = cell / 32;
+  uint32_t mask = BIT(cell % 32);
+  uint32_t v = gran->gat[cell];
+
+  if (v == GATCFULL)
+    {
+      gran->gfull[sidx] |= mask;
+    }
+  else
+    {
+      gran->gfull[sidx] &= ~mask;
+    }
+
+  if (v == 0)
+    {
+      gran->gfree[sidx] |= mask;
+    }
+  else
+    {
+      gran->gfree[sidx] &= ~mask;
+    }
+}
+
+/* return the first cell from given one whose summary bit is clear */
+
+static uint32_t summary_skip(const uint32_t *summ, uint32_t cell,
+                             uint32_t ncells)
+{
+  uint32_t sidx = cell / 32;
+  uint32_t v;
+
+  if (cell >= ncells)
+    {
+      return ncells;
+    }
+
+  v = ~summ[sidx] & (GATCFULL << (cell % 32));
+  while (v == 0)
+    {
+      if (++sidx >= SIZEOF_GAT(ncells))
+        {
+          return ncells;
+        }
+
+      v = ~summ[sidx];
+    }
+
+  cell = sidx * 32 + lsb_offset(v);
+  return cell < ncells ? cell : ncells;
+}
+#endif
+
 /* set or clear a GAT cell with given bit mask */
 
 static void cell_set(gran_t *gran, uint32_t cell, uint32_t mask, bool val)
@@ -102,6 +171,82 @@ static void cell_set(gran_t *gran, uint32_t cell, uint32_t mask, bool val)
     {
       gran->gat[cell] &= ~mask;
     }
+
+#ifdef CONFIG_GRAN_SUMMARY
+  cell_summarize(gran, cell);
+#endif
+}
+
+/* return the first free granule from given position, or ngranules */
+
+static size_t gran_next_free(const gran_t *gran, size_t posi)
+{
+  uint32_t ncells = SIZEOF_GAT(gran->ngranules);
+  uint32_t cell = posi / GATC_BITS(gran);
+  uint32_t v;
+
+  if (posi >= gran->ngranules)
+    {
+      return gran->ngranules;
+    }
+
+  v = ~gran->gat[cell] & (GATCFULL << (posi % GATC_BITS(gran)));
+  while (v == 0)
+    {
+      /* Skip cells without a free granule */
+
+#ifdef CONFIG_GRAN_SUMMARY
+      cell = summary_skip(gran->gfull, cell + 1, ncells);
+#else
+      cell++;
+#endif
+      if (cell >= ncells)
+        {
+          return gran->ngranules;
+        }
+
+      v = ~gran->gat[cell];
+    }
+
+  posi = cell * GATC_BITS(gran) + lsb_offset(v);
+  return posi < gran->ngranules ? posi : gran->ngranules;
+}
+
+/* return the first used granule in [posi, limit), or limit */
+
+static size_t gran_next_used(const gran_t *gran, size_t posi, size_t limit)
+{
+#ifdef CONFIG_GRAN_SUMMARY
+  uint32_t ncells = SIZEOF_GAT(gran->ngranules);
+#endif
+  uint32_t cell = posi / GATC_BITS(gran);
+  uint32_t v;
+
+  if (posi >= limit)
+    {
+      return limit;
+    }
+
+  v = gran->gat[cell] & (GATCFULL << (posi % GATC_BITS(gran)));
+  while (v == 0)
+    {
+      /* Skip cells without a used granule */
+
+#ifdef CONFIG_GRAN_SUMMARY
+      cell = summary_skip(gran->gfree, cell + 1, ncells);
+#else
+      cell++;
+#endif
+      if (cell * GATC_BITS(gran) >= limit)
+        {
+          return limit;
+        }
+
+      v = gran->gat[cell];
+    }
+
+  posi = cell * GATC_BITS(gran) + lsb_offset(v);
+  return posi < limit ? posi : limit;
 }
 
 /* set or clear a range of GAT bits */
@@ -266,14 +411,29 @@ int gran_search(const gran_t *gran, size_t size)
       return ret;
     }
 
+  /* Hop from one free run to the next, measuring each run with whole
+   * cell scans until one is long enough.
+   */
+
   ret = -ENOMEM;
-  for (size_t i = 0; i <= gran->ngranules - size; i++)
+  for (size_t i = 0; ; )
     {
-      if (gran_match(gran, i, size, 0, &i))
+      size_t end;
+
+      i = gran_next_free(gran, i);
+      if (i + size > gran->ngranules)
+        {
+          break;
+        }
+
+      end = gran_next_used(gran, i, i + size);
+      if (end == i + size)
         {
           ret = i;
           break;
         }
+
+      i = end;
     }
 
   return ret;
@@ -174,6 +174,49 @@ uintptr_t mm_pgalloc_align(unsigned int npages, unsigned int align)
   return (uintptr_t)gran_alloc_align(g_pgalloc, alloc_size, align_size);
 }
 
+/****************************************************************************
+ * Name: mm_pgalloc_contig
+ *
+ * Description:
+ *   Allocate physically contiguous page memory, aligned so that it can be
+ *   mapped with the largest block or contiguous entries its size allows,
+ *   up to MM_PGLARGESIZE.  The alignment is relaxed when the pool is too
+ *   fragmented for it.
+ *
+ * Input Parameters:
+ *   npages - The number of pages to allocate, each of size CONFIG_MM_PGSIZE.
+ *
+ * Returned Value:
+ *   On success, a non-zero, physical address of the allocated page memory
+ *   is returned.  Zero is returned on failure.  NOTE:  This is an unmapped
+ *   physical address and cannot be used until it is appropriately mapped.
+ *
+ ****************************************************************************/
+
+uintptr_t mm_pgalloc_contig(unsigned int npages)
+{
+  unsigned int align = MM_PGLARGESIZE >> MM_PGSHIFT;
+  uintptr_t paddr;
+
+  /* Start from the largest power of two pages that fits in npages */
+
+  while (align > 1 && align > npages)
+    {
+      align >>= 1;
+    }
+
+  for (; align > 1; align >>= 1)
+    {
+      paddr = mm_pgalloc_align(npages, align);
+      if (paddr != 0)
+        {
+          return paddr;
+        }
+    }
+
+  return mm_pgalloc(npages);
+}
+
 /****************************************************************************
  * Name: mm_pgfree
  *
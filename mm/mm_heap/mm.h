@@ -35,6 +35,7 @@
 #include <nuttx/lib/math32.h>
 #include <nuttx/mm/mempool.h>
 #include <nuttx/mm/mm.h>
+#include <nuttx/spinlock.h>
 
 #include <assert.h>
 #include <sys/types.h>
@@ -109,6 +110,18 @@
 #  define MM_ADD_BACKTRACE(heap, ptr)
 #endif
 
+/* The region tags that a malloc() or memalign() request of "size" bytes
+ * prefers by default, and the number of free nodes past the best fit that
+ * are searched for a node in such a region.
+ */
+
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+#  define MM_REGION_POLICY(size) \
+     ((size) > 0 && (size) <= CONFIG_MM_HEAP_REGION_FAST_SIZE ? \
+      MM_REGION_FAST : 0)
+#  define MM_REGION_SEARCH 32
+#endif
+
 /* All other definitions derive from these two */
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
@@ -158,6 +171,16 @@
 #define MM_PREVNODE_IS_ALLOC(node) (((node)->size & MM_PREVFREE_BIT) == 0)
 #define MM_PREVNODE_IS_FREE(node) (((node)->size & MM_PREVFREE_BIT) != 0)
 
+/* The per-CPU cache has one list for each chunk size from MM_MIN_CHUNK to
+ * CONFIG_MM_HEAP_CACHE_MAXSIZE in steps of MM_ALIGN.
+ */
+
+#ifdef CONFIG_MM_HEAP_CACHE
+#  define MM_CACHE_NLISTS \
+     ((CONFIG_MM_HEAP_CACHE_MAXSIZE - MM_MIN_CHUNK) / MM_ALIGN + 1)
+#  define MM_CACHE_NDX(size) (((size) - MM_MIN_CHUNK) / MM_ALIGN)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -216,6 +239,24 @@ struct mm_delaynode_s
   FAR struct mm_delaynode_s *flink;
 };
 
+/* This describes the cache of small free chunks of one CPU.  The chunks
+ * stay allocated as far as the heap is concerned and are linked through
+ * their payload, like the delay list.
+ */
+
+#ifdef CONFIG_MM_HEAP_CACHE
+static_assert(CONFIG_MM_HEAP_CACHE_MAXSIZE >= MM_MIN_CHUNK,
+              "CONFIG_MM_HEAP_CACHE_MAXSIZE is smaller than MM_MIN_CHUNK\n");
+
+struct mm_cache_s
+{
+  spinlock_t lock;                                 /* Protects the lists */
+  size_t size;                                     /* Bytes cached */
+  FAR struct mm_delaynode_s *list[MM_CACHE_NLISTS];
+  uint8_t count[MM_CACHE_NLISTS];                  /* Chunks in each list */
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -245,6 +286,12 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+  /* The MM_REGION_* tags of each region */
+
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+  uint8_t mm_regionflags[CONFIG_MM_REGIONS];
+#endif
+
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed up searching of free nodes.
@@ -260,6 +307,12 @@ struct mm_heap_s
   size_t mm_delaycount[CONFIG_SMP_NCPUS];
 #endif
 
+  /* Small free chunks cached by each CPU */
+
+#ifdef CONFIG_MM_HEAP_CACHE
+  struct mm_cache_s mm_cache[CONFIG_SMP_NCPUS];
+#endif
+
   /* The is a multiple mempool of the heap */
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
@@ -302,6 +355,26 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
 
 void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay);
 
+/* Functions contained in mm_sample.c ***************************************/
+
+#if defined(CONFIG_MM_HEAP_SAMPLE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+void mm_sample_alloc(FAR void *mem, size_t size);
+void mm_sample_free(FAR void *mem);
+#else
+#  define mm_sample_alloc(mem, size)
+#  define mm_sample_free(mem)
+#endif
+
+/* Functions contained in mm_cache.c ****************************************/
+
+#ifdef CONFIG_MM_HEAP_CACHE
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t alignsize);
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem);
+bool mm_cache_flush(FAR struct mm_heap_s *heap);
+size_t mm_cache_size(FAR struct mm_heap_s *heap);
+#endif
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
@@ -318,6 +391,26 @@ static inline_function int mm_size2ndx(size_t size)
   return flsl(size) - 1;
 }
 
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+static inline_function bool mm_region_match(FAR struct mm_heap_s *heap,
+                                            FAR void *node,
+                                            unsigned int flags)
+{
+  int region;
+
+  for (region = 0; region < heap->mm_nregions; region++)
+    {
+      if (node >= (FAR void *)heap->mm_heapstart[region] &&
+          node < (FAR void *)heap->mm_heapend[region])
+        {
+          return (heap->mm_regionflags[region] & flags) == flags;
+        }
+    }
+
+  return false;
+}
+#endif
+
 static inline_function void mm_addfreechunk(FAR struct mm_heap_s *heap,
                                             FAR struct mm_freenode_s *node)
 {
@@ -0,0 +1,320 @@
+/****************************************************************************
+ * mm/mm_heap/mm_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/kasan.h>
+#include <nuttx/sched.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/spinlock.h>
+
+#include "mm_heap/mm.h"
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_release
+ *
+ * Description:
+ *   Return a list of cached chunks to the heap.
+ *
+ ****************************************************************************/
+
+static void mm_cache_release(FAR struct mm_heap_s *heap,
+                             FAR struct mm_delaynode_s *list)
+{
+  while (list != NULL)
+    {
+      FAR void *mem = list;
+
+      list = list->flink;
+      mm_delayfree(heap, mem, false);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_cache_alloc
+ *
+ * Description:
+ *   Take a chunk of exactly "alignsize" bytes from the cache of this CPU.
+ *
+ * Input Parameters:
+ *   heap      - The heap the chunk belongs to
+ *   alignsize - The chunk size, including the allocation overhead
+ *
+ * Returned Value:
+ *   The allocated memory, or NULL if no chunk of that size is cached.
+ *
+ ****************************************************************************/
+
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t alignsize)
+{
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_cache_s *cache;
+  FAR void *ret;
+  irqstate_t flags;
+  int ndx;
+
+  if (alignsize > CONFIG_MM_HEAP_CACHE_MAXSIZE)
+    {
+      return NULL;
+    }
+
+  ndx = MM_CACHE_NDX(alignsize);
+
+  /* Interrupts stay disabled so that this CPU is not left while its cache
+   * is in use.  The spinlock only matters to mm_cache_flush().
+   */
+
+  flags = mm_lock_irq(heap);
+  cache = &heap->mm_cache[this_cpu()];
+  spin_lock(&cache->lock);
+
+  ret = cache->list[ndx];
+  if (ret != NULL)
+    {
+      cache->list[ndx] = cache->list[ndx]->flink;
+      cache->count[ndx]--;
+      cache->size -= alignsize;
+    }
+
+  spin_unlock(&cache->lock);
+  mm_unlock_irq(heap, flags);
+
+  if (ret == NULL)
+    {
+      return NULL;
+    }
+
+  node = (FAR struct mm_allocnode_s *)
+         ((FAR char *)ret - MM_SIZEOF_ALLOCNODE);
+  DEBUGASSERT(MM_NODE_IS_ALLOC(node) && MM_SIZEOF_NODE(node) == alignsize);
+
+  sched_note_heap(NOTE_HEAP_ALLOC, heap, ret, alignsize, heap->mm_curused);
+
+  MM_ADD_BACKTRACE(heap, node);
+  ret = kasan_unpoison(ret, alignsize - MM_ALLOCNODE_OVERHEAD);
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(ret, MM_ALLOC_MAGIC, alignsize - MM_ALLOCNODE_OVERHEAD);
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_cache_free
+ *
+ * Description:
+ *   Keep a small chunk in the cache of this CPU instead of returning it to
+ *   the heap.  If the list of that size is full, the chunks already in it
+ *   are returned to the heap first.
+ *
+ * Input Parameters:
+ *   heap - The heap the chunk belongs to
+ *   mem  - The memory being freed
+ *
+ * Returned Value:
+ *   true if the chunk was cached, false if it is too large to be.
+ *
+ ****************************************************************************/
+
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_delaynode_s *victims = NULL;
+  FAR struct mm_delaynode_s *tmp;
+  FAR struct mm_allocnode_s *node;
+  FAR struct mm_cache_s *cache;
+  irqstate_t flags;
+  size_t nodesize;
+  int ndx;
+
+  mem = kasan_clear_tag(mem);
+  node = (FAR struct mm_allocnode_s *)
+         ((FAR char *)mem - MM_SIZEOF_ALLOCNODE);
+  nodesize = MM_SIZEOF_NODE(node);
+  if (nodesize > CONFIG_MM_HEAP_CACHE_MAXSIZE)
+    {
+      return false;
+    }
+
+  /* Sanity check against double-frees of chunks that went to the heap */
+
+  DEBUGASSERT(MM_NODE_IS_ALLOC(node));
+
+  ndx = MM_CACHE_NDX(nodesize);
+
+  flags = mm_lock_irq(heap);
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(mem, MM_FREE_MAGIC, nodesize - MM_ALLOCNODE_OVERHEAD);
+#endif
+
+  kasan_poison(mem, nodesize - MM_ALLOCNODE_OVERHEAD);
+
+  cache = &heap->mm_cache[this_cpu()];
+  spin_lock(&cache->lock);
+
+  if (cache->count[ndx] >= CONFIG_MM_HEAP_CACHE_COUNT)
+    {
+      victims = cache->list[ndx];
+      cache->list[ndx] = NULL;
+      cache->size -= cache->count[ndx] * nodesize;
+      cache->count[ndx] = 0;
+    }
+
+  tmp = mem;
+  tmp->flink = cache->list[ndx];
+  cache->list[ndx] = tmp;
+  cache->count[ndx]++;
+  cache->size += nodesize;
+
+  spin_unlock(&cache->lock);
+  mm_unlock_irq(heap, flags);
+
+  sched_note_heap(NOTE_HEAP_FREE, heap, mem, nodesize, heap->mm_curused);
+
+  mm_cache_release(heap, victims);
+  return true;
+}
+
+/****************************************************************************
+ * Name: mm_cache_flush
+ *
+ * Description:
+ *   Return the chunks cached by all CPUs to the heap.
+ *
+ * Returned Value:
+ *   true if any chunk was returned.
+ *
+ ****************************************************************************/
+
+bool mm_cache_flush(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_delaynode_s *victims = NULL;
+  FAR struct mm_delaynode_s *tail;
+  FAR struct mm_cache_s *cache;
+  irqstate_t flags;
+  int cpu;
+  int ndx;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &heap->mm_cache[cpu];
+
+      flags = mm_lock_irq(heap);
+      spin_lock(&cache->lock);
+
+      for (ndx = 0; ndx < MM_CACHE_NLISTS; ndx++)
+        {
+          if (cache->list[ndx] != NULL)
+            {
+              for (tail = cache->list[ndx]; tail->flink != NULL;
+                   tail = tail->flink);
+
+              tail->flink = victims;
+              victims = cache->list[ndx];
+              cache->list[ndx] = NULL;
+              cache->count[ndx] = 0;
+            }
+        }
+
+      cache->size = 0;
+
+      spin_unlock(&cache->lock);
+      mm_unlock_irq(heap, flags);
+    }
+
+  if (victims == NULL)
+    {
+      return false;
+    }
+
+  mm_cache_release(heap, victims);
+  return true;
+}
+
+/****************************************************************************
+ * Name: mm_cache_size
+ *
+ * Description:
+ *   Return the number of bytes held in the caches of all CPUs.
+ *
+ ****************************************************************************/
+
+size_t mm_cache_size(FAR struct mm_heap_s *heap)
+{
+  size_t size = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      size += heap->mm_cache[cpu].size;
+    }
+
+  return size;
+}
+
+#else /* CONFIG_BUILD_FLAT || __KERNEL__ */
+
+/* The user heap of a protected or kernel build cannot disable interrupts,
+ * so it goes without the cache.
+ */
+
+FAR void *mm_cache_alloc(FAR struct mm_heap_s *heap, size_t alignsize)
+{
+  return NULL;
+}
+
+bool mm_cache_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  return false;
+}
+
+bool mm_cache_flush(FAR struct mm_heap_s *heap)
+{
+  return false;
+}
+
+size_t mm_cache_size(FAR struct mm_heap_s *heap)
+{
+  return 0;
+}
+
+#endif /* CONFIG_BUILD_FLAT || __KERNEL__ */
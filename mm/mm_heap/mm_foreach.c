@@ -103,3 +103,56 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
     }
 #undef region
 }
+
+/****************************************************************************
+ * Name: mm_foreach_free
+ *
+ * Description:
+ *   Report the payload of each free chunk in the heap.  The heap is walked
+ *   without the lock, so this may only be used when the heap cannot
+ *   change, e.g. while writing a core dump.  The walk stops at the first
+ *   node that does not look sane rather than following a corrupted heap.
+ *
+ ****************************************************************************/
+
+void mm_foreach_free(FAR struct mm_heap_s *heap,
+                     CODE void (*handler)(FAR void *start, size_t size,
+                                          FAR void *arg),
+                     FAR void *arg)
+{
+  FAR struct mm_allocnode_s *node;
+  size_t nodesize;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+#  define region 0
+#endif
+
+  DEBUGASSERT(handler);
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      for (node = heap->mm_heapstart[region];
+           node < heap->mm_heapend[region];
+           node = (FAR struct mm_allocnode_s *)((FAR char *)node + nodesize))
+        {
+          nodesize = MM_SIZEOF_NODE(node);
+          if (nodesize < MM_SIZEOF_ALLOCNODE ||
+              nodesize > (FAR char *)heap->mm_heapend[region] -
+                         (FAR char *)node)
+            {
+              break;
+            }
+
+          if (MM_NODE_IS_FREE(node) &&
+              nodesize > sizeof(struct mm_freenode_s))
+            {
+              handler((FAR char *)node + sizeof(struct mm_freenode_s),
+                      nodesize - sizeof(struct mm_freenode_s), arg);
+            }
+        }
+    }
+#undef region
+}
@@ -241,6 +241,7 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
     }
 
   DEBUGASSERT(mm_heapmember(heap, mem));
+  mm_sample_free(mem);
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   if (heap->mm_mpool)
@@ -252,5 +253,12 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
     }
 #endif
 
+#ifdef CONFIG_MM_HEAP_CACHE
+  if (mm_cache_free(heap, mem))
+    {
+      return;
+    }
+#endif
+
   mm_delayfree(heap, mem, CONFIG_MM_FREE_DELAYCOUNT_MAX > 0);
 }
@@ -29,6 +29,7 @@
 #include <string.h>
 #include <assert.h>
 #include <debug.h>
+#include <errno.h>
 
 #include <nuttx/sched_note.h>
 #include <nuttx/mm/mm.h>
@@ -211,6 +212,54 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
   mm_unlock(heap);
 }
 
+/****************************************************************************
+ * Name: mm_region_setflags
+ *
+ * Description:
+ *   Tag the heap region that contains "mem" with MM_REGION_* flags, which
+ *   mm_malloc_region() and mm_memalign_region() match against.
+ *
+ * Input Parameters:
+ *   heap  - The selected heap
+ *   mem   - Any address within the region, such as the start address
+ *           given to mm_addregion()
+ *   flags - The new tags of the region
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if "mem" is not in a region of the heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+int mm_region_setflags(FAR struct mm_heap_s *heap, FAR void *mem,
+                       unsigned int flags)
+{
+  uintptr_t addr = (uintptr_t)mem;
+  int ret = -ENOENT;
+  int region;
+
+  DEBUGVERIFY(mm_lock(heap));
+
+  for (region = 0; region < heap->mm_nregions; region++)
+    {
+      /* The region may start up to MM_ALIGN bytes after the address that
+       * was given to mm_addregion().
+       */
+
+      if (addr + MM_ALIGN > (uintptr_t)heap->mm_heapstart[region] &&
+          addr <= (uintptr_t)heap->mm_heapend[region])
+        {
+          heap->mm_regionflags[region] = flags;
+          ret = OK;
+          break;
+        }
+    }
+
+  mm_unlock(heap);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: mm_initialize
  *
@@ -28,6 +28,7 @@
 
 #include <assert.h>
 #include <debug.h>
+#include <errno.h>
 
 #include <nuttx/mm/mm.h>
 
@@ -131,6 +132,9 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   struct mallinfo poolinfo;
 #endif
+#ifdef CONFIG_MM_HEAP_CACHE
+  size_t cached;
+#endif
 
   memset(&info, 0, sizeof(info));
   mm_foreach(heap, mallinfo_handler, &info);
@@ -146,11 +150,74 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
   info.fordblks += poolinfo.fordblks;
 #endif
 
+#ifdef CONFIG_MM_HEAP_CACHE
+  /* The cached chunks look allocated to the heap, but they are free */
+
+  cached = mm_cache_size(heap);
+  info.uordblks -= cached;
+  info.fordblks += cached;
+#endif
+
   DEBUGASSERT(info.uordblks + info.fordblks == info.arena);
 
   return info;
 }
 
+/****************************************************************************
+ * Name: mm_mallinfo_region
+ *
+ * Description:
+ *   Return the usage of one region of the heap and its MM_REGION_* tags.
+ *   The chunks held by the memory pools or the caches are counted as
+ *   allocated.
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if "region" is not a region of the heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+int mm_mallinfo_region(FAR struct mm_heap_s *heap, int region,
+                       FAR struct mallinfo *info,
+                       FAR unsigned int *flags)
+{
+  FAR struct mm_allocnode_s *node;
+  size_t nodesize;
+
+  if (region < 0 || region >= heap->mm_nregions)
+    {
+      return -ENOENT;
+    }
+
+  memset(info, 0, sizeof(*info));
+
+  if (mm_lock(heap) < 0)
+    {
+      return -EINTR;
+    }
+
+  for (node = heap->mm_heapstart[region];
+       node < heap->mm_heapend[region];
+       node = (FAR struct mm_allocnode_s *)((FAR char *)node + nodesize))
+    {
+      nodesize = MM_SIZEOF_NODE(node);
+      mallinfo_handler(node, info);
+    }
+
+  /* The terminal node of the region is allocated */
+
+  mallinfo_handler(heap->mm_heapend[region], info);
+
+  info->arena = (uintptr_t)heap->mm_heapend[region] -
+                (uintptr_t)heap->mm_heapstart[region] +
+                MM_SIZEOF_ALLOCNODE;
+  *flags = heap->mm_regionflags[region];
+
+  mm_unlock(heap);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: mm_mallinfo_task
  *
@@ -190,7 +257,11 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
 
 size_t mm_heapfree(FAR struct mm_heap_s *heap)
 {
+#ifdef CONFIG_MM_HEAP_CACHE
+  return heap->mm_heapsize - heap->mm_curused + mm_cache_size(heap);
+#else
   return heap->mm_heapsize - heap->mm_curused;
+#endif
 }
 
 /****************************************************************************
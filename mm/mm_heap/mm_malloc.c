@@ -153,23 +153,32 @@ void mm_free_delaylist(FAR struct mm_heap_s *heap)
   if (heap)
     {
        free_delaylist(heap, true);
+#ifdef CONFIG_MM_HEAP_CACHE
+       mm_cache_flush(heap);
+#endif
     }
 }
 
 /****************************************************************************
- * Name: mm_malloc
+ * Name: mm_malloc_internal
  *
  * Description:
  *  Find the smallest chunk that satisfies the request. Take the memory from
- *  that chunk, save the remaining, smaller chunk (if any).
+ *  that chunk, save the remaining, smaller chunk (if any).  If "flags" is
+ *  not zero, prefer a chunk in a region tagged with these flags.
  *
  *  8-byte alignment of the allocated data is assured.
  *
  ****************************************************************************/
 
-FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+static FAR void *mm_malloc_internal(FAR struct mm_heap_s *heap, size_t size,
+                                    unsigned int flags)
 {
   FAR struct mm_freenode_s *node;
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+  FAR struct mm_freenode_s *fallback = NULL;
+  int nsearch = 0;
+#endif
   size_t alignsize;
   size_t nodesize;
   FAR void *ret = NULL;
@@ -179,12 +188,17 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   free_delaylist(heap, false);
 
+  /* The memory pools and the cache may hold memory of any region, they are
+   * skipped by the requests for tagged regions.
+   */
+
 #ifdef CONFIG_MM_HEAP_MEMPOOL
-  if (heap->mm_mpool)
+  if (heap->mm_mpool && flags == 0)
     {
       ret = mempool_multiple_alloc(heap->mm_mpool, size);
       if (ret != NULL)
         {
+          mm_sample_alloc(ret, size);
           return ret;
         }
     }
@@ -210,6 +224,17 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   DEBUGASSERT(alignsize >= MM_ALIGN);
 
+#ifdef CONFIG_MM_HEAP_CACHE
+  /* Try the cache of small free chunks of this CPU first */
+
+  ret = flags == 0 ? mm_cache_alloc(heap, alignsize) : NULL;
+  if (ret != NULL)
+    {
+      mm_sample_alloc(ret, size);
+      return ret;
+    }
+#endif
+
   /* We need to hold the MM mutex while we muck with the nodelist. */
 
   DEBUGVERIFY(mm_lock(heap));
@@ -229,10 +254,39 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       nodesize = MM_SIZEOF_NODE(node);
       if (nodesize >= alignsize)
         {
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+          /* Look a little further for a chunk in a preferred region, but
+           * settle for the best fit elsewhere.
+           */
+
+          if (flags != 0 && !mm_region_match(heap, node, flags))
+            {
+              if (fallback == NULL)
+                {
+                  fallback = node;
+                }
+
+              if (++nsearch < MM_REGION_SEARCH)
+                {
+                  continue;
+                }
+
+              node = NULL;
+            }
+#endif
+
           break;
         }
     }
 
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+  if (node == NULL && fallback != NULL)
+    {
+      node = fallback;
+      nodesize = MM_SIZEOF_NODE(node);
+    }
+#endif
+
   /* If we found a node with non-zero size, then this is one to use. Since
    * the list is ordered, we know that it must be the best fitting chunk
    * available.
@@ -340,6 +394,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 #ifdef CONFIG_DEBUG_MM
       minfo("Allocated %p, size %zu\n", ret, alignsize);
 #endif
+      mm_sample_alloc(ret, size);
     }
 
 #if CONFIG_MM_FREE_DELAYCOUNT_MAX > 0
@@ -347,7 +402,25 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   else if (free_delaylist(heap, true))
     {
-      return mm_malloc(heap, size);
+      return mm_malloc_internal(heap, size, flags);
+    }
+#endif
+
+#ifdef CONFIG_MM_HEAP_CACHE
+  /* Try again after returning the cached chunks to the heap */
+
+  else if (mm_cache_flush(heap))
+    {
+      return mm_malloc_internal(heap, size, flags);
+    }
+#endif
+
+#ifdef CONFIG_MM_SHRINKER
+  /* Try again after asking the other subsystems to give memory back */
+
+  else if (mm_shrink(size) > 0)
+    {
+      return mm_malloc_internal(heap, size, flags);
     }
 #endif
 
@@ -411,3 +484,41 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   DEBUGASSERT(ret == NULL || ((uintptr_t)ret) % MM_ALIGN == 0);
   return ret;
 }
+
+/****************************************************************************
+ * Name: mm_malloc
+ *
+ * Description:
+ *  Find the smallest chunk that satisfies the request. Take the memory from
+ *  that chunk, save the remaining, smaller chunk (if any).
+ *
+ *  8-byte alignment of the allocated data is assured.
+ *
+ ****************************************************************************/
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+  return mm_malloc_internal(heap, size, MM_REGION_POLICY(size));
+#else
+  return mm_malloc_internal(heap, size, 0);
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_malloc_region
+ *
+ * Description:
+ *  Like mm_malloc(), but prefer the heap regions tagged with all of the
+ *  MM_REGION_* "flags".  Any region is used if none of the tagged regions
+ *  can satisfy the request.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+FAR void *mm_malloc_region(FAR struct mm_heap_s *heap, size_t size,
+                           unsigned int flags)
+{
+  return mm_malloc_internal(heap, size, flags);
+}
+#endif
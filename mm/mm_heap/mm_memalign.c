@@ -36,24 +36,36 @@
 #include "mm_heap/mm.h"
 
 /****************************************************************************
- * Public Functions
+ * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+#  define mm_malloc_flags(h, s, f) mm_malloc_region(h, s, f)
+#else
+#  define mm_malloc_flags(h, s, f) mm_malloc(h, s)
+#endif
+
 /****************************************************************************
- * Name: mm_memalign
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_memalign_internal
  *
  * Description:
  *   memalign requests more than enough space from malloc, finds a region
  *   within that chunk that meets the alignment request and then frees any
- *   leading or trailing space.
+ *   leading or trailing space.  A non-zero "flags" selects the preferred
+ *   heap regions, as for mm_malloc_region().
  *
  *   The alignment argument must be a power of two. 16-byte alignment is
  *   guaranteed by normal malloc calls.
  *
  ****************************************************************************/
 
-FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
-                      size_t size)
+static FAR void *mm_memalign_internal(FAR struct mm_heap_s *heap,
+                                      size_t alignment, size_t size,
+                                      unsigned int flags)
 {
   FAR struct mm_allocnode_s *node;
   uintptr_t rawchunk;
@@ -77,11 +89,12 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
     }
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
-  if (heap->mm_mpool)
+  if (heap->mm_mpool && flags == 0)
     {
       node = mempool_multiple_memalign(heap->mm_mpool, alignment, size);
       if (node != NULL)
         {
+          mm_sample_alloc(node, size);
           return node;
         }
     }
@@ -93,7 +106,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   if (alignment <= MM_ALIGN)
     {
-      FAR void *ptr = mm_malloc(heap, size);
+      FAR void *ptr = mm_malloc_flags(heap, size, flags);
       DEBUGASSERT(ptr == NULL || ((uintptr_t)ptr) % alignment == 0);
       return ptr;
     }
@@ -133,7 +146,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   /* Then malloc that size */
 
-  rawchunk = (uintptr_t)mm_malloc(heap, allocsize);
+  rawchunk = (uintptr_t)mm_malloc_flags(heap, allocsize, flags);
   if (rawchunk == 0)
     {
       return NULL;
@@ -290,5 +303,47 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
   DEBUGASSERT(alignedchunk % alignment == 0);
   minfo("Aligned %"PRIxPTR" to %"PRIxPTR", size %zu\n",
         rawchunk, alignedchunk, size);
+  mm_sample_alloc((FAR void *)alignedchunk, size - MM_ALLOCNODE_OVERHEAD);
   return (FAR void *)alignedchunk;
 }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_memalign
+ *
+ * Description:
+ *   Allocate "size" bytes aligned to "alignment", which must be a power of
+ *   two. 16-byte alignment is guaranteed by normal malloc calls.
+ *
+ ****************************************************************************/
+
+FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
+                      size_t size)
+{
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+  return mm_memalign_internal(heap, alignment, size,
+                              MM_REGION_POLICY(size));
+#else
+  return mm_memalign_internal(heap, alignment, size, 0);
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_memalign_region
+ *
+ * Description:
+ *   Like mm_memalign(), but prefer the heap regions tagged with all of the
+ *   MM_REGION_* "flags".
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+FAR void *mm_memalign_region(FAR struct mm_heap_s *heap, size_t alignment,
+                             size_t size, unsigned int flags)
+{
+  return mm_memalign_internal(heap, alignment, size, flags);
+}
+#endif
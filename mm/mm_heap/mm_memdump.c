@@ -247,6 +247,14 @@ void mm_memdump(FAR struct mm_heap_s *heap,
   memset(&priv, 0, sizeof(struct mm_memdump_priv_s));
   priv.dump = dump;
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_PROFILE
+  if (pid == PID_MM_PROFILE)
+    {
+      mempool_multiple_profile(heap->mm_mpool);
+      return;
+    }
+#endif
+
   if (pid == PID_MM_MEMPOOL)
     {
       syslog(LOG_INFO, "Memdump mempool\n");
@@ -92,11 +92,16 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       newmem = mempool_multiple_realloc(heap->mm_mpool, oldmem, size);
       if (newmem != NULL)
         {
+          mm_sample_free(oldmem);
+          mm_sample_alloc(newmem, size);
           return newmem;
         }
-      else if (size <= heap->mm_threshold ||
-               mempool_multiple_alloc_size(heap->mm_mpool, oldmem) >= 0)
+      else if (mempool_multiple_alloc_size(heap->mm_mpool, oldmem) >= 0)
         {
+          /* The pool block is too small, move it to the heap.  A heap
+           * chunk that shrinks below the threshold stays in place.
+           */
+
           newmem = mm_malloc(heap, size);
           if (newmem != NULL)
             {
@@ -162,6 +167,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       mm_unlock(heap);
       MM_ADD_BACKTRACE(heap, oldnode);
 
+      mm_sample_free(oldmem);
+      mm_sample_alloc(oldmem, size);
       return oldmem;
     }
 
@@ -405,6 +412,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
           memcpy(newmem, oldmem, oldsize - MM_ALLOCNODE_OVERHEAD);
         }
 
+      mm_sample_free(oldmem);
+      mm_sample_alloc(newmem, newsize - MM_ALLOCNODE_OVERHEAD);
       return newmem;
     }
 
@@ -0,0 +1,388 @@
+/****************************************************************************
+ * mm/mm_heap/mm_sample.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#include <strings.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+#include "mm_heap/mm.h"
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The live samples are kept in an open addressed hash table that is never
+ * more than half full.
+ */
+
+#define MM_SAMPLE_NSLOTS     (2 * CONFIG_MM_HEAP_SAMPLE_NLIVE)
+#define MM_SAMPLE_HASH(mem) \
+  ((uint32_t)((uintptr_t)(mem) / sizeof(uintptr_t) * 2654435761u) % \
+   MM_SAMPLE_NSLOTS)
+
+/* ln(2) in Q16 */
+
+#define MM_SAMPLE_LN2        45426
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The sampling state of one CPU */
+
+struct mm_sample_cpu_s
+{
+  size_t   next;                /* Bytes left until the next sample */
+  uint32_t seed;                /* Random state, 0 until initialized */
+};
+
+/* One live sampled allocation */
+
+struct mm_sample_live_s
+{
+  FAR void *mem;                /* The allocation, NULL if the slot is free */
+  size_t    size;               /* The requested size */
+  uint16_t  site;               /* Index of the call site */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct mm_sample_cpu_s g_mm_sample_cpu[CONFIG_SMP_NCPUS];
+
+/* The call sites and the live samples.  The extra site collects the
+ * samples of the call sites that do not fit.
+ */
+
+static spinlock_t g_mm_sample_lock = SP_UNLOCKED;
+static struct mm_sample_site_s g_mm_sample_sites[CONFIG_MM_HEAP_SAMPLE_NSITES
+                                                 + 1];
+static int g_mm_sample_nsites;
+static struct mm_sample_live_s g_mm_sample_live[MM_SAMPLE_NSLOTS];
+static volatile size_t g_mm_sample_nlive;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_sample_log2
+ *
+ * Description:
+ *   Return log2(x) in Q16, with a quadratic approximation of the fraction
+ *   that is accurate to about 0.01.
+ *
+ ****************************************************************************/
+
+static uint32_t mm_sample_log2(uint32_t x)
+{
+  int n = fls(x) - 1;
+  uint32_t f;
+
+  f = n >= 16 ? x >> (n - 16) : x << (16 - n);
+  f &= 0xffff;
+
+  return ((uint32_t)n << 16) + f + (((f * (65536 - f)) >> 16) * 22713 >> 16);
+}
+
+/****************************************************************************
+ * Name: mm_sample_interval
+ *
+ * Description:
+ *   Draw the number of bytes until the next sample from an exponential
+ *   distribution whose mean is CONFIG_MM_HEAP_SAMPLE_INTERVAL, so that
+ *   every allocated byte has the same chance of being sampled.
+ *
+ ****************************************************************************/
+
+static size_t mm_sample_interval(FAR struct mm_sample_cpu_s *cpu)
+{
+  uint32_t x = cpu->seed;
+  uint32_t q;
+
+  /* xorshift32, then a uniform q in (0, 2^26] and -ln(q / 2^26) */
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  cpu->seed = x;
+
+  q = (x >> 6) + 1;
+  return ((uint64_t)CONFIG_MM_HEAP_SAMPLE_INTERVAL *
+          ((26 << 16) - mm_sample_log2(q)) * MM_SAMPLE_LN2) >> 32;
+}
+
+/****************************************************************************
+ * Name: mm_sample_findsite
+ *
+ * Description:
+ *   Return the index of the call site with this backtrace, adding it if it
+ *   is new.  Called with g_mm_sample_lock held.
+ *
+ ****************************************************************************/
+
+static int mm_sample_findsite(FAR void * const *backtrace)
+{
+  int i;
+
+  for (i = 0; i < g_mm_sample_nsites; i++)
+    {
+      if (memcmp(g_mm_sample_sites[i].backtrace, backtrace,
+                 sizeof(g_mm_sample_sites[i].backtrace)) == 0)
+        {
+          return i;
+        }
+    }
+
+  if (g_mm_sample_nsites < CONFIG_MM_HEAP_SAMPLE_NSITES)
+    {
+      memcpy(g_mm_sample_sites[i].backtrace, backtrace,
+             sizeof(g_mm_sample_sites[i].backtrace));
+      return g_mm_sample_nsites++;
+    }
+
+  /* The table is full, use the site without a backtrace */
+
+  g_mm_sample_nsites = CONFIG_MM_HEAP_SAMPLE_NSITES + 1;
+  return CONFIG_MM_HEAP_SAMPLE_NSITES;
+}
+
+/****************************************************************************
+ * Name: mm_sample_record
+ *
+ * Description:
+ *   Record a sampled allocation.
+ *
+ ****************************************************************************/
+
+static void mm_sample_record(FAR void *mem, size_t size)
+{
+  FAR void *backtrace[CONFIG_MM_HEAP_SAMPLE_DEPTH];
+  FAR struct mm_sample_site_s *site;
+  irqstate_t flags;
+  uint32_t i;
+  int n;
+
+  memset(backtrace, 0, sizeof(backtrace));
+  n = sched_backtrace(_SCHED_GETTID(), backtrace,
+                      CONFIG_MM_HEAP_SAMPLE_DEPTH,
+                      CONFIG_MM_HEAP_SAMPLE_SKIP);
+  UNUSED(n);
+
+  flags = spin_lock_irqsave(&g_mm_sample_lock);
+
+  if (g_mm_sample_nlive < CONFIG_MM_HEAP_SAMPLE_NLIVE)
+    {
+      for (i = MM_SAMPLE_HASH(mem); g_mm_sample_live[i].mem != NULL;
+           i = (i + 1) % MM_SAMPLE_NSLOTS);
+
+      g_mm_sample_live[i].mem  = mem;
+      g_mm_sample_live[i].size = size;
+      g_mm_sample_live[i].site = mm_sample_findsite(backtrace);
+      g_mm_sample_nlive++;
+
+      site = &g_mm_sample_sites[g_mm_sample_live[i].site];
+      site->inuse_count++;
+      site->inuse_bytes += size;
+      site->alloc_count++;
+      site->alloc_bytes += size;
+    }
+
+  spin_unlock_irqrestore(&g_mm_sample_lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_sample_remove
+ *
+ * Description:
+ *   Remove the live sample in slot "i", moving the entries that follow it
+ *   back so that every entry stays reachable from its hash slot.  Called
+ *   with g_mm_sample_lock held.
+ *
+ ****************************************************************************/
+
+static void mm_sample_remove(uint32_t i)
+{
+  uint32_t j = i;
+  uint32_t k;
+
+  for (; ; )
+    {
+      j = (j + 1) % MM_SAMPLE_NSLOTS;
+      if (g_mm_sample_live[j].mem == NULL)
+        {
+          break;
+        }
+
+      /* The entry in "j" may move to "i" unless its hash slot lies
+       * cyclically in (i, j].
+       */
+
+      k = MM_SAMPLE_HASH(g_mm_sample_live[j].mem);
+      if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+        {
+          continue;
+        }
+
+      g_mm_sample_live[i] = g_mm_sample_live[j];
+      i = j;
+    }
+
+  g_mm_sample_live[i].mem = NULL;
+  g_mm_sample_nlive--;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_sample_alloc
+ *
+ * Description:
+ *   Account an allocation of "size" bytes and record its backtrace if the
+ *   sampling interval of this CPU has elapsed.
+ *
+ ****************************************************************************/
+
+void mm_sample_alloc(FAR void *mem, size_t size)
+{
+  FAR struct mm_sample_cpu_s *cpu;
+  irqstate_t flags;
+
+  if (mem == NULL)
+    {
+      return;
+    }
+
+  flags = up_irq_save();
+  cpu = &g_mm_sample_cpu[this_cpu()];
+
+  if (cpu->seed == 0)
+    {
+      cpu->seed = 2463534242u + this_cpu();
+      cpu->next = mm_sample_interval(cpu);
+    }
+
+  if (cpu->next > size)
+    {
+      cpu->next -= size;
+      up_irq_restore(flags);
+      return;
+    }
+
+  cpu->next = mm_sample_interval(cpu);
+  up_irq_restore(flags);
+
+  mm_sample_record(mem, size);
+}
+
+/****************************************************************************
+ * Name: mm_sample_free
+ *
+ * Description:
+ *   Drop the live sample of "mem", if it was sampled.
+ *
+ ****************************************************************************/
+
+void mm_sample_free(FAR void *mem)
+{
+  FAR struct mm_sample_site_s *site;
+  irqstate_t flags;
+  uint32_t i;
+
+  /* A sampled allocation was recorded before it was handed out, so it is
+   * counted here by the time it is freed.
+   */
+
+  if (g_mm_sample_nlive == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_mm_sample_lock);
+
+  for (i = MM_SAMPLE_HASH(mem); g_mm_sample_live[i].mem != NULL;
+       i = (i + 1) % MM_SAMPLE_NSLOTS)
+    {
+      if (g_mm_sample_live[i].mem == mem)
+        {
+          site = &g_mm_sample_sites[g_mm_sample_live[i].site];
+          site->inuse_count--;
+          site->inuse_bytes -= g_mm_sample_live[i].size;
+          mm_sample_remove(i);
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_mm_sample_lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_sample_site
+ *
+ * Description:
+ *   Return a copy of the statistics of one sampled call site.
+ *
+ * Input Parameters:
+ *   index - The index of the call site, starting from 0
+ *   site  - The location to return the statistics
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no call site with this index.
+ *
+ ****************************************************************************/
+
+int mm_sample_site(int index, FAR struct mm_sample_site_s *site)
+{
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  flags = spin_lock_irqsave(&g_mm_sample_lock);
+
+  if (index >= 0 && index < g_mm_sample_nsites)
+    {
+      *site = g_mm_sample_sites[index];
+      ret = OK;
+    }
+
+  spin_unlock_irqrestore(&g_mm_sample_lock, flags);
+  return ret;
+}
+
+#endif /* CONFIG_BUILD_FLAT || __KERNEL__ */
@@ -0,0 +1,158 @@
+/****************************************************************************
+ * mm/mm_shrink/mm_shrink.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The registered shrinkers and the lock that protects the list.  The lock
+ * is also held while the shrinkers run, so that a shrinker that ends up
+ * allocating memory does not recurse into mm_shrink().
+ */
+
+static mutex_t g_shrink_lock = NXMUTEX_INITIALIZER;
+static sq_queue_t g_shrinkers;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_register_shrinker
+ *
+ * Description:
+ *   Register a shrinker that the heaps call when an allocation fails.
+ *
+ * Input Parameters:
+ *   shrinker - The shrinker, with "shrink" set by the caller
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mm_register_shrinker(FAR struct mm_shrinker_s *shrinker)
+{
+  int ret;
+
+  DEBUGASSERT(shrinker != NULL && shrinker->shrink != NULL);
+
+  ret = nxmutex_lock(&g_shrink_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  sq_addlast(&shrinker->node, &g_shrinkers);
+  nxmutex_unlock(&g_shrink_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mm_unregister_shrinker
+ *
+ * Description:
+ *   Remove a shrinker registered with mm_register_shrinker().  It is not
+ *   called again once this function returns.
+ *
+ * Input Parameters:
+ *   shrinker - The shrinker to remove
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mm_unregister_shrinker(FAR struct mm_shrinker_s *shrinker)
+{
+  int ret;
+
+  DEBUGASSERT(shrinker != NULL);
+
+  ret = nxmutex_lock(&g_shrink_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  sq_rem(&shrinker->node, &g_shrinkers);
+  nxmutex_unlock(&g_shrink_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mm_shrink
+ *
+ * Description:
+ *   Ask the registered shrinkers, in the order they were registered, to
+ *   free memory until "size" bytes have been freed or every shrinker has
+ *   been called.  Nothing is done from interrupt handlers, or while
+ *   another thread is already shrinking.
+ *
+ * Input Parameters:
+ *   size - The number of bytes wanted
+ *
+ * Returned Value:
+ *   The number of bytes freed.
+ *
+ ****************************************************************************/
+
+size_t mm_shrink(size_t size)
+{
+  FAR sq_entry_t *entry;
+  size_t freed = 0;
+
+  if (up_interrupt_context() || nxmutex_trylock(&g_shrink_lock) < 0)
+    {
+      return 0;
+    }
+
+  sq_for_every(&g_shrinkers, entry)
+    {
+      FAR struct mm_shrinker_s *shrinker =
+        container_of(entry, struct mm_shrinker_s, node);
+
+      freed += shrinker->shrink(shrinker, size - freed);
+      if (freed >= size)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_shrink_lock);
+  return freed;
+}
@@ -131,6 +131,12 @@ struct mm_mallinfo_handler_s
   FAR struct mallinfo_task *info;
 };
 
+struct mm_foreach_free_s
+{
+  CODE void (*handler)(FAR void *start, size_t size, FAR void *arg);
+  FAR void *arg;
+};
+
 #if CONFIG_MM_HEAP_BIGGEST_COUNT > 0
 struct mm_tlsf_node_s
 {
@@ -444,6 +450,27 @@ static FAR void *mempool_memalign(FAR void *arg, size_t alignment,
 #  define mempool_memalign mm_memalign
 #endif
 
+/****************************************************************************
+ * Name: foreach_free_handler
+ *
+ * Description:
+ *   Forward the payload of a free block, minus the free list links at the
+ *   start and the physical link of the next block at the end.
+ *
+ ****************************************************************************/
+
+static void foreach_free_handler(FAR void *ptr, size_t size, int used,
+                                 FAR void *user)
+{
+  FAR struct mm_foreach_free_s *priv = user;
+
+  if (!used && size > 3 * sizeof(FAR void *))
+    {
+      priv->handler((FAR char *)ptr + 2 * sizeof(FAR void *),
+                    size - 3 * sizeof(FAR void *), priv->arg);
+    }
+}
+
 /****************************************************************************
  * Name: mallinfo_handler
  ****************************************************************************/
@@ -1201,6 +1228,41 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
   return info;
 }
 
+/****************************************************************************
+ * Name: mm_foreach_free
+ *
+ * Description:
+ *   Report the payload of each free block in the heap.  The heap is walked
+ *   without the lock, so this may only be used when the heap cannot
+ *   change, e.g. while writing a core dump.
+ *
+ ****************************************************************************/
+
+void mm_foreach_free(FAR struct mm_heap_s *heap,
+                     CODE void (*handler)(FAR void *start, size_t size,
+                                          FAR void *arg),
+                     FAR void *arg)
+{
+  struct mm_foreach_free_s priv;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+#  define region 0
+#endif
+
+  priv.handler = handler;
+  priv.arg     = arg;
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      tlsf_walk_pool(heap->mm_heapstart[region],
+                     foreach_free_handler, &priv);
+    }
+#undef region
+}
+
 /****************************************************************************
  * Name: mm_memdump
  *
@@ -1226,6 +1288,14 @@ void mm_memdump(FAR struct mm_heap_s *heap,
   memset(&priv, 0, sizeof(struct mm_memdump_priv_s));
   priv.dump = dump;
 
+#ifdef CONFIG_MM_HEAP_MEMPOOL_PROFILE
+  if (pid == PID_MM_PROFILE)
+    {
+      mempool_multiple_profile(heap->mm_mpool);
+      return;
+    }
+#endif
+
   if (pid == PID_MM_MEMPOOL)
     {
       syslog(LOG_INFO, "Memdump mempool\n");
@@ -1419,6 +1489,15 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+#ifdef CONFIG_MM_SHRINKER
+  /* Try again after asking the other subsystems to give memory back */
+
+  else if (mm_shrink(size) > 0)
+    {
+      return mm_malloc(heap, size);
+    }
+#endif
+
   return ret;
 }
 
@@ -1500,6 +1579,15 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
     }
 #endif
 
+#ifdef CONFIG_MM_SHRINKER
+  /* Try again after asking the other subsystems to give memory back */
+
+  else if (mm_shrink(size) > 0)
+    {
+      return mm_memalign(heap, alignment, size);
+    }
+#endif
+
   return ret;
 }
 
@@ -1559,16 +1647,21 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
         {
           return newmem;
         }
-      else if (size <= heap->mm_threshold ||
-               mempool_multiple_alloc_size(heap->mm_mpool, oldmem) >= 0)
+      else if (mempool_multiple_alloc_size(heap->mm_mpool, oldmem) >= 0)
         {
+          /* The pool block is too small, move it to the heap.  A heap
+           * block that shrinks below the threshold stays in place.
+           */
+
           newmem = mm_malloc(heap, size);
           if (newmem != 0)
             {
-              memcpy(newmem, oldmem, size);
+              memcpy(newmem, oldmem,
+                     MIN(size, mm_malloc_size(heap, oldmem)));
               mm_free(heap, oldmem);
-              return newmem;
             }
+
+          return newmem;
         }
     }
 #endif
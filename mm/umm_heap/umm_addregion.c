@@ -55,3 +55,25 @@ void umm_addregion(FAR void *heap_start, size_t heap_size)
 {
   mm_addregion(USR_HEAP, heap_start, heap_size);
 }
+
+/****************************************************************************
+ * Name: umm_region_setflags
+ *
+ * Description:
+ *   Tag the user heap region that contains "mem" with MM_REGION_* flags.
+ *
+ * Input Parameters:
+ *   mem   - Any address within the region
+ *   flags - The new tags of the region
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if "mem" is not in a region of the heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+int umm_region_setflags(FAR void *mem, unsigned int flags)
+{
+  return mm_region_setflags(USR_HEAP, mem, flags);
+}
+#endif
@@ -77,3 +77,34 @@ FAR void *malloc(size_t size)
   return ret;
 #endif
 }
+
+/****************************************************************************
+ * Name: malloc_region
+ *
+ * Description:
+ *   Allocate memory from the user heap, preferring the regions tagged with
+ *   all of the MALLOC_REGION_* "flags".
+ *
+ * Input Parameters:
+ *   size  - Size (in bytes) of the memory region to be allocated.
+ *   flags - The preferred region tags
+ *
+ * Returned Value:
+ *   The address of the allocated memory (NULL on failure to allocate)
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+FAR void *malloc_region(size_t size, unsigned int flags)
+{
+  FAR void *ret;
+
+  ret = mm_malloc_region(USR_HEAP, size, flags);
+  if (ret == NULL)
+    {
+      set_errno(ENOMEM);
+    }
+
+  return ret;
+}
+#endif
@@ -104,3 +104,27 @@ FAR void *memalign(size_t alignment, size_t size)
   return ret;
 #endif
 }
+
+/****************************************************************************
+ * Name: memalign_region
+ *
+ * Description:
+ *   Allocate aligned memory from the user heap, preferring the regions
+ *   tagged with all of the MALLOC_REGION_* "flags".
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_REGION_FLAGS
+FAR void *memalign_region(size_t alignment, size_t size, unsigned int flags)
+{
+  FAR void *ret;
+
+  ret = mm_memalign_region(USR_HEAP, alignment, size, flags);
+  if (ret == NULL)
+    {
+      set_errno(ENOMEM);
+    }
+
+  return ret;
+}
+#endif
@@ -46,6 +46,7 @@
 #include <netinet/in.h>
 
 #include <nuttx/net/netdev.h>
+#include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 
 #include "devif/devif.h"
@@ -166,6 +167,10 @@ struct arp_entry_s
   clock_t                  at_time;     /* Time of last usage */
   uint8_t                  at_flags;    /* Flags, examples: ATF_PERM */
   FAR struct net_driver_s *at_dev;      /* The device driver structure */
+#if CONFIG_NET_ARPTAB_HASH > 0
+  sq_entry_t               at_hash;     /* Hash bucket or free list link */
+  dq_entry_t               at_lru;      /* Least recently updated order */
+#endif
 #ifdef CONFIG_NET_ARP_SEND_QUEUE
   struct iob_queue_s       at_queue;    /* Queue iobs to wait arp complete */
   struct work_s            at_work;     /* Arp response timeout handle */
@@ -56,6 +56,7 @@
 #include <net/ethernet.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -93,6 +94,18 @@ struct arp_table_info_s
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 
+#if CONFIG_NET_ARPTAB_HASH > 0
+/* The entries in use hashed by IP address and in least recently updated
+ * order, and the entries that were deleted.  g_arpnused counts the entries
+ * that were ever used, the others are free as well.
+ */
+
+static sq_queue_t g_arphash[CONFIG_NET_ARPTAB_HASH];
+static dq_queue_t g_arplru;
+static sq_queue_t g_arpfree;
+static unsigned int g_arpnused;
+#endif
+
 static const struct ether_addr g_zero_ethaddr =
 {
   {
@@ -150,6 +163,104 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
   return 1;
 }
 
+/****************************************************************************
+ * Name: arp_bucket
+ *
+ * Description:
+ *   Return the hash bucket of an IP address.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_ARPTAB_HASH > 0
+static inline FAR sq_queue_t *arp_bucket(in_addr_t ipaddr)
+{
+  uint32_t hash = ipaddr ^ (ipaddr >> 16);
+
+  return &g_arphash[(hash ^ (hash >> 8)) % CONFIG_NET_ARPTAB_HASH];
+}
+
+/****************************************************************************
+ * Name: arp_hash_find
+ *
+ * Description:
+ *   Find the entry of an IP address and device among the entries in use.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_hash_find(in_addr_t ipaddr,
+                                             FAR struct net_driver_s *dev)
+{
+  FAR struct arp_entry_s *tabptr;
+  FAR sq_entry_t *entry;
+
+  sq_for_every(arp_bucket(ipaddr), entry)
+    {
+      tabptr = container_of(entry, struct arp_entry_s, at_hash);
+      if (tabptr->at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: arp_hash_victim
+ *
+ * Description:
+ *   Return the entry to hold a new mapping: a free entry if there is one,
+ *   otherwise the least recently updated one, preferring entries that are
+ *   not permanent.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_hash_victim(void)
+{
+  FAR struct arp_entry_s *tabptr;
+  FAR dq_entry_t *entry;
+
+  if (!sq_empty(&g_arpfree))
+    {
+      tabptr = container_of(sq_remfirst(&g_arpfree), struct arp_entry_s,
+                            at_hash);
+      tabptr->at_flags = 0;
+      return tabptr;
+    }
+
+  if (g_arpnused < CONFIG_NET_ARPTAB_SIZE)
+    {
+      return &g_arptable[g_arpnused++];
+    }
+
+  for (entry = dq_tail(&g_arplru); entry != NULL; entry = dq_prev(entry))
+    {
+      tabptr = container_of(entry, struct arp_entry_s, at_lru);
+      if ((tabptr->at_flags & ATF_PERM) == 0)
+        {
+          return tabptr;
+        }
+    }
+
+  return container_of(dq_tail(&g_arplru), struct arp_entry_s, at_lru);
+}
+
+/****************************************************************************
+ * Name: arp_hash_unlink
+ *
+ * Description:
+ *   Remove an entry in use from its hash bucket and from the LRU list.
+ *
+ ****************************************************************************/
+
+static void arp_hash_unlink(FAR struct arp_entry_s *tabptr)
+{
+  sq_rem(&tabptr->at_hash, arp_bucket(tabptr->at_ipaddr));
+  dq_rem(&tabptr->at_lru, &g_arplru);
+}
+#endif
+
 /****************************************************************************
  * Name: arp_return_old_entry
  *
@@ -158,6 +269,7 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
  *
  ****************************************************************************/
 
+#if CONFIG_NET_ARPTAB_HASH == 0
 static FAR struct arp_entry_s *
 arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
 {
@@ -182,6 +294,7 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
       return e2;
     }
 }
+#endif
 
 /****************************************************************************
  * Name: arp_lookup
@@ -203,27 +316,33 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
   FAR struct arp_entry_s *tabptr;
+#if CONFIG_NET_ARPTAB_HASH == 0
   int i;
+#endif
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+#if CONFIG_NET_ARPTAB_HASH > 0
+  tabptr = arp_hash_find(ipaddr, dev);
+#else
+  for (i = 0, tabptr = NULL; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+      if (g_arptable[i].at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
         {
-          if ((tabptr->at_flags & ATF_PERM) != 0 ||
-              clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
-            {
-              return tabptr;
-            }
-
-          return NULL;  /* Expired */
+          tabptr = &g_arptable[i];
+          break;
         }
     }
+#endif
 
-  /* Not found */
+  if (tabptr != NULL && ((tabptr->at_flags & ATF_PERM) != 0 ||
+      clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK))
+    {
+      return tabptr;
+    }
+
+  /* Not found or expired */
 
   return NULL;
 }
@@ -303,8 +422,27 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
 #if defined(CONFIG_NETLINK_ROUTE) || defined(CONFIG_NET_ARP_SEND_QUEUE)
   bool found = false;
 #endif
+#if CONFIG_NET_ARPTAB_HASH == 0
   int i;
+#endif
+
+#if CONFIG_NET_ARPTAB_HASH > 0
+  /* Look up the mapping in its hash bucket, or take the least recently
+   * updated entry if it is not in the ARP table yet.
+   */
 
+  tabptr = arp_hash_find(ipaddr, dev);
+  if (tabptr == NULL)
+    {
+      tabptr = arp_hash_victim();
+    }
+#if defined(CONFIG_NETLINK_ROUTE) || defined(CONFIG_NET_ARP_SEND_QUEUE)
+  else
+    {
+      found = true;
+    }
+#endif
+#else
   /* Walk through the ARP mapping table and try to find an entry to
    * update. If none is found, the IP -> MAC address mapping is
    * inserted in the ARP table.
@@ -335,6 +473,7 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
           tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
         }
     }
+#endif
 
   if ((tabptr->at_flags & ATF_PERM) != 0 && (flags & ATF_PERM) == 0)
     {
@@ -380,12 +519,24 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
    * information.
    */
 
+#if CONFIG_NET_ARPTAB_HASH > 0
+  if (tabptr->at_ipaddr != 0)
+    {
+      arp_hash_unlink(tabptr);
+    }
+#endif
+
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_ipaddr = ipaddr;
   tabptr->at_time   = clock_systime_ticks();
   tabptr->at_flags  = flags;
   tabptr->at_dev    = dev;
 
+#if CONFIG_NET_ARPTAB_HASH > 0
+  sq_addfirst(&tabptr->at_hash, arp_bucket(ipaddr));
+  dq_addfirst(&tabptr->at_lru, &g_arplru);
+#endif
+
   /* Notify the new entry */
 
 #ifdef CONFIG_NETLINK_ROUTE
@@ -575,6 +726,11 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 
       /* Yes.. Set the IP address to zero to "delete" it */
 
+#if CONFIG_NET_ARPTAB_HASH > 0
+      arp_hash_unlink(tabptr);
+      sq_addlast(&tabptr->at_hash, &g_arpfree);
+#endif
+
       tabptr->at_ipaddr = 0;
       return OK;
     }
@@ -609,7 +765,20 @@ void arp_cleanup(FAR struct net_driver_s *dev)
           iob_free_queue(&g_arptable[i].at_queue);
 #endif
 
+#if CONFIG_NET_ARPTAB_HASH > 0
+          /* Deleted entries are already on the free list */
+
+          if (g_arptable[i].at_ipaddr == 0)
+            {
+              continue;
+            }
+
+          arp_hash_unlink(&g_arptable[i]);
+          memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+          sq_addlast(&g_arptable[i].at_hash, &g_arpfree);
+#else
           memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+#endif
         }
     }
 }
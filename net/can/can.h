@@ -61,6 +61,23 @@
 #  define CONFIG_NET_CAN_NBUFFERS 0
 #endif
 
+/* Bitmaps of the standard identifiers accepted by exact-match filters, one
+ * for filters that ignore the frame format and one for filters that only
+ * accept standard frames.
+ */
+
+#ifdef CONFIG_NET_CAN_RAW_FILTER_IDMAP
+#  define CAN_IDMAP_ANY     0
+#  define CAN_IDMAP_SFF     1
+#  define CAN_IDMAP_NMAPS   2
+#  define CAN_IDMAP_BYTES   ((CAN_SFF_MASK + 1) / 8)
+
+#  define CAN_IDMAP_SET(map,id) \
+  ((map)[((id) & CAN_SFF_MASK) >> 3] |= 1 << ((id) & 7))
+#  define CAN_IDMAP_TEST(map,id) \
+  (((map)[((id) & CAN_SFF_MASK) >> 3] & (1 << ((id) & 7))) != 0)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -129,6 +146,11 @@ struct can_conn_s
 #ifdef CONFIG_NET_CANPROTO_OPTIONS
   struct can_filter filters[CONFIG_NET_CAN_RAW_FILTER_MAX];
   int32_t filter_count;
+#  ifdef CONFIG_NET_CAN_RAW_FILTER_IDMAP
+  uint8_t idmap[CAN_IDMAP_NMAPS][CAN_IDMAP_BYTES];
+  uint16_t filter_lin[CONFIG_NET_CAN_RAW_FILTER_MAX]; /* Not in idmap */
+  uint16_t filter_nlin;
+#  endif
 #  ifdef CONFIG_NET_CAN_ERRORS
   can_err_mask_t err_mask;
 #  endif
@@ -223,6 +245,25 @@ void can_conn_list_unlock(void);
 FAR struct can_conn_s *can_active(FAR struct net_driver_s *dev,
                                   FAR struct can_conn_s *conn);
 
+/****************************************************************************
+ * Name: can_filter_update()
+ *
+ * Description:
+ *   Rebuild the identifier bitmaps of a connection after its CAN_RAW
+ *   filters have changed.  Filters that match one standard identifier
+ *   exactly go into the bitmaps, all others are left for the linear scan.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection whose filters were changed
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN_RAW_FILTER_IDMAP
+void can_filter_update(FAR struct can_conn_s *conn);
+#else
+#  define can_filter_update(conn)
+#endif
+
 /****************************************************************************
  * Name: can_callback
  *
@@ -289,6 +330,31 @@ int can_datahandler(FAR struct net_driver_s *dev,
 ssize_t can_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags);
 
+/****************************************************************************
+ * Name: can_recvmmsg
+ *
+ * Description:
+ *   Receive a batch of CAN frames.  Each round waits for one frame as
+ *   can_recvmsg() does and then takes every frame already queued in the
+ *   read-ahead buffer under a single lock.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   The vector of buffers to receive the frames
+ *   vlen     The number of entries in msgvec
+ *   flags    Receive flags, see psock_recvmmsg()
+ *   timeout  Optional time limit of the batch
+ *
+ * Returned Value:
+ *   The number of frames received or, if the first one failed, a negated
+ *   errno value.
+ *
+ ****************************************************************************/
+
+int can_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                 unsigned int vlen, int flags,
+                 FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: can_poll
  *
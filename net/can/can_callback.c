@@ -133,12 +133,19 @@ uint32_t can_callback(FAR struct net_driver_s *dev,
           if (_SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMP) &&
             (dev->d_iob != NULL))
             {
+              struct timespec ts;
               struct timeval tv;
-              FAR struct timespec *ts = (FAR struct timespec *)&tv;
               int len;
 
-              clock_systime_timespec(ts);
-              tv.tv_usec = ts->tv_nsec / 1000;
+#ifdef CONFIG_ARCH_HAVE_NETDEV_TIMESTAMP
+              /* Use the reception time the driver took from the hardware */
+
+              ts = dev->d_rxtime;
+#else
+              clock_systime_timespec(&ts);
+#endif
+              tv.tv_sec  = ts.tv_sec;
+              tv.tv_usec = ts.tv_nsec / 1000;
 
               len = iob_trycopyin(dev->d_iob, (FAR uint8_t *)&tv,
                                   sizeof(struct timeval),
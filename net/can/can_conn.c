@@ -107,6 +107,7 @@ FAR struct can_conn_s *can_alloc(void)
        */
 
       conn->filter_count = 1;
+      can_filter_update(conn);
 #endif
 
       /* Enqueue the connection into the active list */
@@ -168,6 +169,33 @@ void can_free(FAR struct can_conn_s *conn)
   NET_BUFPOOL_UNLOCK(g_can_connections);
 }
 
+/****************************************************************************
+ * Name: can_filter_match
+ *
+ * Description:
+ *   Check an identifier against one CAN_RAW filter
+ *
+ * Input Parameters:
+ *   filter - The filter to check against
+ *   id     - The CAN identifier
+ *
+ * Returned Value: 0 - Filter not passed, 1 - Filter passed
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+static inline int can_filter_match(FAR const struct can_filter *filter,
+                                   canid_t id)
+{
+  if (filter->can_id & CAN_INV_FILTER)
+    {
+      return (id & filter->can_mask) !=
+             ((filter->can_id & ~CAN_INV_FILTER) & filter->can_mask);
+    }
+
+  return (id & filter->can_mask) == (filter->can_id & filter->can_mask);
+}
+
 /****************************************************************************
  * Name: can_recv_filter
  *
@@ -182,7 +210,6 @@ void can_free(FAR struct can_conn_s *conn)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_CANPROTO_OPTIONS
 static int can_recv_filter(FAR struct can_conn_s *conn, canid_t id)
 {
   uint32_t i;
@@ -196,26 +223,32 @@ static int can_recv_filter(FAR struct can_conn_s *conn, canid_t id)
     }
 #endif
 
-  for (i = 0; i < conn->filter_count; i++)
+#ifdef CONFIG_NET_CAN_RAW_FILTER_IDMAP
+  /* Exact standard identifier filters take one bitmap lookup */
+
+  if (CAN_IDMAP_TEST(conn->idmap[CAN_IDMAP_ANY], id) ||
+      ((id & CAN_EFF_FLAG) == 0 &&
+       CAN_IDMAP_TEST(conn->idmap[CAN_IDMAP_SFF], id)))
     {
-      if (conn->filters[i].can_id & CAN_INV_FILTER)
+      return 1;
+    }
+
+  for (i = 0; i < conn->filter_nlin; i++)
+    {
+      if (can_filter_match(&conn->filters[conn->filter_lin[i]], id))
         {
-          if ((id & conn->filters[i].can_mask) !=
-                ((conn->filters[i].can_id & ~CAN_INV_FILTER) &
-                 conn->filters[i].can_mask))
-            {
-              return 1;
-            }
+          return 1;
         }
-      else
+    }
+#else
+  for (i = 0; i < conn->filter_count; i++)
+    {
+      if (can_filter_match(&conn->filters[i], id))
         {
-          if ((id & conn->filters[i].can_mask) ==
-                (conn->filters[i].can_id & conn->filters[i].can_mask))
-            {
-              return 1;
-            }
+          return 1;
         }
     }
+#endif
 
   return 0;
 }
@@ -311,4 +344,65 @@ FAR struct can_conn_s *can_active(FAR struct net_driver_s *dev,
   return conn;
 }
 
+/****************************************************************************
+ * Name: can_filter_update()
+ *
+ * Description:
+ *   Rebuild the identifier bitmaps of a connection after its CAN_RAW
+ *   filters have changed.  Filters that match one standard identifier
+ *   exactly go into the bitmaps, all others are left for the linear scan.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection whose filters were changed
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN_RAW_FILTER_IDMAP
+void can_filter_update(FAR struct can_conn_s *conn)
+{
+  FAR const struct can_filter *filter;
+  int map;
+  int i;
+
+  memset(conn->idmap, 0, sizeof(conn->idmap));
+  conn->filter_nlin = 0;
+
+  for (i = 0; i < conn->filter_count; i++)
+    {
+      filter = &conn->filters[i];
+
+      if ((filter->can_id & CAN_INV_FILTER) != 0)
+        {
+          map = -1;
+        }
+      else if (filter->can_mask == CAN_SFF_MASK)
+        {
+          /* Low 11 bits must match, the frame format does not matter */
+
+          map = CAN_IDMAP_ANY;
+        }
+      else if (filter->can_mask == (CAN_SFF_MASK | CAN_EFF_FLAG) &&
+               (filter->can_id & CAN_EFF_FLAG) == 0)
+        {
+          /* One identifier, standard frames only */
+
+          map = CAN_IDMAP_SFF;
+        }
+      else
+        {
+          map = -1;
+        }
+
+      if (map < 0)
+        {
+          conn->filter_lin[conn->filter_nlin++] = i;
+        }
+      else
+        {
+          CAN_IDMAP_SET(conn->idmap[map], filter->can_id);
+        }
+    }
+}
+#endif
+
 #endif /* CONFIG_NET_CAN */
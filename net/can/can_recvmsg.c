@@ -38,6 +38,7 @@
 
 #include <arch/irq.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -211,6 +212,46 @@ static inline void can_newdata(FAR struct net_driver_s *dev,
   dev->d_len = 0;
 }
 
+/****************************************************************************
+ * Name: can_recvfrom_init
+ *
+ * Description:
+ *   Initialize the state structure for receiving into one message
+ *
+ * Input Parameters:
+ *   pstate   recvfrom state structure
+ *   conn     The CAN connection to receive from
+ *   msg      The message to receive into
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void can_recvfrom_init(FAR struct can_recvfrom_s *pstate,
+                              FAR struct can_conn_s *conn,
+                              FAR struct msghdr *msg)
+{
+  memset(pstate, 0, sizeof(struct can_recvfrom_s));
+
+  pstate->pr_buflen = msg->msg_iov->iov_len;
+  pstate->pr_buffer = msg->msg_iov->iov_base;
+
+#ifdef CONFIG_NET_TIMESTAMP
+  if (_SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMP))
+    {
+      pstate->pr_msgbuf = cmsg_append(msg, SOL_SOCKET, SO_TIMESTAMP,
+                                      NULL, sizeof(struct timeval));
+      if (pstate->pr_msgbuf != NULL)
+        {
+          pstate->pr_msglen = sizeof(struct timeval);
+        }
+    }
+#endif
+
+  pstate->pr_conn = conn;
+}
+
 /****************************************************************************
  * Name: can_readahead
  *
@@ -353,6 +394,70 @@ static uint32_t can_recvfrom_eventhandler(FAR struct net_driver_s *dev,
   return flags;
 }
 
+/****************************************************************************
+ * Name: can_readahead_batch
+ *
+ * Description:
+ *   Copy the frames already in the read-ahead buffer into a vector of
+ *   messages, stopping when either runs out.
+ *
+ * Input Parameters:
+ *   conn     The CAN connection to receive from
+ *   msgvec   The vector of messages to fill
+ *   vlen     The number of entries in msgvec
+ *
+ * Returned Value:
+ *   The number of messages filled
+ *
+ ****************************************************************************/
+
+static unsigned int can_readahead_batch(FAR struct can_conn_s *conn,
+                                        FAR struct mmsghdr *msgvec,
+                                        unsigned int vlen)
+{
+  struct can_recvfrom_s state;
+  unsigned long msg_controllen;
+  FAR struct msghdr *msg;
+  FAR void *msg_control;
+  unsigned int n = 0;
+  int ret;
+
+  conn_lock(&conn->sconn);
+
+  while (n < vlen && !IOB_QEMPTY(&conn->readahead))
+    {
+      msg = &msgvec[n].msg_hdr;
+      if (msg->msg_iovlen != 1 || msg->msg_iov == NULL ||
+          msg->msg_iov->iov_base == NULL || msg->msg_iov->iov_len == 0)
+        {
+          break;
+        }
+
+      /* Save the original cmsg information as psock_recvmsg() does */
+
+      msg_control    = msg->msg_control;
+      msg_controllen = msg->msg_controllen;
+
+      can_recvfrom_init(&state, conn, msg);
+      ret = can_readahead(&state);
+
+      msg->msg_control = msg_control;
+      if (ret <= 0)
+        {
+          /* The frame was not passed on; reuse this message */
+
+          msg->msg_controllen = msg_controllen;
+          continue;
+        }
+
+      msg->msg_controllen = msg_controllen - msg->msg_controllen;
+      msgvec[n++].msg_len = ret;
+    }
+
+  conn_unlock(&conn->sconn);
+  return n;
+}
+
 /****************************************************************************
  * Name: can_recvfrom_result
  *
@@ -442,26 +547,9 @@ ssize_t can_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 
   /* Initialize the state structure. */
 
-  memset(&state, 0, sizeof(struct can_recvfrom_s));
+  can_recvfrom_init(&state, conn, msg);
   nxsem_init(&state.pr_sem, 0, 0); /* Doesn't really fail */
 
-  state.pr_buflen = msg->msg_iov->iov_len;
-  state.pr_buffer = msg->msg_iov->iov_base;
-
-#ifdef CONFIG_NET_TIMESTAMP
-  if (_SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMP))
-    {
-      state.pr_msgbuf = cmsg_append(msg, SOL_SOCKET, SO_TIMESTAMP,
-                                    NULL, sizeof(struct timeval));
-      if (state.pr_msgbuf != NULL)
-        {
-          state.pr_msglen = sizeof(struct timeval);
-        }
-    }
-#endif
-
-  state.pr_conn = conn;
-
   /* Handle any any CAN data already buffered in a read-ahead buffer.  NOTE
    * that there may be read-ahead data to be retrieved even after the
    * socket has been disconnected.
@@ -544,4 +632,64 @@ errout_with_state:
   return ret;
 }
 
+/****************************************************************************
+ * Name: can_recvmmsg
+ *
+ * Description:
+ *   Receive a batch of CAN frames.  Each round waits for one frame as
+ *   can_recvmsg() does and then takes every frame already queued in the
+ *   read-ahead buffer under a single lock, so a burst costs one wakeup.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   The vector of buffers to receive the frames
+ *   vlen     The number of entries in msgvec
+ *   flags    Receive flags, see psock_recvmmsg()
+ *   timeout  Optional time limit of the batch
+ *
+ ****************************************************************************/
+
+int can_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                 unsigned int vlen, int flags,
+                 FAR const struct timespec *timeout)
+{
+  FAR struct can_conn_s *conn = psock->s_conn;
+  clock_t deadline = 0;
+  unsigned int n = 0;
+  ssize_t ret;
+
+  if (timeout != NULL)
+    {
+      deadline = clock_systime_ticks() + clock_time2ticks(timeout);
+    }
+
+  while (n < vlen)
+    {
+      ret = psock_recvmsg(psock, &msgvec[n].msg_hdr,
+                          flags & ~MSG_WAITFORONE);
+      if (ret < 0)
+        {
+          return n > 0 ? n : ret;
+        }
+
+      msgvec[n++].msg_len = ret;
+      n += can_readahead_batch(conn, &msgvec[n], vlen - n);
+
+      /* Do not wait for the rest once one frame has arrived */
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL &&
+          (sclock_t)(clock_systime_ticks() - deadline) >= 0)
+        {
+          break;
+        }
+    }
+
+  return n;
+}
+
 #endif /* CONFIG_NET_CAN */
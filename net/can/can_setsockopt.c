@@ -98,6 +98,7 @@ int can_setsockopt(FAR struct socket *psock, int level, int option,
         if (value_len == 0)
           {
             conn->filter_count = 0;
+            can_filter_update(conn);
             ret = OK;
           }
         else if (value_len % sizeof(struct can_filter) != 0)
@@ -121,6 +122,7 @@ int can_setsockopt(FAR struct socket *psock, int level, int option,
               }
 
             conn->filter_count = count;
+            can_filter_update(conn);
 
             ret = OK;
           }
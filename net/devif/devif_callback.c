@@ -56,7 +56,7 @@
 
 /* IP/TCP/UDP/ICMP statistics for all network interfaces */
 
-#ifdef CONFIG_NET_STATISTICS
+#if defined(CONFIG_NET_STATISTICS) && !defined(CONFIG_NET_STATISTICS_PERCPU)
 struct net_stats_s g_netstats;
 #endif
 
@@ -59,6 +59,9 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
                    unsigned int len, unsigned int offset,
                    unsigned int target_offset)
 {
+#ifndef CONFIG_NET_IPFRAG
+  unsigned int pktsize;
+#endif
   int ret;
 
   if (dev == NULL)
@@ -74,7 +77,18 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
     }
 
 #ifndef CONFIG_NET_IPFRAG
-  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
+  pktsize = NETDEV_PKTSIZE(dev);
+
+#  ifdef CONFIG_NETDEV_GSO
+  /* A TCP super-frame is only limited by what the driver accepts */
+
+  if (dev->d_gsosize > 0)
+    {
+      pktsize = dev->d_gsomax;
+    }
+#  endif
+
+  if (len > pktsize - NET_LL_HDRLEN(dev) - target_offset)
     {
       ret = -EMSGSIZE;
       goto errout;
@@ -736,6 +736,27 @@ static int inet_get_socketlevel_option(FAR struct socket *psock, int option,
         break;
 #endif
 
+#ifdef CONFIG_NET_TIMESTAMPING
+      case SO_TIMESTAMPING:
+        {
+          if (*value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          if (psock->s_type == SOCK_DGRAM)
+            {
+              FAR struct udp_conn_s *conn = psock->s_conn;
+              *(FAR int *)value = conn->tsflags;
+            }
+          else
+            {
+              return -ENOPROTOOPT;
+            }
+        }
+        break;
+#endif
+
       default:
         return -ENOPROTOOPT;
     }
@@ -1049,6 +1070,45 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
         break;
   #endif
 
+#ifdef CONFIG_NET_TIMESTAMPING
+      case SO_TIMESTAMPING: /* Select SOF_TIMESTAMPING_* rx/tx stamps */
+        {
+          FAR struct udp_conn_s *conn;
+          int tsflags;
+
+          if (value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          tsflags = *((FAR const int *)value);
+          if ((tsflags & ~0xffff) != 0)
+            {
+              return -EINVAL;
+            }
+
+          if (psock->s_type != SOCK_DGRAM)
+            {
+              return -ENOPROTOOPT;
+            }
+
+          conn = psock->s_conn;
+          conn_lock(psock->s_conn);
+
+          /* OPT_ID keys count from zero from the time it is enabled */
+
+          if ((tsflags & SOF_TIMESTAMPING_OPT_ID) &&
+              !(conn->tsflags & SOF_TIMESTAMPING_OPT_ID))
+            {
+              conn->tskey = 0;
+            }
+
+          conn->tsflags = tsflags;
+          conn_unlock(psock->s_conn);
+        }
+        break;
+#endif
+
       default:
         return -ENOPROTOOPT;
     }
@@ -27,12 +27,14 @@
 #include <nuttx/config.h>
 
 #include <debug.h>
+#include <string.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/icmpv6.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/udp.h>
 #include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
 
 #include "icmp/icmp.h"
 #include "icmpv6/icmpv6.h"
@@ -65,6 +67,75 @@
 #define IPv6_L4HDR(ipv6, proto) \
   ((FAR void *)(net_ipv6_payload((FAR struct ipv6_hdr_s *)(ipv6), &(proto))))
 
+/* Returned internally when no rule of a chain matched */
+
+#define IPFILTER_TARGET_NONE   (1)
+
+/* The classes of rules in a classifier, the first three are hashed */
+
+#define IPFILTER_CLASS_PORT    0 /* By protocol and destination port */
+#define IPFILTER_CLASS_SRC     1 /* By source address */
+#define IPFILTER_CLASS_DST     2 /* By destination address */
+#define IPFILTER_CLASS_GENERIC 3 /* Not hashed */
+#define IPFILTER_NCLASSES      4
+
+#ifdef CONFIG_NET_IPv6
+#  define IPFILTER_ADDRLEN     sizeof(net_ipv6addr_t)
+#else
+#  define IPFILTER_ADDRLEN     sizeof(in_addr_t)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+/* The rules of a chain compiled by ipfilter_cfg_commit() */
+
+struct ipfilter_class_s
+{
+  FAR struct ipfilter_entry_s *generic;   /* Rules that are not hashed */
+  uint32_t mask;                          /* Number of buckets - 1 */
+
+  /* The hash buckets of the classes, (mask + 1) heads for each */
+
+  FAR struct ipfilter_entry_s *buckets[];
+};
+
+/* The rules of a classifier still to be visited for a packet */
+
+struct ipfilter_cursor_s
+{
+  FAR const struct ipfilter_entry_s *next[IPFILTER_NCLASSES];
+};
+#endif
+
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+/* The fields of a packet that the rules can match on */
+
+struct ipfilter_flow_key_s
+{
+  FAR const struct net_driver_s *indev;
+  FAR const struct net_driver_s *outdev;
+  uint8_t  saddr[IPFILTER_ADDRLEN];
+  uint8_t  daddr[IPFILTER_ADDRLEN];
+  uint16_t sport;
+  uint16_t dport;
+  uint8_t  proto;
+  uint8_t  chain;
+  uint8_t  family;
+};
+
+/* The verdict of a chain for a flow */
+
+struct ipfilter_flow_s
+{
+  struct ipfilter_flow_key_s key;
+  uint32_t gen;                         /* Rule generation of the verdict */
+  int8_t   target;
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -76,6 +147,26 @@ static sq_queue_t g_ipv4_filters[IPFILTER_CHAIN_MAX];
 static sq_queue_t g_ipv6_filters[IPFILTER_CHAIN_MAX];
 #endif
 
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+#  ifdef CONFIG_NET_IPv4
+static FAR struct ipfilter_class_s *g_ipv4_classes[IPFILTER_CHAIN_MAX];
+#  endif
+#  ifdef CONFIG_NET_IPv6
+static FAR struct ipfilter_class_s *g_ipv6_classes[IPFILTER_CHAIN_MAX];
+#  endif
+#endif
+
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+/* Verdicts are only valid for the generation of the rules they were
+ * computed with, 0 is never a valid generation.
+ */
+
+static struct ipfilter_flow_s
+g_ipfilter_flows[CONFIG_NET_IPFILTER_FLOWCACHE];
+static uint32_t g_ipfilter_gen = 1;
+static spinlock_t g_ipfilter_flowlock = SP_UNLOCKED;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -189,91 +280,644 @@ static bool ipfilter_match_proto(FAR const struct ipfilter_entry_s *entry,
 }
 
 /****************************************************************************
- * Name: ipv4_filter_match / ipv6_filter_match
+ * Name: ipfilter_hash
  *
  * Description:
- *   Match the input packet with the filter entries in the specified chain.
+ *   FNV-1a hash of a key, for the rule classifier and the flow cache.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPFILTER_CLASSIFIER) || \
+    CONFIG_NET_IPFILTER_FLOWCACHE > 0
+static uint32_t ipfilter_hash(FAR const void *key, size_t len)
+{
+  FAR const uint8_t *ptr = key;
+  uint32_t hash = 2166136261u;
+
+  while (len-- > 0)
+    {
+      hash = (hash ^ *ptr++) * 16777619u;
+    }
+
+  return hash;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_cfg_changed
+ *
+ * Description:
+ *   Invalidate the verdicts in the flow cache after a rule change.
+ *
+ ****************************************************************************/
+
+static void ipfilter_cfg_changed(void)
+{
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_ipfilter_flowlock);
+  if (++g_ipfilter_gen == 0)
+    {
+      memset(g_ipfilter_flows, 0, sizeof(g_ipfilter_flows));
+      g_ipfilter_gen = 1;
+    }
+
+  spin_unlock_irqrestore(&g_ipfilter_flowlock, flags);
+#endif
+}
+
+/****************************************************************************
+ * Name: ipfilter_flow_slot
+ *
+ * Description:
+ *   Build the flow key of a packet and return its slot in the flow cache.
+ *   ICMP packets are not cached since rules may match on their type.
+ *
+ * Input Parameters:
+ *   key     - Location to return the flow key
+ *   family  - The address family of the packet
+ *   chain   - The chain being traversed
+ *   indev   - The network device that the packet comes from
+ *   outdev  - The network device that the packet goes to
+ *   srcaddr - The source address of the packet
+ *   dstaddr - The destination address of the packet
+ *   addrlen - The length of the addresses
+ *   proto   - The transport protocol of the packet
+ *   l4hdr   - The transport header of the packet
+ *
+ * Returned Value:
+ *   The slot of the flow in the cache, NULL if the packet is not cached.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+static FAR struct ipfilter_flow_s *
+ipfilter_flow_slot(FAR struct ipfilter_flow_key_s *key, sa_family_t family,
+                   enum ipfilter_chain_e chain,
+                   FAR const struct net_driver_s *indev,
+                   FAR const struct net_driver_s *outdev,
+                   FAR const void *srcaddr, FAR const void *dstaddr,
+                   size_t addrlen, uint8_t proto, FAR const void *l4hdr)
+{
+  if (proto == IP_PROTO_ICMP || proto == IP_PROTO_ICMP6)
+    {
+      return NULL;
+    }
+
+  memset(key, 0, sizeof(*key));
+  key->indev  = indev;
+  key->outdev = outdev;
+  memcpy(key->saddr, srcaddr, addrlen);
+  memcpy(key->daddr, dstaddr, addrlen);
+  key->proto  = proto;
+  key->chain  = chain;
+  key->family = family;
+
+  if (proto == IP_PROTO_TCP || proto == IP_PROTO_UDP)
+    {
+      /* Ports in TCP & UDP headers have same offset. */
+
+      FAR const struct udp_hdr_s *udp = l4hdr;
+      key->sport = udp->srcport;
+      key->dport = udp->destport;
+    }
+
+  return &g_ipfilter_flows[ipfilter_hash(key, sizeof(*key)) %
+                           CONFIG_NET_IPFILTER_FLOWCACHE];
+}
+
+/****************************************************************************
+ * Name: ipfilter_flow_get
+ *
+ * Description:
+ *   Get the verdict of a flow if its slot of the flow cache holds it.
+ *
+ ****************************************************************************/
+
+static bool ipfilter_flow_get(FAR const struct ipfilter_flow_s *flow,
+                              FAR const struct ipfilter_flow_key_s *key,
+                              FAR int *target)
+{
+  irqstate_t flags;
+  bool hit;
+
+  flags = spin_lock_irqsave(&g_ipfilter_flowlock);
+  hit   = flow->gen == g_ipfilter_gen &&
+          memcmp(&flow->key, key, sizeof(*key)) == 0;
+  if (hit)
+    {
+      *target = flow->target;
+    }
+
+  spin_unlock_irqrestore(&g_ipfilter_flowlock, flags);
+  return hit;
+}
+
+/****************************************************************************
+ * Name: ipfilter_flow_set
+ *
+ * Description:
+ *   Remember the verdict of a flow, replacing the previous flow of the slot.
+ *
+ ****************************************************************************/
+
+static void ipfilter_flow_set(FAR struct ipfilter_flow_s *flow,
+                              FAR const struct ipfilter_flow_key_s *key,
+                              int target)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_ipfilter_flowlock);
+  memcpy(&flow->key, key, sizeof(*key));
+  flow->gen    = g_ipfilter_gen;
+  flow->target = target;
+  spin_unlock_irqrestore(&g_ipfilter_flowlock, flags);
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfilter_class_head
+ *
+ * Description:
+ *   Return the list of the classifier that a rule belongs to: its bucket
+ *   by (protocol, destination port) if it matches a single TCP or UDP port,
+ *   otherwise by source or destination address if it matches a single
+ *   host, otherwise the list of generic rules.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+static FAR struct ipfilter_entry_s **
+ipfilter_class_head(FAR struct ipfilter_class_s *cls,
+                    FAR struct ipfilter_entry_s *entry, sa_family_t family)
+{
+  FAR const void *srcaddr = NULL;
+  FAR const void *dstaddr = NULL;
+  size_t addrlen = 0;
+  uint32_t key;
+
+  if ((entry->proto == IP_PROTO_TCP || entry->proto == IP_PROTO_UDP) &&
+      entry->match_tcpudp && !entry->inv_proto && !entry->inv_dport &&
+      entry->match.tcpudp.dports[0] == entry->match.tcpudp.dports[1])
+    {
+      key = (uint32_t)entry->proto << 16 | entry->match.tcpudp.dports[0];
+      return &cls->buckets[IPFILTER_CLASS_PORT * (cls->mask + 1) +
+                           (ipfilter_hash(&key, sizeof(key)) & cls->mask)];
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      FAR struct ipv4_filter_entry_s *filter =
+        (FAR struct ipv4_filter_entry_s *)entry;
+
+      srcaddr = filter->smsk == INADDR_BROADCAST ? &filter->sip : NULL;
+      dstaddr = filter->dmsk == INADDR_BROADCAST ? &filter->dip : NULL;
+      addrlen = sizeof(in_addr_t);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      FAR struct ipv6_filter_entry_s *filter =
+        (FAR struct ipv6_filter_entry_s *)entry;
+
+      srcaddr = net_ipv6_mask2pref(filter->smsk) == 128 ? filter->sip : NULL;
+      dstaddr = net_ipv6_mask2pref(filter->dmsk) == 128 ? filter->dip : NULL;
+      addrlen = sizeof(net_ipv6addr_t);
+    }
+#endif
+
+  if (srcaddr != NULL && !entry->inv_srcip)
+    {
+      return &cls->buckets[IPFILTER_CLASS_SRC * (cls->mask + 1) +
+                           (ipfilter_hash(srcaddr, addrlen) & cls->mask)];
+    }
+
+  if (dstaddr != NULL && !entry->inv_dstip)
+    {
+      return &cls->buckets[IPFILTER_CLASS_DST * (cls->mask + 1) +
+                           (ipfilter_hash(dstaddr, addrlen) & cls->mask)];
+    }
+
+  return &cls->generic;
+}
+
+/****************************************************************************
+ * Name: ipfilter_class_build
+ *
+ * Description:
+ *   Compile the rules of a chain into a classifier.  Each rule is put into
+ *   one list of the classifier, the lists keep the order of the chain.
+ *
+ * Input Parameters:
+ *   queue  - The rules of the chain
+ *   family - The address family of the rules
+ *
+ * Returned Value:
+ *   The classifier, NULL if the chain is empty or on allocation failure,
+ *   the rules are then evaluated one by one.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfilter_class_s *
+ipfilter_class_build(FAR sq_queue_t *queue, sa_family_t family)
+{
+  FAR struct ipfilter_entry_s **head;
+  FAR struct ipfilter_entry_s *entry;
+  FAR struct ipfilter_class_s *cls;
+  FAR sq_entry_t *node;
+  size_t nbuckets = 4;
+  size_t nrules = 0;
+
+  sq_for_every(queue, node)
+    {
+      nrules++;
+    }
+
+  if (nrules == 0 || nrules > UINT16_MAX)
+    {
+      return NULL;
+    }
+
+  while (nbuckets < nrules)
+    {
+      nbuckets <<= 1;
+    }
+
+  cls = kmm_zalloc(sizeof(*cls) + IPFILTER_CLASS_GENERIC * nbuckets *
+                   sizeof(FAR struct ipfilter_entry_s *));
+  if (cls == NULL)
+    {
+      nwarn("WARNING: No memory for the classifier of %zu rules\n", nrules);
+      return NULL;
+    }
+
+  cls->mask = nbuckets - 1;
+  nrules    = 0;
+
+  sq_for_every(queue, node)
+    {
+      entry        = (FAR struct ipfilter_entry_s *)node;
+      entry->seq   = nrules++;
+      entry->cnext = NULL;
+
+      head = ipfilter_class_head(cls, entry, family);
+      while (*head != NULL)
+        {
+          head = &(*head)->cnext;
+        }
+
+      *head = entry;
+    }
+
+  return cls;
+}
+
+/****************************************************************************
+ * Name: ipfilter_class_start
+ *
+ * Description:
+ *   Start to walk the rules of a classifier that may match a packet.
+ *
+ ****************************************************************************/
+
+static void ipfilter_class_start(FAR struct ipfilter_cursor_s *cursor,
+                                 FAR const struct ipfilter_class_s *cls,
+                                 FAR const void *srcaddr,
+                                 FAR const void *dstaddr, size_t addrlen,
+                                 uint8_t proto, FAR const void *l4hdr)
+{
+  uint32_t key;
+
+  memset(cursor, 0, sizeof(*cursor));
+
+  if (proto == IP_PROTO_TCP || proto == IP_PROTO_UDP)
+    {
+      FAR const struct udp_hdr_s *udp = l4hdr;
+
+      key = (uint32_t)proto << 16 | NTOHS(udp->destport);
+      cursor->next[IPFILTER_CLASS_PORT] =
+        cls->buckets[IPFILTER_CLASS_PORT * (cls->mask + 1) +
+                     (ipfilter_hash(&key, sizeof(key)) & cls->mask)];
+    }
+
+  cursor->next[IPFILTER_CLASS_SRC] =
+    cls->buckets[IPFILTER_CLASS_SRC * (cls->mask + 1) +
+                 (ipfilter_hash(srcaddr, addrlen) & cls->mask)];
+  cursor->next[IPFILTER_CLASS_DST] =
+    cls->buckets[IPFILTER_CLASS_DST * (cls->mask + 1) +
+                 (ipfilter_hash(dstaddr, addrlen) & cls->mask)];
+  cursor->next[IPFILTER_CLASS_GENERIC] = cls->generic;
+}
+
+/****************************************************************************
+ * Name: ipfilter_class_next
+ *
+ * Description:
+ *   Return the next rule that may match the packet, in chain order.
+ *
+ ****************************************************************************/
+
+static FAR const struct ipfilter_entry_s *
+ipfilter_class_next(FAR struct ipfilter_cursor_s *cursor)
+{
+  FAR const struct ipfilter_entry_s *entry = NULL;
+  int next = 0;
+  int i;
+
+  for (i = 0; i < IPFILTER_NCLASSES; i++)
+    {
+      if (cursor->next[i] != NULL &&
+          (entry == NULL || cursor->next[i]->seq < entry->seq))
+        {
+          entry = cursor->next[i];
+          next  = i;
+        }
+    }
+
+  if (entry != NULL)
+    {
+      cursor->next[next] = entry->cnext;
+    }
+
+  return entry;
+}
+#endif /* CONFIG_NET_IPFILTER_CLASSIFIER */
+
+/****************************************************************************
+ * Name: ipv4_filter_match_entry / ipv6_filter_match_entry
+ *
+ * Description:
+ *   Match the packet with one filter entry.
  *
  * Input Parameters:
+ *   filter    - The filter entry to match
  *   indev     - The network device that the packet comes from
  *   outdev    - The network device that the packet goes to
  *   ipv4/ipv6 - The IPv4/IPv6 header
- *   chain     - The chain to match the filter entries
+ *   l4hdr     - The transport header
+ *   proto     - The transport protocol (IPv6 only)
  *
  * Returned Value:
- *   IPFILTER_TARGET_ACCEPT(0)  - The input packet is accepted
- *   IPFILTER_TARGET_DROP(-1)   - The input packet needs to be dropped
- *   IPFILTER_TARGET_REJECT(-2) - The input packet is rejected
+ *   true  - The packet is matched
+ *   false - The packet is not matched
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
-static int ipv4_filter_match(FAR const struct net_driver_s *indev,
-                             FAR const struct net_driver_s *outdev,
-                             FAR const struct ipv4_hdr_s *ipv4,
-                             enum ipfilter_chain_e chain)
+static bool
+ipv4_filter_match_entry(FAR const struct ipv4_filter_entry_s *filter,
+                        FAR const struct net_driver_s *indev,
+                        FAR const struct net_driver_s *outdev,
+                        FAR const struct ipv4_hdr_s *ipv4,
+                        FAR const void *l4hdr)
 {
-  FAR const struct ipv4_filter_entry_s *filter;
-  FAR const sq_queue_t *queue = &g_ipv4_filters[chain];
-  FAR const sq_entry_t *entry;
-  FAR const void *l4hdr;
   in_addr_t ipaddr;
   bool matched;
 
-  /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
+  /* Match device */
 
-  if ((indev == NULL && outdev == NULL) || ipv4 == NULL)
+  if (!ipfilter_match_device(&filter->common, indev, outdev))
     {
-      return IPFILTER_TARGET_ACCEPT;
+      return false;
     }
 
-  l4hdr = IPv4_L4HDR(ipv4);
+  /* Match addresses */
+
+  ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
+  matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  /* Match protocol */
 
-  sq_for_every(queue, entry)
+  return ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static bool
+ipv6_filter_match_entry(FAR const struct ipv6_filter_entry_s *filter,
+                        FAR const struct net_driver_s *indev,
+                        FAR const struct net_driver_s *outdev,
+                        FAR const struct ipv6_hdr_s *ipv6,
+                        FAR const void *l4hdr, uint8_t proto)
+{
+  bool matched;
+
+  /* Match device */
+
+  if (!ipfilter_match_device(&filter->common, indev, outdev))
     {
-      filter = (FAR struct ipv4_filter_entry_s *)entry;
+      return false;
+    }
 
-      /* Match device */
+  /* Match addresses */
 
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
+  matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
+                                 filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
+                                 filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  /* Match protocol */
+
+  return ipfilter_match_proto(&filter->common, l4hdr, proto);
+}
+#endif
+
+/****************************************************************************
+ * Name: ipv4_filter_walk / ipv6_filter_walk
+ *
+ * Description:
+ *   Return the target of the first filter entry of a chain matching the
+ *   packet, using the classifier of the chain if it was compiled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int ipv4_filter_walk(FAR const struct net_driver_s *indev,
+                            FAR const struct net_driver_s *outdev,
+                            FAR const struct ipv4_hdr_s *ipv4,
+                            FAR const void *l4hdr,
+                            enum ipfilter_chain_e chain)
+{
+  FAR const struct ipv4_filter_entry_s *filter;
+  FAR const sq_entry_t *entry;
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+  FAR const struct ipfilter_class_s *cls = g_ipv4_classes[chain];
+  struct ipfilter_cursor_s cursor;
+
+  if (cls != NULL)
+    {
+      ipfilter_class_start(&cursor, cls, ipv4->srcipaddr, ipv4->destipaddr,
+                           sizeof(in_addr_t), ipv4->proto, l4hdr);
+      while ((filter = (FAR const struct ipv4_filter_entry_s *)
+                       ipfilter_class_next(&cursor)) != NULL)
         {
-          continue;
+          if (ipv4_filter_match_entry(filter, indev, outdev, ipv4, l4hdr))
+            {
+              return filter->common.target;
+            }
         }
 
-      /* Match addresses */
+      return IPFILTER_TARGET_NONE;
+    }
+#endif
 
-      ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
-      matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
+  sq_for_every(&g_ipv4_filters[chain], entry)
+    {
+      filter = (FAR const struct ipv4_filter_entry_s *)entry;
+      if (ipv4_filter_match_entry(filter, indev, outdev, ipv4, l4hdr))
         {
-          continue;
+          return filter->common.target;
         }
+    }
 
-      ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
-      matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
+  return IPFILTER_TARGET_NONE;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int ipv6_filter_walk(FAR const struct net_driver_s *indev,
+                            FAR const struct net_driver_s *outdev,
+                            FAR const struct ipv6_hdr_s *ipv6,
+                            FAR const void *l4hdr, uint8_t proto,
+                            enum ipfilter_chain_e chain)
+{
+  FAR const struct ipv6_filter_entry_s *filter;
+  FAR const sq_entry_t *entry;
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+  FAR const struct ipfilter_class_s *cls = g_ipv6_classes[chain];
+  struct ipfilter_cursor_s cursor;
+
+  if (cls != NULL)
+    {
+      ipfilter_class_start(&cursor, cls, ipv6->srcipaddr, ipv6->destipaddr,
+                           sizeof(net_ipv6addr_t), proto, l4hdr);
+      while ((filter = (FAR const struct ipv6_filter_entry_s *)
+                       ipfilter_class_next(&cursor)) != NULL)
         {
-          continue;
+          if (ipv6_filter_match_entry(filter, indev, outdev, ipv6, l4hdr,
+                                      proto))
+            {
+              return filter->common.target;
+            }
         }
 
-      /* Match protocol */
+      return IPFILTER_TARGET_NONE;
+    }
+#endif
 
-      if (!ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto))
+  sq_for_every(&g_ipv6_filters[chain], entry)
+    {
+      filter = (FAR const struct ipv6_filter_entry_s *)entry;
+      if (ipv6_filter_match_entry(filter, indev, outdev, ipv6, l4hdr, proto))
         {
-          continue;
+          return filter->common.target;
         }
+    }
+
+  return IPFILTER_TARGET_NONE;
+}
+#endif
 
-      /* Return the target action if matched. */
+/****************************************************************************
+ * Name: ipv4_filter_match / ipv6_filter_match
+ *
+ * Description:
+ *   Match the input packet with the filter entries in the specified chain.
+ *
+ * Input Parameters:
+ *   indev     - The network device that the packet comes from
+ *   outdev    - The network device that the packet goes to
+ *   ipv4/ipv6 - The IPv4/IPv6 header
+ *   chain     - The chain to match the filter entries
+ *
+ * Returned Value:
+ *   IPFILTER_TARGET_ACCEPT(0)  - The input packet is accepted
+ *   IPFILTER_TARGET_DROP(-1)   - The input packet needs to be dropped
+ *   IPFILTER_TARGET_REJECT(-2) - The input packet is rejected
+ *
+ ****************************************************************************/
 
-      return filter->common.target;
+#ifdef CONFIG_NET_IPv4
+static int ipv4_filter_match(FAR const struct net_driver_s *indev,
+                             FAR const struct net_driver_s *outdev,
+                             FAR const struct ipv4_hdr_s *ipv4,
+                             enum ipfilter_chain_e chain)
+{
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+  struct ipfilter_flow_key_s key;
+  FAR struct ipfilter_flow_s *flow;
+#endif
+  FAR const void *l4hdr;
+  int ret;
+
+  /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
+
+  if ((indev == NULL && outdev == NULL) || ipv4 == NULL)
+    {
+      return IPFILTER_TARGET_ACCEPT;
     }
 
-  /* Normally there should be a default rule in chain, won't reach here. */
+  l4hdr = IPv4_L4HDR(ipv4);
+
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+  /* The rules only depend on the fields of the flow key, so a flow gets
+   * the same verdict until the rules change.
+   */
+
+  flow = ipfilter_flow_slot(&key, PF_INET, chain, indev, outdev,
+                            ipv4->srcipaddr, ipv4->destipaddr,
+                            sizeof(in_addr_t), ipv4->proto, l4hdr);
+  if (flow != NULL && ipfilter_flow_get(flow, &key, &ret))
+    {
+      return ret;
+    }
+#endif
 
-  ninfo("No filter matched, maybe uninitialized.\n");
-  return IPFILTER_TARGET_ACCEPT;
+  ret = ipv4_filter_walk(indev, outdev, ipv4, l4hdr, chain);
+  if (ret == IPFILTER_TARGET_NONE)
+    {
+      /* Normally there should be a default rule in chain. */
+
+      ninfo("No filter matched, maybe uninitialized.\n");
+      ret = IPFILTER_TARGET_ACCEPT;
+    }
+
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+  if (flow != NULL)
+    {
+      ipfilter_flow_set(flow, &key, ret);
+    }
+#endif
+
+  return ret;
 }
 #endif
 
@@ -283,12 +927,13 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
                              FAR const struct ipv6_hdr_s *ipv6,
                              enum ipfilter_chain_e chain)
 {
-  FAR const struct ipv6_filter_entry_s *filter;
-  FAR const sq_queue_t *queue = &g_ipv6_filters[chain];
-  FAR const sq_entry_t *entry;
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+  struct ipfilter_flow_key_s key;
+  FAR struct ipfilter_flow_s *flow;
+#endif
   FAR const void *l4hdr;
   uint8_t proto;
-  bool matched;
+  int ret;
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -299,51 +944,37 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
 
   l4hdr = IPv6_L4HDR(ipv6, proto);
 
-  sq_for_every(queue, entry)
-    {
-      filter = (FAR struct ipv6_filter_entry_s *)entry;
-
-      /* Match device */
-
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
-        {
-          continue;
-        }
-
-      /* Match addresses */
-
-      matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
-                                     filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
-        {
-          continue;
-        }
-
-      matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
-                                     filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
-        {
-          continue;
-        }
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+  /* The rules only depend on the fields of the flow key, so a flow gets
+   * the same verdict until the rules change.
+   */
 
-      /* Match protocol */
-
-      if (!ipfilter_match_proto(&filter->common, l4hdr, proto))
-        {
-          continue;
-        }
+  flow = ipfilter_flow_slot(&key, PF_INET6, chain, indev, outdev,
+                            ipv6->srcipaddr, ipv6->destipaddr,
+                            sizeof(net_ipv6addr_t), proto, l4hdr);
+  if (flow != NULL && ipfilter_flow_get(flow, &key, &ret))
+    {
+      return ret;
+    }
+#endif
 
-      /* Return the target action if matched. */
+  ret = ipv6_filter_walk(indev, outdev, ipv6, l4hdr, proto, chain);
+  if (ret == IPFILTER_TARGET_NONE)
+    {
+      /* Normally there should be a default rule in chain. */
 
-      return filter->common.target;
+      ninfo("No filter matched, maybe uninitialized.\n");
+      ret = IPFILTER_TARGET_ACCEPT;
     }
 
-  /* Normally there should be a default rule in chain, won't reach here. */
+#if CONFIG_NET_IPFILTER_FLOWCACHE > 0
+  if (flow != NULL)
+    {
+      ipfilter_flow_set(flow, &key, ret);
+    }
+#endif
 
-  ninfo("No filter matched, maybe uninitialized.\n");
-  return IPFILTER_TARGET_ACCEPT;
+  return ret;
 }
 #endif
 
@@ -411,6 +1042,13 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
   if (family == PF_INET)
     {
       sq_addlast((FAR sq_entry_t *)entry, &g_ipv4_filters[chain]);
+
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+      /* Evaluate the chain linearly until it is compiled again */
+
+      kmm_free(g_ipv4_classes[chain]);
+      g_ipv4_classes[chain] = NULL;
+#endif
     }
 #endif
 
@@ -418,8 +1056,17 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
   if (family == PF_INET6)
     {
       sq_addlast((FAR sq_entry_t *)entry, &g_ipv6_filters[chain]);
+
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+      /* Evaluate the chain linearly until it is compiled again */
+
+      kmm_free(g_ipv6_classes[chain]);
+      g_ipv6_classes[chain] = NULL;
+#endif
     }
 #endif
+
+  ipfilter_cfg_changed();
 }
 
 /****************************************************************************
@@ -444,6 +1091,12 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
   if (family == PF_INET)
     {
       FAR sq_queue_t *queue = &g_ipv4_filters[chain];
+
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+      kmm_free(g_ipv4_classes[chain]);
+      g_ipv4_classes[chain] = NULL;
+#endif
+
       while (!sq_empty(queue))
         {
           kmm_free(sq_remfirst(queue));
@@ -455,12 +1108,62 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
   if (family == PF_INET6)
     {
       FAR sq_queue_t *queue = &g_ipv6_filters[chain];
+
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+      kmm_free(g_ipv6_classes[chain]);
+      g_ipv6_classes[chain] = NULL;
+#endif
+
       while (!sq_empty(queue))
         {
           kmm_free(sq_remfirst(queue));
         }
     }
 #endif
+
+  ipfilter_cfg_changed();
+}
+
+/****************************************************************************
+ * Name: ipfilter_cfg_commit
+ *
+ * Description:
+ *   Compile the filter configuration entries of a chain once all of them
+ *   were added.  Without CONFIG_NET_IPFILTER_CLASSIFIER, or if compilation
+ *   fails, the entries are evaluated one by one.
+ *
+ * Input Parameters:
+ *   family - The address family of the filter entries
+ *   chain  - The chain to compile
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ipfilter_cfg_commit(sa_family_t family, enum ipfilter_chain_e chain)
+{
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      kmm_free(g_ipv4_classes[chain]);
+      g_ipv4_classes[chain] = ipfilter_class_build(&g_ipv4_filters[chain],
+                                                   PF_INET);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      kmm_free(g_ipv6_classes[chain]);
+      g_ipv6_classes[chain] = ipfilter_class_build(&g_ipv6_filters[chain],
+                                                   PF_INET6);
+    }
+#endif
+#endif
+
+  ipfilter_cfg_changed();
 }
 
 /****************************************************************************
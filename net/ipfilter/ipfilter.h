@@ -97,6 +97,13 @@ struct ipfilter_entry_s
   uint8_t inv_sport  : 1; /* Inverse source port */
   uint8_t inv_dport  : 1; /* Inverse destination port */
   uint8_t inv_icmp   : 1; /* Inverse ICMP type */
+
+#ifdef CONFIG_NET_IPFILTER_CLASSIFIER
+  /* Set by ipfilter_cfg_commit() */
+
+  FAR struct ipfilter_entry_s *cnext; /* Next rule of the same class */
+  uint16_t seq;                       /* Position in the chain */
+#endif
 };
 
 struct ipv4_filter_entry_s
@@ -182,6 +189,25 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
 
 void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain);
 
+/****************************************************************************
+ * Name: ipfilter_cfg_commit
+ *
+ * Description:
+ *   Compile the filter configuration entries of a chain once all of them
+ *   were added.  Without CONFIG_NET_IPFILTER_CLASSIFIER, or if compilation
+ *   fails, the entries are evaluated one by one.
+ *
+ * Input Parameters:
+ *   family - The address family of the filter entries
+ *   chain  - The chain to compile
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void ipfilter_cfg_commit(sa_family_t family, enum ipfilter_chain_e chain);
+
 /****************************************************************************
  * Name: ipv4_filter_in / ipv6_filter_in
  *
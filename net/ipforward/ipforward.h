@@ -356,4 +356,29 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #endif
 
 #endif /* CONFIG_NET_IPFORWARD */
+
+/****************************************************************************
+ * Name: ipv4_fwdcache_flush
+ *
+ * Description:
+ *   Forget the egress devices of all forwarded IPv4 flows.  Must be called
+ *   whenever the result of netdev_findby_ripv4addr() may change, i.e. when
+ *   a route is added or deleted or when a device goes up or down or gets
+ *   a new address.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPFORWARD) && defined(CONFIG_NET_IPv4) && \
+    CONFIG_NET_IPFORWARD_CACHE > 0
+void ipv4_fwdcache_flush(void);
+#else
+#  define ipv4_fwdcache_flush()
+#endif
+
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
@@ -35,6 +35,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
+#include <nuttx/spinlock.h>
 
 #include "netdev/netdev.h"
 #include "utils/utils.h"
@@ -47,10 +48,120 @@
 
 #if defined(CONFIG_NET_IPFORWARD) && defined(CONFIG_NET_IPv4)
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFORWARD_CACHE > 0
+/* One entry of the forwarding cache, the egress device of a flow */
+
+struct ipv4_fwdcache_s
+{
+  in_addr_t                srcipaddr;
+  in_addr_t                destipaddr;
+  FAR struct net_driver_s *dev;        /* NULL if the entry is unused */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFORWARD_CACHE > 0
+static struct ipv4_fwdcache_s g_ipv4_fwdcache[CONFIG_NET_IPFORWARD_CACHE];
+
+/* Bumped by each flush, so that a lookup racing with a flush does not put
+ * a stale device back into the cache.
+ */
+
+static uint32_t g_ipv4_fwdcache_gen;
+static spinlock_t g_ipv4_fwdcache_lock = SP_UNLOCKED;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: ipv4_fwdcache_slot
+ *
+ * Description:
+ *   Return the slot of the forwarding cache for a pair of addresses.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFORWARD_CACHE > 0
+static FAR struct ipv4_fwdcache_s *ipv4_fwdcache_slot(in_addr_t srcipaddr,
+                                                      in_addr_t destipaddr)
+{
+  uint32_t hash = (srcipaddr * 0x9e3779b1) ^ destipaddr;
+
+  hash ^= hash >> 16;
+  return &g_ipv4_fwdcache[(hash * 0x85ebca6b >> 16) %
+                          CONFIG_NET_IPFORWARD_CACHE];
+}
+
+/****************************************************************************
+ * Name: ipv4_fwdcache_find
+ *
+ * Description:
+ *   Find the egress device of a flow in the forwarding cache, or return
+ *   the generation of the cache to pass to ipv4_fwdcache_add() once the
+ *   device is looked up.
+ *
+ ****************************************************************************/
+
+static FAR struct net_driver_s *ipv4_fwdcache_find(in_addr_t srcipaddr,
+                                                   in_addr_t destipaddr,
+                                                   FAR uint32_t *gen)
+{
+  FAR struct ipv4_fwdcache_s *slot;
+  FAR struct net_driver_s *dev = NULL;
+  irqstate_t flags;
+
+  slot  = ipv4_fwdcache_slot(srcipaddr, destipaddr);
+  flags = spin_lock_irqsave(&g_ipv4_fwdcache_lock);
+
+  if (slot->dev != NULL && slot->srcipaddr == srcipaddr &&
+      slot->destipaddr == destipaddr && IFF_IS_RUNNING(slot->dev->d_flags))
+    {
+      dev = slot->dev;
+    }
+
+  *gen = g_ipv4_fwdcache_gen;
+  spin_unlock_irqrestore(&g_ipv4_fwdcache_lock, flags);
+  return dev;
+}
+
+/****************************************************************************
+ * Name: ipv4_fwdcache_add
+ *
+ * Description:
+ *   Remember the egress device of a flow, unless the cache was flushed
+ *   since the generation gen was read.
+ *
+ ****************************************************************************/
+
+static void ipv4_fwdcache_add(in_addr_t srcipaddr, in_addr_t destipaddr,
+                              FAR struct net_driver_s *dev, uint32_t gen)
+{
+  FAR struct ipv4_fwdcache_s *slot;
+  irqstate_t flags;
+
+  slot  = ipv4_fwdcache_slot(srcipaddr, destipaddr);
+  flags = spin_lock_irqsave(&g_ipv4_fwdcache_lock);
+
+  if (gen == g_ipv4_fwdcache_gen)
+    {
+      slot->srcipaddr  = srcipaddr;
+      slot->destipaddr = destipaddr;
+      slot->dev        = dev;
+    }
+
+  spin_unlock_irqrestore(&g_ipv4_fwdcache_lock, flags);
+}
+#endif
+
 /****************************************************************************
  * Name: ipv4_hdrsize
  *
@@ -459,6 +570,9 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   in_addr_t destipaddr;
   in_addr_t srcipaddr;
   FAR struct net_driver_s *fwddev;
+#if CONFIG_NET_IPFORWARD_CACHE > 0
+  uint32_t gen;
+#endif
   int ret;
 #if defined(CONFIG_NET_ICMP) && !defined(CONFIG_NET_ICMP_NO_STACK)
   int icmp_reply_type;
@@ -470,7 +584,20 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
   srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
 
+#if CONFIG_NET_IPFORWARD_CACHE > 0
+  fwddev     = ipv4_fwdcache_find(srcipaddr, destipaddr, &gen);
+  if (fwddev == NULL)
+    {
+      fwddev = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+      if (fwddev != NULL)
+        {
+          ipv4_fwdcache_add(srcipaddr, destipaddr, fwddev, gen);
+        }
+    }
+#else
   fwddev     = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+#endif
+
   if (fwddev == NULL)
     {
       nwarn("WARNING: Not routable\n");
@@ -570,6 +697,26 @@ reply:
 #endif /* CONFIG_NET_ICMP */
 }
 
+/****************************************************************************
+ * Name: ipv4_fwdcache_flush
+ *
+ * Description:
+ *   Forget the egress devices of all forwarded IPv4 flows.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFORWARD_CACHE > 0
+void ipv4_fwdcache_flush(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_ipv4_fwdcache_lock);
+  memset(g_ipv4_fwdcache, 0, sizeof(g_ipv4_fwdcache));
+  g_ipv4_fwdcache_gen++;
+  spin_unlock_irqrestore(&g_ipv4_fwdcache_lock, flags);
+}
+#endif
+
 /****************************************************************************
  * Name: ipv4_forward_broadcast
  *
@@ -94,7 +94,18 @@ do  \
 
 /* The maximum I/O buffer occupied by fragment reassembly cache */
 
-#define REASSEMBLY_MAXOCCUPYIOB        CONFIG_IOB_NBUFFERS / 5
+#if CONFIG_NET_IPFRAG_REASS_MAXIOB > 0
+#  define REASSEMBLY_MAXOCCUPYIOB      CONFIG_NET_IPFRAG_REASS_MAXIOB
+#else
+#  define REASSEMBLY_MAXOCCUPYIOB      (CONFIG_IOB_NBUFFERS / 5)
+#endif
+
+/* Number of hash buckets of the datagrams being reassembled, a power of 2 */
+
+#define REASSEMBLY_NBUCKETS            16
+#define REASSEMBLY_BUCKET(dev, ipid) \
+  ((((uintptr_t)(dev) >> 4) ^ (ipid) ^ ((ipid) >> 16)) & \
+   (REASSEMBLY_NBUCKETS - 1))
 
 /* Deciding whether to fragment outgoing packets which target is to ourself */
 
@@ -117,13 +128,11 @@ static struct work_s g_wkfragtimeout;
 
 /* Remember the number of I/O buffers currently in reassembly cache */
 
-static uint8_t       g_bufoccupy;
+static uint32_t      g_bufoccupy;
 
-/* Queue header definition, it links all fragments of all NICs by ascending
- * ipid.
- */
+/* Hash table of the datagrams being reassembled, by NIC and ipid */
 
-static sq_queue_t    g_assemblyhead_ipid;
+static sq_queue_t    g_assemblyhead_ipid[REASSEMBLY_NBUCKETS];
 
 /* Queue header definition, which connects all fragments of all NICs in order
  * of addition time.
@@ -366,8 +375,10 @@ ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink)
  * Name: ip_fragin_check
  *
  * Description:
- *   Check whether the zero fragment has been received or all fragments have
- *   been received.
+ *   Extend the run of fragments from offset zero that follow each other
+ *   exactly and check whether it reached the tail fragment, i.e. whether
+ *   all fragments have been received.  Each fragment is only visited once
+ *   as the run only grows, unless an overlapping fragment reset it.
  *
  * Input Parameters:
  *   fragsnode - node of the upper-level linked list, it maintains
@@ -380,30 +391,30 @@ ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink)
 
 static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode)
 {
-  uint16_t formerlen = 0;
-  FAR struct ip_fraglink_s *entry;
+  FAR struct ip_fraglink_s *entry = fragsnode->contiglink;
 
-  if (fragsnode->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG)
+  if (entry == NULL)
     {
       entry = fragsnode->frags;
-      while (entry != NULL)
+      if (entry == NULL || entry->fragoff != 0)
         {
-          if (entry->morefrags)
-            {
-              formerlen += entry->fraglen;
-            }
-          else
-            {
-              /* Only the last entry has a 0 morefrags flag */
+          return;
+        }
+    }
 
-              if (entry->fragoff == formerlen)
-                {
-                  fragsnode->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
-                }
-            }
+  while (entry->morefrags && entry->flink != NULL &&
+         entry->flink->fragoff == entry->fragoff + entry->fraglen)
+    {
+      entry = entry->flink;
+    }
 
-          entry = entry->flink;
-        }
+  fragsnode->contiglink = entry;
+
+  /* Only the last entry has a 0 morefrags flag */
+
+  if (!entry->morefrags)
+    {
+      fragsnode->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
     }
 }
 
@@ -530,7 +541,8 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
   g_bufoccupy -= node->bufcnt;
   ASSERT(g_bufoccupy < CONFIG_IOB_NBUFFERS);
 
-  sq_rem((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
+  sq_rem((FAR sq_entry_t *)node,
+         &g_assemblyhead_ipid[REASSEMBLY_BUCKET(node->dev, node->ipid)]);
   sq_rem((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
 
   return node->bufcnt;
@@ -558,60 +570,56 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
 bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
                        FAR struct ip_fraglink_s *curfraglink)
 {
+  FAR sq_queue_t            *bucket;
   FAR struct ip_fragsnode_s *node;
   FAR sq_entry_t            *entry;
-  FAR sq_entry_t            *entrylast = NULL;
   bool                       empty;
 
-  /* The linked list is ordered by IP ID value, walk through it and try to
-   * find a node that has the same IP ID value, otherwise need to create a
-   * new node and insert it into the linked list.
+  /* Look for the node of the datagram in its hash bucket, otherwise need
+   * to create a new node.
    */
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-  empty = (entry == NULL) ? true : false;
+  bucket = &g_assemblyhead_ipid[REASSEMBLY_BUCKET(dev, curfraglink->ipid)];
+  empty  = sq_peek(&g_assemblyhead_time) == NULL;
 
-  while (entry != NULL)
+  for (entry = sq_peek(bucket); entry != NULL; entry = sq_next(entry))
     {
-      node = (struct ip_fragsnode_s *)entry;
+      node = (FAR struct ip_fragsnode_s *)entry;
 
-      if (dev == node->dev && curfraglink->ipid <= node->ipid)
+      if (dev == node->dev && curfraglink->ipid == node->ipid &&
+          (node->frags == NULL ||
+           curfraglink->isipv4 == node->frags->isipv4))
         {
           break;
         }
-
-      entrylast = entry;
-      entry = sq_next(entry);
     }
 
   node = (FAR struct ip_fragsnode_s *)entry;
 
-  if (node != NULL && curfraglink->ipid == node->ipid)
+  if (node != NULL)
     {
       FAR struct ip_fraglink_s *fraglink;
       FAR struct ip_fraglink_s *lastlink = NULL;
 
       /* Found a previously created ip_fragsnode_s, insert this new
-       * ip_fraglink_s to the subchain of this node.
-       */
-
-      fraglink = node->frags;
-
-      /* An ip_fragsnode_s must have an ip_fraglink_s because we allocate a
-       * new ip_fraglink_s when caching a new ip_fraglink_s with a new IP ID
+       * ip_fraglink_s to the subchain of this node, ordered by fragment
+       * offset.  In order fragments go straight after the last one.
        */
 
-      while (fraglink != NULL)
+      if (curfraglink->fragoff > node->fraglast->fragoff)
         {
-          /* The fragment list is ordered by fragment offset value */
+          lastlink = node->fraglast;
+          fraglink = NULL;
+        }
+      else
+        {
+          fraglink = node->frags;
 
-          if (curfraglink->fragoff <= fraglink->fragoff)
+          while (curfraglink->fragoff > fraglink->fragoff)
             {
-              break;
+              lastlink = fraglink;
+              fraglink = fraglink->flink;
             }
-
-          lastlink = fraglink;
-          fraglink = fraglink->flink;
         }
 
       if (fraglink == NULL)
@@ -620,62 +628,88 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
            * added to the last position
            */
 
-          lastlink->flink      = curfraglink;
+          lastlink->flink = curfraglink;
+          node->fraglast  = curfraglink;
 
           /* Remember I/O buffer count */
 
           node->bufcnt += IOBUF_CNT(curfraglink->frag);
           g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
         }
-      else if (curfraglink->fragoff == fraglink->fragoff)
+      else
         {
-          /* Fragments with same offset value contain the same data, use the
-           * more recently arrived copy. Refer to RFC791, Section3.2, Page29.
-           * Replace and removed the old packet from the fragment list
+          /* Changing the fragments behind the end of the contiguous run
+           * leaves it valid, otherwise it is rebuilt from offset zero.
            */
 
-          curfraglink->flink = fraglink->flink;
-          if (lastlink == NULL)
+          if (node->contiglink != NULL &&
+              curfraglink->fragoff <= node->contiglink->fragoff)
             {
-              node->frags = curfraglink;
+              node->contiglink = NULL;
             }
-          else
+
+          if (curfraglink->fragoff == fraglink->fragoff)
             {
-              lastlink->flink = curfraglink;
-            }
+              /* Fragments with same offset value contain the same data,
+               * use the more recently arrived copy. Refer to RFC791,
+               * Section3.2, Page29.  Replace and removed the old packet
+               * from the fragment list
+               */
 
-          iob_free_chain(fraglink->frag);
-          kmm_free(fraglink);
-        }
-      else
-        {
-          /* Insert into the fragment list */
+              curfraglink->flink = fraglink->flink;
+              if (lastlink == NULL)
+                {
+                  node->frags = curfraglink;
+                }
+              else
+                {
+                  lastlink->flink = curfraglink;
+                }
 
-          if (lastlink == NULL)
-            {
-              /* Insert before the first node */
+              if (node->fraglast == fraglink)
+                {
+                  node->fraglast = curfraglink;
+                }
+
+              /* Account the I/O buffers of the new copy instead */
+
+              node->bufcnt -= IOBUF_CNT(fraglink->frag);
+              g_bufoccupy  -= IOBUF_CNT(fraglink->frag);
+              node->bufcnt += IOBUF_CNT(curfraglink->frag);
+              g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
 
-              curfraglink->flink = node->frags;
-              node->frags = curfraglink;
+              iob_free_chain(fraglink->frag);
+              kmm_free(fraglink);
             }
           else
             {
-              /* Insert this node after lastlink */
+              /* Insert into the fragment list */
 
-              curfraglink->flink = lastlink->flink;
-              lastlink->flink = curfraglink;
-            }
+              curfraglink->flink = fraglink;
+              if (lastlink == NULL)
+                {
+                  /* Insert before the first node */
 
-          /* Remember I/O buffer count */
+                  node->frags = curfraglink;
+                }
+              else
+                {
+                  /* Insert this node after lastlink */
 
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
+                  lastlink->flink = curfraglink;
+                }
+
+              /* Remember I/O buffer count */
+
+              node->bufcnt += IOBUF_CNT(curfraglink->frag);
+              g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
+            }
         }
     }
   else
     {
       /* It's a new IP ID fragment, malloc a new node and insert it into the
-       * linked list
+       * hash table
        */
 
       node = kmm_malloc(sizeof(struct ip_fragsnode_s));
@@ -690,25 +724,15 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
       node->dev        = dev;
       node->ipid       = curfraglink->ipid;
       node->frags      = curfraglink;
+      node->fraglast   = curfraglink;
+      node->contiglink = NULL;
       node->tick       = clock_systime_ticks();
       node->bufcnt     = IOBUF_CNT(curfraglink->frag);
       g_bufoccupy     += IOBUF_CNT(curfraglink->frag);
       node->verifyflag = 0;
       node->outgoframe = NULL;
 
-      /* Insert this new node into linked list identified by
-       * g_assemblyhead_ipid with correct position
-       */
-
-      if (sq_peek(&g_assemblyhead_ipid) == NULL || entrylast == NULL)
-        {
-          sq_addfirst((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-        }
-      else
-        {
-          sq_addafter(entrylast, (FAR sq_entry_t *)node,
-                      &g_assemblyhead_ipid);
-        }
+      sq_addfirst((FAR sq_entry_t *)node, bucket);
 
       /* Add this new node to the tail of linked list identified by
        * g_assemblyhead_time
@@ -1117,13 +1141,14 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop those unassembled incoming fragments belonging to this NIC */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+        container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
       if (dev == node->dev)
@@ -1139,7 +1164,7 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
             }
 
           ip_frag_remnode(node);
-          kmm_free(entry);
+          kmm_free(node);
         }
 
       entry = entrynext;
@@ -1169,16 +1194,18 @@ void ip_frag_remallfrags(void)
   FAR sq_entry_t *entry = NULL;
   FAR sq_entry_t *entrynext;
   FAR struct net_driver_s *dev;
+  int i;
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop all unassembled incoming fragments */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+        container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
       if (node->frags != NULL)
@@ -1191,17 +1218,20 @@ void ip_frag_remallfrags(void)
             }
         }
 
-      /* Because nodes managed by the two queues are the same,
-       * and g_assemblyhead_ipid will be cleared after this loop ends,
-       * so only reset g_assemblyhead_time is needed after this loop ends
+      /* Because nodes managed by the hash table and the time queue are
+       * the same, just reset all of them after this loop ends
        */
 
-      sq_rem(entry, &g_assemblyhead_ipid);
-      kmm_free(entry);
+      kmm_free(node);
 
       entry = entrynext;
     }
 
+  for (i = 0; i < REASSEMBLY_NBUCKETS; i++)
+    {
+      sq_init(&g_assemblyhead_ipid[i]);
+    }
+
   sq_init(&g_assemblyhead_time);
   g_bufoccupy = 0;
 
@@ -1251,6 +1281,15 @@ int32_t ip_fragout(FAR struct net_driver_s *dev)
       return OK;
     }
 
+#ifdef CONFIG_NETDEV_GSO
+  /* TCP super-frames are segmented by the driver, not fragmented */
+
+  if (dev->d_gsosize > 0)
+    {
+      return OK;
+    }
+#endif
+
 #ifdef CONFIG_NET_6LOWPAN
   if (dev->d_lltype == NET_LL_IEEE802154 ||
       dev->d_lltype == NET_LL_PKTRADIO)
@@ -132,6 +132,19 @@ struct ip_fragsnode_s
 
   FAR struct ip_fraglink_s  *frags;
 
+  /* The fragment with the highest offset, fragments arriving in order are
+   * appended there without walking the list.
+   */
+
+  FAR struct ip_fraglink_s  *fraglast;
+
+  /* The last fragment of the run starting at offset zero where each one
+   * follows the previous one exactly, NULL if the zero fragment is missing.
+   * The datagram is complete when this is the tail fragment.
+   */
+
+  FAR struct ip_fraglink_s  *contiglink;
+
   /* Points to the reassembled outgoing IP frame */
 
   FAR struct iob_s          *outgoframe;
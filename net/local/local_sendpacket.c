@@ -29,6 +29,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <unistd.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -120,7 +121,7 @@ int local_send_preamble(FAR struct local_conn_s *conn,
 {
   FAR const struct iovec *end = buf + len;
   FAR const struct iovec *iov;
-  int ret;
+  uint8_t preamble[2 * sizeof(lc_size_t) + UNIX_PATH_MAX];
   lc_size_t pathlen;
   lc_size_t pktlen;
 
@@ -137,24 +138,16 @@ int local_send_preamble(FAR struct local_conn_s *conn,
       return -EMSGSIZE;
     }
 
-  pathlen = strlen(conn->lc_path);
-  ret = local_fifo_write(&conn->lc_outfile, (FAR const uint8_t *)&pathlen,
-                         sizeof(lc_size_t));
-  if (ret != sizeof(lc_size_t))
-    {
-      nerr("ERROR: local send path length failed ret: %d\n", ret);
-      return ret;
-    }
+  /* The path length, the packet length and the path go out in one write,
+   * so that the reader is only woken up once for them.
+   */
 
-  ret = local_fifo_write(filep, (FAR const uint8_t *)&pktlen,
-                         sizeof(lc_size_t));
-  if (ret != sizeof(lc_size_t))
-    {
-      return ret;
-    }
+  pathlen = strnlen(conn->lc_path, UNIX_PATH_MAX);
+  memcpy(preamble, &pathlen, sizeof(lc_size_t));
+  memcpy(preamble + sizeof(lc_size_t), &pktlen, sizeof(lc_size_t));
+  memcpy(preamble + 2 * sizeof(lc_size_t), conn->lc_path, pathlen);
 
-  return local_fifo_write(&conn->lc_outfile, (uint8_t *)conn->lc_path,
-                          pathlen);
+  return local_fifo_write(filep, preamble, 2 * sizeof(lc_size_t) + pathlen);
 }
 
 /****************************************************************************
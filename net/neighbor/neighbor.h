@@ -72,6 +72,64 @@ struct net_driver_s; /* Forward reference */
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr);
 
+/****************************************************************************
+ * Name: neighbor_hash_find
+ *
+ * Description:
+ *   Find an entry in the hashed Neighbor Table.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address to use in the lookup
+ *   lltype - The link layer type to match, a negative value matches any
+ *
+ * Returned Value:
+ *   The matching Neighbor Table entry, NULL if there is none.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPv6_NCONF_HASH > 0
+FAR struct neighbor_entry_s *neighbor_hash_find(const net_ipv6addr_t ipaddr,
+                                                int lltype);
+#endif
+
+/****************************************************************************
+ * Name: neighbor_hash_victim
+ *
+ * Description:
+ *   Return the entry to hold a new association, an unused entry if there
+ *   is one, otherwise the least recently used one.  The entry is removed
+ *   from the hash table until neighbor_hash_insert() is called.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPv6_NCONF_HASH > 0
+FAR struct neighbor_entry_s *neighbor_hash_victim(void);
+#endif
+
+/****************************************************************************
+ * Name: neighbor_hash_insert
+ *
+ * Description:
+ *   Hash an entry by its IPv6 address and make it the most recently used.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPv6_NCONF_HASH > 0
+void neighbor_hash_insert(FAR struct neighbor_entry_s *neighbor);
+#endif
+
+/****************************************************************************
+ * Name: neighbor_hash_touch
+ *
+ * Description:
+ *   Make an entry of the hash table the most recently used.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPv6_NCONF_HASH > 0
+void neighbor_hash_touch(FAR struct neighbor_entry_s *neighbor);
+#endif
+
 /****************************************************************************
  * Name: neighbor_add
  *
@@ -66,14 +66,37 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
   uint8_t lltype;
-  clock_t oldest_time;
   int     oldest_ndx;
   bool    found = false;
   bool    new_entry;
+#if CONFIG_NET_IPv6_NCONF_HASH > 0
+  FAR struct neighbor_entry_s *neighbor;
+#else
+  clock_t oldest_time;
   int     i;
+#endif
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
+#if CONFIG_NET_IPv6_NCONF_HASH > 0
+  /* Find the matching entry in its hash bucket, or take an unused or the
+   * least recently used entry.
+   */
+
+  lltype   = dev->d_lltype;
+  neighbor = neighbor_hash_find(ipaddr, lltype);
+  if (neighbor != NULL)
+    {
+      found = true;
+    }
+  else
+    {
+      neighbor = neighbor_hash_victim();
+    }
+
+  oldest_ndx = neighbor - g_neighbors;
+#else
+
   /* Find the matching entry, first unused entry, or the oldest used entry.
    * The unused entry will have ne_time == 0 and should generate the oldest
    * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
@@ -100,6 +123,7 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
           oldest_time = g_neighbors[i].ne_time;
         }
     }
+#endif
 
   /* When overwrite old entry, need to notify RTM_DELNEIGH */
 
@@ -128,6 +152,17 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
   memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
          g_neighbors[oldest_ndx].ne_addr.na_llsize);
 
+#if CONFIG_NET_IPv6_NCONF_HASH > 0
+  if (found)
+    {
+      neighbor_hash_touch(neighbor);
+    }
+  else
+    {
+      neighbor_hash_insert(neighbor);
+    }
+#endif
+
   /* Notify the new entry */
 
   if (new_entry)
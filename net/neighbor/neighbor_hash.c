@@ -0,0 +1,218 @@
+/****************************************************************************
+ * net/neighbor/neighbor_hash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+
+#include "neighbor/neighbor.h"
+
+#if CONFIG_NET_IPv6_NCONF_HASH > 0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The links of one Neighbor Table entry.  They are kept apart from
+ * struct neighbor_entry_s since that structure is also returned to users.
+ */
+
+struct neighbor_link_s
+{
+  sq_entry_t nl_hash;  /* Hash bucket link */
+  dq_entry_t nl_lru;   /* Least recently used order */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* g_neighbor_links[i] holds the links of g_neighbors[i].  g_neighbor_nused
+ * counts the entries that were ever used, the others are free.
+ */
+
+static struct neighbor_link_s
+g_neighbor_links[CONFIG_NET_IPv6_NCONF_ENTRIES];
+static sq_queue_t g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASH];
+static dq_queue_t g_neighbor_lru;
+static unsigned int g_neighbor_nused;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_bucket
+ *
+ * Description:
+ *   Return the hash bucket of an IPv6 address.
+ *
+ ****************************************************************************/
+
+static FAR sq_queue_t *neighbor_bucket(const net_ipv6addr_t ipaddr)
+{
+  uint16_t hash = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash ^= ipaddr[i];
+    }
+
+  hash ^= hash >> 8;
+  return &g_neighbor_hash[hash % CONFIG_NET_IPv6_NCONF_HASH];
+}
+
+/****************************************************************************
+ * Name: neighbor_link
+ *
+ * Description:
+ *   Return the links of a Neighbor Table entry.
+ *
+ ****************************************************************************/
+
+static inline FAR struct neighbor_link_s *
+neighbor_link(FAR struct neighbor_entry_s *neighbor)
+{
+  return &g_neighbor_links[neighbor - g_neighbors];
+}
+
+/****************************************************************************
+ * Name: neighbor_entry
+ *
+ * Description:
+ *   Return the Neighbor Table entry of some links.
+ *
+ ****************************************************************************/
+
+static inline FAR struct neighbor_entry_s *
+neighbor_entry(FAR struct neighbor_link_s *link)
+{
+  return &g_neighbors[link - g_neighbor_links];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_hash_find
+ *
+ * Description:
+ *   Find an entry in the hashed Neighbor Table.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address to use in the lookup
+ *   lltype - The link layer type to match, a negative value matches any
+ *
+ * Returned Value:
+ *   The matching Neighbor Table entry, NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *neighbor_hash_find(const net_ipv6addr_t ipaddr,
+                                                int lltype)
+{
+  FAR struct neighbor_entry_s *neighbor;
+  FAR sq_entry_t *entry;
+
+  sq_for_every(neighbor_bucket(ipaddr), entry)
+    {
+      neighbor = neighbor_entry(container_of(entry, struct neighbor_link_s,
+                                             nl_hash));
+      if ((lltype < 0 || neighbor->ne_addr.na_lltype == lltype) &&
+          net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
+        {
+          return neighbor;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: neighbor_hash_victim
+ *
+ * Description:
+ *   Return the entry to hold a new association, an unused entry if there
+ *   is one, otherwise the least recently used one.  The entry is removed
+ *   from the hash table until neighbor_hash_insert() is called.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry_s *neighbor_hash_victim(void)
+{
+  FAR struct neighbor_entry_s *neighbor;
+  FAR struct neighbor_link_s *link;
+
+  if (g_neighbor_nused < CONFIG_NET_IPv6_NCONF_ENTRIES)
+    {
+      return &g_neighbors[g_neighbor_nused++];
+    }
+
+  link     = container_of(dq_tail(&g_neighbor_lru), struct neighbor_link_s,
+                          nl_lru);
+  neighbor = neighbor_entry(link);
+
+  sq_rem(&link->nl_hash, neighbor_bucket(neighbor->ne_ipaddr));
+  dq_rem(&link->nl_lru, &g_neighbor_lru);
+  return neighbor;
+}
+
+/****************************************************************************
+ * Name: neighbor_hash_insert
+ *
+ * Description:
+ *   Hash an entry by its IPv6 address and make it the most recently used.
+ *
+ ****************************************************************************/
+
+void neighbor_hash_insert(FAR struct neighbor_entry_s *neighbor)
+{
+  FAR struct neighbor_link_s *link = neighbor_link(neighbor);
+
+  sq_addfirst(&link->nl_hash, neighbor_bucket(neighbor->ne_ipaddr));
+  dq_addfirst(&link->nl_lru, &g_neighbor_lru);
+}
+
+/****************************************************************************
+ * Name: neighbor_hash_touch
+ *
+ * Description:
+ *   Make an entry of the hash table the most recently used.
+ *
+ ****************************************************************************/
+
+void neighbor_hash_touch(FAR struct neighbor_entry_s *neighbor)
+{
+  FAR struct neighbor_link_s *link = neighbor_link(neighbor);
+
+  dq_rem(&link->nl_lru, &g_neighbor_lru);
+  dq_addfirst(&link->nl_lru, &g_neighbor_lru);
+}
+
+#endif /* CONFIG_NET_IPv6_NCONF_HASH > 0 */
@@ -56,5 +56,8 @@ void neighbor_update(const net_ipv6addr_t ipaddr)
   if (neighbor != NULL)
     {
       neighbor->ne_time = clock_systime_ticks();
+#if CONFIG_NET_IPv6_NCONF_HASH > 0
+      neighbor_hash_touch(neighbor);
+#endif
     }
 }
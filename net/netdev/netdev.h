@@ -34,11 +34,33 @@
 
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
+#include <nuttx/rcu.h>
 
 #ifdef CONFIG_NETDOWN_NOTIFIER
 #  include <nuttx/wqueue.h>
 #endif
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Lookups that only walk the device list use these.  With CONFIG_RCU they
+ * do not take the list lock at all; updaters still serialize on it and
+ * publish changes with netdev_list_assign().
+ */
+
+#ifdef CONFIG_RCU
+#  define netdev_list_read_lock()   rcu_read_lock()
+#  define netdev_list_read_unlock() rcu_read_unlock()
+#  define netdev_list_deref(p)      rcu_dereference(p)
+#  define netdev_list_assign(p, v)  rcu_assign_pointer(p, v)
+#else
+#  define netdev_list_read_lock()   netdev_list_lock()
+#  define netdev_list_read_unlock() netdev_list_unlock()
+#  define netdev_list_deref(p)      (p)
+#  define netdev_list_assign(p, v)  ((p) = (v))
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
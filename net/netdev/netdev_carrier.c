@@ -37,6 +37,7 @@
 #include <net/ethernet.h>
 #include <nuttx/net/netdev.h>
 
+#include "ipforward/ipforward.h"
 #include "ipfrag/ipfrag.h"
 #include "netdev/netdev.h"
 #include "netlink/netlink.h"
@@ -63,6 +64,7 @@ void netdev_carrier_on(FAR struct net_driver_s *dev)
   if (dev && !IFF_IS_RUNNING(dev->d_flags))
     {
       dev->d_flags |= IFF_RUNNING;
+      ipv4_fwdcache_flush();
       netlink_device_notify(dev);
     }
 }
@@ -84,6 +86,7 @@ void netdev_carrier_off(FAR struct net_driver_s *dev)
   if (dev && IFF_IS_RUNNING(dev->d_flags))
     {
       dev->d_flags &= ~IFF_RUNNING;
+      ipv4_fwdcache_flush();
       netlink_device_notify(dev);
 
 #ifdef CONFIG_NET_IPFRAG
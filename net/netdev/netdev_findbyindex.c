@@ -72,7 +72,7 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
 
 #endif
 
-  netdev_list_lock();
+  netdev_list_read_lock();
 
 #ifdef CONFIG_NETDEV_IFINDEX
   /* Check if this index has been assigned */
@@ -81,12 +81,13 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
     {
       /* This index has not been assigned */
 
-      netdev_list_unlock();
+      netdev_list_read_unlock();
       return NULL;
     }
 #endif
 
-  for (dev = g_netdevices; dev; dev = dev->flink)
+  for (dev = netdev_list_deref(g_netdevices); dev;
+       dev = netdev_list_deref(dev->flink))
     {
 #ifdef CONFIG_NETDEV_IFINDEX
       /* Check if the index matches the index assigned when the device was
@@ -104,12 +105,12 @@ FAR struct net_driver_s *netdev_findbyindex(int ifindex)
       if (++i == ifindex)
 #endif
         {
-          netdev_list_unlock();
+          netdev_list_read_unlock();
           return dev;
         }
     }
 
-  netdev_list_unlock();
+  netdev_list_read_unlock();
   return NULL;
 }
 
@@ -59,17 +59,18 @@ FAR struct net_driver_s *netdev_findbyname(FAR const char *ifname)
 
   if (ifname)
     {
-      netdev_list_lock();
-      for (dev = g_netdevices; dev; dev = dev->flink)
+      netdev_list_read_lock();
+      for (dev = netdev_list_deref(g_netdevices); dev;
+           dev = netdev_list_deref(dev->flink))
         {
           if (strcmp(ifname, dev->d_ifname) == 0)
             {
-              netdev_list_unlock();
+              netdev_list_read_unlock();
               return dev;
             }
         }
 
-      netdev_list_unlock();
+      netdev_list_read_unlock();
     }
 
   return NULL;
@@ -83,6 +83,7 @@
 #include "netdev/netdev.h"
 #include "devif/devif.h"
 #include "igmp/igmp.h"
+#include "ipforward/ipforward.h"
 #include "icmpv6/icmpv6.h"
 #include "route/route.h"
 #include "netlink/netlink.h"
@@ -779,6 +780,8 @@ static ssize_t net_ioctl_ifreq_arglen(uint8_t domain, int cmd)
       case SIOCSIFNAME:
       case SIOCGIFNAME:
       case SIOCGIFINDEX:
+      case SIOCSHWTSTAMP:
+      case SIOCGHWTSTAMP:
         return sizeof(struct ifreq);
 
       case SIOCSIFADDR:
@@ -947,6 +950,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
 
       case SIOCSIFNETMASK:  /* Set network mask */
         ioctl_set_ipv4addr(&dev->d_netmask, &req->ifr_addr);
+        ipv4_fwdcache_flush();
         break;
 #endif
 
@@ -1163,6 +1167,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
               }
 
             ioctl_set_ipv4addr(&dev->d_ipaddr, &req->ifr_addr);
+            ipv4_fwdcache_flush();
             netlink_device_notify_ipaddr(dev, RTM_NEWADDR, AF_INET,
                          &dev->d_ipaddr, net_ipv4_mask2pref(dev->d_netmask));
 
@@ -1194,6 +1199,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
             netlink_device_notify_ipaddr(dev, RTM_DELADDR, AF_INET,
                          &dev->d_ipaddr, net_ipv4_mask2pref(dev->d_netmask));
             dev->d_ipaddr = 0;
+            ipv4_fwdcache_flush();
           }
 #endif
 
@@ -1315,6 +1321,25 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
         break;
 #endif
 
+#if defined(CONFIG_NETDEV_IOCTL) && defined(CONFIG_NET_TIMESTAMPING)
+      case SIOCSHWTSTAMP:  /* Set hardware timestamping config */
+      case SIOCGHWTSTAMP:  /* Get hardware timestamping config */
+        if (req->ifr_data == NULL)
+          {
+            ret = -EINVAL;
+          }
+        else if (dev->d_ioctl)
+          {
+            ret = dev->d_ioctl(dev, cmd,
+                               (unsigned long)(uintptr_t)req->ifr_data);
+          }
+        else
+          {
+            ret = -EOPNOTSUPP;
+          }
+        break;
+#endif
+
       default:
         ret = -ENOTTY;
         break;
@@ -2052,6 +2077,7 @@ int netdev_ifup(FAR struct net_driver_s *dev)
               /* Mark the interface as up */
 
               dev->d_flags |= IFF_UP;
+              ipv4_fwdcache_flush();
 
               /* Update the driver status */
 
@@ -2086,6 +2112,7 @@ int netdev_ifdown(FAR struct net_driver_s *dev)
               /* Mark the interface as down */
 
               dev->d_flags &= ~(IFF_UP | IFF_RUNNING);
+              ipv4_fwdcache_flush();
 
               /* Update the driver status */
 
@@ -499,9 +499,8 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
           last = &((*last)->flink);
         }
 
-      *last = dev;
-
       dev->flink = NULL;
+      netdev_list_assign(*last, dev);
 
 #ifdef CONFIG_NET_IGMP
       /* Configure the device for IGMP support */
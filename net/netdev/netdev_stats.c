@@ -57,7 +57,10 @@
 void netdev_statistics_log(FAR void *arg)
 {
   FAR struct net_driver_s *dev = arg;
-  FAR struct netdev_statistics_s *stats = &dev->d_statistics;
+  FAR struct netdev_statistics_s *stats;
+  struct netdev_statistics_s total;
+
+  stats = netdev_statistics_get(dev, &total);
 
   stats_log("%s:T%" PRIu32 "/%" PRIu32 "(%" PRIu64 "B)" ",R"
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
@@ -84,18 +87,18 @@ void netdev_statistics_log(FAR void *arg)
 #endif
             , stats->rx_packets, stats->rx_bytes
 #ifdef CONFIG_NET_TCP
-            , g_netstats.tcp.sent, g_netstats.tcp.recv, g_netstats.tcp.drop
+            , NET_STATS(tcp.sent), NET_STATS(tcp.recv), NET_STATS(tcp.drop)
 #endif
 #ifdef CONFIG_NET_UDP
-            , g_netstats.udp.sent, g_netstats.udp.recv, g_netstats.udp.drop
+            , NET_STATS(udp.sent), NET_STATS(udp.recv), NET_STATS(udp.drop)
 #endif
 #ifdef CONFIG_NET_ICMP
-            , g_netstats.icmp.sent, g_netstats.icmp.recv,
-              g_netstats.icmp.drop
+            , NET_STATS(icmp.sent), NET_STATS(icmp.recv),
+              NET_STATS(icmp.drop)
 #endif
 #ifdef CONFIG_NET_ICMPv6
-            , g_netstats.icmpv6.sent, g_netstats.icmpv6.recv,
-              g_netstats.icmpv6.drop
+            , NET_STATS(icmpv6.sent), NET_STATS(icmpv6.recv),
+              NET_STATS(icmpv6.drop)
 #endif
             );
 }
@@ -37,6 +37,7 @@
 #include <net/ethernet.h>
 #include <nuttx/net/netdev.h>
 
+#include "ipforward/ipforward.h"
 #include "mld/mld.h"
 #include "utils/utils.h"
 #include "netdev/netdev.h"
@@ -136,22 +137,28 @@ int netdev_unregister(FAR struct net_driver_s *dev)
             {
               /* The entry was in the middle or at the end of the list */
 
-              prev->flink = curr->flink;
+              netdev_list_assign(prev->flink, curr->flink);
             }
           else
             {
               /* The entry was at the beginning of the list */
 
-              g_netdevices = curr->flink;
+              netdev_list_assign(g_netdevices, curr->flink);
             }
 
+#ifndef CONFIG_RCU
           curr->flink = NULL;
+#endif
         }
 
 #ifdef CONFIG_NETDEV_IFINDEX
       free_ifindex(dev->d_ifindex);
 #endif
 
+      /* Do not forward any more packets to the removed device */
+
+      ipv4_fwdcache_flush();
+
 #ifdef CONFIG_NET_MLD
       if ((dev->d_flags & IFF_MULTICAST) != 0)
         {
@@ -163,10 +170,20 @@ int netdev_unregister(FAR struct net_driver_s *dev)
 
       netdev_list_unlock();
 
+#ifdef CONFIG_RCU
+      /* Lookups may still be walking through the device:  wait for them
+       * before the caller is allowed to free it.
+       */
+
+      synchronize_rcu();
+      dev->flink = NULL;
+#endif
+
       nxrmutex_destroy(&dev->d_lock);
 
 #if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
-      work_cancel_sync(NETDEV_STATISTICS_WORK, &dev->d_statistics.logwork);
+      work_cancel_sync(NETDEV_STATISTICS_WORK,
+                       NETDEV_STATISTICS_LOGWORK(dev));
 #endif
 
 #ifdef CONFIG_NET_ETHERNET
@@ -178,6 +178,24 @@
  * Public Type Definitions
  ****************************************************************************/
 
+/* A dump that is produced in batches as the application reads it.  The
+ * dump function queues the next batch of responses and returns a positive
+ * value if more may follow, zero when the dump is complete or a negated
+ * errno value on failure.
+ */
+
+struct netlink_dump_s;
+typedef CODE int (*netlink_dump_t)(NETLINK_HANDLE handle,
+                                   FAR struct netlink_dump_s *dump);
+
+struct netlink_dump_s
+{
+  netlink_dump_t fn;                 /* Produces the next batch, or NULL */
+  struct nlmsghdr req;               /* Header of the dump request */
+  unsigned int pos;                  /* Entries dumped so far */
+  bool busy;                         /* A batch is being produced */
+};
+
 /* This connection structure describes the underlying state of the socket. */
 
 struct netlink_conn_s
@@ -202,6 +220,10 @@ struct netlink_conn_s
   /* Queued response data */
 
   sq_queue_t resplist;               /* Singly linked list of responses */
+
+  /* Dump in progress */
+
+  struct netlink_dump_s dump;
 };
 
 /* Standard attribute types to specify validation policy */
@@ -462,6 +484,40 @@ netlink_tryget_response(FAR struct netlink_conn_s *conn);
 int netlink_get_response(FAR struct netlink_conn_s *conn,
                          FAR struct netlink_response_s **response);
 
+/****************************************************************************
+ * Name: netlink_dump_start
+ *
+ * Description:
+ *   Start a dump that is produced in batches as the responses are read,
+ *   instead of queueing every entry at once.  The first batch is queued
+ *   before returning.
+ *
+ * Input Parameters:
+ *   handle - The handle previously provided to the sendto() implementation
+ *            for the protocol.
+ *   fn     - The function that queues each batch.
+ *   req    - The request message header.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBUSY if a dump is already in progress on this
+ *   connection.
+ *
+ ****************************************************************************/
+
+int netlink_dump_start(NETLINK_HANDLE handle, netlink_dump_t fn,
+                       FAR const struct nlmsghdr *req);
+
+/****************************************************************************
+ * Name: netlink_dump_continue
+ *
+ * Description:
+ *   Queue the next batch of the dump in progress, if any.  The NLMSG_DONE
+ *   terminator is queued once the dump is complete.
+ *
+ ****************************************************************************/
+
+void netlink_dump_continue(FAR struct netlink_conn_s *conn);
+
 /****************************************************************************
  * Name: netlink_check_response
  *
@@ -516,10 +516,107 @@ bool netlink_check_response(FAR struct netlink_conn_s *conn)
   DEBUGASSERT(conn != NULL);
 
   /* Check if the response is available.  It is not necessary to lock the
-   * network because the sq_peek() is an atomic operation.
+   * network because the sq_peek() is an atomic operation.  A dump in
+   * progress always has its next batch (or its terminator) to give.
    */
 
-  return (sq_peek(&conn->resplist) != NULL);
+  return (sq_peek(&conn->resplist) != NULL || conn->dump.fn != NULL);
+}
+
+/****************************************************************************
+ * Name: netlink_dump_start
+ *
+ * Description:
+ *   Start a dump that is produced in batches as the responses are read,
+ *   instead of queueing every entry at once.  The first batch is queued
+ *   before returning.
+ *
+ * Input Parameters:
+ *   handle - The handle previously provided to the sendto() implementation
+ *            for the protocol.
+ *   fn     - The function that queues each batch.
+ *   req    - The request message header.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBUSY if a dump is already in progress on this
+ *   connection.
+ *
+ ****************************************************************************/
+
+int netlink_dump_start(NETLINK_HANDLE handle, netlink_dump_t fn,
+                       FAR const struct nlmsghdr *req)
+{
+  FAR struct netlink_conn_s *conn = handle;
+
+  DEBUGASSERT(conn != NULL && fn != NULL && req != NULL);
+
+  netlink_lock();
+  if (conn->dump.fn != NULL)
+    {
+      netlink_unlock();
+      return -EBUSY;
+    }
+
+  conn->dump.fn   = fn;
+  conn->dump.req  = *req;
+  conn->dump.pos  = 0;
+  conn->dump.busy = false;
+  netlink_unlock();
+
+  netlink_dump_continue(conn);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netlink_dump_continue
+ *
+ * Description:
+ *   Queue the next batch of the dump in progress, if any.  The NLMSG_DONE
+ *   terminator is queued once the dump is complete.
+ *
+ *   The batch is produced without the netlink lock held, since the dump
+ *   functions take the network lock to walk their tables.
+ *
+ ****************************************************************************/
+
+void netlink_dump_continue(FAR struct netlink_conn_s *conn)
+{
+  netlink_dump_t fn;
+  int ret;
+
+  DEBUGASSERT(conn != NULL);
+
+  netlink_lock();
+  fn = conn->dump.fn;
+  if (fn == NULL || conn->dump.busy)
+    {
+      netlink_unlock();
+      return;
+    }
+
+  conn->dump.busy = true;
+  netlink_unlock();
+
+  ret = fn(conn, &conn->dump);
+  if (ret <= 0)
+    {
+      if (ret < 0)
+        {
+          nerr("ERROR: Dump failed after %u entries: %d\n",
+               conn->dump.pos, ret);
+        }
+
+      netlink_add_terminator(conn, &conn->dump.req, 0);
+    }
+
+  netlink_lock();
+  conn->dump.busy = false;
+  if (ret <= 0)
+    {
+      conn->dump.fn = NULL;
+    }
+
+  netlink_unlock();
 }
 
 /****************************************************************************
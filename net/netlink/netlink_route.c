@@ -46,6 +46,7 @@
 #include "netdev/netdev.h"
 #include "arp/arp.h"
 #include "net/if_arp.h"
+#include "ipforward/ipforward.h"
 #include "neighbor/neighbor.h"
 #include "route/route.h"
 #include "netlink/netlink.h"
@@ -222,6 +223,18 @@ struct nlroute_info_s
   FAR const struct nlroute_sendto_request_s *req;
 };
 
+/* State of one batch of a routing table dump */
+
+#ifndef CONFIG_NETLINK_DISABLE_GETROUTE
+struct nlroute_dump_s
+{
+  NETLINK_HANDLE handle;
+  FAR const struct nlmsghdr *req;    /* Header of the dump request */
+  unsigned int skip;                 /* Entries sent by earlier batches */
+  unsigned int count;                /* Entries added by this batch */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -755,7 +768,7 @@ static int netlink_get_neighborlist(NETLINK_HANDLE handle, int domain,
 #if defined(CONFIG_NET_IPv4) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
 static FAR struct netlink_response_s *
 netlink_get_ipv4_route(FAR const struct net_route_ipv4_s *route, int type,
-                       FAR const struct nlroute_sendto_request_s *req)
+                       FAR const struct nlmsghdr *req)
 {
   FAR struct getroute_recvfrom_ipv4resplist_s *alloc;
   FAR struct getroute_recvfrom_ipv4response_s *resp;
@@ -776,9 +789,9 @@ netlink_get_ipv4_route(FAR const struct net_route_ipv4_s *route, int type,
   resp                  = &alloc->payload;
   resp->hdr.nlmsg_len   = sizeof(struct getroute_recvfrom_ipv4response_s);
   resp->hdr.nlmsg_type  = type;
-  resp->hdr.nlmsg_flags = req ? req->hdr.nlmsg_flags : 0;
-  resp->hdr.nlmsg_seq   = req ? req->hdr.nlmsg_seq : 0;
-  resp->hdr.nlmsg_pid   = req ? req->hdr.nlmsg_pid : 0;
+  resp->hdr.nlmsg_flags = req ? req->nlmsg_flags : 0;
+  resp->hdr.nlmsg_seq   = req ? req->nlmsg_seq : 0;
+  resp->hdr.nlmsg_pid   = req ? req->nlmsg_pid : 0;
 
   resp->rte.rtm_family   = AF_INET;
   resp->rte.rtm_table    = RT_TABLE_MAIN;
@@ -812,10 +825,18 @@ netlink_get_ipv4_route(FAR const struct net_route_ipv4_s *route, int type,
 static int netlink_ipv4route_callback(FAR struct net_route_ipv4_s *route,
                                       FAR void *arg)
 {
-  FAR struct nlroute_info_s *info = arg;
+  FAR struct nlroute_dump_s *dump = arg;
   FAR struct netlink_response_s *resp;
 
-  resp = netlink_get_ipv4_route(route, RTM_NEWROUTE, info->req);
+  /* Skip the entries that earlier batches have already sent */
+
+  if (dump->skip > 0)
+    {
+      dump->skip--;
+      return OK;
+    }
+
+  resp = netlink_get_ipv4_route(route, RTM_NEWROUTE, dump->req);
   if (resp == NULL)
     {
       return -ENOENT;
@@ -823,8 +844,11 @@ static int netlink_ipv4route_callback(FAR struct net_route_ipv4_s *route,
 
   /* Finally, add the response to the list of pending responses */
 
-  netlink_add_response(info->handle, resp);
-  return OK;
+  netlink_add_response(dump->handle, resp);
+
+  /* Stop the walk once the batch is full */
+
+  return ++dump->count >= CONFIG_NETLINK_ROUTE_DUMP_BATCH ? 1 : OK;
 }
 #endif
 
@@ -837,26 +861,34 @@ static int netlink_ipv4route_callback(FAR struct net_route_ipv4_s *route,
  ****************************************************************************/
 
 #if defined(CONFIG_NET_IPv4) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
-static int netlink_list_ipv4_route(NETLINK_HANDLE handle,
-                              FAR const struct nlroute_sendto_request_s *req)
+static int netlink_ipv4route_dump(NETLINK_HANDLE handle,
+                                  FAR struct netlink_dump_s *cb)
 {
-  struct nlroute_info_s info;
+  struct nlroute_dump_s dump;
   int ret;
 
-  /* Visit each routing table entry */
+  /* Walk the routing table from the start, adding the entries that follow
+   * the ones already sent.
+   */
 
-  info.handle = handle;
-  info.req    = req;
+  dump.handle = handle;
+  dump.req    = &cb->req;
+  dump.skip   = cb->pos;
+  dump.count  = 0;
 
-  ret = net_foreachroute_ipv4(netlink_ipv4route_callback, &info);
-  if (ret < 0)
-    {
-      return ret;
-    }
+  ret = net_foreachroute_ipv4(netlink_ipv4route_callback, &dump);
+  cb->pos += dump.count;
+  return ret;
+}
 
-  /* Terminate the routing table */
+static int netlink_list_ipv4_route(NETLINK_HANDLE handle,
+                              FAR const struct nlroute_sendto_request_s *req)
+{
+  /* The routes are queued a batch at a time as they are read, so the
+   * table is not copied and locked in its entirety.
+   */
 
-  return netlink_add_terminator(handle, &req->hdr, 0);
+  return netlink_dump_start(handle, netlink_ipv4route_dump, &req->hdr);
 }
 #endif
 
@@ -871,7 +903,7 @@ static int netlink_list_ipv4_route(NETLINK_HANDLE handle,
 #if defined(CONFIG_NET_IPv6) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
 static FAR struct netlink_response_s *
 netlink_get_ipv6_route(FAR const struct net_route_ipv6_s *route, int type,
-                       FAR const struct nlroute_sendto_request_s *req)
+                       FAR const struct nlmsghdr *req)
 {
   FAR struct getroute_recvfrom_ipv6resplist_s *alloc;
   FAR struct getroute_recvfrom_ipv6response_s *resp;
@@ -892,9 +924,9 @@ netlink_get_ipv6_route(FAR const struct net_route_ipv6_s *route, int type,
   resp                  = &alloc->payload;
   resp->hdr.nlmsg_len   = sizeof(struct getroute_recvfrom_ipv6response_s);
   resp->hdr.nlmsg_type  = type;
-  resp->hdr.nlmsg_flags = req ? req->hdr.nlmsg_flags : 0;
-  resp->hdr.nlmsg_seq   = req ? req->hdr.nlmsg_seq : 0;
-  resp->hdr.nlmsg_pid   = req ? req->hdr.nlmsg_pid : 0;
+  resp->hdr.nlmsg_flags = req ? req->nlmsg_flags : 0;
+  resp->hdr.nlmsg_seq   = req ? req->nlmsg_seq : 0;
+  resp->hdr.nlmsg_pid   = req ? req->nlmsg_pid : 0;
 
   resp->rte.rtm_family   = AF_INET6;
   resp->rte.rtm_table    = RT_TABLE_MAIN;
@@ -931,10 +963,18 @@ netlink_get_ipv6_route(FAR const struct net_route_ipv6_s *route, int type,
 static int netlink_ipv6route_callback(FAR struct net_route_ipv6_s *route,
                                       FAR void *arg)
 {
-  FAR struct nlroute_info_s *info = arg;
+  FAR struct nlroute_dump_s *dump = arg;
   FAR struct netlink_response_s *resp;
 
-  resp = netlink_get_ipv6_route(route, RTM_NEWROUTE, info->req);
+  /* Skip the entries that earlier batches have already sent */
+
+  if (dump->skip > 0)
+    {
+      dump->skip--;
+      return OK;
+    }
+
+  resp = netlink_get_ipv6_route(route, RTM_NEWROUTE, dump->req);
   if (resp == NULL)
     {
       return -ENOENT;
@@ -942,9 +982,11 @@ static int netlink_ipv6route_callback(FAR struct net_route_ipv6_s *route,
 
   /* Finally, add the response to the list of pending responses */
 
-  netlink_add_response(info->handle, resp);
+  netlink_add_response(dump->handle, resp);
 
-  return OK;
+  /* Stop the walk once the batch is full */
+
+  return ++dump->count >= CONFIG_NETLINK_ROUTE_DUMP_BATCH ? 1 : OK;
 }
 #endif
 
@@ -957,26 +999,34 @@ static int netlink_ipv6route_callback(FAR struct net_route_ipv6_s *route,
  ****************************************************************************/
 
 #if defined(CONFIG_NET_IPv6) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
-static int netlink_list_ipv6_route(NETLINK_HANDLE handle,
-                              FAR const struct nlroute_sendto_request_s *req)
+static int netlink_ipv6route_dump(NETLINK_HANDLE handle,
+                                  FAR struct netlink_dump_s *cb)
 {
-  struct nlroute_info_s info;
+  struct nlroute_dump_s dump;
   int ret;
 
-  /* Visit each routing table entry */
+  /* Walk the routing table from the start, adding the entries that follow
+   * the ones already sent.
+   */
 
-  info.handle = handle;
-  info.req    = req;
+  dump.handle = handle;
+  dump.req    = &cb->req;
+  dump.skip   = cb->pos;
+  dump.count  = 0;
 
-  ret = net_foreachroute_ipv6(netlink_ipv6route_callback, &info);
-  if (ret < 0)
-    {
-      return ret;
-    }
+  ret = net_foreachroute_ipv6(netlink_ipv6route_callback, &dump);
+  cb->pos += dump.count;
+  return ret;
+}
 
-  /* Terminate the routing table */
+static int netlink_list_ipv6_route(NETLINK_HANDLE handle,
+                              FAR const struct nlroute_sendto_request_s *req)
+{
+  /* The routes are queued a batch at a time as they are read, so the
+   * table is not copied and locked in its entirety.
+   */
 
-  return netlink_add_terminator(handle, &req->hdr, 0);
+  return netlink_dump_start(handle, netlink_ipv6route_dump, &req->hdr);
 }
 #endif
 
@@ -1020,6 +1070,7 @@ static int netlink_new_ipv4addr(NETLINK_HANDLE handle,
   netdev_lock(dev);
   dev->d_ipaddr  = nla_get_in_addr(tb[IFA_LOCAL]);
   dev->d_netmask = make_mask(ifm->ifa_prefixlen);
+  ipv4_fwdcache_flush();
 
   netlink_device_notify_ipaddr(dev, RTM_NEWADDR, AF_INET, &dev->d_ipaddr,
                                ifm->ifa_prefixlen);
@@ -1122,6 +1173,7 @@ static int netlink_del_ipv4addr(NETLINK_HANDLE handle,
   netlink_device_notify_ipaddr(dev, RTM_DELADDR, AF_INET, &dev->d_ipaddr,
                                net_ipv4_mask2pref(dev->d_netmask));
   dev->d_ipaddr  = 0;
+  ipv4_fwdcache_flush();
 
   netdev_unlock(dev);
 
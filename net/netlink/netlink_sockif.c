@@ -687,6 +687,14 @@ static ssize_t netlink_recvmsg(FAR struct socket *psock,
   /* Find the response to this message.  The return value */
 
   entry = netlink_tryget_response(psock->s_conn);
+  if (entry == NULL)
+    {
+      /* Produce the next batch of a dump in progress */
+
+      netlink_dump_continue(psock->s_conn);
+      entry = netlink_tryget_response(psock->s_conn);
+    }
+
   if (entry == NULL)
     {
       conn = psock->s_conn;
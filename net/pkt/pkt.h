@@ -32,6 +32,7 @@
 #include <sys/types.h>
 
 #include <nuttx/net/net.h>
+#include <nuttx/wqueue.h>
 
 #ifdef CONFIG_NET_PKT
 
@@ -64,6 +65,42 @@ struct pkt_poll_s
   FAR struct devif_callback_s *cb;   /* Needed to teardown the poll */
 };
 
+#ifdef CONFIG_NET_PKT_MMAP
+/* The memory of the rings of a socket.  It is shared with the mappings of
+ * the application and freed with the last of the socket or the mappings.
+ */
+
+struct pkt_ringbuf_s
+{
+  FAR uint8_t  *area;      /* The receive ring followed by the transmit ring */
+  size_t        size;      /* Total size of the rings */
+  unsigned int  refs;      /* References by the socket and mappings */
+};
+
+/* State of one mapped ring */
+
+struct pkt_ring_s
+{
+  FAR uint8_t  *base;      /* First block, NULL if the ring is not set up */
+  uint32_t      blocksize; /* Size of a block */
+  uint32_t      nblocks;   /* Number of blocks */
+  uint32_t      framesize; /* TX: size of a frame */
+  uint32_t      nframes;   /* TX: number of frames */
+  uint32_t      privsize;  /* RX: private area at the start of a block */
+  uint32_t      head;      /* RX: block being filled, TX: next frame */
+
+  /* The block being filled by the receive ring */
+
+  uint32_t      offset;    /* Offset of the next frame, 0 if not opened */
+  uint32_t      last;      /* Offset of the last frame in the block */
+  uint32_t      npkts;     /* Number of frames in the block */
+  clock_t       tov;       /* Timeout to retire a block, in ticks */
+  uint64_t      seq;       /* Sequence number of the last retired block */
+  bool          losing;    /* Frames were dropped since the last block */
+  bool          frozen;    /* No free block at the last frame */
+};
+#endif
+
 struct pkt_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -98,12 +135,24 @@ struct pkt_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the PKT read-ahead data is retained.
-   *
-   * TODO: Maybe support PACKET_MMAP for further optimize.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
 
+#ifdef CONFIG_NET_PKT_MMAP
+  /* Mapped rings.  With a receive ring the frames are stored there
+   * instead of the read-ahead buffer.
+   */
+
+  FAR struct pkt_ringbuf_s *ringbuf;
+  struct pkt_ring_s  rxring;      /* Receive ring */
+  struct pkt_ring_s  txring;      /* Transmit ring */
+  struct work_s      rxwork;      /* Retires the receive block on timeout */
+  uint32_t           rxpackets;   /* PACKET_STATISTICS counters */
+  uint32_t           rxdrops;
+  uint32_t           rxfreeze;
+#endif
+
   FAR struct iob_s  *pendiob;     /* The iob currently being sent */
 
   /* The following is a list of poll structures of threads waiting for
@@ -400,6 +449,96 @@ int pkt_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds);
 ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags);
 
+#ifdef CONFIG_NET_PKT_MMAP
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Set up (or release if tp_block_nr is zero) the receive or the transmit
+ *   ring of a packet socket.  This must be done before the rings are
+ *   mapped.
+ *
+ * Input Parameters:
+ *   conn - The packet socket connection
+ *   tx   - true for the transmit ring, false for the receive ring
+ *   req  - The geometry of the ring
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+struct tpacket_req3; /* Forward reference */
+int pkt_ring_setup(FAR struct pkt_conn_s *conn, bool tx,
+                   FAR const struct tpacket_req3 *req);
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release the rings of a packet socket being closed.  Their memory stays
+ *   until the application unmaps it.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the rings of a packet socket, the receive ring first.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Store the received frame in the receive ring of a connection.
+ *
+ * Returned Value:
+ *   true if the connection has a receive ring, the frame is then either
+ *   stored or dropped.  false if the frame must be handled as usual.
+ *
+ * Assumptions:
+ *   Called from pkt_input() with the device locked.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_readable
+ *
+ * Description:
+ *   Return true if a block of the receive ring is owned by the
+ *   application.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_readable(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_sendmsg
+ *
+ * Description:
+ *   Send all the frames marked TP_STATUS_SEND_REQUEST in the transmit ring
+ *   if the message is empty, otherwise forward to pkt_sendmsg().
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                         int flags);
+#else
+#  define pkt_ring_free(conn)
+#  define pkt_ring_input(dev, conn) false
+#  define pkt_ring_readable(conn)   false
+#endif
+
 #ifdef CONFIG_NET_PKTPROTO_OPTIONS
 /****************************************************************************
  * Name: pkt_getsockopt
@@ -32,6 +32,8 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <netpacket/packet.h>
+
 #include <nuttx/net/net.h>
 #include <nuttx/net/pkt.h>
 
@@ -113,6 +115,43 @@ int pkt_getsockopt(FAR struct socket *psock, int level, int option,
           }
 #endif
 
+#ifdef CONFIG_NET_PKT_MMAP
+      case PACKET_VERSION:
+        if (*value_len < sizeof(int))
+          {
+            return -EINVAL;
+          }
+
+        *(FAR int *)value = TPACKET_V3;
+        *value_len        = sizeof(int);
+        break;
+
+      case PACKET_STATISTICS:
+        {
+          FAR struct pkt_conn_s *conn = psock->s_conn;
+          FAR struct tpacket_stats_v3 *stats = value;
+
+          if (*value_len < sizeof(struct tpacket_stats_v3))
+            {
+              return -EINVAL;
+            }
+
+          /* The counters are cleared by each read, as on Linux */
+
+          conn_lock(&conn->sconn);
+          stats->tp_packets      = conn->rxpackets;
+          stats->tp_drops        = conn->rxdrops;
+          stats->tp_freeze_q_cnt = conn->rxfreeze;
+          conn->rxpackets        = 0;
+          conn->rxdrops          = 0;
+          conn->rxfreeze         = 0;
+          conn_unlock(&conn->sconn);
+
+          *value_len = sizeof(struct tpacket_stats_v3);
+        }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized RAW PKT socket option: %d\n", option);
         ret = -ENOPROTOOPT;
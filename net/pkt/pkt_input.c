@@ -171,6 +171,14 @@ static int pkt_in(FAR struct net_driver_s *dev)
           return OK;
         }
 
+      /* Store the packet in the mapped receive ring, if there is one */
+
+      if (pkt_ring_input(dev, conn))
+        {
+          pkt_conn_list_unlock();
+          return OK;
+        }
+
 #if defined(CONFIG_NET_TIMESTAMP) && !defined(CONFIG_ARCH_HAVE_NETDEV_TIMESTAMP)
       /* Get system as timestamp if no hardware timestamp */
 
@@ -245,7 +245,8 @@ int pkt_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
   /* Check for read data availability now */
 
-  if (iob_peek_queue(&conn->readahead) != NULL)
+  if (iob_peek_queue(&conn->readahead) != NULL ||
+      pkt_ring_readable(conn))
     {
       /* Normal data may be read without blocking. */
 
@@ -0,0 +1,777 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "utils/utils.h"
+#include "pkt/pkt.h"
+
+#ifdef CONFIG_NET_PKT_MMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Blocks are retired after 8ms without filling up by default */
+
+#define PKT_RING_DEFAULT_TOV  8
+
+/* Offset of the frame data in a frame of the receive ring and of the
+ * transmit ring.
+ */
+
+#define PKT_RING_RXMAC        TPACKET_ALIGN(TPACKET3_HDRLEN)
+#define PKT_RING_TXDATA       TPACKET_ALIGN(sizeof(struct tpacket3_hdr))
+
+/* Offset of the private area in a block */
+
+#define PKT_RING_PRIV         TPACKET_ALIGN(sizeof(struct tpacket_block_desc))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Protects the reference counts of the ring buffers, which may outlive the
+ * socket when they are still mapped.
+ */
+
+static mutex_t g_pkt_ringbuf_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ringbuf_release
+ *
+ * Description:
+ *   Drop one reference on the memory of the rings, free it with the last.
+ *
+ ****************************************************************************/
+
+static void pkt_ringbuf_release(FAR struct pkt_ringbuf_s *rb)
+{
+  bool last;
+
+  nxmutex_lock(&g_pkt_ringbuf_lock);
+  last = --rb->refs == 0;
+  nxmutex_unlock(&g_pkt_ringbuf_lock);
+
+  if (last)
+    {
+      kumm_free(rb->area);
+      kmm_free(rb);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_munmap
+ *
+ * Description:
+ *   Undo pkt_ring_mmap() when the application unmaps the rings.
+ *
+ ****************************************************************************/
+
+static int pkt_ring_munmap(FAR struct task_group_s *group,
+                           FAR struct mm_map_entry_s *entry,
+                           FAR void *start, size_t length)
+{
+  FAR struct pkt_ringbuf_s *rb = entry->priv.p;
+  int ret;
+
+  /* Partial unmap is not supported */
+
+  if (start != entry->vaddr || length != entry->length)
+    {
+      return -EINVAL;
+    }
+
+  ret = mm_map_remove(get_group_mm(group), entry);
+  pkt_ringbuf_release(rb);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_block
+ *
+ * Description:
+ *   Return the descriptor of a block of the receive ring.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tpacket_block_desc *
+pkt_ring_block(FAR struct pkt_ring_s *ring, uint32_t index)
+{
+  return (FAR struct tpacket_block_desc *)
+         (ring->base + index * ring->blocksize);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_frame
+ *
+ * Description:
+ *   Return the header of a frame of the transmit ring.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tpacket3_hdr *
+pkt_ring_frame(FAR struct pkt_ring_s *ring, uint32_t index)
+{
+  uint32_t perblock = ring->blocksize / ring->framesize;
+
+  return (FAR struct tpacket3_hdr *)
+         (ring->base + (index / perblock) * ring->blocksize +
+          (index % perblock) * ring->framesize);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_notify
+ *
+ * Description:
+ *   Wake up the threads polling the socket for received data.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_notify(FAR struct pkt_conn_s *conn)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_PKT_NPOLLWAITERS; i++)
+    {
+      if (conn->pollinfo[i].conn != NULL)
+        {
+          poll_notify(&conn->pollinfo[i].fds, 1, POLLIN);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_retire
+ *
+ * Description:
+ *   Hand the block being filled over to the application.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_retire(FAR struct pkt_conn_s *conn, uint32_t status)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR struct tpacket_block_desc *desc = pkt_ring_block(ring, ring->head);
+  FAR struct tpacket3_hdr *last;
+
+  last = (FAR struct tpacket3_hdr *)((FAR uint8_t *)desc + ring->last);
+  last->tp_next_offset = 0;
+
+  desc->hdr.bh1.num_pkts  = ring->npkts;
+  desc->hdr.bh1.blk_len   = ring->offset;
+  desc->hdr.bh1.seq_num   = ++ring->seq;
+  desc->hdr.bh1.ts_last_pkt.ts_sec  = last->tp_sec;
+  desc->hdr.bh1.ts_last_pkt.ts_nsec = last->tp_nsec;
+
+  if (ring->losing)
+    {
+      status      |= TP_STATUS_LOSING;
+      ring->losing = false;
+    }
+
+  /* Make the content visible before the application may own the block */
+
+  SMP_WMB();
+  desc->hdr.bh1.block_status = TP_STATUS_USER | status;
+
+  ring->head   = (ring->head + 1) % ring->nblocks;
+  ring->offset = 0;
+
+  pkt_ring_notify(conn);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_open
+ *
+ * Description:
+ *   Start to fill the next block of the receive ring, if the application
+ *   released it.
+ *
+ ****************************************************************************/
+
+static bool pkt_ring_open(FAR struct pkt_ring_s *ring)
+{
+  FAR struct tpacket_block_desc *desc = pkt_ring_block(ring, ring->head);
+
+  if (desc->hdr.bh1.block_status != TP_STATUS_KERNEL)
+    {
+      return false;
+    }
+
+  SMP_RMB();
+
+  desc->version        = TPACKET_V3;
+  desc->offset_to_priv = PKT_RING_PRIV;
+  desc->hdr.bh1.num_pkts = 0;
+  desc->hdr.bh1.offset_to_first_pkt = PKT_RING_PRIV +
+                                      TPACKET_ALIGN(ring->privsize);
+
+  ring->offset = desc->hdr.bh1.offset_to_first_pkt;
+  ring->last   = ring->offset;
+  ring->npkts  = 0;
+  return true;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_timeout
+ *
+ * Description:
+ *   Retire the block being filled if no frame filled it up in time.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_timeout(FAR void *arg)
+{
+  FAR struct pkt_conn_s *conn = arg;
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+
+  conn_lock(&conn->sconn);
+
+  if (ring->base != NULL && ring->offset != 0 && ring->npkts > 0)
+    {
+      pkt_ring_retire(conn, TP_STATUS_BLK_TMO);
+    }
+
+  conn_unlock(&conn->sconn);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_check
+ *
+ * Description:
+ *   Validate the geometry of a ring and return its size.
+ *
+ ****************************************************************************/
+
+static int pkt_ring_check(FAR const struct tpacket_req3 *req, bool tx,
+                          FAR size_t *size)
+{
+  uint32_t minsize;
+
+  if (req->tp_block_size == 0 || req->tp_frame_size == 0 ||
+      req->tp_block_size % TPACKET_ALIGNMENT != 0 ||
+      req->tp_frame_size % TPACKET_ALIGNMENT != 0 ||
+      req->tp_frame_size < TPACKET3_HDRLEN ||
+      req->tp_frame_size > req->tp_block_size ||
+      req->tp_frame_nr != req->tp_block_size / req->tp_frame_size *
+                          req->tp_block_nr ||
+      req->tp_block_nr > SIZE_MAX / 2 / req->tp_block_size)
+    {
+      return -EINVAL;
+    }
+
+  /* A receive block must at least hold its header and one frame header */
+
+  minsize = PKT_RING_PRIV + TPACKET_ALIGN(req->tp_sizeof_priv) +
+            PKT_RING_RXMAC;
+  if (!tx && (req->tp_sizeof_priv > req->tp_block_size ||
+              minsize >= req->tp_block_size))
+    {
+      return -EINVAL;
+    }
+
+  *size = (size_t)req->tp_block_nr * req->tp_block_size;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Set up (or release if tp_block_nr is zero) the receive or the transmit
+ *   ring of a packet socket.  This must be done before the rings are
+ *   mapped.
+ *
+ * Input Parameters:
+ *   conn - The packet socket connection
+ *   tx   - true for the transmit ring, false for the receive ring
+ *   req  - The geometry of the ring
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setup(FAR struct pkt_conn_s *conn, bool tx,
+                   FAR const struct tpacket_req3 *req)
+{
+  FAR struct pkt_ring_s *ring = tx ? &conn->txring : &conn->rxring;
+  FAR struct pkt_ring_s *other = tx ? &conn->rxring : &conn->txring;
+  FAR struct pkt_ringbuf_s *oldrb;
+  FAR struct pkt_ringbuf_s *rb = NULL;
+  size_t othersize = (size_t)other->nblocks * other->blocksize;
+  size_t size = 0;
+  int ret;
+
+  if (req->tp_block_nr > 0)
+    {
+      ret = pkt_ring_check(req, tx, &size);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* The rings are only set up once, before they are mapped */
+
+  nxmutex_lock(&g_pkt_ringbuf_lock);
+  ret = (conn->ringbuf != NULL && conn->ringbuf->refs > 1) ||
+        (ring->base != NULL && req->tp_block_nr > 0) ? -EBUSY : OK;
+  nxmutex_unlock(&g_pkt_ringbuf_lock);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Both rings live in one area, so that they are mapped at once */
+
+  if (size + othersize > 0)
+    {
+      rb = kmm_zalloc(sizeof(*rb));
+      if (rb == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      rb->area = kumm_zalloc(size + othersize);
+      if (rb->area == NULL)
+        {
+          kmm_free(rb);
+          return -ENOMEM;
+        }
+
+      rb->size = size + othersize;
+      rb->refs = 1;
+    }
+
+  /* Stop the timer of the old receive ring before replacing it */
+
+  work_cancel_sync(LPWORK, &conn->rxwork);
+
+  conn_lock(&conn->sconn);
+
+  oldrb         = conn->ringbuf;
+  conn->ringbuf = rb;
+
+  memset(ring, 0, sizeof(*ring));
+  if (size > 0)
+    {
+      ring->blocksize = req->tp_block_size;
+      ring->nblocks   = req->tp_block_nr;
+      ring->framesize = req->tp_frame_size;
+      ring->nframes   = req->tp_frame_nr;
+      ring->privsize  = req->tp_sizeof_priv;
+      ring->tov       = MSEC2TICK(req->tp_retire_blk_tov > 0 ?
+                                  req->tp_retire_blk_tov :
+                                  PKT_RING_DEFAULT_TOV);
+    }
+
+  /* The content of the rings is lost, nobody could see it anyway */
+
+  if (conn->rxring.nblocks > 0)
+    {
+      conn->rxring.base   = rb->area;
+      conn->rxring.head   = 0;
+      conn->rxring.offset = 0;
+    }
+
+  if (conn->txring.nblocks > 0)
+    {
+      conn->txring.base = rb->area + (size_t)conn->rxring.nblocks *
+                                     conn->rxring.blocksize;
+      conn->txring.head = 0;
+    }
+
+  conn->rxpackets = 0;
+  conn->rxdrops   = 0;
+  conn->rxfreeze  = 0;
+
+  conn_unlock(&conn->sconn);
+
+  if (oldrb != NULL)
+    {
+      pkt_ringbuf_release(oldrb);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release the rings of a packet socket being closed.  Their memory stays
+ *   until the application unmaps it.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ringbuf_s *rb;
+
+  work_cancel_sync(LPWORK, &conn->rxwork);
+
+  conn_lock(&conn->sconn);
+  rb            = conn->ringbuf;
+  conn->ringbuf = NULL;
+  memset(&conn->rxring, 0, sizeof(conn->rxring));
+  memset(&conn->txring, 0, sizeof(conn->txring));
+  conn_unlock(&conn->sconn);
+
+  if (rb != NULL)
+    {
+      pkt_ringbuf_release(rb);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the rings of a packet socket, the receive ring first.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct pkt_ringbuf_s *rb;
+  int ret;
+
+  conn_lock(&conn->sconn);
+
+  rb = conn->ringbuf;
+  if (rb == NULL || map->offset != 0 || map->length != rb->size)
+    {
+      conn_unlock(&conn->sconn);
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&g_pkt_ringbuf_lock);
+  rb->refs++;
+  nxmutex_unlock(&g_pkt_ringbuf_lock);
+
+  conn_unlock(&conn->sconn);
+
+  map->vaddr  = rb->area;
+  map->priv.p = rb;
+  map->munmap = pkt_ring_munmap;
+
+  ret = mm_map_add(get_current_mm(), map);
+  if (ret < 0)
+    {
+      pkt_ringbuf_release(rb);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Store the received frame in the receive ring of a connection.
+ *
+ * Returned Value:
+ *   true if the connection has a receive ring, the frame is then either
+ *   stored or dropped.  false if the frame must be handled as usual.
+ *
+ * Assumptions:
+ *   Called from pkt_input() with the device locked.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR struct tpacket_block_desc *desc;
+  FAR struct tpacket3_hdr *hdr;
+  FAR struct sockaddr_ll *sll;
+  struct timespec ts;
+  uint32_t snaplen;
+  uint32_t first;
+
+  conn_lock(&conn->sconn);
+
+  if (ring->base == NULL)
+    {
+      conn_unlock(&conn->sconn);
+      return false;
+    }
+
+  conn->rxpackets++;
+
+  /* Truncate the frames that would not fit into an empty block */
+
+  first   = PKT_RING_PRIV + TPACKET_ALIGN(ring->privsize);
+  snaplen = MIN(dev->d_len, ring->blocksize - first - PKT_RING_RXMAC);
+
+  /* Retire the block being filled if the frame does not fit any more */
+
+  if (ring->offset != 0 &&
+      ring->offset + PKT_RING_RXMAC + snaplen > ring->blocksize)
+    {
+      pkt_ring_retire(conn, 0);
+    }
+
+  if (ring->offset == 0 && !pkt_ring_open(ring))
+    {
+      /* The application still owns all the blocks */
+
+      if (!ring->frozen)
+        {
+          ring->frozen = true;
+          conn->rxfreeze++;
+        }
+
+      ring->losing = true;
+      conn->rxdrops++;
+      conn_unlock(&conn->sconn);
+      return true;
+    }
+
+  ring->frozen = false;
+
+#if defined(CONFIG_NET_TIMESTAMP) && defined(CONFIG_ARCH_HAVE_NETDEV_TIMESTAMP)
+  ts = dev->d_rxtime;
+#else
+  clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+
+  desc = pkt_ring_block(ring, ring->head);
+  hdr  = (FAR struct tpacket3_hdr *)((FAR uint8_t *)desc + ring->offset);
+  memset(hdr, 0, PKT_RING_RXMAC);
+
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_nsec    = ts.tv_nsec;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_status  = TP_STATUS_USER;
+  hdr->tp_mac     = PKT_RING_RXMAC;
+  hdr->tp_net     = PKT_RING_RXMAC + NET_LL_HDRLEN(dev);
+
+  sll = (FAR struct sockaddr_ll *)((FAR uint8_t *)hdr +
+                                   TPACKET_ALIGN(sizeof(*hdr)));
+  sll->sll_family  = AF_PACKET;
+  sll->sll_ifindex = conn->ifindex;
+  sll->sll_hatype  = dev->d_lltype;
+
+#ifdef CONFIG_NET_ETHERNET
+  if (dev->d_lltype == NET_LL_ETHERNET && snaplen >= ETH_HDRLEN)
+    {
+      FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)NETLLBUF;
+
+      sll->sll_protocol = eth->type;
+      sll->sll_halen    = ETHER_ADDR_LEN;
+      memcpy(sll->sll_addr, eth->src, ETHER_ADDR_LEN);
+    }
+#endif
+
+  iob_copyout((FAR uint8_t *)hdr + PKT_RING_RXMAC, dev->d_iob, snaplen,
+              -NET_LL_HDRLEN(dev));
+
+  /* Link the frame behind the previous one of the block */
+
+  if (ring->npkts++ > 0)
+    {
+      FAR struct tpacket3_hdr *prev =
+        (FAR struct tpacket3_hdr *)((FAR uint8_t *)desc + ring->last);
+
+      prev->tp_next_offset = ring->offset - ring->last;
+    }
+  else
+    {
+      desc->hdr.bh1.ts_first_pkt.ts_sec  = ts.tv_sec;
+      desc->hdr.bh1.ts_first_pkt.ts_nsec = ts.tv_nsec;
+
+      /* Do not keep the first frame waiting for the block to fill up */
+
+      work_queue(LPWORK, &conn->rxwork, pkt_ring_timeout, conn, ring->tov);
+    }
+
+  ring->last    = ring->offset;
+  ring->offset += TPACKET_ALIGN(PKT_RING_RXMAC + snaplen);
+
+  conn_unlock(&conn->sconn);
+  return true;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_readable
+ *
+ * Description:
+ *   Return true if a block of the receive ring is owned by the
+ *   application.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_readable(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = &conn->rxring;
+  FAR struct tpacket_block_desc *desc;
+
+  if (ring->base == NULL)
+    {
+      return false;
+    }
+
+  /* Blocks are retired in order, the last one is just before the head */
+
+  desc = pkt_ring_block(ring, (ring->head + ring->nblocks - 1) %
+                              ring->nblocks);
+  return (desc->hdr.bh1.block_status & TP_STATUS_USER) != 0;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_sendmsg
+ *
+ * Description:
+ *   Send all the frames marked TP_STATUS_SEND_REQUEST in the transmit ring
+ *   if the message is empty, otherwise forward to pkt_sendmsg().
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                         int flags)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct pkt_ring_s *ring = &conn->txring;
+  FAR struct tpacket3_hdr *hdr;
+  struct msghdr frame;
+  struct iovec iov;
+  ssize_t total = 0;
+  ssize_t ret = 0;
+  uint32_t index;
+
+  if (ring->base == NULL ||
+      (msg->msg_iovlen > 0 && msg->msg_iov[0].iov_len > 0))
+    {
+      return pkt_sendmsg(psock, msg, flags);
+    }
+
+  memset(&frame, 0, sizeof(frame));
+  frame.msg_name    = msg->msg_name;
+  frame.msg_namelen = msg->msg_namelen;
+  frame.msg_iov     = &iov;
+  frame.msg_iovlen  = 1;
+
+  for (; ; )
+    {
+      /* Claim the next frame requested by the application */
+
+      conn_lock(&conn->sconn);
+
+      if (ring->base == NULL)
+        {
+          conn_unlock(&conn->sconn);
+          break;
+        }
+
+      index = ring->head;
+      hdr   = pkt_ring_frame(ring, index);
+      if (hdr->tp_status != TP_STATUS_SEND_REQUEST)
+        {
+          conn_unlock(&conn->sconn);
+          break;
+        }
+
+      SMP_RMB();
+
+      if (hdr->tp_len > ring->framesize - PKT_RING_TXDATA)
+        {
+          hdr->tp_status = TP_STATUS_WRONG_FORMAT;
+          conn_unlock(&conn->sconn);
+          ret = -EINVAL;
+          break;
+        }
+
+      hdr->tp_status = TP_STATUS_SENDING;
+      ring->head     = (index + 1) % ring->nframes;
+
+      conn_unlock(&conn->sconn);
+
+      /* The frame is copied out by the send, then released */
+
+      iov.iov_base = (FAR uint8_t *)hdr + PKT_RING_TXDATA;
+      iov.iov_len  = hdr->tp_len;
+
+      ret = pkt_sendmsg(psock, &frame, flags);
+      if (ret < 0)
+        {
+          /* Leave the frame to the next send() */
+
+          conn_lock(&conn->sconn);
+          if (ring->head == (index + 1) % ring->nframes)
+            {
+              ring->head = index;
+            }
+
+          hdr->tp_status = TP_STATUS_SEND_REQUEST;
+          conn_unlock(&conn->sconn);
+          break;
+        }
+
+      SMP_WMB();
+      hdr->tp_status = TP_STATUS_AVAILABLE;
+      total += ret;
+    }
+
+  return total > 0 ? total : ret;
+}
+
+#endif /* CONFIG_NET_PKT_MMAP */
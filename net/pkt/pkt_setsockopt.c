@@ -172,6 +172,35 @@ int pkt_setsockopt(FAR struct socket *psock, int level, int option,
         break;
 #endif
 
+#ifdef CONFIG_NET_PKT_MMAP
+      case PACKET_VERSION:
+
+        /* Only the TPACKET_V3 format of the rings is supported */
+
+        if (value_len != sizeof(int))
+          {
+            return -EINVAL;
+          }
+
+        if (*(FAR const int *)value != TPACKET_V3)
+          {
+            return -EINVAL;
+          }
+
+        break;
+
+      case PACKET_RX_RING:
+      case PACKET_TX_RING:
+        if (value_len < sizeof(struct tpacket_req3))
+          {
+            return -EINVAL;
+          }
+
+        ret = pkt_ring_setup(psock->s_conn, option == PACKET_TX_RING,
+                             (FAR const struct tpacket_req3 *)value);
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized PKT option: %d\n", option);
         ret = -ENOPROTOOPT;
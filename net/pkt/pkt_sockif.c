@@ -77,7 +77,11 @@ const struct sock_intf_s g_pkt_sockif =
   NULL,            /* si_connect */
   NULL,            /* si_accept */
   pkt_netpoll,     /* si_poll */
+#ifdef CONFIG_NET_PKT_MMAP
+  pkt_ring_sendmsg, /* si_sendmsg */
+#else
   pkt_sendmsg,     /* si_sendmsg */
+#endif
   pkt_recvmsg,     /* si_recvmsg */
   pkt_close,       /* si_close */
   NULL,            /* si_ioctl */
@@ -87,6 +91,12 @@ const struct sock_intf_s g_pkt_sockif =
   , pkt_getsockopt /* si_getsockopt */
   , pkt_setsockopt /* si_setsockopt */
 #endif
+#ifdef CONFIG_NET_PKT_MMAP
+#  ifdef CONFIG_NET_SENDFILE
+  , NULL           /* si_sendfile */
+#  endif
+  , pkt_ring_mmap  /* si_mmap */
+#endif
 };
 
 /****************************************************************************
@@ -395,6 +405,10 @@ static int pkt_close(FAR struct socket *psock)
 
               conn->crefs = 0;          /* No more references on the connection */
               conn_dev_unlock(&conn->sconn, dev);
+
+              /* Release the rings, they live until they are unmapped */
+
+              pkt_ring_free(conn);
               pkt_free(psock->s_conn);  /* Free network resources */
             }
           else
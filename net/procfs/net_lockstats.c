@@ -0,0 +1,163 @@
+/****************************************************************************
+ * net/procfs/net_lockstats.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Output format (times in perf_gettime() cycles):
+ *
+ *   Acquired: dddd Contended: dddd
+ *   Wait: dddd Max: dddd
+ *   Hold: dddd Max: dddd
+ *   Freq: dddd
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "utils/utils.h"
+#include "procfs/procfs.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET) && defined(CONFIG_NET_LOCK_STATS)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Line generating functions */
+
+static int netprocfs_lock_count(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_lock_wait(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_lock_hold(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_lock_freq(FAR struct netprocfs_file_s *netfile);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Line generating functions */
+
+static const linegen_t g_lock_linegen[] =
+{
+  netprocfs_lock_count,
+  netprocfs_lock_wait,
+  netprocfs_lock_hold,
+  netprocfs_lock_freq
+};
+
+#define NLOCK_LINES (sizeof(g_lock_linegen) / sizeof(linegen_t))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_lock_count
+ ****************************************************************************/
+
+static int netprocfs_lock_count(FAR struct netprocfs_file_s *netfile)
+{
+  struct net_lockstats_s stats;
+
+  net_lockstats(&stats);
+  return snprintf(netfile->line, NET_LINELEN,
+                  "Acquired: %" PRIu32 " Contended: %" PRIu32 "\n",
+                  stats.acquired, stats.contended);
+}
+
+/****************************************************************************
+ * Name: netprocfs_lock_wait
+ ****************************************************************************/
+
+static int netprocfs_lock_wait(FAR struct netprocfs_file_s *netfile)
+{
+  struct net_lockstats_s stats;
+
+  net_lockstats(&stats);
+  return snprintf(netfile->line, NET_LINELEN,
+                  "Wait: %" PRIu64 " Max: %" PRIu64 "\n",
+                  stats.waittime, (uint64_t)stats.waitmax);
+}
+
+/****************************************************************************
+ * Name: netprocfs_lock_hold
+ ****************************************************************************/
+
+static int netprocfs_lock_hold(FAR struct netprocfs_file_s *netfile)
+{
+  struct net_lockstats_s stats;
+
+  net_lockstats(&stats);
+  return snprintf(netfile->line, NET_LINELEN,
+                  "Hold: %" PRIu64 " Max: %" PRIu64 "\n",
+                  stats.holdtime, (uint64_t)stats.holdmax);
+}
+
+/****************************************************************************
+ * Name: netprocfs_lock_freq
+ ****************************************************************************/
+
+static int netprocfs_lock_freq(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN, "Freq: %lu\n",
+                  perf_getfreq());
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_lockstats
+ *
+ * Description:
+ *   Read and format network lock usage statistics.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which network status will be
+ *            returned.
+ *   buflen - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_lockstats(FAR struct netprocfs_file_s *priv,
+                                 FAR char *buffer, size_t buflen)
+{
+  return netprocfs_read_linegen(priv, buffer, buflen,
+                                g_lock_linegen, NLOCK_LINES);
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_NET && CONFIG_NET_LOCK_STATS */
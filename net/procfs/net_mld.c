@@ -113,9 +113,9 @@ static int netprocfs_joinleave(FAR struct netprocfs_file_s *netfile)
   int len;
 
   len  = snprintf(netfile->line, NET_LINELEN, "Joins: %04x ",
-                  g_netstats.mld.njoins);
+                  NET_STATS(mld.njoins));
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "Leaves: %04x\n",
-                  g_netstats.mld.nleaves);
+                  NET_STATS(mld.nleaves));
   return len;
 }
 
@@ -130,7 +130,7 @@ static int netprocfs_queries_sent(FAR struct netprocfs_file_s *netfile)
   len = snprintf(netfile->line, NET_LINELEN, "Sent       Sched Sent\n");
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "  Queries: %04x  %04x\n",
-                  g_netstats.mld.query_sched, g_netstats.mld.query_sent);
+                  NET_STATS(mld.query_sched), NET_STATS(mld.query_sent));
   return len;
 }
 
@@ -145,10 +145,10 @@ static int netprocfs_reports_sent(FAR struct netprocfs_file_s *netfile)
   len  = snprintf(netfile->line, NET_LINELEN, "  Reports:\n");
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    Ver 1: ----  %04x\n",
-                  g_netstats.mld.v1report_sent);
+                  NET_STATS(mld.v1report_sent));
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    Ver 2: %04x  %04x\n",
-                  g_netstats.mld.report_sched, g_netstats.mld.v2report_sent);
+                  NET_STATS(mld.report_sched), NET_STATS(mld.v2report_sent));
   return len;
 }
 
@@ -159,7 +159,7 @@ static int netprocfs_reports_sent(FAR struct netprocfs_file_s *netfile)
 static int netprocfs_done_sent(FAR struct netprocfs_file_s *netfile)
 {
   return snprintf(netfile->line, NET_LINELEN, "  Done:    %04x  %04x\n",
-                  g_netstats.mld.done_sched, g_netstats.mld.done_sent);
+                  NET_STATS(mld.done_sched), NET_STATS(mld.done_sent));
 }
 
 /****************************************************************************
@@ -175,10 +175,10 @@ static int netprocfs_queries_received_1(FAR struct netprocfs_file_s *netfile)
                   "  Queries:\n");
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    Gen:   %04x\n",
-                  g_netstats.mld.gm_query_received);
+                  NET_STATS(mld.gm_query_received));
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    MAS:   %04x\n",
-                  g_netstats.mld.mas_query_received);
+                  NET_STATS(mld.mas_query_received));
   return len;
 }
 
@@ -188,13 +188,13 @@ static int netprocfs_queries_received_2(FAR struct netprocfs_file_s *netfile)
 
   len  = snprintf(netfile->line, NET_LINELEN,
                   "    MASS:  %04x\n",
-                  g_netstats.mld.mass_query_received);
+                  NET_STATS(mld.mass_query_received));
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    Ucast: %04x\n",
-                  g_netstats.mld.ucast_query_received);
+                  NET_STATS(mld.ucast_query_received));
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    Bad:   %04x\n",
-                  g_netstats.mld.bad_query_received);
+                  NET_STATS(mld.bad_query_received));
   return len;
 }
 
@@ -209,10 +209,10 @@ static int netprocfs_reports_received(FAR struct netprocfs_file_s *netfile)
   len  = snprintf(netfile->line, NET_LINELEN, "  Reports:\n");
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    Ver 1: %04x\n",
-                  g_netstats.mld.v1report_received);
+                  NET_STATS(mld.v1report_received));
   len += snprintf(&netfile->line[len], NET_LINELEN - len,
                   "    Ver 2: %04x\n",
-                  g_netstats.mld.v2report_received);
+                  NET_STATS(mld.v2report_received));
   return len;
 }
 
@@ -223,7 +223,7 @@ static int netprocfs_reports_received(FAR struct netprocfs_file_s *netfile)
 static int netprocfs_done_received(FAR struct netprocfs_file_s *netfile)
 {
   return snprintf(netfile->line, NET_LINELEN , "  Done:    %04x\n",
-                  g_netstats.mld.done_received);
+                  NET_STATS(mld.done_received));
 }
 
 /****************************************************************************
@@ -139,6 +139,14 @@ static const struct netprocfs_entry_s g_net_entries[] =
   },
 #  endif
 #endif
+#ifdef CONFIG_NET_LOCK_STATS
+  {
+    DTYPE_FILE, "lock",
+    {
+      netprocfs_read_lockstats
+    }
+  },
+#endif
 #ifdef CONFIG_NET_ROUTE
   {
     DTYPE_DIRECTORY, "route",
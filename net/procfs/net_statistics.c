@@ -159,32 +159,32 @@ static int netprocfs_received(FAR struct netprocfs_file_s *netfile)
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "Received   ");
 #ifdef CONFIG_NET_IPv4
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv4.recv);
+                  NET_STATS(ipv4.recv));
 #endif
 #ifdef CONFIG_NET_IPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv6.recv);
+                  NET_STATS(ipv6.recv));
 #endif
 #ifdef CONFIG_NET_TCP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.tcp.recv);
+                  NET_STATS(tcp.recv));
 #endif
 #ifdef CONFIG_NET_UDP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.udp.recv);
+                  NET_STATS(udp.recv));
 #endif
 #ifdef CONFIG_NET_ICMP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmp.recv);
+                  NET_STATS(icmp.recv));
 #endif
 #ifdef CONFIG_NET_ICMPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmpv6.recv);
+                  NET_STATS(icmpv6.recv));
 #endif
 
 #ifdef CONFIG_NET_CAN
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.can.recv);
+                  NET_STATS(can.recv));
 #endif
 
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "\n");
@@ -204,31 +204,31 @@ static int netprocfs_dropped(FAR struct netprocfs_file_s *netfile)
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "Dropped    ");
 #ifdef CONFIG_NET_IPv4
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv4.drop);
+                  NET_STATS(ipv4.drop));
 #endif
 #ifdef CONFIG_NET_IPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv6.drop);
+                  NET_STATS(ipv6.drop));
 #endif
 #ifdef CONFIG_NET_TCP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.tcp.drop);
+                  NET_STATS(tcp.drop));
 #endif
 #ifdef CONFIG_NET_UDP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.udp.drop);
+                  NET_STATS(udp.drop));
 #endif
 #ifdef CONFIG_NET_ICMP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmp.drop);
+                  NET_STATS(icmp.drop));
 #endif
 #ifdef CONFIG_NET_ICMPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmpv6.drop);
+                  NET_STATS(icmpv6.drop));
 #endif
 #ifdef CONFIG_NET_CAN
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.can.drop);
+                  NET_STATS(can.drop));
 #endif
 
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "\n");
@@ -245,7 +245,7 @@ static int netprocfs_ipv4_dropped(FAR struct netprocfs_file_s *netfile)
 {
   return snprintf(netfile->line, NET_LINELEN,
                   "  IPv4        VHL: %04x   Frg: %04x\n",
-                  g_netstats.ipv4.vhlerr, g_netstats.ipv4.fragerr);
+                  NET_STATS(ipv4.vhlerr), NET_STATS(ipv4.fragerr));
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPv4 */
 
@@ -258,7 +258,7 @@ static int netprocfs_ipv6_dropped(FAR struct netprocfs_file_s *netfile)
 {
   return snprintf(netfile->line, NET_LINELEN,
                   "  IPv6        VHL: %04x\n",
-                  g_netstats.ipv6.vhlerr);
+                  NET_STATS(ipv6.vhlerr));
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPv6 */
 
@@ -274,18 +274,18 @@ static int netprocfs_checksum(FAR struct netprocfs_file_s *netfile)
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  Checksum ");
 #ifdef CONFIG_NET_IPv4
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv4.chkerr);
+                  NET_STATS(ipv4.chkerr));
 #endif
 #ifdef CONFIG_NET_IPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
 #endif
 #ifdef CONFIG_NET_TCP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.tcp.chkerr);
+                  NET_STATS(tcp.chkerr));
 #endif
 #ifdef CONFIG_NET_UDP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.udp.chkerr);
+                  NET_STATS(udp.chkerr));
 #endif
 #ifdef CONFIG_NET_ICMP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
@@ -311,7 +311,7 @@ static int netprocfs_tcp_dropped_1(FAR struct netprocfs_file_s *netfile)
 {
   return snprintf(netfile->line, NET_LINELEN,
                   "  TCP         ACK: %04x   SYN: %04x\n",
-                  g_netstats.tcp.ackerr, g_netstats.tcp.syndrop);
+                  NET_STATS(tcp.ackerr), NET_STATS(tcp.syndrop));
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
@@ -324,7 +324,7 @@ static int netprocfs_tcp_dropped_2(FAR struct netprocfs_file_s *netfile)
 {
   return snprintf(netfile->line, NET_LINELEN,
                   "              RST: %04x  %04x\n",
-                  g_netstats.tcp.rst, g_netstats.tcp.synrst);
+                  NET_STATS(tcp.rst), NET_STATS(tcp.synrst));
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
@@ -340,11 +340,11 @@ static int netprocfs_prototype(FAR struct netprocfs_file_s *netfile)
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  Type     ");
 #ifdef CONFIG_NET_IPv4
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv4.protoerr);
+                  NET_STATS(ipv4.protoerr));
 #endif
 #ifdef CONFIG_NET_IPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv6.protoerr);
+                  NET_STATS(ipv6.protoerr));
 #endif
 #ifdef CONFIG_NET_TCP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
@@ -354,11 +354,11 @@ static int netprocfs_prototype(FAR struct netprocfs_file_s *netfile)
 #endif
 #ifdef CONFIG_NET_ICMP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmp.typeerr);
+                  NET_STATS(icmp.typeerr));
 #endif
 #ifdef CONFIG_NET_ICMPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmpv6.typeerr);
+                  NET_STATS(icmpv6.typeerr));
 #endif
 #ifdef CONFIG_NET_CAN
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
@@ -381,31 +381,31 @@ static int netprocfs_sent(FAR struct netprocfs_file_s *netfile)
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "Sent       ");
 #ifdef CONFIG_NET_IPv4
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv4.sent);
+                  NET_STATS(ipv4.sent));
 #endif
 #ifdef CONFIG_NET_IPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.ipv6.sent);
+                  NET_STATS(ipv6.sent));
 #endif
 #ifdef CONFIG_NET_TCP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.tcp.sent);
+                  NET_STATS(tcp.sent));
 #endif
 #ifdef CONFIG_NET_UDP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.udp.sent);
+                  NET_STATS(udp.sent));
 #endif
 #ifdef CONFIG_NET_ICMP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmp.sent);
+                  NET_STATS(icmp.sent));
 #endif
 #ifdef CONFIG_NET_ICMPv6
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.icmpv6.sent);
+                  NET_STATS(icmpv6.sent));
 #endif
 #ifdef CONFIG_NET_CAN
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.can.sent);
+                  NET_STATS(can.sent));
 #endif
 
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "\n");
@@ -430,7 +430,7 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
 #endif
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
-                  g_netstats.tcp.rexmit);
+                  NET_STATS(tcp.rexmit));
 #ifdef CONFIG_NET_UDP
   len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
 #endif
@@ -94,7 +94,7 @@ static ssize_t netprocfs_tcpstats(FAR struct netprocfs_file_s *priv,
                       "    %2" PRIu8
                       ": %02" PRIx8
                       " %3" PRIx8 " %3" PRIu8
-                      " %3" PRIu8
+                      " %6" PRIu32
                       " %4" PRIu32
                       " %3" PRIu8
 #if CONFIG_NET_SEND_BUFSIZE > 0
@@ -161,7 +161,7 @@ ssize_t netprocfs_read_tcpstats(FAR struct netprocfs_file_s *priv,
       if (priv->offset == 0)
         {
           len = snprintf(buffer, buflen, "TCP sl  "
-                                         "st flg ref tmr uack nrt   "
+                                         "st flg ref    tmr uack nrt   "
 #if CONFIG_NET_SEND_BUFSIZE > 0
                                           "txsz   "
 #endif
@@ -426,10 +426,11 @@ static int netprocfs_rxstatistics(FAR struct netprocfs_file_s *netfile)
 {
   FAR struct netdev_statistics_s *stats;
   FAR struct net_driver_s *dev;
+  struct netdev_statistics_s total;
 
   DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
   dev = netfile->dev;
-  stats = &dev->d_statistics;
+  stats = netdev_statistics_get(dev, &total);
 
   return snprintf(netfile->line, NET_LINELEN, \
                   "\t    %08lx %08lx %08lx %-16llx\n",
@@ -486,11 +487,12 @@ static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile)
 {
   FAR struct netdev_statistics_s *stats;
   FAR struct net_driver_s *dev;
+  struct netdev_statistics_s total;
   FAR char *fmt;
 
   DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
   dev = netfile->dev;
-  stats = &dev->d_statistics;
+  stats = netdev_statistics_get(dev, &total);
 
   fmt = "\t    "
 #ifdef CONFIG_NET_IPv4
@@ -543,10 +545,11 @@ static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile)
 {
   FAR struct netdev_statistics_s *stats;
   FAR struct net_driver_s *dev;
+  struct netdev_statistics_s total;
 
   DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
   dev = netfile->dev;
-  stats = &dev->d_statistics;
+  stats = netdev_statistics_get(dev, &total);
 
   return snprintf(netfile->line, NET_LINELEN,
                   "\t    %08lx %08lx %08lx %08lx %-16llx \n",
@@ -567,10 +570,11 @@ static int netprocfs_errors(FAR struct netprocfs_file_s *netfile)
 {
   FAR struct netdev_statistics_s *stats;
   FAR struct net_driver_s *dev;
+  struct netdev_statistics_s total;
 
   DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
   dev = netfile->dev;
-  stats = &dev->d_statistics;
+  stats = netdev_statistics_get(dev, &total);
 
   return snprintf(netfile->line, NET_LINELEN,
                   "\tTotal Errors: %08" PRIx32 "\n\n",
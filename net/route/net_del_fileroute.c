@@ -38,6 +38,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
@@ -320,6 +321,7 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 
 errout_with_fshandle:
   net_closeroute_ipv4(&fshandle);
+  ipv4_fwdcache_flush();
 
 errout_with_lock:
   net_unlockroute_ipv4();
@@ -34,8 +34,10 @@
 #include <arpa/inet.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/ramroute.h"
+#include "route/trieroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -48,6 +50,10 @@
 struct route_match_ipv4_s
 {
   FAR struct net_route_ipv4_s *prev;     /* Predecessor in the list */
+  FAR struct net_route_ipv4_s *removed;  /* The entry that was removed */
+#ifdef ROUTE_IPv4_TRIE
+  FAR struct route_trie_node_s *retired; /* Trie nodes no longer used */
+#endif
   in_addr_t                    target;   /* The target IP address to match */
   in_addr_t                    netmask;  /* The network mask to match */
 };
@@ -57,6 +63,10 @@ struct route_match_ipv4_s
 struct route_match_ipv6_s
 {
   FAR struct net_route_ipv6_s *prev;     /* Predecessor in the list */
+  FAR struct net_route_ipv6_s *removed;  /* The entry that was removed */
+#ifdef ROUTE_IPv6_TRIE
+  FAR struct route_trie_node_s *retired; /* Trie nodes no longer used */
+#endif
   net_ipv6addr_t               target;   /* The target IP address to match */
   net_ipv6addr_t               netmask;  /* The network mask to match */
 };
@@ -113,11 +123,15 @@ static int net_del_ipv4route(FAR struct net_route_ipv4_s *route,
           ramroute_ipv4_remfirst(&g_ipv4_routes);
         }
 
+#ifdef ROUTE_IPv4_TRIE
+      match->retired = net_deltrie_ipv4(route);
+#endif
+
       netlink_route_notify(route, RTM_DELROUTE, AF_INET);
 
-      /* And free the routing table entry by adding it to the free list */
+      /* The caller frees the entry once no lookup can reference it */
 
-      net_freeroute_ipv4(route);
+      match->removed = route;
 
       /* Return a non-zero value to terminate the traversal */
 
@@ -171,11 +185,15 @@ static int net_del_ipv6route(FAR struct net_route_ipv6_s *route,
           ramroute_ipv6_remfirst(&g_ipv6_routes);
         }
 
+#ifdef ROUTE_IPv6_TRIE
+      match->retired = net_deltrie_ipv6(route);
+#endif
+
       netlink_route_notify(route, RTM_DELROUTE, AF_INET6);
 
-      /* And free the routing table entry by adding it to the free list */
+      /* The caller frees the entry once no lookup can reference it */
 
-      net_freeroute_ipv6(route);
+      match->removed = route;
 
       /* Return a non-zero value to terminate the traversal */
 
@@ -213,13 +231,38 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 
   /* Set up the comparison structure */
 
-  match.prev = NULL;
+  match.prev    = NULL;
+  match.removed = NULL;
+#ifdef ROUTE_IPv4_TRIE
+  match.retired = NULL;
+#endif
   net_ipv4addr_copy(match.target, target);
   net_ipv4addr_copy(match.netmask, netmask);
 
-  /* Then remove the entry from the routing table */
+  /* Then remove the entry from the routing table.  The network lock keeps
+   * other updaters out while lookups may still walk the table.
+   */
+
+  net_lock();
+  net_foreachroute_ipv4(net_del_ipv4route, &match);
+  ipv4_fwdcache_flush();
+  net_unlock();
+
+  if (match.removed == NULL)
+    {
+      return -ENOENT;
+    }
+
+  /* Free the routing table entry by adding it to the free list */
 
-  return net_foreachroute_ipv4(net_del_ipv4route, &match) ? OK : -ENOENT;
+#ifdef CONFIG_RCU
+  synchronize_rcu();
+#endif
+  net_freeroute_ipv4(match.removed);
+#ifdef ROUTE_IPv4_TRIE
+  net_freetrie(match.retired);
+#endif
+  return OK;
 }
 #endif
 
@@ -230,13 +273,37 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 
   /* Set up the comparison structure */
 
-  match.prev = NULL;
+  match.prev    = NULL;
+  match.removed = NULL;
+#ifdef ROUTE_IPv6_TRIE
+  match.retired = NULL;
+#endif
   net_ipv6addr_copy(match.target, target);
   net_ipv6addr_copy(match.netmask, netmask);
 
-  /* Then remove the entry from the routing table */
+  /* Then remove the entry from the routing table.  The network lock keeps
+   * other updaters out while lookups may still walk the table.
+   */
+
+  net_lock();
+  net_foreachroute_ipv6(net_del_ipv6route, &match);
+  net_unlock();
 
-  return net_foreachroute_ipv6(net_del_ipv6route, &match) ? OK : -ENOENT;
+  if (match.removed == NULL)
+    {
+      return -ENOENT;
+    }
+
+  /* Free the routing table entry by adding it to the free list */
+
+#ifdef CONFIG_RCU
+  synchronize_rcu();
+#endif
+  net_freeroute_ipv6(match.removed);
+#ifdef ROUTE_IPv6_TRIE
+  net_freetrie(match.retired);
+#endif
+  return OK;
 }
 #endif
 
@@ -68,23 +68,33 @@ int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg)
 
   /* Prevent concurrent access to the routing table */
 
+#ifdef CONFIG_RCU
+  rcu_read_lock();
+#else
   net_lock();
+#endif
 
   /* Visit each entry in the routing table */
 
-  for (route = g_ipv4_routes.head; ret == 0 && route != NULL; route = next)
+  for (route = ramroute_deref(g_ipv4_routes.head);
+       ret == 0 && route != NULL;
+       route = next)
     {
       /* Get the next entry in the to visit.  We do this BEFORE calling the
        * handler because the handler may delete this entry.
        */
 
-      next = route->flink;
+      next = ramroute_deref(route->flink);
       ret  = handler(&route->entry, arg);
     }
 
   /* Unlock the network */
 
+#ifdef CONFIG_RCU
+  rcu_read_unlock();
+#else
   net_unlock();
+#endif
   return ret;
 }
 #endif
@@ -98,23 +108,33 @@ int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
 
   /* Prevent concurrent access to the routing table */
 
+#ifdef CONFIG_RCU
+  rcu_read_lock();
+#else
   net_lock();
+#endif
 
   /* Visit each entry in the routing table */
 
-  for (route = g_ipv6_routes.head; ret == 0 && route != NULL; route = next)
+  for (route = ramroute_deref(g_ipv6_routes.head);
+       ret == 0 && route != NULL;
+       route = next)
     {
       /* Get the next entry in the to visit.  We do this BEFORE calling the
        * handler because the handler may delete this entry.
        */
 
-      next = route->flink;
+      next = ramroute_deref(route->flink);
       ret  = handler(&route->entry, arg);
     }
 
   /* Unlock the network */
 
+#ifdef CONFIG_RCU
+  rcu_read_unlock();
+#else
   net_unlock();
+#endif
   return ret;
 }
 #endif
@@ -57,13 +57,13 @@ void ramroute_ipv4_addlast(FAR struct net_route_ipv4_entry_s *entry,
   entry->flink = NULL;
   if (!list->head)
     {
-      list->head = entry;
+      ramroute_assign(list->head, entry);
       list->tail = entry;
     }
   else
     {
-      list->tail->flink = entry;
-      list->tail        = entry;
+      ramroute_assign(list->tail->flink, entry);
+      list->tail = entry;
     }
 }
 #endif
@@ -75,13 +75,13 @@ void ramroute_ipv6_addlast(FAR struct net_route_ipv6_entry_s *entry,
   entry->flink = NULL;
   if (!list->head)
     {
-      list->head = entry;
+      ramroute_assign(list->head, entry);
       list->tail = entry;
     }
   else
     {
-      list->tail->flink = entry;
-      list->tail        = entry;
+      ramroute_assign(list->tail->flink, entry);
+      list->tail = entry;
     }
 }
 #endif
@@ -110,13 +110,15 @@ ramroute_ipv4_remfirst(FAR struct net_route_ipv4_queue_s *list)
 
   if (ret)
     {
-      list->head = ret->flink;
+      ramroute_assign(list->head, ret->flink);
       if (!list->head)
         {
           list->tail = NULL;
         }
 
+#ifndef CONFIG_RCU
       ret->flink = NULL;
+#endif
     }
 
   return ret;
@@ -131,13 +133,15 @@ ramroute_ipv6_remfirst(FAR struct net_route_ipv6_queue_s *list)
 
   if (ret)
     {
-      list->head = ret->flink;
+      ramroute_assign(list->head, ret->flink);
       if (!list->head)
         {
           list->tail = NULL;
         }
 
+#ifndef CONFIG_RCU
       ret->flink = NULL;
+#endif
     }
 
   return ret;
@@ -173,14 +177,16 @@ ramroute_ipv4_remafter(FAR struct net_route_ipv4_entry_s *entry,
       if (list->tail == ret)
         {
           list->tail = entry;
-          entry->flink = NULL;
+          ramroute_assign(entry->flink, NULL);
         }
       else
         {
-          entry->flink = ret->flink;
+          ramroute_assign(entry->flink, ret->flink);
         }
 
+#ifndef CONFIG_RCU
       ret->flink = NULL;
+#endif
     }
 
   return ret;
@@ -199,14 +205,16 @@ ramroute_ipv6_remafter(FAR struct net_route_ipv6_entry_s *entry,
       if (list->tail == ret)
         {
           list->tail = entry;
-          entry->flink = NULL;
+          ramroute_assign(entry->flink, NULL);
         }
       else
         {
-          entry->flink = ret->flink;
+          ramroute_assign(entry->flink, ret->flink);
         }
 
+#ifndef CONFIG_RCU
       ret->flink = NULL;
+#endif
     }
 
   return ret;
@@ -0,0 +1,603 @@
+/****************************************************************************
+ * net/route/net_trieroute.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/trieroute.h"
+#include "route/ramroute.h"
+#include "route/route.h"
+#include "utils/utils.h"
+
+#if defined(ROUTE_IPv4_TRIE) || defined(ROUTE_IPv6_TRIE)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The roots of the tries, the index of g_ipv4_routes and g_ipv6_routes */
+
+#ifdef ROUTE_IPv4_TRIE
+static FAR struct route_trie_node_s *g_ipv4_trie;
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+static FAR struct route_trie_node_s *g_ipv6_trie;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: trie_bit
+ *
+ * Description:
+ *   Return bit "pos" of a key, counting from the most significant bit.
+ *
+ ****************************************************************************/
+
+static inline int trie_bit(FAR const uint8_t *key, unsigned int pos)
+{
+  return (key[pos >> 3] >> (7 - (pos & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: trie_matchlen
+ *
+ * Description:
+ *   Return the number of leading bits, up to maxlen, shared by two keys.
+ *
+ ****************************************************************************/
+
+static unsigned int trie_matchlen(FAR const uint8_t *a,
+                                  FAR const uint8_t *b,
+                                  unsigned int maxlen)
+{
+  unsigned int len = 0;
+
+  while (len + 8 <= maxlen && a[len >> 3] == b[len >> 3])
+    {
+      len += 8;
+    }
+
+  while (len < maxlen && trie_bit(a, len) == trie_bit(b, len))
+    {
+      len++;
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: trie_alloc
+ *
+ * Description:
+ *   Allocate a node for the first plen bits of key.
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_node_s *trie_alloc(FAR const uint8_t *key,
+                                                unsigned int plen,
+                                                FAR void *route)
+{
+  FAR struct route_trie_node_s *node;
+
+  node = kmm_zalloc(sizeof(struct route_trie_node_s));
+  if (node != NULL)
+    {
+      memcpy(node->key, key, (plen + 7) >> 3);
+      if ((plen & 7) != 0)
+        {
+          node->key[plen >> 3] &= 0xff << (8 - (plen & 7));
+        }
+
+      node->route   = route;
+      node->nroutes = route != NULL;
+      node->plen    = plen;
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: trie_insert
+ *
+ * Description:
+ *   Add the route of prefix "key/plen" to a trie.  If the prefix is already
+ *   present, the route indexed first is kept.
+ *
+ ****************************************************************************/
+
+static int trie_insert(FAR struct route_trie_node_s **root,
+                       FAR const uint8_t *key, unsigned int plen,
+                       FAR void *route)
+{
+  FAR struct route_trie_node_s **link = root;
+  FAR struct route_trie_node_s *node = *link;
+  FAR struct route_trie_node_s *branch;
+  FAR struct route_trie_node_s *leaf;
+  unsigned int common = 0;
+
+  /* Walk down as long as the node is a prefix of the new one */
+
+  while (node != NULL)
+    {
+      common = trie_matchlen(node->key, key, MIN(node->plen, plen));
+      if (common < node->plen)
+        {
+          break;
+        }
+
+      if (node->plen == plen)
+        {
+          if (node->route == NULL)
+            {
+              ramroute_assign(node->route, route);
+            }
+
+          node->nroutes++;
+          return OK;
+        }
+
+      link = &node->child[trie_bit(key, node->plen)];
+      node = *link;
+    }
+
+  leaf = trie_alloc(key, plen, route);
+  if (leaf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  if (node == NULL)
+    {
+      /* Append a new leaf */
+
+      ramroute_assign(*link, leaf);
+    }
+  else if (common == plen)
+    {
+      /* The new prefix covers the node, insert it above */
+
+      leaf->child[trie_bit(node->key, plen)] = node;
+      ramroute_assign(*link, leaf);
+    }
+  else
+    {
+      /* The prefixes diverge at bit "common", join them in a branch */
+
+      branch = trie_alloc(key, common, NULL);
+      if (branch == NULL)
+        {
+          kmm_free(leaf);
+          return -ENOMEM;
+        }
+
+      branch->child[trie_bit(key, common)]       = leaf;
+      branch->child[trie_bit(node->key, common)] = node;
+      ramroute_assign(*link, branch);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: trie_remove
+ *
+ * Description:
+ *   Remove the route of prefix "key/plen" from a trie.  If another route
+ *   of the table has the same prefix, it replaces the removed one.
+ *
+ *   Nodes are unlinked without touching their own links so that lookups
+ *   running concurrently can proceed, the caller frees them later.
+ *
+ ****************************************************************************/
+
+static FAR struct route_trie_node_s *
+trie_remove(FAR struct route_trie_node_s **root, FAR const uint8_t *key,
+            unsigned int plen, FAR void *route, FAR void *replace)
+{
+  FAR struct route_trie_node_s **plink = NULL;
+  FAR struct route_trie_node_s **link = root;
+  FAR struct route_trie_node_s *node = *link;
+  FAR struct route_trie_node_s *parent;
+  FAR struct route_trie_node_s *child;
+
+  while (node != NULL && node->plen < plen)
+    {
+      if (trie_matchlen(node->key, key, node->plen) < node->plen)
+        {
+          return NULL;
+        }
+
+      plink = link;
+      link  = &node->child[trie_bit(key, node->plen)];
+      node  = *link;
+    }
+
+  if (node == NULL || node->plen != plen || node->route == NULL ||
+      trie_matchlen(node->key, key, plen) < plen)
+    {
+      return NULL;
+    }
+
+  if (replace != NULL)
+    {
+      if (node->route == route)
+        {
+          ramroute_assign(node->route, replace);
+        }
+
+      node->nroutes--;
+      return NULL;
+    }
+
+  ramroute_assign(node->route, NULL);
+  node->nroutes = 0;
+
+  /* Keep the node as branch if it still has two children */
+
+  if (node->child[0] != NULL && node->child[1] != NULL)
+    {
+      return NULL;
+    }
+
+  child = node->child[0] != NULL ? node->child[0] : node->child[1];
+  ramroute_assign(*link, child);
+
+  /* A branch node left with only one child is removed too */
+
+  if (child == NULL && plink != NULL)
+    {
+      parent = *plink;
+      if (parent->route == NULL)
+        {
+          child = link == &parent->child[0] ? parent->child[1] :
+                                              parent->child[0];
+          ramroute_assign(*plink, child);
+          parent->retired = node;
+          return parent;
+        }
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_addtrie_ipv4 and net_addtrie_ipv6
+ *
+ * Description:
+ *   Index a new entry of the in-memory routing table.
+ *
+ * Input Parameters:
+ *   route - The route being added to the routing table
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EINVAL is returned if the netmask is
+ *   not contiguous and -ENOMEM if no trie node could be allocated.
+ *
+ * Assumptions:
+ *   The caller holds the network lock.
+ *
+ ****************************************************************************/
+
+#ifdef ROUTE_IPv4_TRIE
+int net_addtrie_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  uint8_t plen = net_ipv4_mask2pref(route->netmask);
+  in_addr_t mask = plen > 0 ? HTONL(0xffffffff << (32 - plen)) : 0;
+  in_addr_t key = route->target & mask;
+
+  if (!net_ipv4addr_cmp(route->netmask, mask))
+    {
+      nerr("ERROR: Netmask %08" PRIx32 " is not contiguous\n",
+           NTOHL(route->netmask));
+      return -EINVAL;
+    }
+
+  return trie_insert(&g_ipv4_trie, (FAR const uint8_t *)&key, plen, route);
+}
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+int net_addtrie_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  uint8_t plen = net_ipv6_mask2pref(route->netmask);
+  net_ipv6addr_t mask;
+  net_ipv6addr_t key;
+  int i;
+
+  net_ipv6_pref2mask(mask, plen);
+  if (!net_ipv6addr_cmp(route->netmask, mask))
+    {
+      nerr("ERROR: IPv6 netmask is not contiguous\n");
+      return -EINVAL;
+    }
+
+  for (i = 0; i < 8; i++)
+    {
+      key[i] = route->target[i] & mask[i];
+    }
+
+  return trie_insert(&g_ipv6_trie, (FAR const uint8_t *)key, plen, route);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_deltrie_ipv4 and net_deltrie_ipv6
+ *
+ * Description:
+ *   Remove an entry of the in-memory routing table from the trie.  The
+ *   entry must already be unlinked from the routing table.
+ *
+ * Input Parameters:
+ *   route - The route being removed from the routing table
+ *
+ * Returned Value:
+ *   The chain of trie nodes no longer in use, linked by their retired
+ *   field.  They must be released with net_freetrie() once no lookup can
+ *   reference them anymore.
+ *
+ * Assumptions:
+ *   The caller holds the network lock.
+ *
+ ****************************************************************************/
+
+#ifdef ROUTE_IPv4_TRIE
+FAR struct route_trie_node_s *
+net_deltrie_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  FAR struct net_route_ipv4_entry_s *entry;
+  FAR struct net_route_ipv4_s *replace = NULL;
+  in_addr_t key = route->target & route->netmask;
+
+  /* Look for another route of the same prefix to take over */
+
+  for (entry = g_ipv4_routes.head; entry != NULL; entry = entry->flink)
+    {
+      if (net_ipv4addr_cmp(entry->entry.netmask, route->netmask) &&
+          net_ipv4addr_maskcmp(entry->entry.target, route->target,
+                               route->netmask))
+        {
+          replace = &entry->entry;
+          break;
+        }
+    }
+
+  return trie_remove(&g_ipv4_trie, (FAR const uint8_t *)&key,
+                     net_ipv4_mask2pref(route->netmask), route, replace);
+}
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+FAR struct route_trie_node_s *
+net_deltrie_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  FAR struct net_route_ipv6_entry_s *entry;
+  FAR struct net_route_ipv6_s *replace = NULL;
+  net_ipv6addr_t key;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      key[i] = route->target[i] & route->netmask[i];
+    }
+
+  /* Look for another route of the same prefix to take over */
+
+  for (entry = g_ipv6_routes.head; entry != NULL; entry = entry->flink)
+    {
+      if (net_ipv6addr_cmp(entry->entry.netmask, route->netmask) &&
+          net_ipv6addr_maskcmp(entry->entry.target, route->target,
+                               route->netmask))
+        {
+          replace = &entry->entry;
+          break;
+        }
+    }
+
+  return trie_remove(&g_ipv6_trie, (FAR const uint8_t *)key,
+                     net_ipv6_mask2pref(route->netmask), route, replace);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_foreachtrie_ipv4 and net_foreachtrie_ipv6
+ *
+ * Description:
+ *   Visit the routes whose prefix matches the target address, from the
+ *   shortest prefix to the longest one.
+ *
+ * Input Parameters:
+ *   target  - The address to look up
+ *   handler - Will be called for each matching route
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if all matching routes were visited.  Handlers may
+ *   terminate the search early with any non-zero, non-negative value.
+ *
+ ****************************************************************************/
+
+#ifdef ROUTE_IPv4_TRIE
+int net_foreachtrie_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                         FAR void *arg)
+{
+  FAR const uint8_t *key = (FAR const uint8_t *)&target;
+  FAR struct net_route_ipv4_entry_s *entry;
+  FAR struct route_trie_node_s *node;
+  FAR struct net_route_ipv4_s *route;
+  int ret = 0;
+
+#ifdef CONFIG_RCU
+  rcu_read_lock();
+#else
+  net_lock();
+#endif
+
+  node = ramroute_deref(g_ipv4_trie);
+  while (ret == 0 && node != NULL &&
+         trie_matchlen(node->key, key, node->plen) == node->plen)
+    {
+      route = ramroute_deref(node->route);
+      if (route != NULL && node->nroutes > 1)
+        {
+          /* Several routes share the prefix, let the handler see all */
+
+          for (entry = ramroute_deref(g_ipv4_routes.head);
+               ret == 0 && entry != NULL;
+               entry = ramroute_deref(entry->flink))
+            {
+              if (net_ipv4addr_cmp(entry->entry.netmask, route->netmask) &&
+                  net_ipv4addr_maskcmp(entry->entry.target, route->target,
+                                       route->netmask))
+                {
+                  ret = handler(&entry->entry, arg);
+                }
+            }
+        }
+      else if (route != NULL)
+        {
+          ret = handler(route, arg);
+        }
+
+      if (node->plen >= 32)
+        {
+          break;
+        }
+
+      node = ramroute_deref(node->child[trie_bit(key, node->plen)]);
+    }
+
+#ifdef CONFIG_RCU
+  rcu_read_unlock();
+#else
+  net_unlock();
+#endif
+
+  return ret;
+}
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+int net_foreachtrie_ipv6(FAR const uint16_t *target,
+                         route_handler_ipv6_t handler, FAR void *arg)
+{
+  FAR const uint8_t *key = (FAR const uint8_t *)target;
+  FAR struct net_route_ipv6_entry_s *entry;
+  FAR struct route_trie_node_s *node;
+  FAR struct net_route_ipv6_s *route;
+  int ret = 0;
+
+#ifdef CONFIG_RCU
+  rcu_read_lock();
+#else
+  net_lock();
+#endif
+
+  node = ramroute_deref(g_ipv6_trie);
+  while (ret == 0 && node != NULL &&
+         trie_matchlen(node->key, key, node->plen) == node->plen)
+    {
+      route = ramroute_deref(node->route);
+      if (route != NULL && node->nroutes > 1)
+        {
+          /* Several routes share the prefix, let the handler see all */
+
+          for (entry = ramroute_deref(g_ipv6_routes.head);
+               ret == 0 && entry != NULL;
+               entry = ramroute_deref(entry->flink))
+            {
+              if (net_ipv6addr_cmp(entry->entry.netmask, route->netmask) &&
+                  net_ipv6addr_maskcmp(entry->entry.target, route->target,
+                                       route->netmask))
+                {
+                  ret = handler(&entry->entry, arg);
+                }
+            }
+        }
+      else if (route != NULL)
+        {
+          ret = handler(route, arg);
+        }
+
+      if (node->plen >= 128)
+        {
+          break;
+        }
+
+      node = ramroute_deref(node->child[trie_bit(key, node->plen)]);
+    }
+
+#ifdef CONFIG_RCU
+  rcu_read_unlock();
+#else
+  net_unlock();
+#endif
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: net_freetrie
+ *
+ * Description:
+ *   Free a chain of nodes returned by net_deltrie_ipv4/ipv6().
+ *
+ * Input Parameters:
+ *   nodes - The first node of the chain, may be NULL
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void net_freetrie(FAR struct route_trie_node_s *nodes)
+{
+  FAR struct route_trie_node_s *next;
+
+  for (; nodes != NULL; nodes = next)
+    {
+      next = nodes->retired;
+      kmm_free(nodes);
+    }
+}
+
+#endif /* ROUTE_IPv4_TRIE || ROUTE_IPv6_TRIE */
@@ -29,6 +29,8 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/rcu.h>
+
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -47,6 +49,20 @@
 #  define CONFIG_ROUTE_MAX_IPv6_RAMROUTES 4
 #endif
 
+/* With CONFIG_RCU the routing tables are traversed without the network
+ * lock.  Updaters still hold the network lock, publish every link with
+ * ramroute_assign() and keep the link of a removed entry intact until a
+ * grace period has elapsed.
+ */
+
+#ifdef CONFIG_RCU
+#  define ramroute_deref(p)     rcu_dereference(p)
+#  define ramroute_assign(p, v) rcu_assign_pointer(p, v)
+#else
+#  define ramroute_deref(p)     (p)
+#  define ramroute_assign(p, v) ((p) = (v))
+#endif
+
 /* Routing table initializer */
 
 #define ramroute_init(rr) \
@@ -0,0 +1,186 @@
+/****************************************************************************
+ * net/route/trieroute.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_TRIEROUTE_H
+#define __NET_ROUTE_TRIEROUTE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include "route/ramroute.h"
+#include "route/route.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The trie only indexes the in-memory routing tables */
+
+#if defined(CONFIG_ROUTE_TRIE) && defined(CONFIG_ROUTE_IPv4_RAMROUTE)
+#  define ROUTE_IPv4_TRIE 1
+#endif
+
+#if defined(CONFIG_ROUTE_TRIE) && defined(CONFIG_ROUTE_IPv6_RAMROUTE)
+#  define ROUTE_IPv6_TRIE 1
+#endif
+
+#if defined(ROUTE_IPv4_TRIE) || defined(ROUTE_IPv6_TRIE)
+
+/* Length of the key in bytes, large enough for the widest address */
+
+#ifdef ROUTE_IPv6_TRIE
+#  define ROUTE_TRIE_KEYLEN 16
+#else
+#  define ROUTE_TRIE_KEYLEN 4
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One node of a path-compressed binary trie.  A node holds the prefix
+ * "key/plen" and branches on bit "plen" of the address; the chain of single
+ * child nodes of a plain binary trie is skipped.  A node either carries the
+ * route of its prefix or is a branch node with two children.
+ */
+
+struct route_trie_node_s
+{
+  FAR struct route_trie_node_s *child[2]; /* Longer prefixes, by next bit */
+  FAR struct route_trie_node_s *retired;  /* Next node waiting to be freed */
+  FAR void *route;                        /* Route of this prefix or NULL */
+  uint16_t nroutes;                       /* Routes sharing this prefix */
+  uint8_t plen;                           /* Prefix length in bits */
+  uint8_t key[ROUTE_TRIE_KEYLEN];         /* Prefix, network order */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_addtrie_ipv4 and net_addtrie_ipv6
+ *
+ * Description:
+ *   Index a new entry of the in-memory routing table.
+ *
+ * Input Parameters:
+ *   route - The route being added to the routing table
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EINVAL is returned if the netmask is
+ *   not contiguous and -ENOMEM if no trie node could be allocated.
+ *
+ * Assumptions:
+ *   The caller holds the network lock.
+ *
+ ****************************************************************************/
+
+#ifdef ROUTE_IPv4_TRIE
+int net_addtrie_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+int net_addtrie_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_deltrie_ipv4 and net_deltrie_ipv6
+ *
+ * Description:
+ *   Remove an entry of the in-memory routing table from the trie.  The
+ *   entry must already be unlinked from the routing table.
+ *
+ * Input Parameters:
+ *   route - The route being removed from the routing table
+ *
+ * Returned Value:
+ *   The chain of trie nodes no longer in use, linked by their retired
+ *   field.  They must be released with net_freetrie() once no lookup can
+ *   reference them anymore.
+ *
+ * Assumptions:
+ *   The caller holds the network lock.
+ *
+ ****************************************************************************/
+
+#ifdef ROUTE_IPv4_TRIE
+FAR struct route_trie_node_s *
+net_deltrie_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+FAR struct route_trie_node_s *
+net_deltrie_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_foreachtrie_ipv4 and net_foreachtrie_ipv6
+ *
+ * Description:
+ *   Visit the routes whose prefix matches the target address, from the
+ *   shortest prefix to the longest one.
+ *
+ * Input Parameters:
+ *   target  - The address to look up
+ *   handler - Will be called for each matching route
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if all matching routes were visited.  Handlers may
+ *   terminate the search early with any non-zero, non-negative value.
+ *
+ ****************************************************************************/
+
+#ifdef ROUTE_IPv4_TRIE
+int net_foreachtrie_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                         FAR void *arg);
+#endif
+
+#ifdef ROUTE_IPv6_TRIE
+int net_foreachtrie_ipv6(FAR const uint16_t *target,
+                         route_handler_ipv6_t handler, FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Name: net_freetrie
+ *
+ * Description:
+ *   Free a chain of nodes returned by net_deltrie_ipv4/ipv6().
+ *
+ * Input Parameters:
+ *   nodes - The first node of the chain, may be NULL
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void net_freetrie(FAR struct route_trie_node_s *nodes);
+
+#endif /* ROUTE_IPv4_TRIE || ROUTE_IPv6_TRIE */
+#endif /* __NET_ROUTE_TRIEROUTE_H */
@@ -42,6 +42,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/net/ioctl.h>
 
 #include <netinet/in.h>
 #include <netpacket/rpmsg.h>
@@ -89,6 +90,16 @@ begin_packed_struct struct rpmsg_socket_shutdown_s
   uint32_t                       how;
 } end_packed_struct;
 
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+struct rpmsg_socket_rxbuf_s
+{
+  FAR void                       *msg;  /* Held rpmsg buffer, NULL if released */
+  FAR uint8_t                    *data; /* Payload not yet consumed */
+  uint32_t                       len;   /* Length of payload at data */
+  uint32_t                       size;  /* Window space the buffer takes */
+};
+#endif
+
 struct rpmsg_socket_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -142,6 +153,24 @@ struct rpmsg_socket_conn_s
 
   uint32_t                       recvpos;
   uint32_t                       lastpos;
+
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+  /* Zero-copy, the reserved tx buffer (protected by sendlock) */
+
+  FAR struct rpmsg_socket_data_s *txbuf;
+  uint32_t                       txlen;
+
+  /* Zero-copy, the held rx buffers (protected by recvlock).  rxnheld
+   * buffers starting at rxhead are held, the first rxndeliv of them were
+   * handed to the application.
+   */
+
+  bool                           zerocopy;
+  uint8_t                        rxhead;
+  uint8_t                        rxnheld;
+  uint8_t                        rxndeliv;
+  struct rpmsg_socket_rxbuf_s    rxbufs[CONFIG_NET_RPMSG_ZEROCOPY_NRXBUFS];
+#endif
 };
 
 /****************************************************************************
@@ -303,7 +332,7 @@ static int rpmsg_socket_wakeup(FAR struct rpmsg_socket_conn_s *conn)
   nxmutex_lock(&conn->recvlock);
   space = conn->recvpos - conn->lastpos;
 
-  if (space > circbuf_size(&conn->recvbuf) / 2)
+  if (space > conn->recvsize / 2)
     {
       conn->lastpos = conn->recvpos;
       msg.cmd = RPMSG_SOCKET_CMD_DATA;
@@ -322,6 +351,135 @@ rpmsg_socket_get_space(FAR struct rpmsg_socket_conn_s *conn)
   return conn->sendsize - (conn->sendpos - conn->ackpos);
 }
 
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+static void rpmsg_socket_hold_rxbuf(FAR struct rpmsg_socket_conn_s *conn,
+                                    FAR struct rpmsg_socket_data_s *msg,
+                                    size_t len)
+{
+  FAR struct rpmsg_socket_rxbuf_s *rxbuf;
+
+  nxmutex_lock(&conn->recvlock);
+  if (conn->rxnheld >= CONFIG_NET_RPMSG_ZEROCOPY_NRXBUFS)
+    {
+      nerr("rx buffers exhausted, %zu\n", len);
+
+      /* Still give the window back, the data is gone either way */
+
+      conn->recvpos += len;
+      nxmutex_unlock(&conn->recvlock);
+      return;
+    }
+
+  rxbuf = &conn->rxbufs[(conn->rxhead + conn->rxnheld) %
+                        CONFIG_NET_RPMSG_ZEROCOPY_NRXBUFS];
+  rxbuf->msg  = msg;
+  rxbuf->data = len == msg->len ? msg->data : msg->data + sizeof(uint32_t);
+  rxbuf->len  = msg->len;
+  rxbuf->size = len;
+
+  rpmsg_hold_rx_buffer(&conn->ept, msg);
+  conn->rxnheld++;
+
+  rpmsg_socket_post(&conn->recvsem);
+  rpmsg_socket_poll_notify(conn, POLLIN);
+  nxmutex_unlock(&conn->recvlock);
+}
+
+static void rpmsg_socket_free_rxbuf(FAR struct rpmsg_socket_conn_s *conn,
+                                    FAR struct rpmsg_socket_rxbuf_s *rxbuf)
+{
+  rpmsg_release_rx_buffer(&conn->ept, rxbuf->msg);
+  rxbuf->msg = NULL;
+  conn->recvpos += rxbuf->size;
+
+  /* Buffers may be given back in any order, slots are recycled in order */
+
+  while (conn->rxndeliv > 0 && conn->rxbufs[conn->rxhead].msg == NULL)
+    {
+      conn->rxhead = (conn->rxhead + 1) % CONFIG_NET_RPMSG_ZEROCOPY_NRXBUFS;
+      conn->rxnheld--;
+      conn->rxndeliv--;
+    }
+}
+
+static int rpmsg_socket_put_rxbuf(FAR struct rpmsg_socket_conn_s *conn,
+                                  FAR void *data)
+{
+  FAR struct rpmsg_socket_rxbuf_s *rxbuf;
+  int ret = -EINVAL;
+  int i;
+
+  nxmutex_lock(&conn->recvlock);
+  for (i = 0; i < conn->rxndeliv; i++)
+    {
+      rxbuf = &conn->rxbufs[(conn->rxhead + i) %
+                            CONFIG_NET_RPMSG_ZEROCOPY_NRXBUFS];
+      if (rxbuf->msg != NULL && rxbuf->data == data)
+        {
+          rpmsg_socket_free_rxbuf(conn, rxbuf);
+          ret = OK;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&conn->recvlock);
+  if (ret == OK)
+    {
+      rpmsg_socket_wakeup(conn);
+    }
+
+  return ret;
+}
+
+static int rpmsg_socket_rxavail(FAR struct rpmsg_socket_conn_s *conn)
+{
+  int avail = 0;
+  int i;
+
+  nxmutex_lock(&conn->recvlock);
+  for (i = conn->rxndeliv; i < conn->rxnheld; i++)
+    {
+      avail += conn->rxbufs[(conn->rxhead + i) %
+                            CONFIG_NET_RPMSG_ZEROCOPY_NRXBUFS].len;
+    }
+
+  nxmutex_unlock(&conn->recvlock);
+  return avail;
+}
+
+static void rpmsg_socket_release_all(FAR struct rpmsg_socket_conn_s *conn)
+{
+  int i;
+
+  nxmutex_lock(&conn->sendlock);
+  if (conn->txbuf)
+    {
+      rpmsg_release_tx_buffer(&conn->ept, conn->txbuf);
+      conn->txbuf = NULL;
+    }
+
+  nxmutex_unlock(&conn->sendlock);
+
+  nxmutex_lock(&conn->recvlock);
+  for (i = 0; i < conn->rxnheld; i++)
+    {
+      FAR struct rpmsg_socket_rxbuf_s *rxbuf =
+        &conn->rxbufs[(conn->rxhead + i) %
+                      CONFIG_NET_RPMSG_ZEROCOPY_NRXBUFS];
+
+      if (rxbuf->msg)
+        {
+          rpmsg_release_rx_buffer(&conn->ept, rxbuf->msg);
+          rxbuf->msg = NULL;
+        }
+    }
+
+  conn->rxnheld  = 0;
+  conn->rxndeliv = 0;
+  nxmutex_unlock(&conn->recvlock);
+}
+#endif
+
 static int rpmsg_socket_ept_cb(FAR struct rpmsg_endpoint *ept,
                                FAR void *data, size_t len, uint32_t src,
                                FAR void *priv)
@@ -363,6 +521,14 @@ static int rpmsg_socket_ept_cb(FAR struct rpmsg_endpoint *ept,
           len -= sizeof(*msg);
           DEBUGASSERT(len == msg->len || len == msg->len + sizeof(uint32_t));
 
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+          if (conn->zerocopy)
+            {
+              rpmsg_socket_hold_rxbuf(conn, msg, len);
+              return 0;
+            }
+#endif
+
           nxmutex_lock(&conn->recvlock);
           if (conn->recvdata)
             {
@@ -461,7 +627,7 @@ static void rpmsg_socket_ns_bound(struct rpmsg_endpoint *ept)
   struct rpmsg_socket_sync_s msg;
 
   msg.cmd  = RPMSG_SOCKET_CMD_SYNC;
-  msg.size = circbuf_size(&conn->recvbuf);
+  msg.size = conn->recvsize;
   msg.pid  = nxsched_getpid();
   msg.uid  = getuid();
   msg.gid  = getgid();
@@ -578,11 +744,18 @@ static void rpmsg_socket_ns_bind(FAR struct rpmsg_device *rdev,
       return;
     }
 
-  ret = circbuf_resize(&new->recvbuf, server->recvsize);
-  if (ret < 0)
+  new->recvsize = server->recvsize;
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+  new->zerocopy = server->zerocopy;
+  if (!new->zerocopy)
+#endif
     {
-      rpmsg_socket_free(new);
-      return;
+      ret = circbuf_resize(&new->recvbuf, server->recvsize);
+      if (ret < 0)
+        {
+          rpmsg_socket_free(new);
+          return;
+        }
     }
 
   new->ept.priv = new;
@@ -750,10 +923,17 @@ static int rpmsg_socket_connect_internal(FAR struct socket *psock)
   FAR struct rpmsg_socket_conn_s *conn = psock->s_conn;
   int ret;
 
-  ret = circbuf_resize(&conn->recvbuf, conn->recvsize);
-  if (ret < 0)
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+  /* Zero-copy sockets keep the rpmsg buffers instead */
+
+  if (!conn->zerocopy)
+#endif
     {
-      return ret;
+      ret = circbuf_resize(&conn->recvbuf, conn->recvsize);
+      if (ret < 0)
+        {
+          return ret;
+        }
     }
 
   ret = rpmsg_register_callback(conn,
@@ -947,6 +1127,13 @@ static int rpmsg_socket_poll(FAR struct socket *psock,
               eventset |= POLLIN;
             }
 
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+          if (conn->rxndeliv < conn->rxnheld)
+            {
+              eventset |= POLLIN;
+            }
+#endif
+
           nxmutex_unlock(&conn->recvlock);
         }
       else /* !_SS_ISCONNECTED(conn->sconn.s_flags) */
@@ -1181,6 +1368,166 @@ static ssize_t rpmsg_socket_send_single(FAR struct socket *psock,
   return ret > 0 ? len : ret;
 }
 
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+static int rpmsg_socket_get_txbuf(FAR struct socket *psock,
+                                  FAR struct iovec *iov)
+{
+  FAR struct rpmsg_socket_conn_s *conn = psock->s_conn;
+  FAR struct rpmsg_socket_data_s *msg;
+  uint32_t hdrlen = sizeof(*msg);
+  uint32_t ipcsize;
+
+  if (!_SS_ISCONNECTED(conn->sconn.s_flags))
+    {
+      return -ENOTCONN;
+    }
+
+  if (!conn->ept.rdev || conn->unbind)
+    {
+      return -ECONNRESET;
+    }
+
+  if (conn->txbuf)
+    {
+      return -EBUSY;
+    }
+
+  msg = rpmsg_get_tx_payload_buffer(&conn->ept, &ipcsize,
+                                    !_SS_ISNONBLOCK(conn->sconn.s_flags));
+  if (!msg)
+    {
+      return _SS_ISNONBLOCK(conn->sconn.s_flags) ? -EAGAIN : -EINVAL;
+    }
+
+  /* SOCK_DGRAM need write len to buffer */
+
+  if (psock->s_type != SOCK_STREAM)
+    {
+      hdrlen += sizeof(uint32_t);
+    }
+
+  nxmutex_lock(&conn->sendlock);
+  if (conn->txbuf)
+    {
+      nxmutex_unlock(&conn->sendlock);
+      rpmsg_release_tx_buffer(&conn->ept, msg);
+      return -EBUSY;
+    }
+
+  conn->txbuf   = msg;
+  conn->txlen   = MIN(ipcsize - hdrlen,
+                      conn->sendsize - (hdrlen - sizeof(*msg)));
+  iov->iov_base = (FAR uint8_t *)msg + hdrlen;
+  iov->iov_len  = conn->txlen;
+  nxmutex_unlock(&conn->sendlock);
+
+  return OK;
+}
+
+static int rpmsg_socket_put_txbuf(FAR struct rpmsg_socket_conn_s *conn)
+{
+  int ret = -EINVAL;
+
+  nxmutex_lock(&conn->sendlock);
+  if (conn->txbuf)
+    {
+      ret = rpmsg_release_tx_buffer(&conn->ept, conn->txbuf);
+      conn->txbuf = NULL;
+    }
+
+  nxmutex_unlock(&conn->sendlock);
+  return ret;
+}
+
+static ssize_t rpmsg_socket_send_zerocopy(FAR struct socket *psock,
+                                          FAR const struct iovec *buf,
+                                          size_t iovcnt, bool nonblock)
+{
+  FAR struct rpmsg_socket_conn_s *conn = psock->s_conn;
+  FAR struct rpmsg_socket_data_s *msg = conn->txbuf;
+  FAR uint8_t *data;
+  uint32_t total;
+  uint32_t len;
+  uint32_t space;
+  int ret;
+
+  if (msg == NULL || iovcnt != 1)
+    {
+      return -EINVAL;
+    }
+
+  data = msg->data;
+  if (psock->s_type != SOCK_STREAM)
+    {
+      data += sizeof(uint32_t);
+    }
+
+  /* Only the reserved buffer itself can be sent in place */
+
+  len = buf->iov_len;
+  if (buf->iov_base != data || len > conn->txlen)
+    {
+      return -EINVAL;
+    }
+
+  total = len + (data - msg->data);
+
+  /* The buffer can't be split, wait until it fits in the window */
+
+  while (1)
+    {
+      nxmutex_lock(&conn->sendlock);
+      space = rpmsg_socket_get_space(conn);
+      nxmutex_unlock(&conn->sendlock);
+
+      if (space >= total)
+        {
+          break;
+        }
+
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      ret = net_sem_timedwait(&conn->sendsem,
+                              _SO_TIMEOUT(conn->sconn.s_sndtimeo));
+      if (!conn->ept.rdev || conn->unbind)
+        {
+          ret = -ECONNRESET;
+        }
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  nxmutex_lock(&conn->sendlock);
+  msg->cmd = RPMSG_SOCKET_CMD_DATA;
+  msg->pos = conn->recvpos;
+  msg->len = len;
+  if (data != msg->data)
+    {
+      memcpy(msg->data, &len, sizeof(uint32_t));
+    }
+
+  conn->lastpos  = conn->recvpos;
+  conn->sendpos += total;
+  conn->txbuf    = NULL;
+
+  ret = rpmsg_sendto_nocopy(&conn->ept, msg, total + sizeof(*msg),
+                            conn->ept.dest_addr);
+  nxmutex_unlock(&conn->sendlock);
+  if (ret < 0)
+    {
+      rpmsg_release_tx_buffer(&conn->ept, msg);
+    }
+
+  return ret > 0 ? len : ret;
+}
+#endif
+
 static ssize_t rpmsg_socket_sendmsg(FAR struct socket *psock,
                                     FAR struct msghdr *msg, int flags)
 {
@@ -1221,6 +1568,13 @@ static ssize_t rpmsg_socket_sendmsg(FAR struct socket *psock,
   nonblock = _SS_ISNONBLOCK(conn->sconn.s_flags) ||
              (flags & MSG_DONTWAIT) != 0;
 
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+  if ((flags & MSG_ZEROCOPY) != 0)
+    {
+      return rpmsg_socket_send_zerocopy(psock, buf, len, nonblock);
+    }
+#endif
+
   if (psock->s_type == SOCK_STREAM)
     {
       return rpmsg_socket_send_continuous(psock, buf, len, nonblock);
@@ -1231,6 +1585,86 @@ static ssize_t rpmsg_socket_sendmsg(FAR struct socket *psock,
     }
 }
 
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+static ssize_t rpmsg_socket_recv_zerocopy(FAR struct socket *psock,
+                                          FAR struct msghdr *msg, int flags)
+{
+  FAR struct rpmsg_socket_conn_s *conn = psock->s_conn;
+  FAR struct rpmsg_socket_rxbuf_s *rxbuf;
+  ssize_t ret;
+
+  nxmutex_lock(&conn->recvlock);
+  while (conn->rxndeliv == conn->rxnheld)
+    {
+      if (!conn->ept.rdev || conn->unbind || (conn->how & SHUT_RD))
+        {
+          /* return EOF if lower IPC closed */
+
+          ret = 0;
+          goto out;
+        }
+
+      if (_SS_ISNONBLOCK(conn->sconn.s_flags) ||
+          (flags & MSG_DONTWAIT) != 0)
+        {
+          ret = -EAGAIN;
+          goto out;
+        }
+
+      nxsem_reset(&conn->recvsem, 0);
+      nxmutex_unlock(&conn->recvlock);
+
+      ret = net_sem_timedwait(&conn->recvsem,
+                              _SO_TIMEOUT(conn->sconn.s_rcvtimeo));
+
+      nxmutex_lock(&conn->recvlock);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  rxbuf = &conn->rxbufs[(conn->rxhead + conn->rxndeliv) %
+                        CONFIG_NET_RPMSG_ZEROCOPY_NRXBUFS];
+
+  if ((flags & MSG_ZEROCOPY) != 0)
+    {
+      /* Hand out the buffer itself until SIOCRPMSGRELRXBUF */
+
+      msg->msg_iov->iov_base = rxbuf->data;
+      msg->msg_iov->iov_len  = rxbuf->len;
+      conn->rxndeliv++;
+      ret = rxbuf->len;
+    }
+  else
+    {
+      ret = MIN(rxbuf->len, msg->msg_iov->iov_len);
+      memcpy(msg->msg_iov->iov_base, rxbuf->data, ret);
+
+      if (psock->s_type == SOCK_STREAM && ret < rxbuf->len)
+        {
+          rxbuf->data += ret;
+          rxbuf->len  -= ret;
+        }
+      else
+        {
+          conn->rxndeliv++;
+          rpmsg_socket_free_rxbuf(conn, rxbuf);
+        }
+    }
+
+out:
+  nxmutex_unlock(&conn->recvlock);
+  if (ret > 0)
+    {
+      rpmsg_socket_wakeup(conn);
+      rpmsg_socket_getaddr(conn, msg->msg_name, &msg->msg_namelen);
+    }
+
+  return ret;
+}
+#endif
+
 static ssize_t rpmsg_socket_recvmsg(FAR struct socket *psock,
                                     FAR struct msghdr *msg, int flags)
 {
@@ -1267,6 +1701,13 @@ static ssize_t rpmsg_socket_recvmsg(FAR struct socket *psock,
       return 0;
     }
 
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+  if (conn->zerocopy)
+    {
+      return rpmsg_socket_recv_zerocopy(psock, msg, flags);
+    }
+#endif
+
   nxmutex_lock(&conn->recvlock);
   if (psock->s_type != SOCK_STREAM)
     {
@@ -1371,6 +1812,9 @@ static int rpmsg_socket_close(FAR struct socket *psock)
 
   if (conn->ept.rdev)
     {
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+      rpmsg_socket_release_all(conn);
+#endif
       rpmsg_socket_destroy_ept(conn);
     }
   else
@@ -1409,6 +1853,14 @@ static int rpmsg_socket_ioctl(FAR struct socket *psock,
   switch (cmd)
     {
       case FIONREAD:
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+        if (conn->zerocopy)
+          {
+            *(FAR int *)((uintptr_t)arg) = rpmsg_socket_rxavail(conn);
+            break;
+          }
+#endif
+
         *(FAR int *)((uintptr_t)arg) = circbuf_used(&conn->recvbuf);
         break;
 
@@ -1420,6 +1872,21 @@ static int rpmsg_socket_ioctl(FAR struct socket *psock,
         rpmsg_socket_path(conn, (FAR char *)(uintptr_t)arg, PATH_MAX);
         break;
 
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+      case SIOCRPMSGGETTXBUF:
+        ret = rpmsg_socket_get_txbuf(psock,
+                                     (FAR struct iovec *)((uintptr_t)arg));
+        break;
+
+      case SIOCRPMSGRELTXBUF:
+        ret = rpmsg_socket_put_txbuf(conn);
+        break;
+
+      case SIOCRPMSGRELRXBUF:
+        ret = rpmsg_socket_put_rxbuf(conn, (FAR void *)((uintptr_t)arg));
+        break;
+#endif
+
       default:
         ret = -ENOTTY;
         break;
@@ -1494,6 +1961,19 @@ static int rpmsg_socket_getsockopt(FAR struct socket *psock, int level,
               *(FAR int *)value = conn->sendsize;
               return OK;
             }
+
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+          case SO_ZEROCOPY:
+            {
+              if (*value_len != sizeof(int))
+                {
+                  return -EINVAL;
+                }
+
+              *(FAR int *)value = conn->zerocopy;
+              return OK;
+            }
+#endif
         }
     }
 
@@ -1522,6 +2002,24 @@ static int rpmsg_socket_setsockopt(FAR struct socket *psock, int level,
       return OK;
     }
 
+#ifdef CONFIG_NET_RPMSG_ZEROCOPY
+  if (level == SOL_SOCKET && option == SO_ZEROCOPY)
+    {
+      if (value_len < sizeof(int))
+        {
+          return -EINVAL;
+        }
+
+      if (_SS_ISCONNECTED(conn->sconn.s_flags))
+        {
+          return -EISCONN;
+        }
+
+      conn->zerocopy = *(FAR const int *)value != 0;
+      return OK;
+    }
+#endif
+
   return -ENOPROTOOPT;
 }
 
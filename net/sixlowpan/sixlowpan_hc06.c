@@ -101,6 +101,27 @@ struct sixlowpan_addrcontext_s
   uint8_t prefix[8];
 };
 
+/* The compressed form of the source and destination addresses of a packet.
+ * It depends only on the two addresses, the MAC addresses and the address
+ * contexts, so it can be kept and reused for the following packets of the
+ * same flow.
+ */
+
+struct sixlowpan_hc06_addrs_s
+{
+#if CONFIG_NET_6LOWPAN_HC06_NTEMPLATES > 0
+  FAR struct radio_driver_s *radio;  /* Radio the template applies to */
+  struct netdev_varaddr_s srcmac;    /* Source MAC address */
+  struct netdev_varaddr_s destmac;   /* Destination MAC address */
+  net_ipv6addr_t srcipaddr;          /* Source IPv6 address */
+  net_ipv6addr_t destipaddr;         /* Destination IPv6 address */
+#endif
+  uint8_t iphc1;                     /* CID, SAC/SAM and M/DAC/DAM bits */
+  uint8_t cid;                       /* SCI | DCI, if CID is set */
+  uint8_t inlen;                     /* Number of inline address bytes */
+  uint8_t inline_addrs[32];          /* Inline source then dest bytes */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -124,6 +145,16 @@ static struct sixlowpan_addrcontext_s
 
 static FAR uint8_t *g_hc06ptr;
 
+#if CONFIG_NET_6LOWPAN_HC06_NTEMPLATES > 0
+/* Compression templates of the most recent flows.  They are replaced
+ * round-robin.
+ */
+
+static struct sixlowpan_hc06_addrs_s
+  g_hc06_templates[CONFIG_NET_6LOWPAN_HC06_NTEMPLATES];
+static uint8_t g_hc06_nexttemplate;
+#endif
+
 /* Constant Data ************************************************************/
 
 /* Uncompression of linklocal
@@ -416,6 +447,271 @@ static uint8_t compress_laddr(FAR const net_ipv6addr_t srcipaddr,
   return tag;
 }
 
+/****************************************************************************
+ * Name: compress_addrs
+ *
+ * Description:
+ *   Compute the IPHC address bits, the context identifiers and the inline
+ *   address bytes for the source and destination of a packet.
+ *
+ * Input Parameters:
+ *   radio   - A reference to a radio network device instance
+ *   ipv6    - The IPv6 header holding the addresses
+ *   destmac - L2 destination address
+ *   addrs   - Location to return the compressed addresses
+ *
+ ****************************************************************************/
+
+static void compress_addrs(FAR struct radio_driver_s *radio,
+                           FAR const struct ipv6_hdr_s *ipv6,
+                           FAR const struct netdev_varaddr_s *destmac,
+                           FAR struct sixlowpan_hc06_addrs_s *addrs)
+{
+  FAR struct sixlowpan_addrcontext_s *saddrcontext;
+  FAR struct sixlowpan_addrcontext_s *daddrcontext;
+
+  addrs->iphc1 = 0;
+  addrs->cid   = 0;
+
+  /* The inline bytes are collected in the template */
+
+  g_hc06ptr = addrs->inline_addrs;
+
+  /* Check if an address context exists (for allocating third byte) */
+
+  daddrcontext = find_addrcontext_byprefix(ipv6->destipaddr);
+  saddrcontext = find_addrcontext_byprefix(ipv6->srcipaddr);
+
+  if (daddrcontext != NULL || saddrcontext != NULL)
+    {
+      ninfo("Compressing dest or src ipaddr. Setting CID\n");
+      addrs->iphc1 |= SIXLOWPAN_IPHC_CID;
+    }
+
+  /* Source address - cannot be multicast */
+
+  if (net_is_addr_unspecified(ipv6->srcipaddr))
+    {
+      ninfo("Compressing unspecified srcipaddr.  Setting SAC\n");
+
+      addrs->iphc1 |= SIXLOWPAN_IPHC_SAC;
+      addrs->iphc1 |= SIXLOWPAN_IPHC_SAM_128;
+    }
+  else if (saddrcontext != NULL)
+    {
+      /* Elide the prefix - indicate by CID and set address context + SAC */
+
+      ninfo("Compressing src with address context."
+            " Setting SAC. Context: %d\n",
+            saddrcontext->number);
+
+      addrs->iphc1 |= SIXLOWPAN_IPHC_SAC;
+      addrs->cid |= saddrcontext->number << 4;
+
+      /* Compression compare with this nodes address (source) */
+
+      addrs->iphc1 |= compress_laddr(ipv6->srcipaddr,
+                                     &radio->r_dev.d_mac.radio,
+                                     SIXLOWPAN_IPHC_SAM_BIT);
+    }
+
+  /* No address context found for the source address */
+
+  else if (net_is_addr_linklocal(ipv6->srcipaddr) &&
+           ipv6->srcipaddr[1] == 0 &&  ipv6->srcipaddr[2] == 0 &&
+           ipv6->srcipaddr[3] == 0)
+    {
+      addrs->iphc1 |= compress_laddr(ipv6->srcipaddr,
+                                     &radio->r_dev.d_mac.radio,
+                                     SIXLOWPAN_IPHC_SAM_BIT);
+    }
+  else
+    {
+      /* Send the full source address ipaddr:  SAC = 0, SAM = 00 */
+
+      ninfo("Uncompressable "
+            "srcipaddr=%04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
+            NTOHS(ipv6->srcipaddr[0]), NTOHS(ipv6->srcipaddr[1]),
+            NTOHS(ipv6->srcipaddr[2]), NTOHS(ipv6->srcipaddr[3]),
+            NTOHS(ipv6->srcipaddr[4]), NTOHS(ipv6->srcipaddr[5]),
+            NTOHS(ipv6->srcipaddr[6]), NTOHS(ipv6->srcipaddr[7]));
+
+      addrs->iphc1 |= SIXLOWPAN_IPHC_SAM_128;   /* 128-bits */
+      memcpy(g_hc06ptr, ipv6->srcipaddr, 16);
+      g_hc06ptr += 16;
+    }
+
+  /* Destination address */
+
+  if (net_is_addr_mcast(ipv6->destipaddr))
+    {
+      /* Address is multicast, try to compress */
+
+      addrs->iphc1 |= SIXLOWPAN_IPHC_M;
+      if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE8(ipv6->destipaddr))
+        {
+          addrs->iphc1 |= SIXLOWPAN_IPHC_MDAM_8;
+
+          /* Use "last" byte ("last" meaning the LS byte in host order.
+           * destipaddr is in big-endian network order).
+           */
+
+#ifdef CONFIG_ENDIAN_BIG
+          *g_hc06ptr = (ipv6->destipaddr[7] & 0xff);
+#else
+          *g_hc06ptr = (ipv6->destipaddr[7] >> 8);
+#endif
+          g_hc06ptr += 1;
+        }
+      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE32(ipv6->destipaddr))
+        {
+          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
+
+          addrs->iphc1 |= SIXLOWPAN_IPHC_MDAM_32;
+
+          /* Second byte + the last three */
+
+          *g_hc06ptr = iptr[1];
+          memcpy(g_hc06ptr + 1, &iptr[13], 3);
+          g_hc06ptr += 4;
+        }
+      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE48(ipv6->destipaddr))
+        {
+          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
+
+          addrs->iphc1 |= SIXLOWPAN_IPHC_MDAM_48;
+
+          /* Second byte + the last five */
+
+          *g_hc06ptr = iptr[1];
+          memcpy(g_hc06ptr + 1, &iptr[11], 5);
+          g_hc06ptr += 6;
+        }
+      else
+        {
+          addrs->iphc1 |= SIXLOWPAN_IPHC_MDAM_128;
+
+          /* Full address */
+
+          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
+          g_hc06ptr += 16;
+        }
+    }
+  else
+    {
+      /* Address is unicast, try to compress */
+
+      if (daddrcontext != NULL)
+        {
+          /* Elide the prefix */
+
+          ninfo("Compressing dest with address context. "
+                "Setting DAC. Context: %d\n",
+                daddrcontext->number);
+
+          addrs->iphc1 |= SIXLOWPAN_IPHC_DAC;
+          addrs->cid |= daddrcontext->number;
+
+          /* Compession compare with link address (destination) */
+
+          addrs->iphc1 |= compress_tagaddr(ipv6->destipaddr, destmac,
+                                           SIXLOWPAN_IPHC_DAM_BIT);
+        }
+
+      /* No address context found for this address */
+
+      else if (net_is_addr_linklocal(ipv6->destipaddr) &&
+               ipv6->destipaddr[1] == 0 && ipv6->destipaddr[2] == 0 &&
+               ipv6->destipaddr[3] == 0)
+        {
+          addrs->iphc1 |= compress_tagaddr(ipv6->destipaddr, destmac,
+                                           SIXLOWPAN_IPHC_DAM_BIT);
+        }
+
+      /* Send the full address */
+
+      else
+        {
+          addrs->iphc1 |= SIXLOWPAN_IPHC_DAM_128;       /* 128-bits */
+          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
+          g_hc06ptr += 16;
+        }
+    }
+
+  addrs->inlen = g_hc06ptr - addrs->inline_addrs;
+}
+
+/****************************************************************************
+ * Name: lookup_addrs
+ *
+ * Description:
+ *   Return the compressed addresses of a packet, from the template of its
+ *   flow if there is one.  Otherwise they are computed, into the oldest
+ *   template if templates are enabled or into 'scratch' if not.
+ *
+ * Input Parameters:
+ *   radio   - A reference to a radio network device instance
+ *   ipv6    - The IPv6 header holding the addresses
+ *   destmac - L2 destination address
+ *   scratch - Storage to use when templates are not enabled
+ *
+ * Returned Value:
+ *   The compressed addresses
+ *
+ ****************************************************************************/
+
+static FAR const struct sixlowpan_hc06_addrs_s *
+  lookup_addrs(FAR struct radio_driver_s *radio,
+               FAR const struct ipv6_hdr_s *ipv6,
+               FAR const struct netdev_varaddr_s *destmac,
+               FAR struct sixlowpan_hc06_addrs_s *scratch)
+{
+#if CONFIG_NET_6LOWPAN_HC06_NTEMPLATES > 0
+  FAR const struct netdev_varaddr_s *srcmac = &radio->r_dev.d_mac.radio;
+  FAR struct sixlowpan_hc06_addrs_s *addrs;
+  int i;
+
+  UNUSED(scratch);
+
+  for (i = 0; i < CONFIG_NET_6LOWPAN_HC06_NTEMPLATES; i++)
+    {
+      addrs = &g_hc06_templates[i];
+      if (addrs->radio == radio &&
+          net_ipv6addr_cmp(addrs->destipaddr, ipv6->destipaddr) &&
+          net_ipv6addr_cmp(addrs->srcipaddr, ipv6->srcipaddr) &&
+          addrs->destmac.nv_addrlen == destmac->nv_addrlen &&
+          memcmp(addrs->destmac.nv_addr, destmac->nv_addr,
+                 destmac->nv_addrlen) == 0 &&
+          addrs->srcmac.nv_addrlen == srcmac->nv_addrlen &&
+          memcmp(addrs->srcmac.nv_addr, srcmac->nv_addr,
+                 srcmac->nv_addrlen) == 0)
+        {
+          return addrs;
+        }
+    }
+
+  /* No template for this flow yet, replace the oldest one */
+
+  addrs = &g_hc06_templates[g_hc06_nexttemplate];
+  if (++g_hc06_nexttemplate >= CONFIG_NET_6LOWPAN_HC06_NTEMPLATES)
+    {
+      g_hc06_nexttemplate = 0;
+    }
+
+  compress_addrs(radio, ipv6, destmac, addrs);
+
+  addrs->radio = radio;
+  memcpy(&addrs->srcmac, srcmac, sizeof(struct netdev_varaddr_s));
+  memcpy(&addrs->destmac, destmac, sizeof(struct netdev_varaddr_s));
+  net_ipv6addr_copy(addrs->srcipaddr, ipv6->srcipaddr);
+  net_ipv6addr_copy(addrs->destipaddr, ipv6->destipaddr);
+  return addrs;
+#else
+  compress_addrs(radio, ipv6, destmac, scratch);
+  return scratch;
+#endif
+}
+
 /****************************************************************************
  * Name: uncompress_addr
  *
@@ -744,8 +1040,8 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
                                FAR uint8_t *fptr)
 {
   FAR uint8_t *iphc = fptr + g_frame_hdrlen;
-  FAR struct sixlowpan_addrcontext_s *saddrcontext;
-  FAR struct sixlowpan_addrcontext_s *daddrcontext;
+  FAR const struct sixlowpan_hc06_addrs_s *addrs;
+  struct sixlowpan_hc06_addrs_s scratch;
   uint8_t iphc0;
   uint8_t iphc1;
   uint8_t tmp;
@@ -760,28 +1056,20 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
    */
 
   iphc0   = SIXLOWPAN_DISPATCH_IPHC;
-  iphc1   = 0;
-  iphc[2] = 0;         /* Might not be used - but needs to be cleared */
-
-  /* Point to just after the two IPHC bytes we have committed to */
-
-  g_hc06ptr = iphc + 2;
 
   /* Address handling needs to be made first since it might cause an extra
    * byte with [ SCI | DCI ]
    */
 
-  /* Check if dest address context exists (for allocating third byte) */
+  addrs   = lookup_addrs(radio, ipv6, destmac, &scratch);
+  iphc1   = addrs->iphc1;
+  iphc[2] = addrs->cid;  /* Might not be used - but needs to be cleared */
 
-  daddrcontext = find_addrcontext_byprefix(ipv6->destipaddr);
-  saddrcontext = find_addrcontext_byprefix(ipv6->srcipaddr);
+  /* Point to just after the IPHC bytes we have committed to */
 
-  if (daddrcontext != NULL || saddrcontext != NULL)
+  g_hc06ptr = iphc + 2;
+  if ((iphc1 & SIXLOWPAN_IPHC_CID) != 0)
     {
-      /* set address context flag and increase g_hc06ptr */
-
-      ninfo("Compressing dest or src ipaddr. Setting CID\n");
-      iphc1 |= SIXLOWPAN_IPHC_CID;
       g_hc06ptr++;
     }
 
@@ -888,155 +1176,10 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
       break;
     }
 
-  /* Source address - cannot be multicast */
-
-  if (net_is_addr_unspecified(ipv6->srcipaddr))
-    {
-      ninfo("Compressing unspecified srcipaddr.  Setting SAC\n");
-
-      iphc1 |= SIXLOWPAN_IPHC_SAC;
-      iphc1 |= SIXLOWPAN_IPHC_SAM_128;
-    }
-  else if (saddrcontext != NULL)
-    {
-      /* Elide the prefix - indicate by CID and set address context + SAC */
-
-      ninfo("Compressing src with address context."
-            " Setting SAC. Context: %d\n",
-            saddrcontext->number);
-
-      iphc1   |= SIXLOWPAN_IPHC_SAC;
-      iphc[2] |= saddrcontext->number << 4;
-
-      /* Compression compare with this nodes address (source) */
-
-      iphc1   |= compress_laddr(ipv6->srcipaddr,
-                                &radio->r_dev.d_mac.radio,
-                                SIXLOWPAN_IPHC_SAM_BIT);
-    }
-
-  /* No address context found for the source address */
-
-  else if (net_is_addr_linklocal(ipv6->srcipaddr) &&
-           ipv6->srcipaddr[1] == 0 &&  ipv6->srcipaddr[2] == 0 &&
-           ipv6->srcipaddr[3] == 0)
-    {
-      iphc1   |= compress_laddr(ipv6->srcipaddr,
-                                &radio->r_dev.d_mac.radio,
-                                SIXLOWPAN_IPHC_SAM_BIT);
-    }
-  else
-    {
-      /* Send the full source address ipaddr:  SAC = 0, SAM = 00 */
-
-      ninfo("Uncompressable "
-            "srcipaddr=%04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
-            NTOHS(ipv6->srcipaddr[0]), NTOHS(ipv6->srcipaddr[1]),
-            NTOHS(ipv6->srcipaddr[2]), NTOHS(ipv6->srcipaddr[3]),
-            NTOHS(ipv6->srcipaddr[4]), NTOHS(ipv6->srcipaddr[5]),
-            NTOHS(ipv6->srcipaddr[6]), NTOHS(ipv6->srcipaddr[7]));
-
-      iphc1 |= SIXLOWPAN_IPHC_SAM_128;   /* 128-bits */
-      memcpy(g_hc06ptr, ipv6->srcipaddr, 16);
-      g_hc06ptr += 16;
-    }
-
-  /* Destination address */
+  /* Source and destination addresses */
 
-  if (net_is_addr_mcast(ipv6->destipaddr))
-    {
-      /* Address is multicast, try to compress */
-
-      iphc1 |= SIXLOWPAN_IPHC_M;
-      if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE8(ipv6->destipaddr))
-        {
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_8;
-
-          /* Use "last" byte ("last" meaning the LS byte in host order.
-           * destipaddr is in big-endian network order).
-           */
-
-#ifdef CONFIG_ENDIAN_BIG
-          *g_hc06ptr = (ipv6->destipaddr[7] & 0xff);
-#else
-          *g_hc06ptr = (ipv6->destipaddr[7] >> 8);
-#endif
-          g_hc06ptr += 1;
-        }
-      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE32(ipv6->destipaddr))
-        {
-          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
-
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_32;
-
-          /* Second byte + the last three */
-
-          *g_hc06ptr = iptr[1];
-          memcpy(g_hc06ptr + 1, &iptr[13], 3);
-          g_hc06ptr += 4;
-        }
-      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE48(ipv6->destipaddr))
-        {
-          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
-
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_48;
-
-          /* Second byte + the last five */
-
-          *g_hc06ptr = iptr[1];
-          memcpy(g_hc06ptr + 1, &iptr[11], 5);
-          g_hc06ptr += 6;
-        }
-      else
-        {
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_128;
-
-          /* Full address */
-
-          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
-          g_hc06ptr += 16;
-        }
-    }
-  else
-    {
-      /* Address is unicast, try to compress */
-
-      if (daddrcontext != NULL)
-        {
-          /* Elide the prefix */
-
-          ninfo("Compressing dest with address context. "
-                "Setting DAC. Context: %d\n",
-                daddrcontext->number);
-
-          iphc1   |= SIXLOWPAN_IPHC_DAC;
-          iphc[2] |= daddrcontext->number;
-
-          /* Compession compare with link address (destination) */
-
-          iphc1   |= compress_tagaddr(ipv6->destipaddr, destmac,
-                                      SIXLOWPAN_IPHC_DAM_BIT);
-        }
-
-      /* No address context found for this address */
-
-      else if (net_is_addr_linklocal(ipv6->destipaddr) &&
-               ipv6->destipaddr[1] == 0 && ipv6->destipaddr[2] == 0 &&
-               ipv6->destipaddr[3] == 0)
-        {
-          iphc1 |= compress_tagaddr(ipv6->destipaddr, destmac,
-                                    SIXLOWPAN_IPHC_DAM_BIT);
-        }
-
-      /* Send the full address */
-
-      else
-        {
-          iphc1 |= SIXLOWPAN_IPHC_DAM_128;       /* 128-bits */
-          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
-          g_hc06ptr += 16;
-        }
-    }
+  memcpy(g_hc06ptr, addrs->inline_addrs, addrs->inlen);
+  g_hc06ptr += addrs->inlen;
 
   g_uncomp_hdrlen = IPv6_HDRLEN;
 
@@ -147,9 +147,13 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
                             * periodic transmission of probes */
       case SO_OOBINLINE:   /* Leaves received out-of-band data inline */
       case SO_REUSEADDR:   /* Allow reuse of local addresses */
+      case SO_REUSEPORT:   /* Allow load balancing on a shared port */
 #ifdef CONFIG_NET_TIMESTAMP
       case SO_TIMESTAMP:   /* Generates a timestamp in us for each incoming packet */
       case SO_TIMESTAMPNS: /* Generates a timestamp in ns for each incoming packet */
+#endif
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      case SO_ZEROCOPY:    /* Allow MSG_ZEROCOPY sends */
 #endif
         {
           sockopt_t optionset;
@@ -0,0 +1,189 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives a vector of messages from a socket with one
+ *   call.  This is an internal OS interface.  It is functionally
+ *   equivalent to recvmmsg() except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   The vector of buffers to receive the messages
+ *   vlen     The number of entries in msgvec
+ *   flags    Receive flags.  MSG_WAITFORONE turns on MSG_DONTWAIT after
+ *            the first message has been received.
+ *   timeout  If not NULL, the batch ends once this much time has elapsed.
+ *            As on Linux, it is checked after each message, so it does
+ *            not bound a blocking receive by itself.
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received; the msg_len
+ *   field of each of them holds the number of bytes received.  A failure
+ *   on the first message returns a negated errno value (see comments with
+ *   recvmsg()).  A failure after that ends the batch and returns the
+ *   number of messages received up to that point.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout)
+{
+  clock_t deadline = 0;
+  unsigned int i;
+  ssize_t ret;
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Let the address family receive the whole batch if it can do better
+   * than one recvmsg() per message.
+   */
+
+  if (psock != NULL && psock->s_conn != NULL &&
+      psock->s_sockif->si_recvmmsg != NULL)
+    {
+      return psock->s_sockif->si_recvmmsg(psock, msgvec, vlen, flags,
+                                          timeout);
+    }
+
+  if (timeout != NULL)
+    {
+      deadline = clock_systime_ticks() + clock_time2ticks(timeout);
+    }
+
+  for (i = 0; i < vlen; i++)
+    {
+      ret = psock_recvmsg(psock, &msgvec[i].msg_hdr,
+                          flags & ~MSG_WAITFORONE);
+      if (ret < 0)
+        {
+          return i > 0 ? i : ret;
+        }
+
+      msgvec[i].msg_len = ret;
+
+      /* Do not wait for the rest once one message has arrived */
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL &&
+          (sclock_t)(clock_systime_ticks() - deadline) >= 0)
+        {
+          return i + 1;
+        }
+    }
+
+  return i;
+}
+
+/****************************************************************************
+ * Function: recvmmsg
+ *
+ * Description:
+ *   The recvmmsg() call receives several messages from a socket with one
+ *   system call.  It is equivalent to calling recvmsg() for each entry of
+ *   msgvec, but the descriptor is looked up and the cancellation point is
+ *   entered only once for the whole batch.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   The vector of buffers to receive the messages
+ *   vlen     The number of entries in msgvec
+ *   flags    Receive flags
+ *   timeout  Optional time limit of the batch
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received in msgvec.  If
+ *   the first message cannot be received, -1 is returned and errno is set
+ *   as for recvmsg().
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &filep, &psock);
+
+  /* Let psock_recvmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+      file_put(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
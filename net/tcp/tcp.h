@@ -32,6 +32,10 @@
 #include <sys/types.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
+#ifdef CONFIG_NET_TCP_PACING
+#  include <nuttx/hrtimer.h>
+#endif
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
@@ -73,6 +77,11 @@
 #  define TCP_WBNACK(wrb)            ((wrb)->wb_nack)
 #endif
 #  define TCP_WBIOB(wrb)             ((wrb)->wb_iob)
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+#  define TCP_WBZEROCOPY(wrb)        ((wrb)->wb_zcconn != NULL)
+#else
+#  define TCP_WBZEROCOPY(wrb)        false
+#endif
 #  define TCP_WBCOPYOUT(wrb,dest,n)  (iob_copyout(dest,(wrb)->wb_iob,(n),0))
 #  define TCP_WBCOPYIN(wrb,src,n,off) \
      (iob_copyin((wrb)->wb_iob,src,(n),(off),true))
@@ -112,6 +121,28 @@
 #define TCP_INFR              0x08U /* The flag in Fast Recovery */
 #define TCP_INFT              0x10U /* The flag in Fast Transmitted */
 
+/* The longest name of a congestion control algorithm (TCP_CONGESTION) */
+
+#define TCP_CC_NAME_MAX       16
+
+/* Increments a size inc and holds at max value rather than rollover. */
+
+#define TCP_CC_CWND_INC(wnd, inc) \
+ do { \
+  if ((uint32_t)((wnd) + (inc)) >= (wnd)) \
+    { \
+      (wnd) = (uint32_t)((wnd) + (inc)); \
+    } \
+  else \
+    { \
+      (wnd) = (uint32_t)-1; \
+    } \
+ } while(0)
+
+/* Number of round trips over which BBR keeps the maximum bandwidth */
+
+#define TCP_BBR_BW_RTTS       10
+
 #endif
 
 /* The Max Range count of TCP Selective ACKs */
@@ -124,8 +155,19 @@
 
 #define TCP_FAST_RETRANSMISSION_THRESH 3
 
-#define TCP_RTO_MAX 240 /* 120s,The unit is half a second */
-#define TCP_RTO_MIN 1   /* 0.5s */
+/* The retransmission timers run in milliseconds, NET_TCP_RTO is
+ * configured in half-seconds.
+ */
+
+#define TCP_RTO_INIT  (TCP_RTO * MSEC_PER_HSEC)
+#define TCP_RTO_MAX   (120 * MSEC_PER_SEC)
+#define TCP_RTO_MIN   200
+
+/* Per RFC 1122:  "... an ACK should not be excessively delayed; in
+ * particular, the delay MUST be less than 0.5 seconds ..."
+ */
+
+#define TCP_ACK_DELAY 200 /* ms */
 
 /****************************************************************************
  * Public Type Definitions
@@ -176,6 +218,90 @@ struct tcp_sack_s
   uint32_t right;   /* Right edge of the SACK */
 };
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* A congestion control algorithm, selected per connection with the
+ * TCP_CONGESTION socket option.  Fast retransmit and fast recovery
+ * (RFC 6582) are common to all of them, the algorithm decides how cwnd
+ * grows and how much it shrinks on a loss.
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;   /* The name used with TCP_CONGESTION */
+
+  /* Reset the state of the algorithm, when the connection starts or
+   * when it switches to this algorithm.
+   */
+
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+
+  /* Return the slow start threshold after a loss */
+
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+
+  /* Grow cwnd for "acked" newly ACKed bytes, outside fast recovery.
+   * May be NULL if cong_control is provided.
+   */
+
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+  /* Optional, replaces cong_avoid and the cwnd handling of fast recovery:
+   * called for every ACK of new data.
+   */
+
+  CODE void (*cong_control)(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+  /* Optional, called on a retransmission timeout after ssthresh */
+
+  CODE void (*timeout)(FAR struct tcp_conn_s *conn);
+};
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* The state of CUBIC (RFC 9438) */
+
+struct tcp_cubic_s
+{
+  clock_t  epoch;         /* Start of the congestion avoidance epoch */
+  uint32_t w_max;         /* cwnd before the last reduction (bytes) */
+  uint32_t origin;        /* Plateau of the cubic function (bytes) */
+  uint32_t k;             /* Time to reach the plateau (ms) */
+  uint32_t w_est;         /* Reno-friendly cwnd estimate (bytes) */
+  bool     in_epoch;      /* The epoch has started */
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_BBR
+/* The state of BBR version 1 */
+
+struct tcp_bbr_s
+{
+  uint64_t rs_stamp;      /* Start of the delivery rate sample (us) */
+  uint64_t min_rtt_stamp; /* When min_rtt was measured (us) */
+  uint64_t cycle_stamp;   /* Start of the current PROBE_BW phase (us) */
+  uint64_t probe_done;    /* End of PROBE_RTT, 0 if not armed (us) */
+  uint32_t rs_delivered;  /* delivered when the sample started */
+  uint32_t rs_seq;        /* The sample ends when data past this is ACKed */
+  uint32_t delivered;     /* Bytes ACKed so far */
+  uint32_t min_rtt;       /* Minimum RTT over 10s (us), 0 if unknown */
+
+  /* Delivery rate of the last rounds (B/s) */
+
+  uint32_t bw[TCP_BBR_BW_RTTS];
+
+  uint32_t full_bw;       /* Bandwidth at the last growth in STARTUP */
+  uint32_t prior_cwnd;    /* cwnd before recovery or PROBE_RTT */
+  uint32_t round;         /* Number of round trips sampled */
+  uint8_t  state;         /* STARTUP, DRAIN, PROBE_BW or PROBE_RTT */
+  uint8_t  cycle;         /* Phase of the PROBE_BW gain cycle */
+  uint8_t  full_bw_cnt;   /* Rounds without bandwidth growth */
+  bool     full_pipe;     /* The bottleneck bandwidth has been reached */
+  bool     rs_active;     /* A delivery rate sample is running */
+  bool     probe_round;   /* A round trip passed in PROBE_RTT */
+  bool     in_recovery;   /* Fast recovery seen on the last ACK */
+};
+#endif
+#endif /* CONFIG_NET_TCP_CC_NEWRENO */
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -209,6 +335,11 @@ struct tcp_conn_s
   /* TCP-specific content follows */
 
   union ip_binding_u u;   /* IP address binding */
+#if CONFIG_NET_TCP_HASH_BITS > 0
+  hash_node_t hnode;      /* Link in the 4-tuple hash of active
+                           * connections */
+  hash_node_t lnode;      /* Link in the local port hash of listeners */
+#endif
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
   uint8_t  sndseq[4];     /* The sequence number that was last sent by us */
@@ -219,20 +350,19 @@ struct tcp_conn_s
 #endif
   uint8_t  shutdown;      /* Whether the connection is shutdown, SHUT_RD and
                            * SHUT_WR */
-  uint8_t  sa;            /* Retransmission time-out calculation state
-                           * variable */
-  uint8_t  sv;            /* Retransmission time-out calculation state
-                           * variable */
-  uint8_t  rto;           /* Retransmission time-out */
   uint8_t  tcpstateflags; /* TCP state and flags */
-  struct   work_s work;   /* TCP timer handle */
+  struct   work_s work;   /* TCP timer handle, queued at the next deadline */
   bool     timeout;       /* Trigger from timer expiry */
-  uint8_t  timer;         /* The retransmission timer (units: half-seconds) */
   uint8_t  nrtx;          /* The number of retransmissions for the last
                            * segment sent */
+  uint32_t sa;            /* Smoothed RTT, scaled by 8 (ms) */
+  uint32_t sv;            /* RTT variance, scaled by 4 (ms) */
+  uint32_t rto;           /* Retransmission time-out (ms) */
+  uint32_t timer;         /* The retransmission timer (ms) */
+  clock_t  timer_stamp;   /* When the timers were last brought up to date */
 #ifdef CONFIG_NET_TCP_DELAYED_ACK
   uint8_t  rx_unackseg;   /* Number of un-ACKed received segments */
-  uint8_t  rx_acktimer;   /* Time since last ACK sent (units: half-seconds) */
+  uint32_t rx_acktimer;   /* Time left before the delayed ACK (ms) */
 #endif
   uint16_t lport;         /* The local TCP port, in network byte order */
   uint16_t rport;         /* The remoteTCP port, in network byte order */
@@ -244,6 +374,11 @@ struct tcp_conn_s
 #endif
   uint32_t rcv_adv;       /* The right edge of the recv window advertised */
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
+
+  /* Congestion control algorithm */
+
+  FAR const struct tcp_cc_ops_s *cc_ops;
+
   uint32_t last_ackno;    /* The ack number at the last receive ack */
   uint32_t dupacks;       /* The number of duplicate ack */
   uint32_t fr_recover;    /* The snd_seq at the retransmissions */
@@ -251,6 +386,23 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+#if defined(CONFIG_NET_TCP_CC_CUBIC) || defined(CONFIG_NET_TCP_CC_BBR)
+  union
+  {
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+    struct tcp_cubic_s cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+    struct tcp_bbr_s   bbr;
+#endif
+  } cc;                   /* The state of the congestion control */
+#endif
+#endif
+#ifdef CONFIG_NET_TCP_PACING
+  uint32_t pacing_rate;   /* Bytes per second, 0 to send unpaced */
+  uint64_t pacing_next;   /* Earliest time of the next send (ns) */
+  hrtimer_t pacing_timer; /* Wakes up the send path at pacing_next */
+  struct work_s pacing_work;
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -325,6 +477,19 @@ struct tcp_conn_s
   uint32_t   isn;         /* Initial sequence number */
   uint32_t   sndseq_max;  /* The sequence number of next not-retransmitted
                            * segment (next greater sndseq) */
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* MSG_ZEROCOPY completions
+   *
+   *   zc_next    - The id of the next MSG_ZEROCOPY send
+   *   zc_lo/hi   - The range of completed ids not yet read with
+   *                MSG_ERRQUEUE, valid if zc_pending is true
+   */
+
+  uint32_t   zc_next;
+  uint32_t   zc_lo;
+  uint32_t   zc_hi;
+  bool       zc_pending;
+#endif
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -343,11 +508,9 @@ struct tcp_conn_s
 #endif
 
 #ifdef CONFIG_NET_TCP_KEEPALIVE
-  /* There fields manage TCP/IP keep-alive.  All times are in units of the
-   * system clock tick.
-   */
+  /* There fields manage TCP/IP keep-alive. */
 
-  uint32_t   keeptimer;   /* KeepAlive timer (dsec) */
+  uint32_t   keeptimer;   /* KeepAlive timer (ms) */
   uint32_t   keepidle;    /* Elapsed idle time before first probe sent (dsec) */
   uint32_t   keepintvl;   /* Interval between probes (dsec) */
   bool       keepalive;   /* True: KeepAlive enabled; false: disabled */
@@ -414,6 +577,14 @@ struct tcp_wrbuffer_s
   uint8_t    wb_nack;      /* The number of ack count */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* MSG_ZEROCOPY: The connection to notify on release if wb_iob refers
+   * to the user buffer, and the id of the send.
+   */
+
+  FAR struct tcp_conn_s *wb_zcconn;
+  uint32_t   wb_zcid;
+#endif
 };
 #endif
 
@@ -454,6 +625,18 @@ extern "C"
 {
 #endif
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* The congestion control algorithms */
+
+extern const struct tcp_cc_ops_s g_tcp_cc_reno;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+extern const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+extern const struct tcp_cc_ops_s g_tcp_cc_bbr;
+#endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -722,6 +905,66 @@ void tcp_removeconn(FAR struct tcp_conn_s *conn);
 
 void tcp_remove_syn_backlog(FAR struct tcp_conn_s *listener);
 
+/****************************************************************************
+ * Name: tcp_drop_synrcvd
+ *
+ * Description:
+ *   Free the SYN_RCVD connection that has retransmitted its SYN-ACK the
+ *   most times, to make room for a connection completed by a SYN cookie.
+ *
+ * Returned Value:
+ *   True if a connection was freed.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+bool tcp_drop_synrcvd(void);
+#endif
+
+/****************************************************************************
+ * Name: tcp_syncookie_send
+ *
+ * Description:
+ *   Answer the SYN in the packet with a SYN-ACK whose sequence number is a
+ *   cookie, without allocating any connection state.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+void tcp_syncookie_send(FAR struct net_driver_s *dev,
+                        FAR struct tcp_conn_s *listener,
+                        FAR union ip_binding_u *uaddr, uint8_t domain,
+                        unsigned int iplen);
+
+/****************************************************************************
+ * Name: tcp_syncookie_accept
+ *
+ * Description:
+ *   Check whether the ACK in the packet returns a cookie sent by
+ *   tcp_syncookie_send() and, if it does, create the connection it
+ *   completes in the SYN_RCVD state.
+ *
+ * Returned Value:
+ *   The new connection or NULL.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_syncookie_accept(FAR struct net_driver_s *dev,
+                                            FAR struct tcp_conn_s *listener,
+                                            FAR union ip_binding_u *uaddr,
+                                            uint8_t domain,
+                                            unsigned int iplen);
+#endif
+
 /****************************************************************************
  * Name: tcp_conn_list_lock
  *
@@ -1028,6 +1271,26 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn);
 
 void tcp_update_timer(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_sync_timer
+ *
+ * Description:
+ *   Bring the timers of the provided TCP connection up to date: subtract
+ *   the time elapsed since they were last synchronized.
+ *
+ * Input Parameters:
+ *   conn - The TCP "connection" to poll for TX data
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   conn is not NULL.
+ *
+ ****************************************************************************/
+
+void tcp_sync_timer(FAR struct tcp_conn_s *conn);
+
 /****************************************************************************
  * Name: tcp_update_retrantimer
  *
@@ -1037,7 +1300,7 @@ void tcp_update_timer(FAR struct tcp_conn_s *conn);
  *
  * Input Parameters:
  *   conn    - The TCP "connection" to poll for TX data
- *   timeout - Time for the next timeout
+ *   timeout - Time for the next timeout (ms)
  *
  * Returned Value:
  *   None
@@ -1059,7 +1322,7 @@ void tcp_update_retrantimer(FAR struct tcp_conn_s *conn, int timeout);
  *
  * Input Parameters:
  *   conn    - The TCP "connection" to poll for TX data
- *   timeout - Time for the next timeout
+ *   timeout - Time for the next timeout (dsec)
  *
  * Returned Value:
  *   None
@@ -1074,6 +1337,29 @@ void tcp_update_retrantimer(FAR struct tcp_conn_s *conn, int timeout);
 void tcp_update_keeptimer(FAR struct tcp_conn_s *conn, int timeout);
 #endif
 
+/****************************************************************************
+ * Name: tcp_update_acktimer
+ *
+ * Description:
+ *   Start the delayed ACK timer for the provided TCP connection
+ *
+ * Input Parameters:
+ *   conn    - The TCP "connection" to poll for TX data
+ *   timeout - Time for the next timeout (ms)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   conn is not NULL.
+ *   The connection (conn) is bound to the polling device (dev).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+void tcp_update_acktimer(FAR struct tcp_conn_s *conn, int timeout);
+#endif
+
 /****************************************************************************
  * Name: tcp_stop_timer
  *
@@ -1114,6 +1400,27 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno);
 #endif
 
+/****************************************************************************
+ * Name: tcp_reuseport
+ *
+ * Description:
+ *   Given the listener returned by tcp_findlistener(), select the member of
+ *   its SO_REUSEPORT group that owns the connection from the remote address
+ *   and port in uaddr/rport.  The choice is a hash of the address and port
+ *   pairs, so every segment of a handshake selects the same listener.  The
+ *   listener is returned unchanged if it is not part of a group.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct tcp_conn_s *tcp_reuseport(FAR struct tcp_conn_s *listener,
+                                     FAR const union ip_binding_u *uaddr,
+                                     uint16_t rport);
+#endif
+
 /****************************************************************************
  * Name: tcp_unlisten
  *
@@ -1878,6 +2185,31 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_alloc(void);
 FAR struct tcp_wrbuffer_s *tcp_wrbuffer_tryalloc(void);
 #endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
+/****************************************************************************
+ * Name: tcp_wrbuffer_zcalloc
+ *
+ * Description:
+ *   Allocate a TCP write buffer whose I/O buffer refers to the caller's
+ *   data instead of holding a copy of it.  The caller must set wb_zcconn
+ *   and wb_zcid, the completion is reported to that connection when the
+ *   write buffer is released.
+ *
+ * Input Parameters:
+ *   buf     - The data to send, must stay valid until the completion
+ *   len     - The length of the data, at most UINT16_MAX
+ *   timeout - The relative time to wait until a timeout is declared.
+ *
+ * Assumptions:
+ *   Called from user logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+FAR struct tcp_wrbuffer_s *tcp_wrbuffer_zcalloc(FAR const void *buf,
+                                                size_t len,
+                                                unsigned int timeout);
+#endif
+
 /****************************************************************************
  * Name: tcp_wrbuffer_release
  *
@@ -1996,6 +2328,25 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds);
 
 int tcp_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds);
 
+/****************************************************************************
+ * Name: tcp_poll_zerocopy
+ *
+ * Description:
+ *   Wake up the pollers of a TCP/IP socket with POLLERR because a
+ *   MSG_ZEROCOPY completion can be read with MSG_ERRQUEUE.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+void tcp_poll_zerocopy(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: tcp_readahead_notifier_setup
  *
@@ -2356,7 +2707,149 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
-#endif
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables on a retransmission timeout.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_slow_start
+ *
+ * Description:
+ *   Grow cwnd by at most one segment for "acked" newly ACKed bytes
+ *   (RFC 5681 slow start).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   acked  - The number of newly ACKed bytes
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_slow_start(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+/****************************************************************************
+ * Name: tcp_cc_set
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name
+ *   (TCP_CONGESTION socket option).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm, not necessarily NUL terminated
+ *   len    - The maximum length of the name
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_set(FAR struct tcp_conn_s *conn, FAR const char *name,
+               size_t len);
+
+/****************************************************************************
+ * Name: tcp_cc_get
+ *
+ * Description:
+ *   Return the congestion control algorithm of a connection, the default
+ *   one if none has been selected yet.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ ****************************************************************************/
+
+FAR const struct tcp_cc_ops_s *tcp_cc_get(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_gettime
+ *
+ * Description:
+ *   Return the current time in nanoseconds, as used by the congestion
+ *   control algorithms and pacing.
+ *
+ ****************************************************************************/
+
+uint64_t tcp_cc_gettime(void);
+#endif /* CONFIG_NET_TCP_CC_NEWRENO */
+
+#ifdef CONFIG_NET_TCP_PACING
+/****************************************************************************
+ * Name: tcp_pacing_ready
+ *
+ * Description:
+ *   Check whether the pacing rate of the connection allows to send new
+ *   data now.  If not, a timer is armed to poll the connection again when
+ *   it does.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   true if data may be sent now.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_pacing_ready(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_pacing_sent
+ *
+ * Description:
+ *   Account "len" bytes of new data sent, to delay the next send according
+ *   to the pacing rate.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   len    - The number of bytes sent
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_pacing_sent(FAR struct tcp_conn_s *conn, uint32_t len);
+
+/****************************************************************************
+ * Name: tcp_pacing_stop
+ *
+ * Description:
+ *   Cancel the pacing timer of a connection that is being freed.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ ****************************************************************************/
+
+void tcp_pacing_stop(FAR struct tcp_conn_s *conn);
+#endif /* CONFIG_NET_TCP_PACING */
 
 #ifdef __cplusplus
 }
@@ -108,10 +108,6 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
     {
       /* Yes.. Handle delayed acknowledgments */
 
-      /* Reset the ACK timer in any event. */
-
-      conn->rx_acktimer = 0;
-
       /* Per RFC 1122:  "...in a stream of full-sized segments there
        * SHOULD be an ACK for at least every second segment."
        *
@@ -144,6 +140,7 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
            */
 
           conn->rx_unackseg = 1;
+          tcp_update_acktimer(conn, TCP_ACK_DELAY);
           return;
         }
     }
@@ -24,8 +24,17 @@
  * Included Files
  ****************************************************************************/
 
+#include <string.h>
+#include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+#include "devif/devif.h"
 #include "tcp/tcp.h"
 
 /****************************************************************************
@@ -60,24 +69,186 @@
     } \
  } while(0)
 
-/* Increments a size inc and holds at max value rather than rollover. */
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
 
-#define CC_CWND_INC(wnd, inc) \
- do { \
-  if ((uint32_t)((wnd) + (inc)) >= (wnd)) \
-    { \
-      (wnd) = (uint32_t)((wnd) + (inc)); \
-    } \
-  else \
-    { \
-      (wnd) = (uint32_t)-1; \
-    } \
- } while(0)
+static uint32_t tcp_reno_ssthresh(FAR struct tcp_conn_s *conn);
+static void tcp_reno_cong_avoid(FAR struct tcp_conn_s *conn,
+                                uint32_t acked);
+static void tcp_reno_timeout(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_reno =
+{
+  "reno",                 /* name */
+  NULL,                   /* init */
+  tcp_reno_ssthresh,      /* ssthresh */
+  tcp_reno_cong_avoid,    /* cong_avoid */
+  NULL,                   /* cong_control */
+  tcp_reno_timeout        /* timeout */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct tcp_cc_ops_s * const g_tcp_cc_ops[] =
+{
+  &g_tcp_cc_reno,
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+  &g_tcp_cc_bbr,
+#endif
+};
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_reno_ssthresh
+ *
+ * Description:
+ *   ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_reno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->tx_unacked / 2, 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: tcp_reno_cong_avoid
+ *
+ * Description:
+ *   Grow cwnd by slow start below ssthresh, then by about one segment per
+ *   RTT (RFC 5681).
+ *
+ ****************************************************************************/
+
+static void tcp_reno_cong_avoid(FAR struct tcp_conn_s *conn,
+                                uint32_t acked)
+{
+  uint32_t increase;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      tcp_cc_slow_start(conn, acked);
+    }
+  else
+    {
+      /* cong avoid (RFC 5681):
+       * Grow cwnd linearly by approximately maxseg per RTT using
+       * maxseg^2 / cwnd per ACK as the increment.
+       * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
+       * avoid capping cwnd.
+       */
+
+      increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+
+      TCP_CC_CWND_INC(conn->cwnd, increase);
+      conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+      ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_reno_timeout
+ *
+ * Description:
+ *   Age the cwnd limit on a retransmission timeout.
+ *
+ ****************************************************************************/
+
+static void tcp_reno_timeout(FAR struct tcp_conn_s *conn)
+{
+  /* update the max_cwnd */
+
+  conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_find
+ *
+ * Description:
+ *   Find a congestion control algorithm by name.
+ *
+ ****************************************************************************/
+
+static FAR const struct tcp_cc_ops_s *tcp_cc_find(FAR const char *name,
+                                                  size_t len)
+{
+  int i;
+
+  len = strnlen(name, MIN(len, TCP_CC_NAME_MAX));
+  for (i = 0; i < nitems(g_tcp_cc_ops); i++)
+    {
+      if (strlen(g_tcp_cc_ops[i]->name) == len &&
+          strncmp(g_tcp_cc_ops[i]->name, name, len) == 0)
+        {
+          return g_tcp_cc_ops[i];
+        }
+    }
+
+  return NULL;
+}
+
+#ifdef CONFIG_NET_TCP_PACING
+/****************************************************************************
+ * Name: tcp_pacing_work
+ *
+ * Description:
+ *   Poll a paced connection again once its next send is due.
+ *
+ ****************************************************************************/
+
+static void tcp_pacing_work(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = NULL;
+
+  tcp_conn_list_lock();
+
+  while ((conn = tcp_nextconn(conn)) != NULL)
+    {
+      if (conn == arg)
+        {
+          tcp_conn_list_unlock();
+          netdev_lock(conn->dev);
+          netdev_txnotify_dev(conn->dev, TCP_POLL);
+          netdev_unlock(conn->dev);
+          return;
+        }
+    }
+
+  tcp_conn_list_unlock();
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_expiry
+ *
+ * Description:
+ *   The pacing timer expired, poll the connection from the work queue.
+ *
+ ****************************************************************************/
+
+static uint64_t tcp_pacing_expiry(FAR const hrtimer_t *hrtimer,
+                                  uint64_t expired)
+{
+  FAR struct tcp_conn_s *conn =
+    container_of(hrtimer, struct tcp_conn_s, pacing_timer);
+
+  work_queue(LPWORK, &conn->pacing_work, tcp_pacing_work, conn, 0);
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -117,6 +288,20 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
   conn->ssthresh = 2 * TCP_IPV4_DEFAULT_MSS;
   conn->dupacks = 0;
+
+  /* A listener passes its algorithm on, otherwise use the default one */
+
+  conn->cc_ops = tcp_cc_get(conn);
+
+#ifdef CONFIG_NET_TCP_PACING
+  conn->pacing_rate = 0;
+  hrtimer_init(&conn->pacing_timer, tcp_pacing_expiry);
+#endif
+
+  if (conn->cc_ops->init != NULL)
+    {
+      conn->cc_ops->init(conn);
+    }
 }
 
 /****************************************************************************
@@ -148,7 +333,7 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+      conn->ssthresh = conn->cc_ops->ssthresh(conn);
       conn->cwnd = conn->ssthresh + 3 * conn->mss;
 
       conn->flags &= ~TCP_INFT;
@@ -217,7 +402,7 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
             {
               /* Inflate the congestion window */
 
-              CC_CWND_INC(conn->cwnd, conn->mss);
+              TCP_CC_CWND_INC(conn->cwnd, conn->mss);
             }
 
           if (conn->dupacks >= TCP_FAST_RETRANSMISSION_THRESH)
@@ -243,6 +428,20 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
       conn->dupacks = 0;
       conn->last_ackno = ackno;
 
+      /* The algorithm handles all of cwnd by itself */
+
+      if (conn->cc_ops->cong_control != NULL)
+        {
+          if ((conn->flags & TCP_INFR) != 0 &&
+              ackno - 1 > conn->fr_recover)
+            {
+              conn->flags &= ~TCP_INFR;
+            }
+
+          conn->cc_ops->cong_control(conn, acked);
+          return;
+        }
+
       /* When the ackno covers more than the fr_recover, exit the
        * fast recovery. Then, reset the "IN Fast Recovery" flags.
        * Also reset the congestion window to the slow start threshold.
@@ -260,7 +459,7 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
             }
           else
             {
-              CC_CWND_INC(conn->cwnd, conn->mss);
+              TCP_CC_CWND_INC(conn->cwnd, conn->mss);
               return;
             }
         }
@@ -269,34 +468,262 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 
       if (conn->tcpstateflags >= TCP_ESTABLISHED)
         {
-          uint32_t increase;
+          conn->cc_ops->cong_avoid(conn, acked);
+        }
+    }
+}
 
-          if (conn->cwnd < conn->ssthresh)
-            {
-              /* slow start (RFC 5681):
-               * Grow cwnd exponentially by maxseg(smss) per ACK.
-               */
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables on a retransmission timeout.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
 
-              increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  /* If conn is TCP_INFR, it should enter to slow start */
 
-              CC_CWND_INC(conn->cwnd, increase);
-              ninfo("update slow start cwnd to %u\n", conn->cwnd);
-            }
-          else
-            {
-              /* cong avoid (RFC 5681):
-               * Grow cwnd linearly by approximately maxseg per RTT using
-               * maxseg^2 / cwnd per ACK as the increment.
-               * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
-               * avoid capping cwnd.
-               */
+  if (conn->flags & TCP_INFR)
+    {
+      conn->flags &= ~TCP_INFR;
+    }
 
-              increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+  /* reset cwnd and ssthresh, refers to RFC5861. */
 
-              CC_CWND_INC(conn->cwnd, increase);
-              conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
-              ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
-            }
+  conn->ssthresh = conn->cc_ops->ssthresh(conn);
+  if (conn->cc_ops->timeout != NULL)
+    {
+      conn->cc_ops->timeout(conn);
+    }
+
+  conn->cwnd = conn->mss;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_slow_start
+ *
+ * Description:
+ *   Grow cwnd by at most one segment for "acked" newly ACKed bytes
+ *   (RFC 5681 slow start).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   acked  - The number of newly ACKed bytes
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_slow_start(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  /* slow start (RFC 5681):
+   * Grow cwnd exponentially by maxseg(smss) per ACK.
+   */
+
+  uint32_t increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+
+  TCP_CC_CWND_INC(conn->cwnd, increase);
+  ninfo("update slow start cwnd to %u\n", conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_set
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name
+ *   (TCP_CONGESTION socket option).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm, not necessarily NUL terminated
+ *   len    - The maximum length of the name
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_set(FAR struct tcp_conn_s *conn, FAR const char *name,
+               size_t len)
+{
+  FAR const struct tcp_cc_ops_s *ops = tcp_cc_find(name, len);
+
+  if (ops == NULL)
+    {
+      return -ENOENT;
+    }
+
+  if (ops == conn->cc_ops)
+    {
+      return OK;
+    }
+
+  conn->cc_ops = ops;
+
+  /* A running connection keeps cwnd and restarts the new algorithm from
+   * there, otherwise tcp_cc_init() will do it when the connection starts.
+   */
+
+  if (conn->tcpstateflags != TCP_ALLOCATED)
+    {
+#ifdef CONFIG_NET_TCP_PACING
+      conn->pacing_rate = 0;
+#endif
+      if (ops->init != NULL)
+        {
+          ops->init(conn);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_get
+ *
+ * Description:
+ *   Return the congestion control algorithm of a connection, the default
+ *   one if none has been selected yet.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ ****************************************************************************/
+
+FAR const struct tcp_cc_ops_s *tcp_cc_get(FAR struct tcp_conn_s *conn)
+{
+  FAR const struct tcp_cc_ops_s *ops = conn->cc_ops;
+
+  if (ops == NULL)
+    {
+      ops = tcp_cc_find(CONFIG_NET_TCP_CC_DEFAULT, TCP_CC_NAME_MAX);
+      if (ops == NULL)
+        {
+          ops = &g_tcp_cc_reno;
         }
     }
+
+  return ops;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_gettime
+ *
+ * Description:
+ *   Return the current time in nanoseconds, as used by the congestion
+ *   control algorithms and pacing.
+ *
+ ****************************************************************************/
+
+uint64_t tcp_cc_gettime(void)
+{
+  struct timespec ts;
+
+  clock_systime_timespec(&ts);
+  return clock_time2nsec(&ts);
+}
+
+#ifdef CONFIG_NET_TCP_PACING
+/****************************************************************************
+ * Name: tcp_pacing_ready
+ *
+ * Description:
+ *   Check whether the pacing rate of the connection allows to send new
+ *   data now.  If not, a timer is armed to poll the connection again when
+ *   it does.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   true if data may be sent now.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_pacing_ready(FAR struct tcp_conn_s *conn)
+{
+  if (conn->pacing_rate == 0 || tcp_cc_gettime() >= conn->pacing_next)
+    {
+      return true;
+    }
+
+  hrtimer_start(&conn->pacing_timer, conn->pacing_next, HRTIMER_MODE_ABS);
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_sent
+ *
+ * Description:
+ *   Account "len" bytes of new data sent, to delay the next send according
+ *   to the pacing rate.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   len    - The number of bytes sent
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_pacing_sent(FAR struct tcp_conn_s *conn, uint32_t len)
+{
+  uint64_t now;
+
+  if (conn->pacing_rate == 0)
+    {
+      return;
+    }
+
+  /* Do not save up credit while idle, the next send is due "len" bytes
+   * at the pacing rate after this one.
+   */
+
+  now = tcp_cc_gettime();
+  if (conn->pacing_next < now)
+    {
+      conn->pacing_next = now;
+    }
+
+  conn->pacing_next += (uint64_t)len * NSEC_PER_SEC / conn->pacing_rate;
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_stop
+ *
+ * Description:
+ *   Cancel the pacing timer of a connection that is being freed.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ ****************************************************************************/
+
+void tcp_pacing_stop(FAR struct tcp_conn_s *conn)
+{
+  hrtimer_cancel_sync(&conn->pacing_timer);
+  work_cancel(LPWORK, &conn->pacing_work);
 }
+#endif /* CONFIG_NET_TCP_PACING */
@@ -0,0 +1,544 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_bbr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Gains are scaled by BBR_UNIT */
+
+#define BBR_UNIT               256
+#define BBR_HIGH_GAIN          739     /* 2 / ln(2) */
+#define BBR_DRAIN_GAIN         88      /* ln(2) / 2 */
+#define BBR_CWND_GAIN          512
+#define BBR_CYCLE_LEN          8
+
+/* Bandwidth must grow by 25% per round in STARTUP, or the pipe is full
+ * after three rounds.
+ */
+
+#define BBR_FULL_BW_THRESH     320
+#define BBR_FULL_BW_ROUNDS     3
+
+#define BBR_MIN_RTT_WIN_US     (10 * USEC_PER_SEC)
+#define BBR_PROBE_RTT_US       (200 * USEC_PER_MSEC)
+#define BBR_MIN_CWND(conn)     (4 * (uint32_t)(conn)->mss)
+
+/* The pacing rate is set 1% below the estimated bandwidth, so that the
+ * bottleneck queue drains over time.
+ */
+
+#define BBR_PACING_MARGIN      99
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum tcp_bbr_state_e
+{
+  BBR_STARTUP = 0,        /* Ramp up quickly to find the bandwidth */
+  BBR_DRAIN,              /* Drain the queue built up in STARTUP */
+  BBR_PROBE_BW,           /* Cycle the pacing gain around the bandwidth */
+  BBR_PROBE_RTT           /* Drain the pipe to measure the minimum RTT */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint16_t g_bbr_cycle_gain[BBR_CYCLE_LEN] =
+{
+  BBR_UNIT * 5 / 4, BBR_UNIT * 3 / 4, BBR_UNIT, BBR_UNIT,
+  BBR_UNIT, BBR_UNIT, BBR_UNIT, BBR_UNIT
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_bbr_max_bw
+ *
+ * Description:
+ *   Return the bottleneck bandwidth, the maximum delivery rate of the last
+ *   TCP_BBR_BW_RTTS rounds, in bytes per second.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_bbr_max_bw(FAR struct tcp_bbr_s *bbr)
+{
+  uint32_t bw = 0;
+  int i;
+
+  for (i = 0; i < TCP_BBR_BW_RTTS; i++)
+    {
+      bw = MAX(bw, bbr->bw[i]);
+    }
+
+  return bw;
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_bdp
+ *
+ * Description:
+ *   Return the bandwidth-delay product scaled by gain, UINT32_MAX while
+ *   there is no estimate yet.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_bbr_bdp(FAR struct tcp_bbr_s *bbr, uint32_t bw,
+                            uint32_t gain)
+{
+  uint64_t bdp;
+
+  if (bw == 0 || bbr->min_rtt == 0)
+    {
+      return UINT32_MAX;
+    }
+
+  bdp = (uint64_t)bw * bbr->min_rtt / USEC_PER_SEC * gain / BBR_UNIT;
+  return MIN(bdp, UINT32_MAX);
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_save_cwnd
+ *
+ * Description:
+ *   Remember cwnd before fast recovery or PROBE_RTT reduces it.
+ *
+ ****************************************************************************/
+
+static void tcp_bbr_save_cwnd(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+
+  if (!bbr->in_recovery && bbr->state != BBR_PROBE_RTT)
+    {
+      bbr->prior_cwnd = conn->cwnd;
+    }
+  else
+    {
+      bbr->prior_cwnd = MAX(bbr->prior_cwnd, conn->cwnd);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_enter_probe_bw
+ *
+ * Description:
+ *   Start the gain cycle at a pseudo-random phase, but never at the
+ *   draining phase.
+ *
+ ****************************************************************************/
+
+static void tcp_bbr_enter_probe_bw(FAR struct tcp_bbr_s *bbr, uint64_t now)
+{
+  bbr->state       = BBR_PROBE_BW;
+  bbr->cycle       = (now % (BBR_CYCLE_LEN - 1) + 2) % BBR_CYCLE_LEN;
+  bbr->cycle_stamp = now;
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_update_sample
+ *
+ * Description:
+ *   Take one delivery rate and RTT sample per round trip: a sample starts
+ *   at an ACK and ends when the data sent after it is ACKed.
+ *
+ * Returned Value:
+ *   True if a round trip ended with this ACK.
+ *
+ ****************************************************************************/
+
+static bool tcp_bbr_update_sample(FAR struct tcp_conn_s *conn,
+                                  uint64_t now)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  bool round_start = false;
+  uint64_t interval;
+  uint64_t bw;
+
+  if (bbr->rs_active && TCP_SEQ_GT(conn->last_ackno, bbr->rs_seq))
+    {
+      bbr->rs_active = false;
+      interval = now - bbr->rs_stamp;
+
+      if (interval > 0)
+        {
+          bw = (uint64_t)(bbr->delivered - bbr->rs_delivered) *
+               USEC_PER_SEC / interval;
+
+          bbr->round++;
+          bbr->bw[bbr->round % TCP_BBR_BW_RTTS] = MIN(bw, UINT32_MAX);
+          round_start = true;
+
+          interval = MIN(interval, UINT32_MAX);
+          if (bbr->min_rtt == 0 || interval <= bbr->min_rtt ||
+              now - bbr->min_rtt_stamp > BBR_MIN_RTT_WIN_US)
+            {
+              bbr->min_rtt       = interval;
+              bbr->min_rtt_stamp = now;
+            }
+        }
+    }
+
+  if (!bbr->rs_active)
+    {
+      bbr->rs_active    = true;
+      bbr->rs_stamp     = now;
+      bbr->rs_delivered = bbr->delivered;
+      bbr->rs_seq       = conn->sndseq_max;
+    }
+
+  return round_start;
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_update_state
+ *
+ * Description:
+ *   Run the BBR state machine.
+ *
+ ****************************************************************************/
+
+static void tcp_bbr_update_state(FAR struct tcp_conn_s *conn,
+                                 uint64_t now, uint32_t bw,
+                                 bool round_start, bool rtt_expired)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  uint32_t gain;
+  bool elapsed;
+  bool advance;
+
+  if (round_start && !bbr->full_pipe)
+    {
+      if (bw >= (uint64_t)bbr->full_bw * BBR_FULL_BW_THRESH / BBR_UNIT)
+        {
+          bbr->full_bw     = bw;
+          bbr->full_bw_cnt = 0;
+        }
+      else if (++bbr->full_bw_cnt >= BBR_FULL_BW_ROUNDS)
+        {
+          bbr->full_pipe = true;
+        }
+    }
+
+  if (bbr->state == BBR_STARTUP && bbr->full_pipe)
+    {
+      bbr->state = BBR_DRAIN;
+    }
+
+  if (bbr->state == BBR_DRAIN)
+    {
+      if (conn->tx_unacked <= tcp_bbr_bdp(bbr, bw, BBR_UNIT))
+        {
+          tcp_bbr_enter_probe_bw(bbr, now);
+        }
+    }
+  else if (bbr->state == BBR_PROBE_BW)
+    {
+      /* Probe for more bandwidth for one min_rtt, then drain what that
+       * queued and cruise at the estimated bandwidth.
+       */
+
+      gain    = g_bbr_cycle_gain[bbr->cycle];
+      elapsed = now - bbr->cycle_stamp > bbr->min_rtt;
+
+      if (gain > BBR_UNIT)
+        {
+          advance = elapsed && ((conn->flags & TCP_INFR) != 0 ||
+                    conn->tx_unacked >= tcp_bbr_bdp(bbr, bw, gain));
+        }
+      else if (gain < BBR_UNIT)
+        {
+          advance = elapsed ||
+                    conn->tx_unacked <= tcp_bbr_bdp(bbr, bw, BBR_UNIT);
+        }
+      else
+        {
+          advance = elapsed;
+        }
+
+      if (advance)
+        {
+          bbr->cycle       = (bbr->cycle + 1) % BBR_CYCLE_LEN;
+          bbr->cycle_stamp = now;
+        }
+    }
+
+  /* The minimum RTT has not been seen again for a while, drain the pipe
+   * to measure it.
+   */
+
+  if (rtt_expired && bbr->state != BBR_PROBE_RTT)
+    {
+      tcp_bbr_save_cwnd(conn);
+      bbr->state          = BBR_PROBE_RTT;
+      bbr->probe_done = 0;
+    }
+
+  if (bbr->state == BBR_PROBE_RTT)
+    {
+      if (bbr->probe_done == 0 &&
+          conn->tx_unacked <= BBR_MIN_CWND(conn))
+        {
+          bbr->probe_done  = now + BBR_PROBE_RTT_US;
+          bbr->probe_round = false;
+        }
+      else if (bbr->probe_done != 0)
+        {
+          if (round_start)
+            {
+              bbr->probe_round = true;
+            }
+
+          if (bbr->probe_round && now >= bbr->probe_done)
+            {
+              bbr->min_rtt_stamp = now;
+              conn->cwnd         = MAX(conn->cwnd, bbr->prior_cwnd);
+
+              if (bbr->full_pipe)
+                {
+                  tcp_bbr_enter_probe_bw(bbr, now);
+                }
+              else
+                {
+                  bbr->state = BBR_STARTUP;
+                }
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_set_pacing
+ *
+ * Description:
+ *   Pace at the bottleneck bandwidth times the gain of the current state.
+ *
+ ****************************************************************************/
+
+static void tcp_bbr_set_pacing(FAR struct tcp_conn_s *conn, uint32_t bw)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  uint64_t rate;
+  uint32_t gain;
+
+  /* Keep sending unpaced until there is a first estimate */
+
+  if (bw == 0)
+    {
+      return;
+    }
+
+  switch (bbr->state)
+    {
+      case BBR_STARTUP:
+        gain = BBR_HIGH_GAIN;
+        break;
+
+      case BBR_DRAIN:
+        gain = BBR_DRAIN_GAIN;
+        break;
+
+      case BBR_PROBE_BW:
+        gain = g_bbr_cycle_gain[bbr->cycle];
+        break;
+
+      default:
+        gain = BBR_UNIT;
+        break;
+    }
+
+  rate = (uint64_t)bw * gain / BBR_UNIT * BBR_PACING_MARGIN / 100;
+  rate = MIN(MAX(rate, 1), UINT32_MAX);
+
+  /* Do not slow down before the bandwidth is known */
+
+  if (bbr->full_pipe || rate > conn->pacing_rate)
+    {
+      conn->pacing_rate = rate;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_set_cwnd
+ *
+ * Description:
+ *   Bound cwnd by twice the bandwidth-delay product, and conserve packets
+ *   during fast recovery.
+ *
+ ****************************************************************************/
+
+static void tcp_bbr_set_cwnd(FAR struct tcp_conn_s *conn, uint32_t bw,
+                             uint32_t acked)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  uint32_t target;
+  uint32_t gain;
+
+  if ((conn->flags & TCP_INFR) != 0)
+    {
+      /* Send one segment for each one that left the network */
+
+      bbr->in_recovery = true;
+      conn->cwnd = MAX(conn->tx_unacked + acked, BBR_MIN_CWND(conn));
+      return;
+    }
+
+  if (bbr->in_recovery)
+    {
+      bbr->in_recovery = false;
+      conn->cwnd = MAX(conn->cwnd, bbr->prior_cwnd);
+    }
+
+  gain = bbr->state == BBR_PROBE_BW || bbr->state == BBR_PROBE_RTT ?
+         BBR_CWND_GAIN : BBR_HIGH_GAIN;
+  target = tcp_bbr_bdp(bbr, bw, gain);
+  if (target != UINT32_MAX)
+    {
+      target += 3 * conn->mss;
+    }
+
+  if (bbr->full_pipe)
+    {
+      TCP_CC_CWND_INC(conn->cwnd, acked);
+      conn->cwnd = MIN(conn->cwnd, target);
+    }
+  else if (conn->cwnd < target)
+    {
+      TCP_CC_CWND_INC(conn->cwnd, acked);
+    }
+
+  conn->cwnd = MAX(conn->cwnd, BBR_MIN_CWND(conn));
+
+  if (bbr->state == BBR_PROBE_RTT)
+    {
+      conn->cwnd = MIN(conn->cwnd, BBR_MIN_CWND(conn));
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_init
+ *
+ * Description:
+ *   Reset the state of BBR and start in STARTUP.
+ *
+ ****************************************************************************/
+
+static void tcp_bbr_init(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+
+  memset(bbr, 0, sizeof(*bbr));
+  bbr->state         = BBR_STARTUP;
+  bbr->min_rtt_stamp = tcp_cc_gettime() / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_ssthresh
+ *
+ * Description:
+ *   BBR does not react to a loss by itself, keep what is in flight.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_bbr_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  tcp_bbr_save_cwnd(conn);
+  return MAX(conn->tx_unacked, BBR_MIN_CWND(conn));
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_cong_control
+ *
+ * Description:
+ *   Update the model of the path and set cwnd and the pacing rate from it.
+ *
+ ****************************************************************************/
+
+static void tcp_bbr_cong_control(FAR struct tcp_conn_s *conn,
+                                 uint32_t acked)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  uint64_t now = tcp_cc_gettime() / NSEC_PER_USEC;
+  bool rtt_expired;
+  bool round_start;
+  uint32_t bw;
+
+  bbr->delivered += acked;
+
+  rtt_expired = now - bbr->min_rtt_stamp > BBR_MIN_RTT_WIN_US;
+  round_start = tcp_bbr_update_sample(conn, now);
+  bw          = tcp_bbr_max_bw(bbr);
+
+  tcp_bbr_update_state(conn, now, bw, round_start, rtt_expired);
+  tcp_bbr_set_pacing(conn, bw);
+  tcp_bbr_set_cwnd(conn, bw, acked);
+
+  ninfo("bbr state %u bw %" PRIu32 " min_rtt %" PRIu32 " cwnd %" PRIu32
+        "\n", bbr->state, bw, bbr->min_rtt, conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: tcp_bbr_timeout
+ *
+ * Description:
+ *   The retransmission timeout invalidates the running sample and ends
+ *   recovery, cwnd grows back from one segment.
+ *
+ ****************************************************************************/
+
+static void tcp_bbr_timeout(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+
+  bbr->rs_active   = false;
+  bbr->in_recovery = false;
+}
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_bbr =
+{
+  "bbr",                  /* name */
+  tcp_bbr_init,           /* init */
+  tcp_bbr_ssthresh,       /* ssthresh */
+  NULL,                   /* cong_avoid */
+  tcp_bbr_cong_control,   /* cong_control */
+  tcp_bbr_timeout         /* timeout */
+};
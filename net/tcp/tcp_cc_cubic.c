@@ -0,0 +1,227 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The constants of RFC 9438, scaled by CUBIC_SCALE:
+ *
+ *   beta  = 0.7                        multiplicative decrease
+ *   c     = 0.4                        cubic growth (segments / s^3)
+ *   alpha = 3 * (1 - beta) / (1 + beta) Reno-friendly growth per RTT
+ */
+
+#define CUBIC_SCALE            1024
+#define CUBIC_BETA             717
+#define CUBIC_C                410
+#define CUBIC_ALPHA            542
+
+/* Do not evaluate the cubic function further than 100s from its plateau,
+ * the cube then still fits in 64 bits.
+ */
+
+#define CUBIC_MAX_DELTA_MS     100000
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cubic_cbrt
+ *
+ * Description:
+ *   Integer cube root, rounded down.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_cbrt(uint64_t x)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      b = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_init
+ *
+ * Description:
+ *   Reset the state of CUBIC.
+ *
+ ****************************************************************************/
+
+static void tcp_cubic_init(FAR struct tcp_conn_s *conn)
+{
+  memset(&conn->cc.cubic, 0, sizeof(conn->cc.cubic));
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_ssthresh
+ *
+ * Description:
+ *   Remember the cwnd at the loss as plateau of the next epoch (with fast
+ *   convergence) and reduce the window by beta.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cc.cubic;
+
+  /* Fast convergence: release bandwidth to new flows if the plateau is
+   * getting lower.
+   */
+
+  if (conn->cwnd < cubic->w_max)
+    {
+      cubic->w_max = (uint64_t)conn->cwnd * (CUBIC_SCALE + CUBIC_BETA) /
+                     (2 * CUBIC_SCALE);
+    }
+  else
+    {
+      cubic->w_max = conn->cwnd;
+    }
+
+  cubic->in_epoch = false;
+
+  return MAX((uint64_t)conn->tx_unacked * CUBIC_BETA / CUBIC_SCALE,
+             2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_cong_avoid
+ *
+ * Description:
+ *   Slow start below ssthresh, then grow cwnd towards the cubic function
+ *   of the time since the epoch started, or the Reno-friendly estimate if
+ *   that is larger.
+ *
+ ****************************************************************************/
+
+static void tcp_cubic_cong_avoid(FAR struct tcp_conn_s *conn,
+                                 uint32_t acked)
+{
+  FAR struct tcp_cubic_s *cubic = &conn->cc.cubic;
+  clock_t now = clock_systime_ticks();
+  int64_t delta;
+  int64_t target;
+  uint32_t increase;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      tcp_cc_slow_start(conn, acked);
+      return;
+    }
+
+  if (!cubic->in_epoch)
+    {
+      cubic->in_epoch = true;
+      cubic->epoch    = now;
+      cubic->w_est    = conn->cwnd;
+
+      if (conn->cwnd < cubic->w_max)
+        {
+          /* K = cbrt((w_max - cwnd) / c), in ms with the difference in
+           * 1/CUBIC_SCALE segments.
+           */
+
+          cubic->k      = tcp_cubic_cbrt((uint64_t)(cubic->w_max -
+                                                    conn->cwnd) *
+                                         CUBIC_SCALE / conn->mss *
+                                         1000000000 / CUBIC_C);
+          cubic->origin = cubic->w_max;
+        }
+      else
+        {
+          cubic->k      = 0;
+          cubic->origin = conn->cwnd;
+        }
+    }
+
+  /* W_cubic(t) = c * (t - K)^3 + origin */
+
+  delta = (int64_t)TICK2MSEC(now - cubic->epoch) - cubic->k;
+  delta = MIN(MAX(delta, -CUBIC_MAX_DELTA_MS), CUBIC_MAX_DELTA_MS);
+
+  target = CUBIC_C * delta * delta * delta / 1000000000;
+  target = cubic->origin + target * conn->mss / CUBIC_SCALE;
+
+  /* Grow at most by half the window per RTT */
+
+  target = MIN(target, (int64_t)conn->cwnd * 3 / 2);
+
+  /* Reno-friendly region: never grow slower than Reno would */
+
+  TCP_CC_CWND_INC(cubic->w_est, (uint64_t)CUBIC_ALPHA * conn->mss * acked /
+                                ((uint64_t)CUBIC_SCALE * conn->cwnd));
+  target = MAX(target, (int64_t)cubic->w_est);
+
+  if (target > conn->cwnd)
+    {
+      increase = (uint64_t)(target - conn->cwnd) * acked / conn->cwnd;
+    }
+  else
+    {
+      increase = (uint64_t)conn->mss * acked / (100 * (uint64_t)conn->cwnd);
+    }
+
+  TCP_CC_CWND_INC(conn->cwnd, MAX(increase, 1));
+  ninfo("update cubic cwnd to %" PRIu32 "\n", conn->cwnd);
+}
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",                /* name */
+  tcp_cubic_init,         /* init */
+  tcp_cubic_ssthresh,     /* ssthresh */
+  tcp_cubic_cong_avoid,   /* cong_avoid */
+  NULL,                   /* cong_control */
+  NULL                    /* timeout */
+};
@@ -71,6 +71,7 @@
 #include "icmpv6/icmpv6.h"
 #include "nat/nat.h"
 #include "netdev/netdev.h"
+#include "socket/socket.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -95,10 +96,108 @@ NET_BUFPOOL_DECLARE(g_tcp_connections, sizeof(struct tcp_conn_s),
 
 static dq_queue_t g_active_tcp_connections;
 
+#if CONFIG_NET_TCP_HASH_BITS > 0
+/* The same connections indexed by remote address and port pair */
+
+static DECLARE_HASHTABLE(g_tcp_hashtable, CONFIG_NET_TCP_HASH_BITS);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#if CONFIG_NET_TCP_HASH_BITS > 0
+/****************************************************************************
+ * Name: tcp_ipv4_hashkey
+ *
+ * Description:
+ *   Create the hash key of an IPv4 connection from its remote address and
+ *   the port pair.  The local address is left out so that connections
+ *   bound to INADDR_ANY hash to the same bucket as the incoming segments.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline uint32_t tcp_ipv4_hashkey(in_addr_t raddr, uint16_t lport,
+                                        uint16_t rport)
+{
+  return NTOHL(raddr) ^ ((uint32_t)rport << 16) ^ lport;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_ipv6_hashkey
+ *
+ * Description:
+ *   Create the hash key of an IPv6 connection from the lower 64 bits of
+ *   its remote address and the port pair.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_hashkey(FAR const uint16_t *raddr,
+                                        uint16_t lport, uint16_t rport)
+{
+  return (((uint32_t)raddr[4] << 16) | raddr[5]) ^
+         (((uint32_t)raddr[6] << 16) | raddr[7]) ^
+         ((uint32_t)rport << 16) ^ lport;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_conn_hashkey
+ *
+ * Description:
+ *   Create the hash key of a connection that is (or is about to be) in the
+ *   active list.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_conn_hashkey(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_ipv4_hashkey(conn->u.ipv4.raddr, conn->lport,
+                              conn->rport);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_ipv6_hashkey(conn->u.ipv6.raddr, conn->lport,
+                              conn->rport);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+#endif /* CONFIG_NET_TCP_HASH_BITS > 0 */
+
+/****************************************************************************
+ * Name: tcp_addconn
+ *
+ * Description:
+ *   Put the connection into the list of active TCP connections.  The
+ *   addresses and ports of the connection must not change while it stays
+ *   in the list.
+ *
+ * Assumptions:
+ *   This function is called with the tcp conn list locked.
+ *
+ ****************************************************************************/
+
+static void tcp_addconn(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#if CONFIG_NET_TCP_HASH_BITS > 0
+  hashtable_add(g_tcp_hashtable, &conn->hnode, tcp_conn_hashkey(conn));
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -168,15 +267,28 @@ static inline FAR struct tcp_conn_s *
 {
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct tcp_conn_s *conn;
+#if CONFIG_NET_TCP_HASH_BITS > 0
+  FAR hash_node_t *node;
+#endif
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
-  while (conn)
+#if CONFIG_NET_TCP_HASH_BITS > 0
+  hashtable_for_every_possible(g_tcp_hashtable, node,
+                               tcp_ipv4_hashkey(srcipaddr, tcp->destport,
+                                                tcp->srcport))
+#else
+  for (conn = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+       conn != NULL; conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink)
+#endif
     {
+#if CONFIG_NET_TCP_HASH_BITS > 0
+      conn = container_of(node, struct tcp_conn_s, hnode);
+#endif
+
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
        *
@@ -201,19 +313,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv4addr_cmp(destipaddr, conn->u.ipv4.laddr)) &&
           net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -235,15 +341,28 @@ static inline FAR struct tcp_conn_s *
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct tcp_conn_s *conn;
+#if CONFIG_NET_TCP_HASH_BITS > 0
+  FAR hash_node_t *node;
+#endif
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
-  while (conn)
+#if CONFIG_NET_TCP_HASH_BITS > 0
+  hashtable_for_every_possible(g_tcp_hashtable, node,
+                               tcp_ipv6_hashkey(*srcipaddr, tcp->destport,
+                                                tcp->srcport))
+#else
+  for (conn = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+       conn != NULL; conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink)
+#endif
     {
+#if CONFIG_NET_TCP_HASH_BITS > 0
+      conn = container_of(node, struct tcp_conn_s, hnode);
+#endif
+
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
        *
@@ -268,21 +387,51 @@ static inline FAR struct tcp_conn_s *
            net_ipv6addr_cmp(*destipaddr, conn->u.ipv6.laddr)) &&
           net_ipv6addr_cmp(*srcipaddr, conn->u.ipv6.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
+    }
 
-      /* Look at the next active connection */
+  return NULL;
+}
+#endif /* CONFIG_NET_IPv6 */
 
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+/****************************************************************************
+ * Name: tcp_reuseport_bind
+ *
+ * Description:
+ *   Return true if the connection may bind to the port (network byte
+ *   order) because it joins a SO_REUSEPORT group that is already listening
+ *   on the same local address.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static bool tcp_reuseport_bind(FAR struct tcp_conn_s *conn,
+                               FAR const union ip_addr_u *ipaddr,
+                               uint16_t portno)
+{
+  FAR struct tcp_conn_s *listener;
+
+  if (portno == 0 || !_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return false;
     }
 
-  return conn;
+  /* As in tcp_listener(), laddr is at offset 0 of ip_binding_u */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  listener = tcp_findlistener((FAR union ip_binding_u *)ipaddr,
+                              portno, conn->domain);
+#else
+  listener = tcp_findlistener((FAR union ip_binding_u *)ipaddr, portno);
+#endif
+
+  return listener != NULL &&
+         _SO_GETOPT(listener->sconn.s_options, SO_REUSEPORT);
 }
-#endif /* CONFIG_NET_IPv6 */
+#endif
 
 /****************************************************************************
  * Name: tcp_ipv4_bind
@@ -341,13 +490,24 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   /* Verify or select a local port (network byte order) */
 
-  port = tcp_selectport(PF_INET,
-                       (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
-                       addr->sin_port);
-  if (port < 0)
+#ifdef CONFIG_NET_SOCKOPTS
+  if (tcp_reuseport_bind(conn,
+                         (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
+                         addr->sin_port))
     {
-      nerr("ERROR: tcp_selectport failed: %d\n", port);
-      return port;
+      port = addr->sin_port;
+    }
+  else
+#endif
+    {
+      port = tcp_selectport(PF_INET,
+                            (FAR const union ip_addr_u *)
+                            &addr->sin_addr.s_addr, addr->sin_port);
+      if (port < 0)
+        {
+          nerr("ERROR: tcp_selectport failed: %d\n", port);
+          return port;
+        }
     }
 
   /* Save the local address in the connection structure (network order). */
@@ -437,13 +597,26 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   /* The port number must be unique for this address binding */
 
-  port = tcp_selectport(PF_INET6,
-                (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
-                addr->sin6_port);
-  if (port < 0)
+#ifdef CONFIG_NET_SOCKOPTS
+  if (tcp_reuseport_bind(conn,
+                         (FAR const union ip_addr_u *)
+                         addr->sin6_addr.in6_u.u6_addr16,
+                         addr->sin6_port))
+    {
+      port = addr->sin6_port;
+    }
+  else
+#endif
     {
-      nerr("ERROR: tcp_selectport failed: %d\n", port);
-      return port;
+      port = tcp_selectport(PF_INET6,
+                            (FAR const union ip_addr_u *)
+                            addr->sin6_addr.in6_u.u6_addr16,
+                            addr->sin6_port);
+      if (port < 0)
+        {
+          nerr("ERROR: tcp_selectport failed: %d\n", port);
+          return port;
+        }
     }
 
   /* Save the local address in the connection structure (network order). */
@@ -812,13 +985,16 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       tcp_conn_list_lock();
-      dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_removeconn(conn);
       tcp_conn_list_unlock();
     }
 
   /* Cancel tcp timer */
 
   tcp_stop_timer(conn);
+#ifdef CONFIG_NET_TCP_PACING
+  tcp_pacing_stop(conn);
+#endif
 
   nxrmutex_destroy(&conn->sconn.s_lock);
   tcp_free_rx_buffers(conn);
@@ -1132,12 +1308,15 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       conn->snd_bufs         = listener->snd_bufs;
 #endif
       conn->mss              = listener->mss;
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      conn->cc_ops           = listener->cc_ops;
+#endif
 
       /* Fill in the necessary fields for the new connection. */
 
-      conn->rto              = TCP_RTO;
+      conn->rto              = TCP_RTO_INIT;
       conn->sa               = 0;
-      conn->sv               = 4;
+      conn->sv               = 4 * MSEC_PER_HSEC;
       conn->nrtx             = 0;
       conn->lport            = tcp->destport;
       conn->rport            = tcp->srcport;
@@ -1181,10 +1360,10 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       tcp_conn_list_lock();
-      dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_addconn(conn);
       tcp_conn_list_unlock();
 
-      tcp_update_retrantimer(conn, TCP_RTO);
+      tcp_update_retrantimer(conn, TCP_RTO_INIT);
     }
 
   return conn;
@@ -1450,9 +1629,9 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   conn->tx_unacked = 1;    /* TCP length of the SYN is one. */
   conn->nrtx       = 0;
   conn->timeout    = true; /* Send the SYN immediately. */
-  conn->rto        = TCP_RTO;
+  conn->rto        = TCP_RTO_INIT;
   conn->sa         = 0;
-  conn->sv         = 16;   /* Initial value of the RTT variance. */
+  conn->sv         = 16 * MSEC_PER_HSEC; /* Initial RTT variance */
   conn->lport      = (uint16_t)port;
 
   /* Set initial sndseq when we have both local/remote addr and port */
@@ -1490,7 +1669,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   tcp_conn_list_lock();
-  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_addconn(conn);
   tcp_conn_list_unlock();
 
   return OK;
@@ -1536,6 +1715,9 @@ void tcp_conn_list_unlock(void)
 void tcp_removeconn(FAR struct tcp_conn_s *conn)
 {
   dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+#if CONFIG_NET_TCP_HASH_BITS > 0
+  hashtable_delete(g_tcp_hashtable, &conn->hnode, tcp_conn_hashkey(conn));
+#endif
 }
 
 /****************************************************************************
@@ -1578,4 +1760,50 @@ void tcp_remove_syn_backlog(FAR struct tcp_conn_s *listener)
     }
 }
 
+/****************************************************************************
+ * Name: tcp_drop_synrcvd
+ *
+ * Description:
+ *   Free the SYN_RCVD connection that has retransmitted its SYN-ACK the
+ *   most times, to make room for a connection completed by a SYN cookie.
+ *
+ * Returned Value:
+ *   True if a connection was freed.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+bool tcp_drop_synrcvd(void)
+{
+  FAR struct tcp_conn_s *victim = NULL;
+  FAR struct tcp_conn_s *conn;
+
+  tcp_conn_list_lock();
+
+  for (conn = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+       conn != NULL;
+       conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink)
+    {
+      if (conn->tcpstateflags == TCP_SYN_RCVD &&
+          (victim == NULL || conn->nrtx > victim->nrtx))
+        {
+          victim = conn;
+        }
+    }
+
+  if (victim != NULL)
+    {
+      nwarn("WARNING: Dropping half-open connection: %p\n", victim);
+      victim->crefs = 0;
+      tcp_free(victim);
+    }
+
+  tcp_conn_list_unlock();
+  return victim != NULL;
+}
+#endif
+
 #endif /* CONFIG_NET && CONFIG_NET_TCP */
@@ -28,6 +28,7 @@
 
 #include <sys/time.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -221,6 +222,19 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        {
+          FAR const char *name = tcp_cc_get(conn)->name;
+          socklen_t len = MIN(*value_len, TCP_CC_NAME_MAX);
+
+          strncpy(value, name, len);
+          *value_len = len;
+          ret        = OK;
+        }
+        break;
+#endif /* CONFIG_NET_TCP_CC_NEWRENO */
+
       case TCP_MAXSEG:   /* The maximum segment size */
         if (*value_len < sizeof(int))
           {
@@ -693,6 +693,9 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
                       unsigned int iplen)
 {
   FAR struct tcp_conn_s *conn = NULL;
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+  FAR struct tcp_conn_s *listener;
+#endif
   FAR struct tcp_hdr_s *tcp;
   union ip_binding_u uaddr;
   unsigned int tcpiplen;
@@ -726,7 +729,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #ifdef CONFIG_NET_TCP_CHECKSUMS
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!net_chksum_verified(dev) && tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
@@ -896,6 +899,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #  endif
     {
       net_ipv6addr_copy(&uaddr.ipv6.laddr, IPv6BUF->destipaddr);
+      net_ipv6addr_copy(&uaddr.ipv6.raddr, IPv6BUF->srcipaddr);
     }
 #endif
 
@@ -906,6 +910,8 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
     {
       net_ipv4addr_copy(uaddr.ipv4.laddr,
                         net_ip4addr_conv32(IPv4BUF->destipaddr));
+      net_ipv4addr_copy(uaddr.ipv4.raddr,
+                        net_ip4addr_conv32(IPv4BUF->srcipaddr));
     }
 #endif
 
@@ -922,6 +928,27 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
       if ((tcp->flags & TCP_CTL) != TCP_SYN)
         {
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+          /* An ACK may complete a handshake answered with a SYN cookie */
+
+          if ((tcp->flags & (TCP_SYN | TCP_RST | TCP_FIN | TCP_ACK)) ==
+              TCP_ACK)
+            {
+              listener = conn;
+#ifdef CONFIG_NET_SOCKOPTS
+              listener = tcp_reuseport(listener, &uaddr, tcp->srcport);
+#endif
+              conn = tcp_syncookie_accept(dev, listener, &uaddr, domain,
+                                          iplen);
+              if (conn != NULL)
+                {
+                  goto found;
+                }
+
+              conn = listener;
+            }
+#endif
+
           if ((tcp->flags & TCP_ACK) != 0)
             {
               goto reset;
@@ -930,6 +957,12 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
           goto drop;
         }
 
+#ifdef CONFIG_NET_SOCKOPTS
+      /* Spread the connections over the members of a SO_REUSEPORT group */
+
+      conn = tcp_reuseport(conn, &uaddr, tcp->srcport);
+#endif
+
       if (!tcp_backlogavailable(conn))
         {
           nerr("ERROR: no free containers for TCP BACKLOG!\n");
@@ -945,6 +978,9 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
        * any user application to accept it.
        */
 
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+      listener = conn;
+#endif
       conn = tcp_alloc_accept(dev, tcp, conn);
       if (conn)
         {
@@ -970,6 +1006,18 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
           conn->crefs = 1;
         }
 
+#ifdef CONFIG_NET_TCP_SYNCOOKIES
+      if (!conn)
+        {
+          /* Out of connections: answer with a SYN cookie, which needs no
+           * state until the remote host returns it in its ACK.
+           */
+
+          tcp_syncookie_send(dev, listener, &uaddr, domain, iplen);
+          return;
+        }
+#endif
+
       if (!conn)
         {
           /* Either (1) all available connections are in use, or (2)
@@ -1099,7 +1147,7 @@ found:
 
   if (dev->d_len > 0)
     {
-      if ((g_netstats.tcp.recv %
+      if ((NET_STATS(tcp.recv) %
           CONFIG_NET_TCP_DEBUG_DROP_RECV_PROBABILITY) == 0)
         {
           uint32_t seq = tcp_getsequence(tcp->seqno);
@@ -1108,7 +1156,7 @@ found:
 
           ninfo("TCP DROP RCVPKT: "
                 "[%d][%" PRIu32 " : %" PRIu32 " : %d]\n",
-                g_netstats.tcp.drop, seq, TCP_SEQ_ADD(seq, dev->d_len),
+                NET_STATS(tcp.drop), seq, TCP_SEQ_ADD(seq, dev->d_len),
                 dev->d_len);
 
           goto drop;
@@ -1237,8 +1285,12 @@ found:
 
       if (conn->nrtx == 0)
         {
-          signed char m;
-          m = conn->rto - conn->timer;
+          int32_t m;
+
+          /* The sample is the time since the timer was last started */
+
+          tcp_sync_timer(conn);
+          m = conn->timer < conn->rto ? conn->rto - conn->timer : 0;
 
           /* This is taken directly from VJs original code in his paper */
 
@@ -1252,6 +1304,7 @@ found:
           m = m - (conn->sv >> 2);
           conn->sv += m;
           conn->rto = (conn->sa >> 3) + conn->sv;
+          conn->rto = MIN(MAX(conn->rto, TCP_RTO_MIN), TCP_RTO_MAX);
         }
 #endif
 
@@ -1716,7 +1769,7 @@ skip_rtt:
               {
                 conn->tcpstateflags = TCP_TIME_WAIT;
                 tcp_update_retrantimer(conn,
-                                       TCP_TIME_WAIT_TIMEOUT * HSEC_PER_SEC);
+                                       TCP_TIME_WAIT_TIMEOUT * MSEC_PER_SEC);
                 ninfo("TCP state: TCP_TIME_WAIT\n");
               }
             else
@@ -1751,7 +1804,7 @@ skip_rtt:
           {
             conn->tcpstateflags = TCP_TIME_WAIT;
             tcp_update_retrantimer(conn,
-                                   TCP_TIME_WAIT_TIMEOUT * HSEC_PER_SEC);
+                                   TCP_TIME_WAIT_TIMEOUT * MSEC_PER_SEC);
             ninfo("TCP state: TCP_TIME_WAIT\n");
 
             net_incr32(conn->rcvseq, 1); /* ack FIN */
@@ -1778,7 +1831,7 @@ skip_rtt:
           {
             conn->tcpstateflags = TCP_TIME_WAIT;
             tcp_update_retrantimer(conn,
-                                   TCP_TIME_WAIT_TIMEOUT * HSEC_PER_SEC);
+                                   TCP_TIME_WAIT_TIMEOUT * MSEC_PER_SEC);
             ninfo("TCP state: TCP_TIME_WAIT\n");
           }
 
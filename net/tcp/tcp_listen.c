@@ -55,15 +55,23 @@
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "socket/socket.h"
 #include "tcp/tcp.h"
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#if CONFIG_NET_TCP_HASH_BITS > 0
+/* The g_tcp_listeners hash all currently listening connections by port. */
+
+static DECLARE_HASHTABLE(g_tcp_listeners, CONFIG_NET_TCP_HASH_BITS);
+static int g_tcp_nlisteners;
+#else
 /* The tcp_listenports list all currently listening ports. */
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -89,18 +97,31 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno)
 #endif
 {
+  FAR struct tcp_conn_s *conn;
+#if CONFIG_NET_TCP_HASH_BITS > 0
+  FAR hash_node_t *node;
+#else
   int ndx;
+#endif
 
   /* Examine each connection structure in each slot of the listener list */
 
   tcp_conn_list_lock();
+#if CONFIG_NET_TCP_HASH_BITS > 0
+  hashtable_for_every_possible(g_tcp_listeners, node, portno)
+#else
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+#endif
     {
       /* Is this slot assigned?  If so, does the connection have the same
-       * local port number?
+       * local port number?  Listeners on other ports may share the bucket.
        */
 
-      FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
+#if CONFIG_NET_TCP_HASH_BITS > 0
+      conn = container_of(node, struct tcp_conn_s, lnode);
+#else
+      conn = tcp_listenports[ndx];
+#endif
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       if (tcp_conn_cmp(domain, (FAR const union ip_addr_u *)uaddr, portno,
                        conn))
@@ -119,10 +140,191 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
   return NULL;
 }
 
+/****************************************************************************
+ * Name: tcp_reuseport_member
+ *
+ * Description:
+ *   Return true if the listener belongs to the same SO_REUSEPORT group as
+ *   the leader: it has the option set and is bound to the same local
+ *   address and port.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static bool tcp_reuseport_member(FAR struct tcp_conn_s *leader,
+                                 FAR struct tcp_conn_s *conn)
+{
+  if (conn == NULL || conn->lport != leader->lport ||
+      !_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (leader->domain == PF_INET)
+#endif
+    {
+#ifdef CONFIG_NET_IPv6
+      if (conn->domain != PF_INET)
+        {
+          return false;
+        }
+#endif
+
+      return net_ipv4addr_cmp(conn->u.ipv4.laddr, leader->u.ipv4.laddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+#ifdef CONFIG_NET_IPv4
+      if (conn->domain != PF_INET6)
+        {
+          return false;
+        }
+#endif
+
+      return net_ipv6addr_cmp(conn->u.ipv6.laddr, leader->u.ipv6.laddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: tcp_reuseport_scan
+ *
+ * Description:
+ *   Walk the listeners in the SO_REUSEPORT group of the leader.  Return the
+ *   member number 'index' (counting from 0) and the number of members seen
+ *   on the way in 'count'.  An index past the end returns NULL and the
+ *   size of the group.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_conn_s *
+tcp_reuseport_scan(FAR struct tcp_conn_s *leader, uint32_t index,
+                   FAR uint32_t *count)
+{
+  FAR struct tcp_conn_s *conn;
+#if CONFIG_NET_TCP_HASH_BITS > 0
+  FAR hash_node_t *node;
+#else
+  int ndx;
+#endif
+
+  *count = 0;
+
+#if CONFIG_NET_TCP_HASH_BITS > 0
+  hashtable_for_every_possible(g_tcp_listeners, node, leader->lport)
+#else
+  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+#endif
+    {
+#if CONFIG_NET_TCP_HASH_BITS > 0
+      conn = container_of(node, struct tcp_conn_s, lnode);
+#else
+      conn = tcp_listenports[ndx];
+#endif
+      if (tcp_reuseport_member(leader, conn) && (*count)++ == index)
+        {
+          return conn;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: tcp_reuseport_hash
+ *
+ * Description:
+ *   Hash the remote address and the port pair of a connection.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_reuseport_hash(FAR struct tcp_conn_s *listener,
+                                   FAR const union ip_binding_u *uaddr,
+                                   uint16_t rport)
+{
+  uint32_t key = ((uint32_t)rport << 16) ^ listener->lport;
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (listener->domain == PF_INET)
+#endif
+    {
+      key ^= NTOHL(uaddr->ipv4.raddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      key ^= ((uint32_t)uaddr->ipv6.raddr[4] << 16) ^
+             uaddr->ipv6.raddr[5] ^
+             ((uint32_t)uaddr->ipv6.raddr[6] << 16) ^
+             uaddr->ipv6.raddr[7];
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+  return HASH(key, 32);
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_reuseport
+ *
+ * Description:
+ *   Given the listener returned by tcp_findlistener(), select the member of
+ *   its SO_REUSEPORT group that owns the connection from uaddr/rport.
+ *
+ * Assumptions:
+ *   This function is called from network logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct tcp_conn_s *tcp_reuseport(FAR struct tcp_conn_s *listener,
+                                     FAR const union ip_binding_u *uaddr,
+                                     uint16_t rport)
+{
+  FAR struct tcp_conn_s *conn;
+  uint32_t count;
+  uint32_t index;
+
+  if (!_SO_GETOPT(listener->sconn.s_options, SO_REUSEPORT))
+    {
+      return listener;
+    }
+
+  tcp_conn_list_lock();
+  tcp_reuseport_scan(listener, UINT32_MAX, &count);
+  if (count < 2)
+    {
+      tcp_conn_list_unlock();
+      return listener;
+    }
+
+  /* Map the flow hash onto [0, count) and pick that member */
+
+  index = ((uint64_t)tcp_reuseport_hash(listener, uaddr, rport) * count)
+          >> 32;
+  conn  = tcp_reuseport_scan(listener, index, &count);
+  tcp_conn_list_unlock();
+
+  return conn != NULL ? conn : listener;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_unlisten
  *
@@ -136,15 +338,32 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
+#if CONFIG_NET_TCP_HASH_BITS > 0
+  FAR hash_node_t *node;
+#else
   int ndx;
+#endif
   int ret = -EINVAL;
 
   tcp_conn_list_lock();
+#if CONFIG_NET_TCP_HASH_BITS > 0
+  hashtable_for_every_possible(g_tcp_listeners, node, conn->lport)
+#else
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+#endif
     {
+#if CONFIG_NET_TCP_HASH_BITS > 0
+      if (node == &conn->lnode)
+#else
       if (tcp_listenports[ndx] == conn)
+#endif
         {
+#if CONFIG_NET_TCP_HASH_BITS > 0
+          hashtable_delete(g_tcp_listeners, node, conn->lport);
+          g_tcp_nlisteners--;
+#else
           tcp_listenports[ndx] = NULL;
+#endif
           tcp_remove_syn_backlog(conn);
           ret = OK;
           break;
@@ -168,7 +387,10 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
+  FAR struct tcp_conn_s *listener;
+#if CONFIG_NET_TCP_HASH_BITS == 0
   int ndx;
+#endif
   int ret;
 
   /* This must be done with network locked because the listener table
@@ -177,13 +399,21 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
   tcp_conn_list_lock();
 
-  /* First, check if there is already a socket listening on this port */
+  /* First, check if there is already a socket listening on this port.
+   * Sockets that all set SO_REUSEPORT may share it.
+   */
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  if (tcp_islistener(&conn->u, conn->lport, conn->domain))
+  listener = tcp_findlistener(&conn->u, conn->lport, conn->domain);
 #else
-  if (tcp_islistener(&conn->u, conn->lport))
+  listener = tcp_findlistener(&conn->u, conn->lport);
+#endif
+  if (listener != NULL
+#ifdef CONFIG_NET_SOCKOPTS
+      && !(_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT) &&
+           _SO_GETOPT(listener->sconn.s_options, SO_REUSEPORT))
 #endif
+     )
     {
       /* Yes, then we must refuse this request */
 
@@ -197,6 +427,14 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
       ret = -ENOBUFS; /* Assume failure */
 
+#if CONFIG_NET_TCP_HASH_BITS > 0
+      if (g_tcp_nlisteners < CONFIG_NET_MAX_LISTENPORTS)
+        {
+          hashtable_add(g_tcp_listeners, &conn->lnode, conn->lport);
+          g_tcp_nlisteners++;
+          ret = OK;
+        }
+#else
       /* Search all slots until an available slot is found */
 
       for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
@@ -212,6 +450,7 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               break;
             }
         }
+#endif
     }
 
   tcp_conn_list_unlock();
@@ -271,6 +510,14 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
 #endif
   if (listener != NULL)
     {
+#ifdef CONFIG_NET_SOCKOPTS
+      /* Hand the connection to the same member of a SO_REUSEPORT group
+       * that answered its SYN.
+       */
+
+      listener = tcp_reuseport(listener, &conn->u, conn->rport);
+#endif
+
       /* Yes, there is a listener.  Is it accepting connections now? */
 
       if (listener->accept)
@@ -318,6 +318,15 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       eventset |= POLLRDNORM;
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* Check for MSG_ZEROCOPY completions to read with MSG_ERRQUEUE */
+
+  if (conn->zc_pending)
+    {
+      eventset |= POLLERR;
+    }
+#endif
+
   /* Check for a loss of connection events.  We need to be careful here.
    * There are four possibilities:
    *
@@ -456,3 +465,46 @@ int tcp_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: tcp_poll_zerocopy
+ *
+ * Description:
+ *   Wake up the pollers of a TCP/IP socket with POLLERR because a
+ *   MSG_ZEROCOPY completion can be read with MSG_ERRQUEUE.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection of interest
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+void tcp_poll_zerocopy(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_poll_s *info;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_TCP_NPOLLWAITERS; i++)
+    {
+      info = &conn->pollinfo[i];
+      if (info->conn == NULL || info->cb->event == NULL)
+        {
+          continue;
+        }
+
+      poll_notify(&info->fds, 1, POLLERR);
+
+      if (info->fds->revents != 0)
+        {
+          /* Stop further callbacks */
+
+          info->cb->flags = 0;
+          info->cb->priv  = NULL;
+          info->cb->event = NULL;
+        }
+    }
+}
+#endif
@@ -844,6 +844,62 @@ static ssize_t tcp_recvfrom_one(FAR struct tcp_conn_s *conn, FAR void *buf,
   return ret;
 }
 
+/****************************************************************************
+ * Name: tcp_recvfrom_errqueue
+ *
+ * Description:
+ *   Read the pending MSG_ZEROCOPY completions of the connection as one
+ *   IP_RECVERR/IPV6_RECVERR control message.
+ *
+ * Returned Value:
+ *   0 on success, -EAGAIN if there is nothing to read, -ENOBUFS if the
+ *   control buffer is too small.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+static ssize_t tcp_recvfrom_errqueue(FAR struct socket *psock,
+                                     FAR struct tcp_conn_s *conn,
+                                     FAR struct msghdr *msg)
+{
+  struct sock_extended_err serr;
+  FAR void *cmsg;
+
+  if (!conn->zc_pending)
+    {
+      return -EAGAIN;
+    }
+
+  memset(&serr, 0, sizeof(serr));
+  serr.ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+  serr.ee_info   = conn->zc_lo;
+  serr.ee_data   = conn->zc_hi;
+
+#ifdef CONFIG_NET_IPv6
+  if (psock->s_domain == PF_INET6)
+    {
+      cmsg = cmsg_append(msg, SOL_IPV6, IPV6_RECVERR, &serr, sizeof(serr));
+    }
+  else
+#endif
+    {
+      cmsg = cmsg_append(msg, SOL_IP, IP_RECVERR, &serr, sizeof(serr));
+    }
+
+  if (cmsg == NULL)
+    {
+      return -ENOBUFS;
+    }
+
+  msg->msg_flags  |= MSG_ERRQUEUE;
+  conn->zc_pending = false;
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -879,6 +935,20 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
   conn = psock->s_conn;
   conn_dev_lock(&conn->sconn, conn->dev);
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* The error queue only holds MSG_ZEROCOPY completions, it never
+   * blocks.
+   */
+
+  if ((flags & MSG_ERRQUEUE) != 0)
+    {
+      ret = tcp_recvfrom_errqueue(psock, conn, msg);
+      conn_dev_unlock(&conn->sconn, conn->dev);
+      return ret;
+    }
+#endif
+
   for (i = 0; i < msg->msg_iovlen; i++)
     {
       FAR void *buf = msg->msg_iov[i].iov_base;
@@ -149,7 +149,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     }
   else
     {
-      if (work_available(&conn->work) && conn->tx_unacked != 0)
+      if (conn->timer == 0 && conn->tx_unacked != 0)
         {
           conn->timeout = false;
           tcp_update_retrantimer(conn, conn->rto);
@@ -200,7 +200,10 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!net_chksum_offload(dev, IP_PROTO_TCP, &tcp->tcpchksum))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
@@ -224,7 +227,10 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!net_chksum_offload(dev, IP_PROTO_TCP, &tcp->tcpchksum))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
@@ -342,14 +348,14 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   if ((flags & TCP_PSH) != 0)
     {
-      if ((g_netstats.tcp.sent %
+      if ((NET_STATS(tcp.sent) %
           CONFIG_NET_TCP_DEBUG_DROP_SEND_PROBABILITY) == 0)
         {
           uint32_t seq = tcp_getsequence(tcp->seqno);
 
           ninfo("TCP DROP SNDPKT: "
                 "[%d][%" PRIu32 " : %" PRIu32 " : %d]\n",
-                g_netstats.tcp.sent, seq, TCP_SEQ_ADD(seq, dev->d_sndlen),
+                NET_STATS(tcp.sent), seq, TCP_SEQ_ADD(seq, dev->d_sndlen),
                 dev->d_sndlen);
 
           dev->d_len = 0;
@@ -507,7 +513,10 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!net_chksum_offload(dev, IP_PROTO_TCP, &tcp->tcpchksum))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
 #endif
     }
 #endif /* CONFIG_NET_IPv6 */
@@ -527,7 +536,10 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!net_chksum_offload(dev, IP_PROTO_TCP, &tcp->tcpchksum))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
 #endif
     }
 #endif /* CONFIG_NET_IPv4 */
@@ -411,6 +411,36 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
 }
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
 
+/****************************************************************************
+ * Name: tcp_max_send_size
+ *
+ * Description:
+ *   Return the largest amount of new data that may go into one packet:
+ *   one MSS, or a whole number of them when the device accepts TCP
+ *   super-frames.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_max_send_size(FAR struct net_driver_s *dev,
+                                  FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NETDEV_GSO
+  uint32_t hdrlen = NET_LL_HDRLEN(dev) + tcpip_hdrsize(conn);
+  uint32_t size;
+
+  if (dev->d_gsomax > NETDEV_PKTSIZE(dev) && dev->d_gsomax > hdrlen)
+    {
+      size = dev->d_gsomax - hdrlen;
+      if (size > conn->mss)
+        {
+          return size - size % conn->mss;
+        }
+    }
+#endif
+
+  return conn->mss;
+}
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -1056,15 +1086,22 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 #else
       snd_wnd_edge = conn->snd_wl2 + conn->snd_wnd;
 #endif
-      if (TCP_SEQ_LT(seq, snd_wnd_edge))
+
+      /* A paced connection may have to wait for the pacing timer */
+
+      if (TCP_SEQ_LT(seq, snd_wnd_edge)
+#ifdef CONFIG_NET_TCP_PACING
+          && tcp_pacing_ready(conn)
+#endif
+         )
         {
           uint32_t remaining_snd_wnd;
           int ret;
 
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > tcp_max_send_size(dev, conn))
             {
-              sndlen = conn->mss;
+              sndlen = tcp_max_send_size(dev, conn);
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1128,10 +1165,22 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
+#ifdef CONFIG_NETDEV_GSO
+          /* Let the driver cut a super-frame back into segments */
+
+          if (sndlen > conn->mss)
+            {
+              dev->d_gsosize = conn->mss;
+            }
+#endif
+
           ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen,
                                TCP_WBSENT(wrb), tcpip_hdrsize(conn));
           if (ret <= 0)
             {
+#ifdef CONFIG_NETDEV_GSO
+              dev->d_gsosize = 0;
+#endif
               return flags;
             }
 
@@ -1144,6 +1193,10 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           conn->tx_unacked += sndlen;
           conn->sent       += sndlen;
 
+#ifdef CONFIG_NET_TCP_PACING
+          tcp_pacing_sent(conn, sndlen);
+#endif
+
           /* Below prediction will become true,
            * unless retransmission occurrence
            */
@@ -1223,6 +1276,15 @@ static uint32_t tcp_max_wrb_size(FAR struct tcp_conn_s *conn)
 
   size = 4 * mss;
 
+#ifdef CONFIG_NETDEV_GSO
+  /* or a full super-frame, if the device takes them */
+
+  if (size < CONFIG_NETDEV_GSO_MAXSIZE)
+    {
+      size = CONFIG_NETDEV_GSO_MAXSIZE;
+    }
+#endif
+
   /* but it should not hog too many IOB buffers */
 
   if (size > CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE / 2)
@@ -1340,6 +1402,9 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   unsigned int timeout;
   ssize_t    result = 0;
   bool       nonblock;
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  bool       zerocopy;
+#endif
   int        ret = OK;
   clock_t    start;
 
@@ -1403,6 +1468,13 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   start    = clock_systime_ticks();
   timeout  = _SO_TIMEOUT(conn->sconn.s_sndtimeo);
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* MSG_ZEROCOPY is ignored unless SO_ZEROCOPY is set, as in Linux */
+
+  zerocopy = (flags & MSG_ZEROCOPY) != 0 &&
+             _SO_GETOPT(conn->sconn.s_options, SO_ZEROCOPY);
+#endif
+
   /* Dump the incoming buffer */
 
   BUF_DUMP("psock_tcp_send", buf, len);
@@ -1414,6 +1486,7 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
       unsigned int off;
       size_t chunk_len = len;
       ssize_t chunk_result;
+      bool fresh;
 
       conn_dev_lock(&conn->sconn, conn->dev);
 
@@ -1513,8 +1586,62 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
            */
 
           max_wrb_size = tcp_max_wrb_size(conn);
+          fresh = false;
           wrb = (FAR struct tcp_wrbuffer_s *)sq_tail(&conn->write_q);
-          if (wrb != NULL && TCP_WBSENT(wrb) == 0 && TCP_WBNRTX(wrb) == 0 &&
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+          if (zerocopy)
+            {
+              /* Queue the user buffer itself in one write buffer of up
+               * to 64KiB, without coalescing.  The caller gets a short
+               * count for the rest, which keeps one completion id per
+               * send() call.
+               */
+
+              if (chunk_len > UINT16_MAX - UINT16_MAX % conn->mss)
+                {
+                  chunk_len = UINT16_MAX - UINT16_MAX % conn->mss;
+                }
+
+              if (nonblock)
+                {
+                  wrb = tcp_wrbuffer_zcalloc(cp, chunk_len, 0);
+                }
+              else
+                {
+                  conn_dev_unlock(&conn->sconn, conn->dev);
+                  wrb = tcp_wrbuffer_zcalloc(cp, chunk_len,
+                                     tcp_send_gettimeout(start, timeout));
+                  conn_dev_lock(&conn->sconn, conn->dev);
+                }
+
+              if (wrb == NULL)
+                {
+                  nerr("ERROR: Failed to allocate write buffer\n");
+                  ret = nonblock || timeout != UINT_MAX ? -EAGAIN : -ENOMEM;
+                  goto errout_with_lock;
+                }
+
+              if (!_SS_ISCONNECTED(conn->sconn.s_flags))
+                {
+                  nerr("ERROR: No longer connected\n");
+                  tcp_wrbuffer_release(wrb);
+                  ret = -ENOTCONN;
+                  goto errout_with_lock;
+                }
+
+              TCP_WBSEQNO(wrb) = (unsigned)-1;
+              TCP_WBNRTX(wrb)  = 0;
+              wrb->wb_zcconn   = conn;
+              wrb->wb_zcid     = conn->zc_next++;
+              chunk_result     = chunk_len;
+              ninfo("zerocopy wrb %p id %" PRIu32 "\n", wrb, wrb->wb_zcid);
+              break;
+            }
+#endif
+
+          if (wrb != NULL && !TCP_WBZEROCOPY(wrb) &&
+              TCP_WBSENT(wrb) == 0 && TCP_WBNRTX(wrb) == 0 &&
               TCP_WBPKTLEN(wrb) < max_wrb_size &&
               (TCP_WBPKTLEN(wrb) % conn->mss) != 0)
             {
@@ -1526,6 +1653,7 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
           else if (nonblock)
             {
               wrb = tcp_wrbuffer_tryalloc();
+              fresh = true;
               ninfo("new wrb %p (non blocking)\n", wrb);
             }
           else
@@ -1534,6 +1662,7 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
               wrb = tcp_wrbuffer_timedalloc(tcp_send_gettimeout(start,
                                                                 timeout));
               conn_dev_lock(&conn->sconn, conn->dev);
+              fresh = true;
               ninfo("new wrb %p\n", wrb);
             }
 
@@ -1578,7 +1707,34 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
            * remaining data.
            */
 
-          chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+          if (fresh)
+            {
+              /* A new write buffer is not on the write queue yet, so no
+               * one else can see it.  Copy into it without holding the
+               * connection and device locks, so that neither the device
+               * nor other connections on it wait for the copy.  Data
+               * coalesced into the last write buffer is still copied
+               * with the locks held, since that buffer already holds
+               * queued data.
+               */
+
+              conn_dev_unlock(&conn->sconn, conn->dev);
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+              conn_dev_lock(&conn->sconn, conn->dev);
+
+              if (!_SS_ISCONNECTED(conn->sconn.s_flags))
+                {
+                  nerr("ERROR: No longer connected\n");
+                  tcp_wrbuffer_release(wrb);
+                  ret = -ENOTCONN;
+                  goto errout_with_lock;
+                }
+            }
+          else
+            {
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+            }
+
           if (chunk_result == -ENOMEM)
             {
               if (TCP_WBPKTLEN(wrb) > 0)
@@ -1693,6 +1849,13 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
       cp += chunk_result;
       len -= chunk_result;
       result += chunk_result;
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      if (zerocopy)
+        {
+          break;
+        }
+#endif
     }
 
   /* Check for errors.  Errors are signaled by negative errno values
@@ -28,6 +28,7 @@
 
 #include <sys/time.h>
 #include <stdint.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -235,6 +236,21 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        if (value_len == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            conn_dev_lock(&conn->sconn, conn->dev);
+            ret = tcp_cc_set(conn, value, value_len);
+            conn_dev_unlock(&conn->sconn, conn->dev);
+          }
+        break;
+#endif /* CONFIG_NET_TCP_CC_NEWRENO */
+
       case TCP_MAXSEG: /* The maximum segment size */
         if (value_len != sizeof(int))
           {
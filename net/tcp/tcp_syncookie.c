@@ -0,0 +1,459 @@
+/****************************************************************************
+ * net/tcp/tcp_syncookie.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <crypto/md5.h>
+#include <debug.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "netdev/netdev.h"
+#include "inet/inet.h"
+#include "tcp/tcp.h"
+#include "utils/utils.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Layout of a cookie, used as our initial sequence number:
+ *
+ *   31..27  count, the uptime in units of 64 seconds (mod 32)
+ *   26..24  index of the peer's MSS in g_tcp_syncookie_mss[]
+ *   23..0   MD5(addresses, ports, peer ISN, count, MSS index, key)
+ */
+
+#define SYNCOOKIE_COUNT_SHIFT  27
+#define SYNCOOKIE_COUNT_MASK   0x1f
+#define SYNCOOKIE_MSS_SHIFT    24
+#define SYNCOOKIE_MSS_MASK     0x07
+#define SYNCOOKIE_HASH_MASK    0x00ffffff
+
+/* A cookie is accepted during the period it was made in and the next one,
+ * i.e. for 64 to 128 seconds.
+ */
+
+#define SYNCOOKIE_PERIOD_SHIFT 6
+#define SYNCOOKIE_MAXAGE       1
+
+/* The MSS assumed if the SYN carries no MSS option (RFC 9293) */
+
+#define SYNCOOKIE_DEFAULT_MSS  536
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The MSS values a cookie can encode, the common ones taken from Linux */
+
+static const uint16_t g_tcp_syncookie_mss[] =
+{
+  536, 1024, 1220, 1300, 1400, 1440, 1452, 1460
+};
+
+static uint32_t g_tcp_syncookie_key[4];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_syncookie_count
+ *
+ * Description:
+ *   Return the current cookie period.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_syncookie_count(void)
+{
+  return (TICK2SEC(clock_systime_ticks()) >> SYNCOOKIE_PERIOD_SHIFT) &
+         SYNCOOKIE_COUNT_MASK;
+}
+
+/****************************************************************************
+ * Name: tcp_syncookie_hash
+ *
+ * Description:
+ *   Calculate the keyed hash part of the cookie for the connection
+ *   request described by the addresses and the TCP header of the packet.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_syncookie_hash(FAR union ip_binding_u *uaddr,
+                                   uint8_t domain,
+                                   FAR struct tcp_hdr_s *tcp,
+                                   uint32_t isn, uint32_t count,
+                                   uint32_t mssidx)
+{
+  const size_t addrlen = net_ip_domain_select(domain,
+                                  sizeof(in_addr_t), sizeof(net_ipv6addr_t));
+  MD5_CTX ctx;
+  uint32_t digest[MD5_DIGEST_LENGTH / 4];
+
+  /* Make sure we have a secret key */
+
+  if (g_tcp_syncookie_key[0] == 0)
+    {
+      arc4random_buf(g_tcp_syncookie_key, sizeof(g_tcp_syncookie_key));
+    }
+
+  md5init(&ctx);
+  md5update(&ctx, net_ip_binding_laddr(uaddr, domain), addrlen);
+  md5update(&ctx, &tcp->destport, sizeof(tcp->destport));
+  md5update(&ctx, net_ip_binding_raddr(uaddr, domain), addrlen);
+  md5update(&ctx, &tcp->srcport, sizeof(tcp->srcport));
+  md5update(&ctx, &isn, sizeof(isn));
+  md5update(&ctx, &count, sizeof(count));
+  md5update(&ctx, &mssidx, sizeof(mssidx));
+  md5update(&ctx, g_tcp_syncookie_key, sizeof(g_tcp_syncookie_key));
+  md5final((FAR uint8_t *)digest, &ctx);
+
+  return digest[0] & SYNCOOKIE_HASH_MASK;
+}
+
+/****************************************************************************
+ * Name: tcp_syncookie_peermss
+ *
+ * Description:
+ *   Return the MSS option of the SYN in the packet, or the default MSS if
+ *   there is none.
+ *
+ ****************************************************************************/
+
+static uint16_t tcp_syncookie_peermss(FAR struct tcp_hdr_s *tcp)
+{
+  int optlen = ((tcp->tcpoffset >> 4) - 5) << 2;
+  int i;
+
+  for (i = 0; i < optlen; )
+    {
+      uint8_t opt = tcp->optdata[i];
+
+      if (opt == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+      else if (i + 1 >= optlen || tcp->optdata[i + 1] == 0)
+        {
+          /* Malformed options */
+
+          break;
+        }
+      else if (opt == TCP_OPT_MSS &&
+               tcp->optdata[i + 1] == TCP_OPT_MSS_LEN &&
+               i + TCP_OPT_MSS_LEN <= optlen)
+        {
+          return ((uint16_t)tcp->optdata[i + 2] << 8) | tcp->optdata[i + 3];
+        }
+
+      i += tcp->optdata[i + 1];
+    }
+
+  return SYNCOOKIE_DEFAULT_MSS;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_syncookie_send
+ *
+ * Description:
+ *   Answer the SYN in the packet with a SYN-ACK whose sequence number is a
+ *   cookie, without allocating any connection state.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure containing the received SYN
+ *   listener - The listening connection the SYN was destined to
+ *   uaddr    - The local and remote addresses of the SYN
+ *   domain   - IP domain (PF_INET or PF_INET6)
+ *   iplen    - Length of the IP header
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_syncookie_send(FAR struct net_driver_s *dev,
+                        FAR struct tcp_conn_s *listener,
+                        FAR union ip_binding_u *uaddr, uint8_t domain,
+                        unsigned int iplen)
+{
+  FAR struct tcp_hdr_s *tcp = IPBUF(iplen);
+  uint32_t recvwndo;
+  uint32_t cookie;
+  uint32_t isn;
+  uint32_t count;
+  uint16_t tcp_mss;
+  uint16_t mss;
+  uint16_t tmp16;
+  int mssidx;
+
+  /* The reply is built in place behind a plain IP header, drop SYNs
+   * carrying IP options or IPv6 extension headers instead.
+   */
+
+  if (iplen != net_ip_domain_select(domain, IPv4_HDRLEN, IPv6_HDRLEN))
+    {
+      dev->d_len = 0;
+      return;
+    }
+
+  /* Use the largest MSS of the table that fits both ends */
+
+  tcp_mss = tcp_rx_mss(dev);
+#ifdef CONFIG_NET_TCPPROTO_OPTIONS
+  if (listener->user_mss != 0 && listener->user_mss < tcp_mss)
+    {
+      tcp_mss = listener->user_mss;
+    }
+#endif
+
+  mss = MIN(tcp_syncookie_peermss(tcp), tcp_mss);
+  for (mssidx = nitems(g_tcp_syncookie_mss) - 1; mssidx > 0; mssidx--)
+    {
+      if (g_tcp_syncookie_mss[mssidx] <= mss)
+        {
+          break;
+        }
+    }
+
+  isn    = tcp_getsequence(tcp->seqno);
+  count  = tcp_syncookie_count();
+  cookie = (count << SYNCOOKIE_COUNT_SHIFT) |
+           ((uint32_t)mssidx << SYNCOOKIE_MSS_SHIFT) |
+           tcp_syncookie_hash(uaddr, domain, tcp, isn, count, mssidx);
+
+  ninfo("SYN cookie %08" PRIx32 " mss %u\n",
+        cookie, g_tcp_syncookie_mss[mssidx]);
+
+  /* Turn the SYN into the SYN-ACK, with only the MSS option: the window
+   * scale and SACK permitted options cannot be remembered.
+   */
+
+  tcp_setsequence(tcp->ackno, isn + 1);
+  tcp_setsequence(tcp->seqno, cookie);
+
+  tmp16         = tcp->srcport;
+  tcp->srcport  = tcp->destport;
+  tcp->destport = tmp16;
+
+  tcp->flags     = TCP_SYN | TCP_ACK;
+  tcp->tcpoffset = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+
+  tcp->optdata[0] = TCP_OPT_MSS;
+  tcp->optdata[1] = TCP_OPT_MSS_LEN;
+  tcp->optdata[2] = tcp_mss >> 8;
+  tcp->optdata[3] = tcp_mss & 0xff;
+
+  recvwndo = MIN(tcp_get_recvwindow(dev, listener), UINT16_MAX);
+  tcp->wnd[0]  = recvwndo >> 8;
+  tcp->wnd[1]  = recvwndo & 0xff;
+  tcp->urgp[0] = 0;
+  tcp->urgp[1] = 0;
+
+  dev->d_len = iplen + TCP_HDRLEN + TCP_OPT_MSS_LEN;
+
+  /* Update device buffer length before setup the IP header */
+
+  iob_update_pktlen(dev->d_iob, dev->d_len, false);
+
+  /* Calculate chk & build L3 header */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (domain == PF_INET6)
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+      ipv6_build_header(ipv6, dev->d_len - IPv6_HDRLEN,
+                        IP_PROTO_TCP,
+                        netdev_ipv6_srcaddr(dev, uaddr->ipv6.laddr),
+                        uaddr->ipv6.raddr,
+                        listener->sconn.s_ttl, listener->sconn.s_tclass);
+      tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      if (!net_chksum_offload(dev, IP_PROTO_TCP, &tcp->tcpchksum))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
+#endif
+
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv6.sent++;
+#endif
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      ipv4_build_header(IPv4BUF, dev->d_len, IP_PROTO_TCP,
+                        &uaddr->ipv4.laddr, &uaddr->ipv4.raddr,
+                        listener->sconn.s_ttl, listener->sconn.s_tos,
+                        NULL);
+      tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      if (!net_chksum_offload(dev, IP_PROTO_TCP, &tcp->tcpchksum))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
+#endif
+
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv4.sent++;
+#endif
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.sent++;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_syncookie_accept
+ *
+ * Description:
+ *   Check whether the ACK in the packet acknowledges a SYN-ACK sent by
+ *   tcp_syncookie_send() and, if it does, create the connection it
+ *   completes.
+ *
+ * Input Parameters:
+ *   dev      - The device driver structure containing the received ACK
+ *   listener - The listening connection the ACK was destined to
+ *   uaddr    - The local and remote addresses of the ACK
+ *   domain   - IP domain (PF_INET or PF_INET6)
+ *   iplen    - Length of the IP header
+ *
+ * Returned Value:
+ *   The new connection in the SYN_RCVD state, ready to be moved to
+ *   ESTABLISHED by the ACK, or NULL if the ACK does not carry a valid
+ *   cookie or the connection cannot be allocated.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_syncookie_accept(FAR struct net_driver_s *dev,
+                                            FAR struct tcp_conn_s *listener,
+                                            FAR union ip_binding_u *uaddr,
+                                            uint8_t domain,
+                                            unsigned int iplen)
+{
+  FAR struct tcp_hdr_s *tcp = IPBUF(iplen);
+  FAR struct tcp_conn_s *conn;
+  uint32_t recvwndo;
+  uint32_t cookie;
+  uint32_t count;
+  uint32_t mssidx;
+  uint32_t isn;
+
+  cookie = tcp_getsequence(tcp->ackno) - 1;
+  isn    = tcp_getsequence(tcp->seqno) - 1;
+  count  = cookie >> SYNCOOKIE_COUNT_SHIFT;
+  mssidx = (cookie >> SYNCOOKIE_MSS_SHIFT) & SYNCOOKIE_MSS_MASK;
+
+  if (((tcp_syncookie_count() - count) & SYNCOOKIE_COUNT_MASK) >
+      SYNCOOKIE_MAXAGE ||
+      tcp_syncookie_hash(uaddr, domain, tcp, isn, count, mssidx) !=
+      (cookie & SYNCOOKIE_HASH_MASK))
+    {
+      return NULL;
+    }
+
+  if (!tcp_backlogavailable(listener))
+    {
+      nerr("ERROR: no free containers for TCP BACKLOG!\n");
+      return NULL;
+    }
+
+  /* The peer has proven to be reachable at its address, so it may take
+   * the place of a connection request that never completed.
+   */
+
+  conn = tcp_alloc_accept(dev, tcp, listener);
+  if (conn == NULL && tcp_drop_synrcvd())
+    {
+      conn = tcp_alloc_accept(dev, tcp, listener);
+    }
+
+  if (conn == NULL)
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.tcp.syndrop++;
+#endif
+      nerr("ERROR: No free TCP connections\n");
+      return NULL;
+    }
+
+  /* Restore the state that the SYN-ACK would have left behind: the
+   * cookie is our ISN, the SYN-ACK is the one outstanding byte.
+   */
+
+  tcp_setsequence(conn->sndseq, cookie);
+  conn->rexmit_seq = cookie;
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+  conn->sndseq_max = cookie + 1;
+#endif
+
+  conn->mss        = g_tcp_syncookie_mss[mssidx];
+
+  /* We advertised a window in the SYN-ACK */
+
+  recvwndo         = MIN(tcp_get_recvwindow(dev, conn), UINT16_MAX);
+  conn->rcv_adv    = tcp_getsequence(conn->rcvseq) + recvwndo;
+
+  conn->crefs      = 1;
+
+  ninfo("SYN cookie %08" PRIx32 " accepted, mss %u\n",
+        cookie, conn->mss);
+  return conn;
+}
@@ -66,22 +66,35 @@
 #include "tcp/tcp.h"
 
 /****************************************************************************
- * Pre-processor Definitions
+ * Private Functions
  ****************************************************************************/
 
-/* Per RFC 1122:  "... an ACK should not be excessively delayed; in
- * particular, the delay MUST be less than 0.5 seconds ..."
+/****************************************************************************
+ * Name: tcp_elapse
+ *
+ * Description:
+ *   Subtract the elapsed time from a running timer
+ *
+ * Returned Value:
+ *   True if the timer was running and has expired.
  *
- * NOTE:  We only have 0.5 timing resolution here so the delay will be
- * between 0.5 and 1.0 seconds, and may be delayed further, depending on the
- * polling rate of the the driver (often 1 second).
- */
+ ****************************************************************************/
 
-#define ACK_DELAY (1)
+static bool tcp_elapse(FAR uint32_t *timer, uint32_t elapsed)
+{
+  if (*timer == 0)
+    {
+      return false;
+    }
+  else if (*timer > elapsed)
+    {
+      *timer -= elapsed;
+      return false;
+    }
 
-/****************************************************************************
- * Private Functions
- ****************************************************************************/
+  *timer = 0;
+  return true;
+}
 
 /****************************************************************************
  * Name: tcp_get_timeout
@@ -93,7 +106,8 @@
  *   conn - The TCP "connection" to poll for TX data
  *
  * Returned Value:
- *   int - The time required for the next expiry (units: half-seconds)
+ *   The time required for the next expiry (units: ms), 0 if no timer is
+ *   running.
  *
  * Assumptions:
  *   conn is not NULL.
@@ -101,22 +115,22 @@
  *
  ****************************************************************************/
 
-static int tcp_get_timeout(FAR struct tcp_conn_s *conn)
+static uint32_t tcp_get_timeout(FAR struct tcp_conn_s *conn)
 {
-  int timeout = conn->timer;
+  uint32_t timeout = conn->timer;
 
 #ifdef CONFIG_NET_TCP_KEEPALIVE
-  if (timeout == 0)
+  if (conn->keeptimer > 0 && (timeout == 0 || timeout > conn->keeptimer))
     {
-      /* The conn->keeptimer units is decisecond and the timeout
-       * units is half-seconds, therefore they need to be unified.
-       */
-
-      timeout = conn->keeptimer / DSEC_PER_HSEC;
+      timeout = conn->keeptimer;
     }
-  else if (conn->keeptimer > 0 && timeout > conn->keeptimer / DSEC_PER_HSEC)
+#endif
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  if (conn->rx_unackseg > 0 && conn->rx_acktimer > 0 &&
+      (timeout == 0 || timeout > conn->rx_acktimer))
     {
-      timeout = conn->keeptimer / DSEC_PER_HSEC;
+      timeout = conn->rx_acktimer;
     }
 #endif
 
@@ -208,6 +222,44 @@ static void tcp_xmit_probe(FAR struct net_driver_s *dev,
   tcp_setsequence(conn->sndseq, saveseq);
 }
 
+/****************************************************************************
+ * Name: tcp_delayed_ack
+ *
+ * Description:
+ *   Send the delayed ACK if its timer has expired
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure to use in the send operation
+ *   conn   - The TCP "connection" to poll for TX data
+ *
+ * Returned Value:
+ *   True if the ACK was sent.
+ *
+ * Assumptions:
+ *   dev is not NULL.
+ *   conn is not NULL.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+static bool tcp_delayed_ack(FAR struct net_driver_s *dev,
+                            FAR struct tcp_conn_s *conn)
+{
+  /* Is there a segment with a delayed acknowledgment that is due? */
+
+  if (conn->rx_unackseg > 0 && conn->rx_acktimer == 0)
+    {
+      /* Reset the delayed ACK state and send the ACK packet. */
+
+      conn->rx_unackseg = 0;
+      tcp_synack(dev, conn, TCP_ACK);
+      return true;
+    }
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -233,33 +285,36 @@ static void tcp_xmit_probe(FAR struct net_driver_s *dev,
 
 void tcp_update_timer(FAR struct tcp_conn_s *conn)
 {
-  sclock_t timeout = tcp_get_timeout(conn);
+  sclock_t ticks;
+  uint32_t timeout;
+
+  tcp_sync_timer(conn);
+  timeout = tcp_get_timeout(conn);
 
-  if (timeout > 0)
+  if (timeout > 0 || conn->timeout)
     {
+      /* A timer that expired while synchronizing must fire now */
+
+      ticks = conn->timeout ? 0 : MSEC2TICK(timeout);
+
 #ifdef CONFIG_NET_SOLINGER
       /* Re-update tcp timeout */
 
       if (conn->ltimeout != 0)
         {
-          sclock_t ticks = conn->ltimeout - clock_systime_ticks();
-
-          if (ticks <= 0)
-            {
-              timeout = 0;
-            }
-          else if (timeout > TICK2HSEC(ticks))
-            {
-              timeout = TICK2HSEC(ticks);
-            }
+          ticks = MIN(ticks, MAX(conn->ltimeout - clock_systime_ticks(), 0));
         }
 #endif
 
+      /* A pending expiry that comes earlier is kept, tcp_timer() will
+       * re-arm the timer from there.  This avoids re-queueing the work on
+       * every ACK that pushes the retransmission deadline further.
+       */
+
       if (work_available(&conn->work) ||
-          TICK2HSEC(work_timeleft(&conn->work)) != timeout)
+          work_timeleft(&conn->work) > ticks)
         {
-          work_queue(LPWORK, &conn->work, tcp_timer_expiry,
-                     conn, HSEC2TICK(timeout));
+          work_queue(LPWORK, &conn->work, tcp_timer_expiry, conn, ticks);
         }
     }
   else
@@ -268,6 +323,66 @@ void tcp_update_timer(FAR struct tcp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: tcp_sync_timer
+ *
+ * Description:
+ *   Bring the timers of the provided TCP connection up to date: subtract
+ *   the time elapsed since they were last synchronized.
+ *
+ * Input Parameters:
+ *   conn - The TCP "connection" to poll for TX data
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   conn is not NULL.
+ *
+ ****************************************************************************/
+
+void tcp_sync_timer(FAR struct tcp_conn_s *conn)
+{
+  clock_t now = clock_systime_ticks();
+  clock_t ticks = now - conn->timer_stamp;
+  uint32_t elapsed;
+  bool expired;
+
+  if (ticks >= SEC2TICK(1))
+    {
+      elapsed = MIN(TICK2MSEC((uint64_t)ticks), UINT32_MAX);
+      conn->timer_stamp = now;
+    }
+  else
+    {
+      /* Keep the remainder of a partial millisecond for the next time */
+
+      elapsed = TICK2MSEC(ticks);
+      conn->timer_stamp += MSEC2TICK(elapsed);
+    }
+
+  if (elapsed == 0)
+    {
+      return;
+    }
+
+  expired = tcp_elapse(&conn->timer, elapsed);
+#ifdef CONFIG_NET_TCP_KEEPALIVE
+  expired |= tcp_elapse(&conn->keeptimer, elapsed);
+#endif
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  expired |= tcp_elapse(&conn->rx_acktimer, elapsed) &&
+             conn->rx_unackseg > 0;
+#endif
+
+  /* Let the next poll of the device run tcp_timer() */
+
+  if (expired)
+    {
+      conn->timeout = true;
+    }
+}
+
 /****************************************************************************
  * Name: tcp_update_retrantimer
  *
@@ -277,7 +392,7 @@ void tcp_update_timer(FAR struct tcp_conn_s *conn)
  *
  * Input Parameters:
  *   conn    - The TCP "connection" to poll for TX data
- *   timeout - Time for the next timeout
+ *   timeout - Time for the next timeout (ms)
  *
  * Returned Value:
  *   None
@@ -290,6 +405,7 @@ void tcp_update_timer(FAR struct tcp_conn_s *conn)
 
 void tcp_update_retrantimer(FAR struct tcp_conn_s *conn, int timeout)
 {
+  tcp_sync_timer(conn);
   conn->timer = timeout;
   tcp_update_timer(conn);
 }
@@ -303,7 +419,7 @@ void tcp_update_retrantimer(FAR struct tcp_conn_s *conn, int timeout)
  *
  * Input Parameters:
  *   conn    - The TCP "connection" to poll for TX data
- *   timeout - Time for the next timeout
+ *   timeout - Time for the next timeout (dsec)
  *
  * Returned Value:
  *   None
@@ -317,7 +433,36 @@ void tcp_update_retrantimer(FAR struct tcp_conn_s *conn, int timeout)
 #ifdef CONFIG_NET_TCP_KEEPALIVE
 void tcp_update_keeptimer(FAR struct tcp_conn_s *conn, int timeout)
 {
-  conn->keeptimer = timeout;
+  tcp_sync_timer(conn);
+  conn->keeptimer = timeout * MSEC_PER_DSEC;
+  tcp_update_timer(conn);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_update_acktimer
+ *
+ * Description:
+ *   Start the delayed ACK timer for the provided TCP connection
+ *
+ * Input Parameters:
+ *   conn    - The TCP "connection" to poll for TX data
+ *   timeout - Time for the next timeout (ms)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   conn is not NULL.
+ *   The connection (conn) is bound to the polling device (dev).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+void tcp_update_acktimer(FAR struct tcp_conn_s *conn, int timeout)
+{
+  tcp_sync_timer(conn);
+  conn->rx_acktimer = timeout;
   tcp_update_timer(conn);
 }
 #endif
@@ -402,16 +547,9 @@ void tcp_set_zero_probe(FAR struct tcp_conn_s *conn, uint32_t flags)
 
 void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 {
-  int hsec = tcp_get_timeout(conn);
   uint16_t result;
   uint8_t hdrlen;
 
-  /* NOTE: It is important to decrease conn->timer at "hsec" pace,
-   * not faster. Excessive (false) decrements of conn->timer are not allowed
-   * here. Otherwise, it breaks TCP timings and leads to TCP spurious
-   * retransmissions and other issues due to premature timeouts.
-   */
-
   DEBUGASSERT(dev != NULL && conn != NULL && dev == conn->dev);
 
   /* Set up for the callback.  We can't know in advance if the application
@@ -427,6 +565,13 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
   hdrlen = tcpip_hdrsize(conn);
 
+  /* The timers count down the time actually elapsed, so an early call
+   * (e.g. a deadline that moved later) only brings them up to date.
+   */
+
+  tcp_sync_timer(conn);
+  conn->timeout = false;
+
   /* Increase the TCP sequence number */
 
   tcp_nextsequence();
@@ -477,9 +622,9 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
   if (conn->tcpstateflags == TCP_TIME_WAIT)
     {
-      /* Check if the timer exceeds the timeout value */
+      /* Check if the timer has expired */
 
-      if (conn->timer <= hsec)
+      if (conn->timer == 0)
         {
           /* Set the timer to zero value */
 
@@ -492,12 +637,6 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
           ninfo("TCP state: TCP_CLOSED\n");
         }
-      else
-        {
-          /* No timeout. Just update the decremented timer */
-
-          conn->timer -= hsec;
-        }
     }
   else if (conn->tcpstateflags != TCP_CLOSED)
     {
@@ -510,18 +649,19 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
         {
           /* The connection has outstanding data */
 
-          if (conn->timer > hsec)
+          if (conn->timer > 0)
             {
-              /* Will not yet decrement to zero */
+              /* Not yet expired, but a delayed ACK may be due */
 
-              conn->timer -= hsec;
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+              if (tcp_delayed_ack(dev, conn))
+                {
+                  goto done;
+                }
+#endif
             }
           else
             {
-              /* Will decrement to zero */
-
-              conn->timer = 0;
-
               /* Check for a timeout on connection in the TCP_SYN_RCVD state.
                * On such timeouts, we would normally resend the SYNACK until
                * the ACK is received, completing the 3-way handshake.  But if
@@ -580,7 +720,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
               /* Exponential backoff. */
 
 #ifndef CONFIG_NET_TCP_FIXED_RTO
-              conn->rto = TCP_RTO << (conn->nrtx > 4 ? 4: conn->nrtx);
+              conn->rto = TCP_RTO_INIT << (conn->nrtx > 4 ? 4: conn->nrtx);
 #endif
               tcp_update_retrantimer(conn, conn->rto);
               conn->nrtx++;
@@ -628,22 +768,9 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                     tcp_rexmit(dev, conn, result);
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-                    /* If conn is TCP_INFR, it should enter to slow start */
-
-                    if (conn->flags & TCP_INFR)
-                      {
-                        conn->flags &= ~TCP_INFR;
-                      }
+                    /* Reset cwnd and ssthresh */
 
-                    /* update the max_cwnd */
-
-                    conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
-
-                    /* reset cwnd and ssthresh, refers to RFC5861. */
-
-                    conn->ssthresh =
-                                    MAX(conn->tx_unacked / 2, 2 * conn->mss);
-                    conn->cwnd = conn->mss;
+                    tcp_cc_timeout(conn);
 #endif
                     goto done;
 
@@ -676,13 +803,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                * received from the remote peer?
                */
 
-              if (conn->keeptimer > hsec * DSEC_PER_HSEC)
-                {
-                  /* Will not yet decrement to zero */
-
-                  conn->keeptimer -= hsec * DSEC_PER_HSEC;
-                }
-              else
+              if (conn->keeptimer == 0)
                 {
                   /* Yes.. Has the retry count expired? */
 
@@ -703,7 +824,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
                       /* Update for the next probe */
 
-                      conn->keeptimer = conn->keepintvl;
+                      conn->keeptimer = conn->keepintvl * MSEC_PER_DSEC;
                       conn->keepretries++;
                     }
 
@@ -718,13 +839,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
           if (conn->zero_probe)
             {
-              if (conn->timer > hsec)
-                {
-                  /* Will not yet decrement to zero */
-
-                  conn->timer -= hsec;
-                }
-              else
+              if (conn->timer == 0)
                 {
                   /* Yes.. Has the retry count expired? */
 
@@ -754,32 +869,11 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
             }
 
 #ifdef CONFIG_NET_TCP_DELAYED_ACK
-          /* Handle delayed acknowledgments.  Is there a segment with a
-           * delayed acknowledgment?
-           */
+          /* Handle delayed acknowledgments. */
 
-          if (conn->rx_unackseg > 0)
+          if (tcp_delayed_ack(dev, conn))
             {
-              /* Increment the ACK delay. */
-
-              conn->rx_acktimer += hsec;
-
-              /* Per RFC 1122:  "...an ACK should not be excessively
-               * delayed; in particular, the delay must be less than
-               * 0.5 seconds..."
-               */
-
-              if (conn->rx_acktimer >= ACK_DELAY)
-                {
-                  /* Reset the delayed ACK state and send the ACK
-                   * packet.
-                   */
-
-                  conn->rx_unackseg = 0;
-                  conn->rx_acktimer = 0;
-                  tcp_synack(dev, conn, TCP_ACK);
-                  goto done;
-                }
+              goto done;
             }
 #endif
 
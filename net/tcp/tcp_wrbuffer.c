@@ -58,6 +58,25 @@ NET_BUFPOOL_DECLARE(g_wrbuffer, sizeof(struct tcp_wrbuffer_s),
                     CONFIG_NET_TCP_NWRBCHAINS,
                     CONFIG_NET_TCP_ALLOC_WRBCHAINS, 0);
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_wrbuffer_zcfree
+ *
+ * Description:
+ *   The free callback of MSG_ZEROCOPY I/O buffers.  The data belongs to
+ *   the user, the completion is reported by tcp_wrbuffer_release().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+static void tcp_wrbuffer_zcfree(FAR void *data)
+{
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -98,6 +117,10 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_timedalloc(unsigned int timeout)
       return NULL;
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  wrb->wb_zcconn = NULL;
+#endif
+
   /* Now get the first I/O buffer for the write buffer structure */
 
   wrb->wb_iob = net_iobtimedalloc(true, timeout);
@@ -137,6 +160,56 @@ FAR struct tcp_wrbuffer_s *tcp_wrbuffer_alloc(void)
   return tcp_wrbuffer_timedalloc(UINT_MAX);
 }
 
+/****************************************************************************
+ * Name: tcp_wrbuffer_zcalloc
+ *
+ * Description:
+ *   Allocate a TCP write buffer whose I/O buffer refers to the caller's
+ *   data instead of holding a copy of it.  The caller must set wb_zcconn
+ *   and wb_zcid, the completion is reported to that connection when the
+ *   write buffer is released.
+ *
+ * Input Parameters:
+ *   buf     - The data to send, must stay valid until the completion
+ *   len     - The length of the data, at most UINT16_MAX
+ *   timeout - The relative time to wait until a timeout is declared.
+ *
+ * Assumptions:
+ *   Called from user logic with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+FAR struct tcp_wrbuffer_s *tcp_wrbuffer_zcalloc(FAR const void *buf,
+                                                size_t len,
+                                                unsigned int timeout)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+
+  DEBUGASSERT(len > 0 && len <= UINT16_MAX);
+
+  wrb = NET_BUFPOOL_TIMEDALLOC(g_wrbuffer, timeout);
+  if (wrb == NULL)
+    {
+      return NULL;
+    }
+
+  wrb->wb_zcconn = NULL;
+  wrb->wb_iob    = iob_alloc_with_data((FAR void *)buf, len,
+                                       tcp_wrbuffer_zcfree);
+  if (wrb->wb_iob == NULL)
+    {
+      nerr("ERROR: Failed to allocate I/O buffer\n");
+      tcp_wrbuffer_release(wrb);
+      return NULL;
+    }
+
+  wrb->wb_iob->io_len    = len;
+  wrb->wb_iob->io_pktlen = len;
+  return wrb;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_wrbuffer_tryalloc
  *
@@ -186,6 +259,35 @@ void tcp_wrbuffer_release(FAR struct tcp_wrbuffer_s *wrb)
       iob_free_chain(wrb->wb_iob);
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* The user buffer of a MSG_ZEROCOPY send is no longer referenced, add
+   * its id to the completions of the connection.
+   */
+
+  if (wrb->wb_zcconn != NULL)
+    {
+      FAR struct tcp_conn_s *conn = wrb->wb_zcconn;
+
+      if (!conn->zc_pending)
+        {
+          conn->zc_lo      = wrb->wb_zcid;
+          conn->zc_hi      = wrb->wb_zcid;
+          conn->zc_pending = true;
+        }
+      else if (TCP_SEQ_LT(wrb->wb_zcid, conn->zc_lo))
+        {
+          conn->zc_lo = wrb->wb_zcid;
+        }
+      else if (TCP_SEQ_GT(wrb->wb_zcid, conn->zc_hi))
+        {
+          conn->zc_hi = wrb->wb_zcid;
+        }
+
+      wrb->wb_zcconn = NULL;
+      tcp_poll_zerocopy(conn);
+    }
+#endif
+
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
   /* Reset the ack counter */
 
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/ip.h>
@@ -111,6 +112,9 @@ struct udp_conn_s
   /* UDP-specific content follows */
 
   union ip_binding_u u;   /* IP address binding */
+#if CONFIG_NET_UDP_HASH_BITS > 0
+  hash_node_t hnode;      /* Link in the local port hash */
+#endif
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
   uint8_t  flags;         /* See _UDP_FLAG_* definitions */
@@ -161,6 +165,19 @@ struct udp_conn_s
 
 #ifdef CONFIG_NET_TIMESTAMP
   int timestamp; /* Nonzero when SO_TIMESTAMP is enabled */
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+  /* SO_TIMESTAMPING state:
+   *
+   *   tsflags  - SOF_TIMESTAMPING_* flags set with SO_TIMESTAMPING
+   *   tskey    - Key of the next send, reported with OPT_ID
+   *   errqueue - Transmit timestamps not yet read with MSG_ERRQUEUE,
+   *              protected by the lock in udp_tstamp.c
+   */
+
+  uint16_t tsflags;
+  uint32_t tskey;
+  FAR struct iob_s *errqueue;
 #endif
   FAR sem_t *txdrain_sem;
 };
@@ -240,6 +257,27 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
                                   FAR struct udp_conn_s *conn,
                                   FAR struct udp_hdr_s *udp);
 
+/****************************************************************************
+ * Name: udp_reuseport
+ *
+ * Description:
+ *   Given the first connection returned by udp_active(), select the member
+ *   of its SO_REUSEPORT group that should receive the datagram.  The
+ *   choice is a hash of the address and port pairs so that a flow always
+ *   reaches the same socket.  The connection is returned unchanged if it
+ *   is not part of a group.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct udp_conn_s *udp_reuseport(FAR struct net_driver_s *dev,
+                                     FAR struct udp_conn_s *conn,
+                                     FAR struct udp_hdr_s *udp);
+#endif
+
 /****************************************************************************
  * Name: udp_nextconn
  *
@@ -298,6 +336,18 @@ void udp_conn_list_unlock(void);
 
 uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u);
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Assign the local port (network byte order) of a connection and move it
+ *   to the matching bucket of the bind hashtable.  A port of 0 unbinds
+ *   the connection.
+ *
+ ****************************************************************************/
+
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno);
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -910,6 +960,63 @@ void udp_notifier_teardown(FAR void *key);
 void udp_readahead_signal(FAR struct udp_conn_s *conn);
 #endif
 
+/****************************************************************************
+ * Name: udp_tstamp_request
+ *
+ * Description:
+ *   Ask for a transmit timestamp of the UDP packet just built in
+ *   dev->d_iob.  The timestamp is queued to the error queue of conn when
+ *   the driver reports it with net_txtstamp().
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure holding the packet
+ *   conn - The UDP connection that sent it
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+void udp_tstamp_request(FAR struct net_driver_s *dev,
+                        FAR struct udp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: udp_tstamp_release
+ *
+ * Description:
+ *   Drop the pending transmit timestamp requests and the error queue of a
+ *   connection that is being freed.
+ *
+ * Input Parameters:
+ *   conn - The UDP connection
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+void udp_tstamp_release(FAR struct udp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: udp_tstamp_errqueue
+ *
+ * Description:
+ *   Read the oldest transmit timestamp of the error queue as a
+ *   SCM_TIMESTAMPING and an IP_RECVERR/IPV6_RECVERR control message.
+ *
+ * Input Parameters:
+ *   conn - The UDP connection
+ *   msg  - Receives the control messages
+ *
+ * Returned Value:
+ *   0 on success, -EAGAIN if the error queue is empty, -ENOBUFS if the
+ *   control buffer is too small.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+ssize_t udp_tstamp_errqueue(FAR struct udp_conn_s *conn,
+                            FAR struct msghdr *msg);
+#endif
+
 /****************************************************************************
  * Name: udp_txdrain
  *
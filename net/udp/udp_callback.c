@@ -155,11 +155,26 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
 #endif /* CONFIG_NET_IPv4 */
 
   /* Copy the meta info into the I/O buffer chain, just before data.
-   * Layout: |datalen|ifindex|src_addr_size|src_addr|[timestamp]|data|
+   * Layout:
+   * |datalen|ifindex|src_addr_size|src_addr|[timestamp]|[hwtstamp]|data|
    */
 
   offset = (dev->d_appdata - iob->io_data) - iob->io_offset;
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  /* The hardware timestamp only lives in the head of the packet, which
+   * is lost once it is concatenated to the read-ahead chain.
+   */
+
+  offset -= sizeof(iob->io_tstamp);
+  ret = iob_trycopyin(iob, (FAR const uint8_t *)&iob->io_tstamp,
+                      sizeof(iob->io_tstamp), offset, true);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+#endif
+
 #ifdef CONFIG_NET_TIMESTAMP
   /* Store timestamp while packet is being queued.
    * This is done unconditionally to avoid race condition when SO_TIMESTAMP
@@ -96,6 +96,12 @@ NET_BUFPOOL_DECLARE(g_udp_connections, sizeof(struct udp_conn_s),
 
 static dq_queue_t g_active_udp_connections;
 
+#if CONFIG_NET_UDP_HASH_BITS > 0
+/* The bound connections indexed by local port */
+
+static DECLARE_HASHTABLE(g_udp_hashtable, CONFIG_NET_UDP_HASH_BITS);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -112,6 +118,7 @@ static dq_queue_t g_active_udp_connections;
  *   portno - The port to use in the lookup
  *   opt    - The option from another conn to match the conflict conn
  *              SO_REUSEADDR: If both sockets have this, they never conflict.
+ *              SO_REUSEPORT: Likewise, the sockets then share the port.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -123,21 +130,38 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
                                             uint16_t portno, sockopt_t opt)
 {
   FAR struct udp_conn_s *conn = NULL;
+#if CONFIG_NET_UDP_HASH_BITS > 0
+  FAR hash_node_t *node;
+#endif
 #ifdef CONFIG_NET_SOCKOPTS
   bool skip_reusable = _SO_GETOPT(opt, SO_REUSEADDR);
+  bool skip_reuseport = _SO_GETOPT(opt, SO_REUSEPORT);
 #endif
 
-  /* Now search each connection structure. */
+  /* Now search each connection structure.  Only the connections bound to
+   * the same port can conflict, the hashtable puts them in one bucket.
+   */
 
   udp_conn_list_lock();
+#if CONFIG_NET_UDP_HASH_BITS > 0
+  hashtable_for_every_possible(g_udp_hashtable, node, portno)
+#else
   while ((conn = udp_nextconn(conn)) != NULL)
+#endif
     {
-      /* With SO_REUSEADDR set for both sockets, we do not need to check its
-       * address and port.
+#if CONFIG_NET_UDP_HASH_BITS > 0
+      conn = container_of(node, struct udp_conn_s, hnode);
+#endif
+
+      /* With SO_REUSEADDR or SO_REUSEPORT set for both sockets, we do not
+       * need to check its address and port.
        */
 
 #ifdef CONFIG_NET_SOCKOPTS
-      if (skip_reusable && _SO_GETOPT(conn->sconn.s_options, SO_REUSEADDR))
+      if ((skip_reusable &&
+           _SO_GETOPT(conn->sconn.s_options, SO_REUSEADDR)) ||
+          (skip_reuseport &&
+           _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT)))
         {
           continue;
         }
@@ -178,6 +202,15 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
 #endif /* CONFIG_NET_IPv6 */
     }
 
+#if CONFIG_NET_UDP_HASH_BITS > 0
+  if (node == NULL)
+    {
+      /* The bucket was exhausted without a match */
+
+      conn = NULL;
+    }
+#endif
+
   udp_conn_list_unlock();
   return conn;
 }
@@ -203,11 +236,25 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
   static const in_addr_t bcast = INADDR_BROADCAST;
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
+#if CONFIG_NET_UDP_HASH_BITS > 0
+  FAR hash_node_t *node;
 
-  conn = udp_nextconn(conn);
+  /* Continue after the previous match or start from the bucket of the
+   * destination port.
+   */
+
+  node = conn != NULL ? conn->hnode.flink :
+         hashtable_bucket(g_udp_hashtable, udp->destport)->head;
 
-  while (conn)
+  for (; node != NULL; node = node->flink)
+#else
+  for (conn = udp_nextconn(conn); conn != NULL; conn = udp_nextconn(conn))
+#endif
     {
+#if CONFIG_NET_UDP_HASH_BITS > 0
+      conn = container_of(node, struct udp_conn_s, hnode);
+#endif
+
       /* If the local UDP port is non-zero, the connection is considered
        * to be used. If so, then the following checks are performed:
        *
@@ -297,31 +344,27 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
                    net_ipv4addr_hdrcmp(ip->srcipaddr, &conn->u.ipv4.raddr)))
                 {
-                  /* Matching connection found.. Break out of the loop and
-                   * return this reference to it.
+                  /* Matching connection found.. Return this reference to
+                   * it.
                    */
 
-                  break;
+                  return conn;
                 }
             }
           else
             {
               /* This UDP socket is not connected.  We need to match only
                * the destination address with the bound socket address.
-               * Break out out of the loop and return this reference to
-               * the matching connection structure.
+               * Return this reference to the matching connection
+               * structure.
                */
 
-              break;
+              return conn;
             }
         }
-
-      /* Look at the next active connection */
-
-      conn = udp_nextconn(conn);
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -343,11 +386,25 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
                 FAR struct udp_hdr_s *udp)
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
+#if CONFIG_NET_UDP_HASH_BITS > 0
+  FAR hash_node_t *node;
+
+  /* Continue after the previous match or start from the bucket of the
+   * destination port.
+   */
 
-  conn = udp_nextconn(conn);
+  node = conn != NULL ? conn->hnode.flink :
+         hashtable_bucket(g_udp_hashtable, udp->destport)->head;
 
-  while (conn != NULL)
+  for (; node != NULL; node = node->flink)
+#else
+  for (conn = udp_nextconn(conn); conn != NULL; conn = udp_nextconn(conn))
+#endif
     {
+#if CONFIG_NET_UDP_HASH_BITS > 0
+      conn = container_of(node, struct udp_conn_s, hnode);
+#endif
+
       /* If the local UDP port is non-zero, the connection is considered
        * to be used. If so, then the following checks are performed:
        *
@@ -437,34 +494,109 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
                    net_ipv6addr_hdrcmp(ip->srcipaddr, conn->u.ipv6.raddr)))
                 {
-                  /* Matching connection found.. Break out of the loop and
-                   * return this reference to it.
+                  /* Matching connection found.. Return this reference to
+                   * it.
                    */
 
-                  break;
+                  return conn;
                 }
             }
           else
             {
               /* This UDP socket is not connected.  We need to match only
                * the destination address with the bound socket address.
-               * Break out out of the loop and return this reference to
-               * the matching connection structure.
+               * Return this reference to the matching connection
+               * structure.
                */
 
-              break;
+              return conn;
             }
         }
+    }
+
+  return NULL;
+}
+#endif /* CONFIG_NET_IPv6 */
 
-      /* Look at the next active connection */
+/****************************************************************************
+ * Name: udp_reuseport_member
+ *
+ * Description:
+ *   Return true if the connection belongs to the same SO_REUSEPORT group as
+ *   the leader: both have the option set, neither is connected and both are
+ *   bound to the same local address.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static bool udp_reuseport_member(FAR struct udp_conn_s *leader,
+                                 FAR struct udp_conn_s *conn)
+{
+  if (!_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT) ||
+      _UDP_ISCONNECTMODE(conn->flags) || conn->domain != leader->domain)
+    {
+      return false;
+    }
 
-      conn = udp_nextconn(conn);
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return net_ipv4addr_cmp(conn->u.ipv4.laddr, leader->u.ipv4.laddr);
     }
+#endif /* CONFIG_NET_IPv4 */
 
-  return conn;
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return net_ipv6addr_cmp(conn->u.ipv6.laddr, leader->u.ipv6.laddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
 }
+
+/****************************************************************************
+ * Name: udp_reuseport_hash
+ *
+ * Description:
+ *   Hash the source address and the port pair of the received datagram.
+ *
+ ****************************************************************************/
+
+static uint32_t udp_reuseport_hash(FAR struct net_driver_s *dev,
+                                   FAR struct udp_hdr_s *udp)
+{
+  uint32_t key = ((uint32_t)udp->srcport << 16) ^ udp->destport;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ip = IPv6BUF;
+
+      key ^= ((uint32_t)ip->srcipaddr[4] << 16) ^ ip->srcipaddr[5] ^
+             ((uint32_t)ip->srcipaddr[6] << 16) ^ ip->srcipaddr[7];
+    }
 #endif /* CONFIG_NET_IPv6 */
 
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ip = IPv4BUF;
+
+      key ^= NTOHL(net_ip4addr_conv32(ip->srcipaddr));
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  return HASH(key, 32);
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -606,7 +738,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   NET_BUFPOOL_LOCK(g_udp_connections);
-  conn->lport = 0;
+  udp_setport(conn, 0);
 
   /* Remove the connection from the active list */
 
@@ -617,6 +749,12 @@ void udp_free(FAR struct udp_conn_s *conn)
 
   iob_free_chain(conn->readahead);
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  /* Forget the transmit timestamps not yet reported or read */
+
+  udp_tstamp_release(conn);
+#endif
+
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
 
@@ -680,6 +818,93 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: udp_reuseport
+ *
+ * Description:
+ *   Given the first connection returned by udp_active(), select the member
+ *   of its SO_REUSEPORT group that should receive the datagram.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct udp_conn_s *udp_reuseport(FAR struct net_driver_s *dev,
+                                     FAR struct udp_conn_s *conn,
+                                     FAR struct udp_hdr_s *udp)
+{
+  FAR struct udp_conn_s *next;
+  uint32_t index;
+  uint32_t count = 0;
+
+  if (!udp_reuseport_member(conn, conn))
+    {
+      return conn;
+    }
+
+  /* Count the members of the group that accept this datagram */
+
+  for (next = conn; next != NULL; next = udp_active(dev, next, udp))
+    {
+      if (udp_reuseport_member(conn, next))
+        {
+          count++;
+        }
+    }
+
+  if (count < 2)
+    {
+      return conn;
+    }
+
+  /* Map the flow hash onto [0, count) and pick that member */
+
+  index = ((uint64_t)udp_reuseport_hash(dev, udp) * count) >> 32;
+  for (next = conn; next != NULL; next = udp_active(dev, next, udp))
+    {
+      if (udp_reuseport_member(conn, next) && index-- == 0)
+        {
+          break;
+        }
+    }
+
+  return next;
+}
+#endif
+
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Assign the local port (network byte order) of a connection and move it
+ *   to the matching bucket of the bind hashtable.  A port of 0 unbinds
+ *   the connection.
+ *
+ ****************************************************************************/
+
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+#if CONFIG_NET_UDP_HASH_BITS > 0
+  udp_conn_list_lock();
+  if (conn->lport != 0)
+    {
+      hashtable_delete(g_udp_hashtable, &conn->hnode, conn->lport);
+    }
+
+  if (portno != 0)
+    {
+      hashtable_add(g_udp_hashtable, &conn->hnode, portno);
+    }
+
+  conn->lport = portno;
+  udp_conn_list_unlock();
+#else
+  conn->lport = portno;
+#endif
+}
+
 /****************************************************************************
  * Name: udp_conn_list_lock
  *
@@ -876,7 +1101,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         }
       else
         {
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
     }
@@ -901,7 +1126,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_setport(conn, portno);
           ret         = OK;
         }
       else
@@ -953,12 +1178,14 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
-      if (!conn->lport)
+      uint16_t portno = HTONS(udp_select_port(conn->domain, &conn->u));
+      if (!portno)
         {
           nerr("ERROR: Failed to get a local port!\n");
           return -EADDRINUSE;
         }
+
+      udp_setport(conn, portno);
     }
 
   /* Is there a remote port (rport)? */
@@ -257,7 +257,11 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
   chksum = udp->udpchksum;
-  if (chksum != 0)
+  if (net_chksum_verified(dev))
+    {
+      chksum = 0;
+    }
+  else if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
@@ -303,6 +307,19 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
         {
           /* We'll only get multiple conn when we support SO_REUSEADDR */
 
+#ifdef CONFIG_NET_SOCKOPTS
+          /* A unicast datagram goes to a single member of a SO_REUSEPORT
+           * group, selected by the flow hash.
+           */
+
+#  ifdef CONFIG_NET_BROADCAST
+          if (!udp_is_broadcast(dev))
+#  endif
+            {
+              conn = udp_reuseport(dev, conn, udp);
+            }
+#endif
+
 #if defined(CONFIG_NET_SOCKOPTS) && defined(CONFIG_NET_BROADCAST)
           /* Check if the destination is a broadcast/multicast address */
 
@@ -227,6 +227,15 @@ int udp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       eventset |= POLLWRNORM;
     }
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  if (conn->errqueue != NULL)
+    {
+      /* Transmit timestamps may be read with MSG_ERRQUEUE */
+
+      eventset |= POLLERR;
+    }
+#endif
+
   /* Check if any requested events are already in effect */
 
   poll_notify(&fds, 1, eventset);
@@ -33,6 +33,7 @@
 #include <assert.h>
 
 #include <sys/time.h>
+#include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
@@ -80,6 +81,40 @@ static void udp_store_cmsg_timestamp(FAR struct udp_recvfrom_s *pstate,
 }
 #endif
 
+#ifdef CONFIG_NET_TIMESTAMPING
+static void udp_store_cmsg_timestamping(FAR struct udp_recvfrom_s *pstate,
+                                        FAR const struct timespec *sw,
+                                        uint64_t hw)
+{
+  uint16_t tsflags = pstate->ir_conn->tsflags;
+  struct scm_timestamping tss;
+  bool valid = false;
+
+  memset(&tss, 0, sizeof(tss));
+
+  if ((tsflags & SOF_TIMESTAMPING_RX_SOFTWARE) &&
+      (tsflags & SOF_TIMESTAMPING_SOFTWARE))
+    {
+      tss.ts[0] = *sw;
+      valid     = true;
+    }
+
+  if ((tsflags & SOF_TIMESTAMPING_RX_HARDWARE) &&
+      (tsflags & SOF_TIMESTAMPING_RAW_HARDWARE) && hw != 0)
+    {
+      tss.ts[2].tv_sec  = hw / NSEC_PER_SEC;
+      tss.ts[2].tv_nsec = hw % NSEC_PER_SEC;
+      valid             = true;
+    }
+
+  if (valid)
+    {
+      cmsg_append(pstate->ir_msg, SOL_SOCKET, SCM_TIMESTAMPING,
+                  &tss, sizeof(tss));
+    }
+}
+#endif
+
 #ifdef CONFIG_NET_SOCKOPTS
 static void udp_recvpktinfo(FAR struct udp_recvfrom_s *pstate,
                             FAR void *srcaddr, uint8_t ifindex)
@@ -195,7 +230,8 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 #endif
 
       /* Unflatten saved connection information
-       * Layout: |datalen|ifindex|src_addr_size|src_addr|[timestamp]|data|
+       * Layout:
+       * |datalen|ifindex|src_addr_size|src_addr|[timestamp]|[hwtstamp]|data|
        */
 
       recvlen = iob_copyout((FAR uint8_t *)&datalen, iob,
@@ -232,6 +268,25 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
           udp_store_cmsg_timestamp(pstate, &timestamp);
         }
 
+#  ifdef CONFIG_NET_TIMESTAMPING
+      if ((conn->tsflags & SOF_TIMESTAMPING_RX_MASK) != 0)
+        {
+          struct timespec timestamp;
+          uint64_t hwtstamp;
+
+          iob_copyout((FAR uint8_t *)&timestamp, iob,
+                      sizeof(struct timespec), offset);
+          recvlen = iob_copyout((FAR uint8_t *)&hwtstamp, iob,
+                                sizeof(hwtstamp),
+                                offset + sizeof(struct timespec));
+          DEBUGASSERT(recvlen == sizeof(hwtstamp));
+
+          udp_store_cmsg_timestamping(pstate, &timestamp, hwtstamp);
+        }
+
+      offset += sizeof(uint64_t);
+#  endif
+
       offset += sizeof(struct timespec);
 #endif
 
@@ -476,6 +531,14 @@ static uint32_t udp_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
+#ifdef CONFIG_NET_TIMESTAMPING
+          if ((pstate->ir_conn->tsflags & SOF_TIMESTAMPING_RX_MASK) != 0)
+            {
+              udp_store_cmsg_timestamping(pstate, &dev->d_rxtime,
+                                          dev->d_iob->io_tstamp);
+            }
+#endif
+
           /* Save the sender's address in the caller's 'from' location */
 
           udp_sender(dev, pstate);
@@ -683,6 +746,15 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   struct udp_recvfrom_s state;
   ssize_t ret;
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  /* The error queue only holds transmit timestamps, it never blocks */
+
+  if ((flags & MSG_ERRQUEUE) != 0)
+    {
+      return udp_tstamp_errqueue(conn, msg);
+    }
+#endif
+
   /* Perform the UDP recvfrom() operation */
 
   if (msg->msg_iovlen != 1)
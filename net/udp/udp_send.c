@@ -247,30 +247,42 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
 
       iob_update_pktlen(dev->d_iob, dev->d_len, false);
 
+#ifdef CONFIG_NET_TIMESTAMPING
+      /* Ask the driver for the transmit time of this datagram */
+
+      if ((conn->tsflags & SOF_TIMESTAMPING_TX_MASK) != 0)
+        {
+          udp_tstamp_request(dev, conn);
+        }
+#endif
+
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-      /* Calculate UDP checksum. */
+      /* Calculate UDP checksum, unless the device does it. */
 
+      if (!net_chksum_offload(dev, IP_PROTO_UDP, &udp->udpchksum))
+        {
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
-      if (IFF_IS_IPv4(dev->d_flags))
+          if (IFF_IS_IPv4(dev->d_flags))
 #endif
-        {
-          udp->udpchksum = ~udp_ipv4_chksum(dev);
-        }
+            {
+              udp->udpchksum = ~udp_ipv4_chksum(dev);
+            }
 #endif /* CONFIG_NET_IPv4 */
 
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
-      else
+          else
 #endif
-        {
-          udp->udpchksum = ~udp_ipv6_chksum(dev);
-        }
+            {
+              udp->udpchksum = ~udp_ipv6_chksum(dev);
+            }
 #endif /* CONFIG_NET_IPv6 */
 
-      if (udp->udpchksum == 0)
-        {
-          udp->udpchksum = 0xffff;
+          if (udp->udpchksum == 0)
+            {
+              udp->udpchksum = 0xffff;
+            }
         }
 #endif /* CONFIG_NET_UDP_CHECKSUMS */
 
@@ -0,0 +1,400 @@
+/****************************************************************************
+ * net/udp/udp_tstamp.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <poll.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mutex.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+
+#include "utils/utils.h"
+#include "udp/udp.h"
+
+#ifdef CONFIG_NET_TIMESTAMPING
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A packet waiting for its transmit timestamp, found from the io_tsid of
+ * the packet as g_udp_tstamp[io_tsid % CONFIG_NET_TIMESTAMPING_NTX].
+ */
+
+struct udp_tstamp_s
+{
+  uint32_t                id;    /* io_tsid of the packet, 0 if unused */
+  uint32_t                key;   /* ee_data of the error queue entry */
+  uint16_t                flags; /* tsflags of conn at send time */
+  FAR struct udp_conn_s  *conn;  /* The sending connection */
+  struct scm_timestamping tss;   /* Timestamps reported so far */
+};
+
+/* An entry of udp_conn_s::errqueue */
+
+struct udp_tstamp_rec_s
+{
+  struct scm_timestamping tss;
+  uint32_t                key;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Protects g_udp_tstamp and the errqueue of every UDP connection.  It is
+ * taken inside the connection and device locks, never the other way.
+ */
+
+static mutex_t g_udp_tstamp_lock = NXMUTEX_INITIALIZER;
+static struct udp_tstamp_s g_udp_tstamp[CONFIG_NET_TIMESTAMPING_NTX];
+static uint32_t g_udp_tstamp_id;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_tstamp_queue
+ *
+ * Description:
+ *   Append the timestamps of a completed request to the error queue of its
+ *   connection and wake up the pollers with POLLERR.
+ *
+ * Assumptions:
+ *   g_udp_tstamp_lock is held.
+ *
+ ****************************************************************************/
+
+static void udp_tstamp_queue(FAR struct udp_tstamp_s *req)
+{
+  FAR struct udp_conn_s *conn = req->conn;
+  struct udp_tstamp_rec_s rec;
+  FAR struct iob_s *iob;
+  int i;
+
+  /* Nothing was stamped, e.g. hardware stamps only on a device that has
+   * no timestamping unit.
+   */
+
+  if (req->tss.ts[0].tv_sec == 0 && req->tss.ts[0].tv_nsec == 0 &&
+      req->tss.ts[2].tv_sec == 0 && req->tss.ts[2].tv_nsec == 0)
+    {
+      return;
+    }
+
+  /* Bound the error queue, a socket that never reads it must not drain
+   * the IOB pool.
+   */
+
+  if (conn->errqueue != NULL && conn->errqueue->io_pktlen >=
+      CONFIG_NET_TIMESTAMPING_NTX * sizeof(rec))
+    {
+      nwarn("WARNING: UDP error queue full, timestamp dropped\n");
+      return;
+    }
+
+  iob = iob_tryalloc(false);
+  if (iob == NULL)
+    {
+      return;
+    }
+
+  rec.tss = req->tss;
+  rec.key = req->key;
+  if (iob_trycopyin(iob, (FAR const uint8_t *)&rec, sizeof(rec), 0,
+                    false) != sizeof(rec))
+    {
+      iob_free_chain(iob);
+      return;
+    }
+
+  if (conn->errqueue == NULL)
+    {
+      conn->errqueue = iob;
+    }
+  else
+    {
+      iob_concat(conn->errqueue, iob);
+    }
+
+  for (i = 0; i < CONFIG_NET_UDP_NPOLLWAITERS; i++)
+    {
+      FAR struct udp_poll_s *info = &conn->pollinfo[i];
+
+      if (info->conn != NULL && info->fds != NULL)
+        {
+          poll_notify(&info->fds, 1, POLLERR);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_tstamp_request
+ *
+ * Description:
+ *   Ask for a transmit timestamp of the UDP packet just built in
+ *   dev->d_iob.  The timestamp is queued to the error queue of conn when
+ *   the driver reports it with net_txtstamp().
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure holding the packet
+ *   conn - The UDP connection that sent it
+ *
+ ****************************************************************************/
+
+void udp_tstamp_request(FAR struct net_driver_s *dev,
+                        FAR struct udp_conn_s *conn)
+{
+  FAR struct udp_tstamp_s *req;
+  uint32_t key = conn->tskey++;
+
+  nxmutex_lock(&g_udp_tstamp_lock);
+
+  if (++g_udp_tstamp_id == 0)
+    {
+      g_udp_tstamp_id = 1;
+    }
+
+  /* The oldest request sharing the slot is dropped, its packet is most
+   * likely gone or its timestamp was never reported.
+   */
+
+  req        = &g_udp_tstamp[g_udp_tstamp_id % CONFIG_NET_TIMESTAMPING_NTX];
+  req->id    = g_udp_tstamp_id;
+  req->key   = (conn->tsflags & SOF_TIMESTAMPING_OPT_ID) ? key : 0;
+  req->flags = conn->tsflags;
+  req->conn  = conn;
+  memset(&req->tss, 0, sizeof(req->tss));
+
+  dev->d_iob->io_tsid = g_udp_tstamp_id;
+
+  nxmutex_unlock(&g_udp_tstamp_lock);
+}
+
+/****************************************************************************
+ * Name: udp_tstamp_release
+ *
+ * Description:
+ *   Drop the pending transmit timestamp requests and the error queue of a
+ *   connection that is being freed.
+ *
+ * Input Parameters:
+ *   conn - The UDP connection
+ *
+ ****************************************************************************/
+
+void udp_tstamp_release(FAR struct udp_conn_s *conn)
+{
+  int i;
+
+  nxmutex_lock(&g_udp_tstamp_lock);
+
+  for (i = 0; i < CONFIG_NET_TIMESTAMPING_NTX; i++)
+    {
+      if (g_udp_tstamp[i].conn == conn)
+        {
+          g_udp_tstamp[i].id   = 0;
+          g_udp_tstamp[i].conn = NULL;
+        }
+    }
+
+  iob_free_chain(conn->errqueue);
+  conn->errqueue = NULL;
+  conn->tsflags  = 0;
+  conn->tskey    = 0;
+
+  nxmutex_unlock(&g_udp_tstamp_lock);
+}
+
+/****************************************************************************
+ * Name: udp_tstamp_errqueue
+ *
+ * Description:
+ *   Read the oldest transmit timestamp of the error queue as a
+ *   SCM_TIMESTAMPING and an IP_RECVERR/IPV6_RECVERR control message.
+ *
+ * Input Parameters:
+ *   conn - The UDP connection
+ *   msg  - Receives the control messages
+ *
+ * Returned Value:
+ *   0 on success, -EAGAIN if the error queue is empty, -ENOBUFS if the
+ *   control buffer is too small.
+ *
+ ****************************************************************************/
+
+ssize_t udp_tstamp_errqueue(FAR struct udp_conn_s *conn,
+                            FAR struct msghdr *msg)
+{
+  struct udp_tstamp_rec_s rec;
+  struct sock_extended_err serr;
+  FAR void *cmsg;
+
+  nxmutex_lock(&g_udp_tstamp_lock);
+
+  if (conn->errqueue == NULL)
+    {
+      nxmutex_unlock(&g_udp_tstamp_lock);
+      return -EAGAIN;
+    }
+
+  iob_copyout((FAR uint8_t *)&rec, conn->errqueue, sizeof(rec), 0);
+
+  memset(&serr, 0, sizeof(serr));
+  serr.ee_errno  = ENOMSG;
+  serr.ee_origin = SO_EE_ORIGIN_TIMESTAMPING;
+  serr.ee_info   = SCM_TSTAMP_SND;
+  serr.ee_data   = rec.key;
+
+  cmsg = cmsg_append(msg, SOL_SOCKET, SCM_TIMESTAMPING, &rec.tss,
+                     sizeof(rec.tss));
+  if (cmsg != NULL)
+    {
+#ifdef CONFIG_NET_IPv6
+      if (conn->domain == PF_INET6)
+        {
+          cmsg = cmsg_append(msg, SOL_IPV6, IPV6_RECVERR, &serr,
+                             sizeof(serr));
+        }
+      else
+#endif
+        {
+          cmsg = cmsg_append(msg, SOL_IP, IP_RECVERR, &serr, sizeof(serr));
+        }
+    }
+
+  if (cmsg == NULL)
+    {
+      nxmutex_unlock(&g_udp_tstamp_lock);
+      return -ENOBUFS;
+    }
+
+  if (conn->errqueue->io_pktlen <= sizeof(rec))
+    {
+      iob_free_chain(conn->errqueue);
+      conn->errqueue = NULL;
+    }
+  else
+    {
+      conn->errqueue = iob_trimhead(conn->errqueue, sizeof(rec));
+    }
+
+  nxmutex_unlock(&g_udp_tstamp_lock);
+
+  msg->msg_flags |= MSG_ERRQUEUE;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: net_txtstamp
+ *
+ * Description:
+ *   Report the transmit time of a packet whose io_tsid is set, the time it
+ *   was handed to the driver (hw is false) or the time the hardware put it
+ *   on the wire (hw is true).  The timestamp is queued to the error queue
+ *   of the sending socket once no further timestamp is expected, a NULL
+ *   ts with hw true completes the request with what has been reported so
+ *   far.  io_tsid is cleared when the request is complete.
+ *
+ * Input Parameters:
+ *   iob - The head of the transmitted packet
+ *   ts  - The CLOCK_REALTIME (software) or PHC (hardware) time, or NULL
+ *   hw  - Whether ts comes from the hardware
+ *
+ * Assumptions:
+ *   Not called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void net_txtstamp(FAR struct iob_s *iob, FAR const struct timespec *ts,
+                  bool hw)
+{
+  FAR struct udp_tstamp_s *req;
+
+  if (iob->io_tsid == 0)
+    {
+      return;
+    }
+
+  nxmutex_lock(&g_udp_tstamp_lock);
+
+  req = &g_udp_tstamp[iob->io_tsid % CONFIG_NET_TIMESTAMPING_NTX];
+  if (req->id != iob->io_tsid)
+    {
+      /* Dropped for a newer request or the socket is gone */
+
+      iob->io_tsid = 0;
+      nxmutex_unlock(&g_udp_tstamp_lock);
+      return;
+    }
+
+  if (hw)
+    {
+      if (ts != NULL && (req->flags & SOF_TIMESTAMPING_TX_HARDWARE) &&
+          (req->flags & SOF_TIMESTAMPING_RAW_HARDWARE))
+        {
+          req->tss.ts[2] = *ts;
+        }
+    }
+  else
+    {
+      if (ts != NULL && (req->flags & SOF_TIMESTAMPING_TX_SOFTWARE) &&
+          (req->flags & SOF_TIMESTAMPING_SOFTWARE))
+        {
+          req->tss.ts[0] = *ts;
+        }
+
+      /* Keep the request for the hardware timestamp still to come */
+
+      if (req->flags & SOF_TIMESTAMPING_TX_HARDWARE)
+        {
+          nxmutex_unlock(&g_udp_tstamp_lock);
+          return;
+        }
+    }
+
+  udp_tstamp_queue(req);
+
+  req->id      = 0;
+  req->conn    = NULL;
+  iob->io_tsid = 0;
+
+  nxmutex_unlock(&g_udp_tstamp_lock);
+}
+
+#endif /* CONFIG_NET_TIMESTAMPING */
@@ -105,6 +105,17 @@ struct usrsock_conn_s
     } datain;
   } resp;
 
+#if CONFIG_NET_USRSOCK_SEND_CREDITS > 0
+  struct
+  {
+    /* Exchange ids of the sends in flight */
+
+    uint32_t xid[CONFIG_NET_USRSOCK_SEND_CREDITS];
+    uint8_t  count;             /* Number of sends in flight */
+    int      error;             /* Failure to report by the next send */
+  } async;
+#endif
+
   /* The following is a list of poll structures of threads waiting for
    * socket events.
    */
@@ -271,6 +282,23 @@ int usrsock_event(FAR struct usrsock_conn_s *conn);
 int usrsock_do_request(FAR struct usrsock_conn_s *conn,
                        FAR struct iovec *iov, unsigned int iovcnt);
 
+/****************************************************************************
+ * Name: usrsock_do_request_async
+ *
+ * Description:
+ *   Send a request allocated with kmm_malloc() to the usrsock network
+ *   interface driver without waiting for its response.  The response
+ *   only returns the credit taken from the connection, and keeps a
+ *   failure for the next request.  The buffer is freed by the driver.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_USRSOCK_SEND_CREDITS > 0
+int usrsock_do_request_async(FAR struct usrsock_conn_s *conn,
+                             FAR struct usrsock_request_common_s *req_head,
+                             size_t len);
+#endif
+
 /****************************************************************************
  * Name: usrsock_socket
  *
@@ -426,6 +426,91 @@ usrsock_handle_datareq_response(FAR struct usrsock_conn_s *conn,
   return sizeof(*datahdr);
 }
 
+/****************************************************************************
+ * Name: usrsock_newxid
+ ****************************************************************************/
+
+static uint32_t usrsock_newxid(FAR struct usrsock_req_s *req)
+{
+  if (++req->newxid == 0)
+    {
+      ++req->newxid;
+    }
+
+  return req->newxid;
+}
+
+#if CONFIG_NET_USRSOCK_SEND_CREDITS > 0
+/****************************************************************************
+ * Name: usrsock_async_remove
+ ****************************************************************************/
+
+static bool usrsock_async_remove(FAR struct usrsock_conn_s *conn,
+                                 uint32_t xid)
+{
+  int i;
+
+  for (i = 0; i < conn->async.count; i++)
+    {
+      if (conn->async.xid[i] == xid)
+        {
+          conn->async.xid[i] = conn->async.xid[--conn->async.count];
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: usrsock_async_response
+ *
+ * Description:
+ *   Handle the response to a request sent by usrsock_do_request_async().
+ *
+ ****************************************************************************/
+
+static ssize_t
+usrsock_async_response(FAR const struct usrsock_message_req_ack_s *hdr,
+                       size_t hdrlen)
+{
+  FAR struct usrsock_conn_s *conn = NULL;
+
+  if (USRSOCK_MESSAGE_REQ_IN_PROGRESS(hdr->head.flags))
+    {
+      return hdrlen;
+    }
+
+  while ((conn = usrsock_nextconn(conn)) != NULL &&
+         !usrsock_async_remove(conn, hdr->xid));
+  if (!conn)
+    {
+      return -ENOENT;
+    }
+
+  if (hdr->result < 0 && hdr->result != -EAGAIN && conn->async.error == 0)
+    {
+      conn->async.error = hdr->result;
+    }
+
+  if (!(hdr->head.events & USRSOCK_EVENT_SENDTO_READY) &&
+      (hdr->result >= 0 || hdr->result == -EAGAIN))
+    {
+      /* Same as for a synchronous send, the daemon will send an event to
+       * restore this flag.
+       */
+
+      conn->flags &= ~USRSOCK_EVENT_SENDTO_READY;
+    }
+
+  /* Forward the events, but nobody waits for this request to complete */
+
+  conn->resp.events = hdr->head.events & ~USRSOCK_EVENT_INTERNAL_MASK;
+  usrsock_event(conn);
+  return hdrlen;
+}
+#endif
+
 /****************************************************************************
  * Name: usrsock_handle_req_response
  ****************************************************************************/
@@ -471,8 +556,29 @@ static ssize_t usrsock_handle_req_response(FAR const void *buffer,
 
   /* Get corresponding usrsock connection for this transfer */
 
+#ifdef CONFIG_NET_USRSOCK_PIPELINE
+  /* Any response ends the reading of the request it answers */
+
+  if (req_done)
+    {
+      *req_done = true;
+    }
+#endif
+
   while ((conn = usrsock_nextconn(conn)) != NULL &&
          conn->resp.xid != hdr->xid);
+
+#if CONFIG_NET_USRSOCK_SEND_CREDITS > 0
+  if (!conn)
+    {
+      ret = usrsock_async_response(hdr, hdrlen);
+      if (ret != -ENOENT)
+        {
+          goto unlock_out;
+        }
+    }
+#endif
+
   if (!conn)
     {
       /* No connection waiting for this message. */
@@ -648,15 +754,31 @@ int usrsock_do_request(FAR struct usrsock_conn_s *conn,
 
   req_head = iov[0].iov_base;
 
-  /* Set outstanding request for daemon to handle. */
+#ifdef CONFIG_NET_USRSOCK_PIPELINE
+  /* usrsock_request() returns once the daemon has the request, the
+   * response is waited for by the caller.  Meanwhile the requests of
+   * other sockets may go to the daemon.
+   */
 
-  usrsock_mutex_timedlock(&req->lock, UINT_MAX);
-  if (++req->newxid == 0)
+  req_head->xid = usrsock_newxid(req);
+
+  /* Prepare connection for response. */
+
+  conn->resp.xid = req_head->xid;
+  conn->resp.result = -EACCES;
+
+  ret = usrsock_request(iov, iovcnt);
+  if (ret < 0)
     {
-      ++req->newxid;
+      nerr("error: usrsock request failed with %d\n", ret);
     }
 
-  req_head->xid = req->newxid;
+  return ret;
+#else
+  /* Set outstanding request for daemon to handle. */
+
+  usrsock_mutex_timedlock(&req->lock, UINT_MAX);
+  req_head->xid = usrsock_newxid(req);
 
   /* Prepare connection for response. */
 
@@ -683,8 +805,38 @@ int usrsock_do_request(FAR struct usrsock_conn_s *conn,
 
   nxmutex_unlock(&req->lock);
   return ret;
+#endif
 }
 
+/****************************************************************************
+ * Name: usrsock_do_request_async() - send usrsock's request, don't wait
+ ****************************************************************************/
+
+#if CONFIG_NET_USRSOCK_SEND_CREDITS > 0
+int usrsock_do_request_async(FAR struct usrsock_conn_s *conn,
+                             FAR struct usrsock_request_common_s *req_head,
+                             size_t len)
+{
+  uint32_t xid;
+  int ret;
+
+  DEBUGASSERT(conn->async.count < CONFIG_NET_USRSOCK_SEND_CREDITS);
+
+  xid = usrsock_newxid(&g_usrsock_req);
+  req_head->xid = xid;
+  conn->async.xid[conn->async.count++] = xid;
+
+  ret = usrsock_request_buffer(req_head, len);
+  if (ret < 0)
+    {
+      nerr("error: usrsock request failed with %d\n", ret);
+      usrsock_async_remove(conn, xid);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: usrsock_abort() - abort all usrsock's operations
  ****************************************************************************/
@@ -703,6 +855,9 @@ void usrsock_abort(void)
     {
       conn->resp.inprogress = false;
       conn->resp.xid = 0;
+#if CONFIG_NET_USRSOCK_SEND_CREDITS > 0
+      conn->async.count = 0;
+#endif
       conn->resp.events = USRSOCK_EVENT_ABORT;
       usrsock_event(conn);
     }
@@ -36,6 +36,7 @@
 #include <arch/irq.h>
 
 #include <sys/socket.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/usrsock.h>
 
@@ -177,6 +178,59 @@ static int do_sendto_request(FAR struct usrsock_conn_s *conn,
   return usrsock_do_request(conn, bufs, nitems(bufs));
 }
 
+/****************************************************************************
+ * Name: do_sendto_async
+ *
+ * Description:
+ *   Copy the message into a request and send it without waiting for the
+ *   response.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_USRSOCK_SEND_CREDITS > 0
+static ssize_t do_sendto_async(FAR struct usrsock_conn_s *conn,
+                               FAR struct msghdr *msg, int flags)
+{
+  FAR struct usrsock_request_sendto_s *req;
+  FAR uint8_t *data;
+  size_t buflen = 0;
+  int ret;
+  int i;
+
+  for (i = 0; i < msg->msg_iovlen; i++)
+    {
+      buflen += msg->msg_iov[i].iov_len;
+    }
+
+  req = kmm_malloc(sizeof(*req) + msg->msg_namelen + buflen);
+  if (req == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset(req, 0, sizeof(*req));
+  req->head.reqid = USRSOCK_REQUEST_SENDTO;
+  req->usockid = conn->usockid;
+  req->flags = flags;
+  req->addrlen = msg->msg_namelen;
+  req->buflen = buflen;
+
+  data = (FAR uint8_t *)(req + 1);
+  memcpy(data, msg->msg_name, msg->msg_namelen);
+  data += msg->msg_namelen;
+
+  for (i = 0; i < msg->msg_iovlen; i++)
+    {
+      memcpy(data, msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+      data += msg->msg_iov[i].iov_len;
+    }
+
+  ret = usrsock_do_request_async(conn, &req->head,
+                                 sizeof(*req) + msg->msg_namelen + buflen);
+  return ret < 0 ? ret : buflen;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -268,6 +322,17 @@ ssize_t usrsock_sendmsg(FAR struct socket *psock,
       goto errout_unlock;
     }
 
+#if CONFIG_NET_USRSOCK_SEND_CREDITS > 0
+  /* Report the failure of an earlier asynchronous send */
+
+  if (conn->async.error < 0)
+    {
+      ret = conn->async.error;
+      conn->async.error = 0;
+      goto errout_unlock;
+    }
+#endif
+
   do
     {
       /* Check if remote end has closed connection. */
@@ -350,6 +415,24 @@ ssize_t usrsock_sendmsg(FAR struct socket *psock,
           DEBUGASSERT(conn->flags & USRSOCK_EVENT_SENDTO_READY);
         }
 
+#if CONFIG_NET_USRSOCK_SEND_CREDITS > 0
+      /* A datagram is sent completely or not at all, so it needs no
+       * response if a credit is left.  Otherwise wait for the response,
+       * which is our flow control.
+       */
+
+      if (psock->s_type == SOCK_DGRAM &&
+          conn->async.count < CONFIG_NET_USRSOCK_SEND_CREDITS &&
+          msg->msg_namelen <= UINT16_MAX)
+        {
+          ret = do_sendto_async(conn, msg, flags & ~MSG_DONTWAIT);
+          if (ret != -ENOMEM)
+            {
+              goto errout_unlock;
+            }
+        }
+#endif
+
       /* Set up event callback for usrsock. */
 
       ret = usrsock_setup_request_callback(conn, &state, sendto_event,
@@ -308,4 +308,64 @@ uint16_t ipv4_chksum(FAR struct ipv4_hdr_s *ipv4)
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
+/****************************************************************************
+ * Name: net_chksum_offload
+ *
+ * Description:
+ *   Leave the TCP or UDP checksum of the packet in d_iob to the device if
+ *   it can compute it: store the pseudo-header sum in the checksum field
+ *   and mark the packet IOB_CSUM_PARTIAL.  The IP header must be built.
+ *
+ * Input Parameters:
+ *   dev    - The network device the packet is sent on
+ *   proto  - IP_PROTO_TCP or IP_PROTO_UDP
+ *   chksum - The checksum field of the TCP or UDP header
+ *
+ * Returned Value:
+ *   true if the device will compute the checksum, false if it has to be
+ *   computed in software.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+bool net_chksum_offload(FAR struct net_driver_s *dev, uint8_t proto,
+                        FAR uint16_t *chksum)
+{
+  uint8_t cap = proto == IP_PROTO_TCP ? NETDEV_CSUM_TCP : NETDEV_CSUM_UDP;
+  uint16_t sum;
+
+  /* The packet may be a reused receive buffer, reset its state */
+
+  dev->d_iob->io_csum = IOB_CSUM_NONE;
+  if ((dev->d_csumcap & cap) == 0)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      sum = ipv6_upperlayer_header_chksum(dev, proto, IPv6_HDRLEN);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      sum = ipv4_upperlayer_header_chksum(dev, proto);
+    }
+#endif
+
+  /* The device adds the header and payload and stores the complement */
+
+  *chksum = HTONS(sum);
+  dev->d_iob->io_csum = IOB_CSUM_PARTIAL;
+  return true;
+}
+#endif /* CONFIG_NETDEV_CSUM_OFFLOAD */
+
 #endif /* CONFIG_NET */
@@ -54,6 +54,106 @@
 
 static rmutex_t g_netlock = NXRMUTEX_INITIALIZER;
 
+#ifdef CONFIG_NET_LOCK_STATS
+/* Both are only accessed by the holder of g_netlock */
+
+static struct net_lockstats_s g_netlock_stats;
+static clock_t g_netlock_start;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATS
+
+/****************************************************************************
+ * Name: net_lockstats_acquire
+ *
+ * Description:
+ *   Take 'mutex' with the recursion count 'count' and, if it is the
+ *   network lock, account for the time spent getting it.
+ *
+ ****************************************************************************/
+
+static int net_lockstats_acquire(FAR rmutex_t *mutex, unsigned int count)
+{
+  bool contended = false;
+  clock_t start;
+  clock_t wait;
+  int ret;
+
+  if (mutex != &g_netlock || count == 0)
+    {
+      return nxrmutex_restorelock(mutex, count);
+    }
+
+  start = perf_gettime();
+  ret   = nxmutex_trylock(&mutex->mutex);
+  if (ret < 0)
+    {
+      contended = true;
+      ret       = nxmutex_lock(&mutex->mutex);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  mutex->count = count;
+
+  g_netlock_start = perf_gettime();
+  wait            = g_netlock_start - start;
+
+  g_netlock_stats.acquired++;
+  g_netlock_stats.waittime += wait;
+  if (contended)
+    {
+      g_netlock_stats.contended++;
+    }
+
+  if (wait > g_netlock_stats.waitmax)
+    {
+      g_netlock_stats.waitmax = wait;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: net_lockstats_release
+ *
+ * Description:
+ *   Called just before 'mutex' is fully released.  Accounts for the hold
+ *   time if it is the network lock and the caller holds it.
+ *
+ ****************************************************************************/
+
+static void net_lockstats_release(FAR rmutex_t *mutex)
+{
+  clock_t hold;
+
+  if (mutex != &g_netlock || !nxrmutex_is_hold(mutex))
+    {
+      return;
+    }
+
+  hold = perf_gettime() - g_netlock_start;
+
+  g_netlock_stats.holdtime += hold;
+  if (hold > g_netlock_stats.holdmax)
+    {
+      g_netlock_stats.holdmax = hold;
+    }
+}
+
+#  define NET_LOCK_RELEASE(m) net_lockstats_release(m)
+#  define NET_LOCK_RESTORE(m, c) net_lockstats_acquire(m, c)
+#else
+#  define NET_LOCK_RELEASE(m)
+#  define NET_LOCK_RESTORE(m, c) nxrmutex_restorelock(m, c)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -78,11 +178,13 @@ int net_sem_timedwait2(FAR sem_t *sem, bool interruptible,
 
   if (mutex1 != NULL)
     {
+      NET_LOCK_RELEASE(mutex1);
       blresult1 = nxrmutex_breaklock(mutex1, &count1);
     }
 
   if (mutex2 != NULL)
     {
+      NET_LOCK_RELEASE(mutex2);
       blresult2 = nxrmutex_breaklock(mutex2, &count2);
     }
 
@@ -119,12 +221,12 @@ int net_sem_timedwait2(FAR sem_t *sem, bool interruptible,
 
   if (blresult2 >= 0)
     {
-      nxrmutex_restorelock(mutex2, count2);
+      NET_LOCK_RESTORE(mutex2, count2);
     }
 
   if (blresult1 >= 0)
     {
-      nxrmutex_restorelock(mutex1, count1);
+      NET_LOCK_RESTORE(mutex1, count1);
     }
 
   return ret;
@@ -147,6 +249,13 @@ int net_sem_timedwait2(FAR sem_t *sem, bool interruptible,
 
 int net_lock(void)
 {
+#ifdef CONFIG_NET_LOCK_STATS
+  if (!nxrmutex_is_hold(&g_netlock))
+    {
+      return net_lockstats_acquire(&g_netlock, 1);
+    }
+#endif
+
   return nxrmutex_lock(&g_netlock);
 }
 
@@ -169,7 +278,20 @@ int net_lock(void)
 
 int net_trylock(void)
 {
+#ifdef CONFIG_NET_LOCK_STATS
+  bool outer = !nxrmutex_is_hold(&g_netlock);
+  int ret = nxrmutex_trylock(&g_netlock);
+
+  if (ret >= 0 && outer)
+    {
+      g_netlock_start = perf_gettime();
+      g_netlock_stats.acquired++;
+    }
+
+  return ret;
+#else
   return nxrmutex_trylock(&g_netlock);
+#endif
 }
 
 /****************************************************************************
@@ -188,6 +310,13 @@ int net_trylock(void)
 
 void net_unlock(void)
 {
+#ifdef CONFIG_NET_LOCK_STATS
+  if (!nxrmutex_is_recursive(&g_netlock))
+    {
+      NET_LOCK_RELEASE(&g_netlock);
+    }
+#endif
+
   nxrmutex_unlock(&g_netlock);
 }
 
@@ -203,6 +332,8 @@ void net_unlock(void)
 int net_breaklock(FAR unsigned int *count)
 {
   DEBUGASSERT(count != NULL);
+
+  NET_LOCK_RELEASE(&g_netlock);
   return nxrmutex_breaklock(&g_netlock, count);
 }
 
@@ -220,9 +351,26 @@ int net_breaklock(FAR unsigned int *count)
 
 int net_restorelock(unsigned int count)
 {
-  return nxrmutex_restorelock(&g_netlock, count);
+  return NET_LOCK_RESTORE(&g_netlock, count);
 }
 
+/****************************************************************************
+ * Name: net_lockstats
+ *
+ * Description:
+ *   Return a snapshot of the network lock usage counters.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATS
+void net_lockstats(FAR struct net_lockstats_s *stats)
+{
+  net_lock();
+  *stats = g_netlock_stats;
+  net_unlock();
+}
+#endif
+
 /****************************************************************************
  * Name: net_sem_timedwait
  *
@@ -0,0 +1,130 @@
+/****************************************************************************
+ * net/utils/net_stats.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+
+#ifdef CONFIG_NET_STATISTICS_PERCPU
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* IP/TCP/UDP/ICMP statistics of all network interfaces, one copy per CPU */
+
+struct net_stats_s g_netstats_cpu[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_stats_sum
+ *
+ * Description:
+ *   Add up one counter over the copies of all CPUs.
+ *
+ * Input Parameters:
+ *   offset - The offset of the counter in struct net_stats_s
+ *
+ * Returned Value:
+ *   The total count.
+ *
+ ****************************************************************************/
+
+net_stats_t net_stats_sum(size_t offset)
+{
+  net_stats_t sum = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      sum += *(FAR net_stats_t *)((FAR uint8_t *)&g_netstats_cpu[cpu] +
+                                  offset);
+    }
+
+  return sum;
+}
+
+/****************************************************************************
+ * Name: netdev_statistics_get
+ *
+ * Description:
+ *   Add up the per-CPU copies of the device counters.
+ *
+ * Input Parameters:
+ *   dev - The network device
+ *   buf - Where to store the total
+ *
+ * Returned Value:
+ *   buf, holding the total counts.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_STATISTICS
+FAR struct netdev_statistics_s *
+netdev_statistics_get(FAR struct net_driver_s *dev,
+                      FAR struct netdev_statistics_s *buf)
+{
+  FAR struct netdev_statistics_s *stats;
+  int cpu;
+
+  memset(buf, 0, sizeof(*buf));
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      stats = &dev->d_statistics[cpu];
+
+      buf->rx_packets   += stats->rx_packets;
+      buf->rx_fragments += stats->rx_fragments;
+      buf->rx_errors    += stats->rx_errors;
+#ifdef CONFIG_NET_IPv4
+      buf->rx_ipv4      += stats->rx_ipv4;
+#endif
+#ifdef CONFIG_NET_IPv6
+      buf->rx_ipv6      += stats->rx_ipv6;
+#endif
+#ifdef CONFIG_NET_ARP
+      buf->rx_arp       += stats->rx_arp;
+#endif
+      buf->rx_dropped   += stats->rx_dropped;
+      buf->rx_bytes     += stats->rx_bytes;
+      buf->tx_packets   += stats->tx_packets;
+      buf->tx_done      += stats->tx_done;
+      buf->tx_errors    += stats->tx_errors;
+      buf->tx_timeouts  += stats->tx_timeouts;
+      buf->tx_bytes     += stats->tx_bytes;
+      buf->errors       += stats->errors;
+    }
+
+  return buf;
+}
+#endif /* CONFIG_NETDEV_STATISTICS */
+
+#endif /* CONFIG_NET_STATISTICS_PERCPU */
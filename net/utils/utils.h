@@ -78,6 +78,18 @@
       (nport) = HTONS(hport); \
     } while (0)
 
+/* Whether the TCP/UDP checksum of the packet in d_iob is known good, either
+ * verified by the hardware or built locally and looped back.
+ */
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+#  define net_chksum_verified(dev) \
+     ((dev)->d_iob != NULL && (dev)->d_iob->io_csum != IOB_CSUM_NONE)
+#else
+#  define net_chksum_verified(dev) false
+#  define net_chksum_offload(dev, proto, chksum) false
+#endif
+
 /* Network buffer pool related macros, in which:
  *   pool:     The name of the buffer pool
  *   nodesize: The size of each node in the pool
@@ -141,6 +153,22 @@ struct net_bufpool_s
   sq_queue_t freebuffers;
 };
 
+#ifdef CONFIG_NET_LOCK_STATS
+/* Network lock usage.  Times are in perf_gettime() cycles and only the
+ * outermost acquisition of the re-entrant lock is counted.
+ */
+
+struct net_lockstats_s
+{
+  uint32_t acquired;   /* Number of times the lock was taken */
+  uint32_t contended;  /* Number of times the taker had to wait */
+  uint64_t waittime;   /* Total time spent waiting for the lock */
+  clock_t  waitmax;    /* Longest single wait */
+  uint64_t holdtime;   /* Total time the lock was held */
+  clock_t  holdmax;    /* Longest single hold */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -248,6 +276,21 @@ int net_breaklock(FAR unsigned int *count);
 
 int net_restorelock(unsigned int count);
 
+/****************************************************************************
+ * Name: net_lockstats
+ *
+ * Description:
+ *   Return a snapshot of the network lock usage counters.
+ *
+ * Input Parameters:
+ *   stats - Location to return the counters
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATS
+void net_lockstats(FAR struct net_lockstats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: net_dsec2timeval
  *
@@ -546,6 +589,30 @@ void net_chksum_adjust(FAR uint16_t *chksum,
                        FAR const uint16_t *optr, ssize_t olen,
                        FAR const uint16_t *nptr, ssize_t nlen);
 
+/****************************************************************************
+ * Name: net_chksum_offload
+ *
+ * Description:
+ *   Leave the TCP or UDP checksum of the packet in d_iob to the device if
+ *   it can compute it: store the pseudo-header sum in the checksum field
+ *   and mark the packet IOB_CSUM_PARTIAL.  The IP header must be built.
+ *
+ * Input Parameters:
+ *   dev    - The network device the packet is sent on
+ *   proto  - IP_PROTO_TCP or IP_PROTO_UDP
+ *   chksum - The checksum field of the TCP or UDP header
+ *
+ * Returned Value:
+ *   true if the device will compute the checksum, false if it has to be
+ *   computed in software.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+bool net_chksum_offload(FAR struct net_driver_s *dev, uint8_t proto,
+                        FAR uint16_t *chksum);
+#endif
+
 /****************************************************************************
  * Name: tcp_chksum, tcp_ipv4_chksum, and tcp_ipv6_chksum
  *
@@ -78,6 +78,10 @@ void clock_increase_sched_ticks(clock_t ticks);
 
 clock_t clock_get_sched_ticks(void);
 
+#ifdef CONFIG_CLOCK_VDSO
+void clock_vdso_update(void);
+#endif
+
 /****************************************************************************
  * perf_init
  ****************************************************************************/
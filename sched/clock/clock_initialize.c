@@ -182,6 +182,10 @@ static void clock_inittime(FAR const struct timespec *tp)
     }
 
   spin_unlock_irqrestore(&g_basetime_lock, flags);
+
+#  ifdef CONFIG_CLOCK_VDSO
+  clock_vdso_update();
+#  endif
 #else
   clock_inittimekeeping(tp);
 #endif
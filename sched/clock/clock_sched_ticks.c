@@ -69,6 +69,10 @@ void clock_increase_sched_ticks(clock_t ticks)
 #else
   atomic_fetch_add((FAR atomic_t *)&g_system_ticks, ticks);
 #endif
+
+#ifdef CONFIG_CLOCK_VDSO
+  clock_vdso_update();
+#endif
 }
 
 /****************************************************************************
@@ -75,6 +75,10 @@ static void nxclock_set_realtime(FAR const struct timespec *tp)
 
   spin_unlock_irqrestore(&g_basetime_lock, flags);
 
+#  ifdef CONFIG_CLOCK_VDSO
+  clock_vdso_update();
+#  endif
+
   /* Setup the RTC (lo- or high-res) */
 
 #  ifdef CONFIG_RTC
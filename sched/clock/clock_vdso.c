@@ -0,0 +1,89 @@
+/****************************************************************************
+ * sched/clock/clock_vdso.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/userspace.h>
+#include <nuttx/vdso.h>
+
+#include "clock/clock.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Serializes the writers: the timer interrupt and clock_settime() */
+
+static spinlock_t g_vdso_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_vdso_update
+ *
+ * Description:
+ *   Publish the current system tick count and base time to user space.
+ *   Called on every timer tick and whenever the base time changes.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clock_vdso_update(void)
+{
+  FAR struct vdso_data_s *vdso = USERSPACE->us_vdso;
+  irqstate_t flags;
+
+  if (vdso == NULL)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_vdso_lock);
+
+  atomic_set((FAR atomic_t *)&vdso->vd_seq, vdso->vd_seq + 1);
+  SMP_WMB();
+
+  vdso->vd_ticks = clock_get_sched_ticks();
+
+  spin_lock(&g_basetime_lock);
+  vdso->vd_basetime = g_basetime;
+  spin_unlock(&g_basetime_lock);
+
+  SMP_WMB();
+  atomic_set((FAR atomic_t *)&vdso->vd_seq, vdso->vd_seq + 1);
+
+  spin_unlock_irqrestore(&g_vdso_lock, flags);
+}
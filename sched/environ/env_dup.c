@@ -66,8 +66,10 @@
 int env_dup(FAR struct task_group_s *group, FAR char * const *envcp)
 {
   FAR char **envp = NULL;
+  FAR char *blk;
   irqstate_t flags;
   size_t envc = 0;
+  size_t total = 0;
   size_t size;
   int ret = OK;
 
@@ -83,11 +85,11 @@ int env_dup(FAR struct task_group_s *group, FAR char * const *envcp)
 
       flags = enter_critical_section();
 
-      /* Count the strings */
+      /* Count the strings and their size */
 
       while (envcp[envc] != NULL)
         {
-          envc++;
+          total += strlen(envcp[envc++]) + 1;
         }
 
       group->tg_envc = envc;
@@ -100,48 +102,50 @@ int env_dup(FAR struct task_group_s *group, FAR char * const *envcp)
 
       if (envc > 0)
         {
-          /* There is an environment, duplicate it */
+          /* There is an environment, duplicate it.  All the strings are
+           * copied into a single allocation, only the variables set later
+           * are allocated one by one.
+           */
 
           envp = group_malloc(group, sizeof(*envp) * group->tg_envpc);
-          if (envp == NULL)
+          blk  = group_malloc(group, total);
+          if (envp == NULL || blk == NULL)
             {
               /* The parent's environment can not be inherited due to a
                * failure in the allocation of the child environment.
                */
 
+              group_free(group, envp);
+              group_free(group, blk);
+              envp = NULL;
               ret = -ENOMEM;
             }
           else
             {
-              envp[envc] = NULL;
+              group->tg_envblk     = blk;
+              group->tg_envblksize = total;
 
               /* Duplicate the parent environment. */
 
-              while (envc-- > 0)
+              for (envc = 0; envcp[envc] != NULL; envc++)
                 {
                   size = strlen(envcp[envc]) + 1;
-                  envp[envc] = group_malloc(group, size);
-                  if (envp[envc] == NULL)
-                    {
-                      while (envp[++envc] != NULL)
-                        {
-                          group_free(group, envp[envc]);
-                        }
-
-                      group_free(group, envp);
-                      envp = NULL;
-                      ret = -ENOMEM;
-                      break;
-                    }
-
-                  strlcpy(envp[envc], envcp[envc], size);
+                  memcpy(blk, envcp[envc], size);
+                  envp[envc] = blk;
+                  blk += size;
                 }
+
+              envp[envc] = NULL;
             }
         }
 
       /* Save the child environment allocation. */
 
       group->tg_envp = envp;
+      if (envp != NULL)
+        {
+          env_hashrebuild(group);
+        }
 
       leave_critical_section(flags);
     }
@@ -98,6 +98,16 @@ ssize_t env_findvar(FAR struct task_group_s *group, FAR const char *pname)
       return -ENOENT;
     }
 
+#ifdef CONFIG_ENVIRON_HASH
+  /* Use the hash index if the group has one */
+
+  i = env_hashfind(group, pname);
+  if (i != -ENOSYS)
+    {
+      return i;
+    }
+#endif
+
   /* Search for a name=value string with matching name */
 
   for (i = 0; group->tg_envp[i] != NULL; i++)
@@ -0,0 +1,359 @@
+/****************************************************************************
+ * sched/environ/env_hash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "environ/environ.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Smallest index allocated.  The index is kept at least twice as large as
+ * the number of variables so that probe sequences stay short.
+ */
+
+#define ENV_HASH_MINSIZE 16
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: env_hashname
+ *
+ * Description:
+ *   FNV-1a hash of a variable name, which ends at the '\0' of a bare name
+ *   or at the '=' of a name=value string.
+ *
+ ****************************************************************************/
+
+static uint32_t env_hashname(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  for (; *name != '\0' && *name != '='; name++)
+    {
+      hash = (hash ^ (uint8_t)*name) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: env_hashslot
+ *
+ * Description:
+ *   Return the slot of the index that refers to tg_envp[index], or -1.
+ *
+ ****************************************************************************/
+
+static ssize_t env_hashslot(FAR struct task_group_s *group, ssize_t index)
+{
+  size_t mask = group->tg_envhashsize - 1;
+  size_t i = env_hashname(group->tg_envp[index]) & mask;
+
+  while (group->tg_envhash[i] != 0)
+    {
+      if (group->tg_envhash[i] == index + 1)
+        {
+          return i;
+        }
+
+      i = (i + 1) & mask;
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: env_hashinsert
+ ****************************************************************************/
+
+static void env_hashinsert(FAR struct task_group_s *group, ssize_t index)
+{
+  size_t mask = group->tg_envhashsize - 1;
+  size_t i = env_hashname(group->tg_envp[index]) & mask;
+
+  while (group->tg_envhash[i] != 0)
+    {
+      i = (i + 1) & mask;
+    }
+
+  group->tg_envhash[i] = index + 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: env_hashfind
+ *
+ * Description:
+ *   Look up a variable in the hash index of the group environment.
+ *
+ * Input Parameters:
+ *   group - The task group containing environment array to be searched.
+ *   pname - The variable name to find
+ *
+ * Returned Value:
+ *   The index of the name=value string in tg_envp, -ENOENT if there is no
+ *   such variable, or -ENOSYS if the group has no hash index.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Pre-emption is disabled by caller
+ *
+ ****************************************************************************/
+
+ssize_t env_hashfind(FAR struct task_group_s *group, FAR const char *pname)
+{
+  FAR const char *var;
+  size_t mask;
+  size_t len;
+  size_t i;
+  int slot;
+
+  if (group->tg_envhash == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  len  = strlen(pname);
+  mask = group->tg_envhashsize - 1;
+  i    = env_hashname(pname) & mask;
+
+  while ((slot = group->tg_envhash[i]) != 0)
+    {
+      var = group->tg_envp[slot - 1];
+      if (strncmp(var, pname, len) == 0 && var[len] == '=')
+        {
+          return slot - 1;
+        }
+
+      i = (i + 1) & mask;
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: env_hashrebuild
+ *
+ * Description:
+ *   (Re)build the hash index from the tg_envc strings in tg_envp.  On an
+ *   allocation failure the group is left without an index and lookups use
+ *   the linear search until the next rebuild succeeds.
+ *
+ * Input Parameters:
+ *   group - The task group owning the environment
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void env_hashrebuild(FAR struct task_group_s *group)
+{
+  size_t size = ENV_HASH_MINSIZE;
+  FAR int *hash;
+  ssize_t i;
+
+  while (size < 2 * (size_t)group->tg_envc + 2)
+    {
+      size <<= 1;
+    }
+
+  hash = group_zalloc(group, sizeof(*hash) * size);
+
+  env_hashrelease(group);
+  if (hash == NULL)
+    {
+      return;
+    }
+
+  group->tg_envhash     = hash;
+  group->tg_envhashsize = size;
+
+  for (i = 0; i < group->tg_envc; i++)
+    {
+      env_hashinsert(group, i);
+    }
+}
+
+/****************************************************************************
+ * Name: env_hashadd
+ *
+ * Description:
+ *   Index tg_envp[index], which must already be counted in tg_envc.  The
+ *   index is rebuilt at twice the size when it becomes half full.
+ *
+ * Input Parameters:
+ *   group - The task group owning the environment
+ *   index - The index of the new name=value string in tg_envp
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void env_hashadd(FAR struct task_group_s *group, ssize_t index)
+{
+  if (group->tg_envhash == NULL ||
+      2 * (size_t)group->tg_envc > group->tg_envhashsize)
+    {
+      env_hashrebuild(group);
+    }
+  else
+    {
+      env_hashinsert(group, index);
+    }
+}
+
+/****************************************************************************
+ * Name: env_hashremove
+ *
+ * Description:
+ *   Drop tg_envp[index] from the index.  The following entries of the
+ *   probe sequence are shifted back so that no tombstones are needed.
+ *
+ * Input Parameters:
+ *   group - The task group owning the environment
+ *   index - The index of the name=value string in tg_envp.  The string
+ *           must not have been freed yet.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void env_hashremove(FAR struct task_group_s *group, ssize_t index)
+{
+  FAR int *hash = group->tg_envhash;
+  ssize_t slot;
+  size_t mask;
+  size_t i;
+  size_t j;
+  size_t k;
+
+  if (hash == NULL)
+    {
+      return;
+    }
+
+  slot = env_hashslot(group, index);
+  DEBUGASSERT(slot >= 0);
+  if (slot < 0)
+    {
+      return;
+    }
+
+  mask    = group->tg_envhashsize - 1;
+  i       = slot;
+  hash[i] = 0;
+
+  for (j = (i + 1) & mask; hash[j] != 0; j = (j + 1) & mask)
+    {
+      /* Move the entry back into the hole unless its home slot lies
+       * cyclically within (i, j].
+       */
+
+      k = env_hashname(group->tg_envp[hash[j] - 1]) & mask;
+      if ((j > i && (k <= i || k > j)) || (j < i && k <= i && k > j))
+        {
+          hash[i] = hash[j];
+          hash[j] = 0;
+          i       = j;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: env_hashmove
+ *
+ * Description:
+ *   Record that the string at tg_envp[from] is moving to tg_envp[to].
+ *
+ * Input Parameters:
+ *   group - The task group owning the environment
+ *   from  - The current index of the name=value string in tg_envp
+ *   to    - The new index of the name=value string in tg_envp
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void env_hashmove(FAR struct task_group_s *group, ssize_t from, ssize_t to)
+{
+  ssize_t slot;
+
+  if (group->tg_envhash == NULL)
+    {
+      return;
+    }
+
+  slot = env_hashslot(group, from);
+  DEBUGASSERT(slot >= 0);
+  if (slot >= 0)
+    {
+      group->tg_envhash[slot] = to + 1;
+    }
+}
+
+/****************************************************************************
+ * Name: env_hashrelease
+ *
+ * Description:
+ *   Free the hash index of the group.
+ *
+ * Input Parameters:
+ *   group - The task group owning the environment
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void env_hashrelease(FAR struct task_group_s *group)
+{
+  if (group->tg_envhash != NULL)
+    {
+      group_free(group, group->tg_envhash);
+    }
+
+  group->tg_envhash     = NULL;
+  group->tg_envhashsize = 0;
+}
@@ -73,7 +73,7 @@ void env_release(FAR struct task_group_s *group)
 
       for (i = 0; group->tg_envp[i] != NULL; i++)
         {
-          group_free(group, group->tg_envp[i]);
+          env_freevar(group, group->tg_envp[i]);
         }
 
       /* Free the environment */
@@ -81,13 +81,22 @@ void env_release(FAR struct task_group_s *group)
       group_free(group, group->tg_envp);
     }
 
+  env_hashrelease(group);
+
+  if (group->tg_envblk)
+    {
+      group_free(group, group->tg_envblk);
+    }
+
   /* In any event, make sure that all environment-related variables in the
    * task group structure are reset to initial values.
    */
 
-  group->tg_envp  = NULL;
-  group->tg_envpc = 0;
-  group->tg_envc  = 0;
+  group->tg_envp       = NULL;
+  group->tg_envpc      = 0;
+  group->tg_envc       = 0;
+  group->tg_envblk     = NULL;
+  group->tg_envblksize = 0;
 }
 
 #endif /* CONFIG_DISABLE_ENVIRON */
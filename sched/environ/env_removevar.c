@@ -40,6 +40,31 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: env_freevar
+ *
+ * Description:
+ *   Free a name=value string, unless it is one of the strings inherited in
+ *   a single allocation by env_dup().
+ *
+ * Input Parameters:
+ *   group - The task group with the environment containing the string
+ *   var   - The name=value string
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void env_freevar(FAR struct task_group_s *group, FAR char *var)
+{
+  if (var < group->tg_envblk ||
+      var >= group->tg_envblk + group->tg_envblksize)
+    {
+      group_free(group, var);
+    }
+}
+
 /****************************************************************************
  * Name: env_removevar
  *
@@ -67,7 +92,8 @@ void env_removevar(FAR struct task_group_s *group, ssize_t index)
 
   /* Free the allocate environment string */
 
-  group_free(group, group->tg_envp[index]);
+  env_hashremove(group, index);
+  env_freevar(group, group->tg_envp[index]);
 
   /* Exchange the last env and the index env */
 
@@ -78,6 +104,7 @@ void env_removevar(FAR struct task_group_s *group, ssize_t index)
     }
   else
     {
+      env_hashmove(group, group->tg_envc, index);
       group->tg_envp[index] = group->tg_envp[group->tg_envc];
       group->tg_envp[group->tg_envc] = NULL;
     }
@@ -86,6 +113,7 @@ void env_removevar(FAR struct task_group_s *group, ssize_t index)
 
   if (group->tg_envc == 0)
     {
+      env_hashrelease(group);
       group_free(group, group->tg_envp);
       group->tg_envp = NULL;
       group->tg_envpc = 0;
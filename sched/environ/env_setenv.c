@@ -188,15 +188,17 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
       group->tg_envpc = envpc;
     }
 
+  /* Put the new name=value string into the environment buffer */
+
+  snprintf(pvar, varlen, "%s=%s", name, value);
+
   /* Save the new buffer and count */
 
   group->tg_envp[envc++] = pvar;
   group->tg_envp[envc]   = NULL;
   group->tg_envc = envc;
 
-  /* Now, put the new name=value string into the environment buffer */
-
-  snprintf(pvar, varlen, "%s=%s", name, value);
+  env_hashadd(group, envc - 1);
   leave_critical_section(flags);
   return OK;
 
@@ -41,6 +41,14 @@
 
 #  define SCHED_ENVIRON_RESERVED (4)
 
+#  ifndef CONFIG_ENVIRON_HASH
+#    define env_hashrebuild(group)        ((void)0)
+#    define env_hashadd(group, index)     ((void)0)
+#    define env_hashremove(group, index)  ((void)0)
+#    define env_hashmove(group, from, to) ((void)0)
+#    define env_hashrelease(group)        ((void)0)
+#  endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -126,6 +134,24 @@ void env_release(FAR struct task_group_s *group);
 
 ssize_t env_findvar(FAR struct task_group_s *group, FAR const char *pname);
 
+/****************************************************************************
+ * Name: env_freevar
+ *
+ * Description:
+ *   Free a name=value string of the environment, unless it is one of the
+ *   strings inherited in a single allocation by env_dup().
+ *
+ * Input Parameters:
+ *   group - The task group with the environment containing the string
+ *   var   - The name=value string
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void env_freevar(FAR struct task_group_s *group, FAR char *var);
+
 /****************************************************************************
  * Name: env_removevar
  *
@@ -149,6 +175,76 @@ ssize_t env_findvar(FAR struct task_group_s *group, FAR const char *pname);
 
 void env_removevar(FAR struct task_group_s *group, ssize_t index);
 
+#ifdef CONFIG_ENVIRON_HASH
+
+/****************************************************************************
+ * Name: env_hashfind
+ *
+ * Description:
+ *   Look up a variable in the hash index of the group environment.
+ *
+ * Returned Value:
+ *   The index of the name=value string in tg_envp, -ENOENT if there is no
+ *   such variable, or -ENOSYS if the group has no hash index (the caller
+ *   must then search tg_envp).
+ *
+ ****************************************************************************/
+
+ssize_t env_hashfind(FAR struct task_group_s *group, FAR const char *pname);
+
+/****************************************************************************
+ * Name: env_hashrebuild
+ *
+ * Description:
+ *   (Re)build the hash index from the tg_envc strings in tg_envp.  On an
+ *   allocation failure the group is left without an index.
+ *
+ ****************************************************************************/
+
+void env_hashrebuild(FAR struct task_group_s *group);
+
+/****************************************************************************
+ * Name: env_hashadd
+ *
+ * Description:
+ *   Index tg_envp[index], which must already be counted in tg_envc.
+ *
+ ****************************************************************************/
+
+void env_hashadd(FAR struct task_group_s *group, ssize_t index);
+
+/****************************************************************************
+ * Name: env_hashremove
+ *
+ * Description:
+ *   Drop tg_envp[index] from the index.  The string must still be valid.
+ *
+ ****************************************************************************/
+
+void env_hashremove(FAR struct task_group_s *group, ssize_t index);
+
+/****************************************************************************
+ * Name: env_hashmove
+ *
+ * Description:
+ *   Record that the string at tg_envp[from] is moving to tg_envp[to].
+ *
+ ****************************************************************************/
+
+void env_hashmove(FAR struct task_group_s *group, ssize_t from, ssize_t to);
+
+/****************************************************************************
+ * Name: env_hashrelease
+ *
+ * Description:
+ *   Free the hash index of the group.
+ *
+ ****************************************************************************/
+
+void env_hashrelease(FAR struct task_group_s *group);
+
+#endif /* CONFIG_ENVIRON_HASH */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -34,6 +34,25 @@
 
 #ifdef CONFIG_HRTIMER
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* With CONFIG_HRTIMER_PERCPU every CPU owns a timer tree, a spinlock and a
+ * programmed deadline; hrtimer->cpu identifies the tree holding a timer.
+ * Otherwise there is a single global tree.
+ */
+
+#ifdef CONFIG_HRTIMER_PERCPU
+#  define hrtimer_tree(cpu)     (&g_hrtimer_tree[cpu])
+#  define hrtimer_lock(cpu)     (&g_hrtimer_spinlock[cpu])
+#  define hrtimer_cpu(hrtimer)  ((hrtimer)->cpu)
+#else
+#  define hrtimer_tree(cpu)     (&g_hrtimer_tree)
+#  define hrtimer_lock(cpu)     (&g_hrtimer_spinlock)
+#  define hrtimer_cpu(hrtimer)  0
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -50,6 +69,15 @@ RB_HEAD(hrtimer_tree_s, hrtimer_node_s);
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_HRTIMER_PERCPU
+/* Per-CPU spinlocks protecting the per-CPU hrtimer RB-trees */
+
+extern spinlock_t g_hrtimer_spinlock[CONFIG_SMP_NCPUS];
+
+/* Per-CPU Red-Black trees of the active timers expiring on each CPU */
+
+extern struct hrtimer_tree_s g_hrtimer_tree[CONFIG_SMP_NCPUS];
+#else
 /* Spinlock protecting access to the hrtimer RB-tree and timer state */
 
 extern spinlock_t g_hrtimer_spinlock;
@@ -57,6 +85,7 @@ extern spinlock_t g_hrtimer_spinlock;
 /* Red-Black tree containing all active high-resolution timers */
 
 extern struct hrtimer_tree_s g_hrtimer_tree;
+#endif
 
 /* Array of pointers to currently running high-resolution timers
  * for each CPU in SMP configurations. Index corresponds to CPU ID.
@@ -87,6 +116,87 @@ extern FAR hrtimer_t *g_hrtimer_running[CONFIG_SMP_NCPUS];
 
 void hrtimer_process(uint64_t now);
 
+/****************************************************************************
+ * Name: hrtimer_lock_timer
+ *
+ * Description:
+ *   Acquire the lock of the tree that currently owns the timer and, if
+ *   different, the lock of the "target" CPU tree as well.  Locks are
+ *   always taken in CPU order.  The owner of a timer may change until its
+ *   lock is held, so the operation is retried if the timer was migrated in
+ *   the meantime.
+ *
+ * Input Parameters:
+ *   hrtimer - The timer
+ *   target  - A second CPU whose tree must be locked, or -1
+ *
+ * Returned Value:
+ *   The CPU that owns the timer.
+ *
+ * Assumptions:
+ *   Local interrupts are disabled.
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER_PERCPU
+int hrtimer_lock_timer(FAR hrtimer_t *hrtimer, int target);
+
+/****************************************************************************
+ * Name: hrtimer_unlock_timer
+ *
+ * Description:
+ *   Release the locks taken by hrtimer_lock_timer().
+ *
+ * Input Parameters:
+ *   cpu    - The value returned by hrtimer_lock_timer()
+ *   target - The "target" passed to hrtimer_lock_timer()
+ *
+ * Returned Value:
+ *   None
+ ****************************************************************************/
+
+void hrtimer_unlock_timer(int cpu, int target);
+
+/****************************************************************************
+ * Name: hrtimer_move
+ *
+ * Description:
+ *   Move a timer to the tree of "target", keeping it armed if it is.
+ *
+ * Input Parameters:
+ *   hrtimer - The timer
+ *   target  - The destination CPU
+ *
+ * Returned Value:
+ *   true if the timer is armed and is now the first timer of "target",
+ *   i.e. the hardware timer of "target" must be reprogrammed.
+ *
+ * Assumptions:
+ *   The locks of both the current owner and "target" are held.
+ ****************************************************************************/
+
+bool hrtimer_move(FAR hrtimer_t *hrtimer, int target);
+
+/****************************************************************************
+ * Name: hrtimer_reprogram
+ *
+ * Description:
+ *   Program the hardware timer of "cpu" for the earliest timer in its
+ *   tree; if "cpu" is not the calling CPU, ask it to do so by means of an
+ *   asynchronous SMP call.
+ *
+ * Input Parameters:
+ *   cpu - The CPU whose tree changed
+ *
+ * Returned Value:
+ *   OK (0) on success, negated errno on failure.
+ *
+ * Assumptions:
+ *   The caller does not hold any hrtimer lock.
+ ****************************************************************************/
+
+int hrtimer_reprogram(int cpu);
+#endif
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
@@ -201,7 +311,7 @@ static inline_function bool hrtimer_is_armed(FAR hrtimer_t *hrtimer)
   /* RB-tree root has NULL parent, so root must be checked explicitly */
 
   return RB_PARENT(&hrtimer->node, entry) != NULL ||
-         RB_ROOT(&g_hrtimer_tree) == &hrtimer->node;
+         RB_ROOT(hrtimer_tree(hrtimer_cpu(hrtimer))) == &hrtimer->node;
 }
 
 /****************************************************************************
@@ -213,7 +323,8 @@ static inline_function bool hrtimer_is_armed(FAR hrtimer_t *hrtimer)
 
 static inline_function void hrtimer_remove(FAR hrtimer_t *hrtimer)
 {
-  RB_REMOVE(hrtimer_tree_s, &g_hrtimer_tree, &hrtimer->node);
+  RB_REMOVE(hrtimer_tree_s, hrtimer_tree(hrtimer_cpu(hrtimer)),
+            &hrtimer->node);
 
   /* Explicitly clear parent to mark the timer as unarmed */
 
@@ -225,26 +336,32 @@ static inline_function void hrtimer_remove(FAR hrtimer_t *hrtimer)
  *
  * Description:
  *   Insert a timer into the RB-tree according to its expiration time.
+ *   With CONFIG_HRTIMER_PERCPU, the tree of hrtimer->cpu is used.
  ****************************************************************************/
 
 static inline_function void hrtimer_insert(FAR hrtimer_t *hrtimer)
 {
-  RB_INSERT(hrtimer_tree_s, &g_hrtimer_tree, &hrtimer->node);
+  RB_INSERT(hrtimer_tree_s, hrtimer_tree(hrtimer_cpu(hrtimer)),
+            &hrtimer->node);
 }
 
 /****************************************************************************
  * Name: hrtimer_get_first
  *
  * Description:
- *   Return the earliest expiring armed timer.
+ *   Return the earliest expiring armed timer of a CPU's tree (there is
+ *   only one tree without CONFIG_HRTIMER_PERCPU).
+ *
+ * Input Parameters:
+ *   cpu - The CPU whose tree is searched
  *
  * Returned Value:
  *   Pointer to the earliest timer, or NULL if none are armed.
  ****************************************************************************/
 
-static inline_function FAR hrtimer_t *hrtimer_get_first(void)
+static inline_function FAR hrtimer_t *hrtimer_get_first(int cpu)
 {
-  return (FAR hrtimer_t *)RB_MIN(hrtimer_tree_s, &g_hrtimer_tree);
+  return (FAR hrtimer_t *)RB_MIN(hrtimer_tree_s, hrtimer_tree(cpu));
 }
 
 /****************************************************************************
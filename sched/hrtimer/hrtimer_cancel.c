@@ -120,9 +120,40 @@ int hrtimer_cancel(FAR hrtimer_t *hrtimer)
   FAR hrtimer_t *first;
   irqstate_t flags;
   int ret = OK;
+#ifdef CONFIG_HRTIMER_PERCPU
+  int cpu;
+#endif
 
   DEBUGASSERT(hrtimer != NULL);
 
+#ifdef CONFIG_HRTIMER_PERCPU
+  /* Lock the tree of the CPU owning the timer.  If the timer was the
+   * earliest one there, the local hardware timer is reprogrammed; a
+   * remote CPU just takes one spurious timer interrupt.
+   */
+
+  flags = up_irq_save();
+  cpu = hrtimer_lock_timer(hrtimer, -1);
+
+  if (hrtimer_is_armed(hrtimer))
+    {
+      bool was_first = hrtimer_get_first(cpu) == hrtimer;
+
+      hrtimer_remove(hrtimer);
+
+      first = hrtimer_get_first(cpu);
+      if (was_first && first != NULL && cpu == this_cpu())
+        {
+          ret = hrtimer_starttimer(first->expired);
+        }
+    }
+
+  hrtimer->expired++;
+
+  hrtimer_unlock_timer(cpu, -1);
+  up_irq_restore(flags);
+  return ret;
+#else
   /* Enter critical section to protect the hrtimer tree and state */
 
   flags = spin_lock_irqsave(&g_hrtimer_spinlock);
@@ -142,7 +173,7 @@ int hrtimer_cancel(FAR hrtimer_t *hrtimer)
 
   if (hrtimer_is_first(hrtimer))
     {
-      first = hrtimer_get_first();
+      first = hrtimer_get_first(0);
       if (first != NULL)
         {
           ret = hrtimer_starttimer(first->expired);
@@ -153,6 +184,7 @@ int hrtimer_cancel(FAR hrtimer_t *hrtimer)
 
   spin_unlock_irqrestore(&g_hrtimer_spinlock, flags);
   return ret;
+#endif
 }
 
 /****************************************************************************
@@ -47,17 +47,27 @@ FAR hrtimer_t *g_hrtimer_running[CONFIG_SMP_NCPUS];
  * timer tree or hrtimer state is modified.
  */
 
+#ifdef CONFIG_HRTIMER_PERCPU
+spinlock_t g_hrtimer_spinlock[CONFIG_SMP_NCPUS];
+#else
 spinlock_t g_hrtimer_spinlock = SP_UNLOCKED;
+#endif
 
 /* Red-black tree containing all active high-resolution timers.
  *
  * Only timers in the ARMED state are present in this tree. Timers in
  * the RUNNING, CANCELED, or INACTIVE states must not be inserted.
  *
- * The tree is ordered by absolute expiration time.
+ * The tree is ordered by absolute expiration time.  With
+ * CONFIG_HRTIMER_PERCPU there is one tree (and one spinlock) per CPU;
+ * zero initialization leaves them empty and unlocked.
  */
 
+#ifdef CONFIG_HRTIMER_PERCPU
+struct hrtimer_tree_s g_hrtimer_tree[CONFIG_SMP_NCPUS];
+#else
 struct hrtimer_tree_s g_hrtimer_tree = RB_INITIALIZER(g_hrtimer_tree);
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -0,0 +1,310 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_migrate.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include "hrtimer/hrtimer.h"
+
+#ifdef CONFIG_HRTIMER_PERCPU
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* SMP call used to make a CPU reprogram its own hardware timer after a
+ * timer was queued at the head of its tree by another CPU.  A request is
+ * pending while g_hrtimer_ipi_pending[cpu] is set, which is protected by
+ * the lock of that CPU's tree.
+ */
+
+static struct smp_call_data_s g_hrtimer_ipi[CONFIG_SMP_NCPUS];
+static bool g_hrtimer_ipi_pending[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_reprogram_handler
+ *
+ * Description:
+ *   SMP call handler that programs the local hardware timer for the
+ *   earliest timer in the local tree.
+ *
+ ****************************************************************************/
+
+static int hrtimer_reprogram_handler(FAR void *arg)
+{
+  FAR hrtimer_t *first;
+  irqstate_t flags;
+  int cpu = this_cpu();
+  int ret = OK;
+
+  UNUSED(arg);
+
+  flags = spin_lock_irqsave(hrtimer_lock(cpu));
+
+  g_hrtimer_ipi_pending[cpu] = false;
+
+  first = hrtimer_get_first(cpu);
+  if (first != NULL)
+    {
+      ret = hrtimer_starttimer(first->expired);
+    }
+
+  spin_unlock_irqrestore(hrtimer_lock(cpu), flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_lock_timer
+ ****************************************************************************/
+
+int hrtimer_lock_timer(FAR hrtimer_t *hrtimer, int target)
+{
+  int first;
+  int second;
+  int cpu;
+
+  for (; ; )
+    {
+      cpu = *(FAR volatile uint8_t *)&hrtimer->cpu;
+
+      if (target < 0 || target == cpu)
+        {
+          spin_lock(hrtimer_lock(cpu));
+        }
+      else
+        {
+          /* Always lock the lower numbered CPU first */
+
+          first  = cpu < target ? cpu : target;
+          second = cpu < target ? target : cpu;
+
+          spin_lock(hrtimer_lock(first));
+          spin_lock(hrtimer_lock(second));
+        }
+
+      if (hrtimer->cpu == cpu)
+        {
+          return cpu;
+        }
+
+      /* The timer was migrated before its lock could be taken */
+
+      hrtimer_unlock_timer(cpu, target);
+    }
+}
+
+/****************************************************************************
+ * Name: hrtimer_unlock_timer
+ ****************************************************************************/
+
+void hrtimer_unlock_timer(int cpu, int target)
+{
+  if (target >= 0 && target != cpu)
+    {
+      spin_unlock(hrtimer_lock(target));
+    }
+
+  spin_unlock(hrtimer_lock(cpu));
+}
+
+/****************************************************************************
+ * Name: hrtimer_move
+ ****************************************************************************/
+
+bool hrtimer_move(FAR hrtimer_t *hrtimer, int target)
+{
+  if (hrtimer->cpu == target)
+    {
+      return false;
+    }
+
+  if (!hrtimer_is_armed(hrtimer))
+    {
+      hrtimer->cpu = target;
+      return false;
+    }
+
+  /* The hardware timer of the old owner is left as it is: at worst it
+   * fires once more and finds nothing to do.
+   */
+
+  hrtimer_remove(hrtimer);
+  hrtimer->cpu = target;
+  hrtimer_insert(hrtimer);
+
+  return hrtimer_get_first(target) == hrtimer;
+}
+
+/****************************************************************************
+ * Name: hrtimer_reprogram
+ ****************************************************************************/
+
+int hrtimer_reprogram(int cpu)
+{
+  FAR hrtimer_t *first;
+  irqstate_t flags;
+  bool ipi = false;
+  int ret = OK;
+
+  flags = spin_lock_irqsave(hrtimer_lock(cpu));
+
+  if (cpu == this_cpu())
+    {
+      first = hrtimer_get_first(cpu);
+      if (first != NULL)
+        {
+          ret = hrtimer_starttimer(first->expired);
+        }
+    }
+  else if (!g_hrtimer_ipi_pending[cpu])
+    {
+      g_hrtimer_ipi_pending[cpu] = true;
+      nxsched_smp_call_init(&g_hrtimer_ipi[cpu],
+                            hrtimer_reprogram_handler, NULL);
+      ipi = true;
+    }
+
+  spin_unlock_irqrestore(hrtimer_lock(cpu), flags);
+
+  if (ipi)
+    {
+      ret = nxsched_smp_call_single_async(cpu, &g_hrtimer_ipi[cpu]);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: hrtimer_migrate
+ *
+ * Description:
+ *   Move a timer to the timer tree of another CPU, preserving its
+ *   expiration time.
+ *
+ * Input Parameters:
+ *   hrtimer - Timer instance to migrate
+ *   cpu     - Destination CPU
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_migrate(FAR hrtimer_t *hrtimer, int cpu)
+{
+  irqstate_t flags;
+  bool reprogram;
+  int owner;
+
+  DEBUGASSERT(hrtimer != NULL);
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  flags = up_irq_save();
+  owner = hrtimer_lock_timer(hrtimer, cpu);
+
+  if (hrtimer->pinned && owner != cpu)
+    {
+      hrtimer_unlock_timer(owner, cpu);
+      up_irq_restore(flags);
+      return -EPERM;
+    }
+
+  reprogram = hrtimer_move(hrtimer, cpu);
+
+  hrtimer_unlock_timer(owner, cpu);
+  up_irq_restore(flags);
+
+  return reprogram ? hrtimer_reprogram(cpu) : OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_pin
+ *
+ * Description:
+ *   Pin a timer to a CPU, or unpin it if "cpu" is negative.
+ *
+ * Input Parameters:
+ *   hrtimer - Timer instance to pin
+ *   cpu     - CPU to pin to, or a negative value to unpin
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int hrtimer_pin(FAR hrtimer_t *hrtimer, int cpu)
+{
+  irqstate_t flags;
+  bool reprogram;
+  int owner;
+
+  DEBUGASSERT(hrtimer != NULL);
+
+  if (cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  flags = up_irq_save();
+
+  if (cpu < 0)
+    {
+      owner = hrtimer_lock_timer(hrtimer, -1);
+      hrtimer->pinned = false;
+      hrtimer_unlock_timer(owner, -1);
+      up_irq_restore(flags);
+      return OK;
+    }
+
+  owner = hrtimer_lock_timer(hrtimer, cpu);
+
+  hrtimer->pinned = true;
+  reprogram = hrtimer_move(hrtimer, cpu);
+
+  hrtimer_unlock_timer(owner, cpu);
+  up_irq_restore(flags);
+
+  return reprogram ? hrtimer_reprogram(cpu) : OK;
+}
+
+#endif /* CONFIG_HRTIMER_PERCPU */
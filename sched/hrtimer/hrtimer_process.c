@@ -31,6 +31,60 @@
 
 #include "hrtimer/hrtimer.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_rearm_remote
+ *
+ * Description:
+ *   Re-arm a periodic timer that was migrated to another CPU while its
+ *   callback was running on "cpu".  It is queued on the tree of its new
+ *   owner, unless it was restarted or canceled in the meantime.
+ *
+ * Input Parameters:
+ *   hrtimer - The timer whose callback just returned
+ *   cpu     - The calling CPU, whose tree lock is held
+ *   expired - The expiration time the callback was invoked for
+ *   period  - The period returned by the callback
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER_PERCPU
+static void hrtimer_rearm_remote(FAR hrtimer_t *hrtimer, int cpu,
+                                 uint64_t expired, uint64_t period)
+{
+  bool reprogram = false;
+  int owner;
+
+  spin_unlock(hrtimer_lock(cpu));
+
+  owner = hrtimer_lock_timer(hrtimer, -1);
+  if (!hrtimer_is_armed(hrtimer) && hrtimer->expired == expired)
+    {
+      hrtimer->expired += period;
+
+      DEBUGASSERT(hrtimer->expired > period);
+
+      hrtimer_insert(hrtimer);
+      reprogram = hrtimer_get_first(owner) == hrtimer;
+    }
+
+  hrtimer_unlock_timer(owner, -1);
+
+  if (reprogram)
+    {
+      hrtimer_reprogram(owner);
+    }
+
+  spin_lock(hrtimer_lock(cpu));
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -74,17 +128,17 @@ void hrtimer_process(uint64_t now)
   hrtimer_entry_t func;
   uint64_t expired;
   uint64_t period;
-#ifdef CONFIG_SMP
   int cpu = this_cpu();
-#endif
 
-  /* Lock the hrtimer RB-tree to protect access */
+  /* Lock the hrtimer RB-tree to protect access.  With
+   * CONFIG_HRTIMER_PERCPU only the tree of the calling CPU is processed.
+   */
 
-  flags = spin_lock_irqsave(&g_hrtimer_spinlock);
+  flags = spin_lock_irqsave(hrtimer_lock(cpu));
 
   /* Fetch the earliest active timer */
 
-  hrtimer = hrtimer_get_first();
+  hrtimer = hrtimer_get_first(cpu);
 
   while (hrtimer != NULL)
     {
@@ -112,7 +166,7 @@ void hrtimer_process(uint64_t now)
 #endif
       /* Leave critical section before invoking the callback */
 
-      spin_unlock_irqrestore(&g_hrtimer_spinlock, flags);
+      spin_unlock_irqrestore(hrtimer_lock(cpu), flags);
 
       /* Invoke the timer callback */
 
@@ -120,7 +174,7 @@ void hrtimer_process(uint64_t now)
 
       /* Re-enter critical section to update timer state */
 
-      flags = spin_lock_irqsave(&g_hrtimer_spinlock);
+      flags = spin_lock_irqsave(hrtimer_lock(cpu));
 
 #ifdef CONFIG_SMP
       g_hrtimer_running[cpu] = NULL;
@@ -133,18 +187,27 @@ void hrtimer_process(uint64_t now)
 
       if (period > 0 && hrtimer->expired == expired)
         {
-          hrtimer->expired += period;
+#ifdef CONFIG_HRTIMER_PERCPU
+          if (hrtimer->cpu != cpu)
+            {
+              hrtimer_rearm_remote(hrtimer, cpu, expired, period);
+            }
+          else
+#endif
+            {
+              hrtimer->expired += period;
 
-          /* Ensure no overflow occurs */
+              /* Ensure no overflow occurs */
 
-          DEBUGASSERT(hrtimer->expired > period);
+              DEBUGASSERT(hrtimer->expired > period);
 
-          hrtimer_insert(hrtimer);
+              hrtimer_insert(hrtimer);
+            }
         }
 
       /* Fetch the next earliest timer */
 
-      hrtimer = hrtimer_get_first();
+      hrtimer = hrtimer_get_first(cpu);
     }
 
   /* Schedule the next timer expiration */
@@ -158,5 +221,5 @@ void hrtimer_process(uint64_t now)
 
   /* Leave critical section */
 
-  spin_unlock_irqrestore(&g_hrtimer_spinlock, flags);
+  spin_unlock_irqrestore(hrtimer_lock(cpu), flags);
 }
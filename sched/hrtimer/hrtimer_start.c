@@ -65,12 +65,38 @@ int hrtimer_start(FAR hrtimer_t *hrtimer,
 {
   irqstate_t flags;
   int ret = OK;
+#ifdef CONFIG_HRTIMER_PERCPU
+  bool reprogram;
+  int target;
+  int cpu;
+#endif
 
   DEBUGASSERT(hrtimer != NULL);
 
   /* Protect RB-tree manipulation with spinlock and disable interrupts */
 
+#ifdef CONFIG_HRTIMER_PERCPU
+  /* Lock both the tree now holding the timer and the tree of the CPU it
+   * will expire on: the pinned CPU, or else the calling CPU.
+   */
+
+  flags = up_irq_save();
+
+  for (; ; )
+    {
+      target = hrtimer->pinned ? hrtimer->cpu : this_cpu();
+      cpu    = hrtimer_lock_timer(hrtimer, target);
+
+      if (!hrtimer->pinned || cpu == target)
+        {
+          break;
+        }
+
+      hrtimer_unlock_timer(cpu, target);
+    }
+#else
   flags = spin_lock_irqsave(&g_hrtimer_spinlock);
+#endif
 
   if (hrtimer_is_armed(hrtimer))
     {
@@ -92,6 +118,37 @@ int hrtimer_start(FAR hrtimer_t *hrtimer,
 
   DEBUGASSERT(hrtimer->expired >= expired);
 
+#ifdef CONFIG_HRTIMER_PERCPU
+  /* Insert the timer into the tree of the target CPU.  If it is now the
+   * earliest one there, program the local hardware timer directly or, for
+   * a remote pinned timer, ask its CPU to do so once the locks are
+   * released.
+   */
+
+  hrtimer->cpu = target;
+  hrtimer_insert(hrtimer);
+
+  reprogram = false;
+  if (hrtimer_get_first(target) == hrtimer)
+    {
+      if (target == this_cpu())
+        {
+          ret = hrtimer_starttimer(hrtimer->expired);
+        }
+      else
+        {
+          reprogram = true;
+        }
+    }
+
+  hrtimer_unlock_timer(cpu, target);
+  up_irq_restore(flags);
+
+  if (reprogram)
+    {
+      ret = hrtimer_reprogram(target);
+    }
+#else
   /* Insert the timer into the RB-tree */
 
   hrtimer_insert(hrtimer);
@@ -106,6 +163,7 @@ int hrtimer_start(FAR hrtimer_t *hrtimer,
   /* Release spinlock and restore interrupts */
 
   spin_unlock_irqrestore(&g_hrtimer_spinlock, flags);
+#endif
 
   return ret;
 }
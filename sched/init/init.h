@@ -51,6 +51,25 @@
 
 void nx_start(void);
 
+/****************************************************************************
+ * Name: nx_initcall_run
+ *
+ * Description:
+ *   Run the initcalls registered with initcall_register(), in parallel
+ *   where their dependencies allow, and wait for all of them to finish.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The number of initcalls that failed or could not be run.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_INITCALL
+int nx_initcall_run(void);
+#endif
+
 /****************************************************************************
  * Name: nx_smp_start
  *
@@ -0,0 +1,163 @@
+/****************************************************************************
+ * sched/init/nx_bootprofile.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <syslog.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bootprofile_mark_s
+{
+  FAR const char *name;  /* Name of the phase that just completed */
+  clock_t time;          /* perf_gettime() when the mark was taken */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct bootprofile_mark_s
+g_bootprofile[CONFIG_SCHED_BOOT_PROFILE_NMARKS];
+static unsigned int g_bootprofile_count;
+static spinlock_t g_bootprofile_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bootprofile_usec
+ *
+ * Description:
+ *   Convert an interval of performance counter ticks to microseconds.
+ *
+ ****************************************************************************/
+
+static uint32_t bootprofile_usec(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (uint32_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_bootprofile_mark
+ *
+ * Description:
+ *   Record the current time under the given name.  The name must remain
+ *   valid until the profile is reported; normally it is a string literal.
+ *   This may be called from any context, including the initcall workers
+ *   running concurrently on several CPUs.
+ *
+ * Input Parameters:
+ *   name - Name of the boot phase that has just completed.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nx_bootprofile_mark(FAR const char *name)
+{
+  clock_t now = perf_gettime();
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_bootprofile_lock);
+  if (g_bootprofile_count < CONFIG_SCHED_BOOT_PROFILE_NMARKS)
+    {
+      g_bootprofile[g_bootprofile_count].name = name;
+      g_bootprofile[g_bootprofile_count].time = now;
+    }
+
+  g_bootprofile_count++;
+  spin_unlock_irqrestore(&g_bootprofile_lock, flags);
+}
+
+/****************************************************************************
+ * Name: nx_bootprofile_report
+ *
+ * Description:
+ *   Print the recorded marks to the syslog.  For each mark the time since
+ *   the first mark and the time since the previous mark are shown, so the
+ *   second column is the cost of the named phase.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nx_bootprofile_report(void)
+{
+  unsigned int count;
+  unsigned int i;
+  clock_t base;
+  clock_t prev;
+
+  count = g_bootprofile_count;
+  if (count > CONFIG_SCHED_BOOT_PROFILE_NMARKS)
+    {
+      syslog(LOG_WARNING, "Boot profile: %u marks dropped\n",
+             count - CONFIG_SCHED_BOOT_PROFILE_NMARKS);
+      count = CONFIG_SCHED_BOOT_PROFILE_NMARKS;
+    }
+
+  if (count == 0)
+    {
+      return;
+    }
+
+  base = g_bootprofile[0].time;
+  prev = base;
+
+  syslog(LOG_INFO, "Boot profile (usec):    total    phase\n");
+  for (i = 0; i < count; i++)
+    {
+      clock_t time = g_bootprofile[i].time;
+
+      syslog(LOG_INFO, "  %-20s %8" PRIu32 " %8" PRIu32 "\n",
+             g_bootprofile[i].name,
+             bootprofile_usec(time - base), bootprofile_usec(time - prev));
+      prev = time;
+    }
+}
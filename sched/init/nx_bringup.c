@@ -36,6 +36,7 @@
 #include <nuttx/board.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/init.h>
+#include <nuttx/initcall.h>
 #include <nuttx/macro.h>
 #include <nuttx/symtab.h>
 #include <nuttx/trace.h>
@@ -48,6 +49,7 @@
 #  include "paging/paging.h"
 #endif
 
+#include "irq/irq.h"
 #include "sched/sched.h"
 #include "wqueue/wqueue.h"
 #include "init/init.h"
@@ -311,6 +313,7 @@ static inline void nx_start_application(void)
 
 #ifdef CONFIG_ETC_ROMFS
   nx_romfsetc();
+  BOOT_PROFILE_MARK("romfsetc");
 #endif
 
 #ifdef CONFIG_BOARD_LATE_INITIALIZE
@@ -319,6 +322,21 @@ static inline void nx_start_application(void)
    */
 
   board_late_initialize();
+  BOOT_PROFILE_MARK("board_late");
+#endif
+
+#ifdef CONFIG_SCHED_INITCALL
+  /* Run the initcalls registered by the board and the drivers, in parallel
+   * where their dependencies allow.
+   */
+
+  ret = nx_initcall_run();
+  if (ret > 0)
+    {
+      serr("ERROR: %d initcalls failed\n", ret);
+    }
+
+  BOOT_PROFILE_MARK("initcalls");
 #endif
 
 #ifdef CONFIG_COREDUMP
@@ -386,6 +404,11 @@ static inline void nx_start_application(void)
   posix_spawnattr_destroy(&attr);
   DEBUGASSERT(ret > 0);
 #endif /* CONFIG_INIT_NONE */
+
+#ifdef CONFIG_SCHED_BOOT_PROFILE
+  BOOT_PROFILE_MARK("init");
+  nx_bootprofile_report();
+#endif
 }
 
 /****************************************************************************
@@ -528,6 +551,13 @@ int nx_bringup(void)
    */
 
   nx_workqueues();
+  BOOT_PROFILE_MARK("workqueues");
+
+#ifdef CONFIG_IRQ_BALANCE
+  /* Start the thread that spreads the interrupts over the CPUs */
+
+  irq_balance_start();
+#endif
 
   /* Once the operating system has been initialized, the system must be
    * started by spawning the user initialization thread of execution.  This
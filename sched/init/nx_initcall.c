@@ -0,0 +1,337 @@
+/****************************************************************************
+ * sched/init/nx_initcall.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/initcall.h>
+#include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+
+#include "init/init.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Initcalls may block for a long time, so prefer the low priority queue */
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define INITCALL_WORK LPWORK
+#else
+#  define INITCALL_WORK HPWORK
+#endif
+
+/* Values of initcall_s::state */
+
+#define INITCALL_IDLE    0  /* Not registered */
+#define INITCALL_PENDING 1  /* Registered, waiting for dependencies */
+#define INITCALL_RUNNING 2  /* Queued or running on the work queue */
+#define INITCALL_DONE    3  /* Completed successfully */
+#define INITCALL_FAILED  4  /* Failed, or not run because a dependency
+                             * failed */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct initcall_s *g_initcall_head;
+static FAR struct initcall_s *g_initcall_tail;
+static bool g_initcall_started;
+
+/* Posted each time an initcall completes */
+
+static sem_t g_initcall_sem = SEM_INITIALIZER(0);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: initcall_worker
+ *
+ * Description:
+ *   Run one initcall on the work queue and report its completion.
+ *
+ ****************************************************************************/
+
+static void initcall_worker(FAR void *arg)
+{
+  FAR struct initcall_s *call = arg;
+  struct timespec ts;
+  clock_t start;
+  int ret;
+
+  start = perf_gettime();
+  ret = call->func(call->arg);
+  perf_convert(perf_gettime() - start, &ts);
+
+  if (ret < 0)
+    {
+      serr("ERROR: initcall %s failed: %d\n", call->name, ret);
+    }
+
+  sinfo("initcall %s: %d, %lu.%06lu s\n", call->name, ret,
+        (unsigned long)ts.tv_sec, (unsigned long)ts.tv_nsec / NSEC_PER_USEC);
+
+  BOOT_PROFILE_MARK(call->name);
+
+  /* Publish the outcome and let nx_initcall_run() rescan the list */
+
+  call->result = ret;
+  call->state  = ret < 0 ? INITCALL_FAILED : INITCALL_DONE;
+  nxsem_post(&g_initcall_sem);
+}
+
+/****************************************************************************
+ * Name: initcall_ready
+ *
+ * Description:
+ *   Check the dependencies of an initcall.
+ *
+ * Returned Value:
+ *   1 if all dependencies have completed successfully, 0 if some are still
+ *   pending or running, or a negated errno value if the initcall can never
+ *   run:  -ENODEV if a dependency failed or -ENOENT if a dependency was
+ *   never registered.
+ *
+ ****************************************************************************/
+
+static int initcall_ready(FAR struct initcall_s *call)
+{
+  FAR struct initcall_s * const *dep;
+  int ready = 1;
+
+  if (call->deps == NULL)
+    {
+      return 1;
+    }
+
+  for (dep = call->deps; *dep != NULL; dep++)
+    {
+      switch ((*dep)->state)
+        {
+          case INITCALL_DONE:
+            break;
+
+          case INITCALL_FAILED:
+            return -ENODEV;
+
+          case INITCALL_IDLE:
+            return -ENOENT;
+
+          default:
+            ready = 0;
+            break;
+        }
+    }
+
+  return ready;
+}
+
+/****************************************************************************
+ * Name: initcall_dispatch
+ *
+ * Description:
+ *   Queue every pending initcall whose dependencies are satisfied and fail
+ *   those whose dependencies can no longer be satisfied.
+ *
+ * Returned Value:
+ *   The number of initcalls that are queued or running.
+ *
+ ****************************************************************************/
+
+static int initcall_dispatch(void)
+{
+  FAR struct initcall_s *call;
+  bool progress;
+  int running;
+  int ret;
+
+  /* Failing one initcall may make its dependents fail as well, so repeat
+   * until nothing changes.
+   */
+
+  do
+    {
+      progress = false;
+      for (call = g_initcall_head; call != NULL; call = call->flink)
+        {
+          if (call->state != INITCALL_PENDING)
+            {
+              continue;
+            }
+
+          ret = initcall_ready(call);
+          if (ret < 0)
+            {
+              serr("ERROR: initcall %s skipped: %d\n", call->name, ret);
+              call->result = ret;
+              call->state  = INITCALL_FAILED;
+              progress     = true;
+            }
+          else if (ret > 0)
+            {
+              call->state = INITCALL_RUNNING;
+              ret = work_queue(INITCALL_WORK, &call->work,
+                               initcall_worker, call, 0);
+              if (ret < 0)
+                {
+                  /* Run it here rather than not at all */
+
+                  initcall_worker(call);
+                  progress = true;
+                }
+            }
+        }
+    }
+  while (progress);
+
+  running = 0;
+  for (call = g_initcall_head; call != NULL; call = call->flink)
+    {
+      if (call->state == INITCALL_RUNNING)
+        {
+          running++;
+        }
+    }
+
+  return running;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: initcall_register
+ *
+ * Description:
+ *   Register an initialization call to be run, concurrently with other
+ *   independent initcalls, just after board_late_initialize().
+ *
+ * Input Parameters:
+ *   call - The initcall to register.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EBUSY if the call is already registered or the
+ *   initcalls have already been run.
+ *
+ ****************************************************************************/
+
+int initcall_register(FAR struct initcall_s *call)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  DEBUGASSERT(call != NULL && call->func != NULL);
+
+  flags = enter_critical_section();
+  if (g_initcall_started || call->state != INITCALL_IDLE)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      call->flink  = NULL;
+      call->result = 0;
+      call->state  = INITCALL_PENDING;
+
+      if (g_initcall_tail != NULL)
+        {
+          g_initcall_tail->flink = call;
+        }
+      else
+        {
+          g_initcall_head = call;
+        }
+
+      g_initcall_tail = call;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nx_initcall_run
+ *
+ * Description:
+ *   Run all registered initcalls, each as soon as the initcalls it depends
+ *   on have completed, and wait until all of them have finished.  This is
+ *   called once from the board initialization thread.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The number of initcalls that failed or could not be run.
+ *
+ ****************************************************************************/
+
+int nx_initcall_run(void)
+{
+  FAR struct initcall_s *call;
+  irqstate_t flags;
+  int nfailed = 0;
+
+  flags = enter_critical_section();
+  g_initcall_started = true;
+  leave_critical_section(flags);
+
+  /* Each completion may release more initcalls.  When nothing is running
+   * any more, whatever is still pending waits on itself.
+   */
+
+  while (initcall_dispatch() > 0)
+    {
+      nxsem_wait_uninterruptible(&g_initcall_sem);
+    }
+
+  for (call = g_initcall_head; call != NULL; call = call->flink)
+    {
+      if (call->state == INITCALL_PENDING)
+        {
+          serr("ERROR: initcall %s has circular dependencies\n",
+               call->name);
+          call->result = -EDEADLK;
+          call->state  = INITCALL_FAILED;
+        }
+
+      if (call->state == INITCALL_FAILED)
+        {
+          nfailed++;
+        }
+    }
+
+  return nfailed;
+}
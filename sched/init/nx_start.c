@@ -56,6 +56,7 @@
 #include "mqueue/mqueue.h"
 #include "mqueue/msg.h"
 #include "clock/clock.h"
+#include "wdog/wdog.h"
 #include "timer/timer.h"
 #include "irq/irq.h"
 #include "group/group.h"
@@ -117,6 +118,28 @@ FAR struct tcb_s *g_assignedtasks[CONFIG_SMP_NCPUS];
 enum task_deliver_e g_delivertasks[CONFIG_SMP_NCPUS];
 #endif
 
+/* With CONFIG_SMP_PERCPU_READYTORUN each CPU has its own ready-to-run list
+ * in place of the shared g_readytorun, along with the number of tasks
+ * currently queued in that list.
+ */
+
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+dq_queue_t g_cpureadytorun[CONFIG_SMP_NCPUS];
+uint16_t g_nreadytorun[CONFIG_SMP_NCPUS];
+#endif
+
+/* With CONFIG_SCHED_PRIOBITMAP, the ready-to-run list(s) are accompanied
+ * by a per-priority index so that insertion does not walk the list.
+ */
+
+#ifdef CONFIG_SCHED_PRIOBITMAP
+#  ifdef CONFIG_SMP_PERCPU_READYTORUN
+struct prioindex_s g_cpureadytorun_index[CONFIG_SMP_NCPUS];
+#  else
+struct prioindex_s g_readytorun_index;
+#  endif
+#endif
+
 /* g_running_tasks[] holds a references to the running task for each CPU.
  * It is valid only when up_interrupt_context() returns true.
  */
@@ -236,8 +259,14 @@ static void tasklist_initialize(void)
 
   /* TSTATE_TASK_READYTORUN */
 
+#  ifdef CONFIG_SMP_PERCPU_READYTORUN
+  tlist[TSTATE_TASK_READYTORUN].list = g_cpureadytorun;
+  tlist[TSTATE_TASK_READYTORUN].attr = TLIST_ATTR_PRIORITIZED |
+                                       TLIST_ATTR_INDEXED;
+#  else
   tlist[TSTATE_TASK_READYTORUN].list = list_readytorun();
   tlist[TSTATE_TASK_READYTORUN].attr = TLIST_ATTR_PRIORITIZED;
+#  endif
 
 #else
 
@@ -405,7 +434,7 @@ static void idle_task_initialize(void)
 #ifdef CONFIG_SMP
       g_assignedtasks[i] = tcb;
 #else
-      dq_addfirst((FAR dq_entry_t *)tcb, TLIST_HEAD(tcb));
+      nxsched_add_rtrlist(tcb, 0);
 #endif
 
       /* Mark the idle task as the running task */
@@ -512,6 +541,7 @@ void nx_start(void)
   /* Boot up is complete */
 
   g_nx_initstate = OSINIT_BOOT;
+  BOOT_PROFILE_MARK("boot");
 
   /* Initialize task list table *********************************************/
 
@@ -539,6 +569,14 @@ void nx_start(void)
 
   nxsem_initialize();
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  /* Initialize the watchdog timer wheel before anything may start a
+   * watchdog.
+   */
+
+  wd_initialize();
+#endif
+
 #if defined(MM_KERNEL_USRHEAP_INIT) || defined(CONFIG_MM_KERNEL_HEAP) || \
     defined(CONFIG_MM_PGALLOC)
   /* Initialize the memory manager */
@@ -617,6 +655,7 @@ void nx_start(void)
   /* The memory manager is available */
 
   g_nx_initstate = OSINIT_MEMORY;
+  BOOT_PROFILE_MARK("memory");
 
   /* Initialize tasking data structures */
 
@@ -629,6 +668,7 @@ void nx_start(void)
   /* Initialize the file system (needed to support device drivers) */
 
   fs_initialize();
+  BOOT_PROFILE_MARK("fs");
 
   /* Initialize the interrupt handling subsystem (if included) */
 
@@ -645,6 +685,7 @@ void nx_start(void)
   /* Initialize the signal facility (if in link) */
 
   nxsig_initialize();
+  BOOT_PROFILE_MARK("clock/signals");
 
 #if !defined(CONFIG_DISABLE_MQUEUE) || !defined(CONFIG_DISABLE_MQUEUE_SYSV)
   /* Initialize the named message queue facility (if in link) */
@@ -656,6 +697,7 @@ void nx_start(void)
   /* Initialize the networking system */
 
   net_initialize();
+  BOOT_PROFILE_MARK("net");
 #endif
 
 #ifndef CONFIG_BINFMT_DISABLE
@@ -673,10 +715,12 @@ void nx_start(void)
    */
 
   up_initialize();
+  BOOT_PROFILE_MARK("up_initialize");
 
   /* Initialize common drivers */
 
   drivers_initialize();
+  BOOT_PROFILE_MARK("drivers");
 
 #ifdef CONFIG_BOARD_EARLY_INITIALIZE
   /* Call the board-specific up_initialize() extension to support
@@ -685,6 +729,7 @@ void nx_start(void)
    */
 
   board_early_initialize();
+  BOOT_PROFILE_MARK("board_early");
 #endif
 
   /* Hardware resources are now available */
@@ -736,6 +781,7 @@ void nx_start(void)
   /* The OS is fully initialized and we are beginning multi-tasking */
 
   g_nx_initstate = OSINIT_OSREADY;
+  BOOT_PROFILE_MARK("osready");
 
   /* Create initial tasks and bring-up the system */
 
@@ -34,8 +34,10 @@
 #include <stdbool.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/atomic.h>
 #include <nuttx/irq.h>
 #include <nuttx/spinlock.h>
+#include <nuttx/wdog.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -74,8 +76,30 @@ struct irq_info_s
   clock_t time;      /* Maximum execution time on this IRQ */
   uint32_t count;    /* Number of interrupts on this IRQ */
 #endif
+#ifdef CONFIG_IRQ_AFFINITY
+  cpu_set_t affinity; /* CPUs the IRQ may be routed to, 0 means any */
+#endif
+#ifdef CONFIG_IRQ_BALANCE
+  clock_t load;      /* Handler time since the last balancing pass */
+  uint8_t cpu;       /* CPU the IRQ is currently routed to */
+#endif
 };
 
+#ifdef CONFIG_IRQ_COALESCE
+/* Coalescing state of the bottom half of one IRQ */
+
+struct irq_coalesce_s
+{
+  uint32_t maxevents;  /* Run the bottom half after this many events */
+  clock_t maxdelay;    /* Or this many ticks after the first event */
+  atomic_t pending;    /* Events since the bottom half last ran */
+  struct wdog_s wdog;  /* Delayed wakeup of a threaded bottom half */
+#ifdef CONFIG_SCHED_IRQMONITOR
+  uint32_t batches;    /* Number of times the bottom half ran */
+#endif
+};
+#endif
+
 #ifdef CONFIG_SCHED_IRQMONITOR
 /* This is the type of the callback from irq_foreach(). */
 
@@ -107,6 +131,14 @@ extern struct irq_info_s g_irqvector[NR_IRQS];
  * declaration is here for the time being.
  */
 
+#ifdef CONFIG_IRQ_COALESCE
+#  ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE
+extern struct irq_coalesce_s g_irq_coalesce[CONFIG_ARCH_NUSER_INTERRUPTS];
+#  else
+extern struct irq_coalesce_s g_irq_coalesce[NR_IRQS];
+#  endif
+#endif
+
 #if defined(CONFIG_ARCH_MINIMAL_VECTORTABLE_DYNAMIC)
 extern irq_mapped_t g_irqmap[NR_IRQS];
 int irq_to_ndx(int irq);
@@ -193,6 +225,47 @@ int irq_unexpected_isr(int irq, FAR void *context, FAR void *arg);
 int irq_foreach(irq_foreach_t callback, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: irq_coalesce_event
+ *
+ * Description:
+ *   Called by the top half each time it asks for the bottom half.
+ *
+ * Returned Value:
+ *   Zero if the bottom half must be woken at once, a positive delay in
+ *   ticks if it must be woken after that delay, or a negated value if a
+ *   wakeup has already been arranged for the current batch.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_COALESCE
+int irq_coalesce_event(FAR struct irq_coalesce_s *coalesce);
+
+/****************************************************************************
+ * Name: irq_coalesce_batch
+ *
+ * Description:
+ *   Called by the bottom half before it runs.  Returns the number of events
+ *   in the batch and clears it; zero means that the batch has already been
+ *   handled by an earlier wakeup.
+ *
+ ****************************************************************************/
+
+uint32_t irq_coalesce_batch(FAR struct irq_coalesce_s *coalesce);
+#endif
+
+/****************************************************************************
+ * Name: irq_balance_start
+ *
+ * Description:
+ *   Start the IRQ balancing kernel thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_BALANCE
+int irq_balance_start(void);
+#endif
+
 #ifdef CONFIG_IRQCHAIN
 void irqchain_initialize(void);
 bool is_irqchain(int ndx, xcpt_t isr);
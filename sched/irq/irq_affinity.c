@@ -0,0 +1,138 @@
+/****************************************************************************
+ * sched/irq/irq_affinity.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <sched.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+
+#include "irq/irq.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IRQ_ALLCPUS ((cpu_set_t)((1u << CONFIG_SMP_NCPUS) - 1))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_set_affinity
+ *
+ * Description:
+ *   Set the set of CPUs that IRQ number 'irq' may be routed to.
+ *
+ * Input Parameters:
+ *   irq    - Irq num
+ *   cpuset - The set of CPUs
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_set_affinity(int irq, FAR const cpu_set_t *cpuset)
+{
+  cpu_set_t affinity;
+  irqstate_t flags;
+  int ndx;
+
+  if ((unsigned)irq >= NR_IRQS || cpuset == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ndx = IRQ_TO_NDX(irq);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  affinity = *cpuset & IRQ_ALLCPUS;
+  if (affinity == 0)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  g_irqvector[ndx].affinity = affinity;
+  up_affinity_irq(irq, affinity);
+
+#ifdef CONFIG_IRQ_BALANCE
+  /* Until the next balancing pass the IRQ is assumed to be serviced by the
+   * first CPU of the set.
+   */
+
+  if (!CPU_ISSET(g_irqvector[ndx].cpu, &affinity))
+    {
+      g_irqvector[ndx].cpu = ffs(affinity) - 1;
+    }
+#endif
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_get_affinity
+ *
+ * Description:
+ *   Get the set of CPUs that IRQ number 'irq' may be routed to.
+ *
+ * Input Parameters:
+ *   irq    - Irq num
+ *   cpuset - Location to return the set of CPUs
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_get_affinity(int irq, FAR cpu_set_t *cpuset)
+{
+  int ndx;
+
+  if ((unsigned)irq >= NR_IRQS || cpuset == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ndx = IRQ_TO_NDX(irq);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  *cpuset = g_irqvector[ndx].affinity != 0 ?
+            g_irqvector[ndx].affinity : IRQ_ALLCPUS;
+  return OK;
+}
@@ -51,6 +51,9 @@ struct irq_thread_info_s
   xcpt_t handler;     /* Address of the interrupt handler */
   FAR void *arg;      /* The argument provided to the interrupt handler. */
   FAR sem_t *sem;     /* irq sem used to notify irq thread */
+#ifdef CONFIG_IRQ_COALESCE
+  FAR struct irq_coalesce_s *coalesce; /* Batching of the irq thread */
+#endif
 };
 
 /****************************************************************************
@@ -63,6 +66,15 @@ static pid_t g_irq_thread_pid[NR_IRQS];
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_IRQ_COALESCE
+/* Wake up the irq thread once the batch delay has expired */
+
+static void irq_coalesce_timeout(wdparm_t arg)
+{
+  nxsem_post((FAR sem_t *)arg);
+}
+#endif
+
 /* Default interrupt handler for threaded interrupts.
  * Useful for oneshot interrupts.
  */
@@ -77,7 +89,28 @@ static int irq_default_handler(int irq, FAR void *regs, FAR void *arg)
 
   if (ret == IRQ_WAKE_THREAD)
     {
-      nxsem_post(info->sem);
+#ifdef CONFIG_IRQ_COALESCE
+      if (info->coalesce->maxevents > 0)
+        {
+          int delay = irq_coalesce_event(info->coalesce);
+
+          if (delay == 0)
+            {
+              wd_cancel(&info->coalesce->wdog);
+              nxsem_post(info->sem);
+            }
+          else if (delay > 0)
+            {
+              wd_start(&info->coalesce->wdog, delay,
+                       irq_coalesce_timeout, (wdparm_t)info->sem);
+            }
+        }
+      else
+#endif
+        {
+          nxsem_post(info->sem);
+        }
+
       ret = OK;
     }
 
@@ -96,6 +129,9 @@ static int isr_thread_main(int argc, FAR char *argv[])
   info.sem = &sem;
   info.arg = arg;
   info.handler = isr;
+#ifdef CONFIG_IRQ_COALESCE
+  info.coalesce = &g_irq_coalesce[IRQ_TO_NDX(irq)];
+#endif
 
   nxsem_init(&sem, 0, 0);
 
@@ -112,6 +148,16 @@ static int isr_thread_main(int argc, FAR char *argv[])
           continue;
         }
 
+#ifdef CONFIG_IRQ_COALESCE
+      /* The batch may have been handled on an earlier wakeup */
+
+      if (info.coalesce->maxevents > 0 &&
+          irq_coalesce_batch(info.coalesce) == 0)
+        {
+          continue;
+        }
+#endif
+
       isrthread(irq, NULL, arg);
     }
 
@@ -173,6 +219,9 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
   if (isrthread == NULL)
     {
       irq_detach(irq);
+#ifdef CONFIG_IRQ_COALESCE
+      wd_cancel(&g_irq_coalesce[ndx].wdog);
+#endif
       DEBUGASSERT(g_irq_thread_pid[ndx] != 0);
       kthread_delete(g_irq_thread_pid[ndx]);
       g_irq_thread_pid[ndx] = 0;
@@ -53,6 +53,9 @@ struct irq_work_info_s
   FAR void *arg;      /* The argument provided to the interrupt handler. */
   int irq;            /* Irq id */
   struct work_s work; /* Interrupt work to the wq */
+#ifdef CONFIG_IRQ_COALESCE
+  FAR struct irq_coalesce_s *coalesce; /* Batching of the interrupt work */
+#endif
 
   FAR struct kwork_wqueue_s *wqueue;   /* Work queue. */
 };
@@ -122,6 +125,13 @@ static void irq_work_handler(FAR void *arg)
 {
   FAR struct irq_work_info_s *info = arg;
 
+#ifdef CONFIG_IRQ_COALESCE
+  if (info->coalesce->maxevents > 0)
+    {
+      irq_coalesce_batch(info->coalesce);
+    }
+#endif
+
   info->isrwork(info->irq, NULL, info->arg);
 }
 
@@ -134,7 +144,28 @@ static int irq_default_handler(int irq, FAR void *regs, FAR void *arg)
 
   if (ret == IRQ_WAKE_THREAD)
     {
-      work_queue_wq(info->wqueue, &info->work, irq_work_handler, info, 0);
+#ifdef CONFIG_IRQ_COALESCE
+      if (info->coalesce->maxevents > 0)
+        {
+          /* Queue the work only once per batch, at once if the batch is
+           * full.
+           */
+
+          int delay = irq_coalesce_event(info->coalesce);
+
+          if (delay >= 0)
+            {
+              work_queue_wq(info->wqueue, &info->work, irq_work_handler,
+                            info, delay);
+            }
+        }
+      else
+#endif
+        {
+          work_queue_wq(info->wqueue, &info->work, irq_work_handler, info,
+                        0);
+        }
+
       ret = OK;
     }
 
@@ -204,6 +235,9 @@ int irq_attach_wqueue(int irq, xcpt_t isr, xcpt_t isrwork,
   info->handler = isr;
   info->arg     = arg;
   info->irq     = irq;
+#ifdef CONFIG_IRQ_COALESCE
+  info->coalesce = &g_irq_coalesce[ndx];
+#endif
   if (info->wqueue == NULL)
     {
       info->wqueue = irq_get_wqueue(priority);
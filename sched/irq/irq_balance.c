@@ -0,0 +1,217 @@
+/****************************************************************************
+ * sched/irq/irq_balance.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+
+#include "irq/irq.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IRQ_ALLCPUS ((cpu_set_t)((1u << CONFIG_SMP_NCPUS) - 1))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The load measured on one IRQ during the last period */
+
+struct irq_load_s
+{
+  int irq;
+  clock_t load;
+};
+
+/* The state of one balancing pass */
+
+struct irq_balance_s
+{
+  int nirqs;
+  struct irq_load_s irqs[NR_IRQS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct irq_balance_s g_irq_balance;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_balance_collect
+ *
+ * Description:
+ *   irq_foreach() callback: take the load of each IRQ that may be moved
+ *   and reset it for the next period.
+ *
+ ****************************************************************************/
+
+static int irq_balance_collect(int irq, FAR struct irq_info_s *info,
+                               FAR void *arg)
+{
+  FAR struct irq_balance_s *balance = arg;
+  cpu_set_t affinity = info->affinity != 0 ? info->affinity : IRQ_ALLCPUS;
+  irqstate_t flags;
+  clock_t load;
+
+  flags = enter_critical_section();
+  load = info->load;
+  info->load = 0;
+  leave_critical_section(flags);
+
+  /* IRQs that are idle or pinned to a single CPU are left alone */
+
+  if (load > 0 && CPU_COUNT(&affinity) > 1)
+    {
+      balance->irqs[balance->nirqs].irq  = irq;
+      balance->irqs[balance->nirqs].load = load;
+      balance->nirqs++;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: irq_balance_compare
+ *
+ * Description:
+ *   qsort() comparator, heaviest IRQ first.
+ *
+ ****************************************************************************/
+
+static int irq_balance_compare(FAR const void *a, FAR const void *b)
+{
+  FAR const struct irq_load_s *la = a;
+  FAR const struct irq_load_s *lb = b;
+
+  return la->load < lb->load ? 1 : la->load > lb->load ? -1 : 0;
+}
+
+/****************************************************************************
+ * Name: irq_balance_pass
+ *
+ * Description:
+ *   Place the IRQs, heaviest first, on the least loaded CPU permitted by
+ *   their affinity.  An IRQ stays where it is unless moving it lowers the
+ *   load of the busiest of the two CPUs, so that balanced IRQs do not move
+ *   back and forth between CPUs.
+ *
+ ****************************************************************************/
+
+static void irq_balance_pass(FAR struct irq_balance_s *balance)
+{
+  clock_t cpuload[CONFIG_SMP_NCPUS];
+  FAR struct irq_info_s *info;
+  cpu_set_t affinity;
+  int best;
+  int cpu;
+  int i;
+
+  balance->nirqs = 0;
+  irq_foreach(irq_balance_collect, balance);
+
+  qsort(balance->irqs, balance->nirqs, sizeof(balance->irqs[0]),
+        irq_balance_compare);
+
+  memset(cpuload, 0, sizeof(cpuload));
+
+  for (i = 0; i < balance->nirqs; i++)
+    {
+      FAR struct irq_load_s *entry = &balance->irqs[i];
+
+      info     = &g_irqvector[entry->irq];
+      affinity = info->affinity != 0 ? info->affinity : IRQ_ALLCPUS;
+      best     = info->cpu;
+
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          if (CPU_ISSET(cpu, &affinity) && cpuload[cpu] < cpuload[best])
+            {
+              best = cpu;
+            }
+        }
+
+      if (best != info->cpu &&
+          cpuload[info->cpu] > cpuload[best] + entry->load)
+        {
+          info->cpu = best;
+          up_affinity_irq(entry->irq, (cpu_set_t)1 << best);
+        }
+
+      cpuload[info->cpu] += entry->load;
+    }
+}
+
+/****************************************************************************
+ * Name: irq_balance_thread
+ ****************************************************************************/
+
+static int irq_balance_thread(int argc, FAR char *argv[])
+{
+  for (; ; )
+    {
+      usleep(CONFIG_IRQ_BALANCE_INTERVAL * USEC_PER_MSEC);
+      irq_balance_pass(&g_irq_balance);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_balance_start
+ *
+ * Description:
+ *   Start the IRQ balancing kernel thread.
+ *
+ * Returned Value:
+ *   The pid of the thread on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_balance_start(void)
+{
+  return kthread_create("irq_balance", CONFIG_IRQ_BALANCE_PRIORITY,
+                        CONFIG_IRQ_BALANCE_STACKSIZE, irq_balance_thread,
+                        NULL);
+}
@@ -0,0 +1,155 @@
+/****************************************************************************
+ * sched/irq/irq_coalesce.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+
+#include "irq/irq.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE
+struct irq_coalesce_s g_irq_coalesce[CONFIG_ARCH_NUSER_INTERRUPTS];
+#else
+struct irq_coalesce_s g_irq_coalesce[NR_IRQS];
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_coalesce_event
+ *
+ * Description:
+ *   Called by the top half each time it asks for the bottom half.
+ *
+ * Returned Value:
+ *   Zero if the bottom half must be woken at once, a positive delay in
+ *   ticks if it must be woken after that delay, or a negated value if a
+ *   wakeup has already been arranged for the current batch.
+ *
+ ****************************************************************************/
+
+int irq_coalesce_event(FAR struct irq_coalesce_s *coalesce)
+{
+  uint32_t pending = atomic_fetch_add(&coalesce->pending, 1) + 1;
+
+  if (pending >= coalesce->maxevents)
+    {
+      return 0;
+    }
+  else if (pending == 1)
+    {
+      return coalesce->maxdelay;
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: irq_coalesce_batch
+ *
+ * Description:
+ *   Called by the bottom half before it runs.  Returns the number of events
+ *   in the batch and clears it; zero means that the batch has already been
+ *   handled by an earlier wakeup.
+ *
+ ****************************************************************************/
+
+uint32_t irq_coalesce_batch(FAR struct irq_coalesce_s *coalesce)
+{
+  uint32_t pending = atomic_xchg(&coalesce->pending, 0);
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+  if (pending > 0)
+    {
+      coalesce->batches++;
+    }
+#endif
+
+  return pending;
+}
+
+/****************************************************************************
+ * Name: irq_set_coalesce
+ *
+ * Description:
+ *   Batch the bottom half attached with irq_attach_thread() or
+ *   irq_attach_wqueue() to IRQ number 'irq'.
+ *
+ * Input Parameters:
+ *   irq       - Irq num
+ *   maxevents - Events per batch, zero or one disables coalescing
+ *   maxdelay  - Maximum delay of the first event of a batch (us)
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_set_coalesce(int irq, unsigned int maxevents,
+                     unsigned int maxdelay)
+{
+  FAR struct irq_coalesce_s *coalesce;
+  irqstate_t flags;
+  int ndx;
+
+  if ((unsigned)irq >= NR_IRQS)
+    {
+      return -EINVAL;
+    }
+
+  ndx = IRQ_TO_NDX(irq);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  if (maxevents > 1 && maxdelay == 0)
+    {
+      return -EINVAL;
+    }
+
+  coalesce = &g_irq_coalesce[ndx];
+
+  flags = enter_critical_section();
+  coalesce->maxevents = maxevents > 1 ? maxevents : 0;
+  coalesce->maxdelay  = maxevents > 1 ? USEC2TICK(maxdelay) : 0;
+  if (coalesce->maxevents > 0 && coalesce->maxdelay == 0)
+    {
+      coalesce->maxdelay = 1;
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
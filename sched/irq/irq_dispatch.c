@@ -47,6 +47,14 @@
 #  define NUSER_IRQS NR_IRQS
 #endif
 
+/* IRQ_ADD_LOAD - Account the handler time used to balance the IRQs */
+
+#ifdef CONFIG_IRQ_BALANCE
+#  define IRQ_ADD_LOAD(ndx, elapsed) (g_irqvector[ndx].load += (elapsed))
+#else
+#  define IRQ_ADD_LOAD(ndx, elapsed)
+#endif
+
 /* CALL_VECTOR - Call the interrupt service routine attached to this
  * interrupt request
  */
@@ -63,6 +71,7 @@
          if (ndx < NUSER_IRQS) \
            { \
              g_irqvector[ndx].count++; \
+             IRQ_ADD_LOAD(ndx, elapsed); \
              if (elapsed > g_irqvector[ndx].time) \
                { \
                  g_irqvector[ndx].time = elapsed; \
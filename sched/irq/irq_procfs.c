@@ -28,6 +28,7 @@
 
 #include <sys/stat.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <fcntl.h>
 #include <string.h>
 #include <assert.h>
@@ -58,17 +59,40 @@
  * NOTE:  This assumes that an address can be represented in 32-bits.  In
  * the typical configuration where CONFIG_HAVE_LONG_LONG=y, the COUNT field
  * may not be wide enough.
+ *
+ * With CONFIG_IRQ_COALESCE, a BATCHES column follows with the number of
+ * times the bottom half ran for the events counted in COUNT.  With
+ * CONFIG_IRQ_AFFINITY, an AFFINITY column follows with the mask of CPUs
+ * that the IRQ may be routed to.
  */
 
-#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME\n"
-#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu\n"
+#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME"
+#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu"
+
+#ifdef CONFIG_IRQ_COALESCE
+#  define HDR_BATCHES "    BATCHES"
+#  define BATCHES_FMT " %10lu"
+#  define BATCHES_LEN 11
+#else
+#  define HDR_BATCHES ""
+#  define BATCHES_LEN 0
+#endif
+
+#ifdef CONFIG_IRQ_AFFINITY
+#  define HDR_AFFINITY " AFFINITY"
+#  define AFFINITY_FMT " %08lx"
+#  define AFFINITY_LEN 9
+#else
+#  define HDR_AFFINITY ""
+#  define AFFINITY_LEN 0
+#endif
 
 /* Determines the size of an intermediate buffer that must be large enough
  * to handle the longest line generated by this logic (plus a couple of
  * bytes).
  */
 
-#define IRQ_LINELEN 50
+#define IRQ_LINELEN (50 + BATCHES_LEN + AFFINITY_LEN)
 
 /****************************************************************************
  * Private Types
@@ -102,6 +126,10 @@ static int     irq_open(FAR struct file *filep, FAR const char *relpath,
 static int     irq_close(FAR struct file *filep);
 static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
+#ifdef CONFIG_IRQ_AFFINITY
+static ssize_t irq_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+#endif
 static int     irq_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     irq_stat(FAR const char *relpath, FAR struct stat *buf);
@@ -120,7 +148,11 @@ const struct procfs_operations g_irq_operations =
   irq_open,       /* open */
   irq_close,      /* close */
   irq_read,       /* read */
+#ifdef CONFIG_IRQ_AFFINITY
+  irq_write,      /* write */
+#else
   NULL,           /* write */
+#endif
   NULL,           /* poll */
 
   irq_dup,        /* dup */
@@ -155,6 +187,13 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   unsigned long intpart;
   unsigned long fracpart;
   unsigned long count;
+#ifdef CONFIG_IRQ_COALESCE
+  FAR struct irq_coalesce_s *coalesce = &g_irq_coalesce[IRQ_TO_NDX(irq)];
+  unsigned long batches;
+#endif
+#ifdef CONFIG_IRQ_AFFINITY
+  cpu_set_t affinity;
+#endif
 
   DEBUGASSERT(irqfile != NULL);
 
@@ -166,8 +205,16 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   info->start = now;
   info->time  = 0;
   info->count = 0;
+#ifdef CONFIG_IRQ_COALESCE
+  batches           = coalesce->batches;
+  coalesce->batches = 0;
+#endif
   leave_critical_section(flags);
 
+#ifdef CONFIG_IRQ_AFFINITY
+  irq_get_affinity(irq, &affinity);
+#endif
+
   /* Don't bother if count == 0.
    *
    * REVISIT:  There is a logic problem with skipping if the count is zero.
@@ -242,6 +289,16 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
                       (unsigned long)((uintptr_t)copy.arg),
                       count, intpart, fracpart,
                       (unsigned long)delta.tv_nsec / 1000);
+#ifdef CONFIG_IRQ_COALESCE
+  linesize += snprintf(irqfile->line + linesize, IRQ_LINELEN - linesize,
+                       BATCHES_FMT, batches);
+#endif
+#ifdef CONFIG_IRQ_AFFINITY
+  linesize += snprintf(irqfile->line + linesize, IRQ_LINELEN - linesize,
+                       AFFINITY_FMT, (unsigned long)affinity);
+#endif
+  linesize += snprintf(irqfile->line + linesize, IRQ_LINELEN - linesize,
+                       "\n");
 
   copysize  = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
                             irqfile->remaining, &irqfile->offset);
@@ -275,6 +332,7 @@ static int irq_open(FAR struct file *filep, FAR const char *relpath,
 
   finfo("Open '%s'\n", relpath);
 
+#ifndef CONFIG_IRQ_AFFINITY
   /* This PROCFS file is read-only.  Any attempt to open with write access
    * is not permitted.
    */
@@ -284,6 +342,7 @@ static int irq_open(FAR struct file *filep, FAR const char *relpath,
       ferr("ERROR: Only O_RDONLY supported\n");
       return -EACCES;
     }
+#endif
 
   /* Allocate a container to hold the file attributes */
 
@@ -346,7 +405,8 @@ static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
 
   /* The first line to output is the header */
 
-  linesize = snprintf(irqfile->line, IRQ_LINELEN, HDR_FMT);
+  linesize = snprintf(irqfile->line, IRQ_LINELEN, "%s%s%s\n",
+                      HDR_FMT, HDR_BATCHES, HDR_AFFINITY);
 
   copysize = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
                            irqfile->remaining, &irqfile->offset);
@@ -367,6 +427,46 @@ static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
   return irqfile->ncopied;
 }
 
+/****************************************************************************
+ * Name: irq_write
+ *
+ * Description:
+ *   Set the affinity of an IRQ: "<irq> <cpumask>", the mask being in
+ *   hexadecimal.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_AFFINITY
+static ssize_t irq_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t buflen)
+{
+  char line[32];
+  FAR char *endptr;
+  cpu_set_t cpuset;
+  int irq;
+  int ret;
+
+  if (buflen >= sizeof(line))
+    {
+      return -EINVAL;
+    }
+
+  memcpy(line, buffer, buflen);
+  line[buflen] = '\0';
+
+  irq = strtol(line, &endptr, 10);
+  if (endptr == line)
+    {
+      return -EINVAL;
+    }
+
+  cpuset = strtoul(endptr, NULL, 16);
+
+  ret = irq_set_affinity(irq, &cpuset);
+  return ret < 0 ? ret : buflen;
+}
+#endif
+
 /****************************************************************************
  * Name: irq_dup
  *
@@ -415,10 +515,13 @@ static int irq_dup(FAR const struct file *oldp, FAR struct file *newp)
 
 static int irq_stat(const char *relpath, struct stat *buf)
 {
-  /* "irqs" is the name for a read-only file */
+  /* "irqs" is the name for a read-only file, writable with IRQ affinity */
 
   memset(buf, 0, sizeof(struct stat));
   buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+#ifdef CONFIG_IRQ_AFFINITY
+  buf->st_mode |= S_IWUSR;
+#endif
   return OK;
 }
 
@@ -32,6 +32,7 @@
 
 #include <nuttx/coredump.h>
 #include <nuttx/elf.h>
+#include <nuttx/mm/mm.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/sched.h>
 
@@ -76,6 +77,17 @@ struct elf_dumpinfo_s
   pid_t                       pid;
 };
 
+#ifdef CONFIG_BOARD_COREDUMP_ZERO_FREEHEAP
+/* State of the free chunk walk over one memory region */
+
+struct elf_freeinfo_s
+{
+  FAR struct elf_dumpinfo_s *cinfo;
+  uintptr_t                  cursor;  /* First byte not yet emitted */
+  uintptr_t                  end;     /* End of the region */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -162,19 +174,17 @@ static int elf_emit(FAR struct elf_dumpinfo_s *cinfo,
 }
 
 /****************************************************************************
- * Name: elf_emit_align
+ * Name: elf_emit_zero
  *
  * Description:
- *   Align the filled data according to the current offset
+ *   Send len bytes of zeros to the out stream
  *
  ****************************************************************************/
 
-static int elf_emit_align(FAR struct elf_dumpinfo_s *cinfo)
+static int elf_emit_zero(FAR struct elf_dumpinfo_s *cinfo, off_t len)
 {
-  off_t align = ALIGN_UP(cinfo->stream->nput,
-                         ELF_PAGESIZE) - cinfo->stream->nput;
   unsigned char null[256];
-  off_t total = align;
+  off_t total = len;
   off_t ret = 0;
 
   memset(null, 0, sizeof(null));
@@ -191,7 +201,23 @@ static int elf_emit_align(FAR struct elf_dumpinfo_s *cinfo)
       total -= ret;
     }
 
-  return ret < 0 ? ret : align;
+  return ret < 0 ? ret : len;
+}
+
+/****************************************************************************
+ * Name: elf_emit_align
+ *
+ * Description:
+ *   Align the filled data according to the current offset
+ *
+ ****************************************************************************/
+
+static int elf_emit_align(FAR struct elf_dumpinfo_s *cinfo)
+{
+  off_t align = ALIGN_UP(cinfo->stream->nput,
+                         ELF_PAGESIZE) - cinfo->stream->nput;
+
+  return elf_emit_zero(cinfo, align);
 }
 
 /****************************************************************************
@@ -464,6 +490,68 @@ static void elf_emit_stack(FAR struct elf_dumpinfo_s *cinfo)
     }
 }
 
+/****************************************************************************
+ * Name: elf_emit_free_handler
+ *
+ * Description:
+ *   Emit the memory up to a free heap chunk, then zeros for the chunk.
+ *   Chunks outside the region, or below what has already been emitted,
+ *   are ignored and dumped as they are.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOARD_COREDUMP_ZERO_FREEHEAP
+static void elf_emit_free_handler(FAR void *start, size_t size,
+                                  FAR void *arg)
+{
+  FAR struct elf_freeinfo_s *info = arg;
+  uintptr_t begin = MAX((uintptr_t)start, info->cursor);
+  uintptr_t end = MIN((uintptr_t)start + size, info->end);
+
+  if (begin >= end)
+    {
+      return;
+    }
+
+  elf_emit(info->cinfo, (FAR void *)info->cursor, begin - info->cursor);
+  elf_emit_zero(info->cinfo, end - begin);
+  info->cursor = end;
+}
+#endif
+
+/****************************************************************************
+ * Name: elf_emit_region
+ *
+ * Description:
+ *   Emit one memory region.  With CONFIG_BOARD_COREDUMP_ZERO_FREEHEAP the
+ *   contents of free heap chunks are replaced by zeros; they are of no use
+ *   for debugging, and the compressor folds the zeros away.
+ *
+ ****************************************************************************/
+
+static void elf_emit_region(FAR struct elf_dumpinfo_s *cinfo,
+                            uintptr_t start, uintptr_t end)
+{
+#ifdef CONFIG_BOARD_COREDUMP_ZERO_FREEHEAP
+  struct elf_freeinfo_s info;
+
+  info.cinfo  = cinfo;
+  info.cursor = start;
+  info.end    = end;
+
+#  ifdef CONFIG_MM_KERNEL_HEAP
+  mm_foreach_free(g_kmmheap, elf_emit_free_handler, &info);
+#  endif
+#  ifdef CONFIG_BUILD_FLAT
+  mm_foreach_free(g_mmheap, elf_emit_free_handler, &info);
+#  endif
+
+  start = info.cursor;
+#endif
+
+  elf_emit(cinfo, (FAR void *)start, end - start);
+}
+
 /****************************************************************************
  * Name: elf_emit_memory
  *
@@ -503,8 +591,8 @@ static void elf_emit_memory(FAR struct elf_dumpinfo_s *cinfo, int memsegs)
         }
       else
         {
-          elf_emit(cinfo, (FAR void *)cinfo->regions[i].start,
-                   cinfo->regions[i].end - cinfo->regions[i].start);
+          elf_emit_region(cinfo, cinfo->regions[i].start,
+                          cinfo->regions[i].end);
         }
 
       /* Align to page */
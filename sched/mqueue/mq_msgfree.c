@@ -48,6 +48,7 @@
  *   allocated dynamically it will be deallocated.
  *
  * Input Parameters:
+ *   msgq  - The message queue that the message was sent to
  *   mqmsg - message to free
  *
  * Returned Value:
@@ -55,10 +56,25 @@
  *
  ****************************************************************************/
 
-void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
+void nxmq_free_msg(FAR struct mqueue_inode_s *msgq,
+                   FAR struct mqueue_msg_s *mqmsg)
 {
   irqstate_t flags;
 
+#ifdef CONFIG_MQ_SLAB
+  /* Messages of the per-queue slab go back to the queue they belong to */
+
+  if (mqmsg->type == MQ_ALLOC_SLAB)
+    {
+      flags = spin_lock_irqsave(&msgq->slablock);
+      list_add_tail(&msgq->slabfree, &mqmsg->node);
+      spin_unlock_irqrestore(&msgq->slablock, flags);
+      return;
+    }
+#else
+  UNUSED(msgq);
+#endif
+
   /* If this is a generally available pre-allocated message,
    * then just put it back in the free list.
    */
@@ -32,6 +32,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/sched.h>
 #include <nuttx/mqueue.h>
+#include <nuttx/spinlock.h>
 
 #include "sched/sched.h"
 #include "mqueue/mqueue.h"
@@ -68,6 +69,13 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
                     FAR struct mqueue_inode_s **pmsgq)
 {
   FAR struct mqueue_inode_s *msgq;
+#ifdef CONFIG_MQ_SLAB
+  FAR struct mqueue_msg_s *mqmsg;
+  FAR uint8_t *slab;
+  size_t slabsize;
+  int16_t maxmsgs;
+  int i;
+#endif
 
   /* Check if the caller is attempting to allocate a message for messages
    * larger than the configured maximum message size.
@@ -79,10 +87,24 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
       return -EINVAL;
     }
 
+#ifdef CONFIG_MQ_SLAB
+  /* Allocate the message queue together with one message per slot of the
+   * queue, so that sending and receiving normally never touch the shared
+   * free lists.
+   */
+
+  maxmsgs  = attr ? (int16_t)attr->mq_maxmsg : MQ_MAX_MSGS;
+  slabsize = MQ_SLAB_SIZE(attr ? attr->mq_msgsize : MQ_MAX_BYTES);
+
+  msgq = (FAR struct mqueue_inode_s *)
+    kmm_zalloc(MQ_ALIGN(sizeof(struct mqueue_inode_s)) +
+               maxmsgs * slabsize);
+#else
   /* Allocate memory for the new message queue. */
 
   msgq = (FAR struct mqueue_inode_s *)
     kmm_zalloc(sizeof(struct mqueue_inode_s));
+#endif
 
   if (msgq)
     {
@@ -100,6 +122,24 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
           msgq->maxmsgsize = MQ_MAX_BYTES;
         }
 
+#ifdef CONFIG_MQ_SLAB
+      spin_lock_init(&msgq->slablock);
+      list_initialize(&msgq->slabfree);
+
+      slab = (FAR uint8_t *)msgq +
+             MQ_ALIGN(sizeof(struct mqueue_inode_s));
+      for (i = 0; i < maxmsgs; i++, slab += slabsize)
+        {
+          mqmsg       = (FAR struct mqueue_msg_s *)slab;
+          mqmsg->type = MQ_ALLOC_SLAB;
+          list_add_tail(&msgq->slabfree, &mqmsg->node);
+        }
+#endif
+
+#ifdef CONFIG_MQ_HANDOFF
+      dq_init(&msgq->cmn.rcvwait);
+#endif
+
 #ifndef CONFIG_DISABLE_MQUEUE_NOTIFICATION
       msgq->ntpid = INVALID_PROCESS_ID;
 #endif
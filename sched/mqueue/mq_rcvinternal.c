@@ -108,6 +108,10 @@ static void nxmq_rcvtimeout(wdparm_t arg)
  *   msgq   - Message queue descriptor
  *   rcvmsg - The caller-provided location in which to return the newly
  *            received message.
+ *   rcvwait - With CONFIG_MQ_HANDOFF, describes the receive buffer that a
+ *             sender may copy the message to directly.  On return,
+ *             rcvwait->msglen is not negative if that happened; *rcvmsg is
+ *             NULL in that case.
  *   abstime - If non-NULL, this is the absolute time to wait until a
  *             message is received.
  *
@@ -126,6 +130,7 @@ static void nxmq_rcvtimeout(wdparm_t arg)
 
 int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
                       FAR struct mqueue_msg_s **rcvmsg,
+                      FAR struct mqueue_rcvwait_s *rcvwait,
                       FAR const struct timespec *abstime,
                       sclock_t ticks)
 {
@@ -158,11 +163,28 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
                nxmq_rcvtimeout, (wdparm_t)rtcb);
     }
 
+#ifdef CONFIG_MQ_HANDOFF
+  rcvwait->tcb    = rtcb;
+  rcvwait->msglen = -1;
+  dq_addlast(&rcvwait->node, &msgq->cmn.rcvwait);
+#else
+  UNUSED(rcvwait);
+#endif
+
   /* Get the message from the head of the queue */
 
   while ((newmsg = (FAR struct mqueue_msg_s *)
                    list_remove_head(&msgq->msglist)) == NULL)
     {
+#ifdef CONFIG_MQ_HANDOFF
+      /* A sender already copied its message to our buffer */
+
+      if (rcvwait->msglen >= 0)
+        {
+          break;
+        }
+
+#endif
       msgq->cmn.nwaitnotempty++;
 
       /* Initialize the 'errcode" used to communication wake-up error
@@ -202,6 +224,28 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
       wd_cancel(&rtcb->waitdog);
     }
 
+#ifdef CONFIG_MQ_HANDOFF
+  if (rcvwait->msglen < 0)
+    {
+      dq_rem(&rcvwait->node, &msgq->cmn.rcvwait);
+    }
+  else if (newmsg != NULL)
+    {
+      /* Handed a message and woken with an error or with a message on the
+       * queue at the same time: the handed off message wins, put the
+       * queued one back.
+       */
+
+      list_add_head(&msgq->msglist, &newmsg->node);
+      newmsg = NULL;
+    }
+
+  if (rcvwait->msglen >= 0)
+    {
+      rtcb->errcode = OK;
+    }
+#endif
+
   *rcvmsg = newmsg;
   return -rtcb->errcode;
 }
@@ -271,3 +315,43 @@ void nxmq_notify_receive(FAR struct mqueue_inode_s *msgq)
         }
     }
 }
+
+/****************************************************************************
+ * Name: nxmq_rcvwait_find
+ *
+ * Description:
+ *   Find the receive buffer that the blocked receiver 'tcb' registered
+ *   with the message queue.
+ *
+ * Input Parameters:
+ *   cmn - The common part of the message queue
+ *   tcb - The blocked receiver
+ *
+ * Returned Value:
+ *   The receive buffer description, or NULL if the receiver has none.
+ *
+ * Assumptions:
+ * - Executes within a critical section established by the caller.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_HANDOFF
+FAR struct mqueue_rcvwait_s *
+nxmq_rcvwait_find(FAR struct mqueue_cmn_s *cmn, FAR struct tcb_s *tcb)
+{
+  FAR dq_entry_t *entry;
+
+  for (entry = dq_peek(&cmn->rcvwait); entry != NULL; entry = dq_next(entry))
+    {
+      FAR struct mqueue_rcvwait_s *rcvwait =
+        (FAR struct mqueue_rcvwait_s *)entry;
+
+      if (rcvwait->tcb == tcb)
+        {
+          return rcvwait;
+        }
+    }
+
+  return NULL;
+}
+#endif
@@ -142,6 +142,7 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
 {
   FAR struct mqueue_inode_s *msgq;
   FAR struct mqueue_msg_s *mqmsg;
+  struct mqueue_rcvwait_s rcvwait;
   irqstate_t flags;
   ssize_t ret = 0;
 
@@ -192,12 +193,29 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
 
       /* Wait & get the message from the message queue */
 
-      ret = nxmq_wait_receive(msgq, &mqmsg, abstime, ticks);
+      rcvwait.msg = msg;
+      ret = nxmq_wait_receive(msgq, &mqmsg, &rcvwait, abstime, ticks);
       if (ret < 0)
         {
           leave_critical_section(flags);
           return ret;
         }
+
+#ifdef CONFIG_MQ_HANDOFF
+      /* The message was copied straight to our buffer and never queued */
+
+      if (mqmsg == NULL)
+        {
+          leave_critical_section(flags);
+
+          if (prio)
+            {
+              *prio = rcvwait.prio;
+            }
+
+          return rcvwait.msglen;
+        }
+#endif
     }
 
   /* If we got message, then decrement the number of messages in
@@ -227,7 +245,7 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
 
   /* Free the message structure */
 
-  nxmq_free_msg(mqmsg);
+  nxmq_free_msg(msgq, mqmsg);
 
   return ret;
 }
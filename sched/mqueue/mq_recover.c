@@ -59,6 +59,9 @@
 void nxmq_recover(FAR struct tcb_s *tcb)
 {
   FAR struct mqueue_inode_s *msgq;
+#ifdef CONFIG_MQ_HANDOFF
+  FAR struct mqueue_rcvwait_s *rcvwait;
+#endif
 
   /* If were were waiting for a timed message queue event, then the
    * timer was canceled and deleted in nxtask_recover() before this
@@ -75,6 +78,16 @@ void nxmq_recover(FAR struct tcb_s *tcb)
 
       DEBUGASSERT(msgq && msgq->cmn.nwaitnotempty > 0);
       msgq->cmn.nwaitnotempty--;
+
+#ifdef CONFIG_MQ_HANDOFF
+      /* Forget the receive buffer, it goes away with the task */
+
+      rcvwait = nxmq_rcvwait_find(&msgq->cmn, tcb);
+      if (rcvwait != NULL)
+        {
+          dq_rem(&rcvwait->node, &msgq->cmn.rcvwait);
+        }
+#endif
     }
 
   /* Was the task waiting for a message queue to become non-full? */
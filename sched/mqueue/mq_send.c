@@ -123,8 +123,11 @@ static int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  *   the g_msgfreeirq list.  If this is unsuccessful, the calling interrupt
  *   handler will be notified.
  *
+ *   With CONFIG_MQ_SLAB, the slab of the receiving queue is tried first.
+ *
  * Input Parameters:
- *   None
+ *   msgq    - The message queue that the message will be sent to
+ *   msgsize - The size of the message payload
  *
  * Returned Value:
  *   A reference to the allocated msg structure.  On a failure to allocate,
@@ -132,11 +135,28 @@ static int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  *
  ****************************************************************************/
 
-static FAR struct mqueue_msg_s *nxmq_alloc_msg(uint16_t msgsize)
+static FAR struct mqueue_msg_s *
+nxmq_alloc_msg(FAR struct mqueue_inode_s *msgq, uint16_t msgsize)
 {
   FAR struct mqueue_msg_s *mqmsg;
   irqstate_t flags;
 
+#ifdef CONFIG_MQ_SLAB
+  /* Try the slab of the queue first.  It only runs dry while receivers
+   * are still copying out messages or senders wait for a full queue.
+   */
+
+  flags = spin_lock_irqsave(&msgq->slablock);
+  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&msgq->slabfree);
+  spin_unlock_irqrestore(&msgq->slablock, flags);
+  if (mqmsg != NULL)
+    {
+      return mqmsg;
+    }
+#else
+  UNUSED(msgq);
+#endif
+
   /* Try to get the message from the generally available free list. */
 
   flags = spin_lock_irqsave(&g_msgfreelock);
@@ -306,9 +326,24 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
 
   msgq = mq->f_inode->i_private;
 
+#ifdef CONFIG_MQ_HANDOFF
+  /* If a receiver is already blocked on the empty queue, copy the message
+   * straight into its buffer.
+   */
+
+  flags = enter_critical_section();
+  if (nxmq_handoff(msgq, msg, msglen, prio))
+    {
+      leave_critical_section(flags);
+      return OK;
+    }
+
+  leave_critical_section(flags);
+#endif
+
   /* Pre-allocate a message structure */
 
-  mqmsg = nxmq_alloc_msg(msglen);
+  mqmsg = nxmq_alloc_msg(msgq, msglen);
   if (!mqmsg)
     {
       return -ENOMEM;
@@ -363,7 +398,7 @@ out:
 
   if (ret < 0)
     {
-      nxmq_free_msg(mqmsg);
+      nxmq_free_msg(msgq, mqmsg);
     }
 
   return ret;
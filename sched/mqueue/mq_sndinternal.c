@@ -304,3 +304,76 @@ void nxmq_notify_send(FAR struct mqueue_inode_s *msgq)
         }
     }
 }
+
+/****************************************************************************
+ * Name: nxmq_handoff
+ *
+ * Description:
+ *   Hand a message directly to the highest priority receiver blocked on
+ *   the empty message queue: the message is copied into the buffer of the
+ *   receiver, which is then made ready-to-run.  The message is neither
+ *   allocated nor queued, and no notification is sent since it is consumed
+ *   right away.
+ *
+ * Input Parameters:
+ *   msgq   - Message queue descriptor
+ *   msg    - Message to send
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   True if the message was handed off; false if no receiver is blocked on
+ *   the queue and the message must be queued as usual.
+ *
+ * Assumptions/restrictions:
+ * - Executes within a critical section established by the caller.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_HANDOFF
+bool nxmq_handoff(FAR struct mqueue_inode_s *msgq, FAR const char *msg,
+                  size_t msglen, unsigned int prio)
+{
+  FAR struct mqueue_rcvwait_s *rcvwait;
+  FAR struct tcb_s *rtcb;
+  FAR struct tcb_s *btcb;
+
+  /* Queued messages go first, they may have a higher priority */
+
+  if (msgq->nmsgs > 0 || msgq->cmn.nwaitnotempty == 0)
+    {
+      return false;
+    }
+
+  /* Find the buffer of the highest priority receiver */
+
+  btcb = (FAR struct tcb_s *)dq_peek(MQ_WNELIST(msgq->cmn));
+  DEBUGASSERT(btcb != NULL);
+
+  rcvwait = nxmq_rcvwait_find(&msgq->cmn, btcb);
+  if (rcvwait == NULL)
+    {
+      return false;
+    }
+
+  memcpy(rcvwait->msg, msg, msglen);
+  rcvwait->msglen = msglen;
+  rcvwait->prio   = prio;
+  dq_rem(&rcvwait->node, &msgq->cmn.rcvwait);
+
+  /* And wake the receiver up */
+
+  rtcb = this_task();
+  dq_rem((FAR dq_entry_t *)btcb, MQ_WNELIST(msgq->cmn));
+  wd_cancel(&btcb->waitdog);
+  msgq->cmn.nwaitnotempty--;
+  btcb->waitobj = NULL;
+
+  if (nxsched_add_readytorun(btcb))
+    {
+      up_switch_context(this_task(), rtcb);
+    }
+
+  return true;
+}
+#endif
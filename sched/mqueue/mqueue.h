@@ -52,6 +52,14 @@
 
 #define MQ_MSG_SIZE(n) (sizeof(struct mqueue_msg_s) + (n) - 1)
 
+/* Size of one message of a per-queue slab, rounded up so that the next
+ * message in the slab stays aligned.
+ */
+
+#define MQ_ALIGN(n)     (((n) + sizeof(uintptr_t) - 1) & \
+                         ~(sizeof(uintptr_t) - 1))
+#define MQ_SLAB_SIZE(n) MQ_ALIGN(MQ_MSG_SIZE(n))
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -60,7 +68,8 @@ enum mqalloc_e
 {
   MQ_ALLOC_FIXED = 0,  /* Pre-allocated; never freed */
   MQ_ALLOC_DYN,        /* Dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_SLAB        /* Part of the slab of the receiving queue */
 };
 
 /* This structure describes one buffered POSIX message. */
@@ -78,6 +87,20 @@ struct mqueue_msg_s
   char mail[1];            /* Message data */
 };
 
+/* This structure describes a receiver blocked on an empty message queue.
+ * With CONFIG_MQ_HANDOFF, a sender copies its message straight into the
+ * receiver's buffer instead of queueing it.
+ */
+
+struct mqueue_rcvwait_s
+{
+  dq_entry_t node;         /* Link in the cmn.rcvwait list of the queue */
+  FAR struct tcb_s *tcb;   /* The blocked receiver */
+  FAR char *msg;           /* The receive buffer */
+  ssize_t msglen;          /* Length of the handed off message, or -1 */
+  unsigned int prio;       /* Priority of the handed off message */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -117,7 +140,8 @@ void nxmq_initialize(void);
 
 /* mq_msgfree.c *************************************************************/
 
-void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg);
+void nxmq_free_msg(FAR struct mqueue_inode_s *msgq,
+                   FAR struct mqueue_msg_s *mqmsg);
 
 /* mq_waitirq.c *************************************************************/
 
@@ -127,9 +151,14 @@ void nxmq_wait_irq(FAR struct tcb_s *wtcb, int errcode);
 
 int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
                       FAR struct mqueue_msg_s **rcvmsg,
+                      FAR struct mqueue_rcvwait_s *rcvwait,
                       FAR const struct timespec *abstime,
                       sclock_t ticks);
 void nxmq_notify_receive(FAR struct mqueue_inode_s *msgq);
+#ifdef CONFIG_MQ_HANDOFF
+FAR struct mqueue_rcvwait_s *
+nxmq_rcvwait_find(FAR struct mqueue_cmn_s *cmn, FAR struct tcb_s *tcb);
+#endif
 
 /* mq_sndinternal.c *********************************************************/
 
@@ -137,6 +166,10 @@ int nxmq_wait_send(FAR struct mqueue_inode_s *msgq,
                    FAR const struct timespec *abstime,
                    sclock_t ticks);
 void nxmq_notify_send(FAR struct mqueue_inode_s *msgq);
+#ifdef CONFIG_MQ_HANDOFF
+bool nxmq_handoff(FAR struct mqueue_inode_s *msgq, FAR const char *msg,
+                  size_t msglen, unsigned int prio);
+#endif
 
 /* mq_recover.c *************************************************************/
 
@@ -60,6 +60,7 @@
 #  define mutex_set_protocol(m,p)     nxrmutex_set_protocol(m,p)
 #  define mutex_getprioceiling(m,p)   nxrmutex_getprioceiling(m,p)
 #  define mutex_setprioceiling(m,p,o) nxrmutex_setprioceiling(m,p,o)
+#  define mutex_sem(m)                (&(m)->mutex.sem)
 #else
 #  define mutex_init(m)               nxmutex_init(m)
 #  define mutex_destroy(m)            nxmutex_destroy(m)
@@ -78,10 +79,19 @@
 #  define mutex_set_protocol(m,p)     nxmutex_set_protocol(m,p)
 #  define mutex_getprioceiling(m,p)   nxmutex_getprioceiling(m,p)
 #  define mutex_setprioceiling(m,p,o) nxmutex_setprioceiling(m,p,o)
+#  define mutex_sem(m)                (&(m)->sem)
 #endif
 
 #define COND_WAIT_COUNT(cond) ((FAR atomic_t *)&(cond)->wait_count)
 
+/* The mutex the waiters of a condition variable reacquire */
+
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+#  define COND_SET_MUTEX(cond,m) ((cond)->mutex = (m))
+#else
+#  define COND_SET_MUTEX(cond,m)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -110,6 +120,10 @@ int pthread_findjoininfo(FAR struct task_group_s *group, pid_t pid,
                          FAR struct task_join_s **join, bool create);
 void pthread_release(FAR struct task_group_s *group);
 
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+int pthread_cond_wake(FAR pthread_cond_t *cond, int count);
+#endif
+
 #ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
 int pthread_mutex_take(FAR struct pthread_mutex_s *mutex,
                        FAR const struct timespec *abs_timeout);
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <limits.h>
 #include <pthread.h>
 #include <sched.h>
 #include <errno.h>
@@ -67,6 +68,9 @@ int pthread_cond_broadcast(FAR pthread_cond_t *cond)
     }
   else
     {
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+      ret = pthread_cond_wake(cond, INT_MAX);
+#else
       int wcnt = atomic_read(COND_WAIT_COUNT(cond));
 
       /* Loop until all of the waiting threads have been restarted. */
@@ -86,6 +90,7 @@ int pthread_cond_broadcast(FAR pthread_cond_t *cond)
               wcnt--;
             }
         }
+#endif
     }
 
   sinfo("Returning %d\n", ret);
@@ -66,6 +66,9 @@ int pthread_cond_signal(FAR pthread_cond_t *cond)
     }
   else
     {
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+      ret = pthread_cond_wake(cond, 1);
+#else
       int wcnt = atomic_read(COND_WAIT_COUNT(cond));
 
       while (wcnt > 0)
@@ -77,6 +80,7 @@ int pthread_cond_signal(FAR pthread_cond_t *cond)
               break;
             }
         }
+#endif
     }
 
   sinfo("Returning %d\n", ret);
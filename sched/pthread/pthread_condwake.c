@@ -0,0 +1,96 @@
+/****************************************************************************
+ * sched/pthread/pthread_condwake.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <pthread.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/semaphore.h>
+
+#include "pthread/pthread.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_cond_wake
+ *
+ * Description:
+ *   Release up to 'count' waiters of a condition variable.  The waiters
+ *   already blocked are moved to the wait list of their mutex when it is
+ *   held, typically by the caller:  the unlock of the mutex then hands it
+ *   to them one at a time, instead of all of them waking up only to block
+ *   again on the mutex.  The condition semaphore is posted for the other
+ *   ones.
+ *
+ * Input Parameters:
+ *   cond  - The condition variable
+ *   count - The maximum number of waiters to release
+ *
+ * Returned Value:
+ *   OK (0) on success; A non-zero errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+int pthread_cond_wake(FAR pthread_cond_t *cond, int count)
+{
+  FAR struct pthread_mutex_s *mutex = cond->mutex;
+  int wcnt = atomic_read(COND_WAIT_COUNT(cond));
+  int ret = OK;
+  int n;
+
+  /* Claim the waiters to release */
+
+  do
+    {
+      n = MIN(wcnt, count);
+      if (n <= 0)
+        {
+          return OK;
+        }
+    }
+  while (!atomic_cmpxchg(COND_WAIT_COUNT(cond), &wcnt, wcnt - n));
+
+  if (mutex != NULL)
+    {
+      n -= nxsem_requeue(&cond->sem, mutex_sem(&mutex->mutex), n);
+    }
+
+  while (n-- > 0 && ret == OK)
+    {
+      ret = -nxsem_post(&cond->sem);
+    }
+
+  return ret;
+}
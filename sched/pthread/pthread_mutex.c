@@ -335,7 +335,24 @@ int pthread_mutex_restorelock(FAR struct pthread_mutex_s *mutex,
   DEBUGASSERT(mutex != NULL);
   if (mutex != NULL)
     {
-      ret = -mutex_restorelock(&mutex->mutex, breakval);
+#ifdef CONFIG_PTHREAD_COND_REQUEUE
+      /* pthread_cond_wake() may have handed the mutex over to the caller
+       * while it waited on the condition variable.
+       */
+
+      if (breakval != 0 && mutex_is_hold(&mutex->mutex))
+        {
+#  ifdef CONFIG_PTHREAD_MUTEX_TYPES
+          mutex->mutex.count = breakval;
+#  endif
+          ret = OK;
+        }
+      else
+#endif
+        {
+          ret = -mutex_restorelock(&mutex->mutex, breakval);
+        }
+
       if (ret == OK)
         {
           /* Add the mutex to the list of mutexes held by this task */
@@ -0,0 +1,233 @@
+/****************************************************************************
+ * sched/rcu/rcu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* A grace period is tracked with two reader counters.  Readers increment
+ * the counter of the current phase when they enter their outermost
+ * read-side section and decrement the same counter when they leave it.
+ * synchronize_rcu() flips the phase, so that new readers use the other
+ * counter, and then waits for the counter of the old phase to drain.  The
+ * last reader of the old phase wakes the updater up.
+ *
+ * NuttX allows a thread to block while pre-emption is disabled, so a
+ * context switch is not a quiescent state here; counting readers keeps
+ * read-side sections preemptible without relying on one.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/irq.h>
+#include <nuttx/mutex.h>
+#include <nuttx/rcu.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Serializes grace periods */
+
+static mutex_t g_rcu_lock = NXMUTEX_INITIALIZER;
+
+/* Posted by the last reader of the old phase */
+
+static sem_t g_rcu_sem = SEM_INITIALIZER(0);
+
+/* The current phase and the number of readers in each phase */
+
+static atomic_t g_rcu_phase;
+static atomic_t g_rcu_readers[2];
+
+/* Non-zero while synchronize_rcu() waits for the readers to drain */
+
+static atomic_t g_rcu_waiting;
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+/* Callbacks queued by call_rcu() and the work that runs them */
+
+static spinlock_t g_rcu_cblock = SP_UNLOCKED;
+static sq_queue_t g_rcu_callbacks;
+static struct work_s g_rcu_work;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_worker
+ *
+ * Description:
+ *   Wait for a grace period and then invoke every callback that was queued
+ *   before it started.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+static void rcu_worker(FAR void *arg)
+{
+  FAR struct rcu_head *head;
+  sq_queue_t callbacks;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_rcu_cblock);
+  sq_move(&g_rcu_callbacks, &callbacks);
+  spin_unlock_irqrestore(&g_rcu_cblock, flags);
+
+  synchronize_rcu();
+
+  while ((head = (FAR struct rcu_head *)sq_remfirst(&callbacks)) != NULL)
+    {
+      head->func(head);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rcu_read_lock
+ *
+ * Description:
+ *   Enter an RCU read-side critical section.
+ *
+ ****************************************************************************/
+
+void rcu_read_lock(void)
+{
+  FAR struct tcb_s *rtcb = this_task();
+
+  DEBUGASSERT(!up_interrupt_context() && rtcb->rcu_nesting < UINT8_MAX);
+
+  if (rtcb->rcu_nesting++ == 0)
+    {
+      int phase = atomic_read(&g_rcu_phase) & 1;
+
+      atomic_fetch_add(&g_rcu_readers[phase], 1);
+      rtcb->rcu_idx = phase;
+
+      /* Order the counter before the loads of the read-side section */
+
+      SMP_MB();
+    }
+}
+
+/****************************************************************************
+ * Name: rcu_read_unlock
+ *
+ * Description:
+ *   Leave an RCU read-side critical section.
+ *
+ ****************************************************************************/
+
+void rcu_read_unlock(void)
+{
+  FAR struct tcb_s *rtcb = this_task();
+
+  DEBUGASSERT(!up_interrupt_context() && rtcb->rcu_nesting > 0);
+
+  if (--rtcb->rcu_nesting == 0)
+    {
+      SMP_MB();
+
+      if (atomic_fetch_sub(&g_rcu_readers[rtcb->rcu_idx], 1) == 1 &&
+          atomic_read(&g_rcu_waiting) != 0)
+        {
+          nxsem_post(&g_rcu_sem);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: synchronize_rcu
+ *
+ * Description:
+ *   Wait until every RCU read-side critical section that was in progress
+ *   when this function was called has completed.
+ *
+ ****************************************************************************/
+
+void synchronize_rcu(void)
+{
+  int phase;
+
+  DEBUGASSERT(!up_interrupt_context() && this_task()->rcu_nesting == 0);
+
+  nxmutex_lock(&g_rcu_lock);
+
+  /* Send new readers to the other counter, then wait for the readers that
+   * are still counted in the old one.  Spurious posts left over from an
+   * earlier grace period only cost one more pass through the loop.
+   */
+
+  phase = atomic_fetch_add(&g_rcu_phase, 1) & 1;
+  atomic_set(&g_rcu_waiting, 1);
+
+  while (atomic_read(&g_rcu_readers[phase]) != 0)
+    {
+      nxsem_wait_uninterruptible(&g_rcu_sem);
+    }
+
+  atomic_set(&g_rcu_waiting, 0);
+  nxmutex_unlock(&g_rcu_lock);
+}
+
+/****************************************************************************
+ * Name: call_rcu
+ *
+ * Description:
+ *   Arrange for "func" to be called with "head" once a grace period has
+ *   elapsed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+void call_rcu(FAR struct rcu_head *head, rcu_callback_t func)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(head != NULL && func != NULL);
+
+  head->func = func;
+
+  flags = spin_lock_irqsave(&g_rcu_cblock);
+  sq_addlast(&head->node, &g_rcu_callbacks);
+  spin_unlock_irqrestore(&g_rcu_cblock, flags);
+
+  if (work_available(&g_rcu_work))
+    {
+      work_queue(LPWORK, &g_rcu_work, rcu_worker, NULL, 0);
+    }
+}
+#endif
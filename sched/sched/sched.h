@@ -31,6 +31,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <strings.h>
 #include <sched.h>
 
 #include <nuttx/arch.h>
@@ -53,6 +54,25 @@
  */
 
 #define list_readytorun()        (&g_readytorun)
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+#  define list_cpureadytorun(cpu) (&g_cpureadytorun[cpu])
+#else
+#  define list_cpureadytorun(cpu) list_readytorun()
+#endif
+
+/* The priority index that accompanies each ready-to-run list */
+
+#ifdef CONFIG_SCHED_PRIOBITMAP
+#  ifdef CONFIG_SMP_PERCPU_READYTORUN
+#    define index_cpureadytorun(cpu) (&g_cpureadytorun_index[cpu])
+#  else
+#    define index_cpureadytorun(cpu) (&g_readytorun_index)
+#  endif
+#endif
+
+/* Number of 32-bit words in the priority bitmap */
+
+#define PRIOINDEX_NWORDS         ((SCHED_PRIORITY_MAX + 32) / 32)
 #ifndef CONFIG_SMP
 #define list_pendingtasks()      (&g_pendingtasks)
 #endif
@@ -133,6 +153,22 @@ struct tasklist_s
   uint8_t attr;          /* List attribute flags */
 };
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+/* This structure indexes a prioritized ready-to-run list so that a TCB can
+ * be inserted or removed in constant time.  The list itself is unchanged
+ * (a dq_queue_t in descending priority order); the index records the last
+ * TCB of each priority level present in the list together with a two-level
+ * bitmap of the levels that are occupied.
+ */
+
+struct prioindex_s
+{
+  uint32_t summary;                               /* Bit n: map[n] != 0 */
+  uint32_t map[PRIOINDEX_NWORDS];                 /* Occupied priorities */
+  FAR struct tcb_s *tail[SCHED_PRIORITY_MAX + 1]; /* Last TCB per level */
+};
+#endif
+
 /* This enumeration defines smp schedule task switch rule */
 
 enum task_deliver_e
@@ -195,12 +231,35 @@ extern FAR struct tcb_s *g_assignedtasks[CONFIG_SMP_NCPUS];
 
 extern enum task_deliver_e g_delivertasks[CONFIG_SMP_NCPUS];
 
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+/* With CONFIG_SMP_PERCPU_READYTORUN, g_readytorun is not used.  Instead,
+ * each CPU owns a prioritized ready-to-run list holding the tasks that are
+ * queued to run on that CPU (tcb->cpu identifies the owning list).  Every
+ * task in g_cpureadytorun[n] is permitted to run on CPU 'n'.  Idle CPUs
+ * pull work from the other lists and a periodic balancer evens out the
+ * list lengths recorded in g_nreadytorun[].
+ */
+
+extern dq_queue_t g_cpureadytorun[CONFIG_SMP_NCPUS];
+extern uint16_t g_nreadytorun[CONFIG_SMP_NCPUS];
+#endif
+
 /* This is the list of idle tasks */
 
 extern struct tcb_s g_idletcb[CONFIG_SMP_NCPUS];
 
 #endif
 
+/* With CONFIG_SCHED_PRIOBITMAP, these index the ready-to-run list(s) */
+
+#ifdef CONFIG_SCHED_PRIOBITMAP
+#  ifdef CONFIG_SMP_PERCPU_READYTORUN
+extern struct prioindex_s g_cpureadytorun_index[CONFIG_SMP_NCPUS];
+#  else
+extern struct prioindex_s g_readytorun_index;
+#  endif
+#endif
+
 /* This is the list of all tasks that are ready-to-run, but cannot be placed
  * in the g_readytorun list because:  (1) They are higher priority than the
  * currently active task at the head of the g_readytorun list, and (2) the
@@ -384,6 +443,15 @@ clock_t nxsched_process_sporadic(FAR struct tcb_s *tcb, clock_t ticks,
 void nxsched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  nxsched_start_deadline(FAR struct tcb_s *tcb,
+                            FAR const struct sched_param *param);
+void nxsched_stop_deadline(FAR struct tcb_s *tcb);
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb);
+clock_t nxsched_process_deadline(FAR struct tcb_s *tcb, clock_t ticks,
+                                 bool noswitches);
+#endif
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void nxsched_suspend(FAR struct tcb_s *tcb);
 #endif
@@ -427,6 +495,10 @@ void nxsched_checkstackoverflow(FAR struct tcb_s *tcb);
 #ifdef CONFIG_SMP
 bool nxsched_switch_running(int cpu, bool switch_equal);
 void nxsched_process_delivered(int cpu);
+#  ifdef CONFIG_SMP_PERCPU_READYTORUN
+FAR struct tcb_s *nxsched_find_readytorun(int cpu, int sched_priority);
+void nxsched_balance_readytorun(void);
+#  endif
 #else
 #  define nxsched_select_cpu(a)     (0)
 #endif
@@ -451,6 +523,16 @@ void nxsched_switch_critmon(FAR struct tcb_s *from, FAR struct tcb_s *to);
 void nxsched_update_critmon(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+void nxsched_critmon_wakeup(FAR struct tcb_s *tcb);
+#endif
+
+#ifdef CONFIG_SCHED_ACCOUNTING
+void nxsched_switch_accounting(FAR struct tcb_s *from,
+                               FAR struct tcb_s *to);
+void nxsched_wakeup_accounting(FAR struct tcb_s *tcb);
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
 void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
                                 FAR void *caller);
@@ -463,6 +545,15 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
                               FAR void *caller);
 #endif
 
+#ifdef CONFIG_SCHED_SAMPLER
+int nxsched_sampler_start(unsigned long hz);
+int nxsched_sampler_stop(void);
+#endif
+
+#ifdef CONFIG_SCHED_BENCH
+int nxsched_bench_run(FAR const char *cmd);
+#endif
+
 /* TCB operations */
 
 bool nxsched_verify_tcb(FAR struct tcb_s *tcb);
@@ -477,6 +568,33 @@ FAR char **nxsched_get_stackargs(FAR struct tcb_s *tcb);
  * Inline functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxsched_outranks
+ *
+ * Description:
+ *   Return true if "tcb" must be queued ahead of "other" in a prioritized
+ *   list: it has a higher priority or, with CONFIG_SCHED_DEADLINE, both
+ *   are SCHED_DEADLINE threads of the same priority and "tcb" has the
+ *   earlier absolute deadline.
+ *
+ ****************************************************************************/
+
+static inline_function bool nxsched_outranks(FAR struct tcb_s *tcb,
+                                             FAR struct tcb_s *other)
+{
+#ifdef CONFIG_SCHED_DEADLINE
+  if (tcb->sched_priority == other->sched_priority &&
+      (tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE &&
+      (other->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      return !clock_compare(other->deadline->abs_deadline,
+                            tcb->deadline->abs_deadline);
+    }
+#endif
+
+  return tcb->sched_priority > other->sched_priority;
+}
+
 static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
                                                     DSEG dq_queue_t *list)
 {
@@ -494,7 +612,7 @@ static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
    */
 
   for (next = (FAR struct tcb_s *)list->head;
-       (next && sched_priority <= next->sched_priority);
+       (next && !nxsched_outranks(tcb, next));
        next = next->flink);
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
@@ -556,6 +674,162 @@ static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
   return ret;
 }
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+
+/* Return the lowest occupied priority that is greater than or equal to
+ * "priority", or -1 if no such priority is present in the index.
+ */
+
+static inline_function int
+nxsched_prioindex_ceil(FAR struct prioindex_s *index, int priority)
+{
+  int word = priority >> 5;
+  uint32_t bits;
+
+  bits = index->map[word] & (UINT32_MAX << (priority & 31));
+  if (bits == 0)
+    {
+      bits = index->summary & ~(UINT32_MAX >> (31 - word));
+      if (bits == 0)
+        {
+          return -1;
+        }
+
+      word = ffs(bits) - 1;
+      bits = index->map[word];
+    }
+
+  return (word << 5) + ffs(bits) - 1;
+}
+
+/* Record a TCB that is already linked at its proper position in an indexed
+ * list.  The TCB is the last one of its priority level unless the next TCB
+ * has the same priority.
+ */
+
+static inline_function void
+nxsched_prioindex_add(FAR struct prioindex_s *index, FAR struct tcb_s *tcb)
+{
+  uint8_t sched_priority = tcb->sched_priority;
+  FAR struct tcb_s *next = tcb->flink;
+
+  if (next == NULL || next->sched_priority != sched_priority)
+    {
+      index->tail[sched_priority] = tcb;
+    }
+
+  index->map[sched_priority >> 5] |= 1u << (sched_priority & 31);
+  index->summary |= 1u << (sched_priority >> 5);
+}
+
+/* Forget a TCB before it is unlinked from an indexed list (or before its
+ * priority is changed in place).
+ */
+
+static inline_function void
+nxsched_prioindex_remove(FAR struct prioindex_s *index,
+                         FAR struct tcb_s *tcb)
+{
+  uint8_t sched_priority = tcb->sched_priority;
+  FAR struct tcb_s *prev = tcb->blink;
+  int word;
+
+  if (index->tail[sched_priority] != tcb)
+    {
+      return;
+    }
+
+  if (prev != NULL && prev->sched_priority == sched_priority)
+    {
+      index->tail[sched_priority] = prev;
+      return;
+    }
+
+  word = sched_priority >> 5;
+  index->tail[sched_priority] = NULL;
+  index->map[word] &= ~(1u << (sched_priority & 31));
+  if (index->map[word] == 0)
+    {
+      index->summary &= ~(1u << word);
+    }
+}
+
+/* Insert a TCB in an indexed ready-to-run list.  The TCB goes after all
+ * TCBs of higher or equal priority, exactly as nxsched_add_prioritized()
+ * would place it, but without walking the list.  Returns true if the TCB
+ * was added at the head of the list.
+ */
+
+static inline_function bool
+nxsched_add_indexed(FAR struct tcb_s *tcb, DSEG dq_queue_t *list,
+                    FAR struct prioindex_s *index)
+{
+  FAR struct tcb_s *prev = NULL;
+  bool ret = false;
+  int ceil;
+
+  DEBUGASSERT(tcb->sched_priority >= SCHED_PRIORITY_MIN);
+
+  ceil = nxsched_prioindex_ceil(index, tcb->sched_priority);
+  if (ceil >= 0)
+    {
+      prev = index->tail[ceil];
+    }
+
+  if (prev == NULL)
+    {
+      dq_addfirst((FAR dq_entry_t *)tcb, list);
+      ret = true;
+    }
+  else
+    {
+      dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)tcb, list);
+    }
+
+  nxsched_prioindex_add(index, tcb);
+  return ret;
+}
+
+/* Remove a TCB from an indexed ready-to-run list */
+
+static inline_function void
+nxsched_remove_indexed(FAR struct tcb_s *tcb, DSEG dq_queue_t *list,
+                       FAR struct prioindex_s *index)
+{
+  nxsched_prioindex_remove(index, tcb);
+  dq_rem((FAR dq_entry_t *)tcb, list);
+}
+
+/* Change the priority of a TCB without moving it.  The caller guarantees
+ * that the list remains in priority order at the TCB's current position.
+ */
+
+static inline_function void
+nxsched_reprioritize_indexed(FAR struct tcb_s *tcb,
+                             FAR struct prioindex_s *index, int priority)
+{
+  nxsched_prioindex_remove(index, tcb);
+  tcb->sched_priority = (uint8_t)priority;
+  nxsched_prioindex_add(index, tcb);
+}
+
+#  define nxsched_add_rtrlist(tcb, cpu) \
+     nxsched_add_indexed(tcb, list_cpureadytorun(cpu), \
+                         index_cpureadytorun(cpu))
+#  define nxsched_remove_rtrlist(tcb, cpu) \
+     nxsched_remove_indexed(tcb, list_cpureadytorun(cpu), \
+                            index_cpureadytorun(cpu))
+#  define nxsched_reprioritize_rtrlist(tcb, cpu, priority) \
+     nxsched_reprioritize_indexed(tcb, index_cpureadytorun(cpu), priority)
+#else
+#  define nxsched_add_rtrlist(tcb, cpu) \
+     nxsched_add_prioritized(tcb, list_cpureadytorun(cpu))
+#  define nxsched_remove_rtrlist(tcb, cpu) \
+     dq_rem((FAR dq_entry_t *)(tcb), list_cpureadytorun(cpu))
+#  define nxsched_reprioritize_rtrlist(tcb, cpu, priority) \
+     ((tcb)->sched_priority = (uint8_t)(priority))
+#endif
+
 #  ifdef CONFIG_SMP
 
 /* Try to switch the head of the ready-to-run list to active on "target_cpu".
@@ -588,6 +862,72 @@ nxsched_deliver_task(int cpu, int target_cpu,
   return ret;
 }
 
+/* Add a TCB to, or remove it from, the ready-to-run list of a CPU.  Without
+ * CONFIG_SMP_PERCPU_READYTORUN there is only the single g_readytorun list
+ * and the CPU argument is ignored.
+ */
+
+#    ifdef CONFIG_SMP_PERCPU_READYTORUN
+static inline_function void nxsched_add_cpureadytorun(FAR struct tcb_s *tcb,
+                                                      int cpu)
+{
+  tcb->cpu = cpu;
+  nxsched_add_rtrlist(tcb, cpu);
+  g_nreadytorun[cpu]++;
+}
+
+static inline_function void
+nxsched_remove_cpureadytorun(FAR struct tcb_s *tcb)
+{
+  nxsched_remove_rtrlist(tcb, tcb->cpu);
+  g_nreadytorun[tcb->cpu]--;
+}
+
+/* Return the highest priority ready-to-run task that may preempt the task
+ * running on "cpu", whether it is queued locally or on another CPU.
+ */
+
+static inline_function FAR struct tcb_s *nxsched_peek_readytorun(int cpu)
+{
+  FAR struct tcb_s *tcb;
+  FAR struct tcb_s *stcb;
+
+  tcb  = (FAR struct tcb_s *)dq_peek(list_cpureadytorun(cpu));
+  stcb = nxsched_find_readytorun(cpu, tcb ? tcb->sched_priority : 0);
+
+  return stcb ? stcb : tcb;
+}
+
+/* Select the CPU with the shortest ready-to-run list that the task is
+ * permitted to run on.
+ */
+
+static inline_function int nxsched_select_queue(cpu_set_t affinity)
+{
+  uint16_t minready = UINT16_MAX;
+  int cpu = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if ((affinity & (1 << i)) != 0 && g_nreadytorun[i] < minready)
+        {
+          minready = g_nreadytorun[i];
+          cpu = i;
+        }
+    }
+
+  return cpu;
+}
+#    else
+#      define nxsched_add_cpureadytorun(tcb, cpu) \
+         nxsched_add_rtrlist(tcb, 0)
+#      define nxsched_remove_cpureadytorun(tcb) \
+         nxsched_remove_rtrlist(tcb, 0)
+#      define nxsched_peek_readytorun(cpu) \
+         ((FAR struct tcb_s *)dq_peek(list_readytorun()))
+#    endif
+
 static inline_function int nxsched_select_cpu(cpu_set_t affinity)
 {
   uint8_t minprio;
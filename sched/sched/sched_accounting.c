@@ -0,0 +1,100 @@
+/****************************************************************************
+ * sched/sched/sched_accounting.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/clock.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_switch_accounting
+ *
+ * Description:
+ *   Called when a thread is switched.  Charge the time since the last
+ *   state change of "from" as run time, and the time since the last state
+ *   change of "to" as wait time: "to" has been ready to run ever since,
+ *   either because it was preempted or because it was woken up.
+ *
+ * Input Parameters:
+ *   from - The thread that is being switched out.
+ *   to   - The thread that is being switched in.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_switch_accounting(FAR struct tcb_s *from, FAR struct tcb_s *to)
+{
+  clock_t current = perf_gettime();
+
+  from->acct_runtime += current - from->acct_start;
+  from->acct_start    = current;
+
+  /* A thread that is still ready to run was preempted */
+
+  if (from->task_state > TSTATE_TASK_INVALID &&
+      from->task_state < FIRST_BLOCKED_STATE)
+    {
+      from->acct_nivcsw++;
+    }
+  else
+    {
+      from->acct_nvcsw++;
+    }
+
+  to->acct_waittime += current - to->acct_start;
+  to->acct_start     = current;
+}
+
+/****************************************************************************
+ * Name: nxsched_wakeup_accounting
+ *
+ * Description:
+ *   Called when a blocked or newly created thread is made ready to run.
+ *   The time it spent blocked is not wait time, so restart the clock.
+ *
+ * Input Parameters:
+ *   tcb - The thread that is being made ready to run.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_wakeup_accounting(FAR struct tcb_s *tcb)
+{
+  if (tcb->task_state >= FIRST_BLOCKED_STATE &&
+      tcb->task_state <= LAST_BLOCKED_STATE)
+    {
+      tcb->acct_start = perf_gettime();
+    }
+}
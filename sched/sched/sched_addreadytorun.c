@@ -71,14 +71,34 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   FAR struct tcb_s *rtcb = this_task();
   bool ret;
 
+#ifdef CONFIG_SCHED_ACCOUNTING
+  nxsched_wakeup_accounting(btcb);
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  nxsched_critmon_wakeup(btcb);
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* A deadline task waking up from a blocked state may need a new server
+   * period before it is ordered by its absolute deadline.
+   */
+
+  if ((btcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE &&
+      btcb->task_state >= FIRST_BLOCKED_STATE &&
+      btcb->task_state <= LAST_BLOCKED_STATE)
+    {
+      nxsched_wakeup_deadline(btcb);
+    }
+#endif
+
   /* Check if pre-emption is disabled for the current running task and if
    * the new ready-to-run task would cause the current running task to be
    * preempted.  NOTE that IRQs disabled implies that pre-emption is
    * also disabled.
    */
 
-  if (nxsched_islocked_tcb(rtcb) &&
-      rtcb->sched_priority < btcb->sched_priority)
+  if (nxsched_islocked_tcb(rtcb) && nxsched_outranks(btcb, rtcb))
     {
       /* Yes.  Preemption would occur!  Add the new ready-to-run task to the
        * g_pendingtasks task list for now.
@@ -91,7 +111,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 
   /* Otherwise, add the new task to the ready-to-run task list */
 
-  else if (nxsched_add_prioritized(btcb, list_readytorun()))
+  else if (nxsched_add_rtrlist(btcb, 0))
     {
       /* The new btcb was added at the head of the ready-to-run list.  It
        * is now the new active task!
@@ -149,6 +169,9 @@ bool nxsched_switch_running(int cpu, bool switch_equal)
   FAR struct tcb_s *rtcb = current_task(cpu);
   int sched_priority = rtcb->sched_priority;
   FAR struct tcb_s *btcb;
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+  FAR struct tcb_s *stcb;
+#endif
   bool ret = false;
 
   DEBUGASSERT(cpu == this_cpu());
@@ -163,6 +186,29 @@ bool nxsched_switch_running(int cpu, bool switch_equal)
       sched_priority--;
     }
 
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+  /* Every task in this CPU's ready-to-run list is eligible to run here, so
+   * only the head of the list needs to be considered.  If some other CPU
+   * has queued a task of even higher priority that may run on this CPU,
+   * pull it over instead.
+   */
+
+  btcb = (FAR struct tcb_s *)dq_peek(list_cpureadytorun(cpu));
+  if (btcb != NULL && btcb->sched_priority > sched_priority)
+    {
+      sched_priority = btcb->sched_priority;
+    }
+  else
+    {
+      btcb = NULL;
+    }
+
+  stcb = nxsched_find_readytorun(cpu, sched_priority);
+  if (stcb != NULL)
+    {
+      btcb = stcb;
+    }
+#else
   /* If there is a task in readytorun list, which is eglible to run on this
    * CPU, and has higher priority than the current task,
    * switch the current task to that one.
@@ -181,30 +227,40 @@ bool nxsched_switch_running(int cpu, bool switch_equal)
       if (CPU_ISSET(cpu, &btcb->affinity) &&
           ((btcb->flags & TCB_FLAG_CPU_LOCKED) == 0 || btcb->cpu == cpu))
         {
-          /* Found a task, remove it from ready-to-run list */
+          break;
+        }
+    }
 
-          dq_rem((FAR struct dq_entry_s *)btcb, list_readytorun());
+  if (btcb != NULL && btcb->sched_priority <= sched_priority)
+    {
+      btcb = NULL;
+    }
+#endif
 
-          if (!is_idle_task(rtcb))
-            {
-              /* Put currently running task back to ready-to-run list */
+  if (btcb != NULL)
+    {
+      /* Found a task, remove it from ready-to-run list */
 
-              rtcb->task_state = TSTATE_TASK_READYTORUN;
-              nxsched_add_prioritized(rtcb, list_readytorun());
-            }
-          else
-            {
-              rtcb->task_state = TSTATE_TASK_ASSIGNED;
-            }
+      nxsched_remove_cpureadytorun(btcb);
 
-          g_assignedtasks[cpu] = btcb;
-          up_update_task(btcb);
+      if (!is_idle_task(rtcb))
+        {
+          /* Put currently running task back to ready-to-run list */
 
-          btcb->cpu = cpu;
-          btcb->task_state = TSTATE_TASK_RUNNING;
-          ret = true;
-          break;
+          rtcb->task_state = TSTATE_TASK_READYTORUN;
+          nxsched_add_cpureadytorun(rtcb, cpu);
         }
+      else
+        {
+          rtcb->task_state = TSTATE_TASK_ASSIGNED;
+        }
+
+      g_assignedtasks[cpu] = btcb;
+      up_update_task(btcb);
+
+      btcb->cpu = cpu;
+      btcb->task_state = TSTATE_TASK_RUNNING;
+      ret = true;
     }
 
   return ret;
@@ -218,7 +274,9 @@ bool nxsched_switch_running(int cpu, bool switch_equal)
  *   will be:
  *
  *   1. The g_readytorun list if the task is ready-to-run but not running
- *      and not assigned to a CPU.
+ *      and not assigned to a CPU.  With CONFIG_SMP_PERCPU_READYTORUN, the
+ *      ready-to-run list of the selected target CPU or, if no CPU can run
+ *      the task now, of the least loaded CPU in its affinity mask.
  *   2. The g_assignedtask[cpu] list if the task is running or if has been
  *      assigned to a CPU.
  *
@@ -251,12 +309,26 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   int target_cpu = btcb->flags & TCB_FLAG_CPU_LOCKED ? btcb->cpu :
     nxsched_select_cpu(btcb->affinity);
 
+#ifdef CONFIG_SCHED_ACCOUNTING
+  nxsched_wakeup_accounting(btcb);
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  nxsched_critmon_wakeup(btcb);
+#endif
+
   /* Add the btcb to the ready to run list, and try to run it on the target
    * CPU
    */
 
   btcb->task_state = TSTATE_TASK_READYTORUN;
-  nxsched_add_prioritized(btcb, list_readytorun());
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+  nxsched_add_cpureadytorun(btcb, target_cpu < CONFIG_SMP_NCPUS ?
+                            target_cpu :
+                            nxsched_select_queue(btcb->affinity));
+#else
+  nxsched_add_cpureadytorun(btcb, target_cpu);
+#endif
 
   if (target_cpu < CONFIG_SMP_NCPUS)
     {
@@ -0,0 +1,204 @@
+/****************************************************************************
+ * sched/sched/sched_balance.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+
+#include "irq/irq.h"
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP_BALANCE_INTERVAL) && CONFIG_SMP_BALANCE_INTERVAL > 0
+/* Ticks remaining until the next balancing pass */
+
+static int g_balance_ticks = CONFIG_SMP_BALANCE_INTERVAL;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_can_migrate
+ *
+ * Description:
+ *   Return true if a task queued on another CPU may be moved to "cpu".
+ *   Tasks locked to a CPU (TCB_FLAG_CPU_LOCKED) never migrate.
+ *
+ ****************************************************************************/
+
+static inline bool nxsched_can_migrate(FAR struct tcb_s *tcb, int cpu)
+{
+  return CPU_ISSET(cpu, &tcb->affinity) &&
+         (tcb->flags & TCB_FLAG_CPU_LOCKED) == 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_find_readytorun
+ *
+ * Description:
+ *   Search the ready-to-run lists of all other CPUs for the highest
+ *   priority task that is permitted to run on "cpu" and whose priority is
+ *   greater than "sched_priority".  This is how an idle (or lightly
+ *   loaded) CPU pulls work from its busier peers.  The task is not removed
+ *   from its list.
+ *
+ * Input Parameters:
+ *   cpu            - The CPU that wants to run the task
+ *   sched_priority - Only tasks with a higher priority are considered
+ *
+ * Returned Value:
+ *   The TCB of the task found, or NULL if there is none.
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_find_readytorun(int cpu, int sched_priority)
+{
+  FAR struct tcb_s *found = NULL;
+  FAR struct tcb_s *tcb;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (i == cpu)
+        {
+          continue;
+        }
+
+      /* The lists are prioritized, so stop at the first task that does not
+       * beat the best candidate found so far.
+       */
+
+      for (tcb = (FAR struct tcb_s *)dq_peek(list_cpureadytorun(i));
+           tcb != NULL && tcb->sched_priority > sched_priority;
+           tcb = tcb->flink)
+        {
+          if (nxsched_can_migrate(tcb, cpu))
+            {
+              sched_priority = tcb->sched_priority;
+              found = tcb;
+              break;
+            }
+        }
+    }
+
+  return found;
+}
+
+/****************************************************************************
+ * Name: nxsched_balance_readytorun
+ *
+ * Description:
+ *   Called from the timer tick.  Every CONFIG_SMP_BALANCE_INTERVAL ticks,
+ *   move one task from the longest per-CPU ready-to-run list to the
+ *   shortest one, if the imbalance is more than one task and the affinity
+ *   mask of a queued task permits it.  The lowest priority eligible task
+ *   is moved since it is the one that would wait the longest.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP_BALANCE_INTERVAL) && CONFIG_SMP_BALANCE_INTERVAL > 0
+void nxsched_balance_readytorun(void)
+{
+  FAR struct tcb_s *rtcb;
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  int busiest = 0;
+  int idlest = 0;
+  int i;
+
+  if (--g_balance_ticks > 0)
+    {
+      return;
+    }
+
+  g_balance_ticks = CONFIG_SMP_BALANCE_INTERVAL;
+
+  flags = enter_critical_section();
+
+  for (i = 1; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (g_nreadytorun[i] > g_nreadytorun[busiest])
+        {
+          busiest = i;
+        }
+
+      if (g_nreadytorun[i] < g_nreadytorun[idlest])
+        {
+          idlest = i;
+        }
+    }
+
+  if (g_nreadytorun[busiest] - g_nreadytorun[idlest] > 1)
+    {
+      for (tcb = (FAR struct tcb_s *)dq_tail(list_cpureadytorun(busiest));
+           tcb != NULL; tcb = tcb->blink)
+        {
+          if (nxsched_can_migrate(tcb, idlest))
+            {
+              break;
+            }
+        }
+
+      if (tcb != NULL)
+        {
+          nxsched_remove_cpureadytorun(tcb);
+          nxsched_add_cpureadytorun(tcb, idlest);
+
+          /* Preempt the task running on the target CPU if needed */
+
+          rtcb = this_task();
+          if (current_task(idlest)->sched_priority < tcb->sched_priority &&
+              nxsched_deliver_task(this_cpu(), idlest, SWITCH_HIGHER))
+            {
+              up_switch_context(this_task(), rtcb);
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+}
+#endif
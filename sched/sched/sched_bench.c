@@ -0,0 +1,1449 @@
+/****************************************************************************
+ * sched/sched/sched_bench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mqueue.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_NOPS        10000  /* Default number of operations */
+#define BENCH_NFDS        16     /* Default number of polled descriptors */
+#define BENCH_MSGSIZE     16     /* Size of a message queue message */
+#define BENCH_CHUNK       512    /* Size of a pipe write */
+#define BENCH_NSLOTS      16     /* Live allocations per malloc thread */
+#define BENCH_LINELEN     96
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define BENCH_WORK      HPWORK
+#else
+#  define BENCH_WORK      LPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct bench_s;
+
+struct bench_thread_s
+{
+  FAR struct bench_s *bench;
+  size_t   nops;               /* Operations to do */
+  size_t   nseen;              /* Operations offered to samples[] */
+  uint32_t seed;
+  uint32_t max;                /* Longest operation in ticks */
+  clock_t  stamp;              /* Work queue: time the work ran */
+  int      index;
+  int      error;
+  uint32_t samples[CONFIG_SCHED_BENCH_NSAMPLES];
+};
+
+struct bench_test_s
+{
+  FAR const char *name;
+  FAR const char *unit;        /* Unit of the rate */
+  uint8_t nthreads;            /* Number of threads, 0 if from the command */
+  bool    local;               /* Run all threads on one CPU */
+  bool    nfds;                /* The command gives a descriptor count */
+  CODE int  (*setup)(FAR struct bench_s *bench);
+  CODE void (*entry)(FAR struct bench_thread_s *thread);
+  CODE void (*teardown)(FAR struct bench_s *bench);
+};
+
+struct bench_s
+{
+  FAR const struct bench_test_s *test;
+  size_t   nops;
+  uint64_t bytes;              /* Pipe: bytes transferred */
+  int      nthreads;
+  int      nfds;
+  bool     ready;              /* The test specific setup was done */
+  bool     abort;
+  sem_t    start;
+  sem_t    done;
+  sem_t    ping[2];            /* Ping-pong and work queue handshakes */
+  mutex_t  mutex;
+#ifndef CONFIG_DISABLE_MQUEUE
+  struct file mq[2];
+#endif
+#if defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
+  struct file pipe[2];
+#endif
+  FAR struct bench_thread_s *thread[CONFIG_SCHED_BENCH_NTHREADS];
+};
+
+/* The result of one run */
+
+struct bench_result_s
+{
+  char     name[24];           /* Test and its parameter */
+  FAR const char *unit;        /* Unit of the rate */
+  size_t   nops;               /* Operations done */
+  uint32_t rate;               /* Operations or KiB per second */
+  uint32_t p50;                /* Median latency in nanoseconds */
+  uint32_t p99;                /* 99th percentile latency in nanoseconds */
+  uint32_t max;                /* Worst latency in nanoseconds */
+  uint8_t  nthreads;           /* Number of threads */
+  uint8_t  ncpus;              /* Number of CPUs they ran on */
+};
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+/* This structure describes one open "file" */
+
+struct bench_file_s
+{
+  struct procfs_file_s base;   /* Base open file structure */
+  char line[BENCH_LINELEN];    /* Pre-allocated buffer for formatted lines */
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int  bench_sem_setup(FAR struct bench_s *bench);
+static void bench_sem_teardown(FAR struct bench_s *bench);
+static void bench_ctxsw_entry(FAR struct bench_thread_s *thread);
+static void bench_sem_entry(FAR struct bench_thread_s *thread);
+static void bench_mutex_entry(FAR struct bench_thread_s *thread);
+#ifndef CONFIG_DISABLE_MQUEUE
+static int  bench_mq_setup(FAR struct bench_s *bench);
+static void bench_mq_entry(FAR struct bench_thread_s *thread);
+static void bench_mq_teardown(FAR struct bench_s *bench);
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE
+static void bench_work_entry(FAR struct bench_thread_s *thread);
+#endif
+static void bench_wdog_entry(FAR struct bench_thread_s *thread);
+#if defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
+static int  bench_pipe_setup(FAR struct bench_s *bench);
+static void bench_pipe_entry(FAR struct bench_thread_s *thread);
+static void bench_pipe_teardown(FAR struct bench_s *bench);
+static void bench_poll_entry(FAR struct bench_thread_s *thread);
+static void bench_epoll_entry(FAR struct bench_thread_s *thread);
+#endif
+static void bench_malloc_entry(FAR struct bench_thread_s *thread);
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+static int     bench_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode);
+static int     bench_close(FAR struct file *filep);
+static ssize_t bench_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen);
+static ssize_t bench_write(FAR struct file *filep, FAR const char *buffer,
+                           size_t buflen);
+static int     bench_dup(FAR const struct file *oldp,
+                         FAR struct file *newp);
+static int     bench_stat(FAR const char *relpath, FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct bench_test_s g_bench_tests[] =
+{
+  {
+    "ctxsw", "ops/s", 2, true, false,
+    bench_sem_setup, bench_ctxsw_entry, bench_sem_teardown
+  },
+  {
+    "sem", "ops/s", 2, false, false,
+    bench_sem_setup, bench_sem_entry, bench_sem_teardown
+  },
+  {
+    "mutex", "ops/s", 0, false, false,
+    bench_sem_setup, bench_mutex_entry, bench_sem_teardown
+  },
+#ifndef CONFIG_DISABLE_MQUEUE
+  {
+    "mq", "ops/s", 2, false, false,
+    bench_mq_setup, bench_mq_entry, bench_mq_teardown
+  },
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE
+  {
+    "work", "ops/s", 1, false, false,
+    bench_sem_setup, bench_work_entry, bench_sem_teardown
+  },
+#endif
+  {
+    "wdog", "ops/s", 1, false, false,
+    NULL, bench_wdog_entry, NULL
+  },
+#if defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
+  {
+    "pipe", "KiB/s", 2, false, false,
+    bench_pipe_setup, bench_pipe_entry, bench_pipe_teardown
+  },
+  {
+    "poll", "ops/s", 1, false, true,
+    NULL, bench_poll_entry, NULL
+  },
+  {
+    "epoll", "ops/s", 1, false, true,
+    NULL, bench_epoll_entry, NULL
+  },
+#endif
+  {
+    "malloc", "ops/s", 0, false, false,
+    NULL, bench_malloc_entry, NULL
+  }
+};
+
+/* Serializes the runs and protects the results */
+
+static mutex_t g_bench_lock = NXMUTEX_INITIALIZER;
+
+/* The run in progress */
+
+static FAR struct bench_s *g_bench;
+
+/* The results of the last runs, g_bench_count counts all of them */
+
+static struct bench_result_s g_bench_results[CONFIG_SCHED_BENCH_NRESULTS];
+static unsigned int g_bench_count;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+/* See fs_procfs.c -- this structure is explicitly extern'ed there. */
+
+const struct procfs_operations g_schedbench_operations =
+{
+  bench_open,     /* open */
+  bench_close,    /* close */
+  bench_read,     /* read */
+  bench_write,    /* write */
+  NULL,           /* poll */
+
+  bench_dup,      /* dup */
+
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+
+  bench_stat      /* stat */
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t bench_rand(FAR struct bench_thread_s *thread)
+{
+  uint32_t x = thread->seed;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return thread->seed = x;
+}
+
+/****************************************************************************
+ * Name: bench_record
+ *
+ * Description:
+ *   Account one operation that took "ticks".  The latencies are sampled
+ *   uniformly (reservoir sampling) so any number of operations fits.
+ *
+ ****************************************************************************/
+
+static void bench_record(FAR struct bench_thread_s *thread, clock_t ticks)
+{
+  uint32_t sample = ticks > UINT32_MAX ? UINT32_MAX : (uint32_t)ticks;
+  size_t i = thread->nseen++;
+
+  if (sample > thread->max)
+    {
+      thread->max = sample;
+    }
+
+  if (i >= CONFIG_SCHED_BENCH_NSAMPLES)
+    {
+      i = bench_rand(thread) % thread->nseen;
+    }
+
+  if (i < CONFIG_SCHED_BENCH_NSAMPLES)
+    {
+      thread->samples[i] = sample;
+    }
+}
+
+/****************************************************************************
+ * Name: bench_sem_setup
+ *
+ * Description:
+ *   The semaphores shared by the ping-pong tests and the work queue test,
+ *   and the mutex of the mutex test.
+ *
+ ****************************************************************************/
+
+static int bench_sem_setup(FAR struct bench_s *bench)
+{
+  nxsem_init(&bench->ping[0], 0, 0);
+  nxsem_init(&bench->ping[1], 0, 0);
+  nxmutex_init(&bench->mutex);
+  return OK;
+}
+
+static void bench_sem_teardown(FAR struct bench_s *bench)
+{
+  nxsem_destroy(&bench->ping[0]);
+  nxsem_destroy(&bench->ping[1]);
+  nxmutex_destroy(&bench->mutex);
+}
+
+/****************************************************************************
+ * Name: bench_pingpong
+ *
+ * Description:
+ *   Thread 0 posts thread 1 and waits for the answer; the round trip is
+ *   recorded, divided by 2^shift.
+ *
+ ****************************************************************************/
+
+static void bench_pingpong(FAR struct bench_thread_s *thread, int shift)
+{
+  FAR struct bench_s *bench = thread->bench;
+  clock_t start;
+  size_t i;
+
+  for (i = 0; i < thread->nops; i++)
+    {
+      if (thread->index == 0)
+        {
+          start = perf_gettime();
+          nxsem_post(&bench->ping[1]);
+          nxsem_wait_uninterruptible(&bench->ping[0]);
+          bench_record(thread, (perf_gettime() - start) >> shift);
+        }
+      else
+        {
+          nxsem_wait_uninterruptible(&bench->ping[1]);
+          nxsem_post(&bench->ping[0]);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: bench_ctxsw_entry
+ *
+ * Description:
+ *   Both threads run on the same CPU with the same priority, so each
+ *   round trip is two context switches.
+ *
+ ****************************************************************************/
+
+static void bench_ctxsw_entry(FAR struct bench_thread_s *thread)
+{
+  bench_pingpong(thread, 1);
+}
+
+static void bench_sem_entry(FAR struct bench_thread_s *thread)
+{
+  bench_pingpong(thread, 0);
+}
+
+/****************************************************************************
+ * Name: bench_mutex_entry
+ *
+ * Description:
+ *   All the threads lock and unlock the same mutex.
+ *
+ ****************************************************************************/
+
+static void bench_mutex_entry(FAR struct bench_thread_s *thread)
+{
+  FAR struct bench_s *bench = thread->bench;
+  clock_t start;
+  size_t i;
+
+  for (i = 0; i < thread->nops; i++)
+    {
+      start = perf_gettime();
+      nxmutex_lock(&bench->mutex);
+      nxmutex_unlock(&bench->mutex);
+      bench_record(thread, perf_gettime() - start);
+    }
+}
+
+#ifndef CONFIG_DISABLE_MQUEUE
+/****************************************************************************
+ * Name: bench_mq_setup
+ *
+ * Description:
+ *   Create two anonymous message queues, one in each direction.
+ *
+ ****************************************************************************/
+
+static int bench_mq_setup(FAR struct bench_s *bench)
+{
+  struct mq_attr attr;
+  char name[16];
+  int ret;
+  int i;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.mq_maxmsg  = 1;
+  attr.mq_msgsize = BENCH_MSGSIZE;
+
+  for (i = 0; i < 2; i++)
+    {
+      snprintf(name, sizeof(name), "schedbench%d", i);
+      ret = file_mq_open(&bench->mq[i], name, O_RDWR | O_CREAT | O_EXCL,
+                         0666, &attr);
+      if (ret < 0)
+        {
+          if (i > 0)
+            {
+              file_mq_close(&bench->mq[0]);
+            }
+
+          return ret;
+        }
+
+      file_mq_unlink(name);
+    }
+
+  return OK;
+}
+
+static void bench_mq_entry(FAR struct bench_thread_s *thread)
+{
+  FAR struct bench_s *bench = thread->bench;
+  char msg[BENCH_MSGSIZE];
+  clock_t start;
+  size_t i;
+
+  memset(msg, 0, sizeof(msg));
+  for (i = 0; i < thread->nops && thread->error >= 0; i++)
+    {
+      if (thread->index == 0)
+        {
+          start = perf_gettime();
+          thread->error = file_mq_send(&bench->mq[1], msg, sizeof(msg), 0);
+          if (thread->error >= 0)
+            {
+              thread->error = file_mq_receive(&bench->mq[0], msg,
+                                              sizeof(msg), NULL);
+            }
+
+          bench_record(thread, perf_gettime() - start);
+        }
+      else
+        {
+          thread->error = file_mq_receive(&bench->mq[1], msg, sizeof(msg),
+                                          NULL);
+          if (thread->error >= 0)
+            {
+              thread->error = file_mq_send(&bench->mq[0], msg, sizeof(msg),
+                                           0);
+            }
+        }
+    }
+}
+
+static void bench_mq_teardown(FAR struct bench_s *bench)
+{
+  file_mq_close(&bench->mq[0]);
+  file_mq_close(&bench->mq[1]);
+}
+#endif
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+/****************************************************************************
+ * Name: bench_work_entry
+ *
+ * Description:
+ *   Measure the time from work_queue() until the worker runs.
+ *
+ ****************************************************************************/
+
+static void bench_work_worker(FAR void *arg)
+{
+  FAR struct bench_thread_s *thread = arg;
+
+  thread->stamp = perf_gettime();
+  nxsem_post(&thread->bench->ping[0]);
+}
+
+static void bench_work_entry(FAR struct bench_thread_s *thread)
+{
+  FAR struct bench_s *bench = thread->bench;
+  struct work_s work;
+  clock_t start;
+  size_t i;
+
+  memset(&work, 0, sizeof(work));
+  for (i = 0; i < thread->nops && thread->error >= 0; i++)
+    {
+      start = perf_gettime();
+      thread->error = work_queue(BENCH_WORK, &work, bench_work_worker,
+                                 thread, 0);
+      if (thread->error >= 0)
+        {
+          nxsem_wait_uninterruptible(&bench->ping[0]);
+          bench_record(thread, thread->stamp - start);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_wdog_entry
+ *
+ * Description:
+ *   Measure a wd_start() and wd_cancel() pair on a timer that never
+ *   expires.
+ *
+ ****************************************************************************/
+
+static void bench_wdog_handler(wdparm_t arg)
+{
+}
+
+static void bench_wdog_entry(FAR struct bench_thread_s *thread)
+{
+  struct wdog_s wdog;
+  clock_t start;
+  size_t i;
+
+  memset(&wdog, 0, sizeof(wdog));
+  for (i = 0; i < thread->nops; i++)
+    {
+      start = perf_gettime();
+      wd_start(&wdog, SEC2TICK(3600), bench_wdog_handler, 0);
+      wd_cancel(&wdog);
+      bench_record(thread, perf_gettime() - start);
+    }
+}
+
+#if defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
+/****************************************************************************
+ * Name: bench_pipe_setup
+ ****************************************************************************/
+
+static int bench_pipe_setup(FAR struct bench_s *bench)
+{
+  FAR struct file *filep[2];
+
+  filep[0] = &bench->pipe[0];
+  filep[1] = &bench->pipe[1];
+  return file_pipe(filep, CONFIG_DEV_PIPE_SIZE, 0);
+}
+
+/****************************************************************************
+ * Name: bench_pipe_entry
+ *
+ * Description:
+ *   Thread 0 writes chunks into the pipe and thread 1 drains it.  The
+ *   latency of each write is recorded.
+ *
+ ****************************************************************************/
+
+static void bench_pipe_entry(FAR struct bench_thread_s *thread)
+{
+  FAR struct bench_s *bench = thread->bench;
+  uint8_t buf[BENCH_CHUNK];
+  uint64_t total = (uint64_t)thread->nops * BENCH_CHUNK;
+  uint64_t done = 0;
+  clock_t start;
+  ssize_t nbytes;
+
+  memset(buf, 0xa5, sizeof(buf));
+  while (done < total)
+    {
+      if (thread->index == 0)
+        {
+          start  = perf_gettime();
+          nbytes = file_write(&bench->pipe[1], buf, sizeof(buf));
+          bench_record(thread, perf_gettime() - start);
+        }
+      else
+        {
+          nbytes = file_read(&bench->pipe[0], buf,
+                             MIN(sizeof(buf), total - done));
+        }
+
+      if (nbytes <= 0)
+        {
+          thread->error = nbytes < 0 ? nbytes : -EPIPE;
+          break;
+        }
+
+      done += nbytes;
+    }
+
+  if (thread->index == 1)
+    {
+      bench->bytes = done;
+    }
+}
+
+static void bench_pipe_teardown(FAR struct bench_s *bench)
+{
+  file_close(&bench->pipe[0]);
+  file_close(&bench->pipe[1]);
+}
+
+/****************************************************************************
+ * Name: bench_openfds
+ *
+ * Description:
+ *   Open "nfds" pipes in the calling thread and make the read end of the
+ *   last one readable, so a poll finds exactly one ready descriptor at the
+ *   far end of the set.
+ *
+ ****************************************************************************/
+
+static FAR int *bench_openfds(FAR struct bench_thread_s *thread)
+{
+  int nfds = thread->bench->nfds;
+  FAR int *fds;
+  int i;
+
+  fds = kmm_malloc(2 * nfds * sizeof(int));
+  if (fds == NULL)
+    {
+      thread->error = -ENOMEM;
+      return NULL;
+    }
+
+  for (i = 0; i < nfds; i++)
+    {
+      thread->error = pipe2(&fds[2 * i], O_CLOEXEC);
+      if (thread->error < 0)
+        {
+          thread->error = -get_errno();
+          break;
+        }
+    }
+
+  if (thread->error >= 0 && nx_write(fds[2 * nfds - 1], "", 1) != 1)
+    {
+      thread->error = -EIO;
+    }
+
+  if (thread->error < 0)
+    {
+      while (--i >= 0)
+        {
+          nx_close(fds[2 * i]);
+          nx_close(fds[2 * i + 1]);
+        }
+
+      kmm_free(fds);
+      return NULL;
+    }
+
+  return fds;
+}
+
+static void bench_closefds(FAR struct bench_thread_s *thread, FAR int *fds)
+{
+  int i;
+
+  for (i = 0; i < 2 * thread->bench->nfds; i++)
+    {
+      nx_close(fds[i]);
+    }
+
+  kmm_free(fds);
+}
+
+/****************************************************************************
+ * Name: bench_poll_entry
+ *
+ * Description:
+ *   Measure a non-blocking poll() over all the descriptors.
+ *
+ ****************************************************************************/
+
+static void bench_poll_entry(FAR struct bench_thread_s *thread)
+{
+  int nfds = thread->bench->nfds;
+  FAR struct pollfd *pfds;
+  clock_t start;
+  FAR int *fds;
+  size_t i;
+  int ret;
+  int j;
+
+  fds = bench_openfds(thread);
+  if (fds == NULL)
+    {
+      return;
+    }
+
+  pfds = kmm_zalloc(nfds * sizeof(struct pollfd));
+  if (pfds == NULL)
+    {
+      thread->error = -ENOMEM;
+      goto out;
+    }
+
+  for (j = 0; j < nfds; j++)
+    {
+      pfds[j].fd     = fds[2 * j];
+      pfds[j].events = POLLIN;
+    }
+
+  for (i = 0; i < thread->nops; i++)
+    {
+      start = perf_gettime();
+      ret   = poll(pfds, nfds, 0);
+      bench_record(thread, perf_gettime() - start);
+
+      if (ret != 1)
+        {
+          thread->error = ret < 0 ? -get_errno() : -EIO;
+          break;
+        }
+    }
+
+  kmm_free(pfds);
+
+out:
+  bench_closefds(thread, fds);
+}
+
+/****************************************************************************
+ * Name: bench_epoll_entry
+ *
+ * Description:
+ *   Measure a non-blocking epoll_wait() on an epoll set holding all the
+ *   descriptors.
+ *
+ ****************************************************************************/
+
+static void bench_epoll_entry(FAR struct bench_thread_s *thread)
+{
+  int nfds = thread->bench->nfds;
+  struct epoll_event ev;
+  clock_t start;
+  FAR int *fds;
+  size_t i;
+  int epfd;
+  int ret;
+  int j;
+
+  fds = bench_openfds(thread);
+  if (fds == NULL)
+    {
+      return;
+    }
+
+  epfd = epoll_create1(EPOLL_CLOEXEC);
+  if (epfd < 0)
+    {
+      thread->error = -get_errno();
+      goto out;
+    }
+
+  for (j = 0; j < nfds; j++)
+    {
+      memset(&ev, 0, sizeof(ev));
+      ev.events  = EPOLLIN;
+      ev.data.fd = fds[2 * j];
+      if (epoll_ctl(epfd, EPOLL_CTL_ADD, fds[2 * j], &ev) < 0)
+        {
+          thread->error = -get_errno();
+          goto out_with_epfd;
+        }
+    }
+
+  for (i = 0; i < thread->nops; i++)
+    {
+      start = perf_gettime();
+      ret   = epoll_wait(epfd, &ev, 1, 0);
+      bench_record(thread, perf_gettime() - start);
+
+      if (ret != 1)
+        {
+          thread->error = ret < 0 ? -get_errno() : -EIO;
+          break;
+        }
+    }
+
+out_with_epfd:
+  nx_close(epfd);
+
+out:
+  bench_closefds(thread, fds);
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_malloc_entry
+ *
+ * Description:
+ *   Pick a random slot and fill it from the kernel heap if it is empty,
+ *   free it otherwise.  Unlike the allocator benchmark this uses the live
+ *   kernel heap, so threads on other CPUs contend for its lock.
+ *
+ ****************************************************************************/
+
+static void bench_malloc_entry(FAR struct bench_thread_s *thread)
+{
+  FAR void *slots[BENCH_NSLOTS];
+  FAR void **slot;
+  clock_t start;
+  size_t i;
+
+  memset(slots, 0, sizeof(slots));
+  for (i = 0; i < thread->nops; i++)
+    {
+      slot  = &slots[bench_rand(thread) % BENCH_NSLOTS];
+      start = perf_gettime();
+      if (*slot == NULL)
+        {
+          *slot = kmm_malloc(16 + bench_rand(thread) % 1009);
+        }
+      else
+        {
+          kmm_free(*slot);
+          *slot = NULL;
+        }
+
+      bench_record(thread, perf_gettime() - start);
+    }
+
+  for (i = 0; i < BENCH_NSLOTS; i++)
+    {
+      kmm_free(slots[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: bench_entry
+ *
+ * Description:
+ *   The benchmark threads.  argv[1] is the index of the thread.
+ *
+ ****************************************************************************/
+
+static int bench_entry(int argc, FAR char *argv[])
+{
+  FAR struct bench_s *bench = g_bench;
+  FAR struct bench_thread_s *thread = bench->thread[atoi(argv[1])];
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+
+  CPU_ZERO(&cpuset);
+  CPU_SET(bench->test->local ? 0 : thread->index % CONFIG_SMP_NCPUS,
+          &cpuset);
+  nxsched_set_affinity(0, sizeof(cpuset), &cpuset);
+#endif
+
+  nxsem_wait_uninterruptible(&bench->start);
+  if (!bench->abort)
+    {
+      bench->test->entry(thread);
+    }
+
+  nxsem_post(&bench->done);
+  return 0;
+}
+
+static int bench_compare(FAR const void *a, FAR const void *b)
+{
+  uint32_t x = *(FAR const uint32_t *)a;
+  uint32_t y = *(FAR const uint32_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+static uint64_t bench_nsec(uint64_t ticks)
+{
+  unsigned long freq = perf_getfreq();
+
+  return ticks / freq * NSEC_PER_SEC +
+         ticks % freq * NSEC_PER_SEC / freq;
+}
+
+static uint32_t bench_nsec32(uint64_t ticks)
+{
+  return MIN(bench_nsec(ticks), UINT32_MAX);
+}
+
+/****************************************************************************
+ * Name: bench_report
+ *
+ * Description:
+ *   Merge the statistics of the threads into a new result.  The rate is
+ *   taken over the wall time of the whole run.
+ *
+ ****************************************************************************/
+
+static void bench_report(FAR struct bench_s *bench, clock_t elapsed)
+{
+  FAR struct bench_result_s *result;
+  FAR uint32_t *samples;
+  uint64_t nsec = bench_nsec(elapsed);
+  uint64_t count;
+  uint32_t max = 0;
+  size_t nsamples = 0;
+  size_t n;
+  int i;
+
+  result = &g_bench_results[g_bench_count++ % CONFIG_SCHED_BENCH_NRESULTS];
+  memset(result, 0, sizeof(*result));
+
+  if (bench->test->nfds)
+    {
+      snprintf(result->name, sizeof(result->name), "%s/%d",
+               bench->test->name, bench->nfds);
+    }
+  else
+    {
+      strlcpy(result->name, bench->test->name, sizeof(result->name));
+    }
+
+  samples = kmm_malloc(bench->nthreads * CONFIG_SCHED_BENCH_NSAMPLES *
+                       sizeof(uint32_t));
+
+  for (i = 0; i < bench->nthreads; i++)
+    {
+      FAR struct bench_thread_s *thread = bench->thread[i];
+
+      n = MIN(thread->nseen, CONFIG_SCHED_BENCH_NSAMPLES);
+      if (samples != NULL)
+        {
+          memcpy(samples + nsamples, thread->samples, n * sizeof(uint32_t));
+          nsamples += n;
+        }
+
+      result->nops += thread->nseen;
+      max           = MAX(max, thread->max);
+    }
+
+  if (nsamples > 0)
+    {
+      qsort(samples, nsamples, sizeof(uint32_t), bench_compare);
+      result->p50 = bench_nsec32(samples[nsamples / 2]);
+      result->p99 = bench_nsec32(samples[nsamples * 99 / 100]);
+    }
+
+  kmm_free(samples);
+
+  count = bench->bytes > 0 ? bench->bytes / 1024 : result->nops;
+  if (nsec > 0)
+    {
+      result->rate = MIN(count * NSEC_PER_SEC / nsec, UINT32_MAX);
+    }
+
+  result->unit     = bench->test->unit;
+  result->nthreads = bench->nthreads;
+  result->ncpus    = bench->test->local ? 1 :
+                     MIN(bench->nthreads, CONFIG_SMP_NCPUS);
+  result->max      = bench_nsec32(max);
+}
+
+/****************************************************************************
+ * Name: bench_parse
+ *
+ * Description:
+ *   Parse "<test> [nops [nthreads|nfds]]".
+ *
+ ****************************************************************************/
+
+static int bench_parse(FAR struct bench_s *bench, FAR char *cmd)
+{
+  FAR char *argv[3] =
+    {
+      NULL
+    };
+
+  FAR const struct bench_test_s *test = NULL;
+  FAR char *save;
+  int argc;
+  int arg;
+  int i;
+
+  for (argc = 0; argc < 3; argc++)
+    {
+      argv[argc] = strtok_r(argc == 0 ? cmd : NULL, " \t\n", &save);
+      if (argv[argc] == NULL)
+        {
+          break;
+        }
+    }
+
+  if (argc < 1)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < (int)nitems(g_bench_tests); i++)
+    {
+      if (strcmp(argv[0], g_bench_tests[i].name) == 0)
+        {
+          test = &g_bench_tests[i];
+          break;
+        }
+    }
+
+  if (test == NULL)
+    {
+      return -ENOENT;
+    }
+
+  bench->test     = test;
+  bench->nops     = argc > 1 ? strtoul(argv[1], NULL, 0) : BENCH_NOPS;
+  arg             = argc > 2 ? atoi(argv[2]) : 0;
+  bench->nthreads = test->nthreads;
+
+  if (test->nfds)
+    {
+      bench->nfds = arg > 0 ? arg : BENCH_NFDS;
+    }
+  else if (test->nthreads == 0)
+    {
+      bench->nthreads = arg > 0 ? arg : 1;
+    }
+
+  if (bench->nops == 0 || bench->nthreads > CONFIG_SCHED_BENCH_NTHREADS)
+    {
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_setup
+ *
+ * Description:
+ *   Create the state of the threads.  The ping-pong peers and the pipe
+ *   reader do as many operations as thread 0, the others share them.
+ *
+ ****************************************************************************/
+
+static int bench_setup(FAR struct bench_s *bench)
+{
+  FAR struct bench_thread_s *thread;
+  int i;
+
+  for (i = 0; i < bench->nthreads; i++)
+    {
+      thread = kmm_zalloc(sizeof(*thread));
+      if (thread == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      bench->thread[i] = thread;
+      thread->bench    = bench;
+      thread->nops     = bench->test->nthreads == 0 ?
+                         bench->nops / bench->nthreads : bench->nops;
+      thread->seed     = 2463534242u + i;
+      thread->index    = i;
+    }
+
+  if (bench->test->setup != NULL)
+    {
+      int ret = bench->test->setup(bench);
+
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  bench->ready = true;
+  return OK;
+}
+
+static void bench_teardown(FAR struct bench_s *bench)
+{
+  int i;
+
+  if (bench->ready && bench->test->teardown != NULL)
+    {
+      bench->test->teardown(bench);
+    }
+
+  for (i = 0; i < bench->nthreads; i++)
+    {
+      kmm_free(bench->thread[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: bench_result
+ *
+ * Description:
+ *   Return the result of a previous run, the oldest one kept first.
+ *
+ * Returned Value:
+ *   OK on success; -ENOENT if there is no such result.
+ *
+ ****************************************************************************/
+
+static int bench_result(int index, FAR struct bench_result_s *result)
+{
+  unsigned int count;
+  int ret;
+
+  ret = nxmutex_lock(&g_bench_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  count = MIN(g_bench_count, CONFIG_SCHED_BENCH_NRESULTS);
+  if (index < 0 || index >= count)
+    {
+      ret = -ENOENT;
+    }
+  else
+    {
+      *result = g_bench_results[(g_bench_count - count + index) %
+                                CONFIG_SCHED_BENCH_NRESULTS];
+    }
+
+  nxmutex_unlock(&g_bench_lock);
+  return ret;
+}
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+/****************************************************************************
+ * Name: bench_open
+ ****************************************************************************/
+
+static int bench_open(FAR struct file *filep, FAR const char *relpath,
+                      int oflags, mode_t mode)
+{
+  FAR struct bench_file_s *benchfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  benchfile = kmm_zalloc(sizeof(struct bench_file_s));
+  if (benchfile == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  filep->f_priv = benchfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_close
+ ****************************************************************************/
+
+static int bench_close(FAR struct file *filep)
+{
+  FAR struct bench_file_s *benchfile = filep->f_priv;
+
+  DEBUGASSERT(benchfile != NULL);
+
+  kmm_free(benchfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_read
+ *
+ * Description:
+ *   Show the results of the last runs, one line each under a header, with
+ *   fixed columns so the output of two builds can be diffed.
+ *
+ ****************************************************************************/
+
+static ssize_t bench_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct bench_file_s *benchfile = filep->f_priv;
+  struct bench_result_s result;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int i;
+
+  DEBUGASSERT(benchfile != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  linesize  = procfs_snprintf(benchfile->line, BENCH_LINELEN,
+                              "%-12s%4s%4s%10s%11s%6s%9s%9s%9s\n",
+                              "name", "thr", "cpu", "ops", "rate", "unit",
+                              "p50(ns)", "p99(ns)", "max(ns)");
+  copysize  = procfs_memcpy(benchfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  for (i = 0; buflen > 0 && bench_result(i, &result) >= 0; i++)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(benchfile->line, BENCH_LINELEN,
+                                   "%-12s%4u%4u%10zu%11" PRIu32 "%6s"
+                                   "%9" PRIu32 "%9" PRIu32 "%9" PRIu32
+                                   "\n",
+                                   result.name, result.nthreads,
+                                   result.ncpus, result.nops, result.rate,
+                                   result.unit, result.p50, result.p99,
+                                   result.max);
+      copysize   = procfs_memcpy(benchfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: bench_write
+ *
+ * Description:
+ *   Run one benchmark, see nxsched_bench_run() for the syntax, e.g.
+ *   "echo sem 100000 > /proc/schedbench".
+ *
+ ****************************************************************************/
+
+static ssize_t bench_write(FAR struct file *filep, FAR const char *buffer,
+                           size_t buflen)
+{
+  char cmd[BENCH_LINELEN];
+  int ret;
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+
+  if (buflen >= sizeof(cmd))
+    {
+      return -E2BIG;
+    }
+
+  memcpy(cmd, buffer, buflen);
+  cmd[buflen] = '\0';
+
+  ret = nxsched_bench_run(cmd);
+  return ret < 0 ? ret : buflen;
+}
+
+/****************************************************************************
+ * Name: bench_dup
+ ****************************************************************************/
+
+static int bench_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct bench_file_s *oldattr = oldp->f_priv;
+  FAR struct bench_file_s *newattr;
+
+  DEBUGASSERT(oldattr != NULL);
+
+  newattr = kmm_malloc(sizeof(struct bench_file_s));
+  if (newattr == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldattr, sizeof(struct bench_file_s));
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_stat
+ ****************************************************************************/
+
+static int bench_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_bench_run
+ *
+ * Description:
+ *   Run one benchmark and keep its result.  "cmd" is
+ *   "<test> [nops [nthreads|nfds]]" where test is one of:
+ *
+ *     ctxsw  - Semaphore ping-pong between two threads on one CPU, half
+ *              the round trip, i.e. one context switch
+ *     sem    - Semaphore ping-pong round trip, across CPUs on SMP
+ *     mutex  - Lock and unlock of a mutex shared by nthreads threads
+ *     mq     - Message queue ping-pong round trip
+ *     work   - Latency from work_queue() until the worker runs
+ *     wdog   - A wd_start() and wd_cancel() pair
+ *     pipe   - Pipe bandwidth, latency of each write
+ *     poll   - poll() over nfds pipes with one ready
+ *     epoll  - epoll_wait() on an epoll set of nfds pipes with one ready
+ *     malloc - Kernel heap allocation and free from nthreads threads
+ *
+ *   The threads are spread over the CPUs.  "clear" discards the results.
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxsched_bench_run(FAR const char *cmd)
+{
+  struct bench_s bench;
+  FAR char *argv[2];
+  char index[8];
+  FAR char *copy;
+  clock_t start;
+  int ret;
+  int n;
+  int i;
+
+  copy = kmm_malloc(strlen(cmd) + 1);
+  if (copy == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  strcpy(copy, cmd);
+
+  ret = nxmutex_lock(&g_bench_lock);
+  if (ret < 0)
+    {
+      kmm_free(copy);
+      return ret;
+    }
+
+  if (strncmp(copy, "clear", 5) == 0)
+    {
+      g_bench_count = 0;
+      goto out;
+    }
+
+  memset(&bench, 0, sizeof(bench));
+  ret = bench_parse(&bench, copy);
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  nxsem_init(&bench.start, 0, 0);
+  nxsem_init(&bench.done, 0, 0);
+  g_bench = &bench;
+
+  ret = bench_setup(&bench);
+  for (n = 0; ret >= 0 && n < bench.nthreads; )
+    {
+      snprintf(index, sizeof(index), "%d", n);
+      argv[0] = index;
+      argv[1] = NULL;
+
+      ret = kthread_create("sched_bench", CONFIG_SCHED_BENCH_PRIORITY,
+                           CONFIG_SCHED_BENCH_STACKSIZE, bench_entry, argv);
+      if (ret >= 0)
+        {
+          n++;
+        }
+    }
+
+  /* Start the threads all at once, or let them exit if not all of them
+   * could be created
+   */
+
+  bench.abort = ret < 0;
+  start = perf_gettime();
+  for (i = 0; i < n; i++)
+    {
+      nxsem_post(&bench.start);
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      nxsem_wait_uninterruptible(&bench.done);
+    }
+
+  if (ret >= 0)
+    {
+      for (i = 0; i < bench.nthreads && ret >= 0; i++)
+        {
+          ret = bench.thread[i]->error;
+        }
+
+      if (ret >= 0)
+        {
+          bench_report(&bench, perf_gettime() - start);
+          ret = OK;
+        }
+    }
+
+  bench_teardown(&bench);
+  nxsem_destroy(&bench.start);
+  nxsem_destroy(&bench.done);
+  g_bench = NULL;
+
+out:
+  nxmutex_unlock(&g_bench_lock);
+  kmm_free(copy);
+  return ret;
+}
@@ -30,6 +30,7 @@
 #include <sched.h>
 #include <assert.h>
 #include <debug.h>
+#include <strings.h>
 #include <time.h>
 
 #include "sched/sched.h"
@@ -100,10 +101,46 @@ clock_t g_preemp_max[CONFIG_SMP_NCPUS];
 clock_t g_crit_max[CONFIG_SMP_NCPUS];
 #endif
 
+/* Per-CPU latency histograms */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+uint32_t g_wakeup_hist[CONFIG_SMP_NCPUS][CRITMON_HIST_NBUCKETS];
+#  if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
+uint32_t g_preemp_hist[CONFIG_SMP_NCPUS][CRITMON_HIST_NBUCKETS];
+#  endif
+#  if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0
+uint32_t g_crit_hist[CONFIG_SMP_NCPUS][CRITMON_HIST_NBUCKETS];
+#  endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxsched_critmon_hist
+ *
+ * Description:
+ *   Count one interval in the log2 bucket of a histogram.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+static inline void nxsched_critmon_hist(FAR uint32_t *hist, clock_t elapsed)
+{
+  int bucket = elapsed > 0 ? flsll(elapsed) : 0;
+
+  if (bucket >= CRITMON_HIST_NBUCKETS)
+    {
+      bucket = CRITMON_HIST_NBUCKETS - 1;
+    }
+
+  hist[bucket]++;
+}
+#else
+#  define nxsched_critmon_hist(h, e)
+#endif
+
 /****************************************************************************
  * Name: nxsched_critmon_cpuload
  *
@@ -205,6 +242,8 @@ void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
         {
           g_preemp_max[cpu] = elapsed;
         }
+
+      nxsched_critmon_hist(g_preemp_hist[cpu], elapsed);
     }
 }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0 */
@@ -257,10 +296,32 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
         {
           g_crit_max[cpu] = elapsed;
         }
+
+      nxsched_critmon_hist(g_crit_hist[cpu], elapsed);
     }
 }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
 
+/****************************************************************************
+ * Name: nxsched_critmon_wakeup
+ *
+ * Description:
+ *   Called when a blocked thread is made ready to run, the wakeup-to-run
+ *   latency is measured from here.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+void nxsched_critmon_wakeup(FAR struct tcb_s *tcb)
+{
+  if (tcb->task_state >= FIRST_BLOCKED_STATE &&
+      tcb->task_state <= LAST_BLOCKED_STATE)
+    {
+      tcb->wakeup_start = perf_gettime();
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nxsched_switch_critmon
  *
@@ -286,6 +347,17 @@ void nxsched_switch_critmon(FAR struct tcb_s *from, FAR struct tcb_s *to)
   nxsched_critmon_cpuload(from, current, tick);
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_HISTOGRAM
+  /* Was the thread woken up since it last ran? */
+
+  if (to->wakeup_start != 0)
+    {
+      nxsched_critmon_hist(g_wakeup_hist[this_cpu()],
+                           current - to->wakeup_start);
+      to->wakeup_start = 0;
+    }
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
   from->run_time += elapsed;
   to->run_time = current;
@@ -322,11 +394,13 @@ void nxsched_switch_critmon(FAR struct tcb_s *from, FAR struct tcb_s *to)
         {
           g_preemp_max[cpu] = elapsed;
         }
+
+      nxsched_critmon_hist(g_preemp_hist[cpu], elapsed);
     }
 
   if (to->lockcount > 0)
     {
-      to->premp_start = current;
+      to->preemp_start = current;
     }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION */
 
@@ -354,6 +428,8 @@ void nxsched_switch_critmon(FAR struct tcb_s *from, FAR struct tcb_s *to)
         {
           g_crit_max[cpu] = elapsed;
         }
+
+      nxsched_critmon_hist(g_crit_hist[cpu], elapsed);
     }
 
   if (to->irqcount > 0)
@@ -371,7 +447,7 @@ void nxsched_switch_critmon(FAR struct tcb_s *from, FAR struct tcb_s *to)
     {
       /* Yes.. Save the start time */
 
-      to->premp_start = current;
+      to->preemp_start = current;
     }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION */
 }
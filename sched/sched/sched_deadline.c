@@ -0,0 +1,321 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/param.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched_note.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bandwidths are expressed in parts per million */
+
+#define DEADLINE_BW_ONE       1000000
+#define DEADLINE_BW_MAX       (CONFIG_SCHED_DEADLINE_MAXBW * 10000)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Sum of the bandwidth of all SCHED_DEADLINE threads */
+
+static uint32_t g_deadline_bw;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deadline_replenish
+ *
+ * Description:
+ *   Start a new server period: refill the budget and set the absolute
+ *   deadline relative to "release".
+ *
+ ****************************************************************************/
+
+static void deadline_replenish(FAR struct tcb_s *tcb, clock_t release)
+{
+  FAR struct deadline_s *deadline = tcb->deadline;
+
+  deadline->abs_deadline = release + deadline->deadline;
+  tcb->timeslice         = deadline->runtime;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_start_deadline
+ *
+ * Description:
+ *   Validate the SCHED_DEADLINE parameters, perform the admission control
+ *   and start (or restart with new parameters) deadline scheduling of the
+ *   thread.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB of the thread
+ *   param - The new scheduling parameters
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure:
+ *
+ *   EINVAL - The parameters do not satisfy 0 < runtime <= deadline <=
+ *            period
+ *   EBUSY  - The total bandwidth would exceed CONFIG_SCHED_DEADLINE_MAXBW
+ *   ENOMEM - The deadline structure could not be allocated
+ *
+ * Assumptions:
+ *   Interrupts are disabled.  The policy bits of the TCB have not yet been
+ *   set to TCB_FLAG_SCHED_DEADLINE by the caller.
+ *
+ ****************************************************************************/
+
+int nxsched_start_deadline(FAR struct tcb_s *tcb,
+                           FAR const struct sched_param *param)
+{
+  FAR struct deadline_s *deadline = tcb->deadline;
+  sclock_t runtime;
+  sclock_t reldl;
+  sclock_t period;
+  uint32_t bandwidth;
+  uint32_t oldbw;
+
+  runtime = clock_time2ticks(&param->sched_dl_runtime);
+  reldl   = clock_time2ticks(&param->sched_dl_deadline);
+  period  = clock_time2ticks(&param->sched_dl_period);
+
+  /* A zero period means that the period equals the deadline */
+
+  if (period == 0)
+    {
+      period = reldl;
+    }
+
+  if (runtime < 1 || runtime > reldl || reldl > period)
+    {
+      return -EINVAL;
+    }
+
+  bandwidth = (uint32_t)(((uint64_t)runtime * DEADLINE_BW_ONE) / period);
+  oldbw     = deadline != NULL ? deadline->bandwidth : 0;
+
+  if (g_deadline_bw - oldbw + bandwidth > DEADLINE_BW_MAX)
+    {
+      sched_note_printf(NOTE_TAG_SCHED, "deadline %d: rejected bw=%" PRIu32,
+                        tcb->pid, bandwidth);
+      return -EBUSY;
+    }
+
+  if (deadline == NULL)
+    {
+      deadline = kmm_zalloc(sizeof(struct deadline_s));
+      if (deadline == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      tcb->deadline = deadline;
+    }
+
+  g_deadline_bw        = g_deadline_bw - oldbw + bandwidth;
+  deadline->runtime    = runtime;
+  deadline->deadline   = reldl;
+  deadline->period     = period;
+  deadline->bandwidth  = bandwidth;
+
+  deadline_replenish(tcb, clock_systime_ticks());
+
+  sched_note_printf(NOTE_TAG_SCHED, "deadline %d: start bw=%" PRIu32,
+                    tcb->pid, bandwidth);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_stop_deadline
+ *
+ * Description:
+ *   Stop deadline scheduling of the thread, release its bandwidth and free
+ *   the deadline structure.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_stop_deadline(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(tcb != NULL && tcb->deadline != NULL);
+
+  flags = enter_critical_section();
+
+  g_deadline_bw -= tcb->deadline->bandwidth;
+  kmm_free(tcb->deadline);
+  tcb->deadline  = NULL;
+  tcb->timeslice = 0;
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: nxsched_wakeup_deadline
+ *
+ * Description:
+ *   Called when a SCHED_DEADLINE thread becomes ready-to-run.  If its
+ *   deadline has passed or its remaining budget cannot be consumed before
+ *   the deadline without exceeding the reserved bandwidth, a new server
+ *   period is started now (the constant bandwidth server wake-up rule).
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *deadline = tcb->deadline;
+  clock_t now = clock_systime_ticks();
+
+  DEBUGASSERT(deadline != NULL);
+
+  /* budget / (deadline - now) > runtime / period ? */
+
+  if (clock_compare(deadline->abs_deadline, now) ||
+      (uint64_t)tcb->timeslice * deadline->period >
+      (uint64_t)(deadline->abs_deadline - now) * deadline->runtime)
+    {
+      deadline_replenish(tcb, now);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_process_deadline
+ *
+ * Description:
+ *   Charge the running SCHED_DEADLINE thread for the elapsed time.  When
+ *   its budget is exhausted, replenish it and postpone its deadline by one
+ *   period; if another deadline thread now has the earliest deadline, it
+ *   preempts this one.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the currently executing task
+ *   ticks - The number of ticks that have elapsed on the interval timer.
+ *   noswitches - True: Can't do context switches now.
+ *
+ * Returned Value:
+ *   The number if ticks remaining until the budget is exhausted.  The
+ *   value one means that the budget expired but could not be replenished
+ *   because noswitches == true.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *   - The task associated with TCB uses the deadline scheduling policy
+ *
+ ****************************************************************************/
+
+clock_t nxsched_process_deadline(FAR struct tcb_s *tcb, clock_t ticks,
+                                 bool noswitches)
+{
+  FAR struct deadline_s *deadline = tcb->deadline;
+  clock_t ret;
+
+  DEBUGASSERT(deadline != NULL);
+
+  tcb->timeslice -= MIN(tcb->timeslice, ticks);
+
+  ret = tcb->timeslice;
+  if (tcb->timeslice <= 0)
+    {
+      if (nxsched_islocked_tcb(tcb))
+        {
+          /* The overrun is handled by sched_unlock() */
+
+          ret = CLOCK_MAX;
+        }
+      else if (noswitches)
+        {
+          ret = 1;
+        }
+      else
+        {
+          sched_note_printf(NOTE_TAG_SCHED, "deadline %d: overrun",
+                            tcb->pid);
+
+          /* Postpone the deadline by one period with a full budget */
+
+          deadline->abs_deadline += deadline->period;
+          tcb->timeslice          = deadline->runtime;
+          ret                     = tcb->timeslice;
+
+          /* Requeue the task behind any deadline thread with an earlier
+           * deadline now.
+           */
+
+          if (tcb->flink && nxsched_outranks(tcb->flink, tcb))
+            {
+              FAR struct tcb_s *rtcb = this_task();
+
+              if (nxsched_reprioritize_rtr(tcb, tcb->sched_priority))
+                {
+                  up_switch_context(this_task(), rtcb);
+                }
+            }
+        }
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
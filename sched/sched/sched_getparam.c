@@ -30,6 +30,7 @@
 #include <sched.h>
 #include <assert.h>
 #include <errno.h>
+#include <string.h>
 
 #include <nuttx/sched.h>
 
@@ -138,6 +139,32 @@ int nxsched_get_param(pid_t pid, FAR struct sched_param *param)
               param->sched_ss_init_budget.tv_nsec = 0;
             }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+          if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+            {
+              FAR struct deadline_s *deadline = tcb->deadline;
+              DEBUGASSERT(deadline != NULL);
+
+              /* Return parameters associated with SCHED_DEADLINE */
+
+              clock_ticks2time(&param->sched_dl_runtime,
+                               deadline->runtime);
+              clock_ticks2time(&param->sched_dl_deadline,
+                               deadline->deadline);
+              clock_ticks2time(&param->sched_dl_period,
+                               deadline->period);
+            }
+          else
+            {
+              memset(&param->sched_dl_runtime, 0,
+                     sizeof(param->sched_dl_runtime));
+              memset(&param->sched_dl_deadline, 0,
+                     sizeof(param->sched_dl_deadline));
+              memset(&param->sched_dl_period, 0,
+                     sizeof(param->sched_dl_period));
+            }
+#endif
         }
 
       leave_critical_section(flags);
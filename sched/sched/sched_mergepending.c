@@ -61,6 +61,43 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_PRIOBITMAP
+bool nxsched_merge_pending(void)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  FAR struct tcb_s *ptcb;
+  bool ret = false;
+
+  /* Do nothing if pre-emption is still disabled */
+
+  if (!nxsched_islocked_tcb(rtcb))
+    {
+      /* With the priority index each insertion is O(1), so simply move the
+       * pending tasks one by one into the ready-to-run list.
+       */
+
+      while ((ptcb = (FAR struct tcb_s *)
+                     dq_remfirst(list_pendingtasks())) != NULL)
+        {
+          if (nxsched_add_rtrlist(ptcb, 0))
+            {
+              /* ptcb is now the head of the ready-to-run list */
+
+              ptcb->flink->task_state = TSTATE_TASK_READYTORUN;
+              ptcb->task_state        = TSTATE_TASK_RUNNING;
+              up_update_task(ptcb);
+              ret                     = true;
+            }
+          else
+            {
+              ptcb->task_state        = TSTATE_TASK_READYTORUN;
+            }
+        }
+    }
+
+  return ret;
+}
+#else
 bool nxsched_merge_pending(void)
 {
   FAR struct tcb_s *ptcb;
@@ -96,7 +133,7 @@ bool nxsched_merge_pending(void)
            */
 
           for (;
-               (rtcb && ptcb->sched_priority <= rtcb->sched_priority);
+               (rtcb && !nxsched_outranks(ptcb, rtcb));
                rtcb = rtcb->flink)
             {
             }
@@ -150,3 +187,4 @@ bool nxsched_merge_pending(void)
 
   return ret;
 }
+#endif
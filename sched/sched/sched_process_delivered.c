@@ -89,7 +89,8 @@ void nxsched_process_delivered(int cpu)
        * pass it forward.
        */
 
-      FAR struct tcb_s *tcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
+      FAR struct tcb_s *tcb =
+        (FAR struct tcb_s *)dq_peek(list_cpureadytorun(cpu));
       if (tcb)
         {
           int target_cpu = tcb->flags & TCB_FLAG_CPU_LOCKED ?
@@ -97,6 +98,14 @@ void nxsched_process_delivered(int cpu)
           if (target_cpu < CONFIG_SMP_NCPUS && target_cpu != cpu &&
               current_task(target_cpu)->sched_priority < tcb->sched_priority)
             {
+#ifdef CONFIG_SMP_PERCPU_READYTORUN
+              /* Hand the task over to the ready-to-run list of the CPU
+               * that will run it.
+               */
+
+              nxsched_remove_cpureadytorun(tcb);
+              nxsched_add_cpureadytorun(tcb, target_cpu);
+#endif
               nxsched_deliver_task(cpu, target_cpu, priority);
             }
         }
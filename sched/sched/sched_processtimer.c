@@ -65,7 +65,8 @@
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static inline void nxsched_cpu_scheduler(int cpu)
 {
   FAR struct tcb_s *rtcb = current_task(cpu);
@@ -95,6 +96,17 @@ static inline void nxsched_cpu_scheduler(int cpu)
       nxsched_process_sporadic(rtcb, 1, false);
     }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Check if the currently executing task uses deadline scheduling. */
+
+  if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+    {
+      /* Yes, charge the tick against its runtime budget */
+
+      nxsched_process_deadline(rtcb, 1, false);
+    }
+#endif
 }
 #endif
 
@@ -113,7 +125,8 @@ static inline void nxsched_cpu_scheduler(int cpu)
  *
  ****************************************************************************/
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
 static inline void nxsched_process_scheduler(void)
 {
   irqstate_t flags;
@@ -181,6 +194,12 @@ static void nxsched_process_tick(void)
 
   nxsched_process_scheduler();
 
+#if defined(CONFIG_SMP_BALANCE_INTERVAL) && CONFIG_SMP_BALANCE_INTERVAL > 0
+  /* Even out the per-CPU ready-to-run lists */
+
+  nxsched_balance_readytorun();
+#endif
+
   /* Process watchdogs */
 
   wd_timer(clock_systime_ticks());
@@ -90,10 +90,17 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb)
     }
 
   /* Remove the TCB from the ready-to-run list.  In the non-SMP case, this
-   * is always the g_readytorun list.
+   * is always the g_readytorun list (or g_pendingtasks).
    */
 
-  dq_rem((FAR dq_entry_t *)rtcb, tasklist);
+  if (tasklist == list_readytorun())
+    {
+      nxsched_remove_rtrlist(rtcb, 0);
+    }
+  else
+    {
+      dq_rem((FAR dq_entry_t *)rtcb, tasklist);
+    }
 
   /* Since the TCB is not in any list, it is now invalid */
 
@@ -179,13 +186,9 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *tcb)
     }
   else
     {
-      FAR dq_queue_t *tasklist;
-
-      tasklist = TLIST_HEAD(tcb, tcb->cpu);
-
       /* The task is not running.  Just remove its TCB from the task list */
 
-      dq_rem((FAR dq_entry_t *)tcb, tasklist);
+      nxsched_remove_cpureadytorun(tcb);
 
       /* Since the TCB is no longer in any list, it is now invalid */
 
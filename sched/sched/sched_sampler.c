@@ -0,0 +1,569 @@
+/****************************************************************************
+ * sched/sched/sched_sampler.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wdog.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#ifdef CONFIG_ALLSYMS
+#  include <nuttx/allsyms.h>
+#  include <nuttx/symtab.h>
+#endif
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SAMPLER_DEPTH     CONFIG_SCHED_SAMPLER_DEPTH
+#define SAMPLER_NSAMPLES  CONFIG_SCHED_SAMPLER_NSAMPLES
+
+#if (SAMPLER_NSAMPLES & (SAMPLER_NSAMPLES - 1)) != 0
+#  error CONFIG_SCHED_SAMPLER_NSAMPLES must be a power of two
+#endif
+
+/* Room for the frames of the interrupt and sampler logic that precede the
+ * interrupted code in a backtrace taken from interrupt context.
+ */
+
+#define SAMPLER_IRQFRAMES 16
+
+/* Longest folded stack line:  "name;frame;...;frame 1\n" */
+
+#define SAMPLER_LINELEN   (CONFIG_TASK_NAME_SIZE + 16 + SAMPLER_DEPTH * 40)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One call chain, leaf first */
+
+struct sampler_sample_s
+{
+  pid_t pid;                           /* Thread that was interrupted */
+  uint8_t nframes;                     /* Number of valid frames */
+  FAR void *frames[SAMPLER_DEPTH];     /* Return addresses, leaf first */
+};
+
+/* Per-CPU ring.  The CPU itself is the only producer, from interrupt
+ * context; the procfs reader is the only consumer.  head and tail are free
+ * running counters, so neither side needs a lock.
+ */
+
+struct sampler_cpu_s
+{
+  atomic_t head;                       /* Next slot to fill */
+  atomic_t tail;                       /* Next slot to drain */
+  atomic_t dropped;                    /* Samples lost to a full ring */
+  struct sampler_sample_s samples[SAMPLER_NSAMPLES];
+};
+
+struct sampler_s
+{
+  struct wdog_s timer;                 /* Sampling timer */
+  clock_t period;                      /* Sampling period in ticks */
+  struct sampler_cpu_s cpu[CONFIG_SMP_NCPUS];
+};
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+/* This structure describes one open "file" */
+
+struct sampler_file_s
+{
+  struct procfs_file_s base;           /* Base open file structure */
+  unsigned int cpu;                    /* Next CPU to drain */
+  char line[SAMPLER_LINELEN];          /* Formatted folded stack */
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static int sampler_timer_handler_cpu(FAR void *arg);
+#endif
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+static int     sampler_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     sampler_close(FAR struct file *filep);
+static ssize_t sampler_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t sampler_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static int     sampler_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     sampler_stat(FAR const char *relpath, FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct sampler_s g_sampler;
+
+/* Serializes the readers, the only consumers of the rings */
+
+static mutex_t g_sampler_lock = NXMUTEX_INITIALIZER;
+
+#ifdef CONFIG_SMP
+static struct smp_call_data_s g_sampler_call_data =
+SMP_CALL_INITIALIZER(sampler_timer_handler_cpu, &g_sampler);
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+/* See fs_procfs.c -- this structure is explicitly extern'ed there. */
+
+const struct procfs_operations g_sampler_operations =
+{
+  sampler_open,   /* open */
+  sampler_close,  /* close */
+  sampler_read,   /* read */
+  sampler_write,  /* write */
+  NULL,           /* poll */
+
+  sampler_dup,    /* dup */
+
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+
+  sampler_stat    /* stat */
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sampler_timer_handler_cpu
+ *
+ * Description:
+ *   Record the call chain of the code interrupted on this CPU.
+ *
+ ****************************************************************************/
+
+static int sampler_timer_handler_cpu(FAR void *arg)
+{
+  FAR struct sampler_s *sampler = (FAR struct sampler_s *)arg;
+  FAR struct sampler_cpu_s *cpu = &sampler->cpu[this_cpu()];
+  FAR struct sampler_sample_s *sample;
+  FAR struct tcb_s *tcb = this_task();
+  FAR void *frames[SAMPLER_DEPTH + SAMPLER_IRQFRAMES];
+  uintptr_t pc = up_getusrpc(NULL);
+  uint32_t head;
+  int nframes;
+  int i;
+
+  head = atomic_read(&cpu->head);
+  if (head - (uint32_t)atomic_read_acquire(&cpu->tail) >= SAMPLER_NSAMPLES)
+    {
+      atomic_fetch_add(&cpu->dropped, 1);
+      return OK;
+    }
+
+  /* The backtrace starts in this handler; everything up to the interrupted
+   * PC belongs to the interrupt logic and is dropped.  If the unwinder
+   * did not get that far, record the interrupted PC alone.
+   */
+
+  sample  = &cpu->samples[head & (SAMPLER_NSAMPLES - 1)];
+  nframes = sched_backtrace(tcb->pid, frames, nitems(frames), 0);
+
+  i = 0;
+  while (i < nframes && (uintptr_t)frames[i] != pc)
+    {
+      i++;
+    }
+
+  if (i < nframes)
+    {
+      nframes = MIN(nframes - i, SAMPLER_DEPTH);
+      memcpy(sample->frames, &frames[i], nframes * sizeof(FAR void *));
+    }
+  else
+    {
+      sample->frames[0] = (FAR void *)pc;
+      nframes = 1;
+    }
+
+  sample->pid     = tcb->pid;
+  sample->nframes = nframes;
+  atomic_set_release(&cpu->head, head + 1);
+  return OK;
+}
+
+static void sampler_timer_handler(wdparm_t arg)
+{
+  FAR struct sampler_s *sampler = (FAR struct sampler_s *)(uintptr_t)arg;
+
+#ifdef CONFIG_SMP
+  cpu_set_t cpus = (1 << CONFIG_SMP_NCPUS) - 1;
+  CPU_CLR(this_cpu(), &cpus);
+  nxsched_smp_call_async(cpus, &g_sampler_call_data);
+#endif
+
+  sampler_timer_handler_cpu(sampler);
+  wd_start_next(&sampler->timer, sampler->period, sampler_timer_handler,
+                arg);
+}
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+
+/****************************************************************************
+ * Name: sampler_format
+ *
+ * Description:
+ *   Format one sample as a folded stack line, root first, as consumed by
+ *   flamegraph.pl.  Without CONFIG_ALLSYMS the frames are raw addresses
+ *   that can be resolved on the host against the ELF file.
+ *
+ ****************************************************************************/
+
+static size_t sampler_format(FAR const struct sampler_sample_s *sample,
+                             FAR char *line, size_t size)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  size_t len;
+  int i;
+
+  /* Reserve room for the count at the end of the line */
+
+  size -= 4;
+
+  flags = enter_critical_section();
+  tcb = nxsched_get_tcb(sample->pid);
+  if (tcb != NULL)
+    {
+      len = snprintf(line, size, "%s", get_task_name(tcb));
+    }
+  else
+    {
+      len = snprintf(line, size, "[%d]", (int)sample->pid);
+    }
+
+  leave_critical_section(flags);
+
+  for (i = sample->nframes - 1; i >= 0 && len < size; i--)
+    {
+#ifdef CONFIG_ALLSYMS
+      FAR const struct symtab_s *symbol;
+
+      symbol = allsyms_findbyvalue(sample->frames[i], NULL);
+      if (symbol != NULL)
+        {
+          len += snprintf(line + len, size - len, ";%s", symbol->sym_name);
+          continue;
+        }
+#endif
+
+      len += snprintf(line + len, size - len, ";0x%" PRIxPTR,
+                      (uintptr_t)sample->frames[i]);
+    }
+
+  len = MIN(len, size - 1);
+  memcpy(line + len, " 1\n", 4);
+  return len + 3;
+}
+
+/****************************************************************************
+ * Name: sampler_open
+ ****************************************************************************/
+
+static int sampler_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct sampler_file_s *samplerfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  samplerfile = kmm_zalloc(sizeof(struct sampler_file_s));
+  if (samplerfile == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  filep->f_priv = samplerfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sampler_close
+ ****************************************************************************/
+
+static int sampler_close(FAR struct file *filep)
+{
+  FAR struct sampler_file_s *samplerfile = filep->f_priv;
+
+  DEBUGASSERT(samplerfile != NULL);
+
+  kmm_free(samplerfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sampler_read
+ *
+ * Description:
+ *   Drain the per-CPU rings as folded stacks, one line per sample.  Only
+ *   whole lines are returned, and returned samples are consumed, so the
+ *   file can be read repeatedly to stream samples off a running device.
+ *   Lost samples are reported as a "[dropped]" stack.
+ *
+ ****************************************************************************/
+
+static ssize_t sampler_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct sampler_file_s *samplerfile = filep->f_priv;
+  FAR struct sampler_s *sampler = &g_sampler;
+  FAR struct sampler_cpu_s *cpu;
+  size_t ncopied = 0;
+  size_t linesize;
+  unsigned int ncpus;
+  uint32_t tail;
+  int dropped;
+  int ret;
+
+  DEBUGASSERT(samplerfile != NULL);
+
+  ret = nxmutex_lock(&g_sampler_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (ncpus = 0; ncpus < CONFIG_SMP_NCPUS; )
+    {
+      cpu  = &sampler->cpu[samplerfile->cpu];
+      tail = atomic_read(&cpu->tail);
+
+      dropped = atomic_read(&cpu->dropped);
+      if (dropped > 0)
+        {
+          linesize = snprintf(samplerfile->line, SAMPLER_LINELEN,
+                              "[dropped] %d\n", dropped);
+        }
+      else if (tail != (uint32_t)atomic_read_acquire(&cpu->head))
+        {
+          linesize = sampler_format(
+            &cpu->samples[tail & (SAMPLER_NSAMPLES - 1)],
+            samplerfile->line, SAMPLER_LINELEN);
+        }
+      else
+        {
+          /* This ring is empty, move on to the next CPU */
+
+          samplerfile->cpu = (samplerfile->cpu + 1) % CONFIG_SMP_NCPUS;
+          ncpus++;
+          continue;
+        }
+
+      if (linesize > buflen - ncopied)
+        {
+          if (ncopied > 0)
+            {
+              break;
+            }
+
+          /* The caller's buffer cannot hold a single line; truncate it */
+
+          linesize = buflen;
+        }
+
+      memcpy(buffer + ncopied, samplerfile->line, linesize);
+      ncopied += linesize;
+
+      if (dropped > 0)
+        {
+          atomic_fetch_sub(&cpu->dropped, dropped);
+        }
+      else
+        {
+          atomic_set_release(&cpu->tail, tail + 1);
+        }
+
+      ncpus = 0;
+    }
+
+  nxmutex_unlock(&g_sampler_lock);
+
+  filep->f_pos += ncopied;
+  return ncopied;
+}
+
+/****************************************************************************
+ * Name: sampler_write
+ *
+ * Description:
+ *   Writing a rate in Hz starts sampling at that rate; writing 0 stops it.
+ *
+ ****************************************************************************/
+
+static ssize_t sampler_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  char line[16];
+  FAR char *endptr;
+  unsigned long hz;
+  int ret;
+
+  if (buflen >= sizeof(line))
+    {
+      return -EINVAL;
+    }
+
+  memcpy(line, buffer, buflen);
+  line[buflen] = '\0';
+
+  hz = strtoul(line, &endptr, 10);
+  if (endptr == line)
+    {
+      return -EINVAL;
+    }
+
+  ret = hz > 0 ? nxsched_sampler_start(hz) : nxsched_sampler_stop();
+  return ret < 0 ? ret : buflen;
+}
+
+/****************************************************************************
+ * Name: sampler_dup
+ ****************************************************************************/
+
+static int sampler_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct sampler_file_s *oldattr = oldp->f_priv;
+  FAR struct sampler_file_s *newattr;
+
+  DEBUGASSERT(oldattr != NULL);
+
+  newattr = kmm_malloc(sizeof(struct sampler_file_s));
+  if (newattr == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldattr, sizeof(struct sampler_file_s));
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sampler_stat
+ ****************************************************************************/
+
+static int sampler_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_sampler_start
+ *
+ * Description:
+ *   Start, or change the rate of, call chain sampling on all CPUs.
+ *
+ * Input Parameters:
+ *   hz - Samples per second per CPU.  Rates above the system tick rate
+ *        are limited to one sample per tick.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxsched_sampler_start(unsigned long hz)
+{
+  FAR struct sampler_s *sampler = &g_sampler;
+  clock_t period;
+
+  if (hz == 0)
+    {
+      return -EINVAL;
+    }
+
+  period = NSEC2TICK(NSEC_PER_SEC / hz);
+  sampler->period = period > 0 ? period : 1;
+
+  return wd_start(&sampler->timer, sampler->period, sampler_timer_handler,
+                  (wdparm_t)(uintptr_t)sampler);
+}
+
+/****************************************************************************
+ * Name: nxsched_sampler_stop
+ *
+ * Description:
+ *   Stop call chain sampling.  Samples already taken remain readable.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxsched_sampler_stop(void)
+{
+  wd_cancel(&g_sampler.timer);
+  return OK;
+}
@@ -82,6 +82,9 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 {
   FAR struct tcb_s *tcb;
   irqstate_t flags;
+#ifdef CONFIG_SCHED_DEADLINE
+  uint32_t oldpolicy;
+#endif
   int ret;
 
   /* Check for supported scheduling policy */
@@ -93,6 +96,9 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
      )
     {
@@ -134,6 +140,27 @@ int nxsched_set_scheduler(pid_t pid, int policy,
   /* Further, disable timer interrupts while we set up scheduling policy. */
 
   flags = enter_critical_section();
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Start or update deadline scheduling first: it may be refused by the
+   * admission control, in which case the current policy is retained.
+   */
+
+  oldpolicy = tcb->flags & TCB_FLAG_POLICY_MASK;
+  if (policy == SCHED_DEADLINE)
+    {
+      ret = nxsched_start_deadline(tcb, param);
+      if (ret < 0)
+        {
+          goto errout_with_irq;
+        }
+    }
+  else if (oldpolicy == TCB_FLAG_SCHED_DEADLINE)
+    {
+      nxsched_stop_deadline(tcb);
+    }
+#endif
+
   tcb->flags &= ~TCB_FLAG_POLICY_MASK;
   switch (policy)
     {
@@ -152,7 +179,8 @@ int nxsched_set_scheduler(pid_t pid, int policy,
           /* Save the FIFO scheduling parameters */
 
           tcb->flags     |= TCB_FLAG_SCHED_FIFO;
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
           tcb->timeslice  = 0;
 #endif
         }
@@ -269,6 +297,16 @@ int nxsched_set_scheduler(pid_t pid, int policy,
         }
         break;
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+          /* The budget and deadline were set by nxsched_start_deadline() */
+
+          tcb->flags |= TCB_FLAG_SCHED_DEADLINE;
+        }
+        break;
+#endif
     }
 
   leave_critical_section(flags);
@@ -279,7 +317,7 @@ int nxsched_set_scheduler(pid_t pid, int policy,
   sched_unlock();
   return ret;
 
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
 errout_with_irq:
   leave_critical_section(flags);
   sched_unlock();
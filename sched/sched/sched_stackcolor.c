@@ -0,0 +1,156 @@
+/****************************************************************************
+ * sched/sched/sched_stackcolor.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The bottom of the stack is fully colored so that an overflow, or a check
+ * limited to the overflow margin, is detected exactly.
+ */
+
+#if defined(CONFIG_STACKCHECK_MARGIN) && CONFIG_STACKCHECK_MARGIN > 256
+#  define STACK_GUARD_SIZE  ((CONFIG_STACKCHECK_MARGIN + 3) & ~3)
+#else
+#  define STACK_GUARD_SIZE  256
+#endif
+
+/* Above the guard, only probe words are colored.  Their distances from the
+ * top of the stack start at STACK_PROBE_FIRST and grow by a quarter each
+ * time, so a 64 KiB stack has about 30 probes and the usage reported is
+ * at most 25% above the real high water mark.
+ */
+
+#define STACK_PROBE_FIRST   64
+#define STACK_PROBE_NEXT(d) ((d) + (((d) >> 2) & ~3))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_stack_color
+ *
+ * Description:
+ *   Color the guard area at the bottom of a stack and the probe words
+ *   above it, instead of the whole stack.
+ *
+ * Input Parameters:
+ *   start - The word aligned lowest address of the stack
+ *   end   - The word aligned top of the stack
+ *   color - The architecture's stack coloration value
+ *
+ ****************************************************************************/
+
+void nxsched_stack_color(FAR void *start, FAR void *end, uint32_t color)
+{
+  FAR uint32_t *guard = (FAR uint32_t *)start + STACK_GUARD_SIZE / 4;
+  FAR uint32_t *ptr;
+  size_t dist;
+
+  for (ptr = start; ptr < guard && ptr < (FAR uint32_t *)end; ptr++)
+    {
+      *ptr = color;
+    }
+
+  for (dist = STACK_PROBE_FIRST; ; dist = STACK_PROBE_NEXT(dist))
+    {
+      ptr = (FAR uint32_t *)((FAR char *)end - dist);
+      if (ptr < guard)
+        {
+          break;
+        }
+
+      *ptr = color;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_stack_check
+ *
+ * Description:
+ *   Estimate the stack usage from a stack colored by nxsched_stack_color(),
+ *   or fully colored.  If the guard area has been touched, the usage is
+ *   exact.  Otherwise it is the distance of the probe below the deepest
+ *   clobbered probe, an upper bound of the high water mark.  This reads a
+ *   few dozen words instead of scanning the whole unused stack.
+ *
+ * Input Parameters:
+ *   start - The word aligned lowest address of the stack
+ *   end   - The word aligned top of the stack
+ *   color - The architecture's stack coloration value
+ *
+ * Returned Value:
+ *   The estimated amount of stack space used.
+ *
+ ****************************************************************************/
+
+size_t nxsched_stack_check(FAR void *start, FAR void *end, uint32_t color)
+{
+  FAR uint32_t *guard = (FAR uint32_t *)start + STACK_GUARD_SIZE / 4;
+  FAR uint32_t *ptr;
+  size_t nbytes = (FAR char *)end - (FAR char *)start;
+  size_t used = STACK_PROBE_FIRST;
+  size_t dist;
+
+  for (ptr = start; ptr < guard && ptr < (FAR uint32_t *)end; ptr++)
+    {
+      if (*ptr != color)
+        {
+          return (FAR char *)end - (FAR char *)ptr;
+        }
+    }
+
+  /* The whole range is the guard when only the margin is checked */
+
+  if (nbytes <= STACK_GUARD_SIZE)
+    {
+      return 0;
+    }
+
+  for (dist = STACK_PROBE_FIRST; ; dist = STACK_PROBE_NEXT(dist))
+    {
+      ptr = (FAR uint32_t *)((FAR char *)end - dist);
+      if (ptr < guard)
+        {
+          break;
+        }
+
+      if (*ptr != color)
+        {
+          used = STACK_PROBE_NEXT(dist);
+        }
+    }
+
+  return MIN(used, nbytes - STACK_GUARD_SIZE);
+}
@@ -71,6 +71,10 @@ void nxsched_switch_context(FAR struct tcb_s *from, FAR struct tcb_s *to)
   nxsched_switch_critmon(from, to);
 #endif
 
+#ifdef CONFIG_SCHED_ACCOUNTING
+  nxsched_switch_accounting(from, to);
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_suspend(from);
   sched_note_resume(to);
@@ -90,7 +90,7 @@ void sched_unlock(void)
            */
 
 #ifdef CONFIG_SMP
-          ptcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
+          ptcb = nxsched_peek_readytorun(rtcb->cpu);
           if (ptcb && ptcb->sched_priority > rtcb->sched_priority &&
               nxsched_deliver_task(rtcb->cpu, rtcb->cpu, SWITCH_HIGHER))
 #else
@@ -170,6 +170,28 @@ void sched_unlock(void)
             }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+          /* If the running deadline task exhausted its budget while
+           * pre-emption was disabled, postpone its deadline now.
+           */
+
+          if ((rtcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE
+              && rtcb == this_task() && rtcb->timeslice <= 0)
+            {
+              nxsched_process_deadline(rtcb, 0, false);
+
+#  ifdef CONFIG_SCHED_TICKLESS
+              if (rtcb == this_task() &&
+                  (rtcb->flags & TCB_FLAG_PREEMPT_SCHED) == 0)
+                {
+                  rtcb->flags |= TCB_FLAG_PREEMPT_SCHED;
+                  nxsched_reassess_timer();
+                  rtcb->flags &= ~TCB_FLAG_PREEMPT_SCHED;
+                }
+#  endif
+            }
+#endif
+
           leave_critical_section_wo_note(flags);
         }
       else
@@ -99,6 +99,15 @@ int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
   DEBUGASSERT(sem != NULL && abstime != NULL);
   DEBUGASSERT(up_interrupt_context() == false);
 
+  /* Try the lock-free fast path first:  an uncontended semaphore can be
+   * taken without entering the critical section at all.
+   */
+
+  if (nxsem_trywait(sem) == OK)
+    {
+      return OK;
+    }
+
   /* We will disable interrupts until we have completed the semaphore
    * wait.  We need to do this (as opposed to just disabling pre-emption)
    * because there could be interrupt handlers that are asynchronously
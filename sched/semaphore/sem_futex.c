@@ -0,0 +1,252 @@
+/****************************************************************************
+ * sched/semaphore/sem_futex.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdbool.h>
+
+#include <nuttx/futex.h>
+#include <nuttx/queue.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FUTEX_HASH_BITS    5
+#define FUTEX_HASH_SIZE    (1 << FUTEX_HASH_BITS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One hash bucket: the threads waiting on all futex words that hash here */
+
+struct futex_bucket_s
+{
+  spinlock_t lock;
+  dq_queue_t waiters;
+};
+
+/* One waiting thread.  Lives on the stack of the waiter. */
+
+struct futex_waiter_s
+{
+  dq_entry_t node;                  /* Link in the bucket wait list */
+  FAR volatile uint32_t *addr;      /* The futex word */
+#ifdef CONFIG_ARCH_ADDRENV
+  FAR struct task_group_s *group;   /* Owner of the address environment */
+#endif
+  sem_t sem;                        /* Posted by nxfutex_wake() */
+  bool woken;                       /* Removed from the list by a waker */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct futex_bucket_s g_futex_hash[FUTEX_HASH_SIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR struct futex_bucket_s *futex_bucket(FAR volatile uint32_t *addr)
+{
+  uint32_t key = (uint32_t)((uintptr_t)addr >> 2);
+
+  return &g_futex_hash[(key * 0x9e3779b1u) >> (32 - FUTEX_HASH_BITS)];
+}
+
+static bool futex_match(FAR struct futex_waiter_s *waiter,
+                        FAR volatile uint32_t *addr)
+{
+#ifdef CONFIG_ARCH_ADDRENV
+  if (waiter->group != this_task()->group)
+    {
+      return false;
+    }
+#endif
+
+  return waiter->addr == addr;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxfutex_wait
+ *
+ * Description:
+ *   Block on the futex word 'addr' as long as it holds 'val'.  See
+ *   include/nuttx/futex.h.
+ *
+ ****************************************************************************/
+
+int nxfutex_wait(FAR volatile uint32_t *addr, uint32_t val,
+                 clockid_t clockid, FAR const struct timespec *abstime)
+{
+  FAR struct futex_bucket_s *bucket;
+  struct futex_waiter_s waiter;
+  irqstate_t flags;
+  int ret;
+
+  if (addr == NULL || ((uintptr_t)addr & 3) != 0)
+    {
+      return -EINVAL;
+    }
+
+  waiter.addr  = addr;
+#ifdef CONFIG_ARCH_ADDRENV
+  waiter.group = this_task()->group;
+#endif
+  waiter.woken = false;
+  nxsem_init(&waiter.sem, 0, 0);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  nxsem_set_protocol(&waiter.sem, SEM_PRIO_NONE);
+#endif
+
+  /* Compare the word and enqueue under the bucket lock.  A waker changes
+   * the word before it takes the same lock, so either we see the new value
+   * here or the waker finds us on the list.
+   */
+
+  bucket = futex_bucket(addr);
+  flags  = spin_lock_irqsave(&bucket->lock);
+
+  if (*addr != val)
+    {
+      spin_unlock_irqrestore(&bucket->lock, flags);
+      nxsem_destroy(&waiter.sem);
+      return -EAGAIN;
+    }
+
+  dq_addlast(&waiter.node, &bucket->waiters);
+  spin_unlock_irqrestore(&bucket->lock, flags);
+
+  if (abstime != NULL)
+    {
+      ret = nxsem_clockwait(&waiter.sem, clockid, abstime);
+    }
+  else
+    {
+      ret = nxsem_wait(&waiter.sem);
+    }
+
+  if (ret < 0)
+    {
+      flags = spin_lock_irqsave(&bucket->lock);
+      if (waiter.woken)
+        {
+          /* A waker already took us off the list and is about to post the
+           * semaphore.  Consume that post so that the waiter does not go
+           * out of scope under the waker, and report the wake-up.
+           */
+
+          spin_unlock_irqrestore(&bucket->lock, flags);
+          nxsem_wait_uninterruptible(&waiter.sem);
+          ret = OK;
+        }
+      else
+        {
+          dq_rem(&waiter.node, &bucket->waiters);
+          spin_unlock_irqrestore(&bucket->lock, flags);
+        }
+    }
+
+  nxsem_destroy(&waiter.sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxfutex_wake
+ *
+ * Description:
+ *   Wake up to 'count' threads waiting on the futex word 'addr'.  See
+ *   include/nuttx/futex.h.
+ *
+ ****************************************************************************/
+
+int nxfutex_wake(FAR volatile uint32_t *addr, int count)
+{
+  FAR struct futex_bucket_s *bucket;
+  FAR struct futex_waiter_s *waiter;
+  FAR dq_entry_t *curr;
+  FAR dq_entry_t *next;
+  dq_queue_t wakeup;
+  irqstate_t flags;
+  int woken = 0;
+
+  if (addr == NULL || ((uintptr_t)addr & 3) != 0 || count < 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Collect the waiters under the lock, post them after dropping it */
+
+  dq_init(&wakeup);
+  bucket = futex_bucket(addr);
+  flags  = spin_lock_irqsave(&bucket->lock);
+
+  for (curr = dq_peek(&bucket->waiters);
+       curr != NULL && woken < count;
+       curr = next)
+    {
+      next   = dq_next(curr);
+      waiter = (FAR struct futex_waiter_s *)curr;
+      if (futex_match(waiter, addr))
+        {
+          dq_rem(curr, &bucket->waiters);
+          dq_addlast(curr, &wakeup);
+          waiter->woken = true;
+          woken++;
+        }
+    }
+
+  spin_unlock_irqrestore(&bucket->lock, flags);
+
+  /* Hold off the woken threads until all of them are ready to run.  The
+   * waiter may return and release its stack as soon as its semaphore is
+   * posted, so fetch the next entry first.
+   */
+
+  sched_lock();
+  for (curr = dq_peek(&wakeup); curr != NULL; curr = next)
+    {
+      next   = dq_next(curr);
+      waiter = (FAR struct futex_waiter_s *)curr;
+      nxsem_post(&waiter->sem);
+    }
+
+  sched_unlock();
+  return woken;
+}
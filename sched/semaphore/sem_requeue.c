@@ -0,0 +1,134 @@
+/****************************************************************************
+ * sched/semaphore/sem_requeue.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/wdog.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_requeue
+ *
+ * Description:
+ *   Move up to 'count' of the highest priority threads waiting on the
+ *   counting semaphore 'sem' to the wait list of 'mutex', as long as the
+ *   mutex is held by another thread.  Each moved thread is given the mutex
+ *   when it is its turn, and then returns successfully from its wait on
+ *   'sem'.  A thread that would only wake up to block on the mutex is thus
+ *   never scheduled in between.
+ *
+ *   Once moved, the wait can no longer time out or be interrupted by a
+ *   signal, just like any other wait on a mutex.
+ *
+ * Input Parameters:
+ *   sem   - The counting semaphore with the waiters
+ *   mutex - The mutex they are to acquire afterwards
+ *   count - The maximum number of waiters to move
+ *
+ * Returned Value:
+ *   The number of waiters moved.  The caller posts 'sem' for the others.
+ *   Nothing is moved if the mutex is free or uses priority inheritance or
+ *   protection, whose holder would need to be boosted.
+ *
+ ****************************************************************************/
+
+int nxsem_requeue(FAR sem_t *sem, FAR sem_t *mutex, int count)
+{
+  FAR struct tcb_s *htcb = NULL;
+  FAR struct tcb_s *stcb;
+  irqstate_t flags;
+  uint32_t mholder;
+  int moved = 0;
+
+  DEBUGASSERT(!NXSEM_IS_MUTEX(sem) && NXSEM_IS_MUTEX(mutex));
+
+  if ((mutex->flags & SEM_PRIO_MASK) != SEM_PRIO_NONE)
+    {
+      return 0;
+    }
+
+  flags = enter_critical_section();
+
+  while (moved < count && !dq_empty(SEM_WAITLIST(sem)))
+    {
+      if (htcb == NULL)
+        {
+          /* Mark the mutex as blocking while it keeps the same holder, so
+           * that its release goes through nxsem_post_slow() and hands it
+           * over to the first waiter.
+           */
+
+          mholder = atomic_read(NXSEM_MHOLDER(mutex));
+          do
+            {
+              if (!NXSEM_MACQUIRED(mholder))
+                {
+                  goto out;
+                }
+
+              htcb = nxsched_get_tcb(mholder & ~NXSEM_MBLOCKING_BIT);
+              if (htcb == NULL)
+                {
+                  goto out;
+                }
+            }
+          while (!atomic_try_cmpxchg_acquire(NXSEM_MHOLDER(mutex), &mholder,
+                                             mholder | NXSEM_MBLOCKING_BIT));
+        }
+
+      stcb = (FAR struct tcb_s *)dq_peek(SEM_WAITLIST(sem));
+
+      /* Undo the wait on the semaphore, as nxsem_wait_irq() does */
+
+      nxsem_canceled(stcb, sem);
+      dq_rem((FAR dq_entry_t *)stcb, SEM_WAITLIST(sem));
+      atomic_fetch_add(NXSEM_COUNT(sem), 1);
+      wd_cancel(&stcb->waitdog);
+
+      /* And block on the mutex, as nxsem_wait_slow() does */
+
+      nxsem_add_holder_tcb(htcb, mutex);
+      stcb->waitobj = mutex;
+      nxsched_add_prioritized(stcb, SEM_WAITLIST(mutex));
+      moved++;
+    }
+
+out:
+  leave_critical_section(flags);
+  return moved;
+}
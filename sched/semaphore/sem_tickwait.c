@@ -72,6 +72,15 @@ int nxsem_tickwait(FAR sem_t *sem, uint32_t delay)
   irqstate_t flags;
   int ret;
 
+  /* Try the lock-free fast path first:  an uncontended semaphore can be
+   * taken without entering the critical section at all.
+   */
+
+  if (nxsem_trywait(sem) == OK)
+    {
+      return OK;
+    }
+
   /* We will disable interrupts until we have completed the semaphore
    * wait.  We need to do this (as opposed to just disabling pre-emption)
    * because there could be interrupt handlers that are asynchronously
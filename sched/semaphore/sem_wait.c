@@ -38,6 +38,81 @@
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_holder_running
+ *
+ * Description:
+ *   Return true if the thread "pid" is currently running on a CPU other
+ *   than this one.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN
+static bool nxsem_holder_running(pid_t pid)
+{
+  int me = this_cpu();
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (cpu != me && current_task(cpu)->pid == pid)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsem_spin_mutex
+ *
+ * Description:
+ *   Poll a contended mutex for as long as its holder is running on another
+ *   CPU and nobody is blocked on it, trying to take it the same way as the
+ *   fast path in nxsem_wait() does.  For mutexes the holder list is only
+ *   updated when a thread blocks, so a mutex taken here needs no further
+ *   bookkeeping.
+ *
+ * Input Parameters:
+ *   sem - The mutex to take
+ *   pid - The ID of the calling thread
+ *
+ * Returned Value:
+ *   True if the mutex was taken; false if the caller has to block.
+ *
+ ****************************************************************************/
+
+static bool nxsem_spin_mutex(FAR sem_t *sem, pid_t pid)
+{
+  FAR atomic_t *mholder = NXSEM_MHOLDER(sem);
+  int spins;
+
+  for (spins = 0; spins < CONFIG_SEM_ADAPTIVE_SPINCOUNT; spins++)
+    {
+      int32_t old = atomic_read(mholder);
+
+      if (old == NXSEM_NO_MHOLDER)
+        {
+          if (atomic_try_cmpxchg_acquire(mholder, &old, pid))
+            {
+              return true;
+            }
+        }
+      else if (NXSEM_MBLOCKING(old) || !nxsem_holder_running(old))
+        {
+          break;
+        }
+    }
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -78,6 +153,23 @@ int nxsem_wait_slow(FAR sem_t *sem)
   FAR struct tcb_s *htcb = NULL;
   bool mutex = NXSEM_IS_MUTEX(sem);
 
+#ifdef CONFIG_SEM_ADAPTIVE_SPIN
+  /* A mutex held by a thread running on another CPU is likely to be
+   * released soon:  spin for it before paying for the context switches.
+   * This is not possible from within a critical section, which could keep
+   * the holder from releasing the mutex.
+   */
+
+  if (mutex && rtcb->irqcount == 0 &&
+#  ifdef CONFIG_PRIORITY_PROTECT
+      (sem->flags & SEM_PRIO_MASK) != SEM_PRIO_PROTECT &&
+#  endif
+      nxsem_spin_mutex(sem, rtcb->pid))
+    {
+      return OK;
+    }
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -429,6 +429,26 @@ static int nxsig_alloc_dyn_pending(FAR irqstate_t *flags)
   return ret;
 }
 
+/****************************************************************************
+ * Name: nxsig_waiting_for
+ *
+ * Description:
+ *   Return true if the task is blocked waiting for this signal with the
+ *   signal masked, i.e. the signal will be delivered directly to the
+ *   waiter without being queued.
+ *
+ * Assumptions:
+ *   Called in critical section
+ *
+ ****************************************************************************/
+
+static inline bool nxsig_waiting_for(FAR struct tcb_s *stcb, int signo)
+{
+  return stcb->task_state == TSTATE_WAIT_SIG &&
+         nxsig_ismember(&stcb->sigprocmask, signo) == 1 &&
+         nxsig_ismember(&stcb->sigwaitmask, signo) == 1;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -498,13 +518,20 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info,
    * available, in case one needs to be queued later. Note that this breaks
    * the critical section if it needs to allocate any new structures. So it
    * needs to be done here before using the task state or sigprocmask.
+   *
+   * The exception is a blocked signal that the task is already waiting for
+   * in sigwaitinfo() or sigtimedwait(): it is handed over directly through
+   * sigunbinfo below and nothing is queued, so the pools need no refill.
    */
 
-  ret = nxsig_alloc_dyn_pending(&flags);
-  if (ret < 0)
+  if (!nxsig_waiting_for(stcb, info->si_signo))
     {
-      leave_critical_section(flags);
-      return ret;
+      ret = nxsig_alloc_dyn_pending(&flags);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
     }
 
   masked = nxsig_ismember(&stcb->sigprocmask, info->si_signo);
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <signal.h>
+#include <strings.h>
 
 #include <nuttx/signal.h>
 
@@ -47,12 +48,25 @@
 int nxsig_lowest(sigset_t *set)
 {
   int signo;
+  int ndx;
 
-  for (signo = MIN_SIGNO; signo <= MAX_SIGNO; signo++)
+  /* Scan the set a word at a time rather than testing each signal number.
+   * Bit 0 of the first word is never a valid signal number and is ignored.
+   */
+
+  for (ndx = 0; ndx < _SIGSET_NELEM; ndx++)
     {
-      if (nxsig_ismember(set, signo) == 1)
+      uint32_t elem = set->_elem[ndx];
+
+      if (ndx == _SIGSET_NDX(MIN_SIGNO))
+        {
+          elem &= ~((UINT32_C(1) << _SIGSET_BIT(MIN_SIGNO)) - 1);
+        }
+
+      if (elem != 0)
         {
-          return signo;
+          signo = (ndx << 5) + ffs((int)elem) - 1;
+          return signo <= MAX_SIGNO ? signo : ERROR;
         }
     }
 
@@ -53,8 +53,8 @@
  * allocate in a block
  */
 
-#define NUM_PENDING_ACTIONS      4
-#define NUM_SIGNALS_PENDING      4
+#define NUM_PENDING_ACTIONS      CONFIG_SIG_PREALLOC_PENDING
+#define NUM_SIGNALS_PENDING      CONFIG_SIG_PREALLOC_PENDING
 
 /****************************************************************************
  * Public Type Definitions
@@ -447,6 +447,12 @@ void nxtask_exithook(FAR struct tcb_s *tcb, int status)
 
   sched_unlock();
 
+#ifdef CONFIG_FS_POLL_CACHE
+  /* Tear down the poll() registrations kept by the thread */
+
+  pollcache_release(tcb);
+#endif
+
   /* Leave the task group.  Perhaps discarding any un-reaped child
    * status (no zombies here!)
    */
@@ -70,5 +70,13 @@ int tls_dup_info(FAR struct tcb_s *dst, FAR struct tcb_s *src)
   /* Attach per-task info in group to TLS */
 
   info->tl_task = dst->group->tg_info;
+
+  /* The child has its own identity */
+
+  info->tl_tid = dst->pid;
+#ifdef CONFIG_TLS_GETPID
+  info->tl_pid = dst->group->tg_pid;
+#endif
+
   return OK;
 }
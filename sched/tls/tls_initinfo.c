@@ -77,6 +77,9 @@ int tls_init_info(FAR struct tcb_s *tcb)
   /* Thread ID */
 
   info->tl_tid = tcb->pid;
+#ifdef CONFIG_TLS_GETPID
+  info->tl_pid = tcb->group->tg_pid;
+#endif
 
   return OK;
 }
@@ -60,7 +60,9 @@
 
 int wd_cancel(FAR struct wdog_s *wdog)
 {
+#ifndef CONFIG_WDOG_TIMER_WHEEL
   FAR struct wdog_s *first;
+#endif
   irqstate_t         flags;
   int                  ret = -EINVAL;
 
@@ -76,6 +78,14 @@ int wd_cancel(FAR struct wdog_s *wdog)
 
       if (WDOG_ISACTIVE(wdog))
         {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+          /* With the timer wheel there is no interval timer to re-adjust,
+           * removing the watchdog from its slot is all that is needed.
+           */
+
+          list_delete_fast(&wdog->node);
+          wdog->func = NULL;
+#else
           first = list_first_entry(&g_wdactivelist, struct wdog_s, node);
 
           /* Now, remove the watchdog from the timer queue */
@@ -102,6 +112,7 @@ int wd_cancel(FAR struct wdog_s *wdog)
                   wd_timer_cancel();
                 }
             }
+#endif
 
           ret = OK;
         }
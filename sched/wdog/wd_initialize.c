@@ -34,12 +34,21 @@
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/* Active watchdogs hashed by expiration tick, and the last tick whose slot
+ * has been processed.
+ */
+
+struct list_node g_wdtimerwheel[CONFIG_WDOG_TIMER_WHEEL_SIZE];
+clock_t g_wdlasttick;
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 struct list_node g_wdactivelist = LIST_INITIAL_VALUE(g_wdactivelist);
+#endif
 
 #ifdef CONFIG_SCHED_TICKLESS
 bool g_wdtimernested;
@@ -48,3 +57,32 @@ bool g_wdtimernested;
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_initialize
+ *
+ * Description:
+ *   Initialize the watchdog timer wheel.  This must be called before any
+ *   watchdog is started.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+void wd_initialize(void)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_WDOG_TIMER_WHEEL_SIZE; i++)
+    {
+      list_initialize(&g_wdtimerwheel[i]);
+    }
+
+  g_wdlasttick = clock_systime_ticks();
+}
+#endif
@@ -89,6 +89,141 @@
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/****************************************************************************
+ * Name: wd_expiration
+ *
+ * Description:
+ *   Process every timer wheel slot between the last processed tick and
+ *   the current time.  Watchdogs in a slot that have expired are removed
+ *   and executed; the others belong to a later revolution of the wheel and
+ *   are left in place.
+ *
+ * Input Parameters:
+ *   ticks - current time in ticks
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline_function void wd_expiration(clock_t ticks)
+{
+  FAR struct wdog_s *wdog;
+  struct list_node   pending;
+  FAR struct list_node *slot;
+  irqstate_t         flags;
+  wdentry_t          func;
+  wdparm_t           arg;
+  clock_t            nslots;
+
+  flags = enter_critical_section();
+
+  /* If the clock has jumped by more than a full revolution, every slot
+   * needs to be visited only once.
+   */
+
+  nslots = ticks - g_wdlasttick;
+  if (nslots > CONFIG_WDOG_TIMER_WHEEL_SIZE)
+    {
+      g_wdlasttick = ticks - CONFIG_WDOG_TIMER_WHEEL_SIZE;
+    }
+
+  while (g_wdlasttick != ticks)
+    {
+      /* Advance first, so that a watchdog started from a callback for the
+       * current (or an earlier) tick is placed in the next slot.
+       */
+
+      g_wdlasttick++;
+      slot = wd_wheel_slot(g_wdlasttick);
+      if (list_is_empty(slot))
+        {
+          continue;
+        }
+
+      /* Move the slot contents to a private list.  Callbacks may then
+       * start or cancel any watchdog without disturbing the iteration.
+       */
+
+      pending.next       = slot->next;
+      pending.prev       = slot->prev;
+      pending.next->prev = &pending;
+      pending.prev->next = &pending;
+      list_initialize(slot);
+
+      while (!list_is_empty(&pending))
+        {
+          wdog = list_first_entry(&pending, struct wdog_s, node);
+          list_delete_fast(&wdog->node);
+
+          if (!clock_compare(wdog->expired, ticks))
+            {
+              /* Not yet: it expires on a later revolution */
+
+              list_add_tail(slot, &wdog->node);
+              continue;
+            }
+
+          /* Indicate that the watchdog is no longer active. */
+
+          func = wdog->func;
+          arg  = wdog->arg;
+          wdog->func = NULL;
+
+          /* Execute the watchdog function */
+
+          up_setpicbase(wdog->picbase);
+          CALL_FUNC(func, arg);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: wd_insert
+ *
+ * Description:
+ *   Hash the timer into the timer wheel slot of its expiration tick.  A
+ *   watchdog whose expiration time has already passed goes into the slot
+ *   that will be processed next.
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   expired  - expired absolute time in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry
+ *
+ * Assumptions:
+ *   wdog and wdentry is not NULL.
+ *
+ * Returned Value:
+ *   Always false; there is no ordered list head to reassess.
+ *
+ ****************************************************************************/
+
+static inline_function
+bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
+               wdentry_t wdentry, wdparm_t arg)
+{
+  clock_t slot = expired;
+
+  if (clock_compare(slot, g_wdlasttick))
+    {
+      slot = g_wdlasttick + 1;
+    }
+
+  list_add_tail(wd_wheel_slot(slot), &wdog->node);
+
+  wdog->func = wdentry;
+  up_getpicbase(&wdog->picbase);
+  wdog->arg = arg;
+  wdog->expired = expired;
+
+  return false;
+}
+#else
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -220,6 +355,7 @@ bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
 
   return head == curr;
 }
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
 
 /****************************************************************************
  * Public Functions
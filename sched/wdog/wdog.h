@@ -42,6 +42,17 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+#  if (CONFIG_WDOG_TIMER_WHEEL_SIZE & (CONFIG_WDOG_TIMER_WHEEL_SIZE - 1)) != 0
+#    error CONFIG_WDOG_TIMER_WHEEL_SIZE must be a power of two
+#  endif
+
+/* The timer wheel slot that holds watchdogs expiring at tick 't' */
+
+#  define wd_wheel_slot(t) \
+     (&g_wdtimerwheel[(t) & (CONFIG_WDOG_TIMER_WHEEL_SIZE - 1)])
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -54,12 +65,24 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/* With CONFIG_WDOG_TIMER_WHEEL, active watchdogs are hashed by expiration
+ * tick into the unsorted lists of g_wdtimerwheel.  A watchdog that expires
+ * more than one revolution in the future simply stays in its slot until
+ * the wheel comes around again.  g_wdlasttick is the last tick whose slot
+ * has been processed by wd_timer().
+ */
+
+extern struct list_node g_wdtimerwheel[CONFIG_WDOG_TIMER_WHEEL_SIZE];
+extern clock_t g_wdlasttick;
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern struct list_node g_wdactivelist;
+#endif
 
 #ifdef CONFIG_SCHED_TICKLESS
 extern bool g_wdtimernested;
@@ -115,15 +138,36 @@ static inline_function void wd_timer_cancel(void)
 #  define wd_timer_cancel()
 #endif
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 static inline_function clock_t wd_next_expire(void)
 {
   return list_first_entry(&g_wdactivelist, struct wdog_s, node)->expired;
 }
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wd_initialize
+ *
+ * Description:
+ *   Initialize the watchdog timer wheel.  This must be called before any
+ *   watchdog is started.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+void wd_initialize(void);
+#endif
+
 /****************************************************************************
  * Name: wd_timer
  *
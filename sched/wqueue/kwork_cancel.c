@@ -60,6 +60,14 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
 
   flags = spin_lock_irqsave(&wqueue->lock);
 
+#ifdef CONFIG_WQUEUE_WORKSTEAL
+  /* The work may sit on the list of any worker, and the running work and
+   * the waiters of each worker are protected by its lock.
+   */
+
+  work_lock_workers(wqueue);
+#endif
+
   if (!work_available(work))
     {
       /* If the head of the pending queue has changed, we should reset
@@ -95,6 +103,10 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
         }
     }
 
+#ifdef CONFIG_WQUEUE_WORKSTEAL
+  work_unlock_workers(wqueue);
+#endif
+
   spin_unlock_irqrestore(&wqueue->lock, flags);
 
   if (sync_wait)
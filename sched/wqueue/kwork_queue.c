@@ -34,12 +34,89 @@
 #include <nuttx/arch.h>
 #include <nuttx/clock.h>
 #include <nuttx/list.h>
+#include <nuttx/sched.h>
 #include <nuttx/wqueue.h>
 
 #include "wqueue/wqueue.h"
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_queue_locked
+ *
+ * Description:
+ *   Queue one work with the wqueue lock held: remove it if it is still
+ *   queued and insert it into the pending or the expired list.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue handle
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   True if the head of the pending queue has changed, i.e. the wqueue
+ *   timer must be reset.
+ *
+ ****************************************************************************/
+
+static bool work_queue_locked(FAR struct kwork_wqueue_s *wqueue,
+                              FAR struct work_s *work, worker_t worker,
+                              FAR void *arg, clock_t delay)
+{
+  bool retimer;
+
+  /* Ensure the work has been removed. */
+
+#ifdef CONFIG_WQUEUE_WORKSTEAL
+  /* A worker may take the queued work without holding wqueue->lock, so
+   * check again once all the worker lists are locked.
+   */
+
+  retimer = false;
+  if (!work_available(work))
+    {
+      work_lock_workers(wqueue);
+      retimer = !work_available(work) && work_remove(wqueue, work);
+      work_unlock_workers(wqueue);
+    }
+#else
+  retimer = work_available(work) ? false : work_remove(wqueue, work);
+#endif
+
+  /* Initialize the work structure. */
+
+  work->worker = worker;                     /* Non-NULL means queued */
+  work->arg    = arg;                        /* Callback argument */
+  work->qtime  = clock_delay2abstick(delay); /* Expected time */
+
+  if (delay)
+    {
+      /* Insert to the pending list of the wqueue.  The timer must be
+       * restarted if the work is the earliest expired work.
+       */
+
+      if (work_insert_pending(wqueue, work))
+        {
+          retimer = true;
+        }
+    }
+  else
+    {
+      /* Insert to the expired list of the wqueue. */
+
+      work_insert_expired(wqueue, work);
+    }
+
+  return retimer;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -103,7 +180,7 @@ int work_queue_next_wq(FAR struct kwork_wqueue_s *wqueue,
     {
       /* Insert to the expired list of the wqueue. */
 
-      list_add_tail(&wqueue->expired, &work->node);
+      work_insert_expired(wqueue, work);
     }
 
   spin_unlock_irqrestore(&wqueue->lock, flags);
@@ -159,8 +236,6 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
                   FAR void *arg, clock_t delay)
 {
   irqstate_t flags;
-  clock_t expected;
-  bool retimer;
 
   if (wqueue == NULL || work == NULL || worker == NULL ||
       delay > WDOG_MAX_DELAY)
@@ -168,42 +243,94 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
       return -EINVAL;
     }
 
-  expected = clock_delay2abstick(delay);
-
   /* Interrupts are disabled so that this logic can be called from with
    * task logic or from interrupt handling logic.
    */
 
   flags = spin_lock_irqsave(&wqueue->lock);
 
-  /* Ensure the work has been removed. */
+  if (work_queue_locked(wqueue, work, worker, arg, delay))
+    {
+      work_timer_reset(wqueue);
+    }
 
-  retimer = work_available(work) ? false : work_remove(wqueue, work);
+  spin_unlock_irqrestore(&wqueue->lock, flags);
 
-  /* Initialize the work structure. */
+  if (!delay)
+    {
+      /* Immediately wake up the worker thread. */
 
-  work->worker = worker;   /* Work callback. non-NULL means queued */
-  work->arg    = arg;      /* Callback argument */
-  work->qtime  = expected; /* Expected time */
+      nxsem_post(&wqueue->sem);
+    }
 
-  if (delay)
+  return 0;
+}
+
+int work_queue(int qid, FAR struct work_s *work, worker_t worker,
+               FAR void *arg, clock_t delay)
+{
+  return work_queue_wq(work_qid2wq(qid), work, worker, arg, delay);
+}
+
+/****************************************************************************
+ * Name: work_queue_batch/work_queue_batch_wq
+ *
+ * Description:
+ *   Queue several works at once.  Each entry behaves as a work_queue()
+ *   call, but all of them are queued under a single acquisition of the
+ *   wqueue lock, the wqueue timer is reset at most once and the worker
+ *   threads are woken up with the scheduler locked, so that the burst
+ *   causes a single reschedule.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue - The work queue handle
+ *   batch  - The array of works to queue
+ *   nitems - The number of entries in batch
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure.  Nothing is queued if
+ *   any entry is invalid.
+ *
+ ****************************************************************************/
+
+int work_queue_batch_wq(FAR struct kwork_wqueue_s *wqueue,
+                        FAR const struct work_batch_s *batch,
+                        size_t nitems)
+{
+  irqstate_t flags;
+  size_t nposts = 0;
+  bool retimer = false;
+  size_t i;
+
+  if (wqueue == NULL || (batch == NULL && nitems > 0))
     {
-      /* Insert to the pending list of the wqueue. */
+      return -EINVAL;
+    }
 
-      if (work_insert_pending(wqueue, work))
+  for (i = 0; i < nitems; i++)
+    {
+      if (batch[i].work == NULL || batch[i].worker == NULL ||
+          batch[i].delay > WDOG_MAX_DELAY)
         {
-          /* Start the timer if the work is the earliest expired work. */
-
-          retimer = false;
-          wd_start_abstick(&wqueue->timer, work->qtime,
-                           work_timer_expired, (wdparm_t)wqueue);
+          return -EINVAL;
         }
     }
-  else
+
+  flags = spin_lock_irqsave(&wqueue->lock);
+
+  for (i = 0; i < nitems; i++)
     {
-      /* Insert to the expired list of the wqueue. */
+      if (work_queue_locked(wqueue, batch[i].work, batch[i].worker,
+                            batch[i].arg, batch[i].delay))
+        {
+          retimer = true;
+        }
 
-      list_add_tail(&wqueue->expired, &work->node);
+      if (!batch[i].delay)
+        {
+          nposts++;
+        }
     }
 
   if (retimer)
@@ -213,20 +340,30 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
 
   spin_unlock_irqrestore(&wqueue->lock, flags);
 
-  if (!delay)
+  /* Every worker thread performs one work per semaphore count, so one
+   * count is still needed per immediate work.  Holding the scheduler lock
+   * lets a higher priority worker run only once, after the whole batch.
+   */
+
+  if (nposts > 0)
     {
-      /* Immediately wake up the worker thread. */
+      sched_lock();
 
-      nxsem_post(&wqueue->sem);
+      while (nposts-- > 0)
+        {
+          nxsem_post(&wqueue->sem);
+        }
+
+      sched_unlock();
     }
 
   return 0;
 }
 
-int work_queue(int qid, FAR struct work_s *work, worker_t worker,
-               FAR void *arg, clock_t delay)
+int work_queue_batch(int qid, FAR const struct work_batch_s *batch,
+                     size_t nitems)
 {
-  return work_queue_wq(work_qid2wq(qid), work, worker, arg, delay);
+  return work_queue_batch_wq(work_qid2wq(qid), batch, nitems);
 }
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -147,7 +147,7 @@ void work_dispatch(FAR struct kwork_wqueue_s *wq)
       /* Expired work will be moved to tail of the expired queue. */
 
       list_delete(&work->node);
-      list_add_tail(&wq->expired, &work->node);
+      work_insert_expired(wq, work);
 
       /* Note that the thread execution this function is also
        * a worker thread, which has already been woken up by the timer.
@@ -161,6 +161,140 @@ void work_dispatch(FAR struct kwork_wqueue_s *wq)
     }
 }
 
+/****************************************************************************
+ * Name: work_find
+ *
+ * Description:
+ *   Find a worker with expired work, starting with the calling worker and
+ *   then stealing from the others.  The lists are peeked without the lock
+ *   first: the work was queued before the wqueue semaphore was posted.
+ *
+ * Input Parameters:
+ *   wqueue  - The work queue
+ *   kworker - The calling worker
+ *
+ * Returned Value:
+ *   The worker whose list is not empty, with its lock held, or NULL.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_WORKSTEAL
+static FAR struct kworker_s *work_find(FAR struct kwork_wqueue_s *wqueue,
+                                       FAR struct kworker_s *kworker)
+{
+  FAR struct kworker_s *worker = wq_get_worker(wqueue);
+  FAR struct kworker_s *victim;
+  int self = kworker - worker;
+  int wndx;
+
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      victim = &worker[(self + wndx) % wqueue->nthreads];
+      if (list_is_empty(&victim->expired))
+        {
+          continue;
+        }
+
+      spin_lock(&victim->lock);
+      if (!list_is_empty(&victim->expired))
+        {
+          return victim;
+        }
+
+      spin_unlock(&victim->lock);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: work_thread_steal
+ *
+ * Description:
+ *   Perform one expired work, if any, from the list of this worker or,
+ *   when it is empty, from the list of another worker of the queue.  The
+ *   queue-wide lock is only taken when the wqueue timer may have expired.
+ *
+ * Input Parameters:
+ *   wqueue  - The work queue
+ *   kworker - The calling worker
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void work_thread_steal(FAR struct kwork_wqueue_s *wqueue,
+                              FAR struct kworker_s *kworker)
+{
+  FAR struct kworker_s *victim;
+  FAR struct work_s    *work;
+  worker_t      worker;
+  irqstate_t    flags;
+  FAR void     *arg;
+
+  flags = up_irq_save();
+
+  kworker->cpu = this_cpu();
+
+  /* If the wqueue timer is expired and non-active, it indicates that
+   * there might be expired work in the pending queue.
+   */
+
+  if (!WDOG_ISACTIVE(&wqueue->timer))
+    {
+      spin_lock(&wqueue->lock);
+      if (!WDOG_ISACTIVE(&wqueue->timer))
+        {
+          work_dispatch(wqueue);
+        }
+
+      spin_unlock(&wqueue->lock);
+    }
+
+  victim = work_find(wqueue, kworker);
+  if (victim == NULL)
+    {
+      up_irq_restore(flags);
+      return;
+    }
+
+  work = list_first_entry(&victim->expired, struct work_s, node);
+
+  list_delete(&work->node);
+
+  worker = work->worker;
+  arg    = work->arg;
+
+  /* Return the work structure ownership to the work owner and mark the
+   * thread busy while the lock of the list is still held, so that
+   * work_cancel_sync() sees the work either queued or running.
+   */
+
+  work->worker  = NULL;
+  kworker->work = work;
+
+  spin_unlock(&victim->lock);
+  up_irq_restore(flags);
+
+  CALL_WORKER(worker, arg);
+
+  flags = spin_lock_irqsave(&kworker->lock);
+
+  /* Mark the thread un-busy and wake up the waiters, if any */
+
+  kworker->work = NULL;
+
+  while (kworker->wait_count > 0)
+    {
+      kworker->wait_count--;
+      nxsem_post(&kworker->wait);
+    }
+
+  spin_unlock_irqrestore(&kworker->lock, flags);
+}
+#endif
+
 /****************************************************************************
  * Name: work_thread
  *
@@ -187,10 +321,12 @@ static int work_thread(int argc, FAR char *argv[])
 {
   FAR struct kwork_wqueue_s *wqueue;
   FAR struct kworker_s      *kworker;
+#ifndef CONFIG_WQUEUE_WORKSTEAL
   FAR struct work_s         *work;
   worker_t      worker;
   irqstate_t    flags;
   FAR void     *arg;
+#endif
 
   /* Get the handle from argv */
 
@@ -206,6 +342,9 @@ static int work_thread(int argc, FAR char *argv[])
 
   while (!wqueue->exit)
     {
+#ifdef CONFIG_WQUEUE_WORKSTEAL
+      work_thread_steal(wqueue, kworker);
+#else
       /* And check first entry in the work queue. Since we have disabled
        * interrupts we know:  (1) we will not be suspended unless we do
        * so ourselves, and (2) there will be no changes to the work queue
@@ -269,6 +408,7 @@ static int work_thread(int argc, FAR char *argv[])
         }
 
       spin_unlock_irqrestore_nopreempt(&wqueue->lock, flags);
+#endif
 
       /* Wait for the semaphore to be posted by the wqueue timer. */
 
@@ -318,6 +458,11 @@ static int work_thread_create(FAR const char *name, int priority,
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
     {
       nxsem_init(&worker[wndx].wait, 0, 0);
+#ifdef CONFIG_WQUEUE_WORKSTEAL
+      list_initialize(&worker[wndx].expired);
+      spin_lock_init(&worker[wndx].lock);
+      worker[wndx].cpu = wndx % CONFIG_SMP_NCPUS;
+#endif
 
       snprintf(arg0, sizeof(arg0), "%p", wqueue);
       snprintf(arg1, sizeof(arg1), "%p", &worker[wndx]);
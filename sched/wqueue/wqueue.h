@@ -67,6 +67,11 @@ struct kworker_s
   FAR struct work_s *work;     /* The work structure */
   sem_t             wait;      /* Sync waiting for worker done */
   int16_t           wait_count;
+#ifdef CONFIG_WQUEUE_WORKSTEAL
+  struct list_node  expired;   /* The expired work queued to this worker */
+  spinlock_t        lock;      /* Protects expired, work and wait_count */
+  uint8_t           cpu;       /* The CPU this worker last ran on */
+#endif
 };
 
 /* This structure defines the state of one kernel-mode work queue */
@@ -209,12 +214,103 @@ bool work_insert_pending(FAR struct kwork_wqueue_s *wqueue,
   return curr == head;
 }
 
+/****************************************************************************
+ * Name: work_insert_expired
+ *
+ * Description:
+ *   Internal public function to queue work for immediate execution.
+ *   With CONFIG_WQUEUE_WORKSTEAL the work is queued to the worker that
+ *   last ran on the calling CPU, so that it preferably runs there.
+ *   Require wqueue != NULL, work != NULL and wqueue->lock held.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *   work   - The work to be inserted.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+static inline_function
+void work_insert_expired(FAR struct kwork_wqueue_s *wqueue,
+                         FAR struct work_s         *work)
+{
+#ifdef CONFIG_WQUEUE_WORKSTEAL
+  FAR struct kworker_s *worker = wq_get_worker(wqueue);
+  FAR struct kworker_s *target;
+  int cpu = this_cpu();
+  int wndx;
+
+  target = &worker[cpu % wqueue->nthreads];
+
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      if (worker[wndx].cpu == cpu)
+        {
+          target = &worker[wndx];
+          break;
+        }
+    }
+
+  spin_lock(&target->lock);
+  list_add_tail(&target->expired, &work->node);
+  spin_unlock(&target->lock);
+#else
+  list_add_tail(&wqueue->expired, &work->node);
+#endif
+}
+
+/****************************************************************************
+ * Name: work_lock_workers/work_unlock_workers
+ *
+ * Description:
+ *   Internal public functions to take (release) the locks of all the
+ *   workers of the workqueue, so that a queued work can be found on any
+ *   of their lists.  The locks are taken after wqueue->lock and in index
+ *   order.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_WORKSTEAL
+static inline_function
+void work_lock_workers(FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR struct kworker_s *worker = wq_get_worker(wqueue);
+  int wndx;
+
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      spin_lock(&worker[wndx].lock);
+    }
+}
+
+static inline_function
+void work_unlock_workers(FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR struct kworker_s *worker = wq_get_worker(wqueue);
+  int wndx;
+
+  for (wndx = wqueue->nthreads - 1; wndx >= 0; wndx--)
+    {
+      spin_unlock(&worker[wndx].lock);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: work_remove
  *
  * Description:
  *   Internal public function to remove the work from the workqueue.
- *   Require wqueue != NULL and work != NULL.
+ *   Require wqueue != NULL and work != NULL.  With
+ *   CONFIG_WQUEUE_WORKSTEAL the locks of all workers must be held too.
  *
  * Input Parameters:
  *   wqueue - The work queue.
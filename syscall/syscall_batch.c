@@ -0,0 +1,92 @@
+/****************************************************************************
+ * syscall/syscall_batch.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <syscall.h>
+#include <errno.h>
+
+#ifdef CONFIG_LIB_SYSCALL_BATCH
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syscall_batch
+ *
+ * Description:
+ *   Execute 'ncalls' system calls described by the array 'calls' with a
+ *   single trap into the kernel.  Each call goes through the same stub as
+ *   if it had been made on its own; its result is stored in 'ret' and the
+ *   errno value it left (zero if none) in 'errcode'.
+ *
+ *   All numbers are validated before any call is made.  The batch system
+ *   call itself may not appear in the array.
+ *
+ * Input Parameters:
+ *   calls  - The array of system call requests
+ *   ncalls - The number of entries in 'calls'
+ *
+ * Returned Value:
+ *   The number of calls executed on success; -1 with errno set to EINVAL
+ *   on an invalid request.
+ *
+ ****************************************************************************/
+
+int syscall_batch(FAR struct syscall_batch_s *calls, size_t ncalls)
+{
+  size_t i;
+
+  if (calls == NULL && ncalls > 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  for (i = 0; i < ncalls; i++)
+    {
+      if (calls[i].nbr < CONFIG_SYS_RESERVED ||
+          calls[i].nbr >= SYS_maxsyscall ||
+          calls[i].nbr == SYS_syscall_batch)
+        {
+          set_errno(EINVAL);
+          return ERROR;
+        }
+    }
+
+  for (i = 0; i < ncalls; i++)
+    {
+      set_errno(0);
+      calls[i].ret     = syscall_dispatch(calls[i].nbr, calls[i].parm);
+      calls[i].errcode = get_errno();
+    }
+
+  return (int)ncalls;
+}
+
+#endif /* CONFIG_LIB_SYSCALL_BATCH */
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <assert.h>
 #include <syscall.h>
 
 /* The content of this file is only meaningful during the kernel phase of
@@ -66,6 +67,23 @@
 
 #define STUB_PROT(f, n) CAT(STUB_PROT, n)(f)
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One exact prototype per stub arity */
+
+typedef uintptr_t (*stub0_t)(int);
+typedef uintptr_t (*stub1_t)(int, uintptr_t);
+typedef uintptr_t (*stub2_t)(int, uintptr_t, uintptr_t);
+typedef uintptr_t (*stub3_t)(int, uintptr_t, uintptr_t, uintptr_t);
+typedef uintptr_t (*stub4_t)(int, uintptr_t, uintptr_t, uintptr_t,
+                             uintptr_t);
+typedef uintptr_t (*stub5_t)(int, uintptr_t, uintptr_t, uintptr_t,
+                             uintptr_t, uintptr_t);
+typedef uintptr_t (*stub6_t)(int, uintptr_t, uintptr_t, uintptr_t,
+                             uintptr_t, uintptr_t, uintptr_t);
+
 /****************************************************************************
  * Stub Function Prototypes
  ****************************************************************************/
@@ -94,8 +112,75 @@ const uintptr_t g_stublookup[SYS_nsyscalls] =
 #  undef SYSCALL_LOOKUP
 };
 
+/* Stub arity table.  Also indexed by the system call number, this gives
+ * the number of parameters that the stub function really takes so that
+ * a dispatcher only has to move that many arguments.
+ */
+
+const uint8_t g_stubnparms[SYS_nsyscalls] =
+{
+#  define SYSCALL_LOOKUP1(f,n) n
+#  define SYSCALL_LOOKUP(f,n)  , n
+#  include <sys/syscall_lookup.h>
+#  undef SYSCALL_LOOKUP1
+#  undef SYSCALL_LOOKUP
+};
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: syscall_dispatch
+ *
+ * Description:
+ *   Call the stub function for system call 'nbr' through a trampoline
+ *   that matches its arity, so that only the parameters that are actually
+ *   used are loaded.
+ *
+ * Input Parameters:
+ *   nbr  - The system call number (including CONFIG_SYS_RESERVED)
+ *   parm - The system call parameters; only the first g_stubnparms[]
+ *          entries are referenced.
+ *
+ * Returned Value:
+ *   The value returned by the stub function.
+ *
+ ****************************************************************************/
+
+uintptr_t syscall_dispatch(unsigned int nbr, FAR const uintptr_t *parm)
+{
+  unsigned int index = nbr - CONFIG_SYS_RESERVED;
+  uintptr_t stub;
+
+  DEBUGASSERT(index < SYS_nsyscalls);
+
+  stub = g_stublookup[index];
+  switch (g_stubnparms[index])
+    {
+      case 0:
+        return ((stub0_t)stub)(nbr);
+
+      case 1:
+        return ((stub1_t)stub)(nbr, parm[0]);
+
+      case 2:
+        return ((stub2_t)stub)(nbr, parm[0], parm[1]);
+
+      case 3:
+        return ((stub3_t)stub)(nbr, parm[0], parm[1], parm[2]);
+
+      case 4:
+        return ((stub4_t)stub)(nbr, parm[0], parm[1], parm[2], parm[3]);
+
+      case 5:
+        return ((stub5_t)stub)(nbr, parm[0], parm[1], parm[2], parm[3],
+                               parm[4]);
+
+      default:
+        return ((stub6_t)stub)(nbr, parm[0], parm[1], parm[2], parm[3],
+                               parm[4], parm[5]);
+    }
+}
+
 #endif /* CONFIG_LIB_SYSCALL */
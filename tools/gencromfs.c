@@ -34,6 +34,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <dirent.h>
+#include <fnmatch.h>
 #include <limits.h>
 #include <errno.h>
 
@@ -95,6 +96,10 @@
 #define CROMFS_MAGIC       0x4d4f5243
 #define CROMFS_BLOCKSIZE   512
 
+#define CROMFS_NODE_XIP    (1 << 0)   /* Must match fs/cromfs/cromfs.h */
+#define CROMFS_XIPALIGN    4096       /* Default alignment of XIP data */
+#define CROMFS_MAXXIP      32         /* Maximum number of -x patterns */
+
 #define LZF_BUFSIZE        512
 #define LZF_HLOG           13
 #define LZF_HSIZE          (1 << LZF_HLOG)
@@ -142,7 +147,7 @@ struct cromfs_volume_s
 struct cromfs_node_s
 {
   uint16_t cn_mode;       /* File type, attributes, and access mode bits */
-  uint16_t cn_pad;        /* Not used */
+  uint16_t cn_flags;      /* CROMFS_NODE_XIP if stored uncompressed */
   uint32_t cn_name;       /* Offset from the beginning of the volume header to the
                            * node name string.  NUL-terminated. */
   uint32_t cn_size;       /* Size of the uncompressed data (in bytes) */
@@ -257,6 +262,14 @@ static unsigned int g_nhex;    /* Number of hex characters on output line */
 static unsigned int g_ntmps;   /* Number temporary files */
 #endif
 
+/* Files stored uncompressed so that they can be executed in place */
+
+static const char *g_xippatterns[CROMFS_MAXXIP];
+static unsigned int g_nxippatterns;
+static bool g_xipexec;                      /* All executable files */
+static uint32_t g_xipalign = CROMFS_XIPALIGN;
+static uint32_t g_imgalign = 4;             /* Alignment of the image */
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -276,6 +289,7 @@ static void dump_nextline(FILE *stream);
 static size_t lzf_compress(const uint8_t *inbuffer, unsigned int inlen,
                            union lzf_result_u *result);
 static uint16_t get_mode(mode_t mode);
+static bool is_xipfile(const char *path, const char *name, mode_t mode);
 #ifdef HOST_TGTSWAP
 static inline uint16_t tgt_uint16(uint16_t a);
 static inline uint32_t tgt_uint32(uint32_t a);
@@ -303,7 +317,21 @@ static int  traverse_directory(const char *dirpath,
 
 static void show_usage(void)
 {
-  fprintf(stderr, "USAGE: %s <dir-path> <out-file>\n", g_progname);
+  fprintf(stderr,
+          "USAGE: %s [-a <align>] [-e] [-x <pattern>]... "
+          "<dir-path> <out-file>\n\n", g_progname);
+  fprintf(stderr,
+          "  -a <align>    Alignment of uncompressed file data, a power\n"
+          "                of two.  Default: %u\n", CROMFS_XIPALIGN);
+  fprintf(stderr,
+          "  -e            Store all executable files uncompressed\n");
+  fprintf(stderr,
+          "  -x <pattern>  Store files whose name or path relative to\n"
+          "                <dir-path> matches <pattern> uncompressed.\n"
+          "                May be repeated.\n\n");
+  fprintf(stderr,
+          "Uncompressed files are aligned in the image so that they can\n"
+          "be mapped and executed in place.\n");
   exit(1);
 }
 
@@ -866,6 +894,28 @@ static inline uint32_t tgt_uint32(uint32_t a)
 }
 #endif
 
+static bool is_xipfile(const char *path, const char *name, mode_t mode)
+{
+  const char *relpath = path + strlen(g_dirname) + 1;
+  unsigned int i;
+
+  if (g_xipexec && (mode & (S_IXUSR | S_IXGRP | S_IXOTH)) != 0)
+    {
+      return true;
+    }
+
+  for (i = 0; i < g_nxippatterns; i++)
+    {
+      if (fnmatch(g_xippatterns[i], relpath, 0) == 0 ||
+          fnmatch(g_xippatterns[i], name, 0) == 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
 static void gen_dirlink(const char *name, uint32_t tgtoffs, bool dirempty)
 {
   struct cromfs_node_s node;
@@ -879,7 +929,7 @@ static void gen_dirlink(const char *name, uint32_t tgtoffs, bool dirempty)
           (unsigned long)g_offset, name);
 
   node.cn_mode    = TGT_UINT16(DIRLINK_MODEFLAGS);
-  node.cn_pad     = 0;
+  node.cn_flags   = 0;
 
   g_offset       += sizeof(struct cromfs_node_s);
   node.cn_name    = TGT_UINT32(g_offset);
@@ -962,7 +1012,7 @@ static void gen_directory(const char *path, const char *name, mode_t mode,
           (unsigned long)save_offset, path);
 
   node.cn_mode    = TGT_UINT16(NUTTX_IFDIR | get_mode(mode));
-  node.cn_pad     = 0;
+  node.cn_flags   = 0;
 
   save_offset    += sizeof(struct cromfs_node_s);
   node.cn_name    = TGT_UINT32(save_offset);
@@ -995,11 +1045,13 @@ static void gen_file(const char *path, const char *name, mode_t mode,
   FILE *outstream;
   FILE *instream;
   uint8_t iobuffer[LZF_BUFSIZE];
+  uint32_t dataoffs;
   size_t nread;
   size_t ntotal;
   size_t blklen;
   size_t blktotal;
   unsigned int blkno;
+  bool xip;
   int namlen;
 
   namlen      = strlen(name) + 1;
@@ -1027,46 +1079,98 @@ static void gen_file(const char *path, const char *name, mode_t mode,
   blkno       = 0;
   ntotal      = 0;
   blktotal    = 0;
+  dataoffs    = g_offset;
+  xip         = is_xipfile(path, name, mode);
 
-  do
+  if (xip)
     {
-      /* Read the next chunk from the file */
+      static const uint8_t zero;
+      uint32_t padlen;
 
-      nread = fread(iobuffer, 1, LZF_BUFSIZE, instream);
-      if (nread > 0)
-        {
-          uint16_t clen;
+      /* Pad so that the raw file data starts on an aligned offset.  The
+       * image itself is given the same alignment.
+       */
 
-          /* Compress the chunk */
+      padlen = ((g_offset + g_xipalign - 1) & ~(g_xipalign - 1)) - g_offset;
+      if (padlen > 0)
+        {
+          fprintf(g_tmpstream, "\n  /* Offset %6lu:  Padding %lu */\n\n",
+                  (unsigned long)g_offset, (unsigned long)padlen);
 
-          blklen = lzf_compress(iobuffer, nread, &result);
-          if (result.cmn.lzf_type == LZF_TYPE0_HDR)
+          for (blklen = 0; blklen < padlen; blklen++)
             {
-              clen = nread;
-            }
-          else
-            {
-              clen = (uint16_t)result.compressed.lzf_clen[0] << 8 |
-                     (uint16_t)result.compressed.lzf_clen[1];
+              dump_hexbuffer(g_tmpstream, &zero, 1);
             }
 
-          fprintf(g_tmpstream,
-                  "\n  /* Offset %6lu:  "
-                  "Block %u blklen=%lu Uncompressed=%lu Compressed=%u "
-                  "*/\n\n",  (unsigned long)g_offset, blkno, (long)blklen,
-                  (long)nread, clen);
-          dump_hexbuffer(g_tmpstream, &result, blklen);
           dump_nextline(g_tmpstream);
+        }
+
+      g_offset += padlen;
+      blktotal  = padlen;
+      dataoffs  = g_offset;
+
+      if (g_imgalign < g_xipalign)
+        {
+          g_imgalign = g_xipalign;
+        }
+
+      fprintf(g_tmpstream, "\n  /* Offset %6lu:  Uncompressed data */\n\n",
+              (unsigned long)g_offset);
+
+      while ((nread = fread(iobuffer, 1, LZF_BUFSIZE, instream)) > 0)
+        {
+          dump_hexbuffer(g_tmpstream, iobuffer, nread);
 
           ntotal   += nread;
-          blktotal += blklen;
-          g_offset += blklen;
+          blktotal += nread;
+          g_offset += nread;
+        }
+
+      dump_nextline(g_tmpstream);
+      g_nblocks += (ntotal + CROMFS_BLOCKSIZE - 1) / CROMFS_BLOCKSIZE;
+    }
+  else
+    {
+      do
+        {
+          /* Read the next chunk from the file */
 
-          g_nblocks++;
-          blkno++;
+          nread = fread(iobuffer, 1, LZF_BUFSIZE, instream);
+          if (nread > 0)
+            {
+              uint16_t clen;
+
+              /* Compress the chunk */
+
+              blklen = lzf_compress(iobuffer, nread, &result);
+              if (result.cmn.lzf_type == LZF_TYPE0_HDR)
+                {
+                  clen = nread;
+                }
+              else
+                {
+                  clen = (uint16_t)result.compressed.lzf_clen[0] << 8 |
+                         (uint16_t)result.compressed.lzf_clen[1];
+                }
+
+              fprintf(g_tmpstream,
+                      "\n  /* Offset %6lu:  "
+                      "Block %u blklen=%lu Uncompressed=%lu Compressed=%u "
+                      "*/\n\n",  (unsigned long)g_offset, blkno,
+                      (long)blklen, (long)nread, clen);
+              dump_hexbuffer(g_tmpstream, &result, blklen);
+              dump_nextline(g_tmpstream);
+
+              ntotal   += nread;
+              blktotal += blklen;
+              g_offset += blklen;
+
+              g_nblocks++;
+              blkno++;
+            }
         }
+      while (nread > 0);
     }
-  while (nread > 0);
 
   /* Restore the old tmpfile context */
 
@@ -1080,7 +1184,7 @@ static void gen_file(const char *path, const char *name, mode_t mode,
           (unsigned long)blktotal);
 
   node.cn_mode       = TGT_UINT16(NUTTX_IFREG | get_mode(mode));
-  node.cn_pad        = 0;
+  node.cn_flags      = TGT_UINT16(xip ? CROMFS_NODE_XIP : 0);
 
   nodeoffs          += sizeof(struct cromfs_node_s);
   node.cn_name       = TGT_UINT32(nodeoffs);
@@ -1088,7 +1192,7 @@ static void gen_file(const char *path, const char *name, mode_t mode,
   node.cn_size       = TGT_UINT32(ntotal);
 
   nodeoffs          += namlen;
-  node.u.cn_blocks   = TGT_UINT32(nodeoffs);
+  node.u.cn_blocks   = TGT_UINT32(dataoffs);
 
   nodeoffs          += blktotal;
   node.cn_peer       = TGT_UINT32(lastentry ? 0 : nodeoffs);
@@ -1254,20 +1358,55 @@ int main(int argc, char **argv, char **envp)
   struct cromfs_volume_s vol;
   char *ptr;
   int result;
+  int option;
 
   /* Verify arguments */
 
   ptr = strrchr(argv[0], '/');
   g_progname = ptr == NULL ? argv[0] : ptr + 1;
 
-  if (argc != 3)
+  while ((option = getopt(argc, argv, "a:ex:h")) > 0)
+    {
+      switch (option)
+        {
+          case 'a':
+            g_xipalign = strtoul(optarg, &ptr, 0);
+            if (*ptr != '\0' || g_xipalign == 0 ||
+                (g_xipalign & (g_xipalign - 1)) != 0)
+              {
+                fprintf(stderr, "ERROR: Invalid alignment: %s\n", optarg);
+                show_usage();
+              }
+            break;
+
+          case 'e':
+            g_xipexec = true;
+            break;
+
+          case 'x':
+            if (g_nxippatterns >= CROMFS_MAXXIP)
+              {
+                fprintf(stderr, "ERROR: Too many -x patterns\n");
+                show_usage();
+              }
+
+            g_xippatterns[g_nxippatterns++] = optarg;
+            break;
+
+          case 'h':
+          default:
+            show_usage();
+        }
+    }
+
+  if (argc - optind != 2)
     {
       fprintf(stderr, "Unexpected number of arguments\n");
       show_usage();
     }
 
-  g_dirname  = argv[1];
-  g_outname  = argv[2];
+  g_dirname  = argv[optind];
+  g_outname  = argv[optind + 1];
 
   verify_directory();
   verify_outfile();
@@ -1312,7 +1451,9 @@ int main(int argc, char **argv, char **envp)
   /* Now append the volume header to output file */
 
   fprintf(g_outstream, "/* CROMFS image */\n\n");
-  fprintf(g_outstream, "const uint8_t aligned_data(4) g_cromfs_image[] =\n");
+  fprintf(g_outstream,
+          "const uint8_t aligned_data(%lu) g_cromfs_image[] =\n",
+          (unsigned long)g_imgalign);
   fprintf(g_outstream, "{\n");
   fprintf(g_outstream, "  /* Offset %6lu:  Volume header */\n\n", 0ul);
 
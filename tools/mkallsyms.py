@@ -48,6 +48,7 @@ class SymbolTables(object):
             self.elffile = None
         self.output = output
         self.symbol_list = []
+        self.orderbyhash = False
 
     def symbol_filter(self, symbol):
         if symbol["st_info"]["type"] != "STT_FUNC":
@@ -74,6 +75,24 @@ class SymbolTables(object):
             "%s struct symtab_s g_allsyms[%d + 2] =\n{"
             % (noconst, len(self.symbol_list))
         )
+        # The boundaries keep their place in a table ordered by hash with the
+        # lowest and the highest hash
+
+        if self.orderbyhash:
+            self.emitline(
+                '  { "Unknown", (FAR %s void *)0x00000000, 0x00000000 },' % (noconst)
+            )
+            for symbol in self.symbol_list:
+                self.emitline(
+                    '  { "%s", (FAR %s void *)%s, 0x%08x },'
+                    % (symbol[1], noconst, hex(symbol[0]), gnu_hash(symbol[1]))
+                )
+            self.emitline(
+                '  { "Unknown", (FAR %s void *)0xffffffff, 0xffffffff }\n};'
+                % (noconst)
+            )
+            return
+
         self.emitline('  { "Unknown", (FAR %s void *)0x00000000 },' % (noconst))
         for symbol in self.symbol_list:
             self.emitline(
@@ -101,7 +120,7 @@ class SymbolTables(object):
 
             return section
 
-    def parse_symbol(self, orderbyname=False):
+    def parse_symbol(self, orderbyname=False, orderbyhash=False):
         if self.elffile is None:
             return
         symtable = self.get_symtable()
@@ -113,7 +132,12 @@ class SymbolTables(object):
                 except cxxfilt.InvalidName:
                     symbol_name = symbol.name
                 self.symbol_list.append((symbol["st_value"], func_name))
-        if orderbyname:
+        self.orderbyhash = bool(orderbyhash)
+        if orderbyhash:
+            self.symbol_list = sorted(
+                self.symbol_list, key=lambda item: (gnu_hash(item[1]), item[1])
+            )
+        elif orderbyname:
             self.symbol_list = sorted(self.symbol_list, key=lambda item: item[1])
         else:
             self.symbol_list = sorted(self.symbol_list, key=lambda item: item[0])
@@ -122,6 +146,15 @@ class SymbolTables(object):
         self.output.write(str(s) + "\n")
 
 
+def gnu_hash(name):
+    # The same hash as symtab_hash()
+
+    h = 5381
+    for c in name.encode():
+        h = (h * 33 + c) & 0xFFFFFFFF
+    return h
+
+
 def usage():
     print(
         "Usage: mkallsyms.py [noconst] <ELFBIN> [output file] [order symbols by name]"
@@ -154,8 +187,15 @@ if __name__ == "__main__":
         default=False,
         help='Order symbols by name (specify "y" to enable, default: False).',
     )
+    parser.add_argument(
+        "--orderbyhash",
+        nargs="?",
+        const=False,
+        default=False,
+        help='Order symbols by hash (specify "y" to enable, default: False).',
+    )
     args = parser.parse_args()
 
     readelf = SymbolTables(args.elffile, args.outfile)
-    readelf.parse_symbol(args.orderbyname)
+    readelf.parse_symbol(args.orderbyname, args.orderbyhash)
     readelf.print_symbol_tables(args.noconst)
@@ -25,6 +25,7 @@
  ****************************************************************************/
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -45,6 +46,14 @@
  * Private Types
  ****************************************************************************/
 
+struct symbol_s
+{
+  char *name;         /* Symbol name */
+  char *cond;         /* Condition of the symbol, empty if none */
+  bool parm1;         /* A function, its address is its name */
+  uint32_t hash;      /* symtab_hash() of the name */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -52,6 +61,9 @@
 static const char *g_hdrfiles[MAX_HEADER_FILES];
 static int nhdrfiles;
 
+static struct symbol_s *g_symbols;
+static int nsymbols;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -118,6 +130,100 @@ static void add_hdrfile(const char *hdrfile)
     }
 }
 
+static void add_symbol(void)
+{
+  struct symbol_s *symbol;
+  const char *ptr;
+
+  symbol = realloc(g_symbols, (nsymbols + 1) * sizeof(*g_symbols));
+  if (symbol == NULL)
+    {
+      fprintf(stderr, "ERROR:  Out of memory\n");
+      exit(EXIT_FAILURE);
+    }
+
+  g_symbols = symbol;
+  symbol    = &g_symbols[nsymbols++];
+
+  symbol->name  = strdup(g_parm[NAME_INDEX]);
+  symbol->cond  = strdup(g_parm[COND_INDEX]);
+  symbol->parm1 = strlen(g_parm[PARM1_INDEX]) > 0;
+
+  /* The same hash as symtab_hash() */
+
+  symbol->hash = 5381;
+  for (ptr = symbol->name; *ptr != '\0'; ptr++)
+    {
+      symbol->hash = symbol->hash * 33 + (unsigned char)*ptr;
+    }
+}
+
+static int compare_hash(const void *arg1, const void *arg2)
+{
+  const struct symbol_s *symbol1 = arg1;
+  const struct symbol_s *symbol2 = arg2;
+
+  if (symbol1->hash != symbol2->hash)
+    {
+      return symbol1->hash < symbol2->hash ? -1 : 1;
+    }
+
+  return strcmp(symbol1->name, symbol2->name);
+}
+
+static void emit_symbols(FILE *outstream, bool hashed)
+{
+  const char *nextterm;
+  const char *finalterm;
+  bool cond;
+  int i;
+
+  nextterm  = "";
+  finalterm = "";
+
+  for (i = 0; i < nsymbols; i++)
+    {
+      struct symbol_s *symbol = &g_symbols[i];
+
+      /* Output any conditional compilation */
+
+      cond = strlen(symbol->cond) > 0;
+      if (cond)
+        {
+          fprintf(outstream, "%s#if %s\n", nextterm, symbol->cond);
+          nextterm  = "";
+        }
+
+      /* Output the symbol table entry */
+
+      fprintf(outstream, "%s  { \"%s\", (FAR const void *)%s%s",
+              nextterm, symbol->name, symbol->parm1 ? "" : "&",
+              symbol->name);
+
+      if (hashed)
+        {
+          fprintf(outstream, ", 0x%08x }", (unsigned int)symbol->hash);
+        }
+      else
+        {
+          fprintf(outstream, " }");
+        }
+
+      if (cond)
+        {
+          nextterm  = ",\n#endif\n";
+          finalterm = "\n#endif\n";
+        }
+      else
+        {
+          nextterm  = ",\n";
+          finalterm = "\n";
+        }
+    }
+
+  fprintf(outstream, "%s", finalterm);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -127,12 +233,8 @@ int main(int argc, char **argv, char **envp)
   char *csvpath;
   char *sympath;
   char *symtab;
-  char *nsymbols;
-  char *nextterm;
-  char *finalterm;
+  char *nsymname;
   char *ptr;
-  bool cond;
-  bool parm1;
   FILE *instream;
   FILE *outstream;
   int ch;
@@ -141,7 +243,7 @@ int main(int argc, char **argv, char **envp)
   /* Parse command line options */
 
   symtab   = SYMTAB_NAME;
-  nsymbols = NSYMBOLS_NAME;
+  nsymname = NSYMBOLS_NAME;
   g_debug  = false;
 
   while ((ch = getopt(argc, argv, ":d")) > 0)
@@ -192,7 +294,7 @@ int main(int argc, char **argv, char **envp)
 
   if (optind < argc)
     {
-       nsymbols = argv[optind];
+       nsymname = argv[optind];
        optind++;
     }
 
@@ -264,9 +366,6 @@ int main(int argc, char **argv, char **envp)
 
   /* Parse each line in the CVS file */
 
-  nextterm  = "";
-  finalterm = "";
-
   while ((ptr = read_line(instream)) != NULL)
     {
       /* Parse the line from the CVS file */
@@ -284,45 +383,24 @@ int main(int argc, char **argv, char **envp)
           exit(EXIT_FAILURE);
         }
 
-      /* Output any conditional compilation */
-
-      cond = strlen(g_parm[COND_INDEX]) > 0;
-      if (cond)
-        {
-          fprintf(outstream, "%s#if %s\n", nextterm, g_parm[COND_INDEX]);
-          nextterm  = "";
-        }
-
-      /* Output the symbol table entry */
+      add_symbol();
+    }
 
-      parm1 = strlen(g_parm[PARM1_INDEX]) > 0;
-      if (parm1)
-        {
-          fprintf(outstream, "%s  { \"%s\", (FAR const void *)%s }",
-                  nextterm, g_parm[NAME_INDEX], g_parm[NAME_INDEX]);
-        }
-      else
-        {
-          fprintf(outstream, "%s  { \"%s\", (FAR const void *)&%s }",
-                  nextterm, g_parm[NAME_INDEX], g_parm[NAME_INDEX]);
-        }
+  /* The symbols in the order of the CSV file, or ordered by the hash of
+   * their names with the hashes for CONFIG_SYMTAB_ORDEREDBYHASH.
+   */
 
-      if (cond)
-        {
-          nextterm  = ",\n#endif\n";
-          finalterm = "\n#endif\n";
-        }
-      else
-        {
-          nextterm  = ",\n";
-          finalterm = "\n";
-        }
-    }
+  fprintf(outstream, "#ifndef CONFIG_SYMTAB_ORDEREDBYHASH\n");
+  emit_symbols(outstream, false);
+  fprintf(outstream, "#else\n");
+  qsort(g_symbols, nsymbols, sizeof(*g_symbols), compare_hash);
+  emit_symbols(outstream, true);
+  fprintf(outstream, "#endif\n");
 
-  fprintf(outstream, "%s};\n\n", finalterm);
+  fprintf(outstream, "};\n\n");
   fprintf(outstream,
     "#define NSYMBOLS (sizeof(%s) / sizeof (struct symtab_s))\n", symtab);
-  fprintf(outstream, "int %s = NSYMBOLS;\n", nsymbols);
+  fprintf(outstream, "int %s = NSYMBOLS;\n", nsymname);
 
   /* Close the CSV and symbol table files and exit */
 
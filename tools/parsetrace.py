@@ -398,10 +398,15 @@ class ParseBinaryLogTool:
                 print(f"debug, dump one={mod.dump_one_trace()}")
 
 
+NOTE_PAGE_MAGIC = 0x4750544E
+
+
 class TraceDecoder(SymbolTables):
     def __init__(self, elffile):
         super().__init__(elffile)
         self.data = b""
+        self.pagedata = b""
+        self.pageseq = None
         self.typeinfo["time_t"] = "int%d" % (self.get_typesize("time_t") * 8)
 
     def note_common_define(self):
@@ -605,11 +610,40 @@ class TraceDecoder(SymbolTables):
 
             self.data = data[nc_length:]
 
-    def tty_received(self):
+    def parse_pages(self):
+        # Pages are produced by the paged noterpmsg client, see
+        # struct noterpmsg_page_s in drivers/note/noterpmsg.h
+
+        header = struct.Struct("<IIII")
+        while len(self.pagedata) >= header.size:
+            magic, seq, dropped, length = header.unpack_from(self.pagedata)
+            if magic != NOTE_PAGE_MAGIC or length < header.size:
+                logger.debug(f"skip one byte, data: {hex(self.pagedata[0])}")
+                self.pagedata = self.pagedata[1:]
+                continue
+
+            if len(self.pagedata) < length:
+                return
+
+            if self.pageseq is not None and seq != (self.pageseq + 1) & 0xFFFFFFFF:
+                logger.warning(f"pages lost between {self.pageseq} and {seq}")
+            if dropped:
+                logger.warning(f"{dropped} notes dropped before page {seq}")
+
+            self.pageseq = seq
+            self.data += self.pagedata[header.size : length]
+            self.pagedata = self.pagedata[length:]
+            self.parse_note()
+
+    def tty_received(self, pages=False):
         while True:
             data = ser.read(16384)
             if len(data) == 0:
                 continue
+            if pages:
+                self.pagedata += data
+                decode.parse_pages()
+                continue
             self.data += data
             logger.debug(f"serial buffer data: {self.data.hex()}")
             decode.parse_note()
@@ -624,6 +658,12 @@ def parse_arguments():
         "-b", "--baudrate", help="Physical serial device baud rate", default=115200
     )
     parser.add_argument("-v", "--verbose", help="verbose output", action="store_true")
+    parser.add_argument(
+        "-p",
+        "--pages",
+        help="input is a stream of note pages from the paged noterpmsg client",
+        action="store_true",
+    )
     parser.add_argument(
         "-o",
         "--output",
@@ -641,11 +681,20 @@ if __name__ == "__main__":
     if args.trace is None and args.device is None:
         print("error, please add trace file path or device name")
         print(
-            "usage: parsetrace.py [-h] [-t TRACE] [-e ELF] [-d DEVICE] [-b BAUDRATE] [-v] [-o OUTPUT]"
+            "usage: parsetrace.py [-h] [-t TRACE] [-e ELF] [-d DEVICE] [-b BAUDRATE] [-v] [-p] [-o OUTPUT]"
         )
         exit(1)
 
-    if args.trace:
+    if args.trace and args.pages:
+        if args.elf is None:
+            print("error, please add elf file path")
+            exit(1)
+
+        decode = TraceDecoder(args.elf)
+        with open(args.trace, "rb") as f:
+            decode.pagedata = f.read()
+        decode.parse_pages()
+    elif args.trace:
         file_type = subprocess.check_output(f"file -b {args.trace}", shell=True)
         file_type = str(file_type, "utf-8").lower()
         if "ascii" in file_type:
@@ -690,4 +739,4 @@ if __name__ == "__main__":
         decode = TraceDecoder(args.elf)
         with serial.Serial(args.device, baudrate=args.baudrate) as ser:
             ser.timeout = 0
-            decode.tty_received()
+            decode.tty_received(args.pages)
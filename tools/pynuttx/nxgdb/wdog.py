@@ -49,6 +49,17 @@ class WDog(Value, p.WDog):
 
 def get_wdog_list() -> List[WDog]:
     wdogs = []
+    wheel = utils.gdb_eval_or_none("g_wdtimerwheel")
+    if wheel is not None:
+        # CONFIG_WDOG_TIMER_WHEEL: walk every slot and sort by expiration
+
+        for i in range(utils.nitems(wheel)):
+            for wdog in lists.NxList(wheel[i], "struct wdog_s", "node"):
+                wdogs.append(WDog(wdog))
+
+        wdogs.sort(key=lambda w: int(w.expired))
+        return wdogs
+
     active = utils.parse_and_eval("g_wdactivelist")
     for wdog in lists.NxList(active, "struct wdog_s", "node"):
         wdogs.append(WDog(wdog))
@@ -39,6 +39,7 @@
 
 #define bt_atomic_set(ptr, value)        atomic_set(ptr, value);
 #define bt_atomic_get(ptr)               atomic_read(ptr)
+#define bt_atomic_xchg(ptr, value)       atomic_xchg(ptr, value)
 #define bt_atomic_testbit(ptr, bitno)    ((atomic_read(ptr) & (1 << (bitno))) != 0)
 #define bt_atomic_incr(ptr)              atomic_fetch_add(ptr, 1)
 #define bt_atomic_decr(ptr)              atomic_fetch_sub(ptr, 1)
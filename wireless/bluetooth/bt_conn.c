@@ -141,6 +141,22 @@ static int conn_tx_kthread(int argc, FAR char *argv[])
 
   while (conn->state == BT_CONN_CONNECTED)
     {
+      /* Get next ACL packet for connection.  The controller buffer credit
+       * is only taken once there is something to send so that an idle
+       * connection does not hold a credit that another connection could
+       * use.
+       */
+
+      ret = bt_queue_receive(&conn->tx_queue, &buf);
+      DEBUGASSERT(ret >= 0 && buf != NULL);
+      UNUSED(ret);
+
+      if (conn->state != BT_CONN_CONNECTED)
+        {
+          bt_buf_release(buf);
+          break;
+        }
+
       /* Wait until the controller can accept ACL packets */
 
       wlinfo("calling nxsem_wait_uninterruptible()\n");
@@ -149,6 +165,7 @@ static int conn_tx_kthread(int argc, FAR char *argv[])
       if (ret < 0)
         {
           wlerr("nxsem_wait_uninterruptible() failed: %d\n", ret);
+          bt_buf_release(buf);
           break;
         }
 
@@ -157,24 +174,25 @@ static int conn_tx_kthread(int argc, FAR char *argv[])
       if (conn->state != BT_CONN_CONNECTED)
         {
           nxsem_post(&g_btdev.le_pkts_sem);
+          bt_buf_release(buf);
           break;
         }
 
-      /* Get next ACL packet for connection */
+      /* Account for the credit before the packet reaches the controller
+       * so that a Number Of Completed Packets event cannot overtake it.
+       */
 
-      ret = bt_queue_receive(&conn->tx_queue, &buf);
-      DEBUGASSERT(ret >= 0 && buf != NULL);
-      UNUSED(ret);
+      bt_atomic_incr(&conn->pending);
 
-      if (conn->state != BT_CONN_CONNECTED)
+      wlinfo("passing buf %p len %u to driver\n", buf, buf->len);
+      ret = bt_send(g_btdev.btdev, buf);
+      if (ret < 0)
         {
+          wlerr("ERROR: bt_send() failed: %d\n", ret);
+          bt_atomic_decr(&conn->pending);
           nxsem_post(&g_btdev.le_pkts_sem);
-          bt_buf_release(buf);
-          break;
         }
 
-      wlinfo("passing buf %p len %u to driver\n", buf, buf->len);
-      bt_send(g_btdev.btdev, buf);
       bt_buf_release(buf);
     }
 
@@ -442,7 +460,7 @@ void bt_conn_send(FAR struct bt_conn_s *conn, FAR struct bt_buf_s *buf)
       buf = bt_l2cap_create_pdu(conn);
 
       len = remaining;
-      if (len < g_btdev.le_mtu)
+      if (len > g_btdev.le_mtu)
         {
           len = g_btdev.le_mtu;
         }
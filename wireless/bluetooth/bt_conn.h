@@ -93,6 +93,12 @@ struct bt_conn_s
 
   struct file tx_queue;
 
+  /* ACL packets handed to the controller but not yet reported by a
+   * Number Of Completed Packets event.
+   */
+
+  bt_atomic_t pending;
+
   FAR struct bt_keys_s *keys;
 
   /* Fixed channel contexts */
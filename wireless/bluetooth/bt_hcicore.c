@@ -426,6 +426,18 @@ static void hci_cmd_status(FAR struct bt_buf_s *buf)
     }
 }
 
+static void hci_reclaim_credits(FAR struct bt_conn_s *conn)
+{
+  int count = bt_atomic_xchg(&conn->pending, 0);
+
+  wlinfo("handle %u reclaimed %d\n", conn->handle, count);
+
+  while (count-- > 0)
+    {
+      nxsem_post(&g_btdev.le_pkts_sem);
+    }
+}
+
 static void hci_num_completed_packets(FAR struct bt_buf_s *buf)
 {
   FAR struct bt_hci_evt_num_completed_packets_s *evt = (FAR void *)buf->data;
@@ -436,6 +448,7 @@ static void hci_num_completed_packets(FAR struct bt_buf_s *buf)
 
   for (i = 0; i < num_handles; i++)
     {
+      FAR struct bt_conn_s *conn;
       uint16_t handle;
       uint16_t count;
 
@@ -443,12 +456,24 @@ static void hci_num_completed_packets(FAR struct bt_buf_s *buf)
       count  = BT_LE162HOST(evt->h[i].count);
 
       wlinfo("handle %u count %u\n", handle, count);
-      UNUSED(handle);
 
-      while (count--)
+      /* Credits of a connection that is already gone were given back
+       * when it disconnected.
+       */
+
+      conn = bt_conn_lookup_handle(handle);
+      if (conn == NULL)
         {
+          continue;
+        }
+
+      while (count-- && bt_atomic_get(&conn->pending) > 0)
+        {
+          bt_atomic_decr(&conn->pending);
           nxsem_post(&g_btdev.le_pkts_sem);
         }
+
+      bt_conn_release(conn);
     }
 }
 
@@ -658,6 +683,12 @@ static void hci_disconn_complete(FAR struct bt_buf_s *buf)
   bt_disconnected(conn);
 
   bt_conn_set_state(conn, BT_CONN_DISCONNECTED);
+
+  /* The controller flushes the packets still pending for the handle
+   * without reporting them, so give their credits back.
+   */
+
+  hci_reclaim_credits(conn);
   conn->handle = 0;
 
   if (bt_atomic_testbit(conn->flags, BT_CONN_AUTO_CONNECT))